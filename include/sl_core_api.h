@@ -258,7 +258,13 @@ SL_API sl::Result slFreeResources(sl::Feature feature, const sl::ViewportHandle&
 //! NOTE: It is allowed to pass in buffer tags as inputs, they are considered to be a "local" tags and do NOT interact with
 //! same tags sent in the global scope using slSetTag API.
 //!
-//! This method is NOT thread safe and requires DX/VK device to be created before calling it.
+//! NOTE: Chain sl::ViewportBatch instead of sl::ViewportHandle to evaluate several viewports in one call.
+//!
+//! NOTE: Different viewports can be evaluated on separate threads' command lists at the same time, features which do not
+//! support it (currently all but NIS on D3D12 and Vulkan) are serialized internally. A viewport must not be evaluated
+//! on two threads at once.
+//!
+//! This method requires DX/VK device to be created before calling it.
 SL_API sl::Result slEvaluateFeature(sl::Feature feature, const sl::FrameToken& frame, const sl::BaseStructure** inputs, uint32_t numInputs, sl::CommandBuffer* cmdBuffer);
 
 //! Upgrade interface
@@ -371,7 +371,13 @@ enum ResourceLifecycle
     //! Resource does NOT change, gets destroyed or reused for other purposes from the moment it is provided to SL until the frame is presented
     eValidUntilPresent,
     //! Resource does NOT change, gets destroyed or reused for other purposes from the moment it is provided to SL until after the slEvaluateFeature call has returned.
-    eValidUntilEvaluate
+    eValidUntilEvaluate,
+    //! Resource is one of a ring of persistent resources owned by the host and it does NOT change, gets destroyed or reused for other purposes
+    //! for the number of frames specified by the chained 'ResourceLifetimeInfo' (or 'ResourceLifetimeInfo::kDefaultFrameCount' if not chained).
+    //!
+    //! SL does not make a copy of such resource unless a plugin needs it on present (for example DLSS-G), host is responsible
+    //! for cycling through enough resources to cover the frames in flight.
+    eValidForFrames
 };
 
 //! Tagged resource
@@ -379,6 +385,7 @@ enum ResourceLifecycle
 //! {4C6A5AAD-B445-496C-87FF-1AF3845BE653}
 //! Extensions as part of the `next` ptr:
 //!     PrecisionInfo
+//!     ResourceLifetimeInfo
 SL_STRUCT_BEGIN(ResourceTag, StructType({ 0x4c6a5aad, 0xb445, 0x496c, { 0x87, 0xff, 0x1a, 0xf3, 0x84, 0x5b, 0xe6, 0x53 } }), kStructVersion1)
     ResourceTag(Resource* r, BufferType t, ResourceLifecycle l, const Extent* e = nullptr)
         : BaseStructure(ResourceTag::s_structType, kStructVersion1), resource(r), type(t), lifecycle(l)
@@ -444,6 +451,24 @@ SL_STRUCT_BEGIN(PrecisionInfo, StructType({ 0x98f6e9ba, 0x8d16, 0x4831, { 0xa8,
     }
 SL_STRUCT_END()
 
+//! Resource lifetime info, optional extension for ResourceTag tagged as 'ResourceLifecycle::eValidForFrames'
+//! 
+//! {E67476DA-EC5D-4B08-BBBD-263A25D2047B}
+//! Extensions as part of the `next` ptr:
+//!     ResourceTag
+SL_STRUCT_BEGIN(ResourceLifetimeInfo, StructType({ 0xe67476da, 0xec5d, 0x4b08, { 0xbb, 0xbd, 0x26, 0x3a, 0x25, 0xd2, 0x04, 0x7b } }), kStructVersion1)
+    static constexpr uint32_t kDefaultFrameCount = 2;
+
+    ResourceLifetimeInfo(uint32_t frames) : BaseStructure(ResourceLifetimeInfo::s_structType, kStructVersion1), frameCount(frames) {}
+
+    //! Number of frames, starting with the one the resource is tagged in, during which host does NOT modify the resource
+    //! 
+    //! Typically this matches the number of resources in the host's ring, must be at least 1
+    uint32_t frameCount = kDefaultFrameCount;
+
+    //! IMPORTANT: New members go here or if optional can be chained in a new struct, see sl_struct.h for details
+SL_STRUCT_END()
+
 //! Resource allocation/deallocation callbacks
 //!
 //! Use these callbacks to gain full control over 
@@ -517,6 +542,26 @@ enum class PreferenceFlags : uint64_t
     //! Optional - allow tagging of resources for frame. This helps distinguish whether slEvaluateFeature needs to do frame-based tagging
     //! of resources which wasn't the case earlier.
     eUseFrameBasedResourceTagging = 1 << 7,
+
+    //! Optional - Start each feature only when the host first uses it (any per-feature API like 'slIsFeatureSupported', 'slAllocateResources'
+    //! or 'slEvaluateFeature') rather than when plugins are initialized. Disabled features then never pay for their startup.
+    //! 
+    //! NOTE: 'sl.common' and any plugin required by another plugin still start immediately. Features started later are not
+    //! reported to the other plugins' 'slOnPluginsInitialized'.
+    eDeferFeatureStartup = 1 << 8,
+
+    //! Optional - 'slSetFeatureLoaded(feature, false)' also shuts the plugin down, releasing its VRAM, NGX features and hooks,
+    //! and 'slSetFeatureLoaded(feature, true)' starts it again. Features unloaded before the device is set are never started.
+    //! 
+    //! NOTE: The plugin library stays resident so pointers obtained via 'slGetFeatureFunction' remain valid but must not be
+    //! used while the feature is unloaded. 'sl.common' and any plugin required by another loaded plugin are kept running.
+    eReleaseUnloadedFeatures = 1 << 9,
+
+    //! Optional - Host renders without a swap-chain and presents through 'slPresentHeadless', see sl_headless.h
+    //! 
+    //! Software adapters are enumerated as well and adapter details which need a display or KMT queries (HWS, battery)
+    //! are reported with fixed values so runs on headless GPU servers are reproducible.
+    eHeadless = 1 << 10,
 };
 
 SL_ENUM_OPERATORS_64(PreferenceFlags)
@@ -565,6 +610,19 @@ SL_STRUCT_BEGIN(Preferences, StructType({ 0x1ca10965, 0xbf8e, 0x432b, { 0x8d, 0x
     //! IMPORTANT: New members go here or if optional can be chained in a new struct, see sl_struct.h for details
 SL_STRUCT_END()
 
+//! Optional - chained to Preferences
+//!
+//! {9B814967-1708-430E-93CE-84831FCCED4C}
+SL_STRUCT_BEGIN(PreferencesViewports, StructType({ 0x9b814967, 0x1708, 0x430e, { 0x93, 0xce, 0x84, 0x83, 0x1f, 0xcc, 0xed, 0x4c } }), kStructVersion1)
+    //! Optional - Maximum number of viewports each feature is evaluated on within a frame, 0 keeps the default of 4
+    //! 
+    //! NOTE: Per frame constant storage of features like DLSS or NIS is sized from this, set it when using
+    //! more viewports (multi-view tooling, stereo rendering etc.)
+    uint32_t maxNumViewports = 0;
+
+    //! IMPORTANT: New members go here or if optional can be chained in a new struct, see sl_struct.h for details
+SL_STRUCT_END()
+
 //! Frame tracking handle
 //! 
 //! IMPORTANT: Use slGetNewFrameToken to obtain unique instance
@@ -587,6 +645,22 @@ private:
     friend void sl::test::AbiValidation();
 SL_STRUCT_END()
 
+//! Batch of viewports evaluated by a single slEvaluateFeature call
+//! 
+//! Chain this instead of a ViewportHandle to evaluate the same feature for several viewports
+//! (split-screen, picture-in-picture) back to back on the same command buffer.
+//! 
+//! IMPORTANT: Local tags cannot be provided as inputs when evaluating a batch, use slSetTag or slSetTagForFrame
+//! 
+//! {6F115E8D-6386-48F5-B191-7DEA4BA5FF3B}
+SL_STRUCT_BEGIN(ViewportBatch, StructType({ 0x6f115e8d, 0x6386, 0x48f5, { 0xb1, 0x91, 0x7d, 0xea, 0x4b, 0xa5, 0xff, 0x3b } }), kStructVersion1)
+    //! Viewports to evaluate, in order
+    const ViewportHandle* viewports{};
+    uint32_t numViewports{};
+
+    //! IMPORTANT: New members go here or if optional can be chained in a new struct, see sl_struct.h for details
+SL_STRUCT_END()
+
 //! Specifies feature requirement flags
 //! 
 enum class FeatureRequirementFlags : uint32_t
@@ -36,21 +36,37 @@ enum class DeepDVCMode : uint32_t
 };
 
 // {23288AAD-7E7E-BE2A-916F-27DA30A3046B}
-SL_STRUCT_BEGIN(DeepDVCOptions, StructType({ 0x23288aad, 0x7e7e, 0xbe2a, { 0x91, 0x67, 0x27, 0xda, 0x30, 0xa3, 0x04, 0x6b } }), kStructVersion1)
+SL_STRUCT_BEGIN(DeepDVCOptions, StructType({ 0x23288aad, 0x7e7e, 0xbe2a, { 0x91, 0x67, 0x27, 0xda, 0x30, 0xa3, 0x04, 0x6b } }), kStructVersion2)
     //! Specifies which mode should be used
     DeepDVCMode mode = DeepDVCMode::eOff;
     //! Specifies intensity level in range [0,1]. Default 0.5
     float intensity = 0.5f;
     //! Specifies saturation boost in range [0,1]. Default 0.25
     float saturationBoost = 0.25f;
+
+    //! Version 2 members:
+    //! GPU time in milliseconds DeepDVC may take per frame, 0 disables adaptive quality
+    //! 
+    //! While the measured cost is over budget the network only runs every other frame, the enhancement
+    //! from the last evaluation is applied to the frames in between at a fraction of the cost.
+    float gpuBudgetMs = 0.0f;
+    //! Runs the network every Nth frame in range [1,4], the frames in between reuse the last enhancement
+    //! 
+    //! If 'kBufferTypeMotionVectors' is tagged (with 'sl::Constants::mvecScale' set) the enhancement is reprojected
+    //! to the current frame, otherwise it is applied in place.
+    uint32_t updateInterval = 1;
 SL_STRUCT_END()
 
 //! Returned by the DeepDVC plugin
 //!
 // {934FD3D3-B34C-70A7-A139-F19FE04D91D3}
-SL_STRUCT_BEGIN(DeepDVCState, StructType({ 0x934fd3d3, 0xb34c, 0x70a7, { 0xa1, 0x39, 0xf1, 0x9f, 0xe0, 0x4d, 0x91, 0xd3 } }), kStructVersion1)
+SL_STRUCT_BEGIN(DeepDVCState, StructType({ 0x934fd3d3, 0xb34c, 0x70a7, { 0xa1, 0x39, 0xf1, 0x9f, 0xe0, 0x4d, 0x91, 0xd3 } }), kStructVersion2)
     //! Specified the amount of memory expected to be used
     uint64_t estimatedVRAMUsageInBytes {};
+
+    //! Version 2 members:
+    //! Number of frames between network evaluations, the larger of 'DeepDVCOptions::updateInterval' and the adaptive quality interval
+    uint32_t updateInterval = 1;
 SL_STRUCT_END()
 
 }
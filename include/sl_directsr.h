@@ -52,7 +52,7 @@ enum class DirectSRVariantFlags : uint32_t
 };
 
 // {1AD87504-774E-4BF3-9633-A44D1F7F9CB8}
-SL_STRUCT_BEGIN(DirectSROptions, StructType({ 0x1ad87504, 0x774e, 0x4bf3, { 0x96, 0x33, 0xa4, 0x4d, 0x1f, 0x7f, 0x9c, 0xb8 } }), kStructVersion1)
+SL_STRUCT_BEGIN(DirectSROptions, StructType({ 0x1ad87504, 0x774e, 0x4bf3, { 0x96, 0x33, 0xa4, 0x4d, 0x1f, 0x7f, 0x9c, 0xb8 } }), kStructVersion2)
     // DirectSR variant index as enumerated
     uint32_t variantIndex;
 
@@ -80,6 +80,15 @@ SL_STRUCT_BEGIN(DirectSROptions, StructType({ 0x1ad87504, 0x774e, 0x4bf3, { 0x96
     //! Specifies if tagged color buffers are full HDR or not (DLSS in HDR pipeline or not)
     Boolean colorBuffersHDR = Boolean::eTrue;
 
+    //! Version 2 members:
+    //! Executes the upscaler on an SL owned compute queue instead of 'pCommandQueue'
+    //! 
+    //! The compute queue waits for everything submitted to 'pCommandQueue' before the evaluate call and
+    //! 'pCommandQueue' waits for the upscaled output before any work submitted after it, so host work already
+    //! in flight (e.g. the previous frame's post-processing) overlaps with the upscaler.
+    //! Falls back to 'pCommandQueue' if the variant cannot run on a compute queue.
+    Boolean useAsyncCompute = Boolean::eFalse;
+
     //! IMPORTANT: New members go here or if optional can be chained in a new struct, see sl_struct.h for details
 SL_STRUCT_END()
 
@@ -120,6 +129,22 @@ SL_STRUCT_BEGIN(DirectSRVariantInfo, StructType({ 0x38216184, 0x79ba, 0x48cb, {
     //! IMPORTANT: New members go here or if optional can be chained in a new struct, see sl_struct.h for details
 SL_STRUCT_END()
 
+//! Describes a DirectSR engine to create ahead of time, see 'slDirectSRPrewarm'
+//! 
+//! {5E0A2C71-3B8D-4F6A-9C14-7D2E81B04A36}
+SL_STRUCT_BEGIN(DirectSRPrewarmInfo, StructType({ 0x5e0a2c71, 0x3b8d, 0x4f6a, { 0x9c, 0x14, 0x7d, 0x2e, 0x81, 0xb0, 0x4a, 0x36 } }), kStructVersion1)
+    //! Options as they will be passed to 'slDirectSRSetOptions'
+    DirectSROptions options{};
+    //! Formats of the resources tagged as output color, input color and depth
+    DXGI_FORMAT targetFormat = DXGI_FORMAT_UNKNOWN;
+    DXGI_FORMAT sourceColorFormat = DXGI_FORMAT_UNKNOWN;
+    DXGI_FORMAT sourceDepthFormat = DXGI_FORMAT_UNKNOWN;
+    //! Must match 'sl::Constants::motionVectorsJittered'
+    Boolean motionVectorsJittered = Boolean::eFalse;
+
+    //! IMPORTANT: New members go here or if optional can be chained in a new struct, see sl_struct.h for details
+SL_STRUCT_END()
+
 }
 
 //! Provides optimal DirectSR settings
@@ -147,6 +172,19 @@ using PFun_slDirectSRGetVariantInfo = sl::Result(uint32_t *numVariants, sl::Dire
 //! This method is NOT thread safe.
 using PFun_slDirectSRSetOptions = sl::Result(const sl::ViewportHandle& viewport, const sl::DirectSROptions& options);
 
+//! Creates DirectSR engines up front
+//!
+//! Call this method (e.g. during a loading screen) with the variants, output sizes and formats the host expects
+//! to switch between. Creation runs in the background and the call returns right away. Switching to any of them
+//! later on only creates an upscaler from the prepared engine instead of blocking the render thread.
+//!
+//! @param infos Engines to create, must have 'count' elements
+//! @param count Number of engines
+//! @return sl::ResultCode::eOk if successful, error code otherwise (see sl_result.h for details)
+//!
+//! This method is NOT thread safe.
+using PFun_slDirectSRPrewarm = sl::Result(const sl::DirectSRPrewarmInfo* infos, uint32_t count);
+
 //! HELPERS
 //! 
 inline sl::Result slDirectSRGetOptimalSettings(const sl::DirectSROptions& options, sl::DirectSROptimalSettings& settings)
@@ -167,3 +205,9 @@ inline sl::Result slDirectSRSetOptions(const sl::ViewportHandle& viewport, const
     return s_slDirectSRSetOptions(viewport, options);
 }
 
+inline sl::Result slDirectSRPrewarm(const sl::DirectSRPrewarmInfo* infos, uint32_t count)
+{
+    SL_FEATURE_FUN_IMPORT_STATIC(sl::kFeatureDirectSR, slDirectSRPrewarm);
+    return s_slDirectSRPrewarm(infos, count);
+}
+
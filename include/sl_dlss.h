@@ -70,7 +70,7 @@ enum class DLSSPreset : uint32_t
 };
 
 // {6AC826E4-4C61-4101-A92D-638D421057B8}
-SL_STRUCT_BEGIN(DLSSOptions, StructType({ 0x6ac826e4, 0x4c61, 0x4101, { 0xa9, 0x2d, 0x63, 0x8d, 0x42, 0x10, 0x57, 0xb8 } }), kStructVersion3)
+SL_STRUCT_BEGIN(DLSSOptions, StructType({ 0x6ac826e4, 0x4c61, 0x4101, { 0xa9, 0x2d, 0x63, 0x8d, 0x42, 0x10, 0x57, 0xb8 } }), kStructVersion4)
     //! Specifies which mode should be used
     DLSSMode mode = DLSSMode::eOff;
     //! Specifies output (final) target width
@@ -104,6 +104,27 @@ SL_STRUCT_BEGIN(DLSSOptions, StructType({ 0x6ac826e4, 0x4c61, 0x4101, { 0xa9, 0x
     //! Enabling alpha upscaling may impact performance
     Boolean alphaUpscalingEnabled = Boolean::eFalse;
 
+    // kStructVersion4
+    //! Dilates motion vectors towards the closest depth in each 3x3 neighborhood before they reach DLSS,
+    //! invalid vectors are replaced with camera motion. Replaces a host side dilation pass before tagging.
+    Boolean dilateMotionVectors = Boolean::eFalse;
+
+    //! IMPORTANT: New members go here or if optional can be chained in a new struct, see sl_struct.h for details
+SL_STRUCT_END()
+
+//! Optional, chained to DLSSOptions when calling slDLSSSetOptions
+//! 
+//! Enables the dynamic resolution controller, recommended render size is then returned in DLSSState
+//! 
+//! {C0D44F25-C0EA-41BB-984B-D464B4E9610F}
+SL_STRUCT_BEGIN(DLSSDynamicResolutionOptions, StructType({ 0xc0d44f25, 0xc0ea, 0x41bb, { 0x98, 0x4b, 0xd4, 0x64, 0xb4, 0xe9, 0x61, 0xf } }), kStructVersion1)
+    //! Specifies GPU frame time to aim for, 0 disables the controller
+    float targetFrameTimeMS = 0.0f;
+    //! Specifies GPU time of the most recently completed frame as measured by the host, 0 if not available yet
+    //! 
+    //! NOTE: Provide a new value every frame, controller only adjusts the resolution when a new measurement comes in
+    float frameTimeMS = 0.0f;
+
     //! IMPORTANT: New members go here or if optional can be chained in a new struct, see sl_struct.h for details
 SL_STRUCT_END()
 
@@ -132,10 +153,25 @@ SL_STRUCT_END()
 //! Returned by DLSS plugin
 //! 
 //! {9366B056-8C01-463C-BB91-E68782636CE9}
-SL_STRUCT_BEGIN(DLSSState, StructType({ 0x9366b056, 0x8c01, 0x463c, { 0xbb, 0x91, 0xe6, 0x87, 0x82, 0x63, 0x6c, 0xe9 } }), kStructVersion1)
+SL_STRUCT_BEGIN(DLSSState, StructType({ 0x9366b056, 0x8c01, 0x463c, { 0xbb, 0x91, 0xe6, 0x87, 0x82, 0x63, 0x6c, 0xe9 } }), kStructVersion3)
     //! Specified the amount of memory expected to be used
     uint64_t estimatedVRAMUsageInBytes{};
 
+    //! Version 2 members:
+    //! GPU time spent evaluating DLSS on this viewport, last value plus average and 99th percentile over the last 120 evaluations
+    //!
+    //! NOTE: Timings are resolved a few frames late and are zero until then, on d3d11 only available in non-production builds
+    float gpuTimeLastMS{};
+    float gpuTimeAverageMS{};
+    float gpuTimeP99MS{};
+
+    //! Version 3 members:
+    //! Render size picked by the dynamic resolution controller, zero if DLSSDynamicResolutionOptions are not provided
+    //!
+    //! Always within the dynamic range from DLSSOptimalSettings (capped by the optimal size) so the feature is never recreated
+    uint32_t recommendedRenderWidth{};
+    uint32_t recommendedRenderHeight{};
+
     //! IMPORTANT: New members go here or if optional can be chained in a new struct, see sl_struct.h for details
 SL_STRUCT_END()
 
@@ -174,6 +210,23 @@ using PFun_slDLSSGetState = sl::Result(const sl::ViewportHandle & viewport, sl::
 //! This method is NOT thread safe.
 using PFun_slDLSSSetOptions = sl::Result(const sl::ViewportHandle& viewport, const sl::DLSSOptions& options);
 
+//! Creates DLSS features up front
+//!
+//! Call this method (e.g. during a loading screen) with the modes and output sizes the host expects to switch
+//! between. Switching to any of them later on picks up the prepared feature instead of creating one.
+//! Calling this enables the feature cache, features not in use are kept until its budget or count is exceeded.
+//! Features are created with auto exposure only if 'DLSSOptions::useAutoExposure' is set, hosts which leave
+//! the exposure buffer untagged should set it or the prewarmed features will not match.
+//!
+//! @param cmdBuffer Command buffer to record feature creation on
+//! @param viewport Specified viewport we are working with
+//! @param options Options to create features for, must have 'count' elements
+//! @param count Number of options
+//! @return sl::ResultCode::eOk if successful, error code otherwise (see sl_result.h for details)
+//!
+//! This method is NOT thread safe.
+using PFun_slDLSSPrewarm = sl::Result(sl::CommandBuffer* cmdBuffer, const sl::ViewportHandle& viewport, const sl::DLSSOptions* options, uint32_t count);
+
 //! HELPERS
 //! 
 inline sl::Result slDLSSGetOptimalSettings(const sl::DLSSOptions& options, sl::DLSSOptimalSettings& settings)
@@ -193,3 +246,9 @@ inline sl::Result slDLSSSetOptions(const sl::ViewportHandle& viewport, const sl:
     SL_FEATURE_FUN_IMPORT_STATIC(sl::kFeatureDLSS, slDLSSSetOptions);
     return s_slDLSSSetOptions(viewport, options);
 }
+
+inline sl::Result slDLSSPrewarm(sl::CommandBuffer* cmdBuffer, const sl::ViewportHandle& viewport, const sl::DLSSOptions* options, uint32_t count)
+{
+    SL_FEATURE_FUN_IMPORT_STATIC(sl::kFeatureDLSS, slDLSSPrewarm);
+    return s_slDLSSPrewarm(cmdBuffer, viewport, options, count);
+}
@@ -129,10 +129,23 @@ SL_STRUCT_END()
 //! Returned by DLSSD plugin
 //! 
 //! {71873C14-F8CA-4767-9EAF-3B4393EA98FA}
-SL_STRUCT_BEGIN(DLSSDState, StructType({ 0x71873c14, 0xf8ca, 0x4767, { 0x9e, 0xaf, 0x3b, 0x43, 0x93, 0xea, 0x98, 0xfa } }), kStructVersion1)
+SL_STRUCT_BEGIN(DLSSDState, StructType({ 0x71873c14, 0xf8ca, 0x4767, { 0x9e, 0xaf, 0x3b, 0x43, 0x93, 0xea, 0x98, 0xfa } }), kStructVersion3)
 //! Specified the amount of memory expected to be used
     uint64_t estimatedVRAMUsageInBytes {};
 
+    //! Version 2 members:
+    //! Specifies if the viewport is still evaluated with the feature created for the previous options
+    //! while the feature for the current ones is being created in the background
+    Boolean usingStaleFeature = Boolean::eFalse;
+
+    //! Version 3 members:
+    //! GPU time spent evaluating DLSSD on this viewport, last value plus average and 99th percentile over the last 120 evaluations
+    //!
+    //! NOTE: Timings are resolved a few frames late and are zero until then, on d3d11 only available in non-production builds
+    float gpuTimeLastMS{};
+    float gpuTimeAverageMS{};
+    float gpuTimeP99MS{};
+
     //! IMPORTANT: New members go here or if optional can be chained in a new struct, see sl_struct.h for details
 SL_STRUCT_END()
 
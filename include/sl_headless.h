@@ -0,0 +1,68 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+
+#pragma once
+
+namespace sl
+{
+
+//! Emulated present for hosts rendering without a swap-chain, for example performance runs on GPU servers without a display
+//!
+//! Runs the per frame work SL normally does on present (garbage collection, tag recycling, frame counters and 'slGetPerfStats')
+//! and paces the CPU against the GPU through a null swap-chain. Plugin present hooks which need a real swap-chain are not invoked.
+//!
+//! NOTE: Only supported on D3D12, set 'PreferenceFlags::eHeadless' on adapters without display outputs.
+// {a415a85a-047a-4fb3-a480-df5481dc0f8b}
+SL_STRUCT_BEGIN(HeadlessPresentOptions, StructType({ 0xa415a85a, 0x047a, 0x4fb3, { 0xa4, 0x80, 0xdf, 0x54, 0x81, 0xdc, 0x0f, 0x8b } }), kStructVersion1)
+    //! Queue the frame was submitted to, 'ID3D12CommandQueue*', the emulated present is signaled on it
+    void* commandQueue{};
+    //! Size of the emulated back buffers, zero skips allocating them and only paces the CPU
+    uint32_t width{};
+    uint32_t height{};
+    //! Frames the CPU can run ahead of the GPU, same as the back buffer count of a swap-chain
+    uint32_t bufferCount = 3;
+    //! Reported to plugins as the display refresh rate
+    float refreshRate = 60.0f;
+
+    //! IMPORTANT: New members go here or if optional can be chained in a new struct, see sl_struct.h for details
+SL_STRUCT_END()
+
+}
+
+//! Emulates present for the frame just submitted to 'options.commandQueue'
+//!
+//! Call once per frame where the host would otherwise call Present. Blocks while all emulated back buffers are in flight.
+//!
+//! @param options Reference to a structure describing the queue and the emulated swap-chain
+//! @return sl::ResultCode::eOk if successful, error code otherwise (see sl_result.h for details)
+//!
+//! This method is NOT thread safe and should be called on the thread which would present.
+using PFun_slPresentHeadless = sl::Result(const sl::HeadlessPresentOptions& options);
+
+//! HELPERS
+//!
+inline sl::Result slPresentHeadless(const sl::HeadlessPresentOptions& options)
+{
+    SL_FEATURE_FUN_IMPORT_STATIC(sl::kFeatureCommon, slPresentHeadless);
+    return s_slPresentHeadless(options);
+}
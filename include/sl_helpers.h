@@ -376,6 +376,7 @@ inline const char* getResourceLifecycleAsStr(ResourceLifecycle v)
         SL_CASE_STR(ResourceLifecycle::eOnlyValidNow);
         SL_CASE_STR(ResourceLifecycle::eValidUntilPresent);
         SL_CASE_STR(ResourceLifecycle::eValidUntilEvaluate);
+        SL_CASE_STR(ResourceLifecycle::eValidForFrames);
     };
     return "Unknown";
 }
@@ -457,8 +458,8 @@ T* findStruct(const void** ptr, uint32_t count)
     return (T*)base;
 }
 
-template<typename T>
-bool findStructs(const void** ptr, uint32_t count, std::vector<T*>& structs)
+template<typename T, typename Allocator>
+bool findStructs(const void** ptr, uint32_t count, std::vector<T*, Allocator>& structs)
 {
     for (uint32_t i = 0; i < count; i++)
     {
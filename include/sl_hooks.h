@@ -75,6 +75,14 @@ enum class FunctionHookID : uint32_t
     eVulkan_CreateWin32SurfaceKHR,
     eVulkan_DestroySurfaceKHR,
 
+    //! Internal - please ignore when doing manual hooking
+    //! 
+    //! Resource creation, plugins only see resources matching the 'filter' from their hook JSON
+    eID3D12Device_CreateCommittedResource,
+    eID3D12Device_CreatePlacedResource,
+    eID3D12Device_CreateReservedResource,
+    eVulkan_CreateImage,
+
     eMaxNum
 };
 
@@ -107,6 +115,10 @@ inline const char* getFunctionHookIDAsStr(FunctionHookID v)
         SL_CASE_STR(FunctionHookID::eVulkan_DeviceWaitIdle);
         SL_CASE_STR(FunctionHookID::eVulkan_CreateWin32SurfaceKHR);
         SL_CASE_STR(FunctionHookID::eVulkan_DestroySurfaceKHR);
+        SL_CASE_STR(FunctionHookID::eID3D12Device_CreateCommittedResource);
+        SL_CASE_STR(FunctionHookID::eID3D12Device_CreatePlacedResource);
+        SL_CASE_STR(FunctionHookID::eID3D12Device_CreateReservedResource);
+        SL_CASE_STR(FunctionHookID::eVulkan_CreateImage);
         case FunctionHookID::eMaxNum: break;
     };
     return "Unknown";
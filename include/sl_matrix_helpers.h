@@ -25,10 +25,27 @@
 #include "sl.h"
 #include "sl_consts.h"
 
+// SIMD implementations are picked at compile time and produce bit-identical results to the scalar
+// reference versions (same operations in the same order, no FMA contraction). Define
+// SL_MATRIX_HELPERS_SCALAR before including this header to force the scalar code.
+#if !defined(SL_MATRIX_HELPERS_SCALAR)
+#if defined(__AVX__)
+#define SL_MATRIX_HELPERS_AVX 1
+#define SL_MATRIX_HELPERS_SSE 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SL_MATRIX_HELPERS_SSE 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SL_MATRIX_HELPERS_NEON 1
+#include <arm_neon.h>
+#endif
+#endif
+
 namespace sl
 {
 
-inline void matrixMul(float4x4& result, const float4x4& a, const float4x4& b)
+inline void matrixMulScalar(float4x4& result, const float4x4& a, const float4x4& b)
 {
     // Alias raw pointers over the input matrices
     const float* pA = &a[0].x;
@@ -55,7 +72,7 @@ inline void matrixMul(float4x4& result, const float4x4& a, const float4x4& b)
     result[3].w = (float)((pA[12] * pB[3]) + (pA[13] * pB[7]) + (pA[14] * pB[11]) + (pA[15] * pB[15]));
 }
 
-inline void matrixFullInvert(float4x4& result, const float4x4& mat)
+inline void matrixFullInvertScalar(float4x4& result, const float4x4& mat)
 {
     // Matrix inversion code from https://stackoverflow.com/questions/1148309/inverting-a-4x4-matrix
     // Alias raw pointers over the input matrix and the result
@@ -92,7 +109,7 @@ inline void matrixFullInvert(float4x4& result, const float4x4& mat)
 }
 
 // Specialised lightweight matrix invert when the matrix is known to be orthonormal
-inline void matrixOrthoNormalInvert(float4x4& result, const float4x4& mat)
+inline void matrixOrthoNormalInvertScalar(float4x4& result, const float4x4& mat)
 {
     // Transpose the first 3x3
     result[0].x = mat[0].x;
@@ -117,6 +134,160 @@ inline void matrixOrthoNormalInvert(float4x4& result, const float4x4& mat)
     result[3].w = 1.0f;
 }
 
+#if defined(SL_MATRIX_HELPERS_SSE) || defined(SL_MATRIX_HELPERS_NEON)
+namespace simd
+{
+// Minimal 4-wide float layer so each helper below is written once for SSE and NEON
+#if defined(SL_MATRIX_HELPERS_SSE)
+using float4v = __m128;
+inline float4v load(const float* p) { return _mm_loadu_ps(p); }
+inline void store(float* p, float4v v) { _mm_storeu_ps(p, v); }
+inline float4v set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+inline float4v add(float4v a, float4v b) { return _mm_add_ps(a, b); }
+inline float4v sub(float4v a, float4v b) { return _mm_sub_ps(a, b); }
+inline float4v mul(float4v a, float4v b) { return _mm_mul_ps(a, b); }
+//! Lane i of the result is lane I<i> of v
+template<int X, int Y, int Z, int W>
+inline float4v shuffle(float4v v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(W, Z, Y, X)); }
+inline void transpose(float4v& r0, float4v& r1, float4v& r2, float4v& r3) { _MM_TRANSPOSE4_PS(r0, r1, r2, r3); }
+#else
+using float4v = float32x4_t;
+inline float4v load(const float* p) { return vld1q_f32(p); }
+inline void store(float* p, float4v v) { vst1q_f32(p, v); }
+inline float4v set(float x, float y, float z, float w) { const float v[4] = { x, y, z, w }; return vld1q_f32(v); }
+inline float4v add(float4v a, float4v b) { return vaddq_f32(a, b); }
+inline float4v sub(float4v a, float4v b) { return vsubq_f32(a, b); }
+inline float4v mul(float4v a, float4v b) { return vmulq_f32(a, b); }
+template<int X, int Y, int Z, int W>
+inline float4v shuffle(float4v v)
+{
+    static const uint8_t bytes[16] = {
+        X * 4, X * 4 + 1, X * 4 + 2, X * 4 + 3, Y * 4, Y * 4 + 1, Y * 4 + 2, Y * 4 + 3,
+        Z * 4, Z * 4 + 1, Z * 4 + 2, Z * 4 + 3, W * 4, W * 4 + 1, W * 4 + 2, W * 4 + 3 };
+    return vreinterpretq_f32_u8(vqtbl1q_u8(vreinterpretq_u8_f32(v), vld1q_u8(bytes)));
+}
+inline void transpose(float4v& r0, float4v& r1, float4v& r2, float4v& r3)
+{
+    float32x4x2_t t01 = vtrnq_f32(r0, r1);
+    float32x4x2_t t23 = vtrnq_f32(r2, r3);
+    r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+#endif
+}
+#endif
+
+inline void matrixMul(float4x4& result, const float4x4& a, const float4x4& b)
+{
+    const float* pA = &a[0].x;
+    const float* pB = &b[0].x;
+    float* pResult = &result[0].x;
+#if defined(SL_MATRIX_HELPERS_AVX)
+    // Two rows per iteration, same per-row operation order as the scalar version
+    const __m256 b0 = _mm256_broadcast_ps((const __m128*)(pB + 0));
+    const __m256 b1 = _mm256_broadcast_ps((const __m128*)(pB + 4));
+    const __m256 b2 = _mm256_broadcast_ps((const __m128*)(pB + 8));
+    const __m256 b3 = _mm256_broadcast_ps((const __m128*)(pB + 12));
+    const __m256 rows01 = _mm256_loadu_ps(pA);
+    const __m256 rows23 = _mm256_loadu_ps(pA + 8);
+    __m256 rows[2] = { rows01, rows23 };
+    for (int i = 0; i < 2; i++)
+    {
+        __m256 r = _mm256_mul_ps(_mm256_shuffle_ps(rows[i], rows[i], 0x00), b0);
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(rows[i], rows[i], 0x55), b1));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(rows[i], rows[i], 0xaa), b2));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(rows[i], rows[i], 0xff), b3));
+        _mm256_storeu_ps(pResult + i * 8, r);
+    }
+#elif defined(SL_MATRIX_HELPERS_SSE) || defined(SL_MATRIX_HELPERS_NEON)
+    using namespace simd;
+    const float4v b0 = load(pB + 0);
+    const float4v b1 = load(pB + 4);
+    const float4v b2 = load(pB + 8);
+    const float4v b3 = load(pB + 12);
+    float4v rows[4] = { load(pA), load(pA + 4), load(pA + 8), load(pA + 12) };
+    for (int i = 0; i < 4; i++)
+    {
+        float4v r = mul(shuffle<0, 0, 0, 0>(rows[i]), b0);
+        r = add(r, mul(shuffle<1, 1, 1, 1>(rows[i]), b1));
+        r = add(r, mul(shuffle<2, 2, 2, 2>(rows[i]), b2));
+        r = add(r, mul(shuffle<3, 3, 3, 3>(rows[i]), b3));
+        store(pResult + i * 4, r);
+    }
+#else
+    matrixMulScalar(result, a, b);
+#endif
+}
+
+inline void matrixFullInvert(float4x4& result, const float4x4& mat)
+{
+#if defined(SL_MATRIX_HELPERS_SSE) || defined(SL_MATRIX_HELPERS_NEON)
+    using namespace simd;
+    // Same cofactor expansion as matrixFullInvertScalar, one result row per iteration.
+    // Cofactors of row r only involve the other three columns of 'mat', each term picks rows
+    // (1,0,0,0), (2,2,1,1) or (3,3,3,2) from them. The alternating sign is folded into the
+    // first factor which keeps every lane bit-identical to the scalar expression.
+    const float* pMat = &mat[0].x;
+    float4v columns[4] = { load(pMat), load(pMat + 4), load(pMat + 8), load(pMat + 12) };
+    transpose(columns[0], columns[1], columns[2], columns[3]);
+    const float4v signs[2] = { set(1.f, -1.f, 1.f, -1.f), set(-1.f, 1.f, -1.f, 1.f) };
+    float cofactors[16];
+    for (int r = 0; r < 4; r++)
+    {
+        const float4v& ca = columns[r == 0 ? 1 : 0];
+        const float4v& cb = columns[r <= 1 ? 2 : 1];
+        const float4v& cc = columns[r <= 2 ? 3 : 2];
+        const float4v a1 = mul(shuffle<1, 0, 0, 0>(ca), signs[r & 1]);
+        const float4v a2 = mul(shuffle<2, 2, 1, 1>(ca), signs[r & 1]);
+        const float4v a3 = mul(shuffle<3, 3, 3, 2>(ca), signs[r & 1]);
+        const float4v b1 = shuffle<1, 0, 0, 0>(cb), b2 = shuffle<2, 2, 1, 1>(cb), b3 = shuffle<3, 3, 3, 2>(cb);
+        const float4v c1 = shuffle<1, 0, 0, 0>(cc), c2 = shuffle<2, 2, 1, 1>(cc), c3 = shuffle<3, 3, 3, 2>(cc);
+        float4v v = sub(mul(mul(a1, b2), c3), mul(mul(a1, c2), b3));
+        v = sub(v, mul(mul(a2, b1), c3));
+        v = add(v, mul(mul(a2, c1), b3));
+        v = add(v, mul(mul(a3, b1), c2));
+        v = sub(v, mul(mul(a3, c1), b2));
+        store(cofactors + r * 4, v);
+    }
+
+    float det = pMat[0] * cofactors[0] + pMat[1] * cofactors[4] + pMat[2] * cofactors[8] + pMat[3] * cofactors[12];
+    float* pResult = &result[0].x;
+    const float4v scale = det != 0.f ? set(1.0f / det, 1.0f / det, 1.0f / det, 1.0f / det) : set(1.f, 1.f, 1.f, 1.f);
+    for (int r = 0; r < 4; r++)
+    {
+        store(pResult + r * 4, mul(load(cofactors + r * 4), scale));
+    }
+#else
+    matrixFullInvertScalar(result, mat);
+#endif
+}
+
+// Specialised lightweight matrix invert when the matrix is known to be orthonormal
+inline void matrixOrthoNormalInvert(float4x4& result, const float4x4& mat)
+{
+#if defined(SL_MATRIX_HELPERS_SSE) || defined(SL_MATRIX_HELPERS_NEON)
+    using namespace simd;
+    // Transposing with a zero fourth row gives the rotation part with a zero w column
+    float4v r0 = load(&mat[0].x), r1 = load(&mat[1].x), r2 = load(&mat[2].x), r3 = set(0.f, 0.f, 0.f, 0.f);
+    transpose(r0, r1, r2, r3);
+    const float4v t = set(mat[3].x, mat[3].y, mat[3].z, 0.f);
+    float4v translation = mul(shuffle<0, 0, 0, 0>(t), r0);
+    translation = add(translation, mul(shuffle<1, 1, 1, 1>(t), r1));
+    translation = add(translation, mul(shuffle<2, 2, 2, 2>(t), r2));
+    // Multiply by -1 rather than subtract from zero so signed zeros match the scalar version
+    translation = mul(translation, set(-1.f, -1.f, -1.f, -1.f));
+    store(&result[0].x, r0);
+    store(&result[1].x, r1);
+    store(&result[2].x, r2);
+    store(&result[3].x, translation);
+    result[3].w = 1.0f;
+#else
+    matrixOrthoNormalInvertScalar(result, mat);
+#endif
+}
+
 inline void vectorNormalize(float3& v)
 {
     float k = 1.f / sqrtf((v.x * v.x) + (v.y * v.y) + (v.z * v.z));
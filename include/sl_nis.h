@@ -41,8 +41,19 @@ enum class NISHDR : uint32_t
     eCount
 };
 
+enum class NISOutputEncoding : uint32_t
+{
+    //! Output is written with the same encoding as the input
+    eNone,
+    //! Linear HDR input ('NISHDR::eLinear', scRGB where 1.0 is 80 nits) is written as Rec.2020 PQ, e.g. for HDR10 swap chains
+    ePQ,
+    //! PQ input ('NISHDR::ePQ') is written as linear scRGB
+    eScRGB,
+    eCount
+};
+
 // {676610E5-9674-4D3A-9C8A-F495D01B36F3}
-SL_STRUCT_BEGIN(NISOptions, StructType({ 0x676610e5, 0x9674, 0x4d3a, { 0x9c, 0x8a, 0xf4, 0x95, 0xd0, 0x1b, 0x36, 0xf3 } }), kStructVersion1)
+SL_STRUCT_BEGIN(NISOptions, StructType({ 0x676610e5, 0x9674, 0x4d3a, { 0x9c, 0x8a, 0xf4, 0x95, 0xd0, 0x1b, 0x36, 0xf3 } }), kStructVersion3)
     //! Specifies which mode should be used
     NISMode mode = NISMode::eScaler;
     //! Specifies which hdr mode should be used
@@ -50,6 +61,18 @@ SL_STRUCT_BEGIN(NISOptions, StructType({ 0x676610e5, 0x9674, 0x4d3a, { 0x9c, 0x8
     //! Specifies sharpening level in range [0,1]
     float sharpness = 0.0f;
 
+    //! Version 2 members:
+    //! Encodes the output in the NIS kernel so no extra full resolution pass is needed, conversion to the
+    //! output texture format is done by the typed store
+    NISOutputEncoding outputEncoding = NISOutputEncoding::eNone;
+    //! Bit depth of the output format (e.g. 8 or 10) to dither to, 0 disables dithering, ignored for scRGB output
+    uint32_t ditherBits = 0;
+
+    //! Version 3 members:
+    //! Records the NIS dispatch once per viewport and replays it as a bundle, re-recorded only when the inputs,
+    //! outputs or options change. D3D12 direct command lists only, other cases record the dispatch every frame
+    Boolean reuseCommandList = Boolean::eFalse;
+
     //! IMPORTANT: New members go here or if optional can be chained in a new struct, see sl_struct.h for details
 SL_STRUCT_END()
 
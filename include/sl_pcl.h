@@ -103,12 +103,56 @@ private:
     PCLMarker marker;
 SL_STRUCT_END()
 
+//! Marker timestamp captured in process, see PCLMarkerCaptureOptions
+struct PCLMarkerTimestamp
+{
+    PCLMarker marker;
+    //! Thread which set the marker
+    uint32_t threadId;
+    uint64_t frameId;
+    //! QueryPerformanceCounter value when the marker was set
+    int64_t qpc;
+};
+
+// {cfa32f9b-023c-420e-9056-6832b74f89b7}
+SL_STRUCT_BEGIN(PCLMarkerCaptureOptions, StructType({ 0xcfa32f9b, 0x023c, 0x420e, { 0x90, 0x56, 0x68, 0x32, 0xb7, 0x4f, 0x89, 0xb7 } }), kStructVersion1)
+    //! Records every marker with its QPC timestamp into a per thread ring, off by default
+    //!
+    //! Chain to PCLOptions when calling slPCLSetOptions. The ring is also published as a named
+    //! shared memory section (see PCLMarkerTimestamps::sharedMemoryName) so an external overlay
+    //! can follow frame phases without ETW.
+    Boolean enable = Boolean::eFalse;
+
+    //! IMPORTANT: New members go here or if optional can be chained in a new struct, see sl_struct.h for details
+SL_STRUCT_END()
+
+// {cfa32f9b-023c-420e-9056-6832b74f89b8}
+SL_STRUCT_BEGIN(PCLMarkerTimestamps, StructType({ 0xcfa32f9b, 0x023c, 0x420e, { 0x90, 0x56, 0x68, 0x32, 0xb7, 0x4f, 0x89, 0xb8 } }), kStructVersion1)
+    //! In: storage for timestamps, can be null to only query the fields below
+    PCLMarkerTimestamp* timestamps{};
+    uint32_t capacity = 0;
+    //! In/out: only timestamps newer than this QPC are returned and it is advanced to the newest one returned,
+    //! start with 0 and keep passing the same value back to stream all markers in order
+    int64_t sinceQpc = 0;
+    //! Out: number of timestamps written, oldest first
+    //!
+    //! Each thread keeps its last 1023 markers, poll at least that often to not miss any.
+    uint32_t count = 0;
+    //! Out: QueryPerformanceFrequency
+    int64_t qpcFrequency = 0;
+    //! Out: name of the shared memory section, null if capture is not enabled
+    const char* sharedMemoryName{};
+
+    //! IMPORTANT: New members go here or if optional can be chained in a new struct, see sl_struct.h for details
+SL_STRUCT_END()
+
 
 }
 
 //! Provides PCL settings
 //!
 //! Call this method to get stats etc.
+//! Chain PCLMarkerTimestamps to the state to also read captured marker timestamps.
 //!
 //! @param state Reference to a structure where states are returned
 //! @return sl::ResultCode::eOk if successful, error code otherwise (see sl_result.h for details)
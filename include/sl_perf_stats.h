@@ -0,0 +1,129 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+namespace sl
+{
+
+//! SL overhead of the last presented frame, counters from all threads are summed when the frame is presented
+//!
+//! Collected in every build, including production, so it can be used for telemetry.
+// {e4d3209e-3446-4050-8243-30beea35a117}
+SL_STRUCT_BEGIN(SLPerfStats, StructType({ 0xe4d3209e, 0x3446, 0x4050, { 0x82, 0x43, 0x30, 0xbe, 0xea, 0x35, 0xa1, 0x17 } }), kStructVersion2)
+    //! Number of frames presented since 'slInit', counters below are all zero until the first present
+    uint64_t frameCount{};
+    //! CPU time in nanoseconds and number of calls for 'slSetTag' and 'slSetTagForFrame', volatile tag copies included
+    uint64_t setTagCpuNs{};
+    uint64_t setTagCalls{};
+    //! CPU time in nanoseconds and number of calls for 'slSetConstants'
+    uint64_t setConstantsCpuNs{};
+    uint64_t setConstantsCalls{};
+    //! CPU time in nanoseconds and number of calls for 'slEvaluateFeature', feature work recorded by plugins included
+    uint64_t evaluateCpuNs{};
+    uint64_t evaluateCalls{};
+    //! CPU time in nanoseconds spent in plugin present hooks and number of hooks invoked
+    uint64_t hooksCpuNs{};
+    uint64_t hookCalls{};
+    //! GPU time in nanoseconds of SL passes and number of passes, timestamps are read back with a few frames of latency
+    //! so these belong to an earlier frame than the CPU counters
+    uint64_t gpuPassNs{};
+    uint64_t gpuPasses{};
+    //! Estimated bytes copied for tags marked as 'ResourceLifecycle::eOnlyValidNow'
+    uint64_t volatileTagBytes{};
+    //! Resource barriers recorded by SL
+    uint64_t barriers{};
+    //! Requests to the internal resource pools and how many of them had to create a new resource
+    uint64_t poolAllocations{};
+    uint64_t poolMisses{};
+    // kStructVersion2
+    //! Heap allocations made by SL modules, only counted when SL is built with allocation tracking, zero otherwise
+    uint64_t heapAllocations{};
+
+    //! IMPORTANT: New members go here or if optional can be chained in a new struct, see sl_struct.h for details
+SL_STRUCT_END()
+
+//! Blocking wait inside SL which took longer than 'SLHitchReport::thresholdUs'
+struct SLHitch
+{
+    //! Where SL was waiting, for example "D3D12::waitCPUFence" or "ResourcePool::allocate"
+    char site[64];
+    //! Value of 'SLPerfStats::frameCount' when the wait finished
+    uint64_t frame;
+    //! Steady clock time when the wait finished and how long it took, both in microseconds
+    uint64_t timestampUs;
+    uint64_t durationUs;
+    uint32_t threadId;
+};
+
+//! Most recent SL hitches, newest first
+//!
+//! Collected in every build. Threshold defaults to 1ms, 'SL_HITCH_THRESHOLD_US' environment variable overrides it.
+// {2850b33d-b04c-4a84-8006-a7b34a26ca40}
+SL_STRUCT_BEGIN(SLHitchReport, StructType({ 0x2850b33d, 0xb04c, 0x4a84, { 0x80, 0x06, 0xa7, 0xb3, 0x4a, 0x26, 0xca, 0x40 } }), kStructVersion1)
+    //! Provided by the host, 'maxHitches' entries are available
+    SLHitch* hitches{};
+    uint32_t maxHitches{};
+    //! Entries written to 'hitches', SL keeps the last 256 hitches
+    uint32_t numHitches{};
+    //! Hitches recorded since 'slInit', including the ones no longer kept
+    uint64_t totalHitches{};
+    uint64_t thresholdUs{};
+
+    //! IMPORTANT: New members go here or if optional can be chained in a new struct, see sl_struct.h for details
+SL_STRUCT_END()
+
+}
+
+//! Provides SL overhead counters for the last presented frame
+//!
+//! Call this method once per frame, for example after present, to collect telemetry.
+//!
+//! @param stats Reference to a structure where counters are returned
+//! @return sl::ResultCode::eOk if successful, error code otherwise (see sl_result.h for details)
+//!
+//! This method is thread safe.
+using PFun_slGetPerfStats = sl::Result(sl::SLPerfStats& stats);
+
+//! Provides the most recent blocking waits inside SL which took longer than the threshold
+//!
+//! Hitches are also reported in the SL log, at most one message per second.
+//!
+//! @param report Reference to a structure where hitches are returned, 'hitches' can be null to only query the totals
+//! @return sl::ResultCode::eOk if successful, error code otherwise (see sl_result.h for details)
+//!
+//! This method is thread safe.
+using PFun_slGetHitches = sl::Result(sl::SLHitchReport& report);
+
+//! HELPERS
+//!
+inline sl::Result slGetPerfStats(sl::SLPerfStats& stats)
+{
+    SL_FEATURE_FUN_IMPORT_STATIC(sl::kFeatureCommon, slGetPerfStats);
+    return s_slGetPerfStats(stats);
+}
+
+inline sl::Result slGetHitches(sl::SLHitchReport& report)
+{
+    SL_FEATURE_FUN_IMPORT_STATIC(sl::kFeatureCommon, slGetHitches);
+    return s_slGetHitches(report);
+}
@@ -39,7 +39,7 @@ enum ReflexMode
 };
 
 // {F03AF81A-6D0B-4902-A651-C4965E215434}
-SL_STRUCT_BEGIN(ReflexOptions, StructType({ 0xf03af81a, 0x6d0b, 0x4902, { 0xa6, 0x51, 0xc4, 0x96, 0x5e, 0x21, 0x54, 0x34 } }), kStructVersion1)
+SL_STRUCT_BEGIN(ReflexOptions, StructType({ 0xf03af81a, 0x6d0b, 0x4902, { 0xa6, 0x51, 0xc4, 0x96, 0x5e, 0x21, 0x54, 0x34 } }), kStructVersion3)
     //! Specifies which mode should be used
     ReflexMode mode = ReflexMode::eOff;
     //! Specifies if frame limiting (FPS cap) is enabled (0 to disable, microseconds otherwise).
@@ -58,6 +58,19 @@ SL_STRUCT_BEGIN(ReflexOptions, StructType({ 0xf03af81a, 0x6d0b, 0x4902, { 0xa6,
     //! Most integrations should leave unset unless advised otherwise by the Reflex team
     uint32_t idThread = 0;
 
+    //! Version 2 members:
+    //! Picks the frame limit automatically from the latency reports, keeping the GPU just under saturation
+    //! so the render queue does not build up. When set, 'frameLimitUs' is the lowest limit (highest FPS) allowed.
+    //! Requires Reflex Low Latency to be available.
+    bool adaptiveFrameLimit = false;
+
+    //! Version 3 members:
+    //! Delays simulation start in slReflexSleep so frames are presented on an even cadence, reducing frame-to-frame jitter.
+    //! Under fixed refresh (D3D exclusive or independent flip) the cadence snaps to whole refresh intervals and presents
+    //! are phased just ahead of vblank, otherwise (VRR, windowed, Vulkan) frames are spaced by the recent median frame time.
+    //! Works on any GPU but requires slReflexSleep and PCL simulation/present markers every frame.
+    bool framePacing = false;
+
     //! IMPORTANT: New members go here or if optional can be chained in a new struct, see sl_struct.h for details
 SL_STRUCT_END()
 
@@ -187,6 +200,20 @@ using PFun_slReflexSetCameraData = sl::Result(const sl::ViewportHandle& viewport
 //! This method is thread safe.
 using PFun_slReflexGetPredictedCameraData = sl::Result(const sl::ViewportHandle& viewport, const sl::FrameToken& frame, sl::ReflexPredictedCameraData& outCameraData);
 
+//! Gets latency reports collected since the last call
+//!
+//! The first call starts a background poller which keeps a ring of the latest reports, deduplicated by frame id.
+//! Reports are not copied, 'reports' points straight into the ring and stays valid for at least 4000 frames.
+//! Call again until 'count' is 0 to drain reports split by the ring wrap around.
+//!
+//! @param cursor Index of the first report to return, use 0 on the first call. Advanced past the returned reports.
+//! @param reports Pointer to the first new report or null if none
+//! @param count Number of consecutive reports at 'reports'
+//! @return sl::ResultCode::eOk if successful, error code otherwise (see sl_result.h for details)
+//!
+//! This method is thread safe, each consumer should keep its own cursor.
+using PFun_slReflexGetLatencyReports = sl::Result(uint64_t& cursor, const sl::ReflexReport*& reports, uint32_t& count);
+
 //! HELPERS
 //! 
 inline sl::Result slReflexGetState(sl::ReflexState& state)
@@ -219,3 +246,9 @@ inline sl::Result slReflexGetPredictedCameraData(const sl::ViewportHandle& viewp
     return s_slReflexGetPredictedCameraData(viewport, frame, outCameraData);
 }
 
+inline sl::Result slReflexGetLatencyReports(uint64_t& cursor, const sl::ReflexReport*& reports, uint32_t& count)
+{
+    SL_FEATURE_FUN_IMPORT_STATIC(sl::kFeatureReflex, slReflexGetLatencyReports);
+    return s_slReflexGetLatencyReports(cursor, reports, count);
+}
+
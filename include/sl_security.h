@@ -328,7 +328,9 @@ bool isSignedByNVIDIA(const wchar_t* pathToFile)
 //! See https://docs.microsoft.com/en-us/windows/win32/seccrypto/example-c-program--verifying-the-signature-of-a-pe-file
 //! 
 //! IMPORTANT: Always pass in the FULL PATH to the file, relative paths are NOT allowed!
-bool verifyEmbeddedSignature(const wchar_t* pathToFile)
+//! 
+//! Optional 'file' is an open handle to the same file with at least read access, WinVerifyTrust then checks that handle
+bool verifyEmbeddedSignature(const wchar_t* pathToFile, HANDLE file = NULL)
 {
     bool valid = true;
 
@@ -340,7 +342,7 @@ bool verifyEmbeddedSignature(const wchar_t* pathToFile)
     memset(&FileData, 0, sizeof(FileData));
     FileData.cbStruct = sizeof(WINTRUST_FILE_INFO);
     FileData.pcwszFilePath = pathToFile;
-    FileData.hFile = NULL;
+    FileData.hFile = file;
     FileData.pgKnownSubject = NULL;
 
     if (!pfnWinVerifyTrust)
@@ -217,10 +217,12 @@ copy %src%\include\sl_consts.h          %dest%\include
 copy %src%\include\sl_core_api.h        %dest%\include
 copy %src%\include\sl_core_types.h      %dest%\include
 copy %src%\include\sl_device_wrappers.h %dest%\include
+copy %src%\include\sl_headless.h        %dest%\include
 copy %src%\include\sl_helpers.h         %dest%\include
 copy %src%\include\sl_helpers_vk.h      %dest%\include
 copy %src%\include\sl_hooks.h           %dest%\include
 copy %src%\include\sl_matrix_helpers.h  %dest%\include
+copy %src%\include\sl_perf_stats.h      %dest%\include
 copy %src%\include\sl_result.h          %dest%\include
 copy %src%\include\sl_security.h        %dest%\include
 copy %src%\include\sl_struct.h          %dest%\include
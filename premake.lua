@@ -49,6 +49,23 @@ newoption {
 	default = "yes"
 }
 
+newoption {
+	trigger = "with-trace",
+	description = "Instrumentation zones for external profilers",
+	allowed = {
+		{"no", "No zones, macros compile to nothing"},
+		{"etw", "ETW events via TraceLogging"},
+		{"tracy", "Tracy zones, requires Tracy client in external/tracy"},
+		{"all", "ETW events and Tracy zones"}
+	},
+	default = "no"
+}
+
+newoption {
+	trigger = "with-alloc-tracking",
+	description = "Count heap allocations made by SL modules, warns when frames allocate in steady state"
+}
+
 newoption {
 	trigger = "with-toolset",
 	description = "Specify premake toolset"
@@ -184,6 +201,18 @@ workspace "streamline"
 	-- building makefiles
 	cppdialect "C++20"
 	
+	-- Each SL module imports the host's TracyClient.dll so zones land in the engine's Tracy session
+	filter { "options:with-trace=etw or with-trace=all", "system:windows" }
+		defines { "SL_TRACE_ETW=1" }
+	filter { "options:with-trace=tracy or with-trace=all" }
+		defines { "SL_TRACE_TRACY=1", "TRACY_ENABLE", "TRACY_IMPORTS" }
+		includedirs { EXTERNAL .. "tracy/public" }
+		libdirs { EXTERNAL .. "tracy/lib" }
+		links { "TracyClient.lib" }
+	filter { "options:with-alloc-tracking" }
+		defines { "SL_TRACK_ALLOCATIONS=1" }
+	filter {}
+
 	filter "configurations:Debug"
 		defines { "DEBUG", "SL_ENABLE_TIMING=1", "SL_DEBUG" }
 		if _OPTIONS["use-debug-runtime"] then
@@ -204,7 +233,7 @@ workspace "streamline"
 		optimize "On"
 		flags { "LinkTimeOptimization" }
 
-	filter { "files:**.hlsl" }
+	filter { "files:**.hlsl", "files:not **_sm66.hlsl" }
 		buildmessage 'Compiling shader %{file.relpath} to DXBC/SPIRV with slang'
 		local shaders_output = out_dir() .. "shaders/"
         buildcommands {
@@ -219,6 +248,18 @@ workspace "streamline"
 		 buildoutputs { shaders_output .. "%{file.basename}.spv", shaders_output .. "%{file.basename}.cs" }
 		 -- One or more additional dependencies for this build command (optional)
 		 --buildinputs { 'path/to/file1.ext', 'path/to/file2.ext' }
+
+	-- D3D12 only, bindless variants index 'ResourceDescriptorHeap' which needs SM 6.6 DXIL, see 'shaders/bindless.hlsli'
+	filter { "files:**_sm66.hlsl" }
+		buildmessage 'Compiling shader %{file.relpath} to DXIL with slang'
+		local shaders_output = out_dir() .. "shaders/"
+		buildcommands {
+			path.translate(EXTERNAL .. "slang/bin/windows-x64/release/") .. 'slangc "%{file.relpath}" -profile sm_6_6 -entry main -target dxil -o "' .. shaders_output .. '%{file.basename}.cs"',
+			'pushd ' .. path.translate(shaders_output),
+			'powershell.exe -NoProfile -ExecutionPolicy Bypass ' .. path.translate(TOOLS) .. 'bin2cheader.ps1 -i "%{file.basename}.cs" > "%{file.basename}_cs.h"',
+			'popd'
+		}
+		buildoutputs { shaders_output .. "%{file.basename}.cs" }
 	
 	filter { "files:**.json" }
 		buildmessage 'Compiling %{file.relpath} to %{file.basename}_json.h'
@@ -363,9 +404,12 @@ project "sl.compute"
 		end
 		files {
 			"./source/platforms/sl.chi/capture.h",
+			"./source/platforms/sl.chi/captureCodec.h",
+			"./source/platforms/sl.chi/imageCodec.h",
 			"./source/platforms/sl.chi/capture.cpp",
 			"./source/platforms/sl.chi/compute.h",
 			"./source/platforms/sl.chi/generic.h",
+			"./source/platforms/sl.chi/hash.h",
 			"./source/platforms/sl.chi/d3d12.cpp",
 			"./source/platforms/sl.chi/d3d12.h",
 			"./source/platforms/sl.chi/d3d11.cpp",
@@ -384,9 +428,12 @@ project "sl.compute"
 		files {
 			"./shaders/**.hlsl",
 			"./source/platforms/sl.chi/capture.h",
+			"./source/platforms/sl.chi/captureCodec.h",
+			"./source/platforms/sl.chi/imageCodec.h",
 			"./source/platforms/sl.chi/capture.cpp",
 			"./source/platforms/sl.chi/compute.h",
 			"./source/platforms/sl.chi/generic.h",
+			"./source/platforms/sl.chi/hash.h",
 			"./source/platforms/sl.chi/vulkan.cpp",
 			"./source/platforms/sl.chi/vulkan.h",
 			"./source/platforms/sl.chi/generic.cpp"	
@@ -736,3 +783,58 @@ if (os.isdir("./source/plugins/sl.nvperf")) then
 end
 
 group ""
+
+group "tools"
+
+if os.host() == "windows" then
+	project "sl.replay"
+		kind "ConsoleApp"
+		targetdir (out_dynamic_lib_dir())
+		objdir (out_obj_dir())
+		characterset ("MBCS")
+		dependson { "sl.interposer"}
+
+		files {
+			"./source/tools/sl.replay/**.h",
+			"./source/tools/sl.replay/**.cpp"
+		}
+
+		vpaths { ["impl"] = {"./source/tools/sl.replay/**.h", "./source/tools/sl.replay/**.cpp" }}
+
+		links { "sl.interposer", "d3d12.lib", "dxgi.lib"}
+
+	project "sl.benchmarks"
+		kind "ConsoleApp"
+		targetdir (out_dynamic_lib_dir())
+		objdir (out_obj_dir())
+		characterset ("MBCS")
+		dependson { "sl.compute"}
+
+		filter { filter_platforms }
+			includedirs { "./external/nvapi" }
+		filter{}
+
+		-- Core and sl.common code under test is compiled in directly, no plugins or interposer involved
+		files {
+			"./source/tools/sl.benchmarks/**.h",
+			"./source/tools/sl.benchmarks/**.cpp",
+			"./source/core/sl.param/**.cpp",
+			"./source/core/sl.log/**.cpp",
+			"./source/core/sl.exception/**.cpp",
+			"./source/plugins/sl.common/resourceTaggingForFrame.cpp"
+		}
+
+		vpaths { ["impl"] = {"./source/tools/sl.benchmarks/**.h", "./source/tools/sl.benchmarks/**.cpp" }}
+		vpaths { ["core"] = {"./source/core/**.cpp", "./source/plugins/sl.common/**.cpp" }}
+
+		libdirs {EXTERNAL .. "nvapi/amd64", EXTERNAL .."vulkan/Lib"}
+		links { "d3d12.lib", "dxgi.lib", "dxguid.lib", "vulkan-1.lib", "dbghelp.lib", "Version.lib", "nvapi64.lib", (out_static_lib_dir("sl.compute") .. "sl.compute.lib")}
+
+		filter { "options:with-nvllvk=yes" }
+			defines { "SL_WITH_NVLLVK" }
+			links { "NvLowLatencyVk.lib" }
+			linkoptions { "/DELAYLOAD:NvLowLatencyVk.dll" }
+		filter {}
+end
+
+group ""
@@ -0,0 +1,35 @@
+// Resource declarations shared by the regular and the SM 6.6 bindless builds of a kernel
+//
+// 'slot' is the 'pos' chi binds the resource at, in the bindless build resources are fetched from
+// 'ResourceDescriptorHeap' using the index chi stores at that position in the root constants.
+// Declare with 'SL_RESOURCE' at global scope and fetch with 'SL_FETCH' at the top of the entry point.
+//
+// Bindless builds compile '<name>_sm66.hlsl' which defines SL_BINDLESS before including '<name>.hlsl'
+
+#ifndef SL_BINDLESS
+#define SL_BINDLESS 0
+#endif
+
+#if SL_BINDLESS
+
+// Matches 'kMaxBindlessBindings' and the root signature layout in 'D3D12::dispatchBindless'
+struct SLBindlessIndices
+{
+    uint4 indices[4];
+};
+ConstantBuffer<SLBindlessIndices> gSLBindless : register(b0, space1);
+
+uint slBindlessIndex(uint slot)
+{
+    return gSLBindless.indices[slot / 4][slot % 4];
+}
+
+#define SL_RESOURCE(type, name, slot, reg) static const uint name##Slot = slot
+#define SL_FETCH(type, name, slot) type name = ResourceDescriptorHeap[slBindlessIndex(slot)]
+
+#else
+
+#define SL_RESOURCE(type, name, slot, reg) [[vk::binding(slot)]] type name : register(reg)
+#define SL_FETCH(type, name, slot)
+
+#endif
@@ -0,0 +1,40 @@
+// Capture region of interest, downsampling and format conversion
+//
+// Box filters 'downsample' x 'downsample' source pixels into one output pixel, the format of the
+// output texture does the conversion on store
+[[vk::binding(0)]] Texture2D<float4> texSrc : register(t0);
+[[vk::binding(1)]] RWTexture2D<float4> rwDst : register(u0);
+
+[[vk::binding(2)]] cbuffer shaderConsts : register(b0)
+{
+    // Region origin in source pixels
+    uint2 origin;
+    // Output size in pixels
+    uint2 size;
+    // Last source pixel inside the region, partial blocks at the edges are clamped to it
+    uint2 last;
+    uint downsample;
+    uint padding;
+};
+
+[shader("compute")]
+[numthreads(16, 16, 1)]
+void main(uint3 DTid : SV_DispatchThreadID)
+{
+    uint2 pixelId = DTid.xy;
+    if (any(pixelId >= size))
+    {
+        return;
+    }
+
+    uint2 base = origin + pixelId * downsample;
+    float4 sum = 0.0;
+    for (uint y = 0; y < downsample; y++)
+    {
+        for (uint x = 0; x < downsample; x++)
+        {
+            sum += texSrc[min(base + uint2(x, y), last)];
+        }
+    }
+    rwDst[pixelId] = sum / float(downsample * downsample);
+}
@@ -6,17 +6,25 @@
 [[vk::binding(1)]] Texture2D<float4>  gSrc    : register(t0);
 [[vk::binding(2)]] RWTexture2D<float4> outDst : register(u0);
 
+// Each thread copies a 2x2 quad so a group still covers a 16x16 tile, callers dispatch (size + 15) / 16 groups
 [shader("compute")]
-[numthreads(16, 16, 1)]
+[numthreads(8, 8, 1)]
 void main( uint3 DTid : SV_DispatchThreadID)
 {
-  uint2 pos = DTid.xy;
-  if ( any ( pos >= (uint2)sizeAndInvSize.xy ) )
+  uint2 size = (uint2)sizeAndInvSize.xy;
+  uint2 base = DTid.xy * 2;
+  if ( any ( base >= size ) )
   {
     return;
   }
 
-  outDst[pos] = gSrc[pos];  
+  [unroll]
+  for (uint i = 0; i < 4; i++)
+  {
+    uint2 pos = base + uint2(i & 1, i >> 1);
+    if ( all ( pos < size ) )
+    {
+      outDst[pos] = gSrc.Load(int3(pos, 0));
+    }
+  }
 }
-
-
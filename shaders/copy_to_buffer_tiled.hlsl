@@ -0,0 +1,62 @@
+[[vk::binding(0)]] cbuffer shaderConsts : register(b0)
+{
+  float4 sizeAndInvSize; 
+}
+    
+[[vk::binding(1)]] Texture2D<float4>  gSrc    : register(t0);
+[[vk::binding(2)]] RWByteAddressBuffer outDst : register(u0); // RGB32F buffer, same layout as 'copy_to_buffer.hlsl'
+
+// Tile is staged in groupshared memory so consecutive lanes write consecutive 16 bytes of the buffer
+// instead of each lane storing its own 12 byte texel. Rows start 16 byte aligned when the width is a multiple of 4.
+groupshared uint3 gTile[16][16];
+
+static const uint kTileSize = 16;
+static const uint kChunksPerRow = kTileSize * 3 / 4;
+
+[shader("compute")]
+[numthreads(16, 16, 1)]
+void main( uint3 groupId : SV_GroupID, uint3 groupThreadId : SV_GroupThreadID, uint groupIndex : SV_GroupIndex)
+{
+  uint2 size = (uint2)sizeAndInvSize.xy;
+  uint2 origin = groupId.xy * kTileSize;
+  uint2 pixelId = origin + groupThreadId.xy;
+  if ( all ( pixelId < size ) )
+  {
+    gTile[groupThreadId.y][groupThreadId.x] = asuint(gSrc.Load(int3(pixelId, 0)).xyz);
+  }
+  GroupMemoryBarrierWithGroupSync();
+
+  // Each tile row is 48 dwords, written as 12 Store4 by consecutive lanes
+  uint row = groupIndex / kChunksPerRow;
+  uint firstDword = (groupIndex % kChunksPerRow) * 4;
+  uint rowDwords = min(kTileSize, size.x - origin.x) * 3;
+  uint y = origin.y + row;
+  if ( row >= kTileSize || y >= size.y || firstDword >= rowDwords )
+  {
+    return;
+  }
+
+  uint4 value;
+  [unroll]
+  for (uint i = 0; i < 4; i++)
+  {
+    uint dword = min(firstDword + i, rowDwords - 1);
+    uint3 texel = gTile[row][dword / 3];
+    uint channel = dword % 3;
+    value[i] = channel == 0 ? texel.x : (channel == 1 ? texel.y : texel.z);
+  }
+
+  uint byteOffset = ((y * size.x + origin.x) * 3 + firstDword) * 4;
+  if ( firstDword + 4 <= rowDwords )
+  {
+    outDst.Store4(byteOffset, value);
+  }
+  else
+  {
+    // Partial chunk at the right edge of the texture
+    for (uint i = 0; i < rowDwords - firstDword; i++)
+    {
+      outDst.Store(byteOffset + i * 4, value[i]);
+    }
+  }
+}
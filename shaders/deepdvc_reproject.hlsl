@@ -0,0 +1,54 @@
+// DeepDVC result reuse with motion compensation
+//
+// Reprojects the enhancement delta of the previous frame to the current one, stores it for the next
+// frame in line and applies it to the color
+[[vk::binding(0)]] RWTexture2D<float4> rwColor : register(u0);
+[[vk::binding(1)]] RWTexture2D<float4> rwDelta : register(u1);
+[[vk::binding(2)]] RWTexture2D<float4> rwDeltaPrev : register(u2);
+[[vk::binding(3)]] Texture2D<float4> texMVec : register(t0);
+
+[[vk::binding(4)]] cbuffer shaderConsts : register(b0)
+{
+    // Color subrect origin and size in pixels
+    uint2 origin;
+    uint2 size;
+    // Motion vector subrect origin and size in pixels, can be lower resolution than color
+    uint2 mvecOrigin;
+    uint2 mvecSize;
+    // Normalizes motion vectors to [-1,1] range
+    float2 mvecScale;
+    uint2 padding;
+};
+
+float4 loadDeltaPrev(int2 pixelId)
+{
+    return rwDeltaPrev[clamp(pixelId, int2(0, 0), int2(size) - 1)];
+}
+
+[shader("compute")]
+[numthreads(16, 16, 1)]
+void main(uint3 DTid : SV_DispatchThreadID)
+{
+    uint2 pixelId = DTid.xy;
+    if (any(pixelId >= size))
+    {
+        return;
+    }
+
+    float2 uv = (float2(pixelId) + 0.5) / float2(size);
+    uint2 mvecId = mvecOrigin + min(uint2(uv * float2(mvecSize)), mvecSize - 1);
+    // Vectors point from the current to the previous frame
+    float2 prevPos = (uv + texMVec[mvecId].xy * mvecScale) * float2(size) - 0.5;
+
+    // Bilinear filter by hand, delta is only accessed through UAVs
+    int2 base = int2(floor(prevPos));
+    float2 w = prevPos - float2(base);
+    float4 delta = lerp(lerp(loadDeltaPrev(base), loadDeltaPrev(base + int2(1, 0)), w.x),
+                        lerp(loadDeltaPrev(base + int2(0, 1)), loadDeltaPrev(base + int2(1, 1)), w.x), w.y);
+    rwDelta[pixelId] = delta;
+
+    uint2 colorId = origin + pixelId;
+    float4 color = rwColor[colorId];
+    // Alpha is passed through untouched
+    rwColor[colorId] = float4(max(color.rgb + delta.rgb, 0.0), color.a);
+}
@@ -0,0 +1,48 @@
+// DeepDVC result reuse for frames the network is not evaluated on
+//
+// The enhancement is kept as a delta from the input so it can be applied to a different frame
+[[vk::binding(0)]] RWTexture2D<float4> rwColor : register(u0);
+[[vk::binding(1)]] RWTexture2D<float4> rwDelta : register(u1);
+
+[[vk::binding(2)]] cbuffer shaderConsts : register(b0)
+{
+    // Color subrect origin and size in pixels
+    uint2 origin;
+    uint2 size;
+    // 0 capture input, 1 store delta from enhanced output, 2 apply delta
+    uint mode;
+    uint3 padding;
+};
+
+#define DEEPDVC_REUSE_CAPTURE 0
+#define DEEPDVC_REUSE_STORE 1
+#define DEEPDVC_REUSE_APPLY 2
+
+[shader("compute")]
+[numthreads(16, 16, 1)]
+void main(uint3 DTid : SV_DispatchThreadID)
+{
+    uint2 pixelId = DTid.xy;
+    if (any(pixelId >= size))
+    {
+        return;
+    }
+
+    uint2 colorId = origin + pixelId;
+    float4 color = rwColor[colorId];
+
+    [branch]
+    if (mode == DEEPDVC_REUSE_CAPTURE)
+    {
+        rwDelta[pixelId] = color;
+    }
+    else if (mode == DEEPDVC_REUSE_STORE)
+    {
+        rwDelta[pixelId] = color - rwDelta[pixelId];
+    }
+    else
+    {
+        // Alpha is passed through untouched
+        rwColor[colorId] = float4(max(color.rgb + rwDelta[pixelId].rgb, 0.0), color.a);
+    }
+}
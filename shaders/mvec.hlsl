@@ -1,6 +1,8 @@
-[[vk::binding(0)]] Texture2D<float4> texMVec : register(t0);
-[[vk::binding(1)]] Texture2D<float4> texDepth : register(t1);
-[[vk::binding(2)]] RWTexture2D<float2> rwtexMVec : register(u0);
+#include "bindless.hlsli"
+
+SL_RESOURCE(Texture2D<float4>, texMVec, 0, t0);
+SL_RESOURCE(Texture2D<float4>, texDepth, 1, t1);
+SL_RESOURCE(RWTexture2D<float2>, rwtexMVec, 2, u0);
 
 [[vk::binding(3)]] cbuffer shaderConsts : register(b0)
 {
@@ -8,12 +10,19 @@
     float4 textureSize;
     float2 mvecScale;
     uint showMvec;
+    uint padding;
+    // Pixel space jitter difference (current - previous) included in the engine vectors, zero if not jittered
+    float2 jitterDelta;
 };
 
 [shader("compute")]
 [numthreads(16, 16, 1)]
 void main(uint3 DTid : SV_DispatchThreadID)
 {
+    SL_FETCH(Texture2D<float4>, texMVec, 0);
+    SL_FETCH(Texture2D<float4>, texDepth, 1);
+    SL_FETCH(RWTexture2D<float2>, rwtexMVec, 2);
+
     uint2 pixelId = DTid.xy;
     float2 pixelCenter = float2(pixelId)+0.5;
 
@@ -23,6 +32,7 @@ void main(uint3 DTid : SV_DispatchThreadID)
     }
 
     float2 velocity = texMVec[pixelId].xy;
+    float2 jitter = 0;
 
     [branch]
     if (any(velocity > 1.0) || any(velocity < -1.0) || all(velocity == 0.0))
@@ -37,7 +47,9 @@ void main(uint3 DTid : SV_DispatchThreadID)
     else
     {
         velocity *= mvecScale; // to -1,1 range
+        // Camera motion above is computed without jitter, same must hold for engine vectors
+        jitter = jitterDelta;
     }
     if (showMvec != 0) velocity *= textureSize.xy * 10.0f;
-    rwtexMVec[pixelId] = float2(-velocity) * textureSize.xy; // to pixel space
+    rwtexMVec[pixelId] = float2(-velocity) * textureSize.xy - jitter; // to pixel space
 }
@@ -0,0 +1,113 @@
+#include "bindless.hlsli"
+
+SL_RESOURCE(Texture2D<float4>, texMVec, 0, t0);
+SL_RESOURCE(Texture2D<float4>, texDepth, 1, t1);
+SL_RESOURCE(RWTexture2D<float2>, rwtexMVec, 2, u0);
+
+// Same layout as 'mvec.hlsl' followed by the dilation controls
+[[vk::binding(3)]] cbuffer shaderConsts : register(b0)
+{
+    float4x4 currentToPreviousClipMatrixNoOffset;
+    float4 textureSize;
+    float2 mvecScale;
+    uint showMvec;
+    uint padding;
+    // Pixel space jitter difference (current - previous) included in the engine vectors, zero if not jittered
+    float2 jitterDelta;
+    // Non zero if larger depth values are closer to the camera
+    uint depthInverted;
+    // Non zero if engine vectors do not include camera motion, zero vectors are then reconstructed like in 'mvec.hlsl'
+    uint reconstructZero;
+};
+
+// One bit per pixel, 256 bits per 16x16 tile with tiles stored row major, bit 'y * 16 + x' is set if the
+// vector picked for that pixel was invalid and got replaced with camera motion
+SL_RESOURCE(RWByteAddressBuffer, rwInvalidMask, 4, u1);
+
+static const uint kTileSize = 16;
+static const uint kApronSize = kTileSize + 2;
+
+groupshared float gDepth[kApronSize][kApronSize];
+groupshared uint gInvalid[kTileSize * kTileSize / 32];
+
+[shader("compute")]
+[numthreads(16, 16, 1)]
+void main(uint3 groupId : SV_GroupID, uint3 groupThreadId : SV_GroupThreadID, uint groupIndex : SV_GroupIndex)
+{
+    SL_FETCH(Texture2D<float4>, texMVec, 0);
+    SL_FETCH(Texture2D<float4>, texDepth, 1);
+    SL_FETCH(RWTexture2D<float2>, rwtexMVec, 2);
+    SL_FETCH(RWByteAddressBuffer, rwInvalidMask, 4);
+
+    int2 size = (int2)textureSize.xy;
+
+    // Depth tile with a one pixel apron, clamped at the texture edges
+    int2 apronOrigin = int2(groupId.xy * kTileSize) - 1;
+    for (uint i = groupIndex; i < kApronSize * kApronSize; i += kTileSize * kTileSize)
+    {
+        int2 pos = clamp(apronOrigin + int2(i % kApronSize, i / kApronSize), 0, size - 1);
+        gDepth[i / kApronSize][i % kApronSize] = texDepth[pos].x;
+    }
+    if (groupIndex < kTileSize * kTileSize / 32)
+    {
+        gInvalid[groupIndex] = 0;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    int2 pixelId = int2(groupId.xy * kTileSize + groupThreadId.xy);
+    if (all(pixelId < size))
+    {
+        // Closest depth in the 3x3 neighborhood, center wins ties
+        int2 offset = 0;
+        float closestDepth = gDepth[groupThreadId.y + 1][groupThreadId.x + 1];
+        [unroll]
+        for (int y = -1; y <= 1; y++)
+        {
+            [unroll]
+            for (int x = -1; x <= 1; x++)
+            {
+                float depth = gDepth[groupThreadId.y + 1 + y][groupThreadId.x + 1 + x];
+                if (depthInverted != 0 ? depth > closestDepth : depth < closestDepth)
+                {
+                    closestDepth = depth;
+                    offset = int2(x, y);
+                }
+            }
+        }
+        int2 sourceId = clamp(pixelId + offset, 0, size - 1);
+
+        float2 velocity = texMVec[sourceId].xy;
+        float2 scaled = velocity * mvecScale; // to -1,1 range
+        float2 jitter = 0;
+        bool invalid = !all(isfinite(scaled)) || any(abs(scaled) > 1.0) ||
+            (reconstructZero != 0 && (any(abs(velocity) > 1.0) || all(velocity == 0.0)));
+
+        [branch]
+        if (invalid)
+        {
+            float2 uvCurrent = (float2(sourceId) + 0.5) * textureSize.zw;
+            float4 screenSpacePosCurrent = float4(float2(uvCurrent.x * 2.0 - 1.0, 1.0 - uvCurrent.y * 2.0), closestDepth, 1.0);
+            float4 screenSpacePosPrevious = mul(currentToPreviousClipMatrixNoOffset, screenSpacePosCurrent);
+            float2 uvPrevious = float2(0.5, -0.5) * screenSpacePosPrevious.xy / screenSpacePosPrevious.w + 0.5;
+            velocity = uvCurrent - uvPrevious;
+            uint bit = groupThreadId.y * kTileSize + groupThreadId.x;
+            InterlockedOr(gInvalid[bit / 32], 1u << (bit % 32));
+        }
+        else
+        {
+            velocity = scaled;
+            // Camera motion above is computed without jitter, same must hold for engine vectors
+            jitter = jitterDelta;
+        }
+        if (showMvec != 0) velocity *= textureSize.xy * 10.0f;
+        rwtexMVec[pixelId] = float2(-velocity) * textureSize.xy - jitter; // to pixel space
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    if (groupIndex < kTileSize * kTileSize / 32)
+    {
+        uint tilesX = ((uint)size.x + kTileSize - 1) / kTileSize;
+        uint tileIndex = groupId.y * tilesX + groupId.x;
+        rwInvalidMask.Store((tileIndex * (kTileSize * kTileSize / 32) + groupIndex) * 4, gInvalid[groupIndex]);
+    }
+}
@@ -0,0 +1,2 @@
+#define SL_BINDLESS 1
+#include "mvec_dilate.hlsl"
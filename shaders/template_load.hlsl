@@ -0,0 +1,29 @@
+// Synthetic compute load for the sl.template benchmark
+//
+// Iterates a cheap ALU sequence per pixel so the GPU cost scales linearly with 'iterations'
+[[vk::binding(0)]] RWTexture2D<float4> rwOutput : register(u0);
+
+[[vk::binding(1)]] cbuffer shaderConsts : register(b0)
+{
+    uint2 size;
+    uint iterations;
+    uint frame;
+};
+
+[shader("compute")]
+[numthreads(16, 16, 1)]
+void main(uint3 DTid : SV_DispatchThreadID)
+{
+    uint2 pixelId = DTid.xy;
+    if (any(pixelId >= size))
+    {
+        return;
+    }
+
+    float4 value = float4(float2(pixelId) / float2(size), float(frame & 0xff) / 255.0, 1.0);
+    for (uint i = 0; i < iterations; i++)
+    {
+        value = frac(value * 1.618034 + value.yzwx * 0.5);
+    }
+    rwOutput[pixelId] = value;
+}
@@ -155,6 +155,10 @@ using PFunResizeBuffers1After = HRESULT(IDXGISwapChain* SwapChain, UINT BufferCo
 
 //! All below hooks are of type 'eHookTypeAfter' and they do NOT have 'eHookTypeBefore' counterpart
 //! 
+//! Resource creation hooks take an optional 'filter' in the plugin JSON, for example
+//! "filter" : { "dimensions" : ["texture2d"], "flags" : ["allow_render_target", "allow_unordered_access"], "minWidth" : 1024 }
+//! so only matching resources are reported. Newer variants of a method are reported through the base one.
+//! 
 #if defined(__d3d12_h__)
 using PFunCreateCommittedResourceAfter = HRESULT(const D3D12_HEAP_PROPERTIES* pHeapProperties, D3D12_HEAP_FLAGS HeapFlags, const D3D12_RESOURCE_DESC* pResourceDesc, D3D12_RESOURCE_STATES InitialResourceState, const D3D12_CLEAR_VALUE* pOptimizedClearValue, REFIID riidResource, void** ppvResource);
 using PFunCreatePlacedResourceAfter = HRESULT(ID3D12Heap* pHeap, UINT64 HeapOffset, const D3D12_RESOURCE_DESC* pDesc, D3D12_RESOURCE_STATES InitialState, const D3D12_CLEAR_VALUE* pOptimizedClearValue, REFIID riid, void** ppvResource);
@@ -182,5 +186,7 @@ using PFunVkDestroySwapchainKHRBefore = void(VkDevice Device, VkSwapchainKHR Swa
 using PFunVkCreateWin32SurfaceKHRBefore = VkResult(VkInstance Instance, const VkWin32SurfaceCreateInfoKHR* CreateInfo, const VkAllocationCallbacks* Allocator, VkSurfaceKHR* Surface, bool& Skip);
 using PFunVkCreateWin32SurfaceKHRAfter = VkResult(VkInstance Instance, const VkWin32SurfaceCreateInfoKHR* CreateInfo, const VkAllocationCallbacks* Allocator, VkSurfaceKHR* Surface);
 using PFunVkDestroySurfaceKHRBefore = void(VkInstance Instance, VkSurfaceKHR Surface, const VkAllocationCallbacks* Allocator, bool& Skip);
+//! Filtered like the D3D12 resource creation hooks, usage bits stand in for the D3D12 flags
+using PFunVkCreateImageAfter = void(VkDevice Device, const VkImageCreateInfo* CreateInfo, const VkAllocationCallbacks* Allocator, VkImage* Image);
 
 } // namespace sl
@@ -41,16 +41,23 @@
 #include "internal.h"
 #include "source/core/sl.exception/exception.h"
 #include "source/core/sl.extra/extra.h"
+#include "source/core/sl.extra/startupTimeline.h"
+#include "source/core/sl.extra/frameArena.h"
 #include "source/core/sl.log/log.h"
 #include "source/core/sl.file/file.h"
 #include "source/core/sl.param/parameters.h"
 #include "source/core/sl.interposer/hook.h"
 #include "source/core/sl.plugin-manager/pluginManager.h"
+#include "source/core/sl.thread/thread.h"
 #include "include/sl_helpers.h"
 #include "include/sl_helpers_vk.h"
 
 using namespace sl;
 
+// Interposer module provider and allocation counting, plugins define their own in 'SL_PLUGIN_DEFINE'
+SL_TRACE_DEFINE_PROVIDER()
+SL_ALLOCATION_TRACKING_DEFINE()
+
 namespace {
 
 LogLevel ToLogLevel(int logLevel) {
@@ -71,6 +78,10 @@ void ConfigureLogOverridesFromInterposerConfig(log::ILog* log)
         }
         log->setLogLevel(ToLogLevel(config.logLevel));
         log->setLogMessageDelay(config.logMessageDelayMs);
+        if (!config.binaryLogPath.empty())
+        {
+            log->setBinaryLogPath(extra::toWStr(config.binaryLogPath).c_str(), config.binaryLogSizeMB);
+        }
         SL_LOG_HINT("Overriding interposer settings with values from %S\\sl.interposer.json",
                     sl::interposer::getInterface()->getConfigPath().c_str());
     }
@@ -85,6 +96,8 @@ void ConfigureLogOverridesFromRegistry(log::ILog* log)
     constexpr const wchar_t* kLogLevelValue = L"LogLevel";
     constexpr const wchar_t* kLogPathValue = L"LogPath";
     constexpr const wchar_t* kLogNameValue = L"LogName";
+    constexpr const wchar_t* kBinaryLogPathValue = L"BinaryLogPath";
+    constexpr const wchar_t* kBinaryLogSizeValue = L"BinaryLogSizeMB";
 
     bool settingsOverridden = false;
 
@@ -111,6 +124,13 @@ void ConfigureLogOverridesFromRegistry(log::ILog* log)
         log->setLogName(registryString);
         settingsOverridden = true;
     }
+    if (extra::getRegistryString(kRegSubKey, kBinaryLogPathValue, registryString, MAX_PATH))
+    {
+        DWORD sizeMB = 16;
+        extra::getRegistryDword(kRegSubKey, kBinaryLogSizeValue, &sizeMB);
+        log->setBinaryLogPath(registryString, sizeMB);
+        settingsOverridden = true;
+    }
 
     if (settingsOverridden)
     {
@@ -125,6 +145,8 @@ void ConfigureLogOverridesFromEnvironment(log::ILog* log)
     constexpr const char* kLogLevelKey = "SL_LOG_LEVEL";
     constexpr const char* kLogPathKey = "SL_LOG_PATH";
     constexpr const char* kLogNameKey = "SL_LOG_NAME";
+    constexpr const char* kBinaryLogPathKey = "SL_BINARY_LOG_PATH";
+    constexpr const char* kBinaryLogSizeKey = "SL_BINARY_LOG_SIZE_MB";
     std::string value;
     bool settingsOverridden = false;
 
@@ -144,6 +166,12 @@ void ConfigureLogOverridesFromEnvironment(log::ILog* log)
         log->setLogName(extra::toWStr(value).c_str());
         settingsOverridden = true;
     }
+    if (extra::getEnvVar(kBinaryLogPathKey, value)) {
+        std::string size;
+        uint32_t sizeMB = extra::getEnvVar(kBinaryLogSizeKey, size) ? (uint32_t)std::atoi(size.c_str()) : 16;
+        log->setBinaryLogPath(extra::toWStr(value).c_str(), sizeMB);
+        settingsOverridden = true;
+    }
 
     if (settingsOverridden)
     {
@@ -179,6 +207,8 @@ inline sl::Result slValidateState()
 
 inline sl::Result slValidateFeatureContext(sl::Feature f, const sl::plugin_manager::FeatureContext*& ctx)
 {
+    // First use of a feature whose startup was deferred, see PreferenceFlags::eDeferFeatureStartup
+    SL_CHECK(plugin_manager::getInterface()->ensureFeatureStarted(f));
     ctx = plugin_manager::getInterface()->getFeatureContext(f);
     if (!ctx)
     {
@@ -191,9 +221,12 @@ inline sl::Result slValidateFeatureContext(sl::Feature f, const sl::plugin_manag
 
 struct APIContext
 {
+    //! Current ring index in the upper and its frame index in the lower 32 bits, published only after the
+    //! token it points to holds the frame index so that repeated requests for the same frame skip the lock
+    std::atomic<uint64_t> frameHandleState{};
+    //! Serializes advancing the ring, tokens are written by the owner only so a stale writer can never clobber a reused slot
     std::mutex mtxFrameHandle{};
     uint32_t frameCounter = 0;
-    uint32_t frameHandleIndex = 0;
     FrameHandleImplementation frameHandles[MAX_FRAMES_IN_FLIGHT];
 
     std::map<Feature, std::pair<size_t, BufferType*>> requiredTags;
@@ -254,6 +287,12 @@ sl::Result slInit(const Preferences &pref, uint64_t sdkVersion)
                     }
 #endif
                 }
+#ifdef SL_ENABLE_EXCEPTION_HANDLING
+                if (config.vectoredExceptionHandler)
+                {
+                    exception::getInterface()->installVectoredHandler();
+                }
+#endif
             }
 #endif
 
@@ -287,11 +326,17 @@ sl::Result slInit(const Preferences &pref, uint64_t sdkVersion)
 
             manager->setPreferences(pref);
 
+            auto viewports = findStruct<PreferencesViewports>(pref.next);
+            param::getInterface()->set(param::global::kMaxNumViewports, viewports ? viewports->maxNumViewports : 0u);
+
             param::getInterface()->set(param::global::kPFunAllocateResource, pref.allocateCallback);
             param::getInterface()->set(param::global::kPFunReleaseResource, pref.releaseCallback);
             param::getInterface()->set(param::global::kLogInterface, log::getInterface());
 
             // Enumerate plugins and check if they are supported or not
+            extra::IStartupTimeline* timeline{};
+            param::getPointerParam(param::getInterface(), param::global::kStartupTimeline, &timeline);
+            SL_STARTUP_PHASE(timeline, "slInit");
             return manager->loadPlugins();
         }
 
@@ -335,6 +380,11 @@ Result slShutdown()
     manager->unloadPlugins();
 
     plugin_manager::destroyInterface();
+    thread::shutdownSharedJobSystem();
+#ifdef SL_ENABLE_EXCEPTION_HANDLING
+    // Plugin ranges are gone, back to the per call handlers until the next 'slInit'
+    exception::getInterface()->removeVectoredHandler();
+#endif
     param::destroyInterface();
     log::destroyInterface();
     interposer::destroyInterface();
@@ -363,6 +413,17 @@ Result slSetFeatureLoaded(sl::Feature feature, bool enabled)
     SL_EXCEPTION_HANDLE_END_RETURN(Result::eErrorExceptionHandler);
 }
 
+static Result setTagCommon(const sl::ViewportHandle& viewport, const sl::ResourceTag* tags, uint32_t numTags,
+    sl::CommandBuffer* cmdBuffer, bool useResourceTaggingForFrame, const sl::FrameToken& frame)
+{
+    SL_CHECK(slValidateState());
+    const sl::plugin_manager::FeatureContext* ctx;
+    SL_CHECK(slValidateFeatureContext(kFeatureCommon, ctx));
+    if (!tags || numTags == 0) return Result::eErrorInvalidParameter;
+    return (useResourceTaggingForFrame ? ctx->setTagForFrame(frame, viewport, tags, numTags, cmdBuffer)
+        : ctx->setTag(viewport, tags, numTags, cmdBuffer));
+}
+
 Result slSetTagCommon(const sl::ViewportHandle& viewport, const sl::ResourceTag* tags, uint32_t numTags,
     sl::CommandBuffer* cmdBuffer, bool useResourceTaggingForFrame, const sl::FrameToken& frame = FrameHandleImplementation{})
 {
@@ -375,14 +436,7 @@ Result slSetTagCommon(const sl::ViewportHandle& viewport, const sl::ResourceTag*
     static_assert(offsetof(sl::ResourceTag, extent) == 48, "new elements can only be added at the end of each structure");
     static_assert(offsetof(sl::Resource, reserved) == 104, "new elements can only be added at the end of each structure");
 
-    SL_EXCEPTION_HANDLE_START;
-    SL_CHECK(slValidateState());
-    const sl::plugin_manager::FeatureContext* ctx;
-    SL_CHECK(slValidateFeatureContext(kFeatureCommon, ctx));
-    if (!tags || numTags == 0) return Result::eErrorInvalidParameter;
-    return (useResourceTaggingForFrame ? ctx->setTagForFrame(frame, viewport, tags, numTags, cmdBuffer)
-        : ctx->setTag(viewport, tags, numTags, cmdBuffer));
-    SL_EXCEPTION_HANDLE_END_RETURN(Result::eErrorExceptionHandler);
+    SL_EXCEPTION_GUARD_RETURN(Result::eErrorExceptionHandler, setTagCommon(viewport, tags, numTags, cmdBuffer, useResourceTaggingForFrame, frame));
 }
 
 Result slSetTag(const sl::ViewportHandle& viewport, const sl::ResourceTag* tags, uint32_t numTags, sl::CommandBuffer* cmdBuffer)
@@ -409,6 +463,14 @@ Result slSetTagForFrame(const sl::FrameToken& frame, const sl::ViewportHandle& v
     return slSetTagCommon(viewport, tags, numTags, cmdBuffer, true, frame);
 }
 
+static Result setConstants(const Constants& values, const FrameToken& frame, const ViewportHandle& viewport)
+{
+    SL_CHECK(slValidateState());
+    const sl::plugin_manager::FeatureContext* ctx;
+    SL_CHECK(slValidateFeatureContext(kFeatureCommon, ctx));
+    return ctx->setConstants(values, frame, viewport);
+}
+
 Result slSetConstants(const Constants& values, const FrameToken& frame, const ViewportHandle& viewport)
 {
     //! IMPORTANT:
@@ -419,12 +481,7 @@ Result slSetConstants(const Constants& values, const FrameToken& frame, const Vi
     //! that new element(s) are NOT added in the middle of a structure.
     static_assert(offsetof(sl::Constants, motionVectorsJittered) == 450, "new elements can only be added at the end of each structure");
 
-    SL_EXCEPTION_HANDLE_START;
-    SL_CHECK(slValidateState());
-    const sl::plugin_manager::FeatureContext* ctx;
-    SL_CHECK(slValidateFeatureContext(kFeatureCommon, ctx));
-    return ctx->setConstants(values, frame, viewport);
-    SL_EXCEPTION_HANDLE_END_RETURN(Result::eErrorExceptionHandler);
+    SL_EXCEPTION_GUARD_RETURN(Result::eErrorExceptionHandler, setConstants(values, frame, viewport));
 }
 
 Result slAllocateResources(sl::CommandBuffer* cmdBuffer, sl::Feature feature, const sl::ViewportHandle& viewport)
@@ -457,9 +514,8 @@ Result slFreeResources(sl::Feature feature, const sl::ViewportHandle& viewport)
     SL_EXCEPTION_HANDLE_END_RETURN(Result::eErrorExceptionHandler);
 }
 
-Result slEvaluateFeature(sl::Feature feature, const sl::FrameToken& frame, const sl::BaseStructure** inputs, uint32_t numInputs, sl::CommandBuffer* cmdBuffer)
+static Result evaluateFeature(sl::Feature feature, const sl::FrameToken& frame, const sl::BaseStructure** inputs, uint32_t numInputs, sl::CommandBuffer* cmdBuffer)
 {
-    SL_EXCEPTION_HANDLE_START;
     SL_CHECK(slValidateState());
     //! First check if plugin provides an override 
     //!
@@ -474,7 +530,11 @@ Result slEvaluateFeature(sl::Feature feature, const sl::FrameToken& frame, const
         SL_CHECK(slValidateFeatureContext(sl::kFeatureCommon, ctx));
     }
     return ctx->evaluate(feature, frame, inputs, numInputs, cmdBuffer);
-    SL_EXCEPTION_HANDLE_END_RETURN(Result::eErrorExceptionHandler);
+}
+
+Result slEvaluateFeature(sl::Feature feature, const sl::FrameToken& frame, const sl::BaseStructure** inputs, uint32_t numInputs, sl::CommandBuffer* cmdBuffer)
+{
+    SL_EXCEPTION_GUARD_RETURN(Result::eErrorExceptionHandler, evaluateFeature(feature, frame, inputs, numInputs, cmdBuffer));
 }
 
 Result slSetVulkanInfo(const sl::VulkanInfo& info)
@@ -759,6 +819,7 @@ Result slIsFeatureSupported(sl::Feature feature, const sl::AdapterInfo& adapterI
         //! Also since we return a specific error code no real need for extra logging.
         //! 
         SL_CHECK(slValidateState());
+        SL_CHECK(plugin_manager::getInterface()->ensureFeatureStarted(feature));
 
         auto ctx = plugin_manager::getInterface()->getFeatureContext(feature);
         std::string jsonConfig{};
@@ -1104,31 +1165,45 @@ Result slGetFeatureFunction(sl::Feature feature, const char* functionName, void*
     SL_EXCEPTION_HANDLE_END_RETURN(Result::eErrorExceptionHandler)
 }
 
-Result slGetNewFrameToken(FrameToken*& handle, const uint32_t* frameIndex)
+static Result getNewFrameToken(FrameToken*& handle, const uint32_t* frameIndex)
 {
-    auto getFrame = [](FrameToken*& handle, const uint32_t* frameIndex)->Result
-    {
-        SL_CHECK(slValidateState());
-
-        std::scoped_lock lock(s_ctx.mtxFrameHandle);
+    SL_CHECK(slValidateState());
 
-        //! Two scenarios:
-        //! 
-        //! - If frame index is not provided we advance our internal counter and return next token
-        //! - If frame index is provided then reuse the previous one if index is the same
-        //! 
-        //! Host can request multiple frame tokens with an identical frame index within the same frame, this is totally valid.
-        if (!frameIndex || (*frameIndex != s_ctx.frameHandles[s_ctx.frameHandleIndex].counter.load()))
+    //! Two scenarios:
+    //! 
+    //! - If frame index is not provided we advance our internal counter and return next token
+    //! - If frame index is provided then reuse the previous one if index is the same
+    //! 
+    //! Host can request multiple frame tokens with an identical frame index within the same frame, this is totally valid.
+    auto state = s_ctx.frameHandleState.load(std::memory_order_acquire);
+    if (frameIndex && *frameIndex == uint32_t(state))
+    {
+        // Common case, same frame requested again. Token check catches the ring wrapping since the state was read
+        auto& token = s_ctx.frameHandles[uint32_t(state >> 32)];
+        if (token.counter.load(std::memory_order_acquire) == *frameIndex)
         {
-            s_ctx.frameHandleIndex = (s_ctx.frameHandleIndex + 1) % MAX_FRAMES_IN_FLIGHT;
-            s_ctx.frameHandles[s_ctx.frameHandleIndex].counter.store(frameIndex ? *frameIndex : ++s_ctx.frameCounter);
+            handle = &token;
+            return Result::eOk;
         }
+    }
 
-        handle = &s_ctx.frameHandles[s_ctx.frameHandleIndex];
-        return Result::eOk;
-    };
-    SL_EXCEPTION_HANDLE_START;
-    return getFrame(handle, frameIndex);
-    SL_EXCEPTION_HANDLE_END_RETURN(Result::eErrorExceptionHandler)
+    std::scoped_lock lock(s_ctx.mtxFrameHandle);
+    state = s_ctx.frameHandleState.load(std::memory_order_relaxed);
+    if (!frameIndex || *frameIndex != uint32_t(state))
+    {
+        auto index = (uint32_t(state >> 32) + 1) % MAX_FRAMES_IN_FLIGHT;
+        auto value = frameIndex ? *frameIndex : ++s_ctx.frameCounter;
+        // Token first, state last so lock-free readers never see a state whose token is not ready
+        s_ctx.frameHandles[index].counter.store(value, std::memory_order_release);
+        state = (uint64_t(index) << 32) | value;
+        s_ctx.frameHandleState.store(state, std::memory_order_release);
+    }
+    handle = &s_ctx.frameHandles[uint32_t(state >> 32)];
+    return Result::eOk;
+}
+
+Result slGetNewFrameToken(FrameToken*& handle, const uint32_t* frameIndex)
+{
+    SL_EXCEPTION_GUARD_RETURN(Result::eErrorExceptionHandler, getNewFrameToken(handle, frameIndex));
 }
 
@@ -112,8 +112,137 @@ struct Exception : IException
         return EXCEPTION_EXECUTE_HANDLER;
     }
 
+    virtual bool installVectoredHandler() override final
+    {
+        std::scoped_lock lock(m_mutex);
+        if (m_vectoredHandler)
+        {
+            return true;
+        }
+        HMODULE self{};
+        if (GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCWSTR)&getInterface, &self))
+        {
+            addModuleLocked(self);
+        }
+        // First in line, anything we do not recognize is passed on untouched
+        m_vectoredHandler = AddVectoredExceptionHandler(1, vectoredHandler);
+        if (!m_vectoredHandler)
+        {
+            SL_LOG_ERROR("Failed to install vectored exception handler - %s", std::system_category().message(GetLastError()).c_str());
+            return false;
+        }
+        s_vectoredHandler.store(true);
+        SL_LOG_INFO("Using vectored exception handler for SL entry points");
+        return true;
+    }
+
+    virtual void removeVectoredHandler() override final
+    {
+        std::scoped_lock lock(m_mutex);
+        if (m_vectoredHandler)
+        {
+            s_vectoredHandler.store(false);
+            RemoveVectoredExceptionHandler(m_vectoredHandler);
+            m_vectoredHandler = {};
+        }
+    }
+
+    virtual void addModule(HMODULE module) override final
+    {
+        std::scoped_lock lock(m_mutex);
+        addModuleLocked(module);
+    }
+
+private:
+    //! Plugins are few and rarely unloaded, ranges of unloaded ones are kept which at worst dumps an unrelated crash
+    static constexpr uint32_t kMaxModules = 64;
+
+    struct ModuleRange
+    {
+        std::atomic<uintptr_t> begin{};
+        std::atomic<uintptr_t> end{};
+    };
+
+    void addModuleLocked(HMODULE module)
+    {
+        if (!module) return;
+        auto base = (uintptr_t)module;
+        auto dos = (const IMAGE_DOS_HEADER*)module;
+        auto nt = (const IMAGE_NT_HEADERS*)(base + dos->e_lfanew);
+        auto count = m_moduleCount.load();
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (m_modules[i].begin.load() == base) return;
+        }
+        if (count == kMaxModules)
+        {
+            SL_LOG_WARN("Too many modules for the vectored exception handler, crashes in 0x%llx will not be dumped", base);
+            return;
+        }
+        m_modules[count].begin.store(base);
+        m_modules[count].end.store(base + nt->OptionalHeader.SizeOfImage);
+        // Handler reads without the lock, publish the range before the count
+        m_moduleCount.store(count + 1, std::memory_order_release);
+    }
+
+    bool containsAddress(uintptr_t address) const
+    {
+        auto count = m_moduleCount.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (address >= m_modules[i].begin.load(std::memory_order_relaxed) && address < m_modules[i].end.load(std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool isFatal(DWORD code)
+    {
+        // Vectored handlers see first chance exceptions, C++ exceptions and debugger events are handled elsewhere
+        switch (code)
+        {
+            case EXCEPTION_ACCESS_VIOLATION:
+            case EXCEPTION_ARRAY_BOUNDS_EXCEEDED:
+            case EXCEPTION_DATATYPE_MISALIGNMENT:
+            case EXCEPTION_ILLEGAL_INSTRUCTION:
+            case EXCEPTION_IN_PAGE_ERROR:
+            case EXCEPTION_INT_DIVIDE_BY_ZERO:
+            case EXCEPTION_NONCONTINUABLE_EXCEPTION:
+            case EXCEPTION_PRIV_INSTRUCTION:
+            case EXCEPTION_STACK_OVERFLOW:
+                return true;
+        }
+        return false;
+    }
+
+    static LONG CALLBACK vectoredHandler(PEXCEPTION_POINTERS exceptionInfo)
+    {
+        auto self = s_exception;
+        auto record = exceptionInfo->ExceptionRecord;
+        if (self && isFatal(record->ExceptionCode) && self->containsAddress((uintptr_t)record->ExceptionAddress))
+        {
+            // Only the first one, same crash is often raised again while the host unwinds
+            if (!self->m_dumped.exchange(true))
+            {
+                self->writeMiniDump(exceptionInfo);
+            }
+        }
+        // Unlike '__except' there is no frame to return an error from so the host sees the crash as usual
+        return EXCEPTION_CONTINUE_SEARCH;
+    }
+
+public:
     inline static Exception* s_exception = {};
     HANDLE m_outHandle{};
+
+private:
+    std::mutex m_mutex;
+    PVOID m_vectoredHandler{};
+    ModuleRange m_modules[kMaxModules]{};
+    std::atomic<uint32_t> m_moduleCount{};
+    std::atomic<bool> m_dumped{};
 };
 
 IException* getInterface()
@@ -129,6 +258,7 @@ void destroyInterface()
 {
     if (Exception::s_exception)
     {
+        Exception::s_exception->removeVectoredHandler();
         delete Exception::s_exception;
         Exception::s_exception = {};
     }
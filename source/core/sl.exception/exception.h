@@ -26,6 +26,7 @@
 
 #ifdef SL_WINDOWS
 #include <windows.h>
+#include <atomic>
 
 namespace sl
 {
@@ -35,9 +36,31 @@ namespace exception
 #define SL_EXCEPTION_HANDLE_END } __except (sl::exception::getInterface()->writeMiniDump(GetExceptionInformation())) {}
 #define SL_EXCEPTION_HANDLE_END_RETURN(R) } __except (sl::exception::getInterface()->writeMiniDump(GetExceptionInformation())) { return R;}
 
+//! For tiny per frame entry points, 'call' must not construct objects with destructors
+//!
+//! Skips the '__try' frame when the vectored handler is installed, crashes are still dumped by the handler
+//! but are no longer turned into 'R', see 'IException::installVectoredHandler'.
+#define SL_EXCEPTION_GUARD_RETURN(R, call)                                      \
+if (sl::exception::s_vectoredHandler.load(std::memory_order_relaxed))          \
+{                                                                               \
+    return call;                                                                \
+}                                                                               \
+SL_EXCEPTION_HANDLE_START                                                       \
+return call;                                                                    \
+SL_EXCEPTION_HANDLE_END_RETURN(R)
+
+//! Set while the vectored handler is installed, per module so only meaningful in sl.interposer
+inline std::atomic<bool> s_vectoredHandler{};
+
 struct IException
 {
     virtual int writeMiniDump(LPEXCEPTION_POINTERS exceptionInfo) = 0;
+    //! Installs one vectored handler which writes a mini-dump for the first fatal exception raised inside an SL module
+    //!
+    //! The calling module is added automatically, plugins are added with 'addModule' as they get loaded.
+    virtual bool installVectoredHandler() = 0;
+    virtual void removeVectoredHandler() = 0;
+    virtual void addModule(HMODULE module) = 0;
 };
 
 IException* getInterface();
@@ -52,4 +75,5 @@ void destroyInterface();
 #define SL_EXCEPTION_HANDLE_START
 #define SL_EXCEPTION_HANDLE_END
 #define SL_EXCEPTION_HANDLE_END_RETURN(R)
+#define SL_EXCEPTION_GUARD_RETURN(R, call) return call;
 #endif // SL_ENABLE_EXCEPTION_HANDLING
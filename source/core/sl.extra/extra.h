@@ -39,6 +39,11 @@
 #include <iomanip>
 #include <array>
 #include <chrono>
+#include <charconv>
+#include <string_view>
+#include <type_traits>
+
+#include "source/core/sl.extra/trace.h"
 
 #ifdef SL_WINDOWS
 #define SL_IGNOREWARNING_PUSH __pragma(warning(push))
@@ -420,6 +425,18 @@ struct TAverageValueMeter
         return (tmp[i] + tmp[i - 1]) / 2;
     }
 
+    //! Nearest rank percentile over the current window, p in [0,100]
+    //! 
+    //! NOT thread safe
+    double getPercentile(double p)
+    {
+        if (n == 0) return 0.;
+        std::vector<double> tmp(window.begin(), window.begin() + std::min(n.load(), (uint64_t)window.size()));
+        std::sort(tmp.begin(), tmp.end());
+        auto rank = (size_t)std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * tmp.size());
+        return tmp[std::max(rank, (size_t)1) - 1];
+    }
+
     //! NOT thread safe
     inline int64_t getElapsedTimeUs() const
     {
@@ -452,11 +469,149 @@ private:
 };
 typedef TAverageValueMeter<kAverageMeterWindowSize> AverageValueMeter;
 
+//! Streaming quantiles for timings in milliseconds, mean of a window hides exactly the spikes we care about
+//!
+//! Fixed memory log-bucketed histogram, each octave is split into 'kSubBuckets' so quantiles are within ~9% of the
+//! real value. Values below 0.5us go to the first bucket and values above ~37 hours to the last one.
+//! 
+//! Thread safe, 'add' is lock free and can be called from any number of threads. If 'reset' runs concurrently
+//! with 'add' a few samples can end up counted either side of the reset.
+class QuantileMeter
+{
+public:
+    static constexpr int kMinExponent = -10;
+    static constexpr int kMaxExponent = 27;
+    static constexpr uint32_t kSubBuckets = 8;
+    static constexpr uint32_t kBucketCount = (kMaxExponent - kMinExponent) * kSubBuckets;
+
+    struct Quantiles
+    {
+        double p50{};
+        double p95{};
+        double p99{};
+        double max{};
+        uint64_t samples{};
+    };
+
+    void add(double valueMs)
+    {
+        m_buckets[getBucket(valueMs)].fetch_add(1, std::memory_order_relaxed);
+        m_samples.fetch_add(1, std::memory_order_relaxed);
+        auto current = m_max.load(std::memory_order_relaxed);
+        while (valueMs > current && !m_max.compare_exchange_weak(current, valueMs, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void reset()
+    {
+        for (auto& bucket : m_buckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        m_samples.store(0, std::memory_order_relaxed);
+        m_max.store(0, std::memory_order_relaxed);
+    }
+
+    //! Upper bound of the bucket holding the p-th percentile, p in [0,100], never more than the largest sample
+    double getPercentile(double p) const
+    {
+        double value{};
+        uint64_t samples{};
+        getPercentiles(&p, &value, 1, samples);
+        return value;
+    }
+
+    Quantiles getQuantiles() const
+    {
+        Quantiles q{};
+        double percentiles[] = { 50.0, 95.0, 99.0 };
+        double values[3]{};
+        getPercentiles(percentiles, values, 3, q.samples);
+        q.p50 = values[0];
+        q.p95 = values[1];
+        q.p99 = values[2];
+        q.max = getMax();
+        return q;
+    }
+
+    inline double getMax() const { return m_max.load(std::memory_order_relaxed); }
+    inline uint64_t getNumSamples() const { return m_samples.load(std::memory_order_relaxed); }
+
+private:
+    static uint32_t getBucket(double value)
+    {
+        if (!(value > 0.0))
+        {
+            return 0;
+        }
+        // value = mantissa * 2^exponent with mantissa in [0.5,1)
+        int exponent{};
+        auto mantissa = std::frexp(value, &exponent);
+        if (exponent <= kMinExponent)
+        {
+            return 0;
+        }
+        if (exponent > kMaxExponent)
+        {
+            return kBucketCount - 1;
+        }
+        auto sub = std::min((uint32_t)((mantissa * 2.0 - 1.0) * kSubBuckets), kSubBuckets - 1);
+        return (uint32_t)(exponent - kMinExponent - 1) * kSubBuckets + sub;
+    }
+
+    static double getBucketUpperBound(uint32_t bucket)
+    {
+        auto exponent = (int)(bucket / kSubBuckets) + kMinExponent;
+        auto sub = bucket % kSubBuckets;
+        return std::ldexp(1.0 + (sub + 1) / (double)kSubBuckets, exponent);
+    }
+
+    //! Percentiles must be sorted in ascending order
+    void getPercentiles(const double* percentiles, double* values, uint32_t count, uint64_t& samples) const
+    {
+        // Counts are read once so a concurrent 'add' cannot push the cumulative sum past the total
+        uint64_t counts[kBucketCount];
+        samples = 0;
+        for (uint32_t i = 0; i < kBucketCount; i++)
+        {
+            counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+            samples += counts[i];
+        }
+        auto max = getMax();
+        uint64_t cumulative = 0;
+        uint32_t bucket = 0;
+        for (uint32_t k = 0; k < count; k++)
+        {
+            values[k] = 0.0;
+            if (!samples)
+            {
+                continue;
+            }
+            auto rank = std::max((uint64_t)std::ceil(std::clamp(percentiles[k], 0.0, 100.0) / 100.0 * samples), (uint64_t)1);
+            while (bucket < kBucketCount && cumulative + counts[bucket] < rank)
+            {
+                cumulative += counts[bucket++];
+            }
+            values[k] = std::min(getBucketUpperBound(std::min(bucket, kBucketCount - 1)), max);
+        }
+    }
+
+    std::array<std::atomic<uint64_t>, kBucketCount> m_buckets{};
+    std::atomic<uint64_t> m_samples{};
+    std::atomic<double> m_max{};
+};
+
 struct ScopedCPUTimer
 {
-    ScopedCPUTimer(AverageValueMeter* meter)
+    //! Optional 'zone' also shows up in external profilers when SL is built with instrumentation
+    ScopedCPUTimer(AverageValueMeter* meter, const char* zone = nullptr)
     {
         m_meter = meter;
+        if (zone)
+        {
+            SL_TRACE_ZONE_BEGIN(m_zone, zone);
+        }
         meter->begin();
     }
     ~ScopedCPUTimer()
@@ -465,6 +620,7 @@ struct ScopedCPUTimer
     }
 
     AverageValueMeter* m_meter{};
+    SL_TRACE_ZONE_MEMBER(m_zone);
 };
 
 inline void format(std::ostringstream& stream, const char* str)
@@ -509,14 +665,160 @@ inline void format(std::ostringstream& stream, const char* str, Arg&& arg, Args&
  * @param str The format string. Use '{}' to indicate where the next parameter would be inserted.
  * @returns The formatted string
  */
+namespace detail
+{
+//! Output for 'formatTo', keeps counting past the end of the buffer so callers know how much space was needed
+struct FormatWriter
+{
+    char* buffer{};
+    size_t size{};
+    size_t length{};
+
+    void write(const char* str, size_t count)
+    {
+        if (length < size)
+        {
+            memcpy(buffer + length, str, std::min(count, size - length));
+        }
+        length += count;
+    }
+};
+
+template<class T>
+inline void formatArg(FormatWriter& writer, const T& arg, bool hex)
+{
+    using Type = std::decay_t<T>;
+    if constexpr (std::is_same_v<Type, bool>)
+    {
+        writer.write(arg ? "1" : "0", 1);
+    }
+    else if constexpr (std::is_same_v<Type, char> || std::is_same_v<Type, signed char> || std::is_same_v<Type, unsigned char>)
+    {
+        // Same as streaming, 8-bit integers are written as characters
+        char c = (char)arg;
+        writer.write(&c, 1);
+    }
+    else if constexpr (std::is_integral_v<Type> || std::is_enum_v<Type>)
+    {
+        using Integer = typename std::conditional_t<std::is_enum_v<Type>, std::underlying_type<Type>, std::common_type<Type>>::type;
+        char digits[24];
+        // Streams print negative numbers in hex as two's complement
+        auto result = hex ? std::to_chars(digits, digits + sizeof(digits), (std::make_unsigned_t<Integer>)arg, 16) :
+            std::to_chars(digits, digits + sizeof(digits), (Integer)arg, 10);
+        writer.write(digits, result.ptr - digits);
+    }
+    else if constexpr (std::is_floating_point_v<Type>)
+    {
+        char digits[64];
+        auto result = std::to_chars(digits, digits + sizeof(digits), arg, std::chars_format::fixed, 2);
+        if (result.ec == std::errc())
+        {
+            writer.write(digits, result.ptr - digits);
+        }
+        else
+        {
+            // Huge values do not fit, rare enough to go through the stream
+            std::ostringstream stream;
+            stream.precision(2);
+            stream << std::fixed << arg;
+            auto str = stream.str();
+            writer.write(str.data(), str.size());
+        }
+    }
+    else if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>)
+    {
+        if (arg)
+        {
+            writer.write(arg, strlen(arg));
+        }
+    }
+    else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+    {
+        std::string_view str = arg;
+        writer.write(str.data(), str.size());
+    }
+    else
+    {
+        // Pointers and other streamable types, keeps the exact output of 'format' but allocates
+        std::ostringstream stream;
+        stream.precision(2);
+        stream << std::fixed;
+        if (hex) stream << std::hex;
+        stream << arg;
+        auto str = stream.str();
+        writer.write(str.data(), str.size());
+    }
+}
+
+inline void formatTo(FormatWriter& writer, const char* str)
+{
+    writer.write(str, strlen(str));
+}
+
+template <class Arg, class... Args>
+inline void formatTo(FormatWriter& writer, const char* str, const Arg& arg, const Args&... args)
+{
+    auto p = strstr(str, "{}");
+    if (!p)
+    {
+        writer.write(str, strlen(str));
+        return;
+    }
+    writer.write(str, p - str);
+    bool hex = p[2] == '%' && p[3] == 'x';
+    formatArg(writer, arg, hex);
+    formatTo(writer, p + (hex ? 4 : 2), args...);
+}
+}
+
+//! Same as 'format' but writes into a caller provided buffer instead of going through 'std::ostringstream'
+//!
+//! Output is truncated to fit and always null terminated, returns the length of the full result so
+//! a return value of 'size' or more means the buffer was too small. Integers, floats, strings and characters
+//! never touch the heap, anything else is streamed as before.
+template <class... Args>
+inline size_t formatTo(char* buffer, size_t size, const char* str, const Args&... args)
+{
+    detail::FormatWriter writer{ buffer, size ? size - 1 : 0 };
+    detail::formatTo(writer, str, args...);
+    if (size)
+    {
+        buffer[std::min(writer.length, size - 1)] = 0;
+    }
+    return writer.length;
+}
+
+//! Small inline string for 'formatInline', for debug names and labels on hot paths
+template<size_t N>
+struct InlineString
+{
+    char data[N]{};
+
+    inline const char* c_str() const { return data; }
+    inline operator const char* () const { return data; }
+};
+
+template <size_t N = 128, class... Args>
+inline InlineString<N> formatInline(const char* str, const Args&... args)
+{
+    InlineString<N> result;
+    formatTo(result.data, N, str, args...);
+    return result;
+}
+
 template <class... Args>
 inline std::string format(const char* str, Args&&... args)
 {
-    std::ostringstream stream;
-    stream.precision(2);
-    stream << std::fixed;
-    extra::format(stream, str, std::forward<Args>(args)...);
-    return stream.str();
+    // Most strings fit on the stack, only the result itself is allocated
+    char buffer[256];
+    auto length = formatTo(buffer, sizeof(buffer), str, args...);
+    if (length < sizeof(buffer))
+    {
+        return std::string(buffer, length);
+    }
+    std::string result(length, 0);
+    formatTo(result.data(), length + 1, str, args...);
+    return result;
 }
 
 }
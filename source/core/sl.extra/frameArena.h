@@ -0,0 +1,258 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <stdint.h>
+
+namespace sl
+{
+namespace extra
+{
+
+namespace frame
+{
+//! Frames presented so far, owned by sl.interposer and shared via 'param::global::kFrameEpoch'
+//!
+//! Per module, without it frame arenas are disabled and 'FrameAllocator' falls back to the heap.
+inline const std::atomic<uint64_t>* s_epoch{};
+}
+
+namespace alloc
+{
+//! Heap allocations made by SL modules, owned by sl.interposer and shared via 'param::global::kHeapAllocations'
+//!
+//! Only counted in builds with SL_TRACK_ALLOCATIONS=1, see 'SL_ALLOCATION_TRACKING_DEFINE'.
+inline std::atomic<uint64_t>* s_counter{};
+}
+
+//! Per thread linear allocator for scratch data which does not outlive the current frame
+//!
+//! Rewinds on first use after a present, but only when no 'FrameAllocator' referencing it is alive,
+//! so a container constructed before a present on another thread stays valid.
+//! Blocks are kept between frames, if a frame did not fit into the first block it grows to the peak
+//! so steady state runs out of a single block without touching the heap.
+class FrameArena
+{
+public:
+    static constexpr size_t kBlockSize = 64 * 1024;
+
+    FrameArena() = default;
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    ~FrameArena()
+    {
+        for (auto& block : m_blocks)
+        {
+            std::free(block.data);
+        }
+    }
+
+    //! Arena of the calling thread or null if frame arenas are disabled in this module
+    static FrameArena* get()
+    {
+        auto epoch = frame::s_epoch;
+        if (!epoch)
+        {
+            return nullptr;
+        }
+        thread_local FrameArena t_arena;
+        auto current = epoch->load(std::memory_order_relaxed);
+        if (t_arena.m_epoch != current && t_arena.m_users == 0)
+        {
+            t_arena.reset();
+            t_arena.m_epoch = current;
+        }
+        return &t_arena;
+    }
+
+    void* allocate(size_t bytes, size_t alignment)
+    {
+        for (;;)
+        {
+            if (m_current < m_blocks.size())
+            {
+                auto& block = m_blocks[m_current];
+                auto offset = (m_offset + alignment - 1) & ~(alignment - 1);
+                if (offset + bytes <= block.size)
+                {
+                    m_offset = offset + bytes;
+                    m_used += bytes;
+                    return block.data + offset;
+                }
+                if (m_current + 1 < m_blocks.size())
+                {
+                    m_current++;
+                    m_offset = 0;
+                    continue;
+                }
+            }
+            // Out of space, callers fall back to the heap if the block cannot be created
+            size_t size = std::max(kBlockSize, bytes + alignment);
+            auto data = (uint8_t*)std::malloc(size);
+            if (!data)
+            {
+                return nullptr;
+            }
+            m_blocks.push_back({ data, size });
+            m_current = m_blocks.size() - 1;
+            m_offset = 0;
+        }
+    }
+
+    void reset()
+    {
+        m_peak = std::max(m_peak, m_used);
+        if (m_blocks.size() > 1)
+        {
+            // Replace overflow blocks with one big enough for the busiest frame so far
+            for (auto& block : m_blocks)
+            {
+                std::free(block.data);
+            }
+            m_blocks.clear();
+            size_t size = std::max(kBlockSize, m_peak * 2);
+            if (auto data = (uint8_t*)std::malloc(size))
+            {
+                m_blocks.push_back({ data, size });
+            }
+        }
+        m_current = 0;
+        m_offset = 0;
+        m_used = 0;
+    }
+
+    bool owns(const void* p) const
+    {
+        for (auto& block : m_blocks)
+        {
+            if (p >= block.data && p < block.data + block.size)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void addUser() { m_users++; }
+    void removeUser() { m_users--; }
+
+private:
+    struct Block
+    {
+        uint8_t* data{};
+        size_t size{};
+    };
+
+    std::vector<Block> m_blocks;
+    size_t m_current{};
+    size_t m_offset{};
+    size_t m_used{};
+    size_t m_peak{};
+    uint32_t m_users{};
+    uint64_t m_epoch{};
+};
+
+//! STL allocator backed by the frame arena of the constructing thread
+//!
+//! Deallocating arena memory is a no-op, it is reclaimed when the arena rewinds after a present.
+//! Containers must not be shared with other threads nor kept beyond the call which created them.
+template<typename T>
+struct FrameAllocator
+{
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    FrameAllocator() noexcept : m_arena(FrameArena::get()) { if (m_arena) m_arena->addUser(); }
+    FrameAllocator(const FrameAllocator& rhs) noexcept : m_arena(rhs.m_arena) { if (m_arena) m_arena->addUser(); }
+    template<typename U>
+    FrameAllocator(const FrameAllocator<U>& rhs) noexcept : m_arena(rhs.m_arena) { if (m_arena) m_arena->addUser(); }
+    FrameAllocator& operator=(const FrameAllocator& rhs) noexcept
+    {
+        if (rhs.m_arena) rhs.m_arena->addUser();
+        if (m_arena) m_arena->removeUser();
+        m_arena = rhs.m_arena;
+        return *this;
+    }
+    ~FrameAllocator() { if (m_arena) m_arena->removeUser(); }
+
+    T* allocate(size_t n)
+    {
+        if (m_arena)
+        {
+            if (auto p = m_arena->allocate(n * sizeof(T), alignof(T)))
+            {
+                return (T*)p;
+            }
+        }
+        return (T*)::operator new(n * sizeof(T));
+    }
+
+    void deallocate(T* p, size_t n) noexcept
+    {
+        if (!m_arena || !m_arena->owns(p))
+        {
+            ::operator delete(p);
+        }
+    }
+
+    template<typename U>
+    bool operator==(const FrameAllocator<U>& rhs) const noexcept { return m_arena == rhs.m_arena; }
+    template<typename U>
+    bool operator!=(const FrameAllocator<U>& rhs) const noexcept { return m_arena != rhs.m_arena; }
+
+    FrameArena* m_arena{};
+};
+
+template<typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+}
+}
+
+//! Replaces global operator new/delete in the module to count heap allocations, see 'alloc::s_counter'
+//!
+//! Used once per module, next to DllMain. Compiles to nothing unless SL_TRACK_ALLOCATIONS=1.
+#if defined(SL_TRACK_ALLOCATIONS) && SL_TRACK_ALLOCATIONS
+#define SL_ALLOCATION_TRACKING_DEFINE()                                                                 \
+void* operator new(size_t size)                                                                         \
+{                                                                                                       \
+    if (auto counter = sl::extra::alloc::s_counter) counter->fetch_add(1, std::memory_order_relaxed);   \
+    if (auto p = std::malloc(size ? size : 1)) return p;                                                \
+    throw std::bad_alloc();                                                                             \
+}                                                                                                       \
+void* operator new[](size_t size) { return operator new(size); }                                        \
+void operator delete(void* p) noexcept { std::free(p); }                                                \
+void operator delete[](void* p) noexcept { std::free(p); }                                              \
+void operator delete(void* p, size_t) noexcept { std::free(p); }                                        \
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+#else
+#define SL_ALLOCATION_TRACKING_DEFINE()
+#endif
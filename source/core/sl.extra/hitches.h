@@ -0,0 +1,178 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <cstring>
+#include <algorithm>
+#include <stdint.h>
+#if SL_WINDOWS
+#include <windows.h>
+#endif
+
+#include "source/core/sl.log/log.h"
+#include "source/core/sl.extra/perfStats.h"
+
+namespace sl
+{
+namespace extra
+{
+
+struct HitchRecord
+{
+    //! Copied so records stay valid after the module which reported them unloads
+    char site[64]{};
+    //! Frames presented when the wait finished, see 'IPerfStats::getLastFrame'
+    uint64_t frame{};
+    //! Steady clock time when the wait finished
+    uint64_t timestampUs{};
+    uint64_t durationUs{};
+    uint32_t threadId{};
+};
+
+//! Blocking waits inside SL which took longer than a threshold
+//!
+//! Owned by sl.interposer and shared with plugins via 'param::global::kHitchRecorder'.
+struct IHitchRecorder
+{
+    //! Thread safe, 'site' is truncated to fit 'HitchRecord::site'
+    virtual void record(const char* site, uint64_t durationNs) = 0;
+    virtual uint64_t getThresholdNs() const = 0;
+    //! Copies up to 'maxRecords' newest records, newest first, and returns how many were recorded so far
+    virtual uint32_t getRecent(HitchRecord* records, uint32_t maxRecords, uint64_t& totalRecorded) = 0;
+};
+
+class HitchRecorder : public IHitchRecorder
+{
+public:
+    static constexpr uint32_t kCapacity = 256;
+    static constexpr uint64_t kDefaultThresholdUs = 1000;
+    static constexpr uint64_t kLogIntervalMs = 1000;
+
+    HitchRecorder(IPerfStats* perfStats) : m_perfStats(perfStats) {}
+
+    void setThresholdUs(uint64_t thresholdUs) { m_thresholdNs.store(thresholdUs * 1000, std::memory_order_relaxed); }
+
+    void record(const char* site, uint64_t durationNs) override
+    {
+        HitchRecord record{};
+        strncpy_s(record.site, sizeof(record.site), site, _TRUNCATE);
+        if (m_perfStats)
+        {
+            uint64_t values[kPerfCounterCount];
+            m_perfStats->getLastFrame(values, record.frame);
+        }
+        auto now = std::chrono::steady_clock::now();
+        record.timestampUs = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch()).count();
+        record.durationUs = durationNs / 1000;
+#if SL_WINDOWS
+        record.threadId = GetCurrentThreadId();
+#endif
+
+        uint64_t suppressed{};
+        bool log{};
+        {
+            std::scoped_lock lock(m_mutex);
+            m_records[m_total % kCapacity] = record;
+            m_total++;
+            // Hitches tend to come in bursts so only the first one per interval makes it to the log
+            if (now - m_lastLog >= std::chrono::milliseconds(kLogIntervalMs))
+            {
+                m_lastLog = now;
+                suppressed = m_suppressed;
+                m_suppressed = 0;
+                log = true;
+            }
+            else
+            {
+                m_suppressed++;
+            }
+        }
+        if (log)
+        {
+            SL_LOG_WARN("Hitch: '%s' blocked thread %u for %.2fms at frame %llu (%llu more not logged)", record.site, record.threadId,
+                durationNs / 1000000.0, record.frame, suppressed);
+        }
+    }
+
+    uint64_t getThresholdNs() const override { return m_thresholdNs.load(std::memory_order_relaxed); }
+
+    uint32_t getRecent(HitchRecord* records, uint32_t maxRecords, uint64_t& totalRecorded) override
+    {
+        std::scoped_lock lock(m_mutex);
+        totalRecorded = m_total;
+        uint32_t count = (uint32_t)std::min<uint64_t>({ m_total, kCapacity, maxRecords });
+        for (uint32_t i = 0; i < count; i++)
+        {
+            records[i] = m_records[(m_total - 1 - i) % kCapacity];
+        }
+        return count;
+    }
+
+private:
+    IPerfStats* m_perfStats{};
+    std::atomic<uint64_t> m_thresholdNs{ kDefaultThresholdUs * 1000 };
+    std::mutex m_mutex;
+    HitchRecord m_records[kCapacity]{};
+    uint64_t m_total{};
+    uint64_t m_suppressed{};
+    std::chrono::steady_clock::time_point m_lastLog{};
+};
+
+namespace hitch
+{
+//! Per module, set by the interposer itself and by each plugin on load
+inline IHitchRecorder* s_recorder{};
+}
+
+//! Reports its scope to the hitch recorder if it lasted longer than the threshold, no-op without a recorder
+struct ScopedHitchTimer
+{
+    ScopedHitchTimer(const char* site) : m_recorder(hitch::s_recorder), m_site(site)
+    {
+        if (m_recorder)
+        {
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+    ~ScopedHitchTimer()
+    {
+        if (m_recorder)
+        {
+            auto ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+            if (ns >= m_recorder->getThresholdNs())
+            {
+                m_recorder->record(m_site, ns);
+            }
+        }
+    }
+
+    IHitchRecorder* m_recorder{};
+    const char* m_site{};
+    std::chrono::steady_clock::time_point m_start{};
+};
+
+}
+}
@@ -0,0 +1,158 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstring>
+#include <stdint.h>
+
+namespace sl
+{
+namespace extra
+{
+
+//! Creation parameters of a host image, enough to complete a tag which did not provide them
+struct ImageInfo
+{
+    uint32_t width{};
+    uint32_t height{};
+    uint32_t depth{};
+    uint32_t mipLevels{};
+    uint32_t arrayLayers{};
+    uint32_t format{};
+    uint32_t usage{};
+    uint32_t flags{};
+};
+
+//! Native image handle to 'ImageInfo', written on image creation and read only when an image is tagged
+//!
+//! Lock-free open addressing with a bounded probe so neither side ever waits or walks far. Handles are unique
+//! while alive which is what makes reusing erased slots safe. When the probe runs out the image is simply
+//! not recorded, the tag then has to carry the information as it always did.
+class ImageTable
+{
+public:
+    static constexpr uint32_t kCapacity = 1 << 16;
+    static constexpr uint32_t kMaxProbes = 64;
+
+    ImageTable() : m_slots(new Slot[kCapacity]) {}
+
+    bool insert(uint64_t handle, const ImageInfo& info)
+    {
+        if (handle == kEmpty || handle >= kBusy)
+        {
+            return false;
+        }
+        for (uint32_t i = 0; i < kMaxProbes; i++)
+        {
+            auto& slot = m_slots[(hash(handle) + i) & (kCapacity - 1)];
+            auto key = slot.key.load(std::memory_order_relaxed);
+            if ((key == kEmpty || key == kErased) && slot.key.compare_exchange_strong(key, kBusy, std::memory_order_acquire))
+            {
+                // Odd sequence marks the slot as being written, see 'find'
+                auto sequence = slot.sequence.load(std::memory_order_relaxed);
+                slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+                memcpy(&slot.info, &info, sizeof(ImageInfo));
+                slot.sequence.store(sequence + 2, std::memory_order_release);
+                slot.key.store(handle, std::memory_order_release);
+                return true;
+            }
+        }
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void erase(uint64_t handle)
+    {
+        for (uint32_t i = 0; i < kMaxProbes; i++)
+        {
+            auto& slot = m_slots[(hash(handle) + i) & (kCapacity - 1)];
+            auto key = handle;
+            if (slot.key.compare_exchange_strong(key, kErased, std::memory_order_relaxed))
+            {
+                return;
+            }
+            if (key == kEmpty)
+            {
+                return;
+            }
+        }
+    }
+
+    bool find(uint64_t handle, ImageInfo& info) const
+    {
+        for (uint32_t i = 0; i < kMaxProbes; i++)
+        {
+            auto& slot = m_slots[(hash(handle) + i) & (kCapacity - 1)];
+            auto key = slot.key.load(std::memory_order_acquire);
+            if (key == kEmpty)
+            {
+                return false;
+            }
+            if (key != handle)
+            {
+                continue;
+            }
+            auto sequence = slot.sequence.load(std::memory_order_acquire);
+            memcpy(&info, &slot.info, sizeof(ImageInfo));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            // Handle destroyed and reused while copying, treat it as not recorded
+            return !(sequence & 1) && slot.sequence.load(std::memory_order_relaxed) == sequence &&
+                slot.key.load(std::memory_order_relaxed) == handle;
+        }
+        return false;
+    }
+
+    //! Images which could not be recorded because their probe was full
+    uint64_t getDropped() const { return m_dropped.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint64_t kEmpty = 0;
+    static constexpr uint64_t kBusy = ~1ull;
+    static constexpr uint64_t kErased = ~0ull;
+
+    static uint32_t hash(uint64_t handle)
+    {
+        // Handles are mostly pointers or small counters, mix so neighbours do not share a probe
+        handle ^= handle >> 33;
+        handle *= 0xff51afd7ed558ccdull;
+        handle ^= handle >> 33;
+        return (uint32_t)handle;
+    }
+
+    struct Slot
+    {
+        std::atomic<uint64_t> key{};
+        std::atomic<uint64_t> sequence{};
+        ImageInfo info{};
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<uint64_t> m_dropped{};
+};
+
+}
+}
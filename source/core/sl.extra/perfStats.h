@@ -0,0 +1,195 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <stdint.h>
+
+#include "source/core/sl.log/log.h"
+
+namespace sl
+{
+namespace extra
+{
+
+enum class PerfCounter : uint32_t
+{
+    eSetTagNs,
+    eSetTagCalls,
+    eSetConstantsNs,
+    eSetConstantsCalls,
+    eEvaluateNs,
+    eEvaluateCalls,
+    eHookNs,
+    eHookCalls,
+    eGPUPassNs,
+    eGPUPasses,
+    eVolatileTagBytes,
+    eBarriers,
+    ePoolAllocations,
+    ePoolMisses,
+    eHeapAllocations,
+    eCount
+};
+
+constexpr uint32_t kPerfCounterCount = (uint32_t)PerfCounter::eCount;
+
+//! Frame level SL overhead counters, always collected
+//!
+//! Owned by sl.interposer and shared with plugins and sl.compute via 'param::global::kPerfStats'.
+//! Each thread accumulates into its own block so 'add' never contends, blocks are summed when a frame is presented.
+struct IPerfStats
+{
+    //! Thread safe
+    virtual void add(PerfCounter counter, uint64_t value) = 0;
+    //! Closes the current frame, called by the interposer once the present hooks ran
+    virtual void fold() = 0;
+    //! Counters of the last folded frame and the number of frames folded so far
+    virtual void getLastFrame(uint64_t (&values)[kPerfCounterCount], uint64_t& frameCount) = 0;
+};
+
+class PerfStats : public IPerfStats
+{
+public:
+    void add(PerfCounter counter, uint64_t value) override
+    {
+        getThreadBlock().values[(uint32_t)counter].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    void fold() override
+    {
+        std::scoped_lock lock(m_mutex);
+        uint64_t totals[kPerfCounterCount]{};
+        for (auto& block : m_blocks)
+        {
+            for (uint32_t i = 0; i < kPerfCounterCount; i++)
+            {
+                totals[i] += block->values[i].load(std::memory_order_relaxed);
+            }
+        }
+        // Counted by the replaced operator new in each module, see 'SL_ALLOCATION_TRACKING_DEFINE'
+        totals[(uint32_t)PerfCounter::eHeapAllocations] = m_heapAllocations.load(std::memory_order_relaxed);
+        // Blocks only ever grow so the difference is what was added since the previous present
+        for (uint32_t i = 0; i < kPerfCounterCount; i++)
+        {
+            m_lastFrame[i] = totals[i] - m_totals[i];
+            m_totals[i] = totals[i];
+        }
+        m_frameCount++;
+        m_epoch.fetch_add(1, std::memory_order_relaxed);
+#if defined(SL_TRACK_ALLOCATIONS) && SL_TRACK_ALLOCATIONS
+        // Per frame paths are expected to run out of frame arenas once everything is created
+        auto heapAllocations = m_lastFrame[(uint32_t)PerfCounter::eHeapAllocations];
+        if (m_frameCount > kSteadyStateFrames && heapAllocations)
+        {
+            SL_LOG_WARN_EVERY(1000, "Frame %llu made %llu heap allocation(s) in SL, expected none in steady state", m_frameCount, heapAllocations);
+        }
+#endif
+    }
+
+    void getLastFrame(uint64_t (&values)[kPerfCounterCount], uint64_t& frameCount) override
+    {
+        std::scoped_lock lock(m_mutex);
+        for (uint32_t i = 0; i < kPerfCounterCount; i++)
+        {
+            values[i] = m_lastFrame[i];
+        }
+        frameCount = m_frameCount;
+    }
+
+    //! Advanced on every fold, frame arenas rewind when it changes, see 'extra::frame::s_epoch'
+    const std::atomic<uint64_t>& getEpoch() const { return m_epoch; }
+    std::atomic<uint64_t>& getHeapAllocations() { return m_heapAllocations; }
+
+private:
+
+    //! Frames after 'slInit' where resources, contexts and pools are still being created
+    static constexpr uint64_t kSteadyStateFrames = 120;
+
+    struct ThreadBlock
+    {
+        std::atomic<uint64_t> values[kPerfCounterCount]{};
+    };
+
+    //! Registered once per thread, blocks of threads which exited stay around so totals never go backwards
+    ThreadBlock& getThreadBlock()
+    {
+        thread_local ThreadBlock* t_block{};
+        thread_local uint64_t t_owner{};
+        if (t_owner != m_id)
+        {
+            std::scoped_lock lock(m_mutex);
+            m_blocks.push_back(std::make_unique<ThreadBlock>());
+            t_block = m_blocks.back().get();
+            t_owner = m_id;
+        }
+        return *t_block;
+    }
+
+    static uint64_t getNextId()
+    {
+        static std::atomic<uint64_t> s_id{};
+        return ++s_id;
+    }
+
+    //! Unique per instance so a new instance at the same address never picks up stale thread blocks
+    const uint64_t m_id = getNextId();
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<ThreadBlock>> m_blocks;
+    uint64_t m_totals[kPerfCounterCount]{};
+    uint64_t m_lastFrame[kPerfCounterCount]{};
+    uint64_t m_frameCount{};
+    std::atomic<uint64_t> m_epoch{};
+    std::atomic<uint64_t> m_heapAllocations{};
+};
+
+//! Adds the CPU time of its scope and one call to the given counters, no-op without stats
+struct ScopedPerfTimer
+{
+    ScopedPerfTimer(IPerfStats* stats, PerfCounter ns, PerfCounter calls) : m_stats(stats), m_ns(ns)
+    {
+        if (m_stats)
+        {
+            m_stats->add(calls, 1);
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+    ~ScopedPerfTimer()
+    {
+        if (m_stats)
+        {
+            m_stats->add(m_ns, (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count());
+        }
+    }
+
+    IPerfStats* m_stats{};
+    PerfCounter m_ns{};
+    std::chrono::steady_clock::time_point m_start{};
+};
+
+}
+}
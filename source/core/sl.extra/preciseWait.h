@@ -0,0 +1,139 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#if SL_WINDOWS
+#include <windows.h>
+#endif
+
+namespace sl
+{
+namespace extra
+{
+
+//! Sub-millisecond waits without raising the process wide timer resolution
+//!
+//! Sleeps on a high resolution waitable timer and spins through the final stretch. Older Windows versions
+//! without CREATE_WAITABLE_TIMER_HIGH_RESOLUTION get a regular waitable timer and a longer spin.
+//! Not thread safe, each waiting thread needs its own instance, see 'preciseSleepUs'.
+class PreciseTimer
+{
+public:
+    static constexpr double kSpinUs = 500.0;
+    static constexpr double kCoarseSpinUs = 2000.0;
+
+    PreciseTimer()
+    {
+#if SL_WINDOWS
+        m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+        if (!m_timer)
+        {
+            m_timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+            m_spinUs = kCoarseSpinUs;
+        }
+#endif
+    }
+    PreciseTimer(const PreciseTimer&) = delete;
+    PreciseTimer& operator=(const PreciseTimer&) = delete;
+
+    ~PreciseTimer()
+    {
+#if SL_WINDOWS
+        if (m_timer)
+        {
+            CloseHandle(m_timer);
+        }
+#endif
+    }
+
+    //! QueryPerformanceCounter ticks
+    static int64_t now()
+    {
+#if SL_WINDOWS
+        LARGE_INTEGER qpc{};
+        QueryPerformanceCounter(&qpc);
+        return qpc.QuadPart;
+#else
+        return 0;
+#endif
+    }
+
+    static double ticksPerUs()
+    {
+#if SL_WINDOWS
+        static const double s_ticksPerUs = []()
+        {
+            LARGE_INTEGER frequency{};
+            QueryPerformanceFrequency(&frequency);
+            return (double)frequency.QuadPart / 1e6;
+        }();
+        return s_ticksPerUs;
+#else
+        return 1.0;
+#endif
+    }
+
+    //! Returns right away if 'target' is in the past
+    void waitUntil(int64_t target)
+    {
+#if SL_WINDOWS
+        auto remainingUs = (double)(target - now()) / ticksPerUs();
+        if (remainingUs > m_spinUs && m_timer)
+        {
+            // Relative due time in 100ns units
+            LARGE_INTEGER due{};
+            due.QuadPart = -(int64_t)((remainingUs - m_spinUs) * 10.0);
+            if (SetWaitableTimerEx(m_timer, &due, 0, nullptr, nullptr, nullptr, 0))
+            {
+                WaitForSingleObject(m_timer, INFINITE);
+            }
+        }
+        while (now() < target)
+        {
+            YieldProcessor();
+        }
+#endif
+    }
+
+    void waitForUs(double us)
+    {
+        waitUntil(now() + (int64_t)(us * ticksPerUs()));
+    }
+
+private:
+#if SL_WINDOWS
+    HANDLE m_timer{};
+#endif
+    double m_spinUs = kSpinUs;
+};
+
+//! Precise replacement for 'std::this_thread::sleep_for', timer is created on first use by each thread
+inline void preciseSleepUs(double us)
+{
+    thread_local PreciseTimer t_timer;
+    t_timer.waitForUs(us);
+}
+
+}
+}
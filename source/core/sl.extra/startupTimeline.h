@@ -0,0 +1,181 @@
+/*
+* Copyright (c) 2022-2023 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+#if SL_WINDOWS
+#include <windows.h>
+#endif
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <thread>
+#include <sstream>
+#include <algorithm>
+#include <unordered_map>
+#include <iomanip>
+
+namespace sl
+{
+namespace extra
+{
+
+//! Startup timeline for slInit, plugin bring-up, NGX init, compute and kernel creation
+//! 
+//! Owned by sl.interposer and shared with plugins via 'param::global::kStartupTimeline',
+//! parameter is not set when profiling is disabled so all scopes become no-ops.
+struct IStartupTimeline
+{
+    //! Opens a phase on the calling thread, returns start time in microseconds
+    virtual uint64_t beginPhase() = 0;
+    //! Closes the innermost phase opened on the calling thread
+    virtual void endPhase(const char* name, uint64_t startUs) = 0;
+};
+
+class StartupTimeline : public IStartupTimeline
+{
+public:
+    uint64_t beginPhase() override
+    {
+        std::scoped_lock lock(m_mutex);
+        m_depth[getThreadId()]++;
+        return getTimeUs();
+    }
+
+    void endPhase(const char* name, uint64_t startUs) override
+    {
+        auto endUs = getTimeUs();
+        std::scoped_lock lock(m_mutex);
+        auto tid = getThreadId();
+        auto& depth = m_depth[tid];
+        depth = depth > 0 ? depth - 1 : 0;
+        m_events.push_back({ name ? name : "unknown", startUs, endUs - startUs, tid, depth });
+    }
+
+    //! Chrome trace format, open with chrome://tracing or ui.perfetto.dev
+    std::string getChromeTrace()
+    {
+        // Written by hand so this header stays usable from sl.compute without pulling in JSON
+        std::scoped_lock lock(m_mutex);
+        std::ostringstream stream;
+        stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        for (size_t i = 0; i < m_events.size(); i++)
+        {
+            auto& e = m_events[i];
+            std::string name;
+            for (auto c : e.name)
+            {
+                if (c == '"' || c == '\\') name += '\\';
+                name += c;
+            }
+            stream << (i ? ",\n" : "\n") << "{\"name\":\"" << name << "\",\"cat\":\"startup\",\"ph\":\"X\",\"ts\":" << e.startUs
+                << ",\"dur\":" << e.durationUs << ",\"pid\":1,\"tid\":" << e.tid << "}";
+        }
+        stream << "\n]}\n";
+        return stream.str();
+    }
+
+    //! One line per phase, in start order and indented by nesting depth
+    std::vector<std::string> getSummary()
+    {
+        std::scoped_lock lock(m_mutex);
+        auto sorted = m_events;
+        std::sort(sorted.begin(), sorted.end(), [](const Event& a, const Event& b)->bool
+        {
+            return a.tid != b.tid ? a.tid < b.tid : (a.startUs != b.startUs ? a.startUs < b.startUs : a.depth < b.depth);
+        });
+        std::vector<std::string> lines;
+        for (auto& e : sorted)
+        {
+            std::ostringstream stream;
+            stream << std::string(e.depth * 2, ' ') << e.name << " " << std::fixed << std::setprecision(2) << e.durationUs / 1000.0 << "ms";
+            if (e.tid != sorted.front().tid)
+            {
+                stream << " (thread " << e.tid << ")";
+            }
+            lines.push_back(stream.str());
+        }
+        return lines;
+    }
+
+    size_t getEventCount()
+    {
+        std::scoped_lock lock(m_mutex);
+        return m_events.size();
+    }
+
+private:
+
+    struct Event
+    {
+        std::string name;
+        uint64_t startUs;
+        uint64_t durationUs;
+        uint32_t tid;
+        uint32_t depth;
+    };
+
+    uint64_t getTimeUs() const
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_origin).count();
+    }
+
+    static uint32_t getThreadId()
+    {
+#ifdef SL_WINDOWS
+        return (uint32_t)GetCurrentThreadId();
+#else
+        return (uint32_t)std::hash<std::thread::id>{}(std::this_thread::get_id());
+#endif
+    }
+
+    std::mutex m_mutex;
+    std::chrono::steady_clock::time_point m_origin = std::chrono::steady_clock::now();
+    std::unordered_map<uint32_t, uint32_t> m_depth;
+    std::vector<Event> m_events;
+};
+
+//! Names are copied when the phase closes so temporaries are fine
+struct ScopedStartupPhase
+{
+    ScopedStartupPhase(IStartupTimeline* timeline, const char* name) : m_timeline(timeline), m_name(name)
+    {
+        if (m_timeline) m_startUs = m_timeline->beginPhase();
+    }
+    ~ScopedStartupPhase()
+    {
+        if (m_timeline) m_timeline->endPhase(m_name, m_startUs);
+    }
+
+    IStartupTimeline* m_timeline{};
+    const char* m_name{};
+    uint64_t m_startUs{};
+};
+
+}
+}
+
+#define SL_STARTUP_PHASE_CONCAT_(a, b) a##b
+#define SL_STARTUP_PHASE_CONCAT(a, b) SL_STARTUP_PHASE_CONCAT_(a, b)
+#define SL_STARTUP_PHASE(timeline, name) sl::extra::ScopedStartupPhase SL_STARTUP_PHASE_CONCAT(startupPhase, __LINE__)(timeline, name)
@@ -0,0 +1,151 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+
+#pragma once
+
+//! Instrumentation zones for external profilers
+//!
+//! Selected at build time, see 'premake --with-trace', by default every macro below compiles to nothing.
+//!
+//! 'SL_TRACE_ETW' emits start/stop events through the "NVIDIA.Streamline" TraceLogging provider
+//! {42a9414b-0b16-4a2e-be8b-17d89990ea47}, record with WPR/xperf or PIX and view as regions in WPA.
+//!
+//! 'SL_TRACE_TRACY' emits zones through the Tracy C API (0.11 or newer). SL modules import the client so zones
+//! end up in the same session as the host engine, which must ship 'TracyClient.dll' built with 'TRACY_EXPORTS'.
+
+#ifndef SL_TRACE_ETW
+#define SL_TRACE_ETW 0
+#endif
+#ifndef SL_TRACE_TRACY
+#define SL_TRACE_TRACY 0
+#endif
+
+#define SL_TRACE_ENABLED (SL_TRACE_ETW || SL_TRACE_TRACY)
+
+#if SL_TRACE_ENABLED
+
+#include <optional>
+#include <string.h>
+#include <stdint.h>
+
+#if SL_TRACE_ETW
+#include <windows.h>
+#include <winmeta.h>
+#include <TraceLoggingProvider.h>
+TRACELOGGING_DECLARE_PROVIDER(g_slTraceProvider);
+#endif
+
+#if SL_TRACE_TRACY
+#include "tracy/TracyC.h"
+#endif
+
+namespace sl
+{
+namespace extra
+{
+
+//! Profiler zone covering the lifetime of the object
+//!
+//! Name is copied by both backends so it can be a temporary string.
+class TraceZone
+{
+public:
+    TraceZone(const char* name, const char* file, const char* function, uint32_t line)
+    {
+#if SL_TRACE_ETW
+        if (TraceLoggingProviderEnabled(g_slTraceProvider, 0, 0))
+        {
+            // Activity id pairs start and stop, zones can nest and overlap across threads
+            EventActivityIdControl(EVENT_ACTIVITY_CTRL_CREATE_ID, &m_activity);
+            TraceLoggingWriteActivity(g_slTraceProvider, "Zone", &m_activity, nullptr,
+                TraceLoggingOpcode(WINEVENT_OPCODE_START), TraceLoggingString(name, "Name"));
+            m_etw = true;
+        }
+#endif
+#if SL_TRACE_TRACY
+        auto srcloc = ___tracy_alloc_srcloc_name(line, file, strlen(file), function, strlen(function), name, strlen(name), 0);
+        m_tracy = ___tracy_emit_zone_begin_alloc(srcloc, 1);
+#endif
+    }
+
+    ~TraceZone()
+    {
+#if SL_TRACE_TRACY
+        ___tracy_emit_zone_end(m_tracy);
+#endif
+#if SL_TRACE_ETW
+        if (m_etw)
+        {
+            TraceLoggingWriteActivity(g_slTraceProvider, "Zone", &m_activity, nullptr, TraceLoggingOpcode(WINEVENT_OPCODE_STOP));
+        }
+#endif
+    }
+
+    TraceZone(const TraceZone&) = delete;
+    TraceZone& operator=(const TraceZone&) = delete;
+
+private:
+#if SL_TRACE_ETW
+    GUID m_activity{};
+    bool m_etw = false;
+#endif
+#if SL_TRACE_TRACY
+    TracyCZoneCtx m_tracy{};
+#endif
+};
+
+}
+}
+
+#define SL_TRACE_CONCAT_(A, B) A##B
+#define SL_TRACE_CONCAT(A, B) SL_TRACE_CONCAT_(A, B)
+
+//! Zone from here to the end of the enclosing scope
+#define SL_TRACE_ZONE(NAME) sl::extra::TraceZone SL_TRACE_CONCAT(slTraceZone, __LINE__)(NAME, __FILE__, __FUNCTION__, __LINE__)
+//! Zone owned by an object, for scoped helpers which start the zone in their constructor
+#define SL_TRACE_ZONE_MEMBER(VAR) std::optional<sl::extra::TraceZone> VAR
+#define SL_TRACE_ZONE_BEGIN(VAR, NAME) VAR.emplace(NAME, __FILE__, __FUNCTION__, __LINE__)
+
+#else
+
+#define SL_TRACE_ZONE(NAME)
+#define SL_TRACE_ZONE_MEMBER(VAR)
+#define SL_TRACE_ZONE_BEGIN(VAR, NAME)
+
+#endif
+
+#if SL_TRACE_ETW
+//! Defines and registers the provider, exactly once per module (DLL or executable)
+//!
+//! Every module registers the same provider, ETW merges them into a single stream.
+#define SL_TRACE_DEFINE_PROVIDER()                                                                          \
+TRACELOGGING_DEFINE_PROVIDER(g_slTraceProvider, "NVIDIA.Streamline",                                        \
+    (0x42a9414b, 0x0b16, 0x4a2e, 0xbe, 0x8b, 0x17, 0xd8, 0x99, 0x90, 0xea, 0x47));                       \
+static struct SLTraceProviderRegistration                                                                   \
+{                                                                                                           \
+    SLTraceProviderRegistration() { TraceLoggingRegister(g_slTraceProvider); }                              \
+    ~SLTraceProviderRegistration() { TraceLoggingUnregister(g_slTraceProvider); }                           \
+} s_slTraceProviderRegistration;
+#else
+#define SL_TRACE_DEFINE_PROVIDER()
+#endif
@@ -48,6 +48,9 @@
 EXTERN_C IMAGE_DOS_HEADER __ImageBase; // MS linker feature
 #else
 #include <linux/limits.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
 namespace fs = std::filesystem;
@@ -173,6 +176,100 @@ inline std::vector<uint8_t> read(const wchar_t* fname)
     return ret_buffer;
 }
 
+//! Read-only view of a whole file, unmapped when it goes out of scope
+//! 
+//! Pages are shared with the OS file cache so nothing is copied up front.
+//! Empty or missing files give an empty view, check with 'empty()'.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept { *this = std::move(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            std::swap(m_data, other.m_data);
+            std::swap(m_size, other.m_size);
+        }
+        return *this;
+    }
+    ~MappedFile() { unmap(); }
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    const uint8_t* begin() const { return m_data; }
+    const uint8_t* end() const { return m_data + m_size; }
+
+private:
+    friend MappedFile map(const wchar_t* fname);
+
+    void unmap()
+    {
+        if (m_data)
+        {
+#ifdef SL_WINDOWS
+            UnmapViewOfFile(m_data);
+#else
+            munmap((void*)m_data, m_size);
+#endif
+        }
+        m_data = {};
+        m_size = 0;
+    }
+
+    const uint8_t* m_data{};
+    size_t m_size{};
+};
+
+inline MappedFile map(const wchar_t* fname)
+{
+    MappedFile view;
+#ifdef SL_WINDOWS
+    HANDLE file = CreateFileW(fname, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return view;
+    }
+    LARGE_INTEGER size{};
+    // Zero sized files cannot be mapped
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+    {
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping)
+        {
+            view.m_data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            view.m_size = view.m_data ? (size_t)size.QuadPart : 0;
+            // View keeps the mapping alive
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd = ::open(extra::toStr(fname).c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return view;
+    }
+    struct stat st {};
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED)
+        {
+            view.m_data = (const uint8_t*)p;
+            view.m_size = (size_t)st.st_size;
+        }
+    }
+    ::close(fd);
+#endif
+    return view;
+}
+
 inline const wchar_t* getTmpPath()
 {
     static std::wstring g_result;
@@ -21,10 +21,15 @@
 */ 
 
 #include <wrl/client.h>
+#include <algorithm>
+#include <mutex>
+#include <vector>
 
 #include "include/sl.h"
 #include "source/core/sl.interposer/d3d12/d3d12Device.h"
 #include "source/core/sl.interposer/d3d12/d3d12CommandList.h"
+#include "source/core/sl.interposer/hook.h"
+#include "source/core/sl.interposer/interfaceLookup.h"
 #include "source/core/sl.log/log.h"
 #include "source/core/sl.api/internal.h"
 #include "source/core/sl.plugin-manager/pluginManager.h"
@@ -37,6 +42,57 @@ namespace interposer
 
 static_assert(offsetof(D3D12GraphicsCommandList, m_base) == 16, "This location must be maintained to keep compatibility with Nsight tools");
 
+namespace
+{
+// Anything above this is returned to the heap, covers the peak number of lists engines tend to keep alive
+constexpr size_t kMaxPooledProxies = 256;
+
+struct ProxyPool
+{
+    ProxyPool() { free.reserve(kMaxPooledProxies); }
+    std::mutex mutex;
+    std::vector<void*> free;
+};
+
+ProxyPool* getProxyPool()
+{
+    // Intentionally leaked, proxies can be released by the host after static destructors ran
+    static ProxyPool* s_pool = new ProxyPool;
+    return s_pool;
+}
+}
+
+void* D3D12GraphicsCommandList::operator new(size_t size)
+{
+    assert(size == sizeof(D3D12GraphicsCommandList));
+    auto pool = getProxyPool();
+    {
+        std::scoped_lock lock(pool->mutex);
+        if (!pool->free.empty())
+        {
+            auto p = pool->free.back();
+            pool->free.pop_back();
+            return p;
+        }
+    }
+    return ::operator new(size);
+}
+
+void D3D12GraphicsCommandList::operator delete(void* p)
+{
+    if (!p) return;
+    auto pool = getProxyPool();
+    {
+        std::scoped_lock lock(pool->mutex);
+        if (pool->free.size() < kMaxPooledProxies)
+        {
+            pool->free.push_back(p);
+            return;
+        }
+    }
+    ::operator delete(p);
+}
+
 D3D12GraphicsCommandList::D3D12GraphicsCommandList(D3D12Device* device, ID3D12GraphicsCommandList* original) :
     m_base(original),
     m_interfaceVersion(0),
@@ -48,6 +104,13 @@ D3D12GraphicsCommandList::D3D12GraphicsCommandList(D3D12Device* device, ID3D12Gr
     {
         SL_LOG_WARN_ONCE("State tracking for command list 0x%llx has been DISABLED, please ensure to restore CL state correctly on the host side.", this);
     }
+    else if (sl::interposer::getInterface()->getConfig().d3d12LazyStateTracking)
+    {
+        // Lists SL never evaluates on never pay for tracking
+        m_lazyTracking = true;
+        m_trackState = false;
+    }
+    m_trackBarriers = sl::interposer::getInterface()->getConfig().d3d12TrackBarrierStates;
     // Same ref count as base interface to start with
     m_base->AddRef();
     m_refCount.store(m_base->Release());
@@ -55,45 +118,40 @@ D3D12GraphicsCommandList::D3D12GraphicsCommandList(D3D12Device* device, ID3D12Gr
 
 bool D3D12GraphicsCommandList::checkAndUpgradeInterface(REFIID riid)
 {
-    if (riid == __uuidof(this) || riid == __uuidof(IUnknown) || riid == __uuidof(ID3D12Object) ||
-        riid == __uuidof(ID3D12DeviceChild) || riid == __uuidof(ID3D12CommandList))
+    static const InterfaceLookup s_lookup(
+        { __uuidof(D3D12GraphicsCommandList), __uuidof(IUnknown), __uuidof(ID3D12Object), __uuidof(ID3D12DeviceChild), __uuidof(ID3D12CommandList) },
+        {
+            __uuidof(ID3D12GraphicsCommandList),
+            __uuidof(ID3D12GraphicsCommandList1),
+            __uuidof(ID3D12GraphicsCommandList2),
+            __uuidof(ID3D12GraphicsCommandList3),
+            __uuidof(ID3D12GraphicsCommandList4),
+            __uuidof(ID3D12GraphicsCommandList5),
+            __uuidof(ID3D12GraphicsCommandList6),
+            __uuidof(ID3D12GraphicsCommandList7),
+            __uuidof(ID3D12GraphicsCommandList8)
+        });
+
+    auto version = s_lookup.find(riid);
+    if (version == InterfaceLookup::kUnknown)
     {
-        return true;
+        return false;
     }
 
-    std::vector<IID> iidLookup = {
-      __uuidof(ID3D12GraphicsCommandList),
-      __uuidof(ID3D12GraphicsCommandList1),
-      __uuidof(ID3D12GraphicsCommandList2),
-      __uuidof(ID3D12GraphicsCommandList3),
-      __uuidof(ID3D12GraphicsCommandList4),
-      __uuidof(ID3D12GraphicsCommandList5),
-      __uuidof(ID3D12GraphicsCommandList6),
-      __uuidof(ID3D12GraphicsCommandList7),
-      __uuidof(ID3D12GraphicsCommandList8),
-    };
-
-    for (uint32_t version = 0; version < uint32_t(iidLookup.size()); ++version)
+    // Upgraded base interface is kept in 'm_base', repeated queries for the same version only compare
+    if (version > (int32_t)m_interfaceVersion)
     {
-        if (riid != iidLookup[version])
+        IUnknown* new_interface = nullptr;
+        if (FAILED(m_base->QueryInterface(riid, reinterpret_cast<void**>(&new_interface))))
         {
-            continue;
+            return false;
         }
-
-        if (version > m_interfaceVersion)
-        {
-            IUnknown* new_interface = nullptr;
-            if (FAILED(m_base->QueryInterface(riid, reinterpret_cast<void**>(&new_interface))))
-                return false;
-            m_base->Release();
-            m_base = static_cast<ID3D12GraphicsCommandList*>(new_interface);
-            m_interfaceVersion = version;
-        }
-
-        return true;
+        m_base->Release();
+        m_base = static_cast<ID3D12GraphicsCommandList*>(new_interface);
+        m_interfaceVersion = (uint32_t)version;
     }
 
-    return false;
+    return true;
 }
 
 HRESULT STDMETHODCALLTYPE D3D12GraphicsCommandList::QueryInterface(REFIID riid, void** ppvObj)
@@ -170,17 +228,17 @@ HRESULT STDMETHODCALLTYPE D3D12GraphicsCommandList::Close()
 }
 HRESULT STDMETHODCALLTYPE D3D12GraphicsCommandList::Reset(ID3D12CommandAllocator* pAllocator, ID3D12PipelineState* pInitialState)
 {
+    if (m_lazyTracking)
+    {
+        m_trackState = m_evaluated;
+    }
     if (m_trackState)
     {
         m_rootSignature = {};
         m_pso = pInitialState;
         m_so = {};
         m_numHeaps = {};
-        m_mapHandles = {};
-        m_mapCBV.clear();
-        m_mapSRV.clear();
-        m_mapUAV.clear();
-        m_mapConstants.clear();
+        resetRootParameters();
     }
     return m_base->Reset(pAllocator, pInitialState);
 }
@@ -193,11 +251,7 @@ void STDMETHODCALLTYPE D3D12GraphicsCommandList::ClearState(ID3D12PipelineState*
         m_pso = pPipelineState;
         m_so = {};
         m_numHeaps = {};
-        m_mapHandles = {};
-        m_mapCBV.clear();
-        m_mapSRV.clear();
-        m_mapUAV.clear();
-        m_mapConstants.clear();
+        resetRootParameters();
     }
     m_base->ClearState(pPipelineState);
 }
@@ -268,6 +322,28 @@ void STDMETHODCALLTYPE D3D12GraphicsCommandList::SetPipelineState(ID3D12Pipeline
 void STDMETHODCALLTYPE D3D12GraphicsCommandList::ResourceBarrier(UINT NumBarriers, const D3D12_RESOURCE_BARRIER* pBarriers)
 {
     m_base->ResourceBarrier(NumBarriers, pBarriers);
+    if (m_trackBarriers)
+    {
+        for (UINT i = 0; i < NumBarriers; i++)
+        {
+            auto& barrier = pBarriers[i];
+            if (barrier.Type != D3D12_RESOURCE_BARRIER_TYPE_TRANSITION || !barrier.Transition.pResource) continue;
+            // Per subresource states are not tracked since SL tags cover the whole resource, the state is also
+            // in flux between the begin and end halves of a split barrier so both invalidate until the next full transition
+            auto after = barrier.Transition.StateAfter;
+            if (barrier.Transition.Subresource != D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES || (barrier.Flags & D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY))
+            {
+                after = kResourceStateUnknown;
+            }
+            auto resource = barrier.Transition.pResource;
+            D3D12_RESOURCE_STATES state{};
+            UINT size = sizeof(state);
+            if (SUCCEEDED(resource->GetPrivateData(kResourceStateGUID, &size, &state)) && state != after)
+            {
+                resource->SetPrivateData(kResourceStateGUID, sizeof(after), &after);
+            }
+        }
+    }
 }
 void STDMETHODCALLTYPE D3D12GraphicsCommandList::ExecuteBundle(ID3D12GraphicsCommandList* pCommandList)
 {
@@ -302,11 +378,7 @@ void STDMETHODCALLTYPE D3D12GraphicsCommandList::SetComputeRootSignature(ID3D12R
     {
         m_rootSignature = pRootSignature;
         // Clear root signature cached items
-        m_mapCBV.clear();
-        m_mapSRV.clear();
-        m_mapUAV.clear();
-        m_mapConstants.clear();
-        m_mapHandles.clear();
+        resetRootParameters();
     }
 }
 void STDMETHODCALLTYPE D3D12GraphicsCommandList::SetGraphicsRootSignature(ID3D12RootSignature* pRootSignature)
@@ -317,9 +389,10 @@ void STDMETHODCALLTYPE D3D12GraphicsCommandList::SetComputeRootDescriptorTable(U
 {
     m_base->SetComputeRootDescriptorTable(RootParameterIndex, BaseDescriptor);
 
-    if (m_trackState)
+    if (m_trackState && RootParameterIndex < kMaxRootParameterCount)
     {
-        m_mapHandles[RootParameterIndex] = BaseDescriptor;
+        m_handles[RootParameterIndex] = BaseDescriptor;
+        m_validHandles |= 1ull << RootParameterIndex;
     }
 }
 void STDMETHODCALLTYPE D3D12GraphicsCommandList::SetGraphicsRootDescriptorTable(UINT RootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE BaseDescriptor)
@@ -332,9 +405,7 @@ void STDMETHODCALLTYPE D3D12GraphicsCommandList::SetComputeRoot32BitConstant(UIN
 
     if (m_trackState)
     {
-        auto& entry = m_mapConstants[RootParameterIndex];
-        entry.Num32BitValuesToSet = 1;
-        entry.SrcData[0] = SrcData;
+        trackRootConstants(RootParameterIndex, 1, &SrcData, DestOffsetIn32BitValues);
     }
 }
 void STDMETHODCALLTYPE D3D12GraphicsCommandList::SetGraphicsRoot32BitConstant(UINT RootParameterIndex, UINT SrcData, UINT DestOffsetIn32BitValues)
@@ -345,18 +416,37 @@ void STDMETHODCALLTYPE D3D12GraphicsCommandList::SetComputeRoot32BitConstants(UI
 {
     m_base->SetComputeRoot32BitConstants(RootParameterIndex, Num32BitValuesToSet, pSrcData, DestOffsetIn32BitValues);
 
-    assert(Num32BitValuesToSet <= kMaxComputeRoot32BitConstCount);
+    if (m_trackState)
+    {
+        trackRootConstants(RootParameterIndex, Num32BitValuesToSet, pSrcData, DestOffsetIn32BitValues);
+    }
+}
+void D3D12GraphicsCommandList::trackRootConstants(UINT RootParameterIndex, UINT Num32BitValuesToSet, const void* pSrcData, UINT DestOffsetIn32BitValues)
+{
+    assert(DestOffsetIn32BitValues + Num32BitValuesToSet <= kMaxComputeRoot32BitConstCount);
+
+    if (DestOffsetIn32BitValues + Num32BitValuesToSet > kMaxComputeRoot32BitConstCount || RootParameterIndex >= kMaxRootParameterCount)
+    {
+        SL_LOG_WARN("Too many 32bit root constants %u", DestOffsetIn32BitValues + Num32BitValuesToSet);
+        return;
+    }
 
-    if (Num32BitValuesToSet > kMaxComputeRoot32BitConstCount)
+    // Partial updates accumulate, restore covers everything set since the root signature changed
+    auto& entry = m_constants[RootParameterIndex];
+    uint64_t bit = 1ull << RootParameterIndex;
+    uint32_t end = DestOffsetIn32BitValues + Num32BitValuesToSet;
+    if (m_validConstants & bit)
     {
-        SL_LOG_WARN("Too many 32bit root constants %u", Num32BitValuesToSet);
+        end = std::max(end, entry.DestOffsetIn32BitValues + entry.Num32BitValuesToSet);
+        entry.DestOffsetIn32BitValues = std::min(entry.DestOffsetIn32BitValues, DestOffsetIn32BitValues);
     }
-    else if(m_trackState)
+    else
     {
-        auto& entry = m_mapConstants[RootParameterIndex];
-        entry.Num32BitValuesToSet = Num32BitValuesToSet;
-        memcpy(entry.SrcData, pSrcData, sizeof(uint32_t) * Num32BitValuesToSet);
+        entry.DestOffsetIn32BitValues = DestOffsetIn32BitValues;
+        m_validConstants |= bit;
     }
+    entry.Num32BitValuesToSet = end - entry.DestOffsetIn32BitValues;
+    memcpy(entry.SrcData + DestOffsetIn32BitValues, pSrcData, sizeof(uint32_t) * Num32BitValuesToSet);
 }
 void STDMETHODCALLTYPE D3D12GraphicsCommandList::SetGraphicsRoot32BitConstants(UINT RootParameterIndex, UINT Num32BitValuesToSet, const void* pSrcData, UINT DestOffsetIn32BitValues)
 {
@@ -366,9 +456,10 @@ void STDMETHODCALLTYPE D3D12GraphicsCommandList::SetComputeRootConstantBufferVie
 {
     m_base->SetComputeRootConstantBufferView(RootParameterIndex, BufferLocation);
 
-    if (m_trackState)
+    if (m_trackState && RootParameterIndex < kMaxRootParameterCount)
     {
-        m_mapCBV[RootParameterIndex] = BufferLocation;
+        m_cbv[RootParameterIndex] = BufferLocation;
+        m_validCBV |= 1ull << RootParameterIndex;
     }
 }
 void STDMETHODCALLTYPE D3D12GraphicsCommandList::SetGraphicsRootConstantBufferView(UINT RootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS BufferLocation)
@@ -379,9 +470,10 @@ void STDMETHODCALLTYPE D3D12GraphicsCommandList::SetComputeRootShaderResourceVie
 {
     m_base->SetComputeRootShaderResourceView(RootParameterIndex, BufferLocation);
 
-    if (m_trackState)
+    if (m_trackState && RootParameterIndex < kMaxRootParameterCount)
     {
-        m_mapSRV[RootParameterIndex] = BufferLocation;
+        m_srv[RootParameterIndex] = BufferLocation;
+        m_validSRV |= 1ull << RootParameterIndex;
     }
 }
 void STDMETHODCALLTYPE D3D12GraphicsCommandList::SetGraphicsRootShaderResourceView(UINT RootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS BufferLocation)
@@ -392,9 +484,10 @@ void STDMETHODCALLTYPE D3D12GraphicsCommandList::SetComputeRootUnorderedAccessVi
 {
     m_base->SetComputeRootUnorderedAccessView(RootParameterIndex, BufferLocation);
 
-    if (m_trackState)
+    if (m_trackState && RootParameterIndex < kMaxRootParameterCount)
     {
-        m_mapUAV[RootParameterIndex] = BufferLocation;
+        m_uav[RootParameterIndex] = BufferLocation;
+        m_validUAV |= 1ull << RootParameterIndex;
     }
 }
 void STDMETHODCALLTYPE D3D12GraphicsCommandList::SetGraphicsRootUnorderedAccessView(UINT RootParameterIndex, D3D12_GPU_VIRTUAL_ADDRESS BufferLocation)
@@ -566,6 +659,28 @@ void STDMETHODCALLTYPE D3D12GraphicsCommandList::DispatchMesh(UINT ThreadGroupCo
 void STDMETHODCALLTYPE D3D12GraphicsCommandList::Barrier(UINT32 NumBarrierGroups, const D3D12_BARRIER_GROUP* pBarrierGroups)
 {
     static_cast<ID3D12GraphicsCommandList7*>(m_base)->Barrier(NumBarrierGroups, pBarrierGroups);
+    if (m_trackBarriers)
+    {
+        // Enhanced layouts do not map to legacy states, tracked resources fall back to the state passed with the tag
+        auto invalidate = [](ID3D12Resource* resource)->void
+        {
+            D3D12_RESOURCE_STATES state{};
+            UINT size = sizeof(state);
+            if (resource && SUCCEEDED(resource->GetPrivateData(kResourceStateGUID, &size, &state)) && state != kResourceStateUnknown)
+            {
+                resource->SetPrivateData(kResourceStateGUID, sizeof(kResourceStateUnknown), &kResourceStateUnknown);
+            }
+        };
+        for (UINT32 i = 0; i < NumBarrierGroups; i++)
+        {
+            auto& group = pBarrierGroups[i];
+            for (UINT32 j = 0; j < group.NumBarriers; j++)
+            {
+                if (group.Type == D3D12_BARRIER_TYPE_TEXTURE) invalidate(group.pTextureBarriers[j].pResource);
+                else if (group.Type == D3D12_BARRIER_TYPE_BUFFER) invalidate(group.pBufferBarriers[j].pResource);
+            }
+        }
+    }
 }
 
 void STDMETHODCALLTYPE D3D12GraphicsCommandList::OMSetFrontAndBackStencilRef(UINT FrontStencilRef, UINT BackStencilRef)
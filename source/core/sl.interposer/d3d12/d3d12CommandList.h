@@ -35,6 +35,16 @@ namespace interposer
 
 constexpr int kMaxHeapCount = 4;
 constexpr int kMaxComputeRoot32BitConstCount = 64;
+// Root signatures are limited to 64 DWORDs so there can never be more parameters than that
+constexpr int kMaxRootParameterCount = 64;
+
+// {694B3E1C-0E33-416F-BA83-FE248DA1E85D}
+// Private data holding the last D3D12_RESOURCE_STATES the host transitioned a resource to, only present
+// on resources SL opted in to tracking since querying it on every engine barrier is not free
+constexpr GUID kResourceStateGUID = { 0x694b3e1c, 0xe33, 0x416f, { 0xba, 0x83, 0xfe, 0x24, 0x8d, 0xa1, 0xe8, 0x5d } };
+// Stored under kResourceStateGUID when the host did something the whole resource state cannot describe
+// (per subresource or split transitions, enhanced barriers), consumers fall back to the state passed with the tag
+constexpr D3D12_RESOURCE_STATES kResourceStateUnknown = (D3D12_RESOURCE_STATES)0xffffffff;
 
 struct DECLSPEC_UUID("5B2662FB-EB28-4AEC-819E-1C1B4DE060F6") D3D12GraphicsCommandList : ID3D12GraphicsCommandList8
 {
@@ -156,7 +166,16 @@ struct DECLSPEC_UUID("5B2662FB-EB28-4AEC-819E-1C1B4DE060F6") D3D12GraphicsComman
 
     bool checkAndUpgradeInterface(REFIID riid);
 
+    //! Engines often create and destroy transient lists every frame, recycle proxy storage instead of hitting the heap
+    static void* operator new(size_t size);
+    static void operator delete(void* p);
+
     bool m_trackState = true;
+    //! Lazy mode, tracking starts from the next Reset once SL has evaluated on this command list
+    bool m_lazyTracking = false;
+    bool m_evaluated = false;
+    //! Record host transitions on resources carrying kResourceStateGUID
+    bool m_trackBarriers = false;
     std::atomic<LONG> m_refCount = 1;
     unsigned int m_interfaceVersion{};
     D3D12Device* const m_device{};
@@ -164,6 +183,7 @@ struct DECLSPEC_UUID("5B2662FB-EB28-4AEC-819E-1C1B4DE060F6") D3D12GraphicsComman
     // Used to restore states
     struct Constants
     {
+        // Range of 32-bit values set since the root signature changed
         uint32_t DestOffsetIn32BitValues = 0;
         uint32_t Num32BitValuesToSet = 0;
         uint32_t SrcData[kMaxComputeRoot32BitConstCount] = {};
@@ -173,11 +193,30 @@ struct DECLSPEC_UUID("5B2662FB-EB28-4AEC-819E-1C1B4DE060F6") D3D12GraphicsComman
     ID3D12PipelineState* m_pso{};
     ID3D12StateObject* m_so{};
     ID3D12DescriptorHeap* m_heaps[kMaxHeapCount]{};
-    std::map<uint32_t, D3D12_GPU_DESCRIPTOR_HANDLE> m_mapHandles{};
-    std::map<uint32_t, D3D12_GPU_VIRTUAL_ADDRESS> m_mapCBV{};
-    std::map<uint32_t, D3D12_GPU_VIRTUAL_ADDRESS> m_mapSRV{};
-    std::map<uint32_t, D3D12_GPU_VIRTUAL_ADDRESS> m_mapUAV{};
-    std::map<uint32_t, Constants> m_mapConstants{};
+    // Root parameters indexed by RootParameterIndex, bit N in a mask is set when parameter N holds tracked state
+    uint64_t m_validHandles{};
+    uint64_t m_validCBV{};
+    uint64_t m_validSRV{};
+    uint64_t m_validUAV{};
+    uint64_t m_validConstants{};
+    D3D12_GPU_DESCRIPTOR_HANDLE m_handles[kMaxRootParameterCount]{};
+    D3D12_GPU_VIRTUAL_ADDRESS m_cbv[kMaxRootParameterCount]{};
+    D3D12_GPU_VIRTUAL_ADDRESS m_srv[kMaxRootParameterCount]{};
+    D3D12_GPU_VIRTUAL_ADDRESS m_uav[kMaxRootParameterCount]{};
+    Constants m_constants[kMaxRootParameterCount]{};
+
+    inline void resetRootParameters()
+    {
+        m_validHandles = m_validCBV = m_validSRV = m_validUAV = m_validConstants = 0;
+    }
+    void trackRootConstants(UINT RootParameterIndex, UINT Num32BitValuesToSet, const void* pSrcData, UINT DestOffsetIn32BitValues);
+
+    //! Called when SL restores state after an evaluate, returns false if nothing was tracked for this recording
+    inline bool onEvaluate()
+    {
+        m_evaluated = true;
+        return m_trackState;
+    }
 };
 
 }
@@ -21,10 +21,12 @@
 */ 
 
 #include <wrl/client.h>
+#include <algorithm>
 
 #include "source/core/sl.interposer/d3d12/d3d12Device.h"
 #include "source/core/sl.interposer/d3d12/d3d12CommandList.h"
 #include "source/core/sl.interposer/d3d12/d3d12CommandQueue.h"
+#include "source/core/sl.interposer/interfaceLookup.h"
 #include "source/core/sl.log/log.h"
 #include "source/core/sl.api/internal.h"
 #include "source/core/sl.plugin-manager/pluginManager.h"
@@ -48,37 +50,32 @@ D3D12CommandQueue::D3D12CommandQueue(D3D12Device* device, ID3D12CommandQueue* or
 
 bool D3D12CommandQueue::checkAndUpgradeInterface(REFIID riid)
 {
-    if (riid == __uuidof(this) || riid == __uuidof(IUnknown) ||
-        riid == __uuidof(ID3D12Object) || riid == __uuidof(ID3D12DeviceChild) || riid == __uuidof(ID3D12Pageable))
+    static const InterfaceLookup s_lookup(
+        { __uuidof(D3D12CommandQueue), __uuidof(IUnknown), __uuidof(ID3D12Object), __uuidof(ID3D12DeviceChild), __uuidof(ID3D12Pageable) },
+        {
+            __uuidof(ID3D12CommandQueue)
+        });
+
+    auto version = s_lookup.find(riid);
+    if (version == InterfaceLookup::kUnknown)
     {
-        return true;
+        return false;
     }
 
-    std::vector<IID> iidLookup = {
-      __uuidof(ID3D12CommandQueue),
-    };
-
-    for (uint32_t version = 0; version < (uint32_t)iidLookup.size(); ++version)
+    // Upgraded base interface is kept in 'm_base', repeated queries for the same version only compare
+    if (version > (int32_t)m_interfaceVersion)
     {
-        if (riid != iidLookup[version])
-        {
-            continue;
-        }
-
-        if (version > m_interfaceVersion)
+        IUnknown* new_interface = nullptr;
+        if (FAILED(m_base->QueryInterface(riid, reinterpret_cast<void**>(&new_interface))))
         {
-            IUnknown* new_interface = nullptr;
-            if (FAILED(m_base->QueryInterface(riid, reinterpret_cast<void**>(&new_interface))))
-                return false;
-            m_base->Release();
-            m_base = static_cast<ID3D12CommandQueue*>(new_interface);
-            m_interfaceVersion = version;
+            return false;
         }
-
-        return true;
+        m_base->Release();
+        m_base = static_cast<ID3D12CommandQueue*>(new_interface);
+        m_interfaceVersion = (uint32_t)version;
     }
 
-    return false;
+    return true;
 }
 
 HRESULT STDMETHODCALLTYPE D3D12CommandQueue::QueryInterface(REFIID riid, void** ppvObj)
@@ -117,6 +114,11 @@ ULONG   STDMETHODCALLTYPE D3D12CommandQueue::Release()
     auto refOrig = m_base->Release();
     auto ref = --m_refCount;
     if (ref > 0) return ref;
+    // Lists injected after the host's last submission are never executed
+    for (auto cmdList : m_injected)
+    {
+        cmdList->Release();
+    }
     // Base and our interface don't start with identical reference counts so no point in comparing them
     delete this;
     return 0;
@@ -162,7 +164,30 @@ void    STDMETHODCALLTYPE D3D12CommandQueue::ExecuteCommandLists(UINT NumCommand
 #ifndef SL_PRODUCTION
     updateTrackedResources();
 #endif
-    std::vector<ID3D12CommandList*> cmdLists(NumCommandLists);
+    // Typical batches are small, avoid heap traffic on every submission
+    constexpr UINT kMaxInlineCommandLists = 32;
+    ID3D12CommandList* inlineLists[kMaxInlineCommandLists];
+    std::vector<ID3D12CommandList*> heapLists;
+
+    std::vector<ID3D12CommandList*> injected;
+    if (m_hasInjected.load(std::memory_order_acquire))
+    {
+        std::scoped_lock lock(m_mutexInjected);
+        injected.swap(m_injected);
+        m_hasInjected.store(false, std::memory_order_relaxed);
+    }
+
+    const UINT injectedCount = (UINT)injected.size();
+    const UINT totalCount = injectedCount + NumCommandLists;
+    ID3D12CommandList** allLists = inlineLists;
+    if (totalCount > kMaxInlineCommandLists)
+    {
+        heapLists.resize(totalCount);
+        allLists = heapLists.data();
+    }
+    std::copy(injected.begin(), injected.end(), allLists);
+    ID3D12CommandList** cmdLists = allLists + injectedCount;
+
     for (UINT i = 0; i < NumCommandLists; i++)
     {
         assert(ppCommandLists[i] != nullptr);
@@ -180,7 +205,13 @@ void    STDMETHODCALLTYPE D3D12CommandQueue::ExecuteCommandLists(UINT NumCommand
         }
     }
 
-    m_base->ExecuteCommandLists(NumCommandLists, cmdLists.data());
+    m_base->ExecuteCommandLists(totalCount, allLists);
+
+    // Our reference only covers the time until submission, the caller keeps its list alive until the GPU is done
+    for (auto cmdList : injected)
+    {
+        cmdList->Release();
+    }
 }
 void    STDMETHODCALLTYPE D3D12CommandQueue::SetMarker(UINT Metadata, const void* pData, UINT Size)
 {
@@ -24,6 +24,8 @@
 
 #include <d3d12.h>
 #include <atomic>
+#include <mutex>
+#include <vector>
 
 struct D3D12Device;
 struct D3D12CommandQueueDownlevel;
@@ -72,6 +74,30 @@ struct DECLSPEC_UUID("22C3768E-AB10-4870-B03B-2B52E21B1063") D3D12CommandQueue :
 
     bool checkAndUpgradeInterface(REFIID riid);
 
+    //! Closed SL command list which rides along with the host's next ExecuteCommandLists instead of
+    //! costing a separate submission. Injected lists run ahead of the host lists in that batch so they
+    //! must not depend on anything the host records afterwards.
+    //!
+    //! Opt-in, the queue holds a reference until the list is submitted or the queue is destroyed, the caller
+    //! still keeps its list alive until the GPU is done with it.
+    //! Returns false if the list type does not match the queue, the caller has to submit it then.
+    inline bool injectBeforeNextExecute(ID3D12CommandList* cmdList)
+    {
+        if (!cmdList || cmdList->GetType() != m_base->GetDesc().Type)
+        {
+            return false;
+        }
+        cmdList->AddRef();
+        std::scoped_lock lock(m_mutexInjected);
+        m_injected.push_back(cmdList);
+        m_hasInjected.store(true, std::memory_order_release);
+        return true;
+    }
+
+    std::mutex m_mutexInjected;
+    std::vector<ID3D12CommandList*> m_injected;
+    std::atomic<bool> m_hasInjected = false;
+
     std::atomic<LONG> m_refCount = 1;
     unsigned int m_interfaceVersion{};
     D3D12Device* const m_device{};
@@ -28,6 +28,7 @@
 
 #include "source/core/sl.api/internal.h"
 #include "source/core/sl.interposer/hook.h"
+#include "source/core/sl.interposer/interfaceLookup.h"
 #include "source/core/sl.param/parameters.h"
 #include "source/core/sl.log/log.h"
 #include "source/core/sl.plugin-manager/pluginManager.h"
@@ -287,6 +288,44 @@ void trackResource(ID3D12Resource* resource)
 #define SL_TRACK_RESOURCE
 #endif
 
+//! Evaluated inline for every resource the engine creates so keep it cheap
+static bool matchesResourceHookFilter(const sl::plugin_manager::ResourceHookFilter& filter, const D3D12_RESOURCE_DESC& desc)
+{
+    if (filter.dimensions && !(filter.dimensions & (1u << desc.Dimension))) return false;
+    if (filter.anyFlags && !(filter.anyFlags & desc.Flags)) return false;
+    return desc.Width >= filter.minWidth && desc.Height >= filter.minHeight;
+}
+
+//! Plain pass-through unless some plugin hooks this ID, variants report to the hook of their base method.
+//! D3D12_RESOURCE_DESC1 only appends to D3D12_RESOURCE_DESC so hooks always get the latter.
+#define SL_RESOURCE_HOOKS(ID, DESC, PFUN, ...)                                                                     \
+if (SUCCEEDED(hr) && ppvResource && *ppvResource)                                                               \
+{                                                                                                               \
+    const auto& hooks = sl::plugin_manager::getInterface()->getResourceHooks(FunctionHookID::ID);               \
+    for (auto& hook : hooks)                                                                                    \
+    {                                                                                                           \
+        if (matchesResourceHookFilter(hook.filter, *(const D3D12_RESOURCE_DESC*)(DESC)))                        \
+        {                                                                                                       \
+            ((PFUN*)hook.address)(__VA_ARGS__);                                                                 \
+        }                                                                                                       \
+    }                                                                                                           \
+}
+
+//! Command list proxy only carries state tracking for restorePipeline, which is never
+//! called when the host opts out of tracking or does its own hooking, unless a plugin hooks the list itself
+static bool isCommandListProxyNeeded()
+{
+    if (sl::plugin_manager::getInterface()->isProxyNeeded("ID3D12GraphicsCommandList")) return true;
+    auto flags = sl::plugin_manager::getInterface()->getPreferences().flags;
+    return !(flags & (PreferenceFlags::eDisableCLStateTracking | PreferenceFlags::eUseManualHooking));
+}
+
+//! Queue proxy is required to unwrap proxied command lists in ExecuteCommandLists
+static bool isCommandQueueProxyNeeded()
+{
+    return isCommandListProxyNeeded() || sl::plugin_manager::getInterface()->isProxyNeeded("ID3D12CommandQueue");
+}
+
 D3D12Device::D3D12Device(ID3D12Device* original) :
     m_base(original),
     m_interfaceVersion(0)
@@ -304,50 +343,43 @@ D3D12Device::D3D12Device(ID3D12Device* original) :
 
 bool D3D12Device::checkAndUpgradeInterface(REFIID riid)
 {
-    if (riid == __uuidof(this) || riid == __uuidof(IUnknown) || riid == __uuidof(ID3D12Object))
+    static const InterfaceLookup s_lookup(
+        { __uuidof(D3D12Device), __uuidof(IUnknown), __uuidof(ID3D12Object) },
+        {
+            __uuidof(ID3D12Device),
+            __uuidof(ID3D12Device1),
+            __uuidof(ID3D12Device2),
+            __uuidof(ID3D12Device3),
+            __uuidof(ID3D12Device4),
+            __uuidof(ID3D12Device5),
+            __uuidof(ID3D12Device6),
+            __uuidof(ID3D12Device7),
+            __uuidof(ID3D12Device8),
+            __uuidof(ID3D12Device9),
+            __uuidof(ID3D12Device10)
+        });
+
+    auto version = s_lookup.find(riid);
+    if (version == InterfaceLookup::kUnknown)
     {
-        return true;
+        return false;
     }
 
-    std::vector<IID> iidLookup = 
-    {
-        __uuidof(ID3D12Device),
-        __uuidof(ID3D12Device1),
-        __uuidof(ID3D12Device2),
-        __uuidof(ID3D12Device3),
-        __uuidof(ID3D12Device4),
-        __uuidof(ID3D12Device5),
-        __uuidof(ID3D12Device6),
-        __uuidof(ID3D12Device7),
-        __uuidof(ID3D12Device8),
-        __uuidof(ID3D12Device9),
-        __uuidof(ID3D12Device10),
-    };
-
-    for (uint32_t version = 0; version < (uint32_t)iidLookup.size(); ++version)
+    // Upgraded base interface is kept in 'm_base', repeated queries for the same version only compare
+    if (version > (int32_t)m_interfaceVersion)
     {
-        if (riid != iidLookup[version])
+        IUnknown* new_interface = nullptr;
+        if (FAILED(m_base->QueryInterface(riid, reinterpret_cast<void**>(&new_interface))))
         {
-            continue;
-        }
-
-        if (version > m_interfaceVersion)
-        {
-            IUnknown* new_interface = nullptr;
-            if (FAILED(m_base->QueryInterface(riid, reinterpret_cast<void**>(&new_interface))))
-            {
-                return false;
-            }
-            SL_LOG_VERBOSE("Upgraded ID3D12Device v%u to v%u", m_interfaceVersion, version);
-            m_base->Release();
-            m_base = static_cast<ID3D12Device*>(new_interface);
-            m_interfaceVersion = version;
+            return false;
         }
-
-        return true;
+        SL_LOG_VERBOSE("Upgraded ID3D12Device v%u to v%u", m_interfaceVersion, version);
+        m_base->Release();
+        m_base = static_cast<ID3D12Device*>(new_interface);
+        m_interfaceVersion = (uint32_t)version;
     }
 
-    return false;
+    return true;
 }
 
 HRESULT STDMETHODCALLTYPE D3D12Device::QueryInterface(REFIID riid, void** ppvObj)
@@ -440,6 +472,12 @@ HRESULT STDMETHODCALLTYPE D3D12Device::CreateCommandQueue(const D3D12_COMMAND_QU
         for (auto [hook, feature] : hooks) ((PFunCreateCommandQueueAfter*)hook)(pDesc, riid, ppCommandQueue);
     }
 
+    if (!isCommandQueueProxyNeeded())
+    {
+        SL_LOG_VERBOSE_ONCE("No plugin hooks ID3D12CommandQueue, not using D3D12CommandQueue proxy for optimal performance");
+        return hr;
+    }
+
     auto cmdQueueProxy = new D3D12CommandQueue(this, static_cast<ID3D12CommandQueue*>(*ppCommandQueue));
 
     if (cmdQueueProxy->checkAndUpgradeInterface(riid))
@@ -474,9 +512,9 @@ HRESULT STDMETHODCALLTYPE D3D12Device::CreateCommandList(UINT nodeMask, D3D12_CO
         return hr;
     }
 
-    if ((sl::plugin_manager::getInterface()->getPreferences().flags & PreferenceFlags::eDisableCLStateTracking) && !sl::plugin_manager::getInterface()->isProxyNeeded("ID3D12GraphicsCommandList"))
+    if (!isCommandListProxyNeeded())
     {
-        SL_LOG_VERBOSE_ONCE("Command list state tracking disabled, not using D3D12GraphicsCommandList proxy for optimal performance");
+        SL_LOG_VERBOSE_ONCE("Command list state tracking not required, not using D3D12GraphicsCommandList proxy for optimal performance");
     }
     else
     {
@@ -557,6 +595,7 @@ HRESULT STDMETHODCALLTYPE D3D12Device::CreateCommittedResource(const D3D12_HEAP_
 {
     auto hr = m_base->CreateCommittedResource(pHeapProperties, HeapFlags, pResourceDesc, InitialResourceState, pOptimizedClearValue, riidResource, ppvResource);
     SL_TRACK_RESOURCE;
+    SL_RESOURCE_HOOKS(eID3D12Device_CreateCommittedResource, pResourceDesc, PFunCreateCommittedResourceAfter, pHeapProperties, HeapFlags, pResourceDesc, InitialResourceState, pOptimizedClearValue, riidResource, ppvResource);
     return hr;
 }
 HRESULT STDMETHODCALLTYPE D3D12Device::CreateHeap(const D3D12_HEAP_DESC* pDesc, REFIID riid, void** ppvHeap)
@@ -567,12 +606,14 @@ HRESULT STDMETHODCALLTYPE D3D12Device::CreatePlacedResource(ID3D12Heap* pHeap, U
 {
     auto hr = m_base->CreatePlacedResource(pHeap, HeapOffset, pDesc, InitialState, pOptimizedClearValue, riid, ppvResource);
     SL_TRACK_RESOURCE;
+    SL_RESOURCE_HOOKS(eID3D12Device_CreatePlacedResource, pDesc, PFunCreatePlacedResourceAfter, pHeap, HeapOffset, pDesc, InitialState, pOptimizedClearValue, riid, ppvResource);
     return hr;
 }
 HRESULT STDMETHODCALLTYPE D3D12Device::CreateReservedResource(const D3D12_RESOURCE_DESC* pDesc, D3D12_RESOURCE_STATES InitialState, const D3D12_CLEAR_VALUE* pOptimizedClearValue, REFIID riid, void** ppvResource)
 {
     auto hr = m_base->CreateReservedResource(pDesc, InitialState, pOptimizedClearValue, riid, ppvResource);
     SL_TRACK_RESOURCE;
+    SL_RESOURCE_HOOKS(eID3D12Device_CreateReservedResource, pDesc, PFunCreateReservedResourceAfter, pDesc, InitialState, pOptimizedClearValue, riid, ppvResource);
     return hr;
 }
 HRESULT STDMETHODCALLTYPE D3D12Device::CreateSharedHandle(ID3D12DeviceChild* pObject, const SECURITY_ATTRIBUTES* pAttributes, DWORD Access, LPCWSTR Name, HANDLE* pHandle)
@@ -668,9 +709,9 @@ HRESULT STDMETHODCALLTYPE D3D12Device::CreateCommandList1(UINT NodeMask, D3D12_C
         return hr;
     }
 
-    if ((sl::plugin_manager::getInterface()->getPreferences().flags & PreferenceFlags::eDisableCLStateTracking) && !sl::plugin_manager::getInterface()->isProxyNeeded("ID3D12GraphicsCommandList"))
+    if (!isCommandListProxyNeeded())
     {
-        SL_LOG_VERBOSE_ONCE("Command list state tracking disabled, not using D3D12GraphicsCommandList proxy for optimal performance");
+        SL_LOG_VERBOSE_ONCE("Command list state tracking not required, not using D3D12GraphicsCommandList proxy for optimal performance");
     }
     else
     {
@@ -697,6 +738,7 @@ HRESULT STDMETHODCALLTYPE D3D12Device::CreateCommittedResource1(const D3D12_HEAP
 {
     auto hr = static_cast<ID3D12Device4*>(m_base)->CreateCommittedResource1(pHeapProperties, HeapFlags, pDesc, InitialResourceState, pOptimizedClearValue, pProtectedSession, riidResource, ppvResource);
     SL_TRACK_RESOURCE;
+    SL_RESOURCE_HOOKS(eID3D12Device_CreateCommittedResource, pDesc, PFunCreateCommittedResourceAfter, pHeapProperties, HeapFlags, pDesc, InitialResourceState, pOptimizedClearValue, riidResource, ppvResource);
     return hr;
 }
 
@@ -708,6 +750,7 @@ HRESULT STDMETHODCALLTYPE D3D12Device::CreateReservedResource1(const D3D12_RESOU
 {
     auto hr = static_cast<ID3D12Device4*>(m_base)->CreateReservedResource1(pDesc, InitialState, pOptimizedClearValue, pProtectedSession, riid, ppvResource);
     SL_TRACK_RESOURCE;
+    SL_RESOURCE_HOOKS(eID3D12Device_CreateReservedResource, pDesc, PFunCreateReservedResourceAfter, pDesc, InitialState, pOptimizedClearValue, riid, ppvResource);
     return hr;
 }
 D3D12_RESOURCE_ALLOCATION_INFO STDMETHODCALLTYPE D3D12Device::GetResourceAllocationInfo1(UINT VisibleMask, UINT NumResourceDescs, const D3D12_RESOURCE_DESC* pResourceDescs, D3D12_RESOURCE_ALLOCATION_INFO1* pResourceAllocationInfo1)
@@ -771,12 +814,15 @@ HRESULT STDMETHODCALLTYPE D3D12Device::CreateCommittedResource2(const D3D12_HEAP
 {
     auto hr = static_cast<ID3D12Device8*>(m_base)->CreateCommittedResource2(pHeapProperties, HeapFlags, pDesc, InitialResourceState, pOptimizedClearValue, pProtectedSession, riidResource, ppvResource);
     SL_TRACK_RESOURCE;
+    SL_RESOURCE_HOOKS(eID3D12Device_CreateCommittedResource, pDesc, PFunCreateCommittedResourceAfter, pHeapProperties, HeapFlags, (const D3D12_RESOURCE_DESC*)pDesc, InitialResourceState, pOptimizedClearValue, riidResource, ppvResource);
     return hr;
 }
 
 HRESULT STDMETHODCALLTYPE D3D12Device::CreatePlacedResource1(ID3D12Heap* pHeap, UINT64 HeapOffset, const D3D12_RESOURCE_DESC1* pDesc, D3D12_RESOURCE_STATES InitialState, const D3D12_CLEAR_VALUE* pOptimizedClearValue, REFIID riid, void** ppvResource)
 {
     auto hr = static_cast<ID3D12Device8*>(m_base)->CreatePlacedResource1(pHeap, HeapOffset, pDesc, InitialState, pOptimizedClearValue, riid, ppvResource);
+    SL_TRACK_RESOURCE;
+    SL_RESOURCE_HOOKS(eID3D12Device_CreatePlacedResource, pDesc, PFunCreatePlacedResourceAfter, pHeap, HeapOffset, (const D3D12_RESOURCE_DESC*)pDesc, InitialState, pOptimizedClearValue, riid, ppvResource);
     return hr;
 }
 void    STDMETHODCALLTYPE D3D12Device::CreateSamplerFeedbackUnorderedAccessView(ID3D12Resource* pTargetedResource, ID3D12Resource* pFeedbackResource, D3D12_CPU_DESCRIPTOR_HANDLE DestDescriptor)
@@ -799,7 +845,7 @@ HRESULT STDMETHODCALLTYPE D3D12Device::ShaderCacheControl(D3D12_SHADER_CACHE_KIN
 HRESULT STDMETHODCALLTYPE D3D12Device::CreateCommandQueue1(const D3D12_COMMAND_QUEUE_DESC* pDesc, REFIID CreatorID, REFIID riid, void** ppCommandQueue)
 {
     const HRESULT hr = static_cast<ID3D12Device9*>(m_base)->CreateCommandQueue1(pDesc, CreatorID, riid, ppCommandQueue);
-    if (SUCCEEDED(hr))
+    if (SUCCEEDED(hr) && isCommandQueueProxyNeeded())
     {
         const auto cmdQueueProxy = new D3D12CommandQueue(this, static_cast<ID3D12CommandQueue*>(*ppCommandQueue));
 
@@ -820,6 +866,8 @@ HRESULT STDMETHODCALLTYPE D3D12Device::CreateCommittedResource3(const D3D12_HEAP
 {
     auto hr = static_cast<ID3D12Device10*>(m_base)->CreateCommittedResource3(pHeapProperties, HeapFlags, pDesc, InitialLayout, pOptimizedClearValue, pProtectedSession, NumCastableFormats, pCastableFormats, riidResource, ppvResource);
     SL_TRACK_RESOURCE;
+    // Enhanced barrier layouts have no matching resource state, hooks see these resources as common
+    SL_RESOURCE_HOOKS(eID3D12Device_CreateCommittedResource, pDesc, PFunCreateCommittedResourceAfter, pHeapProperties, HeapFlags, (const D3D12_RESOURCE_DESC*)pDesc, D3D12_RESOURCE_STATE_COMMON, pOptimizedClearValue, riidResource, ppvResource);
     return hr;
 }
 
@@ -827,6 +875,7 @@ HRESULT STDMETHODCALLTYPE D3D12Device::CreatePlacedResource2(ID3D12Heap* pHeap,
 {
     auto hr = static_cast<ID3D12Device10*>(m_base)->CreatePlacedResource2(pHeap, HeapOffset, pDesc, InitialLayout, pOptimizedClearValue, NumCastableFormats, pCastableFormats, riid, ppvResource);
     SL_TRACK_RESOURCE;
+    SL_RESOURCE_HOOKS(eID3D12Device_CreatePlacedResource, pDesc, PFunCreatePlacedResourceAfter, pHeap, HeapOffset, (const D3D12_RESOURCE_DESC*)pDesc, D3D12_RESOURCE_STATE_COMMON, pOptimizedClearValue, riid, ppvResource);
     return hr;
 }
 
@@ -834,6 +883,7 @@ HRESULT STDMETHODCALLTYPE D3D12Device::CreateReservedResource2(const D3D12_RESOU
 {
     auto hr = static_cast<ID3D12Device10*>(m_base)->CreateReservedResource2(pDesc, InitialLayout, pOptimizedClearValue, pProtectedSession, NumCastableFormats, pCastableFormats, riid, ppvResource);
     SL_TRACK_RESOURCE;
+    SL_RESOURCE_HOOKS(eID3D12Device_CreateReservedResource, pDesc, PFunCreateReservedResourceAfter, pDesc, D3D12_RESOURCE_STATE_COMMON, pOptimizedClearValue, riid, ppvResource);
     return hr;
 }
 
@@ -27,6 +27,7 @@
 #include "source/core/sl.interposer/dxgi/DXGISwapchain.h"
 #include "source/core/sl.interposer/d3d12/d3d12Device.h"
 #include "source/core/sl.interposer/d3d12/d3d12CommandQueue.h"
+#include "source/core/sl.interposer/interfaceLookup.h"
 #include "source/core/sl.api/internal.h"
 #include "source/core/sl.log/log.h"
 #include "source/core/sl.plugin-manager/pluginManager.h"
@@ -141,43 +142,40 @@ DXGIFactory::DXGIFactory(IDXGIFactory* original) :
 
 bool DXGIFactory::checkAndUpgradeInterface(REFIID riid)
 {
-    if (riid == __uuidof(this) || riid == __uuidof(IUnknown) || riid == __uuidof(IDXGIObject) || riid == __uuidof(IDXGIDeviceSubObject))
+    static const InterfaceLookup s_lookup(
+        { __uuidof(DXGIFactory), __uuidof(IUnknown), __uuidof(IDXGIObject), __uuidof(IDXGIDeviceSubObject) },
+        {
+            __uuidof(IDXGIFactory),
+            __uuidof(IDXGIFactory1),
+            __uuidof(IDXGIFactory2),
+            __uuidof(IDXGIFactory3),
+            __uuidof(IDXGIFactory4),
+            __uuidof(IDXGIFactory5),
+            __uuidof(IDXGIFactory6),
+            __uuidof(IDXGIFactory7)
+        });
+
+    auto version = s_lookup.find(riid);
+    if (version == InterfaceLookup::kUnknown)
     {
-        return true;
+        return false;
     }
 
-    static const IID iidLookup[] = {
-        __uuidof(IDXGIFactory),
-        __uuidof(IDXGIFactory1),
-        __uuidof(IDXGIFactory2),
-        __uuidof(IDXGIFactory3),
-        __uuidof(IDXGIFactory4),
-        __uuidof(IDXGIFactory5),
-        __uuidof(IDXGIFactory6),
-        __uuidof(IDXGIFactory7),
-    };
-
-    for (unsigned int version = 0; version < ARRAYSIZE(iidLookup); ++version)
+    // Upgraded base interface is kept in 'm_base', repeated queries for the same version only compare
+    if (version > (int32_t)m_interfaceVersion)
     {
-        if (riid != iidLookup[version])
-            continue;
-
-        if (version > m_interfaceVersion)
+        IUnknown* newInterface = nullptr;
+        if (FAILED(m_base->QueryInterface(riid, reinterpret_cast<void**>(&newInterface))))
         {
-            IUnknown* newInterface = nullptr;
-            if (FAILED(m_base->QueryInterface(riid, reinterpret_cast<void**>(&newInterface))))
-            {
-                return false;
-            }
-            SL_LOG_VERBOSE("Upgraded IDXGIFactory v%u to v%u", m_interfaceVersion, version);
-            m_base->Release();
-            m_base = static_cast<IDXGIFactory*>(newInterface);
-            m_interfaceVersion = version;
+            return false;
         }
-        return true;
+        SL_LOG_VERBOSE("Upgraded IDXGIFactory v%u to v%u", m_interfaceVersion, version);
+        m_base->Release();
+        m_base = static_cast<IDXGIFactory*>(newInterface);
+        m_interfaceVersion = (uint32_t)version;
     }
 
-    return false;
+    return true;
 }
 
 HRESULT STDMETHODCALLTYPE DXGIFactory::QueryInterface(REFIID riid, void** ppvObj)
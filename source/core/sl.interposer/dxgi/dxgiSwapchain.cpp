@@ -23,6 +23,9 @@
 #include <wrl/client.h>
 #include <d3d11.h>
 #include <mutex>
+#include <map>
+#include <optional>
+#include <tuple>
 
 #include "include/sl_hooks.h"
 #include "source/core/sl.interposer/dxgi/dxgiSwapchain.h"
@@ -32,6 +35,11 @@
 #include "source/core/sl.log/log.h"
 #include "source/core/sl.plugin-manager/pluginManager.h"
 #include "source/core/sl.exception/exception.h"
+#include "source/core/sl.extra/extra.h"
+#include "source/core/sl.extra/perfStats.h"
+#include "include/sl_helpers.h"
+#include "source/core/sl.interposer/hook.h"
+#include "source/core/sl.interposer/interfaceLookup.h"
 
 namespace sl
 {
@@ -67,40 +75,37 @@ DXGISwapChain::DXGISwapChain(ID3D12Device* device, IDXGISwapChain* original) :
 
 bool DXGISwapChain::checkAndUpgradeInterface(REFIID riid)
 {
-    if (riid == __uuidof(this) || riid == __uuidof(IUnknown) || riid == __uuidof(IDXGIObject) || riid == __uuidof(IDXGIDeviceSubObject))
+    static const InterfaceLookup s_lookup(
+        { __uuidof(DXGISwapChain), __uuidof(IUnknown), __uuidof(IDXGIObject), __uuidof(IDXGIDeviceSubObject) },
+        {
+            __uuidof(IDXGISwapChain),
+            __uuidof(IDXGISwapChain1),
+            __uuidof(IDXGISwapChain2),
+            __uuidof(IDXGISwapChain3),
+            __uuidof(IDXGISwapChain4)
+        });
+
+    auto version = s_lookup.find(riid);
+    if (version == InterfaceLookup::kUnknown)
     {
-        return true;
+        return false;
     }
 
-    static const IID iidLookup[] = {
-        __uuidof(IDXGISwapChain),
-        __uuidof(IDXGISwapChain1),
-        __uuidof(IDXGISwapChain2),
-        __uuidof(IDXGISwapChain3),
-        __uuidof(IDXGISwapChain4),
-    };
-
-    for (unsigned int version = 0; version < ARRAYSIZE(iidLookup); ++version)
+    // Upgraded base interface is kept in 'm_base', repeated queries for the same version only compare
+    if (version > (int32_t)m_interfaceVersion)
     {
-        if (riid != iidLookup[version])
-            continue;
-
-        if (version > m_interfaceVersion)
+        IUnknown* newInterface = nullptr;
+        if (FAILED(m_base->QueryInterface(riid, reinterpret_cast<void**>(&newInterface))))
         {
-            IUnknown* newInterface = nullptr;
-            if (FAILED(m_base->QueryInterface(riid, reinterpret_cast<void**>(&newInterface))))
-            {
-                return false;
-            }
-            SL_LOG_VERBOSE("Upgraded IDXGISwapChain v%u to v%u", m_interfaceVersion, version);
-            m_base->Release();
-            m_base = static_cast<IDXGISwapChain*>(newInterface);
-            m_interfaceVersion = version;
+            return false;
         }
-        return true;
+        SL_LOG_VERBOSE("Upgraded IDXGISwapChain v%u to v%u", m_interfaceVersion, version);
+        m_base->Release();
+        m_base = static_cast<IDXGISwapChain*>(newInterface);
+        m_interfaceVersion = (uint32_t)version;
     }
 
-    return false;
+    return true;
 }
 
 HRESULT STDMETHODCALLTYPE DXGISwapChain::QueryInterface(REFIID riid, void** ppvObj)
@@ -172,6 +177,83 @@ private:
 };
 static SwapChainTracker g_swapChainTracker;
 
+#ifndef SL_PRODUCTION
+// Per plugin CPU cost of the hooks around Present, enabled via 'tracePresentHooks' in sl.interposer.json
+struct PresentHookTrace
+{
+    static constexpr uint32_t kReportInterval = 1000;
+
+    PresentHookTrace()
+    {
+        m_enabled = sl::interposer::getInterface()->getConfig().tracePresentHooks;
+        if (m_enabled)
+        {
+            SL_LOG_INFO("Present hook tracing enabled, reporting every %u presents", kReportInterval);
+        }
+    }
+
+    inline bool isEnabled() const { return m_enabled; }
+
+    //! Meters are not thread safe and swap-chains can present from different threads, samples are only ever added under the lock
+    void addSample(FunctionHookID id, bool after, Feature feature, double ms)
+    {
+        std::lock_guard lock(m_mutex);
+        m_meters[{ (uint32_t)id, after, feature }].add(ms);
+    }
+
+    void notifyPresentDone()
+    {
+        std::lock_guard lock(m_mutex);
+        if (++m_presentCount % kReportInterval != 0) return;
+        for (auto& [key, meter] : m_meters)
+        {
+            auto& [id, after, feature] = key;
+            SL_LOG_INFO("Present hook %s:%s:%s - p50 %.3fms p99 %.3fms (%llu samples)", getFeatureAsStr(feature), id == (uint32_t)FunctionHookID::eIDXGISwapChain_Present1 ? "Present1" : "Present",
+                after ? "after" : "before", meter.getMedian(), meter.getPercentile(99.0), meter.getNumSamples());
+        }
+    }
+
+private:
+    bool m_enabled = false;
+    std::mutex m_mutex;
+    uint64_t m_presentCount = 0;
+    std::map<std::tuple<uint32_t, bool, Feature>, extra::AverageValueMeter> m_meters;
+};
+static PresentHookTrace& getPresentHookTrace()
+{
+    // Constructed on first present so interposer config is already parsed
+    static PresentHookTrace s_trace;
+    return s_trace;
+}
+//! Time is measured locally, shared meter state is never touched outside of 'PresentHookTrace::m_mutex'
+struct ScopedPresentHookTimer
+{
+    ScopedPresentHookTimer(FunctionHookID id, bool after, Feature feature) : m_id(id), m_after(after), m_feature(feature)
+    {
+        QueryPerformanceCounter(&m_start);
+    }
+    ~ScopedPresentHookTimer()
+    {
+        LARGE_INTEGER end{}, frequency{};
+        QueryPerformanceCounter(&end);
+        QueryPerformanceFrequency(&frequency);
+        getPresentHookTrace().addSample(m_id, m_after, m_feature, (end.QuadPart - m_start.QuadPart) * 1000.0 / frequency.QuadPart);
+    }
+
+    FunctionHookID m_id;
+    bool m_after;
+    Feature m_feature;
+    LARGE_INTEGER m_start{};
+};
+#define SL_TRACE_PRESENT_HOOK(id, after, feature) \
+    std::optional<ScopedPresentHookTimer> traceTimer; \
+    if (getPresentHookTrace().isEnabled()) traceTimer.emplace(id, after, feature);
+#define SL_TRACE_PRESENT_DONE() if (getPresentHookTrace().isEnabled()) getPresentHookTrace().notifyPresentDone();
+#else
+#define SL_TRACE_PRESENT_HOOK(id, after, feature)
+#define SL_TRACE_PRESENT_DONE()
+#endif
+
 ULONG   STDMETHODCALLTYPE DXGISwapChain::Release()
 {
     if(m_refCount == 1)
@@ -244,11 +326,16 @@ HRESULT STDMETHODCALLTYPE DXGISwapChain::Present(UINT SyncInterval, UINT Flags)
     auto present = [this](UINT SyncInterval, UINT Flags)->HRESULT
     {
         auto hooksId = FunctionHookID::eIDXGISwapChain_Present;
+        SL_TRACE_ZONE("IDXGISwapChain::Present");
+        auto perfStats = sl::plugin_manager::getInterface()->getPerfStats();
         const auto& hooks = sl::plugin_manager::getInterface()->getBeforeHooks(hooksId);
         bool skip = false;
         HRESULT hr = S_OK;
         for (auto [hook, feature] : hooks)
         {
+            SL_TRACE_PRESENT_HOOK(hooksId, false, feature);
+            extra::ScopedPerfTimer perfTimer(perfStats, extra::PerfCounter::eHookNs, extra::PerfCounter::eHookCalls);
+            SL_TRACE_ZONE(getFeatureAsStr(feature));
             hr = ((PFunPresentBefore*)hook)(m_base, SyncInterval, Flags, skip);
             if (FAILED(hr))
             {
@@ -264,6 +351,9 @@ HRESULT STDMETHODCALLTYPE DXGISwapChain::Present(UINT SyncInterval, UINT Flags)
             const auto& hooksAfter = sl::plugin_manager::getInterface()->getAfterHooks(hooksId);
             for (auto [hook, feature] : hooksAfter)
             {
+                SL_TRACE_PRESENT_HOOK(hooksId, true, feature);
+                extra::ScopedPerfTimer perfTimer(perfStats, extra::PerfCounter::eHookNs, extra::PerfCounter::eHookCalls);
+                SL_TRACE_ZONE(getFeatureAsStr(feature));
                 hr = ((PFunPresentAfter*)hook)(Flags);
                 if (FAILED(hr))
                 {
@@ -273,6 +363,9 @@ HRESULT STDMETHODCALLTYPE DXGISwapChain::Present(UINT SyncInterval, UINT Flags)
             }
         }
 
+        // Counters from every thread up to the end of this present belong to the frame just presented
+        perfStats->fold();
+        SL_TRACE_PRESENT_DONE();
         return hr;
     };
     SL_EXCEPTION_HANDLE_START
@@ -481,11 +574,16 @@ HRESULT STDMETHODCALLTYPE DXGISwapChain::Present1(UINT SyncInterval, UINT Presen
     auto present = [this](UINT SyncInterval, UINT PresentFlags, const DXGI_PRESENT_PARAMETERS* pPresentParameters)->HRESULT
     {
         auto hooksId = FunctionHookID::eIDXGISwapChain_Present1;
+        SL_TRACE_ZONE("IDXGISwapChain::Present1");
+        auto perfStats = sl::plugin_manager::getInterface()->getPerfStats();
         const auto& hooks = sl::plugin_manager::getInterface()->getBeforeHooks(hooksId);
         bool skip = false;
         HRESULT hr = S_OK;
         for (auto [hook, feature] : hooks)
         {
+            SL_TRACE_PRESENT_HOOK(hooksId, false, feature);
+            extra::ScopedPerfTimer perfTimer(perfStats, extra::PerfCounter::eHookNs, extra::PerfCounter::eHookCalls);
+            SL_TRACE_ZONE(getFeatureAsStr(feature));
             hr = ((PFunPresent1Before*)hook)(m_base, SyncInterval, PresentFlags, pPresentParameters, skip);
             if (FAILED(hr))
             {
@@ -504,6 +602,9 @@ HRESULT STDMETHODCALLTYPE DXGISwapChain::Present1(UINT SyncInterval, UINT Presen
             const auto& hooksAfter = sl::plugin_manager::getInterface()->getAfterHooks(hooksId);
             for (auto [hook, feature] : hooksAfter)
             {
+                SL_TRACE_PRESENT_HOOK(hooksId, true, feature);
+                extra::ScopedPerfTimer perfTimer(perfStats, extra::PerfCounter::eHookNs, extra::PerfCounter::eHookCalls);
+                SL_TRACE_ZONE(getFeatureAsStr(feature));
                 hr = ((PFunPresentAfter*)hook)(PresentFlags);
                 if (FAILED(hr))
                 {
@@ -513,6 +614,8 @@ HRESULT STDMETHODCALLTYPE DXGISwapChain::Present1(UINT SyncInterval, UINT Presen
             }
         }
 
+        perfStats->fold();
+        SL_TRACE_PRESENT_DONE();
         return hr;
     };
     SL_EXCEPTION_HANDLE_START
@@ -60,7 +60,7 @@ if (config.contains(#a))
             {
                 // NOTE: Logging does not work here, not initialized yet since values from this JSON can change the way logging works
                 m_configPath = path;
-                auto jsonText = file::read(interposerJSONFile.c_str());
+                auto jsonText = file::map(interposerJSONFile.c_str());
                 if (!jsonText.empty())
                 {
                     json config = json::parse(jsonText.begin(), jsonText.end(), nullptr, /* allow exceptions: */ true, /* ignore comments: */ true);
@@ -71,6 +71,8 @@ if (config.contains(#a))
                     SL_EXTRACT_CONFIG_FLAG(showConsole);
                     SL_EXTRACT_CONFIG_FLAG(vkValidation);
                     SL_EXTRACT_CONFIG_FLAG(logPath);
+                    SL_EXTRACT_CONFIG_FLAG(binaryLogPath);
+                    SL_EXTRACT_CONFIG_FLAG(binaryLogSizeMB);
                     SL_EXTRACT_CONFIG_FLAG(pathToPlugins);
                     SL_EXTRACT_CONFIG_FLAG(logLevel);
                     SL_EXTRACT_CONFIG_FLAG(logMessageDelayMs);
@@ -79,6 +81,19 @@ if (config.contains(#a))
                     SL_EXTRACT_CONFIG_FLAG(forceNonNVDA);
                     SL_EXTRACT_CONFIG_FLAG(trackEngineAllocations);
                     SL_EXTRACT_CONFIG_FLAG(enableD3D12DebugLayer);
+                    SL_EXTRACT_CONFIG_FLAG(d3d12DescriptorCount);
+                    SL_EXTRACT_CONFIG_FLAG(asyncCompute);
+                    SL_EXTRACT_CONFIG_FLAG(vkDescriptorBuffer);
+                    SL_EXTRACT_CONFIG_FLAG(d3d11LightweightState);
+                    SL_EXTRACT_CONFIG_FLAG(d3d12LazyStateTracking);
+                    SL_EXTRACT_CONFIG_FLAG(tracePresentHooks);
+                    SL_EXTRACT_CONFIG_FLAG(d3d12TrackBarrierStates);
+                    SL_EXTRACT_CONFIG_FLAG(vkSubmitCoalescing);
+                    SL_EXTRACT_CONFIG_FLAG(vkImageTracking);
+                    SL_EXTRACT_CONFIG_FLAG(startupProfiler);
+                    SL_EXTRACT_CONFIG_FLAG(gpuMarkers);
+                    SL_EXTRACT_CONFIG_FLAG(hitchThresholdUs);
+                    SL_EXTRACT_CONFIG_FLAG(vectoredExceptionHandler);
 
                     if (m_config.trackEngineAllocations)
                     {
@@ -170,10 +185,10 @@ if (config.contains(#a))
         // calls to hook a class instance which we must ignore to avoid circular references.
         if (!f.target)
         {
-            std::scoped_lock<std::mutex> lock(m_mutex);
             void** virtualTable = *reinterpret_cast<VirtualAddress**>(instance);
             auto address = &virtualTable[virtualTableOffset];
-            if (virtualTable[virtualTableOffset] != f.replacement)
+            std::scoped_lock<std::mutex> lock(getPatchMutex(address));
+            if (!f.target && virtualTable[virtualTableOffset] != f.replacement)
             {
                 f.target = virtualTable[virtualTableOffset];
                 DWORD prevProtection{};
@@ -205,7 +220,7 @@ if (config.contains(#a))
 
     bool restoreOriginalCode(ExportedFunction& f) override final
     {
-        std::scoped_lock<std::mutex> lock(m_mutex);
+        std::scoped_lock<std::mutex> lock(getPatchMutex(f.target));
         DWORD prevProtection{};
         if (!VirtualProtect(f.target, kCodePatchSize, PAGE_READWRITE, &prevProtection))
         {
@@ -223,7 +238,7 @@ if (config.contains(#a))
 
     bool restoreCurrentCode(const ExportedFunction& f) override final
     {
-        std::scoped_lock<std::mutex> lock(m_mutex);
+        std::scoped_lock<std::mutex> lock(getPatchMutex(f.target));
         DWORD prevProtection{};
         if (!VirtualProtect(f.target, kCodePatchSize, PAGE_READWRITE, &prevProtection))
         {
@@ -238,12 +253,23 @@ if (config.contains(#a))
         return true;
     }
 
+    //! Patching different v-tables or functions does not need to serialize, only
+    //! writes to the same address do, so locks are striped by the patched address.
+    //! Devices and swap-chains created in parallel then rarely contend.
+    std::mutex& getPatchMutex(const void* address)
+    {
+        // Drop the low bits, v-table slots next to each other share the same lock
+        auto index = (reinterpret_cast<uintptr_t>(address) >> 6) % kPatchMutexCount;
+        return m_patchMutex[index];
+    }
+
 #endif
 
     std::wstring m_configPath{};
     InterposerConfig m_config{};
     bool m_enabled = true;
-    std::mutex m_mutex;
+    static constexpr size_t kPatchMutexCount = 16;
+    std::mutex m_patchMutex[kPatchMutexCount];
     inline static Hook* s_hook = {};
 };
 
@@ -83,6 +83,21 @@ struct InterposerConfig
     float logMessageDelayMs = 5000.0f;
     uint32_t logLevel = 2;
     std::string logPath{};
+    std::string binaryLogPath{};
+    uint32_t binaryLogSizeMB = 16;
+    uint32_t d3d12DescriptorCount = 0; // 0 means default size
+    bool asyncCompute = false;
+    bool vkDescriptorBuffer = false;
+    bool d3d11LightweightState = false;
+    bool d3d12LazyStateTracking = false;
+    bool tracePresentHooks = false;
+    bool d3d12TrackBarrierStates = false;
+    bool vkSubmitCoalescing = false;
+    bool vkImageTracking = false;
+    bool startupProfiler = false;
+    bool gpuMarkers = false;
+    uint32_t hitchThresholdUs = 0; // 0 means default threshold
+    bool vectoredExceptionHandler = false; // One process wide handler instead of '__try' in per frame entry points
     std::string pathToPlugins{};
     std::vector<Feature> loadSpecificFeatures{};
 };
@@ -0,0 +1,101 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+#include <unknwn.h>
+#include <assert.h>
+#include <initializer_list>
+#include <stdint.h>
+
+namespace sl
+{
+namespace interposer
+{
+
+//! IID to interface version of a proxy, built once per proxy class on first 'QueryInterface'
+//!
+//! Hosts and middleware query the same few IIDs every frame, instead of comparing against every known
+//! interface this is one hashed probe and a single IID compare. Open addressing, never more than half full.
+class InterfaceLookup
+{
+public:
+    //! Answered by the proxy itself, the base interface does not need an upgrade
+    static constexpr int32_t kSelf = -1;
+    //! Not implemented by the proxy, forwarded to the base interface
+    static constexpr int32_t kUnknown = -2;
+
+    //! 'versioned' is in ascending order, the index matches the proxy's 'm_interfaceVersion'
+    InterfaceLookup(std::initializer_list<IID> self, std::initializer_list<IID> versioned)
+    {
+        for (auto& iid : self)
+        {
+            insert(iid, kSelf);
+        }
+        int32_t version = 0;
+        for (auto& iid : versioned)
+        {
+            insert(iid, version++);
+        }
+    }
+
+    int32_t find(REFIID riid) const
+    {
+        for (uint32_t i = hash(riid);; i = (i + 1) & (kSlotCount - 1))
+        {
+            auto& slot = m_slots[i];
+            if (slot.version == kUnknown || slot.iid == riid)
+            {
+                return slot.version;
+            }
+        }
+    }
+
+private:
+    static constexpr uint32_t kSlotCount = 32;
+
+    //! IIDs are random so the first dword is as good as hashing the whole thing
+    static uint32_t hash(REFIID riid) { return (riid.Data1 ^ (riid.Data1 >> 16)) & (kSlotCount - 1); }
+
+    void insert(REFIID iid, int32_t version)
+    {
+        assert(m_count < kSlotCount / 2);
+        auto i = hash(iid);
+        while (m_slots[i].version != kUnknown)
+        {
+            i = (i + 1) & (kSlotCount - 1);
+        }
+        m_slots[i] = { iid, version };
+        m_count++;
+    }
+
+    struct Slot
+    {
+        IID iid{};
+        int32_t version = kUnknown;
+    };
+    Slot m_slots[kSlotCount]{};
+    uint32_t m_count = 0;
+};
+
+}
+}
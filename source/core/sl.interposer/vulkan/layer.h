@@ -23,6 +23,9 @@
 #pragma once
 
 #include <mutex>
+#include <atomic>
+#include <map>
+#include <vector>
 
 #include "external/vulkan/include/vulkan/vulkan.h"
 #include "external/vulkan/include/vulkan/vk_layer.h"
@@ -66,8 +69,35 @@ struct VkTable
     uint32_t opticalFlowQueueCreateFlags = 0;
 
     bool nativeOpticalFlowHWSupport = false;
+    bool descriptorBuffer = false; // VK_EXT_descriptor_buffer enabled by SL for its own kernels
+    bool synchronization2 = false; // VK_KHR_synchronization2 feature enabled on the device, by SL or by the host
+    bool lowLatency2 = false; // VK_NV_low_latency2 enabled by SL, swapchains get latency mode enabled on creation
+    std::atomic<VkSwapchainKHR> latencySwapchain{}; // Most recent swapchain created with latency mode, target of all VK_NV_low_latency2 calls
     std::vector<QueueVkInfo> hostGraphicsComputeQueueInfo{};
 
+    //! SL work merged into the host's next vkQueueSubmit/vkQueueSubmit2 on the same queue instead of a separate submission,
+    //! only honored when 'vkSubmitCoalescing' is set. Injected work runs ahead of the host's batch so it can only
+    //! depend on what was already submitted. Semaphore value is ignored for binary semaphores.
+    struct InjectedSubmit
+    {
+        VkCommandBuffer cmdBuffer{};
+        VkSemaphore signalSemaphore{};
+        uint64_t signalValue{};
+    };
+    bool submitCoalescing = false;
+    std::mutex mutexInjected;
+    std::atomic<uint32_t> injectedCount = 0;
+    std::map<VkQueue, std::vector<InjectedSubmit>> injectedSubmits;
+
+    inline bool injectBeforeNextSubmit(VkQueue queue, const InjectedSubmit& submit)
+    {
+        if (!submitCoalescing) return false;
+        std::scoped_lock lock(mutexInjected);
+        injectedSubmits[queue].push_back(submit);
+        injectedCount++;
+        return true;
+    }
+
     std::mutex mutex;
     std::map<void*, VkLayerInstanceDispatchTable> dispatchInstanceMap;
     std::map<void*, VkLayerDispatchTable> dispatchDeviceMap;
@@ -377,6 +407,16 @@ inline void VkTable::mapVulkanDeviceAPI(VkDevice device)
     dt.CmdPushDescriptorSetKHR = (PFN_vkCmdPushDescriptorSetKHR)getDeviceProcAddr(device, "vkCmdPushDescriptorSetKHR");
 #endif /* defined(VK_KHR_push_descriptor) */
 
+#if defined(VK_KHR_external_memory_win32)
+    SL_GDPR(GetMemoryWin32HandleKHR);
+    SL_GDPR(GetMemoryWin32HandlePropertiesKHR);
+#endif /* defined(VK_KHR_external_memory_win32) */
+
+#if defined(VK_KHR_external_semaphore_win32)
+    SL_GDPR(ImportSemaphoreWin32HandleKHR);
+    SL_GDPR(GetSemaphoreWin32HandleKHR);
+#endif /* defined(VK_KHR_external_semaphore_win32) */
+
 #if defined(VK_EXT_debug_utils)
     SL_GDPR(SetDebugUtilsObjectNameEXT);
     SL_GDPR(SetDebugUtilsObjectTagEXT);
@@ -21,12 +21,18 @@
 */
 
 #include <unordered_set>
+#include <array>
+#include <algorithm>
 
 #include "include/sl.h"
 #include "source/core/sl.api/internal.h"
 #include "source/core/sl.log/log.h"
 #include "source/core/sl.param/parameters.h"
 #include "source/core/sl.plugin-manager/pluginManager.h"
+#include "source/core/sl.extra/perfStats.h"
+#include "source/core/sl.extra/trace.h"
+#include "source/core/sl.extra/imageTable.h"
+#include "include/sl_helpers.h"
 #include "source/core/sl.interposer/vulkan/layer.h"
 #include "source/core/sl.interposer/hook.h"
 #include "include/sl_hooks.h"
@@ -41,6 +47,9 @@ VkTable s_vk{};
 VkLayerInstanceDispatchTable s_idt{};
 VkLayerDispatchTable s_ddt{};
 
+//! Only with 'vkImageTracking', shared with plugins via 'param::global::kVkImageTable'
+std::unique_ptr<sl::extra::ImageTable> s_imageTable{};
+
 HMODULE loadVulkanLibrary()
 {
     if (!s_module)
@@ -93,12 +102,50 @@ sl::Result processVulkanInterface(const sl::VulkanInfo* extension)
     s_vk.mapVulkanDeviceAPI(s_vk.device);
     s_ddt = s_vk.dispatchDeviceMap[s_vk.device];
 
+    s_vk.submitCoalescing = sl::interposer::getInterface()->getConfig().vkSubmitCoalescing;
+
     // Allow all plugins to access this information
     sl::param::getInterface()->set(sl::param::global::kVulkanTable, &s_vk);
 
     return sl::Result::eOk;
 }
 
+//! Loaders and layers query thousands of names at startup, keep the hooks sorted so each query is a binary search
+struct InterceptedFunction
+{
+    const char* name;
+    PFN_vkVoidFunction function;
+};
+
+template<size_t N>
+struct InterceptTable
+{
+    std::array<InterceptedFunction, N> entries;
+
+    InterceptTable(std::array<InterceptedFunction, N> list) : entries(list)
+    {
+        std::sort(entries.begin(), entries.end(), [](const InterceptedFunction& a, const InterceptedFunction& b)->bool { return strcmp(a.name, b.name) < 0; });
+    }
+
+    PFN_vkVoidFunction find(const char* name) const
+    {
+        auto it = std::lower_bound(entries.begin(), entries.end(), name, [](const InterceptedFunction& a, const char* b)->bool { return strcmp(a.name, b) < 0; });
+        return it != entries.end() && strcmp((*it).name, name) == 0 ? (*it).function : nullptr;
+    }
+};
+
+//! Atomic check keeps the host's submit path a plain forward when nothing is pending
+static bool takeInjectedSubmits(VkQueue queue, std::vector<VkTable::InjectedSubmit>& injected)
+{
+    if (s_vk.injectedCount.load(std::memory_order_acquire) == 0) return false;
+    std::scoped_lock lock(s_vk.mutexInjected);
+    auto it = s_vk.injectedSubmits.find(queue);
+    if (it == s_vk.injectedSubmits.end() || it->second.empty()) return false;
+    injected.swap(it->second);
+    s_vk.injectedCount -= (uint32_t)injected.size();
+    return true;
+}
+
 extern "C"
 {
     // -- Vulkan 1.0 ---
@@ -819,6 +866,93 @@ extern "C"
             SL_LOG_INFO("Device extension '%s' requested by a plugin(s) added.", ext.c_str());
         }
 
+#if defined(VK_EXT_descriptor_buffer)
+        // SL cannot restore host descriptor buffer bindings after its own dispatches so only opt in when the host is not using them
+        VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptorBufferFeatures{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT };
+        s_vk.descriptorBuffer = false;
+        if (sl::interposer::getInterface()->getConfig().vkDescriptorBuffer)
+        {
+            bool hostEnabled = false;
+            for (uint32_t i = 0; i < pCreateInfo->enabledExtensionCount; i++)
+            {
+                hostEnabled |= strcmp(pCreateInfo->ppEnabledExtensionNames[i], VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) == 0;
+            }
+            bool available = false;
+            for (const auto& ext : availableDeviceExtensions)
+            {
+                available |= strcmp(ext.extensionName, VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) == 0;
+            }
+            VkPhysicalDeviceDescriptorBufferFeaturesEXT supportedDescriptorBufferFeatures{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT };
+            VkPhysicalDeviceFeatures2 features{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, &supportedDescriptorBufferFeatures };
+            if (available && !hostEnabled)
+            {
+                vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+            }
+            // Descriptors reference buffers by address so the feature has to be enabled on the device being created, being supported is not enough
+            bool bufferDeviceAddress = false;
+            for (auto chain = (const VkBaseInStructure*)createInfo.pNext; chain; chain = chain->pNext)
+            {
+                if (chain->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES)
+                {
+                    bufferDeviceAddress |= ((const VkPhysicalDeviceVulkan12Features*)chain)->bufferDeviceAddress == VK_TRUE;
+                }
+                else if (chain->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES)
+                {
+                    bufferDeviceAddress |= ((const VkPhysicalDeviceBufferDeviceAddressFeatures*)chain)->bufferDeviceAddress == VK_TRUE;
+                }
+            }
+            if (hostEnabled)
+            {
+                SL_LOG_WARN("Host enabled '%s', SL kernels keep using descriptor sets", VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+            }
+            else if (!bufferDeviceAddress)
+            {
+                SL_LOG_WARN("'bufferDeviceAddress' is not enabled on the device, SL kernels keep using descriptor sets");
+            }
+            else if (supportedDescriptorBufferFeatures.descriptorBuffer)
+            {
+                descriptorBufferFeatures.descriptorBuffer = VK_TRUE;
+                descriptorBufferFeatures.pNext = (void*)createInfo.pNext;
+                createInfo.pNext = &descriptorBufferFeatures;
+                requiredSLDeviceExtensionNames.insert(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+                s_vk.descriptorBuffer = true;
+                SL_LOG_INFO("Device extension '%s' added for SL kernels", VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+            }
+        }
+#endif
+
+#if defined(VK_NV_low_latency2)
+        // Native low latency replaces NvLowLatencyVk in chi, only opt in when a plugin asked for low latency and the driver exposes it
+        s_vk.lowLatency2 = false;
+        s_vk.latencySwapchain = {};
+        if (requiredSLDeviceExtensionNames.find("VK_NV_low_latency") != requiredSLDeviceExtensionNames.end())
+        {
+            for (const auto& ext : availableDeviceExtensions)
+            {
+                s_vk.lowLatency2 |= strcmp(ext.extensionName, VK_NV_LOW_LATENCY_2_EXTENSION_NAME) == 0;
+            }
+            if (s_vk.lowLatency2)
+            {
+                requiredSLDeviceExtensionNames.insert(VK_NV_LOW_LATENCY_2_EXTENSION_NAME);
+                SL_LOG_INFO("Device extension '%s' added for low latency", VK_NV_LOW_LATENCY_2_EXTENSION_NAME);
+            }
+        }
+#endif
+
+        // chi records precise vkCmdPipelineBarrier2 barriers only if the feature ended up enabled, no matter who asked for it
+        s_vk.synchronization2 = false;
+        for (auto chain = (const VkBaseInStructure*)createInfo.pNext; chain != nullptr; chain = chain->pNext)
+        {
+            if (chain->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES)
+            {
+                s_vk.synchronization2 |= ((const VkPhysicalDeviceVulkan13Features*)chain)->synchronization2 == VK_TRUE;
+            }
+            else if (chain->sType == VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES)
+            {
+                s_vk.synchronization2 |= ((const VkPhysicalDeviceSynchronization2Features*)chain)->synchronization2 == VK_TRUE;
+            }
+        }
+
         std::vector<const char*> extensions;
         extensions.reserve(requiredSLDeviceExtensionNames.size());
         for (auto& e : requiredSLDeviceExtensionNames)
@@ -947,11 +1081,19 @@ extern "C"
 
         s_vk.device = *pDevice;
         s_vk.mapVulkanDeviceAPI(*pDevice);
+        s_vk.submitCoalescing = sl::interposer::getInterface()->getConfig().vkSubmitCoalescing;
 
         sl::param::getInterface()->set(sl::param::global::kVulkanTable, &s_vk);
 
         s_ddt = s_vk.dispatchDeviceMap[s_vk.device];
 
+        if (sl::interposer::getInterface()->getConfig().vkImageTracking && !s_imageTable)
+        {
+            s_imageTable = std::make_unique<sl::extra::ImageTable>();
+            sl::param::getInterface()->set(sl::param::global::kVkImageTable, s_imageTable.get());
+            SL_LOG_INFO("Vulkan image tracking enabled, tags can omit image dimensions and format");
+        }
+
         pluginManager->setVulkanDevice(physicalDevice, *pDevice, s_vk.instance);
         pluginManager->initializePlugins();
 
@@ -1041,7 +1183,38 @@ extern "C"
 
     VkResult VKAPI_CALL vkQueueSubmit(VkQueue Queue, uint32_t SubmitCount, const VkSubmitInfo* Submits, VkFence Fence)
     {
-        return s_ddt.QueueSubmit(Queue, SubmitCount, Submits, Fence);
+        std::vector<VkTable::InjectedSubmit> injected;
+        if (!takeInjectedSubmits(Queue, injected))
+        {
+            return s_ddt.QueueSubmit(Queue, SubmitCount, Submits, Fence);
+        }
+
+        std::vector<VkCommandBuffer> cmdBuffers;
+        std::vector<VkSemaphore> semaphores;
+        std::vector<uint64_t> values;
+        for (auto& submit : injected)
+        {
+            if (submit.cmdBuffer) cmdBuffers.push_back(submit.cmdBuffer);
+            if (submit.signalSemaphore)
+            {
+                semaphores.push_back(submit.signalSemaphore);
+                values.push_back(submit.signalValue);
+            }
+        }
+        VkTimelineSemaphoreSubmitInfo timelineInfo{ VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO };
+        timelineInfo.signalSemaphoreValueCount = (uint32_t)values.size();
+        timelineInfo.pSignalSemaphoreValues = values.data();
+
+        std::vector<VkSubmitInfo> submits(SubmitCount + 1);
+        auto& slSubmit = submits[0];
+        slSubmit = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+        slSubmit.pNext = &timelineInfo;
+        slSubmit.commandBufferCount = (uint32_t)cmdBuffers.size();
+        slSubmit.pCommandBuffers = cmdBuffers.data();
+        slSubmit.signalSemaphoreCount = (uint32_t)semaphores.size();
+        slSubmit.pSignalSemaphores = semaphores.data();
+        std::copy(Submits, Submits + SubmitCount, submits.begin() + 1);
+        return s_ddt.QueueSubmit(Queue, (uint32_t)submits.size(), submits.data(), Fence);
     }
     VkResult VKAPI_CALL vkQueueWaitIdle(VkQueue Queue)
     {
@@ -1237,13 +1410,51 @@ extern "C"
         s_ddt.DestroyBufferView(Device, BufferView, Allocator);
     }
 
+    //! Only handed out when image tracking is on or a plugin hooks image creation, see 'isInterceptSkipped'
     VkResult VKAPI_CALL vkCreateImage(VkDevice Device, const VkImageCreateInfo* CreateInfo, const VkAllocationCallbacks* Allocator, VkImage* Image)
     {
-        return s_ddt.CreateImage(Device, CreateInfo, Allocator, Image);
+        auto result = s_ddt.CreateImage(Device, CreateInfo, Allocator, Image);
+        if (result != VK_SUCCESS || !CreateInfo || !Image)
+        {
+            return result;
+        }
+
+        if (s_imageTable)
+        {
+            // Recorded only, nothing is looked at until the image is actually tagged
+            sl::extra::ImageInfo info{ CreateInfo->extent.width, CreateInfo->extent.height, CreateInfo->extent.depth, CreateInfo->mipLevels,
+                CreateInfo->arrayLayers, (uint32_t)CreateInfo->format, CreateInfo->usage, CreateInfo->flags };
+            if (!s_imageTable->insert((uint64_t)*Image, info))
+            {
+                SL_LOG_WARN_ONCE("Vulkan image table is full, some images must be tagged with their dimensions and format");
+            }
+        }
+
+        const auto& hooks = sl::plugin_manager::getInterface()->getResourceHooks(sl::FunctionHookID::eVulkan_CreateImage);
+        for (auto& hook : hooks)
+        {
+            // Same filter as D3D12, image type maps onto the texture dimensions and usage onto the resource flags
+            auto& filter = hook.filter;
+            if (filter.dimensions && !(filter.dimensions & (1u << (CreateInfo->imageType + 2)))) continue;
+            if (filter.anyFlags)
+            {
+                uint32_t flags = (CreateInfo->usage & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT ? 0x1 : 0) |
+                    (CreateInfo->usage & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT ? 0x2 : 0) |
+                    (CreateInfo->usage & VK_IMAGE_USAGE_STORAGE_BIT ? 0x4 : 0);
+                if (!(filter.anyFlags & flags)) continue;
+            }
+            if (CreateInfo->extent.width < filter.minWidth || CreateInfo->extent.height < filter.minHeight) continue;
+            ((sl::PFunVkCreateImageAfter*)hook.address)(Device, CreateInfo, Allocator, Image);
+        }
+        return result;
     }
 
     void VKAPI_CALL vkDestroyImage(VkDevice Device, VkImage Image, const VkAllocationCallbacks* Allocator)
     {
+        if (s_imageTable && Image)
+        {
+            s_imageTable->erase((uint64_t)Image);
+        }
         s_ddt.DestroyImage(Device, Image, Allocator);
     }
 
@@ -1945,7 +2156,41 @@ extern "C"
 
     VkResult VKAPI_CALL vkQueueSubmit2(VkQueue queue, uint32_t submitCount, const VkSubmitInfo2* pSubmits, VkFence fence)
     {
-        return s_ddt.QueueSubmit2(queue, submitCount, pSubmits, fence);
+        std::vector<VkTable::InjectedSubmit> injected;
+        if (!takeInjectedSubmits(queue, injected))
+        {
+            return s_ddt.QueueSubmit2(queue, submitCount, pSubmits, fence);
+        }
+
+        std::vector<VkCommandBufferSubmitInfo> cmdBuffers;
+        std::vector<VkSemaphoreSubmitInfo> semaphores;
+        for (auto& submit : injected)
+        {
+            if (submit.cmdBuffer)
+            {
+                VkCommandBufferSubmitInfo info{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO };
+                info.commandBuffer = submit.cmdBuffer;
+                cmdBuffers.push_back(info);
+            }
+            if (submit.signalSemaphore)
+            {
+                VkSemaphoreSubmitInfo info{ VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO };
+                info.semaphore = submit.signalSemaphore;
+                info.value = submit.signalValue;
+                info.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+                semaphores.push_back(info);
+            }
+        }
+
+        std::vector<VkSubmitInfo2> submits(submitCount + 1);
+        auto& slSubmit = submits[0];
+        slSubmit = { VK_STRUCTURE_TYPE_SUBMIT_INFO_2 };
+        slSubmit.commandBufferInfoCount = (uint32_t)cmdBuffers.size();
+        slSubmit.pCommandBufferInfos = cmdBuffers.data();
+        slSubmit.signalSemaphoreInfoCount = (uint32_t)semaphores.size();
+        slSubmit.pSignalSemaphoreInfos = semaphores.data();
+        std::copy(pSubmits, pSubmits + submitCount, submits.begin() + 1);
+        return s_ddt.QueueSubmit2(queue, (uint32_t)submits.size(), submits.data(), fence);
     }
 
     void VKAPI_CALL vkCmdCopyBuffer2(VkCommandBuffer commandBuffer, const VkCopyBufferInfo2* pCopyBufferInfo)
@@ -2098,7 +2343,34 @@ extern "C"
 
         if (!skip)
         {
+#if defined(VK_NV_low_latency2)
+            // VK_NV_low_latency2 only works on swapchains created with latency mode, chain it unless the host already did
+            VkSwapchainLatencyCreateInfoNV latencyInfo{ VK_STRUCTURE_TYPE_SWAPCHAIN_LATENCY_CREATE_INFO_NV };
+            VkSwapchainCreateInfoKHR createInfo = *CreateInfo;
+            bool latencyMode = s_vk.lowLatency2;
+            bool hostChained = false;
+            for (auto chain = (const VkBaseInStructure*)CreateInfo->pNext; latencyMode && chain != nullptr; chain = chain->pNext)
+            {
+                if (chain->sType == VK_STRUCTURE_TYPE_SWAPCHAIN_LATENCY_CREATE_INFO_NV)
+                {
+                    latencyMode = ((const VkSwapchainLatencyCreateInfoNV*)chain)->latencyModeEnable == VK_TRUE;
+                    hostChained = true;
+                }
+            }
+            if (latencyMode && !hostChained)
+            {
+                latencyInfo.pNext = createInfo.pNext;
+                latencyInfo.latencyModeEnable = VK_TRUE;
+                createInfo.pNext = &latencyInfo;
+            }
+            result = s_ddt.CreateSwapchainKHR(Device, &createInfo, Allocator, Swapchain);
+            if (result == VK_SUCCESS && latencyMode)
+            {
+                s_vk.latencySwapchain = *Swapchain;
+            }
+#else
             result = s_ddt.CreateSwapchainKHR(Device, CreateInfo, Allocator, Swapchain);
+#endif
         }
 
         {
@@ -2128,6 +2400,9 @@ extern "C"
 
         if (!skip)
         {
+            // Stop chi from issuing latency calls on a swapchain that is about to go away
+            VkSwapchainKHR latencySwapchain = Swapchain;
+            s_vk.latencySwapchain.compare_exchange_strong(latencySwapchain, VkSwapchainKHR{});
             s_ddt.DestroySwapchainKHR(Device, Swapchain, Allocator);
         }
     }
@@ -2184,10 +2459,14 @@ extern "C"
         bool skip = false;
         VkResult result = VK_SUCCESS;
         auto hooksId = sl::FunctionHookID::eVulkan_Present;
+        SL_TRACE_ZONE("vkQueuePresentKHR");
+        auto perfStats = sl::plugin_manager::getInterface()->getPerfStats();
         {
             const auto& hooks = sl::plugin_manager::getInterface()->getBeforeHooks(hooksId);
             for (auto [hook, feature] : hooks)
             {
+                sl::extra::ScopedPerfTimer perfTimer(perfStats, sl::extra::PerfCounter::eHookNs, sl::extra::PerfCounter::eHookCalls);
+                SL_TRACE_ZONE(sl::getFeatureAsStr(feature));
                 result = ((sl::PFunVkQueuePresentKHRBefore*)hook)(Queue, PresentInfo, skip);
                 // report error on first fail
                 if (result != VK_SUCCESS)
@@ -2206,6 +2485,8 @@ extern "C"
             const auto& hooks = sl::plugin_manager::getInterface()->getAfterHooks(hooksId);
             for (auto [hook, feature] : hooks)
             {
+                sl::extra::ScopedPerfTimer perfTimer(perfStats, sl::extra::PerfCounter::eHookNs, sl::extra::PerfCounter::eHookCalls);
+                SL_TRACE_ZONE(sl::getFeatureAsStr(feature));
                 result = ((sl::PFunVkQueuePresentKHRAfter*)hook)();
                 // report error on first fail
                 if (result != VK_SUCCESS)
@@ -2215,6 +2496,8 @@ extern "C"
             }
         }
 
+        // Counters from every thread up to the end of this present belong to the frame just presented
+        perfStats->fold();
         return result;
     }
 
@@ -2385,11 +2668,71 @@ extern "C"
         s_ddt.GetImageMemoryRequirements2KHR(Device, Info, MemoryRequirements);
     }
 
-#define SL_INTERCEPT(F)          \
-if (strcmp(pName, #F) == 0)          \
-{                      \
-  return (PFN_vkVoidFunction)F;      \
-}
+#define SL_INTERCEPT(F) { #F, (PFN_vkVoidFunction)F }
+
+    // Redirect only the hooks we need
+    //
+    // NOTE: vkCmdBindPipeline, vkCmdBindDescriptorSets, vkBeginCommandBuffer and vkCmdPipelineBarrier are not redirected,
+    // no FunctionHookID exists for them so plugin state tracking hooks never run and the wrappers
+    // would only add a call per command. Their exports remain for apps linking against us directly.
+    static const InterceptTable<13> s_deviceIntercepts({ {
+        SL_INTERCEPT(vkGetInstanceProcAddr),
+        SL_INTERCEPT(vkGetDeviceProcAddr),
+        SL_INTERCEPT(vkQueuePresentKHR),
+        SL_INTERCEPT(vkQueueSubmit),
+        SL_INTERCEPT(vkQueueSubmit2),
+        SL_INTERCEPT(vkCreateImage),
+        SL_INTERCEPT(vkDestroyImage),
+        SL_INTERCEPT(vkCreateSwapchainKHR),
+        SL_INTERCEPT(vkGetSwapchainImagesKHR),
+        SL_INTERCEPT(vkDestroySwapchainKHR),
+        SL_INTERCEPT(vkAcquireNextImageKHR),
+        SL_INTERCEPT(vkAcquireNextImage2KHR),
+        SL_INTERCEPT(vkDeviceWaitIdle),
+    } });
+
+    static const InterceptTable<18> s_instanceIntercepts({ {
+        SL_INTERCEPT(vkGetInstanceProcAddr),
+        SL_INTERCEPT(vkGetDeviceProcAddr),
+        SL_INTERCEPT(vkCreateInstance),
+        SL_INTERCEPT(vkDestroyInstance),
+        SL_INTERCEPT(vkCreateDevice),
+        SL_INTERCEPT(vkDestroyDevice),
+        SL_INTERCEPT(vkEnumeratePhysicalDevices),
+
+        SL_INTERCEPT(vkQueuePresentKHR),
+        SL_INTERCEPT(vkQueueSubmit),
+        SL_INTERCEPT(vkQueueSubmit2),
+        SL_INTERCEPT(vkCreateImage),
+        SL_INTERCEPT(vkDestroyImage),
+        SL_INTERCEPT(vkCreateSwapchainKHR),
+        SL_INTERCEPT(vkDestroySwapchainKHR),
+        SL_INTERCEPT(vkGetSwapchainImagesKHR),
+        SL_INTERCEPT(vkAcquireNextImageKHR),
+        SL_INTERCEPT(vkAcquireNextImage2KHR),
+        SL_INTERCEPT(vkDeviceWaitIdle),
+    } });
+
+    //! Submit and image intercepts are opt-in, otherwise the host calls the driver directly
+    //!
+    //! Image creation is decided from the plugin JSON so it holds for plugins enabled after the host resolved it.
+    static bool isInterceptSkipped(PFN_vkVoidFunction function)
+    {
+        auto& config = sl::interposer::getInterface()->getConfig();
+        if (function == (PFN_vkVoidFunction)vkQueueSubmit || function == (PFN_vkVoidFunction)vkQueueSubmit2)
+        {
+            return !config.vkSubmitCoalescing;
+        }
+        if (function == (PFN_vkVoidFunction)vkCreateImage)
+        {
+            return !config.vkImageTracking && !sl::plugin_manager::getInterface()->isHookDeclared(sl::FunctionHookID::eVulkan_CreateImage);
+        }
+        if (function == (PFN_vkVoidFunction)vkDestroyImage)
+        {
+            return !config.vkImageTracking;
+        }
+        return false;
+    }
 
     PFN_vkVoidFunction VKAPI_CALL vkGetDeviceProcAddr(VkDevice device, const char* pName)
     {
@@ -2404,21 +2747,10 @@ if (strcmp(pName, #F) == 0)          \
             s_ddt.GetDeviceProcAddr = (PFN_vkGetDeviceProcAddr)GetProcAddress(s_module, "vkGetDeviceProcAddr");
         }
 
-        // Redirect only the hooks we need
-        SL_INTERCEPT(vkGetInstanceProcAddr);
-        SL_INTERCEPT(vkGetDeviceProcAddr);
-        SL_INTERCEPT(vkQueuePresentKHR);
-        SL_INTERCEPT(vkCreateImage);
-        SL_INTERCEPT(vkCmdPipelineBarrier);
-        SL_INTERCEPT(vkCmdBindPipeline);
-        SL_INTERCEPT(vkCmdBindDescriptorSets);
-        SL_INTERCEPT(vkCreateSwapchainKHR);
-        SL_INTERCEPT(vkGetSwapchainImagesKHR);
-        SL_INTERCEPT(vkDestroySwapchainKHR);
-        SL_INTERCEPT(vkAcquireNextImageKHR);
-        SL_INTERCEPT(vkAcquireNextImage2KHR);
-        SL_INTERCEPT(vkBeginCommandBuffer);
-        SL_INTERCEPT(vkDeviceWaitIdle);
+        if (auto hook = s_deviceIntercepts.find(pName); hook && !isInterceptSkipped(hook))
+        {
+            return hook;
+        }
 
         return s_ddt.GetDeviceProcAddr(device, pName);
     }
@@ -2437,27 +2769,10 @@ if (strcmp(pName, #F) == 0)          \
             s_idt.GetInstanceProcAddr = (PFN_vkGetInstanceProcAddr)GetProcAddress(s_module, "vkGetInstanceProcAddr");
         }
         
-        // Redirect only the hooks we need
-        SL_INTERCEPT(vkGetInstanceProcAddr);
-        SL_INTERCEPT(vkGetDeviceProcAddr);
-        SL_INTERCEPT(vkCreateInstance);
-        SL_INTERCEPT(vkDestroyInstance);
-        SL_INTERCEPT(vkCreateDevice);
-        SL_INTERCEPT(vkDestroyDevice);
-        SL_INTERCEPT(vkEnumeratePhysicalDevices);
-
-        SL_INTERCEPT(vkQueuePresentKHR);
-        SL_INTERCEPT(vkCreateImage);
-        SL_INTERCEPT(vkCmdPipelineBarrier);
-        SL_INTERCEPT(vkCmdBindPipeline);
-        SL_INTERCEPT(vkCmdBindDescriptorSets);
-        SL_INTERCEPT(vkCreateSwapchainKHR);
-        SL_INTERCEPT(vkDestroySwapchainKHR);
-        SL_INTERCEPT(vkGetSwapchainImagesKHR);
-        SL_INTERCEPT(vkAcquireNextImageKHR);
-        SL_INTERCEPT(vkAcquireNextImage2KHR);
-        SL_INTERCEPT(vkBeginCommandBuffer);
-        SL_INTERCEPT(vkDeviceWaitIdle);
+        if (auto hook = s_instanceIntercepts.find(pName); hook && !isInterceptSkipped(hook))
+        {
+            return hook;
+        }
 
         return s_idt.GetInstanceProcAddr(instance, pName);
     }
@@ -0,0 +1,226 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#ifdef SL_WINDOWS
+#include <windows.h>
+#endif
+#include <cstring>
+#include <thread>
+
+#include "source/core/sl.log/binaryLog.h"
+
+namespace sl
+{
+namespace log
+{
+
+#ifdef SL_WINDOWS
+
+BinaryLogSink::~BinaryLogSink()
+{
+    close();
+}
+
+bool BinaryLogSink::open(const wchar_t* path, uint32_t sizeMB)
+{
+    close();
+
+    uint64_t recordBytes = (uint64_t)(sizeMB ? sizeMB : 1) << 20;
+    auto recordCount = (uint32_t)(recordBytes / kBinaryLogRecordSize);
+    uint64_t stringTableOffset = sizeof(BinaryLogHeader);
+    uint64_t recordsOffset = (stringTableOffset + kBinaryLogStringTableSize + 4095) & ~4095ull;
+    uint64_t totalSize = recordsOffset + (uint64_t)recordCount * kBinaryLogRecordSize;
+
+    // Allow other processes to read the log while we are running
+    auto file = CreateFileW(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    auto mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, (DWORD)(totalSize >> 32), (DWORD)totalSize, nullptr);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        return false;
+    }
+    auto view = (uint8_t*)MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, totalSize);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    // New file from CREATE_ALWAYS is zero filled so all records start as invalid
+    auto header = (BinaryLogHeader*)view;
+    LARGE_INTEGER frequency{};
+    QueryPerformanceFrequency(&frequency);
+    header->magic = kBinaryLogMagic;
+    header->version = kBinaryLogVersion;
+    header->recordSize = kBinaryLogRecordSize;
+    header->recordCount = recordCount;
+    header->qpcFrequency = frequency.QuadPart;
+    header->stringTableOffset = stringTableOffset;
+    header->stringTableSize = kBinaryLogStringTableSize;
+    header->recordsOffset = recordsOffset;
+    header->writeIndex.store(0);
+    header->stringTableUsed.store(0);
+
+    for (uint32_t i = 0; i < kInternTableSize; i++)
+    {
+        m_internKeys[i].store(0);
+        m_internValues[i].store(0);
+    }
+
+    m_file = file;
+    m_mapping = mapping;
+    m_strings = (char*)(view + stringTableOffset);
+    m_records = (BinaryLogRecord*)(view + recordsOffset);
+    m_header = header;
+    return true;
+}
+
+void BinaryLogSink::close()
+{
+    if (m_header)
+    {
+        // Hand over to the OS, no need to wait for the write back
+        FlushViewOfFile(m_header, 0);
+        UnmapViewOfFile(m_header);
+        m_header = {};
+    }
+    if (m_mapping)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = {};
+    }
+    if (m_file)
+    {
+        CloseHandle(m_file);
+        m_file = {};
+    }
+    m_strings = {};
+    m_records = {};
+}
+
+uint32_t BinaryLogSink::intern(const char* str)
+{
+    if (!str)
+    {
+        return 0;
+    }
+    // Keyed by content, literals of an unloaded plugin go away and their addresses get reused
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (auto c = str; *c; c++)
+    {
+        hash = (hash ^ (uint8_t)*c) * 0x100000001b3ull;
+    }
+    hash |= 1;
+    // Value could still be in flight on another thread, otherwise the stored string must match in case of a hash collision
+    auto lookup = [this, str](uint32_t i, uint32_t& id)->bool
+    {
+        id = m_internValues[i].load(std::memory_order_acquire);
+        return !id || !strcmp(m_strings + id - 1 + sizeof(uint32_t), str);
+    };
+    for (uint32_t probe = 0; probe < 16; probe++)
+    {
+        auto i = (uint32_t)((hash >> 52) + probe) & (kInternTableSize - 1);
+        auto key = m_internKeys[i].load(std::memory_order_acquire);
+        uint32_t id{};
+        if (key == hash)
+        {
+            if (lookup(i, id))
+            {
+                return id;
+            }
+            continue;
+        }
+        if (!key)
+        {
+            uint64_t expected = 0;
+            if (!m_internKeys[i].compare_exchange_strong(expected, hash, std::memory_order_acq_rel))
+            {
+                if (expected == hash && lookup(i, id))
+                {
+                    return id;
+                }
+                continue;
+            }
+            // We own the slot, append [length][chars] to the string table
+            auto length = (uint32_t)strlen(str);
+            auto size = sizeof(uint32_t) + length + 1;
+            auto offset = m_header->stringTableUsed.fetch_add(size);
+            if (offset + size > m_header->stringTableSize)
+            {
+                return 0;
+            }
+            memcpy(m_strings + offset, &length, sizeof(length));
+            memcpy(m_strings + offset + sizeof(length), str, length + 1);
+            // Offsets are biased by one so zero can mean "none"
+            auto id = (uint32_t)offset + 1;
+            m_internValues[i].store(id, std::memory_order_release);
+            return id;
+        }
+    }
+    return 0;
+}
+
+void BinaryLogSink::write(uint32_t level, int type, const char* file, int line, const char* func, const char* fmt, const char* message)
+{
+    if (!m_header)
+    {
+        return;
+    }
+    LARGE_INTEGER timestamp{};
+    QueryPerformanceCounter(&timestamp);
+
+    auto index = m_header->writeIndex.fetch_add(1, std::memory_order_relaxed);
+    auto& record = m_records[index % m_header->recordCount];
+    // Invalidate first so readers never see a mix of old and new record
+    record.sequence.store(0, std::memory_order_relaxed);
+    record.timestamp = timestamp.QuadPart;
+    record.threadId = GetCurrentThreadId();
+    record.level = (uint16_t)level;
+    record.type = (uint16_t)type;
+    record.line = (uint32_t)line;
+    record.fileId = intern(file);
+    record.funcId = intern(func);
+    record.fmtId = intern(fmt);
+    auto length = strnlen(message, sizeof(record.message) - 1);
+    memcpy(record.message, message, length);
+    record.message[length] = 0;
+    record.length = (uint32_t)length;
+    record.sequence.store(index + 1, std::memory_order_release);
+}
+
+#else
+
+BinaryLogSink::~BinaryLogSink() {}
+bool BinaryLogSink::open(const wchar_t* path, uint32_t sizeMB) { return false; }
+void BinaryLogSink::close() {}
+uint32_t BinaryLogSink::intern(const char* str) { return 0; }
+void BinaryLogSink::write(uint32_t level, int type, const char* file, int line, const char* func, const char* fmt, const char* message) {}
+
+#endif
+
+}
+}
@@ -0,0 +1,110 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+namespace sl
+{
+namespace log
+{
+
+//! Binary log file layout, also consumed by tools/sl_log_decode.py
+//! 
+//! [BinaryLogHeader][string table][record ring]
+//! 
+//! Records are fixed size and written to a ring with plain stores into
+//! mapped pages so the log survives crashes without any flushing.
+//! Strings (file, function, format) are interned once in the string table
+//! and records reference them by offset (zero means none).
+
+constexpr uint32_t kBinaryLogMagic = 0x4c42534c; // 'SLBL'
+constexpr uint32_t kBinaryLogVersion = 1;
+constexpr uint32_t kBinaryLogRecordSize = 256;
+constexpr uint32_t kBinaryLogStringTableSize = 1 << 20;
+
+struct BinaryLogHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t recordCount;
+    uint64_t qpcFrequency;
+    uint64_t stringTableOffset;
+    uint64_t stringTableSize;
+    uint64_t recordsOffset;
+    std::atomic<uint64_t> writeIndex;
+    std::atomic<uint64_t> stringTableUsed;
+};
+
+struct BinaryLogRecord
+{
+    //! Index + 1 of the record, written last so torn records can be detected
+    std::atomic<uint64_t> sequence;
+    uint64_t timestamp;
+    uint32_t threadId;
+    uint16_t level;
+    uint16_t type;
+    uint32_t line;
+    uint32_t fileId;
+    uint32_t funcId;
+    uint32_t fmtId;
+    uint32_t length;
+    uint32_t reserved;
+    char message[kBinaryLogRecordSize - 48];
+};
+static_assert(sizeof(BinaryLogRecord) == kBinaryLogRecordSize);
+
+class BinaryLogSink
+{
+public:
+    ~BinaryLogSink();
+
+    //! Maps (and creates if needed) ring file with a given size in MB
+    bool open(const wchar_t* path, uint32_t sizeMB);
+    void close();
+    bool isOpen() const { return m_header != nullptr; }
+
+    //! Safe to call from any thread, never blocks or allocates
+    //! 
+    //! 'fmt' is only interned if it is a literal (formatted messages).
+    void write(uint32_t level, int type, const char* file, int line, const char* func, const char* fmt, const char* message);
+
+private:
+    uint32_t intern(const char* str);
+
+    static constexpr uint32_t kInternTableSize = 4096;
+
+    void* m_file{};
+    void* m_mapping{};
+    BinaryLogHeader* m_header{};
+    char* m_strings{};
+    BinaryLogRecord* m_records{};
+    //! Content hashes, zero marks a free slot
+    std::atomic<uint64_t> m_internKeys[kInternTableSize] = {};
+    std::atomic<uint32_t> m_internValues[kInternTableSize] = {};
+};
+
+}
+}
@@ -22,10 +22,15 @@
 
 #include <iomanip>
 #include <map>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <cstring>
 
 #include "include/sl.h"
 #include "include/sl_core_types.h"
 #include "source/core/sl.log/log.h"
+#include "source/core/sl.log/binaryLog.h"
 #include "source/core/sl.extra/extra.h"
 #include "source/core/sl.param/parameters.h"
 #include "source/core/sl.thread/thread.h"
@@ -93,6 +98,38 @@ void moveWindowToAnotherMonitor(HWND hwnd, UINT flags)
     }
 }
 
+//! Messages are formatted once on the calling thread straight into a preallocated
+//! record, everything else (time stamps, headers, duplicate checks, I/O) happens on the log thread.
+//! 
+//! NOTE: Raw arguments cannot be deferred safely since '%s' arguments are
+//! often pointing to temporaries which are gone by the time log thread runs.
+struct LogRecord
+{
+    static constexpr size_t kInlineSize = 256;
+    static constexpr size_t kFileSize = 64;
+    static constexpr size_t kFuncSize = 96;
+
+    uint32_t level{};
+    ConsoleForeground color{};
+    // Copied, literals live in the calling plugin image which can be unloaded before the log thread runs
+    char file[kFileSize];
+    int line{};
+    char func[kFuncSize];
+    int type{};
+    bool isMetaDataUnique{};
+    bool formatted{};
+    std::thread::id tid{};
+    char text[kInlineSize];
+    // Only used for messages which do not fit inline
+    std::unique_ptr<char[]> overflow{};
+
+    const char* c_str() const { return overflow ? overflow.get() : text; }
+};
+
+constexpr size_t kRecordQueueSize = 512;
+//! Yields before a message is dropped when the log thread falls behind
+constexpr uint32_t kRecordPushRetries = 1024;
+
 struct Log : ILog
 {
     std::hash<std::string> m_hash;
@@ -105,10 +142,18 @@ struct Log : ILog
     FILE* m_file = {};
     PFun_LogMessageCallback* m_logMessageCallback = {};
     thread::WorkerThread* m_worker{};
+    std::unique_ptr<thread::MPSCRing<LogRecord, kRecordQueueSize>> m_records{};
+    std::unique_ptr<BinaryLogSink> m_binarySink{};
+    std::atomic<BinaryLogSink*> m_activeBinarySink{};
+    //! Reported by the log thread once the queue drains
+    std::atomic<uint32_t> m_droppedRecords = 0;
+    //! Message callback runs on the log thread, it can not wait for space in the queue it drains
+    inline static thread_local bool s_isLogThread = false;
 
     Log()
     {
-        m_worker = new thread::WorkerThread(L"sl.log", THREAD_PRIORITY_BELOW_NORMAL);
+        m_records = std::make_unique<thread::MPSCRing<LogRecord, kRecordQueueSize>>();
+        m_worker = new thread::WorkerThread(L"sl.log", THREAD_PRIORITY_BELOW_NORMAL, thread::ThreadPlacement::eEfficiency);
     }
 
     void enableConsole(bool flag) override
@@ -148,6 +193,23 @@ struct Log : ILog
 
     const wchar_t* getLogName() override { return m_name.c_str(); }
 
+    void setBinaryLogPath(const wchar_t* path, uint32_t sizeMB) override
+    {
+        // Not expected to be called while other threads are logging (slInit time)
+        m_activeBinarySink = nullptr;
+        m_binarySink.reset();
+        if (path && path[0])
+        {
+            auto sink = std::make_unique<BinaryLogSink>();
+            std::wstring fullPath = std::wstring(path) + L"\\" + (m_name.empty() ? L"sl.log" : m_name) + L".bin";
+            if (sink->open(fullPath.c_str(), sizeMB))
+            {
+                m_binarySink = std::move(sink);
+                m_activeBinarySink = m_binarySink.get();
+            }
+        }
+    }
+
     void setLogCallback(void* logMessageCallback) override
     {
         m_logMessageCallback = (PFun_LogMessageCallback*)logMessageCallback;
@@ -189,6 +251,8 @@ struct Log : ILog
             m_file = nullptr;
             m_pathInvalid = true; // prevent log file reopening
         }
+        m_activeBinarySink = nullptr;
+        m_binarySink.reset();
         m_consoleActive = false;
         // Win32 API does not require us to close this handle
         m_outHandle = {};
@@ -229,196 +293,248 @@ struct Log : ILog
             return;
         }
 
-        std::string file(_file);
-        std::string func(_func);
-        std::string fmt(_fmt);
-        std::string msg;
+        LogRecord record;
+        record.level = level;
+        record.color = color;
+        // Only the file name is ever printed, drop the path before copying
+        auto fileName = strrchr(_file, '\\');
+        strncpy_s(record.file, fileName ? fileName + 1 : _file, _TRUNCATE);
+        record.line = line;
+        strncpy_s(record.func, _func, _TRUNCATE);
+        record.type = type;
+        record.isMetaDataUnique = isMetaDataUnique;
+        record.tid = std::this_thread::get_id();
 
         // Incoming message can be un-formatted if provided by 3rd party like NGX
-        bool formatted = fmt.empty() || fmt.back() != '\n';
-        if (formatted)
+        auto fmtLength = strlen(_fmt);
+        record.formatted = fmtLength == 0 || _fmt[fmtLength - 1] != '\n';
+        if (record.formatted)
         {
-            bool errorDetected = false;
             va_list args;
 
             // Make sure va_end is called before early out!
             va_start(args, _fmt);
+            va_list argsCopy;
+            va_copy(argsCopy, args);
 
-            // Determine the required size of the formatted message (without null-terminator)
-            int msgSize = _vscprintf(_fmt, args);
-            if (msgSize >= 1)
+            // Single pass for the common case, only long messages get formatted twice
+            int msgSize = vsnprintf(record.text, LogRecord::kInlineSize, _fmt, args);
+            if (msgSize >= (int)LogRecord::kInlineSize)
             {
-                // Account for the null terminator char
-                msgSize++;
-                msg.resize(msgSize);
-
-                // Format the message
-                msgSize = vsnprintf(msg.data(), msg.size(), _fmt, args);
-
-                if (msgSize <= 0)
-                {
-                    // invalid character in the string or any other error
-                    errorDetected = true;
-                }
-                // vsnprintf adds '0' at the end of the string. if we don't remove it,
-                // the '+=' won't work correctly on that string
-                while (msg.size() && *msg.rbegin() == '\0')
-                {
-                    msg.pop_back();
-                }
-            }
-            else
-            {
-                // _fmt is bad or empty log
-                errorDetected = true;
+                record.overflow = std::make_unique<char[]>(msgSize + 1);
+                msgSize = vsnprintf(record.overflow.get(), msgSize + 1, _fmt, argsCopy);
             }
+            va_end(argsCopy);
             va_end(args);
 
-            if (errorDetected)
+            if (msgSize <= 0)
             {
-                // Something went wrong during `_vscprintf` or `vsprintf_s`
+                // _fmt is bad, empty log or invalid character in the string
                 return;
             }
         }
+        else
+        {
+            if (fmtLength < LogRecord::kInlineSize)
+            {
+                memcpy(record.text, _fmt, fmtLength + 1);
+            }
+            else
+            {
+                record.overflow = std::make_unique<char[]>(fmtLength + 1);
+                memcpy(record.overflow.get(), _fmt, fmtLength + 1);
+            }
+        }
+
+        // Binary sink is a plain memcpy into mapped pages, do it right here so it survives crashes
+        if (auto sink = m_activeBinarySink.load(std::memory_order_acquire))
+        {
+            sink->write(level, type, _file, line, _func, record.formatted ? _fmt : nullptr, record.c_str());
+        }
 
 #if ASSERT_ONLY_CODE
         if ((LogType)type == LogType::eError && IsDebuggerPresent())
         {
             // Use log message and originating file/line number for assert
+            std::string msg(record.c_str()), file(_file);
             _wassert(std::wstring(msg.begin(), msg.end()).c_str(), std::wstring(file.begin(), file.end()).c_str(), line);
         }
 #endif
 
-        // This thread ID
-        auto tid = std::this_thread::get_id();
-        auto logLambda = [this, tid, msg, level, color, file, line, func, type, fmt, formatted, isMetaDataUnique]()->void
+        // Lock-free, only waits if log thread is falling behind by more than the queue size and drops the message
+        // if that lasts, binary sink above still has it
+        auto retries = s_isLogThread ? 0 : kRecordPushRetries;
+        while (!m_records->tryPush(&record, 1))
         {
-            if (m_console && !m_consoleActive)
+            if (!retries--)
             {
-                startConsole();
-                m_consoleActive = isConsoleActive();
+                m_droppedRecords.fetch_add(1, std::memory_order_relaxed);
+                return;
             }
-            std::string completeLogMessage;
-
-            // Today's time
-            auto t = std::time(nullptr);
-            tm time = {};
-            localtime_s(&time, &t);
-
-            if (!m_file && !m_path.empty() && !m_pathInvalid)
+            std::this_thread::yield();
+        }
+        // Capture is just 'this' so it fits inline in the worker task
+        m_worker->scheduleWork([this]()->void
+        {
+            s_isLogThread = true;
+            LogRecord r;
+            while (m_records->tryPop(r))
             {
-                // Allow other process to read log file
-                auto path = m_path + L"\\" + m_name;
-                m_file = _wfsopen(path.c_str(), L"wt", _SH_DENYWR);
-                if (!m_file)
-                {
-                    m_pathInvalid = true;
-                    std::wstring tmp = L"[streamline][error]log.cpp:125[logva] Failed to open log file " + path + L"\n";
-                    completeLogMessage = extra::toStr(tmp);
-                    print(RED, completeLogMessage);
-                }
-                else
-                {
-                    std::stringstream dateTimeOss{};
-                    dateTimeOss << std::put_time(&time, "on %d.%m.%Y at %H-%M-%S");
-                    std::wstring tmp = L"[streamline][info]log.cpp:131[logva] Log file " + path + L" opened " + extra::toWStr(dateTimeOss.str()) + L"\n";
-                    completeLogMessage = extra::toStr(tmp);
-                    print(WHITE, completeLogMessage);
-                }
+                process(r);
+                r.overflow.reset();
+            }
+            if (auto dropped = m_droppedRecords.exchange(0, std::memory_order_relaxed))
+            {
+                LogRecord warning;
+                warning.color = YELLOW;
+                strncpy_s(warning.file, "log.cpp", _TRUNCATE);
+                strncpy_s(warning.func, "logva", _TRUNCATE);
+                warning.line = __LINE__;
+                warning.type = (int)LogType::eWarn;
+                warning.formatted = true;
+                warning.tid = std::this_thread::get_id();
+                snprintf(warning.text, LogRecord::kInlineSize, "Dropped %u log messages, log queue was full", dropped);
+                process(warning);
             }
+        });
+    }
+
+    //! Called on the log thread only
+    void process(const LogRecord& record)
+    {
+        if (m_console && !m_consoleActive)
+        {
+            startConsole();
+            m_consoleActive = isConsoleActive();
+        }
+        std::string completeLogMessage;
 
-            std::string message;
-            if (formatted)
+        // Today's time
+        auto t = std::time(nullptr);
+        tm time = {};
+        localtime_s(&time, &t);
+
+        if (!m_file && !m_path.empty() && !m_pathInvalid)
+        {
+            // Allow other process to read log file
+            auto path = m_path + L"\\" + m_name;
+            m_file = _wfsopen(path.c_str(), L"wt", _SH_DENYWR);
+            if (!m_file)
             {
-                message = msg;
+                m_pathInvalid = true;
+                std::wstring tmp = L"[streamline][error]log.cpp:125[logva] Failed to open log file " + path + L"\n";
+                completeLogMessage = extra::toStr(tmp);
+                print(RED, completeLogMessage);
             }
             else
             {
-                message = fmt;
-                // This is stripping things that it shouldn't (e.g. vulkan validation messages are being cut off)
-                // ppp: patch: begin
+                std::stringstream dateTimeOss{};
+                dateTimeOss << std::put_time(&time, "on %d.%m.%Y at %H-%M-%S");
+                std::wstring tmp = L"[streamline][info]log.cpp:131[logva] Log file " + path + L" opened " + extra::toWStr(dateTimeOss.str()) + L"\n";
+                completeLogMessage = extra::toStr(tmp);
+                print(WHITE, completeLogMessage);
+            }
+        }
+
+        auto tid = record.tid;
+        auto type = record.type;
+        auto line = record.line;
+        const char* func = record.func;
+        auto color = record.color;
+        auto isMetaDataUnique = record.isMetaDataUnique;
+        auto formatted = record.formatted;
+        std::string message = record.c_str();
+        if (!formatted)
+        {
+            // This is stripping things that it shouldn't (e.g. vulkan validation messages are being cut off)
+            // ppp: patch: begin
 #if 0
-                // Message coming from 3rd party (NGX) so remove the time stamp
-                auto p = message.find("]");
+            // Message coming from 3rd party (NGX) so remove the time stamp
+            auto p = message.find("]");
+            if (p != std::string::npos)
+            {
+                p = message.find("]", p + 1);
                 if (p != std::string::npos)
                 {
-                    p = message.find("]", p + 1);
-                    if (p != std::string::npos)
-                    {
-                        message = message.substr(p + 1);
-                    }
+                    message = message.substr(p + 1);
                 }
-#endif
-                // ppp: patch: end
             }
-            
-            // Filename
-            std::string f(file);
-            // file is constexpr so always valid and always will have at least one '\'
-            f = f.substr(f.rfind('\\') + 1);
-
-            // Log type
-            std::string prefix[] = { "info","warn","error" };
-            static_assert(countof(prefix) == (size_t)LogType::eCount);
-            
-            // Metadata that makes a log message unique
-            std::ostringstream oss_logSourceMetdata;
-            oss_logSourceMetdata << "[tid:" << tid << "]" << "[" << sl::extra::getPrettyTimestamp() + "]";
-
-            // Put it all together in the message header
-            std::ostringstream oss;
-            oss << std::put_time(&time, "[%H-%M-%S]") << "[streamline][" << prefix[type] << "]" << oss_logSourceMetdata.str() << f << ":" << line << "[" << func << "]";
-            
-            // Actual message will get appended a bit later in this func
-            completeLogMessage = oss.str();
-
-            // Safety in case map grows too big like 10K unique messages (which is highly unlikely ever to happen but ...)
-            // However if verbose logging is on allow all messages
-            if (m_logLevel != LogLevel::eVerbose)
+#endif
+            // ppp: patch: end
+        }
+        
+        // Filename, path is already stripped by the caller
+        std::string f(record.file);
+
+        // Log type
+        std::string prefix[] = { "info","warn","error" };
+        static_assert(countof(prefix) == (size_t)LogType::eCount);
+        
+        // Metadata that makes a log message unique
+        std::ostringstream oss_logSourceMetdata;
+        oss_logSourceMetdata << "[tid:" << tid << "]" << "[" << sl::extra::getPrettyTimestamp() + "]";
+
+        // Put it all together in the message header
+        std::ostringstream oss;
+        oss << std::put_time(&time, "[%H-%M-%S]") << "[streamline][" << prefix[type] << "]" << oss_logSourceMetdata.str() << f << ":" << line << "[" << func << "]";
+        
+        // Actual message will get appended a bit later in this func
+        completeLogMessage = oss.str();
+
+        // Duplicate suppression, tracked messages are kept in a bounded LRU
+        // However if verbose logging is on allow all messages
+        if (m_logLevel != LogLevel::eVerbose)
+        {
+            std::string messageHashPrefix = "";
+            if (isMetaDataUnique)
             {
-                if (m_logTimes.size() > 10000)
-                {
-                    m_logTimes.clear();
-                }
+                // We consider source metadata(e.g., thread id, granular timestamp) to make a log message unique in this case
+                // e.g.: logging "Hello!" from 2 different threads is considered logging 2 different messages
+                messageHashPrefix = oss_logSourceMetdata.str();
+            }
 
-                std::string messageHashPrefix = "";
-                if (isMetaDataUnique)
+            auto id = m_hash(messageHashPrefix + message);
+            auto now = std::chrono::system_clock::now();
+            auto it = m_logTimes.find(id);
+            if (it != m_logTimes.end())
+            {
+                // Already logged before, move to the front of the LRU
+                m_logTimesLRU.splice(m_logTimesLRU.begin(), m_logTimesLRU, it->second);
+                // Make sure not to spam the log
+                std::chrono::duration<float, std::milli> diff = now - it->second->second;
+                if (diff.count() < m_messageDelayMs)
                 {
-                    // We consider source metadata(e.g., thread id, granular timestamp) to make a log message unique in this case
-                    // e.g.: logging "Hello!" from 2 different threads is considered logging 2 different messages
-                    messageHashPrefix = oss_logSourceMetdata.str();
+                    // Show frequent messages every 'messageDelayMs'
+                    return;
                 }
-
-                auto id = m_hash(messageHashPrefix + message);
-                auto lastLogTime = m_logTimes[id];
-                if (lastLogTime.time_since_epoch().count() > 0)
+                it->second->second = now;
+            }
+            else
+            {
+                // Bounded, evict least recently seen message
+                if (m_logTimes.size() >= kMaxTrackedMessages)
                 {
-                    // Already logged before, make sure not to spam the log
-                    std::chrono::duration<float, std::milli> diff = std::chrono::system_clock::now() - lastLogTime;
-                    if (diff.count() < m_messageDelayMs)
-                    {
-                        // Show frequent messages every 'messageDelayMs'
-                        return;
-                    }
+                    m_logTimes.erase(m_logTimesLRU.back().first);
+                    m_logTimesLRU.pop_back();
                 }
-                m_logTimes[id] = std::chrono::system_clock::now();
+                m_logTimesLRU.emplace_front(id, now);
+                m_logTimes[id] = m_logTimesLRU.begin();
             }
+        }
 
-            completeLogMessage += ' ' + message;
+        completeLogMessage += ' ' + message;
 
-            if (formatted)
-            {
-                completeLogMessage += '\n';
-            }            
+        if (formatted)
+        {
+            completeLogMessage += '\n';
+        }            
 
-            print(color, completeLogMessage);
+        print(color, completeLogMessage);
 
-            if (m_logMessageCallback)
-            {
-                m_logMessageCallback((LogType)type, completeLogMessage.c_str());
-            }
-        };
-        m_worker->scheduleWork(logLambda);
+        if (m_logMessageCallback)
+        {
+            m_logMessageCallback((LogType)type, completeLogMessage.c_str());
+        }
     }
 
     void startConsole()
@@ -440,7 +556,11 @@ struct Log : ILog
     
     float m_messageDelayMs = 5000.0f;
 
-    std::map<size_t, std::chrono::time_point<std::chrono::system_clock>> m_logTimes{};
+    //! Duplicate message suppression, only touched on the log thread
+    static constexpr size_t kMaxTrackedMessages = 1024;
+    using LogTimeList = std::list<std::pair<size_t, std::chrono::time_point<std::chrono::system_clock>>>;
+    LogTimeList m_logTimesLRU{};
+    std::unordered_map<size_t, LogTimeList::iterator> m_logTimes{};
 
     inline static Log* s_log = {};
     HANDLE m_outHandle{};
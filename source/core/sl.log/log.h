@@ -87,14 +87,39 @@ struct ILog
     virtual const wchar_t* getLogName() = 0;
     virtual void flush() = 0;
     virtual void shutdown() = 0;
+    //! Enables memory-mapped binary ring sink in 'path' (nullptr disables it)
+    //! 
+    //! NOTE: Added at the end to keep ABI compatibility with older plugins
+    virtual void setBinaryLogPath(const wchar_t* path, uint32_t sizeMB) = 0;
 };
 
 ILog* getInterface();
 void destroyInterface();
 
-#define SL_RUN_ONCE                                  \
-    for (static std::atomic<int> s_runAlready(false); \
-         !s_runAlready.fetch_or(true);)               \
+// Plain load first so callsites hit every frame do not keep writing to the cache line
+#define SL_RUN_ONCE                                                         \
+    for (static std::atomic<int> s_runAlready(false);                        \
+         !s_runAlready.load(std::memory_order_relaxed) &&                    \
+         !s_runAlready.exchange(true, std::memory_order_relaxed);)           \
+
+//! Per-callsite rate limiter, returns true at most once per interval
+//! 
+//! Rejects repeats before any formatting or allocation takes place.
+inline bool shouldRunRateLimited(std::atomic<int64_t>& lastRun, int64_t intervalMs)
+{
+    auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    auto prev = lastRun.load(std::memory_order_relaxed);
+    if (prev != 0 && now - prev < intervalMs)
+    {
+        return false;
+    }
+    // Only one thread wins if several hit the callsite at the same time
+    return lastRun.compare_exchange_strong(prev, now ? now : 1, std::memory_order_relaxed);
+}
+
+#define SL_RUN_RATE_LIMITED(intervalMs)                                     \
+    for (static std::atomic<int64_t> s_lastRun(0);                           \
+         sl::log::shouldRunRateLimited(s_lastRun, intervalMs);)              \
 
 // WAR for bug 4654661
 // Streamline version 2.3.0 introduced a new sl::log::ILog::logva parameter
@@ -158,6 +183,13 @@ struct ILogPreMetaDataUnique
 #define SL_LOG_ERROR_ONCE(fmt,...) SL_RUN_ONCE { SL_LOG_ERROR(fmt,__VA_ARGS__); }
 #define SL_LOG_VERBOSE_ONCE(fmt,...) SL_RUN_ONCE { SL_LOG_VERBOSE(fmt,__VA_ARGS__); }
 
+// Same as above but allow the message again once 'ms' milliseconds have passed
+#define SL_LOG_HINT_EVERY(ms,fmt,...) SL_RUN_RATE_LIMITED(ms) { SL_LOG_HINT(fmt,__VA_ARGS__); }
+#define SL_LOG_INFO_EVERY(ms,fmt,...) SL_RUN_RATE_LIMITED(ms) { SL_LOG_INFO(fmt,__VA_ARGS__); }
+#define SL_LOG_WARN_EVERY(ms,fmt,...) SL_RUN_RATE_LIMITED(ms) { SL_LOG_WARN(fmt,__VA_ARGS__); }
+#define SL_LOG_ERROR_EVERY(ms,fmt,...) SL_RUN_RATE_LIMITED(ms) { SL_LOG_ERROR(fmt,__VA_ARGS__); }
+#define SL_LOG_VERBOSE_EVERY(ms,fmt,...) SL_RUN_RATE_LIMITED(ms) { SL_LOG_VERBOSE(fmt,__VA_ARGS__); }
+
 }
 }
 
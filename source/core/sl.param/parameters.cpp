@@ -23,6 +23,10 @@
 #include <map>
 #include <typeinfo>
 #include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <cstring>
 
 #include "include/sl.h"
 #include "source/core/sl.log/log.h"
@@ -34,12 +38,39 @@ namespace sl
 namespace param
 {
     
+//! Compile-time type tag, replaces typeid based run-time checks
+enum class ParameterType : uint32_t
+{
+    eUnknown,
+    eBool,
+    eFloat,
+    eDouble,
+    eInt,
+    eUInt,
+    eULL,
+    eVoidPtr
+};
+
+template<typename T>
+constexpr ParameterType getParameterType()
+{
+    if constexpr (std::is_same<T, bool>::value) return ParameterType::eBool;
+    else if constexpr (std::is_same<T, float>::value) return ParameterType::eFloat;
+    else if constexpr (std::is_same<T, double>::value) return ParameterType::eDouble;
+    else if constexpr (std::is_same<T, int>::value) return ParameterType::eInt;
+    else if constexpr (std::is_same<T, unsigned int>::value) return ParameterType::eUInt;
+    else if constexpr (std::is_same<T, unsigned long long>::value) return ParameterType::eULL;
+    else if constexpr (std::is_same<T, void*>::value) return ParameterType::eVoidPtr;
+    else return ParameterType::eUnknown;
+}
+
 struct Parameter
 {      
     template<typename T>
     void operator=(T value) 
     { 
-        key = typeid(T).hash_code();  
+        static_assert(getParameterType<T>() != ParameterType::eUnknown, "Unsupported parameter type");
+        key = getParameterType<T>();
         if constexpr (std::is_same<T, float>::value) values.f = value;        
         else if constexpr (std::is_same<T, int>::value) values.i = value;        
         else if constexpr (std::is_same<T, unsigned int>::value) values.ui = value;        
@@ -52,57 +83,36 @@ struct Parameter
     template<typename T>
     operator T() const 
     { 
-        T v = {};        
-        if constexpr (std::is_same<T, float>::value)
+        T v = {};
+        if constexpr (std::is_same<T, void*>::value)
         {
-            if (key == typeid(unsigned long long).hash_code()) v = (T)values.ull;
-            else if (key == typeid(float).hash_code()) v = (T)values.f;
-            else if (key == typeid(double).hash_code()) v = (T)values.d;
-            else if (key == typeid(unsigned int).hash_code()) v = (T)values.ui;
-            else if (key == typeid(int).hash_code()) v = (T)values.i;
+            if (key == ParameterType::eVoidPtr) v = values.vp;
         }
-        else if constexpr (std::is_same<T, int>::value)
-        {
-            if (key == typeid(unsigned long long).hash_code()) v = (T)values.ull;
-            else if (key == typeid(float).hash_code()) v = (T)values.f;
-            else if (key == typeid(double).hash_code()) v = (T)values.d;
-            else if (key == typeid(int).hash_code()) v = (T)values.i;
-            else if (key == typeid(unsigned int).hash_code()) v = (T)values.ui;
-        }
-        else if constexpr (std::is_same<T, unsigned int>::value)
-        {
-            if (key == typeid(unsigned long long).hash_code()) v = (T)values.ull;
-            else if (key == typeid(float).hash_code()) v = (T)values.f;
-            else if (key == typeid(double).hash_code()) v = (T)values.d;
-            else if (key == typeid(int).hash_code()) v = (T)values.i;
-            else if (key == typeid(unsigned int).hash_code()) v = (T)values.ui;
-        }
-        else if constexpr (std::is_same<T, double>::value)
-        {
-            if (key == typeid(unsigned long long).hash_code()) v = (T)values.ull;
-            else if (key == typeid(float).hash_code()) v = (T)values.f;
-            else if (key == typeid(double).hash_code()) v = (T)values.d;
-            else if (key == typeid(int).hash_code()) v = (T)values.i;
-            else if (key == typeid(unsigned int).hash_code()) v = (T)values.ui;
-        }
-        else if constexpr (std::is_same<T, unsigned long long>::value)
-        {
-            if (key == typeid(unsigned long long).hash_code()) v = (T)values.ull;
-            else if (key == typeid(float).hash_code()) v = (T)values.f;
-            else if (key == typeid(double).hash_code()) v = (T)values.d;
-            else if (key == typeid(int).hash_code()) v = (T)values.i;
-            else if (key == typeid(unsigned int).hash_code()) v = (T)values.ui;
-            else if (key == typeid(void *).hash_code()) v = (T)values.vp;
-        }
-        else if constexpr (std::is_same<T, void*>::value)
+        else if constexpr (std::is_same<T, bool>::value)
         {
-            if (key == typeid(void *).hash_code()) v = values.vp;
+            switch (key)
+            {
+                case ParameterType::eBool: v = values.b; break;
+                case ParameterType::eInt: v = values.i != 0; break;
+                case ParameterType::eUInt: v = values.ui != 0; break;
+                default: break;
+            }
         }
-        else if constexpr (std::is_same<T, bool>::value)
+        else
         {
-            if (key == typeid(bool).hash_code()) v = (T)values.b;
-            else if (key == typeid(int).hash_code()) v = (T)values.i != 0;
-            else if (key == typeid(unsigned int).hash_code()) v = (T)values.ui != 0;
+            // Numeric conversions, only unsigned long long can be read back from a pointer
+            switch (key)
+            {
+                case ParameterType::eULL: v = (T)values.ull; break;
+                case ParameterType::eFloat: v = (T)values.f; break;
+                case ParameterType::eDouble: v = (T)values.d; break;
+                case ParameterType::eInt: v = (T)values.i; break;
+                case ParameterType::eUInt: v = (T)values.ui; break;
+                case ParameterType::eVoidPtr:
+                    if constexpr (std::is_same<T, unsigned long long>::value) v = (T)values.vp;
+                    break;
+                default: break;
+            }
         }
         return v;
     }
@@ -118,16 +128,60 @@ struct Parameter
         void *vp;
     } values;
 
-    size_t key = 0;
+    ParameterType key = ParameterType::eUnknown;
 };
 
+//! Parameters are looked up on hot paths by many plugins, very rarely added
+//! 
+//! Each key is interned once into a node with stable address, nodes are indexed
+//! by a flat open-addressing table of pointers. Readers never lock or allocate,
+//! they probe the currently published table and read the value under a seqlock.
+//! Writers serialize on a mutex, growing the table publishes a new copy and the old
+//! one is retired (kept alive) so in-flight readers are always safe.
 struct Parameters : public IParameters
 {
+    Parameters()
+    {
+        m_table.store(allocateTable(kInitialCapacity));
+    }
+
+    ~Parameters()
+    {
+        for (auto table : m_retired)
+        {
+            delete table;
+        }
+        delete m_table.load();
+        for (auto node : m_nodes)
+        {
+            delete node;
+        }
+    }
+
     template<typename T>
     void setT(const char* key, T &value)
     {
+        Parameter p;
+        p = value;
+
         const std::lock_guard<std::mutex> lock(m_mutex);
-        m_values[key] = value;
+        getOrInsert(key, param::hashKey(key))->store(p);
+        m_generation.fetch_add(1, std::memory_order_release);
+    }
+
+    template<typename T>
+    void setT(ParameterHandle handle, T& value)
+    {
+        if (handle.index >= kMaxHandles) return;
+        auto node = m_handles[handle.index].load(std::memory_order_acquire);
+        if (!node) return;
+
+        Parameter p;
+        p = value;
+
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        node->store(p);
+        m_generation.fetch_add(1, std::memory_order_release);
     }
 
     void set(const char * key, bool value) override { setT(key, value); }
@@ -141,11 +195,20 @@ struct Parameters : public IParameters
     template<typename T>
     bool getT(const char* key, T *value) const
     {
-        const std::lock_guard<std::mutex> lock(m_mutex);
-        auto k = m_values.find(key);
-        if (k == m_values.end()) return false;
-        const Parameter &p = (*k).second;
-        *value = p;
+        auto node = find(m_table.load(std::memory_order_acquire), key, param::hashKey(key));
+        if (!node || !node->isSet()) return false;
+        *value = node->load();
+        return true;
+    }
+
+    template<typename T>
+    bool getT(ParameterHandle handle, T* value) const
+    {
+        if (handle.index >= kMaxHandles) return false;
+        auto node = m_handles[handle.index].load(std::memory_order_acquire);
+        // Registered but never set is the same as missing
+        if (!node || !node->isSet()) return false;
+        *value = node->load();
         return true;
     }
 
@@ -160,17 +223,206 @@ struct Parameters : public IParameters
     std::vector<std::string> enumerate() const override
     {
         std::vector<std::string> keys;
-        for (auto& value : m_values)
+        enumerateKeys([](const char* key, void* context)->bool
         {
-            keys.push_back(value.first);
-        }
+            ((std::vector<std::string>*)context)->push_back(key);
+            return true;
+        }, &keys);
         return keys;
     }
 
+    void enumerateKeys(PFun_ParameterEnumerateCallback* callback, void* context) const override
+    {
+        // Nodes are published in insertion order before the count is bumped
+        auto count = m_snapshotCount.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto node = m_handles[i].load(std::memory_order_acquire);
+            if (node->isSet() && !callback(node->key.c_str(), context))
+            {
+                return;
+            }
+        }
+        if (m_nodeCount.load(std::memory_order_acquire) > count)
+        {
+            // Overflow beyond the handle table, rare so just lock
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            for (size_t i = count; i < m_nodes.size(); i++)
+            {
+                if (m_nodes[i]->isSet() && !callback(m_nodes[i]->key.c_str(), context))
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+    uint64_t getGeneration() const override
+    {
+        return m_generation.load(std::memory_order_acquire);
+    }
+
+    ParameterHandle registerKey(const char* key, uint64_t hash) override
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        return { getOrInsert(key, hash)->handle };
+    }
+
+    void setByHandle(ParameterHandle handle, bool value) override { setT(handle, value); }
+    void setByHandle(ParameterHandle handle, unsigned long long value) override { setT(handle, value); }
+    void setByHandle(ParameterHandle handle, float value) override { setT(handle, value); }
+    void setByHandle(ParameterHandle handle, double value) override { setT(handle, value); }
+    void setByHandle(ParameterHandle handle, unsigned int value) override { setT(handle, value); }
+    void setByHandle(ParameterHandle handle, int value) override { setT(handle, value); }
+    void setByHandle(ParameterHandle handle, void* value) override { setT(handle, value); }
+
+    bool getByHandle(ParameterHandle handle, bool* value) const override { return getT(handle, value); }
+    bool getByHandle(ParameterHandle handle, unsigned long long* value) const override { return getT(handle, value); }
+    bool getByHandle(ParameterHandle handle, float* value) const override { return getT(handle, value); }
+    bool getByHandle(ParameterHandle handle, double* value) const override { return getT(handle, value); }
+    bool getByHandle(ParameterHandle handle, unsigned int* value) const override { return getT(handle, value); }
+    bool getByHandle(ParameterHandle handle, int* value) const override { return getT(handle, value); }
+    bool getByHandle(ParameterHandle handle, void** value) const override { return getT(handle, value); }
+
     inline static Parameters* s_params = {};
 
 private:
-    std::map<std::string, Parameter> m_values;
+
+    static constexpr size_t kInitialCapacity = 256;
+    static constexpr uint32_t kMaxHandles = 4096;
+
+    struct Node
+    {
+        std::string key;
+        uint64_t hash{};
+        mutable std::atomic<uint32_t> seq = 0;
+        uint32_t handle = ParameterHandle::kInvalidIndex;
+        std::atomic<uint64_t> bits = 0;
+        std::atomic<ParameterType> type = ParameterType::eUnknown;
+
+        bool isSet() const { return type.load(std::memory_order_acquire) != ParameterType::eUnknown; }
+
+        //! Writers are serialized by the parameters mutex
+        void store(const Parameter& p)
+        {
+            uint64_t v{};
+            static_assert(sizeof(p.values) == sizeof(v));
+            memcpy(&v, &p.values, sizeof(v));
+            seq.fetch_add(1, std::memory_order_acq_rel);
+            bits.store(v, std::memory_order_relaxed);
+            type.store(p.key, std::memory_order_relaxed);
+            seq.fetch_add(1, std::memory_order_release);
+        }
+
+        Parameter load() const
+        {
+            Parameter p;
+            uint64_t v{};
+            uint32_t s0{};
+            do
+            {
+                s0 = seq.load(std::memory_order_acquire);
+                v = bits.load(std::memory_order_relaxed);
+                p.key = type.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+            } while ((s0 & 1) || s0 != seq.load(std::memory_order_relaxed));
+            memcpy(&p.values, &v, sizeof(v));
+            return p;
+        }
+    };
+
+    struct Table
+    {
+        size_t mask{};
+        std::unique_ptr<std::atomic<Node*>[]> slots;
+    };
+
+    static Table* allocateTable(size_t capacity)
+    {
+        auto table = new Table();
+        table->mask = capacity - 1;
+        table->slots = std::make_unique<std::atomic<Node*>[]>(capacity);
+        for (size_t i = 0; i < capacity; i++)
+        {
+            table->slots[i].store(nullptr, std::memory_order_relaxed);
+        }
+        return table;
+    }
+
+    static Node* find(const Table* table, const char* key, uint64_t hash)
+    {
+        for (auto i = hash & table->mask;; i = (i + 1) & table->mask)
+        {
+            auto node = table->slots[i].load(std::memory_order_acquire);
+            if (!node) return nullptr;
+            if (node->hash == hash && node->key == key) return node;
+        }
+    }
+
+    static void place(Table* table, Node* node)
+    {
+        auto i = node->hash & table->mask;
+        while (table->slots[i].load(std::memory_order_relaxed))
+        {
+            i = (i + 1) & table->mask;
+        }
+        table->slots[i].store(node, std::memory_order_release);
+    }
+
+    //! Must be called with the mutex held
+    Node* getOrInsert(const char* key, uint64_t hash)
+    {
+        auto node = find(m_table.load(std::memory_order_relaxed), key, hash);
+        return node ? node : insert(key, hash);
+    }
+
+    //! Must be called with the mutex held
+    Node* insert(const char* key, uint64_t hash)
+    {
+        auto node = new Node();
+        node->key = key;
+        node->hash = hash;
+        if (m_nodes.size() < kMaxHandles)
+        {
+            node->handle = (uint32_t)m_nodes.size();
+            m_handles[node->handle].store(node, std::memory_order_release);
+            m_snapshotCount.store(node->handle + 1, std::memory_order_release);
+        }
+        else
+        {
+            SL_LOG_WARN_ONCE("Too many parameters, handle based access not available for '%s'", key);
+        }
+        m_nodes.push_back(node);
+        m_nodeCount.store(m_nodes.size(), std::memory_order_release);
+        m_generation.fetch_add(1, std::memory_order_release);
+
+        auto table = m_table.load(std::memory_order_relaxed);
+        // Keep load factor under 50% so probe sequences stay short
+        if (m_nodes.size() * 2 > table->mask + 1)
+        {
+            auto grown = allocateTable((table->mask + 1) * 2);
+            for (auto n : m_nodes)
+            {
+                place(grown, n);
+            }
+            m_table.store(grown, std::memory_order_release);
+            // Readers could still be probing the old table
+            m_retired.push_back(table);
+        }
+        else
+        {
+            place(table, node);
+        }
+        return node;
+    }
+
+    std::atomic<Table*> m_table = {};
+    std::vector<Table*> m_retired;
+    std::vector<Node*> m_nodes;
+    std::unique_ptr<std::atomic<Node*>[]> m_handles = std::make_unique<std::atomic<Node*>[]>(kMaxHandles);
+    std::atomic<uint32_t> m_snapshotCount = 0;
+    std::atomic<size_t> m_nodeCount = 0;
+    std::atomic<uint64_t> m_generation = 0;
     mutable std::mutex m_mutex;
 };
 
@@ -23,6 +23,8 @@
 #pragma once
 
 #include <vector>
+#include <string>
+#include <stdint.h>
 
 namespace sl
 {
@@ -36,6 +38,7 @@ namespace global
 
 constexpr const char* kColorBuffersHDR = "sl.param.global.colorBuffersHDR";
 constexpr const char* kPFunGetConsts = "sl.param.global.getConstsFunc";
+constexpr const char* kPFunGetConstsAndDerived = "sl.param.global.getConstsAndDerivedFunc";
 constexpr const char* kPFunAllocateResource = "sl.param.global.allocateResource";
 constexpr const char* kPFunReleaseResource = "sl.param.global.releaseResource";
 constexpr const char* kPluginPath = "sl.param.global.pluginPath";
@@ -47,8 +50,21 @@ constexpr const char* kDRSContext = "sl.param.global.drsContext";
 constexpr const char* kSwapchainBufferCount = "sl.param.global.swapchainbuffercount";
 constexpr const char* kDebugMode = "sl.param.global.dbgMode";
 constexpr const char* kPFunGetTag = "sl.param.global.getTag";
+constexpr const char* kPFunGetTags = "sl.param.global.getTags";
 constexpr const char* kVulkanTable = "sl.param.global.vulkanTable";
+constexpr const char* kVkImageTable = "sl.param.global.vkImageTable";
 constexpr const char* kPreferenceFlags = "sl.param.global.prefFlags";
+constexpr const char* kD3D12DescriptorCount = "sl.param.global.d3d12DescriptorCount";
+constexpr const char* kAsyncCompute = "sl.param.global.asyncCompute";
+constexpr const char* kD3D11LightweightState = "sl.param.global.d3d11LightweightState";
+constexpr const char* kD3D12TrackBarrierStates = "sl.param.global.d3d12TrackBarrierStates";
+constexpr const char* kStartupTimeline = "sl.param.global.startupTimeline";
+constexpr const char* kPerfStats = "sl.param.global.perfStats";
+constexpr const char* kGPUMarkers = "sl.param.global.gpuMarkers";
+constexpr const char* kHitchRecorder = "sl.param.global.hitchRecorder";
+constexpr const char* kFrameEpoch = "sl.param.global.frameEpoch";
+constexpr const char* kHeapAllocations = "sl.param.global.heapAllocations";
+constexpr const char* kMaxNumViewports = "sl.param.global.maxNumViewports";
 }
 
 namespace interposer
@@ -60,15 +76,24 @@ namespace common
 {
 
 constexpr const char* kSystemCaps = "sl.param.common.gpuInfo";
+constexpr const char* kSystemCapsCache = "sl.param.common.gpuInfoCache";
 constexpr const char* kComputeAPI = "sl.param.common.computeAPI";
 constexpr const char* kComputeDX11On12API = "sl.param.common.computeDX11On12API";
 constexpr const char* kCaptureAPI = "sl.param.common.captureAPI";
 constexpr const char* kKeyboardAPI = "sl.param.common.keyboardAPI";
 constexpr const char* kPFunRegisterEvaluateCallbacks = "sl.param.common.registerEvaluateCallbacks";
+constexpr const char* kPFunSetEvaluateReentrant = "sl.param.common.setEvaluateReentrant";
+constexpr const char* kPFunRegisterResizeCallbacks = "sl.param.common.registerResizeCallbacks";
+constexpr const char* kPFunAcquireScratch = "sl.param.common.acquireScratch";
+constexpr const char* kPFunBeginScratchPass = "sl.param.common.beginScratchPass";
+constexpr const char* kPFunReleaseScratch = "sl.param.common.releaseScratch";
 constexpr const char* kPFunGetStringFromModule = "sl.param.common.getStringFromModule";
 constexpr const char* kPFunUpdateCommonEmbeddedJSONConfig = "sl.param.common.updateCommonEmbeddedJSONConfig";
 constexpr const char* kPFunNGXGetFeatureRequirements = "sl.param.common.NGXGetFeatureRequirements";
 constexpr const char* kPFunFindAdapter = "sl.param.common.findAdapter";
+constexpr const char* kPFunSetTagClonePolicy = "sl.param.common.setTagClonePolicy";
+constexpr const char* kFrameworkStats = "sl.param.common.frameworkStats";
+constexpr const char* kPresentQueue = "sl.param.common.presentQueue";
 
 }
 
@@ -146,6 +171,43 @@ namespace dlss_d
 constexpr const char* kCurrentFrame = "sl.param.dlss_d.frame";
 }
 
+//! Compile-time FNV-1a hash of the parameter key
+constexpr uint64_t hashKey(const char* key)
+{
+    uint64_t hash = 14695981039346656037ull;
+    while (*key)
+    {
+        hash = (hash ^ (uint8_t)*key++) * 1099511628211ull;
+    }
+    return hash;
+}
+
+//! Parameter key with precomputed hash
+//! 
+//! Use with constexpr keys, for example:
+//! 
+//! constexpr ParameterKey kFrame = { param::dlss::kCurrentFrame, hashKey(param::dlss::kCurrentFrame) };
+struct ParameterKey
+{
+    const char* key;
+    uint64_t hash;
+};
+
+//! Opaque handle returned by IParameters::registerKey
+//! 
+//! Handles are valid for the lifetime of the parameters interface and
+//! can be shared across threads and plugins.
+struct ParameterHandle
+{
+    uint32_t index = kInvalidIndex;
+
+    static constexpr uint32_t kInvalidIndex = 0xffffffff;
+    explicit operator bool() const { return index != kInvalidIndex; }
+};
+
+//! Return false to stop enumeration
+using PFun_ParameterEnumerateCallback = bool(const char* key, void* context);
+
 struct IParameters
 {
     virtual void set(const char* key, bool value) = 0;
@@ -165,10 +227,56 @@ struct IParameters
     virtual bool get(const char* key, void** value) const = 0;
 
     virtual std::vector<std::string> enumerate() const = 0;
+
+    //! Registers key (if not registered already) and returns the handle to it
+    //! 
+    //! Handle based set/get skip hashing and string comparison entirely.
+    //! NOTE: Distinct names on purpose, MSVC groups overloads in the vtable so
+    //! new set/get overloads would shift the existing entries.
+    virtual ParameterHandle registerKey(const char* key, uint64_t hash) = 0;
+
+    virtual void setByHandle(ParameterHandle handle, bool value) = 0;
+    virtual void setByHandle(ParameterHandle handle, unsigned long long value) = 0;
+    virtual void setByHandle(ParameterHandle handle, float value) = 0;
+    virtual void setByHandle(ParameterHandle handle, double value) = 0;
+    virtual void setByHandle(ParameterHandle handle, unsigned int value) = 0;
+    virtual void setByHandle(ParameterHandle handle, int value) = 0;
+    virtual void setByHandle(ParameterHandle handle, void* value) = 0;
+
+    virtual bool getByHandle(ParameterHandle handle, bool* value) const = 0;
+    virtual bool getByHandle(ParameterHandle handle, unsigned long long* value) const = 0;
+    virtual bool getByHandle(ParameterHandle handle, float* value) const = 0;
+    virtual bool getByHandle(ParameterHandle handle, double* value) const = 0;
+    virtual bool getByHandle(ParameterHandle handle, unsigned int* value) const = 0;
+    virtual bool getByHandle(ParameterHandle handle, int* value) const = 0;
+    virtual bool getByHandle(ParameterHandle handle, void** value) const = 0;
+
+    //! Enumerates keys without locking or allocating
+    //! 
+    //! Not an 'enumerate' overload, that would move it next to the existing entry in the MSVC vtable.
+    //! 
+    //! Keys are immutable once added so the callback sees a consistent
+    //! snapshot of all keys added before the call.
+    virtual void enumerateKeys(PFun_ParameterEnumerateCallback* callback, void* context) const = 0;
+
+    //! Monotonic counter incremented on every change (new key or new value)
+    //! 
+    //! Tools can poll this to cheaply detect changes.
+    virtual uint64_t getGeneration() const = 0;
 };
 
 // Helpers
 
+inline ParameterHandle registerKey(IParameters* parameters, const ParameterKey& key)
+{
+    return parameters->registerKey(key.key, key.hash);
+}
+
+inline ParameterHandle registerKey(IParameters* parameters, const char* key)
+{
+    return parameters->registerKey(key, hashKey(key));
+}
+
 template<typename T>
 inline bool getPointerParam(IParameters* parameters, const char* key, T** res, bool optional = false, uint32_t id = 0)
 {
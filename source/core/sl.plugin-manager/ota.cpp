@@ -23,12 +23,17 @@
 #include <sstream>
 
 #include <thread>
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <vector>
 
 #include "source/core/sl.api/internal.h"
 #include "source/core/sl.param/parameters.h"
 #include "source/core/sl.plugin/plugin.h"
 #include "source/core/sl.log/log.h"
 #include "source/core/sl.plugin-manager/ota.h"
+#include "source/core/sl.plugin-manager/otaPatch.h"
 #include "source/core/sl.file/file.h"
 #include "source/core/sl.extra/extra.h"
 #include "source/core/sl.security/secureLoadLibrary.h"
@@ -88,7 +93,7 @@ namespace ota
                 &security,               // pointer to process security attributes
                 &security,               // pointer to thread security attributes
                 TRUE,                    // handle inheritance flag
-                NORMAL_PRIORITY_CLASS,   // creation flags
+                BELOW_NORMAL_PRIORITY_CLASS, // creation flags, updater must not compete with the game
                 NULL,                    // pointer to new environment block
                 NULL,                    // pointer to current directory name
                 &start,                  // pointer to STARTUPINFO
@@ -301,8 +306,17 @@ struct OTA : IOTA
         return DriverVersion;
     }
 
+    // Architecture does not change while we are running, skip NvAPI after the first query
+    std::atomic<uint32_t> m_gpuArch = UINT32_MAX;
+
     uint32_t getNVDAArchitecture()
     {
+        auto cached = m_gpuArch.load();
+        if (cached != UINT32_MAX)
+        {
+            return cached;
+        }
+
         // loop over all NvAPI exposed GPUs and return highest architecture
         // present
         NvU32 nvGpuCount = 0;
@@ -325,9 +339,75 @@ struct OTA : IOTA
                 }
             }
         }
+        m_gpuArch.store(gpuArch);
         return gpuArch;
     }
 
+    std::atomic<OTAStatus> m_status = OTAStatus::eIdle;
+    std::atomic<bool> m_stopWorker = false;
+    std::thread m_worker;
+
+    void checkForOTAAsync(const std::vector<Feature>& features, const Version &apiVersion, bool requestOptionalUpdates) override
+    {
+        auto expected = OTAStatus::eIdle;
+        if (!m_status.compare_exchange_strong(expected, OTAStatus::eChecking) && expected == OTAStatus::eChecking)
+        {
+            SL_LOG_VERBOSE("OTA check already in progress");
+            return;
+        }
+        m_status = OTAStatus::eChecking;
+
+        // Previous check is done at this point, joining only reclaims the thread
+        if (m_worker.joinable())
+        {
+            m_worker.join();
+        }
+        m_stopWorker = false;
+        // Joined in 'shutdown' since it uses this object and logs, the updater processes it launches are not waited on
+        m_worker = std::thread([this, features, apiVersion, requestOptionalUpdates]()->void
+        {
+#ifdef SL_WINDOWS
+            SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#endif
+            bool ok = true;
+            for (Feature f : features)
+            {
+                if (m_stopWorker)
+                {
+                    ok = false;
+                    break;
+                }
+                ok &= checkForOTA(f, apiVersion, requestOptionalUpdates);
+            }
+            m_status = ok ? OTAStatus::eComplete : OTAStatus::eFailed;
+            SL_LOG_VERBOSE("OTA check %s", ok ? "completed" : "failed");
+        });
+    }
+
+    void shutdown() override
+    {
+        m_stopWorker = true;
+        if (m_worker.joinable())
+        {
+            m_worker.join();
+        }
+        m_stopPatches = true;
+        std::vector<std::thread> patchWorkers;
+        {
+            std::scoped_lock lock(m_patchMutex);
+            patchWorkers.swap(m_patchWorkers);
+        }
+        for (auto& worker : patchWorkers)
+        {
+            worker.join();
+        }
+    }
+
+    OTAStatus getStatus() const override
+    {
+        return m_status.load();
+    }
+
     bool checkForOTA(Feature featureID, const Version &apiVersion, bool requestOptionalUpdates) override
     {
         uint32_t gpuArch = getNVDAArchitecture();
@@ -396,6 +476,51 @@ struct OTA : IOTA
         return true;
     }
 
+    // Targets of patches being applied, each is applied at most once per process
+    std::mutex m_patchMutex;
+    std::set<std::wstring> m_patches;
+    std::vector<std::thread> m_patchWorkers;
+    std::atomic<bool> m_stopPatches = false;
+
+    //! If the updater delivered a delta instead of 'pluginPath' applies it to the installed version in the background
+    //!
+    //! Returns the installed version in 'basePath' so it can be loaded until the patched one is picked up next launch.
+    bool stagePatchedPlugin(const std::wstring& featurePath, const std::wstring& pluginPath, std::wstring& basePath)
+    {
+        std::wstring patchPath = pluginPath + patch::kExtension;
+        patch::PatchHeader header{};
+        if (!file::exists(patchPath.c_str()) || !patch::readHeader(patchPath.c_str(), header))
+        {
+            return false;
+        }
+        basePath = featurePath + L"versions/" + std::to_wstring(header.baseVersion) + L"/files/" + fs::path(pluginPath).filename().wstring();
+        if (!file::exists(basePath.c_str()))
+        {
+            SL_LOG_WARN("OTA patch %ls needs version %u which is not installed", patchPath.c_str(), header.baseVersion);
+            return false;
+        }
+
+        std::scoped_lock lock(m_patchMutex);
+        if (!m_patches.insert(pluginPath).second || m_stopPatches)
+        {
+            return true;
+        }
+        SL_LOG_INFO("Applying OTA patch %ls in the background", patchPath.c_str());
+        std::wstring stagingPath = featurePath + L"staging/";
+        // Joined in 'shutdown' which stops it between operations, an interrupted patch leaves only the staging directory behind
+        m_patchWorkers.emplace_back([this, basePath, patchPath, stagingPath, pluginPath]()->void
+        {
+#ifdef SL_WINDOWS
+            SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#endif
+            if (patch::apply(basePath, patchPath, stagingPath, pluginPath, &m_stopPatches))
+            {
+                SL_LOG_INFO("OTA plugin %ls patched, it will be used on the next launch", pluginPath.c_str());
+            }
+        });
+        return true;
+    }
+
     bool getOTAPluginForFeature(Feature featureID, const Version &apiVersion, std::filesystem::path &filePath) override
     {
         // First get GPU Architecture, needed to download appropriate OTA
@@ -464,8 +589,8 @@ struct OTA : IOTA
 
         // XXX[ljm] there is probably a nicer sugary way to construct this oh
         // well, this at least matches the tiering of the comment above
-        std::wstring pluginPath = ngxPath + \
-                                  L"sl_" + extra::toWStr(name_version) + L"/" + \
+        std::wstring featurePath = ngxPath + L"sl_" + extra::toWStr(name_version) + L"/";
+        std::wstring pluginPath = featurePath + \
                                   L"versions/" + \
                                   otaVersionString + L"/" + \
                                   L"files/" + \
@@ -474,6 +599,12 @@ struct OTA : IOTA
         // Check if exists
         if (!fs::exists(pluginPath))
         {
+            std::wstring basePath;
+            if (stagePatchedPlugin(featurePath, pluginPath, basePath))
+            {
+                filePath = basePath;
+                return true;
+            }
             SL_LOG_ERROR("Found non-zero plugin \"%s\" in NGX Cache but missing file: %ls", name_version.c_str(), pluginPath.c_str());
             return false;
         }
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <filesystem>
+#include <vector>
 
 #include "include/sl_version.h"
 
@@ -33,6 +34,15 @@ using Feature = uint32_t;
 
 namespace ota
 {
+
+enum class OTAStatus : uint32_t
+{
+    eIdle,
+    eChecking,
+    eComplete,
+    eFailed
+};
+
 struct IOTA
 {
     //! Reads manifest downloaded from the server
@@ -54,6 +64,16 @@ struct IOTA
     //!   TRUE - a suitable plugin was found
     //!   FALSE - otherwise
     virtual bool getOTAPluginForFeature(Feature featureID, const Version &apiVersion, std::filesystem::path &filePath) = 0;
+
+    //! Runs checkForOTA for each feature on a low priority worker so the
+    //! caller never waits on NvAPI, the registry or the updater processes.
+    //! Downloads land in the NGX cache and are only picked up by
+    //! getOTAPluginForFeature on the next launch.
+    virtual void checkForOTAAsync(const std::vector<Feature>& features, const Version &apiVersion, bool requestOptionalUpdates) = 0;
+    //! State of the last checkForOTAAsync
+    virtual OTAStatus getStatus() const = 0;
+    //! Stops and joins the checkForOTAAsync worker, features not checked yet are skipped
+    virtual void shutdown() = 0;
 };
 
 IOTA* getInterface();
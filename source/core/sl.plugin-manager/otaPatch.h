@@ -0,0 +1,220 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <exception>
+#include <string.h>
+#include <stdint.h>
+
+#include "source/core/sl.file/file.h"
+#include "source/core/sl.log/log.h"
+
+#ifdef SL_WINDOWS
+#include <bcrypt.h>
+#pragma comment(lib, "bcrypt.lib")
+#endif
+
+namespace sl
+{
+namespace ota
+{
+
+//! Binary delta from an installed OTA plugin to a newer one, found next to where the full DLL would be
+//!
+//! A 'PatchHeader' followed by 'numOps' operations, each a 'PatchOp' followed by 'length' bytes for
+//! eInsert and eAdd. eAdd adds its bytes to the base range (bsdiff style) so code which only moved
+//! a little is mostly zeros and compresses well on the wire. Base and result are checked by SHA-256.
+namespace patch
+{
+
+constexpr char kMagic[8] = { 'S', 'L', 'P', 'A', 'T', 'C', 'H', '1' };
+constexpr const wchar_t* kExtension = L".slpatch";
+
+#pragma pack(push, 1)
+struct PatchHeader
+{
+    char magic[8];
+    //! Version the patch applies to, same integer as the NGX cache 'versions' directory, see 'Version::toWStrOTAId'
+    uint32_t baseVersion;
+    uint64_t baseSize;
+    uint64_t targetSize;
+    uint8_t baseHash[32];
+    uint8_t targetHash[32];
+    uint32_t numOps;
+};
+
+enum class OpType : uint8_t
+{
+    eCopy,
+    eInsert,
+    eAdd
+};
+
+struct PatchOp
+{
+    OpType type;
+    //! Offset into the base for eCopy and eAdd, unused for eInsert
+    uint64_t offset;
+    uint64_t length;
+};
+#pragma pack(pop)
+
+inline bool sha256(const uint8_t* data, size_t size, uint8_t(&digest)[32])
+{
+#ifdef SL_WINDOWS
+    return BCRYPT_SUCCESS(BCryptHash(BCRYPT_SHA256_ALG_HANDLE, nullptr, 0, (PUCHAR)data, (ULONG)size, digest, sizeof(digest)));
+#else
+    return false;
+#endif
+}
+
+//! Reads only the header, false if 'path' is not a patch
+inline bool readHeader(const wchar_t* path, PatchHeader& header)
+{
+    auto file = file::open(path, L"rb");
+    if (!file)
+    {
+        return false;
+    }
+    bool ok = file::readChunk(file, &header, sizeof(header)) == sizeof(header) && memcmp(header.magic, kMagic, sizeof(kMagic)) == 0;
+    file::close(file);
+    return ok;
+}
+
+//! Applies 'patchPath' to 'basePath' in 'stagingDir' and moves the verified result to 'targetPath'
+//!
+//! Nothing is written to 'targetPath' unless the base and the result match their hashes. Setting 'stop' abandons the patch.
+inline bool apply(const std::wstring& basePath, const std::wstring& patchPath, const std::wstring& stagingDir, const std::wstring& targetPath,
+    const std::atomic<bool>* stop = nullptr)
+{
+    try
+    {
+        auto base = file::map(basePath.c_str());
+        auto patch = file::map(patchPath.c_str());
+        if (patch.size() < sizeof(PatchHeader))
+        {
+            SL_LOG_ERROR("OTA patch '%ls' is truncated", patchPath.c_str());
+            return false;
+        }
+        PatchHeader header;
+        memcpy(&header, patch.data(), sizeof(header));
+        // Every byte of the result comes from the base or the patch, this also bounds the allocation below
+        if (header.targetSize > (uint64_t)base.size() + patch.size())
+        {
+            SL_LOG_ERROR("OTA patch '%ls' has an invalid target size %llu", patchPath.c_str(), header.targetSize);
+            return false;
+        }
+        uint8_t digest[32];
+        if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || base.size() != header.baseSize ||
+            !sha256(base.data(), base.size(), digest) || memcmp(digest, header.baseHash, sizeof(digest)) != 0)
+        {
+            SL_LOG_ERROR("OTA patch '%ls' does not apply to '%ls'", patchPath.c_str(), basePath.c_str());
+            return false;
+        }
+
+        std::vector<uint8_t> target;
+        target.reserve(header.targetSize);
+        size_t offset = sizeof(header);
+        for (uint32_t i = 0; i < header.numOps; i++)
+        {
+            if (stop && *stop)
+            {
+                return false;
+            }
+            PatchOp op;
+            if (patch.size() - offset < sizeof(op))
+            {
+                SL_LOG_ERROR("OTA patch '%ls' is truncated", patchPath.c_str());
+                return false;
+            }
+            memcpy(&op, patch.data() + offset, sizeof(op));
+            offset += sizeof(op);
+            bool fromBase = op.type == OpType::eCopy || op.type == OpType::eAdd;
+            bool fromPatch = op.type == OpType::eInsert || op.type == OpType::eAdd;
+            if (op.type > OpType::eAdd || op.length > header.targetSize - target.size() ||
+                (fromBase && (op.offset > base.size() || op.length > base.size() - op.offset)) ||
+                (fromPatch && op.length > patch.size() - offset))
+            {
+                SL_LOG_ERROR("OTA patch '%ls' is corrupted, operation %u out of range", patchPath.c_str(), i);
+                return false;
+            }
+            auto dst = target.size();
+            if (fromBase)
+            {
+                target.insert(target.end(), base.data() + op.offset, base.data() + op.offset + op.length);
+            }
+            if (op.type == OpType::eInsert)
+            {
+                target.insert(target.end(), patch.data() + offset, patch.data() + offset + op.length);
+            }
+            else if (op.type == OpType::eAdd)
+            {
+                for (uint64_t j = 0; j < op.length; j++)
+                {
+                    target[dst + j] += patch.data()[offset + j];
+                }
+            }
+            offset += fromPatch ? op.length : 0;
+        }
+        if (target.size() != header.targetSize || !sha256(target.data(), target.size(), digest) || memcmp(digest, header.targetHash, sizeof(digest)) != 0)
+        {
+            SL_LOG_ERROR("OTA patch '%ls' produced an unexpected result", patchPath.c_str());
+            return false;
+        }
+
+        // Readers only ever see a complete, verified file at 'targetPath'
+        if (!file::createDirectoryRecursively(stagingDir.c_str()))
+        {
+            return false;
+        }
+        auto stagedPath = stagingDir + fs::path(targetPath).filename().wstring();
+        auto staged = file::open(stagedPath.c_str(), L"wb");
+        if (!staged)
+        {
+            return false;
+        }
+        bool written = file::writeChunk(staged, target.data(), target.size()) == target.size();
+        file::close(staged);
+        if (!written || !file::move(stagedPath.c_str(), targetPath.c_str()))
+        {
+            SL_LOG_ERROR("Failed to stage patched OTA plugin '%ls'", targetPath.c_str());
+            std::error_code ec;
+            fs::remove(stagedPath, ec);
+            return false;
+        }
+        return true;
+    }
+    catch (std::exception& e)
+    {
+        SL_LOG_ERROR("Failed to apply OTA patch '%ls' - %s", patchPath.c_str(), e.what());
+    }
+    return false;
+}
+
+}
+}
+}
@@ -30,17 +30,27 @@
 #endif
 
 #include <sstream>
+#include <atomic>
+#include <unordered_set>
 #include <random>
+#include <future>
+#include <memory>
+#include <optional>
 
 #include "include/sl_hooks.h"
 #include "include/sl_version.h"
 #include "source/core/sl.api/internal.h"
 #include "source/core/sl.log/log.h"
 #include "source/core/sl.file/file.h"
+#include "source/core/sl.extra/startupTimeline.h"
+#include "source/core/sl.extra/perfStats.h"
+#include "source/core/sl.extra/hitches.h"
+#include "source/core/sl.extra/frameArena.h"
 #include "source/core/sl.param/parameters.h"
 #include "source/core/sl.plugin-manager/ota.h"
 #include "source/core/sl.plugin-manager/pluginManager.h"
 #include "source/core/sl.security/secureLoadLibrary.h"
+#include "source/core/sl.exception/exception.h"
 #include "source/core/sl.interposer/versions.h"
 #include "source/core/sl.interposer/hook.h"
 #include "source/plugins/sl.imgui/imgui.h"
@@ -61,6 +71,15 @@ enum class PluginManagerStatus
     ePluginsUnloaded
 };
 
+//! Resource creation hooks have filters and their own lists, see 'getResourceHooks'
+inline bool isResourceHook(uint32_t key)
+{
+    return key == (uint32_t)FunctionHookID::eID3D12Device_CreateCommittedResource ||
+           key == (uint32_t)FunctionHookID::eID3D12Device_CreatePlacedResource ||
+           key == (uint32_t)FunctionHookID::eID3D12Device_CreateReservedResource ||
+           key == (uint32_t)FunctionHookID::eVulkan_CreateImage;
+}
+
 class PluginManager : public IPluginManager
 {
 public:
@@ -94,6 +113,52 @@ public:
     {
         m_pref = pref;
         param::getInterface()->set(param::global::kPreferenceFlags, (uint64_t)m_pref.flags);
+        param::getInterface()->set(param::global::kPerfStats, (void*)getPerfStats());
+
+        // Initial state only, sl.common flips it at runtime via hot-key
+        std::string gpuMarkers;
+        bool enableGPUMarkers = extra::getEnvVar("SL_GPU_MARKERS", gpuMarkers) && std::atoi(gpuMarkers.c_str()) != 0;
+#ifndef SL_PRODUCTION
+        enableGPUMarkers |= sl::interposer::getInterface()->getConfig().gpuMarkers;
+#endif
+        m_gpuMarkers.store(enableGPUMarkers);
+        param::getInterface()->set(param::global::kGPUMarkers, (void*)&m_gpuMarkers);
+
+        // Waits shorter than the threshold are not recorded, environment wins over 'sl.interposer.json'
+        uint64_t hitchThresholdUs = extra::HitchRecorder::kDefaultThresholdUs;
+#ifndef SL_PRODUCTION
+        if (sl::interposer::getInterface()->getConfig().hitchThresholdUs)
+        {
+            hitchThresholdUs = sl::interposer::getInterface()->getConfig().hitchThresholdUs;
+        }
+#endif
+        std::string hitchThreshold;
+        if (extra::getEnvVar("SL_HITCH_THRESHOLD_US", hitchThreshold) && std::atoi(hitchThreshold.c_str()) > 0)
+        {
+            hitchThresholdUs = (uint64_t)std::atoi(hitchThreshold.c_str());
+        }
+        m_hitches.setThresholdUs(hitchThresholdUs);
+        extra::hitch::s_recorder = &m_hitches;
+        param::getInterface()->set(param::global::kHitchRecorder, (void*)&m_hitches);
+
+        // Frame arenas rewind after each present, allocation counting only does something with SL_TRACK_ALLOCATIONS=1
+        extra::frame::s_epoch = &m_perfStats.getEpoch();
+        extra::alloc::s_counter = &m_perfStats.getHeapAllocations();
+        param::getInterface()->set(param::global::kFrameEpoch, (void*)&m_perfStats.getEpoch());
+        param::getInterface()->set(param::global::kHeapAllocations, (void*)&m_perfStats.getHeapAllocations());
+
+        // Startup profiling can be requested via environment in any build or via 'sl.interposer.json' in development builds
+        std::string startupProfiler;
+        bool profileStartup = extra::getEnvVar("SL_STARTUP_PROFILER", startupProfiler) && std::atoi(startupProfiler.c_str()) != 0;
+#ifndef SL_PRODUCTION
+        profileStartup |= sl::interposer::getInterface()->getConfig().startupProfiler;
+#endif
+        if (profileStartup && !m_startupTimeline)
+        {
+            m_startupTimeline = std::make_unique<extra::StartupTimeline>();
+            m_startupTimelineReported = 0;
+            param::getInterface()->set(param::global::kStartupTimeline, (void*)static_cast<extra::IStartupTimeline*>(m_startupTimeline.get()));
+        }
 
         // Keep a copy since we need it later so host does not have keep these allocations around
         m_pathsToPlugins.resize(pref.numPathsToPlugins);
@@ -111,6 +176,22 @@ public:
         //! Moving forward, plugins will be developed independently and ids will be unknown to the interposer
 
         // Allow override via JSON config file
+        if (interposerConfig.d3d12DescriptorCount)
+        {
+            param::getInterface()->set(param::global::kD3D12DescriptorCount, interposerConfig.d3d12DescriptorCount);
+        }
+        if (interposerConfig.asyncCompute)
+        {
+            param::getInterface()->set(param::global::kAsyncCompute, interposerConfig.asyncCompute);
+        }
+        if (interposerConfig.d3d11LightweightState)
+        {
+            param::getInterface()->set(param::global::kD3D11LightweightState, interposerConfig.d3d11LightweightState);
+        }
+        if (interposerConfig.d3d12TrackBarrierStates)
+        {
+            param::getInterface()->set(param::global::kD3D12TrackBarrierStates, interposerConfig.d3d12TrackBarrierStates);
+        }
         if (interposerConfig.loadAllFeatures)
         {
             SL_LOG_HINT("Loading all features");
@@ -182,6 +263,8 @@ public:
     virtual bool isInitialized() const  override final { return s_status == PluginManagerStatus::ePluginsInitialized; }
     virtual bool arePluginsLoaded() const  override final { return s_status == PluginManagerStatus::ePluginsInitialized || s_status == PluginManagerStatus::ePluginsLoaded; }
 
+    virtual Result ensureFeatureStarted(Feature feature) override final;
+
     virtual bool isFeatureEnabled(Feature feature) const override final
     {
         auto it = m_featurePluginsMap.find(feature);
@@ -272,9 +355,36 @@ public:
         return !featureList.empty();
     }
 
+    virtual extra::IPerfStats* getPerfStats() override final
+    {
+        return &m_perfStats;
+    }
+
+    virtual const ResourceHookList& getResourceHooks(FunctionHookID functionHookID) override final
+    {
+        return m_activeHookTables.load(std::memory_order_acquire)->resource[(uint32_t)functionHookID];
+    }
+
+    virtual bool isHookDeclared(FunctionHookID functionHookID) const override final
+    {
+        return m_declaredHooks[(uint32_t)functionHookID];
+    }
+
     void populateLoaderJSON(uint32_t deviceType, json& config);
 
     std::mutex m_mtxPluginConfig;
+    std::mutex m_mtxLazyInit;
+
+    //! Only created when startup profiling is requested, see 'setPreferences'
+    std::unique_ptr<extra::StartupTimeline> m_startupTimeline;
+    size_t m_startupTimelineReported = 0;
+
+    //! Lives as long as the manager so interposer hooks can keep counting after 'unloadPlugins'
+    extra::PerfStats m_perfStats;
+    //! Shared with every chi instance through 'param::global::kGPUMarkers'
+    std::atomic<bool> m_gpuMarkers{};
+    //! Blocking waits over the threshold, shared through 'param::global::kHitchRecorder'
+    extra::HitchRecorder m_hitches{ &m_perfStats };
 
     inline static PluginManager* s_manager = {};
 
@@ -313,12 +423,44 @@ private:
         std::vector<std::string> exclusiveHooks;
         std::vector<std::string> incompatiblePlugins;
         FeatureContext context{};
-    };
+        //! Loaded but 'slOnPluginStartup' not called yet, no hooks are mapped
+        bool startupDeferred = false;
+        //! Shut down while unloaded, see PreferenceFlags::eReleaseUnloadedFeatures, library stays resident
+        bool released = false;
 
-    bool loadPlugin(const fs::path path, Plugin **ppPlugin);
+        //! Parsed once from the 'hooks' JSON at load time, hook lists are rebuilt from these
+        struct Hook
+        {
+            std::string cls{};
+            std::string target{};
+            std::string fullName{};
+            std::string replacement{};
+            std::string base{};
+            bool supported = false;
+            uint32_t key{};
+            void* address{};
+            //! Resource creation hooks only
+            ResourceHookFilter filter{};
+        };
+        std::vector<Hook> hooks;
+    };
 
-    void processPluginHooks(const Plugin* plugin);
+    bool loadPlugin(const fs::path path, Plugin **ppPlugin, HANDLE verifiedFile = INVALID_HANDLE_VALUE);
+
+    void parsePluginHooks(Plugin* plugin);
+    void parseResourceHookFilter(const Plugin* plugin, const json& config, ResourceHookFilter& filter);
+    struct HookTables;
+    void processPluginHooks(const Plugin* plugin, HookTables& tables);
+    void rebuildHookLists();
+    void publishHookTables(std::unique_ptr<HookTables> tables);
+    bool startPlugin(Plugin* plugin, const std::string& configStr, void* device);
+    Result startDeferredPlugin(Plugin* plugin);
+    Result releasePlugin(Plugin* plugin);
+    Result restartPlugin(Plugin* plugin);
     void mapPluginCallbacks(Plugin* plugin);
+    void updateHookCoverage();
+    void lazyInitializePlugins();
+    void reportStartupTimeline();
     uint32_t getFunctionHookID(const std::string& name);
 
     Plugin* isPluginLoaded(const std::string& name) const;
@@ -329,8 +471,26 @@ private:
     Version m_version = { 0,0,1 };
     Version m_api = { 0,0,1 };
 
-    HookList m_beforeHooks[(uint32_t)FunctionHookID::eMaxNum];
-    HookList m_afterHooks[(uint32_t)FunctionHookID::eMaxNum];
+    struct HookTables
+    {
+        HookList before[(uint32_t)FunctionHookID::eMaxNum];
+        HookList after[(uint32_t)FunctionHookID::eMaxNum];
+        //! Only resource creation IDs are populated, these never go into 'after'
+        ResourceHookList resource[(uint32_t)FunctionHookID::eMaxNum];
+    };
+    //! Hooks fire on host threads while features are (un)loaded, so tables are built aside and published with
+    //! a single pointer swap. Hook getters hand out references, replaced tables are kept until plugins unload.
+    std::mutex m_mtxHookTables;
+    std::vector<std::unique_ptr<HookTables>> m_hookTables;
+    std::atomic<const HookTables*> m_activeHookTables{};
+
+    //! What plugins were started with, kept for features started on first use
+    VkDevices m_startupVkDevices{};
+    void* m_startupDevice{};
+    //! Lets per-feature APIs skip the lock once everything is started
+    std::atomic<uint32_t> m_deferredStartupCount = 0;
+    std::string m_startupConfigStr{};
+    json m_initializedConfig{};
 
     ID3D12Device* m_d3d12Device = {};
     ID3D11Device* m_d3d11Device = {};
@@ -343,6 +503,11 @@ private:
     using PluginList = std::vector<Plugin*>;
     PluginList m_plugins;
 
+    //! Classes hooked by any loaded plugin, enabled or not, so proxies created now still serve plugins enabled later
+    std::unordered_set<std::string> m_hookedClasses;
+    //! Same as above per hook, lets the Vulkan wrapper hand out driver entry points for functions nobody hooks
+    bool m_declaredHooks[(uint32_t)FunctionHookID::eMaxNum]{};
+
     using PluginMap = std::map<Feature,Plugin*>;
     using ConfigMap = std::map<Feature, json>;
     using FeatureSupportedMap = std::map<Feature, Result>;
@@ -352,7 +517,7 @@ private:
     FeatureSupportedMap m_featureSupportedMap;
 
     int m_appId = 0;
-    inline static PluginManagerStatus s_status = PluginManagerStatus::eUnknown;
+    inline static std::atomic<PluginManagerStatus> s_status = PluginManagerStatus::eUnknown;
 
     EngineType m_engine = EngineType::eCustom;
     std::string m_engineVersion{};
@@ -425,14 +590,9 @@ PluginManager::Plugin* PluginManager::isExclusiveHookUsed(const Plugin* exclusiv
     {
         if (plugin == exclusivePlugin) continue;
 
-        auto hooks = plugin->config.at("hooks");
-        for (auto hook : hooks)
+        for (auto& hook : plugin->hooks)
         {
-            std::string cls, target;
-            hook.at("class").get_to(cls);
-            hook.at("target").get_to(target);
-            auto fullName = cls + "_" + target;
-            if (fullName == exclusiveHook) return plugin;
+            if (hook.fullName == exclusiveHook) return plugin;
         }
     }
     return nullptr;
@@ -440,17 +600,29 @@ PluginManager::Plugin* PluginManager::isExclusiveHookUsed(const Plugin* exclusiv
 
 bool PluginManager::isProxyNeeded(const char* className)
 {
+    // Called on every object creation so no walking the plugin JSON here
+    return m_hookedClasses.find(className) != m_hookedClasses.end();
+}
+
+void PluginManager::updateHookCoverage()
+{
+    m_hookedClasses.clear();
+    std::fill(std::begin(m_declaredHooks), std::end(m_declaredHooks), false);
     for (auto plugin : m_plugins)
     {
-        auto hooks = plugin->config.at("hooks");
-        for (auto hook : hooks)
+        for (auto& hook : plugin->hooks)
         {
-            std::string cls;
-            hook.at("class").get_to(cls);
-            if (cls == className) return true;
+            m_hookedClasses.insert(hook.cls);
+            if (hook.supported)
+            {
+                m_declaredHooks[hook.key] = true;
+            }
         }
     }
-    return false;
+    for (auto& cls : m_hookedClasses)
+    {
+        SL_LOG_VERBOSE("Class '%s' is hooked by at least one plugin", cls.c_str());
+    }
 }
 
 Result PluginManager::setFeatureEnabled(Feature feature, bool value)
@@ -486,8 +658,13 @@ Result PluginManager::setFeatureEnabled(Feature feature, bool value)
     }
     ctx.enabled = value;
     SL_LOG_INFO("Feature '%s' %s", getFeatureAsStr(feature), value ? "loaded" : "unloaded");
-    auto hooks = (*it).second->config.at("hooks");
-    if (!hooks.empty())
+    if ((m_pref.flags & PreferenceFlags::eReleaseUnloadedFeatures) && s_status == PluginManagerStatus::ePluginsInitialized)
+    {
+        // Both paths rebuild the hook lists
+        std::scoped_lock lock(m_mtxPluginConfig);
+        return value ? restartPlugin((*it).second) : releasePlugin((*it).second);
+    }
+    if (!(*it).second->hooks.empty())
     {
         // Plugin has registered hooks, need to redo our prioritized hook lists
         // 
@@ -495,25 +672,29 @@ Result PluginManager::setFeatureEnabled(Feature feature, bool value)
         // we could leave the lists intact and check for each hook if plugin 
         // is enabled or not but that is very expensive when hooks are accessed 
         // hundreds of times per frame.
-
-        for (auto& hooks : m_afterHooks)
-        {
-            hooks.clear();
-        }
-        for (auto& hooks : m_beforeHooks)
-        {
-            hooks.clear();
-        }
-
-        // Sorted by priority so processing hooks by priority
-        for (auto plugin : m_plugins)
-        {
-            processPluginHooks(plugin);
-        }
+        rebuildHookLists();
     }
     return Result::eOk;
 }
 
+void PluginManager::rebuildHookLists()
+{
+    // Sorted by priority so processing hooks by priority
+    auto tables = std::make_unique<HookTables>();
+    for (auto plugin : m_plugins)
+    {
+        processPluginHooks(plugin, *tables);
+    }
+    publishHookTables(std::move(tables));
+}
+
+void PluginManager::publishHookTables(std::unique_ptr<HookTables> tables)
+{
+    std::scoped_lock lock(m_mtxHookTables);
+    m_activeHookTables.store(tables.get(), std::memory_order_release);
+    m_hookTables.push_back(std::move(tables));
+}
+
 Result PluginManager::findPlugins(const fs::path& directory, std::vector<fs::path>& files)
 {
 #ifdef SL_WINDOWS
@@ -553,7 +734,7 @@ Result PluginManager::findPlugins(const fs::path& directory, std::vector<fs::pat
     return files.empty() ? Result::eErrorNoPlugins : Result::eOk;
 }
 
-bool PluginManager::loadPlugin(const fs::path pluginFullPath, Plugin **ppPlugin)
+bool PluginManager::loadPlugin(const fs::path pluginFullPath, Plugin **ppPlugin, HANDLE verifiedFile)
 {
     auto freePlugin = [](Plugin** plugin)->void
     {
@@ -562,7 +743,7 @@ bool PluginManager::loadPlugin(const fs::path pluginFullPath, Plugin **ppPlugin)
         *plugin = nullptr;
     };
 
-    HMODULE mod = security::loadLibrary(pluginFullPath.c_str());
+    HMODULE mod = security::loadLibrary(pluginFullPath.c_str(), verifiedFile);
     if (!mod)
     {
         return false;
@@ -572,6 +753,9 @@ bool PluginManager::loadPlugin(const fs::path pluginFullPath, Plugin **ppPlugin)
     plugin->fullpath = pluginFullPath;
     plugin->filename = pluginFullPath.stem();
     plugin->lib = mod;
+#ifdef SL_ENABLE_EXCEPTION_HANDLING
+    exception::getInterface()->addModule(mod);
+#endif
     plugin->getFunction = reinterpret_cast<api::PFuncGetPluginFunction*>(GetProcAddress(mod, "slGetPluginFunction"));
     if (plugin->getFunction)
     {
@@ -597,6 +781,8 @@ bool PluginManager::loadPlugin(const fs::path pluginFullPath, Plugin **ppPlugin)
         populateLoaderJSON((uint32_t)m_pref.renderAPI, loaderJSON);
         auto loaderJSONStr = loaderJSON.dump();
         const char* pluginJSONText{};
+        auto onLoadPhase = "slOnPluginLoad " + plugin->filename.string();
+        extra::ScopedStartupPhase phase(m_startupTimeline.get(), onLoadPhase.c_str());
         if (!plugin->onLoad(parameters, loaderJSONStr.c_str(), &pluginJSONText))
         {
             SL_LOG_ERROR( "Ignoring '%ls' since core API 'onPluginLoad' failed", plugin->filename.wstring().c_str());
@@ -627,6 +813,7 @@ bool PluginManager::loadPlugin(const fs::path pluginFullPath, Plugin **ppPlugin)
         plugin->config.at("api").at("major").get_to(plugin->api.major);
         plugin->config.at("api").at("minor").get_to(plugin->api.minor);
         plugin->config.at("api").at("build").get_to(plugin->api.build);
+        parsePluginHooks(plugin);
 
         // Let the host know about API, priority etc. 
         // Plugin has already populated OS, driver and other custom requirements.
@@ -657,6 +844,8 @@ Result PluginManager::mapPlugins(std::vector<fs::path>& files)
 {
     using namespace sl::api;
 
+    SL_STARTUP_PHASE(m_startupTimeline.get(), "mapPlugins");
+
     auto freePlugin = [](Plugin** plugin)->void
     {
         FreeLibrary((*plugin)->lib);
@@ -664,11 +853,32 @@ Result PluginManager::mapPlugins(std::vector<fs::path>& files)
         *plugin = nullptr;
     };
 
-    for (auto pluginFullPath : files)
+    // Signature checks dominate load time on cold caches and are independent of each other so run them all up front.
+    // Loading itself stays serial and in order since plugins can set global state in 'slOnPluginLoad'.
+    // NOTE: First check runs alone, it lazily resolves the crypt32/wintrust entry points which is not thread safe.
+    // Each check hands back the file locked against writes, loading from it means the verified file is the one mapped.
+    std::vector<std::future<HANDLE>> verified;
+    verified.reserve(files.size());
+    for (auto& pluginFullPath : files)
+    {
+        auto policy = verified.empty() ? std::launch::deferred : std::launch::async;
+        verified.push_back(std::async(policy, [pluginFullPath]()->HANDLE { return security::verifyLibrary(pluginFullPath.c_str()); }));
+        if (verified.size() == 1) verified[0].wait();
+    }
+
+    for (size_t i = 0; i < files.size(); i++)
     {
+        auto& pluginFullPath = files[i];
+        HANDLE verifiedFile = verified[i].get();
+        if (verifiedFile == INVALID_HANDLE_VALUE)
+        {
+            SL_LOG_WARN("Ignoring plugin '%ls' since its signature could not be verified", pluginFullPath.wstring().c_str());
+            continue;
+        }
+
         // From this point any error is fatal since user requested specific set of features
         Plugin *plugin = nullptr;
-        if (loadPlugin(pluginFullPath, &plugin))
+        if (loadPlugin(pluginFullPath, &plugin, verifiedFile))
         {
             auto& extCfg = m_featureExternalConfigMap[plugin->id];
             Plugin *duplicatedPluginById = nullptr;
@@ -848,6 +1058,8 @@ Result PluginManager::loadPlugins()
 
     std::scoped_lock lock(m_mtxPluginConfig);
 
+    SL_STARTUP_PHASE(m_startupTimeline.get(), "loadPlugins");
+
     if (s_status == PluginManagerStatus::ePluginsLoaded)
     {
         // Nothing to do, already loaded everything
@@ -879,13 +1091,12 @@ Result PluginManager::loadPlugins()
 
 #if defined(SL_PRODUCTION)
     // On production builds kickoff OTA update, this function internally will
-    // check OTA preferences
+    // check OTA preferences. Only the manifest is read here since loading
+    // OTA'd plugins below depends on it, the update check itself runs in the
+    // background and anything it downloads is used on the next launch.
     m_ota->readServerManifest();
     bool requestOptionalUpdates = (m_pref.flags & PreferenceFlags::eAllowOTA);
-    for (Feature f : m_featuresToLoad)
-    {
-        m_ota->checkForOTA(f, m_api, requestOptionalUpdates);
-    }
+    m_ota->checkForOTAAsync(m_featuresToLoad, m_api, requestOptionalUpdates);
 #endif
 
     //! Now let's enumerate SL plugins!
@@ -1077,6 +1288,7 @@ Result PluginManager::loadPlugins()
             m_featurePluginsMap[plugin->id] = plugin;
         }
     }
+    updateHookCoverage();
     return m_plugins.empty() ? Result::eErrorNoPlugins : Result::eOk;
 }
 
@@ -1084,6 +1296,12 @@ Result PluginManager::unloadPlugins()
 {
     SL_LOG_INFO("Unloading all plugins ...");
 
+    // Background OTA check must not outlive the log and the manager
+    m_ota->shutdown();
+
+    // Hooks firing on other threads must stop reaching into plugins before they are unloaded
+    publishHookTables(std::make_unique<HookTables>());
+
     // IMPORTANT: Shut down in the opposite order lower priority to higher
     for (auto plugin = m_plugins.rbegin(); plugin != m_plugins.rend(); plugin++)
     {
@@ -1095,78 +1313,165 @@ Result PluginManager::unloadPlugins()
         delete (*plugin);
     }
     m_plugins.clear();
+    m_deferredStartupCount = 0;
+    m_hookedClasses.clear();
+    std::fill(std::begin(m_declaredHooks), std::end(m_declaredHooks), false);
     m_featurePluginsMap.clear();
     m_featureExternalConfigMap.clear();
     m_featureSupportedMap.clear();
-    for (auto& hooks : m_afterHooks)
     {
-        hooks.clear();
-    }
-    for (auto& hooks : m_beforeHooks)
-    {
-        hooks.clear();
+        // Only the empty table published above is still active
+        std::scoped_lock lock(m_mtxHookTables);
+        m_hookTables.erase(m_hookTables.begin(), m_hookTables.end() - 1);
     }
     m_externalJSONConfigs.clear();
 
+    // Plugins started on first use are only in the timeline at this point
+    reportStartupTimeline();
+    m_startupTimeline.reset();
+    param::getInterface()->set(param::global::kStartupTimeline, (void*)nullptr);
+    param::getInterface()->set(param::global::kPerfStats, (void*)nullptr);
+    param::getInterface()->set(param::global::kGPUMarkers, (void*)nullptr);
+    param::getInterface()->set(param::global::kHitchRecorder, (void*)nullptr);
+    extra::hitch::s_recorder = nullptr;
+    param::getInterface()->set(param::global::kFrameEpoch, (void*)nullptr);
+    param::getInterface()->set(param::global::kHeapAllocations, (void*)nullptr);
+    extra::frame::s_epoch = nullptr;
+    extra::alloc::s_counter = nullptr;
+
     // After shutdown any hook triggers will be ignored
     s_status = PluginManagerStatus::ePluginsUnloaded;
 
     return sl::Result::eOk;
 }
 
-void PluginManager::processPluginHooks(const Plugin* plugin)
+void PluginManager::parsePluginHooks(Plugin* plugin)
 {
-    // Make sure that whatever is requested by a plugin is actually supported by our interposer
-    auto isHookSupported = [this](const std::string& requestedClass, const std::string& requestedTarget)->bool
+    const auto& hooks = plugin->config.at("hooks");
+    plugin->hooks.clear();
+    plugin->hooks.reserve(hooks.size());
+    for (auto& hook : hooks)
     {
-        return m_functionHookIDMap.find(requestedClass + "_" + requestedTarget) != m_functionHookIDMap.end();
+        Plugin::Hook h{};
+        hook.at("class").get_to(h.cls);
+        hook.at("target").get_to(h.target);
+        hook.at("replacement").get_to(h.replacement);
+        hook.at("base").get_to(h.base);
+        h.fullName = h.cls + "_" + h.target;
+        // Make sure that whatever is requested by a plugin is actually supported by our interposer
+        auto it = m_functionHookIDMap.find(h.fullName);
+        h.supported = it != m_functionHookIDMap.end();
+        if (h.supported)
+        {
+            h.key = (uint32_t)it->second;
+            h.address = plugin->getFunction(h.replacement.c_str());
+            if (isResourceHook(h.key))
+            {
+                if (hook.contains("filter"))
+                {
+                    parseResourceHookFilter(plugin, hook.at("filter"), h.filter);
+                }
+                else
+                {
+                    SL_LOG_WARN("Hook %s:%s has no filter, it will be invoked for every resource the engine creates", plugin->name.c_str(), h.replacement.c_str());
+                }
+            }
+        }
+        plugin->hooks.push_back(std::move(h));
+    }
+}
+
+void PluginManager::parseResourceHookFilter(const Plugin* plugin, const json& config, ResourceHookFilter& filter)
+{
+    // D3D12_RESOURCE_DIMENSION and D3D12_RESOURCE_FLAGS values
+    static const std::map<std::string, uint32_t> kDimensions =
+    {
+        {"buffer", 1}, {"texture1d", 2}, {"texture2d", 3}, {"texture3d", 4}
+    };
+    static const std::map<std::string, uint32_t> kFlags =
+    {
+        {"allow_render_target", 0x1}, {"allow_depth_stencil", 0x2}, {"allow_unordered_access", 0x4},
+        {"allow_cross_adapter", 0x10}, {"allow_simultaneous_access", 0x20}
+    };
+    auto parseNames = [plugin](const json& names, const std::map<std::string, uint32_t>& values, bool asBits)->uint32_t
+    {
+        uint32_t mask = 0;
+        for (auto& name : names)
+        {
+            auto it = values.find(name.get<std::string>());
+            if (it == values.end())
+            {
+                SL_LOG_WARN("Plugin '%s' uses unknown resource hook filter value '%s'", plugin->name.c_str(), name.get<std::string>().c_str());
+                continue;
+            }
+            mask |= asBits ? 1u << (*it).second : (*it).second;
+        }
+        return mask;
     };
+    if (config.contains("dimensions")) filter.dimensions = parseNames(config.at("dimensions"), kDimensions, true);
+    if (config.contains("flags")) filter.anyFlags = parseNames(config.at("flags"), kFlags, false);
+    if (config.contains("minWidth")) config.at("minWidth").get_to(filter.minWidth);
+    if (config.contains("minHeight")) config.at("minHeight").get_to(filter.minHeight);
+}
 
+void PluginManager::processPluginHooks(const Plugin* plugin, HookTables& tables)
+{
     if (!plugin->context.enabled)
     {
         SL_LOG_INFO("Plugin '%s' is disabled, not mapping any hooks for it", plugin->name.c_str());
         return;
     }
+    if (plugin->startupDeferred)
+    {
+        SL_LOG_INFO("Plugin '%s' is not started yet, not mapping any hooks for it", plugin->name.c_str());
+        return;
+    }
 
-    auto hooks = plugin->config.at("hooks");
-    if (hooks.empty())
+    if (plugin->hooks.empty())
     {
         SL_LOG_INFO("Plugin '%s' has no registered hooks", plugin->name.c_str());
     }
 
-    for (auto hook : hooks)
+    for (auto& hook : plugin->hooks)
     {
-        std::string cls, target, replacement, base;
-        hook.at("class").get_to(cls);
-        hook.at("target").get_to(target);
-        hook.at("replacement").get_to(replacement);
-        hook.at("base").get_to(base);
+        auto& replacement = hook.replacement;
+        auto& base = hook.base;
 
         // Skip hooks for unused APIs
-        bool clsVulkan = cls == "Vulkan";
+        bool clsVulkan = hook.cls == "Vulkan";
         if ((getVulkanDevice() && !clsVulkan) || (!getVulkanDevice() && clsVulkan))
         {
             SL_LOG_INFO("Hook %s:%s:%s - skipped", plugin->name.c_str(), replacement.c_str(), base.c_str());
             continue;
         }
 
-        if (!isHookSupported(cls, target))
+        if (!hook.supported)
         {
-            SL_LOG_WARN( "Hook %s:%s:%s is NOT supported, plugin will not function properly", plugin->name.c_str(), cls.c_str(), target.c_str());
+            SL_LOG_WARN( "Hook %s:%s:%s is NOT supported, plugin will not function properly", plugin->name.c_str(), hook.cls.c_str(), hook.target.c_str());
             continue;
         }
 
-        void* address = plugin->getFunction(replacement.c_str());
-        if (!address)
+        if (!hook.address)
         {
             SL_LOG_ERROR( "Failed to obtain replacement address for %s in module %s", replacement.c_str(), plugin->name.c_str());
             continue;
         }
 
+        if (isResourceHook(hook.key))
+        {
+            if (base != "after")
+            {
+                SL_LOG_WARN("Hook %s:%s:%s - resource creation can only be hooked after the base call", plugin->name.c_str(), replacement.c_str(), base.c_str());
+                continue;
+            }
+            tables.resource[hook.key].push_back({ hook.address, (Feature)plugin->id, hook.filter });
+            SL_LOG_INFO("Hook %s:%s:%s - OK (filtered)", plugin->name.c_str(), replacement.c_str(), base.c_str());
+            continue;
+        }
+
         // Two options here, hook before or after the base call.
-        auto key = getFunctionHookID(cls + "_" + target);
-        auto& list = base == "after" ? m_afterHooks[key] : m_beforeHooks[key];
-        std::pair pair = { address, (Feature)plugin->id };
+        auto& list = base == "after" ? tables.after[hook.key] : tables.before[hook.key];
+        std::pair pair = { hook.address, (Feature)plugin->id };
         if (std::find(list.begin(), list.end(), pair) == list.end())
         {
             list.push_back(pair);
@@ -1225,6 +1530,9 @@ Result PluginManager::initializePlugins()
     {
         std::scoped_lock lock(m_mtxPluginConfig);
 
+        std::optional<extra::ScopedStartupPhase> phase;
+        phase.emplace(m_startupTimeline.get(), "initializePlugins");
+
         if (!m_d3d12Device && !m_vkDevice && !m_d3d11Device)
         {
             SL_LOG_ERROR("D3D or VK API hook is activated without device being created, did you forget to call `slSetD3DDevice` or `slSetVulkanInfo` or trying to use another SL API before setting the device?");
@@ -1239,8 +1547,8 @@ Result PluginManager::initializePlugins()
 
         // Default to VK
         uint32_t deviceType = (uint32_t)RenderAPI::eVulkan;
-        VkDevices vk = { m_vkInstance, m_vkDevice, m_vkPhysicalDevice };
-        void* device = &vk;
+        m_startupVkDevices = { m_vkInstance, m_vkDevice, m_vkPhysicalDevice };
+        void* device = &m_startupVkDevices;
 
         if (m_d3d12Device)
         {
@@ -1262,52 +1570,52 @@ Result PluginManager::initializePlugins()
 
         param::IParameters* parameters = param::getInterface();
 
+        m_startupDevice = device;
+        m_startupConfigStr = configStr;
+
+        // Plugins others depend on must be up front, everything else can wait for the host to use it
+        const bool deferStartup = m_pref.flags & PreferenceFlags::eDeferFeatureStartup;
+        const bool releaseUnloaded = m_pref.flags & PreferenceFlags::eReleaseUnloadedFeatures;
+        std::unordered_set<std::string> requiredPlugins;
+        for (auto plugin : m_plugins)
+        {
+            requiredPlugins.insert(plugin->requiredPlugins.begin(), plugin->requiredPlugins.end());
+        }
+
+        auto tables = std::make_unique<HookTables>();
         auto plugins = m_plugins;
         for (auto plugin : plugins)
         {
-            auto& extCfg = m_featureExternalConfigMap[plugin->id];
-
-            plugin->onStartup = reinterpret_cast<api::PFuncOnPluginStartup*>(plugin->getFunction("slOnPluginStartup"));
-            plugin->onShutdown = reinterpret_cast<api::PFuncOnPluginShutdown*>(plugin->getFunction("slOnPluginShutdown"));
-            plugin->onPluginsInitialized = reinterpret_cast<api::PFuncOnPluginsInitialized*>(plugin->getFunction("slOnPluginsInitialized"));
-            bool unload = false;
-            if (!plugin->onStartup || !plugin->onShutdown)
+            if (deferStartup && plugin->name != "sl.common" && requiredPlugins.find(plugin->name) == requiredPlugins.end())
             {
-                unload = true;
-                SL_LOG_ERROR( "onStartup/onShutdown missing for plugin %s", plugin->name.c_str());
-                extCfg["feature"]["lastError"] = "Error: core API not found in the plugin";
-            }
-            else if (!plugin->onStartup(configStr.c_str(), device))
-            {
-                unload = true;
-                extCfg["feature"]["lastError"] = "Error: onStartup failed";
+                SL_LOG_INFO("Deferring startup of plugin '%s' until its feature is first used", plugin->name.c_str());
+                plugin->startupDeferred = true;
+                m_deferredStartupCount++;
+                continue;
             }
-            if (unload)
+            if (releaseUnloaded && !plugin->context.enabled && plugin->name != "sl.common" && requiredPlugins.find(plugin->name) == requiredPlugins.end())
             {
-                extCfg["feature"]["unloaded"] = true;
-                extCfg["feature"]["supported"] = false;
-                m_featurePluginsMap.erase(plugin->id);
-                FreeLibrary(plugin->lib);
-                m_plugins.erase(std::remove(m_plugins.begin(), m_plugins.end(), plugin), m_plugins.end());
-                delete plugin;
-                
+                SL_LOG_INFO("Plugin '%s' is unloaded, not starting it until its feature is loaded", plugin->name.c_str());
+                plugin->startupDeferred = true;
+                plugin->released = true;
                 continue;
             }
-            else
+            if (!startPlugin(plugin, configStr, device))
             {
-                // Plugin initialized correctly, let's map callbacks for the core API
-                mapPluginCallbacks(plugin);
-                // Let other plugins know that this plugin is loaded and supported and on which adapters
-                auto supportedAdaptersParam = "sl.param." + plugin->paramNamespace + ".supportedAdapters";
-                parameters->set(supportedAdaptersParam.c_str(), plugin->context.supportedAdapters);
-                config["active_features"][sl::getFeatureAsStr(plugin->id)]["supportedAdapters"] = plugin->context.supportedAdapters;
+                continue;
             }
-            processPluginHooks(plugin);
+            config["active_features"][sl::getFeatureAsStr(plugin->id)]["supportedAdapters"] = plugin->context.supportedAdapters;
+            processPluginHooks(plugin, *tables);
         }
+        publishHookTables(std::move(tables));
+
+        // Plugins which failed to start no longer need proxies
+        updateHookCoverage();
 
         // Post init phase
         {
             // Config now contains list of active and initialized features with their supported adapters
+            m_initializedConfig = config;
             configStr = config.dump(1, ' ', false, json::error_handler_t::replace);
             for (auto plugin : m_plugins)
             {
@@ -1336,6 +1644,9 @@ Result PluginManager::initializePlugins()
             ui->registerRenderCallbacks(renderUI, nullptr);
         }
 
+        phase.reset();
+        reportStartupTimeline();
+
         s_status = PluginManagerStatus::ePluginsInitialized;
     }
     else if (s_status == PluginManagerStatus::ePluginsInitialized)
@@ -1352,6 +1663,179 @@ Result PluginManager::initializePlugins()
     return Result::eOk;
 }
 
+bool PluginManager::startPlugin(Plugin* plugin, const std::string& configStr, void* device)
+{
+    auto& extCfg = m_featureExternalConfigMap[plugin->id];
+
+    plugin->onStartup = reinterpret_cast<api::PFuncOnPluginStartup*>(plugin->getFunction("slOnPluginStartup"));
+    plugin->onShutdown = reinterpret_cast<api::PFuncOnPluginShutdown*>(plugin->getFunction("slOnPluginShutdown"));
+    plugin->onPluginsInitialized = reinterpret_cast<api::PFuncOnPluginsInitialized*>(plugin->getFunction("slOnPluginsInitialized"));
+    bool unload = false;
+    if (!plugin->onStartup || !plugin->onShutdown)
+    {
+        unload = true;
+        SL_LOG_ERROR( "onStartup/onShutdown missing for plugin %s", plugin->name.c_str());
+        extCfg["feature"]["lastError"] = "Error: core API not found in the plugin";
+    }
+    else
+    {
+        auto onStartupPhase = "slOnPluginStartup " + plugin->name;
+        extra::ScopedStartupPhase phase(m_startupTimeline.get(), onStartupPhase.c_str());
+        if (!plugin->onStartup(configStr.c_str(), device))
+        {
+            unload = true;
+            extCfg["feature"]["lastError"] = "Error: onStartup failed";
+        }
+    }
+    if (unload)
+    {
+        extCfg["feature"]["unloaded"] = true;
+        extCfg["feature"]["supported"] = false;
+        m_featurePluginsMap.erase(plugin->id);
+        FreeLibrary(plugin->lib);
+        m_plugins.erase(std::remove(m_plugins.begin(), m_plugins.end(), plugin), m_plugins.end());
+        delete plugin;
+        return false;
+    }
+
+    // Plugin initialized correctly, let's map callbacks for the core API
+    mapPluginCallbacks(plugin);
+    // Let other plugins know that this plugin is loaded and supported and on which adapters
+    auto supportedAdaptersParam = "sl.param." + plugin->paramNamespace + ".supportedAdapters";
+    param::getInterface()->set(supportedAdaptersParam.c_str(), plugin->context.supportedAdapters);
+    return true;
+}
+
+Result PluginManager::ensureFeatureStarted(Feature feature)
+{
+    if (m_deferredStartupCount.load() == 0 || s_status != PluginManagerStatus::ePluginsInitialized)
+    {
+        return Result::eOk;
+    }
+
+    std::scoped_lock lock(m_mtxPluginConfig);
+
+    auto it = m_featurePluginsMap.find(feature);
+    // Released plugins only come back via 'slSetFeatureLoaded'
+    if (it == m_featurePluginsMap.end() || !(*it).second->startupDeferred || (*it).second->released)
+    {
+        return Result::eOk;
+    }
+
+    SL_LOG_INFO("Starting plugin '%s' on first use", (*it).second->name.c_str());
+    return startDeferredPlugin((*it).second);
+}
+
+Result PluginManager::startDeferredPlugin(Plugin* plugin)
+{
+    // Released plugins are not counted so per-feature API calls stay lock free while they are unloaded
+    if (!plugin->released)
+    {
+        m_deferredStartupCount--;
+    }
+    plugin->startupDeferred = false;
+    plugin->released = false;
+    if (!startPlugin(plugin, m_startupConfigStr, m_startupDevice))
+    {
+        updateHookCoverage();
+        return Result::eErrorFeatureFailedToLoad;
+    }
+
+    // Same as setFeatureEnabled, hooks already in flight keep walking the previous tables
+    rebuildHookLists();
+
+    m_initializedConfig["active_features"][sl::getFeatureAsStr(plugin->id)]["supportedAdapters"] = plugin->context.supportedAdapters;
+    if (plugin->onPluginsInitialized)
+    {
+        auto configStr = m_initializedConfig.dump(1, ' ', false, json::error_handler_t::replace);
+        plugin->onPluginsInitialized(configStr.c_str());
+    }
+    return Result::eOk;
+}
+
+Result PluginManager::releasePlugin(Plugin* plugin)
+{
+    // Plugin is disabled at this point so it is no longer in the rebuilt lists,
+    // nothing routes into it while it shuts down.
+    rebuildHookLists();
+
+    if (plugin->startupDeferred)
+    {
+        // Never started, nothing to release
+        if (!plugin->released)
+        {
+            plugin->released = true;
+            m_deferredStartupCount--;
+        }
+        return Result::eOk;
+    }
+    if (plugin->name == "sl.common")
+    {
+        SL_LOG_WARN("Plugin 'sl.common' is required by all features, keeping it resident");
+        return Result::eOk;
+    }
+    for (auto other : m_plugins)
+    {
+        if (other != plugin && !other->startupDeferred &&
+            std::find(other->requiredPlugins.begin(), other->requiredPlugins.end(), plugin->name) != other->requiredPlugins.end())
+        {
+            SL_LOG_WARN("Plugin '%s' is required by '%s', keeping it resident", plugin->name.c_str(), other->name.c_str());
+            return Result::eOk;
+        }
+    }
+
+    // Plugin frees its resources, NGX features and VRAM segment allocations here
+    SL_LOG_INFO("Releasing plugin '%s'", plugin->name.c_str());
+    plugin->onShutdown();
+
+    // Everything mapped in 'startPlugin' points at state which is gone now, library itself stays
+    // resident so function pointers host obtained via 'slGetFeatureFunction' remain valid.
+    auto context = plugin->context;
+    plugin->context = {};
+    plugin->context.enabled = false;
+    plugin->context.supportedAdapters = context.supportedAdapters;
+    plugin->context.getFunction = context.getFunction;
+    plugin->context.isSupported = context.isSupported;
+    plugin->onStartup = {};
+    plugin->onShutdown = {};
+    plugin->onPluginsInitialized = {};
+    plugin->startupDeferred = true;
+    plugin->released = true;
+    if (m_initializedConfig.contains("active_features"))
+    {
+        m_initializedConfig["active_features"].erase(sl::getFeatureAsStr(plugin->id));
+    }
+    return Result::eOk;
+}
+
+Result PluginManager::restartPlugin(Plugin* plugin)
+{
+    if (!plugin->startupDeferred)
+    {
+        // Kept resident, only hooks need remapping
+        rebuildHookLists();
+        return Result::eOk;
+    }
+
+    if (plugin->released)
+    {
+        // 'slOnPluginShutdown' destroyed the plugin's context so load again for a clean one
+        json loaderJSON;
+        populateLoaderJSON((uint32_t)m_pref.renderAPI, loaderJSON);
+        auto loaderJSONStr = loaderJSON.dump();
+        const char* pluginJSONText{};
+        if (!plugin->onLoad(param::getInterface(), loaderJSONStr.c_str(), &pluginJSONText))
+        {
+            SL_LOG_ERROR("Failed to reload plugin '%s'", plugin->name.c_str());
+            plugin->context.enabled = false;
+            return Result::eErrorFeatureFailedToLoad;
+        }
+    }
+
+    SL_LOG_INFO("Restarting plugin '%s'", plugin->name.c_str());
+    return startDeferredPlugin(plugin);
+}
+
 void PluginManager::mapPluginCallbacks(Plugin* plugin)
 {
     plugin->context.initialized = true;
@@ -1374,42 +1858,76 @@ void PluginManager::mapPluginCallbacks(Plugin* plugin)
     SL_LOG_INFO("Callback %s:slSetConsts:0x%llx", plugin->name.c_str(), plugin->context.setConstants);
 }
 
-const HookList& PluginManager::getBeforeHooks(FunctionHookID functionHookID)
+void PluginManager::reportStartupTimeline()
 {
-    // Lazy plugin initialization because of the late device initialization
-    if (s_status == PluginManagerStatus::ePluginsLoaded)
+    if (!m_startupTimeline || m_startupTimeline->getEventCount() == m_startupTimelineReported)
     {
-        initializePlugins();
+        return;
     }
-    else if(s_status == PluginManagerStatus::eUnknown)
+    m_startupTimelineReported = m_startupTimeline->getEventCount();
+
+    SL_LOG_INFO("Startup timeline:");
+    for (auto& line : m_startupTimeline->getSummary())
     {
-        SL_LOG_ERROR( "Please make sure to call slInit before calling DXGI/D3D/Vulkan API");
+        SL_LOG_INFO("  %s", line.c_str());
     }
-    return m_beforeHooks[(uint32_t)functionHookID];
+
+    // Next to the log if there is one, otherwise in the temp folder
+    std::wstring path = log::getInterface()->getLogPath();
+    if (path.empty() && file::getTmpPath())
+    {
+        path = file::getTmpPath();
+    }
+    auto tracePath = (fs::path(path) / L"sl.startup.json").wstring();
+    auto trace = m_startupTimeline->getChromeTrace();
+    file::write(tracePath.c_str(), std::vector<uint8_t>(trace.begin(), trace.end()));
+    SL_LOG_INFO("Startup trace written to '%ls'", tracePath.c_str());
 }
 
-const HookList& PluginManager::getAfterHooks(FunctionHookID functionHookID)
+void PluginManager::lazyInitializePlugins()
 {
     // Lazy plugin initialization because of the late device initialization
+    if (s_status == PluginManagerStatus::eUnknown)
+    {
+        SL_LOG_ERROR( "Please make sure to call slInit before calling DXGI/D3D/Vulkan API");
+        return;
+    }
+
+    // Hooks can fire on multiple threads at once, first one in initializes and the rest find plugins ready
+    std::scoped_lock lock(m_mtxLazyInit);
     if (s_status == PluginManagerStatus::ePluginsLoaded)
     {
         initializePlugins();
     }
-    else if (s_status == PluginManagerStatus::eUnknown)
+}
+
+const HookList& PluginManager::getBeforeHooks(FunctionHookID functionHookID)
+{
+    // Hit on every intercepted call so only a single atomic load once plugins are up
+    if (s_status.load(std::memory_order_acquire) != PluginManagerStatus::ePluginsInitialized) [[unlikely]]
     {
-        SL_LOG_ERROR( "Please make sure to call slInit before calling DXGI/D3D/Vulkan API");
+        lazyInitializePlugins();
+    }
+    return m_activeHookTables.load(std::memory_order_acquire)->before[(uint32_t)functionHookID];
+}
+
+const HookList& PluginManager::getAfterHooks(FunctionHookID functionHookID)
+{
+    if (s_status.load(std::memory_order_acquire) != PluginManagerStatus::ePluginsInitialized) [[unlikely]]
+    {
+        lazyInitializePlugins();
     }
-    return m_afterHooks[(uint32_t)functionHookID];
+    return m_activeHookTables.load(std::memory_order_acquire)->after[(uint32_t)functionHookID];
 }
 
 const HookList& PluginManager::getBeforeHooksWithoutLazyInit(FunctionHookID functionHookID)
 {
-    return m_beforeHooks[(uint32_t)functionHookID];
+    return m_activeHookTables.load(std::memory_order_acquire)->before[(uint32_t)functionHookID];
 }
 
 const HookList& PluginManager::getAfterHooksWithoutLazyInit(FunctionHookID functionHookID)
 {
-    return m_afterHooks[(uint32_t)functionHookID];
+    return m_activeHookTables.load(std::memory_order_acquire)->after[(uint32_t)functionHookID];
 }
 
 PluginManager::PluginManager()
@@ -1417,6 +1935,7 @@ PluginManager::PluginManager()
     m_version.major = VERSION_MAJOR;
     m_version.minor = VERSION_MINOR;
     m_version.build = VERSION_PATCH;
+    publishHookTables(std::make_unique<HookTables>());
 
 #define FUNCTION_HOOK_ID_MAP_ENTRY(id) (m_functionHookIDMap[#id] = FunctionHookID::e##id)
     FUNCTION_HOOK_ID_MAP_ENTRY(IDXGIFactory_CreateSwapChain);
@@ -1440,6 +1959,10 @@ PluginManager::PluginManager()
     FUNCTION_HOOK_ID_MAP_ENTRY(Vulkan_DeviceWaitIdle);
     FUNCTION_HOOK_ID_MAP_ENTRY(Vulkan_CreateWin32SurfaceKHR);
     FUNCTION_HOOK_ID_MAP_ENTRY(Vulkan_DestroySurfaceKHR);
+    FUNCTION_HOOK_ID_MAP_ENTRY(ID3D12Device_CreateCommittedResource);
+    FUNCTION_HOOK_ID_MAP_ENTRY(ID3D12Device_CreatePlacedResource);
+    FUNCTION_HOOK_ID_MAP_ENTRY(ID3D12Device_CreateReservedResource);
+    FUNCTION_HOOK_ID_MAP_ENTRY(Vulkan_CreateImage);
 
     assert((size_t)FunctionHookID::eMaxNum == m_functionHookIDMap.size());
 
@@ -49,6 +49,10 @@ namespace interposer
 {
 using VirtualAddress = void*;
 }
+namespace extra
+{
+struct IPerfStats;
+}
 
 using Feature = uint32_t;
 
@@ -58,6 +62,28 @@ namespace plugin_manager
 using HookPair = std::pair<interposer::VirtualAddress, sl::Feature>;
 using HookList = std::vector<HookPair>;
 
+//! Declared by the 'filter' of a resource creation hook and evaluated by the D3D12 device proxy
+//!
+//! Empty filter matches every resource. Values are D3D12 ones, kept as integers so D3D12 headers are not needed here.
+struct ResourceHookFilter
+{
+    //! Bit per D3D12_RESOURCE_DIMENSION, zero matches any dimension
+    uint32_t dimensions{};
+    //! D3D12_RESOURCE_FLAGS, resource must have at least one of these, zero matches any flags
+    uint32_t anyFlags{};
+    //! Width is in bytes for buffers
+    uint64_t minWidth{};
+    uint32_t minHeight{};
+};
+
+struct ResourceHook
+{
+    interposer::VirtualAddress address{};
+    sl::Feature feature{};
+    ResourceHookFilter filter{};
+};
+using ResourceHookList = std::vector<ResourceHook>;
+
 using PFun_slSetDataInternal = Result(const sl::BaseStructure* inputs, sl::CommandBuffer* cmdBuffer);
 using PFun_slGetDataInternal = Result(const sl::BaseStructure* inputs, sl::BaseStructure* outputs, sl::CommandBuffer* cmdBuffer);
 using PFun_slIsSupported = Result(const sl::AdapterInfo& adapterInfo);
@@ -117,6 +143,16 @@ struct IPluginManager
     virtual Result getFeatureSupportedExternalConfig(Feature feature) = 0;
     virtual bool getLoadedFeatureConfigs(std::vector<json>& configList) const = 0;
     virtual bool getLoadedFeatures(std::vector<Feature>& featureList) const = 0;
+    //! Starts the plugin for this feature if its startup was deferred, see PreferenceFlags::eDeferFeatureStartup
+    virtual Result ensureFeatureStarted(Feature feature) = 0;
+    //! Frame level overhead counters, also shared with plugins via 'param::global::kPerfStats'
+    virtual extra::IPerfStats* getPerfStats() = 0;
+    //! Resource creation 'after' hooks with their filters, empty unless a plugin hooks this ID
+    //!
+    //! No lazy initialization, engines create far too many resources to check plugin status on each one.
+    virtual const ResourceHookList& getResourceHooks(FunctionHookID functionHookID) = 0;
+    //! True if any loaded plugin, enabled or not, has this hook in its JSON
+    virtual bool isHookDeclared(FunctionHookID functionHookID) const = 0;
 };
 
 IPluginManager* getInterface();
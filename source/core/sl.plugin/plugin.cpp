@@ -28,7 +28,10 @@
 #include "source/core/sl.log/log.h"
 #include "source/core/sl.file/file.h"
 #include "source/core/sl.extra/extra.h"
+#include "source/core/sl.extra/hitches.h"
+#include "source/core/sl.extra/frameArena.h"
 #include "source/core/sl.param/parameters.h"
+#include "source/core/sl.thread/thread.h"
 #include "external/json/include/nlohmann/json.hpp"
 #include <unordered_set>
 
@@ -120,6 +123,9 @@ bool onLoad(api::Context* ctx, const char* loaderJSON, const char* embeddedJSON)
 {
     // Setup logging and callbacks so we can report any issues correctly
     param::getPointerParam(api::getContext()->parameters, param::global::kLogInterface, &log::s_log);
+    param::getPointerParam(api::getContext()->parameters, param::global::kHitchRecorder, &extra::hitch::s_recorder);
+    param::getPointerParam(api::getContext()->parameters, param::global::kFrameEpoch, &extra::frame::s_epoch);
+    param::getPointerParam(api::getContext()->parameters, param::global::kHeapAllocations, &extra::alloc::s_counter);
 #ifndef SL_COMMON_PLUGIN
     param::getPointerParam(api::getContext()->parameters, param::common::kKeyboardAPI, &extra::keyboard::s_keyboard);
 #endif
@@ -170,7 +176,7 @@ bool onLoad(api::Context* ctx, const char* loaderJSON, const char* embeddedJSON)
             if (file::exists(extraJSONFile.c_str()))
             {
                 SL_LOG_INFO("Found extra JSON config %S", extraJSONFile.c_str());
-                std::vector<uint8_t> jsonText = file::read(extraJSONFile.c_str());
+                auto jsonText = file::map(extraJSONFile.c_str());
                 if (!jsonText.empty())
                 {
                     json& extraConfig = *(json*)ctx->extConfig;
@@ -210,6 +216,8 @@ StartupResult onStartup(api::Context *ctx, const char* jsonConfig)
 void onShutdown(api::Context *ctx)
 {
     SL_LOG_INFO("Shutting down plugin %s", ctx->pluginName.c_str());
+    // Each module owns its pool, join it here rather than from the static destructor under the loader lock
+    thread::shutdownSharedJobSystem();
     delete ctx->pluginConfig;
     delete ctx->loaderConfig;
     delete ctx->extConfig;
@@ -24,6 +24,8 @@
 
 #include "include/sl_version.h"
 #include "source/core/sl.api/internal.h"
+#include "source/core/sl.extra/trace.h"
+#include "source/core/sl.extra/frameArena.h"
 
 #define SL_EXPORT extern "C" __declspec(dllexport)
 SL_EXPORT BOOL APIENTRY DllMain(HMODULE hModule, DWORD fdwReason, LPVOID);
@@ -153,6 +155,13 @@ SL_PLUGIN_CONTEXT_DEFINE(PLUGIN_NAMESPACE, PLUGIN_CTX)
                                                                                                            \
 bool slOnPluginLoad(sl::param::IParameters *params, const char* loaderJSON, const char **pluginJSON)       \
 {                                                                                                          \
+    if(sl::PLUGIN_NAMESPACE::s_init && !sl::api::s_ctx->pluginConfig)                                      \
+    {                                                                                                      \
+        /* Loaded again after 'slOnPluginShutdown', start over from fresh contexts */                      \
+        delete sl::api::s_ctx;                                                                             \
+        delete sl::PLUGIN_NAMESPACE::s_ctx;                                                                \
+        sl::PLUGIN_NAMESPACE::s_init = false;                                                              \
+    }                                                                                                      \
     if(!sl::PLUGIN_NAMESPACE::s_init)                                                                      \
     {                                                                                                      \
         sl::api::s_ctx = new sl::api::Context(N, sl::V1, sl::V2, nullptr, nullptr,                         \
@@ -175,6 +184,8 @@ bool slOnPluginLoad(sl::param::IParameters *params, const char* loaderJSON, cons
                                                                                                            \
 }  /* namespace sl */                                                                                      \
 /* Always in global namespace */                                                                           \
+SL_TRACE_DEFINE_PROVIDER()                                                                                 \
+SL_ALLOCATION_TRACKING_DEFINE()                                                                            \
 SL_EXPORT BOOL APIENTRY DllMain(HMODULE hModule, DWORD fdwReason, LPVOID)                                  \
 {                                                                                                          \
     switch (fdwReason)                                                                                     \
@@ -20,6 +20,10 @@
 * SOFTWARE.
 */ 
 
+#include <map>
+#include <mutex>
+#include <tuple>
+
 #include "include/sl_security.h"
 
 namespace sl
@@ -28,15 +32,79 @@ namespace sl
 namespace security
 {
 
-HMODULE loadLibrary(const wchar_t* path)
+namespace
+{
+//! Read access is shared so WinVerifyTrust and LoadLibrary can open the file, write and delete are not
+//! so the file that passed the check cannot be rewritten, renamed or replaced before it is mapped.
+HANDLE lockLibrary(const wchar_t* path)
+{
+    return CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+}
+
+#ifdef SL_PRODUCTION
+// Volume, file index, size and last write time
+using FileIdentity = std::tuple<DWORD, uint64_t, uint64_t, uint64_t>;
+
+bool getFileIdentity(HANDLE file, FileIdentity& id)
+{
+    BY_HANDLE_FILE_INFORMATION info{};
+    if (!GetFileInformationByHandle(file, &info)) return false;
+    id = { info.dwVolumeSerialNumber,
+        ((uint64_t)info.nFileIndexHigh << 32) | info.nFileIndexLow,
+        ((uint64_t)info.nFileSizeHigh << 32) | info.nFileSizeLow,
+        ((uint64_t)info.ftLastWriteTime.dwHighDateTime << 32) | info.ftLastWriteTime.dwLowDateTime };
+    return true;
+}
+
+//! Every verified file keeps a lock handle open for the lifetime of the process. Nobody can write to or
+//! delete it after the check, so while the handle lives the same identity means the same verified content.
+std::mutex s_verifiedMutex;
+std::map<FileIdentity, HANDLE> s_verified;
+#endif
+}
+
+HANDLE verifyLibrary(const wchar_t* path)
 {
-    HMODULE mod = {};
+    HANDLE file = lockLibrary(path);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return INVALID_HANDLE_VALUE;
+    }
 #ifdef SL_PRODUCTION
-    if (verifyEmbeddedSignature(path))
+    // Only successful checks are remembered and only for the lifetime of the process, a persistent
+    // cache would be a trust decision any process running as the same user could forge.
+    FileIdentity id{};
+    bool hasId = getFileIdentity(file, id);
+    if (hasId)
+    {
+        std::scoped_lock lock(s_verifiedMutex);
+        if (s_verified.find(id) != s_verified.end()) return file;
+    }
+    if (!verifyEmbeddedSignature(path, file))
+    {
+        CloseHandle(file);
+        return INVALID_HANDLE_VALUE;
+    }
+    HANDLE held{};
+    if (hasId && DuplicateHandle(GetCurrentProcess(), file, GetCurrentProcess(), &held, 0, FALSE, DUPLICATE_SAME_ACCESS))
+    {
+        std::scoped_lock lock(s_verifiedMutex);
+        if (!s_verified.emplace(id, held).second) CloseHandle(held);
+    }
 #endif
+    return file;
+}
+
+HMODULE loadLibrary(const wchar_t* path, HANDLE file)
+{
+    if (file == INVALID_HANDLE_VALUE)
     {
-        mod = LoadLibraryW(path);
+        file = verifyLibrary(path);
+        if (file == INVALID_HANDLE_VALUE) return {};
     }
+    // Lock is held until the image is mapped, the mapping then keeps the file from being written on its own
+    HMODULE mod = LoadLibraryW(path);
+    CloseHandle(file);
     return mod;
 }
 
@@ -28,7 +28,13 @@ namespace sl
 namespace security
 {
 
-HMODULE loadLibrary(const wchar_t* path);
+//! Checks the embedded signature on production builds, always passes otherwise
+//!
+//! Returns the library opened without write or delete sharing so it cannot change before it is loaded,
+//! INVALID_HANDLE_VALUE if it failed the check. Must be passed to 'loadLibrary' which closes it.
+HANDLE verifyLibrary(const wchar_t* path);
+//! Loads the library only if its signature checks out, 'file' from 'verifyLibrary' skips the check
+HMODULE loadLibrary(const wchar_t* path, HANDLE file = INVALID_HANDLE_VALUE);
 
 }
 
@@ -24,16 +24,24 @@
 
 #include <vector>
 #include <list>
+#include <deque>
 #include <functional>
 #include <mutex>
 #include <atomic>
 #include <map>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <algorithm>
+#include <iterator>
 
 #include <condition_variable>
 #include <thread>
 
 #include "source/core/sl.exception/exception.h"
 #include "source/core/sl.log/log.h"
+#include "source/core/sl.extra/trace.h"
+#include "source/core/sl.extra/hitches.h"
 
 using namespace std::chrono_literals;
 
@@ -45,11 +53,9 @@ namespace thread
 template<typename T>
 struct ThreadContext
 {
-    ThreadContext() 
+    ThreadContext()
     {
-        // Space for 64K thread ids.
-        // This does not waste too much memory
-        threads.resize(65536);
+        m_id = nextId();
     };
 
     ~ThreadContext()
@@ -57,125 +63,506 @@ struct ThreadContext
         clear();
     }
 
+    //! Releases all contexts
+    //! 
+    //! Any cached per-thread pointers are invalidated since
+    //! we switch to a new instance id.
     void clear()
     {
-        for (auto& t : threads)
-        {
-            t.reset();
-        }
-        for (auto& t : threadMap)
+        std::lock_guard<std::mutex> lock(mutex);
+        m_id = nextId();
+        threadMap.clear();
+        threadCount = 0;
+    }
+
+    //! Releases context for the calling thread, if any
+    //! 
+    //! Should be called by threads which are about to exit and
+    //! are known to never call into this context again.
+    void releaseContext()
+    {
+        auto& cache = s_cache;
+        std::lock_guard<std::mutex> lock(mutex);
+        threadMap.erase(GetCurrentThreadId());
+        if (cache.id == m_id)
         {
-            t.second.reset();
+            cache = {};
         }
-        threads.clear();
-        threadMap.clear();
+        threadCount = (uint32_t)threadMap.size();
     }
 
     T &getContext()
     {
-        // Accessing thread context via thread id
-        // This is super fast since there are no sync points
-        // but can result in huge memory consumption if
-        // OS assigns some really big id (it is 32bit value)
-        // As long as thread ids are 16bit we are good.
-        // If we hit a title where thread ids are crazy high we 
-        // need to switch to classic mode with mutex lock.
+        // Fast path, one TLS read and compare with no sync points.
+        // Instance id is unique per instance and per clear() so
+        // stale pointers can never match.
+        auto& cache = s_cache;
+        if (cache.id == m_id.load(std::memory_order_acquire))
+        {
+            return *cache.context;
+        }
+
+        // Slow path, only taken the first time a thread touches this instance
+        // (or when swapping between multiple instances of the same type)
         auto id = GetCurrentThreadId();
-        if (!useThreadMap && id > 65536)
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& context = threadMap[id];
+        if (!context)
+        {
+            context = std::make_unique<T>();
+            threadCount++;
+            SL_LOG_HINT("detected new thread %u - total threads %u", id, threadCount.load());
+        }
+        cache.id = m_id;
+        cache.context = context.get();
+        return *context;
+    }
+
+protected:
+
+    struct Cache
+    {
+        uint64_t id{};
+        T* context{};
+    };
+
+    static uint64_t nextId()
+    {
+        // Zero is reserved for "no cache"
+        static std::atomic<uint64_t> s_nextId = 1;
+        return s_nextId.fetch_add(1);
+    }
+
+    static inline thread_local Cache s_cache = {};
+
+    std::atomic<uint64_t> m_id = {};
+    std::mutex mutex = {};
+    std::map<DWORD, std::unique_ptr<T>> threadMap = {};
+    std::atomic<uint32_t> threadCount = {};
+};
+
+//! Move-only callable with small buffer optimization
+//! 
+//! Callables up to kInlineSize bytes are stored in place, larger ones
+//! fall back to a single heap allocation.
+class Task
+{
+public:
+    static constexpr size_t kInlineSize = 64;
+
+    Task() = default;
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    template<typename F, typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>>
+    Task(F&& func)
+    {
+        using D = std::decay_t<F>;
+        if constexpr (sizeof(D) <= kInlineSize && alignof(D) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<D>)
+        {
+            new (m_storage) D(std::forward<F>(func));
+            m_ops = &InlineOps<D>::ops;
+        }
+        else
+        {
+            *(D**)m_storage = new D(std::forward<F>(func));
+            m_ops = &HeapOps<D>::ops;
+        }
+    }
+
+    Task(Task&& other) noexcept
+    {
+        moveFrom(other);
+    }
+
+    Task& operator=(Task&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    ~Task()
+    {
+        reset();
+    }
+
+    explicit operator bool() const { return m_ops != nullptr; }
+
+    void operator()() { m_ops->invoke(m_storage); }
+
+    void reset()
+    {
+        if (m_ops)
         {
-            useThreadMap = true; 
-            SL_LOG_WARN("Thread id over 65536 detected, switching to thread map");
+            m_ops->destroy(m_storage);
+            m_ops = nullptr;
         }
-        // Atomic check
-        if (useThreadMap)
+    }
+
+private:
+    struct Ops
+    {
+        void(*invoke)(void*);
+        void(*move)(void* dst, void* src);
+        void(*destroy)(void*);
+    };
+
+    template<typename D>
+    struct InlineOps
+    {
+        static void invoke(void* p) { (*(D*)p)(); }
+        static void move(void* dst, void* src) { new (dst) D(std::move(*(D*)src)); ((D*)src)->~D(); }
+        static void destroy(void* p) { ((D*)p)->~D(); }
+        static constexpr Ops ops = { invoke, move, destroy };
+    };
+
+    template<typename D>
+    struct HeapOps
+    {
+        static void invoke(void* p) { (**(D**)p)(); }
+        static void move(void* dst, void* src) { *(D**)dst = *(D**)src; }
+        static void destroy(void* p) { delete *(D**)p; }
+        static constexpr Ops ops = { invoke, move, destroy };
+    };
+
+    void moveFrom(Task& other)
+    {
+        m_ops = other.m_ops;
+        if (m_ops)
         {
-            std::lock_guard<std::mutex> lock(mutex);
-            auto it = threadMap.find(id);
-            if (it == threadMap.end())
+            m_ops->move(m_storage, other.m_storage);
+            other.m_ops = nullptr;
+        }
+    }
+
+    alignas(std::max_align_t) uint8_t m_storage[kInlineSize];
+    const Ops* m_ops{};
+};
+
+//! Bounded lock-free multi-producer, single-consumer ring buffer
+//! 
+//! Each slot carries a sequence number (Vyukov style) so producers
+//! only contend on a single CAS and never take a lock. Capacity
+//! must be a power of two.
+template<typename T, size_t N>
+class MPSCRing
+{
+    static_assert(N && (N & (N - 1)) == 0, "Capacity must be a power of two");
+
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    Slot m_slots[N];
+    alignas(64) std::atomic<size_t> m_tail = 0;
+    //! Only written by the consumer, atomic so 'empty' can be called from any thread
+    alignas(64) std::atomic<size_t> m_head = 0;
+
+public:
+    MPSCRing()
+    {
+        for (size_t i = 0; i < N; i++)
+        {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    //! Reserves and fills 'count' consecutive slots, returns false if ring does not have enough space
+    //! 
+    //! Since the single consumer frees slots in order, if the last slot
+    //! in the range is free all of the previous ones are free as well.
+    //! 
+    //! Optional 'end' receives the position just past the reserved range.
+    bool tryPush(T* values, size_t count, size_t* end = nullptr)
+    {
+        if (!count || count > N) return false;
+        auto pos = m_tail.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto& last = m_slots[(pos + count - 1) & (N - 1)];
+            auto seq = last.sequence.load(std::memory_order_acquire);
+            auto diff = (intptr_t)seq - (intptr_t)(pos + count - 1);
+            if (diff == 0)
             {
-                // If we switched to this later in the game, co-own existing context, if any
-                if (threads.size() > (size_t)id && threads[id])
+                if (m_tail.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
                 {
-                    threadMap[id] = threads[id];
-                }
-                else
-                {
-                    threadMap[id] = std::make_shared<T>();
+                    break;
                 }
             }
-            return *threadMap[id];
+            else if (diff < 0)
+            {
+                // Full
+                return false;
+            }
+            else
+            {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+        for (size_t i = 0; i < count; i++)
+        {
+            auto& slot = m_slots[(pos + i) & (N - 1)];
+            slot.value = std::move(values[i]);
+            slot.sequence.store(pos + i + 1, std::memory_order_release);
         }
+        if (end)
+        {
+            *end = pos + count;
+        }
+        return true;
+    }
 
-        // Each thread has different id so no need to sync here
-        if (!threads[id])
+    //! Consumer side, must only be called from one thread
+    bool tryPop(T& value)
+    {
+        auto head = m_head.load(std::memory_order_relaxed);
+        auto& slot = m_slots[head & (N - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1)
         {
-            threads[id] = std::make_shared<T>();
-            threadCount++;
-            SL_LOG_HINT("detected new thread %u - total threads %u", id, threadCount.load());
+            return false;
         }
-        return *threads[id];
+        value = std::move(slot.value);
+        slot.sequence.store(head + N, std::memory_order_release);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
     }
 
-protected:
+    //! Approximate, safe to call from any thread
+    bool empty() const
+    {
+        auto head = m_head.load(std::memory_order_acquire);
+        auto& slot = m_slots[head & (N - 1)];
+        return slot.sequence.load(std::memory_order_acquire) != head + 1;
+    }
 
-    std::atomic<bool> useThreadMap = false;
-    std::mutex mutex = {};
-    std::vector<std::shared_ptr<T>> threads = {};
-    std::map<DWORD, std::shared_ptr<T>> threadMap = {};
-    std::atomic<uint32_t> threadCount = {};
+    //! Total number of positions reserved by producers so far
+    size_t tail() const { return m_tail.load(std::memory_order_acquire); }
+
+    static constexpr size_t capacity() { return N; }
 };
 
+//! Where a thread should run on hybrid CPUs with performance and efficiency cores
+enum class ThreadPlacement
+{
+    //! Left to the OS scheduler
+    eDefault,
+    //! Background work, EcoQoS lets the scheduler prefer efficiency cores and lower clocks
+    eEfficiency,
+    //! Latency critical work, restricted to the performance cores on the NUMA node of the creating thread
+    ePerformance,
+};
+
+struct CpuSet
+{
+    ULONG id;
+    BYTE efficiencyClass;
+    BYTE numaNode;
+};
+
+//! CPU sets available to the process, queried once
+inline const std::vector<CpuSet>& getCpuSets()
+{
+    static const std::vector<CpuSet> s_cpuSets = []()
+    {
+        std::vector<CpuSet> sets;
+        ULONG size{};
+        GetSystemCpuSetInformation(nullptr, 0, &size, GetCurrentProcess(), 0);
+        std::vector<uint8_t> buffer(size);
+        if (!size || !GetSystemCpuSetInformation((PSYSTEM_CPU_SET_INFORMATION)buffer.data(), size, &size, GetCurrentProcess(), 0))
+        {
+            return sets;
+        }
+        for (ULONG offset = 0; offset < size;)
+        {
+            auto info = (PSYSTEM_CPU_SET_INFORMATION)(buffer.data() + offset);
+            if (info->Type == CpuSetInformation)
+            {
+                sets.push_back({ info->CpuSet.Id, info->CpuSet.EfficiencyClass, (BYTE)info->CpuSet.NumaNodeIndex });
+            }
+            offset += info->Size;
+        }
+        return sets;
+    }();
+    return s_cpuSets;
+}
+
+//! Applies placement to 'thread', returns false if the OS does not support it
+//!
+//! Only a hint, efficiency threads are never pinned so they can still use any core when the system is idle.
+//! On CPUs without different core types performance threads keep their default CPU sets.
+inline bool setThreadPlacement(HANDLE thread, ThreadPlacement placement)
+{
+    if (placement == ThreadPlacement::eDefault)
+    {
+        return true;
+    }
+
+    THREAD_POWER_THROTTLING_STATE throttling{};
+    throttling.Version = THREAD_POWER_THROTTLING_CURRENT_VERSION;
+    throttling.ControlMask = THREAD_POWER_THROTTLING_EXECUTION_SPEED;
+    // Opting out explicitly so latency critical threads are not throttled while the host window is in background
+    throttling.StateMask = placement == ThreadPlacement::eEfficiency ? THREAD_POWER_THROTTLING_EXECUTION_SPEED : 0;
+    if (!SetThreadInformation(thread, ThreadPowerThrottling, &throttling, sizeof(throttling)))
+    {
+        return false;
+    }
+    if (placement == ThreadPlacement::eEfficiency)
+    {
+        return true;
+    }
+
+    // Higher efficiency class means a more performant core
+    auto& sets = getCpuSets();
+    BYTE minClass = 0xff, maxClass = 0;
+    for (auto& set : sets)
+    {
+        minClass = std::min(minClass, set.efficiencyClass);
+        maxClass = std::max(maxClass, set.efficiencyClass);
+    }
+    if (sets.empty() || minClass == maxClass)
+    {
+        return true;
+    }
+    PROCESSOR_NUMBER processor{};
+    GetCurrentProcessorNumberEx(&processor);
+    USHORT node{};
+    bool hasNode = GetNumaProcessorNodeEx(&processor, &node);
+    std::vector<ULONG> ids, anyNode;
+    for (auto& set : sets)
+    {
+        if (set.efficiencyClass == maxClass)
+        {
+            anyNode.push_back(set.id);
+            if (!hasNode || set.numaNode == node)
+            {
+                ids.push_back(set.id);
+            }
+        }
+    }
+    if (ids.empty())
+    {
+        ids = anyNode;
+    }
+    return SetThreadSelectedCpuSets(thread, ids.data(), (ULONG)ids.size());
+}
+
 class WorkerThread
 {
+    static constexpr size_t kQueueSize = 2048;
+
     std::mutex m_mtx;
 
-    std::condition_variable m_cv; // work queue cv
+    std::condition_variable m_cv; // work queue cv, only used when worker is sleeping
+    std::atomic<bool> m_sleeping = false;
     bool m_workAdded = false;
 
-    std::condition_variable m_cvf; // flushing cv, no need for flag since we use a timeout for it
+    std::condition_variable m_cvf; // fence cv, only notified when someone is waiting
+    std::atomic<uint32_t> m_fenceWaiters = 0;
+    // Number of one-shot jobs completed, ring is consumed in order so this
+    // matches the ring position of the next job to run.
+    std::atomic<uint64_t> m_completed = 0;
 
     std::atomic<bool> m_quit = false;
-    std::atomic<bool> m_flush = false;
 
-    size_t m_jobCount = 0;
+    std::atomic<size_t> m_jobCount = 0;
     std::thread m_thread;
-    std::list<std::pair<bool, std::function<void(void)>>> m_work{};
+    std::unique_ptr<MPSCRing<Task, kQueueSize>> m_work = std::make_unique<MPSCRing<Task, kQueueSize>>();
+    
+    // Perpetual jobs are rare and long lived, keep them out of the ring
+    std::mutex m_perpetualMtx;
+    std::vector<Task> m_perpetual{};
+    std::atomic<size_t> m_perpetualCount = 0;
+    // Held while perpetual jobs run so they can schedule more work, bumped generation drops the running ones
+    std::mutex m_perpetualRunMtx;
+    uint64_t m_perpetualGeneration = 0;
     std::wstring m_name;
 
+    void wake()
+    {
+        // Only pay for the lock when the worker is actually sleeping.
+        // Worker publishes m_sleeping before re-checking the queues so
+        // either it sees our work or we see it sleeping.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_sleeping.load())
+        {
+            std::lock_guard<std::mutex> lock(m_mtx);
+            m_workAdded = true;
+            m_cv.notify_one();
+        }
+    }
+
     void workerFunction()
     {
+        Task task;
         while (!m_quit)
         {
-            std::unique_lock<std::mutex> lock(m_mtx);
-            if (m_work.empty())
-            {
-                // Tell threads waiting on flush that we are done
-                m_cvf.notify_all();
-
-                // Check if there was work added while the work queue was empty. If added, don't wait. Otherwise, keep waiting until notify + work added
-                m_cv.wait(lock, [this] { return m_workAdded; });
-                m_workAdded = false;
-            }
-            else
+            bool didWork = false;
+            // Drain one-shot work first
+            while (m_work->tryPop(task))
             {
-                auto [perpetual, func] = m_work.front();
-                lock.unlock();
                 // NOTE: No need to wrap this in the exception handler
                 // since all internal workers are already executing within one.
-                func();
-                lock.lock();
-                // Done, remove from the queue
-                m_work.erase(m_work.begin());
-                // Keep perpetual jobs until flush is requested
-                if (!perpetual || m_flush.load())
                 {
-                    m_jobCount--;
+                    SL_TRACE_ZONE("WorkerThread::job");
+                    task();
+                }
+                task.reset();
+                m_jobCount--;
+                m_completed.fetch_add(1);
+                didWork = true;
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (m_fenceWaiters.load())
+                {
+                    std::lock_guard<std::mutex> lock(m_mtx);
+                    m_cvf.notify_all();
+                }
+            }
+            // Then execute each perpetual job once, after other workloads (if any)
+            if (m_perpetualCount.load())
+            {
+                std::lock_guard<std::mutex> runLock(m_perpetualRunMtx);
+                std::vector<Task> perpetual;
+                uint64_t generation;
+                {
+                    std::lock_guard<std::mutex> lock(m_perpetualMtx);
+                    perpetual.swap(m_perpetual);
+                    generation = m_perpetualGeneration;
+                }
+                for (auto& func : perpetual)
+                {
+                    SL_TRACE_ZONE("WorkerThread::perpetualJob");
+                    func();
                 }
-                else
                 {
-                    // Back to the queue to execute again but after other workloads (if any)
-                    m_work.push_back({ perpetual, func });
+                    // Jobs scheduled while running go after the existing ones
+                    std::lock_guard<std::mutex> lock(m_perpetualMtx);
+                    if (generation == m_perpetualGeneration)
+                    {
+                        perpetual.insert(perpetual.end(), std::make_move_iterator(m_perpetual.begin()), std::make_move_iterator(m_perpetual.end()));
+                        m_perpetual.swap(perpetual);
+                    }
+                    else
+                    {
+                        m_jobCount -= perpetual.size();
+                    }
                 }
+                didWork = true;
+            }
+
+            if (!didWork)
+            {
+                std::unique_lock<std::mutex> lock(m_mtx);
+                m_sleeping = true;
+                // Check if there was work added while we were getting ready to sleep. If added, don't wait. Otherwise, keep waiting until notify + work added
+                m_cv.wait(lock, [this] { return m_workAdded || !m_work->empty() || m_perpetualCount.load() > 0; });
+                m_sleeping = false;
+                m_workAdded = false;
             }
         }
     }
@@ -183,7 +570,7 @@ class WorkerThread
 public:
     WorkerThread(const WorkerThread&) = delete;
 
-    WorkerThread(const wchar_t* name, int priority)
+    WorkerThread(const wchar_t* name, int priority, ThreadPlacement placement = ThreadPlacement::eDefault)
     {
         m_name = name;
         m_thread = std::thread(&WorkerThread::workerFunction, this);
@@ -191,6 +578,8 @@ public:
         {
             SL_LOG_WARN("Failed to set thread priority to %d for thread '%S'", priority, name);
         }
+        // Older Windows versions do not support placement, nothing to report
+        setThreadPlacement(m_thread.native_handle(), placement);
         SetThreadDescription(m_thread.native_handle(), name);
     }
 
@@ -205,45 +594,558 @@ public:
         m_thread.join(); // block until thread exits
     }
 
-    std::cv_status flush(uint32_t timeout = 500)
+    //! Returns fence covering all one-shot jobs scheduled so far
+    //! 
+    //! Fence values increase monotonically, perpetual jobs are not included.
+    uint64_t getFence()
     {
-        bool isTimeout = false;
+        return m_work->tail();
+    }
+
+    //! Returns true if all jobs covered by the fence have completed
+    bool isFenceCompleted(uint64_t fence)
+    {
+        return m_completed.load() >= fence;
+    }
 
-        // Atomic swap to true and check that it was false so we don't flush
-        // multiple times from different threads.
-        if (!m_flush.exchange(true))
+    //! Blocks until all jobs covered by the fence have completed or timeout expires
+    std::cv_status waitForFence(uint64_t fence, uint32_t timeout = 500)
+    {
+        if (isFenceCompleted(fence))
+        {
+            return std::cv_status::no_timeout;
+        }
+        extra::ScopedHitchTimer hitch("WorkerThread::waitForFence");
+        m_fenceWaiters++;
+        bool isTimeout = false;
         {
             std::unique_lock<std::mutex> lock(m_mtx);
+            isTimeout = !m_cvf.wait_for(lock, std::chrono::milliseconds(timeout), [this, fence]() { return isFenceCompleted(fence); });
+        }
+        m_fenceWaiters--;
+        if (isTimeout)
+        {
+            SL_LOG_WARN("Worker thread '%S' timed out", m_name.c_str());
+        }
+        return isTimeout ? std::cv_status::timeout : std::cv_status::no_timeout;
+    }
+
+    //! Waits for all one-shot jobs scheduled before this call
+    //! 
+    //! Returns as soon as they are done, perpetual jobs keep running.
+    std::cv_status flush(uint32_t timeout = 500)
+    {
+        return waitForFence(getFence(), timeout);
+    }
+
+    //! Removes all perpetual jobs
+    //! 
+    //! Waits for the running ones unless called from one of them.
+    void clearPerpetualWork()
+    {
+        std::unique_lock<std::mutex> runLock(m_perpetualRunMtx, std::defer_lock);
+        if (std::this_thread::get_id() != m_thread.get_id())
+        {
+            runLock.lock();
+        }
+        std::lock_guard<std::mutex> lock(m_perpetualMtx);
+        m_jobCount -= m_perpetual.size();
+        m_perpetual.clear();
+        m_perpetualCount = 0;
+        m_perpetualGeneration++;
+    }
 
-            isTimeout = !m_cvf.wait_for(lock, std::chrono::milliseconds(timeout), [this]() { return m_work.empty(); });
-            if (isTimeout)
+    size_t getJobCount()
+    {
+        return m_jobCount.load();
+    }
+
+    template<typename F>
+    bool scheduleWork(F&& func, bool perpetual = false)
+    {
+        Task task(std::forward<F>(func));
+        if (perpetual)
+        {
+            std::lock_guard<std::mutex> lock(m_perpetualMtx);
+            m_perpetual.push_back(std::move(task));
+            m_perpetualCount++;
+            m_jobCount++;
+        }
+        else
+        {
+            return scheduleBatch(&task, 1);
+        }
+        wake();
+        return true;
+    }
+
+    //! Schedules multiple one-shot jobs with a single reservation and wake up
+    //! 
+    //! Tasks are moved from, execution order matches the array order.
+    //! If the ring is full the caller backs off until the worker makes room.
+    //! Worker can not make room for itself, jobs it schedules into a full ring
+    //! run inline instead, ahead of the ones already queued.
+    bool scheduleBatch(Task* tasks, size_t count)
+    {
+        if (m_quit) return false;
+        bool isWorker = std::this_thread::get_id() == m_thread.get_id();
+        while (count)
+        {
+            auto chunk = count < kQueueSize ? count : kQueueSize;
+            m_jobCount += chunk;
+            while (!m_work->tryPush(tasks, chunk))
             {
-                SL_LOG_WARN("Worker thread '%S' timed out", m_name.c_str());
+                if (isWorker)
+                {
+                    for (size_t i = 0; i < chunk; i++)
+                    {
+                        SL_TRACE_ZONE("WorkerThread::job");
+                        tasks[i]();
+                        tasks[i].reset();
+                    }
+                    m_jobCount -= chunk;
+                    break;
+                }
+                wake();
+                std::this_thread::yield();
             }
-            m_flush = false;
+            tasks += chunk;
+            count -= chunk;
         }
-        return isTimeout ? std::cv_status::timeout : std::cv_status::no_timeout;
+        wake();
+        return true;
     }
+};
 
-    size_t getJobCount()
+//! Exponential backoff used by the spinning locks below
+//! 
+//! Returns false once the spin budget is exhausted and caller should block instead.
+struct SpinBackoff
+{
+    static constexpr uint32_t kMaxSpins = 1 << 10;
+
+    bool spin()
+    {
+        if (m_count >= kMaxSpins)
+        {
+            return false;
+        }
+        for (uint32_t i = 0; i < m_count; i++)
+        {
+            YieldProcessor();
+        }
+        m_total += m_count;
+        m_count = m_count ? m_count << 1 : 1;
+        return true;
+    }
+
+    uint32_t m_count = 0;
+    uint32_t m_total = 0;
+};
+
+//! Adaptive lock, spins with pause and exponential backoff then parks the thread
+//! 
+//! Parking uses C++20 atomic wait/notify which maps to WaitOnAddress on Windows
+//! so oversubscribed systems do not burn cores while holder is descheduled.
+//! Satisfies BasicLockable so it can be used with std::lock_guard/std::scoped_lock.
+class AdaptiveLock
+{
+    enum : uint32_t
+    {
+        eUnlocked,
+        eLocked,
+        eLockedWithWaiters
+    };
+
+    std::atomic<uint32_t> m_state = eUnlocked;
+    std::atomic<uint64_t> m_contended = 0;
+    std::atomic<uint64_t> m_spins = 0;
+    std::atomic<uint64_t> m_waits = 0;
+
+public:
+    AdaptiveLock() = default;
+    AdaptiveLock(const AdaptiveLock&) = delete;
+    AdaptiveLock& operator=(const AdaptiveLock&) = delete;
+
+    bool try_lock()
+    {
+        uint32_t expected = eUnlocked;
+        return m_state.compare_exchange_strong(expected, eLocked, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    void lock()
+    {
+        if (try_lock())
+        {
+            return;
+        }
+        m_contended.fetch_add(1, std::memory_order_relaxed);
+
+        SpinBackoff backoff;
+        while (backoff.spin())
+        {
+            // Read first, only attempt CAS when lock looks free
+            if (m_state.load(std::memory_order_relaxed) == eUnlocked && try_lock())
+            {
+                m_spins.fetch_add(backoff.m_total, std::memory_order_relaxed);
+                return;
+            }
+        }
+        m_spins.fetch_add(backoff.m_total, std::memory_order_relaxed);
+
+        // Mark as contended and park until the holder releases
+        while (m_state.exchange(eLockedWithWaiters, std::memory_order_acquire) != eUnlocked)
+        {
+            m_waits.fetch_add(1, std::memory_order_relaxed);
+            m_state.wait(eLockedWithWaiters, std::memory_order_relaxed);
+        }
+    }
+
+    void unlock()
     {
-        std::unique_lock<std::mutex> lock(m_mtx);
-        return m_jobCount;
+        if (m_state.exchange(eUnlocked, std::memory_order_release) == eLockedWithWaiters)
+        {
+            m_state.notify_one();
+        }
     }
 
-    bool scheduleWork(const std::function<void(void)>& func, bool perpetual = false)
+    //! Contention statistics, useful when profiling lock hot spots
+    uint64_t getContendedCount() const { return m_contended.load(std::memory_order_relaxed); }
+    uint64_t getSpinCount() const { return m_spins.load(std::memory_order_relaxed); }
+    uint64_t getWaitCount() const { return m_waits.load(std::memory_order_relaxed); }
+};
+
+//! Job priorities, higher priority queues are always drained first
+enum class JobPriority : uint32_t
+{
+    eHigh,
+    eNormal,
+    eLow,
+    eCount
+};
+
+//! Shared work-stealing job pool
+//! 
+//! Each worker owns a set of per-priority deques. Jobs scheduled from a worker
+//! go to its own deque (LIFO for locality), jobs scheduled from any other thread
+//! are distributed round-robin. Idle workers steal from the opposite end of
+//! other workers' deques before going to sleep.
+//! 
+//! Affinity hint is a bit mask of logical cores the workers are allowed to run on,
+//! zero means no restriction. This is typically used to keep SL background work
+//! away from the cores the host render/game threads are running on.
+//! 
+//! Jobs can be grouped with a JobCounter which allows callers to wait for
+//! completion of a specific set of jobs (waiting thread helps executing queued jobs).
+using JobCounter = std::atomic<uint32_t>;
+
+class JobSystem
+{
+    using Job = std::pair<std::function<void(void)>, JobCounter*>;
+
+    struct Worker
     {
-        std::unique_lock<std::mutex> lock(m_mtx);
-        m_work.push_back({ perpetual, func });
-        m_workAdded = true;
-        m_jobCount++;
+        //! Held briefly by the owner and stealing workers
+        AdaptiveLock mtx;
+        std::deque<Job> queues[(uint32_t)JobPriority::eCount];
+        std::thread thread;
+    };
 
-        m_cv.notify_one();
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::mutex m_sleepMtx;
+    std::condition_variable m_sleepCv;
+    //! Scheduled and not finished yet, includes running jobs
+    std::atomic<uint32_t> m_pendingJobs = 0;
+    //! Sitting in a queue, idle workers sleep while this is zero even if long jobs are still running
+    std::atomic<uint32_t> m_queuedJobs = 0;
+    std::atomic<uint32_t> m_nextWorker = 0;
+    std::atomic<bool> m_quit = false;
+    std::wstring m_name;
 
+    static inline thread_local JobSystem* s_owner = {};
+    static inline thread_local uint32_t s_workerIndex = {};
+
+    bool popLocal(uint32_t index, Job& job)
+    {
+        auto& w = *m_workers[index];
+        std::lock_guard<AdaptiveLock> lock(w.mtx);
+        for (auto& q : w.queues)
+        {
+            if (!q.empty())
+            {
+                job = std::move(q.back());
+                q.pop_back();
+                m_queuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool steal(uint32_t thief, Job& job)
+    {
+        auto count = (uint32_t)m_workers.size();
+        // Steal high priority work from anyone before moving on to lower priorities
+        for (uint32_t p = 0; p < (uint32_t)JobPriority::eCount; p++)
+        {
+            for (uint32_t i = 1; i < count; i++)
+            {
+                auto& w = *m_workers[(thief + i) % count];
+                // Never block on a busy victim, just move on to the next one
+                std::unique_lock<AdaptiveLock> lock(w.mtx, std::try_to_lock);
+                if (lock.owns_lock() && !w.queues[p].empty())
+                {
+                    job = std::move(w.queues[p].front());
+                    w.queues[p].pop_front();
+                    m_queuedJobs.fetch_sub(1, std::memory_order_acq_rel);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    bool tryGetJob(uint32_t index, Job& job)
+    {
+        return popLocal(index, job) || steal(index, job);
+    }
+
+    void execute(Job& job)
+    {
+        // NOTE: No need to wrap this in the exception handler
+        // since all internal workers are already executing within one.
+        {
+            SL_TRACE_ZONE("JobSystem::job");
+            job.first();
+        }
+        if (job.second)
+        {
+            job.second->fetch_sub(1, std::memory_order_acq_rel);
+        }
+        if (m_pendingJobs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            // Wake up anyone waiting for the pool to go idle
+            std::lock_guard<std::mutex> lock(m_sleepMtx);
+            m_sleepCv.notify_all();
+        }
+    }
+
+    void workerFunction(uint32_t index)
+    {
+        s_owner = this;
+        s_workerIndex = index;
+        while (!m_quit)
+        {
+            Job job;
+            if (tryGetJob(index, job))
+            {
+                execute(job);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(m_sleepMtx);
+            m_sleepCv.wait(lock, [this] { return m_quit.load() || m_queuedJobs.load() > 0; });
+        }
+    }
+
+public:
+    JobSystem(const JobSystem&) = delete;
+
+    JobSystem(const wchar_t* name, uint32_t workerCount = 0, uint64_t affinityMask = 0, int priority = THREAD_PRIORITY_BELOW_NORMAL,
+              ThreadPlacement placement = ThreadPlacement::eDefault)
+    {
+        m_name = name;
+        if (!workerCount)
+        {
+            // Leave at least one core for the host
+            auto cores = std::thread::hardware_concurrency();
+            workerCount = cores > 1 ? cores - 1 : 1;
+        }
+        m_workers.resize(workerCount);
+        for (auto& w : m_workers)
+        {
+            w = std::make_unique<Worker>();
+        }
+        for (uint32_t i = 0; i < workerCount; i++)
+        {
+            auto& t = m_workers[i]->thread;
+            t = std::thread(&JobSystem::workerFunction, this, i);
+            if (affinityMask && !SetThreadAffinityMask(t.native_handle(), (DWORD_PTR)affinityMask))
+            {
+                SL_LOG_WARN("Failed to set affinity mask 0x%llx for job system '%S'", affinityMask, name);
+            }
+            if (!SetThreadPriority(t.native_handle(), priority))
+            {
+                SL_LOG_WARN("Failed to set thread priority to %d for job system '%S'", priority, name);
+            }
+            setThreadPlacement(t.native_handle(), placement);
+            SetThreadDescription(t.native_handle(), (m_name + L"." + std::to_wstring(i)).c_str());
+        }
+    }
+
+    ~JobSystem()
+    {
+        // Drain everything that was already scheduled
+        waitIdle(UINT_MAX);
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMtx);
+            m_quit = true;
+        }
+        m_sleepCv.notify_all();
+        for (auto& w : m_workers)
+        {
+            w->thread.join();
+        }
+    }
+
+    //! Schedules job for execution on any of the workers
+    //! 
+    //! If counter is provided it is incremented here and decremented once job completes.
+    bool scheduleJob(const std::function<void(void)>& func, JobPriority priority = JobPriority::eNormal, JobCounter* counter = nullptr)
+    {
+        if (m_quit || priority >= JobPriority::eCount) return false;
+
+        if (counter)
+        {
+            counter->fetch_add(1, std::memory_order_acq_rel);
+        }
+        m_pendingJobs.fetch_add(1, std::memory_order_acq_rel);
+
+        // Workers push to their own deque, everyone else round-robins
+        auto index = s_owner == this ? s_workerIndex : m_nextWorker.fetch_add(1, std::memory_order_relaxed) % (uint32_t)m_workers.size();
+        {
+            auto& w = *m_workers[index];
+            std::lock_guard<AdaptiveLock> lock(w.mtx);
+            // Counted before the job can be popped, otherwise a thief could decrement first and wrap the count
+            m_queuedJobs.fetch_add(1, std::memory_order_acq_rel);
+            w.queues[(uint32_t)priority].push_back({ func, counter });
+        }
+        {
+            // Notified under the sleep lock so a worker checking the predicate cannot miss the wake up
+            std::lock_guard<std::mutex> lock(m_sleepMtx);
+            m_sleepCv.notify_one();
+        }
         return true;
     }
+
+    //! Waits for all jobs associated with the counter to complete
+    //! 
+    //! Calling thread helps out by executing queued jobs while waiting.
+    void wait(JobCounter* counter)
+    {
+        auto index = s_owner == this ? s_workerIndex : 0;
+        while (counter->load(std::memory_order_acquire) != 0)
+        {
+            Job job;
+            if (tryGetJob(index, job))
+            {
+                execute(job);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    //! Waits for all scheduled jobs to complete
+    std::cv_status waitIdle(uint32_t timeout = 500)
+    {
+        extra::ScopedHitchTimer hitch("JobSystem::waitIdle");
+        std::unique_lock<std::mutex> lock(m_sleepMtx);
+        auto isTimeout = !m_sleepCv.wait_for(lock, std::chrono::milliseconds(timeout), [this]() { return m_pendingJobs.load() == 0; });
+        if (isTimeout)
+        {
+            SL_LOG_WARN("Job system '%S' timed out", m_name.c_str());
+        }
+        return isTimeout ? std::cv_status::timeout : std::cv_status::no_timeout;
+    }
+
+    uint32_t getWorkerCount() const { return (uint32_t)m_workers.size(); }
+    uint32_t getPendingJobCount() const { return m_pendingJobs.load(); }
+};
+
+//! Default affinity for SL background work
+//! 
+//! Excludes the first logical core since that is where most engines
+//! pin their main/render thread.
+inline uint64_t getBackgroundAffinityMask()
+{
+    DWORD_PTR processMask{}, systemMask{};
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+    {
+        return 0;
+    }
+    auto mask = (uint64_t)processMask & ~1ull;
+    return mask ? mask : (uint64_t)processMask;
+}
+
+namespace detail
+{
+inline std::mutex s_sharedJobSystemMtx;
+inline JobSystem* s_sharedJobSystem{};
+}
+
+//! Shared job pool for the module, created on first use
+inline JobSystem& getSharedJobSystem()
+{
+    std::lock_guard<std::mutex> lock(detail::s_sharedJobSystemMtx);
+    if (!detail::s_sharedJobSystem)
+    {
+        detail::s_sharedJobSystem = new JobSystem(L"sl.jobs", 0, getBackgroundAffinityMask());
+    }
+    return *detail::s_sharedJobSystem;
+}
+
+//! Drains and joins the shared pool, called from plugin and interposer shutdown
+//!
+//! Never left to a static destructor, joining threads during DLL unload deadlocks on the loader lock.
+inline void shutdownSharedJobSystem()
+{
+    JobSystem* jobs{};
+    {
+        std::lock_guard<std::mutex> lock(detail::s_sharedJobSystemMtx);
+        std::swap(jobs, detail::s_sharedJobSystem);
+    }
+    delete jobs;
+}
+
+//! Background file I/O
+//! 
+//! Separate from the shared pool so slow disk writes never hold up latency sensitive jobs.
+//! The number of jobs in flight is capped since each one typically owns a full copy of the data
+//! it is writing, when the cap is reached scheduling fails and it is up to the caller to drop or retry.
+class IOQueue
+{
+    JobSystem m_jobs;
+    JobCounter m_counter = 0;
+
+public:
+    static constexpr uint32_t kMaxPending = 32;
+
+    IOQueue(const IOQueue&) = delete;
+    IOQueue() : m_jobs(L"sl.io", 2, getBackgroundAffinityMask(), THREAD_PRIORITY_LOWEST, ThreadPlacement::eEfficiency) {}
+
+    bool schedule(const std::function<void(void)>& func)
+    {
+        if (m_counter.load(std::memory_order_acquire) >= kMaxPending) return false;
+        return m_jobs.scheduleJob(func, JobPriority::eNormal, &m_counter);
+    }
+
+    //! Blocks until everything scheduled so far is written out
+    void flush() { m_jobs.wait(&m_counter); }
+
+    uint32_t getPendingCount() const { return m_counter.load(std::memory_order_acquire); }
 };
 
+inline IOQueue& getSharedIOQueue()
+{
+    static IOQueue s_ioQueue;
+    return s_ioQueue;
+}
+
+//! Two-party lock, each side owns one flag and can only enter when the other side's flag is clear
+//! 
+//! Spins with backoff and then parks on the other side's flag instead of spinning forever.
 struct LockAtomic
 {
     LockAtomic() {};
@@ -255,12 +1157,19 @@ struct LockAtomic
 
     void lock()
     {
+        SpinBackoff backoff;
         while (true)
         {
             m_l1->store(1, std::memory_order_seq_cst);
             if (m_l2->load(std::memory_order_seq_cst) != 0)
             {
                 m_l1->store(0, std::memory_order_seq_cst);
+                m_l1->notify_all();
+                if (!backoff.spin())
+                {
+                    // Other side is holding it for a while, park until it releases
+                    m_l2->wait(1, std::memory_order_relaxed);
+                }
                 continue;
             }
             break;
@@ -270,6 +1179,7 @@ struct LockAtomic
     void unlock()
     {
         m_l1->store(0, std::memory_order_seq_cst);
+        m_l1->notify_all();
     }
 
     std::atomic<uint32_t>* m_l1{};
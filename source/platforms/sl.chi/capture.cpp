@@ -1,27 +1,268 @@
 #include "capture.h"
+#include "captureCodec.h"
 
 #ifdef SL_CAPTURE
 
 #include "source/core/sl.log/log.h"
 #include "source/platforms/sl.chi/compute.h"
+#include "source/core/sl.thread/thread.h"
 
+#include <windows.h>
 #include <time.h> 
 #include <fstream>
 #include <filesystem>
-#include <future>
 #include <atomic>
 #include <mutex>
 #include <chrono>
 #include <vector>
 #include <map>
 #include <thread>
+#include <algorithm>
 #pragma warning( disable : 4996)
 
+#include "_artifacts/shaders/capture_convert_cs.h"
+#include "_artifacts/shaders/capture_convert_spv.h"
+
 namespace sl
 {
     namespace chi
     {
 
+        //! Appends dumps to the capture file as they arrive instead of holding the whole capture in memory
+        //!
+        //! Data is staged in a small pool of sector aligned buffers which are written with unbuffered
+        //! overlapped I/O. When every buffer is in flight we wait for the oldest one, so memory use is
+        //! bounded by the pool size no matter how long the capture runs.
+        struct CaptureStreamWriter
+        {
+            static constexpr uint32_t kBufferCount = 8;
+            static constexpr uint64_t kBufferSize = 4 * 1024 * 1024;
+            // FILE_FLAG_NO_BUFFERING requires sector aligned offsets and sizes, 4K covers all current drives
+            static constexpr uint64_t kAlignment = 4096;
+
+            struct Buffer
+            {
+                char* data{};
+                uint64_t used{};
+                OVERLAPPED overlapped{};
+                bool inFlight = false;
+            };
+
+            HANDLE file = INVALID_HANDLE_VALUE;
+            Buffer buffers[kBufferCount]{};
+            uint32_t current = 0;
+            uint64_t fileOffset = 0; // Where the current buffer goes in the file
+            uint64_t totalBytes = 0; // Actual amount of data appended, the file is trimmed to this on close
+            bool failed = false;
+
+            ~CaptureStreamWriter()
+            {
+                close();
+            }
+
+            bool open(const std::string& path)
+            {
+                close();
+                file = CreateFileW(std::filesystem::path(path).wstring().c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED | FILE_FLAG_NO_BUFFERING, nullptr);
+                if (file == INVALID_HANDLE_VALUE)
+                {
+                    SL_LOG_WARN("Capture: Failed to open '%s' - error %u", path.c_str(), GetLastError());
+                    return false;
+                }
+                for (auto& b : buffers)
+                {
+                    // VirtualAlloc is page aligned which satisfies the sector alignment requirement
+                    b.data = (char*)VirtualAlloc(nullptr, kBufferSize, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+                    b.overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+                    if (!b.data || !b.overlapped.hEvent)
+                    {
+                        SL_LOG_WARN("Capture: Failed to allocate stream buffers - error %u", GetLastError());
+                        failed = true;
+                        close();
+                        return false;
+                    }
+                }
+                current = 0;
+                fileOffset = 0;
+                totalBytes = 0;
+                failed = false;
+                return true;
+            }
+
+            bool isOpen() const { return file != INVALID_HANDLE_VALUE; }
+
+            bool append(const void* src, uint64_t size)
+            {
+                auto bytes = (const char*)src;
+                while (size && !failed)
+                {
+                    auto& b = buffers[current];
+                    // Only blocks when we wrapped around onto a buffer which is still being written
+                    if (!waitFor(b)) break;
+                    uint64_t n = std::min(size, kBufferSize - b.used);
+                    memcpy(b.data + b.used, bytes, n);
+                    b.used += n;
+                    bytes += n;
+                    size -= n;
+                    totalBytes += n;
+                    if (b.used == kBufferSize)
+                    {
+                        submit();
+                    }
+                }
+                return !failed;
+            }
+
+            //! Flushes what is left, waits for all writes and trims the sector padding off the end
+            bool close()
+            {
+                if (!isOpen()) return false;
+
+                if (!failed && buffers[current].used)
+                {
+                    submit();
+                }
+                // Buffers cannot be released while the OS is still reading from them
+                for (auto& b : buffers)
+                {
+                    waitFor(b);
+                }
+                if (!failed)
+                {
+                    FILE_END_OF_FILE_INFO eof{};
+                    eof.EndOfFile.QuadPart = (LONGLONG)totalBytes;
+                    if (!SetFileInformationByHandle(file, FileEndOfFileInfo, &eof, sizeof(eof)))
+                    {
+                        SL_LOG_WARN("Capture: Failed to set the file size - error %u", GetLastError());
+                        failed = true;
+                    }
+                }
+                CloseHandle(file);
+                file = INVALID_HANDLE_VALUE;
+                for (auto& b : buffers)
+                {
+                    if (b.data) VirtualFree(b.data, 0, MEM_RELEASE);
+                    if (b.overlapped.hEvent) CloseHandle(b.overlapped.hEvent);
+                    b = {};
+                }
+                return !failed;
+            }
+
+        private:
+
+            //! Issues the current buffer at the current file offset and moves on to the next one
+            void submit()
+            {
+                auto& b = buffers[current];
+                // Only the last buffer can be partial, it is padded here and trimmed back in 'close'
+                uint64_t size = (b.used + kAlignment - 1) & ~(kAlignment - 1);
+                memset(b.data + b.used, 0, size - b.used);
+                b.overlapped.Offset = (DWORD)fileOffset;
+                b.overlapped.OffsetHigh = (DWORD)(fileOffset >> 32);
+                if (!WriteFile(file, b.data, (DWORD)size, nullptr, &b.overlapped) && GetLastError() != ERROR_IO_PENDING)
+                {
+                    SL_LOG_WARN("Capture: Error while writing to file - error %u", GetLastError());
+                    failed = true;
+                    return;
+                }
+                b.inFlight = true;
+                fileOffset += size;
+                current = (current + 1) % kBufferCount;
+            }
+
+            bool waitFor(Buffer& b)
+            {
+                if (!b.inFlight) return true;
+                b.inFlight = false;
+                b.used = 0;
+                DWORD written{};
+                if (!GetOverlappedResult(file, &b.overlapped, &written, TRUE))
+                {
+                    SL_LOG_WARN("Capture: Error while writing to file - error %u", GetLastError());
+                    failed = true;
+                    return false;
+                }
+                return true;
+            }
+        };
+
+        //! Readback buffers for one buffer type
+        //!
+        //! A copy is recorded into the next slot every frame and read out SL_DUMP_QUEUE_SIZE frames later on a
+        //! worker thread. The extra slots give that worker a couple of frames before its slot is recorded into
+        //! again, if it is still busy by then the frame is skipped instead of stalling the render thread.
+        struct ResourceReadbackQueue
+        {
+            static constexpr uint32_t kSlotCount = SL_DUMP_QUEUE_SIZE + 2;
+
+            struct Slot
+            {
+                Resource readback{};
+                uint64_t bytes{};
+                ResourceDescription desc{};
+                Extent extent{};
+                uint64_t rowPitch{};
+                uint64_t rowSizeInBytes{};
+                uint64_t predictedBytes{};
+                bool recorded = false; // Holds a copy which was not handed to readout yet, render thread only
+                std::atomic<bool> busy = false; // Being read out on a worker thread
+            };
+
+            Slot slots[kSlotCount]{};
+            uint32_t index = 0;
+
+            // Reduced copy of the resource when region, downsampling or conversion are used. The copy into
+            // the readback slot follows on the same command list so one texture covers all slots.
+            Resource converted{};
+            ResourceDescription convertedDesc{};
+        };
+
+        //! Dispatches of the conversion pass per frame, one per captured buffer type
+        constexpr uint32_t kMaxConversionsPerFrame = 16;
+
+        //! Format written by the conversion pass, keeps the channel count of the source
+        //!
+        //! Returns eFormatINVALID for formats which cannot be read as float, those are always copied as is.
+        Format getConvertedFormat(Format format, CaptureConversion conversion)
+        {
+            uint32_t channels = 4;
+            switch (format)
+            {
+                case eFormatR16F:
+                case eFormatR32F:
+                case eFormatR8UN:
+                case eFormatD32S32:
+                case eFormatD24S8:
+                case eFormatD32S8U:
+                    channels = 1;
+                    break;
+                case eFormatRG16F:
+                case eFormatRG32F:
+                case eFormatRG8UN:
+                case eFormatRG16UN:
+                    channels = 2;
+                    break;
+                case eFormatINVALID:
+                case eFormatRG16UI:
+                case eFormatRG16SI:
+                case eFormatR8UI:
+                case eFormatR16UI:
+                case eFormatR32UI:
+                case eFormatRG32UI:
+                    return eFormatINVALID;
+                default:
+                    break;
+            }
+            static constexpr Format kFormats[][3] =
+            {
+                { eFormatR32F, eFormatRG32F, eFormatRGBA32F },
+                { eFormatR8UN, eFormatRG8UN, eFormatRGBA8UN },
+                { eFormatR16F, eFormatRG16F, eFormatRGBA16F },
+            };
+            return kFormats[(uint32_t)conversion][std::min(channels, 3u) - 1];
+        }
+
         struct Capture : public ICapture
         {
             ICompute* compute;
@@ -30,13 +271,27 @@ namespace sl
             std::mutex captureStreamMutex; // Mutex for threading consistency.
             std::atomic<bool> isCapturing = false; // tell if we are capturing.
             std::chrono::steady_clock::time_point startTime; // start time of the capture session.
-            std::vector<std::pair<char*, uint64_t>> pendingDumps; // Vector of contents and length dumps that we have accumulated and are waiting to dump to the file.
+            CaptureStreamWriter stream; // Dumps are appended to the file as they arrive.
+            std::vector<CaptureIndexEntry> frameIndex; // Where each chunk went, written at the end of the file.
+
+            // Last depth/mvec payload per buffer type, the next one is delta coded against it
+            struct DeltaReference
+            {
+                std::mutex mutex;
+                int frame = -1;
+                std::vector<uint8_t> data;
+            };
+            std::map<BufferType, DeltaReference> deltaReferences;
             std::string fullPath = ""; // Filepath to use when opening a file.
-            std::thread dumpthread;
+            thread::JobCounter dumpJobs = {};
             std::mutex mtx;
 
             std::map<BufferType, ResourceReadbackQueue> m_readbackMap; //Must be destroyed in the API
-            std::vector<std::future<bool>> m_readbackThreads;
+            thread::JobCounter readbackJobs = {};
+
+            std::map<BufferType, CaptureBufferOptions> bufferOptions; // Guarded by mtx
+            CaptureBufferOptions defaultBufferOptions{}; // Guarded by mtx
+            Kernel convertKernel{}; // Created on first use, render thread only
 
             /// <summary>
             /// Deallocate
@@ -59,7 +314,7 @@ namespace sl
             virtual ComputeStatus dumpResource(int id, BufferType type, Extent& extent, CommandList cmdList, Resource src) override final;
 
             /// <summary>
-            /// Resource description and pixel data to the binary data to the pendingDumps.
+            /// Appends resource description and pixel data to the capture file.
             /// </summary>
             virtual ComputeStatus appendResourceDump(int id, BufferType type, Extent extent, ResourceDescription srcDesc, char* pixels, uint64_t bytes) override final;
 
@@ -84,7 +339,7 @@ namespace sl
             virtual ComputeStatus addToPending(char* dump, uint64_t size) override final;
 
             /// <summary>
-            /// Dumps the pendingDumps into a file all at once and ends the capture.
+            /// Flushes the remaining dumps to the file and ends the capture.
             /// </summary>
             virtual ComputeStatus dumpPending() override final;
 
@@ -117,6 +372,31 @@ namespace sl
             /// Tell if we are currently capturing.
             /// </summary>
             virtual bool getIsCapturing() override final;
+
+            /// <summary>
+            /// Sets how a buffer type is captured, nullptr goes back to the default options.
+            /// </summary>
+            virtual void setBufferOptions(BufferType type, const CaptureBufferOptions* options) override final;
+
+            /// <summary>
+            /// Sets the options used for buffer types without their own.
+            /// </summary>
+            virtual void setDefaultBufferOptions(const CaptureBufferOptions& options) override final;
+
+            /// <summary>
+            /// Encodes the pieces of a dump as one chunk and appends it to the capture file.
+            /// </summary>
+            ComputeStatus appendToStream(CaptureChunkKind kind, int id, BufferType type, const std::pair<const void*, uint64_t>* pieces, size_t count);
+
+            /// <summary>
+            /// Maps a recorded readback slot, copies the rows out and appends them to the capture.
+            /// </summary>
+            void readbackSlot(CommandList cmdList, ResourceReadbackQueue::Slot& slot, int id, BufferType type);
+
+            /// <summary>
+            /// Records the compute pass reducing a resource into 'rrq.converted', moves 'extent' into the reduced data.
+            /// </summary>
+            ComputeStatus convertResource(CommandList cmdList, ResourceReadbackQueue& rrq, const CaptureBufferOptions& options, Format format, Resource src, const ResourceDescription& srcDesc, Extent& extent);
         };
 
         Capture CaptureSystem = Capture{};
@@ -128,11 +408,11 @@ namespace sl
         ComputeStatus cleanResources(ICompute* compute, std::map<BufferType, ResourceReadbackQueue>* readbackMap) {
             for (auto& rb : *readbackMap)
             {
-                CHI_CHECK(compute->destroyResource(rb.second.target));
-                for (int i = 0; i < SL_DUMP_QUEUE_SIZE; i++)
+                for (auto& slot : rb.second.slots)
                 {
-                    CHI_CHECK(compute->destroyResource(rb.second.readback[i]));
+                    CHI_CHECK(compute->destroyResource(slot.readback));
                 }
+                CHI_CHECK(compute->destroyResource(rb.second.converted));
             }
             readbackMap->clear();
             return ComputeStatus::eOk;
@@ -144,8 +424,9 @@ namespace sl
             int captureIndex,
             std::string fullPath, 
             std::mutex* captureStreamMutex,
-            std::vector<std::pair<char*, uint64_t>>* pendingDumps,
-            std::vector<std::future<bool>>* m_readbackThreads,
+            CaptureStreamWriter* stream,
+            std::vector<CaptureIndexEntry>* frameIndex,
+            thread::JobCounter* readbackJobs,
             std::map<BufferType, ResourceReadbackQueue>* readbackMap)
         {
             
@@ -159,39 +440,29 @@ namespace sl
                 }
             }
 
-            // Wait for all the threads to finish
-            for (int i = 0; i < m_readbackThreads->size(); i++) m_readbackThreads->at(i).wait();
+            // Wait for all the readouts to finish, the waiting thread helps executing them
+            thread::getSharedJobSystem().wait(readbackJobs);
 
-            // Now we lock the capture and we write to file.
+            // Everything was already streamed out, just flush the tail and close the file
             std::scoped_lock lock(*captureStreamMutex);
 
             isCapturing->store(false);
 
-            /// Capture
-            auto captureStream = std::ofstream(fullPath.c_str(), std::ios::binary);
-
-            if (!captureStream.is_open())
-            {
-                SL_LOG_WARN("Capture: Failed to open filestream.");
-                captureStream.close();
-                return ComputeStatus::eError;
-            }
+            CaptureFileFooter footer{};
+            footer.indexOffset = stream->totalBytes;
+            footer.indexCount = frameIndex->size();
+            bool written = stream->append(frameIndex->data(), frameIndex->size() * sizeof(CaptureIndexEntry)) && stream->append(&footer, sizeof(footer));
+            written = stream->close() && written;
+            frameIndex->clear();
 
-            for (auto i : (*pendingDumps)) captureStream.write(i.first, i.second);
+            // Clean up 
+            cleanResources(compute, readbackMap);
 
-            if (!captureStream.good())
+            if (!written)
             {
-                SL_LOG_WARN("Capture: Error while writing to filestream.");
-                captureStream.close();
+                SL_LOG_WARN("Capture: Failed to write '%s'.", fullPath.c_str());
                 return ComputeStatus::eError;
             }
-            captureStream.close();
-
-            // Clean up 
-            m_readbackThreads->clear();
-            for (auto i : (*pendingDumps)) delete[] i.first;
-            pendingDumps->clear();
-            cleanResources(compute, readbackMap);
 
             SL_LOG_INFO("Capture: Dump finished successfully.");
 
@@ -199,7 +470,11 @@ namespace sl
         }
 
         Capture::~Capture() {
-            if (dumpthread.joinable()) dumpthread.join();
+            // Shared job system drains all pending jobs on shutdown
+            while (dumpJobs.load() || readbackJobs.load())
+            {
+                std::this_thread::yield();
+            }
         }
 
 
@@ -220,18 +495,53 @@ namespace sl
 
             // Find the ResourceReadbackQueue for a resource, if not there then create it
             ResourceReadbackQueue* rrq = {};
+            CaptureBufferOptions options{};
             {
                 std::scoped_lock<std::mutex> lock(mtx);
-                auto it = m_readbackMap.find(type);
-                if (it == m_readbackMap.end()) {
-                    m_readbackMap[type] = {};
-                    rrq = &m_readbackMap[type];
+                rrq = &m_readbackMap.try_emplace(type).first->second;
+                auto it = bufferOptions.find(type);
+                options = it != bufferOptions.end() ? it->second : defaultBufferOptions;
+            }
+
+            // Hand the copy recorded SL_DUMP_QUEUE_SIZE frames ago to a worker, the render thread never maps
+            auto& ready = rrq->slots[(rrq->index + ResourceReadbackQueue::kSlotCount - SL_DUMP_QUEUE_SIZE) % ResourceReadbackQueue::kSlotCount];
+            // Shortcut incase id is not yet caught up to lag
+            if (ready.recorded && id >= 0)
+            {
+                RenderAPI api{};
+                compute->getRenderAPI(api);
+                if (api == RenderAPI::eD3D11)
+                {
+                    // D3D11 maps through the immediate context which is not thread safe, only the encode and write move off this thread
+                    readbackSlot(cmdList, ready, id, type);
+                }
+                else
+                {
+                    ready.busy.store(true, std::memory_order_relaxed);
+                    thread::getSharedJobSystem().scheduleJob([this, &ready, id, type]()->void
+                    {
+                        readbackSlot(nullptr, ready, id, type);
+                        ready.busy.store(false, std::memory_order_release);
+                    }, thread::JobPriority::eLow, &readbackJobs);
                 }
-                else rrq = &(*it).second;
+            }
+            ready.recorded = false;
+
+            auto& slot = rrq->slots[rrq->index];
+            rrq->index = (rrq->index + 1) % ResourceReadbackQueue::kSlotCount;
+            if (slot.busy.load(std::memory_order_acquire))
+            {
+                // Worker is still reading this slot out, drop the frame rather than wait for it
+                SL_LOG_WARN_ONCE("Capture: Readback of buffer type %u fell behind, skipping frames", type);
+                return ComputeStatus::eOk;
+            }
+
+            // What is recorded now gets the label SL_DUMP_QUEUE_SIZE frames later, the interval applies to that label
+            if (options.frameInterval > 1 && (id + SL_DUMP_QUEUE_SIZE) % (int)options.frameInterval != 0)
+            {
+                return ComputeStatus::eOk;
             }
 
-            // Get the byte size of the resource
-            size_t bpp;
             auto format = srcDesc.format;
             if (format == eFormatINVALID && srcDesc.nativeFormat != NativeFormatUnknown)
             {
@@ -242,110 +552,202 @@ namespace sl
                 }
             }
 
+            // Reduce on the GPU first so only the reduced data is copied back
+            Resource copySrc = src;
+            ResourceDescription copyDesc = srcDesc;
+            Extent copyExtent = extent;
+            bool reduce = options.region || options.downsample > 1 || options.conversion != CaptureConversion::eNone;
+            if (reduce && getConvertedFormat(format, options.conversion) == eFormatINVALID)
+            {
+                SL_LOG_WARN_ONCE("Capture: Buffer type %u with format %u cannot be converted, capturing it as is", type, format);
+                reduce = false;
+            }
+            if (reduce)
+            {
+                CHI_CHECK(convertResource(cmdList, *rrq, options, format, src, srcDesc, copyExtent));
+                copySrc = rrq->converted;
+                copyDesc = rrq->convertedDesc;
+                format = getConvertedFormat(format, options.conversion);
+            }
+
+            // Get the byte size of the resource
+            size_t bpp;
             compute->getBytesPerPixel(format, bpp);
-            uint64_t predictedbytes = bpp * srcDesc.width * srcDesc.height;
-            uint64_t rowSizeInBytes = bpp * srcDesc.width;
+            uint64_t predictedbytes = bpp * copyDesc.width * copyDesc.height;
+            uint64_t rowSizeInBytes = bpp * copyDesc.width;
 
             ResourceFootprint footprint;
-            compute->getResourceFootprint(src, footprint);
+            compute->getResourceFootprint(copySrc, footprint);
             uint64_t bytes = footprint.totalBytes;
 
-            // if the readback has a buffer then check its readback states.
-            if (rrq->readback[rrq->index])
+            if (slot.readback && slot.bytes < bytes)
             {
-                // Shortcut incase id is not yet caught up to lag
-                if (id >= 0) {
-
-                    // If there is already a buffer
-                    // Create a map between the resource and a data pointer
-                    // And read the data
-                    {
-                        Resource res = rrq->readback[rrq->index];
-                        void* data;
-                        compute->mapResource(cmdList, res, data, 0, 0, bytes);
-                        if (!data) {
-                            SL_LOG_WARN("Capture: Failed to map readback resource.");
-                        } else {
-                            char* pixels = new char[predictedbytes];
-                            for (uint64_t y = 0; y < srcDesc.height; y++)
-                            {
-                                void* gpu_ptr = (char*)data + y * footprint.rowPitch;
-                                void* cpu_ptr = (char*)pixels + y * rowSizeInBytes;
-                                memcpy(cpu_ptr, gpu_ptr, rowSizeInBytes);
-                            }
-                            compute->unmapResource(cmdList, res, 0);
-                            // Launch a thread to add it to queue
-                            m_readbackThreads.push_back(std::async(std::launch::async, [this, id, type, extent, srcDesc, pixels, predictedbytes]()->bool {
-                                return this->appendResourceDump(id, type, extent, srcDesc, pixels, predictedbytes);
-                                }));
-                        }
-                    }
-                }
+                // Resolution went up, the old buffer is too small
+                CHI_CHECK(compute->destroyResource(slot.readback));
+                slot.readback = {};
             }
-            // if it does not have a buffer
-            else
+            if (!slot.readback)
             {
                 // create a readback buffer for CPU access
                 ResourceDescription desc((uint32_t) bytes, 1, chi::eFormatINVALID, chi::eHeapTypeReadback, chi::ResourceState::eCopyDestination);
-                CHI_CHECK(compute->createBuffer(desc, rrq->readback[rrq->index], (std::string("chi.capture.") + std::to_string((size_t)src) + "." + std::to_string(rrq->index)).c_str()));
+                CHI_CHECK(compute->createBuffer(desc, slot.readback, (std::string("chi.capture.") + std::to_string((size_t)src) + "." + std::to_string(rrq->index)).c_str()));
+                slot.bytes = bytes;
             }
 
-            // Once we are done creating/using the resource
             // Transition an and copy the buffer to it
             {
                 extra::ScopedTasks revTransitions;
                 chi::ResourceTransition transitions[] =
                 {
-                    {src, chi::ResourceState::eCopySource, srcDesc.state},
+                    {copySrc, chi::ResourceState::eCopySource, copyDesc.state},
                 };
                 CHI_CHECK(compute->transitionResources(cmdList, transitions, (uint32_t)countof(transitions), &revTransitions));
 
-                compute->copyDeviceTextureToDeviceBuffer(cmdList, src, rrq->readback[rrq->index]);
+                compute->copyDeviceTextureToDeviceBuffer(cmdList, copySrc, slot.readback);
                 
             }
 
-            // increment the index
-            rrq->index = (rrq->index + 1) % SL_DUMP_QUEUE_SIZE;
+            // Everything the readout needs, the resource itself may change before we get to it
+            slot.desc = copyDesc;
+            slot.extent = copyExtent;
+            slot.rowPitch = footprint.rowPitch;
+            slot.rowSizeInBytes = rowSizeInBytes;
+            slot.predictedBytes = predictedbytes;
+            slot.recorded = true;
 
             return ComputeStatus::eOk;
         }
 
 
-        ComputeStatus Capture::appendResourceDump(int id, BufferType type, Extent extent, ResourceDescription srcDesc, char* pixels, uint64_t bytes) {
-            /// <summary>
-            /// Adds resource data to the dump
-            /// </summary>
+        ComputeStatus Capture::convertResource(CommandList cmdList, ResourceReadbackQueue& rrq, const CaptureBufferOptions& options, Format format, Resource src, const ResourceDescription& srcDesc, Extent& extent)
+        {
+            // Region is clamped to the resource, partial blocks at its edges are kept
+            Extent region{ 0, 0, srcDesc.width, srcDesc.height };
+            if (options.region)
+            {
+                region.left = std::min(options.region.left, srcDesc.width - 1);
+                region.top = std::min(options.region.top, srcDesc.height - 1);
+                region.width = std::min(options.region.width, srcDesc.width - region.left);
+                region.height = std::min(options.region.height, srcDesc.height - region.top);
+            }
+            uint32_t factor = std::clamp(options.downsample, 1u, SL_DUMP_MAX_DOWNSAMPLE);
+            uint32_t width = (region.width + factor - 1) / factor;
+            uint32_t height = (region.height + factor - 1) / factor;
 
-            // The capture runs with a delay of SL_DUMP_QUEUE_SIZE. So we need to pre-empt it.
-            if (id < 0) { return ComputeStatus::eOk; }
+            Format convertedFormat = getConvertedFormat(format, options.conversion);
+            if (!rrq.converted || rrq.convertedDesc.width != width || rrq.convertedDesc.height != height || rrq.convertedDesc.format != convertedFormat)
+            {
+                // Destruction is delayed by a few frames, copies still in flight are fine
+                CHI_CHECK(compute->destroyResource(rrq.converted));
+                rrq.converted = {};
+                ResourceDescription desc(width, height, convertedFormat, eHeapTypeDefault, ResourceState::eStorageRW, ResourceFlags::eShaderResourceStorage);
+                CHI_CHECK(compute->createTexture2D(desc, rrq.converted, "chi.capture.converted"));
+                CHI_CHECK(compute->getResourceDescription(rrq.converted, rrq.convertedDesc));
+                rrq.convertedDesc.format = convertedFormat;
+            }
 
-            uint64_t totalSize = SL_DUMP_SIZE_OF_LABELS + sizeof(int) + sizeof(BufferType) + sizeof(Extent) + sizeof(ResourceDescription) + sizeof(uint64_t) + bytes;
+            if (!convertKernel)
+            {
+                RenderAPI api{};
+                compute->getRenderAPI(api);
+                if (api == RenderAPI::eVulkan)
+                {
+                    CHI_CHECK(compute->createKernel((void*)capture_convert_spv, capture_convert_spv_len, "capture_convert.cs", "main", convertKernel));
+                }
+                else
+                {
+                    CHI_CHECK(compute->createKernel((void*)capture_convert_cs, capture_convert_cs_len, "capture_convert.cs", "main", convertKernel));
+                }
+            }
 
-            char* data = new char[totalSize];
+            struct ConvertConsts
+            {
+                uint32_t origin[2];
+                uint32_t size[2];
+                uint32_t last[2];
+                uint32_t downsample;
+                uint32_t padding;
+            };
+            ConvertConsts cb{ { region.left, region.top }, { width, height }, { region.left + region.width - 1, region.top + region.height - 1 }, factor, 0 };
 
-            totalSize = 0;
+            {
+                extra::ScopedTasks revTransitions;
+                chi::ResourceTransition transitions[] =
+                {
+                    {src, chi::ResourceState::eTextureRead, srcDesc.state},
+                };
+                CHI_CHECK(compute->transitionResources(cmdList, transitions, (uint32_t)countof(transitions), &revTransitions));
 
-            memcpy(data + totalSize, resourceLabel, SL_DUMP_SIZE_OF_LABELS);
-            totalSize += SL_DUMP_SIZE_OF_LABELS;
+                CHI_CHECK(compute->bindKernel(convertKernel));
+                CHI_CHECK(compute->bindTexture(0, 0, src));
+                CHI_CHECK(compute->bindRWTexture(1, 0, rrq.converted));
+                CHI_CHECK(compute->bindConsts(2, 0, &cb, sizeof(cb), kMaxConversionsPerFrame));
+                CHI_CHECK(compute->dispatch((width + 16 - 1) / 16, (height + 16 - 1) / 16, 1));
+            }
 
-            memcpy(data + totalSize, &id, sizeof(int));
-            totalSize += sizeof(int);
+            // Tagged extent relative to the reduced data, nothing to do if the whole resource was used
+            if (extent)
+            {
+                uint32_t left = std::clamp(extent.left, region.left, region.left + region.width) - region.left;
+                uint32_t top = std::clamp(extent.top, region.top, region.top + region.height) - region.top;
+                uint32_t right = std::clamp(extent.left + extent.width, region.left, region.left + region.width) - region.left;
+                uint32_t bottom = std::clamp(extent.top + extent.height, region.top, region.top + region.height) - region.top;
+                extent = { top / factor, left / factor, (right + factor - 1) / factor - left / factor, (bottom + factor - 1) / factor - top / factor };
+            }
+            return ComputeStatus::eOk;
+        }
 
-            memcpy(data + totalSize, &type, sizeof(BufferType));
-            totalSize += sizeof(BufferType);
+        void Capture::readbackSlot(CommandList cmdList, ResourceReadbackQueue::Slot& slot, int id, BufferType type)
+        {
+            void* data{};
+            compute->mapResource(cmdList, slot.readback, data, 0, 0, slot.bytes);
+            if (!data)
+            {
+                SL_LOG_WARN("Capture: Failed to map readback resource.");
+                return;
+            }
+            char* pixels = new char[slot.predictedBytes];
+            for (uint64_t y = 0; y < slot.desc.height; y++)
+            {
+                memcpy(pixels + y * slot.rowSizeInBytes, (char*)data + y * slot.rowPitch, slot.rowSizeInBytes);
+            }
+            compute->unmapResource(cmdList, slot.readback, 0);
+            if (cmdList)
+            {
+                // Mapped on the render thread, encoding and writing still happen in the background
+                auto desc = slot.desc;
+                auto extent = slot.extent;
+                auto bytes = slot.predictedBytes;
+                thread::getSharedJobSystem().scheduleJob([this, id, type, extent, desc, pixels, bytes]()->void
+                {
+                    appendResourceDump(id, type, extent, desc, pixels, bytes);
+                }, thread::JobPriority::eLow, &readbackJobs);
+                return;
+            }
+            appendResourceDump(id, type, slot.extent, slot.desc, pixels, slot.predictedBytes);
+        }
 
-            memcpy(data + totalSize, &extent, sizeof(Extent));
-            totalSize += sizeof(Extent);
+        ComputeStatus Capture::appendResourceDump(int id, BufferType type, Extent extent, ResourceDescription srcDesc, char* pixels, uint64_t bytes) {
+            /// <summary>
+            /// Adds resource data to the dump
+            /// </summary>
 
-            memcpy(data + totalSize, &srcDesc, sizeof(ResourceDescription));
-            totalSize += sizeof(ResourceDescription);
+            // The capture runs with a delay of SL_DUMP_QUEUE_SIZE. So we need to pre-empt it.
+            if (id < 0) { delete[] pixels; return ComputeStatus::eOk; }
 
-            memcpy(data + totalSize, pixels, bytes);
-            totalSize += bytes;
+            // Written straight from the pixel copy, same layout as before without staging the whole dump
+            const std::pair<const void*, uint64_t> chunks[] =
+            {
+                { resourceLabel, SL_DUMP_SIZE_OF_LABELS },
+                { &id, sizeof(int) },
+                { &type, sizeof(BufferType) },
+                { &extent, sizeof(Extent) },
+                { &srcDesc, sizeof(ResourceDescription) },
+                { pixels, bytes },
+            };
+            ComputeStatus status = appendToStream(eCaptureChunkResource, id, type, chunks, countof(chunks));
             delete[] pixels;
 
-            ComputeStatus status = addToPending(data, totalSize);
-
             return status;
         }
 
@@ -357,25 +759,14 @@ namespace sl
             // The capture runs with a delay of SL_DUMP_QUEUE_SIZE. So we need to pre-empt it.
             if (id < 0) { return ComputeStatus::eOk; }
             
-            uint64_t totalSize = SL_DUMP_SIZE_OF_LABELS + sizeof(int) + sizeof(double) + sizeof(Constants);
-
-            char* data = new char[totalSize];
-
-            totalSize = 0;
-
-            memcpy(data + totalSize, constGloLabel, SL_DUMP_SIZE_OF_LABELS);
-            totalSize += SL_DUMP_SIZE_OF_LABELS;
-
-            memcpy(data + totalSize, &id, sizeof(int));
-            totalSize += sizeof(int);
-
-            memcpy(data + totalSize, &time, sizeof(double));
-            totalSize += sizeof(double);
-
-            memcpy(data + totalSize, ptrConsts, sizeof(Constants));
-            totalSize += sizeof(Constants);
-
-            return addToPending(data, totalSize);
+            const std::pair<const void*, uint64_t> chunks[] =
+            {
+                { constGloLabel, SL_DUMP_SIZE_OF_LABELS },
+                { &id, sizeof(int) },
+                { &time, sizeof(double) },
+                { ptrConsts, sizeof(Constants) },
+            };
+            return appendToStream(eCaptureChunkGlobalConstants, id, 0, chunks, countof(chunks));
 
         }
 
@@ -387,25 +778,14 @@ namespace sl
             // The capture runs with a delay of SL_DUMP_QUEUE_SIZE. So we need to pre-empt it.
             if (id < 0) { return ComputeStatus::eOk; }
 
-            uint64_t totalSize = SL_DUMP_SIZE_OF_LABELS + sizeof(int) + sizeof(int) + sizeConsts;
-
-            char* data = new char[totalSize];
-
-            totalSize = 0;
-
-            memcpy(data + totalSize, constFeaLabel, SL_DUMP_SIZE_OF_LABELS);
-            totalSize += SL_DUMP_SIZE_OF_LABELS;
-
-            memcpy(data + totalSize, &id, sizeof(int));
-            totalSize += sizeof(int);
-
-            memcpy(data + totalSize, &counter, sizeof(int));
-            totalSize += sizeof(int);
-
-            memcpy(data + totalSize, ptrConsts, sizeConsts);
-            totalSize += sizeConsts;
-
-            return addToPending(data, totalSize);
+            const std::pair<const void*, uint64_t> chunks[] =
+            {
+                { constFeaLabel, SL_DUMP_SIZE_OF_LABELS },
+                { &id, sizeof(int) },
+                { &counter, sizeof(int) },
+                { ptrConsts, (uint64_t)sizeConsts },
+            };
+            return appendToStream(eCaptureChunkFeatureConstants, id, 0, chunks, countof(chunks));
 
         }
 
@@ -423,6 +803,22 @@ namespace sl
             fullPath = path + "SLCapture_" + std::to_string(maxCaptureIndex) + "_" + plugin + "_" + dt +".sldump";
             startTime = std::chrono::high_resolution_clock::now();
 
+            CaptureFileHeader header{};
+            if (!stream.open(fullPath) || !stream.append(&header, sizeof(header)))
+            {
+                stream.close();
+                return ComputeStatus::eError;
+            }
+            frameIndex.clear();
+            {
+                std::scoped_lock<std::mutex> referenceLock(mtx);
+                for (auto& [type, reference] : deltaReferences)
+                {
+                    reference.frame = -1;
+                    reference.data.clear();
+                }
+            }
+
             captureIndex = -SL_DUMP_QUEUE_SIZE;
             isCapturing = true;
             SL_LOG_INFO("Caputure: Start - %i frames for plugin %s", maxCaptureIndex, plugin.c_str());
@@ -431,11 +827,73 @@ namespace sl
         }
 
         ComputeStatus Capture::addToPending(char* dump, uint64_t size) {
+            const std::pair<const void*, uint64_t> chunk = { dump, size };
+            ComputeStatus status = appendToStream(eCaptureChunkRaw, captureIndex, 0, &chunk, 1);
+            delete[] dump;
+            return status;
+        }
+
+        ComputeStatus Capture::appendToStream(CaptureChunkKind kind, int id, BufferType type, const std::pair<const void*, uint64_t>* pieces, size_t count) {
+            if (!isCapturing) return ComputeStatus::eError;
+
+            // Encoding happens on the calling (readback) thread, only the final append is serialized
+            std::vector<uint8_t> raw;
+            for (size_t i = 0; i < count; i++)
+            {
+                auto bytes = (const uint8_t*)pieces[i].first;
+                raw.insert(raw.end(), bytes, bytes + pieces[i].second);
+            }
+
+            CaptureChunkHeader header{};
+            header.kind = kind;
+            header.frame = id;
+            header.bufferType = type;
+            header.rawSize = raw.size();
+
+            // Depth and motion vectors barely change between frames, XOR against the previous one leaves mostly zeros
+            if (kind == eCaptureChunkResource && (type == kBufferTypeDepth || type == kBufferTypeMotionVectors))
+            {
+                DeltaReference* reference = {};
+                {
+                    std::scoped_lock<std::mutex> referenceLock(mtx);
+                    reference = &deltaReferences[type];
+                }
+                std::scoped_lock referenceLock(reference->mutex);
+                bool isKey = id % SL_DUMP_KEY_FRAME_INTERVAL == 0 || reference->frame < 0 || reference->data.size() != raw.size();
+                if (isKey)
+                {
+                    reference->data = raw;
+                }
+                else
+                {
+                    codec::deltaXor(raw.data(), reference->data.data(), raw.size());
+                    header.codec |= eCaptureCodecDeltaXor;
+                    header.referenceFrame = reference->frame;
+                }
+                reference->frame = id;
+            }
+
+            std::vector<uint8_t> compressed(codec::lz4CompressBound(raw.size()));
+            std::vector<uint32_t> table;
+            size_t compressedSize = codec::lz4Compress(raw.data(), raw.size(), compressed.data(), table);
+            const uint8_t* payload = raw.data();
+            header.storedSize = raw.size();
+            if (compressedSize < raw.size())
+            {
+                header.codec |= eCaptureCodecLZ4;
+                header.storedSize = compressedSize;
+                payload = compressed.data();
+            }
+
             std::scoped_lock lock(captureStreamMutex);
 
             if (!isCapturing) return ComputeStatus::eError;
 
-            pendingDumps.push_back(std::make_pair(dump, size));
+            frameIndex.push_back({ id, kind, type, 0, stream.totalBytes });
+            if (!stream.append(&header, sizeof(header)) || !stream.append(payload, header.storedSize))
+            {
+                return ComputeStatus::eError;
+            }
 
             return ComputeStatus::eOk;
         }
@@ -447,8 +905,15 @@ namespace sl
                 return ComputeStatus::eError;
             }
 
-            if (dumpthread.joinable()) dumpthread.join();
-            dumpthread = std::thread(&dump_threadFunction, compute, &isCapturing, captureIndex, fullPath, &captureStreamMutex, &pendingDumps, &m_readbackThreads, &m_readbackMap);
+            // Previous dump must be fully written out before we start a new one
+            auto& jobs = thread::getSharedJobSystem();
+            jobs.wait(&dumpJobs);
+            auto index = captureIndex;
+            auto path = fullPath;
+            jobs.scheduleJob([this, index, path]()->void
+            {
+                dump_threadFunction(compute, &isCapturing, index, path, &captureStreamMutex, &stream, &frameIndex, &readbackJobs, &m_readbackMap);
+            }, thread::JobPriority::eLow, &dumpJobs);
             
             captureIndex = INT_MIN;
             return ComputeStatus::eOk;
@@ -482,6 +947,23 @@ namespace sl
             return isCapturing;
         }
 
+        void Capture::setBufferOptions(BufferType type, const CaptureBufferOptions* options) {
+            std::scoped_lock<std::mutex> lock(mtx);
+            if (options)
+            {
+                bufferOptions[type] = *options;
+            }
+            else
+            {
+                bufferOptions.erase(type);
+            }
+        }
+
+        void Capture::setDefaultBufferOptions(const CaptureBufferOptions& options) {
+            std::scoped_lock<std::mutex> lock(mtx);
+            defaultBufferOptions = options;
+        }
+
     }
 }
 
@@ -20,6 +20,77 @@ namespace sl
     constexpr int SL_DUMP_QUEUE_SIZE = 3; // Size of Capture Queue. This also defines the lag between frame copy and text copy.
     constexpr int SL_DUMP_SIZE_OF_LABELS = 20; // This is the size of all the predefined str labels when exporting the binary. The constant size makes it easier to parse.
 
+    /// <summary>
+    /// Capture file layout
+    ///
+    /// CaptureFileHeader, then one chunk per dump and at the end the frame index followed by CaptureFileFooter.
+    /// Each chunk is a CaptureChunkHeader followed by 'storedSize' bytes of payload. Once decoded the payload
+    /// is 'rawSize' bytes in the same layout as the flat dumps used to have (label, ids, structures, pixels).
+    ///
+    /// Decoding is done in reverse order of the codec flags:
+    /// - eCaptureCodecLZ4, the payload is a raw LZ4 block (no frame header) and any LZ4 block decoder works
+    /// - eCaptureCodecDeltaXor, the payload is XOR-ed with the decoded payload of 'referenceFrame' for
+    ///   the same buffer type. Only depth and motion vectors are delta coded, with a key chunk (no delta)
+    ///   every SL_DUMP_KEY_FRAME_INTERVAL frames so random access never has to walk far back.
+    ///
+    /// If the capture was not finished cleanly the footer is missing, chunks can still be walked front to back.
+    /// </summary>
+    constexpr uint32_t SL_DUMP_FILE_VERSION = 2;
+    constexpr uint32_t SL_DUMP_CHUNK_MAGIC = 0x4B434C53;  // "SLCK" on disk
+    constexpr uint32_t SL_DUMP_FOOTER_MAGIC = 0x49434C53; // "SLCI" on disk
+    constexpr int SL_DUMP_KEY_FRAME_INTERVAL = 16;
+
+    enum CaptureChunkKind : uint32_t
+    {
+        eCaptureChunkResource,
+        eCaptureChunkGlobalConstants,
+        eCaptureChunkFeatureConstants,
+        eCaptureChunkRaw,
+    };
+
+    enum CaptureCodec : uint32_t
+    {
+        eCaptureCodecNone = 0,
+        eCaptureCodecLZ4 = 1 << 0,
+        eCaptureCodecDeltaXor = 1 << 1,
+    };
+
+    struct CaptureFileHeader
+    {
+        char magic[8] = { 'S', 'L', 'C', 'A', 'P', 'T', 'U', 'R' };
+        uint32_t version = SL_DUMP_FILE_VERSION;
+        uint32_t reserved = 0;
+    };
+
+    struct CaptureChunkHeader
+    {
+        uint32_t magic = SL_DUMP_CHUNK_MAGIC;
+        CaptureChunkKind kind = eCaptureChunkRaw;
+        int32_t frame = 0;
+        int32_t referenceFrame = -1; // Frame this chunk was delta coded against, -1 if none
+        uint32_t codec = eCaptureCodecNone;
+        BufferType bufferType = 0; // Resource chunks only
+        uint64_t rawSize = 0;
+        uint64_t storedSize = 0;
+    };
+
+    struct CaptureIndexEntry
+    {
+        int32_t frame = 0;
+        CaptureChunkKind kind = eCaptureChunkRaw;
+        BufferType bufferType = 0;
+        uint32_t reserved = 0;
+        uint64_t offset = 0; // File offset of the CaptureChunkHeader
+    };
+
+    struct CaptureFileFooter
+    {
+        uint64_t indexOffset = 0;
+        uint64_t indexCount = 0;
+        uint32_t magic = SL_DUMP_FOOTER_MAGIC;
+        uint32_t version = SL_DUMP_FILE_VERSION;
+    };
+
     namespace chi
     {
 
@@ -29,13 +100,30 @@ namespace sl
         using CommandList = void*;
         using Resource = sl::Resource*;
 
-        struct ResourceReadbackQueue
+        enum class CaptureConversion : uint32_t
         {
-            Resource target;
-            Resource readback[SL_DUMP_QUEUE_SIZE];
-            uint32_t index = 0;
+            eNone, // Keeps the source precision
+            eUnorm8,
+            eFloat16,
         };
 
+        /// <summary>
+        /// Reduces what is captured for a buffer type, the defaults capture everything at full precision.
+        ///
+        /// Region, downsampling and conversion are applied by a compute pass before the readback so only the
+        /// reduced data is ever copied to the CPU. The converted texture keeps the channel count of the source,
+        /// recorded descriptions and extents describe the reduced data. Integer formats are always copied as is.
+        /// </summary>
+        struct CaptureBufferOptions
+        {
+            Extent region{}; // Region of interest in pixels of the resource, empty captures the whole resource
+            uint32_t frameInterval = 1; // Captures every Nth frame only
+            uint32_t downsample = 1; // Box filters NxN pixels into one, up to SL_DUMP_MAX_DOWNSAMPLE
+            CaptureConversion conversion = CaptureConversion::eNone;
+        };
+
+        constexpr uint32_t SL_DUMP_MAX_DOWNSAMPLE = 16;
+
         /// <summary>
         /// This class encapsulates are the capture mechanisms.
         // </summary>
@@ -57,7 +145,7 @@ namespace sl
             virtual ComputeStatus dumpResource(int id, BufferType type, Extent& extent, CommandList cmdList, Resource src) = 0;
 
             /// <summary>
-            /// Resource description and pixel data to the binary data to the pendingDumps.
+            /// Appends resource description and pixel data to the capture file.
             /// </summary>
             virtual ComputeStatus appendResourceDump(int id, BufferType type, Extent extent, ResourceDescription srcDesc, char* pixels, uint64_t bytes) = 0;
 
@@ -82,7 +170,7 @@ namespace sl
             virtual ComputeStatus addToPending(char* dump, uint64_t size) = 0;
 
             /// <summary>
-            /// Dumps the pendingDumps into a file all at once and ends the capture.
+            /// Flushes the remaining dumps to the file and ends the capture.
             /// </summary>
             virtual ComputeStatus dumpPending() = 0;
 
@@ -115,6 +203,16 @@ namespace sl
             /// Tell if we are currently capturing.
             /// </summary>
             virtual bool getIsCapturing() = 0;
+
+            /// <summary>
+            /// Sets how a buffer type is captured, nullptr goes back to the default options.
+            /// </summary>
+            virtual void setBufferOptions(BufferType type, const CaptureBufferOptions* options) = 0;
+
+            /// <summary>
+            /// Sets the options used for buffer types without their own, e.g. downsampled previews for everything but a few buffers.
+            /// </summary>
+            virtual void setDefaultBufferOptions(const CaptureBufferOptions& options) = 0;
         };
 
         ICapture* getCapture();
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+//! Codecs used by the capture container, see the file layout in capture.h
+//!
+//! Shared by the capture writer and tools reading captures back.
+namespace sl
+{
+    namespace chi
+    {
+        namespace codec
+        {
+            constexpr uint32_t kHashLog = 16;
+            constexpr size_t kMinMatch = 4;
+            constexpr size_t kLastLiterals = 5; // LZ4 requires the last 5 bytes to be literals
+            constexpr size_t kMatchStartLimit = 12; // and the last match to start at least 12 bytes before the end
+            constexpr size_t kMaxOffset = 65535;
+
+            inline size_t lz4CompressBound(size_t size) { return size + size / 255 + 16; }
+
+            inline void writeLength(uint8_t*& op, size_t length)
+            {
+                for (; length >= 255; length -= 255) *op++ = 255;
+                *op++ = (uint8_t)length;
+            }
+
+            inline void writeSequence(uint8_t*& op, const uint8_t* literals, size_t literalLength, size_t offset, size_t matchLength)
+            {
+                uint8_t* token = op++;
+                *token = (uint8_t)((literalLength >= 15 ? 15 : literalLength) << 4);
+                if (literalLength >= 15) writeLength(op, literalLength - 15);
+                memcpy(op, literals, literalLength);
+                op += literalLength;
+                if (offset)
+                {
+                    *op++ = (uint8_t)offset;
+                    *op++ = (uint8_t)(offset >> 8);
+                    matchLength -= kMinMatch;
+                    *token |= (uint8_t)(matchLength >= 15 ? 15 : matchLength);
+                    if (matchLength >= 15) writeLength(op, matchLength - 15);
+                }
+            }
+
+            //! Greedy single probe LZ4 block compressor, same idea as LZ4's fast mode including skipping
+            //! ahead faster through data which doesn't compress. 'dst' needs 'lz4CompressBound' bytes.
+            inline size_t lz4Compress(const uint8_t* src, size_t size, uint8_t* dst, std::vector<uint32_t>& table)
+            {
+                table.assign(size_t(1) << kHashLog, 0);
+                const uint8_t* ip = src;
+                const uint8_t* anchor = src;
+                const uint8_t* end = src + size;
+                uint8_t* op = dst;
+                if (size > kMatchStartLimit)
+                {
+                    const uint8_t* matchStartLimit = end - kMatchStartLimit;
+                    const uint8_t* matchEndLimit = end - kLastLiterals;
+                    while (ip < matchStartLimit)
+                    {
+                        uint32_t sequence;
+                        memcpy(&sequence, ip, sizeof(sequence));
+                        uint32_t hash = (sequence * 2654435761u) >> (32 - kHashLog);
+                        const uint8_t* ref = src + table[hash];
+                        table[hash] = (uint32_t)(ip - src);
+                        uint32_t refSequence;
+                        memcpy(&refSequence, ref, sizeof(refSequence));
+                        if (ref >= ip || size_t(ip - ref) > kMaxOffset || refSequence != sequence)
+                        {
+                            ip += 1 + ((ip - anchor) >> 6);
+                            continue;
+                        }
+                        const uint8_t* matchEnd = ip + kMinMatch;
+                        const uint8_t* refEnd = ref + kMinMatch;
+                        while (matchEnd < matchEndLimit && *matchEnd == *refEnd)
+                        {
+                            matchEnd++;
+                            refEnd++;
+                        }
+                        writeSequence(op, anchor, ip - anchor, ip - ref, matchEnd - ip);
+                        ip = matchEnd;
+                        anchor = ip;
+                    }
+                }
+                writeSequence(op, anchor, end - anchor, 0, 0);
+                return op - dst;
+            }
+
+            //! Decodes a raw LZ4 block, returns the decoded size or SIZE_MAX if the block is malformed or does not fit
+            inline size_t lz4Decompress(const uint8_t* src, size_t size, uint8_t* dst, size_t capacity)
+            {
+                const uint8_t* ip = src;
+                const uint8_t* end = src + size;
+                uint8_t* op = dst;
+                uint8_t* opEnd = dst + capacity;
+                auto readLength = [&ip, end](size_t& length)->bool
+                {
+                    uint8_t b;
+                    do
+                    {
+                        if (ip >= end) return false;
+                        b = *ip++;
+                        length += b;
+                    } while (b == 255);
+                    return true;
+                };
+                while (ip < end)
+                {
+                    uint8_t token = *ip++;
+                    size_t literalLength = token >> 4;
+                    if (literalLength == 15 && !readLength(literalLength)) return SIZE_MAX;
+                    if (literalLength > size_t(end - ip) || literalLength > size_t(opEnd - op)) return SIZE_MAX;
+                    memcpy(op, ip, literalLength);
+                    ip += literalLength;
+                    op += literalLength;
+                    if (ip == end) break; // Last sequence is literals only
+                    if (end - ip < 2) return SIZE_MAX;
+                    size_t offset = ip[0] | (size_t(ip[1]) << 8);
+                    ip += 2;
+                    size_t matchLength = token & 15;
+                    if (matchLength == 15 && !readLength(matchLength)) return SIZE_MAX;
+                    matchLength += kMinMatch;
+                    if (offset == 0 || offset > size_t(op - dst) || matchLength > size_t(opEnd - op)) return SIZE_MAX;
+                    // Byte by byte since the match can overlap what it is producing
+                    const uint8_t* match = op - offset;
+                    for (size_t i = 0; i < matchLength; i++)
+                    {
+                        op[i] = match[i];
+                    }
+                    op += matchLength;
+                }
+                return op - dst;
+            }
+
+            //! XORs 'data' with the previous payload and keeps the original data as the new reference
+            inline void deltaXor(uint8_t* data, uint8_t* reference, size_t size)
+            {
+                size_t i = 0;
+                for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+                {
+                    uint64_t a, b;
+                    memcpy(&a, data + i, sizeof(a));
+                    memcpy(&b, reference + i, sizeof(b));
+                    memcpy(reference + i, &a, sizeof(a));
+                    a ^= b;
+                    memcpy(data + i, &a, sizeof(a));
+                }
+                for (; i < size; i++)
+                {
+                    uint8_t a = data[i];
+                    data[i] ^= reference[i];
+                    reference[i] = a;
+                }
+            }
+        }
+    }
+}
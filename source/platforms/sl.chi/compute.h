@@ -73,6 +73,8 @@ using Output = void*;
 constexpr uint32_t kAllSubResources = 0xffffffff;
 constexpr uint64_t kBinarySemaphoreValue = 0xcafec0de;
 constexpr const char* kGlobalVRAMSegment = "global";
+//! Constant blocks up to this size are bound as root constants where the API allows it
+constexpr size_t kMaxRootConstantsSize = 128;
 
 #define SL_SAFE_RELEASE(a) if(a) { ((IUnknown*)a)->Release(); a = nullptr;}
 #define MAX_NUM_NODES 2
@@ -140,7 +142,9 @@ enum HeapType
 
 enum BarrierType
 {
-    eBarrierTypeUAV
+    eBarrierTypeUAV,
+    //! Marks the first use of a resource created by 'ICompute::createAliasedResources', no-op where nothing is aliased
+    eBarrierTypeAliasing
 };
 
 enum class CommandQueueType
@@ -286,6 +290,18 @@ struct ResourceDescription
     bool createImageViewTypeStencil = false;
 };
 
+//! One resource created by 'ICompute::createResources', 'type' selects between 'createBuffer' and 'createTexture2D'
+struct ResourceBatchEntry
+{
+    ResourceType type = ResourceType::eTex2d;
+    ResourceDescription desc;
+    const char* name = "";
+    Resource resource{};
+    //! Only used by 'ICompute::createAliasedResources', first and last pass which touch the resource
+    uint32_t firstUse = 0;
+    uint32_t lastUse = UINT32_MAX;
+};
+
 struct ResourceInfo
 {
     ResourceInfo() {};
@@ -447,6 +463,8 @@ struct HashedResourceData
     ResourceState state{};
     Resource resource{};
     ICompute* m_pCompute{};
+    //! Index in the owning resource pool's allocated list, keeps recycling O(1)
+    uint32_t poolSlot = UINT32_MAX;
 private:
     HashedResourceData(const HashedResourceData&) = delete;
     void operator=(const HashedResourceData&) = delete;
@@ -474,6 +492,7 @@ struct HashedResource
     ResourceState &accessState() { return m_p ? m_p->state : s_invalidState; }
     ResourceState getState() const { return m_p ? m_p->state : ResourceState::eUnknown; }
     uint64_t& accessHash() { return m_p ? m_p->hash : s_invalidHash; }
+    uint32_t& accessPoolSlot() { return m_p ? m_p->poolSlot : s_invalidPoolSlot; }
     void* getNative() const { return m_p ? m_p->resource->native : nullptr; }
     ICompute* getCompute() const { return m_p ? m_p->m_pCompute : nullptr; }
 #if ASSERT_ONLY_CODE
@@ -489,6 +508,7 @@ private:
     std::shared_ptr<HashedResourceData> m_p;
     static ResourceState s_invalidState;
     static uint64_t s_invalidHash;
+    static uint32_t s_invalidPoolSlot;
 };
 
 struct IResourcePool
@@ -498,6 +518,69 @@ struct IResourcePool
     virtual void recycle(HashedResource res) = 0;
     virtual void clear() = 0;
     virtual void collectGarbage(float deltaMs = 10000.0f) = 0;
+    //! Pools with lower priority are trimmed first when running low on VRAM
+    virtual void setEvictionPriority(uint32_t priority) = 0;
+    virtual uint32_t getEvictionPriority() const = 0;
+    //! Releases least recently used free resources until at least 'bytes' are released, returns bytes actually released
+    virtual uint64_t trim(uint64_t bytes) = 0;
+    //! Same as 'allocate' but the resource is created with 'format' instead of the source format (texture only, no depth-stencil usage)
+    virtual HashedResource allocateAs(Resource source, Format format, const char* debugName, ResourceState initialState = ResourceState::eCopyDestination) = 0;
+};
+
+//! Point in time copy of the VRAM accounted for a segment
+struct VRAMSegmentStats
+{
+    //! Owned by the compute instance, remains valid until it is destroyed
+    const char* name{};
+    uint64_t allocCount{};
+    uint64_t totalAllocatedSize{};
+};
+
+//! GPU timings for a perf section, collected over the last 'kAverageMeterWindowSize' resolved samples
+struct PerfSectionStats
+{
+    float lastMS{};
+    float meanMS{};
+    float p99MS{};
+    uint64_t numSamples{};
+};
+
+//! Shader execution capabilities of the device, used to pick between kernel permutations
+struct ShaderCaps
+{
+    //! Native 16-bit float arithmetic, not just min precision hints
+    bool nativeFP16{};
+    //! Zero when the API cannot report wave (subgroup) sizes
+    uint32_t waveLaneCountMin{};
+    uint32_t waveLaneCountMax{};
+    //! SM 6.6 'ResourceDescriptorHeap' indexing, kernels built from '<name>_sm66.hlsl' can be used (D3D12 only)
+    bool bindlessResources{};
+};
+
+//! Offscreen stand-in for a swap-chain when there is no window, see 'ICompute::createNullSwapChain'
+struct NullSwapChainDesc
+{
+    //! Zero sized chains have no back buffers, present then only paces the CPU
+    uint32_t width{};
+    uint32_t height{};
+    Format format = Format::eFormatRGBA8UN;
+    uint32_t bufferCount = 3;
+    //! Reported by 'getRefreshRate'
+    float refreshRate = 60.0f;
+};
+
+//! Controls how resource pools give memory back when approaching the VRAM budget
+struct VRAMEvictionPolicy
+{
+    bool enabled = true;
+    //! Fraction of the budget, once exceeded pools start releasing their free resources
+    float highWatermark = 0.95f;
+    //! Fraction of the budget pools are trimmed down to
+    float lowWatermark = 0.85f;
+    //! Trim proactively when the OS budget shrinks by more than this fraction between two updates
+    float budgetShrinkThreshold = 0.05f;
+    //! Released resources go through deferred destruction so give the usage time to catch up
+    uint32_t cooldownFrames = 4;
 };
 
 // Common functions
@@ -506,6 +589,17 @@ using PFun_GetThreadContext = CommonThreadContext*(void);
 // padding are bytes not covered by 2D resource (appears due to block-linear memory structure)
 enum CLEAR_TYPE { CLEAR_UNDEFINED, CLEAR_ZBC_WITH_PADDING, CLEAR_ZBC_WITHOUT_PADDING, CLEAR_NON_ZBC };
 
+//! One clear for 'ICompute::clearViews', without rects the whole texture is cleared
+struct ClearRequest
+{
+    Resource resource{};
+    float4 color{};
+    const RECT* rects{};
+    uint32_t numRects{};
+    //! Set by 'clearViews', same as 'outType' of 'clearView'
+    CLEAR_TYPE type = CLEAR_UNDEFINED;
+};
+
 enum ComputeStatus
 {
     eOk,
@@ -731,17 +825,190 @@ public:
 
     // check if an extension is available, vulkan only
     virtual ComputeStatus isDeviceExtensionSupported(const char* extension, uint32_t version) = 0;
+
+    virtual ComputeStatus setVRAMEvictionPolicy(const VRAMEvictionPolicy& policy) = 0;
+    //! Copies up to 'count' segments into 'stats' (can be null) and returns the total number of segments in 'count'
+    virtual ComputeStatus getVRAMSegmentStats(VRAMSegmentStats* stats, uint32_t& count) = 0;
+
+    //! Between begin/end, reverse transitions recorded via 'transitionResources' scoped tasks on this command list are
+    //! deferred and folded into later transitions of the same resource, anything left is flushed by 'endTransitionBatch'.
+    //! 
+    //! IMPORTANT: Only use around work recorded through this interface, deferred resources are not in the expected state until flushed
+    virtual ComputeStatus beginTransitionBatch(CommandList cmdList) = 0;
+    virtual ComputeStatus endTransitionBatch(CommandList cmdList) = 0;
+
+    //! Creates pipeline objects recorded for these kernels by previous runs ahead of their first dispatch.
+    //! 
+    //! Pipelines are persisted in an on-disk cache keyed by kernel hash and driver, call from 'slOnPluginStartup' after 'createKernel'
+    virtual ComputeStatus prewarmKernels(const Kernel* kernels, uint32_t count) = 0;
+
+    //! Binds small constant blocks directly in the root signature, no constant buffer ring or descriptors involved.
+    //! 
+    //! 'dataSize' must be a multiple of 4 and not exceed 'kMaxRootConstantsSize'. APIs without root constants
+    //! fall back to 'bindConsts' so 'instances' follows the same rules as there.
+    //! 
+    //! NOTE: 'bindConsts' already picks this path automatically on D3D12 when the block is small enough
+    virtual ComputeStatus bindRootConstants(uint32_t binding, uint32_t reg, const void* data, size_t dataSize, uint32_t instances) = 0;
+
+    //! Opt-in async compute, enabled with 'asyncCompute' in sl.interposer.json.
+    //! 
+    //! 'beginAsyncCompute' makes the SL owned compute queue wait for everything submitted to 'hostQueue' so far and returns
+    //! a command list to record into, 'endAsyncCompute' submits it and makes 'hostQueue' wait for the results.
+    //! Returns eNoImplementation when the mode is off or not supported so callers can record on their own command list instead.
+    //! 
+    //! IMPORTANT: Only eligible for passes whose inputs were produced by work already submitted to 'hostQueue' and whose
+    //! outputs are consumed by later submissions (e.g. present time work), resources must stay in compute compatible states.
+    virtual ComputeStatus beginAsyncCompute(CommandQueue hostQueue, CommandList& cmdList) = 0;
+    virtual ComputeStatus endAsyncCompute(CommandQueue hostQueue) = 0;
+
+    //! Uploads host data through a staging ring shared by all plugins, no upload resources need to be created or tracked.
+    //! 
+    //! Staging space is sub-allocated linearly and recycled once the GPU is a few frames past it so 'data' can be released
+    //! as soon as the call returns. For textures 'rowPitch' is the pitch of 'data', any device pitch alignment is handled here.
+    //! 
+    //! NOTE: Only the first subresource is written, copies are recorded on 'cmdList' and 'target' must be in the copy destination state
+    virtual ComputeStatus uploadToBuffer(CommandList cmdList, const void* data, uint64_t size, Resource target, uint64_t dstOffset = 0) = 0;
+    virtual ComputeStatus uploadToTexture(CommandList cmdList, const void* data, uint64_t size, uint64_t rowPitch, Resource target) = 0;
+
+    //! Blocks until every fence (or with 'waitAny' at least one of them) reaches its value or 'timeoutMs' expires.
+    //! 
+    //! Vulkan waits on all timeline semaphores with a single vkWaitSemaphores call, d3d12 uses SetEventOnMultipleFenceCompletion
+    //! and d3d11 waits on one completion event per pending fence (up to MAXIMUM_WAIT_OBJECTS).
+    virtual WaitStatus waitCPUFences(const Fence* fences, const uint64_t* syncValues, uint32_t count, bool waitAny = false, uint32_t timeoutMs = 500) = 0;
+    //! Schedules 'callback' to run on an SL background thread once 'fence' reaches 'syncValue', never blocks the caller.
+    //! 
+    //! IMPORTANT: Callbacks must be short and thread safe. Pending callbacks are dropped when
+    //! their fence is destroyed via 'destroyFence' or when chi shuts down.
+    virtual ComputeStatus notifyOnFence(Fence fence, uint64_t syncValue, std::function<void(void)> callback) = 0;
+
+    //! Copies only 'region' of the first subresource into the same location in 'dstResource'.
+    //! 
+    //! Falls back to 'copyResource' for buffers, empty regions and resources where the API does not allow
+    //! partial copies (d3d depth-stencil or multisampled) or which have more than one subresource.
+    //! On d3d12 a render target 'dstResource' in copy destination state is discarded first, everything outside 'region' is undefined.
+    virtual ComputeStatus copyResourceRegion(CommandList cmdList, Resource dstResource, Resource srcResource, const Extent& region) = 0;
+    //! Copies the depth plane of a depth-stencil texture into a single channel color texture (e.g. D32S8 into R32F).
+    //! 
+    //! NOTE: Only d3d12 can copy between depth and color formats, other platforms return eNotSupported
+    virtual ComputeStatus copyDepthToColor(CommandList cmdList, Resource dstResource, Resource srcResource) = 0;
+
+    //! Returns timings for a section recorded via 'beginPerfSection/endPerfSection'
+    //! 
+    //! NOTE: Section timings are resolved a few frames late, until then stats are zero
+    virtual ComputeStatus getPerfSectionStats(const char* section, PerfSectionStats& stats, uint32_t node = 0) = 0;
+
+    //! Reports if VRAM usage from the last 'setVRAMBudget' is above the eviction high watermark
+    //! 
+    //! Lets plugins give back memory pools cannot (e.g. NGX features), always false if VRAM is not managed
+    virtual ComputeStatus isVRAMOverBudget(bool& overBudget) = 0;
+
+    //! Reports native FP16 and wave size support so plugins can select matching shader permutations
+    virtual ComputeStatus getShaderCaps(ShaderCaps& caps) = 0;
+
+    //! Names of all sections recorded via 'beginPerfSection/endPerfSection' so far, for use with 'getPerfSectionStats'
+    virtual ComputeStatus getPerfSectionNames(std::vector<std::string>& names, uint32_t node = 0) = 0;
+
+    //! True when 'ScopedProfilingSection' should emit GPU markers (PIX events, debug utils labels)
+    //!
+    //! Shared by all SL modules and toggled at runtime, see 'param::global::kGPUMarkers'
+    virtual bool isGPUMarkersEnabled() = 0;
+
+    //! Headless mode, a null swap-chain is a ring of offscreen back buffers which are never displayed.
+    //! 
+    //! 'getSwapChainBuffer', 'getFullscreenState' and 'getRefreshRate' accept it like a native swap-chain. 'presentNullSwapChain'
+    //! emulates present with a fence signaled on 'queue' and, like a flip model swap-chain, blocks until the back buffer
+    //! returned in 'bufferIndex' is no longer used by the GPU.
+    //! 
+    //! NOTE: Only d3d12 implements null swap-chains, other platforms return eNoImplementation
+    virtual ComputeStatus createNullSwapChain(const NullSwapChainDesc& desc, SwapChain& chain) = 0;
+    virtual ComputeStatus destroyNullSwapChain(SwapChain chain) = 0;
+    virtual ComputeStatus presentNullSwapChain(SwapChain chain, CommandQueue queue, uint32_t& bufferIndex) = 0;
+
+    //! Back buffers wrapped once per swap-chain, per present access is a lookup instead of 'getSwapChainBuffer'
+    //!
+    //! The cache owns returned buffers, callers must NOT destroy them. 'cacheSwapChainBuffers' is called by sl.common
+    //! after the swap-chain is resized, buffers which were not cached up front are added on first access.
+    //! 'releaseSwapChainBuffers' drops all references immediately so it must run before the swap-chain is resized or destroyed.
+    virtual ComputeStatus cacheSwapChainBuffers(SwapChain chain, uint32_t bufferCount) = 0;
+    virtual ComputeStatus getCachedSwapChainBuffer(SwapChain chain, uint32_t index, Resource& buffer) = 0;
+    virtual ComputeStatus releaseSwapChainBuffers(SwapChain chain) = 0;
+
+    //! Creates all resources in one go, for example when the swap-chain is resized and the host is already stalling
+    //!
+    //! D3D12 places whatever it can in a single heap sized for the whole batch, the rest and other platforms
+    //! use the regular allocation path. On failure nothing is created and all 'resource' members are null.
+    virtual ComputeStatus createResources(ResourceBatchEntry* entries, uint32_t count) = 0;
+
+    //! Publishes the frame index used to schedule deferred destruction and ring allocations without collecting garbage
+    //!
+    //! Lets 'collectGarbage' run later on another thread, the index only ever moves forward so a late call cannot rewind it.
+    virtual ComputeStatus setFinishedFrame(uint32_t finishedFrame) = 0;
+
+    //! Changes whenever 'resource' stops being tracked via 'startTrackingResource' and is tracked again
+    //!
+    //! While tracked SL holds a reference so the native pointer cannot be reused by another resource, anything cached
+    //! per native pointer along with the generation stays valid for as long as it is returned unchanged.
+    //! Fails for resources which are not tracked and on platforms without tracking.
+    virtual ComputeStatus getTrackedResourceGeneration(Resource resource, uint64_t& generation) = 0;
+
+    //! Same as 'createResources' but entries whose 'firstUse'/'lastUse' ranges do not overlap may share memory
+    //!
+    //! Contents are undefined on first use, insert 'eBarrierTypeAliasing' on the resource before its first pass.
+    //! D3D12 aliases what 'createResources' would place in a heap, the rest and other platforms get dedicated memory.
+    virtual ComputeStatus createAliasedResources(ResourceBatchEntry* entries, uint32_t count) = 0;
+
+    //! Same as 'getResourceFromSharedHandle' for APIs which cannot query what a shared handle points to
+    //!
+    //! Vulkan imports D3D12 textures (VK_KHR_external_memory_win32) and D3D12 fences as timeline semaphores
+    //! (VK_KHR_external_semaphore_win32), 'desc' must match the shared texture. The handle stays owned by the caller.
+    virtual ComputeStatus importSharedResource(ResourceType type, Handle handle, const ResourceDescription& desc, Resource& res) = 0;
+
+    //! Starts recording SL work into a reusable D3D12 bundle, pass 'bundle' to 'bindSharedState' and the usual bind/dispatch calls
+    //!
+    //! Transitions and profiling sections must stay on the list the bundle is executed on. Only kernels taking root
+    //! constants can be recorded, ring constants and ring descriptors fail with 'eInvalidCall'. A bundle is never
+    //! re-recorded since the GPU could still be executing it, record a new one and retire the old one with 'destroyBundle'.
+    virtual ComputeStatus beginBundle(uint32_t node, CommandList& bundle) = 0;
+    virtual ComputeStatus endBundle(CommandList bundle) = 0;
+    //! Fails with 'eInvalidCall' if a descriptor recorded in 'bundle' has moved since, the caller must record a new one
+    //!
+    //! Only direct command lists can execute bundles, anything else returns 'eNoImplementation'.
+    virtual ComputeStatus executeBundle(CommandList cmdList, CommandList bundle) = 0;
+    //! Released once the frames which could still execute 'bundle' have finished
+    virtual ComputeStatus destroyBundle(CommandList bundle) = 0;
+
+    //! Same as 'clearView' for several textures, for example history and intermediate buffers on resize or camera cut
+    //!
+    //! All resources are transitioned to 'eStorageRW' with one batch of barriers and stay in it. Vulkan records
+    //! the rect clears with a single kernel bind and one memory barrier before and after instead of one per resource.
+    virtual ComputeStatus clearViews(CommandList cmdList, ClearRequest* requests, uint32_t count) = 0;
 };
 
 
+//! GPU marker (and instrumentation zone) around SL work recorded on 'cmdList'
+//!
+//! Markers are only emitted while 'ICompute::isGPUMarkersEnabled' is set, the state is latched
+//! at construction so begin/end always stay balanced if markers are toggled in between.
 class  ScopedProfilingSection
 {
     CommandList m_cmdList;
     ICompute* m_compute;
+    bool m_active = false;
+    SL_TRACE_ZONE_MEMBER(m_zone);
 
     ScopedProfilingSection(ICompute* compute, CommandList cmdList)
         : m_cmdList(cmdList), m_compute(compute)
     {
+        m_active = m_compute && m_cmdList && m_compute->isGPUMarkersEnabled();
+    }
+
+    void begin(const char* marker)
+    {
+        if (m_active)
+        {
+            // Backends without marker support must not get an unmatched end
+            m_active = m_compute->beginProfiling(m_cmdList, 0, marker) == ComputeStatus::eOk;
+        }
     }
 
   public:
@@ -749,16 +1016,21 @@ class  ScopedProfilingSection
     ScopedProfilingSection(ICompute* compute, CommandList cmdList, const char* marker) 
         : ScopedProfilingSection(compute, cmdList)
     {
-        m_compute->beginProfiling(m_cmdList, 0, marker);
+        SL_TRACE_ZONE_BEGIN(m_zone, marker);
+        begin(marker);
     }
 
     // those are in generic.cpp since they use sl_helpers to stringify some of the arguments
     ScopedProfilingSection(ICompute* compute, CommandList cmdList, const char* function, sl::Feature feature);
+    ScopedProfilingSection(ICompute* compute, CommandList cmdList, const char* function, sl::Feature feature, uint32_t viewport);
     ScopedProfilingSection(ICompute* compute, CommandList cmdList, const char* function, const sl::ResourceTag* resources, uint32_t numResources);
 
     ~ScopedProfilingSection()
     {  
-        m_compute->endProfiling(m_cmdList);
+        if (m_active)
+        {
+            m_compute->endProfiling(m_cmdList);
+        }
     }
 };
 
@@ -39,11 +39,88 @@ ICompute *getD3D11()
     return &s_d3d11;
 }
 
+constexpr uint32_t kMaxFenceWaitMs = 500; // 500ms max wait on any fence
+
 WaitStatus D3D11::waitCPUFence(Fence fence, uint64_t syncValue)
 {
-    assert(false);
-    SL_LOG_ERROR("Not implemented");
-    return WaitStatus::eError;
+    // This can be called from any thread so make sure not to touch any internals
+    auto d3d11Fence = (ID3D11Fence*)fence;
+    if (!d3d11Fence) return WaitStatus::eError;
+
+    WaitStatus status = WaitStatus::eNoTimeout;
+    if (d3d11Fence->GetCompletedValue() < syncValue)
+    {
+        extra::ScopedHitchTimer hitch("D3D11::waitCPUFence");
+        HANDLE waitEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (SUCCEEDED(d3d11Fence->SetEventOnCompletion(syncValue, waitEvent)))
+        {
+            if (WaitForSingleObject(waitEvent, kMaxFenceWaitMs) == WAIT_TIMEOUT)
+            {
+                SL_LOG_WARN("Wait on gpu fence timed out after %ums value %llu", kMaxFenceWaitMs, syncValue);
+                status = WaitStatus::eTimeout;
+            }
+        }
+        else
+        {
+            status = WaitStatus::eError;
+        }
+        CloseHandle(waitEvent);
+    }
+    return status;
+}
+
+WaitStatus D3D11::waitCPUFences(const Fence* fences, const uint64_t* syncValues, uint32_t count, bool waitAny, uint32_t timeoutMs)
+{
+    if (!fences || !syncValues) return WaitStatus::eError;
+    if (count == 0) return WaitStatus::eNoTimeout;
+    if (count > MAXIMUM_WAIT_OBJECTS)
+    {
+        SL_LOG_ERROR("Cannot wait on more than %u fences at once", MAXIMUM_WAIT_OBJECTS);
+        return WaitStatus::eError;
+    }
+
+    // No multi fence event on d3d11, one event per fence which is still pending
+    WaitStatus status = WaitStatus::eNoTimeout;
+    HANDLE events[MAXIMUM_WAIT_OBJECTS]{};
+    DWORD eventCount = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto d3d11Fence = (ID3D11Fence*)fences[i];
+        if (d3d11Fence->GetCompletedValue() >= syncValues[i])
+        {
+            if (waitAny) break;
+            continue;
+        }
+        HANDLE waitEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+        if (FAILED(d3d11Fence->SetEventOnCompletion(syncValues[i], waitEvent)))
+        {
+            CloseHandle(waitEvent);
+            status = WaitStatus::eError;
+            break;
+        }
+        events[eventCount++] = waitEvent;
+    }
+
+    // Nothing to wait for when any fence already completed (waitAny) or all did
+    bool satisfied = eventCount < count && waitAny;
+    if (status == WaitStatus::eNoTimeout && eventCount && !satisfied)
+    {
+        extra::ScopedHitchTimer hitch("D3D11::waitCPUFences");
+        if (WaitForMultipleObjects(eventCount, events, waitAny ? FALSE : TRUE, timeoutMs) == WAIT_TIMEOUT)
+        {
+            status = WaitStatus::eTimeout;
+        }
+    }
+    for (DWORD i = 0; i < eventCount; i++)
+    {
+        CloseHandle(events[i]);
+    }
+    return status;
+}
+
+uint64_t D3D11::getCompletedValue(Fence fence)
+{
+    return fence ? ((ID3D11Fence*)fence)->GetCompletedValue() : 0;
 }
 
 struct D3D11CommandListContext : public ICommandListContext
@@ -127,8 +204,7 @@ struct D3D11CommandListContext : public ICommandListContext
 
     Handle getFenceEvent()
     {
-        assert(false);
-        SL_LOG_ERROR( "Not implemented");
+        // Waits create their own events, see D3D11::waitCPUFence
         return nullptr;
     }
 
@@ -201,23 +277,20 @@ struct D3D11CommandListContext : public ICommandListContext
 
     WaitStatus waitForCommandListToFinish(uint32_t index)
     {
-        assert(false);
-        SL_LOG_ERROR( "Not implemented");
-        return WaitStatus::eError;
+        // Single implicit command list, done once the last signaled value completes
+        if (!m_fence) return WaitStatus::eError;
+        m_cmdCtxImmediate->Flush();
+        return m_compute->waitCPUFence(m_fence, m_syncValue);
     }
 
     uint64_t getCompletedValue(Fence fence)
     {
-        assert(false);
-        SL_LOG_ERROR( "Not implemented");
-        return false;
+        return m_compute->getCompletedValue(fence);
     }
 
     bool didCommandListFinish(uint32_t index)
     {
-        assert(false);
-        SL_LOG_ERROR( "Not implemented");
-        return false;
+        return m_fence && m_compute->getCompletedValue(m_fence) >= m_syncValue;
     }
 
     void syncGPU(const GPUSyncInfo* info)
@@ -364,6 +437,12 @@ ComputeStatus D3D11::init(Device InDevice, param::IParameters* params)
 
     m_dbgSupportRs2RelaxedConversionRules = true;
 
+    params->get(sl::param::global::kD3D11LightweightState, &m_lightweightState);
+    if (m_lightweightState)
+    {
+        SL_LOG_INFO("Saving and restoring only the compute state SL binds over");
+    }
+
     SL_LOG_INFO("GPU nodes %u - visible node mask %u", NodeCount, m_visibleNodeMask);
        
     {
@@ -460,10 +539,13 @@ ComputeStatus D3D11::init(Device InDevice, param::IParameters* params)
 
 ComputeStatus D3D11::shutdown()
 {
+    // Callbacks could still be waiting on fences owned by the device
+    shutdownFenceCallbacks();
+
     CHI_CHECK(destroyKernel(m_copyKernel));
     m_copyKernel = {};
 
-    m_context = {};
+    m_dispatchContext.clear();
     SL_SAFE_RELEASE(m_immediateContext);
     SL_SAFE_RELEASE(m_device5);
 
@@ -518,9 +600,10 @@ ComputeStatus D3D11::clearCache()
     }
     m_resourceData.clear();
 
-    if (m_context)
+    auto& ctx = m_dispatchContext.getContext();
+    if (ctx.context)
     {
-        m_context->ClearState();
+        ctx.context->ClearState();
     }
 
     return Generic::clearCache();
@@ -534,27 +617,14 @@ ComputeStatus D3D11::getRenderAPI(RenderAPI &OutType)
 
 ComputeStatus D3D11::createKernel(void *blobData, unsigned int blobSize, const char* fileName, const char *entryPoint, Kernel &kernel)
 {
+    SL_STARTUP_PHASE(m_startupTimeline, fileName);
     if (!blobData || !fileName || !entryPoint)
     {
         return ComputeStatus::eInvalidArgument;
     }
 
-    size_t hash = 0;
-    const char* p = fileName;
-    while (*p)
-    {
-        hash_combine(hash, *p++);
-    }
-    p = entryPoint;
-    while (*p)
-    {
-        hash_combine(hash, *p++);
-    }
-    auto i = blobSize;
-    while (i--)
-    {
-        hash_combine(hash, ((char*)blobData)[i]);
-    }
+    // Names seed the blob hash so the same byte code registered under a different name stays distinct
+    size_t hash = hash::hash64(blobData, blobSize, hash::hashString(entryPoint, hash::hashString(fileName)));
 
     ComputeStatus Res = ComputeStatus::eOk;
     KernelDataD3D11 *data = {};
@@ -634,9 +704,21 @@ ComputeStatus D3D11::pushState(CommandList cmdList)
     auto& threadD3D11 = *(chi::D3D11ThreadContext*)m_getThreadContext();
     auto context = (ID3D11DeviceContext*)cmdList;
 
+    context->OMGetRenderTargets(chi::kMaxD3D11Items, threadD3D11.engineRTVs, &threadD3D11.engineDSV);
+
+    if (m_lightweightState)
+    {
+        // Compute slots are saved by the bind calls, only the ones SL overwrites are restored.
+        //
+        // NOTE: Engine CS UAVs and SRVs are left bound, hosts must not keep resources SL reads bound for compute writes
+        threadD3D11.trackBindings = true;
+        static ID3D11RenderTargetView* nullRTVs[D3D11_SIMULTANEOUS_RENDER_TARGET_COUNT] = {};
+        context->OMSetRenderTargets(chi::kMaxD3D11Items, nullRTVs, nullptr);
+        return ComputeStatus::eOk;
+    }
+
     context->CSGetShader(&threadD3D11.engineCS, 0, 0);
     context->CSGetSamplers(0, chi::kMaxD3D11Items, threadD3D11.engineSamplers);
-    context->OMGetRenderTargets(chi::kMaxD3D11Items, threadD3D11.engineRTVs, &threadD3D11.engineDSV);
     context->CSGetShaderResources(0, chi::kMaxD3D11Items, &threadD3D11.engineSRVs[0]);
     context->CSGetUnorderedAccessViews(0, chi::kMaxD3D11Items, &threadD3D11.engineUAVs[0]);
     context->CSGetConstantBuffers(0, chi::kMaxD3D11Items, threadD3D11.engineConstBuffers);
@@ -660,12 +742,31 @@ ComputeStatus D3D11::popState(CommandList cmdList)
     auto& threadD3D11 = *(chi::D3D11ThreadContext*)m_getThreadContext();
     auto context = (ID3D11DeviceContext*)cmdList;
 
-    context->CSSetShader(threadD3D11.engineCS, 0, 0);
-    context->CSSetSamplers(0, chi::kMaxD3D11Items, threadD3D11.engineSamplers);
-    context->CSSetUnorderedAccessViews(0, chi::kMaxD3D11Items, threadD3D11.engineUAVs, nullptr);
-    context->OMSetRenderTargets(chi::kMaxD3D11Items, threadD3D11.engineRTVs, threadD3D11.engineDSV);
-    context->CSSetShaderResources(0, chi::kMaxD3D11Items, threadD3D11.engineSRVs);
-    context->CSSetConstantBuffers(0, chi::kMaxD3D11Items, threadD3D11.engineConstBuffers);
+    if (threadD3D11.trackBindings)
+    {
+        if (threadD3D11.capturedCS)
+        {
+            context->CSSetShader(threadD3D11.engineCS, 0, 0);
+        }
+        for (uint32_t i = 0; i < chi::kMaxD3D11Items; i++)
+        {
+            uint32_t slot = 1 << i;
+            if (threadD3D11.capturedSamplers & slot) context->CSSetSamplers(i, 1, &threadD3D11.engineSamplers[i]);
+            if (threadD3D11.capturedUAVs & slot) context->CSSetUnorderedAccessViews(i, 1, &threadD3D11.engineUAVs[i], nullptr);
+            if (threadD3D11.capturedSRVs & slot) context->CSSetShaderResources(i, 1, &threadD3D11.engineSRVs[i]);
+            if (threadD3D11.capturedConstBuffers & slot) context->CSSetConstantBuffers(i, 1, &threadD3D11.engineConstBuffers[i]);
+        }
+        context->OMSetRenderTargets(chi::kMaxD3D11Items, threadD3D11.engineRTVs, threadD3D11.engineDSV);
+    }
+    else
+    {
+        context->CSSetShader(threadD3D11.engineCS, 0, 0);
+        context->CSSetSamplers(0, chi::kMaxD3D11Items, threadD3D11.engineSamplers);
+        context->CSSetUnorderedAccessViews(0, chi::kMaxD3D11Items, threadD3D11.engineUAVs, nullptr);
+        context->OMSetRenderTargets(chi::kMaxD3D11Items, threadD3D11.engineRTVs, threadD3D11.engineDSV);
+        context->CSSetShaderResources(0, chi::kMaxD3D11Items, threadD3D11.engineSRVs);
+        context->CSSetConstantBuffers(0, chi::kMaxD3D11Items, threadD3D11.engineConstBuffers);
+    }
 
     SL_SAFE_RELEASE(threadD3D11.engineCS);
     SL_SAFE_RELEASE(threadD3D11.engineDSV);
@@ -835,16 +936,24 @@ ComputeStatus D3D11::bindSharedState(CommandList cmdList, UINT node)
 {
     if (!cmdList) return ComputeStatus::eInvalidArgument;
 
-    m_context = (ID3D11DeviceContext*)cmdList;
+    // Per thread so hosts can record SL work into deferred contexts from multiple threads
+    m_dispatchContext.getContext().context = (ID3D11DeviceContext*)cmdList;
     return ComputeStatus::eOk;
 }
 
-ComputeStatus D3D11::bindKernel(const Kernel kernelToBind)
+//! Lightweight state mode, true if the engine binding in this slot must be saved before SL overwrites it
+inline bool captureSlot(D3D11ThreadContext& thread, uint32_t& captured, uint32_t base)
 {
-    if (!m_context) return ComputeStatus::eInvalidArgument;
+    if (!thread.trackBindings || base >= kMaxD3D11Items || (captured & (1 << base))) return false;
+    captured |= 1 << base;
+    return true;
+}
 
+ComputeStatus D3D11::bindKernel(const Kernel kernelToBind)
+{
     auto& ctx = m_dispatchContext.getContext();
-    
+    if (!ctx.context) return ComputeStatus::eInvalidArgument;
+
     {
         std::scoped_lock lock(m_mutexKernel);
         auto it = m_kernels.find(kernelToBind);
@@ -856,7 +965,14 @@ ComputeStatus D3D11::bindKernel(const Kernel kernelToBind)
         ctx.kernel = (KernelDataD3D11*)(*it).second;
     }
 
-    m_context->CSSetShader(ctx.kernel->shader, nullptr, 0);
+    auto& thread = *(D3D11ThreadContext*)m_getThreadContext();
+    if (thread.trackBindings && !thread.capturedCS)
+    {
+        ctx.context->CSGetShader(&thread.engineCS, 0, 0);
+        thread.capturedCS = true;
+    }
+
+    ctx.context->CSSetShader(ctx.kernel->shader, nullptr, 0);
 
     return ComputeStatus::eOk;
 }
@@ -864,9 +980,15 @@ ComputeStatus D3D11::bindKernel(const Kernel kernelToBind)
 ComputeStatus D3D11::bindSampler(uint32_t pos, uint32_t base, Sampler sampler)
 {
     auto& ctx = m_dispatchContext.getContext();
-    if (!m_context || !ctx.kernel || base >= 8) return ComputeStatus::eInvalidArgument;
+    if (!ctx.context || !ctx.kernel || base >= 8) return ComputeStatus::eInvalidArgument;
+
+    auto& thread = *(D3D11ThreadContext*)m_getThreadContext();
+    if (captureSlot(thread, thread.capturedSamplers, base))
+    {
+        ctx.context->CSGetSamplers(base, 1, &thread.engineSamplers[base]);
+    }
 
-    m_context->CSSetSamplers(base, 1, &m_samplers[sampler]);
+    ctx.context->CSSetSamplers(base, 1, &m_samplers[sampler]);
 
     return ComputeStatus::eOk;
 }
@@ -874,7 +996,7 @@ ComputeStatus D3D11::bindSampler(uint32_t pos, uint32_t base, Sampler sampler)
 ComputeStatus D3D11::bindConsts(uint32_t pos, uint32_t base, void *data, size_t dataSize, uint32_t instances)
 {
     auto& ctx = m_dispatchContext.getContext();
-    if (!m_context || !ctx.kernel) return ComputeStatus::eInvalidArgument;
+    if (!ctx.context || !ctx.kernel) return ComputeStatus::eInvalidArgument;
 
     auto it = ctx.kernel->constBuffers.find(base);
     if (it == ctx.kernel->constBuffers.end())
@@ -890,16 +1012,22 @@ ComputeStatus D3D11::bindConsts(uint32_t pos, uint32_t base, void *data, size_t
     }
     auto buffer = ctx.kernel->constBuffers[base];
     D3D11_MAPPED_SUBRESOURCE bufferData = {};
-    m_context->Map(buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &bufferData);
+    ctx.context->Map(buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &bufferData);
     if (!bufferData.pData)
     {
         SL_LOG_ERROR( "Failed to map constant buffer");
         return ComputeStatus::eError;
     }
     memcpy(bufferData.pData, data, dataSize);
-    m_context->Unmap(buffer, 0);
+    ctx.context->Unmap(buffer, 0);
 
-    m_context->CSSetConstantBuffers(base, 1, &buffer);
+    auto& thread = *(D3D11ThreadContext*)m_getThreadContext();
+    if (captureSlot(thread, thread.capturedConstBuffers, base))
+    {
+        ctx.context->CSGetConstantBuffers(base, 1, &thread.engineConstBuffers[base]);
+    }
+
+    ctx.context->CSSetConstantBuffers(base, 1, &buffer);
 
     return ComputeStatus::eOk;
 }
@@ -907,7 +1035,7 @@ ComputeStatus D3D11::bindConsts(uint32_t pos, uint32_t base, void *data, size_t
 ComputeStatus D3D11::bindTexture(uint32_t pos, uint32_t base, Resource resource, uint32_t mipOffset, uint32_t mipLevels)
 {
     auto& ctx = m_dispatchContext.getContext();
-    if (!m_context || !ctx.kernel) return ComputeStatus::eInvalidArgument;
+    if (!ctx.context || !ctx.kernel) return ComputeStatus::eInvalidArgument;
 
     // Allow null resource
     auto res = ComputeStatus::eOk;
@@ -917,7 +1045,13 @@ ComputeStatus D3D11::bindTexture(uint32_t pos, uint32_t base, Resource resource,
         res = getTextureDriverData(resource, data, mipOffset, mipLevels);
     }
 
-    m_context->CSSetShaderResources(base, 1, &data.SRV);
+    auto& thread = *(D3D11ThreadContext*)m_getThreadContext();
+    if (captureSlot(thread, thread.capturedSRVs, base))
+    {
+        ctx.context->CSGetShaderResources(base, 1, &thread.engineSRVs[base]);
+    }
+
+    ctx.context->CSSetShaderResources(base, 1, &data.SRV);
 
     return res;
 }
@@ -925,7 +1059,7 @@ ComputeStatus D3D11::bindTexture(uint32_t pos, uint32_t base, Resource resource,
 ComputeStatus D3D11::bindRWTexture(uint32_t pos, uint32_t base, Resource resource, uint32_t mipOffset)
 {
     auto& ctx = m_dispatchContext.getContext();
-    if (!m_context || !ctx.kernel) return ComputeStatus::eInvalidArgument;
+    if (!ctx.context || !ctx.kernel) return ComputeStatus::eInvalidArgument;
 
     // Allow null resource
     auto res = ComputeStatus::eOk;
@@ -935,7 +1069,13 @@ ComputeStatus D3D11::bindRWTexture(uint32_t pos, uint32_t base, Resource resourc
         res = getSurfaceDriverData(resource, data, mipOffset);
     }
 
-    m_context->CSSetUnorderedAccessViews(base, 1, &data.UAV, nullptr);
+    auto& thread = *(D3D11ThreadContext*)m_getThreadContext();
+    if (captureSlot(thread, thread.capturedUAVs, base))
+    {
+        ctx.context->CSGetUnorderedAccessViews(base, 1, &thread.engineUAVs[base]);
+    }
+
+    ctx.context->CSSetUnorderedAccessViews(base, 1, &data.UAV, nullptr);
 
     return res;
 }
@@ -950,9 +1090,9 @@ ComputeStatus D3D11::bindRawBuffer(uint32_t pos, uint32_t base, Resource resourc
 ComputeStatus D3D11::dispatch(unsigned int blocksX, unsigned int blocksY, unsigned int blocksZ)
 {
     auto& ctx = m_dispatchContext.getContext();
-    if (!m_context || !ctx.kernel) return ComputeStatus::eInvalidArgument;
+    if (!ctx.context || !ctx.kernel) return ComputeStatus::eInvalidArgument;
      
-    m_context->Dispatch(blocksX, blocksY, blocksZ);
+    ctx.context->Dispatch(blocksX, blocksY, blocksZ);
 
     return ComputeStatus::eOk;
 }
@@ -1297,6 +1437,28 @@ ComputeStatus D3D11::copyHostToDeviceTexture(CommandList InCmdList, uint64_t InS
     return ComputeStatus::eOk;
 }
 
+ComputeStatus D3D11::uploadToBuffer(CommandList cmdList, const void* data, uint64_t size, Resource target, uint64_t dstOffset)
+{
+    if (!cmdList || !data || !target)
+    {
+        return ComputeStatus::eInvalidArgument;
+    }
+    // Driver renames the staging memory for us, no need for the shared ring here
+    D3D11_BOX box = { (UINT)dstOffset, 0, 0, (UINT)(dstOffset + size), 1, 1 };
+    ((ID3D11DeviceContext*)cmdList)->UpdateSubresource((ID3D11Resource*)(target->native), 0, &box, data, UINT(size), UINT(size));
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D11::uploadToTexture(CommandList cmdList, const void* data, uint64_t size, uint64_t rowPitch, Resource target)
+{
+    if (!cmdList || !data || !target)
+    {
+        return ComputeStatus::eInvalidArgument;
+    }
+    ((ID3D11DeviceContext*)cmdList)->UpdateSubresource((ID3D11Resource*)(target->native), 0, nullptr, data, UINT(rowPitch), UINT(size));
+    return ComputeStatus::eOk;
+}
+
 ComputeStatus D3D11::clearView(CommandList InCmdList, Resource InResource, const float4 Color, const RECT * pRects, unsigned int NumRects, CLEAR_TYPE &outType)
 {
     outType = CLEAR_UNDEFINED;
@@ -1353,6 +1515,40 @@ ComputeStatus D3D11::copyResource(CommandList cmdList, Resource dstResource, Res
     return ComputeStatus::eOk;
 }
 
+ComputeStatus D3D11::copyResourceRegion(CommandList cmdList, Resource dstResource, Resource srcResource, const Extent& region)
+{
+    if (!cmdList || !dstResource || !srcResource) return ComputeStatus::eInvalidArgument;
+
+    D3D11_RESOURCE_DIMENSION dimension{};
+    ((ID3D11Resource*)(srcResource->native))->GetType(&dimension);
+    if (!region || dimension != D3D11_RESOURCE_DIMENSION_TEXTURE2D)
+    {
+        return copyResource(cmdList, dstResource, srcResource);
+    }
+
+    D3D11_TEXTURE2D_DESC desc{};
+    ((ID3D11Texture2D*)(srcResource->native))->GetDesc(&desc);
+    // Source box must be null for depth-stencil and multisampled resources
+    bool fullCopy = desc.MipLevels != 1 || desc.ArraySize != 1 || desc.SampleDesc.Count > 1 || (desc.BindFlags & D3D11_BIND_DEPTH_STENCIL) ||
+        region.left + region.width > desc.Width || region.top + region.height > desc.Height ||
+        (region.left == 0 && region.top == 0 && region.width == desc.Width && region.height == desc.Height);
+    if (fullCopy)
+    {
+        return copyResource(cmdList, dstResource, srcResource);
+    }
+
+    auto context = (ID3D11DeviceContext*)cmdList;
+    D3D11_BOX box{ region.left, region.top, 0, region.left + region.width, region.top + region.height, 1 };
+    context->CopySubresourceRegion((ID3D11Resource*)(dstResource->native), 0, region.left, region.top, 0, (ID3D11Resource*)(srcResource->native), 0, &box);
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D11::copyDepthToColor(CommandList cmdList, Resource dstResource, Resource srcResource)
+{
+    // Copies are only allowed within the same typeless format group
+    return ComputeStatus::eNotSupported;
+}
+
 ComputeStatus D3D11::cloneResource(Resource resource, Resource &clone, const char friendlyName[], ResourceState initialState, unsigned int creationMask, unsigned int visibilityMask)
 {
     if (!resource) return ComputeStatus::eInvalidArgument;
@@ -1628,6 +1824,23 @@ ComputeStatus D3D11::endPerfSection(CommandList cmdList, const char* key, float
 
     HRESULT hres = S_OK;
 
+    if (context->GetType() != D3D11_DEVICE_CONTEXT_IMMEDIATE)
+    {
+        // Queries recorded into a deferred context resolve only after the host executes it, poll results
+        // from the last execution on the immediate context without waiting and keep the average otherwise
+        hres = m_immediateContext->GetData(data->queryDisjoint, &timestampData, sizeof(timestampData), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+        if (hres == S_OK) hres = m_immediateContext->GetData(data->queryBegin, &beginTimeStamp, sizeof(beginTimeStamp), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+        if (hres == S_OK) hres = m_immediateContext->GetData(data->queryEnd, &endTimeStamp, sizeof(endTimeStamp), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+        if (hres == S_OK && !timestampData.Disjoint)
+        {
+            double delta = (double)((endTimeStamp - beginTimeStamp) / (double)timestampData.Frequency * 1000);
+            data->meter.add(delta);
+            countGPUPass(delta);
+        }
+        avgTimeMS = (float)data->meter.getMean();
+        return ComputeStatus::eOk;
+    }
+
     // Prevent deadlocks 
     {
         int i = 0;
@@ -1661,6 +1874,7 @@ ComputeStatus D3D11::endPerfSection(CommandList cmdList, const char* key, float
         {
             double delta = (double)((endTimeStamp - beginTimeStamp) / (double)timestampData.Frequency * 1000);
             data->meter.add(delta);
+            countGPUPass(delta);
         }
         avgTimeMS = (float)data->meter.getMean();
     }
@@ -1671,18 +1885,53 @@ ComputeStatus D3D11::endPerfSection(CommandList cmdList, const char* key, float
     return ComputeStatus::eOk;
 }
 
+ComputeStatus D3D11::getPerfSectionStats(const char* key, PerfSectionStats& stats, unsigned int node)
+{
+    std::scoped_lock lock(m_mutexProfiler);
+    auto section = m_sectionPerfMap[node].find(key);
+    if (section == m_sectionPerfMap[node].end())
+    {
+        return ComputeStatus::eError;
+    }
+    auto& meter = (*section).second.meter;
+    stats.lastMS = (float)meter.getValue();
+    stats.meanMS = (float)meter.getMean();
+    stats.p99MS = (float)meter.getPercentile(99.0);
+    stats.numSamples = meter.getNumSamples();
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D11::getPerfSectionNames(std::vector<std::string>& names, unsigned int node)
+{
+    std::scoped_lock lock(m_mutexProfiler);
+    names.clear();
+    for (auto& section : m_sectionPerfMap[node])
+    {
+        names.push_back(section.first);
+    }
+    return ComputeStatus::eOk;
+}
+
 ComputeStatus D3D11::beginProfiling(CommandList cmdList, unsigned int Metadata, const char* marker)
 {
-#if SL_ENABLE_PROFILING
-#endif
-    return ComputeStatus::eError;
+    Microsoft::WRL::ComPtr<ID3DUserDefinedAnnotation> annotation;
+    if (FAILED(((ID3D11DeviceContext*)cmdList)->QueryInterface(IID_PPV_ARGS(&annotation))))
+    {
+        return ComputeStatus::eNoImplementation;
+    }
+    annotation->BeginEvent(extra::utf8ToUtf16(marker).c_str());
+    return ComputeStatus::eOk;
 }
 
 ComputeStatus D3D11::endProfiling(CommandList cmdList)
 {
-#if SL_ENABLE_PROFILING
-#endif
-    return ComputeStatus::eError;
+    Microsoft::WRL::ComPtr<ID3DUserDefinedAnnotation> annotation;
+    if (FAILED(((ID3D11DeviceContext*)cmdList)->QueryInterface(IID_PPV_ARGS(&annotation))))
+    {
+        return ComputeStatus::eNoImplementation;
+    }
+    annotation->EndEvent();
+    return ComputeStatus::eOk;
 }
 
  bool D3D11::signalCPUFence(Fence fence, uint64_t syncValue)
@@ -1844,9 +2093,8 @@ ComputeStatus D3D11::getResourceFromSharedHandle(ResourceType type, Handle handl
 ComputeStatus D3D11::prepareTranslatedResources(CommandList cmdList, const std::vector<std::pair<chi::TranslatedResource, chi::ResourceDescription>>& resourceList)
 {
     // Running on D3D11 immediate context and using D3D11 resources
-    CHI_CHECK(pushState(cmdList));
-    CHI_CHECK(bindSharedState(cmdList, 0));
-    CHI_CHECK(bindKernel(m_copyKernel));
+    auto context = (ID3D11DeviceContext*)cmdList;
+    bool kernelBound = false;
     for (auto& [resource, desc] : resourceList)
     {
         // If shared directly nothing to do here!
@@ -1855,12 +2103,33 @@ ComputeStatus D3D11::prepareTranslatedResources(CommandList cmdList, const std::
             continue;
         }
 
+        // Clones of resources which were simply not created as shared keep the footprint and format
+        // so they go through CopyResource and stay off the shader cores
+        D3D11_TEXTURE2D_DESC srcDesc{}, dstDesc{};
+        ((ID3D11Texture2D*)resource.source->native)->GetDesc(&srcDesc);
+        ((ID3D11Texture2D*)resource.clone->native)->GetDesc(&dstDesc);
+        bool sameFootprint = srcDesc.Width == dstDesc.Width && srcDesc.Height == dstDesc.Height && srcDesc.MipLevels == dstDesc.MipLevels &&
+            srcDesc.ArraySize == dstDesc.ArraySize && srcDesc.SampleDesc.Count == dstDesc.SampleDesc.Count;
+        bool sameFormat = srcDesc.Format == dstDesc.Format || getCorrectFormat(srcDesc.Format) == dstDesc.Format;
+        if (sameFootprint && sameFormat && !(srcDesc.BindFlags & D3D11_BIND_DEPTH_STENCIL))
+        {
+            context->CopyResource((ID3D11Resource*)resource.clone->native, (ID3D11Resource*)resource.source->native);
+            continue;
+        }
+
         // Why use copy kernel? 
         // 
         // Some formats cannot be used in combination with NT shared handle hence
         // direct copy is not always possible due to format difference. For example,
         // any depth/stencil format cannot be shared directly, needs to be cloned as R32F
         // and then we copy R24S8 to R32F using the below code.
+        if (!kernelBound)
+        {
+            CHI_CHECK(pushState(cmdList));
+            CHI_CHECK(bindSharedState(cmdList, 0));
+            CHI_CHECK(bindKernel(m_copyKernel));
+            kernelBound = true;
+        }
 
         struct CopyCB
         {
@@ -1877,7 +2146,10 @@ ComputeStatus D3D11::prepareTranslatedResources(CommandList cmdList, const std::
         uint32_t grid[] = { ((uint32_t)cb.texSize.x + 16 - 1) / 16, ((uint32_t)cb.texSize.y + 16 - 1) / 16, 1 };
         CHI_CHECK(dispatch(grid[0], grid[1], grid[2]));
     }
-    CHI_CHECK(popState(cmdList));
+    if (kernelBound)
+    {
+        CHI_CHECK(popState(cmdList));
+    }
     return ComputeStatus::eOk;
 }
 
@@ -45,6 +45,14 @@ struct D3D11ThreadContext : public CommonThreadContext
     ID3D11ShaderResourceView* engineSRVs[kMaxD3D11Items] = {};
     ID3D11DepthStencilView* engineDSV = {};
     ID3D11Buffer* engineConstBuffers[kMaxD3D11Items] = {};
+
+    //! Lightweight state mode, compute slots are saved the first time SL binds over them after pushState
+    bool trackBindings = false;
+    bool capturedCS = false;
+    uint32_t capturedSamplers = 0;
+    uint32_t capturedSRVs = 0;
+    uint32_t capturedUAVs = 0;
+    uint32_t capturedConstBuffers = 0;
 };
 
 struct KernelDataD3D11 : public KernelDataBase
@@ -68,6 +76,8 @@ struct ResourceDriverDataD3D11
 struct DispatchDataD3D11
 {
     KernelDataD3D11* kernel;
+    //! Immediate or deferred context SL records into on this thread
+    ID3D11DeviceContext* context;
 };
 
 class D3D11 : public Generic
@@ -88,8 +98,8 @@ class D3D11 : public Generic
     chi::Kernel m_copyKernel{};
 
     bool m_dbgSupportRs2RelaxedConversionRules = false;
+    bool m_lightweightState = false;
 
-    ID3D11DeviceContext* m_context{};
     ID3D11DeviceContext* m_immediateContext{};
     UINT m_visibleNodeMask = 0;
 
@@ -135,6 +145,8 @@ public:
 
     virtual ComputeStatus createFence(FenceFlags flags, uint64_t initialValue, Fence& outFence, const char friendlyName[])  override final;
     virtual WaitStatus waitCPUFence(Fence fence, uint64_t syncValue) override final;
+    virtual WaitStatus waitCPUFences(const Fence* fences, const uint64_t* syncValues, uint32_t count, bool waitAny = false, uint32_t timeoutMs = 500) override final;
+    virtual uint64_t getCompletedValue(Fence fence) override final;
 
     virtual ComputeStatus createCommandQueue(CommandQueueType type,
                                              ChiCommandQueue*& queue,
@@ -163,6 +175,8 @@ public:
     virtual ComputeStatus insertGPUBarrierList(CommandList cmdList, const Resource* InResources, unsigned int InResourceCount, BarrierType InBarrierType = eBarrierTypeUAV) override final;
     virtual ComputeStatus insertGPUBarrier(CommandList cmdList, Resource InResource, BarrierType InBarrierType) override final;
     virtual ComputeStatus copyResource(CommandList cmdList, Resource InDstResource, Resource InSrcResource) override final;
+    virtual ComputeStatus copyResourceRegion(CommandList cmdList, Resource InDstResource, Resource InSrcResource, const Extent& region) override final;
+    virtual ComputeStatus copyDepthToColor(CommandList cmdList, Resource InDstResource, Resource InSrcResource) override final;
     virtual ComputeStatus cloneResource(Resource InResource, Resource &OutResource, const char friendlyName[], ResourceState InitialState, unsigned int InCreationMask, unsigned int InVisibilityMask) override final;
     virtual ComputeStatus copyBufferToReadbackBuffer(CommandList cmdList, Resource InResource, Resource OutResource, unsigned int InBytesToCopy) override final;
     virtual ComputeStatus getResourceDescription(Resource InResource, ResourceDescription &OutDesc) override final;
@@ -172,11 +186,15 @@ public:
 
     virtual ComputeStatus copyHostToDeviceBuffer(CommandList InCmdList, uint64_t InSize, const void* InData, Resource InUploadResource, Resource InTargetResource, unsigned long long InUploadOffset, unsigned long long InDstOffset) override final;
     virtual ComputeStatus copyHostToDeviceTexture(CommandList InCmdList, uint64_t InSize, uint64_t RowPitch, const void* InData, Resource InTargetResource, Resource& InUploadResource) override final;
+    virtual ComputeStatus uploadToBuffer(CommandList cmdList, const void* data, uint64_t size, Resource target, uint64_t dstOffset = 0) override final;
+    virtual ComputeStatus uploadToTexture(CommandList cmdList, const void* data, uint64_t size, uint64_t rowPitch, Resource target) override final;
 
     virtual ComputeStatus setDebugName(Resource res, const char friendlyName[]) override final;
 
     virtual ComputeStatus beginPerfSection(CommandList cmdList, const char *key, unsigned int node, bool InReset = false) override final;
     virtual ComputeStatus endPerfSection(CommandList cmdList, const char *key, float &OutAvgTimeMS, unsigned int node) override final;
+    virtual ComputeStatus getPerfSectionStats(const char* key, PerfSectionStats& stats, uint32_t node) override final;
+    virtual ComputeStatus getPerfSectionNames(std::vector<std::string>& names, uint32_t node) override final;
     virtual ComputeStatus beginProfiling(CommandList cmdList, UINT metadata, const char* marker) override final;
     virtual ComputeStatus endProfiling(CommandList cmdList) override final;
 
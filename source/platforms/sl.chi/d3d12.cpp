@@ -28,6 +28,7 @@
 #include <wrl/client.h>
 
 #include "source/core/sl.log/log.h"
+#include "source/core/sl.file/file.h"
 #include "source/core/sl.interposer/d3d12/d3d12.h"
 #include "source/platforms/sl.chi/d3d12.h"
 #include "shaders/copy_to_buffer_cs.h"
@@ -55,6 +56,29 @@ inline static uint32_t calcSubresource(uint32_t MipSlice, uint32_t ArraySlice, u
     return MipSlice + (ArraySlice * MipLevels) + (PlaneSlice * MipLevels * ArraySize);
 }
 
+//! DXIL containers flag 'ResourceDescriptorHeap' indexing in the shader feature info part
+//!
+//! Container header is 'DXBC', 16 byte digest, version, total size and part count followed by part offsets,
+//! each part starts with its fourcc and size.
+inline static bool usesResourceDescriptorHeap(const uint8_t* blob, size_t size)
+{
+    constexpr size_t kHeaderSize = 32;
+    constexpr uint64_t kRequiresResourceDescriptorHeapIndexing = 0x02000000; // D3D_SHADER_REQUIRES_RESOURCE_DESCRIPTOR_HEAP_INDEXING
+    if (size < kHeaderSize) return false;
+    uint32_t partCount{};
+    memcpy(&partCount, blob + 28, sizeof(partCount));
+    for (uint32_t i = 0; i < partCount && kHeaderSize + (i + 1) * sizeof(uint32_t) <= size; i++)
+    {
+        uint32_t offset{};
+        memcpy(&offset, blob + kHeaderSize + i * sizeof(uint32_t), sizeof(offset));
+        if ((size_t)offset + 16 > size || memcmp(blob + offset, "SFI0", 4) != 0) continue;
+        uint64_t flags{};
+        memcpy(&flags, blob + offset + 8, sizeof(flags));
+        return (flags & kRequiresResourceDescriptorHeapIndexing) != 0;
+    }
+    return false;
+}
+
 D3D12 s_d3d12;
 ICompute *getD3D12()
 {
@@ -826,9 +850,11 @@ ComputeStatus D3D12::init(Device device, param::IParameters* params)
     Generic::init(device, params);
 
     m_device = (ID3D12Device*)device;
+    m_placedHeaps.init(m_device);
 
     UINT NodeCount = m_device->GetNodeCount();
     m_visibleNodeMask = (1 << NodeCount) - 1;
+    m_nodeCount = NodeCount;
 
     if (NodeCount > MAX_NUM_NODES)
     {
@@ -855,15 +881,47 @@ ComputeStatus D3D12::init(Device device, param::IParameters* params)
         m_dbgSupportRs2RelaxedConversionRules = true;
     }
 
+    // Bindless kernels index 'ResourceDescriptorHeap' directly, our heap has to be fully visible to them
+    D3D12_FEATURE_DATA_SHADER_MODEL shaderModel{ D3D_SHADER_MODEL_6_6 };
+    D3D12_FEATURE_DATA_D3D12_OPTIONS options{};
+    m_bindlessSupported = SUCCEEDED(m_device->CheckFeatureSupport(D3D12_FEATURE_SHADER_MODEL, &shaderModel, sizeof(shaderModel))) && shaderModel.HighestShaderModel >= D3D_SHADER_MODEL_6_6 &&
+        SUCCEEDED(m_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options))) && options.ResourceBindingTier >= D3D12_RESOURCE_BINDING_TIER_3;
+    SL_LOG_INFO("SM 6.6 bindless kernels %s", m_bindlessSupported ? "supported" : "not supported");
+
+    D3D12_FEATURE_DATA_D3D12_OPTIONS heapOptions{};
+    m_heapTier2 = SUCCEEDED(m_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &heapOptions, sizeof(heapOptions))) && heapOptions.ResourceHeapTier >= D3D12_RESOURCE_HEAP_TIER_2;
+
+    D3D12_FEATURE_DATA_D3D12_OPTIONS12 options12{};
+    m_enhancedBarriers = SUCCEEDED(m_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS12, &options12, sizeof(options12))) && options12.EnhancedBarriersSupported;
+    SL_LOG_INFO("Enhanced barriers %s", m_enhancedBarriers ? "supported" : "not supported");
+
     m_heap = new HeapInfo;
 
+    uint32_t descriptorCount = SL_DEFAULT_D3D12_DESCRIPTORS;
+    params->get(sl::param::global::kD3D12DescriptorCount, &descriptorCount);
+    descriptorCount = std::max(descriptorCount, SL_MIN_D3D12_DESCRIPTORS);
+    m_descriptors.init(descriptorCount);
+    m_descriptorCache.init(m_descriptors.getPersistentCount());
+    SL_LOG_INFO("D3D12 descriptor heap size %u", descriptorCount);
+
+    params->get(sl::param::global::kAsyncCompute, &m_asyncComputeEnabled);
+    if (m_asyncComputeEnabled)
+    {
+        SL_LOG_INFO("Async compute is enabled for eligible SL passes");
+    }
+
+    params->get(sl::param::global::kD3D12TrackBarrierStates, &m_trackBarrierStates);
+    if (m_trackBarrierStates)
+    {
+        SL_LOG_INFO("Resource states are tracked from host barriers");
+    }
+
     for(UINT Node = 0; Node < NodeCount; Node++)
     {
         // create desc heaps for SRV/UAV/CBV
         {
             D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
-            // Each wraparound we target a different part of the heap to prevent direct reuse
-            heapDesc.NumDescriptors = SL_MAX_D3D12_DESCRIPTORS * SL_DESCRIPTOR_WRAPAROUND_CAPACITY;
+            heapDesc.NumDescriptors = descriptorCount;
             heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
             heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
             heapDesc.NodeMask = (1 << Node);
@@ -883,6 +941,8 @@ ComputeStatus D3D12::init(Device device, param::IParameters* params)
 
     genericPostInit();
 
+    loadPipelineCache();
+
     CHI_CHECK(createKernel((void*)copy_to_buffer_cs, copy_to_buffer_cs_len, "copy_to_buffer.cs", "main", m_copyKernel));
 
     return ComputeStatus::eOk;
@@ -890,26 +950,53 @@ ComputeStatus D3D12::init(Device device, param::IParameters* params)
 
 ComputeStatus D3D12::shutdown()
 {
+    shutdownFenceCallbacks();
     CHI_CHECK(destroyKernel(m_copyKernel));
     m_copyKernel = {};
 
-    for (UINT node = 0; node < MAX_NUM_NODES; node++)
+    if (m_asyncCompute.context)
+    {
+        m_asyncCompute.context->flushAll();
+        destroyCommandListContext(m_asyncCompute.context);
+        destroyCommandQueue(m_asyncCompute.queue);
+        destroyFence(m_asyncCompute.hostFence);
+        destroyFence(m_asyncCompute.computeFence);
+        m_asyncCompute.context = {};
+        m_asyncCompute.queue = {};
+    }
+
+    while (!m_nullSwapChains.empty())
     {
-        for (auto section : m_sectionPerfMap[node])
+        destroyNullSwapChain(m_nullSwapChains.back().get());
+    }
+
+    {
+        std::scoped_lock lock(m_mutexBundles);
+        for (auto& [list, bundle] : m_bundles)
         {
-            for (int i = 0; i < SL_READBACK_QUEUE_SIZE; i++)
-            {
-                SL_SAFE_RELEASE(section.second.queryHeap[i]);
-                SL_SAFE_RELEASE(section.second.queryBufferReadback[i]);
-            }
+            releaseBundle(bundle.release());
         }
-        m_sectionPerfMap[node].clear();
+        m_bundles.clear();
+    }
+
+    for (UINT node = 0; node < MAX_NUM_NODES; node++)
+    {
+        SL_SAFE_RELEASE(m_timestampPool[node].heap);
+        SL_SAFE_RELEASE(m_timestampPool[node].readback);
+        m_timestampPool[node] = {};
         SL_SAFE_RELEASE(m_heap->descriptorHeap[node]);
         SL_SAFE_RELEASE(m_heap->descriptorHeapCPU[node]);
     }
 
     delete m_heap;
     m_heap = {};
+    m_perfSectionIds.clear();
+
+    savePipelineCache();
+    SL_SAFE_RELEASE(m_pipelineLibrary);
+    m_pipelineLibraryData.clear();
+    m_pipelineCache.clear();
+    m_rootSignatureBlobs.clear();
 
     for (auto& v : m_psoMap)
     {
@@ -937,6 +1024,9 @@ ComputeStatus D3D12::shutdown()
 
     auto res = Generic::shutdown();
 
+    // Any clones still pending destruction were released by the generic shutdown
+    m_placedHeaps.shutdown();
+
     if (dx11On12)
     {
         // We created this device so release it
@@ -948,11 +1038,11 @@ ComputeStatus D3D12::shutdown()
 
 ComputeStatus D3D12::clearCache()
 {
-    for (auto& resources : m_resourceData)
     {
-        resources.second.clear();
+        std::scoped_lock lock(m_mutexResource);
+        m_descriptorCache.clear([](uint32_t, uint32_t)->void {});
+        m_descriptors.reset(m_finishedFrame);
     }
-    m_resourceData.clear();
 
     return Generic::clearCache();
 }
@@ -972,32 +1062,54 @@ ComputeStatus D3D12::restorePipeline(CommandList cmdBuffer)
     
     assert(thread->cmdList->m_base == cmdBuffer);
 
+    // Host state is going back on the command list so whatever we tracked is stale now
+    m_dispatchContext.getContext().resetBoundState();
+
+    if (!thread->cmdList->onEvaluate())
+    {
+        // Lazy tracking, state is recorded from the next reset of this command list
+        if (thread->cmdList->m_lazyTracking)
+        {
+            SL_LOG_WARN_ONCE("Command list 0x%llx was not tracked yet, host must restore its state after this evaluate", thread->cmdList);
+        }
+        return ComputeStatus::eOk;
+    }
+
     if (thread->cmdList->m_numHeaps > 0)
     {
         cmdList->SetDescriptorHeaps(thread->cmdList->m_numHeaps, thread->cmdList->m_heaps);
     }
     if (thread->cmdList->m_rootSignature)
     {
-        cmdList->SetComputeRootSignature(thread->cmdList->m_rootSignature);
-        for (auto& pair : thread->cmdList->m_mapHandles)
-        {
-            cmdList->SetComputeRootDescriptorTable(pair.first, pair.second);
-        }
-        for (auto& pair : thread->cmdList->m_mapCBV)
+        auto proxy = thread->cmdList;
+        cmdList->SetComputeRootSignature(proxy->m_rootSignature);
+        // Each root parameter has a single type so at most one of these bits is set per index
+        uint64_t valid = proxy->m_validHandles | proxy->m_validCBV | proxy->m_validSRV | proxy->m_validUAV | proxy->m_validConstants;
+        for (uint32_t i = 0; valid; i++, valid >>= 1)
         {
-            cmdList->SetComputeRootConstantBufferView(pair.first, pair.second);
-        }
-        for (auto& pair : thread->cmdList->m_mapSRV)
-        {
-            cmdList->SetComputeRootShaderResourceView(pair.first, pair.second);
-        }
-        for (auto& pair : thread->cmdList->m_mapUAV)
-        {
-            cmdList->SetComputeRootUnorderedAccessView(pair.first, pair.second);
-        }
-        for (auto& pair : thread->cmdList->m_mapConstants)
-        {
-            cmdList->SetComputeRoot32BitConstants(pair.first, pair.second.Num32BitValuesToSet, pair.second.SrcData, pair.second.DestOffsetIn32BitValues);
+            if (!(valid & 1)) continue;
+            uint64_t bit = 1ull << i;
+            if (proxy->m_validHandles & bit)
+            {
+                cmdList->SetComputeRootDescriptorTable(i, proxy->m_handles[i]);
+            }
+            else if (proxy->m_validCBV & bit)
+            {
+                cmdList->SetComputeRootConstantBufferView(i, proxy->m_cbv[i]);
+            }
+            else if (proxy->m_validSRV & bit)
+            {
+                cmdList->SetComputeRootShaderResourceView(i, proxy->m_srv[i]);
+            }
+            else if (proxy->m_validUAV & bit)
+            {
+                cmdList->SetComputeRootUnorderedAccessView(i, proxy->m_uav[i]);
+            }
+            else
+            {
+                auto& constants = proxy->m_constants[i];
+                cmdList->SetComputeRoot32BitConstants(i, constants.Num32BitValuesToSet, constants.SrcData + constants.DestOffsetIn32BitValues, constants.DestOffsetIn32BitValues);
+            }
         }
     }
     if (thread->cmdList->m_pso)
@@ -1118,6 +1230,7 @@ ComputeStatus D3D12::getNativeResourceState(ResourceState states, uint32_t& reso
 
 ComputeStatus D3D12::createKernel(void *blobData, uint32_t blobSize, const char* fileName, const char *entryPoint, Kernel &kernel)
 {
+    SL_STARTUP_PHASE(m_startupTimeline, fileName);
     if (!blobData || !fileName || !entryPoint)
     {
         if (fileName && entryPoint)
@@ -1131,22 +1244,8 @@ ComputeStatus D3D12::createKernel(void *blobData, uint32_t blobSize, const char*
         return ComputeStatus::eInvalidArgument;
     }
 
-    size_t hash = 0;
-    const char* p = fileName;
-    while (*p)
-    {
-        hash_combine(hash, *p++);
-    }
-    p = entryPoint;
-    while (*p)
-    {
-        hash_combine(hash, *p++);
-    }
-    auto i = blobSize;
-    while (i--)
-    {
-        hash_combine(hash, ((char*)blobData)[i]);
-    }
+    // Names seed the blob hash so the same byte code registered under a different name stays distinct
+    size_t hash = hash::hash64(blobData, blobSize, hash::hashString(entryPoint, hash::hashString(fileName)));
 
     ComputeStatus Res = ComputeStatus::eOk;
     KernelDataBase*data = {};
@@ -1175,7 +1274,13 @@ ComputeStatus D3D12::createKernel(void *blobData, uint32_t blobSize, const char*
         {
             data->kernelBlob.resize(blobSize);
             memcpy(data->kernelBlob.data(), blob, blobSize);
-            SL_LOG_VERBOSE("Creating DXBC kernel %s:%s hash %llu", fileName, entryPoint, hash);
+            data->bindless = usesResourceDescriptorHeap(data->kernelBlob.data(), blobSize);
+            if (data->bindless && !m_bindlessSupported)
+            {
+                SL_LOG_ERROR( "Kernel %s:%s indexes the descriptor heap but SM 6.6 bindless is not supported", fileName, entryPoint);
+                return ComputeStatus::eNotSupported;
+            }
+            SL_LOG_VERBOSE("Creating %s kernel %s:%s hash %llu", data->bindless ? "bindless DXIL" : "DXBC", fileName, entryPoint, hash);
         }
         else
         {
@@ -1248,6 +1353,7 @@ WaitStatus D3D12::waitCPUFence(Fence fence, uint64_t syncValue)
     WaitStatus status = WaitStatus::eNoTimeout;
     if (completedValue < syncValue)
     {
+        extra::ScopedHitchTimer hitch("D3D12::waitCPUFence");
         HANDLE waitEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
         if (SUCCEEDED(d3d12Fence->SetEventOnCompletion(syncValue, waitEvent)))
         {
@@ -1266,6 +1372,37 @@ WaitStatus D3D12::waitCPUFence(Fence fence, uint64_t syncValue)
     return status;
 }
 
+WaitStatus D3D12::waitCPUFences(const Fence* fences, const uint64_t* syncValues, uint32_t count, bool waitAny, uint32_t timeoutMs)
+{
+    if (!fences || !syncValues) return WaitStatus::eError;
+    if (count == 0) return WaitStatus::eNoTimeout;
+
+    Microsoft::WRL::ComPtr<ID3D12Device1> device1;
+    if (FAILED(m_device->QueryInterface(IID_PPV_ARGS(&device1))))
+    {
+        SL_LOG_ERROR("ID3D12Device1 is required to wait on multiple fences");
+        return WaitStatus::eError;
+    }
+
+    extra::ScopedHitchTimer hitch("D3D12::waitCPUFences");
+    WaitStatus status = WaitStatus::eNoTimeout;
+    HANDLE waitEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+    auto flags = waitAny ? D3D12_MULTIPLE_FENCE_WAIT_FLAG_ANY : D3D12_MULTIPLE_FENCE_WAIT_FLAG_ALL;
+    if (SUCCEEDED(device1->SetEventOnMultipleFenceCompletion((ID3D12Fence* const*)fences, syncValues, count, flags, waitEvent)))
+    {
+        if (WaitForSingleObject(waitEvent, timeoutMs) == WAIT_TIMEOUT)
+        {
+            status = WaitStatus::eTimeout;
+        }
+    }
+    else
+    {
+        status = WaitStatus::eError;
+    }
+    CloseHandle(waitEvent);
+    return status;
+}
+
 ComputeStatus D3D12::createCommandQueue(CommandQueueType type, ChiCommandQueue*& queue, const char friendlyName[], uint32_t index)
 {
     D3D12_COMMAND_QUEUE_DESC desc = {};
@@ -1283,6 +1420,161 @@ ComputeStatus D3D12::createCommandQueue(CommandQueueType type, ChiCommandQueue*&
     return ComputeStatus::eOk;
 }
 
+ComputeStatus D3D12::beginAsyncCompute(CommandQueue hostQueue, CommandList& cmdList)
+{
+    if (!m_asyncComputeEnabled || !hostQueue) return ComputeStatus::eNoImplementation;
+
+    std::scoped_lock lock(m_mutexAsyncCompute);
+    auto& ac = m_asyncCompute;
+    if (ac.recording)
+    {
+        SL_LOG_ERROR( "Async compute pass already recording, nested passes are not supported");
+        return ComputeStatus::eInvalidCall;
+    }
+    if (!ac.context)
+    {
+        CHI_CHECK(createCommandQueue(CommandQueueType::eCompute, ac.queue, "sl.chi.asyncComputeQueue"));
+        CHI_CHECK(createCommandListContext(ac.queue, SL_READBACK_QUEUE_SIZE, ac.context, "sl.chi.asyncCompute"));
+        CHI_CHECK(createFence(eFenceFlagsNone, 0, ac.hostFence, "sl.chi.asyncComputeHostFence"));
+        CHI_CHECK(createFence(eFenceFlagsNone, 0, ac.computeFence, "sl.chi.asyncComputeFence"));
+    }
+
+    // Everything the host submitted so far must land before we start reading its resources
+    if (FAILED(((ID3D12CommandQueue*)hostQueue)->Signal((ID3D12Fence*)ac.hostFence, ++ac.hostValue)))
+    {
+        SL_LOG_ERROR( "Failed to signal the host queue");
+        return ComputeStatus::eError;
+    }
+    ac.context->waitGPUFence(ac.hostFence, ac.hostValue, DebugInfo(__FILE__, __LINE__));
+    if (!ac.context->beginCommandList())
+    {
+        return ComputeStatus::eError;
+    }
+    ac.recording = true;
+    cmdList = ac.context->getCmdList();
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::endAsyncCompute(CommandQueue hostQueue)
+{
+    if (!m_asyncComputeEnabled || !hostQueue) return ComputeStatus::eNoImplementation;
+
+    std::scoped_lock lock(m_mutexAsyncCompute);
+    auto& ac = m_asyncCompute;
+    if (!ac.recording)
+    {
+        SL_LOG_ERROR( "No async compute pass is recording");
+        return ComputeStatus::eInvalidCall;
+    }
+    ac.recording = false;
+    if (!ac.context->executeCommandList() || !ac.context->signalGPUFence(ac.computeFence, ++ac.computeValue))
+    {
+        return ComputeStatus::eError;
+    }
+    // Host work submitted from now on consumes our outputs so it has to wait, earlier host work keeps overlapping
+    if (FAILED(((ID3D12CommandQueue*)hostQueue)->Wait((ID3D12Fence*)ac.computeFence, ac.computeValue)))
+    {
+        SL_LOG_ERROR( "Failed to wait on the host queue");
+        return ComputeStatus::eError;
+    }
+    return ComputeStatus::eOk;
+}
+
+D3D12::NullSwapChain* D3D12::findNullSwapChain(SwapChain chain)
+{
+    std::scoped_lock lock(m_mutexNullSwapChains);
+    for (auto& entry : m_nullSwapChains)
+    {
+        if (entry.get() == chain) return entry.get();
+    }
+    return nullptr;
+}
+
+ComputeStatus D3D12::createNullSwapChain(const NullSwapChainDesc& desc, SwapChain& chain)
+{
+    if (!desc.bufferCount) return ComputeStatus::eInvalidArgument;
+
+    auto nullChain = std::make_unique<NullSwapChain>();
+    nullChain->desc = desc;
+    nullChain->retireValues.resize(desc.bufferCount);
+    CHI_CHECK(createFence(eFenceFlagsNone, 0, nullChain->fence, "sl.chi.nullSwapChainFence"));
+    if (desc.width && desc.height)
+    {
+        ResourceDescription bufferDesc(desc.width, desc.height, desc.format, HeapType::eHeapTypeDefault, ResourceState::ePresent,
+            ResourceFlags::eShaderResource | ResourceFlags::eColorAttachment);
+        for (uint32_t i = 0; i < desc.bufferCount; i++)
+        {
+            Resource buffer{};
+            auto status = createTexture2D(bufferDesc, buffer, "sl.chi.nullSwapChainBuffer");
+            if (status != ComputeStatus::eOk)
+            {
+                for (auto& created : nullChain->buffers) destroyResource(created, 0);
+                destroyFence(nullChain->fence);
+                return status;
+            }
+            nullChain->buffers.push_back(buffer);
+        }
+    }
+
+    chain = nullChain.get();
+    SL_LOG_INFO("Created null swap-chain 0x%llx %ux%u with %u buffers", chain, desc.width, desc.height, desc.bufferCount);
+    std::scoped_lock lock(m_mutexNullSwapChains);
+    m_nullSwapChains.push_back(std::move(nullChain));
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::destroyNullSwapChain(SwapChain chain)
+{
+    std::unique_ptr<NullSwapChain> nullChain;
+    {
+        std::scoped_lock lock(m_mutexNullSwapChains);
+        auto it = std::find_if(m_nullSwapChains.begin(), m_nullSwapChains.end(), [chain](const auto& entry) { return entry.get() == chain; });
+        if (it == m_nullSwapChains.end()) return ComputeStatus::eInvalidArgument;
+        nullChain = std::move(*it);
+        m_nullSwapChains.erase(it);
+    }
+    CHI_CHECK(releaseSwapChainBuffers(chain));
+    // Back buffers can still be referenced by work in flight, the last present retires all of them
+    if (nullChain->presentCount)
+    {
+        waitCPUFence(nullChain->fence, nullChain->presentCount);
+    }
+    for (auto& buffer : nullChain->buffers)
+    {
+        destroyResource(buffer, 0);
+    }
+    destroyFence(nullChain->fence);
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::presentNullSwapChain(SwapChain chain, CommandQueue queue, uint32_t& bufferIndex)
+{
+    auto nullChain = findNullSwapChain(chain);
+    if (!nullChain || !queue) return ComputeStatus::eInvalidArgument;
+
+    // Everything the host submitted for this frame retires the back buffer it rendered to
+    auto value = ++nullChain->presentCount;
+    if (FAILED(((ID3D12CommandQueue*)queue)->Signal((ID3D12Fence*)nullChain->fence, value)))
+    {
+        SL_LOG_ERROR( "Failed to signal the null swap-chain fence");
+        return ComputeStatus::eError;
+    }
+    nullChain->retireValues[nullChain->index] = value;
+    nullChain->index = (nullChain->index + 1) % nullChain->desc.bufferCount;
+
+    // Same pacing as a real swap-chain, the next back buffer cannot be handed out while the GPU still uses it
+    auto retireValue = nullChain->retireValues[nullChain->index];
+    if (retireValue && getCompletedValue(nullChain->fence) < retireValue)
+    {
+        if (waitCPUFence(nullChain->fence, retireValue) != WaitStatus::eNoTimeout)
+        {
+            return ComputeStatus::eError;
+        }
+    }
+    bufferIndex = nullChain->index;
+    return ComputeStatus::eOk;
+}
+
 ComputeStatus D3D12::destroyCommandQueue(ChiCommandQueue* queue)
 {
     if (queue)
@@ -1317,6 +1609,11 @@ ComputeStatus D3D12::createFence(FenceFlags flags, uint64_t initialValue, Fence&
 ComputeStatus D3D12::getFullscreenState(SwapChain chain, bool& fullscreen)
 {
     if (!chain) return ComputeStatus::eInvalidArgument;
+    if (findNullSwapChain(chain))
+    {
+        fullscreen = false;
+        return ComputeStatus::eOk;
+    }
     IDXGISwapChain* swapChain = (IDXGISwapChain*)chain;
 
     BOOL fs = false;
@@ -1332,6 +1629,7 @@ ComputeStatus D3D12::getFullscreenState(SwapChain chain, bool& fullscreen)
 ComputeStatus D3D12::setFullscreenState(SwapChain chain, bool fullscreen, Output out)
 {
     if (!chain) return ComputeStatus::eInvalidArgument;
+    if (findNullSwapChain(chain)) return ComputeStatus::eNotSupported;
     IDXGISwapChain* swapChain = (IDXGISwapChain*)chain;
     if (FAILED(swapChain->SetFullscreenState(fullscreen, (IDXGIOutput*)out)))
     {
@@ -1343,6 +1641,11 @@ ComputeStatus D3D12::setFullscreenState(SwapChain chain, bool fullscreen, Output
 ComputeStatus D3D12::getRefreshRate(SwapChain chain, float& refreshRate)
 {
     if (!chain) return ComputeStatus::eInvalidArgument;
+    if (auto nullChain = findNullSwapChain(chain))
+    {
+        refreshRate = nullChain->desc.refreshRate;
+        return ComputeStatus::eOk;
+    }
     IDXGISwapChain* swapChain = (IDXGISwapChain*)chain;
     IDXGIOutput* dxgiOutput;
     HRESULT hr = swapChain->GetContainingOutput(&dxgiOutput);
@@ -1405,6 +1708,20 @@ ComputeStatus D3D12::getRefreshRate(SwapChain chain, float& refreshRate)
 ComputeStatus D3D12::getSwapChainBuffer(SwapChain chain, uint32_t index, Resource& buffer)
 {
     ID3D12Resource* tmp;
+    if (auto nullChain = findNullSwapChain(chain))
+    {
+        if (index >= nullChain->buffers.size())
+        {
+            SL_LOG_ERROR( "Null swap-chain 0x%llx has no buffer %u", chain, index);
+            return ComputeStatus::eInvalidArgument;
+        }
+        // Handed out like a native back buffer, the caller owns a reference
+        tmp = (ID3D12Resource*)nullChain->buffers[index]->native;
+        tmp->AddRef();
+        buffer = new sl::Resource(ResourceType::eTex2d, tmp);
+        manageVRAM(buffer, VRAMOperation::eAlloc);
+        return ComputeStatus::eOk;
+    }
     if (FAILED(((IDXGISwapChain*)chain)->GetBuffer(index, IID_PPV_ARGS(&tmp))))
     {
         SL_LOG_ERROR( "Failed to get buffer from swapchain");
@@ -1422,8 +1739,11 @@ ComputeStatus D3D12::bindSharedState(CommandList InCmdList, UINT node)
     ctx.node = node;
     ctx.cmdList = (ID3D12GraphicsCommandList*)InCmdList;
 
+    // Host or NGX could have changed anything since our last dispatch so always start fresh
+    ctx.resetBoundState();
     ID3D12DescriptorHeap *Heaps[] = { m_heap->descriptorHeap[ctx.node] };
     ctx.cmdList->SetDescriptorHeaps(1, Heaps);
+    ctx.boundHeap = Heaps[0];
 
     return ComputeStatus::eOk;
 }
@@ -1450,12 +1770,13 @@ ComputeStatus D3D12::bindKernel(const Kernel kernelToBind)
     auto it = ctx.kddMap->find(ctx.kernel->hash);
     if (it == ctx.kddMap->end())
     {
-        (*ctx.kddMap)[ctx.kernel->hash] = {};
+        ctx.kdd = &(*ctx.kddMap)[ctx.kernel->hash];
     }
     else
     {
-        (*it).second.numSamplers = 0;
-        (*it).second.slot = 0;
+        ctx.kdd = &(*it).second;
+        ctx.kdd->numSamplers = 0;
+        ctx.kdd->slot = 0;
     }
     //SL_LOG_INFO("Binding kernel %s:%s", ctx.kernel->name.c_str(), ctx.kernel->entryPoint.c_str());
     
@@ -1467,7 +1788,18 @@ ComputeStatus D3D12::bindSampler(uint32_t pos, uint32_t base, Sampler sampler)
     auto& ctx = m_dispatchContext.getContext();
     if (!ctx.kernel || base >= 8) return ComputeStatus::eInvalidArgument;
 
-    auto &kdd = (*ctx.kddMap)[ctx.kernel->hash];
+    if (ctx.kernel->bindless)
+    {
+        // Shared root signature has one static sampler per 'Sampler' value at the matching register
+        if (base != (uint32_t)sampler)
+        {
+            SL_LOG_ERROR( "Bindless kernel %s expects sampler %u at register s%u", ctx.kernel->name.c_str(), sampler, sampler);
+            return ComputeStatus::eInvalidArgument;
+        }
+        return ComputeStatus::eOk;
+    }
+
+    auto &kdd = *ctx.kdd;
     if (sampler == Sampler::eSamplerPointClamp)
     {
         kdd.samplers[base] = CD3DX12_STATIC_SAMPLER_DESC(base, D3D12_FILTER_MIN_MAG_MIP_POINT, D3D12_TEXTURE_ADDRESS_MODE_CLAMP, D3D12_TEXTURE_ADDRESS_MODE_CLAMP);
@@ -1498,13 +1830,37 @@ ComputeStatus D3D12::bindConsts(uint32_t pos, uint32_t base, void *data, size_t
     auto& ctx = m_dispatchContext.getContext();
     if (!ctx.kernel) return ComputeStatus::eInvalidArgument;
 
+    // Bindless kernels share one root signature, constants always come from the ring at b0
+    bool bindless = ctx.kernel->bindless;
+    if (bindless && base != 0)
+    {
+        SL_LOG_ERROR( "Bindless kernel %s can only take constants at register b0", ctx.kernel->name.c_str());
+        return ComputeStatus::eInvalidArgument;
+    }
+
+    // Small blocks skip the constant buffer ring entirely, selection depends only on size so the layout is stable per kernel
+    // unless the slot was demoted back to a CBV because the root signature went over budget
+    auto& slots = ctx.kdd->rootParameters;
+    bool demoted = pos < (uint32_t)slots.size() && slots[pos].ParameterType == D3D12_ROOT_PARAMETER_TYPE_CBV;
+    if (!bindless && !demoted && dataSize <= kMaxRootConstantsSize && (dataSize % 4) == 0)
+    {
+        return bindRootConstants(pos, base, data, dataSize, instances);
+    }
+
+    if (ctx.bundle)
+    {
+        // Ring advances every frame while the bundle keeps pointing at the slot it was recorded with
+        SL_LOG_WARN("Kernel %s uses the constant buffer ring and cannot be recorded into a bundle", ctx.kernel->name.c_str());
+        return ComputeStatus::eInvalidCall;
+    }
+
     if (instances < 3)
     {
         SL_LOG_WARN("Detected too low instance count for circular constant buffer - please use num_viewports * 3 formula");
     }
 
-    auto &kdd = (*ctx.kddMap)[ctx.kernel->hash];
-    kdd.slot = pos;
+    auto &kdd = *ctx.kdd;
+    kdd.slot = bindless ? 0 : pos;
     if (kdd.addSlot(kdd.slot))
     {
         kdd.rootRanges[kdd.slot].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, base);
@@ -1531,12 +1887,64 @@ ComputeStatus D3D12::bindConsts(uint32_t pos, uint32_t base, void *data, size_t
     return ComputeStatus::eOk;
 }
 
+ComputeStatus D3D12::bindRootConstants(uint32_t pos, uint32_t base, const void* data, size_t dataSize, uint32_t instances)
+{
+    auto& ctx = m_dispatchContext.getContext();
+    if (!ctx.kernel || dataSize == 0 || dataSize > kMaxRootConstantsSize || (dataSize % 4) != 0) return ComputeStatus::eInvalidArgument;
+    auto &kdd = *ctx.kdd;
+    bool demoted = pos < (uint32_t)kdd.rootParameters.size() && kdd.rootParameters[pos].ParameterType == D3D12_ROOT_PARAMETER_TYPE_CBV;
+    if (ctx.kernel->bindless || demoted)
+    {
+        return bindConsts(pos, base, (void*)data, dataSize, instances);
+    }
+
+    kdd.slot = pos;
+    kdd.rootConstantInstances = std::max(kdd.rootConstantInstances, instances);
+    auto num32BitValues = (uint32_t)(dataSize / 4);
+    if (kdd.addSlot(kdd.slot))
+    {
+        kdd.rootRanges[kdd.slot].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, base);
+        kdd.rootParameters[kdd.slot].InitAsConstants(num32BitValues, base);
+        kdd.rootConstants[kdd.slot].resize(num32BitValues);
+    }
+    if (kdd.rootParameters[kdd.slot].ParameterType != D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS || kdd.rootConstants[kdd.slot].size() != num32BitValues)
+    {
+        SL_LOG_ERROR( "Root constants at slot %u do not match the layout from the first bind", kdd.slot);
+        return ComputeStatus::eInvalidArgument;
+    }
+
+    if (data)
+    {
+        // Values are recorded straight into the command list at dispatch time so there is nothing to ring buffer
+        memcpy(kdd.rootConstants[kdd.slot].data(), data, dataSize);
+    }
+    // Not a GPU handle, just keeps the slot from looking unbound
+    kdd.handles[kdd.slot] = 1;
+
+#ifndef SL_PRODUCTION
+    kdd.validate(kdd.slot, D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, base);
+#endif
+    return ComputeStatus::eOk;
+}
+
 ComputeStatus D3D12::bindTexture(uint32_t pos, uint32_t base, Resource resource, uint32_t mipOffset, uint32_t mipLevels)
 {
     auto& ctx = m_dispatchContext.getContext();
     if (!ctx.kernel) return ComputeStatus::eInvalidArgument;
 
-    auto &kdd = (*ctx.kddMap)[ctx.kernel->hash];
+    auto &kdd = *ctx.kdd;
+    if (ctx.kernel->bindless)
+    {
+        if (pos >= kMaxBindlessBindings) return ComputeStatus::eInvalidArgument;
+        ResourceDriverData data = {};
+        if (resource && resource->native)
+        {
+            CHI_CHECK(getTextureDriverData(resource, data, mipOffset, mipLevels));
+        }
+        kdd.bindlessIndices[pos] = data.descIndex;
+        return ComputeStatus::eOk;
+    }
+
     kdd.slot = pos;
     if (kdd.addSlot(kdd.slot))
     {
@@ -1549,6 +1957,10 @@ ComputeStatus D3D12::bindTexture(uint32_t pos, uint32_t base, Resource resource,
     {
         ResourceDriverData data = {};
         CHI_CHECK(getTextureDriverData(resource, data, mipOffset, mipLevels));
+        if (ctx.bundle)
+        {
+            CHI_CHECK(addBundleBinding(ctx.bundle, resource, mipOffset, mipLevels, false, data.descIndex));
+        }
         auto handle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_heap->descriptorHeap[ctx.node]->GetGPUDescriptorHandleForHeapStart(), data.descIndex, m_descriptorSize);
         kdd.handles[kdd.slot] = handle.ptr;
 
@@ -1572,7 +1984,19 @@ ComputeStatus D3D12::bindRWTexture(uint32_t pos, uint32_t base, Resource resourc
     auto& ctx = m_dispatchContext.getContext();
     if (!ctx.kernel) return ComputeStatus::eInvalidArgument;
 
-    auto &kdd = (*ctx.kddMap)[ctx.kernel->hash];
+    auto &kdd = *ctx.kdd;
+    if (ctx.kernel->bindless)
+    {
+        if (pos >= kMaxBindlessBindings) return ComputeStatus::eInvalidArgument;
+        ResourceDriverData data = {};
+        if (resource && resource->native)
+        {
+            CHI_CHECK(getSurfaceDriverData(resource, data, mipOffset));
+        }
+        kdd.bindlessIndices[pos] = data.descIndex;
+        return ComputeStatus::eOk;
+    }
+
     kdd.slot = pos;
     if (kdd.addSlot(kdd.slot))
     {
@@ -1585,6 +2009,10 @@ ComputeStatus D3D12::bindRWTexture(uint32_t pos, uint32_t base, Resource resourc
     {
         ResourceDriverData data = {};
         CHI_CHECK(getSurfaceDriverData(resource, data, mipOffset));
+        if (ctx.bundle)
+        {
+            CHI_CHECK(addBundleBinding(ctx.bundle, resource, mipOffset, 0, true, data.descIndex));
+        }
         auto handle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_heap->descriptorHeap[ctx.node]->GetGPUDescriptorHandleForHeapStart(), data.descIndex, m_descriptorSize);
         kdd.handles[kdd.slot] = handle.ptr;
 #ifndef SL_PRODUCTION
@@ -1614,12 +2042,32 @@ ComputeStatus D3D12::dispatch(uint32_t blocksX, uint32_t blocksY, uint32_t block
     auto& ctx = m_dispatchContext.getContext();
     if (!ctx.kernel) return ComputeStatus::eInvalidArgument;
 
-    auto &kdd = (*ctx.kddMap)[ctx.kernel->hash];
+    if (ctx.kernel->bindless)
+    {
+        if (ctx.bundle)
+        {
+            // Descriptor indices and constants of bindless kernels live in the per frame rings
+            SL_LOG_WARN("Bindless kernel %s cannot be recorded into a bundle", ctx.kernel->name.c_str());
+            return ComputeStatus::eInvalidCall;
+        }
+        return dispatchBindless(blocksX, blocksY, blocksZ);
+    }
+
+    auto &kdd = *ctx.kdd;
     ComputeStatus Res = ComputeStatus::eOk;
     
     {
+        if (kdd.node != ctx.node)
+        {
+            // Same kernel dispatched on another node of a linked adapter needs that node's objects
+            kdd.rootSignature = {};
+            kdd.pso = {};
+            kdd.node = ctx.node;
+        }
         if (!kdd.rootSignature)
         {
+            CHI_CHECK(fitRootSignature(kdd));
+
             //! Debug driver complains if we leave empty slot for the sampler so find and remove any.
             //! 
             //! We use static samplers always.
@@ -1639,29 +2087,30 @@ ComputeStatus D3D12::dispatch(uint32_t blocksX, uint32_t blocksY, uint32_t block
             CD3DX12_ROOT_SIGNATURE_DESC rootSignatureDesc;
             rootSignatureDesc.Init((UINT)rootParameters.size(), rootParameters.data(), kdd.numSamplers, kdd.samplers, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
             auto hash = hashRootSignature(rootSignatureDesc);
-            auto node = ctx.node << 1;
+            uint32_t node = m_nodeCount > 1 ? (1 << ctx.node) : 0;
+            if (node)
+            {
+                hash_combine(hash, node);
+            }
 
             {
                 std::scoped_lock lock(m_mutexKernel);
                 auto it = m_rootSignatureMap.find(hash);
                 if (it == m_rootSignatureMap.end())
                 {
-                    ID3DBlob *signature;
-                    ID3DBlob *error;
+                    ID3DBlob *signature{};
+                    ID3DBlob *error{};
                     D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, &error);
                     if (error)
                     {
                         SL_LOG_ERROR( "D3D12SerializeRootSignature failed %s", (const char*)error->GetBufferPointer());
                         error->Release();
+                        SL_SAFE_RELEASE(signature);
                         return ComputeStatus::eError;
                     }
-                    if (FAILED(m_device->CreateRootSignature(node, signature->GetBufferPointer(), signature->GetBufferSize(), IID_PPV_ARGS(&kdd.rootSignature))))
-                    {
-                        SL_LOG_ERROR( "Failed to create root signature");
-                        return ComputeStatus::eError;
-                    }
-                    SL_LOG_VERBOSE("Created root signature 0x%llx with hash %llu", kdd.rootSignature, hash);
-                    m_rootSignatureMap[hash] = kdd.rootSignature;
+                    Res = createRootSignature(hash, signature->GetBufferPointer(), signature->GetBufferSize(), node, kdd.rootSignature);
+                    signature->Release();
+                    CHI_CHECK(Res);
                 }
                 else
                 {
@@ -1670,22 +2119,13 @@ ComputeStatus D3D12::dispatch(uint32_t blocksX, uint32_t blocksY, uint32_t block
             }
 
             {
+                auto rootSignatureHash = hash;
                 hash_combine(hash, ctx.kernel->hash);
                 std::scoped_lock lock(m_mutexKernel);
                 auto it = m_psoMap.find(hash);
                 if (it == m_psoMap.end())
                 {
-                    D3D12_COMPUTE_PIPELINE_STATE_DESC psoDesc = {};
-                    psoDesc.pRootSignature = kdd.rootSignature;
-                    psoDesc.CS = { ctx.kernel->kernelBlob.data(), ctx.kernel->kernelBlob.size() };
-                    psoDesc.NodeMask = node;
-                    if (FAILED(m_device->CreateComputePipelineState(&psoDesc, IID_PPV_ARGS(&kdd.pso))))
-                    {
-                        SL_LOG_ERROR( "Failed to create CS pipeline state");
-                        return ComputeStatus::eError;
-                    }
-                    SL_LOG_VERBOSE("Created pipeline state 0x%llx with hash %llu", kdd.pso, hash);
-                    m_psoMap[hash] = kdd.pso;
+                    CHI_CHECK(createPipelineState(hash, ctx.kernel, rootSignatureHash, kdd.rootSignature, node, kdd.pso));
                 }
                 else
                 {
@@ -1700,8 +2140,23 @@ ComputeStatus D3D12::dispatch(uint32_t blocksX, uint32_t blocksY, uint32_t block
             return ComputeStatus::eError;
         }
 
-        ctx.cmdList->SetComputeRootSignature(kdd.rootSignature);
-        ctx.cmdList->SetPipelineState(kdd.pso);
+        // Consecutive dispatches of the same kernel in one evaluate only need new root arguments
+        auto heap = m_heap->descriptorHeap[ctx.node];
+        if (ctx.boundHeap != heap)
+        {
+            ctx.cmdList->SetDescriptorHeaps(1, &heap);
+            ctx.boundHeap = heap;
+        }
+        if (ctx.boundRootSignature != kdd.rootSignature)
+        {
+            ctx.cmdList->SetComputeRootSignature(kdd.rootSignature);
+            ctx.boundRootSignature = kdd.rootSignature;
+        }
+        if (ctx.boundPSO != kdd.pso)
+        {
+            ctx.cmdList->SetPipelineState(kdd.pso);
+            ctx.boundPSO = kdd.pso;
+        }
 
         //! Set root parameters by accounting for the empty sampler slot(s) (if any)
         //! 
@@ -1716,6 +2171,11 @@ ComputeStatus D3D12::dispatch(uint32_t blocksX, uint32_t blocksY, uint32_t block
             {
                 ctx.cmdList->SetComputeRootConstantBufferView(slot, { handle });
             }
+            else if (param.ParameterType == D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS)
+            {
+                auto& constants = kdd.rootConstants[itp - kdd.rootParameters.begin()];
+                ctx.cmdList->SetComputeRoot32BitConstants(slot, (UINT)constants.size(), constants.data(), 0);
+            }
             else if (param.ParameterType == D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE)
             {
                 if (param.DescriptorTable.NumDescriptorRanges == 0)
@@ -1741,67 +2201,524 @@ ComputeStatus D3D12::dispatch(uint32_t blocksX, uint32_t blocksY, uint32_t block
     return Res;
 }
 
-size_t D3D12::hashRootSignature(const CD3DX12_ROOT_SIGNATURE_DESC& desc)
+ComputeStatus D3D12::getBindlessRootSignature(uint32_t node, size_t& hash, ID3D12RootSignature*& rootSignature)
 {
-    size_t h = 0;
-    hash_combine(h, desc.Flags);
-    hash_combine(h, desc.NumParameters);
-    hash_combine(h, desc.NumStaticSamplers);
-    for (uint32_t i = 0; i < desc.NumStaticSamplers; i++)
+    // Layout never changes so a fixed seed is enough to tell it apart from the per kernel root signatures
+    uint32_t nodeMask = m_nodeCount > 1 ? (1 << node) : 0;
+    hash = hash::hashString("sl.bindless.rootSignature");
+    if (nodeMask)
     {
-        hash_combine(h, desc.pStaticSamplers[i].Filter);
-        hash_combine(h, desc.pStaticSamplers[i].ShaderRegister);
-        hash_combine(h, desc.pStaticSamplers[i].AddressU);
-        hash_combine(h, desc.pStaticSamplers[i].AddressV);
-        hash_combine(h, desc.pStaticSamplers[i].AddressW);
-        hash_combine(h, desc.pStaticSamplers[i].MipLODBias);
-        hash_combine(h, desc.pStaticSamplers[i].ShaderVisibility);
+        hash_combine(hash, nodeMask);
     }
-    for (uint32_t i = 0; i < desc.NumParameters; i++)
+
+    std::scoped_lock lock(m_mutexKernel);
+    auto it = m_rootSignatureMap.find(hash);
+    if (it != m_rootSignatureMap.end())
     {
-        hash_combine(h, desc.pParameters[i].ParameterType);
-        hash_combine(h, desc.pParameters[i].ShaderVisibility);
+        rootSignature = (*it).second;
+        return ComputeStatus::eOk;
+    }
+
+    // Descriptor indices at b0 space1, see 'shaders/bindless.hlsli', host constants at b0 and
+    // static samplers at the register matching their 'Sampler' value
+    CD3DX12_ROOT_PARAMETER1 rootParameters[2];
+    rootParameters[0].InitAsConstants(kMaxBindlessBindings, 0, 1);
+    // Same semantics as version 1.0 root signatures, constant buffer ring can be updated after recording
+    rootParameters[1].InitAsConstantBufferView(0, 0, D3D12_ROOT_DESCRIPTOR_FLAG_DATA_VOLATILE);
+    CD3DX12_STATIC_SAMPLER_DESC samplers[eSamplerCount];
+    samplers[eSamplerLinearClamp] = CD3DX12_STATIC_SAMPLER_DESC(eSamplerLinearClamp, D3D12_FILTER_MIN_MAG_MIP_LINEAR, D3D12_TEXTURE_ADDRESS_MODE_CLAMP, D3D12_TEXTURE_ADDRESS_MODE_CLAMP);
+    samplers[eSamplerLinearMirror] = CD3DX12_STATIC_SAMPLER_DESC(eSamplerLinearMirror, D3D12_FILTER_MIN_MAG_MIP_LINEAR, D3D12_TEXTURE_ADDRESS_MODE_MIRROR, D3D12_TEXTURE_ADDRESS_MODE_MIRROR);
+    samplers[eSamplerAnisoClamp] = CD3DX12_STATIC_SAMPLER_DESC(eSamplerAnisoClamp, D3D12_FILTER_ANISOTROPIC, D3D12_TEXTURE_ADDRESS_MODE_CLAMP, D3D12_TEXTURE_ADDRESS_MODE_CLAMP);
+    samplers[eSamplerPointClamp] = CD3DX12_STATIC_SAMPLER_DESC(eSamplerPointClamp, D3D12_FILTER_MIN_MAG_MIP_POINT, D3D12_TEXTURE_ADDRESS_MODE_CLAMP, D3D12_TEXTURE_ADDRESS_MODE_CLAMP);
+    samplers[eSamplerPointMirror] = CD3DX12_STATIC_SAMPLER_DESC(eSamplerPointMirror, D3D12_FILTER_MIN_MAG_MIP_POINT, D3D12_TEXTURE_ADDRESS_MODE_MIRROR, D3D12_TEXTURE_ADDRESS_MODE_MIRROR);
+
+    CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDesc;
+    rootSignatureDesc.Init_1_1((UINT)countof(rootParameters), rootParameters, (UINT)countof(samplers), samplers, D3D12_ROOT_SIGNATURE_FLAG_CBV_SRV_UAV_HEAP_DIRECTLY_INDEXED);
+
+    ID3DBlob* signature{};
+    ID3DBlob* error{};
+    D3D12SerializeVersionedRootSignature(&rootSignatureDesc, &signature, &error);
+    if (error)
+    {
+        SL_LOG_ERROR( "D3D12SerializeVersionedRootSignature failed %s", (const char*)error->GetBufferPointer());
+        error->Release();
+        SL_SAFE_RELEASE(signature);
+        return ComputeStatus::eError;
+    }
+    auto res = createRootSignature(hash, signature->GetBufferPointer(), signature->GetBufferSize(), nodeMask, rootSignature);
+    signature->Release();
+    return res;
+}
+
+ComputeStatus D3D12::dispatchBindless(uint32_t blocksX, uint32_t blocksY, uint32_t blocksZ)
+{
+    auto& ctx = m_dispatchContext.getContext();
+    auto& kdd = *ctx.kdd;
+    if (kdd.node != ctx.node)
+    {
+        kdd.rootSignature = {};
+        kdd.pso = {};
+        kdd.node = ctx.node;
+    }
+    if (!kdd.rootSignature || !kdd.pso)
+    {
+        size_t hash{};
+        CHI_CHECK(getBindlessRootSignature(ctx.node, hash, kdd.rootSignature));
+        auto rootSignatureHash = hash;
+        hash_combine(hash, ctx.kernel->hash);
+        uint32_t node = m_nodeCount > 1 ? (1 << ctx.node) : 0;
+        std::scoped_lock lock(m_mutexKernel);
+        auto it = m_psoMap.find(hash);
+        if (it == m_psoMap.end())
+        {
+            CHI_CHECK(createPipelineState(hash, ctx.kernel, rootSignatureHash, kdd.rootSignature, node, kdd.pso));
+        }
+        else
+        {
+            kdd.pso = (*it).second;
+        }
+    }
+
+    // Every bindless kernel shares the root signature so switching kernels only changes the PSO and root arguments
+    auto heap = m_heap->descriptorHeap[ctx.node];
+    if (ctx.boundHeap != heap)
+    {
+        ctx.cmdList->SetDescriptorHeaps(1, &heap);
+        ctx.boundHeap = heap;
+    }
+    if (ctx.boundRootSignature != kdd.rootSignature)
+    {
+        ctx.cmdList->SetComputeRootSignature(kdd.rootSignature);
+        ctx.boundRootSignature = kdd.rootSignature;
+    }
+    if (ctx.boundPSO != kdd.pso)
+    {
+        ctx.cmdList->SetPipelineState(kdd.pso);
+        ctx.boundPSO = kdd.pso;
+    }
+    ctx.cmdList->SetComputeRoot32BitConstants(0, kMaxBindlessBindings, kdd.bindlessIndices, 0);
+    if (!kdd.handles.empty() && kdd.handles[0])
+    {
+        ctx.cmdList->SetComputeRootConstantBufferView(1, { kdd.handles[0] });
+    }
+    ctx.cmdList->Dispatch(blocksX, blocksY, blocksZ);
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::createRootSignature(size_t hash, const void* blob, size_t blobSize, uint32_t node, ID3D12RootSignature*& rootSignature)
+{
+    if (FAILED(m_device->CreateRootSignature(node, blob, blobSize, IID_PPV_ARGS(&rootSignature))))
+    {
+        SL_LOG_ERROR( "Failed to create root signature");
+        return ComputeStatus::eError;
+    }
+    SL_LOG_VERBOSE("Created root signature 0x%llx with hash %llu", rootSignature, hash);
+    m_rootSignatureMap[hash] = rootSignature;
+    // Serialized form is what the pipeline cache manifest needs to recreate it next time
+    m_rootSignatureBlobs[hash].assign((const uint8_t*)blob, (const uint8_t*)blob + blobSize);
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::createPipelineState(size_t hash, const KernelDataBase* kernel, size_t rootSignatureHash, ID3D12RootSignature* rootSignature, uint32_t node, ID3D12PipelineState*& pso)
+{
+    D3D12_COMPUTE_PIPELINE_STATE_DESC psoDesc = {};
+    psoDesc.pRootSignature = rootSignature;
+    psoDesc.CS = { kernel->kernelBlob.data(), kernel->kernelBlob.size() };
+    psoDesc.NodeMask = node;
+
+    auto name = L"sl_" + std::to_wstring(hash);
+    if (m_pipelineLibrary && SUCCEEDED(m_pipelineLibrary->LoadComputePipeline(name.c_str(), &psoDesc, IID_PPV_ARGS(&pso))))
+    {
+        SL_LOG_VERBOSE("Loaded pipeline state 0x%llx with hash %llu from pipeline library", pso, hash);
+    }
+    else
+    {
+        if (FAILED(m_device->CreateComputePipelineState(&psoDesc, IID_PPV_ARGS(&pso))))
+        {
+            SL_LOG_ERROR( "Failed to create CS pipeline state");
+            return ComputeStatus::eError;
+        }
+        SL_LOG_VERBOSE("Created pipeline state 0x%llx with hash %llu", pso, hash);
+        if (m_pipelineLibrary && SUCCEEDED(m_pipelineLibrary->StorePipeline(name.c_str(), pso)))
+        {
+            m_pipelineCacheDirty = true;
+        }
+    }
+    m_psoMap[hash] = pso;
+
+    auto& entry = m_pipelineCache[hash];
+    if (entry.rootSignatureBlob.empty())
+    {
+        entry = { kernel->hash, rootSignatureHash, node, m_rootSignatureBlobs[rootSignatureHash] };
+        m_pipelineCacheDirty = true;
+    }
+    return ComputeStatus::eOk;
+}
+
+namespace
+{
+//! Manifest layout is a header followed by 'count' entries of
+//! { psoHash, kernel, rootSignature, node, blobSize, blob[blobSize] }
+constexpr uint32_t kPipelineManifestMagic = 0x43504c53; // 'SLPC'
+constexpr uint32_t kPipelineManifestVersion = 1;
+}
+
+void D3D12::loadPipelineCache()
+{
+    ID3D12Device1* device1{};
+    if (FAILED(m_device->QueryInterface(IID_PPV_ARGS(&device1))))
+    {
+        SL_LOG_WARN("ID3D12Device1 is not available, persistent pipeline cache is disabled");
+        return;
+    }
+
+    auto libraryPath = getPipelineCachePath(L".d3d12.psolib");
+    auto manifestPath = getPipelineCachePath(L".d3d12.manifest");
+    if (libraryPath.empty() || manifestPath.empty())
+    {
+        device1->Release();
+        return;
+    }
+
+    if (file::exists(libraryPath.c_str()))
+    {
+        // Must stay alive as long as the library since the runtime does not copy it
+        m_pipelineLibraryData = file::read(libraryPath.c_str());
+    }
+    HRESULT hr = E_FAIL;
+    if (!m_pipelineLibraryData.empty())
+    {
+        hr = device1->CreatePipelineLibrary(m_pipelineLibraryData.data(), m_pipelineLibraryData.size(), IID_PPV_ARGS(&m_pipelineLibrary));
+        if (FAILED(hr))
+        {
+            // Driver or adapter changed, compiled PSOs are useless but the manifest still lets us prewarm
+            SL_LOG_INFO("Discarding stale pipeline library %S hr=%d", libraryPath.c_str(), hr);
+            m_pipelineLibraryData.clear();
+            m_pipelineCacheDirty = true;
+        }
+    }
+    if (FAILED(hr) && FAILED(device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&m_pipelineLibrary))))
+    {
+        SL_LOG_WARN("Failed to create pipeline library, persistent pipeline cache is disabled");
+    }
+    device1->Release();
+
+    if (!file::exists(manifestPath.c_str()))
+    {
+        return;
+    }
+    auto manifest = file::map(manifestPath.c_str());
+    size_t offset = 0;
+    auto readData = [&manifest, &offset](void* dst, size_t size)->bool
+    {
+        if (offset + size > manifest.size()) return false;
+        memcpy(dst, manifest.data() + offset, size);
+        offset += size;
+        return true;
+    };
+    uint32_t header[3] = {};
+    if (!readData(header, sizeof(header)) || header[0] != kPipelineManifestMagic || header[1] != kPipelineManifestVersion)
+    {
+        SL_LOG_WARN("Ignoring invalid pipeline cache manifest %S", manifestPath.c_str());
+        return;
+    }
+    for (uint32_t i = 0; i < header[2]; i++)
+    {
+        uint64_t hashes[3] = {};
+        uint32_t info[2] = {};
+        PipelineCacheEntry entry{};
+        if (!readData(hashes, sizeof(hashes)) || !readData(info, sizeof(info)) || info[1] == 0 || offset + info[1] > manifest.size())
+        {
+            SL_LOG_WARN("Pipeline cache manifest %S is truncated", manifestPath.c_str());
+            break;
+        }
+        entry.kernel = hashes[1];
+        entry.rootSignature = hashes[2];
+        entry.node = info[0];
+        entry.rootSignatureBlob.assign(manifest.begin() + offset, manifest.begin() + offset + info[1]);
+        offset += info[1];
+        m_pipelineCache[hashes[0]] = std::move(entry);
+    }
+    SL_LOG_INFO("Loaded %llu pipeline(s) from cache manifest %S", m_pipelineCache.size(), manifestPath.c_str());
+}
+
+void D3D12::savePipelineCache()
+{
+    if (!m_pipelineCacheDirty) return;
+    m_pipelineCacheDirty = false;
+
+    if (m_pipelineLibrary)
+    {
+        std::vector<uint8_t> data(m_pipelineLibrary->GetSerializedSize());
+        if (SUCCEEDED(m_pipelineLibrary->Serialize(data.data(), data.size())))
+        {
+            file::write(getPipelineCachePath(L".d3d12.psolib").c_str(), data);
+        }
+        else
+        {
+            SL_LOG_WARN("Failed to serialize pipeline library");
+        }
+    }
+
+    std::vector<uint8_t> manifest;
+    auto writeData = [&manifest](const void* src, size_t size)->void
+    {
+        manifest.insert(manifest.end(), (const uint8_t*)src, (const uint8_t*)src + size);
+    };
+    uint32_t header[3] = { kPipelineManifestMagic, kPipelineManifestVersion, (uint32_t)m_pipelineCache.size() };
+    writeData(header, sizeof(header));
+    for (auto& [hash, entry] : m_pipelineCache)
+    {
+        uint64_t hashes[3] = { hash, entry.kernel, entry.rootSignature };
+        uint32_t info[2] = { entry.node, (uint32_t)entry.rootSignatureBlob.size() };
+        writeData(hashes, sizeof(hashes));
+        writeData(info, sizeof(info));
+        writeData(entry.rootSignatureBlob.data(), entry.rootSignatureBlob.size());
+    }
+    file::write(getPipelineCachePath(L".d3d12.manifest").c_str(), manifest);
+}
+
+ComputeStatus D3D12::prewarmKernels(const Kernel* kernels, uint32_t count)
+{
+    if (!kernels) return ComputeStatus::eInvalidArgument;
+
+    std::scoped_lock lock(m_mutexKernel);
+    uint32_t prewarmed = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto it = m_kernels.find(kernels[i]);
+        if (it == m_kernels.end())
+        {
+            SL_LOG_WARN("Unable to prewarm unknown kernel %llu", kernels[i]);
+            continue;
+        }
+        auto kernel = (*it).second;
+        for (auto& [hash, entry] : m_pipelineCache)
+        {
+            if (entry.kernel != kernel->hash || m_psoMap.find(hash) != m_psoMap.end()) continue;
+
+            // Stale manifest entries are not fatal, dispatch will simply create the pipeline lazily
+            ID3D12RootSignature* rootSignature{};
+            auto rs = m_rootSignatureMap.find(entry.rootSignature);
+            if (rs != m_rootSignatureMap.end())
+            {
+                rootSignature = (*rs).second;
+            }
+            else if (createRootSignature(entry.rootSignature, entry.rootSignatureBlob.data(), entry.rootSignatureBlob.size(), entry.node, rootSignature) != ComputeStatus::eOk)
+            {
+                continue;
+            }
+            ID3D12PipelineState* pso{};
+            if (createPipelineState(hash, kernel, entry.rootSignature, rootSignature, entry.node, pso) == ComputeStatus::eOk)
+            {
+                prewarmed++;
+            }
+        }
+    }
+    SL_LOG_INFO("Prewarmed %u pipeline(s) for %u kernel(s)", prewarmed, count);
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::getShaderCaps(ShaderCaps& caps)
+{
+    caps = {};
+    caps.bindlessResources = m_bindlessSupported;
+
+    // SM 6.2 half precision needs native 16-bit ops, 'MinPrecisionSupport' alone only allows relaxed precision hints
+    D3D12_FEATURE_DATA_D3D12_OPTIONS options{};
+    D3D12_FEATURE_DATA_D3D12_OPTIONS4 options4{};
+    if (SUCCEEDED(m_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options))) &&
+        SUCCEEDED(m_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS4, &options4, sizeof(options4))))
+    {
+        caps.nativeFP16 = (options.MinPrecisionSupport & D3D12_SHADER_MIN_PRECISION_SUPPORT_16_BIT) && options4.Native16BitShaderOpsSupported;
+    }
+
+    D3D12_FEATURE_DATA_D3D12_OPTIONS1 options1{};
+    if (SUCCEEDED(m_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS1, &options1, sizeof(options1))) && options1.WaveOps)
+    {
+        caps.waveLaneCountMin = options1.WaveLaneCountMin;
+        caps.waveLaneCountMax = options1.WaveLaneCountMax;
+    }
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::fitRootSignature(KernelDispatchData& kdd)
+{
+    auto getCost = [&kdd]()->uint32_t
+    {
+        uint32_t cost = 0;
+        for (auto& param : kdd.rootParameters)
+        {
+            if (param.ParameterType == D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS) cost += param.Constants.Num32BitValues;
+            else if (param.ParameterType != D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE) cost += 2;
+            else if (param.DescriptorTable.NumDescriptorRanges) cost += 1;
+        }
+        return cost;
+    };
+
+    // Largest root constant blocks go back to the ring backed CBV first, each one saves 'Num32BitValues - 2' DWORDs
+    auto cost = getCost();
+    while (cost > kMaxRootSignatureDWORDs)
+    {
+        uint32_t largest = UINT_MAX;
+        for (uint32_t i = 0; i < (uint32_t)kdd.rootParameters.size(); i++)
+        {
+            auto& param = kdd.rootParameters[i];
+            if (param.ParameterType == D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS && param.Constants.Num32BitValues > 2 &&
+                (largest == UINT_MAX || param.Constants.Num32BitValues > kdd.rootParameters[largest].Constants.Num32BitValues))
+            {
+                largest = i;
+            }
+        }
+        if (largest == UINT_MAX)
+        {
+            SL_LOG_ERROR( "Root signature needs %u DWORDs, limit is %u", cost, kMaxRootSignatureDWORDs);
+            return ComputeStatus::eInvalidArgument;
+        }
+
+        auto& constants = kdd.rootConstants[largest];
+        auto size = (uint32_t)(constants.size() * sizeof(uint32_t));
+        SL_LOG_INFO("Root signature needs %u DWORDs, moving %u bytes of root constants at slot %u to a constant buffer", cost, size, largest);
+        kdd.rootParameters[largest].InitAsConstantBufferView(kdd.rootParameters[largest].Constants.ShaderRegister);
+        if (!kdd.cb[largest])
+        {
+            kdd.cb[largest] = new ConstantBuffer();
+            kdd.cb[largest]->create(m_device, size, kdd.rootConstantInstances);
+        }
+        // Values from this dispatch were only recorded as root constants so far
+        auto idx = kdd.cb[largest]->getIndex();
+        kdd.cb[largest]->copyStagingToGpu(constants.data(), idx);
+        kdd.handles[largest] = kdd.cb[largest]->getGpuVirtualAddress(idx);
+        kdd.cb[largest]->advanceIndex();
+        constants.clear();
+        cost = getCost();
+    }
+    return ComputeStatus::eOk;
+}
+
+size_t D3D12::hashRootSignature(const CD3DX12_ROOT_SIGNATURE_DESC& desc)
+{
+    // Pack everything that matters into a flat array and hash it in one go
+    std::vector<uint32_t> fields;
+    fields.reserve(3 + desc.NumStaticSamplers * 7 + desc.NumParameters * 4);
+    auto add = [&fields](uint32_t v)->void { fields.push_back(v); };
+
+    add(desc.Flags);
+    add(desc.NumParameters);
+    add(desc.NumStaticSamplers);
+    for (uint32_t i = 0; i < desc.NumStaticSamplers; i++)
+    {
+        uint32_t bias;
+        memcpy(&bias, &desc.pStaticSamplers[i].MipLODBias, sizeof(bias));
+        add(desc.pStaticSamplers[i].Filter);
+        add(desc.pStaticSamplers[i].ShaderRegister);
+        add(desc.pStaticSamplers[i].AddressU);
+        add(desc.pStaticSamplers[i].AddressV);
+        add(desc.pStaticSamplers[i].AddressW);
+        add(bias);
+        add(desc.pStaticSamplers[i].ShaderVisibility);
+    }
+    for (uint32_t i = 0; i < desc.NumParameters; i++)
+    {
+        add(desc.pParameters[i].ParameterType);
+        add(desc.pParameters[i].ShaderVisibility);
         if (desc.pParameters[i].ParameterType == D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE)
         {
-            hash_combine(h, desc.pParameters[i].DescriptorTable.NumDescriptorRanges);
+            add(desc.pParameters[i].DescriptorTable.NumDescriptorRanges);
             for (uint32_t j = 0; j < desc.pParameters[i].DescriptorTable.NumDescriptorRanges; j++)
             {
-                hash_combine(h, desc.pParameters[i].DescriptorTable.pDescriptorRanges[j].RangeType);
+                add(desc.pParameters[i].DescriptorTable.pDescriptorRanges[j].RangeType);
             }
         }
         else if (desc.pParameters[i].ParameterType == D3D12_ROOT_PARAMETER_TYPE_CBV)
         {
-            hash_combine(h, desc.pParameters[i].Descriptor.RegisterSpace);
+            add(desc.pParameters[i].Descriptor.RegisterSpace);
+        }
+        else if (desc.pParameters[i].ParameterType == D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS)
+        {
+            add(desc.pParameters[i].Constants.ShaderRegister);
+            add(desc.pParameters[i].Constants.Num32BitValues);
         }
         else
         {
             SL_LOG_ERROR( "Unsupported parameter type in root signature");
         }
     }
-    return h;
+    return hash::hash64(fields.data(), fields.size() * sizeof(uint32_t));
+}
+
+// {4F1C8A57-3D2B-4E6A-9B0D-7C5E2A61F3B8}
+static const GUID sDescriptorSerialGUID = { 0x4f1c8a57, 0x3d2b, 0x4e6a, { 0x9b, 0xd, 0x7c, 0x5e, 0x2a, 0x61, 0xf3, 0xb8 } };
+// {9C3E5B21-7A4D-4F08-8E6B-1D2F7C9A4E53}
+static const GUID sOwnedTextureGUID = { 0x9c3e5b21, 0x7a4d, 0x4f08, { 0x8e, 0x6b, 0x1d, 0x2f, 0x7c, 0x9a, 0x4e, 0x53 } };
+
+//! Textures created by chi use enhanced layouts, host textures keep legacy states the host still relies on
+static void markOwnedTexture(ID3D12Resource* resource)
+{
+    uint8_t owned = 1;
+    resource->SetPrivateData(sOwnedTextureGUID, sizeof(owned), &owned);
+}
+
+static bool isOwnedTexture(ID3D12Resource* resource)
+{
+    uint8_t owned = 0;
+    UINT size = sizeof(owned);
+    return SUCCEEDED(resource->GetPrivateData(sOwnedTextureGUID, &size, &owned)) && owned;
+}
+
+uint32_t D3D12::getResourceNodeMask(ID3D12Resource* resource)
+{
+    if (m_nodeCount == 1) return 1;
+
+    // Reserved resources have no heap properties, assume they can be seen everywhere
+    D3D12_HEAP_PROPERTIES props{};
+    if (SUCCEEDED(resource->GetHeapProperties(&props, nullptr)))
+    {
+        auto mask = (props.VisibleNodeMask ? props.VisibleNodeMask : 1) & m_visibleNodeMask;
+        if (mask) return mask;
+    }
+    return m_visibleNodeMask;
+}
+
+uint32_t D3D12::getDescriptorSerial(ID3D12Resource* resource)
+{
+    // Private data goes away with the resource so a recycled pointer never shows an old serial
+    uint32_t serial = 0;
+    UINT size = sizeof(serial);
+    if (FAILED(resource->GetPrivateData(sDescriptorSerialGUID, &size, &serial)) || serial == 0)
+    {
+        serial = ++m_descriptorSerial;
+        if (serial == 0) serial = ++m_descriptorSerial;
+        if (FAILED(resource->SetPrivateData(sDescriptorSerialGUID, sizeof(serial), &serial)))
+        {
+            SL_LOG_ERROR("Failed to set descriptor serial for resource 0x%llx", resource);
+        }
+    }
+    return serial;
 }
 
-UINT D3D12::getNewAndIncreaseDescIndex()
+UINT D3D12::getNewAndIncreaseDescIndex(void* resource, uint64_t key)
 {
     // This method is thread safe since it is just a helper for cache texture or surface
 
-    auto node = 0; // FIX THIS
-    if ((m_heap->descIndex[node] + 1) >= SL_MAX_D3D12_DESCRIPTORS)
+    uint32_t frame = m_finishedFrame;
+    if (m_descriptorCache.isFull())
     {
-        // We've looped around our Descriptor heap
-        // There's no way we can keep the old cached Descriptors as valid..
-        // Invalidate all caches and force the SetInput() calls to set up new ones
-        // It will be a slow burn for a while, but hopefully that isn't too frequent ??
-        SL_LOG_WARN("D3D12 Descriptor heap wrap around. Clearing all cache and reallocating from scratch again. This is impacting performance - please do NOT change the tagged resources every frame");
-        memset(m_heap->descIndex, 0, MAX_NUM_NODES * sizeof(UINT));
-        assert(m_heap->descIndex[node] == 0);
-        m_heap->wrapAroundCount = (m_heap->wrapAroundCount + 1) % SL_DESCRIPTOR_WRAPAROUND_CAPACITY;
-        m_resourceData.clear();
+        // Make room by dropping the least recently used view, if everything is in flight the ring takes over
+        m_descriptorCache.evict(frame, DescriptorAllocator::kFrameDelay, [this](uint32_t index, uint32_t lastUsed)->void
+        {
+            m_descriptors.release(index, lastUsed);
+        });
     }
-    UINT ReturnedIndex = m_heap->descIndex[node] + SL_MAX_D3D12_DESCRIPTORS * m_heap->wrapAroundCount;
-    m_heap->descIndex[node] = (m_heap->descIndex[node] + 1) % SL_MAX_D3D12_DESCRIPTORS;
 
-    return ReturnedIndex;
+    DescriptorAllocator::Owner evicted{};
+    auto index = m_descriptors.allocate(frame, resource, key, evicted);
+    if (evicted.resource)
+    {
+        // Ring slot got reused, whoever cached it has to create a new view next time
+        m_descriptorCache.erase(evicted.resource, evicted.key);
+    }
+    return index;
 }
 
 ComputeStatus D3D12::getTextureDriverData(Resource res, ResourceDriverData &data, uint32_t mipOffset, uint32_t mipLevels, Sampler sampler)
@@ -1810,16 +2727,23 @@ ComputeStatus D3D12::getTextureDriverData(Resource res, ResourceDriverData &data
 
     ID3D12Resource* resource = (ID3D12Resource*)(res->native);
 
-    std::scoped_lock lock(m_mutexResource);
-
     uint32_t hash = (mipOffset << 16) | mipLevels;
+    auto key = DescriptorCache::makeKey(getDescriptorSerial(resource), hash);
+    uint32_t frame = m_finishedFrame;
+
+    // Lookup and touch must be atomic with respect to eviction, otherwise the slot
+    // could be handed to another resource between 'find' and 'touch'
+    std::scoped_lock lock(m_mutexResource);
 
-    auto it = m_resourceData.find(resource);
-    if (it == m_resourceData.end() || (*it).second.find(hash) == (*it).second.end())
+    data.heap = m_heap;
+    if (m_descriptorCache.find(resource, key, frame, data.descIndex, data.bZBCSupported))
+    {
+        m_descriptors.touch(data.descIndex, frame);
+    }
+    else
     {
-        auto node = 0; // FIX THIS
-        data.descIndex = getNewAndIncreaseDescIndex();
-        auto currentCPUHandle =  CD3DX12_CPU_DESCRIPTOR_HANDLE(m_heap->descriptorHeap[node]->GetCPUDescriptorHandleForHeapStart(), data.descIndex, m_descriptorSize);
+        auto nodeMask = getResourceNodeMask(resource);
+        data.descIndex = getNewAndIncreaseDescIndex(resource, key);
 
         D3D12_RESOURCE_DESC desc = resource->GetDesc();
 
@@ -1831,19 +2755,18 @@ ComputeStatus D3D12::getTextureDriverData(Resource res, ResourceDriverData &data
         SRVDesc.Texture2D.MostDetailedMip = mipOffset;
 
         auto name = getDebugName(res);
-        SL_LOG_VERBOSE("Caching texture 0x%llx(%S) node %u fmt %s size (%u,%u) mip %u mips %u sampler[%d]", resource, name.c_str(), node, getDXGIFormatStr(desc.Format), (UINT)desc.Width, (UINT)desc.Height, SRVDesc.Texture2D.MostDetailedMip, SRVDesc.Texture2D.MipLevels, sampler);
+        SL_LOG_VERBOSE("Caching texture 0x%llx(%S) node mask %u fmt %s size (%u,%u) mip %u mips %u sampler[%d]", resource, name.c_str(), nodeMask, getDXGIFormatStr(desc.Format), (UINT)desc.Width, (UINT)desc.Height, SRVDesc.Texture2D.MostDetailedMip, SRVDesc.Texture2D.MipLevels, sampler);
 
-        m_device->CreateShaderResourceView(resource, &SRVDesc, currentCPUHandle);
-
-        data.heap = m_heap;
+        // Descriptor index is shared by all nodes so the view has to exist in every heap that can see the resource
+        for (UINT node = 0; node < m_nodeCount; node++)
+        {
+            if ((nodeMask & (1 << node)) == 0) continue;
+            auto currentCPUHandle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_heap->descriptorHeap[node]->GetCPUDescriptorHandleForHeapStart(), data.descIndex, m_descriptorSize);
+            m_device->CreateShaderResourceView(resource, &SRVDesc, currentCPUHandle);
+        }
 
-        m_resourceData[resource][hash] = data;
-    }
-    else
-    {
-        data = (*it).second[hash];
+        m_descriptorCache.insert(resource, key, frame, data.descIndex, data.bZBCSupported);
     }
-    assert(data.heap == m_heap);
     return ComputeStatus::eOk;
 }
 
@@ -1853,15 +2776,24 @@ ComputeStatus D3D12::getSurfaceDriverData(Resource res, ResourceDriverData &data
 
     ID3D12Resource* resource = (ID3D12Resource*)(res->native);
 
-    std::scoped_lock lock(m_mutexResource);
+    // Lower bits set so a UAV never aliases an SRV of the same mip
+    uint32_t hash = (mipOffset << 16) | 0xffff;
+    auto key = DescriptorCache::makeKey(getDescriptorSerial(resource), hash);
+    uint32_t frame = m_finishedFrame;
 
-    uint32_t hash = mipOffset << 16;
+    // Lookup and touch must be atomic with respect to eviction, otherwise the slot
+    // could be handed to another resource between 'find' and 'touch'
+    std::scoped_lock lock(m_mutexResource);
 
-    auto it = m_resourceData.find(resource);
-    if (it == m_resourceData.end() || (*it).second.find(hash) == (*it).second.end())
+    data.heap = m_heap;
+    if (m_descriptorCache.find(resource, key, frame, data.descIndex, data.bZBCSupported))
+    {
+        m_descriptors.touch(data.descIndex, frame);
+    }
+    else
     {
-        auto node = 0; // FIX THIS
-        data.descIndex = getNewAndIncreaseDescIndex();
+        auto nodeMask = getResourceNodeMask(resource);
+        data.descIndex = getNewAndIncreaseDescIndex(resource, key);
 
         D3D12_RESOURCE_DESC desc = resource->GetDesc();
 
@@ -1877,7 +2809,7 @@ ComputeStatus D3D12::getSurfaceDriverData(Resource res, ResourceDriverData &data
             UAVDesc.Buffer.NumElements = (UINT)desc.Width / 4;
             UAVDesc.Buffer.StructureByteStride = 0;
 
-            SL_LOG_VERBOSE("Caching raw buffer 0x%llx(%S) node %u fmt %s size (%u,%u)", resource, name.c_str(), node, getDXGIFormatStr(desc.Format), (UINT)desc.Width, (UINT)desc.Height);
+            SL_LOG_VERBOSE("Caching raw buffer 0x%llx(%S) node mask %u fmt %s size (%u,%u)", resource, name.c_str(), nodeMask, getDXGIFormatStr(desc.Format), (UINT)desc.Width, (UINT)desc.Height);
         }
         else
         {
@@ -1888,13 +2820,16 @@ ComputeStatus D3D12::getSurfaceDriverData(Resource res, ResourceDriverData &data
             if (!isSupportedFormat(UAVDesc.Format, 0, D3D12_FORMAT_SUPPORT2_UAV_TYPED_LOAD | D3D12_FORMAT_SUPPORT2_UAV_TYPED_STORE))
             {
                 SL_LOG_ERROR( "Format %s cannot be used as UAV", getDXGIFormatStr(UAVDesc.Format));
+                m_descriptors.release(data.descIndex, frame);
                 return ComputeStatus::eError;
             }
 
-            SL_LOG_VERBOSE("Caching rwtexture 0x%llx(%S) node %u fmt %s size (%u,%u) mip %u", resource, name.c_str(), node, getDXGIFormatStr(desc.Format), (UINT)desc.Width, (UINT)desc.Height, UAVDesc.Texture2D.MipSlice);
+            SL_LOG_VERBOSE("Caching rwtexture 0x%llx(%S) node mask %u fmt %s size (%u,%u) mip %u", resource, name.c_str(), nodeMask, getDXGIFormatStr(desc.Format), (UINT)desc.Width, (UINT)desc.Height, UAVDesc.Texture2D.MipSlice);
         }
         
+        for (UINT node = 0; node < m_nodeCount; node++)
         {
+            if ((nodeMask & (1 << node)) == 0) continue;
             auto cpuVisibleCpuHandle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_heap->descriptorHeapCPU[node]->GetCPUDescriptorHandleForHeapStart(), data.descIndex, m_descriptorSize);
             m_device->CreateUnorderedAccessView(resource, nullptr, &UAVDesc, cpuVisibleCpuHandle);
 
@@ -1902,15 +2837,8 @@ ComputeStatus D3D12::getSurfaceDriverData(Resource res, ResourceDriverData &data
             m_device->CopyDescriptorsSimple(1, gpuVisibleCpuHandle, cpuVisibleCpuHandle, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
         }
 
-        data.heap = m_heap;
-
-        m_resourceData[resource][hash] = data;
-    }
-    else
-    {
-        data = (*it).second[hash];
+        m_descriptorCache.insert(resource, key, frame, data.descIndex, data.bZBCSupported);
     }
-    assert(data.heap == m_heap);
 
     return ComputeStatus::eOk;
 }
@@ -1985,7 +2913,8 @@ ComputeStatus D3D12::createTexture2DResourceSharedImpl(ResourceDescription &reso
     {
         initialState &= ~(ResourceState::eColorAttachmentRead | ResourceState::eColorAttachmentWrite);
     }
-    if (isSupportedFormat(texDesc.Format, D3D12_FORMAT_SUPPORT1_DEPTH_STENCIL, 0))
+    // Simultaneous access used for sharing rules out depth-stencil
+    if (!(resourceDesc.flags & ResourceFlags::eSharedResource) && isSupportedFormat(texDesc.Format, D3D12_FORMAT_SUPPORT1_DEPTH_STENCIL, 0))
     {
         texDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
     }
@@ -2009,9 +2938,17 @@ ComputeStatus D3D12::createTexture2DResourceSharedImpl(ResourceDescription &reso
         auto result = m_allocateCallback(&desc, m_device);
         res = (ID3D12Resource*)result.native;
     }
-    else
+    else if (NativeHeapType == D3D12_HEAP_TYPE_DEFAULT && !(texDesc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL | D3D12_RESOURCE_FLAG_ALLOW_SIMULTANEOUS_ACCESS)))
+    {
+        // Placed render targets and depth-stencils would need a discard before first use, those stay committed
+        HRESULT hr = S_OK;
+        res = m_placedHeaps.allocateFromBatch(texDesc, nativeInitialState, hr);
+    }
+    if (!res && !m_allocateCallback)
     {
-        auto hr = m_device->CreateCommittedResource(&heapProp, D3D12_HEAP_FLAG_NONE, &texDesc, nativeInitialState, nullptr, IID_PPV_ARGS(&res));
+        // Shared heaps are required for 'createSharedHandle'
+        auto heapFlags = (resourceDesc.flags & ResourceFlags::eSharedResource) ? D3D12_HEAP_FLAG_SHARED : D3D12_HEAP_FLAG_NONE;
+        auto hr = m_device->CreateCommittedResource(&heapProp, heapFlags, &texDesc, nativeInitialState, nullptr, IID_PPV_ARGS(&res));
         if (FAILED(hr))
         {
             SL_LOG_ERROR( "CreateCommittedResource failed %s", std::system_category().message(hr).c_str());
@@ -2024,6 +2961,7 @@ ComputeStatus D3D12::createTexture2DResourceSharedImpl(ResourceDescription &reso
         return ComputeStatus::eError;
     }
     
+    markOwnedTexture(res);
     outResource = new sl::Resource(ResourceType::eTex2d, res);
     outResource->state = nativeInitialState;
     return ComputeStatus::eOk;
@@ -2071,7 +3009,12 @@ ComputeStatus D3D12::createBufferResourceImpl(ResourceDescription &resourceDesc,
         auto result = m_allocateCallback(&desc, m_device);
         res = (ID3D12Resource*)result.native;
     }
-    else
+    else if (NativeHeapType == D3D12_HEAP_TYPE_DEFAULT)
+    {
+        HRESULT hr = S_OK;
+        res = m_placedHeaps.allocateFromBatch(bufferDesc, NativeInitialState, hr);
+    }
+    if (!res && !m_allocateCallback)
     {
         m_device->CreateCommittedResource(&heapProp, D3D12_HEAP_FLAG_NONE, &bufferDesc, NativeInitialState, nullptr, IID_PPV_ARGS(&res));
     }
@@ -2085,37 +3028,196 @@ ComputeStatus D3D12::createBufferResourceImpl(ResourceDescription &resourceDesc,
     return ComputeStatus::eOk;
 }
 
-ComputeStatus D3D12::setDebugName(Resource res, const char name[])
+ComputeStatus D3D12::createResources(ResourceBatchEntry* entries, uint32_t count)
 {
-    ID3D12Pageable *resource = (ID3D12Pageable*)(res->native);
-    resource->SetPrivateData(WKPDID_D3DDebugObjectName, (UINT)strlen(name), name);
-    return ComputeStatus::eOk;
+    // Host allocation callbacks and multi node setups keep their own placement
+    uint64_t bytes = 0;
+    if (m_heapTier2 && !m_allocateCallback && !m_releaseCallback && m_nodeCount == 1)
+    {
+        // Only resources 'allocateFromBatch' will take are counted, footprints are estimated and
+        // anything which ends up not fitting falls back to a committed resource
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto& desc = entries[i].desc;
+            if (desc.heapType != eHeapTypeDefault) continue;
+            uint64_t size = desc.width;
+            if (entries[i].type != ResourceType::eBuffer)
+            {
+                Format format = desc.format;
+                NativeFormat native = desc.nativeFormat;
+                if (format == eFormatINVALID) getFormat(native, format);
+                else getNativeFormat(format, native);
+                if ((desc.flags & ResourceFlags::eSharedResource) ||
+                    isSupportedFormat((DXGI_FORMAT)native, D3D12_FORMAT_SUPPORT1_RENDER_TARGET | D3D12_FORMAT_SUPPORT1_DEPTH_STENCIL, 0))
+                {
+                    continue;
+                }
+                size_t bytesPerPixel = 16;
+                getBytesPerPixel(format, bytesPerPixel);
+                size = (uint64_t)desc.width * desc.height * bytesPerPixel;
+                // Mip chain and tiled layout padding
+                size += desc.mips > 1 ? size / 2 : size / 8;
+            }
+            bytes += (size + D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1) & ~(uint64_t)(D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1);
+        }
+    }
+    const bool batch = bytes && m_placedHeaps.beginBatch(bytes);
+    auto status = Generic::createResources(entries, count);
+    if (batch)
+    {
+        m_placedHeaps.endBatch();
+    }
+    return status;
 }
 
-ComputeStatus D3D12::copyHostToDeviceBuffer(CommandList InCmdList, uint64_t InSize, const void *InData, Resource InUploadResource, Resource InTargetResource, unsigned long long InUploadOffset, unsigned long long InDstOffset)
+ComputeStatus D3D12::createAliasedResources(ResourceBatchEntry* entries, uint32_t count)
 {
-    UINT8 *StagingPtr = nullptr;
-
-    ID3D12Resource *Resource = (ID3D12Resource*)(InTargetResource->native);
-    ID3D12Resource *Scratch = (ID3D12Resource*)(InUploadResource->native);
-
-    //SL_LOG_INFO("Scratch size %llu", Scratch->GetDesc().Width * Scratch->GetDesc().Height);
-
-    HRESULT hr = Scratch->Map(0, NULL, reinterpret_cast<void**>(&StagingPtr));
-    if (hr != S_OK)
+    if (!m_heapTier2 || m_allocateCallback || m_releaseCallback || m_nodeCount != 1)
     {
-        SL_LOG_ERROR( " failed to map buffer - error %s", std::system_category().message(hr).c_str());
-        return ComputeStatus::eError;
+        return createResources(entries, count);
     }
 
-    memcpy(StagingPtr + InUploadOffset, InData, InSize);
-
-    Scratch->Unmap(0, nullptr);
-
-    ((ID3D12GraphicsCommandList*)InCmdList)->CopyBufferRegion(Resource, InDstOffset, Scratch, InUploadOffset, InSize);
-
-    return ComputeStatus::eOk;
-}
+    // Exact footprints of whatever 'allocateFromBatch' will take, same rules as the texture and buffer paths
+    struct Placement
+    {
+        uint32_t entry;
+        uint64_t size;
+        uint64_t alignment;
+        uint64_t offset;
+    };
+    std::vector<Placement> placements;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto& desc = entries[i].desc;
+        if (desc.heapType != eHeapTypeDefault) continue;
+        D3D12_RESOURCE_DESC nativeDesc{};
+        if (entries[i].type == ResourceType::eBuffer)
+        {
+            nativeDesc = CD3DX12_RESOURCE_DESC::Buffer(desc.width, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS);
+        }
+        else
+        {
+            Format format = desc.format;
+            NativeFormat native = desc.nativeFormat;
+            if (format == eFormatINVALID) getFormat(native, format);
+            else getNativeFormat(format, native);
+            if ((desc.flags & ResourceFlags::eSharedResource) ||
+                isSupportedFormat((DXGI_FORMAT)native, D3D12_FORMAT_SUPPORT1_RENDER_TARGET | D3D12_FORMAT_SUPPORT1_DEPTH_STENCIL, 0))
+            {
+                continue;
+            }
+            nativeDesc = CD3DX12_RESOURCE_DESC::Tex2D((DXGI_FORMAT)native, desc.width, desc.height, 1, (UINT16)desc.mips);
+            if (isSupportedFormat((DXGI_FORMAT)native, 0, D3D12_FORMAT_SUPPORT2_UAV_TYPED_LOAD | D3D12_FORMAT_SUPPORT2_UAV_TYPED_STORE))
+            {
+                nativeDesc.Flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+            }
+        }
+        auto info = m_device->GetResourceAllocationInfo(0, 1, &nativeDesc);
+        if (info.SizeInBytes == UINT64_MAX) continue;
+        placements.push_back({ i, info.SizeInBytes, info.Alignment, 0 });
+    }
+
+    // Largest first, each one goes to the lowest offset clear of everything placed so far with an overlapping lifetime
+    std::sort(placements.begin(), placements.end(), [](const Placement& a, const Placement& b)->bool { return a.size > b.size; });
+    auto overlaps = [entries](const Placement& a, const Placement& b)->bool
+    {
+        return entries[a.entry].firstUse <= entries[b.entry].lastUse && entries[b.entry].firstUse <= entries[a.entry].lastUse;
+    };
+    uint64_t heapBytes = 0;
+    uint64_t totalBytes = 0;
+    for (size_t i = 0; i < placements.size(); i++)
+    {
+        auto& p = placements[i];
+        std::vector<uint64_t> candidates = { 0 };
+        for (size_t j = 0; j < i; j++)
+        {
+            if (overlaps(p, placements[j]))
+            {
+                candidates.push_back((placements[j].offset + placements[j].size + p.alignment - 1) & ~(p.alignment - 1));
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+        for (auto candidate : candidates)
+        {
+            bool clear = true;
+            for (size_t j = 0; j < i && clear; j++)
+            {
+                auto& other = placements[j];
+                clear = !overlaps(p, other) || candidate >= other.offset + other.size || candidate + p.size <= other.offset;
+            }
+            if (clear)
+            {
+                p.offset = candidate;
+                break;
+            }
+        }
+        heapBytes = std::max(heapBytes, p.offset + p.size);
+        totalBytes += p.size;
+    }
+
+    std::vector<uint64_t> offsets(count, UINT64_MAX);
+    const bool batch = heapBytes && m_placedHeaps.beginBatch(heapBytes);
+    if (batch)
+    {
+        for (auto& p : placements) offsets[p.entry] = p.offset;
+    }
+    auto status = ComputeStatus::eOk;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        m_placedHeaps.placeNextAt(offsets[i]);
+        status = Generic::createResources(entries + i, 1);
+        if (status != ComputeStatus::eOk)
+        {
+            for (uint32_t j = 0; j < i; j++)
+            {
+                destroyResource(entries[j].resource, 0);
+                entries[j].resource = {};
+            }
+            break;
+        }
+    }
+    if (batch)
+    {
+        m_placedHeaps.endBatch();
+        if (status == ComputeStatus::eOk)
+        {
+            SL_LOG_VERBOSE("Aliased %llu resource(s) into %.1fMB, %.1fMB without aliasing", placements.size(), heapBytes / (1024.0 * 1024.0), totalBytes / (1024.0 * 1024.0));
+        }
+    }
+    return status;
+}
+
+ComputeStatus D3D12::setDebugName(Resource res, const char name[])
+{
+    ID3D12Pageable *resource = (ID3D12Pageable*)(res->native);
+    resource->SetPrivateData(WKPDID_D3DDebugObjectName, (UINT)strlen(name), name);
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::copyHostToDeviceBuffer(CommandList InCmdList, uint64_t InSize, const void *InData, Resource InUploadResource, Resource InTargetResource, unsigned long long InUploadOffset, unsigned long long InDstOffset)
+{
+    UINT8 *StagingPtr = nullptr;
+
+    ID3D12Resource *Resource = (ID3D12Resource*)(InTargetResource->native);
+    ID3D12Resource *Scratch = (ID3D12Resource*)(InUploadResource->native);
+
+    //SL_LOG_INFO("Scratch size %llu", Scratch->GetDesc().Width * Scratch->GetDesc().Height);
+
+    HRESULT hr = Scratch->Map(0, NULL, reinterpret_cast<void**>(&StagingPtr));
+    if (hr != S_OK)
+    {
+        SL_LOG_ERROR( " failed to map buffer - error %s", std::system_category().message(hr).c_str());
+        return ComputeStatus::eError;
+    }
+
+    memcpy(StagingPtr + InUploadOffset, InData, InSize);
+
+    Scratch->Unmap(0, nullptr);
+
+    ((ID3D12GraphicsCommandList*)InCmdList)->CopyBufferRegion(Resource, InDstOffset, Scratch, InUploadOffset, InSize);
+
+    return ComputeStatus::eOk;
+}
 
 ComputeStatus D3D12::copyHostToDeviceTexture(CommandList cmdList, uint64_t InSize, uint64_t RowPitch, const void* InData, Resource InTargetResource, Resource& InUploadResource)
 {
@@ -2160,6 +3262,62 @@ ComputeStatus D3D12::copyHostToDeviceTexture(CommandList cmdList, uint64_t InSiz
     return ComputeStatus::eOk;
 }
 
+ComputeStatus D3D12::uploadToTexture(CommandList cmdList, const void* data, uint64_t size, uint64_t rowPitch, Resource target)
+{
+    if (!cmdList || !data || !target)
+    {
+        return ComputeStatus::eInvalidArgument;
+    }
+
+    ID3D12Resource* dest = (ID3D12Resource*)(target->native);
+    D3D12_RESOURCE_DESC resourceDesc = dest->GetDesc();
+
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint = {};
+    uint32_t numRows;
+    uint64_t rowSizeInBytes;
+    uint64_t totalBytes;
+    m_device->GetCopyableFootprints(&resourceDesc, 0, 1, 0, &footprint, &numRows, &rowSizeInBytes, &totalBytes);
+    if (rowPitch < rowSizeInBytes || rowPitch * (numRows - 1) + rowSizeInBytes > size)
+    {
+        SL_LOG_ERROR("Upload of %llu bytes with row pitch %llu does not cover texture '%S'", size, rowPitch, getDebugName(target).c_str());
+        return ComputeStatus::eInvalidArgument;
+    }
+
+    Resource staging{};
+    uint64_t offset = 0;
+    CHI_CHECK(allocateUpload(totalBytes, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, staging, offset));
+
+    ID3D12Resource* uploadBuffer = (ID3D12Resource*)(staging->native);
+    uint8_t* cpuVA = nullptr;
+    D3D12_RANGE noRead = {};
+    if (FAILED(uploadBuffer->Map(0, &noRead, (void**)&cpuVA)))
+    {
+        return ComputeStatus::eError;
+    }
+    // Repack rows from the host pitch to the 256 byte aligned device pitch
+    for (uint32_t row = 0; row < numRows; row++)
+    {
+        memcpy(cpuVA + offset + footprint.Footprint.RowPitch * row, (const uint8_t*)data + rowPitch * row, rowSizeInBytes);
+    }
+    D3D12_RANGE written = { offset, offset + totalBytes };
+    uploadBuffer->Unmap(0, &written);
+
+    footprint.Offset = offset;
+
+    D3D12_TEXTURE_COPY_LOCATION destCopyLocation = {};
+    destCopyLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+    destCopyLocation.SubresourceIndex = 0;
+    destCopyLocation.pResource = dest;
+
+    D3D12_TEXTURE_COPY_LOCATION srcCopyLocation = {};
+    srcCopyLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+    srcCopyLocation.PlacedFootprint = footprint;
+    srcCopyLocation.pResource = uploadBuffer;
+
+    ((ID3D12GraphicsCommandList*)cmdList)->CopyTextureRegion(&destCopyLocation, 0, 0, 0, &srcCopyLocation, nullptr);
+    return ComputeStatus::eOk;
+}
+
 ComputeStatus D3D12::copyDeviceTextureToDeviceBuffer(CommandList cmdList, Resource srcTexture, Resource dstBuffer)
 {
     if (!cmdList || !srcTexture || !dstBuffer)
@@ -2192,7 +3350,8 @@ ComputeStatus D3D12::clearView(CommandList InCmdList, Resource resource, const f
     ResourceDriverData Data = {};
     if (getSurfaceDriverData(resource, Data) == ComputeStatus::eOk)
     {
-        auto node = 0; // FIX THIS
+        // Clears are recorded for the node the calling thread is working on
+        auto node = m_dispatchContext.getContext().node;
         CD3DX12_CPU_DESCRIPTOR_HANDLE CPUVisibleCPUHandle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_heap->descriptorHeapCPU[node]->GetCPUDescriptorHandleForHeapStart(), Data.descIndex, m_descriptorSize);
         CD3DX12_GPU_DESCRIPTOR_HANDLE GPUHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_heap->descriptorHeap[node]->GetGPUDescriptorHandleForHeapStart(), Data.descIndex, m_descriptorSize);
 
@@ -2204,17 +3363,194 @@ ComputeStatus D3D12::clearView(CommandList InCmdList, Resource resource, const f
     return ComputeStatus::eError;
 }
 
+namespace
+{
+//! Enhanced barrier equivalent of a legacy resource state
+struct EnhancedBarrierState
+{
+    D3D12_BARRIER_SYNC sync = D3D12_BARRIER_SYNC_NONE;
+    D3D12_BARRIER_ACCESS access = D3D12_BARRIER_ACCESS_COMMON;
+    D3D12_BARRIER_LAYOUT layout = D3D12_BARRIER_LAYOUT_COMMON;
+};
+
+//! Derived from the same 'toD3D12States' value tracked on the resource so layouts always match what was set last.
+//! Returns false for states without an exact equivalent, callers fall back to legacy barriers.
+bool toEnhancedBarrierState(D3D12_RESOURCE_STATES state, EnhancedBarrierState& out)
+{
+    out = {};
+    if (state == D3D12_RESOURCE_STATE_COMMON)
+    {
+        // Also covers eGeneral/ePresent, resources can be promoted from common so sync with everything
+        out.sync = D3D12_BARRIER_SYNC_ALL;
+        return true;
+    }
+
+    struct Mapping
+    {
+        D3D12_RESOURCE_STATES state;
+        D3D12_BARRIER_SYNC sync;
+        D3D12_BARRIER_ACCESS access;
+        D3D12_BARRIER_LAYOUT layout;
+    };
+    static const Mapping kMappings[] =
+    {
+        { D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER, D3D12_BARRIER_SYNC_ALL_SHADING, D3D12_BARRIER_ACCESS_VERTEX_BUFFER | D3D12_BARRIER_ACCESS_CONSTANT_BUFFER, D3D12_BARRIER_LAYOUT_GENERIC_READ },
+        { D3D12_RESOURCE_STATE_INDEX_BUFFER, D3D12_BARRIER_SYNC_INDEX_INPUT, D3D12_BARRIER_ACCESS_INDEX_BUFFER, D3D12_BARRIER_LAYOUT_GENERIC_READ },
+        { D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_BARRIER_SYNC_RENDER_TARGET, D3D12_BARRIER_ACCESS_RENDER_TARGET, D3D12_BARRIER_LAYOUT_RENDER_TARGET },
+        { D3D12_RESOURCE_STATE_UNORDERED_ACCESS, D3D12_BARRIER_SYNC_ALL_SHADING, D3D12_BARRIER_ACCESS_UNORDERED_ACCESS, D3D12_BARRIER_LAYOUT_UNORDERED_ACCESS },
+        { D3D12_RESOURCE_STATE_DEPTH_WRITE, D3D12_BARRIER_SYNC_DEPTH_STENCIL, D3D12_BARRIER_ACCESS_DEPTH_STENCIL_WRITE, D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_WRITE },
+        { D3D12_RESOURCE_STATE_DEPTH_READ, D3D12_BARRIER_SYNC_DEPTH_STENCIL, D3D12_BARRIER_ACCESS_DEPTH_STENCIL_READ, D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_READ },
+        { D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE, D3D12_BARRIER_SYNC_NON_PIXEL_SHADING, D3D12_BARRIER_ACCESS_SHADER_RESOURCE, D3D12_BARRIER_LAYOUT_SHADER_RESOURCE },
+        { D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_BARRIER_SYNC_PIXEL_SHADING, D3D12_BARRIER_ACCESS_SHADER_RESOURCE, D3D12_BARRIER_LAYOUT_SHADER_RESOURCE },
+        { D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT, D3D12_BARRIER_SYNC_EXECUTE_INDIRECT, D3D12_BARRIER_ACCESS_INDIRECT_ARGUMENT, D3D12_BARRIER_LAYOUT_GENERIC_READ },
+        { D3D12_RESOURCE_STATE_COPY_DEST, D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_DEST, D3D12_BARRIER_LAYOUT_COPY_DEST },
+        { D3D12_RESOURCE_STATE_COPY_SOURCE, D3D12_BARRIER_SYNC_COPY, D3D12_BARRIER_ACCESS_COPY_SOURCE, D3D12_BARRIER_LAYOUT_COPY_SOURCE },
+        { D3D12_RESOURCE_STATE_RESOLVE_DEST, D3D12_BARRIER_SYNC_RESOLVE, D3D12_BARRIER_ACCESS_RESOLVE_DEST, D3D12_BARRIER_LAYOUT_RESOLVE_DEST },
+        { D3D12_RESOURCE_STATE_RESOLVE_SOURCE, D3D12_BARRIER_SYNC_RESOLVE, D3D12_BARRIER_ACCESS_RESOLVE_SOURCE, D3D12_BARRIER_LAYOUT_RESOLVE_SOURCE },
+        { D3D12_RESOURCE_STATE_RAYTRACING_ACCELERATION_STRUCTURE, D3D12_BARRIER_SYNC_RAYTRACING | D3D12_BARRIER_SYNC_BUILD_RAYTRACING_ACCELERATION_STRUCTURE,
+          D3D12_BARRIER_ACCESS_RAYTRACING_ACCELERATION_STRUCTURE_READ | D3D12_BARRIER_ACCESS_RAYTRACING_ACCELERATION_STRUCTURE_WRITE, D3D12_BARRIER_LAYOUT_UNDEFINED },
+    };
+
+    uint32_t remaining = state;
+    uint32_t layouts = 0;
+    for (auto& mapping : kMappings)
+    {
+        if (state & mapping.state)
+        {
+            out.sync |= mapping.sync;
+            out.access |= mapping.access;
+            if (layouts++ == 0 || out.layout == mapping.layout)
+            {
+                out.layout = mapping.layout;
+            }
+            else if (out.layout == D3D12_BARRIER_LAYOUT_DEPTH_STENCIL_READ && mapping.layout == D3D12_BARRIER_LAYOUT_SHADER_RESOURCE)
+            {
+                // Depth read combined with shader reads stays a depth layout
+            }
+            else
+            {
+                // Combination of read states
+                out.layout = D3D12_BARRIER_LAYOUT_GENERIC_READ;
+            }
+            remaining &= ~mapping.state;
+        }
+    }
+    // Shading rate, video and predication states have no chi equivalent
+    return remaining == 0;
+}
+}
+
+bool D3D12::recordEnhancedTransitions(CommandList cmdList, const ResourceTransition* transitions, uint32_t count)
+{
+    ID3D12GraphicsCommandList7* cmdList7{};
+    if (!m_enhancedBarriers || FAILED(((ID3D12GraphicsCommandList*)cmdList)->QueryInterface(IID_PPV_ARGS(&cmdList7))))
+    {
+        return false;
+    }
+
+    std::vector<D3D12_TEXTURE_BARRIER> textureBarriers;
+    std::vector<D3D12_BUFFER_BARRIER> bufferBarriers;
+    std::vector<std::pair<uint32_t, D3D12_RESOURCE_STATES>> states;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (transitions[i].from == transitions[i].to) continue;
+        auto from = toD3D12States(transitions[i].from);
+        auto to = toD3D12States(transitions[i].to);
+        if (from == to) continue;
+
+        EnhancedBarrierState before, after;
+        if (!toEnhancedBarrierState(from, before) || !toEnhancedBarrierState(to, after))
+        {
+            cmdList7->Release();
+            return false;
+        }
+        auto resource = (ID3D12Resource*)(transitions[i].resource->native);
+        auto isBuffer = resource->GetDesc().Dimension == D3D12_RESOURCE_DIMENSION_BUFFER;
+        if (!isBuffer && !isOwnedTexture(resource))
+        {
+            // Host textures are in legacy states which do not map to a known layout, the whole list takes the legacy path
+            cmdList7->Release();
+            return false;
+        }
+        if (isBuffer)
+        {
+            bufferBarriers.push_back({ before.sync, after.sync, before.access, after.access, resource, 0, UINT64_MAX });
+        }
+        else
+        {
+            // With NumMipLevels zero the range is a single subresource index, D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES selects all of them
+            D3D12_BARRIER_SUBRESOURCE_RANGE range{ transitions[i].subresource, 0, 0, 0, 0, 0 };
+            textureBarriers.push_back({ before.sync, after.sync, before.access, after.access, before.layout, after.layout, resource, range });
+        }
+        states.push_back({ i, to });
+    }
+
+    D3D12_BARRIER_GROUP groups[2]{};
+    uint32_t groupCount = 0;
+    if (!textureBarriers.empty())
+    {
+        groups[groupCount].Type = D3D12_BARRIER_TYPE_TEXTURE;
+        groups[groupCount].NumBarriers = (UINT32)textureBarriers.size();
+        groups[groupCount++].pTextureBarriers = textureBarriers.data();
+    }
+    if (!bufferBarriers.empty())
+    {
+        groups[groupCount].Type = D3D12_BARRIER_TYPE_BUFFER;
+        groups[groupCount].NumBarriers = (UINT32)bufferBarriers.size();
+        groups[groupCount++].pBufferBarriers = bufferBarriers.data();
+    }
+    if (groupCount)
+    {
+        cmdList7->Barrier(groupCount, groups);
+    }
+    cmdList7->Release();
+
+    // Legacy state is still tracked, split barriers and the fallback path rely on it
+    for (auto& [i, to] : states)
+    {
+        transitions[i].resource->state = to;
+    }
+    if (m_perfStats) m_perfStats->add(extra::PerfCounter::eBarriers, states.size());
+    return true;
+}
+
 ComputeStatus D3D12::insertGPUBarrierList(CommandList InCmdList, const Resource* resources, uint32_t resourceCount, BarrierType barrierType)
 {
-    if (barrierType == BarrierType::eBarrierTypeUAV)
+    if (barrierType == BarrierType::eBarrierTypeUAV && m_enhancedBarriers && resourceCount)
+    {
+        // One global barrier orders all UAV work instead of a barrier per resource
+        ID3D12GraphicsCommandList7* cmdList7{};
+        if (SUCCEEDED(((ID3D12GraphicsCommandList*)InCmdList)->QueryInterface(IID_PPV_ARGS(&cmdList7))))
+        {
+            D3D12_GLOBAL_BARRIER barrier{ D3D12_BARRIER_SYNC_ALL, D3D12_BARRIER_SYNC_ALL, D3D12_BARRIER_ACCESS_UNORDERED_ACCESS, D3D12_BARRIER_ACCESS_UNORDERED_ACCESS };
+            D3D12_BARRIER_GROUP group{};
+            group.Type = D3D12_BARRIER_TYPE_GLOBAL;
+            group.NumBarriers = 1;
+            group.pGlobalBarriers = &barrier;
+            cmdList7->Barrier(1, &group);
+            cmdList7->Release();
+            if (m_perfStats) m_perfStats->add(extra::PerfCounter::eBarriers, 1);
+            return ComputeStatus::eOk;
+        }
+    }
+    if (barrierType == BarrierType::eBarrierTypeUAV || barrierType == BarrierType::eBarrierTypeAliasing)
     {
         std::vector< D3D12_RESOURCE_BARRIER> Barriers;
         for (uint32_t i = 0; i < resourceCount; i++)
         {
             const Resource& res = resources[i];
-            Barriers.push_back(CD3DX12_RESOURCE_BARRIER::UAV((ID3D12Resource*)(res->native)));
+            if (barrierType == BarrierType::eBarrierTypeAliasing)
+            {
+                // Any resource sharing the memory may have been used last
+                Barriers.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(nullptr, (ID3D12Resource*)(res->native)));
+            }
+            else
+            {
+                Barriers.push_back(CD3DX12_RESOURCE_BARRIER::UAV((ID3D12Resource*)(res->native)));
+            }
         }
         ((ID3D12GraphicsCommandList*)InCmdList)->ResourceBarrier((UINT)Barriers.size(), Barriers.data());
+        if (m_perfStats) m_perfStats->add(extra::PerfCounter::eBarriers, Barriers.size());
     }
     else
     {
@@ -2226,10 +3562,21 @@ ComputeStatus D3D12::insertGPUBarrierList(CommandList InCmdList, const Resource*
 
 ComputeStatus D3D12::insertGPUBarrier(CommandList InCmdList, Resource InResource, BarrierType InBarrierType)
 {
+    if (InBarrierType == BarrierType::eBarrierTypeUAV && m_enhancedBarriers)
+    {
+        return insertGPUBarrierList(InCmdList, &InResource, 1, InBarrierType);
+    }
     if (InBarrierType == BarrierType::eBarrierTypeUAV)
     {
         D3D12_RESOURCE_BARRIER UAV = CD3DX12_RESOURCE_BARRIER::UAV((ID3D12Resource*)(InResource->native));
         ((ID3D12GraphicsCommandList*)InCmdList)->ResourceBarrier(1, &UAV);
+        if (m_perfStats) m_perfStats->add(extra::PerfCounter::eBarriers, 1);
+    }
+    else if (InBarrierType == BarrierType::eBarrierTypeAliasing)
+    {
+        D3D12_RESOURCE_BARRIER aliasing = CD3DX12_RESOURCE_BARRIER::Aliasing(nullptr, (ID3D12Resource*)(InResource->native));
+        ((ID3D12GraphicsCommandList*)InCmdList)->ResourceBarrier(1, &aliasing);
+        if (m_perfStats) m_perfStats->add(extra::PerfCounter::eBarriers, 1);
     }
     else
     {
@@ -2245,6 +3592,10 @@ ComputeStatus D3D12::transitionResourceImpl(CommandList cmdList, const ResourceT
     {
         return ComputeStatus::eInvalidArgument;
     }
+    if (recordEnhancedTransitions(cmdList, transitions, count))
+    {
+        return ComputeStatus::eOk;
+    }
     std::vector<D3D12_RESOURCE_BARRIER> barriers;
     for (uint32_t i = 0; i < count; i++)
     {
@@ -2264,6 +3615,45 @@ ComputeStatus D3D12::transitionResourceImpl(CommandList cmdList, const ResourceT
         }
     }
     ((ID3D12GraphicsCommandList*)cmdList)->ResourceBarrier((uint32_t)barriers.size(), barriers.data());
+    if (m_perfStats) m_perfStats->add(extra::PerfCounter::eBarriers, barriers.size());
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::transitionResourceSplitImpl(CommandList cmdList, const ResourceTransition* transitions, const BarrierSplit* splits, uint32_t count)
+{
+    if (!cmdList || !transitions || !splits)
+    {
+        return ComputeStatus::eInvalidArgument;
+    }
+    std::vector<D3D12_RESOURCE_BARRIER> barriers;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto from = toD3D12States(transitions[i].from);
+        auto to = toD3D12States(transitions[i].to);
+        // Same mapping as above so begin and end are always skipped together
+        if (from == to) continue;
+
+        auto flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+        if (splits[i] == BarrierSplit::eBegin)
+        {
+            flags = D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+        }
+        else if (splits[i] == BarrierSplit::eEnd)
+        {
+            flags = D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+        }
+        // State only changes once the transition is complete
+        if (splits[i] != BarrierSplit::eBegin)
+        {
+            transitions[i].resource->state = to;
+        }
+        barriers.push_back({ CD3DX12_RESOURCE_BARRIER::Transition((ID3D12Resource*)(transitions[i].resource->native), from, to, transitions[i].subresource, flags) });
+    }
+    if (!barriers.empty())
+    {
+        ((ID3D12GraphicsCommandList*)cmdList)->ResourceBarrier((uint32_t)barriers.size(), barriers.data());
+        if (m_perfStats) m_perfStats->add(extra::PerfCounter::eBarriers, barriers.size());
+    }
     return ComputeStatus::eOk;
 }
 
@@ -2274,13 +3664,81 @@ ComputeStatus D3D12::copyResource(CommandList InCmdList, Resource InDstResource,
     return ComputeStatus::eOk;
 }
 
+ComputeStatus D3D12::copyResourceRegion(CommandList InCmdList, Resource InDstResource, Resource InSrcResource, const Extent& region)
+{
+    if (!InCmdList || !InDstResource || !InSrcResource) return ComputeStatus::eInvalidArgument;
+
+    auto src = (ID3D12Resource*)(InSrcResource->native);
+    auto dst = (ID3D12Resource*)(InDstResource->native);
+    auto desc = src->GetDesc();
+    // Source box must be null for depth-stencil and multisampled resources
+    bool fullCopy = !region || desc.Dimension != D3D12_RESOURCE_DIMENSION_TEXTURE2D || desc.MipLevels != 1 || desc.DepthOrArraySize != 1 ||
+        desc.SampleDesc.Count > 1 || (desc.Flags & D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL) ||
+        region.left + region.width > desc.Width || region.top + region.height > desc.Height ||
+        (region.left == 0 && region.top == 0 && region.width == desc.Width && region.height == desc.Height);
+    if (fullCopy)
+    {
+        return copyResource(InCmdList, InDstResource, InSrcResource);
+    }
+
+    // Render target and depth-stencil textures must be initialized by a clear, discard or full copy before a partial
+    // copy touches them. Outside of the region the clone holds nothing anyone reads, so discard it in the state the
+    // list type requires, if that is not possible fall back to the full copy.
+    auto cmdList = (ID3D12GraphicsCommandList*)InCmdList;
+    auto dstDesc = dst->GetDesc();
+    if (dstDesc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL))
+    {
+        D3D12_RESOURCE_STATES discardState{};
+        if (cmdList->GetType() == D3D12_COMMAND_LIST_TYPE_DIRECT && (dstDesc.Flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET))
+        {
+            discardState = D3D12_RESOURCE_STATE_RENDER_TARGET;
+        }
+        else if (cmdList->GetType() == D3D12_COMMAND_LIST_TYPE_COMPUTE && (dstDesc.Flags & D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS))
+        {
+            discardState = D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+        }
+        else
+        {
+            return copyResource(InCmdList, InDstResource, InSrcResource);
+        }
+        // Caller has the clone in copy destination state
+        auto toDiscard = CD3DX12_RESOURCE_BARRIER::Transition(dst, D3D12_RESOURCE_STATE_COPY_DEST, discardState);
+        auto toCopy = CD3DX12_RESOURCE_BARRIER::Transition(dst, discardState, D3D12_RESOURCE_STATE_COPY_DEST);
+        cmdList->ResourceBarrier(1, &toDiscard);
+        cmdList->DiscardResource(dst, nullptr);
+        cmdList->ResourceBarrier(1, &toCopy);
+    }
+
+    CD3DX12_TEXTURE_COPY_LOCATION dstLocation(dst, 0);
+    CD3DX12_TEXTURE_COPY_LOCATION srcLocation(src, 0);
+    D3D12_BOX box{ region.left, region.top, 0, region.left + region.width, region.top + region.height, 1 };
+    cmdList->CopyTextureRegion(&dstLocation, region.left, region.top, 0, &srcLocation, &box);
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::copyDepthToColor(CommandList InCmdList, Resource InDstResource, Resource InSrcResource)
+{
+    if (!InCmdList || !InDstResource || !InSrcResource) return ComputeStatus::eInvalidArgument;
+
+    // Depth is plane 0 of the first subresource, copying a plane into a compatible single plane format is allowed
+    CD3DX12_TEXTURE_COPY_LOCATION dstLocation((ID3D12Resource*)(InDstResource->native), 0);
+    CD3DX12_TEXTURE_COPY_LOCATION srcLocation((ID3D12Resource*)(InSrcResource->native), 0);
+    ((ID3D12GraphicsCommandList*)InCmdList)->CopyTextureRegion(&dstLocation, 0, 0, 0, &srcLocation, nullptr);
+    return ComputeStatus::eOk;
+}
+
 ComputeStatus D3D12::cloneResource(Resource resource, Resource &clone, const char friendlyName[], ResourceState initialState, uint32_t creationMask, uint32_t visibilityMask)
 {
     if (!resource || !resource->native) return ComputeStatus::eInvalidArgument;
 
     D3D12_RESOURCE_DESC desc1 = ((ID3D12Resource*)(resource->native))->GetDesc();
     ID3D12Resource *res = nullptr;
-        
+
+    if (!creationMask && m_nodeCount > 1)
+    {
+        // Create on the node this thread records for so the feature can use the clone without cross-node traffic
+        creationMask = 1 << m_dispatchContext.getContext().node;
+    }
     CD3DX12_HEAP_PROPERTIES heapProp(D3D12_HEAP_TYPE_DEFAULT, creationMask, visibilityMask ? visibilityMask : m_visibleNodeMask);
 
     if (isSupportedFormat(desc1.Format, 0, D3D12_FORMAT_SUPPORT2_UAV_TYPED_LOAD | D3D12_FORMAT_SUPPORT2_UAV_TYPED_STORE))    
@@ -2326,255 +3784,852 @@ ComputeStatus D3D12::cloneResource(Resource resource, Resource &clone, const cha
         auto result = m_allocateCallback(&desc, m_device);
         res = (ID3D12Resource*)result.native;
     }
-    else
+    else if (!m_releaseCallback && m_nodeCount == 1 && !creationMask && !visibilityMask && initialState == ResourceState::eCopyDestination)
+    {
+        // Single node clones which are about to be fully overwritten by a copy (tag clones) are sub-allocated
+        // from shared heaps, anything else or a heap failure falls back to a committed resource
+        HRESULT hr = S_OK;
+        res = m_placedHeaps.allocate(desc1, (D3D12_RESOURCE_STATES)nativeState, hr);
+    }
+
+    if (!res && !m_allocateCallback)
+    {
+        HRESULT hr = m_device->CreateCommittedResource(
+            &heapProp,
+            D3D12_HEAP_FLAG_NONE,
+            &desc1,
+            (D3D12_RESOURCE_STATES)nativeState,
+            nullptr,
+            IID_PPV_ARGS(&res));
+
+        if (FAILED(hr))
+        {
+            SL_LOG_ERROR( "Unable to clone resource (%s:%u:%u:%s) - %s", friendlyName, desc1.Width, desc1.Height, getDXGIFormatStr(desc1.Format), std::system_category().message(hr).c_str());
+            return ComputeStatus::eError;
+        }
+    }
+
+    if (!res)
+    {
+        SL_LOG_ERROR("Unable to clone resource (%s:%u:%u:%s)", friendlyName, desc1.Width, desc1.Height, getDXGIFormatStr(desc1.Format));
+        return ComputeStatus::eError;
+    }
+
+    if (type == ResourceType::eTex2d) markOwnedTexture(res);
+    clone = new sl::Resource(type, res, nativeState);
+    clone->flags = desc1.Flags;
+    clone->mipLevels = desc1.MipLevels;
+    clone->arrayLayers = desc1.DepthOrArraySize;
+    clone->nativeFormat = desc1.Format;
+    clone->width = (uint32_t)desc1.Width;
+    clone->height = desc1.Height;
+
+    setDebugName(clone, friendlyName);
+
+    manageVRAM(clone, VRAMOperation::eAlloc);
+    
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::copyBufferToReadbackBuffer(CommandList InCmdList, Resource InResource, Resource OutResource, uint32_t InBytesToCopy) 
+{
+    ID3D12Resource *InD3dResource = (ID3D12Resource*)(InResource->native);
+    ID3D12Resource *OutD3dResource = (ID3D12Resource*)(OutResource->native);
+    ID3D12GraphicsCommandList* CmdList = (ID3D12GraphicsCommandList*)InCmdList;
+
+#if 0
+    ResourceDescription ResourceDesc;
+    GetResourceDescription(OutResource, ResourceDesc);
+    const size_t readbackBufferSize = ResourceDesc.Width;
+
+    D3D12_RANGE readbackBufferRange{ 0, readbackBufferSize };
+    FLOAT * pReadbackBufferData{};
+    OutD3dResource->Map(0, &readbackBufferRange, reinterpret_cast<void**>(&pReadbackBufferData));
+
+    memset(pReadbackBufferData, 0xAA, readbackBufferSize);
+
+    D3D12_RANGE emptyRange{ 0, 0 };
+    OutD3dResource->Unmap(0, &emptyRange);
+#endif
+
+    CmdList->CopyBufferRegion(OutD3dResource, 0, InD3dResource, 0, InBytesToCopy);
+
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::mapResource(CommandList cmdList, Resource resource, void*& data, uint32_t subResource, uint64_t offset, uint64_t totalBytes)
+{
+    auto src = (ID3D12Resource*)(resource->native);
+    if (!src) return ComputeStatus::eInvalidPointer;
+
+    void* mapped{};
+    D3D12_RANGE range = { offset, offset + totalBytes };
+    if (FAILED(src->Map(subResource, &range, &mapped)))
+    {
+        SL_LOG_ERROR( "Failed to map buffer");
+        return ComputeStatus::eError;
+    }
+    data = mapped;
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::unmapResource(CommandList cmdList, Resource resource, uint32_t subResource)
+{
+    auto src = (ID3D12Resource*)(resource->native);
+    if (!src) return ComputeStatus::eInvalidPointer;
+
+    src->Unmap(0, nullptr);
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::getLUIDFromDevice(NVSDK_NGX_LUID *OutId)
+{
+    auto id = m_device->GetAdapterLuid();
+    memcpy(OutId, &id, sizeof(LUID));
+    return ComputeStatus::eOk;
+}
+
+uint32_t D3D12::getPerfSectionId(const char* key)
+{
+    auto it = m_perfSectionIds.find(key);
+    if (it != m_perfSectionIds.end())
+    {
+        return (*it).second;
+    }
+    auto id = (uint32_t)m_perfSectionIds.size();
+    m_perfSectionIds[key] = id;
+    return id;
+}
+
+ComputeStatus D3D12::initTimestampPool(TimestampPool& pool, uint32_t node)
+{
+    D3D12_QUERY_HEAP_DESC queryHeapDesc = {};
+    queryHeapDesc.Count = kTimestampsPerSlice * SL_READBACK_QUEUE_SIZE;
+    queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+    queryHeapDesc.NodeMask = (1 << node);
+    if (FAILED(m_device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&pool.heap))))
+    {
+        SL_LOG_ERROR( "Failed to create timestamp query heap");
+        return ComputeStatus::eError;
+    }
+    pool.heap->SetName(L"sl.chi.timestamps");
+
+    // One extra entry per slice for the marker written once its resolve has completed on the GPU
+    auto bufferSize = (queryHeapDesc.Count + SL_READBACK_QUEUE_SIZE) * sizeof(uint64_t);
+    auto bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(bufferSize);
+    auto heapProp = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_READBACK, queryHeapDesc.NodeMask, queryHeapDesc.NodeMask);
+    if (FAILED(m_device->CreateCommittedResource(&heapProp, D3D12_HEAP_FLAG_NONE, &bufferDesc, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, IID_PPV_ARGS(&pool.readback))))
+    {
+        SL_LOG_ERROR( "Failed to create timestamp readback buffer");
+        SL_SAFE_RELEASE(pool.heap);
+        return ComputeStatus::eError;
+    }
+    //! Map in advance to increase performance, no need to map/unmap every frame
+    D3D12_RANGE mapRange = { 0, bufferSize };
+    pool.readback->Map(0, &mapRange, (void**)&pool.timestamps);
+    return ComputeStatus::eOk;
+}
+
+void D3D12::advanceTimestampPool(TimestampPool& pool, ID3D12GraphicsCommandList* cmdList)
+{
+    uint32_t frame = m_finishedFrame;
+    if (pool.frame == frame) return;
+    pool.frame = frame;
+
+    // Everything from the previous frame is resolved in one go, we only split on gaps
+    // since resolving timestamps which were never written is not allowed
+    auto resolveRun = [&pool, cmdList](uint32_t first, uint32_t last)->void
+    {
+        auto base = pool.slice * kTimestampsPerSlice;
+        cmdList->ResolveQueryData(pool.heap, D3D12_QUERY_TYPE_TIMESTAMP, base + first * 2, (last - first) * 2, pool.readback, (base + first * 2) * sizeof(uint64_t));
+    };
+    if (pool.pendingResolve)
+    {
+        uint32_t first = UINT_MAX;
+        for (uint32_t id = 0; id < (uint32_t)pool.sections.size(); id++)
+        {
+            bool active = pool.sections[id].active[pool.slice];
+            if (active && first == UINT_MAX)
+            {
+                first = id;
+            }
+            else if (!active && first != UINT_MAX)
+            {
+                resolveRun(first, id);
+                first = UINT_MAX;
+            }
+        }
+        if (first != UINT_MAX)
+        {
+            resolveRun(first, (uint32_t)pool.sections.size());
+        }
+        pool.pendingResolve = false;
+
+        // Command list is not ours so there is no fence to signal, marker write waits for the resolve to complete instead
+        pool.sliceSerial[pool.slice] = 0;
+        ID3D12GraphicsCommandList2* cmdList2{};
+        if (SUCCEEDED(cmdList->QueryInterface(IID_PPV_ARGS(&cmdList2))))
+        {
+            pool.resolveSerial = std::max(pool.resolveSerial + 1, 1u);
+            pool.sliceSerial[pool.slice] = pool.resolveSerial;
+            D3D12_WRITEBUFFERIMMEDIATE_PARAMETER param{};
+            param.Dest = pool.readback->GetGPUVirtualAddress() + (kTimestampsPerSlice * SL_READBACK_QUEUE_SIZE + pool.slice) * sizeof(uint64_t);
+            param.Value = pool.resolveSerial;
+            D3D12_WRITEBUFFERIMMEDIATE_MODE mode = D3D12_WRITEBUFFERIMMEDIATE_MODE_MARKER_OUT;
+            cmdList2->WriteBufferImmediate(1, &param, &mode);
+            cmdList2->Release();
+        }
+    }
+
+    // Slice we are about to reuse was resolved SL_READBACK_QUEUE_SIZE - 1 frames ago, results are only
+    // read if the GPU got past the resolve, otherwise whatever is in the buffer belongs to an older frame
+    pool.slice = (pool.slice + 1) % SL_READBACK_QUEUE_SIZE;
+    auto timestamps = pool.timestamps + pool.slice * kTimestampsPerSlice;
+    auto marker = (const volatile uint32_t*)(pool.timestamps + kTimestampsPerSlice * SL_READBACK_QUEUE_SIZE + pool.slice);
+    bool ready = !pool.sliceSerial[pool.slice] || *marker == pool.sliceSerial[pool.slice];
+    for (uint32_t id = 0; id < (uint32_t)pool.sections.size(); id++)
+    {
+        auto& data = pool.sections[id];
+        if (!data.active[pool.slice]) continue;
+        data.active[pool.slice] = false;
+        if (data.reset[pool.slice] || !ready)
+        {
+            data.reset[pool.slice] = false;
+            continue;
+        }
+        double delta = (timestamps[id * 2 + 1] - timestamps[id * 2]) / 1e06;
+        if (delta > 0)
+        {
+            data.meter.add(delta);
+            countGPUPass(delta);
+        }
+    }
+}
+
+ComputeStatus D3D12::beginPerfSection(CommandList cmdList, const char *key, uint32_t node, bool reset)
+{
+    std::scoped_lock lock(m_mutexProfiler);
+
+    auto id = getPerfSectionId(key);
+    if (id >= kMaxPerfSections)
+    {
+        SL_LOG_ERROR_ONCE("Too many perf sections, '%s' will not be timed", key);
+        return ComputeStatus::eError;
+    }
+
+    auto& pool = m_timestampPool[node];
+    if (!pool.heap)
+    {
+        CHI_CHECK(initTimestampPool(pool, node));
+    }
+    advanceTimestampPool(pool, (ID3D12GraphicsCommandList*)cmdList);
+
+    if (id >= (uint32_t)pool.sections.size())
+    {
+        pool.sections.resize(id + 1);
+    }
+    auto& data = pool.sections[id];
+    if (reset)
+    {
+        // Anything still in flight was recorded before the reset so skip it
+        for (int i = 0; i < SL_READBACK_QUEUE_SIZE; i++)
+        {
+            data.reset[i] = data.active[i];
+        }
+        data.meter.reset();
+    }
+
+    data.slice = pool.slice;
+    data.active[data.slice] = true;
+    pool.pendingResolve = true;
+    ((ID3D12GraphicsCommandList*)cmdList)->EndQuery(pool.heap, D3D12_QUERY_TYPE_TIMESTAMP, data.slice * kTimestampsPerSlice + id * 2);
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::endPerfSection(CommandList cmdList, const char* key, float &avgTimeMS, uint32_t node)
+{
+    std::scoped_lock lock(m_mutexProfiler);
+
+    auto it = m_perfSectionIds.find(key);
+    auto& pool = m_timestampPool[node];
+    if (it == m_perfSectionIds.end() || (*it).second >= (uint32_t)pool.sections.size())
+    {
+        return ComputeStatus::eError;
+    }
+    auto id = (*it).second;
+    auto& data = pool.sections[id];
+    ((ID3D12GraphicsCommandList*)cmdList)->EndQuery(pool.heap, D3D12_QUERY_TYPE_TIMESTAMP, data.slice * kTimestampsPerSlice + id * 2 + 1);
+
+    avgTimeMS = (float)data.meter.getMean();
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::getPerfSectionStats(const char* key, PerfSectionStats& stats, uint32_t node)
+{
+    std::scoped_lock lock(m_mutexProfiler);
+
+    auto it = m_perfSectionIds.find(key);
+    auto& pool = m_timestampPool[node];
+    if (it == m_perfSectionIds.end() || (*it).second >= (uint32_t)pool.sections.size())
+    {
+        return ComputeStatus::eError;
+    }
+    auto& meter = pool.sections[(*it).second].meter;
+    stats.lastMS = (float)meter.getValue();
+    stats.meanMS = (float)meter.getMean();
+    stats.p99MS = (float)meter.getPercentile(99.0);
+    stats.numSamples = meter.getNumSamples();
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::getPerfSectionNames(std::vector<std::string>& names, uint32_t node)
+{
+    std::scoped_lock lock(m_mutexProfiler);
+
+    // Ids are shared by all nodes, only report sections which have timestamps on the requested one
+    auto& pool = m_timestampPool[node];
+    names.clear();
+    for (auto& [name, id] : m_perfSectionIds)
+    {
+        if (id < (uint32_t)pool.sections.size())
+        {
+            names.push_back(name);
+        }
+    }
+    return ComputeStatus::eOk;
+}
+
+
+#if !SL_ENABLE_PROFILING
+// Metadata PIX uses for plain ANSI strings, PIX and Nsight decode these without the PIX event runtime
+constexpr UINT kPIXEventAnsiVersion = 1;
+#endif
+
+ComputeStatus D3D12::beginProfiling(CommandList cmdList, uint32_t metadata, const char* marker)
+{
+#if SL_ENABLE_PROFILING
+    PIXBeginEvent(((ID3D12GraphicsCommandList*)cmdList), metadata, marker);
+#else
+    ((ID3D12GraphicsCommandList*)cmdList)->BeginEvent(kPIXEventAnsiVersion, marker, (UINT)strlen(marker) + 1);
+#endif    
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::endProfiling(CommandList cmdList)
+{
+#if SL_ENABLE_PROFILING
+    PIXEndEvent(((ID3D12GraphicsCommandList*)cmdList));
+#else
+    ((ID3D12GraphicsCommandList*)cmdList)->EndEvent();
+#endif
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::beginProfilingQueue(CommandQueue cmdQueue, uint32_t metadata, const char* marker)
+{
+#if SL_ENABLE_PROFILING
+    PIXBeginEvent(((ID3D12CommandQueue*)cmdQueue), metadata, marker);
+#else
+    ((ID3D12CommandQueue*)cmdQueue)->BeginEvent(kPIXEventAnsiVersion, marker, (UINT)strlen(marker) + 1);
+#endif    
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::endProfilingQueue(CommandQueue cmdQueue)
+{
+#if SL_ENABLE_PROFILING
+    PIXEndEvent(((ID3D12CommandQueue*)cmdQueue));
+#else
+    ((ID3D12CommandQueue*)cmdQueue)->EndEvent();
+#endif
+    return ComputeStatus::eOk;
+}
+
+bool D3D12::signalCPUFence(Fence fence, uint64_t syncValue)
+{
+    auto d3d12Fence = ((ID3D12Fence*)fence);
+    if (FAILED(d3d12Fence->Signal(syncValue)))
+    {
+        SL_LOG_ERROR("Failed to signal fence from CPU");
+        return false;
+    }
+    return true;
+}
+
+int D3D12::destroyResourceDeferredImpl(const Resource resource)
+{   
+    if (resource->type == ResourceType::eTex2d || resource->type == ResourceType::eBuffer)
+    {
+        ULONG refCount = 0;
+        if (m_placedHeaps.release((ID3D12Resource*)resource->native, refCount))
+        {
+            return (int)refCount;
+        }
+    }
+    auto unknown = (IUnknown*)(resource->native);
+    return unknown->Release();
+}
+
+void PlacedHeapAllocator::shutdown()
+{
+    std::scoped_lock lock(m_mtx);
+    if (!m_blocks.empty())
+    {
+        SL_LOG_WARN("%llu placed resource(s) still alive on shutdown", (uint64_t)m_blocks.size());
+    }
+    m_blocks.clear();
+    for (auto& heap : m_batchHeaps)
+    {
+        SL_SAFE_RELEASE(heap->heap);
+    }
+    m_batchHeaps.clear();
+    m_batch = {};
+    for (auto& category : m_heaps)
+    {
+        for (auto& heaps : category)
+        {
+            for (auto& heap : heaps)
+            {
+                SL_SAFE_RELEASE(heap->heap);
+            }
+            heaps.clear();
+        }
+    }
+    m_heapBytes = 0;
+}
+
+ID3D12Resource* PlacedHeapAllocator::allocate(const D3D12_RESOURCE_DESC& desc, D3D12_RESOURCE_STATES state, HRESULT& hr)
+{
+    hr = S_OK;
+    if (!m_device) return nullptr;
+
+    // MSAA needs 4MB alignment and is rare enough for clones that committed resources are fine
+    auto info = m_device->GetResourceAllocationInfo(0, 1, &desc);
+    if (info.SizeInBytes == UINT64_MAX || info.Alignment > kMinBlockSize) return nullptr;
+
+    uint32_t sizeClass = 0;
+    uint64_t blockSize = kMinBlockSize;
+    while (blockSize < info.SizeInBytes && sizeClass < kClassCount)
+    {
+        blockSize <<= 1;
+        sizeClass++;
+    }
+    if (sizeClass == kClassCount) return nullptr;
+
+    HeapCategory category = HeapCategory::eTexture;
+    D3D12_HEAP_FLAGS heapFlags = D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+    if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER)
+    {
+        category = HeapCategory::eBuffer;
+        heapFlags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+    }
+    else if (desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL))
+    {
+        category = HeapCategory::eRTDSTexture;
+        heapFlags = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+    }
+
+    std::scoped_lock lock(m_mtx);
+
+    auto& heaps = getHeaps(category, sizeClass);
+    Heap* heap = {};
+    bool createdHeap = false;
+    for (auto& h : heaps)
+    {
+        if (!h->freeBlocks.empty())
+        {
+            heap = h.get();
+            break;
+        }
+    }
+    if (!heap)
     {
-        auto heapProp = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT, creationMask, visibilityMask);
-        HRESULT hr = m_device->CreateCommittedResource(
-            &heapProp,
-            D3D12_HEAP_FLAG_NONE,
-            &desc1,
-            (D3D12_RESOURCE_STATES)nativeState,
-            nullptr,
-            IID_PPV_ARGS(&res));
+        auto heapSize = std::max(kHeapSize, blockSize);
+        D3D12_HEAP_DESC heapDesc = {};
+        heapDesc.SizeInBytes = heapSize;
+        heapDesc.Properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+        heapDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+        heapDesc.Flags = heapFlags;
 
+        auto newHeap = std::make_unique<Heap>();
+        hr = m_device->CreateHeap(&heapDesc, IID_PPV_ARGS(&newHeap->heap));
         if (FAILED(hr))
         {
-            SL_LOG_ERROR( "Unable to clone resource (%s:%u:%u:%s) - %s", friendlyName, desc1.Width, desc1.Height, getDXGIFormatStr(desc1.Format), std::system_category().message(hr).c_str());
-            return ComputeStatus::eError;
+            SL_LOG_WARN("CreateHeap failed for %.1fMB - %s", heapSize / (1024.0 * 1024.0), std::system_category().message(hr).c_str());
+            return nullptr;
+        }
+        newHeap->blockCount = (uint32_t)(heapSize / blockSize);
+        newHeap->freeBlocks.resize(newHeap->blockCount);
+        for (uint32_t i = 0; i < newHeap->blockCount; i++)
+        {
+            // Hand out low offsets first
+            newHeap->freeBlocks[i] = newHeap->blockCount - 1 - i;
+        }
+        m_heapBytes += heapSize;
+        SL_LOG_VERBOSE("Created placed heap %.1fMB for %.1fKB blocks (category %u) - total %.1fMB", heapSize / (1024.0 * 1024.0), blockSize / 1024.0, (uint32_t)category, m_heapBytes / (1024.0 * 1024.0));
+        heap = newHeap.get();
+        heaps.push_back(std::move(newHeap));
+        createdHeap = true;
+    }
+
+    auto index = heap->freeBlocks.back();
+    ID3D12Resource* res = {};
+    // NOTE: Only used for clones which are fully overwritten by a copy before they are read so
+    // memory previously used by another clone does not need an explicit discard.
+    hr = m_device->CreatePlacedResource(heap->heap, index * blockSize, &desc, state, nullptr, IID_PPV_ARGS(&res));
+    if (FAILED(hr))
+    {
+        SL_LOG_WARN("CreatePlacedResource failed - %s", std::system_category().message(hr).c_str());
+        if (createdHeap)
+        {
+            // Heap was created for this resource only, nothing else lives in it and release would never free it
+            m_heapBytes -= heap->heap->GetDesc().SizeInBytes;
+            SL_SAFE_RELEASE(heap->heap);
+            heaps.pop_back();
         }
+        return nullptr;
     }
+    heap->freeBlocks.pop_back();
+    heap->usedCount++;
+    m_blocks[res] = { heap, index, sizeClass, category };
+    return res;
+}
 
-    if (!res)
+bool PlacedHeapAllocator::release(ID3D12Resource* resource, ULONG& refCount)
+{
+    std::scoped_lock lock(m_mtx);
+    auto it = m_blocks.find(resource);
+    if (it == m_blocks.end()) return false;
+
+    auto block = it->second;
+    m_blocks.erase(it);
+    refCount = resource->Release();
+    if (refCount != 0)
     {
-        SL_LOG_ERROR("Unable to clone resource (%s:%u:%u:%s)", friendlyName, desc1.Width, desc1.Height, getDXGIFormatStr(desc1.Format));
-        return ComputeStatus::eError;
+        // Someone else still holds the resource so its memory cannot be reused, leak the block instead
+        SL_LOG_WARN("Placed resource 0x%llx still has %u reference(s), block will not be reused", resource, refCount);
+        return true;
     }
 
-    clone = new sl::Resource(type, res, nativeState);
-    clone->flags = desc1.Flags;
-    clone->mipLevels = desc1.MipLevels;
-    clone->arrayLayers = desc1.DepthOrArraySize;
-    clone->nativeFormat = desc1.Format;
-    clone->width = (uint32_t)desc1.Width;
-    clone->height = desc1.Height;
-
-    setDebugName(clone, friendlyName);
-
-    manageVRAM(clone, VRAMOperation::eAlloc);
-    
-    return ComputeStatus::eOk;
+    auto heap = block.heap;
+    if (block.sizeClass == kClassCount)
+    {
+        // Batch heaps are never refilled, the last resource takes the heap with it
+        heap->usedCount--;
+        if (heap->usedCount == 0 && heap != m_batch)
+        {
+            m_heapBytes -= heap->heap->GetDesc().SizeInBytes;
+            SL_SAFE_RELEASE(heap->heap);
+            m_batchHeaps.erase(std::find_if(m_batchHeaps.begin(), m_batchHeaps.end(), [heap](const std::unique_ptr<Heap>& h)->bool { return h.get() == heap; }));
+        }
+        return true;
+    }
+    heap->freeBlocks.push_back(block.index);
+    heap->usedCount--;
+    if (heap->usedCount == 0)
+    {
+        // Keep one empty heap per size class around to avoid thrashing, release any others
+        auto& heaps = getHeaps(block.category, block.sizeClass);
+        auto emptyCount = std::count_if(heaps.begin(), heaps.end(), [](const std::unique_ptr<Heap>& h)->bool { return h->usedCount == 0; });
+        if (emptyCount > 1)
+        {
+            auto desc = heap->heap->GetDesc();
+            m_heapBytes -= desc.SizeInBytes;
+            SL_SAFE_RELEASE(heap->heap);
+            heaps.erase(std::find_if(heaps.begin(), heaps.end(), [heap](const std::unique_ptr<Heap>& h)->bool { return h.get() == heap; }));
+        }
+    }
+    return true;
 }
 
-ComputeStatus D3D12::copyBufferToReadbackBuffer(CommandList InCmdList, Resource InResource, Resource OutResource, uint32_t InBytesToCopy) 
+bool PlacedHeapAllocator::beginBatch(uint64_t bytes)
 {
-    ID3D12Resource *InD3dResource = (ID3D12Resource*)(InResource->native);
-    ID3D12Resource *OutD3dResource = (ID3D12Resource*)(OutResource->native);
-    ID3D12GraphicsCommandList* CmdList = (ID3D12GraphicsCommandList*)InCmdList;
-
-#if 0
-    ResourceDescription ResourceDesc;
-    GetResourceDescription(OutResource, ResourceDesc);
-    const size_t readbackBufferSize = ResourceDesc.Width;
-
-    D3D12_RANGE readbackBufferRange{ 0, readbackBufferSize };
-    FLOAT * pReadbackBufferData{};
-    OutD3dResource->Map(0, &readbackBufferRange, reinterpret_cast<void**>(&pReadbackBufferData));
-
-    memset(pReadbackBufferData, 0xAA, readbackBufferSize);
+    if (!m_device || !bytes) return false;
 
-    D3D12_RANGE emptyRange{ 0, 0 };
-    OutD3dResource->Unmap(0, &emptyRange);
-#endif
+    std::scoped_lock lock(m_mtx);
+    if (m_batch) return false;
 
-    CmdList->CopyBufferRegion(OutD3dResource, 0, InD3dResource, 0, InBytesToCopy);
+    D3D12_HEAP_DESC heapDesc = {};
+    heapDesc.SizeInBytes = (bytes + kMinBlockSize - 1) & ~(kMinBlockSize - 1);
+    heapDesc.Properties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
+    heapDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+    heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES;
 
-    return ComputeStatus::eOk;
+    auto heap = std::make_unique<Heap>();
+    auto hr = m_device->CreateHeap(&heapDesc, IID_PPV_ARGS(&heap->heap));
+    if (FAILED(hr))
+    {
+        SL_LOG_WARN("CreateHeap failed for %.1fMB batch - %s", heapDesc.SizeInBytes / (1024.0 * 1024.0), std::system_category().message(hr).c_str());
+        return false;
+    }
+    m_heapBytes += heapDesc.SizeInBytes;
+    m_batch = heap.get();
+    m_batchThread = std::this_thread::get_id();
+    m_batchHeaps.push_back(std::move(heap));
+    return true;
 }
 
-ComputeStatus D3D12::mapResource(CommandList cmdList, Resource resource, void*& data, uint32_t subResource, uint64_t offset, uint64_t totalBytes)
+ID3D12Resource* PlacedHeapAllocator::allocateFromBatch(const D3D12_RESOURCE_DESC& desc, D3D12_RESOURCE_STATES state, HRESULT& hr)
 {
-    auto src = (ID3D12Resource*)(resource->native);
-    if (!src) return ComputeStatus::eInvalidPointer;
+    hr = S_OK;
+    std::scoped_lock lock(m_mtx);
+    if (!m_batch || m_batchThread != std::this_thread::get_id()) return nullptr;
+    auto base = m_batchPlacement != UINT64_MAX ? m_batchPlacement : m_batch->offset;
+    m_batchPlacement = UINT64_MAX;
+
+    auto info = m_device->GetResourceAllocationInfo(0, 1, &desc);
+    if (info.SizeInBytes == UINT64_MAX) return nullptr;
+    auto offset = (base + info.Alignment - 1) & ~(info.Alignment - 1);
+    if (offset + info.SizeInBytes > m_batch->heap->GetDesc().SizeInBytes) return nullptr;
+
+    // Fresh heap memory is zeroed and never reused by another batch, aliased placements are not zeroed but
+    // render targets and depth-stencils never get here so no discard is needed either way
+    ID3D12Resource* res = {};
+    hr = m_device->CreatePlacedResource(m_batch->heap, offset, &desc, state, nullptr, IID_PPV_ARGS(&res));
+    if (FAILED(hr))
+    {
+        SL_LOG_WARN("CreatePlacedResource failed - %s", std::system_category().message(hr).c_str());
+        return nullptr;
+    }
+    m_batch->offset = std::max(m_batch->offset, offset + info.SizeInBytes);
+    m_batch->usedCount++;
+    m_blocks[res] = { m_batch, 0, kClassCount, HeapCategory::eCount };
+    return res;
+}
 
-    void* mapped{};
-    D3D12_RANGE range = { offset, offset + totalBytes };
-    if (FAILED(src->Map(subResource, &range, &mapped)))
+void PlacedHeapAllocator::placeNextAt(uint64_t offset)
+{
+    std::scoped_lock lock(m_mtx);
+    if (m_batch && m_batchThread == std::this_thread::get_id())
     {
-        SL_LOG_ERROR( "Failed to map buffer");
-        return ComputeStatus::eError;
+        m_batchPlacement = offset;
     }
-    data = mapped;
-    return ComputeStatus::eOk;
 }
 
-ComputeStatus D3D12::unmapResource(CommandList cmdList, Resource resource, uint32_t subResource)
+void PlacedHeapAllocator::endBatch()
 {
-    auto src = (ID3D12Resource*)(resource->native);
-    if (!src) return ComputeStatus::eInvalidPointer;
-
-    src->Unmap(0, nullptr);
-    return ComputeStatus::eOk;
+    std::scoped_lock lock(m_mtx);
+    auto heap = m_batch;
+    m_batch = {};
+    m_batchThread = {};
+    m_batchPlacement = UINT64_MAX;
+    if (heap && heap->usedCount == 0)
+    {
+        // Nothing fit, do not keep the heap around
+        m_heapBytes -= heap->heap->GetDesc().SizeInBytes;
+        SL_SAFE_RELEASE(heap->heap);
+        m_batchHeaps.erase(std::find_if(m_batchHeaps.begin(), m_batchHeaps.end(), [heap](const std::unique_ptr<Heap>& h)->bool { return h.get() == heap; }));
+    }
 }
 
-ComputeStatus D3D12::getLUIDFromDevice(NVSDK_NGX_LUID *OutId)
+void DescriptorAllocator::init(uint32_t count)
 {
-    auto id = m_device->GetAdapterLuid();
-    memcpy(OutId, &id, sizeof(LUID));
-    return ComputeStatus::eOk;
+    m_count = count;
+    // Quarter of the heap is reserved for the overflow ring
+    m_persistentCount = count - count / 4;
+    m_persistentHead = 0;
+    m_free.clear();
+    m_retiring.clear();
+    m_ringCount = count - m_persistentCount;
+    m_ringFrame = std::make_unique<std::atomic<uint32_t>[]>(m_ringCount);
+    for (uint32_t i = 0; i < m_ringCount; i++)
+    {
+        m_ringFrame[i].store(UINT_MAX, std::memory_order_relaxed);
+    }
+    m_ringOwner.assign(m_ringCount, {});
+    m_ringHead = 0;
 }
 
-ComputeStatus D3D12::beginPerfSection(CommandList cmdList, const char *key, uint32_t node, bool reset)
+uint32_t DescriptorAllocator::allocate(uint32_t frame, void* resource, uint64_t key, Owner& evicted)
 {
-    PerfData* data = {};
+    evicted = {};
+
+    // Anything retired long enough can be reused
+    while (!m_retiring.empty() && frame >= m_retiring.front().second + kFrameDelay)
     {
-        std::scoped_lock lock(m_mutexProfiler);
-        auto section = m_sectionPerfMap[node].find(key);
-        if (section == m_sectionPerfMap[node].end())
-        {
-            m_sectionPerfMap[node][key] = {};
-            section = m_sectionPerfMap[node].find(key);
-        }
-        data = &(*section).second;
+        m_free.push_back(m_retiring.front().first);
+        m_retiring.pop_front();
     }
-    
-    if (reset)
+
+    if (!m_free.empty())
     {
-        for (int i = 0; i < SL_READBACK_QUEUE_SIZE; i++)
-        {
-            data->reset[i] = true;
-        }
-        data->meter.reset();
+        auto index = m_free.back();
+        m_free.pop_back();
+        return index;
     }
-    
-    if (!data->queryHeap[data->queryIdx])
-    {
-        D3D12_QUERY_HEAP_DESC queryHeapDesc = {};
-        queryHeapDesc.Count = 2;
-        queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
-        queryHeapDesc.NodeMask = (1 << node);
-        m_device->CreateQueryHeap(&queryHeapDesc, __uuidof(ID3D12QueryHeap), (void **)&data->queryHeap[data->queryIdx]);
-
-        D3D12_RESOURCE_DESC bufferDesc = {};
-        bufferDesc.MipLevels = 1;
-        bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
-        bufferDesc.Width = 2 * sizeof(uint64_t);
-        bufferDesc.Height = 1;
-        bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-        bufferDesc.DepthOrArraySize = 1;
-        bufferDesc.SampleDesc.Count = 1;
-        bufferDesc.SampleDesc.Quality = 0;
-        bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-        bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-        D3D12_RESOURCE_STATES initialState = D3D12_RESOURCE_STATE_COPY_DEST;
-        auto heapProp = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_READBACK, queryHeapDesc.NodeMask, queryHeapDesc.NodeMask);
-        m_device->CreateCommittedResource(&heapProp, D3D12_HEAP_FLAG_NONE, &bufferDesc, initialState, nullptr, IID_PPV_ARGS(&data->queryBufferReadback[data->queryIdx]));
-        D3D12_RANGE mapRange = { 0, sizeof(uint64_t) * 2 };
-        //! Map in advance to increase performance, no need to map/unmap every frame
-        data->queryBufferReadback[data->queryIdx]->Map(0, &mapRange, reinterpret_cast<void**>(&data->pStagingPtr));
+    if (m_persistentHead < m_persistentCount)
+    {
+        return m_persistentHead++;
     }
-    else
+
+    if (m_ringCount == 0) return kInvalidIndex;
+
+    // Persistent part is exhausted, look for the oldest ring slot which is no longer in flight
+    auto slot = m_ringHead;
+    for (uint32_t i = 0; i < m_ringCount; i++)
     {
-        ((ID3D12GraphicsCommandList*)cmdList)->ResolveQueryData(data->queryHeap[data->queryIdx], D3D12_QUERY_TYPE_TIMESTAMP, 0, 2, data->queryBufferReadback[data->queryIdx], 0);
-        uint64_t dxNanoSecondTS[2];
-        if (data->pStagingPtr)
+        auto candidate = (m_ringHead + i) % m_ringCount;
+        auto lastUsed = m_ringFrame[candidate].load(std::memory_order_relaxed);
+        if (lastUsed == UINT_MAX || frame >= lastUsed + kFrameDelay)
         {
-            dxNanoSecondTS[0] = ((uint64_t*)data->pStagingPtr)[0];
-            dxNanoSecondTS[1] = ((uint64_t*)data->pStagingPtr)[1];
-            double delta = (dxNanoSecondTS[1] - dxNanoSecondTS[0]) / 1e06;
-            if (!data->reset[data->queryIdx])
-            {
-                if (delta > 0)
-                {
-                    data->meter.add(delta);
-                }
-            }
-            else
-            {
-                data->meter.reset();
-            }
+            slot = candidate;
+            break;
         }
-        else
+        if (i + 1 == m_ringCount)
         {
-            data->reset[data->queryIdx] = false;
+            // Nothing left which is guaranteed to be idle, oldest ring slot is the least likely to still be in use
+            SL_LOG_WARN_ONCE("D3D12 descriptor heap exhausted, reusing descriptors which could still be in flight - please increase 'd3d12DescriptorCount' or do NOT change the tagged resources every frame");
         }
     }
-
-    ((ID3D12GraphicsCommandList*)cmdList)->EndQuery(data->queryHeap[data->queryIdx], D3D12_QUERY_TYPE_TIMESTAMP, 0);
-    return ComputeStatus::eOk;
+    evicted = m_ringOwner[slot];
+    m_ringFrame[slot].store(frame, std::memory_order_relaxed);
+    m_ringOwner[slot] = { resource, key };
+    m_ringHead = (slot + 1) % m_ringCount;
+    return m_persistentCount + slot;
 }
 
-ComputeStatus D3D12::endPerfSection(CommandList cmdList, const char* key, float &avgTimeMS, uint32_t node)
+void DescriptorAllocator::release(uint32_t index, uint32_t frame)
 {
-    PerfData* data = {};
+    if (index == kInvalidIndex) return;
+
+    if (isRing(index))
     {
-        std::scoped_lock lock(m_mutexProfiler);
-        auto section = m_sectionPerfMap[node].find(key);
-        if (section == m_sectionPerfMap[node].end())
-        {
-            return ComputeStatus::eError;
-        }
-        data = &(*section).second;
+        // Slot keeps its frame so it is not reused while in flight
+        m_ringOwner[index - m_persistentCount] = {};
+    }
+    else
+    {
+        // Evicted views can be older than the ones released recently, keep the list ordered by frame
+        auto it = std::upper_bound(m_retiring.begin(), m_retiring.end(), frame, [](uint32_t f, const std::pair<uint32_t, uint32_t>& item)->bool { return f < item.second; });
+        m_retiring.insert(it, { index, frame });
     }
-    ((ID3D12GraphicsCommandList*)cmdList)->EndQuery(data->queryHeap[data->queryIdx], D3D12_QUERY_TYPE_TIMESTAMP, 1);
-    data->queryIdx = (data->queryIdx + 1) % SL_READBACK_QUEUE_SIZE;
-
-    avgTimeMS = (float)data->meter.getMean();
-    return ComputeStatus::eOk;
 }
 
-
-ComputeStatus D3D12::beginProfiling(CommandList cmdList, uint32_t metadata, const char* marker)
+void DescriptorAllocator::reset(uint32_t frame)
 {
-#if SL_ENABLE_PROFILING
-    PIXBeginEvent(((ID3D12GraphicsCommandList*)cmdList), metadata, marker);
-#endif    
-    return ComputeStatus::eOk;
+    // Everything handed out so far could still be in flight
+    m_free.clear();
+    m_retiring.clear();
+    for (uint32_t i = 0; i < m_persistentHead; i++)
+    {
+        m_retiring.push_back({ i, frame });
+    }
+    for (auto& owner : m_ringOwner)
+    {
+        owner = {};
+    }
 }
 
-ComputeStatus D3D12::endProfiling(CommandList cmdList)
+void DescriptorCache::init(uint32_t maxEntries)
 {
-#if SL_ENABLE_PROFILING
-    PIXEndEvent(((ID3D12GraphicsCommandList*)cmdList));
-#endif
-    return ComputeStatus::eOk;
+    // Keep the load factor at or below one half so probe sequences stay short
+    uint32_t capacity = 1;
+    while (capacity < maxEntries * 2) capacity <<= 1;
+    m_entries = std::make_unique<Entry[]>(capacity);
+    m_mask = capacity - 1;
+    m_maxEntries = maxEntries;
+    m_count = 0;
+    m_clockHand = 0;
 }
 
-ComputeStatus D3D12::beginProfilingQueue(CommandQueue cmdQueue, uint32_t metadata, const char* marker)
+bool DescriptorCache::find(void* resource, uint64_t key, uint32_t frame, uint32_t& descIndex, bool& zbc)
 {
-#if SL_ENABLE_PROFILING
-    PIXBeginEvent(((ID3D12CommandQueue*)cmdQueue), metadata, marker);
-#endif    
-    return ComputeStatus::eOk;
+    while (true)
+    {
+        auto gen = m_generation.load();
+        if (gen & 1)
+        {
+            YieldProcessor();
+            continue;
+        }
+        Entry* hit{};
+        uint64_t value{};
+        for (uint32_t i = 0, idx = home(resource, key); i <= m_mask; i++, idx = (idx + 1) & m_mask)
+        {
+            auto& entry = m_entries[idx];
+            auto k = entry.key.load(std::memory_order_relaxed);
+            if (k == kEmpty) break;
+            if (k == key && entry.resource.load(std::memory_order_relaxed) == resource)
+            {
+                hit = &entry;
+                value = entry.value.load(std::memory_order_relaxed);
+                // Must be visible before validating, a writer then either sees it or we retry
+                entry.lastUsedFrame.store(frame);
+                break;
+            }
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_generation.load() == gen)
+        {
+            if (!hit) return false;
+            descIndex = (uint32_t)value;
+            zbc = (value >> 32) != 0;
+            return true;
+        }
+    }
 }
 
-ComputeStatus D3D12::endProfilingQueue(CommandQueue cmdQueue)
+void DescriptorCache::insert(void* resource, uint64_t key, uint32_t frame, uint32_t descIndex, bool zbc)
 {
-#if SL_ENABLE_PROFILING
-    PIXEndEvent(((ID3D12CommandQueue*)cmdQueue));
-#endif
-    return ComputeStatus::eOk;
+    auto idx = home(resource, key);
+    while (m_entries[idx].key.load(std::memory_order_relaxed) != kEmpty)
+    {
+        idx = (idx + 1) & m_mask;
+    }
+    beginWrite();
+    auto& entry = m_entries[idx];
+    entry.resource.store(resource, std::memory_order_relaxed);
+    entry.value.store((uint64_t)descIndex | ((uint64_t)zbc << 32), std::memory_order_relaxed);
+    entry.lastUsedFrame.store(frame, std::memory_order_relaxed);
+    entry.key.store(key, std::memory_order_relaxed);
+    m_count++;
+    endWrite();
 }
 
-bool D3D12::signalCPUFence(Fence fence, uint64_t syncValue)
+bool DescriptorCache::erase(void* resource, uint64_t key)
 {
-    auto d3d12Fence = ((ID3D12Fence*)fence);
-    if (FAILED(d3d12Fence->Signal(syncValue)))
+    for (uint32_t i = 0, idx = home(resource, key); i <= m_mask; i++, idx = (idx + 1) & m_mask)
     {
-        SL_LOG_ERROR("Failed to signal fence from CPU");
-        return false;
+        auto& entry = m_entries[idx];
+        auto k = entry.key.load(std::memory_order_relaxed);
+        if (k == kEmpty) break;
+        if (k == key && entry.resource.load(std::memory_order_relaxed) == resource)
+        {
+            beginWrite();
+            removeAt(idx);
+            endWrite();
+            return true;
+        }
     }
-    return true;
+    return false;
 }
 
-int D3D12::destroyResourceDeferredImpl(const Resource resource)
-{   
-    auto it = m_resourceData.find(resource->native);
-    if (it != m_resourceData.end())
-    {
-        m_resourceData.erase(it);
+void DescriptorCache::removeAt(uint32_t idx)
+{
+    // Shift back any entry which would become unreachable once this slot is empty
+    auto hole = idx;
+    auto next = idx;
+    while (true)
+    {
+        next = (next + 1) & m_mask;
+        auto& entry = m_entries[next];
+        auto k = entry.key.load(std::memory_order_relaxed);
+        if (k == kEmpty) break;
+        auto desired = home(entry.resource.load(std::memory_order_relaxed), k);
+        // Entry can move into the hole only if the hole lies between its home and its current slot
+        if (((next - desired) & m_mask) >= ((next - hole) & m_mask))
+        {
+            auto& target = m_entries[hole];
+            target.resource.store(entry.resource.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            target.value.store(entry.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            target.lastUsedFrame.store(entry.lastUsedFrame.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            target.key.store(k, std::memory_order_relaxed);
+            hole = next;
+        }
     }
-    auto unknown = (IUnknown*)(resource->native);
-    return unknown->Release();
+    m_entries[hole].resource.store(nullptr, std::memory_order_relaxed);
+    m_entries[hole].key.store(kEmpty, std::memory_order_relaxed);
+    m_count--;
 }
 
 DXGI_FORMAT D3D12::getCorrectFormat(DXGI_FORMAT Format)
@@ -2619,13 +4674,28 @@ DXGI_FORMAT D3D12::getCorrectFormat(DXGI_FORMAT Format)
     };
 }
 
-// {694B3E1C-0E33-416F-BA83-FE248DA1E85D}
-static const GUID sResourceStateGUID = { 0x694b3e1c, 0xe33, 0x416f, { 0xba, 0x83, 0xfe, 0x24, 0x8d, 0xa1, 0xe8, 0x5d } };
-
 ComputeStatus D3D12::getResourceState(Resource resource, ResourceState& state)
 {
     state = ResourceState::eUnknown;
     if(!resource) return ComputeStatus::eOk;
+    if (m_trackBarrierStates && resource->native)
+    {
+        // First query opts the resource in, from then on the proxy keeps the state current
+        auto res = (ID3D12Resource*)resource->native;
+        D3D12_RESOURCE_STATES tracked{};
+        UINT size = sizeof(tracked);
+        if (SUCCEEDED(res->GetPrivateData(interposer::kResourceStateGUID, &size, &tracked)))
+        {
+            if (tracked != interposer::kResourceStateUnknown)
+            {
+                return getResourceState(tracked, state);
+            }
+            // Host used a barrier the tracking cannot follow, state passed with the tag is the best we have
+            return getResourceState(resource->state, state);
+        }
+        tracked = (D3D12_RESOURCE_STATES)resource->state;
+        res->SetPrivateData(interposer::kResourceStateGUID, sizeof(tracked), &tracked);
+    }
     return getResourceState(resource->state, state);
 }
 
@@ -2800,5 +4870,140 @@ ComputeStatus D3D12::getResourceFromSharedHandle(ResourceType type, Handle handl
     return ComputeStatus::eOk;
 }
 
+
+ComputeStatus D3D12::beginBundle(uint32_t node, CommandList& bundle)
+{
+    auto& ctx = m_dispatchContext.getContext();
+    if (ctx.bundle)
+    {
+        SL_LOG_ERROR( "Bundle recording already in progress on this thread");
+        return ComputeStatus::eInvalidCall;
+    }
+
+    auto b = std::make_unique<BundleD3D12>();
+    b->node = node;
+    UINT nodeMask = m_nodeCount > 1 ? (1 << node) : 0;
+    if (FAILED(m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_BUNDLE, IID_PPV_ARGS(&b->allocator))) ||
+        FAILED(m_device->CreateCommandList(nodeMask, D3D12_COMMAND_LIST_TYPE_BUNDLE, b->allocator, nullptr, IID_PPV_ARGS(&b->cmdList))))
+    {
+        SL_LOG_ERROR( "Failed to create bundle");
+        releaseBundle(b.release());
+        return ComputeStatus::eError;
+    }
+    b->recording = true;
+    ctx.bundle = b.get();
+    bundle = b->cmdList;
+
+    std::scoped_lock lock(m_mutexBundles);
+    m_bundles[bundle] = std::move(b);
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::endBundle(CommandList bundle)
+{
+    auto& ctx = m_dispatchContext.getContext();
+    if (!ctx.bundle || ctx.bundle->cmdList != bundle)
+    {
+        SL_LOG_ERROR( "Bundle 0x%llx is not being recorded on this thread", bundle);
+        return ComputeStatus::eInvalidCall;
+    }
+    ctx.bundle->recording = false;
+    ctx.bundle = {};
+    // Nothing set on the bundle carries over to the next host list
+    ctx.cmdList = {};
+    ctx.resetBoundState();
+
+    if (FAILED(((ID3D12GraphicsCommandList*)bundle)->Close()))
+    {
+        SL_LOG_ERROR( "Failed to close bundle 0x%llx", bundle);
+        return ComputeStatus::eError;
+    }
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::executeBundle(CommandList cmdList, CommandList bundle)
+{
+    auto list = (ID3D12GraphicsCommandList*)cmdList;
+    if (!list || list->GetType() != D3D12_COMMAND_LIST_TYPE_DIRECT)
+    {
+        return ComputeStatus::eNoImplementation;
+    }
+
+    // Destruction is deferred so the bundle stays valid after the lookup
+    BundleD3D12* b{};
+    {
+        std::scoped_lock lock(m_mutexBundles);
+        auto it = m_bundles.find(bundle);
+        if (it != m_bundles.end())
+        {
+            b = (*it).second.get();
+        }
+    }
+    if (!b || b->recording)
+    {
+        SL_LOG_ERROR( "Bundle 0x%llx is not recorded", bundle);
+        return ComputeStatus::eInvalidArgument;
+    }
+
+    // Same lookups as the binds, cached views return the slot they were recorded with
+    for (auto& binding : b->bindings)
+    {
+        ResourceDriverData data = {};
+        auto status = binding.rw ? getSurfaceDriverData(&binding.resource, data, binding.mipOffset) : getTextureDriverData(&binding.resource, data, binding.mipOffset, binding.mipLevels);
+        if (status != ComputeStatus::eOk || data.descIndex != binding.descIndex)
+        {
+            return ComputeStatus::eInvalidCall;
+        }
+    }
+
+    // Heap set inside the bundle must match the one bound on the executing list
+    ID3D12DescriptorHeap* heaps[] = { m_heap->descriptorHeap[b->node] };
+    list->SetDescriptorHeaps(1, heaps);
+    list->ExecuteBundle(b->cmdList);
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus D3D12::destroyBundle(CommandList bundle)
+{
+    BundleD3D12* b{};
+    {
+        std::scoped_lock lock(m_mutexBundles);
+        auto it = m_bundles.find(bundle);
+        if (it == m_bundles.end() || (*it).second->recording)
+        {
+            SL_LOG_ERROR( "Bundle 0x%llx cannot be destroyed", bundle);
+            return ComputeStatus::eInvalidArgument;
+        }
+        b = (*it).second.release();
+        m_bundles.erase(it);
+    }
+    // Host command lists executing it could still be in flight
+    return destroy([this, b]()->void { releaseBundle(b); });
+}
+
+void D3D12::releaseBundle(BundleD3D12* bundle)
+{
+    SL_SAFE_RELEASE(bundle->cmdList);
+    SL_SAFE_RELEASE(bundle->allocator);
+    delete bundle;
+}
+
+ComputeStatus D3D12::addBundleBinding(BundleD3D12* bundle, Resource resource, uint32_t mipOffset, uint32_t mipLevels, bool rw, uint32_t descIndex)
+{
+    // Ring slots are handed out again a few frames later so they cannot be baked into a bundle
+    if (m_descriptors.isRing(descIndex))
+    {
+        SL_LOG_WARN("Descriptor heap is out of persistent slots, bundle cannot be recorded");
+        return ComputeStatus::eInvalidCall;
+    }
+    BundleD3D12::Binding binding{};
+    binding.resource = sl::Resource(resource->type, resource->native);
+    binding.mipOffset = mipOffset;
+    binding.mipLevels = mipLevels;
+    binding.rw = rw;
+    binding.descIndex = descIndex;
+    bundle->bindings.push_back(binding);
+    return ComputeStatus::eOk;
+}
 }
 }
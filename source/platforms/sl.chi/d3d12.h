@@ -25,6 +25,8 @@
 #include <d3d12.h>
 #include <future>
 #include <array>
+#include <unordered_map>
+#include <deque>
 
 #include "source/core/sl.thread/thread.h"
 #include "source/platforms/sl.chi/generic.h"
@@ -44,8 +46,8 @@ struct D3D12ThreadContext : public CommonThreadContext
     interposer::D3D12GraphicsCommandList* cmdList = {};
 };
 
-constexpr unsigned int SL_MAX_D3D12_DESCRIPTORS          = 1024;
-constexpr unsigned int SL_DESCRIPTOR_WRAPAROUND_CAPACITY = 2;
+constexpr unsigned int SL_DEFAULT_D3D12_DESCRIPTORS      = 4096;
+constexpr unsigned int SL_MIN_D3D12_DESCRIPTORS          = 256;
 
 class GpuUploadBuffer
 {
@@ -144,6 +146,11 @@ public:
     }
 };
 
+//! Descriptor indices passed to bindless kernels as root constants, see 'shaders/bindless.hlsli'
+constexpr uint32_t kMaxBindlessBindings = 16;
+//! Root signature size limit in DWORDs, tables cost 1, root descriptors 2 and constants 1 per value
+constexpr uint32_t kMaxRootSignatureDWORDs = 64;
+
 struct KernelDispatchData
 {
     KernelDispatchData() {};
@@ -155,8 +162,15 @@ struct KernelDispatchData
     std::vector<CD3DX12_ROOT_PARAMETER> rootParameters = {};
     CD3DX12_DESCRIPTOR_RANGE rootRanges[32];
     std::vector<ConstantBuffer*> cb = {};
+    std::vector<std::vector<uint32_t>> rootConstants = {};
+    //! Ring size for root constants demoted to a CBV when the root signature is over budget
+    uint32_t rootConstantInstances = 3;
     CD3DX12_STATIC_SAMPLER_DESC samplers[8] = {};
+    //! Heap indices of the resources bound at each 'pos', only used by bindless kernels
+    uint32_t bindlessIndices[kMaxBindlessBindings] = {};
 
+    //! Root signature and PSO are node specific, this is the node they were resolved for
+    uint32_t node = 0;
     ID3D12RootSignature* rootSignature = {};
     ID3D12PipelineState* pso = {};
 
@@ -168,7 +182,11 @@ struct KernelDispatchData
         rootParameters = rhs.rootParameters;
         memcpy(rootRanges, rhs.rootRanges, 32 * sizeof(CD3DX12_DESCRIPTOR_RANGE));
         cb = rhs.cb;
+        rootConstants = rhs.rootConstants;
+        rootConstantInstances = rhs.rootConstantInstances;
         memcpy(samplers, rhs.samplers, 8 * sizeof(CD3DX12_STATIC_SAMPLER_DESC));
+        memcpy(bindlessIndices, rhs.bindlessIndices, sizeof(bindlessIndices));
+        node = rhs.node;
         rootSignature = rhs.rootSignature;
         pso = rhs.pso;
         return *this;
@@ -182,6 +200,7 @@ struct KernelDispatchData
             handles[index] = 0;
             rootParameters.resize(index + 1);
             cb.resize(index + 1);
+            rootConstants.resize(index + 1);
             return true;
         }
         return false;
@@ -198,6 +217,26 @@ struct KernelDispatchData
 
 using KernelDispatchDataMap = std::map< Kernel, KernelDispatchData>;
 
+//! Reusable command list recorded between 'D3D12::beginBundle' and 'D3D12::endBundle'
+struct BundleD3D12
+{
+    //! Descriptor recorded into the bundle, looked up again before every execute
+    struct Binding
+    {
+        sl::Resource resource{};
+        uint32_t mipOffset{};
+        uint32_t mipLevels{};
+        bool rw{};
+        uint32_t descIndex{};
+    };
+
+    ID3D12CommandAllocator* allocator = {};
+    ID3D12GraphicsCommandList* cmdList = {};
+    uint32_t node = 0;
+    bool recording = false;
+    std::vector<Binding> bindings;
+};
+
 struct DispatchDataD3D12
 {
     DispatchDataD3D12() {};
@@ -217,21 +256,33 @@ struct DispatchDataD3D12
         }
     }
 
+    //! Forget what was bound on the command list, next dispatch sets everything again
+    void resetBoundState()
+    {
+        boundHeap = {};
+        boundRootSignature = {};
+        boundPSO = {};
+    }
+
     KernelDataBase* kernel = {};
     KernelDispatchDataMap* kddMap = {};
+    //! Resolved once in 'bindKernel', map nodes are stable so this stays valid
+    KernelDispatchData* kdd = {};
     ID3D12GraphicsCommandList* cmdList = {};
     uint32_t node = 0;
+    //! Set while this thread records a bundle, bindings are collected so 'executeBundle' can validate them
+    BundleD3D12* bundle = {};
+
+    //! State we last set on 'cmdList', only trusted from 'bindSharedState' until the pipeline is restored
+    ID3D12DescriptorHeap* boundHeap = {};
+    ID3D12RootSignature* boundRootSignature = {};
+    ID3D12PipelineState* boundPSO = {};
 };
 
 struct HeapInfo
 {
     ID3D12DescriptorHeap *descriptorHeap[MAX_NUM_NODES] = {};
     ID3D12DescriptorHeap *descriptorHeapCPU[MAX_NUM_NODES] = {};
-
-    UINT descIndex[MAX_NUM_NODES] = {0,0};
-
-    // Number of time we've wrapped around our Descriptor heap
-    unsigned int wrapAroundCount = 0;
 };
 
 struct ResourceDriverData
@@ -244,39 +295,369 @@ struct ResourceDriverData
     HeapInfo *heap = {};
 };
 
+//! Sub-allocates placed resources from a small set of large heaps.
+//!
+//! Allocations are rounded up to a power-of-two size class so that clones with
+//! compatible footprints share blocks regardless of their format or dimensions.
+//! Blocks are only returned once the placed resource has been released, which
+//! happens after the usual frame delay in `destroyResource`, so a block reused
+//! by a clone in a later frame is never in flight on the GPU.
+class PlacedHeapAllocator
+{
+public:
+    //! Heap tier 1 does not allow mixing these on the same heap
+    enum class HeapCategory : uint32_t
+    {
+        eBuffer,
+        eRTDSTexture,
+        eTexture,
+        eCount
+    };
+
+    void init(ID3D12Device* device) { m_device = device; }
+    void shutdown();
+
+    ID3D12Resource* allocate(const D3D12_RESOURCE_DESC& desc, D3D12_RESOURCE_STATES state, HRESULT& hr);
+    //! Returns false if the resource was not placed by this allocator
+    bool release(ID3D12Resource* resource, ULONG& refCount);
+
+    //! Linear heap shared by all resources of one 'D3D12::createResources' call, requires resource heap tier 2.
+    //!
+    //! Only the thread which began the batch places into it, the heap is released with its last resource.
+    bool beginBatch(uint64_t bytes);
+    //! Returns null if no batch is active on this thread or the resource does not fit
+    ID3D12Resource* allocateFromBatch(const D3D12_RESOURCE_DESC& desc, D3D12_RESOURCE_STATES state, HRESULT& hr);
+    //! Next 'allocateFromBatch' places at 'offset' instead of after the previous resource, used to alias memory
+    void placeNextAt(uint64_t offset);
+    void endBatch();
+
+    uint64_t getHeapBytes() const { return m_heapBytes; }
+
+private:
+    static constexpr uint64_t kMinBlockSize = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+    static constexpr uint64_t kHeapSize = 64ull * 1024 * 1024;
+    static constexpr uint32_t kClassCount = 16; // 64KB to 2GB
+
+    struct Heap
+    {
+        ID3D12Heap* heap = {};
+        uint32_t blockCount = 0;
+        uint32_t usedCount = 0;
+        std::vector<uint32_t> freeBlocks;
+        //! Batch heaps only, next free byte
+        uint64_t offset = 0;
+    };
+
+    struct Block
+    {
+        Heap* heap;
+        uint32_t index;
+        uint32_t sizeClass;
+        HeapCategory category;
+    };
+
+    std::vector<std::unique_ptr<Heap>>& getHeaps(HeapCategory category, uint32_t sizeClass) { return m_heaps[(uint32_t)category][sizeClass]; }
+
+    std::mutex m_mtx;
+    ID3D12Device* m_device = {};
+    uint64_t m_heapBytes = 0;
+    std::vector<std::unique_ptr<Heap>> m_heaps[(uint32_t)HeapCategory::eCount][kClassCount];
+    std::unordered_map<ID3D12Resource*, Block> m_blocks;
+    //! Blocks with 'sizeClass == kClassCount' live in one of these
+    std::vector<std::unique_ptr<Heap>> m_batchHeaps;
+    Heap* m_batch = {};
+    std::thread::id m_batchThread{};
+    uint64_t m_batchPlacement = UINT64_MAX;
+};
+
+//! Hands out slots in the shader visible SRV/UAV descriptor heap.
+//!
+//! The first part of the heap is persistent, cached views get a slot from a free list and
+//! return it when their resource goes away. Released slots are retired by frame so a view
+//! still referenced by a command list in flight is never overwritten. The remainder of the
+//! heap is a ring used once the persistent part is exhausted, ring slots are handed out
+//! again only after the frame they were last used in has finished.
+class DescriptorAllocator
+{
+public:
+    static constexpr uint32_t kInvalidIndex = UINT_MAX;
+    static constexpr uint32_t kFrameDelay = 3;
+
+    //! Owner of a ring slot, the cache entry which must be invalidated when the slot is reused
+    struct Owner
+    {
+        void* resource;
+        uint64_t key;
+    };
+
+    void init(uint32_t count);
+    uint32_t getCount() const { return m_count; }
+    uint32_t getPersistentCount() const { return m_persistentCount; }
+
+    //! Slot previously owned by 'evicted' (if any) has been reused and its cache entry must be dropped
+    uint32_t allocate(uint32_t frame, void* resource, uint64_t key, Owner& evicted);
+    //! Persistent slots go back to the free list once 'frame' has finished, ring slots are simply orphaned
+    void release(uint32_t index, uint32_t frame);
+    //! Ring slots used again must not be recycled until this frame finishes, lock-free
+    void touch(uint32_t index, uint32_t frame)
+    {
+        if (isRing(index))
+        {
+            m_ringFrame[index - m_persistentCount].store(frame, std::memory_order_relaxed);
+        }
+    }
+    //! All slots are released, cache must be empty at this point
+    void reset(uint32_t frame);
+
+    bool isRing(uint32_t index) const { return index >= m_persistentCount; }
+
+private:
+    uint32_t m_count = 0;
+    uint32_t m_persistentCount = 0;
+    uint32_t m_persistentHead = 0;
+    std::vector<uint32_t> m_free;
+    std::deque<std::pair<uint32_t, uint32_t>> m_retiring;
+    std::unique_ptr<std::atomic<uint32_t>[]> m_ringFrame;
+    std::vector<Owner> m_ringOwner;
+    uint32_t m_ringCount = 0;
+    uint32_t m_ringHead = 0;
+};
+
+//! Cache of SRV/UAV descriptors keyed by resource identity.
+//!
+//! Native pointers are reused by the runtime once a resource is released, so each resource
+//! gets a creation serial stored in its private data and the serial is part of the key.
+//! Entries for released resources never match again and simply age out. Eviction is
+//! a CLOCK approximation of LRU based on the frame each entry was last used in.
+//!
+//! The generation works as a seqlock (odd while writing) exactly like in ResourceTrackingTable.
+//! Writers must be serialized externally and so must any reader which goes on to use the
+//! descriptor index, eviction can recycle it as soon as 'find' returns.
+class DescriptorCache
+{
+public:
+    static constexpr uint64_t kEmpty = 0;
+
+    void init(uint32_t maxEntries);
+    bool isFull() const { return m_count >= m_maxEntries; }
+
+    //! Serials start at 1 so a valid key is never empty
+    static uint64_t makeKey(uint32_t serial, uint32_t hash) { return ((uint64_t)serial << 32) | hash; }
+
+    //! Marks the entry as used in 'frame'
+    bool find(void* resource, uint64_t key, uint32_t frame, uint32_t& descIndex, bool& zbc);
+    //! Writer only
+    void insert(void* resource, uint64_t key, uint32_t frame, uint32_t descIndex, bool zbc);
+    bool erase(void* resource, uint64_t key);
+
+    //! Writer only, drops least recently used entry which is no longer in flight and hands its descriptor to 'release'
+    template<typename F>
+    bool evict(uint32_t frame, uint32_t frameDelay, F release)
+    {
+        auto capacity = m_mask + 1;
+        for (uint32_t i = 0; i < capacity; i++)
+        {
+            auto idx = m_clockHand;
+            m_clockHand = (m_clockHand + 1) & m_mask;
+            auto& entry = m_entries[idx];
+            if (entry.key.load(std::memory_order_relaxed) == kEmpty) continue;
+
+            beginWrite();
+            auto lastUsed = entry.lastUsedFrame.load();
+            if (frame >= lastUsed + frameDelay)
+            {
+                auto value = entry.value.load(std::memory_order_relaxed);
+                removeAt(idx);
+                endWrite();
+                release((uint32_t)value, lastUsed);
+                return true;
+            }
+            endWrite();
+        }
+        return false;
+    }
+
+    //! Writer only, hands every cached descriptor to 'release'
+    template<typename F>
+    void clear(F release)
+    {
+        beginWrite();
+        auto capacity = m_mask + 1;
+        for (uint32_t i = 0; i < capacity; i++)
+        {
+            auto& entry = m_entries[i];
+            if (entry.key.load(std::memory_order_relaxed) != kEmpty)
+            {
+                release((uint32_t)entry.value.load(std::memory_order_relaxed), entry.lastUsedFrame.load());
+                entry.resource.store(nullptr, std::memory_order_relaxed);
+                entry.key.store(kEmpty, std::memory_order_relaxed);
+            }
+        }
+        m_count = 0;
+        endWrite();
+    }
+
+private:
+    struct Entry
+    {
+        std::atomic<void*> resource{};
+        //! Creation serial in the upper and view hash in the lower 32 bits
+        std::atomic<uint64_t> key{};
+        //! Descriptor index in the lower 32 bits, ZBC support in bit 32
+        std::atomic<uint64_t> value{};
+        std::atomic<uint32_t> lastUsedFrame{};
+    };
+
+    uint32_t home(void* resource, uint64_t key) const
+    {
+        auto h = (uint64_t)resource ^ (key * 0x9E3779B97F4A7C15ull);
+        h ^= h >> 32;
+        return (uint32_t)(h * 0x9E3779B97F4A7C15ull >> 32) & m_mask;
+    }
+    //! Backward shift deletion so probe sequences never need tombstones
+    void removeAt(uint32_t idx);
+    void beginWrite()
+    {
+        m_generation.fetch_add(1);
+    }
+    void endWrite()
+    {
+        m_generation.fetch_add(1);
+    }
+
+    std::unique_ptr<Entry[]> m_entries;
+    uint32_t m_mask = 0;
+    uint32_t m_maxEntries = 0;
+    uint32_t m_count = 0;
+    uint32_t m_clockHand = 0;
+    std::atomic<uint32_t> m_generation = 0;
+};
+
 class D3D12 : public Generic
 {
+    //! Perf sections share one timestamp heap per node, each frame gets its own slice of it and
+    //! sections are sub-allocated within the slice by their interned id. A slice is resolved with
+    //! one call when the next frame starts and read back when the slice comes around again.
+    static constexpr uint32_t kMaxPerfSections = 64;
+    static constexpr uint32_t kTimestampsPerSlice = kMaxPerfSections * 2;
+
     struct PerfData
     {
-        UINT8* pStagingPtr = nullptr;
-        ID3D12QueryHeap *queryHeap[SL_READBACK_QUEUE_SIZE] = {};
-        ID3D12Resource  *queryBufferReadback[SL_READBACK_QUEUE_SIZE] = {};
-        UINT queryIdx = 0;
         extra::AverageValueMeter meter{};
+        uint32_t slice = 0;
+        bool active[SL_READBACK_QUEUE_SIZE] = {};
         bool reset[SL_READBACK_QUEUE_SIZE] = {};
     };
-    using MapSectionPerf = std::map<std::string, PerfData>;
-    MapSectionPerf m_sectionPerfMap[MAX_NUM_NODES] = {};
+    struct TimestampPool
+    {
+        ID3D12QueryHeap* heap = {};
+        ID3D12Resource* readback = {};
+        const uint64_t* timestamps = {};
+        uint32_t frame = UINT_MAX;
+        uint32_t slice = 0;
+        bool pendingResolve = false;
+        //! Written by the GPU after each slice is resolved, zero if the command list cannot write markers
+        uint32_t resolveSerial = 0;
+        uint32_t sliceSerial[SL_READBACK_QUEUE_SIZE] = {};
+        std::vector<PerfData> sections = {};
+    };
+    std::unordered_map<std::string, uint32_t> m_perfSectionIds = {};
+    TimestampPool m_timestampPool[MAX_NUM_NODES] = {};
+
+    //! SL owned compute queue for opt-in async passes, one pass records at a time
+    struct AsyncCompute
+    {
+        ChiCommandQueue* queue = {};
+        ICommandListContext* context = {};
+        Fence hostFence = {};
+        Fence computeFence = {};
+        uint64_t hostValue = 0;
+        uint64_t computeValue = 0;
+        bool recording = false;
+    };
+    bool m_asyncComputeEnabled = false;
+    //! Host transitions are recorded by the command list proxy, see kResourceStateGUID
+    bool m_trackBarrierStates = false;
+    AsyncCompute m_asyncCompute;
+    std::mutex m_mutexAsyncCompute;
+
+    //! Headless back buffers, the chain handle given out is the address of the entry
+    struct NullSwapChain
+    {
+        NullSwapChainDesc desc = {};
+        std::vector<Resource> buffers = {};
+        Fence fence = {};
+        //! Fence value which retires each back buffer, zero if it was never presented
+        std::vector<uint64_t> retireValues = {};
+        uint64_t presentCount = 0;
+        uint32_t index = 0;
+    };
+    std::vector<std::unique_ptr<NullSwapChain>> m_nullSwapChains;
+    std::mutex m_mutexNullSwapChains;
+
+    NullSwapChain* findNullSwapChain(SwapChain chain);
+
+    uint32_t getPerfSectionId(const char* key);
+    ComputeStatus initTimestampPool(TimestampPool& pool, uint32_t node);
+    void advanceTimestampPool(TimestampPool& pool, ID3D12GraphicsCommandList* cmdList);
 
     ID3D12Device         *m_device     = nullptr;
 
     Kernel m_copyKernel = {};
 
     bool m_dbgSupportRs2RelaxedConversionRules = false;
+    //! SM 6.6 and resource binding tier 3, see 'ShaderCaps::bindlessResources'
+    bool m_bindlessSupported = false;
+    //! Buffers and textures can share a heap, see 'createResources'
+    bool m_heapTier2 = false;
+    //! D3D12_FEATURE_D3D12_OPTIONS12, transitions and UAV barriers go through ID3D12GraphicsCommandList7::Barrier
+    bool m_enhancedBarriers = false;
 
     UINT m_descriptorSize = 0;
     D3D12_CPU_DESCRIPTOR_HANDLE m_descHandleSamplerCPU[MAX_NUM_NODES][eSamplerCount] = {};
 
     HeapInfo* m_heap = nullptr;
+    DescriptorAllocator m_descriptors;
+    DescriptorCache m_descriptorCache;
+    std::atomic<uint32_t> m_descriptorSerial = 0;
     
     UINT m_visibleNodeMask = 0;
+    UINT m_nodeCount = 1;
 
-    std::map<void*, std::map<uint32_t,ResourceDriverData>> m_resourceData;
     std::map<size_t, ID3D12PipelineState*> m_psoMap = {};
     std::map<size_t, ID3D12RootSignature*> m_rootSignatureMap = {};
+
+    //! Persistent pipeline cache, PSOs live in the pipeline library while the manifest
+    //! records what is needed to recreate their root signatures before the first dispatch
+    struct PipelineCacheEntry
+    {
+        size_t kernel = {};
+        size_t rootSignature = {};
+        uint32_t node = {};
+        std::vector<uint8_t> rootSignatureBlob = {};
+    };
+    ID3D12PipelineLibrary* m_pipelineLibrary = nullptr;
+    std::vector<uint8_t> m_pipelineLibraryData = {};
+    std::map<size_t, PipelineCacheEntry> m_pipelineCache = {};
+    std::map<size_t, std::vector<uint8_t>> m_rootSignatureBlobs = {};
+    bool m_pipelineCacheDirty = false;
+
+    void loadPipelineCache();
+    void savePipelineCache();
+    ComputeStatus createRootSignature(size_t hash, const void* blob, size_t blobSize, uint32_t node, ID3D12RootSignature*& rootSignature);
+    ComputeStatus createPipelineState(size_t hash, const KernelDataBase* kernel, size_t rootSignatureHash, ID3D12RootSignature* rootSignature, uint32_t node, ID3D12PipelineState*& pso);
     thread::ThreadContext<DispatchDataD3D12> m_dispatchContext;
+    PlacedHeapAllocator m_placedHeaps;
+
+    std::unordered_map<CommandList, std::unique_ptr<BundleD3D12>> m_bundles;
+    std::mutex m_mutexBundles;
+    void releaseBundle(BundleD3D12* bundle);
+    ComputeStatus addBundleBinding(BundleD3D12* bundle, Resource resource, uint32_t mipOffset, uint32_t mipLevels, bool rw, uint32_t descIndex);
 
     size_t hashRootSignature(const CD3DX12_ROOT_SIGNATURE_DESC& desc);
+    ComputeStatus fitRootSignature(KernelDispatchData& kdd);
+    ComputeStatus getBindlessRootSignature(uint32_t node, size_t& hash, ID3D12RootSignature*& rootSignature);
+    ComputeStatus dispatchBindless(uint32_t blocksX, uint32_t blocksY, uint32_t blocksZ);
 
     virtual std::wstring getDebugName(Resource res) override final;
     virtual int destroyResourceDeferredImpl(const Resource InResource) override final;
@@ -285,13 +666,17 @@ class D3D12 : public Generic
     ComputeStatus getSurfaceDriverData(Resource resource, ResourceDriverData &data, uint32_t mipOffset = 0);
     ComputeStatus getTextureDriverData(Resource resource, ResourceDriverData &data, uint32_t mipOffset = 0, uint32_t mipLevels = 0, Sampler sampler = Sampler::eSamplerPointClamp);
     ComputeStatus transitionResourceImpl(CommandList InCmdList, const ResourceTransition* transisitions, uint32_t count) override final;
+    ComputeStatus transitionResourceSplitImpl(CommandList cmdList, const ResourceTransition* transitions, const BarrierSplit* splits, uint32_t count) override final;
     ComputeStatus createTexture2DResourceSharedImpl(ResourceDescription& InOutResourceDesc, Resource& OutResource, bool UseNativeFormat, ResourceState InitialState, const char InFriendlyName[]) override final;
     ComputeStatus createBufferResourceImpl(ResourceDescription& InOutResourceDesc, Resource& OutResource, ResourceState InitialState, const char InFriendlyName[]) override final;
 
     bool dx11On12 = false;
     bool isSupportedFormat(DXGI_FORMAT format, int flag1, int flag2);
     DXGI_FORMAT getCorrectFormat(DXGI_FORMAT Format);
-    UINT getNewAndIncreaseDescIndex();
+    UINT getNewAndIncreaseDescIndex(void* resource, uint64_t key);
+    uint32_t getDescriptorSerial(ID3D12Resource* resource);
+    uint32_t getResourceNodeMask(ID3D12Resource* resource);
+    bool recordEnhancedTransitions(CommandList cmdList, const ResourceTransition* transitions, uint32_t count);
 
     inline D3D12_RESOURCE_STATES toD3D12States(ResourceState state)
     {
@@ -325,6 +710,7 @@ public:
 
     virtual uint64_t getCompletedValue(Fence fence) override final;
     virtual WaitStatus waitCPUFence(Fence fence, uint64_t syncValue) override final;
+    virtual WaitStatus waitCPUFences(const Fence* fences, const uint64_t* syncValues, uint32_t count, bool waitAny = false, uint32_t timeoutMs = 500) override final;
 
     virtual ComputeStatus createCommandQueue(CommandQueueType type, ChiCommandQueue*& queue, const char friendlyName[], uint32_t index) override final;
     virtual ComputeStatus destroyCommandQueue(ChiCommandQueue* queue) override final;
@@ -341,6 +727,7 @@ public:
     virtual ComputeStatus bindTexture(uint32_t binding, uint32_t reg, Resource resource, uint32_t mipOffset = 0, uint32_t mipLevels = 0) override;
     virtual ComputeStatus bindRWTexture(uint32_t binding, uint32_t reg, Resource resource, uint32_t mipOffset = 0) override;
     virtual ComputeStatus bindRawBuffer(uint32_t binding, uint32_t reg, Resource resource) override;
+    virtual ComputeStatus bindRootConstants(uint32_t binding, uint32_t reg, const void* data, size_t dataSize, uint32_t instances) override final;
     virtual ComputeStatus dispatch(unsigned int blockX, unsigned int blockY, unsigned int blockZ = 1) override final;
 
     virtual ComputeStatus clearView(CommandList cmdList, Resource InResource, const float4 Color, const RECT * pRect, unsigned int NumRects, CLEAR_TYPE &outType) override final;
@@ -348,6 +735,8 @@ public:
     virtual ComputeStatus insertGPUBarrierList(CommandList cmdList, const Resource* InResources, unsigned int InResourceCount, BarrierType InBarrierType = eBarrierTypeUAV) override final;
     virtual ComputeStatus insertGPUBarrier(CommandList cmdList, Resource InResource, BarrierType InBarrierType) override final;
     virtual ComputeStatus copyResource(CommandList cmdList, Resource InDstResource, Resource InSrcResource) override final;
+    virtual ComputeStatus copyResourceRegion(CommandList cmdList, Resource InDstResource, Resource InSrcResource, const Extent& region) override final;
+    virtual ComputeStatus copyDepthToColor(CommandList cmdList, Resource InDstResource, Resource InSrcResource) override final;
     virtual ComputeStatus cloneResource(Resource InResource, Resource &OutResource, const char friendlyName[], ResourceState InitialState, unsigned int InCreationMask, unsigned int InVisibilityMask) override final;
     virtual ComputeStatus copyBufferToReadbackBuffer(CommandList cmdList, Resource InResource, Resource OutResource, unsigned int InBytesToCopy) override final;
     virtual ComputeStatus copyDeviceTextureToDeviceBuffer(CommandList cmdList, Resource srcTexture, Resource dstBuffer) override final;
@@ -365,6 +754,7 @@ public:
 
     ComputeStatus beginPerfSection(CommandList cmdList, const char *key, unsigned int node, bool InReset = false) override final;
     ComputeStatus endPerfSection(CommandList cmdList, const char *key, float &OutAvgTimeMS, unsigned int node) override final;
+    ComputeStatus getPerfSectionStats(const char* key, PerfSectionStats& stats, uint32_t node) override final;
     ComputeStatus beginProfiling(CommandList cmdList, UINT Metadata, const char* marker) override final;
     ComputeStatus endProfiling(CommandList cmdList) override final;
     ComputeStatus beginProfilingQueue(CommandQueue cmdQueue, UINT Metadata, const char* marker) override final;
@@ -379,6 +769,27 @@ public:
     virtual ComputeStatus createSharedHandle(Resource res, Handle& handle)  override final;
     virtual ComputeStatus destroySharedHandle(Handle& handle)  override final;
     virtual ComputeStatus getResourceFromSharedHandle(ResourceType type, Handle handle, Resource& res)  override final;
+
+    virtual ComputeStatus prewarmKernels(const Kernel* kernels, uint32_t count) override final;
+    virtual ComputeStatus getShaderCaps(ShaderCaps& caps) override final;
+    virtual ComputeStatus getPerfSectionNames(std::vector<std::string>& names, uint32_t node) override final;
+
+    virtual ComputeStatus beginAsyncCompute(CommandQueue hostQueue, CommandList& cmdList) override final;
+    virtual ComputeStatus endAsyncCompute(CommandQueue hostQueue) override final;
+
+    virtual ComputeStatus createNullSwapChain(const NullSwapChainDesc& desc, SwapChain& chain) override final;
+    virtual ComputeStatus destroyNullSwapChain(SwapChain chain) override final;
+    virtual ComputeStatus presentNullSwapChain(SwapChain chain, CommandQueue queue, uint32_t& bufferIndex) override final;
+
+    virtual ComputeStatus uploadToTexture(CommandList cmdList, const void* data, uint64_t size, uint64_t rowPitch, Resource target) override final;
+
+    virtual ComputeStatus createResources(ResourceBatchEntry* entries, uint32_t count) override final;
+    virtual ComputeStatus createAliasedResources(ResourceBatchEntry* entries, uint32_t count) override final;
+
+    virtual ComputeStatus beginBundle(uint32_t node, CommandList& bundle) override final;
+    virtual ComputeStatus endBundle(CommandList bundle) override final;
+    virtual ComputeStatus executeBundle(CommandList cmdList, CommandList bundle) override final;
+    virtual ComputeStatus destroyBundle(CommandList bundle) override final;
 };
 
 }
@@ -32,6 +32,10 @@
 #include <fstream>
 #include <map>
 #include <unordered_set>
+#include <unordered_map>
+#include <deque>
+#include <condition_variable>
+#include <algorithm>
 
 struct IDXGIAdapter;
 struct IDXGISwapChain;
@@ -40,11 +44,15 @@ struct IDXGISwapChain;
 #include "source/core/sl.log/log.h"
 #include "source/core/sl.extra/extra.h"
 #include "source/core/sl.param/parameters.h"
+#include "source/core/sl.file/file.h"
 #include "source/platforms/sl.chi/generic.h"
+#include "source/platforms/sl.chi/imageCodec.h"
 #include "nvapi.h"
 
 // {B5504F36-CB88-4B2D-AE64-9CAE29E23CA9}
 static const GUID sResourceTrackGUID = { 0xb5504f36, 0xcb88, 0x4b2d, { 0xae, 0x64, 0x9c, 0xae, 0x29, 0xe2, 0x3c, 0xa9 } };
+// {3F0C9A6E-52D1-4B7E-9A0B-6C1E8D24F7B3}
+static const GUID sSharedResourceNotifierGUID = { 0x3f0c9a6e, 0x52d1, 0x4b7e, { 0x9a, 0x0b, 0x6c, 0x1e, 0x8d, 0x24, 0xf7, 0xb3 } };
 
 const char *GFORMAT_STR[] = {
     "eFormatINVALID",
@@ -89,17 +97,29 @@ namespace chi
 ScopedProfilingSection::ScopedProfilingSection(ICompute* compute, CommandList cmdList, const char* function, sl::Feature feature)
     : ScopedProfilingSection(compute, cmdList)
 {
-#if SL_ENABLE_PROFILING
+    // Nothing to format unless someone is listening
+    if (!m_active && !SL_TRACE_ENABLED) return;
+
     std::stringstream str;
     str << function << " " << getFeatureAsStr(feature);
-    m_compute->beginProfiling(m_cmdList, 0, str.str().c_str());
-#endif
+    SL_TRACE_ZONE_BEGIN(m_zone, str.str().c_str());
+    begin(str.str().c_str());
+}
+
+ScopedProfilingSection::ScopedProfilingSection(ICompute* compute, CommandList cmdList, const char* function, sl::Feature feature, uint32_t viewport)
+    : ScopedProfilingSection(compute, cmdList)
+{
+    if (!m_active && !SL_TRACE_ENABLED) return;
+
+    std::stringstream str;
+    str << function << " " << getFeatureAsStr(feature) << " viewport " << viewport;
+    SL_TRACE_ZONE_BEGIN(m_zone, str.str().c_str());
+    begin(str.str().c_str());
 }
 
  ScopedProfilingSection::ScopedProfilingSection(ICompute* compute, CommandList cmdList, const char* function, const sl::ResourceTag* resources, uint32_t numResources) : ScopedProfilingSection(compute, cmdList)
 {
-#if SL_ENABLE_PROFILING
-    std::string marker;
+    if (!m_active && !SL_TRACE_ENABLED) return;
 
     std::stringstream str;
     str << function << " ";
@@ -113,8 +133,8 @@ ScopedProfilingSection::ScopedProfilingSection(ICompute* compute, CommandList cm
             str << ", ";
         }
     }
-    m_compute->beginProfiling(m_cmdList, 0, str.str().c_str());
-    #endif
+    SL_TRACE_ZONE_BEGIN(m_zone, str.str().c_str());
+    begin(str.str().c_str());
 }
 
 
@@ -124,7 +144,14 @@ struct ResourcePool : IResourcePool
 {
     using TimestampedResource = std::pair<std::chrono::system_clock::time_point, HashedResource>;
 
-    ResourcePool(ICompute* compute, const char* vramSegment) : m_compute(compute), m_vramSegment(vramSegment) {};
+    //! Time spent per collectGarbage call before the remaining buckets are deferred to the next call
+    static constexpr float kGarbageCollectionBudgetUs = 100.0f;
+    //! Frames over which the peak number of items in use is measured, see 'Bucket::trackDemand'
+    static constexpr uint32_t kDemandWindowFrames = 120;
+    //! Cached source descriptions before the cache starts over, entries of sources no longer tagged are never looked up again
+    static constexpr size_t kMaxSourceDescriptions = 256;
+
+    ResourcePool(ICompute* compute, const char* vramSegment, extra::IPerfStats* perfStats) : m_compute(compute), m_vramSegment(vramSegment), m_perfStats(perfStats) {};
 
     virtual void setMaxQueueSize(size_t maxSize) override final
     {
@@ -132,84 +159,124 @@ struct ResourcePool : IResourcePool
     }
 
     virtual HashedResource allocate(Resource source, const char* debugName, ResourceState initialState) override final
+    {
+        return allocateAs(source, eFormatINVALID, debugName, initialState);
+    }
+
+    virtual HashedResource allocateAs(Resource source, Format format, const char* debugName, ResourceState initialState) override final
     {
         ResourceDescription desc;
-        m_compute->getResourceDescription(source, desc);
+        getSourceDescription(source, desc);
         desc.state = initialState;
+        if (format != eFormatINVALID)
+        {
+            // Different format means a different bucket, clones with the source format are never handed out here
+            desc.format = format;
+            desc.nativeFormat = NativeFormatUnknown;
+            desc.flags &= ~ResourceFlags::eDepthStencilAttachment;
+        }
         auto hash = getHash(desc);
+        if (m_perfStats) m_perfStats->add(extra::PerfCounter::ePoolAllocations, 1);
         std::unique_lock<std::mutex> lock(m_mtx);
         // Look for a free one to recycle
         HashedResource resource{};
+        auto& bucket = getBucket(hash);
         {
-            auto& freeItems = m_free[hash];
+            auto& freeItems = bucket.free;
             // Incoming resource was allocated and freed before but nothing is free at the moment
             if (freeItems.empty())
             {
                 // No free items, check if this was allocated before
-                for (auto& allocated : m_allocated)
+                if (!bucket.allocated.empty())
                 {
-                    if (hash == allocated.first)
-                    {
-                        // Yes, this was allocated before so it makes sense to wait for an item to be freed
-
-                        // Figure out how much VRAM is available vs how much we need
-                        uint64_t bytesAvailable;
-                        m_compute->getVRAMBudget(bytesAvailable);
-                        ResourceFootprint footprint{};
-                        m_compute->getResourceFootprint(source, footprint);
-
-                        //! IMPORTANT: The more we wait the less VRAM we use but we potentially slow down execution.
-                        //! 
-                        //! Therefore we determine dynamically how much VRAM is available and if we need to wait more (100ms) or less (0.5ms).
-                        //! In addition, we have to check for hard limit on the queue size since even if there is plenty of VRAM it does not 
-                        //! make sense to allocate buffers endlessly. Good example would be the v-sync on mode, in that scenario the longer 
-                        //! waits are normal since present calls will block and wait for the v-sync line before actually presenting the frame.
-                        float resourcePoolWaitUs = bytesAvailable > footprint.totalBytes && allocated.second.size() < m_maxQueueSize ? 500.0f : 100000.0f;
-
-                        // Use more precise timer
-                        extra::AverageValueMeter meter;
-                        meter.begin();
-                        // Prevent deadlocks, time out after a reasonable wait period.
-                        // See comments above about the wait time and VRAM consumption.
-                        while (freeItems.empty() && meter.getElapsedTimeUs() < resourcePoolWaitUs)
-                        {
-                            lock.unlock();
-                            // Better than sleep for modern CPUs with hyper-threading
-                            YieldProcessor();
-                            lock.lock();
-                            meter.end();
-                        }
-                        // Timing out here is fine, that just means more VRAM is needed.
-                        //
-                        // We already have warnings/errors for GPU fence and worker thread timeouts which are serious problems
-                    }
+                    // Yes, this was allocated before so it makes sense to wait for an item to be freed
+
+                    // Figure out how much VRAM is available vs how much we need
+                    uint64_t bytesAvailable;
+                    m_compute->getVRAMBudget(bytesAvailable);
+                    ResourceFootprint footprint{};
+                    m_compute->getResourceFootprint(source, footprint);
+
+                    //! IMPORTANT: The more we wait the less VRAM we use but we potentially slow down execution.
+                    //! 
+                    //! Therefore we determine dynamically how much VRAM is available and if we need to wait more (100ms) or less (0.5ms).
+                    //! In addition, we have to check for hard limit on the queue size since even if there is plenty of VRAM it does not 
+                    //! make sense to allocate buffers endlessly. Good example would be the v-sync on mode, in that scenario the longer 
+                    //! waits are normal since present calls will block and wait for the v-sync line before actually presenting the frame.
+                    float resourcePoolWaitUs = bytesAvailable > footprint.totalBytes && bucket.allocated.size() < m_maxQueueSize ? 500.0f : 100000.0f;
+
+                    // Prevent deadlocks, time out after a reasonable wait period.
+                    // See comments above about the wait time and VRAM consumption.
+                    //
+                    // No spinning, recycle() wakes us up as soon as something is returned to the pool.
+                    SL_TRACE_ZONE("ResourcePool::wait");
+                    extra::ScopedHitchTimer hitch("ResourcePool::allocate");
+                    bucket.waiters++;
+                    m_cvFree.wait_for(lock, std::chrono::microseconds((int64_t)resourcePoolWaitUs), [&freeItems]() { return !freeItems.empty(); });
+                    bucket.waiters--;
+                    // Timing out here is fine, that just means more VRAM is needed.
+                    //
+                    // We already have warnings/errors for GPU fence and worker thread timeouts which are serious problems
                 }
             }
             if (!freeItems.empty())
             {
-                resource = freeItems.back().second;
-                freeItems.pop_back();
+                // Prefer the item recycled before the last frame the GPU finished with,
+                // otherwise the oldest one since it is the most likely to be retired.
+                uint32_t finishedFrame{};
+                m_compute->getFinishedFrameIndex(finishedFrame);
+                auto it = std::find_if(freeItems.begin(), freeItems.end(), [finishedFrame](const FreeResource& item) { return item.frame <= finishedFrame; });
+                if (it == freeItems.end())
+                {
+                    it = freeItems.begin();
+                }
+                resource = it->resource;
+                freeItems.erase(it);
                 m_compute->getResourceState((Resource)resource, resource.accessState());
-                m_allocated[hash].push_back({ std::chrono::system_clock::now(), resource });
+                bucket.push(resource);
+                bucket.trackDemand(finishedFrame);
                 return resource;
             }
         }
         if (!resource)
         {
+            // Nothing to recycle, a new resource is created
+            if (m_perfStats) m_perfStats->add(extra::PerfCounter::ePoolMisses, 1);
             m_compute->beginVRAMSegment(m_vramSegment.c_str());
             Resource res{};
-            m_compute->cloneResource(source, res, debugName, initialState);
+            if (format != eFormatINVALID)
+            {
+                m_compute->createTexture2D(desc, res, debugName);
+            }
+            else
+            {
+                m_compute->cloneResource(source, res, debugName, initialState);
+            }
             m_compute->endVRAMSegment();
+            if (!res)
+            {
+                SL_LOG_ERROR("Failed to allocate '%s' from the resource pool", debugName);
+                return {};
+            }
             m_compute->getResourceState(res->state, initialState);
             resource = HashedResource(hash, initialState, res, m_compute, true);
+            if (!bucket.resourceBytes)
+            {
+                ResourceFootprint footprint{};
+                m_compute->getResourceFootprint(res, footprint);
+                bucket.resourceBytes = footprint.totalBytes;
+            }
+            uint32_t finishedFrame{};
+            m_compute->getFinishedFrameIndex(finishedFrame);
 #if SL_DEBUG_RESOURCE_POOL
-            for (auto& [timestamp, cached] : m_allocated[hash])
+            for (auto& [timestamp, cached] : bucket.allocated)
             {
                 assert(res != cached.resource);
             }
-            SL_LOG_VERBOSE("alloc - hash %llu 0x%p '%s' [%llu,%llu]\n", hash, ((Resource)resource)->native, debugName, m_allocated[hash].size(), m_free[hash].size());
+            SL_LOG_VERBOSE("alloc - hash %llu 0x%p '%s' [%llu,%llu]\n", hash, ((Resource)resource)->native, debugName, bucket.allocated.size(), bucket.free.size());
 #endif
-            m_allocated[hash].push_back({ std::chrono::system_clock::now(), resource });
+            bucket.push(resource);
+            bucket.trackDemand(finishedFrame);
         }
         return resource;
     }
@@ -219,78 +286,163 @@ struct ResourcePool : IResourcePool
         if (!res) return;
         std::scoped_lock lock(m_mtx);
         assert(!res.dbgIsCorrupted());
-        auto& list = m_allocated[res.accessHash()];
-        auto it = list.begin();
-#if SL_DEBUG_RESOURCE_POOL
-        int count = 0;
-#endif
-        while(it != list.end())
+        auto& bucket = getBucket(res.accessHash());
+        if (!bucket.remove(res))
         {
-            if ((*it).second == res)
-            {
-                it = list.erase(it);
-#if SL_DEBUG_RESOURCE_POOL
-                count++;
-                continue;
-#else
-                break;
-#endif
-            }
-            it++;
+            SL_LOG_ERROR("Resource 0x%llx recycled but not allocated from this pool", res.getNative());
+            return;
         }
 #if SL_DEBUG_RESOURCE_POOL
-        assert(count == 1);
-        for (auto& [timestamp, cached] : m_free[res.hash])
+        for (auto& cached : bucket.free)
         {
-            assert(res.resource != cached.resource);
+            assert(res != cached.resource);
         }
 #endif
-        m_free[res.accessHash()].push_back({ std::chrono::system_clock::now(), res });
+        uint32_t frame{};
+        m_compute->getFinishedFrameIndex(frame);
+        // Can only be reused safely once GPU finishes the frame currently in flight
+        bucket.free.push_back({ std::chrono::system_clock::now(), res, frame + 1 });
+        m_cvFree.notify_all();
     }
 
     virtual void clear() override final
     {
         m_compute->beginVRAMSegment(m_vramSegment.c_str());
         std::scoped_lock lock(m_mtx);
-        m_free.clear();
-        m_allocated.clear();
+        m_buckets.clear();
+        m_hashes.clear();
+        m_gcCursor = 0;
         m_compute->endVRAMSegment();
     }
 
     virtual void collectGarbage(float deltaMs = 1000.0f) override final
     {
-        std::scoped_lock lock(m_mtx);
+        std::vector<HashedResource> expired;
+        {
+            std::scoped_lock lock(m_mtx);
+            if (m_hashes.empty()) return;
+
+            // Incremental, visit buckets round-robin until we run out of time for this call.
+            // Free lists are ordered by recycle time so only the front of each one needs checking.
+            auto start = std::chrono::steady_clock::now();
+            auto now = std::chrono::system_clock::now();
+            uint32_t finishedFrame{};
+            m_compute->getFinishedFrameIndex(finishedFrame);
+            for (size_t visited = 0; visited < m_hashes.size(); visited++)
+            {
+                m_gcCursor = m_gcCursor % m_hashes.size();
+                auto hash = m_hashes[m_gcCursor];
+                auto& bucket = m_buckets[hash];
+                while (!bucket.free.empty())
+                {
+                    std::chrono::duration<float, std::milli> deltaSinceLastUsed = now - bucket.free.front().timestamp;
+                    if (deltaSinceLastUsed.count() <= deltaMs) break;
+                    expired.push_back(std::move(bucket.free.front().resource));
+                    bucket.free.pop_front();
+                }
+                // Items beyond the recent peak were only needed while more frames were in flight, for example
+                // before the host enabled low latency mode, so they go without waiting for the timeout
+                bucket.rollDemandWindow(finishedFrame);
+                auto demand = bucket.getDemand();
+                while (demand && !bucket.free.empty() && bucket.allocated.size() + bucket.free.size() > demand &&
+                    bucket.free.front().frame <= finishedFrame)
+                {
+                    expired.push_back(std::move(bucket.free.front().resource));
+                    bucket.free.pop_front();
+                }
+#if SL_DEBUG_RESOURCE_POOL
+                SL_LOG_VERBOSE("hash %llu [alloc %llu free %llu]", hash, bucket.allocated.size(), bucket.free.size());
+#endif
+                // Descriptions which are no longer requested (resolution changes, retired tags) leave empty buckets behind
+                if (bucket.allocated.empty() && bucket.free.empty() && !bucket.waiters && !demand)
+                {
+                    m_buckets.erase(hash);
+                    m_hashes[m_gcCursor] = m_hashes.back();
+                    m_hashes.pop_back();
+                    if (m_hashes.empty()) break;
+                }
+                else
+                {
+                    m_gcCursor++;
+                }
+                std::chrono::duration<float, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+                if (elapsed.count() > kGarbageCollectionBudgetUs) break;
+            }
+        }
+        // Actual release happens outside of the lock so allocate/recycle are not blocked by it
         m_compute->beginVRAMSegment(m_vramSegment.c_str());
-        auto it = m_free.begin();
-        while (it != m_free.end())
+        expired.clear();
+        m_compute->endVRAMSegment();
+    }
+
+    virtual void setEvictionPriority(uint32_t priority) override final
+    {
+        m_priority = priority;
+    }
+
+    virtual uint32_t getEvictionPriority() const override final
+    {
+        return m_priority;
+    }
+
+    virtual uint64_t trim(uint64_t bytes) override final
+    {
+        uint64_t released = 0;
+        std::vector<HashedResource> evicted;
         {
-            auto it1 = (*it).second.begin();
-            while (it1 != (*it).second.end())
+            std::scoped_lock lock(m_mtx);
+            while (released < bytes)
             {
-                auto& [timestamp, resource] = (*it1);
+                // Least recently used across all buckets, front of each free list is its oldest item
+                Bucket* oldest{};
+                for (auto& [hash, bucket] : m_buckets)
                 {
-                    std::chrono::duration<float, std::milli> deltaSinceLastUsed = std::chrono::system_clock::now() - timestamp;
-                    if (deltaSinceLastUsed.count() > deltaMs)
+                    if (!bucket.free.empty() && (!oldest || bucket.free.front().timestamp < oldest->free.front().timestamp))
                     {
-                        it1 = (*it).second.erase(it1);
-                        continue;
+                        oldest = &bucket;
                     }
                 }
-                it1++;
+                if (!oldest) break;
+                released += oldest->resourceBytes;
+                evicted.push_back(std::move(oldest->free.front().resource));
+                oldest->free.pop_front();
             }
-#if SL_DEBUG_RESOURCE_POOL
-            for (auto& [hash, list] : m_allocated)
+        }
+        if (!evicted.empty())
+        {
+            SL_LOG_INFO("Trimmed %llu resource(s) %.2fMB from pool '%s'", (uint64_t)evicted.size(), released / (1024.0 * 1024.0), m_vramSegment.c_str());
+            m_compute->beginVRAMSegment(m_vramSegment.c_str());
+            evicted.clear();
+            m_compute->endVRAMSegment();
+        }
+        return released;
+    }
+
+    //! Tagged sources are allocated from every frame, their description is queried once per tracking generation
+    void getSourceDescription(Resource source, ResourceDescription& desc)
+    {
+        uint64_t generation{};
+        if (m_compute->getTrackedResourceGeneration(source, generation) != ComputeStatus::eOk)
+        {
+            m_compute->getResourceDescription(source, desc);
+            return;
+        }
+        {
+            std::scoped_lock lock(m_descMtx);
+            auto it = m_sourceDescs.find(source->native);
+            if (it != m_sourceDescs.end() && it->second.generation == generation)
             {
-                if (hash == (*it).first)
-                {
-                    SL_LOG_VERBOSE("hash %llu [alloc %llu free %llu]", hash, list.size(), (*it).second.size());
-                    break;
-                }
+                desc = it->second.desc;
+                return;
             }
-#endif
-            it++;
         }
-        m_compute->endVRAMSegment();
+        m_compute->getResourceDescription(source, desc);
+        std::scoped_lock lock(m_descMtx);
+        if (m_sourceDescs.size() >= kMaxSourceDescriptions)
+        {
+            m_sourceDescs.clear();
+        }
+        m_sourceDescs[source->native] = { generation, desc };
     }
 
     uint64_t getHash(const ResourceDescription& desc) const
@@ -306,17 +458,109 @@ struct ResourcePool : IResourcePool
         return hash;
     };
 
+    //! Free item along with the frame after which GPU is no longer using it
+    struct FreeResource
+    {
+        std::chrono::system_clock::time_point timestamp;
+        HashedResource resource;
+        uint32_t frame;
+    };
+
+    //! All resources with the same hash, allocated items know their own index
+    //! so they can be removed by swapping with the last one.
+    struct Bucket
+    {
+        std::vector<TimestampedResource> allocated;
+        std::deque<FreeResource> free;
+        //! Same hash means same description so this is shared by all items
+        uint64_t resourceBytes = 0;
+        //! Peak number of items in use during the current and previous demand window
+        uint32_t peakInUse = 0;
+        uint32_t prevPeakInUse = 0;
+        uint32_t windowFrame = 0;
+        //! Threads waiting in 'allocate' with a reference to this bucket, it is not pruned until they are done
+        uint32_t waiters = 0;
+
+        void rollDemandWindow(uint32_t frame)
+        {
+            if (frame - windowFrame >= kDemandWindowFrames)
+            {
+                // Nothing was requested for a whole window, treat the previous one as stale too
+                prevPeakInUse = frame - windowFrame >= 2 * kDemandWindowFrames ? 0 : peakInUse;
+                peakInUse = 0;
+                windowFrame = frame;
+            }
+        }
+
+        //! Called on every allocation, number of items in use follows the CPU to GPU frame lag
+        void trackDemand(uint32_t frame)
+        {
+            rollDemandWindow(frame);
+            peakInUse = std::max(peakInUse, (uint32_t)allocated.size());
+        }
+
+        //! Items worth keeping around, zero if the bucket was not used recently and only the timeout applies
+        uint32_t getDemand() const
+        {
+            return std::max(peakInUse, prevPeakInUse);
+        }
+
+        void push(HashedResource& res)
+        {
+            res.accessPoolSlot() = (uint32_t)allocated.size();
+            allocated.push_back({ std::chrono::system_clock::now(), res });
+        }
+
+        bool remove(HashedResource& res)
+        {
+            auto slot = res.accessPoolSlot();
+            if (slot >= allocated.size() || !(allocated[slot].second == res)) return false;
+            if (slot + 1 != allocated.size())
+            {
+                allocated[slot] = std::move(allocated.back());
+                allocated[slot].second.accessPoolSlot() = slot;
+            }
+            allocated.pop_back();
+            res.accessPoolSlot() = UINT32_MAX;
+            return true;
+        }
+    };
+
+    Bucket& getBucket(uint64_t hash)
+    {
+        auto [it, inserted] = m_buckets.try_emplace(hash);
+        if (inserted)
+        {
+            m_hashes.push_back(hash);
+        }
+        return it->second;
+    }
+
     std::mutex m_mtx{};
+    std::condition_variable m_cvFree{};
     //! Some basic default, must be set to a reasonable value based on the use-case
     std::atomic<size_t> m_maxQueueSize = 2; 
+    std::atomic<uint32_t> m_priority = 0;
     ICompute* m_compute{};
     std::string m_vramSegment{};
-    std::map<uint64_t, std::vector<TimestampedResource>> m_free{};
-    std::map<uint64_t, std::vector<TimestampedResource>> m_allocated{};
+    extra::IPerfStats* m_perfStats{};
+    //! Node based so bucket references remain valid while waiting in allocate, empty buckets are pruned in 'collectGarbage'
+    std::unordered_map<uint64_t, Bucket> m_buckets{};
+    std::vector<uint64_t> m_hashes{};
+    size_t m_gcCursor = 0;
+    //! Description of a tracked source along with the generation it was queried for, see 'ICompute::getTrackedResourceGeneration'
+    struct SourceDescription
+    {
+        uint64_t generation{};
+        ResourceDescription desc{};
+    };
+    std::mutex m_descMtx{};
+    std::unordered_map<void*, SourceDescription> m_sourceDescs{};
 };
 
 ResourceState HashedResource::s_invalidState{};
 uint64_t HashedResource::s_invalidHash{};
+uint32_t HashedResource::s_invalidPoolSlot = UINT32_MAX;
 
 ComputeStatus Generic::genericPostInit()
 {
@@ -324,42 +568,234 @@ ComputeStatus Generic::genericPostInit()
     return ComputeStatus::eOk;
 }
 
+std::wstring Generic::getPipelineCachePath(const wchar_t* extension)
+{
+    // One cache per executable, driver mismatches are detected on load by the API itself
+    std::wstring path = std::wstring(file::getTmpPath()) + L"/sl.cache";
+    if (!file::createDirectoryRecursively(path.c_str()))
+    {
+        return {};
+    }
+    return path + L"/" + file::getExecutableName() + extension;
+}
+
+ComputeStatus Generic::allocateUpload(uint64_t size, uint64_t alignment, Resource& buffer, uint64_t& offset)
+{
+    std::scoped_lock lock(m_mutexUploadRing);
+
+    auto& ring = m_uploadRing;
+    if (!ring.buffer)
+    {
+        ResourceDescription desc((uint32_t)kUploadRingSize, 1, eFormatINVALID, HeapType::eHeapTypeUpload, ResourceState::eUnknown);
+        CHI_CHECK(createBuffer(desc, ring.buffer, "sl.chi.uploadRing"));
+    }
+
+    if (!ring.space.allocate(size, alignment, m_finishedFrame, offset))
+    {
+        SL_LOG_WARN("Upload ring cannot fit %llu bytes, using a temporary staging buffer", size);
+        ResourceDescription desc((uint32_t)size, 1, eFormatINVALID, HeapType::eHeapTypeUpload, ResourceState::eUnknown);
+        CHI_CHECK(createBuffer(desc, buffer, "sl.chi.uploadTemp"));
+        // Deferred so it outlives the copy recorded by the caller
+        destroyResource(buffer, kUploadFrameDelay);
+        offset = 0;
+        return ComputeStatus::eOk;
+    }
+    buffer = ring.buffer;
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus Generic::uploadToBuffer(CommandList cmdList, const void* data, uint64_t size, Resource target, uint64_t dstOffset)
+{
+    if (!cmdList || !data || !target)
+    {
+        return ComputeStatus::eInvalidArgument;
+    }
+    Resource staging{};
+    uint64_t offset = 0;
+    CHI_CHECK(allocateUpload(size, 16, staging, offset));
+    return copyHostToDeviceBuffer(cmdList, size, data, staging, target, offset, dstOffset);
+}
+
+ComputeStatus Generic::notifyOnFence(Fence fence, uint64_t syncValue, std::function<void(void)> callback)
+{
+    if (!fence || !callback)
+    {
+        return ComputeStatus::eInvalidArgument;
+    }
+    std::scoped_lock lock(m_mutexFenceCallbacks);
+    if (m_fenceCallbackQuit)
+    {
+        return ComputeStatus::eNotReady;
+    }
+    m_fenceCallbacks.push_back({ fence, syncValue, callback });
+    if (!m_fenceCallbackThread.joinable())
+    {
+        m_fenceCallbackThread = std::thread(&Generic::fenceCallbackThread, this);
+#if defined(SL_WINDOWS)
+        SetThreadDescription(m_fenceCallbackThread.native_handle(), L"sl.chi.fenceCallbacks");
+#endif
+    }
+    m_cvFenceCallbacks.notify_one();
+    return ComputeStatus::eOk;
+}
+
+void Generic::fenceCallbackThread()
+{
+    std::vector<Fence> fences;
+    std::vector<uint64_t> values;
+    std::vector<std::function<void(void)>> ready;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutexFenceCallbacks);
+            m_cvFenceCallbacks.wait(lock, [this]()->bool { return m_fenceCallbackQuit || !m_fenceCallbacks.empty(); });
+            if (m_fenceCallbackQuit) break;
+        }
+
+        {
+            // Anything still registered while we hold this cannot be destroyed, see 'dropFenceCallbacks'
+            std::scoped_lock waitLock(m_mutexFenceCallbackWait);
+            fences.clear();
+            values.clear();
+            {
+                std::scoped_lock lock(m_mutexFenceCallbacks);
+                for (auto& entry : m_fenceCallbacks)
+                {
+                    fences.push_back(entry.fence);
+                    values.push_back(entry.syncValue);
+                }
+            }
+            if (fences.empty()) continue;
+
+            if (waitCPUFences(fences.data(), values.data(), (uint32_t)fences.size(), true, kFenceCallbackWaitMs) == WaitStatus::eError)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(kFenceCallbackWaitMs));
+            }
+
+            // Registrations which arrived during the wait are checked too, values are queried once per fence
+            std::map<Fence, uint64_t> completed;
+            std::scoped_lock lock(m_mutexFenceCallbacks);
+            auto it = m_fenceCallbacks.begin();
+            while (it != m_fenceCallbacks.end())
+            {
+                auto value = completed.find((*it).fence);
+                if (value == completed.end())
+                {
+                    value = completed.insert({ (*it).fence, getCompletedValue((*it).fence) }).first;
+                }
+                if ((*value).second >= (*it).syncValue)
+                {
+                    ready.push_back(std::move((*it).callback));
+                    it = m_fenceCallbacks.erase(it);
+                    continue;
+                }
+                it++;
+            }
+        }
+
+        // No locks held so callbacks are free to register more work or destroy their fences
+        for (auto& callback : ready)
+        {
+            callback();
+        }
+        ready.clear();
+    }
+}
+
+void Generic::dropFenceCallbacks(Fence fence)
+{
+    if (!fence) return;
+    {
+        std::scoped_lock lock(m_mutexFenceCallbacks);
+        auto it = std::remove_if(m_fenceCallbacks.begin(), m_fenceCallbacks.end(), [fence](const FenceCallback& entry)->bool { return entry.fence == fence; });
+        if (it == m_fenceCallbacks.end()) return;
+        m_fenceCallbacks.erase(it, m_fenceCallbacks.end());
+    }
+    // Wait for the thread to stop using it, an in flight wait times out quickly
+    std::scoped_lock waitLock(m_mutexFenceCallbackWait);
+}
+
+void Generic::shutdownFenceCallbacks()
+{
+    {
+        std::scoped_lock lock(m_mutexFenceCallbacks);
+        m_fenceCallbackQuit = true;
+        if (!m_fenceCallbacks.empty())
+        {
+            SL_LOG_WARN("Dropping %llu pending fence callbacks", (uint64_t)m_fenceCallbacks.size());
+        }
+        m_fenceCallbacks.clear();
+    }
+    m_cvFenceCallbacks.notify_all();
+    if (m_fenceCallbackThread.joinable())
+    {
+        m_fenceCallbackThread.join();
+    }
+}
+
 ComputeStatus Generic::init(Device device, param::IParameters* params)
 {
     m_parameters = params;
     m_typelessDevice = device;
+    {
+        std::scoped_lock lock(m_mutexFenceCallbacks);
+        m_fenceCallbackQuit = false;
+    }
     params->get(sl::param::global::kPreferenceFlags, (uint64_t*)&m_preferenceFlags);
+    param::getPointerParam(params, param::global::kStartupTimeline, &m_startupTimeline);
+    param::getPointerParam(params, param::global::kPerfStats, &m_perfStats);
+    param::getPointerParam(params, param::global::kGPUMarkers, &m_gpuMarkers);
     return ComputeStatus::eOk;
 }
 
 ComputeStatus Generic::shutdown()
 {
+    // Pending image dumps must land before the module goes away
+    thread::getSharedIOQueue().flush();
+
+    shutdownFenceCallbacks();
     Generic::clearCache();
 
-    // Release any tracked resources
+    // Back buffers belong to the host swap-chains, only our references go away
     {
-        std::scoped_lock lock(m_mutexResourceTrack);
-        for (auto cachedResource : m_resourceTrackMap)
+        std::map<SwapChain, std::vector<Resource>> swapChainBuffers;
         {
-            ((IUnknown*)cachedResource.second)->Release();
+            std::scoped_lock lock(m_mutexSwapChainBuffers);
+            swapChainBuffers.swap(m_swapChainBuffers);
         }
-        m_resourceTrackMap.clear();
-
-        for (auto& frameResourceMap : m_frameResourceTrackingMap)
+        for (auto& [chain, buffers] : swapChainBuffers)
         {
-            for (auto& cachedResource : frameResourceMap.second)
+            for (auto buffer : buffers)
             {
-                ((IUnknown*)cachedResource.second)->Release();
-                cachedResource.second = nullptr;
+                if (buffer) destroyResource(buffer, 0);
             }
-            frameResourceMap.second.clear();
         }
-        m_frameResourceTrackingMap.clear();
+    }
+
+    if (m_uploadRing.buffer)
+    {
+        destroyResource(m_uploadRing.buffer, 0);
+    }
+    m_uploadRing = {};
+
+    // Release any tracked resources
+    {
+        std::scoped_lock lock(m_mutexResourceTrack);
+        auto release = [this](IUnknown* res)->void { unpinTrackedResource(res); };
+        m_resourceTracking.reset(UINT_MAX, release);
+        for (auto& table : m_frameResourceTracking)
+        {
+            table.reset(UINT_MAX, release);
+        }
     }
 
     CHI_CHECK(collectGarbage(UINT_MAX));
-    SL_LOG_INFO("Delayed destroy resource list count %llu", m_resourcesToDestroy.size());
-    m_vramSegments.clear();
+    SL_LOG_INFO("Delayed destroy resource list count %llu", m_pendingDestruction.size());
+    for (auto& seg : m_vramSegments)
+    {
+        seg.allocCount = 0;
+        seg.totalAllocatedSize = 0;
+    }
 
     return ComputeStatus::eOk;
 }
@@ -367,16 +803,128 @@ ComputeStatus Generic::shutdown()
 ComputeStatus Generic::clearCache()
 {
     // Release shared resources
-    for (auto& [original, shared] : m_sharedResourceMap)
     {
-        if (shared.source != shared.translated)
+        std::scoped_lock lock(m_mutexSharedResource);
+        for (auto& [original, shared] : m_sharedResourceMap)
+        {
+            releaseSharedResource(shared);
+        }
+        m_sharedResourceMap.clear();
+    }
+    {
+        // Notifiers still attached to live sources report ids which no longer match anything
+        std::scoped_lock lock(m_sharedResourceRetireList->mutex);
+        m_sharedResourceRetireList->retired.clear();
+    }
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus Generic::cacheSwapChainBuffers(SwapChain chain, uint32_t bufferCount)
+{
+    CHI_CHECK(releaseSwapChainBuffers(chain));
+
+    std::vector<Resource> buffers(bufferCount);
+    for (uint32_t i = 0; i < bufferCount; i++)
+    {
+        auto status = getSwapChainBuffer(chain, i, buffers[i]);
+        if (status != ComputeStatus::eOk)
         {
-            destroySharedHandle(shared.handle);
-            destroyResource(shared.translated);
-            destroyResource(shared.clone);
+            for (auto buffer : buffers)
+            {
+                if (buffer) destroyResource(buffer, 0);
+            }
+            return status;
+        }
+    }
+
+    std::scoped_lock lock(m_mutexSwapChainBuffers);
+    m_swapChainBuffers[chain] = std::move(buffers);
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus Generic::getCachedSwapChainBuffer(SwapChain chain, uint32_t index, Resource& buffer)
+{
+    std::scoped_lock lock(m_mutexSwapChainBuffers);
+    auto& buffers = m_swapChainBuffers[chain];
+    if (index < buffers.size() && buffers[index])
+    {
+        buffer = buffers[index];
+        return ComputeStatus::eOk;
+    }
+    // Swap-chain was never resized while SL was loaded, wrap this buffer once and keep it
+    if (index >= buffers.size())
+    {
+        buffers.resize(index + 1);
+    }
+    CHI_CHECK(getSwapChainBuffer(chain, index, buffers[index]));
+    buffer = buffers[index];
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus Generic::releaseSwapChainBuffers(SwapChain chain)
+{
+    std::vector<Resource> buffers;
+    {
+        std::scoped_lock lock(m_mutexSwapChainBuffers);
+        auto it = m_swapChainBuffers.find(chain);
+        if (it == m_swapChainBuffers.end())
+        {
+            return ComputeStatus::eOk;
+        }
+        buffers = std::move(it->second);
+        m_swapChainBuffers.erase(it);
+    }
+    // Not deferred, resize and destroy fail or leak while any reference to a back buffer is alive
+    for (auto buffer : buffers)
+    {
+        if (buffer) destroyResource(buffer, 0);
+    }
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus Generic::clearViews(CommandList cmdList, ClearRequest* requests, uint32_t count)
+{
+    if (!cmdList || (count && !requests))
+    {
+        return ComputeStatus::eInvalidArgument;
+    }
+    std::vector<ResourceTransition> transitions;
+    transitions.reserve(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (!requests[i].resource)
+        {
+            return ComputeStatus::eInvalidArgument;
+        }
+        transitions.push_back({ requests[i].resource, ResourceState::eStorageRW });
+    }
+    CHI_CHECK(transitionResources(cmdList, transitions.data(), count));
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto& request = requests[i];
+        CHI_CHECK(clearView(cmdList, request.resource, request.color, request.rects, request.numRects, request.type));
+    }
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus Generic::createResources(ResourceBatchEntry* entries, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto& entry = entries[i];
+        auto status = entry.type == ResourceType::eBuffer ? createBuffer(entry.desc, entry.resource, entry.name) : createTexture2D(entry.desc, entry.resource, entry.name);
+        if (status != ComputeStatus::eOk)
+        {
+            SL_LOG_ERROR("Failed to create '%s' (%u of %u in batch)", entry.name, i + 1, count);
+            for (uint32_t j = 0; j < i; j++)
+            {
+                destroyResource(entries[j].resource, 0);
+                entries[j].resource = {};
+            }
+            entry.resource = {};
+            return status;
         }
     }
-    m_sharedResourceMap.clear();
     return ComputeStatus::eOk;
 }
 
@@ -403,26 +951,36 @@ ComputeStatus Generic::getVendorId(VendorId& id)
 
 ComputeStatus Generic::startTrackingResource(uint64_t uid, Resource resource)
 {
+    // Fast path, host keeps tagging the same resource every frame so nothing to do
+    if (m_resourceTracking.find(uid) == resource->native)
+    {
+        return ComputeStatus::eOk;
+    }
+
     // Make sure we are thread safe
     std::scoped_lock lock(m_mutexResourceTrack);
 
     // NOTE: This covers d3d11/d3d12, VK currently does NOP here
-    auto it = m_resourceTrackMap.find(uid);
-    IUnknown* cachedResource = (it == m_resourceTrackMap.end()) ? nullptr : it->second;
+    IUnknown* cachedResource = m_resourceTracking.find(uid);
     if (cachedResource)
     {
         if (cachedResource != resource->native)
         {
             // Note that here we could easily hold last reference and that is fine, host destroys tag and calls setTag(newTag)
-            cachedResource->Release();
+            unpinTrackedResource(cachedResource);
             cachedResource = nullptr;
         }
     }
     if (!cachedResource)
     {
         cachedResource = (IUnknown*)(resource->native);
-        auto refCount = cachedResource->AddRef();
-        m_resourceTrackMap[uid] = cachedResource;
+        IUnknown* previous{};
+        if (!m_resourceTracking.insert(uid, cachedResource, previous))
+        {
+            SL_LOG_ERROR("Too many resources tracked, unable to track tag uid 0x%llx", uid);
+            return ComputeStatus::eError;
+        }
+        auto refCount = pinTrackedResource(cachedResource);
         //std::wstring name = getDebugName(cachedResource);
         //SL_LOG_VERBOSE("Start tracking 0x%llx '%S' ref count %d", cachedResource, name.c_str(), refCount);
     }
@@ -437,13 +995,29 @@ ComputeStatus Generic::startTrackingResource(uint32_t frameId, uint64_t uid, Res
         std::scoped_lock lock(m_mutexResourceTrack);
         
         // NOTE: This covers d3d11/d3d12, VK currently does NOP here
-        auto cachedResource = (IUnknown*)(resource->native);
-        auto refCount = cachedResource->AddRef();
-        m_frameResourceTrackingMap[frameId][uid] = cachedResource;
+        auto& table = m_frameResourceTracking[frameId % kResourceTrackingFrameSlots];
+        if (table.frameId.load(std::memory_order_relaxed) != frameId)
+        {
+            // Frames must release their tags long before the slot comes around again, anything left is stale
+            if (table.count)
+            {
+                SL_LOG_WARN("Frame %u still tracks %u resource(s) while frame %u is being tagged, releasing them", table.frameId.load(), table.count, frameId);
+            }
+            table.reset(frameId, [this](IUnknown* res)->void { unpinTrackedResource(res); });
+        }
 
-        // frames must be deleted from this map, otherwise it would grow infinitely
-        constexpr uint32_t InsaneNumberOfFramesInFlight = 30;
-        assert(m_frameResourceTrackingMap.size() < InsaneNumberOfFramesInFlight);
+        auto cachedResource = (IUnknown*)(resource->native);
+        IUnknown* previous{};
+        if (!table.insert(uid, cachedResource, previous))
+        {
+            SL_LOG_ERROR("Too many resources tracked for frame %u, unable to track tag uid 0x%llx", frameId, uid);
+            return ComputeStatus::eError;
+        }
+        auto refCount = pinTrackedResource(cachedResource);
+        if (previous)
+        {
+            unpinTrackedResource(previous);
+        }
         //std::wstring name = getDebugName(cachedResource);
         //SL_LOG_VERBOSE("Start tracking 0x%llx '%S' ref count %d", cachedResource, name.c_str(), refCount);
     }
@@ -453,37 +1027,43 @@ ComputeStatus Generic::startTrackingResource(uint32_t frameId, uint64_t uid, Res
 
 ComputeStatus Generic::stopTrackingResource(uint64_t id, Resource dbgResource)
 {
+    // Fast path, nothing tracked for this tag
+    if (!m_resourceTracking.find(id))
+    {
+        return ComputeStatus::eOk;
+    }
+
     // Make sure we are thread safe
     std::scoped_lock lock(m_mutexResourceTrack);
 
     // NOTE: This covers d3d11/d3d12, VK currently does NOP here
-    ResourceTrackingMap::const_iterator it = m_resourceTrackMap.find(id);
-    IUnknown* cachedResource = (it == m_resourceTrackMap.end()) ? nullptr : it->second;
+    IUnknown* cachedResource = m_resourceTracking.erase(id);
     if (cachedResource)
     {
         assert(cachedResource == dbgResource->native ||
             dbgResource->native == nullptr); // startTracking() and stopTracking() is called for different resources?
         // Note that here we could easily hold last reference and that is fine, host destroys tag and calls setTag(null)
-        cachedResource->Release();
-        m_resourceTrackMap.erase(it);
+        unpinTrackedResource(cachedResource);
     }
     return ComputeStatus::eOk;
 }
 
 ComputeStatus Generic::stopTrackingResource(uint32_t frameId, uint64_t id, Resource dbgResource)
 {
+    // Fast path, nothing tracked for this tag in this frame
+    auto& table = m_frameResourceTracking[frameId % kResourceTrackingFrameSlots];
+    if (!table.find(id, frameId))
+    {
+        return ComputeStatus::eOk;
+    }
+
     // Make sure we are thread safe
     std::scoped_lock lock(m_mutexResourceTrack);
 
     IUnknown* cachedResource{};
-    std::map<uint32_t, ResourceTrackingMap>::const_iterator frameMapIt{};
-    ResourceTrackingMap::const_iterator resourceMapIt{};
-    if (frameMapIt = m_frameResourceTrackingMap.find(frameId); frameMapIt != m_frameResourceTrackingMap.end())
+    if (table.frameId.load(std::memory_order_relaxed) == frameId)
     {
-        if (resourceMapIt = m_frameResourceTrackingMap[frameId].find(id); resourceMapIt != m_frameResourceTrackingMap[frameId].end())
-        {
-            cachedResource = m_frameResourceTrackingMap[frameId][id];
-        }
+        cachedResource = table.erase(id);
     }
 
     if (cachedResource != nullptr)
@@ -492,18 +1072,47 @@ ComputeStatus Generic::stopTrackingResource(uint32_t frameId, uint64_t id, Resou
             dbgResource->native == nullptr); // startTracking() and stopTracking() is called for different resources?
         // Note that here we could easily hold last reference and that is fine, host destroys tag and calls setTag(null)
         // NOTE: This covers d3d11/d3d12, VK currently does NOP here
-        cachedResource->Release();
-        cachedResource = m_frameResourceTrackingMap[frameId][id] = nullptr;
-        m_frameResourceTrackingMap[frameId].erase(resourceMapIt);
-        if (m_frameResourceTrackingMap[frameId].empty())
-        {
-            m_frameResourceTrackingMap.erase(frameMapIt);
-        }
+        unpinTrackedResource(cachedResource);
     }
 
     return ComputeStatus::eOk;
 }
 
+ComputeStatus Generic::getTrackedResourceGeneration(Resource resource, uint64_t& generation)
+{
+    if (!resource || !resource->native) return ComputeStatus::eInvalidArgument;
+
+    std::scoped_lock lock(m_mutexResourceTrack);
+    auto it = m_trackedPins.find(resource->native);
+    if (it == m_trackedPins.end())
+    {
+        return ComputeStatus::eError;
+    }
+    generation = it->second.generation;
+    return ComputeStatus::eOk;
+}
+
+ULONG Generic::pinTrackedResource(IUnknown* resource)
+{
+    auto& pin = m_trackedPins[resource];
+    if (pin.count++ == 0)
+    {
+        pin.generation = ++m_trackedGeneration;
+    }
+    return resource->AddRef();
+}
+
+ULONG Generic::unpinTrackedResource(IUnknown* resource)
+{
+    // Once the last reference is gone the pointer can be recycled by the host for a different resource
+    auto it = m_trackedPins.find(resource);
+    if (it != m_trackedPins.end() && --it->second.count == 0)
+    {
+        m_trackedPins.erase(it);
+    }
+    return resource->Release();
+}
+
 void Generic::setResourceTracked(chi::Resource resource, uint64_t tracked)
 {
     assert(m_platform != RenderAPI::eVulkan);
@@ -580,108 +1189,413 @@ ComputeStatus Generic::getResourceState(Resource resource, ResourceState& state)
         return ComputeStatus::eOk;
     }
 
-    state = ResourceState::eGeneral;
-    if (m_platform == RenderAPI::eD3D11)
+    state = ResourceState::eGeneral;
+    if (m_platform == RenderAPI::eD3D11)
+    {
+        return ComputeStatus::eOk;
+    }
+    return getResourceState(resource->state, state);
+}
+
+ComputeStatus Generic::transitionResources(CommandList cmdList, const ResourceTransition* transitions, uint32_t count, extra::ScopedTasks* scopedTasks)
+{
+    if (!cmdList)
+    {
+        return ComputeStatus::eInvalidArgument;
+    }
+
+    // All these cases are OK, nothing to do here
+    if (!transitions || count == 0 || m_platform == RenderAPI::eD3D11)
+    {
+        return ComputeStatus::eOk;
+    }
+
+    std::vector<ResourceTransition> transitionList;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto tr = transitions[i];
+        if (tr.from == ResourceState::eUnknown)
+        {
+            getResourceState(tr.fromNativeState, tr.from);
+        }
+        if (!tr.resource || !tr.resource->native || (tr.from & tr.to) != 0)
+        {
+            continue;
+        }
+
+        if (tr.from != ResourceState::eUnknown)
+        {
+            if (std::find(transitionList.begin(), transitionList.end(), tr) == transitionList.end())
+            {
+                transitionList.push_back(tr);
+            }
+        }
+        else
+        {
+            SL_LOG_ERROR("From/to states must be provided");
+            return ComputeStatus::eNotSupported;
+        }
+    }
+
+    if (transitionList.empty()) return ComputeStatus::eOk;
+
+    if (scopedTasks)
+    {
+        auto lambda = [this, cmdList, transitionList](void) -> void
+        {
+            std::vector<ResourceTransition> revTransitionList;
+            for (auto& tr : transitionList)
+            {
+                if (chi::ResourceState(tr.from & tr.to) & chi::ResourceState::eStorageRW)
+                {
+                    // to and from states are UAV which means we need to insert barrier on scope exit to make sure writes are done
+                    insertGPUBarrier(cmdList, tr.resource);
+                }
+                revTransitionList.push_back(ResourceTransition(tr.resource, tr.from, tr.to));
+            }
+            if (m_transitionBatchCount.load() > 0)
+            {
+                // Going back is only needed once someone else uses these resources, hold on to it
+                deferTransitions(cmdList, revTransitionList);
+            }
+            else
+            {
+                transitionResources(cmdList, revTransitionList.data(), (uint32_t)revTransitionList.size());
+            }
+        };
+        scopedTasks->tasks.push_back(lambda);
+    }
+
+    if (m_transitionBatchCount.load() > 0)
+    {
+        std::scoped_lock lock(m_mutexTransitionBatch);
+        auto it = m_transitionBatches.find(cmdList);
+        if (it != m_transitionBatches.end())
+        {
+            return resolveTransitionBatch(cmdList, (*it).second, transitionList);
+        }
+    }
+
+    return transitionResourceImpl(cmdList, transitionList.data(), (uint32_t)transitionList.size());
+}
+
+ComputeStatus Generic::transitionResourceSplitImpl(CommandList cmdList, const ResourceTransition* transitions, const BarrierSplit* splits, uint32_t count)
+{
+    // No split barriers, beginning is a nop and ending is a regular transition
+    std::vector<ResourceTransition> transitionList;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (splits[i] != BarrierSplit::eBegin)
+        {
+            transitionList.push_back(transitions[i]);
+        }
+    }
+    if (transitionList.empty()) return ComputeStatus::eOk;
+    return transitionResourceImpl(cmdList, transitionList.data(), (uint32_t)transitionList.size());
+}
+
+ComputeStatus Generic::beginTransitionBatch(CommandList cmdList)
+{
+    if (!cmdList) return ComputeStatus::eInvalidArgument;
+    if (m_platform == RenderAPI::eD3D11) return ComputeStatus::eOk;
+    std::scoped_lock lock(m_mutexTransitionBatch);
+    auto& batch = m_transitionBatches[cmdList];
+    if (batch.depth++ == 0)
     {
-        return ComputeStatus::eOk;
+        m_transitionBatchCount++;
     }
-    return getResourceState(resource->state, state);
+    return ComputeStatus::eOk;
 }
 
-ComputeStatus Generic::transitionResources(CommandList cmdList, const ResourceTransition* transitions, uint32_t count, extra::ScopedTasks* scopedTasks)
+ComputeStatus Generic::endTransitionBatch(CommandList cmdList)
 {
-    if (!cmdList)
+    if (!cmdList) return ComputeStatus::eInvalidArgument;
+    if (m_platform == RenderAPI::eD3D11) return ComputeStatus::eOk;
+    std::scoped_lock lock(m_mutexTransitionBatch);
+    auto it = m_transitionBatches.find(cmdList);
+    if (it == m_transitionBatches.end())
     {
+        SL_LOG_ERROR("Transition batch was not started for command list 0x%llx", cmdList);
         return ComputeStatus::eInvalidArgument;
     }
+    auto& batch = (*it).second;
+    if (--batch.depth > 0) return ComputeStatus::eOk;
+
+    // Empty request list flushes everything
+    auto res = resolveTransitionBatch(cmdList, batch, {});
+    m_transitionBatches.erase(it);
+    m_transitionBatchCount--;
+    return res;
+}
 
-    // All these cases are OK, nothing to do here
-    if (!transitions || count == 0 || m_platform == RenderAPI::eD3D11)
+ComputeStatus Generic::deferTransitions(CommandList cmdList, const std::vector<ResourceTransition>& transitions)
+{
     {
-        return ComputeStatus::eOk;
+        std::scoped_lock lock(m_mutexTransitionBatch);
+        auto it = m_transitionBatches.find(cmdList);
+        if (it != m_transitionBatches.end())
+        {
+            auto& batch = (*it).second;
+            for (auto& tr : transitions)
+            {
+                batch.pending.push_back({ tr, batch.step, false });
+            }
+            return ComputeStatus::eOk;
+        }
     }
+    // Batch on this command list was closed before the scope ended, nothing to fold into
+    return transitionResources(cmdList, transitions.data(), (uint32_t)transitions.size());
+}
 
-    std::vector<ResourceTransition> transitionList;
-    for (uint32_t i = 0; i < count; i++)
+ComputeStatus Generic::resolveTransitionBatch(CommandList cmdList, TransitionBatch& batch, const std::vector<ResourceTransition>& requests)
+{
+    // Pending transitions which must complete before the requested ones
+    std::vector<ResourceTransition> before;
+    std::vector<BarrierSplit> beforeSplits;
+    std::vector<ResourceTransition> barriers;
+    std::vector<BarrierSplit> splits;
+
+    auto& pending = batch.pending;
+    for (auto tr : requests)
     {
-        auto tr = transitions[i];
-        if (tr.from == ResourceState::eUnknown)
-        {
-            getResourceState(tr.fromNativeState, tr.from);
-        }
-        if (!tr.resource || !tr.resource->native || (tr.from & tr.to) != 0)
+        // All pending transitions for this resource in the order they were recorded
+        std::vector<PendingTransition> matches;
+        auto it = pending.begin();
+        while (it != pending.end())
         {
-            continue;
+            if ((*it).transition.resource->native == tr.resource->native)
+            {
+                matches.push_back(*it);
+                it = pending.erase(it);
+                continue;
+            }
+            it++;
         }
 
-        if (tr.from != ResourceState::eUnknown)
+        bool emit = true;
+        if (!matches.empty())
         {
-            if (std::find(transitionList.begin(), transitionList.end(), tr) == transitionList.end())
+            auto& last = matches.back();
+            if (!last.begun && last.transition.subresource == tr.subresource && last.transition.to == tr.from)
             {
-                transitionList.push_back(tr);
+                // Never recorded so A->B followed by B->C is just A->C, round trip back to A is nothing at all
+                tr.from = last.transition.from;
+                emit = (tr.from & tr.to) == 0;
+                matches.pop_back();
+            }
+            // Different subresources or state we did not expect, play it safe and complete these first
+            for (auto& m : matches)
+            {
+                before.push_back(m.transition);
+                beforeSplits.push_back(m.begun ? BarrierSplit::eEnd : BarrierSplit::eNone);
             }
         }
-        else
+        if (emit)
         {
-            SL_LOG_ERROR("From/to states must be provided");
-            return ComputeStatus::eNotSupported;
+            barriers.push_back(tr);
+            splits.push_back(BarrierSplit::eNone);
         }
     }
 
-    if (transitionList.empty()) return ComputeStatus::eOk;
-
-    if (scopedTasks)
+    if (requests.empty())
     {
-        auto lambda = [this, cmdList, transitionList](void) -> void
+        for (auto& p : pending)
         {
-            std::vector<ResourceTransition> revTransitionList;
-            for (auto& tr : transitionList)
+            before.push_back(p.transition);
+            beforeSplits.push_back(p.begun ? BarrierSplit::eEnd : BarrierSplit::eNone);
+        }
+        pending.clear();
+    }
+    else if (m_platform == RenderAPI::eD3D12)
+    {
+        // Not needed for a while so most likely not needed again in this batch, let the GPU start on them
+        for (auto& p : pending)
+        {
+            if (!p.begun && batch.step - p.step >= kSplitBarrierDelay)
             {
-                if (chi::ResourceState(tr.from & tr.to) & chi::ResourceState::eStorageRW)
-                {
-                    // to and from states are UAV which means we need to insert barrier on scope exit to make sure writes are done
-                    insertGPUBarrier(cmdList, tr.resource);
-                }
-                revTransitionList.push_back(ResourceTransition(tr.resource, tr.from, tr.to));
+                barriers.push_back(p.transition);
+                splits.push_back(BarrierSplit::eBegin);
+                p.begun = true;
             }
-            transitionResources(cmdList, revTransitionList.data(), (uint32_t)revTransitionList.size());
-        };
-        scopedTasks->tasks.push_back(lambda);
+        }
     }
+    batch.step++;
 
-    return transitionResourceImpl(cmdList, transitionList.data(), (uint32_t)transitionList.size());
+    // Kept separate since Vulkan does not guarantee ordering within one barrier call for the same subresource
+    if (!before.empty())
+    {
+        CHI_CHECK(transitionResourceSplitImpl(cmdList, before.data(), beforeSplits.data(), (uint32_t)before.size()));
+    }
+    if (!barriers.empty())
+    {
+        CHI_CHECK(transitionResourceSplitImpl(cmdList, barriers.data(), splits.data(), (uint32_t)barriers.size()));
+    }
+    return ComputeStatus::eOk;
+}
+
+uint32_t Generic::findVRAMSegment(const char* name)
+{
+    // Handful of segments so a linear scan beats any map, no locking since published names never change
+    auto count = m_vramSegmentCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        if (m_vramSegmentNames[i] == name) return i;
+    }
+    return UINT32_MAX;
+}
+
+uint32_t Generic::registerVRAMSegment(const char* name)
+{
+    auto id = findVRAMSegment(name);
+    if (id != UINT32_MAX) return id;
+
+    std::scoped_lock lock(m_mutexVRAM);
+    // Someone else could have registered it while we were waiting
+    id = findVRAMSegment(name);
+    if (id != UINT32_MAX) return id;
+    id = m_vramSegmentCount.load(std::memory_order_relaxed);
+    if (id == kMaxVRAMSegments)
+    {
+        SL_LOG_ERROR("Too many VRAM segments, '%s' will be accounted as '%s'", name, kGlobalVRAMSegment);
+        return kGlobalVRAMSegmentId;
+    }
+    m_vramSegmentNames[id] = name;
+    m_vramSegmentCount.store(id + 1, std::memory_order_release);
+    return id;
 }
 
 ComputeStatus Generic::beginVRAMSegment(const char* name)
 {
     if (!name) return ComputeStatus::eInvalidArgument;
-    std::scoped_lock lock(m_mutexVRAM);
-    auto& id = m_currentVRAMSegment[std::this_thread::get_id()];
-    assert(id.empty() || id == kGlobalVRAMSegment);
-    id = name;
+    auto& state = m_vramThreadState.getContext();
+    assert(state.segment == kGlobalVRAMSegmentId);
+    state.segment = registerVRAMSegment(name);
     return ComputeStatus::eOk;
 }
 
 ComputeStatus Generic::endVRAMSegment()
 {
-    std::scoped_lock lock(m_mutexVRAM);
-    auto& id = m_currentVRAMSegment[std::this_thread::get_id()];
-    assert(!id.empty() && id != kGlobalVRAMSegment);
-    id = kGlobalVRAMSegment;
+    auto& state = m_vramThreadState.getContext();
+    assert(state.segment != kGlobalVRAMSegmentId);
+    state.segment = kGlobalVRAMSegmentId;
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus Generic::getVRAMSegmentStats(VRAMSegmentStats* stats, uint32_t& count)
+{
+    auto segmentCount = m_vramSegmentCount.load(std::memory_order_acquire);
+    if (stats)
+    {
+        for (uint32_t i = 0; i < std::min(count, segmentCount); i++)
+        {
+            stats[i].name = m_vramSegmentNames[i].c_str();
+            stats[i].allocCount = m_vramSegments[i].allocCount.load(std::memory_order_relaxed);
+            stats[i].totalAllocatedSize = m_vramSegments[i].totalAllocatedSize.load(std::memory_order_relaxed);
+        }
+    }
+    count = segmentCount;
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus Generic::setVRAMBudget(uint64_t currentUsageBytes, uint64_t budgetBytes)
+{
+    m_vramBudgetBytes.store(budgetBytes);
+    m_vramUsageBytes.store(currentUsageBytes);
+
+    std::scoped_lock lock(m_mutexPools);
+    auto lastBudgetBytes = m_lastVRAMBudgetBytes;
+    m_lastVRAMBudgetBytes = budgetBytes;
+
+    // Unlimited budget means VRAM is not managed, unless low VRAM is being emulated (usage is unlimited as well)
+    if (!m_evictionPolicy.enabled || budgetBytes == 0 || (budgetBytes == UINT64_MAX && currentUsageBytes != UINT64_MAX)) return ComputeStatus::eOk;
+    if (m_evictionCooldown > 0)
+    {
+        m_evictionCooldown--;
+        return ComputeStatus::eOk;
+    }
+
+    auto highBytes = uint64_t(budgetBytes * (double)m_evictionPolicy.highWatermark);
+    auto lowBytes = uint64_t(budgetBytes * (double)m_evictionPolicy.lowWatermark);
+    // Do not wait for the high watermark if OS just took away a chunk of our budget, chances are it will keep dropping
+    auto budgetShrunk = lastBudgetBytes > budgetBytes && (lastBudgetBytes - budgetBytes) > uint64_t(lastBudgetBytes * (double)m_evictionPolicy.budgetShrinkThreshold);
+    if (currentUsageBytes > highBytes || (budgetShrunk && currentUsageBytes > lowBytes))
+    {
+        auto released = evictPoolResources(currentUsageBytes - lowBytes);
+        if (released)
+        {
+            SL_LOG_WARN("VRAM usage %.2fGB budget %.2fGB%s - released %.2fMB from resource pools", currentUsageBytes / (1024.0 * 1024.0 * 1024.0), budgetBytes / (1024.0 * 1024.0 * 1024.0),
+                budgetShrunk ? " (budget shrunk)" : "", released / (1024.0 * 1024.0));
+            m_evictionCooldown = m_evictionPolicy.cooldownFrames;
+        }
+    }
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus Generic::isVRAMOverBudget(bool& overBudget)
+{
+    auto budgetBytes = m_vramBudgetBytes.load();
+    auto usageBytes = m_vramUsageBytes.load();
+
+    std::scoped_lock lock(m_mutexPools);
+    // Same rules as 'setVRAMBudget', usage is unlimited too when low VRAM is being emulated
+    bool managed = m_evictionPolicy.enabled && budgetBytes != 0 && (budgetBytes != UINT64_MAX || usageBytes == UINT64_MAX);
+    overBudget = managed && usageBytes > uint64_t(budgetBytes * (double)m_evictionPolicy.highWatermark);
     return ComputeStatus::eOk;
 }
 
+ComputeStatus Generic::setVRAMEvictionPolicy(const VRAMEvictionPolicy& policy)
+{
+    if (policy.lowWatermark > policy.highWatermark || policy.highWatermark <= 0.0f) return ComputeStatus::eInvalidArgument;
+    std::scoped_lock lock(m_mutexPools);
+    m_evictionPolicy = policy;
+    m_evictionCooldown = 0;
+    return ComputeStatus::eOk;
+}
+
+uint64_t Generic::evictPoolResources(uint64_t bytes)
+{
+    // Lowest priority first, stable so pools with equal priority are trimmed in creation order
+    auto pools = m_pools;
+    std::stable_sort(pools.begin(), pools.end(), [](IResourcePool* a, IResourcePool* b)->bool { return a->getEvictionPriority() < b->getEvictionPriority(); });
+    uint64_t released = 0;
+    for (auto pool : pools)
+    {
+        if (released >= bytes) break;
+        released += pool->trim(bytes - released);
+    }
+    return released;
+}
+
 ComputeStatus Generic::getAllocatedBytes(uint64_t& bytes, const char* name)
 { 
     bytes = {};
-    std::scoped_lock lock(m_mutexVRAM);
-    auto it = m_vramSegments.find(name);
-    if(it == m_vramSegments.end()) return ComputeStatus::eInvalidArgument;
-    auto& seg = (*it).second;
-    bytes = seg.totalAllocatedSize;
+    auto id = findVRAMSegment(name);
+    if (id == UINT32_MAX) return ComputeStatus::eInvalidArgument;
+    bytes = m_vramSegments[id].totalAllocatedSize.load(std::memory_order_relaxed);
     return ComputeStatus::eOk; 
 }
 
+namespace
+{
+template<typename Counters>
+void updateVRAMSegment(Counters& seg, uint64_t sizeInBytes, VRAMOperation op)
+{
+    if (op == VRAMOperation::eFree)
+    {
+        // Never wrap around, mismatched free (resource created before tracking started etc.) just clamps to zero
+        auto count = seg.allocCount.load(std::memory_order_relaxed);
+        while (count && !seg.allocCount.compare_exchange_weak(count, count - 1, std::memory_order_relaxed)) {}
+        auto total = seg.totalAllocatedSize.load(std::memory_order_relaxed);
+        while (!seg.totalAllocatedSize.compare_exchange_weak(total, total > sizeInBytes ? total - sizeInBytes : 0, std::memory_order_relaxed)) {}
+    }
+    else
+    {
+        seg.allocCount.fetch_add(1, std::memory_order_relaxed);
+        seg.totalAllocatedSize.fetch_add(sizeInBytes, std::memory_order_relaxed);
+    }
+}
+}
+
 Generic::VRAMSegment Generic::manageVRAM(Resource res, VRAMOperation op)
 {
     ResourceDescription desc;
@@ -689,53 +1603,20 @@ Generic::VRAMSegment Generic::manageVRAM(Resource res, VRAMOperation op)
     auto sizeInBytes = getResourceSize(res);
     auto name = getDebugName(res);
 
-    std::scoped_lock lock(m_mutexVRAM);
-
-    auto& id = m_currentVRAMSegment[std::this_thread::get_id()];
-    if (id != kGlobalVRAMSegment)
+    auto id = m_vramThreadState.getContext().segment;
+    if (id != kGlobalVRAMSegmentId)
     {
         auto& seg = m_vramSegments[id];
-        if (op == VRAMOperation::eFree)
-        {
-            if (seg.allocCount == 0 || seg.totalAllocatedSize < sizeInBytes)
-            {
-                seg = {};
-            }
-            else
-            {
-                seg.allocCount--;
-                seg.totalAllocatedSize -= sizeInBytes;
-            }
-        }
-        else
-        {
-            seg.allocCount++;
-            seg.totalAllocatedSize += sizeInBytes;
-        }
+        updateVRAMSegment(seg, sizeInBytes, op);
         
-        SL_LOG_VERBOSE("vram %s [%s %u %.1fMB usage:%.2fGB budget:%.2fGB] resource 0x%llx [%u:%u:%s] - '%S'", op == VRAMOperation::eFree ? "free" : "alloc", id.c_str(), seg.allocCount, 
-            double(seg.totalAllocatedSize / (1024 * 1024)), double(m_vramUsageBytes.load() / (1024 * 1024 * 1024)), double(m_vramBudgetBytes.load() / (1024 * 1024 * 1024)),
+        SL_LOG_VERBOSE("vram %s [%s %u %.1fMB usage:%.2fGB budget:%.2fGB] resource 0x%llx [%u:%u:%s] - '%S'", op == VRAMOperation::eFree ? "free" : "alloc", m_vramSegmentNames[id].c_str(), seg.allocCount.load(),
+            double(seg.totalAllocatedSize.load() / (1024 * 1024)), double(m_vramUsageBytes.load() / (1024 * 1024 * 1024)), double(m_vramBudgetBytes.load() / (1024 * 1024 * 1024)),
             res->native, desc.width, desc.height, GFORMAT_STR[desc.format], name.c_str());
     }
 
-    auto& seg = m_vramSegments[kGlobalVRAMSegment];
-    if (op == VRAMOperation::eFree)
-    {
-        if (seg.allocCount == 0 || seg.totalAllocatedSize < sizeInBytes)
-        {
-            seg = {};
-        }
-        else
-        {
-            seg.allocCount--;
-            seg.totalAllocatedSize -= sizeInBytes;
-        }
-    }
-    else
-    {
-        seg.allocCount++;
-        seg.totalAllocatedSize += sizeInBytes;
-    }
+    auto& seg = m_vramSegments[kGlobalVRAMSegmentId];
+    updateVRAMSegment(seg, sizeInBytes, op);
+    VRAMSegment snapshot{ seg.allocCount.load(std::memory_order_relaxed), seg.totalAllocatedSize.load(std::memory_order_relaxed) };
     
     // Warn if global allocations are over the budget
     auto budgetedBytes = m_vramBudgetBytes.load();
@@ -745,13 +1626,13 @@ Generic::VRAMSegment Generic::manageVRAM(Resource res, VRAMOperation op)
         SL_LOG_WARN("Allocated %.2fMB which is more than allowed by the VRAM budget %.2fMB", usedBytes / (1024.0 * 1024.0), budgetedBytes / (1024.0 * 1024.0));
     }
 
-    if (id == kGlobalVRAMSegment)
+    if (id == kGlobalVRAMSegmentId)
     {
-        SL_LOG_VERBOSE("vram %s [%s %u %.1fMB usage:%.2fGB budget:%.2fGB] resource 0x%llx [%u:%u:%s] - '%S'", op == VRAMOperation::eFree ? "free" : "alloc", id.c_str(), seg.allocCount,
-            double(seg.totalAllocatedSize / (1024 * 1024)), double(m_vramUsageBytes.load() / (1024 * 1024 * 1024)), double(m_vramBudgetBytes.load() / (1024 * 1024 * 1024)),
+        SL_LOG_VERBOSE("vram %s [%s %u %.1fMB usage:%.2fGB budget:%.2fGB] resource 0x%llx [%u:%u:%s] - '%S'", op == VRAMOperation::eFree ? "free" : "alloc", kGlobalVRAMSegment, snapshot.allocCount,
+            double(snapshot.totalAllocatedSize / (1024 * 1024)), double(m_vramUsageBytes.load() / (1024 * 1024 * 1024)), double(m_vramBudgetBytes.load() / (1024 * 1024 * 1024)),
             res->native, desc.width, desc.height, GFORMAT_STR[desc.format], name.c_str());
     }
-    return seg;
+    return snapshot;
 }
 
 ComputeStatus Generic::createBuffer(const ResourceDescription& CreateResourceDesc, Resource& OutResource, const char InFriendlyName[])
@@ -814,7 +1695,8 @@ ComputeStatus Generic::destroy(std::function<void(void)> task, uint32_t frameDel
     // Delayed destroy for safety
     {
         std::lock_guard<std::mutex> lock(m_mutexResource);
-        m_destroyWithLambdas.push_back({ task, m_finishedFrame, frameDelay });
+        uint32_t frame = m_finishedFrame;
+        m_destructionBatches[frame + frameDelay].lambdas.push_back({ task, frame, frameDelay });
     }
     SL_LOG_VERBOSE("Scheduled to destroy lambda task - frame %u", m_finishedFrame.load());
     return ComputeStatus::eOk;
@@ -851,7 +1733,7 @@ ComputeStatus Generic::destroyResource(Resource resource, uint32_t frameDelay)
             // Delayed destroy for safety
             std::lock_guard<std::mutex> lock(m_mutexResource);
             TimestampedResource rest = { resource, m_finishedFrame, frameDelay };
-            if (std::find(m_resourcesToDestroy.begin(), m_resourcesToDestroy.end(), rest) == m_resourcesToDestroy.end())
+            if (m_pendingDestruction.insert(resource->native).second)
             {
                 if (m_platform != RenderAPI::eVulkan)
                 {
@@ -861,67 +1743,71 @@ ComputeStatus Generic::destroyResource(Resource resource, uint32_t frameDelay)
                     auto unknown = (IUnknown*)(resource->native);
                     unknown->AddRef();
                 }
-                m_resourcesToDestroy.push_back(rest);
+                m_destructionBatches[rest.frame + frameDelay].resources.push_back(rest);
             }
         }
     }
     return ComputeStatus::eOk;
 }
 
+ComputeStatus Generic::setFinishedFrame(uint32_t finishedFrame)
+{
+    // Present thread publishes the index ahead of the deferred 'collectGarbage' call so never move back
+    auto current = m_finishedFrame.load();
+    while (current < finishedFrame && !m_finishedFrame.compare_exchange_weak(current, finishedFrame))
+    {
+    }
+    return ComputeStatus::eOk;
+}
+
 ComputeStatus Generic::collectGarbage(uint32_t finishedFrame)
 {
     if (finishedFrame != UINT_MAX)
     {
-        m_finishedFrame.store(finishedFrame);
+        setFinishedFrame(finishedFrame);
     }
 
-    std::lock_guard<std::mutex> lock(m_mutexResource);
-
+    // Grab all batches for the retired frames in one go, lock is held only for the lookup
+    TimestampedLambdaList lambdas;
+    TimestampedResourceList resources;
     {
-        auto it = m_destroyWithLambdas.begin();
-        while (it != m_destroyWithLambdas.end())
+        std::lock_guard<std::mutex> lock(m_mutexResource);
+        auto it = m_destructionBatches.begin();
+        while (it != m_destructionBatches.end() && finishedFrame > (*it).first)
         {
-            auto& tres = (*it);
-            // Run lambda is
-            if (finishedFrame > (tres.frame + tres.frameDelay))
-            {
-                SL_LOG_VERBOSE("Calling destroy lambda - scheduled at frame %u - finished frame %u - forced %s", tres.frame, m_finishedFrame.load(), finishedFrame != UINT_MAX ? "no" : "yes");
-                tres.task();
-                it = m_destroyWithLambdas.erase(it);
-            }
-            else
-            {
-                it++;
-            }
+            auto& batch = (*it).second;
+            if (lambdas.empty()) lambdas.swap(batch.lambdas);
+            else lambdas.insert(lambdas.end(), batch.lambdas.begin(), batch.lambdas.end());
+            if (resources.empty()) resources.swap(batch.resources);
+            else resources.insert(resources.end(), batch.resources.begin(), batch.resources.end());
+            it = m_destructionBatches.erase(it);
         }
     }
 
+    for (auto& tres : lambdas)
+    {
+        SL_LOG_VERBOSE("Calling destroy lambda - scheduled at frame %u - finished frame %u - forced %s", tres.frame, m_finishedFrame.load(), finishedFrame != UINT_MAX ? "no" : "yes");
+        tres.task();
+    }
+
+    if (!resources.empty())
     {
-        auto it = m_resourcesToDestroy.begin();
-        while (it != m_resourcesToDestroy.end())
+        std::lock_guard<std::mutex> lock(m_mutexResource);
+        for (auto& tres : resources)
         {
-            auto& tres = (*it);
-            // Release resources dumped more than few frames ago
-            if (finishedFrame > (tres.frame + tres.frameDelay))
-            {
-                if (m_platform != RenderAPI::eVulkan)
-                {
-                    //! Make sure to release the "safety" reference that was added when scheduling resource for destruction.
-                    //! 
-                    //! This is important because of the swap-chains and their buffers which are shared with the host.
-                    auto unknown = (IUnknown*)(tres.resource->native);
-                    unknown->Release();
-                }
-                auto name = getDebugName(tres.resource);
-                auto ref = destroyResourceDeferredImpl(tres.resource);
-                SL_LOG_VERBOSE("Destroyed 0x%llx(%S) - scheduled at frame %u - finished frame %u - forced %s - ref count %d", tres.resource, name.c_str(), tres.frame, m_finishedFrame.load(), finishedFrame != UINT_MAX ? "no" : "yes", ref);
-                delete tres.resource;
-                it = m_resourcesToDestroy.erase(it);
-            }
-            else
+            if (m_platform != RenderAPI::eVulkan)
             {
-                it++;
+                //! Make sure to release the "safety" reference that was added when scheduling resource for destruction.
+                //! 
+                //! This is important because of the swap-chains and their buffers which are shared with the host.
+                auto unknown = (IUnknown*)(tres.resource->native);
+                unknown->Release();
             }
+            m_pendingDestruction.erase(tres.resource->native);
+            auto name = getDebugName(tres.resource);
+            auto ref = destroyResourceDeferredImpl(tres.resource);
+            SL_LOG_VERBOSE("Destroyed 0x%llx(%S) - scheduled at frame %u - finished frame %u - forced %s - ref count %d", tres.resource, name.c_str(), tres.frame, m_finishedFrame.load(), finishedFrame != UINT_MAX ? "no" : "yes", ref);
+            delete tres.resource;
         }
     }
 
@@ -1192,33 +2078,49 @@ ComputeStatus Generic::getFormatAsString(const Format format, std::string& name)
     return ComputeStatus::eOk;
 }
 
-bool Generic::savePFM(const std::string &path, const char* srcBuffer, const int width, const int height)
+bool Generic::saveImage(const std::string& path, ImageFileFormat format, const float* pixels, uint32_t width, uint32_t height, uint32_t channels)
 {
-    auto fpath = path;
-    fpath += ".pfm";
-
-    const int totalBytes = width * height * sizeof(float) * 3;
-
-    // Setup header
-    const std::string header = "PF\n" + std::to_string(width) + " " + std::to_string(height) + "\n-1.0\n";
-    const size_t headerSize = header.length();
-    const char* headerArr = header.c_str();
+    if (!pixels || !width || !height || channels < 1 || channels > 4)
+    {
+        SL_LOG_ERROR("Invalid image %ux%u with %u channels for '%s'", width, height, channels, path.c_str());
+        return false;
+    }
 
-    std::ofstream binWriter(fpath.c_str(), std::ios::binary);
+    static constexpr const char* kExtensions[] = { ".pfm", ".png", ".exr" };
+    auto fpath = path + kExtensions[(uint32_t)format];
+    // Shared so the job stays copyable for std::function, the copy is what lets the caller move on
+    auto data = std::make_shared<std::vector<float>>(pixels, pixels + (size_t)width * height * channels);
+    auto job = [fpath, format, data, width, height, channels]()->void
+    {
+        std::vector<uint8_t> encoded;
+        switch (format)
+        {
+            case ImageFileFormat::ePFM: image::encodePFM(data->data(), width, height, channels, encoded); break;
+            case ImageFileFormat::ePNG: image::encodePNG(data->data(), width, height, channels, encoded); break;
+            case ImageFileFormat::eEXR: image::encodeEXR(data->data(), width, height, channels, true, encoded); break;
+        }
+        std::ofstream binWriter(fpath.c_str(), std::ios::binary);
+        if (!binWriter)
+        {
+            SL_LOG_ERROR( "Failed to open %s", fpath.c_str());
+            return;
+        }
+        binWriter.write((const char*)encoded.data(), encoded.size());
+    };
 
-    if (!binWriter)
+    if (!thread::getSharedIOQueue().schedule(job))
     {
-        SL_LOG_ERROR( "Failed to open %s", fpath.c_str());
-        binWriter.close();
+        SL_LOG_WARN("I/O queue is full, dropping '%s'", fpath.c_str());
         return false;
     }
-
-    binWriter.write(header.c_str(), headerSize);
-    binWriter.write(srcBuffer, totalBytes);
-    binWriter.close();
     return true;
 }
 
+bool Generic::savePFM(const std::string &path, const char* srcBuffer, const int width, const int height)
+{
+    return saveImage(path, ImageFileFormat::ePFM, (const float*)srcBuffer, width, height, 3);
+}
+
 ComputeStatus Generic::setSleepMode(const ReflexOptions& consts)
 {
     NV_SET_SLEEP_MODE_PARAMS_V1 params = { 0 };
@@ -1285,6 +2187,103 @@ ComputeStatus Generic::setReflexMarker(PCLMarker marker, uint64_t frameId)
     return ComputeStatus::eOk;
 }
 
+//! Attached to a translated source as private data, the runtime releases it when the host destroys the source
+class SharedResourceNotifier : public IUnknown
+{
+    std::atomic<ULONG> m_refCount = 1;
+    std::shared_ptr<SharedResourceRetireList> m_list;
+    void* m_native;
+    uint64_t m_id;
+
+public:
+    SharedResourceNotifier(std::shared_ptr<SharedResourceRetireList> list, void* native, uint64_t id) : m_list(list), m_native(native), m_id(id) {};
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override
+    {
+        if (riid == __uuidof(IUnknown))
+        {
+            *ppvObject = this;
+            AddRef();
+            return S_OK;
+        }
+        *ppvObject = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override { return ++m_refCount; }
+
+    ULONG STDMETHODCALLTYPE Release() override
+    {
+        auto refCount = --m_refCount;
+        if (refCount == 0)
+        {
+            {
+                std::scoped_lock lock(m_list->mutex);
+                m_list->retired.push_back({ m_native, m_id });
+            }
+            delete this;
+        }
+        return refCount;
+    }
+};
+
+void Generic::notifyOnSourceRelease(Resource resource, uint64_t id)
+{
+    auto unknown = (IUnknown*)(resource->native);
+    auto notifier = new SharedResourceNotifier(m_sharedResourceRetireList, resource->native, id);
+    HRESULT hr = E_NOINTERFACE;
+    ID3D11DeviceChild* deviceChild{};
+    ID3D12Object* object{};
+    if (SUCCEEDED(unknown->QueryInterface(&deviceChild)))
+    {
+        hr = deviceChild->SetPrivateDataInterface(sSharedResourceNotifierGUID, notifier);
+        deviceChild->Release();
+    }
+    else if (SUCCEEDED(unknown->QueryInterface(&object)))
+    {
+        hr = object->SetPrivateDataInterface(sSharedResourceNotifierGUID, notifier);
+        object->Release();
+    }
+    if (FAILED(hr))
+    {
+        // Cache entry is then only invalidated when a recycled pointer is detected
+        SL_LOG_WARN("Failed to attach release notifier to shared resource 0x%llx", resource);
+    }
+    // Runtime holds the reference now, last one goes away with the source (or right here on failure)
+    notifier->Release();
+}
+
+void Generic::releaseSharedResource(SharedResource& shared)
+{
+    auto& resource = shared.resource;
+    if (resource.source != resource.translated)
+    {
+        destroySharedHandle(resource.handle);
+        destroyResource(resource.translated);
+        shared.otherAPI->destroyResource(resource.clone);
+    }
+}
+
+void Generic::releaseRetiredSharedResources()
+{
+    std::vector<std::pair<void*, uint64_t>> retired;
+    {
+        std::scoped_lock lock(m_sharedResourceRetireList->mutex);
+        if (m_sharedResourceRetireList->retired.empty()) return;
+        retired.swap(m_sharedResourceRetireList->retired);
+    }
+    for (auto& [native, id] : retired)
+    {
+        auto it = m_sharedResourceMap.find(native);
+        if (it != m_sharedResourceMap.end() && (*it).second.id == id)
+        {
+            SL_LOG_VERBOSE("Source 0x%llx destroyed - removing from the shared resource cache", native);
+            releaseSharedResource((*it).second);
+            m_sharedResourceMap.erase(it);
+        }
+    }
+}
+
 ComputeStatus Generic::fetchTranslatedResourceFromCache(ICompute* compute, ResourceType type, Resource resource, TranslatedResource& shared, const char friendlyName[])
 {
     if (!compute || !resource || !resource->native)
@@ -1297,19 +2296,26 @@ ComputeStatus Generic::fetchTranslatedResourceFromCache(ICompute* compute, Resou
 
     auto otherAPI = (Generic*)compute;
 
+    std::scoped_lock lock(m_mutexSharedResource);
+
+    // Drop translations whose sources the host destroyed since the last call
+    releaseRetiredSharedResources();
+
     auto it = m_sharedResourceMap.find(resource->native);
     // If resource is cached and it is a texture not a fence or semaphore check for recycled pointers
     if (type == ResourceType::eTex2d && it != m_sharedResourceMap.end())
     {
-        if (!isResourceTracked(resource))
+        // Vulkan handles carry no private data, only an image recreated at the same handle with a new size is detected
+        auto clone = (*it).second.resource.clone;
+        bool recycled = otherAPI->m_platform == RenderAPI::eVulkan ?
+            clone && (clone->width != resource->width || clone->height != resource->height) :
+            !isResourceTracked(resource);
+        if (recycled)
         {
             // Pointer recycled by DX, remove from cache
             SL_LOG_WARN("Detected recycled resource 0x%llx - removing from the shared resource cache", resource);
 
-            auto& shared = (*it).second;
-            destroySharedHandle(shared.handle);
-            destroyResource(shared.translated);
-            otherAPI->destroyResource(shared.clone);
+            releaseSharedResource((*it).second);
             m_sharedResourceMap.erase(it);
             it = m_sharedResourceMap.end();
         }
@@ -1332,7 +2338,24 @@ ComputeStatus Generic::fetchTranslatedResourceFromCache(ICompute* compute, Resou
             return ComputeStatus::eInvalidArgument;
         }
 
-        if ((desc.flags & chi::ResourceFlags::eSharedResource))
+        if (otherAPI->m_platform == RenderAPI::eVulkan)
+        {
+            // Host images cannot be exported, memory is created here and imported into Vulkan as the clone so
+            // the only per frame work is a copy on the host's queue, see 'Vulkan::prepareTranslatedResources'
+            if (type != ResourceType::eTex2d || (desc.flags & ResourceFlags::eDepthStencilAttachment))
+            {
+                SL_LOG_ERROR("Only color images can be translated from Vulkan");
+                return ComputeStatus::eNotSupported;
+            }
+            desc.nativeFormat = NativeFormatUnknown;
+            desc.flags = chi::ResourceFlags::eSharedResource;
+            desc.state = ResourceState::eTextureRead;
+            std::string name = friendlyName + std::string(".shared");
+            CHI_CHECK(createTexture2D(desc, shared.translated, name.c_str()));
+            CHI_VALIDATE(createSharedHandle(shared.translated, shared.handle));
+            CHI_VALIDATE(otherAPI->importSharedResource(type, shared.handle, desc, shared.clone));
+        }
+        else if ((desc.flags & chi::ResourceFlags::eSharedResource))
         {
             CHI_VALIDATE(otherAPI->createSharedHandle(resource, shared.handle));
         }
@@ -1350,20 +2373,30 @@ ComputeStatus Generic::fetchTranslatedResourceFromCache(ICompute* compute, Resou
             CHI_VALIDATE(otherAPI->createTexture2D(desc, shared.clone, name.c_str()));
             CHI_VALIDATE(otherAPI->createSharedHandle(shared.clone, shared.handle));
         }
-        CHI_VALIDATE(getResourceFromSharedHandle(type, shared.handle, shared.translated));
+        if (otherAPI->m_platform != RenderAPI::eVulkan)
+        {
+            CHI_VALIDATE(getResourceFromSharedHandle(type, shared.handle, shared.translated));
+        }
 
-        m_sharedResourceMap[resource->native] = shared;
-        if (type == ResourceType::eTex2d)
+        auto id = ++m_sharedResourceId;
+        shared.source = resource;
+        m_sharedResourceMap[resource->native] = { shared, otherAPI, id };
+        if (otherAPI->m_platform != RenderAPI::eVulkan)
         {
-            // Mark for tracking so we can detect recycled pointers
-            setResourceTracked(resource, 1);
+            if (type == ResourceType::eTex2d)
+            {
+                // Mark for tracking so we can detect recycled pointers
+                setResourceTracked(resource, 1);
+            }
+            notifyOnSourceRelease(resource, id);
         }
     }
     else
     {
-        shared.translated = (*it).second.translated;
-        shared.handle = (*it).second.handle;
-        shared.clone = (*it).second.clone;
+        auto& cached = (*it).second.resource;
+        shared.translated = cached.translated;
+        shared.handle = cached.handle;
+        shared.clone = cached.clone;
     }
     shared.source = resource;
     return ComputeStatus::eOk;
@@ -1372,12 +2405,18 @@ ComputeStatus Generic::fetchTranslatedResourceFromCache(ICompute* compute, Resou
 ComputeStatus Generic::createResourcePool(IResourcePool** pool, const char* vramSegment)
 {
     if (!pool) return ComputeStatus::eInvalidArgument;
-    *pool = new ResourcePool(this, vramSegment);
+    *pool = new ResourcePool(this, vramSegment, m_perfStats);
+    std::scoped_lock lock(m_mutexPools);
+    m_pools.push_back(*pool);
     return ComputeStatus::eOk;
 }
 ComputeStatus Generic::destroyResourcePool(IResourcePool* pool)
 {
     if (!pool) return ComputeStatus::eInvalidArgument;
+    {
+        std::scoped_lock lock(m_mutexPools);
+        m_pools.erase(std::remove(m_pools.begin(), m_pools.end(), pool), m_pools.end());
+    }
     pool->clear();
     delete pool;
     return ComputeStatus::eOk;
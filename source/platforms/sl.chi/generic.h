@@ -25,10 +25,21 @@
 #include <chrono>
 #include <vector>
 #include <map>
+#include <deque>
+#include <memory>
+#include <unordered_set>
+#include <unordered_map>
 #include <atomic>
 #include <mutex>
+#include <thread>
+#include <condition_variable>
 
+#include "source/core/sl.thread/thread.h"
 #include "source/platforms/sl.chi/compute.h"
+#include "source/platforms/sl.chi/hash.h"
+#include "source/core/sl.extra/startupTimeline.h"
+#include "source/core/sl.extra/perfStats.h"
+#include "source/core/sl.extra/hitches.h"
 
 #if !defined(SL_WINDOWS)
 typedef struct GUID {
@@ -64,6 +75,8 @@ struct KernelDataBase
     std::string name = {};
     std::string entryPoint = {};
     std::vector<uint8_t> kernelBlob = {};
+    //! D3D12 only, blob indexes 'ResourceDescriptorHeap' so it uses the shared bindless root signature
+    bool bindless = false;
 };
 
 struct TimestampedResource
@@ -101,6 +114,241 @@ enum class VRAMOperation
     eFree
 };
 
+//! Split barriers let the GPU overlap a transition with unrelated work, only D3D12 supports them
+enum class BarrierSplit : uint32_t
+{
+    eNone,
+    eBegin,
+    eEnd
+};
+
+//! Debug image dump formats, see 'Generic::saveImage'
+enum class ImageFileFormat : uint32_t
+{
+    ePFM,
+    ePNG,
+    eEXR
+};
+
+//! Flat open addressing table of tracked resources keyed by tag uid
+//!
+//! Writers must be serialized externally while readers need no lock, the generation
+//! works as a seqlock (odd while writing) so readers simply retry if they raced a writer.
+struct ResourceTrackingTable
+{
+    static constexpr uint32_t kCapacity = 256;
+    static constexpr uint64_t kEmpty = 0;
+    static constexpr uint64_t kRemoved = UINT64_MAX;
+
+    struct Entry
+    {
+        //! uid + 1 so that tag 0 on viewport 0 is not confused with an empty entry
+        std::atomic<uint64_t> key{};
+        std::atomic<IUnknown*> resource{};
+    };
+
+    //! Frame currently owning this table when used for frame based tagging
+    std::atomic<uint32_t> frameId = UINT_MAX;
+    std::atomic<uint32_t> generation = 0;
+    uint32_t count = 0;
+    Entry entries[kCapacity];
+
+    static uint32_t hash(uint64_t uid)
+    {
+        uid ^= uid >> 29;
+        return uint32_t((uid * 0x9E3779B97F4A7C15ull) >> 32) & (kCapacity - 1);
+    }
+
+    //! Lock-free, returns null if not tracked or if table belongs to a different frame
+    IUnknown* find(uint64_t uid, uint32_t frame = UINT_MAX) const
+    {
+        while (true)
+        {
+            auto gen = generation.load(std::memory_order_acquire);
+            if (gen & 1)
+            {
+                YieldProcessor();
+                continue;
+            }
+            IUnknown* res{};
+            if (frameId.load(std::memory_order_relaxed) == frame)
+            {
+                auto key = uid + 1;
+                auto idx = hash(uid);
+                for (uint32_t i = 0; i < kCapacity; i++, idx = (idx + 1) & (kCapacity - 1))
+                {
+                    auto k = entries[idx].key.load(std::memory_order_relaxed);
+                    if (k == kEmpty) break;
+                    if (k == key)
+                    {
+                        res = entries[idx].resource.load(std::memory_order_relaxed);
+                        break;
+                    }
+                }
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (generation.load(std::memory_order_relaxed) == gen) return res;
+        }
+    }
+
+    //! Writer only, returns the previously tracked resource (if any) or false if the table is full
+    bool insert(uint64_t uid, IUnknown* resource, IUnknown*& previous)
+    {
+        auto key = uid + 1;
+        auto idx = hash(uid);
+        Entry* target{};
+        for (uint32_t i = 0; i < kCapacity; i++, idx = (idx + 1) & (kCapacity - 1))
+        {
+            auto k = entries[idx].key.load(std::memory_order_relaxed);
+            if (k == key)
+            {
+                target = &entries[idx];
+                break;
+            }
+            if (k == kRemoved && !target)
+            {
+                target = &entries[idx];
+            }
+            else if (k == kEmpty)
+            {
+                if (!target) target = &entries[idx];
+                break;
+            }
+        }
+        if (!target) return false;
+
+        beginWrite();
+        previous = target->key.load(std::memory_order_relaxed) == key ? target->resource.load(std::memory_order_relaxed) : nullptr;
+        if (target->key.load(std::memory_order_relaxed) != key)
+        {
+            target->key.store(key, std::memory_order_relaxed);
+            count++;
+        }
+        target->resource.store(resource, std::memory_order_relaxed);
+        endWrite();
+        return true;
+    }
+
+    //! Writer only, returns the resource which was tracked or null
+    IUnknown* erase(uint64_t uid)
+    {
+        auto key = uid + 1;
+        auto idx = hash(uid);
+        for (uint32_t i = 0; i < kCapacity; i++, idx = (idx + 1) & (kCapacity - 1))
+        {
+            auto k = entries[idx].key.load(std::memory_order_relaxed);
+            if (k == kEmpty) break;
+            if (k == key)
+            {
+                beginWrite();
+                auto res = entries[idx].resource.load(std::memory_order_relaxed);
+                entries[idx].resource.store(nullptr, std::memory_order_relaxed);
+                entries[idx].key.store(kRemoved, std::memory_order_relaxed);
+                // Last one out gets rid of all the tombstones
+                if (--count == 0)
+                {
+                    clearEntries();
+                }
+                endWrite();
+                return res;
+            }
+        }
+        return nullptr;
+    }
+
+    //! Writer only, calls 'release' for each tracked resource and hands the table over to the new frame
+    template<typename F>
+    void reset(uint32_t frame, F release)
+    {
+        beginWrite();
+        for (auto& entry : entries)
+        {
+            auto res = entry.resource.load(std::memory_order_relaxed);
+            if (res) release(res);
+        }
+        clearEntries();
+        frameId.store(frame, std::memory_order_relaxed);
+        endWrite();
+    }
+
+private:
+    void beginWrite()
+    {
+        generation.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+    void endWrite()
+    {
+        generation.fetch_add(1, std::memory_order_release);
+    }
+    void clearEntries()
+    {
+        for (auto& entry : entries)
+        {
+            entry.key.store(kEmpty, std::memory_order_relaxed);
+            entry.resource.store(nullptr, std::memory_order_relaxed);
+        }
+        count = 0;
+    }
+};
+
+//! Sub-allocates a fixed size GPU visible buffer linearly, space is recycled once the GPU is 'frameDelay' frames past it
+//! 
+//! 'head' and 'tail' only ever grow, the offset in the buffer is the position modulo 'size'.
+//! Each frame's end position is queued and space up to it is retired after 'frameDelay' frames.
+//! 
+//! NOTE: Not thread safe, owners serialize access
+struct FrameRing
+{
+    uint64_t size = 0;
+    uint32_t frameDelay = 3;
+    uint64_t head = 0;
+    uint64_t tail = 0;
+    uint32_t frame = 0;
+    std::deque<std::pair<uint32_t, uint64_t>> frameEnds;
+
+    inline bool allocate(uint64_t bytes, uint64_t alignment, uint32_t currentFrame, uint64_t& offset)
+    {
+        // Close the previous frame and retire everything the GPU is guaranteed to be done with
+        if (currentFrame != frame)
+        {
+            frameEnds.push_back({ frame, head });
+            frame = currentFrame;
+        }
+        while (!frameEnds.empty() && currentFrame >= frameEnds.front().first + frameDelay)
+        {
+            tail = frameEnds.front().second;
+            frameEnds.pop_front();
+        }
+
+        // Align the offset in the buffer, alignment does not have to divide the ring size
+        uint64_t base = head / size * size;
+        uint64_t aligned = (head - base + alignment - 1) / alignment * alignment;
+        uint64_t start = base + aligned;
+        if (aligned + bytes > size)
+        {
+            // Allocations never straddle the end of the buffer
+            start = base + size;
+        }
+        if (start + bytes - tail > size)
+        {
+            return false;
+        }
+        head = start + bytes;
+        offset = start % size;
+        return true;
+    }
+};
+
+//! Sources of shared resources which have been destroyed by the host
+//!
+//! Shared with the destruction notifiers so a notification arriving after shutdown stays harmless
+struct SharedResourceRetireList
+{
+    std::mutex mutex;
+    std::vector<std::pair<void*, uint64_t>> retired;
+};
+
 class Generic : public ICompute
 {
 protected:
@@ -119,8 +367,16 @@ protected:
     using TimestampedResourceList = std::vector<TimestampedResource>;
     using TimestampedLambdaList = std::vector<TimestampedLambda>;
 
-    TimestampedResourceList m_resourcesToDestroy = {};
-    TimestampedLambdaList m_destroyWithLambdas = {};
+    //! Everything scheduled for destruction in the same frame with the same delay
+    struct DestructionBatch
+    {
+        TimestampedResourceList resources;
+        TimestampedLambdaList lambdas;
+    };
+    //! Keyed by the frame after which the batch can be released, ordered so retiring is just popping from the front
+    std::map<uint32_t, DestructionBatch> m_destructionBatches = {};
+    //! Native pointers already scheduled, avoids scheduling the same resource twice
+    std::unordered_set<void*> m_pendingDestruction = {};
 
     std::mutex m_mutexKernel;
     std::mutex m_mutexProfiler;
@@ -132,10 +388,27 @@ protected:
     std::atomic<uint64_t> m_vramBudgetBytes{};
     std::atomic<uint64_t> m_vramUsageBytes{};
 
-    using ResourceTrackingMap = std::map<uint64_t, IUnknown*>;
-    ResourceTrackingMap m_resourceTrackMap{};
-    // frame-aware tracking of resources tagged using frame-based resource tagging APIs
-    std::map<uint32_t, ResourceTrackingMap> m_frameResourceTrackingMap{};
+    std::mutex m_mutexPools;
+    std::vector<IResourcePool*> m_pools{};
+    VRAMEvictionPolicy m_evictionPolicy{};
+    uint64_t m_lastVRAMBudgetBytes{};
+    uint32_t m_evictionCooldown{};
+
+    ResourceTrackingTable m_resourceTracking{};
+    // frame-aware tracking of resources tagged using frame-based resource tagging APIs, one table per frame in flight
+    static constexpr uint32_t kResourceTrackingFrameSlots = 32;
+    ResourceTrackingTable m_frameResourceTracking[kResourceTrackingFrameSlots]{};
+    //! References held by the tables above per native pointer, generation is assigned when the first one is taken
+    struct TrackedResourcePin
+    {
+        uint32_t count{};
+        uint64_t generation{};
+    };
+    std::unordered_map<void*, TrackedResourcePin> m_trackedPins{};
+    uint64_t m_trackedGeneration{};
+    //! Called with 'm_mutexResourceTrack' held, return the reference count like AddRef/Release
+    ULONG pinTrackedResource(IUnknown* resource);
+    ULONG unpinTrackedResource(IUnknown* resource);
 
     PFun_ResourceAllocateCallback* m_allocateCallback = {};
     PFun_ResourceReleaseCallback* m_releaseCallback = {};
@@ -143,22 +416,112 @@ protected:
 
     bool m_bFastUAVClearSupported = false;
     PreferenceFlags m_preferenceFlags{};
+    extra::IStartupTimeline* m_startupTimeline{};
+    //! Barriers, pool traffic and resolved perf sections are counted here when the interposer provides it
+    extra::IPerfStats* m_perfStats{};
+    //! Owned by sl.interposer, flipped at runtime so every module sees the same state
+    std::atomic<bool>* m_gpuMarkers{};
+    //! Every resolved perf section sample adds to the frame level GPU time of SL passes
+    void countGPUPass(double deltaMs)
+    {
+        if (m_perfStats)
+        {
+            m_perfStats->add(extra::PerfCounter::eGPUPassNs, (uint64_t)(deltaMs * 1e6));
+            m_perfStats->add(extra::PerfCounter::eGPUPasses, 1);
+        }
+    }
 
     struct VRAMSegment
     {
         uint64_t allocCount{};
         uint64_t totalAllocatedSize{};
     };
-    std::map<std::string, VRAMSegment> m_vramSegments{};
-    std::map<std::thread::id, std::string> m_currentVRAMSegment{};
+    struct VRAMSegmentCounters
+    {
+        std::atomic<uint64_t> allocCount{};
+        std::atomic<uint64_t> totalAllocatedSize{};
+    };
+    struct VRAMThreadState
+    {
+        uint32_t segment = kGlobalVRAMSegmentId;
+    };
+    static constexpr uint32_t kGlobalVRAMSegmentId = 0;
+    static constexpr uint32_t kMaxVRAMSegments = 64;
+    //! Segments are never removed, a name is immutable once published by incrementing the count
+    std::string m_vramSegmentNames[kMaxVRAMSegments] = { kGlobalVRAMSegment };
+    VRAMSegmentCounters m_vramSegments[kMaxVRAMSegments]{};
+    std::atomic<uint32_t> m_vramSegmentCount = 1;
+    thread::ThreadContext<VRAMThreadState> m_vramThreadState;
+
+    //! Cached translation, 'id' matches notifications against a recycled source pointer
+    struct SharedResource
+    {
+        TranslatedResource resource;
+        Generic* otherAPI;
+        uint64_t id;
+    };
+    std::mutex m_mutexSharedResource;
+    std::map<void*, SharedResource> m_sharedResourceMap{};
+    std::shared_ptr<SharedResourceRetireList> m_sharedResourceRetireList = std::make_shared<SharedResourceRetireList>();
+    uint64_t m_sharedResourceId = 0;
+
+    void releaseSharedResource(SharedResource& shared);
+
+    //! Indexed by back buffer index, see 'getCachedSwapChainBuffer'
+    std::mutex m_mutexSwapChainBuffers;
+    std::map<SwapChain, std::vector<Resource>> m_swapChainBuffers{};
+    void releaseRetiredSharedResources();
+    void notifyOnSourceRelease(Resource resource, uint64_t id);
+
+    //! Deferred transition, 'step' is the batched call it was recorded in
+    struct PendingTransition
+    {
+        ResourceTransition transition;
+        uint32_t step;
+        bool begun;
+    };
+    struct TransitionBatch
+    {
+        std::vector<PendingTransition> pending;
+        uint32_t step = 0;
+        uint32_t depth = 0;
+    };
+    //! Pending transitions not needed for this many batched calls are started with a split barrier
+    static constexpr uint32_t kSplitBarrierDelay = 2;
+    std::mutex m_mutexTransitionBatch;
+    std::map<CommandList, TransitionBatch> m_transitionBatches{};
+    std::atomic<uint32_t> m_transitionBatchCount = 0;
+
+    ComputeStatus deferTransitions(CommandList cmdList, const std::vector<ResourceTransition>& transitions);
 
-    std::map<void*, TranslatedResource> m_sharedResourceMap{};
+    //! Behind 'notifyOnFence', the thread is started on first use and waits for any pending fence
+    //! with a short timeout so callbacks registered meanwhile with lower values are not held back.
+    struct FenceCallback
+    {
+        Fence fence;
+        uint64_t syncValue;
+        std::function<void(void)> callback;
+    };
+    static constexpr uint32_t kFenceCallbackWaitMs = 1;
+    std::mutex m_mutexFenceCallbacks;
+    //! Held by the thread while it touches fences so 'dropFenceCallbacks' can wait for it before a fence goes away
+    std::mutex m_mutexFenceCallbackWait;
+    std::condition_variable m_cvFenceCallbacks;
+    std::vector<FenceCallback> m_fenceCallbacks;
+    std::thread m_fenceCallbackThread;
+    bool m_fenceCallbackQuit = false;
+
+    void fenceCallbackThread();
+    void dropFenceCallbacks(Fence fence);
+    void shutdownFenceCallbacks();
+    ComputeStatus resolveTransitionBatch(CommandList cmdList, TransitionBatch& batch, const std::vector<ResourceTransition>& requests);
 
     virtual int destroyResourceDeferredImpl(const Resource InResource) = 0;
     virtual ComputeStatus createBufferResourceImpl(ResourceDescription &InOutResourceDesc, Resource &OutResource, ResourceState InitialState, const char InFriendlyName[]) = 0;
     virtual ComputeStatus createTexture2DResourceSharedImpl(ResourceDescription &InOutResourceDesc, Resource &OutResource, bool UseNativeFormat, ResourceState InitialState, const char InFriendlyName[]) = 0;
     virtual ComputeStatus insertGPUBarrierList(CommandList cmdList, const Resource* InResources, unsigned int InResourceCount, BarrierType InBarrierType = eBarrierTypeUAV) override;
     virtual ComputeStatus transitionResourceImpl(CommandList cmdList, const ResourceTransition *transisitions, uint32_t count) = 0;
+    virtual ComputeStatus transitionResourceSplitImpl(CommandList cmdList, const ResourceTransition* transitions, const BarrierSplit* splits, uint32_t count);
 
     virtual ComputeStatus beginVRAMSegment(const char* name) override final;
     virtual ComputeStatus endVRAMSegment() override final;
@@ -168,7 +531,26 @@ protected:
 
     ComputeStatus createTexture2DResourceShared(const ResourceDescription& CreateResourceDesc, Resource& OutResource, bool UseNativeFormat, const char InFriendlyName[]);
     ComputeStatus genericPostInit();
+    std::wstring getPipelineCachePath(const wchar_t* extension);
+
+    //! Linear staging ring behind 'uploadToBuffer/uploadToTexture'
+    static constexpr uint64_t kUploadRingSize = 4 * 1024 * 1024;
+    static constexpr uint32_t kUploadFrameDelay = 3;
+    struct UploadRing
+    {
+        Resource buffer{};
+        FrameRing space{ kUploadRingSize, kUploadFrameDelay };
+    };
+    UploadRing m_uploadRing{};
+    std::mutex m_mutexUploadRing;
+
+    //! Returns staging space for 'size' bytes, falls back to a one-off buffer (destroyed with a frame delay) when the ring is full
+    ComputeStatus allocateUpload(uint64_t size, uint64_t alignment, Resource& buffer, uint64_t& offset);
 
+    //! Encodes and writes the image on the shared I/O queue, pixels are copied so the caller can reuse them right away
+    //!
+    //! Extension is added based on the format. Returns false if the I/O queue is full and the image was dropped.
+    bool saveImage(const std::string& path, ImageFileFormat format, const float* pixels, uint32_t width, uint32_t height, uint32_t channels);
     bool savePFM(const std::string &path, const char* srcBuffer, const int width, const int height);
     uint64_t getResourceSize(Resource res);
 
@@ -176,6 +558,9 @@ protected:
     bool isResourceTracked(chi::Resource resource);
 
     VRAMSegment manageVRAM(Resource res, VRAMOperation op);
+    uint32_t findVRAMSegment(const char* name);
+    uint32_t registerVRAMSegment(const char* name);
+    uint64_t evictPoolResources(uint64_t bytes);
 
 public:
 
@@ -210,6 +595,7 @@ public:
     virtual ComputeStatus getResourceFootprint(Resource resoruce, ResourceFootprint& footprint) override;
 
     virtual ComputeStatus getFinishedFrameIndex(uint32_t& index) final override { index = m_finishedFrame; return ComputeStatus::eOk; };
+    virtual ComputeStatus setFinishedFrame(uint32_t finishedFrame) override final;
 
     virtual ComputeStatus createCommandListContext(ChiCommandQueue* queue,
                                                    uint32_t count,
@@ -236,7 +622,7 @@ public:
         return ComputeStatus::eNoImplementation;
     }
     virtual ComputeStatus createFence(FenceFlags flags, uint64_t initialValue, Fence& outFence, const char friendlyName[] = "")  override { return ComputeStatus::eNoImplementation; }
-    virtual ComputeStatus destroyFence(Fence& fence) override { SL_SAFE_RELEASE(fence); return ComputeStatus::eOk; }
+    virtual ComputeStatus destroyFence(Fence& fence) override { dropFenceCallbacks(fence); SL_SAFE_RELEASE(fence); return ComputeStatus::eOk; }
     virtual ComputeStatus getDebugName(Resource res, std::wstring& name) { name = getDebugName(res); return ComputeStatus::eOk; }
     virtual ComputeStatus setDebugName(Resource res, const char friendlyName[]) override { return ComputeStatus::eNoImplementation; }
         
@@ -254,7 +640,7 @@ public:
     virtual ComputeStatus destroyResource(Resource InResource, uint32_t frameDelay = 3) override final;
     virtual ComputeStatus destroy(std::function<void(void)> task, uint32_t frameDelay = 3) override final;
         
-    virtual ComputeStatus setVRAMBudget(uint64_t currentUsageBytes, uint64_t budgetBytes) override final { m_vramBudgetBytes.store(budgetBytes); m_vramUsageBytes.store(currentUsageBytes); return ComputeStatus::eOk; }
+    virtual ComputeStatus setVRAMBudget(uint64_t currentUsageBytes, uint64_t budgetBytes) override final;
     virtual ComputeStatus getVRAMBudget(uint64_t& totalBytes)  override final 
     { 
         if(m_vramBudgetBytes.load() == 0) return ComputeStatus::eNotReady;
@@ -280,6 +666,7 @@ public:
     virtual ComputeStatus startTrackingResource(uint32_t frameId, uint64_t uid, Resource resource) override;
     virtual ComputeStatus stopTrackingResource(uint64_t uid, Resource dbgResource) override;
     virtual ComputeStatus stopTrackingResource(uint32_t frameId, uint64_t uid, Resource dbgResource) override;
+    virtual ComputeStatus getTrackedResourceGeneration(Resource resource, uint64_t& generation) override;
 
     ComputeStatus restorePipeline(CommandList cmdList)  override { return ComputeStatus::eOk; }
 
@@ -314,6 +701,7 @@ public:
     virtual ComputeStatus createSharedHandle(Resource res, Handle& handle) { return ComputeStatus::eNoImplementation; }
     virtual ComputeStatus destroySharedHandle(Handle& handle)  { return ComputeStatus::eNoImplementation; }
     virtual ComputeStatus getResourceFromSharedHandle(ResourceType type, Handle handle, Resource& res)  { return ComputeStatus::eNoImplementation; }
+    virtual ComputeStatus importSharedResource(ResourceType type, Handle handle, const ResourceDescription& desc, Resource& res) override { return getResourceFromSharedHandle(type, handle, res); }
 
     // Resource pool
     virtual ComputeStatus createResourcePool(IResourcePool** pool, const char* vramSegment) override final;
@@ -323,6 +711,51 @@ public:
     virtual ComputeStatus isNativeOpticalFlowSupported() override { return ComputeStatus::eNoImplementation; }
 
     virtual ComputeStatus isDeviceExtensionSupported(const char* extension, uint32_t version) override { return ComputeStatus::eNoImplementation; }
+
+    virtual ComputeStatus setVRAMEvictionPolicy(const VRAMEvictionPolicy& policy) override final;
+    virtual ComputeStatus getVRAMSegmentStats(VRAMSegmentStats* stats, uint32_t& count) override final;
+    virtual ComputeStatus isVRAMOverBudget(bool& overBudget) override final;
+
+    virtual ComputeStatus beginTransitionBatch(CommandList cmdList) override;
+    virtual ComputeStatus endTransitionBatch(CommandList cmdList) override;
+
+    virtual ComputeStatus prewarmKernels(const Kernel* kernels, uint32_t count) override { return ComputeStatus::eOk; }
+    virtual ComputeStatus getShaderCaps(ShaderCaps& caps) override { caps = {}; return ComputeStatus::eOk; }
+    virtual bool isGPUMarkersEnabled() override final
+    {
+#if SL_ENABLE_PROFILING
+        return true;
+#else
+        return m_gpuMarkers && m_gpuMarkers->load(std::memory_order_relaxed);
+#endif
+    }
+    virtual ComputeStatus bindRootConstants(uint32_t binding, uint32_t reg, const void* data, size_t dataSize, uint32_t instances) override { return bindConsts(binding, reg, (void*)data, dataSize, instances); }
+
+    virtual ComputeStatus beginAsyncCompute(CommandQueue hostQueue, CommandList& cmdList) override { return ComputeStatus::eNoImplementation; }
+    virtual ComputeStatus endAsyncCompute(CommandQueue hostQueue) override { return ComputeStatus::eNoImplementation; }
+
+    virtual ComputeStatus createNullSwapChain(const NullSwapChainDesc& desc, SwapChain& chain) override { return ComputeStatus::eNoImplementation; }
+    virtual ComputeStatus destroyNullSwapChain(SwapChain chain) override { return ComputeStatus::eNoImplementation; }
+    virtual ComputeStatus presentNullSwapChain(SwapChain chain, CommandQueue queue, uint32_t& bufferIndex) override { return ComputeStatus::eNoImplementation; }
+
+    virtual ComputeStatus cacheSwapChainBuffers(SwapChain chain, uint32_t bufferCount) override final;
+    virtual ComputeStatus getCachedSwapChainBuffer(SwapChain chain, uint32_t index, Resource& buffer) override final;
+    virtual ComputeStatus releaseSwapChainBuffers(SwapChain chain) override final;
+
+    virtual ComputeStatus createResources(ResourceBatchEntry* entries, uint32_t count) override;
+    virtual ComputeStatus createAliasedResources(ResourceBatchEntry* entries, uint32_t count) override { return createResources(entries, count); }
+
+    virtual ComputeStatus uploadToBuffer(CommandList cmdList, const void* data, uint64_t size, Resource target, uint64_t dstOffset = 0) override;
+
+    virtual WaitStatus waitCPUFences(const Fence* fences, const uint64_t* syncValues, uint32_t count, bool waitAny = false, uint32_t timeoutMs = 500) override { return WaitStatus::eError; }
+    virtual ComputeStatus notifyOnFence(Fence fence, uint64_t syncValue, std::function<void(void)> callback) override;
+
+    virtual ComputeStatus beginBundle(uint32_t node, CommandList& bundle) override { return ComputeStatus::eNoImplementation; }
+    virtual ComputeStatus endBundle(CommandList bundle) override { return ComputeStatus::eNoImplementation; }
+    virtual ComputeStatus executeBundle(CommandList cmdList, CommandList bundle) override { return ComputeStatus::eNoImplementation; }
+    virtual ComputeStatus destroyBundle(CommandList bundle) override { return ComputeStatus::eNoImplementation; }
+
+    virtual ComputeStatus clearViews(CommandList cmdList, ClearRequest* requests, uint32_t count) override;
 };
 
 }
@@ -0,0 +1,220 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <emmintrin.h>
+#define SL_HASH_SSE2 1
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace sl
+{
+namespace chi
+{
+namespace hash
+{
+
+//! Fast 64-bit non-cryptographic hash for large blobs (shader byte code, serialized descriptions)
+//!
+//! Follows the XXH3 long input design: eight 64-bit lanes accumulate 64-byte stripes with a 32x32->64
+//! multiply per lane, lanes are scrambled every kilobyte and folded with a 128-bit multiply at the end.
+//! SSE2 processes two lanes per instruction, the scalar path produces identical results.
+//! NOTE: Values are stable across runs and builds but are NOT compatible with the reference XXH3.
+
+constexpr uint64_t kPrime32_1 = 0x9E3779B1ull;
+constexpr uint64_t kPrime64_1 = 0x9E3779B185EBCA87ull;
+constexpr uint64_t kPrime64_2 = 0xC2B2AE3D27D4EB4Full;
+constexpr uint64_t kPrime64_3 = 0x165667B19E3779F9ull;
+constexpr uint64_t kPrime64_4 = 0x85EBCA77C2B2AE63ull;
+
+alignas(16) constexpr uint64_t kSecret[16] =
+{
+    0xbe4ba423396cfeb8ull, 0x1cad21f72c81017cull, 0xdb979083e96dd4deull, 0x1f67b3b7a4a44072ull,
+    0x78e5c0cc4ee679cbull, 0x2172ffcc7dd05a82ull, 0x8e2443f7744608b8ull, 0x4c263a81e69035e0ull,
+    0xcb00c391bb52283cull, 0xa32e531b8b65d088ull, 0x4ef90da297486471ull, 0xd8acdea946ef1938ull,
+    0x3f349ce33f76faa8ull, 0x1d4f0bc7c7bbdcf9ull, 0x3159b4cd4be0518aull, 0x647378d9c97e9fc8ull,
+};
+
+constexpr size_t kStripeSize = 64;
+constexpr size_t kStripesPerBlock = 16;
+
+inline uint64_t read64(const uint8_t* p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+//! 64x64->128 multiply folded to 64 bits
+inline uint64_t mul128Fold(uint64_t a, uint64_t b)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    uint64_t hi;
+    uint64_t lo = _umul128(a, b, &hi);
+    return lo ^ hi;
+#elif defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+#else
+    uint64_t lolo = (a & 0xffffffff) * (b & 0xffffffff);
+    uint64_t hilo = (a >> 32) * (b & 0xffffffff);
+    uint64_t lohi = (a & 0xffffffff) * (b >> 32);
+    uint64_t hihi = (a >> 32) * (b >> 32);
+    uint64_t cross = (lolo >> 32) + (hilo & 0xffffffff) + lohi;
+    uint64_t upper = (hilo >> 32) + (cross >> 32) + hihi;
+    uint64_t lower = (cross << 32) | (lolo & 0xffffffff);
+    return lower ^ upper;
+#endif
+}
+
+inline uint64_t avalanche(uint64_t h)
+{
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ull;
+    h ^= h >> 32;
+    return h;
+}
+
+inline void accumulateStripe(uint64_t* acc, const uint8_t* p, const uint64_t* secret)
+{
+#if SL_HASH_SSE2
+    auto* xacc = (__m128i*)acc;
+    for (int i = 0; i < 4; i++)
+    {
+        __m128i data = _mm_loadu_si128((const __m128i*)p + i);
+        __m128i key = _mm_loadu_si128((const __m128i*)secret + i);
+        __m128i dataKey = _mm_xor_si128(data, key);
+        __m128i product = _mm_mul_epu32(dataKey, _mm_shuffle_epi32(dataKey, _MM_SHUFFLE(0, 3, 0, 1)));
+        __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+        xacc[i] = _mm_add_epi64(xacc[i], _mm_add_epi64(product, swapped));
+    }
+#else
+    for (int i = 0; i < 8; i++)
+    {
+        uint64_t data = read64(p + i * 8);
+        uint64_t dataKey = data ^ secret[i];
+        acc[i ^ 1] += data;
+        acc[i] += (dataKey & 0xffffffff) * (dataKey >> 32);
+    }
+#endif
+}
+
+inline void scramble(uint64_t* acc, const uint64_t* secret)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        uint64_t a = acc[i];
+        a ^= a >> 47;
+        a ^= secret[i];
+        acc[i] = a * kPrime32_1;
+    }
+}
+
+//! Hashes 'size' bytes starting at 'data'
+inline uint64_t hash64(const void* data, size_t size, uint64_t seed = 0)
+{
+    auto p = (const uint8_t*)data;
+    if (size <= 16)
+    {
+        // Short inputs, typically strings
+        uint64_t lo = 0, hi = 0;
+        if (size > 8)
+        {
+            lo = read64(p);
+            hi = read64(p + size - 8);
+        }
+        else if (size >= 4)
+        {
+            uint32_t a, b;
+            memcpy(&a, p, 4);
+            memcpy(&b, p + size - 4, 4);
+            lo = ((uint64_t)a << 32) | b;
+        }
+        else if (size > 0)
+        {
+            lo = ((uint64_t)p[0] << 16) | ((uint64_t)p[size >> 1] << 8) | p[size - 1];
+        }
+        return avalanche(mul128Fold(lo ^ (kSecret[0] + seed), hi ^ (kSecret[1] - seed)) + size);
+    }
+
+    alignas(16) uint64_t acc[8] = { kPrime32_1, kPrime64_1, kPrime64_2, kPrime64_3, kPrime64_4, 0x85EBCA77ull, kPrime64_1 ^ seed, kPrime32_1 + seed };
+
+    size_t stripes = size / kStripeSize;
+    size_t stripe = 0;
+    while (stripe < stripes)
+    {
+        size_t end = stripe + kStripesPerBlock;
+        if (end > stripes) end = stripes;
+        for (; stripe < end; stripe++)
+        {
+            accumulateStripe(acc, p + stripe * kStripeSize, kSecret + (stripe & 1) * 2);
+        }
+        if (stripe % kStripesPerBlock == 0)
+        {
+            scramble(acc, kSecret + 8);
+        }
+    }
+
+    // Remainder in 16 byte chunks, last chunk overlaps the previous one so no byte is left out
+    auto tail = p + stripes * kStripeSize;
+    size_t remaining = size - stripes * kStripeSize;
+    uint64_t h = size * kPrime64_1;
+    for (size_t i = 0; i + 16 <= remaining; i += 16)
+    {
+        h += mul128Fold(read64(tail + i) ^ kSecret[(i >> 3) & 15], read64(tail + i + 8) ^ kSecret[((i >> 3) + 1) & 15]);
+    }
+    if (remaining & 15)
+    {
+        auto last = p + size - 16;
+        h += mul128Fold(read64(last) ^ kSecret[14], read64(last + 8) ^ kSecret[15]);
+    }
+
+    for (int i = 0; i < 8; i += 2)
+    {
+        h += mul128Fold(acc[i] ^ kSecret[8 + i], acc[i + 1] ^ kSecret[9 + i]);
+    }
+    return avalanche(h);
+}
+
+//! Hashes a null terminated string
+inline uint64_t hashString(const char* str, uint64_t seed = 0)
+{
+    return hash64(str, strlen(str), seed);
+}
+
+//! Hashes a trivially copyable value, handy for descriptions with no padding
+template<typename T>
+inline uint64_t hashValue(const T& v, uint64_t seed = 0)
+{
+    return hash64(&v, sizeof(T), seed);
+}
+
+}
+}
+}
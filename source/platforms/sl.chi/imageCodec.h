@@ -0,0 +1,383 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+//! Encoders for debug image dumps, see 'Generic::saveImage'
+//!
+//! All of them take tightly packed float pixels with 1 to 4 channels and produce the complete file in memory.
+namespace sl
+{
+    namespace chi
+    {
+        namespace image
+        {
+            //! Portable float map, RGB only (missing channels are zero, alpha is dropped), rows bottom to top
+            inline void encodePFM(const float* pixels, uint32_t width, uint32_t height, uint32_t channels, std::vector<uint8_t>& out)
+            {
+                const std::string header = "PF\n" + std::to_string(width) + " " + std::to_string(height) + "\n-1.0\n";
+                out.assign(header.begin(), header.end());
+                size_t offset = out.size();
+                out.resize(offset + (size_t)width * height * 3 * sizeof(float));
+                for (uint32_t y = 0; y < height; y++)
+                {
+                    // Rows are stored bottom to top, the capture data always went in as is so keep doing that
+                    for (uint32_t x = 0; x < width; x++)
+                    {
+                        float rgb[3]{};
+                        const float* src = pixels + ((size_t)y * width + x) * channels;
+                        for (uint32_t c = 0; c < std::min(channels, 3u); c++) rgb[c] = src[c];
+                        memcpy(out.data() + offset, rgb, sizeof(rgb));
+                        offset += sizeof(rgb);
+                    }
+                }
+            }
+
+            inline uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0)
+            {
+                static const auto kTable = []()
+                {
+                    std::vector<uint32_t> table(256);
+                    for (uint32_t i = 0; i < 256; i++)
+                    {
+                        uint32_t c = i;
+                        for (int k = 0; k < 8; k++) c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                        table[i] = c;
+                    }
+                    return table;
+                }();
+                crc = ~crc;
+                for (size_t i = 0; i < size; i++) crc = kTable[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+                return ~crc;
+            }
+
+            inline uint32_t adler32(const uint8_t* data, size_t size)
+            {
+                uint32_t a = 1, b = 0;
+                while (size)
+                {
+                    // Largest run before the sums can overflow
+                    size_t n = std::min<size_t>(size, 5552);
+                    size -= n;
+                    while (n--)
+                    {
+                        a += *data++;
+                        b += a;
+                    }
+                    a %= 65521;
+                    b %= 65521;
+                }
+                return (b << 16) | a;
+            }
+
+            //! Deflate with the fixed Huffman codes and a single candidate hash match finder
+            //!
+            //! Nowhere near zlib ratios but filtered image rows compress well enough and it stays tiny.
+            struct DeflateWriter
+            {
+                std::vector<uint8_t>& out;
+                uint32_t bits = 0;
+                uint32_t bitCount = 0;
+
+                void put(uint32_t value, uint32_t count)
+                {
+                    bits |= value << bitCount;
+                    bitCount += count;
+                    while (bitCount >= 8)
+                    {
+                        out.push_back((uint8_t)bits);
+                        bits >>= 8;
+                        bitCount -= 8;
+                    }
+                }
+
+                //! Huffman codes go out most significant bit first
+                void putCode(uint32_t code, uint32_t length)
+                {
+                    uint32_t reversed = 0;
+                    for (uint32_t i = 0; i < length; i++) reversed |= ((code >> i) & 1) << (length - 1 - i);
+                    put(reversed, length);
+                }
+
+                void putSymbol(uint32_t symbol)
+                {
+                    if (symbol < 144) putCode(0x30 + symbol, 8);
+                    else if (symbol < 256) putCode(0x190 + symbol - 144, 9);
+                    else if (symbol < 280) putCode(symbol - 256, 7);
+                    else putCode(0xc0 + symbol - 280, 8);
+                }
+
+                void putMatch(uint32_t length, uint32_t distance)
+                {
+                    static constexpr uint16_t kLengthBase[] = { 3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258 };
+                    static constexpr uint8_t kLengthExtra[] = { 0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0 };
+                    static constexpr uint16_t kDistanceBase[] = { 1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,1025,1537,2049,3073,4097,6145,8193,12289,16385,24577 };
+                    static constexpr uint8_t kDistanceExtra[] = { 0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13 };
+                    uint32_t l = 28;
+                    while (kLengthBase[l] > length) l--;
+                    putSymbol(257 + l);
+                    put(length - kLengthBase[l], kLengthExtra[l]);
+                    uint32_t d = 29;
+                    while (kDistanceBase[d] > distance) d--;
+                    putCode(d, 5);
+                    put(distance - kDistanceBase[d], kDistanceExtra[d]);
+                }
+
+                void flush()
+                {
+                    if (bitCount) out.push_back((uint8_t)bits);
+                    bits = 0;
+                    bitCount = 0;
+                }
+            };
+
+            //! zlib stream (RFC 1950) holding a single fixed Huffman deflate block
+            inline void zlibCompress(const uint8_t* data, size_t size, std::vector<uint8_t>& out)
+            {
+                constexpr uint32_t kHashLog = 15;
+                constexpr size_t kWindow = 32768;
+                constexpr size_t kMinMatch = 3;
+                constexpr size_t kMaxMatch = 258;
+
+                out.push_back(0x78);
+                out.push_back(0x01);
+                DeflateWriter writer{ out };
+                writer.put(1, 1); // Final block
+                writer.put(1, 2); // Fixed Huffman codes
+
+                std::vector<int64_t> table(size_t(1) << kHashLog, -1);
+                auto hash = [data](size_t i)->uint32_t
+                {
+                    uint32_t v = data[i] | (data[i + 1] << 8) | (data[i + 2] << 16);
+                    return (v * 2654435761u) >> (32 - kHashLog);
+                };
+                size_t i = 0;
+                while (i < size)
+                {
+                    size_t length = 0;
+                    size_t distance = 0;
+                    if (i + kMinMatch <= size)
+                    {
+                        uint32_t h = hash(i);
+                        int64_t candidate = table[h];
+                        table[h] = (int64_t)i;
+                        if (candidate >= 0 && i - (size_t)candidate <= kWindow)
+                        {
+                            size_t limit = std::min(kMaxMatch, size - i);
+                            while (length < limit && data[candidate + length] == data[i + length]) length++;
+                            distance = i - (size_t)candidate;
+                        }
+                    }
+                    if (length >= kMinMatch)
+                    {
+                        writer.putMatch((uint32_t)length, (uint32_t)distance);
+                        // Keep the table warm inside the match, cheap and helps long runs
+                        for (size_t k = 1; k < length && i + k + kMinMatch <= size; k++) table[hash(i + k)] = (int64_t)(i + k);
+                        i += length;
+                    }
+                    else
+                    {
+                        writer.putSymbol(data[i]);
+                        i++;
+                    }
+                }
+                writer.putSymbol(256);
+                writer.flush();
+
+                uint32_t adler = adler32(data, size);
+                for (int shift = 24; shift >= 0; shift -= 8) out.push_back((uint8_t)(adler >> shift));
+            }
+
+            //! 8-bit PNG, values are clamped to [0,1], 1 channel is gray, 2 is gray and alpha, 3 RGB and 4 RGBA
+            inline void encodePNG(const float* pixels, uint32_t width, uint32_t height, uint32_t channels, std::vector<uint8_t>& out)
+            {
+                const size_t stride = (size_t)width * channels;
+                std::vector<uint8_t> filtered((stride + 1) * height);
+                std::vector<uint8_t> previous(stride), current(stride), candidate(stride);
+                for (uint32_t y = 0; y < height; y++)
+                {
+                    for (size_t i = 0; i < stride; i++)
+                    {
+                        current[i] = (uint8_t)(std::clamp(pixels[y * stride + i], 0.0f, 1.0f) * 255.0f + 0.5f);
+                    }
+                    // Pick the filter with the smallest sum of absolute differences, the usual heuristic
+                    uint8_t* row = filtered.data() + y * (stride + 1);
+                    uint64_t best = UINT64_MAX;
+                    for (uint8_t filter = 0; filter < 5; filter++)
+                    {
+                        uint64_t sum = 0;
+                        for (size_t i = 0; i < stride; i++)
+                        {
+                            int a = i >= channels ? current[i - channels] : 0;
+                            int b = y ? previous[i] : 0;
+                            int c = i >= channels && y ? previous[i - channels] : 0;
+                            int predictor = 0;
+                            switch (filter)
+                            {
+                                case 1: predictor = a; break;
+                                case 2: predictor = b; break;
+                                case 3: predictor = (a + b) / 2; break;
+                                case 4:
+                                {
+                                    int p = a + b - c;
+                                    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+                                    predictor = pa <= pb && pa <= pc ? a : (pb <= pc ? b : c);
+                                    break;
+                                }
+                            }
+                            candidate[i] = (uint8_t)(current[i] - predictor);
+                            sum += (uint64_t)abs((int8_t)candidate[i]);
+                        }
+                        if (sum < best)
+                        {
+                            best = sum;
+                            row[0] = filter;
+                            memcpy(row + 1, candidate.data(), stride);
+                        }
+                    }
+                    std::swap(previous, current);
+                }
+
+                auto chunk = [&out](const char* type, const std::vector<uint8_t>& data)
+                {
+                    uint32_t size = (uint32_t)data.size();
+                    for (int shift = 24; shift >= 0; shift -= 8) out.push_back((uint8_t)(size >> shift));
+                    size_t start = out.size();
+                    out.insert(out.end(), type, type + 4);
+                    out.insert(out.end(), data.begin(), data.end());
+                    uint32_t crc = crc32(out.data() + start, out.size() - start);
+                    for (int shift = 24; shift >= 0; shift -= 8) out.push_back((uint8_t)(crc >> shift));
+                };
+
+                static constexpr uint8_t kSignature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+                static constexpr uint8_t kColorTypes[] = { 0, 4, 2, 6 };
+                out.assign(kSignature, kSignature + sizeof(kSignature));
+                std::vector<uint8_t> header;
+                for (uint32_t v : { width, height })
+                {
+                    for (int shift = 24; shift >= 0; shift -= 8) header.push_back((uint8_t)(v >> shift));
+                }
+                header.insert(header.end(), { 8, kColorTypes[channels - 1], 0, 0, 0 });
+                chunk("IHDR", header);
+                std::vector<uint8_t> compressed;
+                zlibCompress(filtered.data(), filtered.size(), compressed);
+                chunk("IDAT", compressed);
+                chunk("IEND", {});
+            }
+
+            inline uint16_t floatToHalf(float value)
+            {
+                uint32_t f;
+                memcpy(&f, &value, sizeof(f));
+                uint32_t sign = (f >> 16) & 0x8000;
+                int32_t exponent = (int32_t)((f >> 23) & 0xff) - 127 + 15;
+                uint32_t mantissa = f & 0x7fffff;
+                if (((f >> 23) & 0xff) == 0xff)
+                {
+                    // Inf stays inf, NaN stays NaN
+                    return (uint16_t)(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+                }
+                if (exponent >= 31) return (uint16_t)(sign | 0x7c00);
+                if (exponent <= 0)
+                {
+                    if (exponent < -10) return (uint16_t)sign;
+                    mantissa |= 0x800000;
+                    uint32_t shift = 14 - exponent;
+                    uint32_t half = mantissa >> shift;
+                    // Round to nearest even
+                    uint32_t remainder = mantissa & ((1u << shift) - 1);
+                    uint32_t halfway = 1u << (shift - 1);
+                    if (remainder > halfway || (remainder == halfway && (half & 1))) half++;
+                    return (uint16_t)(sign | half);
+                }
+                uint32_t half = sign | (exponent << 10) | (mantissa >> 13);
+                uint32_t remainder = mantissa & 0x1fff;
+                // Carry into the exponent is the correct result, up to and including inf
+                if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) half++;
+                return (uint16_t)half;
+            }
+
+            //! Uncompressed scanline OpenEXR, 1 channel is Y, then R, G, B and A
+            inline void encodeEXR(const float* pixels, uint32_t width, uint32_t height, uint32_t channels, bool halfFloat, std::vector<uint8_t>& out)
+            {
+                auto putInt = [&out](uint32_t v) { for (int i = 0; i < 4; i++) out.push_back((uint8_t)(v >> (8 * i))); };
+                auto putFloat = [&putInt](float v) { uint32_t u; memcpy(&u, &v, sizeof(u)); putInt(u); };
+                auto putString = [&out](const char* s) { out.insert(out.end(), s, s + strlen(s) + 1); };
+                auto attribute = [&](const char* name, const char* type, uint32_t size) { putString(name); putString(type); putInt(size); };
+
+                // Channels have to be sorted by name, 'order' maps them back to the source channel
+                static constexpr const char* kNames[][4] = { { "Y" }, { "G", "R" }, { "B", "G", "R" }, { "A", "B", "G", "R" } };
+                static constexpr uint32_t kOrder[][4] = { { 0 }, { 1, 0 }, { 2, 1, 0 }, { 3, 2, 1, 0 } };
+                const uint32_t pixelType = halfFloat ? 1 : 2;
+                const uint32_t bytesPerValue = halfFloat ? 2 : 4;
+
+                out.clear();
+                putInt(20000630);
+                putInt(2);
+                attribute("channels", "chlist", channels * 18 + 1);
+                for (uint32_t c = 0; c < channels; c++)
+                {
+                    putString(kNames[channels - 1][c]);
+                    putInt(pixelType);
+                    putInt(0); // pLinear and reserved
+                    putInt(1);
+                    putInt(1);
+                }
+                out.push_back(0);
+                attribute("compression", "compression", 1);
+                out.push_back(0);
+                attribute("dataWindow", "box2i", 16);
+                for (uint32_t v : { 0u, 0u, width - 1, height - 1 }) putInt(v);
+                attribute("displayWindow", "box2i", 16);
+                for (uint32_t v : { 0u, 0u, width - 1, height - 1 }) putInt(v);
+                attribute("lineOrder", "lineOrder", 1);
+                out.push_back(0);
+                attribute("pixelAspectRatio", "float", 4);
+                putFloat(1.0f);
+                attribute("screenWindowCenter", "v2f", 8);
+                putFloat(0.0f);
+                putFloat(0.0f);
+                attribute("screenWindowWidth", "float", 4);
+                putFloat(1.0f);
+                out.push_back(0);
+
+                // One scanline per block, offset table first
+                const uint32_t lineBytes = width * channels * bytesPerValue;
+                const uint64_t first = out.size() + (uint64_t)height * sizeof(uint64_t);
+                for (uint32_t y = 0; y < height; y++)
+                {
+                    uint64_t offset = first + (uint64_t)y * (lineBytes + 8);
+                    putInt((uint32_t)offset);
+                    putInt((uint32_t)(offset >> 32));
+                }
+                out.reserve(out.size() + (size_t)height * (lineBytes + 8));
+                for (uint32_t y = 0; y < height; y++)
+                {
+                    putInt(y);
+                    putInt(lineBytes);
+                    for (uint32_t c = 0; c < channels; c++)
+                    {
+                        const float* src = pixels + (size_t)y * width * channels + kOrder[channels - 1][c];
+                        for (uint32_t x = 0; x < width; x++)
+                        {
+                            float v = src[(size_t)x * channels];
+                            if (halfFloat)
+                            {
+                                uint16_t h = floatToHalf(v);
+                                out.push_back((uint8_t)h);
+                                out.push_back((uint8_t)(h >> 8));
+                            }
+                            else
+                            {
+                                putFloat(v);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
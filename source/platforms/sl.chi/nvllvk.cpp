@@ -27,6 +27,8 @@
 #include "source/core/sl.security/secureLoadLibrary.h"
 #include "nvllvk.h"
 
+#include <mutex>
+
 #include "external/reflex-sdk-vk/inc/NvLowLatencyVk.h"
 
 #define LL_CHECK(f) {auto _r = f;if(_r != NvLL_VK_Status::NVLL_VK_OK){SL_LOG_ERROR( "%s failed - error %u",#f,_r); return ComputeStatus::eError;}}
@@ -155,6 +157,11 @@ public:
 
     virtual ComputeStatus sleep() override
     {
+        if (!m_lowLatencySemaphore)
+        {
+            // Device failed to initialize for low latency, nothing would ever signal the wait
+            return ComputeStatus::eError;
+        }
         reflexSemaphoreValue++;
         LL_CHECK(NvLL_VK_Sleep(m_device, reflexSemaphoreValue));
         VkSemaphoreWaitInfo waitInfo;
@@ -164,7 +171,11 @@ public:
         waitInfo.semaphoreCount = 1;
         waitInfo.pSemaphores = &m_lowLatencySemaphore;
         waitInfo.pValues = &reflexSemaphoreValue;
-        m_ddt.WaitSemaphores(m_device, &waitInfo, kMaxSemaphoreWaitUs);
+        auto res = m_ddt.WaitSemaphores(m_device, &waitInfo, kMaxSemaphoreWaitUs);
+        if (res != VK_SUCCESS)
+        {
+            SL_LOG_WARN_ONCE("Low latency sleep wait failed - error %d", res);
+        }
         return ComputeStatus::eOk;
     }
 
@@ -202,6 +213,259 @@ IReflexVk* CreateNvLowLatencyVk(VkDevice device, param::IParameters* params)
     return ptr;
 }
 
+#if defined(VK_NV_low_latency2)
+
+#define VK_LL_CHECK(f) {auto _r = f;if(_r != VK_SUCCESS){SL_LOG_ERROR( "%s failed - error %d",#f,_r); return ComputeStatus::eError;}}
+
+//! Native VK_NV_low_latency2 path, same semantics as NvLowLatencyVk but without NvLowLatencyVk.dll.
+//!
+//! Every call targets the swapchain the interposer created with latency mode enabled, sleep mode
+//! is cached and re-applied whenever that swapchain changes since the driver tracks it per swapchain.
+class LowLatency2Vk : public IReflexVk
+{
+private:
+    VkDevice m_device{};
+    VkLayerDispatchTable m_ddt{};
+    interposer::VkTable* m_vk{};
+
+    PFN_vkSetLatencySleepModeNV m_setLatencySleepMode{};
+    PFN_vkLatencySleepNV m_latencySleep{};
+    PFN_vkSetLatencyMarkerNV m_setLatencyMarker{};
+    PFN_vkGetLatencyTimingsNV m_getLatencyTimings{};
+    PFN_vkQueueNotifyOutOfBandNV m_queueNotifyOutOfBand{};
+
+    VkSemaphore m_lowLatencySemaphore{};
+    uint64_t reflexSemaphoreValue = 0;
+
+    std::mutex m_mtxSleepMode;
+    VkLatencySleepModeInfoNV m_sleepMode{ VK_STRUCTURE_TYPE_LATENCY_SLEEP_MODE_INFO_NV };
+    VkSwapchainKHR m_sleepModeSwapchain{};
+
+    //! Returns the current latency swapchain with our sleep mode applied, null until the host creates one
+    VkSwapchainKHR getSwapchain()
+    {
+        VkSwapchainKHR swapchain = m_vk->latencySwapchain;
+        if (swapchain && swapchain != m_sleepModeSwapchain)
+        {
+            std::scoped_lock lock(m_mtxSleepMode);
+            if (swapchain != m_sleepModeSwapchain && m_setLatencySleepMode(m_device, swapchain, &m_sleepMode) == VK_SUCCESS)
+            {
+                m_sleepModeSwapchain = swapchain;
+            }
+        }
+        return swapchain;
+    }
+
+    static bool toLatencyMarker(PCLMarker marker, VkLatencyMarkerNV& out)
+    {
+        switch (marker)
+        {
+            case PCLMarker::eSimulationStart: out = VK_LATENCY_MARKER_SIMULATION_START_NV; return true;
+            case PCLMarker::eSimulationEnd: out = VK_LATENCY_MARKER_SIMULATION_END_NV; return true;
+            case PCLMarker::eRenderSubmitStart: out = VK_LATENCY_MARKER_RENDERSUBMIT_START_NV; return true;
+            case PCLMarker::eRenderSubmitEnd: out = VK_LATENCY_MARKER_RENDERSUBMIT_END_NV; return true;
+            case PCLMarker::ePresentStart: out = VK_LATENCY_MARKER_PRESENT_START_NV; return true;
+            case PCLMarker::ePresentEnd: out = VK_LATENCY_MARKER_PRESENT_END_NV; return true;
+            case PCLMarker::eControllerInputSample: out = VK_LATENCY_MARKER_INPUT_SAMPLE_NV; return true;
+            case PCLMarker::eTriggerFlash: out = VK_LATENCY_MARKER_TRIGGER_FLASH_NV; return true;
+            case PCLMarker::eOutOfBandRenderSubmitStart: out = VK_LATENCY_MARKER_OUT_OF_BAND_RENDERSUBMIT_START_NV; return true;
+            case PCLMarker::eOutOfBandRenderSubmitEnd: out = VK_LATENCY_MARKER_OUT_OF_BAND_RENDERSUBMIT_END_NV; return true;
+            case PCLMarker::eOutOfBandPresentStart: out = VK_LATENCY_MARKER_OUT_OF_BAND_PRESENT_START_NV; return true;
+            case PCLMarker::eOutOfBandPresentEnd: out = VK_LATENCY_MARKER_OUT_OF_BAND_PRESENT_END_NV; return true;
+            default: return false;
+        }
+    }
+
+public:
+    LowLatency2Vk(interposer::VkTable* vk) : m_vk(vk) {}
+
+    ComputeStatus init(VkDevice device, param::IParameters* params)
+    {
+        m_device = device;
+        if (!m_vk->lowLatency2)
+        {
+            return ComputeStatus::eNoImplementation;
+        }
+
+        // Entry points are only exposed when the extension is enabled on this device
+        m_setLatencySleepMode = (PFN_vkSetLatencySleepModeNV)m_vk->getDeviceProcAddr(device, "vkSetLatencySleepModeNV");
+        m_latencySleep = (PFN_vkLatencySleepNV)m_vk->getDeviceProcAddr(device, "vkLatencySleepNV");
+        m_setLatencyMarker = (PFN_vkSetLatencyMarkerNV)m_vk->getDeviceProcAddr(device, "vkSetLatencyMarkerNV");
+        m_getLatencyTimings = (PFN_vkGetLatencyTimingsNV)m_vk->getDeviceProcAddr(device, "vkGetLatencyTimingsNV");
+        m_queueNotifyOutOfBand = (PFN_vkQueueNotifyOutOfBandNV)m_vk->getDeviceProcAddr(device, "vkQueueNotifyOutOfBandNV");
+        if (!m_setLatencySleepMode || !m_latencySleep || !m_setLatencyMarker || !m_getLatencyTimings || !m_queueNotifyOutOfBand)
+        {
+            SL_LOG_WARN("'%s' entry points are missing", VK_NV_LOW_LATENCY_2_EXTENSION_NAME);
+            return ComputeStatus::eNoImplementation;
+        }
+        return ComputeStatus::eOk;
+    }
+
+    virtual ComputeStatus shutdown() override
+    {
+        if (m_lowLatencySemaphore)
+        {
+            m_ddt.DestroySemaphore(m_device, m_lowLatencySemaphore, nullptr);
+            m_lowLatencySemaphore = {};
+        }
+        return ComputeStatus::eOk;
+    }
+
+    virtual void initDispatchTable(VkLayerDispatchTable table) override
+    {
+        m_ddt = table;
+
+        VkSemaphoreTypeCreateInfo timelineInfo{ VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO };
+        timelineInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        timelineInfo.initialValue = reflexSemaphoreValue;
+        VkSemaphoreCreateInfo createInfo{ VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, &timelineInfo };
+        if (m_ddt.CreateSemaphore(m_device, &createInfo, nullptr, &m_lowLatencySemaphore) != VK_SUCCESS)
+        {
+            SL_LOG_ERROR("Failed to create low latency semaphore");
+            m_lowLatencySemaphore = {};
+        }
+    }
+
+    virtual ComputeStatus setSleepMode(const ReflexOptions& consts) override
+    {
+        VkSwapchainKHR swapchain = m_vk->latencySwapchain;
+        std::scoped_lock lock(m_mtxSleepMode);
+        m_sleepMode.lowLatencyMode = consts.mode != ReflexMode::eOff;
+        m_sleepMode.lowLatencyBoost = consts.mode == ReflexMode::eLowLatencyWithBoost;
+        m_sleepMode.minimumIntervalUs = consts.frameLimitUs;
+        // Without a swapchain the mode is applied as soon as the host creates one
+        m_sleepModeSwapchain = {};
+        if (swapchain)
+        {
+            VK_LL_CHECK(m_setLatencySleepMode(m_device, swapchain, &m_sleepMode));
+            m_sleepModeSwapchain = swapchain;
+        }
+        return ComputeStatus::eOk;
+    }
+
+    virtual ComputeStatus getSleepStatus(ReflexState& settings) override
+    {
+        // Extension has no sleep status query, low latency availability is reported by the plugin
+        return ComputeStatus::eOk;
+    }
+
+    virtual ComputeStatus getReport(ReflexState& settings) override
+    {
+        auto swapchain = getSwapchain();
+        if (!swapchain)
+        {
+            return ComputeStatus::eOk;
+        }
+        constexpr uint32_t kMaxReports = sizeof(ReflexState::frameReport) / sizeof(ReflexReport);
+        VkLatencyTimingsFrameReportNV timings[kMaxReports];
+        for (auto& t : timings)
+        {
+            t = { VK_STRUCTURE_TYPE_LATENCY_TIMINGS_FRAME_REPORT_NV };
+        }
+        VkGetLatencyMarkerInfoNV info{ VK_STRUCTURE_TYPE_GET_LATENCY_MARKER_INFO_NV };
+        info.timingCount = kMaxReports;
+        info.pTimings = timings;
+        m_getLatencyTimings(m_device, swapchain, &info);
+        for (uint32_t i = 0; i < kMaxReports; i++)
+        {
+            // Keep the layout NvLowLatencyVk produces, oldest report first and unused slots cleared
+            const auto& t = timings[i];
+            auto& report = settings.frameReport[i];
+            report = {};
+            if (i >= info.timingCount)
+            {
+                continue;
+            }
+            report.frameID = t.presentID;
+            report.inputSampleTime = t.inputSampleTimeUs;
+            report.simStartTime = t.simStartTimeUs;
+            report.simEndTime = t.simEndTimeUs;
+            report.renderSubmitStartTime = t.renderSubmitStartTimeUs;
+            report.renderSubmitEndTime = t.renderSubmitEndTimeUs;
+            report.presentStartTime = t.presentStartTimeUs;
+            report.presentEndTime = t.presentEndTimeUs;
+            report.driverStartTime = t.driverStartTimeUs;
+            report.driverEndTime = t.driverEndTimeUs;
+            report.osRenderQueueStartTime = t.osRenderQueueStartTimeUs;
+            report.osRenderQueueEndTime = t.osRenderQueueEndTimeUs;
+            report.gpuRenderStartTime = t.gpuRenderStartTimeUs;
+            report.gpuRenderEndTime = t.gpuRenderEndTimeUs;
+            report.gpuActiveRenderTimeUs = (uint32_t)(t.gpuRenderEndTimeUs - t.gpuRenderStartTimeUs);
+            report.gpuFrameTimeUs = i == 0 ? 0 : (uint32_t)(t.gpuRenderEndTimeUs - timings[i - 1].gpuRenderEndTimeUs);
+        }
+        return ComputeStatus::eOk;
+    }
+
+    virtual ComputeStatus sleep() override
+    {
+        auto swapchain = getSwapchain();
+        if (!swapchain || !m_lowLatencySemaphore)
+        {
+            // Nothing to pace against yet
+            return ComputeStatus::eOk;
+        }
+        reflexSemaphoreValue++;
+        VkLatencySleepInfoNV sleepInfo{ VK_STRUCTURE_TYPE_LATENCY_SLEEP_INFO_NV };
+        sleepInfo.signalSemaphore = m_lowLatencySemaphore;
+        sleepInfo.value = reflexSemaphoreValue;
+        VK_LL_CHECK(m_latencySleep(m_device, swapchain, &sleepInfo));
+        // Driver signals the semaphore when the frame should start, block on it instead of spinning
+        VkSemaphoreWaitInfo waitInfo{ VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO };
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_lowLatencySemaphore;
+        waitInfo.pValues = &reflexSemaphoreValue;
+        auto res = m_ddt.WaitSemaphores(m_device, &waitInfo, kMaxSemaphoreWaitUs);
+        if (res != VK_SUCCESS)
+        {
+            SL_LOG_WARN_ONCE("Low latency sleep wait failed - error %d", res);
+        }
+        return ComputeStatus::eOk;
+    }
+
+    virtual ComputeStatus setMarker(PCLMarker marker, uint64_t frameId) override
+    {
+        VkSetLatencyMarkerInfoNV info{ VK_STRUCTURE_TYPE_SET_LATENCY_MARKER_INFO_NV };
+        auto swapchain = getSwapchain();
+        if (!swapchain || !toLatencyMarker(marker, info.marker))
+        {
+            // PC latency ping and late warp markers have no equivalent in the extension
+            return ComputeStatus::eOk;
+        }
+        info.presentID = frameId;
+        m_setLatencyMarker(m_device, swapchain, &info);
+        return ComputeStatus::eOk;
+    }
+
+    virtual ComputeStatus notifyOutOfBandCommandQueue(ChiCommandQueue* queue, OutOfBandCommandQueueType type) override
+    {
+        VkOutOfBandQueueTypeInfoNV info{ VK_STRUCTURE_TYPE_OUT_OF_BAND_QUEUE_TYPE_INFO_NV };
+        info.queueType = type == OutOfBandCommandQueueType::eOutOfBandPresent ? VK_OUT_OF_BAND_QUEUE_TYPE_PRESENT_NV : VK_OUT_OF_BAND_QUEUE_TYPE_RENDER_NV;
+        m_queueNotifyOutOfBand((VkQueue)((CommandQueueVk*)queue)->native, &info);
+        return ComputeStatus::eOk;
+    }
+
+    virtual ComputeStatus setAsyncFrameMarker(CommandQueue queue, PCLMarker marker, uint64_t frameId) override
+    {
+        // Markers are per swapchain in VK, queue association comes from notifyOutOfBandCommandQueue
+        return setMarker(marker, frameId);
+    }
+};
+
+IReflexVk* CreateLowLatency2Vk(VkDevice device, interposer::VkTable* vk)
+{
+    auto ptr = new LowLatency2Vk(vk);
+    ComputeStatus res = ptr->init(device, nullptr);
+    if (res != ComputeStatus::eOk)
+    {
+        SL_LOG_INFO("'%s' not available, using NvLowLatencyVk", VK_NV_LOW_LATENCY_2_EXTENSION_NAME);
+        delete ptr;
+        ptr = nullptr;
+    }
+    return ptr;
+}
+
+#endif
+
 } // namespace chi
 } // namespace sl
 
@@ -51,6 +51,11 @@ public:
 
 IReflexVk* CreateNvLowLatencyVk(VkDevice device, param::IParameters* params);
 
+#if defined(VK_NV_low_latency2)
+//! Native VK_NV_low_latency2 path, returns null when the interposer did not enable the extension on this device
+IReflexVk* CreateLowLatency2Vk(VkDevice device, interposer::VkTable* vk);
+#endif
+
 #endif //SL_WITH_NVLLVK
 
 }
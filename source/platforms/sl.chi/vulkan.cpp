@@ -21,6 +21,7 @@
 */
 
 #include "source/core/sl.log/log.h"
+#include "source/core/sl.file/file.h"
 #include "source/platforms/sl.chi/vulkan.h"
 #include "source/core/sl.param/parameters.h"
 #include "source/core/sl.security/secureLoadLibrary.h"
@@ -69,7 +70,7 @@ void KernelDataVK::destroy(const VkLayerDispatchTable& ddt, VkDevice device)
 
 struct Allocator
 {
-    void init(VkCommandPool pAllocator, VkLayerDispatchTable* pDdt, ICompute* pCompute, VkDevice pDevice, std::string sDebugName)
+    void init(VkCommandPool pAllocator, VkLayerDispatchTable* pDdt, ICompute* pCompute, VkDevice pDevice, std::string sDebugName, CommandBufferSet* pNonGraphics, CommandQueueType queueType)
     {
         destroy();
 
@@ -78,6 +79,8 @@ struct Allocator
         m_pCompute = pCompute;
         m_pDevice = pDevice;
         m_sDebugName = sDebugName;
+        m_pNonGraphics = pNonGraphics;
+        m_queueType = queueType;
 
         // at all times we want to have at least one command buffer - because we have getCommandBuffer() function
         TimedCommandBuffer cmdBuffer;
@@ -105,6 +108,7 @@ struct Allocator
         m_pDdt = nullptr;
         m_pCompute = nullptr;
         m_pDevice = nullptr;
+        m_pNonGraphics = nullptr;
         m_sDebugName.clear();
     }
 
@@ -176,10 +180,20 @@ struct Allocator
         r.native = cmdBuffer;
         r.type = (ResourceType)ResourceType::eCommandBuffer;
         m_pCompute->setDebugName(&r, (m_sDebugName + "_command_buffer").c_str());
+        if (m_pNonGraphics)
+        {
+            std::scoped_lock lock(m_pNonGraphics->mutex);
+            m_pNonGraphics->buffers[cmdBuffer] = m_queueType;
+        }
         return cmdBuffer;
     }
     void freeCmdBuffer(VkCommandBuffer cmdBuffer)
     {
+        if (m_pNonGraphics)
+        {
+            std::scoped_lock lock(m_pNonGraphics->mutex);
+            m_pNonGraphics->buffers.erase(cmdBuffer);
+        }
         m_pDdt->FreeCommandBuffers(m_pDevice, m_pAllocator, 1, &cmdBuffer);
     }
 
@@ -189,6 +203,8 @@ struct Allocator
     VkLayerDispatchTable* m_pDdt = nullptr;
     ICompute* m_pCompute = nullptr;
     VkDevice m_pDevice = nullptr;
+    CommandBufferSet* m_pNonGraphics = nullptr;
+    CommandQueueType m_queueType = CommandQueueType::eGraphics;
     std::string m_sDebugName;
 };
 
@@ -229,7 +245,7 @@ class CommandListContextVK : public ICommandListContext
 
 public:
 
-    void init(ICompute* c, interposer::VkTable* vkMap, const char* debugName, VkDevice dev, CommandQueueVk* queue, uint32_t count)
+    void init(ICompute* c, interposer::VkTable* vkMap, const char* debugName, VkDevice dev, CommandQueueVk* queue, uint32_t count, CommandBufferSet* nonGraphics)
     {
         m_compute = c;
         m_device = dev;
@@ -308,7 +324,7 @@ public:
                 r.native = allocator;
                 r.type = (ResourceType)ResourceType::eCommandPool;
                 m_compute->setDebugName(&r, (std::string(debugName) + "_command_pool").c_str());
-                m_allocators[i].init(allocator, &m_ddt, m_compute, m_device, debugName);
+                m_allocators[i].init(allocator, &m_ddt, m_compute, m_device, debugName, queue->queueType == CommandQueueType::eGraphics ? nullptr : nonGraphics, queue->queueType);
             }
 
         }
@@ -805,6 +821,64 @@ VkAccessFlags toVkAccessFlags(ResourceState state)
     }
 }
 
+//! Unlike 'toVkAccessFlags' these accumulate per state bit, states which could mean anything map to all commands
+VkPipelineStageFlags2 toVkPipelineStageFlags2(ResourceState state, CommandQueueType queueType)
+{
+    bool graphics = queueType == CommandQueueType::eGraphics;
+    if (!graphics && queueType != CommandQueueType::eCompute)
+    {
+        return VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    }
+    if (state == ResourceState::eUnknown || state & (ResourceState::eGeneral | ResourceState::ePresent | ResourceState::eGenericRead | ResourceState::eUndefined |
+        ResourceState::eAccelStructRead | ResourceState::eAccelStructWrite))
+    {
+        return VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+    }
+
+    // Queues without graphics support only accept compute and transfer stages
+    const VkPipelineStageFlags2 shaderStages = graphics ? VK_PIPELINE_STAGE_2_PRE_RASTERIZATION_SHADERS_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+
+    VkPipelineStageFlags2 stages = 0;
+    if (state & ResourceState::eVertexBuffer) stages |= VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT;
+    if (state & ResourceState::eIndexBuffer) stages |= VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT;
+    if (state & ResourceState::eArgumentBuffer) stages |= VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
+    if (state & (ResourceState::eConstantBuffer | ResourceState::eTextureRead | ResourceState::eStorageRW)) stages |= shaderStages;
+    // Storage images are also cleared with vkCmdClearColorImage, see 'toVkAccessFlags'
+    if (state & ResourceState::eStorageWrite) stages |= VK_PIPELINE_STAGE_2_CLEAR_BIT;
+    if (state & ResourceState::eColorAttachmentRW) stages |= VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+    if (state & ResourceState::eDepthStencilAttachmentRW) stages |= VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+    if (state & (ResourceState::eCopySource | ResourceState::eCopyDestination | ResourceState::eResolveSource | ResourceState::eResolveDestination)) stages |= VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT;
+    if (!graphics)
+    {
+        stages &= VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT | VK_PIPELINE_STAGE_2_CLEAR_BIT;
+    }
+    return stages ? stages : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+}
+
+VkAccessFlags2 toVkAccessFlags2(ResourceState state)
+{
+    if (state == ResourceState::eUnknown || state & ResourceState::eGeneral)
+    {
+        return VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+    }
+    VkAccessFlags2 access = 0;
+    if (state & ResourceState::eVertexBuffer) access |= VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT;
+    if (state & ResourceState::eIndexBuffer) access |= VK_ACCESS_2_INDEX_READ_BIT;
+    if (state & ResourceState::eConstantBuffer) access |= VK_ACCESS_2_UNIFORM_READ_BIT;
+    if (state & ResourceState::eArgumentBuffer) access |= VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT;
+    if (state & (ResourceState::eTextureRead | ResourceState::eStorageRead)) access |= VK_ACCESS_2_SHADER_READ_BIT;
+    if (state & ResourceState::eStorageWrite) access |= VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    if (state & ResourceState::eColorAttachmentRead) access |= VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT;
+    if (state & ResourceState::eColorAttachmentWrite) access |= VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+    if (state & ResourceState::eDepthStencilAttachmentRead) access |= VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+    if (state & ResourceState::eDepthStencilAttachmentWrite) access |= VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    if (state & (ResourceState::eCopySource | ResourceState::eResolveSource)) access |= VK_ACCESS_2_TRANSFER_READ_BIT;
+    if (state & (ResourceState::eCopyDestination | ResourceState::eResolveDestination)) access |= VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    if (state & ResourceState::eGenericRead) access |= VK_ACCESS_2_MEMORY_READ_BIT;
+    if (state & (ResourceState::eAccelStructRead | ResourceState::eAccelStructWrite)) access |= VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+    return access;
+}
+
 VkImageAspectFlags toVkAspectFlags(uint32_t nativeFormat, bool isImageViewForTexture, bool isImageViewTypeStencil)
 {
     switch (nativeFormat)
@@ -836,6 +910,10 @@ DispatchData::~DispatchData()
                 poolDescCombo.descSetData.descSet.clear();
                 poolDescCombo.descSetData = {};
                 pddt->DestroyDescriptorPool(device, poolDescCombo.pool, nullptr);
+                if (poolDescCombo.updateTemplate)
+                {
+                    pddt->DestroyDescriptorUpdateTemplate(device, poolDescCombo.updateTemplate, nullptr);
+                }
             }
         }
     }
@@ -1080,12 +1158,6 @@ ComputeStatus Vulkan::init(Device device, param::IParameters* params)
     m_device = (VkDevice)deviceArray[1];
     m_physicalDevice = (VkPhysicalDevice)deviceArray[2];
 
-    #ifdef SL_WITH_NVLLVK
-    m_reflex = CreateNvLowLatencyVk(m_device, params);
-    #else
-    #error "Not implemented"
-    #endif
-    
     // For callbacks we just need VkDevice
     Generic::init(m_device, params);
 
@@ -1107,12 +1179,27 @@ ComputeStatus Vulkan::init(Device device, param::IParameters* params)
     m_vk->opticalFlowQueueFamily = vk->opticalFlowQueueFamily;
     m_vk->opticalFlowQueueIndex = vk->opticalFlowQueueIndex;
     m_vk->opticalFlowQueueCreateFlags = vk->opticalFlowQueueCreateFlags;
+    m_vk->descriptorBuffer = vk->descriptorBuffer;
+    m_vk->synchronization2 = vk->synchronization2;
     m_vk->hostGraphicsComputeQueueInfo = vk->hostGraphicsComputeQueueInfo;
     m_vk->mapVulkanInstanceAPI(m_instance);
     m_vk->mapVulkanDeviceAPI(m_device);
     m_ddt = m_vk->dispatchDeviceMap[m_device];
     m_idt = m_vk->dispatchInstanceMap[m_instance];
 
+    #ifdef SL_WITH_NVLLVK
+    #if defined(VK_NV_low_latency2)
+    // Prefer the native extension when the interposer managed to enable it
+    m_reflex = CreateLowLatency2Vk(m_device, vk);
+    #endif
+    if (!m_reflex)
+    {
+        m_reflex = CreateNvLowLatencyVk(m_device, params);
+    }
+    #else
+    #error "Not implemented"
+    #endif
+
     if (m_reflex)
     {
         m_reflex->initDispatchTable(m_ddt);
@@ -1178,6 +1265,12 @@ ComputeStatus Vulkan::init(Device device, param::IParameters* params)
     }
     m_idt.GetPhysicalDeviceMemoryProperties(m_physicalDevice, &m_vkPhysicalDeviceMemoryProperties);
 
+    loadPipelineCache();
+    CHI_VALIDATE(initDescriptorBuffer());
+
+    m_useSynchronization2 = m_vk->synchronization2 && m_ddt.CmdPipelineBarrier2;
+    SL_LOG_INFO("Barriers recorded via %s", m_useSynchronization2 ? "vkCmdPipelineBarrier2" : "vkCmdPipelineBarrier");
+
     // Create the descriptor pool, layout, and set for image view clears
     VkDescriptorSetLayoutBinding bindings[2] = { };
     bindings[0].binding = 0;
@@ -1231,7 +1324,7 @@ ComputeStatus Vulkan::init(Device device, param::IParameters* params)
     pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
     pipelineInfo.stage.module = csm;
     pipelineInfo.stage.pName = "main";
-    result = m_ddt.CreateComputePipelines(m_device, nullptr, 1, &pipelineInfo, 0, &m_imageViewClear.doClear);
+    result = m_ddt.CreateComputePipelines(m_device, m_pipelineCache, 1, &pipelineInfo, 0, &m_imageViewClear.doClear);
     if (result != VK_SUCCESS) {
         return ComputeStatus::eError;
     }
@@ -1249,6 +1342,8 @@ ComputeStatus Vulkan::init(Device device, param::IParameters* params)
 
 ComputeStatus Vulkan::shutdown()
 {
+    // Callback thread uses the device so stop it before anything else goes away
+    shutdownFenceCallbacks();
     m_dispatchContext.clear();
 
     assert(m_device != NULL);
@@ -1284,6 +1379,9 @@ ComputeStatus Vulkan::shutdown()
     m_ddt.DestroyDescriptorSetLayout(m_device, m_imageViewClear.descriptorSetLayout, nullptr);
     m_imageViewClear = {};
 
+    savePipelineCache();
+    shutdownDescriptorBuffer();
+
     // cleanup samplers
     for (uint32_t u = 0; u < countof(m_sampler); ++u)
     {
@@ -1305,6 +1403,9 @@ ComputeStatus Vulkan::shutdown()
 
     ComputeStatus status = Generic::shutdown();
 
+    // Resources are released by the generic shutdown so blocks can only go after it
+    shutdownMemoryAllocator();
+
     if (m_reflex)
     {
         m_reflex->shutdown();
@@ -1315,6 +1416,60 @@ ComputeStatus Vulkan::shutdown()
     return status;
 }
 
+void Vulkan::loadPipelineCache()
+{
+    auto path = getPipelineCachePath(L".vk.pipelinecache");
+    if (path.empty()) return;
+
+    file::MappedFile data;
+    if (file::exists(path.c_str()))
+    {
+        data = file::map(path.c_str());
+
+        // Driver would reject a mismatch anyway but this way we know why the cache was cold
+        VkPhysicalDeviceProperties props{};
+        m_idt.GetPhysicalDeviceProperties(m_physicalDevice, &props);
+        VkPipelineCacheHeaderVersionOne header{};
+        if (data.size() >= sizeof(header))
+        {
+            memcpy(&header, data.data(), sizeof(header));
+        }
+        if (header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE || header.vendorID != props.vendorID || header.deviceID != props.deviceID ||
+            memcmp(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+        {
+            SL_LOG_INFO("Discarding stale pipeline cache %S", path.c_str());
+            data = {};
+        }
+    }
+
+    VkPipelineCacheCreateInfo info = { VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+    info.initialDataSize = data.size();
+    info.pInitialData = data.empty() ? nullptr : data.data();
+    if (m_ddt.CreatePipelineCache(m_device, &info, nullptr, &m_pipelineCache) != VK_SUCCESS)
+    {
+        SL_LOG_WARN("Failed to create pipeline cache, persistent pipeline cache is disabled");
+        m_pipelineCache = {};
+    }
+}
+
+void Vulkan::savePipelineCache()
+{
+    if (!m_pipelineCache) return;
+
+    size_t size = 0;
+    if (m_ddt.GetPipelineCacheData(m_device, m_pipelineCache, &size, nullptr) == VK_SUCCESS && size > 0)
+    {
+        std::vector<uint8_t> data(size);
+        if (m_ddt.GetPipelineCacheData(m_device, m_pipelineCache, &size, data.data()) == VK_SUCCESS)
+        {
+            data.resize(size);
+            file::write(getPipelineCachePath(L".vk.pipelinecache").c_str(), data);
+        }
+    }
+    m_ddt.DestroyPipelineCache(m_device, m_pipelineCache, nullptr);
+    m_pipelineCache = {};
+}
+
 // This function retrieves queue info for presentable queues only but can be extended for any type of queue.
 ComputeStatus Vulkan::getHostQueueInfo(chi::CommandQueue queue, void* pQueueInfo)
 {
@@ -1428,27 +1583,14 @@ ComputeStatus Vulkan::restorePipeline(CommandList cmdList)
 
 ComputeStatus Vulkan::createKernel(void *blob, unsigned int blobSize, const char* fileName, const char *entryPoint, Kernel &kernel)
 {
+    SL_STARTUP_PHASE(m_startupTimeline, fileName);
     if (!blob || !fileName || !entryPoint)
     {
         return ComputeStatus::eInvalidArgument;
     }
 
-    size_t hash = 0;
-    const char* p = fileName;
-    while (*p)
-    {
-        hash_combine(hash, *p++);
-    }
-    p = entryPoint;
-    while (*p)
-    {
-        hash_combine(hash, *p++);
-    }
-    auto i = blobSize;
-    while (i--)
-    {
-        hash_combine(hash, ((char*)blob)[i]);
-    }
+    // Names seed the blob hash so the same byte code registered under a different name stays distinct
+    size_t hash = hash::hash64(blob, blobSize, hash::hashString(entryPoint, hash::hashString(fileName)));
 
     ComputeStatus Res = ComputeStatus::eOk;
     KernelDataVK *data = {};
@@ -1517,7 +1659,7 @@ ComputeStatus Vulkan::createCommandListContext(ChiCommandQueue* queue,
                                                const char friendlyName[])
 { 
     auto tmp = new CommandListContextVK();
-    tmp->init(this, m_vk, friendlyName, m_device, (CommandQueueVk*)queue, count);
+    tmp->init(this, m_vk, friendlyName, m_device, (CommandQueueVk*)queue, count, &m_nonGraphicsCommandBuffers);
     ctx = tmp;
     return ComputeStatus::eOk;
 }
@@ -1548,6 +1690,7 @@ WaitStatus Vulkan::waitCPUFence(Fence fence, uint64_t syncValue)
     VK_CHECK_RWS(m_ddt.GetSemaphoreCounterValue(m_device, semaphore, &completedValue));
     if (completedValue < syncValue)
     {
+        extra::ScopedHitchTimer hitch("Vulkan::waitCPUFence");
         VkSemaphoreWaitInfo waitInfo;
         waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
         waitInfo.pNext = NULL;
@@ -1560,6 +1703,25 @@ WaitStatus Vulkan::waitCPUFence(Fence fence, uint64_t syncValue)
     return WaitStatus::eNoTimeout;
 }
 
+WaitStatus Vulkan::waitCPUFences(const Fence* fences, const uint64_t* syncValues, uint32_t count, bool waitAny, uint32_t timeoutMs)
+{
+    if (!fences || !syncValues) return WaitStatus::eError;
+    if (count == 0) return WaitStatus::eNoTimeout;
+
+    VkSemaphoreWaitInfo waitInfo{ VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO };
+    waitInfo.flags = waitAny ? VK_SEMAPHORE_WAIT_ANY_BIT : 0;
+    waitInfo.semaphoreCount = count;
+    waitInfo.pSemaphores = (const VkSemaphore*)fences;
+    waitInfo.pValues = syncValues;
+    extra::ScopedHitchTimer hitch("Vulkan::waitCPUFences");
+    auto result = m_ddt.WaitSemaphores(m_device, &waitInfo, uint64_t(timeoutMs) * 1000000);
+    if (result == VK_TIMEOUT)
+    {
+        return WaitStatus::eTimeout;
+    }
+    return result == VK_SUCCESS ? WaitStatus::eNoTimeout : WaitStatus::eError;
+}
+
 ComputeStatus Vulkan::createCommandQueue(CommandQueueType type,
                                          ChiCommandQueue*& queue,
                                          const char friendlyName[],
@@ -1631,6 +1793,7 @@ ComputeStatus Vulkan::destroyFence(Fence& fence)
 {
     if (fence)
     {
+        dropFenceCallbacks(fence);
         m_ddt.DestroySemaphore(m_device, (VkSemaphore)fence, NULL);
         fence = VK_NULL_HANDLE;
     }
@@ -1718,8 +1881,8 @@ ComputeStatus Vulkan::bindConsts(uint32_t base, uint32_t reg, void *data, size_t
         CHI_CHECK(createBuffer(cbDesc, cb, "const buffer"));
         slot.handles.push_back(cb);
         slot.mapped = {};
-        auto info = (sl::Resource*)cb;
-        VK_CHECK(m_ddt.MapMemory(m_device, (VkDeviceMemory)info->memory, 0, cbDesc.width, 0, &slot.mapped));
+        // Stays mapped for the lifetime of the buffer
+        CHI_CHECK(mapResource(nullptr, cb, slot.mapped, 0, 0, cbDesc.width));
         slot.dataRange = (uint32_t)dataSize;
         slot.offsetIndex = (uint32_t)thread.signature->offsets.size();
         uint32_t offset = slot.instance * alignedDataSize;
@@ -1819,12 +1982,14 @@ ComputeStatus Vulkan::bindRawBuffer(uint32_t base, uint32_t reg, Resource InReso
         assert(slot.type == DescriptorType::eStorageBuffer);
         slot.dirty |= slot.handles.back() != resource->native;
         slot.handles.back() = resource->native;
+        slot.dataRange = resource->width;
     }
     else
     {
         BindingSlot slot = {};
         slot.type = DescriptorType::eStorageBuffer;
         slot.registerIndex = base;
+        slot.dataRange = resource->width;
         slot.handles.push_back(resource->native);
         thread.signature->descriptors[base] = slot;
     }
@@ -1832,10 +1997,80 @@ ComputeStatus Vulkan::bindRawBuffer(uint32_t base, uint32_t reg, Resource InReso
     return ComputeStatus::eOk;
 }
 
+ComputeStatus Vulkan::initDescriptorPool(DispatchData& thread, const std::vector<VkDescriptorSetLayoutBinding>& bindings, const std::vector<VkDescriptorPoolSize>& poolSizes, uint32_t totalDescriptorCount, PoolDescCombo& combo)
+{
+    auto id = GetCurrentThreadId();
+    VkDescriptorPoolCreateInfo descriptorPoolInfo =
+    {
+        VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        nullptr,
+        (VkDescriptorPoolCreateFlags)0,
+        ((uint32_t)thread.kernel->numDescriptorSets * totalDescriptorCount),
+        (uint32_t)(poolSizes.size()),
+        poolSizes.data()
+    };
+    VK_CHECK(m_ddt.CreateDescriptorPool(m_device, &descriptorPoolInfo, nullptr, &combo.pool));
+    std::stringstream name{};
+    name << "SL_thread_" << id << "_descriptor_pool";
+    setDebugNameVk(combo.pool, name.str().c_str());
+
+    combo.descSetData.descSet.resize(thread.kernel->numDescriptorSets);
+    for (uint32_t i = 0; i < thread.kernel->numDescriptorSets; i++)
+    {
+        VkDescriptorSetAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO , nullptr, combo.pool, 1, &thread.kernel->descriptorSetLayout };
+        VK_CHECK(m_ddt.AllocateDescriptorSets(m_device, &allocInfo, &combo.descSetData.descSet[i]));
+        name = std::stringstream{};
+        name << "SL_thread_" << id << "_kernel_descriptor_set_" << i;
+        setDebugNameVk(combo.descSetData.descSet[i], name.str().c_str());
+    }
+
+    // Payload layout never changes for a signature so templates and writes are built once, dispatch only refreshes the payload
+    size_t infoCount = 0;
+    for (auto& binding : bindings)
+    {
+        infoCount += binding.descriptorCount;
+    }
+    combo.descriptorInfos.resize(infoCount);
+    std::vector<VkDescriptorUpdateTemplateEntry> entries = {};
+    size_t index = 0;
+    for (auto& binding : bindings)
+    {
+        entries.push_back({ binding.binding, 0, binding.descriptorCount, binding.descriptorType, index * sizeof(PoolDescCombo::DescriptorInfo), sizeof(PoolDescCombo::DescriptorInfo) });
+
+        VkWriteDescriptorSet write = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        write.dstBinding = binding.binding;
+        write.descriptorCount = binding.descriptorCount;
+        write.descriptorType = binding.descriptorType;
+        if (binding.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER || binding.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC)
+        {
+            write.pBufferInfo = &combo.descriptorInfos[index].buffer;
+        }
+        else
+        {
+            write.pImageInfo = &combo.descriptorInfos[index].image;
+        }
+        combo.writes.push_back(write);
+        index += binding.descriptorCount;
+    }
+
+    if (m_ddt.CreateDescriptorUpdateTemplate && m_ddt.UpdateDescriptorSetWithTemplate)
+    {
+        VkDescriptorUpdateTemplateCreateInfo templateInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO };
+        templateInfo.descriptorUpdateEntryCount = (uint32_t)entries.size();
+        templateInfo.pDescriptorUpdateEntries = entries.data();
+        templateInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+        templateInfo.descriptorSetLayout = thread.kernel->descriptorSetLayout;
+        templateInfo.pipelineBindPoint = VK_PIPELINE_BIND_POINT_COMPUTE;
+        templateInfo.pipelineLayout = thread.kernel->pipelineLayout;
+        VK_CHECK(m_ddt.CreateDescriptorUpdateTemplate(m_device, &templateInfo, nullptr, &combo.updateTemplate));
+    }
+    return ComputeStatus::eOk;
+}
+
 ComputeStatus Vulkan::processDescriptors(DispatchData& thread)
 {
     bool needsUpdate = false;
-    if (thread.signatureToDesc.find(thread.signature) == thread.signatureToDesc.end())
+    if (!thread.signature->combo)
     {
         std::vector<VkDescriptorSetLayoutBinding> bindings = { };
         std::vector<VkDescriptorPoolSize> poolSizes = { };
@@ -1872,8 +2107,9 @@ ComputeStatus Vulkan::processDescriptors(DispatchData& thread)
             }
             else if (slot.type == DescriptorType::eConstantBuffer)
             {
-                ps.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
-                binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+                // Descriptor buffer layouts cannot hold dynamic buffers, constant ring offsets are baked into the descriptor instead
+                ps.type = m_useDescriptorBuffer ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+                binding.descriptorType = ps.type;
             }
             bindings.push_back(binding);
             poolSizes.push_back(ps);
@@ -1888,6 +2124,12 @@ ComputeStatus Vulkan::processDescriptors(DispatchData& thread)
             dslInfo.bindingCount = (uint32_t)bindings.size();
             dslInfo.pBindings = bindings.data();
             //dslInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+#if defined(VK_EXT_descriptor_buffer)
+            if (m_useDescriptorBuffer)
+            {
+                dslInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+            }
+#endif
             VK_CHECK(m_ddt.CreateDescriptorSetLayout(m_device, &dslInfo, 0, &thread.kernel->descriptorSetLayout));
             setDebugNameVk(thread.kernel->descriptorSetLayout, "SL_thread_kernel_descriptorSetLayout");
 
@@ -1900,144 +2142,92 @@ ComputeStatus Vulkan::processDescriptors(DispatchData& thread)
             setDebugNameVk(thread.kernel->pipelineLayout, "SL_thread_kernel_pipelineLayout");
         }
 
-        auto id = GetCurrentThreadId();
-        VkDescriptorPoolCreateInfo descriptorPoolInfo =
-        {
-            VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-            nullptr,
-            (VkDescriptorPoolCreateFlags)0,
-            ((uint32_t)thread.kernel->numDescriptorSets * totalDescriptorCount),
-            (uint32_t)(poolSizes.size()),
-            poolSizes.data()
-        };
         PoolDescCombo& combo = thread.signatureToDesc[thread.signature];
-        VK_CHECK(m_ddt.CreateDescriptorPool(m_device, &descriptorPoolInfo, nullptr, &combo.pool));
-        std::stringstream name{};
-        name << "SL_thread_" << id << "_descriptor_pool";
-        setDebugNameVk(combo.pool, name.str().c_str());
-
-        combo.descSetData.descSet.resize(thread.kernel->numDescriptorSets);
-        for (uint32_t i = 0; i < thread.kernel->numDescriptorSets; i++)
+        if (m_useDescriptorBuffer)
         {
-            VkDescriptorSetAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO , nullptr, combo.pool, 1, &thread.kernel->descriptorSetLayout };
-            VK_CHECK(m_ddt.AllocateDescriptorSets(m_device, &allocInfo, &combo.descSetData.descSet[i]));
-            name = std::stringstream{};
-            name << "SL_thread_" << id << "_kernel_descriptor_set_" << i;
-            setDebugNameVk(combo.descSetData.descSet[i], name.str().c_str());
+            CHI_CHECK(initDescriptorBufferLayout(thread.kernel->descriptorSetLayout, bindings, combo));
         }
-
+        else
+        {
+            CHI_CHECK(initDescriptorPool(thread, bindings, poolSizes, totalDescriptorCount, combo));
+        }
+        thread.signature->combo = &combo;
         needsUpdate = true;
     }
 
-    auto writeBufferDescriptorSet = [](VkDescriptorSet dstSet, VkDescriptorType type, uint32_t binding, VkDescriptorBufferInfo* bufferInfo, uint32_t descriptorCount = 1)->VkWriteDescriptorSet
+    auto& combo = *thread.signature->combo;
+    for (auto& [base, slot] : thread.signature->descriptors)
     {
-        VkWriteDescriptorSet descSet{};
-        descSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descSet.dstSet = dstSet;
-        descSet.descriptorType = type;
-        descSet.dstBinding = binding;
-        descSet.pBufferInfo = bufferInfo;
-        descSet.descriptorCount = descriptorCount;
-        return descSet;
-    };
-
-    auto writeImageDescriptorSet = [](VkDescriptorSet dstSet, VkDescriptorType type, uint32_t binding, VkDescriptorImageInfo* imageInfo, uint32_t descriptorCount = 1)->VkWriteDescriptorSet
+        needsUpdate |= slot.dirty;
+    }
+    if (needsUpdate && m_useDescriptorBuffer)
     {
-        VkWriteDescriptorSet descSet{};
-        descSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descSet.dstSet = dstSet;
-        descSet.descriptorType = type;
-        descSet.dstBinding = binding;
-        descSet.pImageInfo = imageInfo;
-        descSet.descriptorCount = descriptorCount;
-        return descSet;
-    };
-
-    auto& combo = thread.signatureToDesc[thread.signature];
+        CHI_CHECK(writeDescriptorBuffer(thread, combo));
+    }
+    else if (needsUpdate)
     {
-        std::vector<VkWriteDescriptorSet> writeDescriptorSets = {};
-        std::vector<VkDescriptorBufferInfo> buffers[16];
-        std::vector<VkDescriptorImageInfo> images[16];
-        for (auto& it : thread.signature->descriptors)
-        {
-            auto& slot = it.second;
-            assert(slot.registerIndex < 16);
-            needsUpdate |= slot.dirty;
-        }
-        if (needsUpdate)
-        {
-            combo.descSetData.descSetIndex = (combo.descSetData.descSetIndex + 1) % thread.kernel->numDescriptorSets;
-            auto& descSet = combo.descSetData.descSet[combo.descSetData.descSetIndex];
+        combo.descSetData.descSetIndex = (combo.descSetData.descSetIndex + 1) % thread.kernel->numDescriptorSets;
+        auto& descSet = combo.descSetData.descSet[combo.descSetData.descSetIndex];
 
-            for (auto& it : thread.signature->descriptors)
+        // Same order as the template entries, handles are tightly packed across slots and each slot
+        // gets exactly the descriptor count its binding was created with so the payload can never overrun
+        size_t bindingIndex = 0;
+        size_t offset = 0;
+        for (auto& [base, slot] : thread.signature->descriptors)
+        {
+            if (bindingIndex >= combo.writes.size())
+            {
+                SL_LOG_ERROR_ONCE("Kernel %s binds more slots than its descriptor set layout has", thread.kernel->name.c_str());
+                break;
+            }
+            auto capacity = (size_t)combo.writes[bindingIndex++].descriptorCount;
+            if (slot.handles.size() > capacity)
+            {
+                SL_LOG_ERROR_ONCE("Kernel %s binds %llu descriptors at register %u, layout has %llu", thread.kernel->name.c_str(), slot.handles.size(), slot.registerIndex, capacity);
+            }
+            auto info = combo.descriptorInfos.data() + offset;
+            offset += capacity;
+            for (size_t i = 0; i < std::min(slot.handles.size(), capacity); i++)
             {
-                auto& slot = it.second;
+                auto h = slot.handles[i];
                 if (slot.type == DescriptorType::eStorageBuffer)
                 {
-                    for (auto& h : slot.handles)
-                    {
-                        VkDescriptorBufferInfo info = {};
-                        auto buffer = (VkBuffer)h;
-                        if (buffer)
-                        {
-                            info =
-                            {
-                                buffer,                           // VkBuffer        buffer;
-                                0,                                // VkDeviceSize    offset;
-                                VK_WHOLE_SIZE                     // VkDeviceSize    range;
-                            };
-                        }
-                        buffers[slot.registerIndex].push_back(info);
-                    }
-                    writeDescriptorSets.push_back(writeBufferDescriptorSet(descSet, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, slot.registerIndex, buffers[slot.registerIndex].data(), (uint32_t)slot.handles.size()));
+                    auto buffer = (VkBuffer)h;
+                    info->buffer = buffer ? VkDescriptorBufferInfo{ buffer, 0, VK_WHOLE_SIZE } : VkDescriptorBufferInfo{};
                 }
                 else if (slot.type == DescriptorType::eStorageTexture)
                 {
-                    for (auto& h : slot.handles)
-                    {
-                        VkDescriptorImageInfo info = { nullptr, (VkImageView)h, VK_IMAGE_LAYOUT_GENERAL };
-                        images[slot.registerIndex].push_back(info);
-                    }
-                    writeDescriptorSets.push_back(writeImageDescriptorSet(descSet, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, slot.registerIndex, images[slot.registerIndex].data(), (uint32_t)slot.handles.size()));
+                    info->image = { nullptr, (VkImageView)h, VK_IMAGE_LAYOUT_GENERAL };
                 }
                 else if (slot.type == DescriptorType::eTexture)
                 {
-                    for (auto& h : slot.handles)
-                    {
-                        VkDescriptorImageInfo info = { nullptr, (VkImageView)h, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
-                        images[slot.registerIndex].push_back(info);
-                    }
-                    writeDescriptorSets.push_back(writeImageDescriptorSet(descSet, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, slot.registerIndex, images[slot.registerIndex].data(), (uint32_t)slot.handles.size()));
+                    info->image = { nullptr, (VkImageView)h, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
                 }
                 else if (slot.type == DescriptorType::eSampler)
                 {
-                    for (auto& h : slot.handles)
-                    {
-                        VkDescriptorImageInfo info = { (VkSampler)h,nullptr,VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
-                        images[slot.registerIndex].push_back(info);
-                    }
-                    writeDescriptorSets.push_back(writeImageDescriptorSet(descSet, VK_DESCRIPTOR_TYPE_SAMPLER, slot.registerIndex, images[slot.registerIndex].data(), (uint32_t)slot.handles.size()));
+                    info->image = { (VkSampler)h, nullptr, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
                 }
                 else if (slot.type == DescriptorType::eConstantBuffer)
                 {
-                    auto buffer = reinterpret_cast<VkBuffer>(reinterpret_cast<Resource>(slot.handles.front())->native);
-                    VkDescriptorBufferInfo info = {};
-                    if (buffer)
-                    {
-                        info =
-                        {
-                            buffer,                           // VkBuffer        buffer;
-                            0,                                // VkDeviceSize    offset;
-                            slot.dataRange                    // VkDeviceSize    range;
-                        };
-                    }
-                    buffers[slot.registerIndex].push_back(info);
-                    writeDescriptorSets.push_back(writeBufferDescriptorSet(descSet, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, slot.registerIndex, buffers[slot.registerIndex].data(), (uint32_t)slot.handles.size()));
+                    auto buffer = reinterpret_cast<VkBuffer>(reinterpret_cast<Resource>(h)->native);
+                    info->buffer = buffer ? VkDescriptorBufferInfo{ buffer, 0, slot.dataRange } : VkDescriptorBufferInfo{};
                 }
-                slot.dirty = false;
+                info++;
+            }
+            slot.dirty = false;
+        }
+
+        if (combo.updateTemplate)
+        {
+            m_ddt.UpdateDescriptorSetWithTemplate(m_device, descSet, combo.updateTemplate, combo.descriptorInfos.data());
+        }
+        else
+        {
+            for (auto& write : combo.writes)
+            {
+                write.dstSet = descSet;
             }
-            auto sz = static_cast<uint32_t>(writeDescriptorSets.size());
-            m_ddt.UpdateDescriptorSets(m_device, sz, writeDescriptorSets.data(), 0, NULL);
+            m_ddt.UpdateDescriptorSets(m_device, (uint32_t)combo.writes.size(), combo.writes.data(), 0, nullptr);
         }
     }
 
@@ -2049,17 +2239,233 @@ ComputeStatus Vulkan::processDescriptors(DispatchData& thread)
         pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
         pipelineInfo.stage.module = thread.kernel->shaderModule;
         pipelineInfo.stage.pName = "main";
-        VK_CHECK(m_ddt.CreateComputePipelines(m_device, nullptr, 1, &pipelineInfo, 0, &thread.kernel->pipeline));
+#if defined(VK_EXT_descriptor_buffer)
+        if (m_useDescriptorBuffer)
+        {
+            pipelineInfo.flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+        }
+#endif
+        VK_CHECK(m_ddt.CreateComputePipelines(m_device, m_pipelineCache, 1, &pipelineInfo, 0, &thread.kernel->pipeline));
         setDebugNameVk(thread.kernel->pipeline, "SL_thread_kernel_pipeline");
     }
     return ComputeStatus::eOk;
 }
 
+#if defined(VK_EXT_descriptor_buffer)
+ComputeStatus Vulkan::initDescriptorBuffer()
+{
+    if (!m_vk->descriptorBuffer || isDeviceExtensionSupported(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME, 1) != ComputeStatus::eOk)
+    {
+        return ComputeStatus::eOk;
+    }
+
+    auto& db = m_descriptorBuffer;
+    db.getLayoutSize = (PFN_vkGetDescriptorSetLayoutSizeEXT)m_vk->getDeviceProcAddr(m_device, "vkGetDescriptorSetLayoutSizeEXT");
+    db.getBindingOffset = (PFN_vkGetDescriptorSetLayoutBindingOffsetEXT)m_vk->getDeviceProcAddr(m_device, "vkGetDescriptorSetLayoutBindingOffsetEXT");
+    db.getDescriptor = (PFN_vkGetDescriptorEXT)m_vk->getDeviceProcAddr(m_device, "vkGetDescriptorEXT");
+    db.cmdBindBuffers = (PFN_vkCmdBindDescriptorBuffersEXT)m_vk->getDeviceProcAddr(m_device, "vkCmdBindDescriptorBuffersEXT");
+    db.cmdSetOffsets = (PFN_vkCmdSetDescriptorBufferOffsetsEXT)m_vk->getDeviceProcAddr(m_device, "vkCmdSetDescriptorBufferOffsetsEXT");
+    if (!db.getLayoutSize || !db.getBindingOffset || !db.getDescriptor || !db.cmdBindBuffers || !db.cmdSetOffsets || !m_ddt.GetBufferDeviceAddress)
+    {
+        SL_LOG_WARN("%s entry points missing, SL kernels keep using descriptor sets", VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+        db = {};
+        return ComputeStatus::eOk;
+    }
+
+    VkPhysicalDeviceProperties2 properties2 = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, &db.props };
+    m_idt.GetPhysicalDeviceProperties2(m_physicalDevice, &properties2);
+
+    // Samplers and resources share one ring, SL kernels only ever bind a single set
+    VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+    bufferInfo.size = kDescriptorBufferSize;
+    bufferInfo.usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+    VK_CHECK(m_ddt.CreateBuffer(m_device, &bufferInfo, nullptr, &db.buffer));
+
+    VkMemoryRequirements memReqs = {};
+    m_ddt.GetBufferMemoryRequirements(m_device, db.buffer, &memReqs);
+    const VkMemoryPropertyFlags memProps = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    uint32_t memoryTypeIndex;
+    for (memoryTypeIndex = 0; memoryTypeIndex < m_vkPhysicalDeviceMemoryProperties.memoryTypeCount; ++memoryTypeIndex)
+    {
+        if ((memReqs.memoryTypeBits & (1 << memoryTypeIndex)) && (m_vkPhysicalDeviceMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & memProps) == memProps)
+        {
+            break;
+        }
+    }
+    if (memoryTypeIndex >= m_vkPhysicalDeviceMemoryProperties.memoryTypeCount)
+    {
+        SL_LOG_WARN("No host visible memory for the descriptor buffer, SL kernels keep using descriptor sets");
+        shutdownDescriptorBuffer();
+        return ComputeStatus::eOk;
+    }
+
+    VkMemoryAllocateFlagsInfo memFlags = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO, nullptr, VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT, 0 };
+    VkMemoryAllocateInfo memInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, &memFlags, memReqs.size, memoryTypeIndex };
+    VK_CHECK(m_ddt.AllocateMemory(m_device, &memInfo, nullptr, &db.memory));
+    setDebugNameVk(db.memory, "SL_descriptor_buffer_device_memory");
+    VK_CHECK(m_ddt.BindBufferMemory(m_device, db.buffer, db.memory, 0));
+    VK_CHECK(m_ddt.MapMemory(m_device, db.memory, 0, VK_WHOLE_SIZE, 0, (void**)&db.cpuVA));
+
+    VkBufferDeviceAddressInfo addressInfo = { VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO, nullptr, db.buffer };
+    db.address = m_ddt.GetBufferDeviceAddress(m_device, &addressInfo);
+
+    m_useDescriptorBuffer = true;
+    SL_LOG_INFO("Using %s for SL kernels", VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+    return ComputeStatus::eOk;
+}
+
+void Vulkan::shutdownDescriptorBuffer()
+{
+    auto& db = m_descriptorBuffer;
+    if (db.cpuVA)
+    {
+        m_ddt.UnmapMemory(m_device, db.memory);
+    }
+    if (db.buffer)
+    {
+        m_ddt.DestroyBuffer(m_device, db.buffer, nullptr);
+    }
+    if (db.memory)
+    {
+        m_ddt.FreeMemory(m_device, db.memory, nullptr);
+    }
+    db = {};
+    m_useDescriptorBuffer = false;
+}
+
+ComputeStatus Vulkan::initDescriptorBufferLayout(VkDescriptorSetLayout layout, const std::vector<VkDescriptorSetLayoutBinding>& bindings, PoolDescCombo& combo)
+{
+    auto& db = m_descriptorBuffer;
+    db.getLayoutSize(m_device, layout, &combo.layoutSize);
+    combo.bindingOffsets.resize(bindings.size());
+    for (size_t i = 0; i < bindings.size(); i++)
+    {
+        db.getBindingOffset(m_device, layout, bindings[i].binding, &combo.bindingOffsets[i]);
+    }
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus Vulkan::writeDescriptorBuffer(DispatchData& thread, PoolDescCombo& combo)
+{
+    auto& db = m_descriptorBuffer;
+
+    // Previous copies may still be in flight so every update lands in fresh space
+    uint64_t offset = 0;
+    {
+        std::scoped_lock lock(m_mutexDescriptorBuffer);
+        if (!db.space.allocate(combo.layoutSize, db.props.descriptorBufferOffsetAlignment, m_finishedFrame, offset))
+        {
+            SL_LOG_ERROR("Descriptor buffer exhausted, %llu bytes in flight", db.space.head - db.space.tail);
+            return ComputeStatus::eError;
+        }
+    }
+
+    auto getAddress = [this](VkBuffer buffer)->VkDeviceAddress
+    {
+        VkBufferDeviceAddressInfo addressInfo = { VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO, nullptr, buffer };
+        return m_ddt.GetBufferDeviceAddress(m_device, &addressInfo);
+    };
+
+    // Same order as the layout bindings, array elements are tightly packed within a binding
+    size_t binding = 0;
+    for (auto& [base, slot] : thread.signature->descriptors)
+    {
+        auto dst = db.cpuVA + offset + combo.bindingOffsets[binding++];
+        for (auto& h : slot.handles)
+        {
+            VkDescriptorGetInfoEXT info = { VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT };
+            VkDescriptorImageInfo image = {};
+            VkDescriptorAddressInfoEXT address = { VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT };
+            VkSampler sampler = (VkSampler)h;
+            size_t size = 0;
+            bool valid = h != nullptr;
+            if (slot.type == DescriptorType::eStorageBuffer)
+            {
+                info.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                info.data.pStorageBuffer = &address;
+                size = db.props.storageBufferDescriptorSize;
+                if (valid)
+                {
+                    address.address = getAddress((VkBuffer)h);
+                    address.range = slot.dataRange;
+                }
+            }
+            else if (slot.type == DescriptorType::eStorageTexture)
+            {
+                info.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+                info.data.pStorageImage = &image;
+                size = db.props.storageImageDescriptorSize;
+                image = { nullptr, (VkImageView)h, VK_IMAGE_LAYOUT_GENERAL };
+            }
+            else if (slot.type == DescriptorType::eTexture)
+            {
+                info.type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                info.data.pSampledImage = &image;
+                size = db.props.sampledImageDescriptorSize;
+                image = { nullptr, (VkImageView)h, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+            }
+            else if (slot.type == DescriptorType::eSampler)
+            {
+                info.type = VK_DESCRIPTOR_TYPE_SAMPLER;
+                info.data.pSampler = &sampler;
+                size = db.props.samplerDescriptorSize;
+            }
+            else if (slot.type == DescriptorType::eConstantBuffer)
+            {
+                info.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                info.data.pUniformBuffer = &address;
+                size = db.props.uniformBufferDescriptorSize;
+                auto buffer = reinterpret_cast<VkBuffer>(reinterpret_cast<Resource>(h)->native);
+                valid = buffer != nullptr;
+                if (valid)
+                {
+                    address.address = getAddress(buffer) + thread.signature->offsets[slot.offsetIndex];
+                    address.range = slot.dataRange;
+                }
+            }
+
+            if (valid)
+            {
+                db.getDescriptor(m_device, &info, size, dst);
+            }
+            else
+            {
+                // Null descriptors need 'nullDescriptor', unbound slots are never accessed by SL kernels
+                memset(dst, 0, size);
+            }
+            dst += size;
+        }
+        slot.dirty = false;
+    }
+    combo.descriptorBufferOffset = offset;
+    return ComputeStatus::eOk;
+}
+
+void Vulkan::bindDescriptorBuffer(VkCommandBuffer cmdBuffer, VkPipelineLayout layout, VkDeviceSize offset)
+{
+    auto& db = m_descriptorBuffer;
+    VkDescriptorBufferBindingInfoEXT bindingInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT };
+    bindingInfo.address = db.address;
+    bindingInfo.usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT | VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT;
+    db.cmdBindBuffers(cmdBuffer, 1, &bindingInfo);
+    uint32_t bufferIndex = 0;
+    db.cmdSetOffsets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, layout, 0, 1, &bufferIndex, &offset);
+}
+#else
+ComputeStatus Vulkan::initDescriptorBuffer() { return ComputeStatus::eOk; }
+void Vulkan::shutdownDescriptorBuffer() {}
+ComputeStatus Vulkan::initDescriptorBufferLayout(VkDescriptorSetLayout layout, const std::vector<VkDescriptorSetLayoutBinding>& bindings, PoolDescCombo& combo) { return ComputeStatus::eNoImplementation; }
+ComputeStatus Vulkan::writeDescriptorBuffer(DispatchData& thread, PoolDescCombo& combo) { return ComputeStatus::eNoImplementation; }
+void Vulkan::bindDescriptorBuffer(VkCommandBuffer cmdBuffer, VkPipelineLayout layout, VkDeviceSize offset) {}
+#endif
+
 ComputeStatus Vulkan::dispatch(unsigned int blockX, unsigned int blockY, unsigned int blockZ)
 {
     auto& thread = m_dispatchContext.getContext();
     if (!thread.kernel) return ComputeStatus::eInvalidArgument;
 
+    flushBarriers(m_cmdBuffer);
+
     if (thread.kernel->shaderModule)
     {
         ComputeStatus ret = processDescriptors(thread);
@@ -2069,10 +2475,17 @@ ComputeStatus Vulkan::dispatch(unsigned int blockX, unsigned int blockY, unsigne
             return ret;
         }
 
-        auto& combo = thread.signatureToDesc[thread.signature];
+        auto& combo = *thread.signature->combo;
 
         m_ddt.CmdBindPipeline(m_cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, thread.kernel->pipeline);
-        m_ddt.CmdBindDescriptorSets(m_cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, thread.kernel->pipelineLayout, 0, 1, &(combo.descSetData.descSet[combo.descSetData.descSetIndex]), (uint32_t)thread.signature->offsets.size(), thread.signature->offsets.data());
+        if (m_useDescriptorBuffer)
+        {
+            bindDescriptorBuffer(m_cmdBuffer, thread.kernel->pipelineLayout, combo.descriptorBufferOffset);
+        }
+        else
+        {
+            m_ddt.CmdBindDescriptorSets(m_cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, thread.kernel->pipelineLayout, 0, 1, &(combo.descSetData.descSet[combo.descSetData.descSetIndex]), (uint32_t)thread.signature->offsets.size(), thread.signature->offsets.data());
+        }
         m_ddt.CmdDispatch(m_cmdBuffer, blockX, blockY, blockZ);
     }
 
@@ -2191,8 +2604,11 @@ ComputeStatus Vulkan::createTexture2DResourceSharedImpl(ResourceDescription &res
             return ComputeStatus::eError;
         }
 
-        VkMemoryRequirements memReqs = { };
-        m_ddt.GetImageMemoryRequirements(m_device, image, &memReqs);
+        VkImageMemoryRequirementsInfo2 memReqsInfo = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_REQUIREMENTS_INFO_2, nullptr, image };
+        VkMemoryDedicatedRequirements dedicatedReqs = { VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS };
+        VkMemoryRequirements2 memReqs2 = { VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2, &dedicatedReqs };
+        m_ddt.GetImageMemoryRequirements2(m_device, &memReqsInfo, &memReqs2);
+        const VkMemoryRequirements& memReqs = memReqs2.memoryRequirements;
 
         // Find an available memory type that satisfies the requested properties.
         uint32_t memoryTypeIndex;
@@ -2209,28 +2625,19 @@ ComputeStatus Vulkan::createTexture2DResourceSharedImpl(ResourceDescription &res
             return ComputeStatus::eError;
         }
 
-        VkMemoryAllocateInfo memInfo = {
-            VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,          // sType
-            NULL,                                            // pNext
-            memReqs.size,                                    // allocationSize
-            memoryTypeIndex,                                 // memoryTypeIndex
-        };
-
-        // Ideally, we'd do suballocation, but we expect relatively few platform-managed
-        // buffer objects, so just take the simple route for now    
-        result = m_ddt.AllocateMemory(m_device, &memInfo, 0, &deviceMemory);
+        // Only device local images are placed in shared blocks, host visible ones get mapped through 'resource->memory'
+        bool dedicated = dedicatedReqs.prefersDedicatedAllocation || dedicatedReqs.requiresDedicatedAllocation || resDesc.heapType != eHeapTypeDefault;
+        VkDeviceSize memoryOffset{};
+        result = allocateMemory(eMemoryPoolImage, image, memReqs, memoryTypeIndex, dedicated, false, InFriendlyName, deviceMemory, memoryOffset);
 
         if (result != VK_SUCCESS) {
             m_ddt.DestroyImage(m_device, image, nullptr);
             return ComputeStatus::eError;
         }
-        std::stringstream name{};
-        name << InFriendlyName << "_device_memory";
-        setDebugNameVk(deviceMemory, name.str().c_str());
 
-        result = m_ddt.BindImageMemory(m_device, image, deviceMemory, 0);
+        result = m_ddt.BindImageMemory(m_device, image, deviceMemory, memoryOffset);
         if (result != VK_SUCCESS) {
-            m_ddt.FreeMemory(m_device, deviceMemory, nullptr);
+            releaseMemory(image, deviceMemory);
             m_ddt.DestroyImage(m_device, image, nullptr);
             return ComputeStatus::eError;
         }
@@ -2252,11 +2659,11 @@ ComputeStatus Vulkan::createTexture2DResourceSharedImpl(ResourceDescription &res
 
         result = m_ddt.CreateImageView(m_device, &texViewCreateInfo, 0, &imageView);
         if (result != VK_SUCCESS) {
-            m_ddt.FreeMemory(m_device, deviceMemory, nullptr);
+            releaseMemory(image, deviceMemory);
             m_ddt.DestroyImage(m_device, image, nullptr);
             return ComputeStatus::eError;
         }
-        name = std::stringstream{};
+        std::stringstream name{};
         name << InFriendlyName << "_image_view";
         setDebugNameVk(imageView, name.str().c_str());
     }
@@ -2314,6 +2721,12 @@ ComputeStatus Vulkan::createBufferResourceImpl(ResourceDescription &resDesc, Res
         {
             bufferInfo.usage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
         }
+        if (m_useDescriptorBuffer)
+        {
+            // Anything bound through the descriptor buffer is referenced by address, memory gets
+            // VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT in 'allocateMemory' based on this usage bit
+            bufferInfo.usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+        }
         break;
     case eHeapTypeReadback:
         memProps        |= VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT  |
@@ -2348,8 +2761,11 @@ ComputeStatus Vulkan::createBufferResourceImpl(ResourceDescription &resDesc, Res
         return ComputeStatus::eError;
     }
 
-    VkMemoryRequirements memReqs = { };
-    m_ddt.GetBufferMemoryRequirements(m_device, buffer, &memReqs);
+    VkBufferMemoryRequirementsInfo2 memReqsInfo = { VK_STRUCTURE_TYPE_BUFFER_MEMORY_REQUIREMENTS_INFO_2, nullptr, buffer };
+    VkMemoryDedicatedRequirements dedicatedReqs = { VK_STRUCTURE_TYPE_MEMORY_DEDICATED_REQUIREMENTS };
+    VkMemoryRequirements2 memReqs2 = { VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2, &dedicatedReqs };
+    m_ddt.GetBufferMemoryRequirements2(m_device, &memReqsInfo, &memReqs2);
+    const VkMemoryRequirements& memReqs = memReqs2.memoryRequirements;
 
     // Find an available memory type that satisfies the requested properties.
     uint32_t memoryTypeIndex;
@@ -2366,46 +2782,37 @@ ComputeStatus Vulkan::createBufferResourceImpl(ResourceDescription &resDesc, Res
         return ComputeStatus::eError;
     }
 
-    VkMemoryAllocateInfo memInfo = {
-        VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,          // sType
-        NULL,                                            // pNext
-        memReqs.size,                                    // allocationSize
-        memoryTypeIndex,                                 // memoryTypeIndex
-    };
-
-    // If the VkPhysicalDeviceBufferDeviceAddressFeatures::bufferDeviceAddress feature is enabled and buffer was created 
-    // with the VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT bit set, memory must have been allocated with the VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT bit set
-    VkMemoryAllocateFlagsInfo memFlags = {
-        VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO,    // sType
-        NULL,                                            // pNext
-        VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT,           // allocationSize
-        0                                                // memoryTypeIndex
-    };
-    if (bufferInfo.usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) 
-    {
-        memInfo.pNext = &memFlags;
-    }
-
-    // Ideally, we'd do suballocation, but we expect relatively few platform-managed
-    // buffer objects, so just take the simple route for now
-    
-
-    result = m_ddt.AllocateMemory(m_device, &memInfo, 0, &deviceMemory);
+    // Host visible buffers are mapped through 'resource->memory' at offset 0 so they always get their own allocation.
+    //
+    // Note that all device local buffers are created with VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT so their blocks never mix with non addressable memory.
+    bool dedicated = dedicatedReqs.prefersDedicatedAllocation || dedicatedReqs.requiresDedicatedAllocation || resDesc.heapType != eHeapTypeDefault;
+    bool deviceAddress = (bufferInfo.usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) != 0;
+    VkDeviceSize memoryOffset{};
+    result = allocateMemory(eMemoryPoolBuffer, buffer, memReqs, memoryTypeIndex, dedicated, deviceAddress, InFriendlyName, deviceMemory, memoryOffset);
 
     if (result != VK_SUCCESS) {
         m_ddt.DestroyBuffer(m_device, buffer, nullptr);
         return ComputeStatus::eError;
     }
-    std::stringstream name{};
-    name << InFriendlyName << "_device_memory";
-    setDebugNameVk(deviceMemory, name.str().c_str());
 
-    result = m_ddt.BindBufferMemory(m_device, buffer, deviceMemory, 0);
+    result = m_ddt.BindBufferMemory(m_device, buffer, deviceMemory, memoryOffset);
     if (result != VK_SUCCESS) {
-        m_ddt.FreeMemory(m_device, deviceMemory, nullptr);
+        releaseMemory(buffer, deviceMemory);
         m_ddt.DestroyBuffer(m_device, buffer, nullptr);
         return ComputeStatus::eError;
     }
+
+    if (resDesc.heapType != eHeapTypeDefault)
+    {
+        // Dedicated allocation so the whole memory belongs to this buffer, see above
+        void* mapped{};
+        if (m_ddt.MapMemory(m_device, deviceMemory, 0, VK_WHOLE_SIZE, 0, &mapped) == VK_SUCCESS)
+        {
+            bool coherent = (m_vkPhysicalDeviceMemoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+            std::scoped_lock lock(m_mutexMapped);
+            m_mappedMemory[deviceMemory] = { (uint8_t*)mapped, coherent };
+        }
+    }
         
     VkBufferView view = {};
     //VkBufferViewCreateInfo bufferViewCreateInfo = { VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO };
@@ -2440,20 +2847,12 @@ ComputeStatus Vulkan::copyHostToDeviceBuffer(CommandList InCmdList, uint64_t InS
     if (dstResource->type != ResourceType::eBuffer) return ComputeStatus::eInvalidArgument;
     VkBuffer scratch = (VkBuffer)scratchResource->native;
 
-    uint8_t *StagingPtr = nullptr;
-
-    VkDeviceMemory mem = (VkDeviceMemory)scratchResource->memory;
-    
-    VkResult result = m_ddt.MapMemory(m_device, mem, 0, InSize, 0, (void**)&StagingPtr);
-    if (result != VK_SUCCESS) {
-        return ComputeStatus::eError;
-    }
-
-    StagingPtr += InUploadOffset;
+    flushBarriers((VkCommandBuffer)InCmdList);
 
+    void* StagingPtr = nullptr;
+    CHI_CHECK(mapResource(InCmdList, InUploadResource, StagingPtr, 0, InUploadOffset, InSize));
     memcpy(StagingPtr, InData, InSize);
-
-    m_ddt.UnmapMemory(m_device, mem);
+    unmapResource(InCmdList, InUploadResource, 0);
 
     VkCommandBuffer commandBuffer = (VkCommandBuffer)InCmdList;
 
@@ -2481,19 +2880,24 @@ ComputeStatus Vulkan::copyHostToDeviceTexture(CommandList InCmdList, uint64_t In
     if (dstResource->type != ResourceType::eTex2d) return ComputeStatus::eInvalidArgument;
     if (scratchResource->type != ResourceType::eBuffer) return ComputeStatus::eInvalidArgument;
 
-    auto dst = (VkImage)dstResource->native;
     auto scratch = (VkBuffer)scratchResource->native;
-    auto mem = (VkDeviceMemory)scratchResource->memory;
 
     // Copy to staging buffer
     void *stagingPtr = nullptr;
-    auto result = m_ddt.MapMemory(m_device, mem, 0, InSize, 0, &stagingPtr);
-    if (result != VK_SUCCESS)
-    {
-        return ComputeStatus::eError;
-    }
+    CHI_CHECK(mapResource(InCmdList, InUploadResource, stagingPtr, 0, 0, InSize));
     memcpy(stagingPtr, InData, InSize);
-    m_ddt.UnmapMemory(m_device, mem);
+    unmapResource(InCmdList, InUploadResource, 0);
+
+    recordBufferToImageCopy(commandBuffer, scratch, 0, 0, dstResource);
+
+    return ComputeStatus::eOk;
+}
+
+void Vulkan::recordBufferToImageCopy(VkCommandBuffer commandBuffer, VkBuffer scratch, uint64_t scratchOffset, uint32_t rowLength, sl::Resource* dstResource)
+{
+    auto dst = (VkImage)dstResource->native;
+
+    flushBarriers(commandBuffer);
 
     bool isImageViewForTexture = false, isImageViewTypeStencil = false;
     {
@@ -2519,6 +2923,8 @@ ComputeStatus Vulkan::copyHostToDeviceTexture(CommandList InCmdList, uint64_t In
     VkBufferImageCopy buffImageCopyRegions{};
     buffImageCopyRegions.imageSubresource.aspectMask = toVkAspectFlags(dstResource->nativeFormat, isImageViewForTexture, isImageViewTypeStencil);
     buffImageCopyRegions.imageSubresource.layerCount = 1;
+    buffImageCopyRegions.bufferOffset = scratchOffset;
+    buffImageCopyRegions.bufferRowLength = rowLength;
     buffImageCopyRegions.imageExtent = { desc.width, desc.height, 1 };
     m_ddt.CmdCopyBufferToImage(commandBuffer, scratch, dst, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &buffImageCopyRegions);
 
@@ -2537,7 +2943,36 @@ ComputeStatus Vulkan::copyHostToDeviceTexture(CommandList InCmdList, uint64_t In
         };
         m_ddt.CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &useBarrier);
     }
+}
+
+ComputeStatus Vulkan::uploadToTexture(CommandList cmdList, const void* data, uint64_t size, uint64_t rowPitch, Resource target)
+{
+    auto dstResource = (sl::Resource*)target;
+    if (!cmdList || !data || !dstResource) return ComputeStatus::eInvalidArgument;
+    if (dstResource->type != ResourceType::eTex2d) return ComputeStatus::eInvalidArgument;
 
+    ResourceDescription desc;
+    getResourceDescription(dstResource, desc);
+    size_t bytesPerPixel = 0;
+    getBytesPerPixel(desc.format, bytesPerPixel);
+    if (!bytesPerPixel || rowPitch % bytesPerPixel || rowPitch * desc.height > size)
+    {
+        SL_LOG_ERROR("Upload of %llu bytes with row pitch %llu does not cover texture '%S'", size, rowPitch, getDebugName(target).c_str());
+        return ComputeStatus::eInvalidArgument;
+    }
+
+    // Offset must be a multiple of the texel size and 4, copy the host pitch as is and let the copy skip the padding
+    Resource staging{};
+    uint64_t offset = 0;
+    CHI_CHECK(allocateUpload(size, 16 * bytesPerPixel, staging, offset));
+
+    auto scratchResource = (sl::Resource*)staging;
+    void* stagingPtr = nullptr;
+    CHI_CHECK(mapResource(cmdList, staging, stagingPtr, 0, offset, size));
+    memcpy(stagingPtr, data, size);
+    unmapResource(cmdList, staging, 0);
+
+    recordBufferToImageCopy((VkCommandBuffer)cmdList, (VkBuffer)scratchResource->native, offset, uint32_t(rowPitch / bytesPerPixel), dstResource);
     return ComputeStatus::eOk;
 }
 
@@ -2548,8 +2983,49 @@ ComputeStatus Vulkan::insertGPUBarrier(CommandList InCmdList, Resource InResourc
     if (InBarrierType == BarrierType::eBarrierTypeUAV)
     {
         if (!InResource) return ComputeStatus::eInvalidArgument;
+        if (m_perfStats) m_perfStats->add(extra::PerfCounter::eBarriers, 1);
 
         sl::Resource* inResourceVK = (sl::Resource*)InResource;
+        if (m_useSynchronization2)
+        {
+            // Same as a storage to storage transition, batched the same way
+            std::vector<VkImageMemoryBarrier2> images;
+            std::vector<VkBufferMemoryBarrier2> buffers;
+            auto stages = toVkPipelineStageFlags2(ResourceState::eStorageRW, getQueueType(commandBuffer));
+            if (inResourceVK->type == ResourceType::eBuffer)
+            {
+                VkBufferMemoryBarrier2 barrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2 };
+                barrier.srcStageMask = stages;
+                barrier.srcAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_SHADER_READ_BIT;
+                barrier.dstStageMask = stages;
+                barrier.dstAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_SHADER_READ_BIT;
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.buffer = (VkBuffer)inResourceVK->native;
+                barrier.offset = 0;
+                barrier.size = VK_WHOLE_SIZE;
+                buffers.push_back(barrier);
+            }
+            else
+            {
+                bool isImageViewForTexture = false, isImageViewTypeStencil = false;
+                VkImageMemoryBarrier2 barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+                barrier.srcStageMask = stages;
+                barrier.srcAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_SHADER_READ_BIT;
+                barrier.dstStageMask = stages;
+                barrier.dstAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_SHADER_READ_BIT;
+                barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+                barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.image = (VkImage)inResourceVK->native;
+                barrier.subresourceRange = { toVkAspectFlags(inResourceVK->nativeFormat, isImageViewForTexture, isImageViewTypeStencil), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+                images.push_back(barrier);
+            }
+            submitBarriers(commandBuffer, images, buffers);
+            return ComputeStatus::eOk;
+        }
+
         if(inResourceVK->type == ResourceType::eBuffer)
         {
             VkBufferMemoryBarrier memoryBarrier = {
@@ -2585,6 +3061,11 @@ ComputeStatus Vulkan::insertGPUBarrier(CommandList InCmdList, Resource InResourc
             m_ddt.CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, 0, 0, 0, 1, &memoryBarrier);
         }
     }
+    else if (InBarrierType == BarrierType::eBarrierTypeAliasing)
+    {
+        // Nothing is aliased on Vulkan, see 'createAliasedResources'
+        return ComputeStatus::eOk;
+    }
     else
     {
         assert(false);
@@ -2599,8 +3080,158 @@ ComputeStatus Vulkan::getResourceState(Resource resource, ResourceState& state)
     return resource ? getResourceState(resource->state, state) : ComputeStatus::eOk;
 }
 
+CommandQueueType Vulkan::getQueueType(VkCommandBuffer cmdBuffer)
+{
+    std::scoped_lock lock(m_nonGraphicsCommandBuffers.mutex);
+    auto it = m_nonGraphicsCommandBuffers.buffers.find(cmdBuffer);
+    return it != m_nonGraphicsCommandBuffers.buffers.end() ? (*it).second : CommandQueueType::eGraphics;
+}
+
+void Vulkan::recordBarriers(VkCommandBuffer cmdBuffer, const std::vector<VkImageMemoryBarrier2>& images, const std::vector<VkBufferMemoryBarrier2>& buffers)
+{
+    if (images.empty() && buffers.empty()) return;
+
+    VkDependencyInfo dependencyInfo{ VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+    dependencyInfo.bufferMemoryBarrierCount = (uint32_t)buffers.size();
+    dependencyInfo.pBufferMemoryBarriers = buffers.data();
+    dependencyInfo.imageMemoryBarrierCount = (uint32_t)images.size();
+    dependencyInfo.pImageMemoryBarriers = images.data();
+    m_ddt.CmdPipelineBarrier2(cmdBuffer, &dependencyInfo);
+}
+
+void Vulkan::submitBarriers(VkCommandBuffer cmdBuffer, const std::vector<VkImageMemoryBarrier2>& images, const std::vector<VkBufferMemoryBarrier2>& buffers)
+{
+    if (m_barrierBatchCount.load() > 0)
+    {
+        std::scoped_lock lock(m_mutexBarrierBatch);
+        auto it = m_barrierBatches.find(cmdBuffer);
+        if (it != m_barrierBatches.end())
+        {
+            auto& batch = (*it).second;
+            // Barriers for the same resource within one call are not ordered, record what we have first
+            bool overlaps = false;
+            for (auto& b : images)
+            {
+                overlaps |= std::find_if(batch.images.begin(), batch.images.end(), [&b](const VkImageMemoryBarrier2& p)->bool { return p.image == b.image; }) != batch.images.end();
+            }
+            for (auto& b : buffers)
+            {
+                overlaps |= std::find_if(batch.buffers.begin(), batch.buffers.end(), [&b](const VkBufferMemoryBarrier2& p)->bool { return p.buffer == b.buffer; }) != batch.buffers.end();
+            }
+            if (overlaps)
+            {
+                recordBarriers(cmdBuffer, batch.images, batch.buffers);
+                batch.images.clear();
+                batch.buffers.clear();
+            }
+            batch.images.insert(batch.images.end(), images.begin(), images.end());
+            batch.buffers.insert(batch.buffers.end(), buffers.begin(), buffers.end());
+            return;
+        }
+    }
+    recordBarriers(cmdBuffer, images, buffers);
+}
+
+void Vulkan::flushBarriers(VkCommandBuffer cmdBuffer)
+{
+    if (m_barrierBatchCount.load() == 0) return;
+
+    std::scoped_lock lock(m_mutexBarrierBatch);
+    auto it = m_barrierBatches.find(cmdBuffer);
+    if (it != m_barrierBatches.end())
+    {
+        auto& batch = (*it).second;
+        recordBarriers(cmdBuffer, batch.images, batch.buffers);
+        batch.images.clear();
+        batch.buffers.clear();
+    }
+}
+
+ComputeStatus Vulkan::beginTransitionBatch(CommandList cmdList)
+{
+    CHI_CHECK(Generic::beginTransitionBatch(cmdList));
+    if (m_useSynchronization2)
+    {
+        std::scoped_lock lock(m_mutexBarrierBatch);
+        if (m_barrierBatches[(VkCommandBuffer)cmdList].depth++ == 0)
+        {
+            m_barrierBatchCount++;
+        }
+    }
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus Vulkan::endTransitionBatch(CommandList cmdList)
+{
+    // Generic flushes transitions it deferred, these still land in our barrier batch
+    auto res = Generic::endTransitionBatch(cmdList);
+    if (m_useSynchronization2)
+    {
+        std::scoped_lock lock(m_mutexBarrierBatch);
+        auto it = m_barrierBatches.find((VkCommandBuffer)cmdList);
+        if (it != m_barrierBatches.end() && --(*it).second.depth == 0)
+        {
+            recordBarriers((VkCommandBuffer)cmdList, (*it).second.images, (*it).second.buffers);
+            m_barrierBatches.erase(it);
+            m_barrierBatchCount--;
+        }
+    }
+    return res;
+}
+
 ComputeStatus Vulkan::transitionResourceImpl(CommandList cmdList, const ResourceTransition *transitions, uint32_t count)
 {
+    if (m_useSynchronization2)
+    {
+        auto cmdBuffer = (VkCommandBuffer)cmdList;
+        auto queueType = getQueueType(cmdBuffer);
+
+        std::vector<VkImageMemoryBarrier2> images;
+        std::vector<VkBufferMemoryBarrier2> buffers;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (transitions[i].from == transitions[i].to) continue;
+
+            auto info = (sl::Resource*)transitions[i].resource;
+            auto srcStages = toVkPipelineStageFlags2(transitions[i].from, queueType);
+            auto dstStages = toVkPipelineStageFlags2(transitions[i].to, queueType);
+            if (info->type == ResourceType::eBuffer)
+            {
+                VkBufferMemoryBarrier2 barrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2 };
+                barrier.srcStageMask = srcStages;
+                barrier.srcAccessMask = toVkAccessFlags2(transitions[i].from);
+                barrier.dstStageMask = dstStages;
+                barrier.dstAccessMask = toVkAccessFlags2(transitions[i].to);
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.buffer = (VkBuffer)info->native;
+                barrier.offset = 0;
+                barrier.size = VK_WHOLE_SIZE;
+                buffers.push_back(barrier);
+            }
+            else
+            {
+                VkImageMemoryBarrier2 barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+                barrier.srcStageMask = srcStages;
+                barrier.srcAccessMask = toVkAccessFlags2(transitions[i].from);
+                barrier.dstStageMask = dstStages;
+                barrier.dstAccessMask = toVkAccessFlags2(transitions[i].to);
+                barrier.oldLayout = toVkImageLayout(transitions[i].from);
+                barrier.newLayout = toVkImageLayout(transitions[i].to == ResourceState::eUndefined ? ResourceState::eGeneral : transitions[i].to);
+                barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                barrier.image = (VkImage)info->native;
+                bool isImageViewForTexture = false, isImageViewTypeStencil = false;
+                barrier.subresourceRange = { toVkAspectFlags(info->nativeFormat, isImageViewForTexture, isImageViewTypeStencil), 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+                images.push_back(barrier);
+            }
+        }
+
+        if (m_perfStats) m_perfStats->add(extra::PerfCounter::eBarriers, images.size() + buffers.size());
+        submitBarriers(cmdBuffer, images, buffers);
+        return ComputeStatus::eOk;
+    }
+
     std::vector<VkImageMemoryBarrier> images;
     std::vector<VkBufferMemoryBarrier> buffers;
 
@@ -2648,6 +3279,7 @@ ComputeStatus Vulkan::transitionResourceImpl(CommandList cmdList, const Resource
     if (!images.empty() || !buffers.empty())
     {
         m_ddt.CmdPipelineBarrier((VkCommandBuffer)cmdList, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 0, nullptr, (uint32_t)buffers.size(), buffers.data(), (uint32_t)images.size(), images.data());
+        if (m_perfStats) m_perfStats->add(extra::PerfCounter::eBarriers, images.size() + buffers.size());
     }
     return ComputeStatus::eOk;
 }
@@ -2888,11 +3520,36 @@ ComputeStatus Vulkan::isNativeOpticalFlowSupported()
     return vk->nativeOpticalFlowHWSupport ? ComputeStatus::eOk : ComputeStatus::eNotSupported;
 }
 
+bool Vulkan::getMappedMemory(VkDeviceMemory memory, MappedMemory& mapped)
+{
+    std::scoped_lock lock(m_mutexMapped);
+    auto it = m_mappedMemory.find(memory);
+    if (it == m_mappedMemory.end())
+    {
+        return false;
+    }
+    mapped = (*it).second;
+    return true;
+}
+
 ComputeStatus Vulkan::mapResource(CommandList cmdList, Resource resource, void*& data, uint32_t subResource, uint64_t offset, uint64_t totalBytes)
 {
     auto src = (sl::Resource*)resource;
     if (!src) return ComputeStatus::eInvalidPointer;
-    
+
+    MappedMemory persistent{};
+    if (getMappedMemory((VkDeviceMemory)src->memory, persistent))
+    {
+        if (!persistent.coherent)
+        {
+            // Make GPU writes visible to the host, whole allocation so there is no need to align to 'nonCoherentAtomSize'
+            VkMappedMemoryRange range = { VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE, nullptr, (VkDeviceMemory)src->memory, 0, VK_WHOLE_SIZE };
+            m_ddt.InvalidateMappedMemoryRanges(m_device, 1, &range);
+        }
+        data = persistent.data + offset;
+        return ComputeStatus::eOk;
+    }
+
     void* mapped{};
     m_ddt.MapMemory(m_device, (VkDeviceMemory)src->memory, offset, totalBytes, 0, &mapped);
     data = mapped;
@@ -2904,6 +3561,18 @@ ComputeStatus Vulkan::unmapResource(CommandList cmdList, Resource resource, uint
     auto src = (sl::Resource*)resource;
     if (!src) return ComputeStatus::eInvalidPointer;
 
+    MappedMemory persistent{};
+    if (getMappedMemory((VkDeviceMemory)src->memory, persistent))
+    {
+        if (!persistent.coherent)
+        {
+            // Make host writes visible to the GPU
+            VkMappedMemoryRange range = { VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE, nullptr, (VkDeviceMemory)src->memory, 0, VK_WHOLE_SIZE };
+            m_ddt.FlushMappedMemoryRanges(m_device, 1, &range);
+        }
+        return ComputeStatus::eOk;
+    }
+
     m_ddt.UnmapMemory(m_device, (VkDeviceMemory)src->memory);
     return ComputeStatus::eOk;
 }
@@ -2918,6 +3587,8 @@ ComputeStatus Vulkan::copyResource(CommandList InCmdList, Resource InDstResource
         return ComputeStatus::eError;
     }
 
+    flushBarriers((VkCommandBuffer)InCmdList);
+
     ResourceDescription desc;
     getResourceDescription(src, desc);
 
@@ -2946,6 +3617,200 @@ ComputeStatus Vulkan::copyResource(CommandList InCmdList, Resource InDstResource
     return ComputeStatus::eOk;
 }
 
+ComputeStatus Vulkan::copyResourceRegion(CommandList InCmdList, Resource InDstResource, Resource InSrcResource, const Extent& region)
+{
+    auto src = (sl::Resource*)InSrcResource;
+    auto dst = (sl::Resource*)InDstResource;
+    if (!region || src->type == ResourceType::eBuffer || src->type != dst->type)
+    {
+        return copyResource(InCmdList, InDstResource, InSrcResource);
+    }
+
+    ResourceDescription desc;
+    getResourceDescription(src, desc);
+    if (region.left + region.width > desc.width || region.top + region.height > desc.height ||
+        (region.left == 0 && region.top == 0 && region.width == desc.width && region.height == desc.height))
+    {
+        return copyResource(InCmdList, InDstResource, InSrcResource);
+    }
+
+    flushBarriers((VkCommandBuffer)InCmdList);
+
+    // Same subresource as copyResource, only the first layer and mip
+    bool isImageViewForTexture = false, isImageViewTypeStencil = false;
+    VkImageCopy copyRegion =
+    {
+        { toVkAspectFlags(src->nativeFormat, isImageViewForTexture, isImageViewTypeStencil), 0, 0, 1 },
+        { (int32_t)region.left, (int32_t)region.top, 0 },
+        { toVkAspectFlags(dst->nativeFormat, isImageViewForTexture, isImageViewTypeStencil), 0, 0, 1 },
+        { (int32_t)region.left, (int32_t)region.top, 0 },
+        { region.width, region.height, 1 }
+    };
+    m_ddt.CmdCopyImage((VkCommandBuffer)InCmdList, (VkImage)src->native, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, (VkImage)dst->native, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus Vulkan::copyDepthToColor(CommandList InCmdList, Resource InDstResource, Resource InSrcResource)
+{
+    // vkCmdCopyImage requires size compatible formats of the same aspect, depth would need a buffer round trip or a shader
+    return ComputeStatus::eNotSupported;
+}
+
+ComputeStatus Vulkan::prepareTranslatedResources(CommandList cmdList, const std::vector<std::pair<chi::TranslatedResource, chi::ResourceDescription>>& resourceList)
+{
+    // Clones are D3D12 memory imported into Vulkan, see 'Generic::fetchTranslatedResourceFromCache'
+    for (auto& [resource, desc] : resourceList)
+    {
+        if (!resource.clone)
+        {
+            continue;
+        }
+
+        ResourceState cloneState{};
+        getResourceState(resource.clone, cloneState);
+        {
+            extra::ScopedTasks revTransitions;
+            ResourceTransition transitions[] =
+            {
+                {resource.source, ResourceState::eCopySource, desc.state},
+                {resource.clone, ResourceState::eCopyDestination, cloneState},
+            };
+            CHI_CHECK(transitionResources(cmdList, transitions, (uint32_t)countof(transitions), &revTransitions));
+            CHI_CHECK(copyResource(cmdList, resource.clone, resource.source));
+        }
+        // Other API ignores Vulkan layouts, general works for whatever it does with the memory
+        ResourceTransition toShared(resource.clone, ResourceState::eGeneral, ResourceState::eCopyDestination);
+        CHI_CHECK(transitionResources(cmdList, &toShared, 1));
+    }
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus Vulkan::importSharedResource(ResourceType type, Handle handle, const ResourceDescription& desc, Resource& resource)
+{
+    if (!handle)
+    {
+        return ComputeStatus::eInvalidArgument;
+    }
+
+    if (type == ResourceType::eFence)
+    {
+        if (!m_ddt.ImportSemaphoreWin32HandleKHR)
+        {
+            SL_LOG_ERROR("Importing shared fences requires 'VK_KHR_external_semaphore_win32'");
+            return ComputeStatus::eNotSupported;
+        }
+        Fence fence{};
+        CHI_CHECK(createFence(eFenceFlagsNone, 0, fence, "sl.shared.from.d3d12"));
+        VkImportSemaphoreWin32HandleInfoKHR importInfo = { VK_STRUCTURE_TYPE_IMPORT_SEMAPHORE_WIN32_HANDLE_INFO_KHR };
+        importInfo.semaphore = (VkSemaphore)fence;
+        importInfo.handleType = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_D3D12_FENCE_BIT;
+        importInfo.handle = (HANDLE)handle;
+        if (m_ddt.ImportSemaphoreWin32HandleKHR(m_device, &importInfo) != VK_SUCCESS)
+        {
+            SL_LOG_ERROR("Failed to import shared fence");
+            destroyFence(fence);
+            return ComputeStatus::eError;
+        }
+        resource = new sl::Resource(ResourceType::eFence, fence);
+        return ComputeStatus::eOk;
+    }
+    else if (type != ResourceType::eTex2d)
+    {
+        SL_LOG_ERROR("Unsupported resource type");
+        return ComputeStatus::eInvalidArgument;
+    }
+
+    if (!m_ddt.GetMemoryWin32HandlePropertiesKHR)
+    {
+        SL_LOG_ERROR("Importing shared textures requires 'VK_KHR_external_memory_win32'");
+        return ComputeStatus::eNotSupported;
+    }
+
+    NativeFormat native = NativeFormatUnknown;
+    getNativeFormat(desc.format, native);
+    if (native == VK_FORMAT_UNDEFINED)
+    {
+        SL_LOG_ERROR("Shared texture format %u has no Vulkan equivalent", desc.format);
+        return ComputeStatus::eNotSupported;
+    }
+
+    VkExternalMemoryImageCreateInfo externalInfo = { VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_IMAGE_CREATE_INFO, nullptr, VK_EXTERNAL_MEMORY_HANDLE_TYPE_D3D12_RESOURCE_BIT };
+    VkImageCreateInfo imageInfo = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO, &externalInfo };
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = (VkFormat)native;
+    imageInfo.extent = { desc.width, desc.height, 1 };
+    imageInfo.mipLevels = desc.mips;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    if (isFormatSupported(desc.format, VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT))
+    {
+        imageInfo.usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+    }
+
+    VkImage image{};
+    VK_CHECK(m_ddt.CreateImage(m_device, &imageInfo, nullptr, &image));
+
+    VkMemoryWin32HandlePropertiesKHR handleProps = { VK_STRUCTURE_TYPE_MEMORY_WIN32_HANDLE_PROPERTIES_KHR };
+    m_ddt.GetMemoryWin32HandlePropertiesKHR(m_device, VK_EXTERNAL_MEMORY_HANDLE_TYPE_D3D12_RESOURCE_BIT, (HANDLE)handle, &handleProps);
+    VkMemoryRequirements memReqs{};
+    m_ddt.GetImageMemoryRequirements(m_device, image, &memReqs);
+    // Exporter already picked the memory, any type the handle allows works
+    auto memoryTypeBits = memReqs.memoryTypeBits & (handleProps.memoryTypeBits ? handleProps.memoryTypeBits : UINT32_MAX);
+    uint32_t memoryTypeIndex = 0;
+    while (memoryTypeIndex < m_vkPhysicalDeviceMemoryProperties.memoryTypeCount && !(memoryTypeBits & (1 << memoryTypeIndex)))
+    {
+        memoryTypeIndex++;
+    }
+    if (memoryTypeIndex >= m_vkPhysicalDeviceMemoryProperties.memoryTypeCount)
+    {
+        SL_LOG_ERROR("No memory type can import the shared texture");
+        m_ddt.DestroyImage(m_device, image, nullptr);
+        return ComputeStatus::eError;
+    }
+
+    // Importing a D3D12 resource always needs a dedicated allocation
+    VkMemoryDedicatedAllocateInfo dedicatedInfo = { VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO, nullptr, image, VK_NULL_HANDLE };
+    VkImportMemoryWin32HandleInfoKHR importInfo = { VK_STRUCTURE_TYPE_IMPORT_MEMORY_WIN32_HANDLE_INFO_KHR, &dedicatedInfo, VK_EXTERNAL_MEMORY_HANDLE_TYPE_D3D12_RESOURCE_BIT, (HANDLE)handle, nullptr };
+    VkMemoryAllocateInfo memInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, &importInfo, memReqs.size, memoryTypeIndex };
+    VkDeviceMemory memory{};
+    if (m_ddt.AllocateMemory(m_device, &memInfo, nullptr, &memory) != VK_SUCCESS || m_ddt.BindImageMemory(m_device, image, memory, 0) != VK_SUCCESS)
+    {
+        SL_LOG_ERROR("Failed to import shared texture memory");
+        if (memory) m_ddt.FreeMemory(m_device, memory, nullptr);
+        m_ddt.DestroyImage(m_device, image, nullptr);
+        return ComputeStatus::eError;
+    }
+
+    bool isImageViewForTexture = true, isImageViewTypeStencil = false;
+    VkImageViewCreateInfo viewInfo = { VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO };
+    viewInfo.image = image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = imageInfo.format;
+    viewInfo.subresourceRange = { toVkAspectFlags(native, isImageViewForTexture, isImageViewTypeStencil), 0, 1, 0, 1 };
+    VkImageView view{};
+    if (m_ddt.CreateImageView(m_device, &viewInfo, nullptr, &view) != VK_SUCCESS)
+    {
+        m_ddt.FreeMemory(m_device, memory, nullptr);
+        m_ddt.DestroyImage(m_device, image, nullptr);
+        return ComputeStatus::eError;
+    }
+    setDebugNameVk(image, "sl.shared.from.d3d12");
+
+    resource = new sl::Resource{ ResourceType::eTex2d, image, memory, view, VK_IMAGE_LAYOUT_UNDEFINED };
+    resource->nativeFormat = imageInfo.format;
+    resource->width = imageInfo.extent.width;
+    resource->height = imageInfo.extent.height;
+    resource->arrayLayers = 1;
+    resource->mipLevels = imageInfo.mipLevels;
+    resource->usage = imageInfo.usage;
+    // We free these images but never allocate them so account for the VRAM
+    manageVRAM(resource, VRAMOperation::eAlloc);
+    return ComputeStatus::eOk;
+}
+
 bool Vulkan::isFormatSupported(Format format, VkFormatFeatureFlagBits flag)
 {
     uint32_t native;
@@ -2984,93 +3849,323 @@ ComputeStatus Vulkan::cloneResource(Resource InResource, Resource &OutResource,
     return ComputeStatus::eOk;
 }
 
-ComputeStatus Vulkan::clearView(CommandList InCmdList, Resource InResource, const float4 Color, const RECT* pRects, unsigned int NumRects, CLEAR_TYPE &outType)
+void Vulkan::clearImage(VkCommandBuffer commandBuffer, sl::Resource* vkResource, const float4& color)
 {
-    outType = CLEAR_UNDEFINED;
-    
-    VkCommandBuffer commandBuffer = (VkCommandBuffer)InCmdList;
+    VkClearColorValue clearColor;
+    clearColor.float32[0] = color.x;
+    clearColor.float32[1] = color.y;
+    clearColor.float32[2] = color.z;
+    clearColor.float32[3] = color.w;
+    VkImageSubresourceRange subresourceRange;
+    bool isImageViewForTexture = false, isImageViewTypeStencil = false;
+    subresourceRange.aspectMask = toVkAspectFlags(vkResource->nativeFormat, isImageViewForTexture, isImageViewTypeStencil);
+    subresourceRange.baseMipLevel = 0;
+    subresourceRange.levelCount = 1;
+    subresourceRange.baseArrayLayer = 0;
+    subresourceRange.layerCount = 1;
+    m_ddt.CmdClearColorImage(commandBuffer, (VkImage)vkResource->native, VK_IMAGE_LAYOUT_GENERAL, &clearColor, 1, &subresourceRange);
+}
 
+void Vulkan::insertRectClearBarrier(VkCommandBuffer commandBuffer, bool beforeClear)
+{
+    // XXX Toss in a very heavy barrier for now
+    constexpr VkAccessFlags kAnyAccess = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT |
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+        VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+        VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    if (beforeClear)
+    {
+        VkMemoryBarrier memoryBarrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER, NULL, kAnyAccess, VK_ACCESS_SHADER_WRITE_BIT };
+        m_ddt.CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, 0, 0, 0);
+    }
+    else
+    {
+        VkMemoryBarrier memoryBarrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER, NULL, VK_ACCESS_SHADER_WRITE_BIT, kAnyAccess };
+        m_ddt.CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &memoryBarrier, 0, 0, 0, 0);
+    }
+}
+
+void Vulkan::recordRectClears(VkCommandBuffer commandBuffer, sl::Resource* vkResource, const float4& color, const RECT* pRects, uint32_t NumRects)
+{
     // Update the push descriptor for the image view
     VkDescriptorImageInfo imageInfo = { 0 };
     VkWriteDescriptorSet write = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+    imageInfo.imageView = (VkImageView)vkResource->native;
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    write.dstBinding = 0;
+    write.dstArrayElement = 0;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    write.pImageInfo = &imageInfo;
+    write.pNext = NULL;
+
+    m_ddt.CmdPushDescriptorSetKHR(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_imageViewClear.pipelineLayout, 0, 1, &write);
+
+    // Update the push constant for the color
+    m_ddt.CmdPushConstants(commandBuffer, m_imageViewClear.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 16, 4 * 4, &color);
+
+    // For each rectangle, update the offset and dispatch with the size of the rectangle
+    for (unsigned int r = 0; r < NumRects; r++) {
+        uint32_t offsetSize[4] = { uint32_t(pRects[r].left), uint32_t(pRects[r].top),
+                                   uint32_t(pRects[r].right - pRects[r].left),
+                                   uint32_t(pRects[r].bottom - pRects[r].top) };
+
+        m_ddt.CmdPushConstants(commandBuffer, m_imageViewClear.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, 4 * 4, &offsetSize);
+
+        m_ddt.CmdDispatch(commandBuffer, (offsetSize[2] + 15) / 16, (offsetSize[3] + 15) / 16, 1);
+    }
+}
+
+ComputeStatus Vulkan::clearView(CommandList InCmdList, Resource InResource, const float4 Color, const RECT* pRects, unsigned int NumRects, CLEAR_TYPE &outType)
+{
+    outType = CLEAR_UNDEFINED;
+    
+    VkCommandBuffer commandBuffer = (VkCommandBuffer)InCmdList;
 
     if (!InResource) return ComputeStatus::eInvalidArgument;
 
     sl::Resource* vkResource = (sl::Resource*)InResource;
     if (vkResource->type == ResourceType::eBuffer) return ComputeStatus::eInvalidArgument;
 
+    flushBarriers(commandBuffer);
+
     if (NumRects == 0)
     {
-        VkClearColorValue clearColor;
-        clearColor.float32[0] = Color.x;
-        clearColor.float32[1] = Color.y;
-        clearColor.float32[2] = Color.z;
-        clearColor.float32[3] = Color.w;
-        VkImageSubresourceRange subresourceRange;
-        bool isImageViewForTexture = false, isImageViewTypeStencil = false;
-        subresourceRange.aspectMask = toVkAspectFlags(vkResource->nativeFormat, isImageViewForTexture, isImageViewTypeStencil);
-        subresourceRange.baseMipLevel = 0;
-        subresourceRange.levelCount = 1;
-        subresourceRange.baseArrayLayer = 0;
-        subresourceRange.layerCount = 1;
-        m_ddt.CmdClearColorImage(commandBuffer, (VkImage)vkResource->native, VK_IMAGE_LAYOUT_GENERAL, &clearColor, 1, &subresourceRange);
+        clearImage(commandBuffer, vkResource, Color);
         outType = CLEAR_ZBC_WITHOUT_PADDING;
     }
     else
     {
-        imageInfo.imageView = (VkImageView)vkResource->native;
-        imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        insertRectClearBarrier(commandBuffer, true);
+        m_ddt.CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_imageViewClear.doClear);
+        recordRectClears(commandBuffer, vkResource, Color, pRects, NumRects);
+        insertRectClearBarrier(commandBuffer, false);
+        outType = CLEAR_NON_ZBC;
+    }
 
-        write.dstBinding = 0;
-        write.dstArrayElement = 0;
-        write.descriptorCount = 1;
-        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-        write.pImageInfo = &imageInfo;
-        write.pNext = NULL;
+    return ComputeStatus::eOk;
+}
 
-        // XXX Toss in a very heavy barrier for now
+ComputeStatus Vulkan::clearViews(CommandList cmdList, ClearRequest* requests, uint32_t count)
+{
+    if (!cmdList || (count && !requests))
+    {
+        return ComputeStatus::eInvalidArgument;
+    }
+    std::vector<ResourceTransition> transitions;
+    transitions.reserve(count);
+    bool anyRects = false;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto vkResource = (sl::Resource*)requests[i].resource;
+        if (!vkResource || vkResource->type == ResourceType::eBuffer)
         {
-            VkMemoryBarrier memoryBarrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER, NULL,
-                VK_ACCESS_INPUT_ATTACHMENT_READ_BIT |
-                VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
-                VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
-                VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT,
-                VK_ACCESS_SHADER_WRITE_BIT };
-            m_ddt.CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, 0, 0, 0);
+            return ComputeStatus::eInvalidArgument;
         }
+        transitions.push_back({ requests[i].resource, ResourceState::eStorageRW });
+        anyRects |= requests[i].numRects > 0;
+    }
+    CHI_CHECK(transitionResources(cmdList, transitions.data(), count));
 
+    VkCommandBuffer commandBuffer = (VkCommandBuffer)cmdList;
+    flushBarriers(commandBuffer);
+
+    // Whole texture clears are transfer commands, no kernel or barriers needed in between
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto& request = requests[i];
+        if (request.numRects == 0)
+        {
+            clearImage(commandBuffer, (sl::Resource*)request.resource, request.color);
+            request.type = CLEAR_ZBC_WITHOUT_PADDING;
+        }
+    }
+
+    // Rect clears share one pipeline bind and one barrier scope, only the push descriptor changes per resource
+    if (anyRects)
+    {
+        insertRectClearBarrier(commandBuffer, true);
         m_ddt.CmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_imageViewClear.doClear);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto& request = requests[i];
+            if (request.numRects > 0)
+            {
+                recordRectClears(commandBuffer, (sl::Resource*)request.resource, request.color, request.rects, request.numRects);
+                request.type = CLEAR_NON_ZBC;
+            }
+        }
+        insertRectClearBarrier(commandBuffer, false);
+    }
+    return ComputeStatus::eOk;
+}
 
-        m_ddt.CmdPushDescriptorSetKHR(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_imageViewClear.pipelineLayout, 0, 1, &write);
+VkResult Vulkan::allocateMemory(MemoryPool pool, void* native, const VkMemoryRequirements& memReqs, uint32_t memoryTypeIndex, bool dedicated, bool deviceAddress, const char friendlyName[], VkDeviceMemory& memory, VkDeviceSize& offset)
+{
+    // If the VkPhysicalDeviceBufferDeviceAddressFeatures::bufferDeviceAddress feature is enabled and buffer was created 
+    // with the VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT bit set, memory must have been allocated with the VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT bit set
+    VkMemoryAllocateFlagsInfo memFlags = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO, nullptr, VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT, 0 };
+    VkMemoryAllocateInfo memInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, nullptr, memReqs.size, memoryTypeIndex };
+    if (deviceAddress)
+    {
+        memInfo.pNext = &memFlags;
+    }
 
-        // Update the push constant for the color
-        m_ddt.CmdPushConstants(commandBuffer, m_imageViewClear.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 16, 4 * 4, &Color);
+    if (dedicated || memReqs.size > kMemoryBlockSize)
+    {
+        VkMemoryDedicatedAllocateInfo dedicatedInfo = { VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO, memInfo.pNext };
+        if (pool == eMemoryPoolImage)
+        {
+            dedicatedInfo.image = (VkImage)native;
+        }
+        else
+        {
+            dedicatedInfo.buffer = (VkBuffer)native;
+        }
+        memInfo.pNext = &dedicatedInfo;
+        offset = 0;
+        auto result = m_ddt.AllocateMemory(m_device, &memInfo, nullptr, &memory);
+        if (result == VK_SUCCESS)
+        {
+            std::stringstream name{};
+            name << friendlyName << "_device_memory";
+            setDebugNameVk(memory, name.str().c_str());
+        }
+        return result;
+    }
 
-        // For each rectangle, update the offset and dispatch with the size of the rectangle
-        for (unsigned int r = 0; r < NumRects; r++) {
-            uint32_t offsetSize[4] = { uint32_t(pRects[r].left), uint32_t(pRects[r].top),
-                                       uint32_t(pRects[r].right - pRects[r].left),
-                                       uint32_t(pRects[r].bottom - pRects[r].top) };
+    std::scoped_lock lock(m_mutexMemory);
 
-            m_ddt.CmdPushConstants(commandBuffer, m_imageViewClear.pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, 4 * 4, &offsetSize);
+    auto alignment = std::max<VkDeviceSize>(memReqs.alignment, 1);
+    auto tryAllocate = [&memReqs, alignment](MemoryBlock& block, VkDeviceSize& allocOffset)->bool
+    {
+        for (auto it = block.freeRanges.begin(); it != block.freeRanges.end(); it++)
+        {
+            auto [start, length] = *it;
+            auto aligned = (start + alignment - 1) / alignment * alignment;
+            if (aligned + memReqs.size > start + length) continue;
 
-            m_ddt.CmdDispatch(commandBuffer, (offsetSize[2] + 15) / 16, (offsetSize[3] + 15) / 16, 1);
+            block.freeRanges.erase(it);
+            if (aligned > start)
+            {
+                block.freeRanges[start] = aligned - start;
+            }
+            auto end = aligned + memReqs.size;
+            if (end < start + length)
+            {
+                block.freeRanges[end] = start + length - end;
+            }
+            block.used += memReqs.size;
+            allocOffset = aligned;
+            return true;
         }
+        return false;
+    };
 
-        // XXX Toss in a very heavy barrier for now
+    auto& blocks = m_memoryBlocks[pool][memoryTypeIndex];
+    MemoryBlock* target{};
+    for (auto& block : blocks)
+    {
+        if (block->used + memReqs.size <= kMemoryBlockSize && tryAllocate(*block, offset))
         {
-            VkMemoryBarrier memoryBarrier = { VK_STRUCTURE_TYPE_MEMORY_BARRIER, NULL,
-                VK_ACCESS_SHADER_WRITE_BIT,
-                VK_ACCESS_INPUT_ATTACHMENT_READ_BIT |
-                VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
-                VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
-                VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT };
-            m_ddt.CmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &memoryBarrier, 0, 0, 0, 0);
+            target = block.get();
+            break;
         }
-        outType = CLEAR_NON_ZBC;
     }
 
-    return ComputeStatus::eOk;
+    if (!target)
+    {
+        auto block = std::make_unique<MemoryBlock>();
+        memInfo.allocationSize = kMemoryBlockSize;
+        auto result = m_ddt.AllocateMemory(m_device, &memInfo, nullptr, &block->memory);
+        if (result != VK_SUCCESS)
+        {
+            return result;
+        }
+        std::stringstream name{};
+        name << "SL_memory_block_" << (pool == eMemoryPoolImage ? "image_" : "buffer_") << memoryTypeIndex << "_" << blocks.size();
+        setDebugNameVk(block->memory, name.str().c_str());
+        SL_LOG_VERBOSE("Allocated %s memory block %u for type %u [%.1fMB]", pool == eMemoryPoolImage ? "image" : "buffer", (uint32_t)blocks.size(), memoryTypeIndex, kMemoryBlockSize / (1024.0 * 1024.0));
+        tryAllocate(*block, offset);
+        target = block.get();
+        blocks.push_back(std::move(block));
+    }
+
+    memory = target->memory;
+    m_memoryAllocations[native] = { pool, memoryTypeIndex, target, offset, memReqs.size };
+    return VK_SUCCESS;
+}
+
+void Vulkan::releaseMemory(void* native, VkDeviceMemory memory)
+{
+    {
+        std::scoped_lock lock(m_mutexMemory);
+        auto it = m_memoryAllocations.find(native);
+        if (it != m_memoryAllocations.end())
+        {
+            auto alloc = (*it).second;
+            m_memoryAllocations.erase(it);
+
+            auto& ranges = alloc.block->freeRanges;
+            auto offset = alloc.offset;
+            auto size = alloc.size;
+            auto next = ranges.lower_bound(offset);
+            if (next != ranges.end() && next->first == offset + size)
+            {
+                size += next->second;
+                next = ranges.erase(next);
+            }
+            if (next != ranges.begin())
+            {
+                auto prev = std::prev(next);
+                if (prev->first + prev->second == offset)
+                {
+                    offset = prev->first;
+                    size += prev->second;
+                    ranges.erase(prev);
+                }
+            }
+            ranges[offset] = size;
+            alloc.block->used -= alloc.size;
+
+            // Keep one empty block per memory type around so allocate/free patterns do not thrash the driver
+            auto& blocks = m_memoryBlocks[alloc.pool][alloc.memoryTypeIndex];
+            if (alloc.block->used == 0 && blocks.size() > 1)
+            {
+                m_ddt.FreeMemory(m_device, alloc.block->memory, nullptr);
+                blocks.erase(std::find_if(blocks.begin(), blocks.end(), [&alloc](const std::unique_ptr<MemoryBlock>& block)->bool { return block.get() == alloc.block; }));
+            }
+            return;
+        }
+    }
+    m_ddt.FreeMemory(m_device, memory, nullptr);
+}
+
+void Vulkan::shutdownMemoryAllocator()
+{
+    std::scoped_lock lock(m_mutexMemory);
+    if (!m_memoryAllocations.empty())
+    {
+        SL_LOG_WARN("%llu sub-allocated resources are still alive on shutdown", (uint64_t)m_memoryAllocations.size());
+    }
+    m_memoryAllocations.clear();
+    {
+        // Freeing memory implicitly unmaps it
+        std::scoped_lock mappedLock(m_mutexMapped);
+        m_mappedMemory.clear();
+    }
+    for (auto& pool : m_memoryBlocks)
+    {
+        for (auto& blocks : pool)
+        {
+            for (auto& block : blocks)
+            {
+                m_ddt.FreeMemory(m_device, block->memory, nullptr);
+            }
+            blocks.clear();
+        }
+    }
 }
 
 int Vulkan::destroyResourceDeferredImpl(const Resource resource)
@@ -3100,7 +4195,15 @@ int Vulkan::destroyResourceDeferredImpl(const Resource resource)
 
     if (resource->memory)
     {
-        m_ddt.FreeMemory(m_device, (VkDeviceMemory)resource->memory, nullptr);
+        if (destroyBuffer)
+        {
+            std::scoped_lock lock(m_mutexMapped);
+            if (m_mappedMemory.erase((VkDeviceMemory)resource->memory))
+            {
+                m_ddt.UnmapMemory(m_device, (VkDeviceMemory)resource->memory);
+            }
+        }
+        releaseMemory(resource->native, (VkDeviceMemory)resource->memory);
     }
 
     if (destroyBuffer)
@@ -3276,6 +4379,8 @@ ComputeStatus Vulkan::copyBufferToReadbackBuffer(CommandList InCmdList, Resource
 {
     VkCommandBuffer commandBuffer = (VkCommandBuffer)InCmdList;
 
+    flushBarriers(commandBuffer);
+
     // Throw in a memory barrier here, because the VK cubin resource transition implementations are just dummies that don't do anything,
     // due to the nature of the VK API (the interface NGX exposes doesn't give enough information for doing resource transitions in general)
     // and so we just expect all input resources to be in VK_IMAGE_LAYOUT_GENERAL. But this forces us to surround our copy
@@ -3360,12 +4465,15 @@ ComputeStatus Vulkan::beginPerfSection(CommandList cmdList, const char *key, uns
             {
                 Data.AccumulatedTimeMS += Delta;
                 Data.NumExecutedQueries++;
+                Data.meter.add(Delta);
+                countGPUPass(Delta);
             }
             else
             {
                 Data.Reset[Data.QueryIdx] = false;
                 Data.AccumulatedTimeMS = 0;
                 Data.NumExecutedQueries = 0;
+                Data.meter.reset();
             }
         }
         m_ddt.CmdResetQueryPool(commandBuffer, Data.QueryPool[Data.QueryIdx], 0, 2);
@@ -3395,6 +4503,94 @@ ComputeStatus Vulkan::endPerfSection(CommandList cmdList, const char *key, float
     return ComputeStatus::eOk;
 }
 
+ComputeStatus Vulkan::getPerfSectionStats(const char* key, PerfSectionStats& stats, unsigned int node)
+{
+    std::scoped_lock lock(m_mutexProfiler);
+    auto Section = m_SectionPerfMap[node].find(key);
+    if (Section == m_SectionPerfMap[node].end())
+    {
+        return ComputeStatus::eError;
+    }
+    auto& meter = (*Section).second.meter;
+    stats.lastMS = (float)meter.getValue();
+    stats.meanMS = (float)meter.getMean();
+    stats.p99MS = (float)meter.getPercentile(99.0);
+    stats.numSamples = meter.getNumSamples();
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus Vulkan::getPerfSectionNames(std::vector<std::string>& names, unsigned int node)
+{
+    std::scoped_lock lock(m_mutexProfiler);
+    names.clear();
+    for (auto& section : m_SectionPerfMap[node])
+    {
+        names.push_back(section.first);
+    }
+    return ComputeStatus::eOk;
+}
+
+// Labels need VK_EXT_debug_utils enabled by the host, entry points are null otherwise
+ComputeStatus Vulkan::beginProfiling(CommandList cmdList, uint32_t metadata, const char* marker)
+{
+    if (!m_ddt.CmdBeginDebugUtilsLabelEXT || !m_ddt.CmdEndDebugUtilsLabelEXT)
+    {
+        return ComputeStatus::eNoImplementation;
+    }
+    VkDebugUtilsLabelEXT label{ VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT };
+    label.pLabelName = marker;
+    m_ddt.CmdBeginDebugUtilsLabelEXT((VkCommandBuffer)cmdList, &label);
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus Vulkan::endProfiling(CommandList cmdList)
+{
+    if (!m_ddt.CmdEndDebugUtilsLabelEXT)
+    {
+        return ComputeStatus::eNoImplementation;
+    }
+    m_ddt.CmdEndDebugUtilsLabelEXT((VkCommandBuffer)cmdList);
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus Vulkan::beginProfilingQueue(CommandQueue cmdQueue, uint32_t metadata, const char* marker)
+{
+    if (!m_ddt.QueueBeginDebugUtilsLabelEXT || !m_ddt.QueueEndDebugUtilsLabelEXT)
+    {
+        return ComputeStatus::eNoImplementation;
+    }
+    VkDebugUtilsLabelEXT label{ VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT };
+    label.pLabelName = marker;
+    m_ddt.QueueBeginDebugUtilsLabelEXT((VkQueue)((CommandQueueVk*)cmdQueue)->native, &label);
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus Vulkan::endProfilingQueue(CommandQueue cmdQueue)
+{
+    if (!m_ddt.QueueEndDebugUtilsLabelEXT)
+    {
+        return ComputeStatus::eNoImplementation;
+    }
+    m_ddt.QueueEndDebugUtilsLabelEXT((VkQueue)((CommandQueueVk*)cmdQueue)->native);
+    return ComputeStatus::eOk;
+}
+
+ComputeStatus Vulkan::getShaderCaps(ShaderCaps& caps)
+{
+    VkPhysicalDeviceShaderFloat16Int8Features float16Int8Features = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES };
+    VkPhysicalDeviceFeatures2 features2 = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, &float16Int8Features };
+    m_idt.GetPhysicalDeviceFeatures2(m_physicalDevice, &features2);
+
+    VkPhysicalDeviceSubgroupProperties subgroupProperties = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES };
+    VkPhysicalDeviceProperties2 properties2 = { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, &subgroupProperties };
+    m_idt.GetPhysicalDeviceProperties2(m_physicalDevice, &properties2);
+
+    caps.nativeFP16 = float16Int8Features.shaderFloat16 == VK_TRUE;
+    caps.waveLaneCountMin = subgroupProperties.subgroupSize;
+    caps.waveLaneCountMax = subgroupProperties.subgroupSize;
+    return ComputeStatus::eOk;
+}
+
 bool Vulkan::signalCPUFence(Fence fence, uint64_t syncValue)
 {
     VkSemaphoreSignalInfo signalInfo{};
@@ -3571,14 +4767,13 @@ ComputeStatus Vulkan::getNativeFormat(Format format, NativeFormat& native)
  ComputeStatus Vulkan::setAsyncFrameMarker(CommandQueue queue, PCLMarker marker, uint64_t frameId)
  {
      CHECK_REFLEX();
-     SL_LOG_WARN_ONCE("Vulkan setAsyncFrameMarker is not implemented!");
      return m_reflex->setAsyncFrameMarker(queue, marker, frameId);
  }
  ComputeStatus Vulkan::setLatencyMarker(CommandQueue queue, PCLMarker marker, uint64_t frameId)
  {
      CHECK_REFLEX();
-     SL_LOG_WARN_ONCE("Vulkan setLatencyMarker is not implemented!");
-     return ComputeStatus::eOk;
+     // VK markers are not tied to a queue, same path as D3D12 SetLatencyMarker on the default queue
+     return m_reflex->setMarker(marker, frameId);
  }
 
  ComputeStatus Vulkan::fillSupportedDeviceExtensions()
@@ -86,6 +86,22 @@ struct PoolDescCombo
         std::vector<VkDescriptorSet> descSet{};
         size_t descSetIndex { kDescriptorSetCount - 1};
     } descSetData{};
+
+    //! Descriptor payload for all slots in binding order, refreshed in place when any slot is dirty
+    union DescriptorInfo
+    {
+        VkDescriptorImageInfo image;
+        VkDescriptorBufferInfo buffer;
+    };
+    std::vector<DescriptorInfo> descriptorInfos{};
+    //! Used with 'descriptorInfos' as is, 'writes' point into it and only serve drivers without update templates
+    VkDescriptorUpdateTemplate updateTemplate{};
+    std::vector<VkWriteDescriptorSet> writes{};
+
+    // descriptor buffer backend only, no pool or sets are allocated
+    VkDeviceSize layoutSize{};
+    std::vector<VkDeviceSize> bindingOffsets{};
+    VkDeviceSize descriptorBufferOffset{};
 };
 
 enum class DescriptorType
@@ -119,7 +135,7 @@ struct BindingSlot
         return *this;
     }
 
-    // dynamic buffers only
+    // dynamic buffers only, 'dataRange' also holds the size of storage buffers
     void* mapped = {};
     uint32_t instance = {};
     uint32_t offsetIndex = {};
@@ -140,6 +156,7 @@ struct ResourceBindingDesc
     uint32_t maxDescSets = 1;
     std::map<uint32_t, BindingSlot> descriptors;
     std::vector<uint32_t> offsets; // for dynamic buffers
+    PoolDescCombo* combo = {}; // cached entry from 'DispatchData::signatureToDesc'
 };
 
 struct DispatchData
@@ -177,6 +194,13 @@ struct CommandQueueVk : public sl::Resource
     uint32_t index;
 };
 
+//! Command buffers allocated for SL queues without graphics support, barriers recorded on them cannot use graphics stages
+struct CommandBufferSet
+{
+    std::mutex mutex;
+    std::unordered_map<VkCommandBuffer, CommandQueueType> buffers;
+};
+
 struct SwapChainVk : public sl::Resource
 {
     SwapChainVk(VkSwapchainKHR sc, const VkSwapchainCreateInfoKHR& i)
@@ -221,12 +245,76 @@ class Vulkan : public Generic
         UINT NumExecutedQueries = 0;
         float AccumulatedTimeMS = 0;
         bool Reset[SL_READBACK_QUEUE_SIZE] = {};
+        extra::AverageValueMeter meter{};
     };
     using MapSectionPerf = std::map<std::string, PerfData>;
     MapSectionPerf m_SectionPerfMap[MAX_NUM_NODES] = {};
 
     VkDebugUtilsMessengerEXT m_debugUtilsMessenger = {};
 
+    //! Persistent across runs, driver validates the header and ignores data from a different device or driver
+    VkPipelineCache m_pipelineCache = {};
+
+    void loadPipelineCache();
+    void savePipelineCache();
+
+    //! Records the staging to image copy and layout transitions shared by 'copyHostToDeviceTexture' and 'uploadToTexture'
+    void recordBufferToImageCopy(VkCommandBuffer commandBuffer, VkBuffer scratch, uint64_t scratchOffset, uint32_t rowLength, sl::Resource* dstResource);
+
+    //! Device local textures and buffers are placed in shared blocks, host visible resources and anything the
+    //! driver prefers to be dedicated (or which does not fit in a block) still get their own VkDeviceMemory.
+    //!
+    //! Images and buffers live in separate pools so 'bufferImageGranularity' never has to be honored between neighbours.
+    static constexpr VkDeviceSize kMemoryBlockSize = 64 * 1024 * 1024;
+    enum MemoryPool
+    {
+        eMemoryPoolImage,
+        eMemoryPoolBuffer,
+        eMemoryPoolCount
+    };
+    struct MemoryBlock
+    {
+        VkDeviceMemory memory{};
+        VkDeviceSize used{};
+        //! Free ranges keyed by offset, neighbours are merged on release
+        std::map<VkDeviceSize, VkDeviceSize> freeRanges{ { 0, kMemoryBlockSize } };
+    };
+    struct MemoryAllocation
+    {
+        MemoryPool pool{};
+        uint32_t memoryTypeIndex{};
+        MemoryBlock* block{};
+        VkDeviceSize offset{};
+        VkDeviceSize size{};
+    };
+    std::vector<std::unique_ptr<MemoryBlock>> m_memoryBlocks[eMemoryPoolCount][VK_MAX_MEMORY_TYPES];
+    std::unordered_map<void*, MemoryAllocation> m_memoryAllocations;
+    std::mutex m_mutexMemory;
+
+    VkResult allocateMemory(MemoryPool pool, void* native, const VkMemoryRequirements& memReqs, uint32_t memoryTypeIndex, bool dedicated, bool deviceAddress, const char friendlyName[], VkDeviceMemory& memory, VkDeviceSize& offset);
+    void releaseMemory(void* native, VkDeviceMemory memory);
+    void shutdownMemoryAllocator();
+
+    //! Host visible buffers we allocate are mapped once at creation and stay mapped until destroyed,
+    //! 'mapResource' returns the cached pointer and only non-coherent memory needs explicit flush/invalidate.
+    //!
+    //! Host allocated buffers are not in here, the host may map them itself so those are still mapped per call.
+    struct MappedMemory
+    {
+        uint8_t* data{};
+        bool coherent{};
+    };
+    std::unordered_map<VkDeviceMemory, MappedMemory> m_mappedMemory;
+    std::mutex m_mutexMapped;
+
+    bool getMappedMemory(VkDeviceMemory memory, MappedMemory& mapped);
+
+    //! Building blocks of 'clearView' and 'clearViews', the image is expected to be in VK_IMAGE_LAYOUT_GENERAL
+    void clearImage(VkCommandBuffer commandBuffer, sl::Resource* vkResource, const float4& color);
+    void insertRectClearBarrier(VkCommandBuffer commandBuffer, bool beforeClear);
+    //! Pipeline must already be bound to 'm_imageViewClear.doClear'
+    void recordRectClears(VkCommandBuffer commandBuffer, sl::Resource* vkResource, const float4& color, const RECT* pRects, uint32_t NumRects);
+
     inline static PFN_vkCreateInstance vkCreateInstance{};
     inline static PFN_vkDestroyInstance vkDestroyInstance{};
     inline static PFN_vkGetPhysicalDeviceFeatures2 vkGetPhysicalDeviceFeatures2{};
@@ -238,6 +326,36 @@ class Vulkan : public Generic
     static ComputeStatus getStaticVKMethods();
 
     ComputeStatus processDescriptors(DispatchData& thread);
+    ComputeStatus initDescriptorPool(DispatchData& thread, const std::vector<VkDescriptorSetLayoutBinding>& bindings, const std::vector<VkDescriptorPoolSize>& poolSizes, uint32_t totalDescriptorCount, PoolDescCombo& combo);
+
+    //! Optional VK_EXT_descriptor_buffer backend, descriptors are written straight into a host visible ring instead of
+    //! pool allocated sets. Only active when the interposer enabled the extension for SL ('vkDescriptorBuffer' in sl.interposer.json).
+    bool m_useDescriptorBuffer = false;
+#if defined(VK_EXT_descriptor_buffer)
+    static constexpr uint64_t kDescriptorBufferSize = 1024 * 1024;
+    struct DescriptorBuffer
+    {
+        VkBuffer buffer{};
+        VkDeviceMemory memory{};
+        VkDeviceAddress address{};
+        uint8_t* cpuVA{};
+        FrameRing space{ kDescriptorBufferSize, 3 };
+        VkPhysicalDeviceDescriptorBufferPropertiesEXT props{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT };
+        PFN_vkGetDescriptorSetLayoutSizeEXT getLayoutSize{};
+        PFN_vkGetDescriptorSetLayoutBindingOffsetEXT getBindingOffset{};
+        PFN_vkGetDescriptorEXT getDescriptor{};
+        PFN_vkCmdBindDescriptorBuffersEXT cmdBindBuffers{};
+        PFN_vkCmdSetDescriptorBufferOffsetsEXT cmdSetOffsets{};
+    };
+    DescriptorBuffer m_descriptorBuffer{};
+#endif
+    std::mutex m_mutexDescriptorBuffer;
+
+    ComputeStatus initDescriptorBuffer();
+    void shutdownDescriptorBuffer();
+    ComputeStatus initDescriptorBufferLayout(VkDescriptorSetLayout layout, const std::vector<VkDescriptorSetLayoutBinding>& bindings, PoolDescCombo& combo);
+    ComputeStatus writeDescriptorBuffer(DispatchData& thread, PoolDescCombo& combo);
+    void bindDescriptorBuffer(VkCommandBuffer cmdBuffer, VkPipelineLayout layout, VkDeviceSize offset);
 
     struct {
         VkPipelineLayout pipelineLayout;
@@ -248,6 +366,29 @@ class Vulkan : public Generic
 
     bool isFormatSupported(Format format, VkFormatFeatureFlagBits flag);
 
+    //! VK_KHR_synchronization2 barriers with stage and access masks derived from the states involved.
+    //!
+    //! While a transition batch is open on a command buffer barriers are accumulated and recorded with a single
+    //! vkCmdPipelineBarrier2 right before the next dispatch or copy, or when the batch ends.
+    bool m_useSynchronization2 = false;
+    struct BarrierBatch
+    {
+        uint32_t depth = 0;
+        std::vector<VkImageMemoryBarrier2> images;
+        std::vector<VkBufferMemoryBarrier2> buffers;
+    };
+    std::mutex m_mutexBarrierBatch;
+    std::map<VkCommandBuffer, BarrierBatch> m_barrierBatches;
+    std::atomic<uint32_t> m_barrierBatchCount = 0;
+    CommandBufferSet m_nonGraphicsCommandBuffers;
+
+    //! Anything not allocated by an SL compute or optical flow context is assumed to be a graphics command buffer
+    CommandQueueType getQueueType(VkCommandBuffer cmdBuffer);
+    void recordBarriers(VkCommandBuffer cmdBuffer, const std::vector<VkImageMemoryBarrier2>& images, const std::vector<VkBufferMemoryBarrier2>& buffers);
+    //! Records right away unless a batch is open on the command buffer
+    void submitBarriers(VkCommandBuffer cmdBuffer, const std::vector<VkImageMemoryBarrier2>& images, const std::vector<VkBufferMemoryBarrier2>& buffers);
+    void flushBarriers(VkCommandBuffer cmdBuffer);
+
     // Some API Specific implementation that can be called only from the Generic API shim
     ComputeStatus transitionResourceImpl(CommandList InCmdList, const ResourceTransition* transisitions, uint32_t count) override final;
     ComputeStatus createTexture2DResourceSharedImpl(ResourceDescription& InOutResourceDesc, Resource& OutResource, bool UseNativeFormat, ResourceState InitialState, const char InFriendlyName[]) override final;
@@ -304,6 +445,7 @@ public:
 
     uint64_t getCompletedValue(Fence fence) override final;
     virtual WaitStatus waitCPUFence(Fence fence, uint64_t syncValue) override final;
+    virtual WaitStatus waitCPUFences(const Fence* fences, const uint64_t* syncValues, uint32_t count, bool waitAny = false, uint32_t timeoutMs = 500) override final;
 
     virtual ComputeStatus createCommandQueue(CommandQueueType type,
                                              ChiCommandQueue*& queue,
@@ -324,7 +466,13 @@ public:
     virtual ComputeStatus getFormat(NativeFormat native, Format& format) override final;
 
     virtual ComputeStatus insertGPUBarrier(CommandList InCmdList, Resource InResource, BarrierType InBarrierType = eBarrierTypeUAV) override final;
+    virtual ComputeStatus beginTransitionBatch(CommandList cmdList) override final;
+    virtual ComputeStatus endTransitionBatch(CommandList cmdList) override final;
     virtual ComputeStatus copyResource(CommandList InCmdList, Resource InDstResource, Resource InSrcResource) override final;
+    virtual ComputeStatus copyResourceRegion(CommandList InCmdList, Resource InDstResource, Resource InSrcResource, const Extent& region) override final;
+    virtual ComputeStatus copyDepthToColor(CommandList InCmdList, Resource InDstResource, Resource InSrcResource) override final;
+    virtual ComputeStatus prepareTranslatedResources(CommandList cmdList, const std::vector<std::pair<chi::TranslatedResource, chi::ResourceDescription>>& resourceList) override final;
+    virtual ComputeStatus importSharedResource(ResourceType type, Handle handle, const ResourceDescription& desc, Resource& res) override final;
     virtual ComputeStatus cloneResource(Resource InResource, Resource &OutResource, const char friendlyName[], ResourceState InitialState, unsigned int InCreationMask, unsigned int InVisibilityMask) override final;
     virtual ComputeStatus copyBufferToReadbackBuffer(CommandList InCmdList, Resource InResource, Resource OutResource, unsigned int InBytesToCopy) override final;
     virtual ComputeStatus getResourceState(Resource resource, ResourceState& state) override final;
@@ -334,12 +482,14 @@ public:
     virtual ComputeStatus startTrackingResource(uint32_t frameId, uint64_t uid, Resource resource) override final { return ComputeStatus::eOk; }
     virtual ComputeStatus stopTrackingResource(uint64_t uid, Resource dbgResource) override final { return ComputeStatus::eOk; }
     virtual ComputeStatus stopTrackingResource(uint32_t frameId, uint64_t uid, Resource dbgResource) override final { return ComputeStatus::eOk; }
+    virtual ComputeStatus getTrackedResourceGeneration(Resource resource, uint64_t& generation) override final { return ComputeStatus::eNoImplementation; }
 
     virtual ComputeStatus mapResource(CommandList cmdList, Resource resource, void*& data, uint32_t subResource = 0, uint64_t offset = 0, uint64_t totalBytes = UINT64_MAX) override final;
     virtual ComputeStatus unmapResource(CommandList cmdList, Resource resource, uint32_t subResource) override final;
 
     virtual ComputeStatus copyHostToDeviceBuffer(CommandList InCmdList, uint64_t InSize, const void* InData, Resource InUploadResource, Resource InTargetResource, unsigned long long InUploadOffset, unsigned long long InDstOffset) override final;
     virtual ComputeStatus copyHostToDeviceTexture(CommandList InCmdList, uint64_t InSize, uint64_t RowPitch, const void* InData, Resource InTargetResource, Resource& InUploadResource) override final;
+    virtual ComputeStatus uploadToTexture(CommandList cmdList, const void* data, uint64_t size, uint64_t rowPitch, Resource target) override final;
 
     virtual ComputeStatus getSwapChainBuffer(SwapChain chain, uint32_t index, Resource& buffer) override final;
     
@@ -349,6 +499,13 @@ public:
 
     virtual ComputeStatus beginPerfSection(CommandList cmdList, const char *section, unsigned int node, bool reset = false) override;
     virtual ComputeStatus endPerfSection(CommandList cmdList, const char *section, float &avgTimeMS, unsigned int node) override;
+    virtual ComputeStatus getPerfSectionStats(const char* section, PerfSectionStats& stats, uint32_t node) override;
+    virtual ComputeStatus getPerfSectionNames(std::vector<std::string>& names, uint32_t node) override;
+    virtual ComputeStatus getShaderCaps(ShaderCaps& caps) override final;
+    virtual ComputeStatus beginProfiling(CommandList cmdList, uint32_t metadata, const char* marker) override final;
+    virtual ComputeStatus endProfiling(CommandList cmdList) override final;
+    virtual ComputeStatus beginProfilingQueue(CommandQueue cmdQueue, uint32_t metadata, const char* marker) override final;
+    virtual ComputeStatus endProfilingQueue(CommandQueue cmdQueue) override final;
 
     virtual bool signalCPUFence(Fence fence, uint64_t syncValue) override final;
 
@@ -370,6 +527,8 @@ public:
 
     // check if an extension is available
     virtual ComputeStatus isDeviceExtensionSupported(const char* extension, uint32_t version) override final;
+
+    virtual ComputeStatus clearViews(CommandList cmdList, ClearRequest* requests, uint32_t count) override final;
 };
 
 }
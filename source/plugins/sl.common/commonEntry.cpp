@@ -22,13 +22,23 @@
 
 #include <dxgi1_6.h>
 #include <d3d11_4.h>
+#include <optional>
+#include <future>
 
 #include "include/sl.h"
 #include "source/core/sl.api/internal.h"
 #include "include/sl_consts.h"
 #include "include/sl_helpers.h"
+#include "include/sl_matrix_helpers.h"
+#include "include/sl_perf_stats.h"
+#include "include/sl_headless.h"
 #include "source/core/sl.log/log.h"
 #include "source/core/sl.file/file.h"
+#include "source/core/sl.extra/startupTimeline.h"
+#include "source/core/sl.extra/perfStats.h"
+#include "source/core/sl.extra/hitches.h"
+#include "source/core/sl.extra/frameArena.h"
+#include "source/core/sl.extra/imageTable.h"
 #include "source/core/sl.plugin/plugin.h"
 #include "source/core/sl.param/parameters.h"
 #include "source/core/sl.interposer/d3d12/d3d12.h"
@@ -39,6 +49,7 @@
 #include "source/platforms/sl.chi/capture.h"
 #include "source/plugins/sl.common/commonInterface.h"
 #include "source/plugins/sl.common/resourceTaggingForFrame.h"
+#include "source/plugins/sl.common/tagValidation.h"
 #include "source/plugins/sl.common/commonDRSInterface.h"
 #include "source/plugins/sl.common/drs.h"
 #include "source/plugins/sl.pcl/pclImpl.h"
@@ -76,6 +87,8 @@ extern HRESULT slHookPresent(IDXGISwapChain* swapChain, UINT SyncInterval, UINT
 extern HRESULT slHookAfterPresent(UINT Flags);
 extern HRESULT slHookPresent1(IDXGISwapChain* swapChain, UINT SyncInterval, UINT Flags, DXGI_PRESENT_PARAMETERS* params, bool& Skip);
 extern HRESULT slHookResizeSwapChainPre(IDXGISwapChain* swapChain, UINT BufferCount, UINT Width, UINT Height, DXGI_FORMAT NewFormat, UINT SwapChainFlags, bool& Skip);
+extern HRESULT slHookResizeSwapChainPost(IDXGISwapChain* swapChain, UINT BufferCount, UINT Width, UINT Height, DXGI_FORMAT NewFormat, UINT& SwapChainFlags);
+extern void slHookSwapChainDestroyed(IDXGISwapChain* swapChain);
 
 // VULKAN
 extern VkResult slHookVkPresent(VkQueue Queue, const VkPresentInfoKHR* PresentInfo, bool& Skip);
@@ -85,6 +98,7 @@ extern void slHookVkCmdBindDescriptorSets(VkCommandBuffer CommandBuffer, VkPipel
 extern void slHookVkBeginCommandBuffer(VkCommandBuffer CommandBuffer, const VkCommandBufferBeginInfo* BeginInfo);
 
 extern bool getSystemCaps(common::SystemCaps*& info);
+extern sl::Result presentHeadless(const sl::HeadlessPresentOptions& options);
 extern sl::Result slEvaluateFeatureInternal(sl::Feature feature, const sl::FrameToken& frame, const sl::BaseStructure** inputs, uint32_t numInputs, sl::CommandBuffer* cmdBuffer);
 
 struct NGXContextStandard : public common::NGXContext
@@ -97,6 +111,36 @@ struct NGXContextD3D12 : public common::NGXContext
 
 namespace common
 {
+//! Evaluation parameter block owned by a single viewport, see 'NGXContext::setCachedParameter'
+struct NGXParameterCache
+{
+    struct Value
+    {
+        NGXParameterType type{};
+        uint64_t bits{};
+        bool valid = false;
+    };
+
+    NVSDK_NGX_Parameter* params{};
+    //! Only a block nobody else writes to can be diffed
+    bool owned = false;
+    //! Keys are resolved once per call site pointer, same key can come from different string literals
+    std::unordered_map<const char*, uint32_t> slots{};
+    std::unordered_map<std::string, uint32_t> names{};
+    std::vector<Value> values{};
+};
+
+//! Camera matrices of the current and previous frame for a viewport
+struct CameraHistory
+{
+    uint32_t frame = UINT_MAX;
+    float4x4 cameraViewToWorld{};
+    float4x4 cameraViewToClip{};
+    bool hasPrevious = false;
+    float4x4 prevCameraViewToWorld{};
+    float4x4 prevCameraViewToClip{};
+};
+
 //! Our common context
 //! 
 //! Here we keep tagged resources, NGX context
@@ -120,6 +164,10 @@ struct CommonEntryContext
     DRSContext drsContext{};            // DRS context for plugins which use d3dreg keys
 
     common::SystemCaps* caps{};
+    //! Owned by sl.interposer, see 'slGetPerfStats'
+    extra::IPerfStats* perfStats{};
+    //! Owned by sl.interposer, only with 'vkImageTracking' on Vulkan
+    extra::ImageTable* imageTable{};
 
     chi::IResourcePool* pool{};
     chi::ICompute* compute{};
@@ -128,7 +176,10 @@ struct CommonEntryContext
 
     std::unique_ptr<ResourceTaggingBase> pBaseResourceTagging{};
     // Common constants must be set every frame, we allow up to 3 frames in flight
-    common::ViewportIdFrameData<3, true> constants = { "common" };
+    common::TypedViewportIdFrameData<common::CommonConstants, 3, true> constants = { "common" };
+    // Camera matrices from the last frames per viewport, used to derive previous frame data
+    std::mutex cameraHistoryMutex{};
+    std::map<uint32_t, CameraHistory> cameraHistory{};
 
     // WAR for interposer < 2.3 which don't load PCL plugin.  PCL functionality will instead be handled in sl.common.
     PCLOptions pclOptions{};
@@ -138,6 +189,15 @@ struct CommonEntryContext
     // frame-based resource-tagging and thereby resource-tagging for multiple frames in the same frame as required by some SL clients
     // and is therefore not frame-aware.
     bool useResourceTaggingForFrame = false;
+
+    // Clone policies declared by plugins, see 'TagClonePolicy', rarely written so most lookups only check 'anyTagClonePolicy'
+    std::shared_mutex tagClonePolicyMutex{};
+    std::unordered_map<BufferTagInfo, TagClonePolicy, BufferTagInfoHash> tagClonePolicies{};
+    std::atomic<bool> anyTagClonePolicy = false;
+
+#ifndef SL_PRODUCTION
+    TagValidator tagValidator{};
+#endif
 };
 }
 
@@ -150,6 +210,7 @@ void updateEmbeddedJSON(json& config);
 SL_PLUGIN_DEFINE("sl.common", Version(VERSION_MAJOR, VERSION_MINOR, VERSION_PATCH), Version(0, 0, 1), JSON.c_str(), updateEmbeddedJSON, common, CommonEntryContext)
 
 extern uint64_t getCurrentFrame();
+extern common::FrameworkStats& getFrameworkStats();
 
 //! Thread safe get/set resource tag
 //! 
@@ -167,6 +228,120 @@ void getCommonTag(BufferType tagType, uint32_t frameId, uint32_t viewportId, Com
     ctx.pBaseResourceTagging->getTag(tagType, frameId, viewportId, res, inputs, numInputs, optional);
 }
 
+void setCommonTagClonePolicy(const BufferTagInfo& info, TagClonePolicy policy)
+{
+    auto& ctx = (*common::getContext());
+    std::unique_lock lock(ctx.tagClonePolicyMutex);
+    ctx.tagClonePolicies[info] = policy;
+    ctx.anyTagClonePolicy = true;
+}
+
+TagClonePolicy getTagClonePolicy(const BufferTagInfo& info)
+{
+    auto& ctx = (*common::getContext());
+    if (!ctx.anyTagClonePolicy.load(std::memory_order_relaxed))
+    {
+        return TagClonePolicy::eExact;
+    }
+    std::shared_lock lock(ctx.tagClonePolicyMutex);
+    auto it = ctx.tagClonePolicies.find(info);
+    return it != ctx.tagClonePolicies.end() ? it->second : TagClonePolicy::eExact;
+}
+
+sl::Result common::ResourceTaggingBase::makeVolatileCopy(chi::ICompute* compute, chi::IResourcePool* pool, chi::CommandList cmdList, const sl::Resource* resource,
+    BufferType tag, uint32_t id, const Extent* ext, bool requiredOnPresent, bool requiredOnEvaluate, CommonResource& res)
+{
+    // Actual resource to use
+    auto actualResource = (chi::Resource)resource;
+
+    // Reduced clone only if the consumers of every lifecycle this tag is required with are fine with it
+    bool depthOnly = (requiredOnPresent || requiredOnEvaluate) &&
+        (!requiredOnPresent || getTagClonePolicy({ id, tag, ResourceLifecycle::eValidUntilPresent }) == TagClonePolicy::eDepthOnly) &&
+        (!requiredOnEvaluate || getTagClonePolicy({ id, tag, ResourceLifecycle::eValidUntilEvaluate }) == TagClonePolicy::eDepthOnly);
+    if (depthOnly)
+    {
+        RenderAPI platform{};
+        compute->getRenderAPI(platform);
+        chi::ResourceDescription desc{};
+        compute->getResourceDescription(actualResource, desc);
+        depthOnly = platform == RenderAPI::eD3D12 && desc.format == chi::eFormatD32S32 && desc.mips == 1 && desc.depth == 1;
+    }
+
+    // Runs for every volatile tag each frame, name is only used on a pool miss so keep it on the stack
+    auto name = extra::formatInline("sl.tag.{}.volatile.{}", sl::getBufferTypeAsStr(tag), id);
+    res.clone = depthOnly ? pool->allocateAs(actualResource, chi::eFormatR32F, name) : pool->allocate(actualResource, name);
+    if (!res.clone)
+    {
+        return Result::eErrorComputeFailed;
+    }
+
+    if (auto perfStats = (*common::getContext()).perfStats)
+    {
+        // Only the tagged region is copied, clones of sub-rectangles are still allocated at full size
+        chi::ResourceFootprint footprint{};
+        compute->getResourceFootprint(res.clone, footprint);
+        uint64_t bytes = footprint.totalBytes;
+        uint64_t pixels = (uint64_t)footprint.width * footprint.height;
+        if (ext && *ext && pixels)
+        {
+            bytes = bytes * std::min(pixels, (uint64_t)ext->width * ext->height) / pixels;
+        }
+        perfStats->add(extra::PerfCounter::eVolatileTagBytes, bytes);
+    }
+
+    // Get tagged resource's state
+    chi::ResourceState state{};
+    compute->getResourceState(res.res.state, state);
+    // Now store clone's state for further use in SL, copy transitions are reverted so that is where it ends up
+    chi::ResourceState cloneState = res.clone.getState();
+    compute->getNativeResourceState(cloneState, res.res.state);
+
+    Extent region = ext ? *ext : Extent{};
+    if (auto batch = getTagCopyBatch())
+    {
+        // Recorded together with the other tags from this call, see setTagCommon
+        batch->copies.push_back({ *resource, state, res.clone, cloneState, region, depthOnly });
+        return Result::eOk;
+    }
+
+    chi::ScopedProfilingSection section(compute, cmdList, name);
+    extra::ScopedTasks revTransitions;
+    chi::ResourceTransition transitions[] =
+    {
+        {actualResource, chi::ResourceState::eCopySource, state},
+        {res.clone, chi::ResourceState::eCopyDestination, cloneState},
+    };
+    CHI_CHECK_RR(compute->transitionResources(cmdList, transitions, (uint32_t)countof(transitions), &revTransitions));
+    if (depthOnly)
+    {
+        CHI_CHECK_RR(compute->copyDepthToColor(cmdList, res.clone, actualResource));
+    }
+    else
+    {
+        // Dynamic resolution often tags a sub-rectangle of a max sized target, only that part is needed
+        CHI_CHECK_RR(compute->copyResourceRegion(cmdList, res.clone, actualResource, region));
+    }
+    return Result::eOk;
+}
+
+void getCommonTags(const BufferType* tagTypes, uint32_t count, uint32_t frameId, uint32_t viewportId, CommonResource* res, const sl::BaseStructure** inputs, uint32_t numInputs, bool optional)
+{
+    auto& ctx = (*common::getContext());
+
+    if (ctx.pBaseResourceTagging == nullptr)
+    {
+        SL_LOG_ERROR("SL Resource tagging not properly initialized!");
+        assert("SL Resource tagging not properly initialized!" && false);
+        return;
+    }
+
+    for (uint32_t offset = 0; offset < count; offset += ResourceTaggingBase::kMaxTagsPerRequest)
+    {
+        auto batch = std::min(count - offset, ResourceTaggingBase::kMaxTagsPerRequest);
+        ctx.pBaseResourceTagging->getTags(tagTypes + offset, batch, frameId, viewportId, res + offset, inputs, numInputs, optional);
+    }
+}
+
 void recycleFramePresentEndResourceTags()
 {
     auto& ctx = (*common::getContext());
@@ -194,12 +369,14 @@ sl::Result common::ResourceTaggingGeneral::setTag(const sl::Resource* resource,
     CommandBuffer* cmdBuffer,
     bool localTag,
     const PrecisionInfo* pi,
+    const ResourceLifetimeInfo* lifetime,
     const sl::FrameToken& frame)
 {
     auto& ctx = (*common::getContext());
     uint64_t uid = ((uint64_t)tag << 32) | (uint64_t)id;
     CommonResource cr{};
     cr.uFrameWhenTagged = getCurrentFrame();
+    cr.lifecycle = lifecycle;
     if (resource && resource->native)
     {
         cr.res = *(sl::Resource*)resource;
@@ -223,16 +400,26 @@ sl::Result common::ResourceTaggingGeneral::setTag(const sl::Resource* resource,
         bool writeTag = tag == kBufferTypeScalingOutputColor || tag == kBufferTypeAmbientOcclusionDenoised ||
             tag == kBufferTypeShadowDenoised || tag == kBufferTypeSpecularHitDenoised || tag == kBufferTypeDiffuseHitDenoised ||
             tag == kBufferTypeBackbuffer;
+        if (lifecycle == ResourceLifecycle::eValidForFrames)
+        {
+            //! Host owns a ring of resources and promises not to touch this one for the specified number of frames
+            //! so instead of copying we just keep track of the frame it was tagged in, see getTag below.
+            cr.uFramesValid = lifetime ? lifetime->frameCount : ResourceLifetimeInfo::kDefaultFrameCount;
+            if (cr.uFramesValid == 0)
+            {
+                SL_LOG_ERROR("Tag '%s' requires at least one valid frame", sl::getBufferTypeAsStr(tag));
+                return Result::eErrorInvalidParameter;
+            }
+        }
         if (!writeTag && lifecycle != ResourceLifecycle::eValidUntilPresent)
         {
             //! Only make a copy if this tag is required by at least one loaded and supported plugin on the same viewport and with immutable life-cycle.
             //! 
-            //! If tag is required on present we have to make a copy always, if tag is required on evaluate
-            //! we make a copy only if buffer is tagged as "valid only now" and this is not a local tag.
-            resourceTagMutex.lock();
-            auto requiredOnPresent = requiredTags.find({ id, tag, ResourceLifecycle::eValidUntilPresent }) != requiredTags.end();
-            auto requiredOnEvaluate = requiredTags.find({ id, tag, ResourceLifecycle::eValidUntilEvaluate }) != requiredTags.end();
-            resourceTagMutex.unlock();
+            //! If tag is required on present we have to make a copy always, including host rings since present can run after
+            //! the host moved on, if tag is required on evaluate we make a copy only if buffer is tagged as "valid only now"
+            //! and this is not a local tag.
+            auto requiredOnPresent = requiredTags.contains({ id, tag, ResourceLifecycle::eValidUntilPresent });
+            auto requiredOnEvaluate = requiredTags.contains({ id, tag, ResourceLifecycle::eValidUntilEvaluate });
             auto makeCopy = requiredOnPresent || (requiredOnEvaluate && lifecycle == ResourceLifecycle::eOnlyValidNow && !localTag);
 
             if (makeCopy)
@@ -244,9 +431,6 @@ sl::Result common::ResourceTaggingGeneral::setTag(const sl::Resource* resource,
                 }
                 cmdBuffer = common::getNativeCommandBuffer(cmdBuffer);
 
-                // Actual resource to use
-                auto actualResource = (chi::Resource)resource;
-
                 // Quick peek at the previous tag with the same id
                 resourceTagMutex.lock();
                 auto prevTag = idToResourceMap[uid];
@@ -261,21 +445,11 @@ sl::Result common::ResourceTaggingGeneral::setTag(const sl::Resource* resource,
                     ctx.compute->stopTrackingResource(uid, &prevTag.res);
                 }
 
-                // Defaults to eCopyDestination state 
-                cr.clone = ctx.pool->allocate(actualResource, extra::format("sl.tag.{}.volatile.{}", sl::getBufferTypeAsStr(tag), id).c_str());
-
-                // Get tagged resource's state
-                chi::ResourceState state{};
-                ctx.compute->getResourceState(cr.res.state, state);
-                // Now store clone's state for further use in SL
-                ctx.compute->getNativeResourceState(chi::ResourceState::eCopyDestination, cr.res.state);
-                extra::ScopedTasks revTransitions;
-                chi::ResourceTransition transitions[] =
+                auto copyResult = makeVolatileCopy(ctx.compute, ctx.pool, cmdBuffer, resource, tag, id, ext, requiredOnPresent, requiredOnEvaluate, cr);
+                if (copyResult != Result::eOk)
                 {
-                    {actualResource, chi::ResourceState::eCopySource, state},
-                };
-                CHI_CHECK_RR(ctx.compute->transitionResources(cmdBuffer, transitions, (uint32_t)countof(transitions), &revTransitions));
-                CHI_CHECK_RR(ctx.compute->copyResource(cmdBuffer, cr.clone, actualResource));
+                    return copyResult;
+                }
 
                 // We've made a copy of the original resource and we're not doing AddRef() on the original. So set the
                 // original to nullptr - that way nobody can access it (it may become invalid at some point).
@@ -300,6 +474,20 @@ sl::Result common::ResourceTaggingGeneral::setTag(const sl::Resource* resource,
         // If this is a local tag but it was not copied there is nothing more to do, bail out
         if (localTag) return Result::eOk;
 
+        // Host tagging the same resource every frame, it is tracked already so only the frame index moves forward
+        if (cr.res.native)
+        {
+            std::lock_guard<std::mutex> lock(resourceTagMutex);
+            auto it = idToResourceMap.find(uid);
+            if (it != idToResourceMap.end() && (*it).second.isSameTag(cr))
+            {
+                cr.updateChanged((*it).second);
+                (*it).second.uFrameWhenTagged = cr.uFrameWhenTagged;
+                (*it).second.changed = cr.changed;
+                return Result::eOk;
+            }
+        }
+
         if (cr.res.native)
         {
             ctx.compute->startTrackingResource(uid, &cr.res);
@@ -317,6 +505,7 @@ sl::Result common::ResourceTaggingGeneral::setTag(const sl::Resource* resource,
         // Host can set null as a tag or even change the life-cycle of a tag, in that case any previously allocated copies must be recycled
         ctx.pool->recycle(prevTag.clone);
     }
+    cr.updateChanged(prevTag);
     prevTag = cr;
     return Result::eOk;
 }
@@ -324,68 +513,60 @@ sl::Result common::ResourceTaggingGeneral::setTag(const sl::Resource* resource,
 //! Thread safe get/set resource tag
 //! 
 void common::ResourceTaggingGeneral::getTag(BufferType tagType, uint32_t frameId, uint32_t viewportId, CommonResource& res, const sl::BaseStructure** inputs, uint32_t numInputs, bool optional)
+{
+    getTags(&tagType, 1, frameId, viewportId, &res, inputs, numInputs, optional);
+}
+
+void common::ResourceTaggingGeneral::getTags(const BufferType* tagTypes, uint32_t count, uint32_t frameId, uint32_t viewportId, CommonResource* res, const sl::BaseStructure** inputs, uint32_t numInputs, bool optional)
 {
     auto& ctx = (*common::getContext());
 
     //! First look for local tags
-    if (inputs)
-    {
-        std::vector<ResourceTag*> tags;
-        if (findStructs<ResourceTag>((const void**)inputs, numInputs, tags))
-        {
-            for (auto& tag : tags)
-            {
-                if (tag->type == tagType)
-                {
-                    res.extent = tag->extent;
-                    res.res = *tag->resource;
-
-                    // Optional extensions are chained after the tag they belong to
-                    PrecisionInfo* optPi = findStruct<PrecisionInfo>(tag->next);
-                    res.pi = optPi ? *optPi : PrecisionInfo{};
-
-                    //! Keep track of what tags are requested for what viewport (unique insert)
-                    //! 
-                    //! Note that the presence of a valid pointer to 'inputs' 
-                    //! indicates that we are called during the evaluate feature call.
-                    std::lock_guard<std::mutex> lock(resourceTagMutex);
-                    requiredTags.insert({ viewportId, tagType, ResourceLifecycle::eValidUntilEvaluate });
+    const uint64_t local = findLocalTags(tagTypes, count, res, inputs, numInputs);
 
-                    return;
-                }
-            }
-        }
-    }
-
-    //! Now let's check the global ones
-    uint64_t uid = ((uint64_t)tagType << 32) | (uint64_t)viewportId;
     std::lock_guard<std::mutex> lock(resourceTagMutex);
-    // legacy tag-retrieval implementation
-    CommonResource& resTmp = idToResourceMap[uid];
     uint64_t uCurFrame = getCurrentFrame();
-    if (resTmp.uFrameWhenTagged != ~0ull && uCurFrame > resTmp.uFrameWhenTagged + 1)
+    for (uint32_t k = 0; k < count; k++)
     {
-        if (resTmp)
+        auto tagType = tagTypes[k];
+        if (local & (1ull << k))
         {
-            SL_LOG_WARN("Tags are valid only until Present(). Invalidating the hanging tag %d for viewport %d (created at frame: %d, current frame: %d)", tagType, viewportId, resTmp.uFrameWhenTagged, uCurFrame);
-            if (resTmp.clone)
-            {
-                ctx.pool->recycle(resTmp.clone);
-            }
-            else
+            //! Keep track of what tags are requested for what viewport (unique insert)
+            //! 
+            //! Note that the presence of a valid pointer to 'inputs' 
+            //! indicates that we are called during the evaluate feature call.
+            requiredTags.insert({ viewportId, tagType, ResourceLifecycle::eValidUntilEvaluate });
+            continue;
+        }
+
+        //! Now let's check the global ones
+        uint64_t uid = ((uint64_t)tagType << 32) | (uint64_t)viewportId;
+        // legacy tag-retrieval implementation
+        CommonResource& resTmp = idToResourceMap[uid];
+        if (resTmp.uFrameWhenTagged != ~0ull && uCurFrame > resTmp.uFrameWhenTagged + resTmp.uFramesValid)
+        {
+            if (resTmp)
             {
-                ctx.compute->stopTrackingResource(uid, &resTmp.res);
+                SL_LOG_WARN("Tags are valid only until Present() or for the number of frames promised by the host. Invalidating the hanging tag %d for viewport %d (created at frame: %d, current frame: %d)", tagType, viewportId, resTmp.uFrameWhenTagged, uCurFrame);
+                if (resTmp.clone)
+                {
+                    ctx.pool->recycle(resTmp.clone);
+                }
+                else
+                {
+                    ctx.compute->stopTrackingResource(uid, &resTmp.res);
+                }
             }
+            resTmp = CommonResource();
         }
-        resTmp = CommonResource();
-    }
-    res = resTmp;
+        res[k] = resTmp;
 
-    //! Keep track of what tags are requested for what viewport (unique insert)
-    //! 
-    //! Note that the presence of a valid pointer to 'inputs' indicates that we are called
-    //! during the evaluate feature call, otherwise tag was requested from a hook (present etc.)
-    requiredTags.insert({ viewportId, tagType, inputs ? ResourceLifecycle::eValidUntilEvaluate : ResourceLifecycle::eValidUntilPresent });
+        //! Keep track of what tags are requested for what viewport (unique insert)
+        //! 
+        //! Note that the presence of a valid pointer to 'inputs' indicates that we are called
+        //! during the evaluate feature call, otherwise tag was requested from a hook (present etc.)
+        requiredTags.insert({ viewportId, tagType, inputs ? ResourceLifecycle::eValidUntilEvaluate : ResourceLifecycle::eValidUntilPresent });
+    }
 }
 
 common::ResourceTaggingGeneral::~ResourceTaggingGeneral()
@@ -408,6 +589,76 @@ common::ResourceTaggingGeneral::~ResourceTaggingGeneral()
     idToResourceMap.clear();
 }
 
+//! Records all volatile tag copies collected while tagging with one barrier for all sources and clones
+//!
+//! Reverse transitions go through the open transition batch so they are flushed together as well
+sl::Result recordTagCopies(chi::CommandList cmdList, const ResourceTaggingBase::TagCopyBatch& batch)
+{
+    auto& ctx = (*common::getContext());
+
+    std::vector<chi::ResourceTransition> transitions;
+    for (size_t i = 0; i < batch.copies.size(); i++)
+    {
+        auto& copy = batch.copies[i];
+        // Same resource tagged more than once only needs to be transitioned once
+        bool seen = false;
+        for (size_t k = 0; k < i && !seen; k++)
+        {
+            seen = batch.copies[k].source.native == copy.source.native;
+        }
+        if (!seen)
+        {
+            transitions.push_back({ (chi::Resource)&copy.source, chi::ResourceState::eCopySource, copy.sourceState });
+        }
+        transitions.push_back({ copy.clone, chi::ResourceState::eCopyDestination, copy.cloneState });
+    }
+
+    chi::ScopedProfilingSection section(ctx.compute, cmdList, "sl.tag.copies");
+    extra::ScopedTasks revTransitions;
+    CHI_CHECK_RR(ctx.compute->transitionResources(cmdList, transitions.data(), (uint32_t)transitions.size(), &revTransitions));
+    for (auto& copy : batch.copies)
+    {
+        if (copy.depthOnly)
+        {
+            CHI_CHECK_RR(ctx.compute->copyDepthToColor(cmdList, copy.clone, (chi::Resource)&copy.source));
+        }
+        else
+        {
+            CHI_CHECK_RR(ctx.compute->copyResourceRegion(cmdList, copy.clone, (chi::Resource)&copy.source, copy.region));
+        }
+    }
+    return sl::Result::eOk;
+}
+
+//! Vulkan images are opaque so the host has to describe them, with image tracking whatever it left out comes from
+//! the creation parameters the interposer recorded. Looked up only here, when an image is actually tagged.
+const sl::Resource* completeImageTag(const sl::Resource* resource, sl::Resource& completed)
+{
+    auto& ctx = (*common::getContext());
+    if (!ctx.imageTable || !resource || !resource->native || resource->type != ResourceType::eTex2d ||
+        (resource->width && resource->height && resource->nativeFormat && resource->mipLevels && resource->arrayLayers))
+    {
+        return resource;
+    }
+    extra::ImageInfo info{};
+    if (!ctx.imageTable->find((uint64_t)resource->native, info))
+    {
+        return resource;
+    }
+    completed = *resource;
+    if (!completed.width) completed.width = info.width;
+    if (!completed.height) completed.height = info.height;
+    if (!completed.nativeFormat) completed.nativeFormat = info.format;
+    if (!completed.mipLevels) completed.mipLevels = info.mipLevels;
+    if (!completed.arrayLayers) completed.arrayLayers = info.arrayLayers;
+    if (!completed.usage)
+    {
+        completed.usage = info.usage;
+        completed.flags = info.flags;
+    }
+    return &completed;
+}
+
 sl::Result setTagCommon(const sl::ViewportHandle& viewport, const sl::ResourceTag* resources, uint32_t numResources, sl::CommandBuffer* cmdBuffer, const sl::FrameToken& frame)
 {
     auto& ctx = (*common::getContext());
@@ -419,20 +670,63 @@ sl::Result setTagCommon(const sl::ViewportHandle& viewport, const sl::ResourceTa
         return Result::eErrorNotInitialized;
     }
 
-    for (uint32_t i = 0; i < numResources; i++)
+    auto& stats = getFrameworkStats();
+    common::ScopedFrameworkTimer timer(stats, stats.setTagNs, &stats.setTagCalls);
+    extra::ScopedPerfTimer perfTimer(ctx.perfStats, extra::PerfCounter::eSetTagNs, extra::PerfCounter::eSetTagCalls);
+
+    // Volatile copies are collected while tagging and recorded together afterwards
+    //
+    // NOTE: Declared ahead of the transition batch, reverse transitions flushed when the batch ends point at these sources
+    ResourceTaggingBase::TagCopyBatch copyBatch;
+
+    // Each tag copy transitions its source around the copy, batching lets all of them go back together
+    // and removes the round trip completely when the same resource is tagged more than once
+    extra::ScopedTasks transitionBatch;
+    auto cmdList = cmdBuffer ? common::getNativeCommandBuffer(cmdBuffer) : nullptr;
+    if (cmdList && ctx.compute)
+    {
+        CHI_VALIDATE(ctx.compute->beginTransitionBatch(cmdList));
+        transitionBatch.tasks.push_back([&ctx, cmdList]()->void { CHI_VALIDATE(ctx.compute->endTransitionBatch(cmdList)); });
+        ResourceTaggingBase::getTagCopyBatch() = &copyBatch;
+    }
+
+    sl::Result result = sl::Result::eOk;
+    for (uint32_t i = 0; i < numResources && result == sl::Result::eOk; i++)
     {
         auto tag = &resources[i];
         while (tag != nullptr)
         {
-            // Find the optional extension PrecisionInfo, until we see a ResourceTag (or nullptr) in the linked list
+            // Find the optional extensions, until we see a ResourceTag (or nullptr) in the linked list
             PrecisionInfo* optPi = findStruct<PrecisionInfo, ResourceTag>(tag->next);
-            SL_CHECK(ctx.pBaseResourceTagging->setTag(tag->resource, tag->type, viewport, &tag->extent, tag->lifecycle, cmdBuffer, false, optPi, frame));
+            ResourceLifetimeInfo* optLifetime = findStruct<ResourceLifetimeInfo, ResourceTag>(tag->next);
+            sl::Resource completed{};
+            auto resource = completeImageTag(tag->resource, completed);
+#ifndef SL_PRODUCTION
+            ctx.tagValidator.validate(ctx.compute, resource, tag->type, viewport, tag->extent, (uint32_t)getCurrentFrame());
+#endif
+            result = ctx.pBaseResourceTagging->setTag(resource, tag->type, viewport, &tag->extent, tag->lifecycle, cmdBuffer, false, optPi, optLifetime, frame);
+            if (result != sl::Result::eOk)
+            {
+                break;
+            }
 
             tag = findStruct<ResourceTag>(tag->next);
         }
     }
 
-    return sl::Result::eOk;
+    ResourceTaggingBase::getTagCopyBatch() = nullptr;
+
+    // Clones already stored in the tags must be filled even if a later tag failed
+    if (!copyBatch.copies.empty())
+    {
+        auto copyResult = recordTagCopies(cmdList, copyBatch);
+        if (result == sl::Result::eOk)
+        {
+            result = copyResult;
+        }
+    }
+
+    return result;
 }
 
 sl::Result slSetTag(const sl::ViewportHandle& viewport, const sl::ResourceTag* resources, uint32_t numResources, sl::CommandBuffer* cmdBuffer)
@@ -503,33 +797,168 @@ void validateCommonConstants(const Constants& consts)
     // minRelativeLinearDepthObjectSeparation does not need to be validated. It's entirely optional.
 }
 
+//! Computes 'DerivedCameraData' for the incoming constants, done once per frame and viewport
+//! so plugins don't have to. Previous frame matrices come from 'history' which is updated here.
+void calcDerivedCameraData(common::DerivedCameraData& derived, const Constants& consts, common::CameraHistory& history, uint32_t frame)
+{
+    if (history.frame != frame)
+    {
+        // First set for this frame, what we had so far becomes the previous frame
+        history.hasPrevious = history.frame != UINT_MAX;
+        history.prevCameraViewToWorld = history.cameraViewToWorld;
+        history.prevCameraViewToClip = history.cameraViewToClip;
+        history.frame = frame;
+    }
+
+    const float4x4 identity = {
+        float4(1, 0, 0, 0),
+        float4(0, 1, 0, 0),
+        float4(0, 0, 1, 0),
+        float4(0, 0, 0, 1),
+    };
+    auto isValid3 = [](const float3& v)->bool { return v.x != INVALID_FLOAT && v.y != INVALID_FLOAT && v.z != INVALID_FLOAT; };
+
+    // Same camera basis as 'recalculateCameraMatrices' but without touching the host values
+    derived.cameraViewToWorld = identity;
+    if (isValid3(consts.cameraRight) && isValid3(consts.cameraFwd) && isValid3(consts.cameraPos))
+    {
+        float3 right = consts.cameraRight;
+        float3 fwd = consts.cameraFwd;
+        float3 up;
+        vectorNormalize(right);
+        vectorNormalize(fwd);
+        vectorCrossProduct(up, fwd, right);
+        vectorNormalize(up);
+        derived.cameraViewToWorld = {
+            float4(right.x, right.y, right.z, 0.f),
+            float4(up.x, up.y, up.z, 0.f),
+            float4(fwd.x, fwd.y, fwd.z, 0.f),
+            float4(consts.cameraPos.x, consts.cameraPos.y, consts.cameraPos.z, 1.f)
+        };
+    }
+    matrixOrthoNormalInvert(derived.worldToCameraView, derived.cameraViewToWorld);
+
+    const float4x4& cameraViewToClip = consts.cameraViewToClip[0].x != INVALID_FLOAT ? consts.cameraViewToClip : identity;
+    if (consts.clipToCameraView[0].x != INVALID_FLOAT)
+    {
+        derived.clipToCameraView = consts.clipToCameraView;
+    }
+    else
+    {
+        matrixFullInvert(derived.clipToCameraView, cameraViewToClip);
+    }
+    matrixMul(derived.clipToWorld, derived.clipToCameraView, derived.cameraViewToWorld);
+    matrixMul(derived.worldToClip, derived.worldToCameraView, cameraViewToClip);
+
+    derived.hasPreviousFrame = history.hasPrevious && consts.reset != Boolean::eTrue;
+    if (consts.clipToPrevClip[0].x != INVALID_FLOAT)
+    {
+        derived.clipToPrevClip = consts.clipToPrevClip;
+    }
+    else if (derived.hasPreviousFrame)
+    {
+        float4x4 cameraViewToPrevCameraView;
+        calcCameraToPrevCamera(cameraViewToPrevCameraView, derived.cameraViewToWorld, history.prevCameraViewToWorld);
+        float4x4 clipToPrevCameraView;
+        matrixMul(clipToPrevCameraView, derived.clipToCameraView, cameraViewToPrevCameraView);
+        matrixMul(derived.clipToPrevClip, clipToPrevCameraView, history.prevCameraViewToClip);
+    }
+    else
+    {
+        derived.clipToPrevClip = identity;
+    }
+    if (consts.prevClipToClip[0].x != INVALID_FLOAT)
+    {
+        derived.prevClipToClip = consts.prevClipToClip;
+    }
+    else
+    {
+        matrixFullInvert(derived.prevClipToClip, derived.clipToPrevClip);
+    }
+
+    history.cameraViewToWorld = derived.cameraViewToWorld;
+    history.cameraViewToClip = cameraViewToClip;
+}
+
 //! Thread safe get/set common constants
 sl::Result slSetConstants(const sl::Constants& consts, const sl::FrameToken& frame, const sl::ViewportHandle& viewport)
 {
+    auto& stats = getFrameworkStats();
+    common::ScopedFrameworkTimer timer(stats, stats.setConstantsNs, &stats.setConstantsCalls);
+    extra::ScopedPerfTimer perfTimer((*common::getContext()).perfStats, extra::PerfCounter::eSetConstantsNs, extra::PerfCounter::eSetConstantsCalls);
     SL_RUN_ONCE
     {
         validateCommonConstants(consts);
     }
+    auto& ctx = (*common::getContext());
+    common::CommonConstants entry{};
+    static_cast<Constants&>(entry) = consts;
+    {
+        std::lock_guard<std::mutex> lock(ctx.cameraHistoryMutex);
+        calcDerivedCameraData(entry.derived, consts, ctx.cameraHistory[viewport], frame);
+    }
     // Common constants are per frame, per special id (viewport, instance etc)
-    if (!(*common::getContext()).constants.set(frame, viewport, &consts))
+    if (!ctx.constants.set(frame, viewport, &entry))
     {
         return sl::Result::eErrorDuplicatedConstants;
     }
     return sl::Result::eOk;
 }
 
+common::GetDataResult getCommonConstantsAndDerived(const common::EventData& ev, Constants** consts, const common::DerivedCameraData** derived)
+{
+    common::CommonConstants* entry{};
+    auto res = (*common::getContext()).constants.get(ev, &entry);
+    *consts = entry;
+    if (derived)
+    {
+        *derived = entry ? &entry->derived : nullptr;
+    }
+    return res;
+}
+
 common::GetDataResult getCommonConstants(const common::EventData& ev, Constants** consts)
 {
-    return (*common::getContext()).constants.get(ev, consts);
+    return getCommonConstantsAndDerived(ev, consts, nullptr);
 }
 
 sl::Result slEvaluateFeature(sl::Feature feature, const sl::FrameToken& frame, const sl::BaseStructure** inputs, uint32_t numInputs, sl::CommandBuffer* cmdBuffer)
 {
 
     chi::ScopedProfilingSection ScopedSection((*common::getContext()).compute, cmdBuffer, __FUNCTION__, feature);
+    auto& stats = getFrameworkStats();
+    common::ScopedFrameworkTimer timer(stats, stats.evaluateNs, &stats.evaluateCalls);
+    extra::ScopedPerfTimer perfTimer((*common::getContext()).perfStats, extra::PerfCounter::eEvaluateNs, extra::PerfCounter::eEvaluateCalls);
     // Check if host provided tags or constants in the eval call
 
-    auto viewport = findStruct<ViewportHandle>((const void**)inputs, numInputs);
+    // Chains are walked once, lookups here and in the plugins go through the index which is passed as the first input
+    common::InputIndex index{};
+    index.build(inputs, numInputs);
+    extra::FrameVector<const sl::BaseStructure*> indexedInputs{};
+    indexedInputs.reserve(numInputs + 1);
+    indexedInputs.push_back(&index);
+    if (inputs)
+    {
+        indexedInputs.insert(indexedInputs.end(), inputs, inputs + numInputs);
+    }
+
+    auto viewport = index.find<ViewportHandle>();
+    auto batch = index.find<ViewportBatch>();
+    if (batch)
+    {
+        if (!batch->viewports || batch->numViewports == 0)
+        {
+            SL_LOG_ERROR("Viewport batch is empty");
+            return Result::eErrorInvalidParameter;
+        }
+        if (index.find<ResourceTag>())
+        {
+            // Local tags are not tied to a viewport so there is no way to tell which viewport they belong to
+            SL_LOG_ERROR("Local tags cannot be provided when evaluating a viewport batch");
+            return Result::eErrorInvalidParameter;
+        }
+        return slEvaluateFeatureInternal(feature, frame, indexedInputs.data(), (uint32_t)indexedInputs.size(), cmdBuffer);
+    }
     if (!viewport)
     {
         SL_LOG_ERROR("Missing viewport handle, did you forget to chain it up in the slEvaluateFeature inputs?");
@@ -548,8 +977,9 @@ sl::Result slEvaluateFeature(sl::Feature feature, const sl::FrameToken& frame, c
             return Result::eErrorNotInitialized;
         }
 
-        std::vector<ResourceTag*> tags{};
-        if (findStructs<ResourceTag>((const void**)inputs, numInputs, tags))
+        // Per evaluate scratch, comes from the frame arena so steady state does not touch the heap
+        extra::FrameVector<ResourceTag*> tags{};
+        if (index.findAll<ResourceTag>(tags))
         {
             for (auto& tag : tags)
             {
@@ -557,15 +987,18 @@ sl::Result slEvaluateFeature(sl::Feature feature, const sl::FrameToken& frame, c
                 {
                     // Optional extensions are chained after the tag they belong to
                     PrecisionInfo* optPi = findStruct<PrecisionInfo>(tag->next);
+                    ResourceLifetimeInfo* optLifetime = findStruct<ResourceLifetimeInfo>(tag->next);
 
                     //! Temporary tag, hence passing true
-                    SL_CHECK(ctx.pBaseResourceTagging->setTag(tag->resource, tag->type, *viewport, &tag->extent, tag->lifecycle, cmdBuffer, true, optPi, frame));
+                    sl::Resource completed{};
+                    auto resource = completeImageTag(tag->resource, completed);
+                    SL_CHECK(ctx.pBaseResourceTagging->setTag(resource, tag->type, *viewport, &tag->extent, tag->lifecycle, cmdBuffer, true, optPi, optLifetime, frame));
                 }
             }
         }
     }
 
-    return slEvaluateFeatureInternal(feature, frame, inputs, numInputs, cmdBuffer);
+    return slEvaluateFeatureInternal(feature, frame, indexedInputs.data(), (uint32_t)indexedInputs.size(), cmdBuffer);
 }
 
 namespace ngx
@@ -579,6 +1012,8 @@ namespace ngx
 //! 
 bool createNGXFeature(void* cmdList, NVSDK_NGX_Feature feature, NVSDK_NGX_Handle** handle, const char* id)
 {
+    SL_TRACE_ZONE(__FUNCTION__);
+    extra::ScopedHitchTimer hitch(__FUNCTION__);
     auto& ctx = (*common::getContext());
 
     extra::ScopedTasks vram([&ctx, id]()->void {ctx.compute->beginVRAMSegment(id); }, [&ctx]()->void {ctx.compute->endVRAMSegment(); });
@@ -600,6 +1035,7 @@ bool createNGXFeature(void* cmdList, NVSDK_NGX_Feature feature, NVSDK_NGX_Handle
 
 bool evaluateNGXFeature(void* cmdList, NVSDK_NGX_Handle* handle, const char* id)
 {
+    SL_TRACE_ZONE(__FUNCTION__);
     auto& ctx = (*common::getContext());
 
     extra::ScopedTasks vram([&ctx, id]()->void {ctx.compute->beginVRAMSegment(id); }, [&ctx]()->void {ctx.compute->endVRAMSegment(); });
@@ -621,6 +1057,7 @@ bool evaluateNGXFeature(void* cmdList, NVSDK_NGX_Handle* handle, const char* id)
 
 bool releaseNGXFeature(NVSDK_NGX_Handle* handle, const char* id)
 {
+    SL_TRACE_ZONE(__FUNCTION__);
     auto& ctx = (*common::getContext());
 
     extra::ScopedTasks vram([&ctx, id]()->void {ctx.compute->beginVRAMSegment(id); }, [&ctx]()->void {ctx.compute->endVRAMSegment(); });
@@ -860,6 +1297,8 @@ bool getNGXFeatureRequirements(NVSDK_NGX_Feature feature, common::PluginInfo& pl
 //! Special case when running d3d11 on d3d12, we have an additional context which is d3d12 exclusive
 bool createNGXFeatureD3D12(void* cmdList, NVSDK_NGX_Feature feature, NVSDK_NGX_Handle** handle, const char* id)
 {
+    SL_TRACE_ZONE(__FUNCTION__);
+    extra::ScopedHitchTimer hitch(__FUNCTION__);
     auto& ctx = (*common::getContext());
     extra::ScopedTasks vram([&ctx, id]()->void {ctx.computeD3D12->beginVRAMSegment(id); }, [&ctx]()->void {ctx.computeD3D12->endVRAMSegment(); });
     CHECK_NGX_RETURN_ON_ERROR(NVSDK_NGX_D3D12_CreateFeature((ID3D12GraphicsCommandList*)cmdList, feature, ctx.ngxContextD3D12.params, handle));
@@ -868,6 +1307,7 @@ bool createNGXFeatureD3D12(void* cmdList, NVSDK_NGX_Feature feature, NVSDK_NGX_H
 
 bool evaluateNGXFeatureD3D12(void* cmdList, NVSDK_NGX_Handle* handle, const char* id)
 {
+    SL_TRACE_ZONE(__FUNCTION__);
     auto& ctx = (*common::getContext());
     extra::ScopedTasks vram([&ctx, id]()->void {ctx.computeD3D12->beginVRAMSegment(id); }, [&ctx]()->void {ctx.computeD3D12->endVRAMSegment(); });
     CHECK_NGX_RETURN_ON_ERROR(NVSDK_NGX_D3D12_EvaluateFeature((ID3D12GraphicsCommandList*)cmdList, handle, ctx.ngxContextD3D12.params, nullptr));
@@ -876,6 +1316,7 @@ bool evaluateNGXFeatureD3D12(void* cmdList, NVSDK_NGX_Handle* handle, const char
 
 bool releaseNGXFeatureD3D12(NVSDK_NGX_Handle* handle, const char* id)
 {
+    SL_TRACE_ZONE(__FUNCTION__);
     auto& ctx = (*common::getContext());
     extra::ScopedTasks vram([&ctx, id]()->void {ctx.computeD3D12->beginVRAMSegment(id); }, [&ctx]()->void {ctx.computeD3D12->endVRAMSegment(); });
     CHECK_NGX_RETURN_ON_ERROR(NVSDK_NGX_D3D12_ReleaseFeature(handle));
@@ -1009,12 +1450,230 @@ void releaseNGXResourceCallback(IUnknown* resource)
     }
 }
 
+NVSDK_NGX_Parameter* allocateNGXParameters()
+{
+    auto& ctx = (*common::getContext());
+
+    NVSDK_NGX_Parameter* params{};
+    NVSDK_NGX_Result res{};
+    if (ctx.platform == RenderAPI::eD3D11)
+    {
+        res = NVSDK_NGX_D3D11_AllocateParameters(&params);
+    }
+    else if (ctx.platform == RenderAPI::eD3D12)
+    {
+        res = NVSDK_NGX_D3D12_AllocateParameters(&params);
+    }
+    else
+    {
+        res = NVSDK_NGX_VULKAN_AllocateParameters(&params);
+    }
+    if (NVSDK_NGX_FAILED(res))
+    {
+        SL_LOG_ERROR("Failed to allocate NGX parameters");
+        return nullptr;
+    }
+    // Same memory management as the shared parameters
+    if (ctx.platform == RenderAPI::eD3D12)
+    {
+        params->Set(NVSDK_NGX_Parameter_ResourceAllocCallback, allocateNGXResourceCallback);
+        params->Set(NVSDK_NGX_Parameter_ResourceReleaseCallback, releaseNGXResourceCallback);
+    }
+    else if (ctx.platform == RenderAPI::eD3D11)
+    {
+        params->Set(NVSDK_NGX_Parameter_BufferAllocCallback, allocateNGXBufferCallback);
+        params->Set(NVSDK_NGX_Parameter_Tex2DAllocCallback, allocateNGXTex2dCallback);
+        params->Set(NVSDK_NGX_Parameter_ResourceReleaseCallback, releaseNGXResourceCallback);
+    }
+    // NGX does not provide VK memory hooking
+    return params;
+}
+
+void destroyNGXParameters(NVSDK_NGX_Parameter* params)
+{
+    auto& ctx = (*common::getContext());
+
+    if (!params)
+    {
+        return;
+    }
+    if (ctx.platform == RenderAPI::eD3D11)
+    {
+        NVSDK_NGX_D3D11_DestroyParameters(params);
+    }
+    else if (ctx.platform == RenderAPI::eD3D12)
+    {
+        NVSDK_NGX_D3D12_DestroyParameters(params);
+    }
+    else
+    {
+        NVSDK_NGX_VULKAN_DestroyParameters(params);
+    }
+}
+
+bool createNGXFeatureWithParameters(void* cmdList, NVSDK_NGX_Feature feature, NVSDK_NGX_Parameter* params, NVSDK_NGX_Handle** handle, const char* id)
+{
+    SL_TRACE_ZONE(__FUNCTION__);
+    extra::ScopedHitchTimer hitch(__FUNCTION__);
+    auto& ctx = (*common::getContext());
+
+    extra::ScopedTasks vram([&ctx, id]()->void {ctx.compute->beginVRAMSegment(id); }, [&ctx]()->void {ctx.compute->endVRAMSegment(); });
+
+    CHECK_NGX_RETURN_ON_ERROR(NVSDK_NGX_D3D12_CreateFeature((ID3D12GraphicsCommandList*)cmdList, feature, params, handle));
+    return true;
+}
+
+common::NGXParameterCache* createNGXParameterCache()
+{
+    auto& ctx = (*common::getContext());
+
+    auto cache = new common::NGXParameterCache();
+    cache->params = allocateNGXParameters();
+    cache->owned = cache->params != nullptr;
+    if (!cache->owned)
+    {
+        SL_LOG_WARN("Using shared NGX parameters for evaluation, all values will be set on each evaluate");
+        cache->params = ctx.ngxContext.params;
+    }
+    return cache;
+}
+
+void destroyNGXParameterCache(common::NGXParameterCache* cache)
+{
+    if (cache)
+    {
+        if (cache->owned)
+        {
+            destroyNGXParameters(cache->params);
+        }
+        delete cache;
+    }
+}
+
+void setNGXParameter(NVSDK_NGX_Parameter* params, const char* name, common::NGXParameterType type, uint64_t value)
+{
+    switch (type)
+    {
+        case common::NGXParameterType::eUInt64:
+            params->Set(name, (unsigned long long)value);
+            break;
+        case common::NGXParameterType::eFloat:
+        {
+            float f;
+            uint32_t bits = (uint32_t)value;
+            memcpy(&f, &bits, sizeof(f));
+            params->Set(name, f);
+            break;
+        }
+        case common::NGXParameterType::eDouble:
+        {
+            double d;
+            memcpy(&d, &value, sizeof(d));
+            params->Set(name, d);
+            break;
+        }
+        case common::NGXParameterType::eUInt:
+            params->Set(name, (unsigned int)value);
+            break;
+        case common::NGXParameterType::eInt:
+            params->Set(name, (int)(uint32_t)value);
+            break;
+        case common::NGXParameterType::ePointer:
+            params->Set(name, (void*)value);
+            break;
+    }
+}
+
+void setCachedNGXParameter(common::NGXParameterCache* cache, const char* name, common::NGXParameterType type, uint64_t value)
+{
+    auto& ctx = (*common::getContext());
+
+    if (!cache || !cache->owned)
+    {
+        // Shared parameters are written by everyone, nothing to compare with
+        setNGXParameter(cache ? cache->params : ctx.ngxContext.params, name, type, value);
+        return;
+    }
+
+    uint32_t slot{};
+    auto it = cache->slots.find(name);
+    if (it == cache->slots.end())
+    {
+        auto named = cache->names.try_emplace(name, (uint32_t)cache->values.size());
+        if (named.second)
+        {
+            cache->values.push_back({});
+        }
+        slot = named.first->second;
+        cache->slots[name] = slot;
+    }
+    else
+    {
+        slot = (*it).second;
+    }
+
+    auto& last = cache->values[slot];
+    if (last.valid && last.type == type && last.bits == value)
+    {
+        return;
+    }
+    last = { type, value, true };
+    setNGXParameter(cache->params, name, type, value);
+}
+
+bool evaluateNGXFeatureWithCache(void* cmdList, NVSDK_NGX_Handle* handle, common::NGXParameterCache* cache, const char* id)
+{
+    SL_TRACE_ZONE(__FUNCTION__);
+    auto& ctx = (*common::getContext());
+
+    extra::ScopedTasks vram([&ctx, id]()->void {ctx.compute->beginVRAMSegment(id); }, [&ctx]()->void {ctx.compute->endVRAMSegment(); });
+
+    auto params = cache ? cache->params : ctx.ngxContext.params;
+    if (ctx.platform == RenderAPI::eD3D11)
+    {
+        CHECK_NGX_RETURN_ON_ERROR(NVSDK_NGX_D3D11_EvaluateFeature((ID3D11DeviceContext*)cmdList, handle, params, nullptr));
+    }
+    else if (ctx.platform == RenderAPI::eD3D12)
+    {
+        CHECK_NGX_RETURN_ON_ERROR(NVSDK_NGX_D3D12_EvaluateFeature((ID3D12GraphicsCommandList*)cmdList, handle, params, nullptr));
+    }
+    else
+    {
+        CHECK_NGX_RETURN_ON_ERROR(NVSDK_NGX_VULKAN_EvaluateFeature((VkCommandBuffer)cmdList, handle, params, nullptr));
+    }
+    return true;
+}
+
+//! Highest NVSDK_NGX_Logging_Level forwarded per NGX feature, last slot covers NGX core and SDK messages
+//!
+//! Set once before NGX is initialized, see 'logLevelNGXComponents' in 'sl.common.json'
+std::atomic<uint32_t> s_logLevels[NVSDK_NGX_Feature_Count + 1]{};
+
+inline uint32_t getLogComponent(NVSDK_NGX_Feature feature)
+{
+    return (uint32_t)feature < NVSDK_NGX_Feature_Count ? (uint32_t)feature : NVSDK_NGX_Feature_Count;
+}
+
 void ngxLog(const char* message, NVSDK_NGX_Logging_Level loggingLevel, NVSDK_NGX_Feature sourceComponent)
 {
+    // Filter before anything is copied or queued, SL log level can change at runtime so it is checked here too
+    auto level = (uint32_t)loggingLevel;
+    if (!message || level > s_logLevels[getLogComponent(sourceComponent)].load(std::memory_order_relaxed) ||
+        level > (uint32_t)log::getInterface()->getLogLevel())
+    {
+        return;
+    }
+    // NGX messages are newline terminated which 'logva' takes as preformatted, copied as is without vsnprintf
+    auto length = strlen(message);
+    bool preformatted = length && message[length - 1] == '\n';
     switch (loggingLevel)
     {
-        case NVSDK_NGX_LOGGING_LEVEL_ON: SL_LOG_INFO(message); break;
-        case NVSDK_NGX_LOGGING_LEVEL_VERBOSE: SL_LOG_VERBOSE(message); break;
+        case NVSDK_NGX_LOGGING_LEVEL_ON:
+            if (preformatted) { SL_LOG_INFO(message); } else { SL_LOG_INFO("%s", message); }
+            break;
+        case NVSDK_NGX_LOGGING_LEVEL_VERBOSE:
+            if (preformatted) { SL_LOG_VERBOSE(message); } else { SL_LOG_VERBOSE("%s", message); }
+            break;
     }
 };
 
@@ -1176,8 +1835,17 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
 
     //! We handle all common functionality - common constants, tagging, evaluate and provide various helpers
     parameters->set(param::global::kPFunGetConsts, getCommonConstants);
+    parameters->set(param::global::kPFunGetConstsAndDerived, getCommonConstantsAndDerived);
     parameters->set(param::global::kPFunGetTag, getCommonTag);
+    parameters->set(param::global::kPFunGetTags, getCommonTags);
+    parameters->set(param::common::kPFunSetTagClonePolicy, setCommonTagClonePolicy);
     parameters->set(param::common::kPFunRegisterEvaluateCallbacks, common::registerEvaluateCallbacks);
+    parameters->set(param::common::kPFunSetEvaluateReentrant, common::setEvaluateReentrant);
+    parameters->set(param::common::kPFunRegisterResizeCallbacks, common::registerResizeCallbacks);
+    parameters->set(param::common::kPFunAcquireScratch, common::acquireScratch);
+    parameters->set(param::common::kPFunBeginScratchPass, common::beginScratchPass);
+    parameters->set(param::common::kPFunReleaseScratch, common::releaseScratch);
+    parameters->set(param::common::kFrameworkStats, &getFrameworkStats());
 
     //! Plugin manager gives us the device type and the application id
     json& config = *(json*)api::getContext()->loaderConfig;
@@ -1205,6 +1873,41 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
         extraConfig.at("logLevelNGX").get_to(logLevelNGX);
         SL_LOG_HINT("Overriding NGX logging level to %u'", logLevelNGX);
     }
+    // Anything above the SL log level would be formatted by NGX only to be dropped by us
+    auto logLevelSL = log::getInterface()->getLogLevel();
+    for (auto& level : ngx::s_logLevels)
+    {
+        level.store((uint32_t)std::min(logLevelNGX, logLevelSL));
+    }
+    //! Optional per component override, keys are NVSDK_NGX_Feature values or "core", for example { "11": 2, "core": 0 }
+    if (extraConfig.contains("logLevelNGXComponents"))
+    {
+        for (auto& [key, value] : extraConfig.at("logLevelNGXComponents").items())
+        {
+            uint32_t component = key == "core" ? NVSDK_NGX_Feature_Count : ngx::getLogComponent((NVSDK_NGX_Feature)std::strtoul(key.c_str(), nullptr, 10));
+            auto level = std::min(value.get<LogLevel>(), logLevelSL);
+            ngx::s_logLevels[component].store((uint32_t)level);
+            SL_LOG_HINT("Overriding NGX logging level for component '%s' to %u", key.c_str(), level);
+        }
+    }
+    // NGX only needs to produce messages some component still wants
+    logLevelNGX = LogLevel::eOff;
+    for (auto& level : ngx::s_logLevels)
+    {
+        logLevelNGX = std::max(logLevelNGX, (LogLevel)level.load());
+    }
+#ifndef SL_PRODUCTION
+    // Default binding, can be overridden below like any other key
+    extra::keyboard::getInterface()->registerKey("gpu_markers", extra::keyboard::VirtKey('M', true, true));
+    //! Optional tag validation mode, 0 - off, 1 - when a tag changes (default), 2 - every tag on every call
+    if (extraConfig.contains("tagValidation"))
+    {
+        uint32_t mode{};
+        extraConfig.at("tagValidation").get_to(mode);
+        ctx.tagValidator.setMode((TagValidationMode)std::min(mode, (uint32_t)TagValidationMode::eAlways));
+        SL_LOG_HINT("Overriding tag validation mode to %u", mode);
+    }
+#endif
     //! Optional hot-key bindings
     if (extraConfig.contains("keys"))
     {
@@ -1223,9 +1926,19 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
         }
     }
 
+    param::getPointerParam(parameters, param::global::kPerfStats, &ctx.perfStats);
+    param::getPointerParam(parameters, param::global::kVkImageTable, &ctx.imageTable);
+
+    // Optional, only present when startup profiling is enabled
+    extra::IStartupTimeline* timeline{};
+    param::getPointerParam(parameters, param::global::kStartupTimeline, &timeline);
+
     // Now let's create our compute interface
     ctx.platform = (RenderAPI)deviceType;
+    std::optional<extra::ScopedStartupPhase> computePhase;
+    computePhase.emplace(timeline, "createCompute");
     auto [compute, computeD3D12] = common::createCompute(device, ctx.platform, ctx.needDX11On12);
+    computePhase.reset();
     if (!compute)
     {
         return false;
@@ -1258,6 +1971,7 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
     {
         // NGX initialization
         SL_LOG_INFO("At least one plugin requires NGX, trying to initialize ...");
+        SL_STARTUP_PHASE(timeline, "ngxInit");
 
         // Reset our flag until we see if NGX can be initialized correctly
         ctx.needNGX = false;
@@ -1423,6 +2137,16 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
             ctx.ngxContext.releaseFeature = ngx::releaseNGXFeature;
             ctx.ngxContext.evaluateFeature = ngx::evaluateNGXFeature;
             ctx.ngxContext.updateFeature = ngx::updateNGXFeature;
+            ctx.ngxContext.allocateParameters = ngx::allocateNGXParameters;
+            ctx.ngxContext.destroyParameters = ngx::destroyNGXParameters;
+            if (deviceType == RenderAPI::eD3D12)
+            {
+                ctx.ngxContext.createFeatureWithParameters = ngx::createNGXFeatureWithParameters;
+            }
+            ctx.ngxContext.createParameterCache = ngx::createNGXParameterCache;
+            ctx.ngxContext.destroyParameterCache = ngx::destroyNGXParameterCache;
+            ctx.ngxContext.setCachedParameter = ngx::setCachedNGXParameter;
+            ctx.ngxContext.evaluateFeatureWithCache = ngx::evaluateNGXFeatureWithCache;
             parameters->set(param::global::kNGXContext, &ctx.ngxContext);
 
             // Special context for plugins running d3d11 on d3d12
@@ -1502,8 +2226,17 @@ void slOnPluginShutdown()
 
     // Remove all provided common interfaces
     parameters->set(param::global::kPFunGetConsts, nullptr);
+    parameters->set(param::global::kPFunGetConstsAndDerived, nullptr);
     parameters->set(param::global::kPFunGetTag, nullptr);
+    parameters->set(param::global::kPFunGetTags, nullptr);
+    parameters->set(param::common::kPFunSetTagClonePolicy, nullptr);
     parameters->set(param::common::kPFunRegisterEvaluateCallbacks, nullptr);
+    parameters->set(param::common::kPFunSetEvaluateReentrant, nullptr);
+    parameters->set(param::common::kPFunRegisterResizeCallbacks, nullptr);
+    parameters->set(param::common::kPFunAcquireScratch, nullptr);
+    parameters->set(param::common::kPFunBeginScratchPass, nullptr);
+    parameters->set(param::common::kPFunReleaseScratch, nullptr);
+    parameters->set(param::common::kFrameworkStats, nullptr);
     parameters->set(param::common::kPFunGetStringFromModule, nullptr);
     parameters->set(param::common::kPFunUpdateCommonEmbeddedJSONConfig, nullptr);
     parameters->set(param::common::kPFunNGXGetFeatureRequirements, nullptr);
@@ -1511,6 +2244,7 @@ void slOnPluginShutdown()
     parameters->set(param::common::kPFunFindAdapter, nullptr);
     parameters->set(param::common::kKeyboardAPI, nullptr);
     parameters->set(param::common::kComputeAPI, nullptr);
+    parameters->set(param::common::kPresentQueue, nullptr);
 
     auto& ctx = (*common::getContext());
 
@@ -1525,9 +2259,12 @@ void slOnPluginShutdown()
         sl::pcl::implOnPluginShutdown(parameters);
     }
 
+    common::stopPresentWorker();
+    common::destroyScratch();
     ctx.compute->destroyResourcePool(ctx.pool);
     ctx.pool = {};
 
+    common::stopVRAMBudgetMonitor();
     for (uint32_t i = 0; i < common::kMaxNumSupportedGPUs; i++)
     {
         auto adapter = (IDXGIAdapter*)ctx.caps->adapters[i].nativeInterface;
@@ -1569,10 +2306,9 @@ void slOnPluginShutdown()
 }
 
 using PFunRtlGetVersion = NTSTATUS(WINAPI*)(PRTL_OSVERSIONINFOW);
-using PFunNtSetTimerResolution = NTSTATUS(NTAPI*)(ULONG DesiredResolution, BOOLEAN SetResolution, PULONG CurrentResolution);
 using PFunNtQueryTimerResolution = NTSTATUS(NTAPI*)(PULONG MinimumResolution, PULONG MaximumResolution, PULONG CurrentResolution);
 
-bool getOSVersionAndUpdateTimerResolution(common::SystemCaps* caps)
+bool getOSVersion(common::SystemCaps* caps)
 {
     // In Win8, the GetVersion[Ex][AW]() functions were all deprecated in favour of using
     // other more dumbed down functions such as IsWin10OrGreater(), isWinVersionOrGreater(),
@@ -1682,44 +2418,12 @@ bool getOSVersionAndUpdateTimerResolution(common::SystemCaps* caps)
         caps->osVersionBuild = vNT.build;
     }
 
+    // Timer resolution is process wide, SL waits use high resolution waitable timers instead, see 'extra::PreciseTimer'
     auto NtQueryTimerResolution = reinterpret_cast<PFunNtQueryTimerResolution>(GetProcAddress(handle, "NtQueryTimerResolution"));
-    auto NtSetTimerResolution = reinterpret_cast<PFunNtSetTimerResolution>(GetProcAddress(handle, "NtSetTimerResolution"));
-    if (NtSetTimerResolution && NtQueryTimerResolution)
+    ULONG minRes{}, maxRes{}, currentRes{};
+    if (NtQueryTimerResolution && NT_SUCCESS(NtQueryTimerResolution(&minRes, &maxRes, &currentRes)))
     {
-        // SL wants a minimum timer resolution of 0.5ms. The application may have already set a finer-grained value, this is fine, and SL should not modify the timer resolution.
-        const ULONG slPreferredTimerRes = 5000UL;
-
-        ULONG minRes = ULONG_MAX;
-        ULONG maxRes = slPreferredTimerRes;
-        ULONG setRes = slPreferredTimerRes;
-        ULONG currentRes = ULONG_MAX;
-
-        if (!NT_SUCCESS(NtQueryTimerResolution(&minRes, &maxRes, &currentRes)))
-        {
-            SL_LOG_WARN("Failed to query high resolution timer capabilities, assuming it supports at least %u [100 ns units].", slPreferredTimerRes);
-        }
-
-        if (currentRes > slPreferredTimerRes)
-        {
-            if (maxRes > slPreferredTimerRes)
-            {
-                SL_LOG_INFO("Preferred high resolution timer resolution (%u) is unsupported, trying %u [100 ns units] instead.", slPreferredTimerRes, maxRes);
-                setRes = maxRes;
-            }
-
-            if (NT_SUCCESS(NtSetTimerResolution(setRes, TRUE, &currentRes)))
-            {
-                SL_LOG_INFO("Changed high resolution timer resolution to %u [100 ns units].", currentRes);
-            }
-            else
-            {
-                SL_LOG_WARN("Failed to change high resolution timer resolution to %u [100 ns units].", setRes);
-            }
-        }
-    }
-    else
-    {
-        SL_LOG_WARN("Failed to retrieve the NtQueryTimerResolution() and NtSetTimerResolution() functions from ntdll.");
+        SL_LOG_INFO("Timer resolution %u [100 ns units], finest supported %u", currentRes, maxRes);
     }
     return res;
 }
@@ -1765,9 +2469,16 @@ void updateEmbeddedJSON(json& config)
 
     // Now we need to check OS and GPU capabilities
     // Note that this always succeeds but HW info in caps might not be complete (NVAPI not running on non-NVDA hardware etc.) 
+    //
+    // Let's get the OS info and update our timer resolution (both use ntdll.dll so combined for convenience).
+    // This is independent of the adapter discovery so it runs on a worker thread while we enumerate adapters.
+    common::SystemCaps osCaps{};
+    auto osQuery = std::async(std::launch::async, getOSVersion, &osCaps);
     getSystemCaps(ctx.caps);
-    // Let's get the OS info and update our timer resolution (both use ntdll.dll so combined for convenience)
-    getOSVersionAndUpdateTimerResolution(ctx.caps);
+    osQuery.wait();
+    ctx.caps->osVersionMajor = osCaps.osVersionMajor;
+    ctx.caps->osVersionMinor = osCaps.osVersionMinor;
+    ctx.caps->osVersionBuild = osCaps.osVersionBuild;
 
     // Allow other plugins to query system caps (this is static pointer in our context)
     api::getContext()->parameters->set(param::common::kSystemCaps, (void*)ctx.caps);
@@ -1788,6 +2499,76 @@ void updateEmbeddedJSON(json& config)
     }
 }
 
+sl::Result slGetPerfStats(sl::SLPerfStats& stats)
+{
+    auto& ctx = (*common::getContext());
+    if (!ctx.perfStats)
+    {
+        return Result::eErrorNotInitialized;
+    }
+    uint64_t values[extra::kPerfCounterCount]{};
+    ctx.perfStats->getLastFrame(values, stats.frameCount);
+    auto get = [&values](extra::PerfCounter counter)->uint64_t { return values[(uint32_t)counter]; };
+    stats.setTagCpuNs = get(extra::PerfCounter::eSetTagNs);
+    stats.setTagCalls = get(extra::PerfCounter::eSetTagCalls);
+    stats.setConstantsCpuNs = get(extra::PerfCounter::eSetConstantsNs);
+    stats.setConstantsCalls = get(extra::PerfCounter::eSetConstantsCalls);
+    stats.evaluateCpuNs = get(extra::PerfCounter::eEvaluateNs);
+    stats.evaluateCalls = get(extra::PerfCounter::eEvaluateCalls);
+    stats.hooksCpuNs = get(extra::PerfCounter::eHookNs);
+    stats.hookCalls = get(extra::PerfCounter::eHookCalls);
+    stats.gpuPassNs = get(extra::PerfCounter::eGPUPassNs);
+    stats.gpuPasses = get(extra::PerfCounter::eGPUPasses);
+    stats.volatileTagBytes = get(extra::PerfCounter::eVolatileTagBytes);
+    stats.barriers = get(extra::PerfCounter::eBarriers);
+    stats.poolAllocations = get(extra::PerfCounter::ePoolAllocations);
+    stats.poolMisses = get(extra::PerfCounter::ePoolMisses);
+    if (stats.structVersion >= kStructVersion2)
+    {
+        stats.heapAllocations = get(extra::PerfCounter::eHeapAllocations);
+    }
+    return Result::eOk;
+}
+
+sl::Result slPresentHeadless(const sl::HeadlessPresentOptions& options)
+{
+    SL_TRACE_ZONE(__FUNCTION__);
+    auto& ctx = (*common::getContext());
+    auto res = presentHeadless(options);
+    // No interposer present hook runs without a swap-chain so headless frames are closed here
+    if (res == Result::eOk && ctx.perfStats)
+    {
+        ctx.perfStats->fold();
+    }
+    return res;
+}
+
+sl::Result slGetHitches(sl::SLHitchReport& report)
+{
+    auto recorder = extra::hitch::s_recorder;
+    if (!recorder)
+    {
+        return Result::eErrorNotInitialized;
+    }
+    report.thresholdUs = recorder->getThresholdNs() / 1000;
+    report.numHitches = 0;
+    uint32_t maxRecords = report.hitches ? std::min(report.maxHitches, extra::HitchRecorder::kCapacity) : 0;
+    std::vector<extra::HitchRecord> records(maxRecords);
+    uint32_t count = recorder->getRecent(records.data(), maxRecords, report.totalHitches);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto& hitch = report.hitches[i];
+        static_assert(sizeof(hitch.site) == sizeof(records[i].site));
+        memcpy(hitch.site, records[i].site, sizeof(hitch.site));
+        hitch.frame = records[i].frame;
+        hitch.timestampUs = records[i].timestampUs;
+        hitch.durationUs = records[i].durationUs;
+        hitch.threadId = records[i].threadId;
+    }
+    report.numHitches = count;
+    return Result::eOk;
+}
+
 //! The only exported function - gateway to all functionality
 SL_EXPORT void* slGetPluginFunction(const char* functionName)
 {
@@ -1800,6 +2581,10 @@ SL_EXPORT void* slGetPluginFunction(const char* functionName)
     SL_EXPORT_FUNCTION(slSetConstants);
     SL_EXPORT_FUNCTION(slEvaluateFeature)
 
+    SL_EXPORT_FUNCTION(slGetPerfStats);
+    SL_EXPORT_FUNCTION(slGetHitches);
+    SL_EXPORT_FUNCTION(slPresentHeadless);
+
     //! Hooks defined in the JSON config above
 
     //! D3D12
@@ -1807,6 +2592,8 @@ SL_EXPORT void* slGetPluginFunction(const char* functionName)
     SL_EXPORT_FUNCTION(slHookPresent1);
     SL_EXPORT_FUNCTION(slHookAfterPresent);
     SL_EXPORT_FUNCTION(slHookResizeSwapChainPre);
+    SL_EXPORT_FUNCTION(slHookResizeSwapChainPost);
+    SL_EXPORT_FUNCTION(slHookSwapChainDestroyed);
     
     //! Vulkan
     SL_EXPORT_FUNCTION(slHookVkPresent);
@@ -34,6 +34,7 @@
 #endif
 
 #include "include/sl.h"
+#include "include/sl_headless.h"
 #include "source/core/sl.api/internal.h"
 #include "source/core/sl.log/log.h"
 #include "source/core/sl.thread/thread.h"
@@ -47,6 +48,7 @@
 #include "source/platforms/sl.chi/d3d12.h"
 #include "source/platforms/sl.chi/vulkan.h"
 #include "source/plugins/sl.common/commonInterface.h"
+#include "source/plugins/sl.common/presentQueue.h"
 #include "source/plugins/sl.imgui/imgui.h"
 
 #include "_artifacts/gitVersion.h"
@@ -59,6 +61,106 @@ namespace sl
 
 using namespace common;
 
+//! Keeps a snapshot of the local segment budget and usage up to date on a background thread
+//!
+//! The OS signals budget changes through an event. Usage changes (including our own allocations)
+//! are not signaled so the snapshot is also refreshed with a short timeout. Present only reads the
+//! snapshot instead of calling 'QueryVideoMemoryInfo' every frame.
+struct VRAMBudgetMonitor
+{
+    static constexpr DWORD kRefreshIntervalMs = 100;
+
+    bool start(IDXGIAdapter3* adapter)
+    {
+        m_adapter = adapter;
+        m_quit = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        m_budgetChanged = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        if (!m_quit || !m_budgetChanged)
+        {
+            SL_LOG_WARN("Failed to create VRAM budget events, querying budget on present");
+            stop();
+            return false;
+        }
+        if (FAILED(m_adapter->RegisterVideoMemoryBudgetChangeNotificationEvent(m_budgetChanged, &m_cookie)))
+        {
+            // Still fine, we just rely on the periodic refresh
+            SL_LOG_WARN("Failed to register for VRAM budget notifications");
+            m_cookie = 0;
+        }
+        update();
+        m_thread = std::thread([this]()->void
+        {
+            HANDLE events[] = { m_quit, m_budgetChanged };
+            while (WaitForMultipleObjects((DWORD)countof(events), events, FALSE, kRefreshIntervalMs) != WAIT_OBJECT_0)
+            {
+                update();
+            }
+        });
+        SetThreadDescription(m_thread.native_handle(), L"sl.common.vram");
+        thread::setThreadPlacement(m_thread.native_handle(), thread::ThreadPlacement::eEfficiency);
+        return true;
+    }
+
+    void stop()
+    {
+        if (m_thread.joinable())
+        {
+            SetEvent(m_quit);
+            m_thread.join();
+        }
+        if (m_cookie)
+        {
+            m_adapter->UnregisterVideoMemoryBudgetChangeNotification(m_cookie);
+            m_cookie = 0;
+        }
+        if (m_quit) CloseHandle(m_quit);
+        if (m_budgetChanged) CloseHandle(m_budgetChanged);
+        m_quit = m_budgetChanged = {};
+        m_adapter = {};
+        m_sequence.store(0);
+    }
+
+    //! Returns false if nothing was published yet
+    bool get(uint64_t& currentUsage, uint64_t& budget) const
+    {
+        uint32_t seq;
+        do
+        {
+            seq = m_sequence.load(std::memory_order_acquire);
+            currentUsage = m_currentUsage.load(std::memory_order_relaxed);
+            budget = m_budget.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((seq & 1) || seq != m_sequence.load(std::memory_order_relaxed));
+        return seq != 0;
+    }
+
+private:
+    void update()
+    {
+        DXGI_QUERY_VIDEO_MEMORY_INFO videoMemoryInfo{};
+        if (FAILED(m_adapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &videoMemoryInfo)))
+        {
+            return;
+        }
+        // Single writer, odd sequence means an update is in progress
+        auto seq = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_currentUsage.store(videoMemoryInfo.CurrentUsage, std::memory_order_relaxed);
+        m_budget.store(videoMemoryInfo.Budget, std::memory_order_relaxed);
+        m_sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    IDXGIAdapter3* m_adapter{};
+    HANDLE m_quit{};
+    HANDLE m_budgetChanged{};
+    DWORD m_cookie{};
+    std::thread m_thread;
+    std::atomic<uint32_t> m_sequence{};
+    std::atomic<uint64_t> m_currentUsage{};
+    std::atomic<uint64_t> m_budget{};
+};
+
 struct CommonInterfaceContext
 {
     RenderAPI platform{};
@@ -71,6 +173,13 @@ struct CommonInterfaceContext
     uint64_t currentFrame{};
 
     IDXGIAdapter3* adapter{};
+    VRAMBudgetMonitor vramMonitor{};
+    bool vramMonitorRunning = false;
+
+    //! Runs garbage collection and logging scheduled by 'presentCommon' off the present thread, null on D3D11
+    std::unique_ptr<thread::WorkerThread> presentWorker{};
+    //! Idle until a frame generation plugin starts it, see 'IPresentQueue'
+    PresentQueue presentQueue{};
 
     sl::PreferenceFlags flags{};
     bool interposerEnabled = true;
@@ -82,11 +191,30 @@ struct CommonInterfaceContext
     thread::ThreadContext<chi::VulkanThreadContext>* threadsVulkan{};
 
     std::map<Feature, EvaluateCallbacks> evalCallbacks;
+    //! Serializes evaluates of features which are not reentrant, entries are never removed so references stay valid
+    std::map<Feature, std::mutex> evalMutex;
+    std::map<Feature, ResizeCallbacks> resizeCallbacks;
+
+    //! Scratch requests of one plugin, see 'ScratchRequest'
+    struct ScratchSet
+    {
+        std::vector<ScratchRequest> requests;
+        std::vector<std::string> names;
+        std::vector<chi::Resource> resources;
+        uint32_t passCount{};
+    };
+    std::mutex scratchMtx;
+    std::map<Feature, ScratchSet> scratch;
 
     NvPhysicalGpuHandle nvGPUHandle[NVAPI_MAX_PHYSICAL_GPUS]{};
     NvU32 nvGPUCount = 0;
 
     common::SystemCaps sysCaps{};
+    common::FrameworkStats frameworkStats{};
+
+    //! Created on the first 'slPresentHeadless', recreated when the host changes its size
+    chi::SwapChain nullSwapChain{};
+    chi::NullSwapChainDesc nullSwapChainDesc{};
 
     chi::CommonThreadContext& getThreadContext()
     {
@@ -127,28 +255,77 @@ uint64_t getCurrentFrame()
     return ctx.currentFrame;
 }
 
-//! Get GPU information and share with other plugins
-//! 
-bool getSystemCaps(common::SystemCaps*& info)
+common::FrameworkStats& getFrameworkStats()
 {
-#if defined(SL_WINDOWS)
-    ctx.sysCaps = {};
-    info = &ctx.sysCaps;
+    return ctx.frameworkStats;
+}
 
-    SYSTEM_POWER_STATUS powerStatus{};
-    if (GetSystemPowerStatus(&powerStatus))
+//! Adapter details which are expensive to discover (KMT and NVAPI queries) and cannot change while the process is alive
+//!
+//! sl.common is unloaded on slShutdown so the cache is allocated from the process heap and
+//! published through the parameter store which outlives all plugins. Subsequent slInit calls
+//! in the same process only re-enumerate DXGI adapters and reuse everything else if the
+//! adapter list did not change.
+struct SystemCapsCache
+{
+    common::SystemCaps caps{};
+};
+
+SystemCapsCache* getSystemCapsCache()
+{
+    SystemCapsCache* cache{};
+    api::getContext()->parameters->get(param::common::kSystemCapsCache, (void**)&cache);
+    return cache;
+}
+
+void updateSystemCapsCache(const common::SystemCaps& caps)
+{
+    auto cache = getSystemCapsCache();
+    if (!cache)
     {
-        // https://learn.microsoft.com/en-us/windows/win32/api/winbase/ns-winbase-system_power_status
-        ctx.sysCaps.laptopDevice = powerStatus.BatteryFlag != 128; // No system battery according to MS docs
+        // Intentionally never freed, lives as long as the process (the parameter store does the same)
+        auto memory = HeapAlloc(GetProcessHeap(), HEAP_ZERO_MEMORY, sizeof(SystemCapsCache));
+        if (!memory) return;
+        cache = new (memory) SystemCapsCache{};
+        api::getContext()->parameters->set(param::common::kSystemCapsCache, (void*)cache);
     }
+    cache->caps = caps;
+    for (uint32_t i = 0; i < kMaxNumSupportedGPUs; i++)
+    {
+        // Native interfaces are released on shutdown, never cache them
+        cache->caps.adapters[i].nativeInterface = {};
+    }
+    for (auto& load : cache->caps.gpuLoad)
+    {
+        load = 0;
+    }
+}
+
+//! Cached caps can only be reused if DXGI reports exactly the same adapters as last time
+bool isSystemCapsCacheValid(const SystemCapsCache* cache, const common::SystemCaps& caps)
+{
+    if (!cache || cache->caps.gpuCount != caps.gpuCount) return false;
+    for (uint32_t i = 0; i < caps.gpuCount; i++)
+    {
+        auto& a = cache->caps.adapters[i];
+        auto& b = caps.adapters[i];
+        if (a.id.HighPart != b.id.HighPart || a.id.LowPart != b.id.LowPart || a.deviceId != b.deviceId || a.vendor != b.vendor)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//! Check if hardware scheduling is enabled on any of our adapters via KMT
+bool isHWSEnabled(const common::SystemCaps& caps)
+{
+    bool hwsSupported = false;
 
     PFND3DKMT_ENUMADAPTERS2 pfnEnumAdapters2{};
     PFND3DKMT_QUERYADAPTERINFO pfnQueryAdapterInfo{};
     PFND3DKMT_CLOSEADAPTER pfnCloseAdapter{};
 
-    // We support up to kMaxNumSupportedGPUs adapters (currently 8)
-    SL_LOG_INFO("Enumerating up to %u adapters but only one of them can be used to create a device - no mGPU support in this SDK", kMaxNumSupportedGPUs);
-
     D3DKMT_ADAPTERINFO adapterInfo[kMaxNumSupportedGPUs]{};
     D3DKMT_ENUMADAPTERS2 enumAdapters2{};
 
@@ -182,6 +359,78 @@ bool getSystemCaps(common::SystemCaps*& info)
         }
     }
 
+    // Check HWS for each LUID in the DXGI enumeration order
+    for (uint32_t i = 0; i < caps.gpuCount && !hwsSupported && enumAdapters2.NumAdapters > 0 && pfnQueryAdapterInfo; i++)
+    {
+        auto& luid = caps.adapters[i].id;
+        for (uint32_t k = 0; k < enumAdapters2.NumAdapters; k++)
+        {
+            if (adapterInfo[k].AdapterLuid.HighPart == luid.HighPart &&
+                adapterInfo[k].AdapterLuid.LowPart == luid.LowPart)
+            {
+                D3DKMT_QUERYADAPTERINFO info{};
+                info.hAdapter = adapterInfo[k].hAdapter;
+                info.Type = KMTQAITYPE_WDDM_2_7_CAPS;
+                D3DKMT_WDDM_2_7_CAPS data{};
+                info.pPrivateDriverData = &data;
+                info.PrivateDriverDataSize = sizeof(data);
+                NTSTATUS err = pfnQueryAdapterInfo(&info);
+                if (NT_SUCCESS(err) && data.HwSchEnabled)
+                {
+                    hwsSupported = true;
+                }
+                break;
+            }
+        }
+    }
+
+    if (pfnCloseAdapter)
+    {
+        for (uint32_t k = 0; k < enumAdapters2.NumAdapters; k++)
+        {
+            const D3DKMT_CLOSEADAPTER adapter { adapterInfo[k].hAdapter };
+            auto res = pfnCloseAdapter(&adapter);
+            if (!NT_SUCCESS(res))
+            {
+                SL_LOG_WARN("Failed to close adapter 0x%x: %u", adapter.hAdapter, res);
+            }
+        }
+        enumAdapters2 = {};
+    }
+
+    if (modGDI32)
+    {
+        FreeLibrary(modGDI32);
+    }
+    return hwsSupported;
+}
+
+//! Get GPU information and share with other plugins
+//! 
+bool getSystemCaps(common::SystemCaps*& info)
+{
+#if defined(SL_WINDOWS)
+    ctx.sysCaps = {};
+    info = &ctx.sysCaps;
+
+    // No display or battery on headless servers, report fixed values there so runs are reproducible
+    sl::PreferenceFlags flags = (*(json*)api::getContext()->loaderConfig)["preferences"]["flags"];
+    bool headless = flags & PreferenceFlags::eHeadless;
+    if (headless)
+    {
+        SL_LOG_INFO("Headless mode - software adapters are enumerated, HWS and laptop detection are skipped");
+    }
+
+    SYSTEM_POWER_STATUS powerStatus{};
+    if (!headless && GetSystemPowerStatus(&powerStatus))
+    {
+        // https://learn.microsoft.com/en-us/windows/win32/api/winbase/ns-winbase-system_power_status
+        ctx.sysCaps.laptopDevice = powerStatus.BatteryFlag != 128; // No system battery according to MS docs
+    }
+
+    // We support up to kMaxNumSupportedGPUs adapters (currently 8)
+    SL_LOG_INFO("Enumerating up to %u adapters but only one of them can be used to create a device - no mGPU support in this SDK", kMaxNumSupportedGPUs);
+
     ctx.nvGPUCount = 0;
 
 #ifndef SL_PRODUCTION
@@ -209,7 +458,7 @@ bool getSystemCaps(common::SystemCaps*& info)
                 }
 #endif
 
-                if (isVendorNvidia(vendor) || vendor == chi::VendorId::eIntel || vendor == chi::VendorId::eAMD)
+                if (isVendorNvidia(vendor) || vendor == chi::VendorId::eIntel || vendor == chi::VendorId::eAMD || (headless && vendor == chi::VendorId::eMS))
                 {
                     info->adapters[info->gpuCount].nativeInterface = adapter;
                     info->adapters[info->gpuCount].vendor = vendor;
@@ -224,29 +473,6 @@ bool getSystemCaps(common::SystemCaps*& info)
                     {
                         ctx.nvGPUCount++;
                     }
-                    // Check HWS for this LUID if NVDA adapter
-                    if (!ctx.sysCaps.hwsSupported && enumAdapters2.NumAdapters > 0 && pfnQueryAdapterInfo)
-                    {
-                        for (uint32_t k = 0; k < enumAdapters2.NumAdapters; k++)
-                        {
-                            if (adapterInfo[k].AdapterLuid.HighPart == desc.AdapterLuid.HighPart &&
-                                adapterInfo[k].AdapterLuid.LowPart == desc.AdapterLuid.LowPart)
-                            {
-                                D3DKMT_QUERYADAPTERINFO info{};
-                                info.hAdapter = adapterInfo[k].hAdapter;
-                                info.Type = KMTQAITYPE_WDDM_2_7_CAPS;
-                                D3DKMT_WDDM_2_7_CAPS data{};
-                                info.pPrivateDriverData = &data;
-                                info.PrivateDriverDataSize = sizeof(data);
-                                NTSTATUS err = pfnQueryAdapterInfo(&info);
-                                if (NT_SUCCESS(err) && data.HwSchEnabled)
-                                {
-                                    ctx.sysCaps.hwsSupported = true;
-                                }
-                                break;
-                            }
-                        }
-                    }
 
                     // Adapter released on shutdown
                 }
@@ -260,50 +486,83 @@ bool getSystemCaps(common::SystemCaps*& info)
         factory->Release();
     }
 
+    // Same adapters as the last time we were initialized in this process, skip KMT and per GPU NVAPI queries
+    auto cache = getSystemCapsCache();
+    bool useCache = isSystemCapsCacheValid(cache, ctx.sysCaps);
+
+    if (headless)
+    {
+        ctx.sysCaps.hwsSupported = false;
+    }
+    else if (useCache)
+    {
+        ctx.sysCaps.hwsSupported = cache->caps.hwsSupported;
+    }
+    else
+    {
+        ctx.sysCaps.hwsSupported = isHWSEnabled(ctx.sysCaps);
+    }
+
     if (ctx.nvGPUCount > 0)
     {
         // Detected at least one NVDA GPU, we can use NVAPI
         if (NvAPI_EnumPhysicalGPUs(ctx.nvGPUHandle, &ctx.nvGPUCount) == NVAPI_OK)
         {
             ctx.nvGPUCount = std::min((NvU32)kMaxNumSupportedGPUs, ctx.nvGPUCount);
-            NvU32 driverVersion;
-            NvAPI_ShortString driverName;
-            NVAPI_VALIDATE_RF(NvAPI_SYS_GetDriverAndBranchVersion(&driverVersion, driverName));
-            SL_LOG_INFO(">-----------------------------------------");
-            ctx.sysCaps.driverVersionMajor = driverVersion / 100;
-            ctx.sysCaps.driverVersionMinor = driverVersion % 100;
-            SL_LOG_INFO("NVIDIA driver %u.%u", ctx.sysCaps.driverVersionMajor, ctx.sysCaps.driverVersionMinor);
-            for (NvU32 gpu = 0; gpu < ctx.nvGPUCount; ++gpu)
+            if (useCache)
             {
-                // Find LUID for NVDA physical device
-                LUID id;
-                NvLogicalGpuHandle hLogicalGPU;
-                NVAPI_VALIDATE_RF(NvAPI_GetLogicalGPUFromPhysicalGPU(ctx.nvGPUHandle[gpu], &hLogicalGPU));
-                NV_LOGICAL_GPU_DATA lData{};
-                lData.version = NV_LOGICAL_GPU_DATA_VER;
-                lData.pOSAdapterId = &id;
-                NVAPI_VALIDATE_RF(NvAPI_GPU_GetLogicalGpuInfo(hLogicalGPU, &lData));
-                
-                // Now find adapter by matching the LUID
+                ctx.sysCaps.driverVersionMajor = cache->caps.driverVersionMajor;
+                ctx.sysCaps.driverVersionMinor = cache->caps.driverVersionMinor;
                 for (uint32_t i = 0; i < ctx.sysCaps.gpuCount; i++)
                 {
-                    if (ctx.sysCaps.adapters[i].id.HighPart == id.HighPart && ctx.sysCaps.adapters[i].id.LowPart == id.LowPart)
+                    auto& adapter = ctx.sysCaps.adapters[i];
+                    adapter.architecture = cache->caps.adapters[i].architecture;
+                    adapter.implementation = cache->caps.adapters[i].implementation;
+                    adapter.revision = cache->caps.adapters[i].revision;
+                }
+                SL_LOG_INFO("NVIDIA driver %u.%u - reusing adapter information from the previous initialization", ctx.sysCaps.driverVersionMajor, ctx.sysCaps.driverVersionMinor);
+            }
+            else
+            {
+                NvU32 driverVersion;
+                NvAPI_ShortString driverName;
+                NVAPI_VALIDATE_RF(NvAPI_SYS_GetDriverAndBranchVersion(&driverVersion, driverName));
+                SL_LOG_INFO(">-----------------------------------------");
+                ctx.sysCaps.driverVersionMajor = driverVersion / 100;
+                ctx.sysCaps.driverVersionMinor = driverVersion % 100;
+                SL_LOG_INFO("NVIDIA driver %u.%u", ctx.sysCaps.driverVersionMajor, ctx.sysCaps.driverVersionMinor);
+                for (NvU32 gpu = 0; gpu < ctx.nvGPUCount; ++gpu)
+                {
+                    // Find LUID for NVDA physical device
+                    LUID id;
+                    NvLogicalGpuHandle hLogicalGPU;
+                    NVAPI_VALIDATE_RF(NvAPI_GetLogicalGPUFromPhysicalGPU(ctx.nvGPUHandle[gpu], &hLogicalGPU));
+                    NV_LOGICAL_GPU_DATA lData{};
+                    lData.version = NV_LOGICAL_GPU_DATA_VER;
+                    lData.pOSAdapterId = &id;
+                    NVAPI_VALIDATE_RF(NvAPI_GPU_GetLogicalGpuInfo(hLogicalGPU, &lData));
+                    
+                    // Now find adapter by matching the LUID
+                    for (uint32_t i = 0; i < ctx.sysCaps.gpuCount; i++)
                     {
-                        auto& adapter = ctx.sysCaps.adapters[i];
-
-                        NV_GPU_ARCH_INFO archInfo;
-                        archInfo.version = NV_GPU_ARCH_INFO_VER;
-                        NVAPI_VALIDATE_RF(NvAPI_GPU_GetArchInfo(ctx.nvGPUHandle[gpu], &archInfo));
-                        adapter.architecture = archInfo.architecture;
-                        adapter.implementation = archInfo.implementation;
-                        adapter.revision = archInfo.revision;
-                        SL_LOG_INFO("Adapter %u architecture 0x%x implementation 0x%x revision 0x%x - bit 0x%0x - LUID %u.%u", gpu, adapter.architecture, adapter.implementation, adapter.revision, adapter.bit, adapter.id.HighPart, adapter.id.LowPart);
-                        break;
+                        if (ctx.sysCaps.adapters[i].id.HighPart == id.HighPart && ctx.sysCaps.adapters[i].id.LowPart == id.LowPart)
+                        {
+                            auto& adapter = ctx.sysCaps.adapters[i];
+
+                            NV_GPU_ARCH_INFO archInfo;
+                            archInfo.version = NV_GPU_ARCH_INFO_VER;
+                            NVAPI_VALIDATE_RF(NvAPI_GPU_GetArchInfo(ctx.nvGPUHandle[gpu], &archInfo));
+                            adapter.architecture = archInfo.architecture;
+                            adapter.implementation = archInfo.implementation;
+                            adapter.revision = archInfo.revision;
+                            SL_LOG_INFO("Adapter %u architecture 0x%x implementation 0x%x revision 0x%x - bit 0x%0x - LUID %u.%u", gpu, adapter.architecture, adapter.implementation, adapter.revision, adapter.bit, adapter.id.HighPart, adapter.id.LowPart);
+                            break;
+                        }
                     }
-                }
 
-            };
-            SL_LOG_INFO("-----------------------------------------<");
+                };
+                SL_LOG_INFO("-----------------------------------------<");
+            }
         }
         else
         {
@@ -311,23 +570,9 @@ bool getSystemCaps(common::SystemCaps*& info)
         }
     }
 
-    if (pfnCloseAdapter)
-    {
-        for (uint32_t k = 0; k < enumAdapters2.NumAdapters; k++)
-        {
-            const D3DKMT_CLOSEADAPTER adapter { adapterInfo[k].hAdapter };
-            auto res = pfnCloseAdapter(&adapter);
-            if (!NT_SUCCESS(res))
-            {
-                SL_LOG_WARN("Failed to close adapter 0x%x: %u", adapter.hAdapter, res);
-            }
-        }
-        enumAdapters2 = {};
-    }
-
-    if (modGDI32)
+    if (!useCache)
     {
-        FreeLibrary(modGDI32);
+        updateSystemCapsCache(ctx.sysCaps);
     }
 #endif
     return true;
@@ -376,6 +621,8 @@ std::pair<sl::chi::ICompute*, sl::chi::ICompute*> createCompute(void* device, Re
     CHI_VALIDATE(ctx.compute->init(device, api::getContext()->parameters));
 
     api::getContext()->parameters->set(sl::param::common::kComputeAPI, ctx.compute);
+    ctx.presentQueue.setCompute(ctx.compute);
+    api::getContext()->parameters->set(sl::param::common::kPresentQueue, (IPresentQueue*)&ctx.presentQueue);
 
     if (ctx.computeDX11On12)
     {
@@ -393,6 +640,36 @@ std::pair<sl::chi::ICompute*, sl::chi::ICompute*> createCompute(void* device, Re
     return { ctx.compute, ctx.computeDX11On12 };
 }
 
+void stopVRAMBudgetMonitor()
+{
+    if (ctx.vramMonitorRunning)
+    {
+        ctx.vramMonitorRunning = false;
+        ctx.vramMonitor.stop();
+    }
+}
+
+void stopPresentWorker()
+{
+    // Queued frames still reference resources of the plugin which queued them
+    ctx.presentQueue.stop();
+    if (ctx.presentWorker)
+    {
+        ctx.presentWorker->flush();
+        ctx.presentWorker.reset();
+    }
+}
+
+//! Work which does not have to finish before the host's present, runs inline if there is no worker
+template<typename F>
+void runAfterPresent(const F& func)
+{
+    if (!ctx.presentWorker || !ctx.presentWorker->scheduleWork(func))
+    {
+        func();
+    }
+}
+
 //! Destroy compute API when sl.common is released
 bool destroyCompute()
 {
@@ -401,6 +678,11 @@ bool destroyCompute()
         CHI_CHECK_RF(ctx.computeDX11On12->shutdown());
     }
 
+    if (ctx.nullSwapChain)
+    {
+        CHI_VALIDATE(ctx.compute->destroyNullSwapChain(ctx.nullSwapChain));
+        ctx.nullSwapChain = {};
+    }
     CHI_CHECK_RF(ctx.compute->shutdown());
     if (ctx.threadsD3D11)
     {
@@ -426,7 +708,167 @@ bool destroyCompute()
 //! 
 void registerEvaluateCallbacks(Feature feature, PFunBeginEndEvent* beginEvaluate, PFunBeginEndEvent* endEvaluate)
 {
-    ctx.evalCallbacks[feature] = { beginEvaluate, endEvaluate };
+    // Registered at plugin startup and shutdown, never while evaluating
+    auto& callbacks = ctx.evalCallbacks[feature];
+    callbacks.beginEvaluate = beginEvaluate;
+    callbacks.endEvaluate = endEvaluate;
+    ctx.evalMutex[feature];
+}
+
+void setEvaluateReentrant(Feature feature, bool reentrant)
+{
+    ctx.evalCallbacks[feature].reentrant = reentrant;
+    ctx.evalMutex[feature];
+}
+
+//! Common register callbacks from other plugins
+//! 
+//! Used to rebuild back buffer sized resources of all plugins at once when the swap-chain is resized.
+//! 
+void registerResizeCallbacks(Feature feature, PFunResizeRelease* release, PFunResizeDescribe* describe, PFunResizeCommit* commit)
+{
+    if (release || describe || commit)
+    {
+        ctx.resizeCallbacks[feature] = { release, describe, commit };
+    }
+    else
+    {
+        ctx.resizeCallbacks.erase(feature);
+    }
+}
+
+//! Common scratch service for other plugins
+//!
+//! Resources of all plugins are created together so 'ICompute::createAliasedResources' can share memory between them.
+//!
+static bool isSameScratch(const ScratchRequest& a, const ScratchRequest& b)
+{
+    return a.type == b.type && a.firstPass == b.firstPass && a.lastPass == b.lastPass && a.desc.width == b.desc.width &&
+        a.desc.height == b.desc.height && a.desc.format == b.desc.format && a.desc.nativeFormat == b.desc.nativeFormat &&
+        a.desc.mips == b.desc.mips && a.desc.heapType == b.desc.heapType && a.desc.state == b.desc.state && a.desc.flags == b.desc.flags;
+}
+
+static void destroyScratchResources(CommonInterfaceContext::ScratchSet& set)
+{
+    for (auto& res : set.resources)
+    {
+        // Deferred, the last evaluate which used it may still be in flight
+        if (res) CHI_VALIDATE(ctx.compute->destroyResource(res));
+    }
+    set.resources.clear();
+}
+
+//! Recreates scratch resources of all plugins, plugins get consecutive pass ranges in feature order
+static bool rebuildScratch()
+{
+    std::vector<chi::ResourceBatchEntry> entries;
+    uint32_t firstPass = 0;
+    for (auto& [feature, set] : ctx.scratch)
+    {
+        destroyScratchResources(set);
+        for (size_t i = 0; i < set.requests.size(); i++)
+        {
+            auto& request = set.requests[i];
+            chi::ResourceBatchEntry entry{ request.type, request.desc, set.names[i].c_str() };
+            entry.firstUse = firstPass + request.firstPass;
+            entry.lastUse = firstPass + request.lastPass;
+            entries.push_back(entry);
+        }
+        firstPass += set.passCount;
+    }
+    if (entries.empty()) return true;
+
+    SL_LOG_INFO("Creating %llu scratch resource(s) over %u pass(es)", (uint64_t)entries.size(), firstPass);
+    if (ctx.compute->createAliasedResources(entries.data(), (uint32_t)entries.size()) != chi::ComputeStatus::eOk)
+    {
+        SL_LOG_ERROR("Failed to create scratch resources");
+        return false;
+    }
+    size_t index = 0;
+    for (auto& [feature, set] : ctx.scratch)
+    {
+        for (size_t i = 0; i < set.requests.size(); i++)
+        {
+            set.resources.push_back(entries[index++].resource);
+        }
+    }
+    return true;
+}
+
+bool acquireScratch(Feature feature, const ScratchRequest* requests, uint32_t count, chi::Resource* resources)
+{
+    if (!requests || !resources || !count) return false;
+    std::fill(resources, resources + count, nullptr);
+
+    std::scoped_lock lock(ctx.scratchMtx);
+    auto& set = ctx.scratch[feature];
+    bool same = set.requests.size() == count && set.resources.size() == count;
+    for (uint32_t i = 0; i < count && same; i++)
+    {
+        same = isSameScratch(set.requests[i], requests[i]);
+    }
+    if (!same)
+    {
+        set.requests.assign(requests, requests + count);
+        set.names.clear();
+        set.passCount = 0;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            auto& request = set.requests[i];
+            if (request.firstPass > request.lastPass)
+            {
+                SL_LOG_ERROR("Scratch resource '%s' of feature %u ends before it starts", request.name, feature);
+                request.lastPass = request.firstPass;
+            }
+            set.names.push_back(request.name ? request.name : "");
+            set.passCount = std::max(set.passCount, request.lastPass + 1);
+        }
+        if (!rebuildScratch())
+        {
+            return false;
+        }
+    }
+    std::copy(set.resources.begin(), set.resources.end(), resources);
+    return true;
+}
+
+void beginScratchPass(Feature feature, chi::CommandList cmdList, uint32_t pass)
+{
+    std::vector<chi::Resource> first;
+    {
+        std::scoped_lock lock(ctx.scratchMtx);
+        auto it = ctx.scratch.find(feature);
+        if (it == ctx.scratch.end()) return;
+        auto& set = it->second;
+        for (size_t i = 0; i < set.resources.size(); i++)
+        {
+            if (set.requests[i].firstPass == pass && set.resources[i]) first.push_back(set.resources[i]);
+        }
+    }
+    if (!first.empty())
+    {
+        CHI_VALIDATE(ctx.compute->insertGPUBarrierList(cmdList, first.data(), (uint32_t)first.size(), chi::eBarrierTypeAliasing));
+    }
+}
+
+void releaseScratch(Feature feature)
+{
+    std::scoped_lock lock(ctx.scratchMtx);
+    auto it = ctx.scratch.find(feature);
+    if (it == ctx.scratch.end()) return;
+    // Memory of the remaining plugins stays put, it is compacted the next time their requests change
+    destroyScratchResources(it->second);
+    ctx.scratch.erase(it);
+}
+
+void destroyScratch()
+{
+    std::scoped_lock lock(ctx.scratchMtx);
+    for (auto& [feature, set] : ctx.scratch)
+    {
+        destroyScratchResources(set);
+    }
+    ctx.scratch.clear();
 }
 
 //! Checks if proxies are used and returns correct command buffer to use
@@ -497,7 +939,9 @@ bool onLoad(const void* managerConfigPtr, const void* extraConfigPtr, chi::IReso
 //! callbacks for the requested feature (sl plugin)
 sl::Result slEvaluateFeatureInternal(sl::Feature feature, const sl::FrameToken& frame, const sl::BaseStructure** inputs, uint32_t numInputs, sl::CommandBuffer* cmdBuffer)
 {
-    auto evalCallbacks = ctx.evalCallbacks[feature];
+    // Map is only modified at plugin startup and shutdown, no insertion here so parallel evaluates are safe
+    auto it = ctx.evalCallbacks.find(feature);
+    auto evalCallbacks = it != ctx.evalCallbacks.end() ? (*it).second : EvaluateCallbacks{};
     if (!evalCallbacks.beginEvaluate || !evalCallbacks.endEvaluate)
     {
         SL_LOG_ERROR_ONCE( "Could not find 'evaluateFeature' callbacks for feature %u", feature);
@@ -505,25 +949,47 @@ sl::Result slEvaluateFeatureInternal(sl::Feature feature, const sl::FrameToken&
     }
 
     uint32_t id = 0;
-    auto viewport = findStruct<ViewportHandle>((const void**)inputs, numInputs);
+    auto viewport = common::findInput<ViewportHandle>(inputs, numInputs);
     if (viewport)
     {
         id = *viewport;
     }
 
+    // Batched viewports share the state push/pop, pipeline restore and budget check below
+    const ViewportHandle* viewports = nullptr;
+    uint32_t numViewports = 1;
+    if (auto batch = common::findInput<ViewportBatch>(inputs, numInputs))
+    {
+        viewports = batch->viewports;
+        numViewports = batch->numViewports;
+    }
+
     bool slProxy = false;
     auto cmdList = getNativeCommandBuffer(cmdBuffer, &slProxy);
 
-    // This allows us to map correct constants and tags to this evaluate call
-    common::EventData event = { id, frame };
-
     // Push the state (d3d11 only, nop otherwise)
     CHI_CHECK_RR(ctx.compute->pushState(cmdList));
 
-    auto res = evalCallbacks.beginEvaluate(cmdList, event, inputs, numInputs);
-    if (res == sl::Result::eOk)
+    // Plugins which keep global state between their begin and end callbacks are evaluated one at a time
+    std::unique_lock<std::mutex> evalLock;
+    if (!evalCallbacks.reentrant)
     {
-        res = evalCallbacks.endEvaluate(cmdList, event, inputs, numInputs);
+        evalLock = std::unique_lock<std::mutex>((*ctx.evalMutex.find(feature)).second);
+    }
+
+    auto res = sl::Result::eOk;
+    for (uint32_t i = 0; i < numViewports && res == sl::Result::eOk; i++)
+    {
+        // This allows us to map correct constants and tags to this evaluate call
+        common::EventData event = { viewports ? (uint32_t)viewports[i] : id, frame };
+
+        chi::ScopedProfilingSection section(ctx.compute, cmdList, "evaluate", feature, event.id);
+        common::ScopedFrameworkTimer timer(ctx.frameworkStats, ctx.frameworkStats.pluginNs);
+        res = evalCallbacks.beginEvaluate(cmdList, event, inputs, numInputs);
+        if (res == sl::Result::eOk)
+        {
+            res = evalCallbacks.endEvaluate(cmdList, event, inputs, numInputs);
+        }
     }
 
     // Pop the state (d3d11 only, nop otherwise)
@@ -533,6 +999,8 @@ sl::Result slEvaluateFeatureInternal(sl::Feature feature, const sl::FrameToken&
     if (slProxy && (ctx.flags & PreferenceFlags::eUseManualHooking) == 0 && ctx.interposerEnabled)
     {
         // Restore the pipeline so host can continue running like we never existed
+        common::ScopedFrameworkTimer timer(ctx.frameworkStats, ctx.frameworkStats.restorePipelineNs);
+        chi::ScopedProfilingSection section(ctx.compute, cmdList, "sl.common.restorePipeline");
         CHI_CHECK_RR(ctx.compute->restorePipeline(cmdList));
     }
 
@@ -566,6 +1034,20 @@ void presentCommon(UINT Flags)
         return;
     }
 
+#ifndef SL_PRODUCTION
+    if (extra::keyboard::getInterface()->wasKeyPressed("gpu_markers"))
+    {
+        // Shared by all SL modules, every plugin starts or stops emitting markers with the next pass
+        std::atomic<bool>* gpuMarkers{};
+        if (param::getPointerParam(api::getContext()->parameters, param::global::kGPUMarkers, &gpuMarkers) && gpuMarkers)
+        {
+            bool enabled = !gpuMarkers->load();
+            gpuMarkers->store(enabled);
+            SL_LOG_INFO("GPU markers %s", enabled ? "enabled" : "disabled");
+        }
+    }
+#endif
+
     if (ctx.compute)
     {
         if (ctx.manageVRAMBudget)
@@ -576,15 +1058,21 @@ void presentCommon(UINT Flags)
             }
             else if (ctx.adapter)
             {
-                //! IMPORTANT: Overhead for calling 'QueryVideoMemoryInfo' is 0.01ms 
+                //! IMPORTANT: Overhead for calling 'QueryVideoMemoryInfo' is 0.01ms so it is only done here if the monitor is not running
                 DXGI_QUERY_VIDEO_MEMORY_INFO videoMemoryInfo{};
-                ctx.adapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &videoMemoryInfo);
+                if (!ctx.vramMonitorRunning || !ctx.vramMonitor.get(videoMemoryInfo.CurrentUsage, videoMemoryInfo.Budget))
+                {
+                    ctx.adapter->QueryVideoMemoryInfo(0, DXGI_MEMORY_SEGMENT_GROUP_LOCAL, &videoMemoryInfo);
+                }
                 ctx.compute->setVRAMBudget(videoMemoryInfo.CurrentUsage, videoMemoryInfo.Budget);
                 // to reduce the LOG spam - print only when the new maximum is reached
                 if (videoMemoryInfo.CurrentUsage > ctx.m_maxMemoryUsage)
                 {
                     ctx.m_maxMemoryUsage = videoMemoryInfo.CurrentUsage;
-                    SL_LOG_VERBOSE("Total VRAM used: %.2lf GB", ctx.m_maxMemoryUsage / (double)(1024 * 1024 * 1024));
+                    runAfterPresent([maxMemoryUsage = ctx.m_maxMemoryUsage]()->void
+                    {
+                        SL_LOG_VERBOSE("Total VRAM used: %.2lf GB", maxMemoryUsage / (double)(1024 * 1024 * 1024));
+                    });
                 }
             }
         }
@@ -607,6 +1095,17 @@ void presentCommon(UINT Flags)
                 }
             }
 
+            if (ctx.adapter && ctx.manageVRAMBudget && !ctx.emulateLowVRAMScenario)
+            {
+                ctx.vramMonitorRunning = ctx.vramMonitor.start(ctx.adapter);
+            }
+
+            // D3D11 devices can be created single threaded so releasing resources has to stay on the present thread
+            if (ctx.platform != RenderAPI::eD3D11)
+            {
+                ctx.presentWorker = std::make_unique<thread::WorkerThread>(L"sl.common.present", THREAD_PRIORITY_BELOW_NORMAL, thread::ThreadPlacement::eEfficiency);
+            }
+
 #ifndef SL_PRODUCTION
             // Check for UI and register our callback
             imgui::ImGUI* ui{};
@@ -700,10 +1199,16 @@ void presentCommon(UINT Flags)
 
         ++ctx.currentFrame;
 
-        // This will release any resources scheduled to be destroyed few frames behind
-        CHI_VALIDATE(ctx.compute->collectGarbage((uint32_t)ctx.currentFrame));
-        // This will release unused recycled resources (volatile tag copies)
-        ctx.pool->collectGarbage();
+        // Anything scheduled for destruction from now on must be tagged with the new frame so publish it right away
+        auto frame = (uint32_t)ctx.currentFrame;
+        CHI_VALIDATE(ctx.compute->setFinishedFrame(frame));
+        runAfterPresent([frame]()->void
+        {
+            // This will release any resources scheduled to be destroyed few frames behind
+            CHI_VALIDATE(ctx.compute->collectGarbage(frame));
+            // This will release unused recycled resources (volatile tag copies)
+            ctx.pool->collectGarbage();
+        });
     }
 
     // Our stats including GPU load info
@@ -752,12 +1257,136 @@ HRESULT slHookAfterPresent(UINT Flags)
     return S_OK;
 }
 
+//! Headless
+
+sl::Result presentHeadless(const sl::HeadlessPresentOptions& options)
+{
+    if (!ctx.compute)
+    {
+        return Result::eErrorDeviceNotCreated;
+    }
+    if (!options.commandQueue)
+    {
+        return Result::eErrorMissingInputParameter;
+    }
+    if (!options.bufferCount)
+    {
+        return Result::eErrorInvalidParameter;
+    }
+
+    auto& desc = ctx.nullSwapChainDesc;
+    if (!ctx.nullSwapChain || desc.width != options.width || desc.height != options.height || desc.bufferCount != options.bufferCount)
+    {
+        if (ctx.nullSwapChain)
+        {
+            CHI_VALIDATE(ctx.compute->destroyNullSwapChain(ctx.nullSwapChain));
+            ctx.nullSwapChain = {};
+        }
+        desc = {};
+        desc.width = options.width;
+        desc.height = options.height;
+        desc.bufferCount = options.bufferCount;
+        auto status = ctx.compute->createNullSwapChain(desc, ctx.nullSwapChain);
+        if (status == chi::ComputeStatus::eNoImplementation)
+        {
+            SL_LOG_ERROR_ONCE("'slPresentHeadless' is not supported on this platform");
+            return Result::eErrorUnsupportedInterface;
+        }
+        CHI_CHECK_RR(status);
+    }
+    // Picked up by 'getRefreshRate' on the next call, no need to recreate buffers
+    desc.refreshRate = options.refreshRate;
+
+    presentCommon(0);
+    uint32_t bufferIndex{};
+    CHI_CHECK_RR(ctx.compute->presentNullSwapChain(ctx.nullSwapChain, options.commandQueue, bufferIndex));
+    afterPresentCommon(0);
+    return Result::eOk;
+}
+
 HRESULT slHookResizeSwapChainPre(IDXGISwapChain* swapChain, UINT BufferCount, UINT Width, UINT Height, DXGI_FORMAT NewFormat, UINT SwapChainFlags, bool& Skip)
 {
+    // Queued frames present to the current buffers and deferred destruction holds references to them,
+    // both must be done before the host resizes
+    ctx.presentQueue.flush();
+    if (ctx.presentWorker)
+    {
+        ctx.presentWorker->flush();
+    }
     CHI_VALIDATE(ctx.compute->clearCache());
+    CHI_VALIDATE(ctx.compute->releaseSwapChainBuffers(swapChain));
+
+    // Old resources go first so the new ones do not have to fit next to them
+    ResizeInfo info{ swapChain, Width, Height, BufferCount };
+    ctx.compute->getFormat(NewFormat, info.format);
+    for (auto& [feature, callbacks] : ctx.resizeCallbacks)
+    {
+        if (callbacks.release)
+        {
+            callbacks.release(info);
+        }
+    }
+    return S_OK;
+}
+
+//! Creates back buffer sized resources of all plugins in one batch, see 'PFunRegisterResizeCallbacks'
+void rebuildResizeResources(const ResizeInfo& info)
+{
+    if (ctx.resizeCallbacks.empty()) return;
+
+    struct Range
+    {
+        ResizeCallbacks* callbacks;
+        uint32_t first;
+        uint32_t count;
+    };
+    std::vector<Range> ranges;
+    std::vector<chi::ResourceBatchEntry> entries(ctx.resizeCallbacks.size() * kMaxResizeResources);
+    uint32_t total = 0;
+    for (auto& [feature, callbacks] : ctx.resizeCallbacks)
+    {
+        if (!callbacks.describe || !callbacks.commit) continue;
+        auto count = std::min(callbacks.describe(info, entries.data() + total), kMaxResizeResources);
+        ranges.push_back({ &callbacks, total, count });
+        total += count;
+    }
+    if (total)
+    {
+        SL_LOG_INFO("Creating %u resource(s) for swap-chain %ux%u", total, info.width, info.height);
+        if (ctx.compute->createResources(entries.data(), total) != chi::ComputeStatus::eOk)
+        {
+            // Plugins see null resources and fall back to creating them lazily
+            SL_LOG_WARN("Failed to create resources for the resized swap-chain");
+        }
+    }
+    for (auto& range : ranges)
+    {
+        range.callbacks->commit(info, entries.data() + range.first, range.count);
+    }
+}
+
+HRESULT slHookResizeSwapChainPost(IDXGISwapChain* swapChain, UINT BufferCount, UINT Width, UINT Height, DXGI_FORMAT NewFormat, UINT& SwapChainFlags)
+{
+    DXGI_SWAP_CHAIN_DESC desc{};
+    if (SUCCEEDED(swapChain->GetDesc(&desc)))
+    {
+        // Only the first buffer is accessible with the bitblt model
+        const bool flip = desc.SwapEffect == DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL || desc.SwapEffect == DXGI_SWAP_EFFECT_FLIP_DISCARD;
+        CHI_VALIDATE(ctx.compute->cacheSwapChainBuffers(swapChain, flip ? desc.BufferCount : 1));
+
+        ResizeInfo info{ swapChain, desc.BufferDesc.Width, desc.BufferDesc.Height, desc.BufferCount };
+        ctx.compute->getFormat(desc.BufferDesc.Format, info.format);
+        rebuildResizeResources(info);
+    }
     return S_OK;
 }
 
+void slHookSwapChainDestroyed(IDXGISwapChain* swapChain)
+{
+    ctx.presentQueue.flush();
+    CHI_VALIDATE(ctx.compute->releaseSwapChainBuffers(swapChain));
+}
+
 //! VULKAN
 
 VkResult slHookVkPresent(VkQueue Queue, const VkPresentInfoKHR* PresentInfo, bool& Skip)
@@ -25,6 +25,11 @@
 #include <map>
 #include <unordered_set>
 #include <shared_mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include <algorithm>
 
 #include "include/sl.h"
 #include "include/sl_helpers.h"
@@ -32,6 +37,7 @@
 #include "source/core/sl.param/parameters.h"
 #include "source/core/sl.plugin/plugin.h"
 #include "source/core/sl.log/log.h"
+#include "source/core/sl.extra/frameArena.h"
 #include "commonDRSInterface.h"
 
 #define NVAPI_VALIDATE_RF(f) {auto r = f; if(r != NVAPI_OK) { SL_LOG_ERROR( "%s failed error %d", #f, r); return false;} };
@@ -75,6 +81,74 @@ namespace sl
         }
     };
 
+    //! Tags requested by plugins per viewport and lifecycle
+    //!
+    //! Requirements stabilize after the first few frames so viewports, buffer types and lifecycles within
+    //! the fixed limits are kept in atomic bit masks, checking or re-registering a known requirement is a
+    //! single atomic load. Anything outside of the limits falls back to a set protected by a mutex.
+    struct RequiredTagRegistry
+    {
+        static constexpr uint32_t kMaxViewports = 16;
+        static constexpr uint32_t kMaxBufferTypes = 128;
+        static constexpr uint32_t kMaxLifecycles = 4;
+
+        //! Unique insert
+        void insert(const BufferTagInfo& info)
+        {
+            if (auto mask = getMask(info))
+            {
+                auto bit = 1ull << (info.type % 64);
+                if (!(mask->load(std::memory_order_relaxed) & bit))
+                {
+                    mask->fetch_or(bit, std::memory_order_relaxed);
+                }
+                return;
+            }
+            std::lock_guard<std::mutex> lock(m_overflowMutex);
+            m_overflow.insert(info);
+        }
+
+        bool contains(const BufferTagInfo& info) const
+        {
+            if (auto mask = const_cast<RequiredTagRegistry*>(this)->getMask(info))
+            {
+                return (mask->load(std::memory_order_relaxed) & (1ull << (info.type % 64))) != 0;
+            }
+            std::lock_guard<std::mutex> lock(m_overflowMutex);
+            return m_overflow.find(info) != m_overflow.end();
+        }
+
+        void clear()
+        {
+            for (auto& viewport : m_masks)
+            {
+                for (auto& lifecycle : viewport)
+                {
+                    for (auto& mask : lifecycle)
+                    {
+                        mask.store(0, std::memory_order_relaxed);
+                    }
+                }
+            }
+            std::lock_guard<std::mutex> lock(m_overflowMutex);
+            m_overflow.clear();
+        }
+
+    private:
+        std::atomic<uint64_t>* getMask(const BufferTagInfo& info)
+        {
+            if (info.viewportId >= kMaxViewports || info.type >= kMaxBufferTypes || (uint32_t)info.lifecycle >= kMaxLifecycles)
+            {
+                return nullptr;
+            }
+            return &m_masks[info.viewportId][(uint32_t)info.lifecycle][info.type / 64];
+        }
+
+        std::atomic<uint64_t> m_masks[kMaxViewports][kMaxLifecycles][kMaxBufferTypes / 64]{};
+        mutable std::mutex m_overflowMutex;
+        std::unordered_set<BufferTagInfo, BufferTagInfoHash> m_overflow{};
+    };
+
 namespace chi
 {
 using CommandList = void*;
@@ -83,12 +157,14 @@ class ICompute;
 
 namespace common
 {
+    struct ResourceTaggingBase;
     struct ResourceTaggingGeneral;
     struct ResourceTaggingForFrame;
 }
 
 struct CommonResource
 {
+    friend common::ResourceTaggingBase;
     friend common::ResourceTaggingGeneral;
     friend common::ResourceTaggingForFrame;
 
@@ -128,14 +204,35 @@ struct CommonResource
     inline uint32_t getState() const { return res.state; }
     inline const Extent& getExtent() const { return extent; }
     inline const PrecisionInfo& getPrecisionInfo() const { return pi; }
+    //! False if the host set exactly the same tag as in the previous frame, descriptors and NGX resource parameters
+    //! bound to it can be kept. Always true for local tags and the first time a tag is set.
+    inline bool isChanged() const { return changed; }
+
+    //! Same resource, view, state, extent, precision info and life-cycle, copies are compared by the pooled resource
+    inline bool isSameTag(const CommonResource& rhs) const
+    {
+        return getNative() == rhs.getNative() && res.view == rhs.res.view && res.state == rhs.res.state && extent == rhs.extent &&
+            pi.conversionFormula == rhs.pi.conversionFormula && pi.bias == rhs.pi.bias && pi.scale == rhs.pi.scale &&
+            lifecycle == rhs.lifecycle && uFramesValid == rhs.uFramesValid;
+    }
     
     uint64_t uFrameWhenTagged = ~0ull;
+    //! Number of frames the host guarantees the tagged resource stays intact, see ResourceLifecycle::eValidForFrames
+    uint32_t uFramesValid = 1;
 
 private:
+    //! 'rhs' is the previous tag, a change earlier in the same frame still counts until the next frame
+    inline void updateChanged(const CommonResource& rhs)
+    {
+        changed = !isSameTag(rhs) || (rhs.changed && rhs.uFrameWhenTagged == uFrameWhenTagged);
+    }
+
     sl::Resource res{};
     Extent extent{};
     PrecisionInfo pi{};
     chi::HashedResource clone{};
+    ResourceLifecycle lifecycle = ResourceLifecycle::eOnlyValidNow;
+    bool changed = true;
 };
 
 using PFunGetTag = void(BufferType tag, uint32_t frameId, uint32_t id, CommonResource& res, const sl::BaseStructure** inputs, uint32_t numInputs, bool optional);
@@ -159,6 +256,119 @@ inline Result getTaggedResource(BufferType tagType, CommonResource& res, uint32_
     return Result::eOk;
 }
 
+using PFunGetTags = void(const BufferType* tags, uint32_t count, uint32_t frameId, uint32_t id, CommonResource* res, const sl::BaseStructure** inputs, uint32_t numInputs, bool optional);
+
+//! Resolves several tags at once, one lock of the tag container and one walk of the inputs for all of them
+//!
+//! Returns eErrorMissingInputParameter if any of the tags is missing unless optional
+inline Result getTaggedResources(const BufferType* tagTypes, uint32_t count, CommonResource* res, uint32_t frameId, uint32_t viewportId, bool optional = false, const sl::BaseStructure** inputs = nullptr, uint32_t numInputs = 0)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        res[i] = {};
+    }
+
+    static PFunGetTags* getTagsThreadSafe = {};
+    if (!getTagsThreadSafe)
+    {
+        param::getPointerParam(api::getContext()->parameters, sl::param::global::kPFunGetTags, &getTagsThreadSafe);
+    }
+    // Always returns instances of common resource even if invalid (not provided by host, all values null)
+    getTagsThreadSafe(tagTypes, count, frameId, viewportId, res, inputs, numInputs, optional);
+    Result result = Result::eOk;
+    for (uint32_t i = 0; i < count && !optional; i++)
+    {
+        if (!res[i])
+        {
+            SL_LOG_ERROR("Failed to find global tag '%s', please make sure to tag all required buffers", getBufferTypeAsStr(tagTypes[i]));
+            result = Result::eErrorMissingInputParameter;
+        }
+    }
+    return result;
+}
+
+//! How the copy SL makes of a volatile tag may differ from the tagged resource
+//!
+//! Declared by the plugin consuming the tag, the policy applies to the exact viewport, buffer type and lifecycle
+//! the plugin requests the tag with. If the same tag is also required with another lifecycle the exact copy is used.
+enum class TagClonePolicy : uint32_t
+{
+    //! Same format as the tagged resource
+    eExact,
+    //! Only depth is read, stencil can be dropped (D32S8 stored as R32F where the platform can copy depth to color)
+    eDepthOnly,
+};
+
+using PFunSetTagClonePolicy = void(const BufferTagInfo& info, TagClonePolicy policy);
+
+inline void setTagClonePolicy(const BufferTagInfo& info, TagClonePolicy policy)
+{
+    static PFunSetTagClonePolicy* setPolicy = {};
+    if (!setPolicy)
+    {
+        param::getPointerParam(api::getContext()->parameters, sl::param::common::kPFunSetTagClonePolicy, &setPolicy);
+    }
+    if (setPolicy)
+    {
+        setPolicy(info, policy);
+    }
+}
+
+//! Viewport count features size their per frame storage for, 'PreferencesViewports' can raise it
+constexpr uint32_t kDefaultMaxNumViewports = 4;
+
+inline uint32_t getMaxNumViewports()
+{
+    uint32_t maxNumViewports = 0;
+    api::getContext()->parameters->get(sl::param::global::kMaxNumViewports, &maxNumViewports);
+    return maxNumViewports ? maxNumViewports : kDefaultMaxNumViewports;
+}
+
+//! Picks NGX features to release while VRAM usage is over the eviction high watermark
+//! 
+//! Plugins 'touch' a viewport on every evaluate and ask for a victim, at most once per frame. Only viewports
+//! not evaluated for 'idleFrames' are picked, least recently evaluated first, and the feature is recreated
+//! on the next evaluate.
+struct IdleFeatureEviction
+{
+    //! Frames without an evaluate before the feature of a viewport can be released
+    uint32_t idleFrames = 300;
+    //! Frames to wait after a release, NGX releases go through deferred destruction so usage drops later
+    uint32_t cooldownFrames = 4;
+
+    void touch(uint32_t id, uint32_t frame) { lastEvaluated[id] = frame; }
+    void remove(uint32_t id) { lastEvaluated.erase(id); }
+
+    bool pick(chi::ICompute* compute, uint32_t frame, uint32_t& id)
+    {
+        if (frame == lastChecked || frame < nextCheck) return false;
+        lastChecked = frame;
+
+        bool overBudget = false;
+        if (compute->isVRAMOverBudget(overBudget) != chi::ComputeStatus::eOk || !overBudget) return false;
+
+        auto lru = lastEvaluated.end();
+        for (auto it = lastEvaluated.begin(); it != lastEvaluated.end(); it++)
+        {
+            bool idle = frame > (*it).second && frame - (*it).second >= idleFrames;
+            if (idle && (lru == lastEvaluated.end() || (*it).second < (*lru).second))
+            {
+                lru = it;
+            }
+        }
+        if (lru == lastEvaluated.end()) return false;
+
+        id = (*lru).first;
+        lastEvaluated.erase(lru);
+        nextCheck = frame + cooldownFrames;
+        return true;
+    }
+
+    std::map<uint32_t, uint32_t> lastEvaluated{};
+    uint32_t lastChecked = UINT_MAX;
+    uint32_t nextCheck = 0;
+};
+
 struct CommonResource;
 struct Constants;
 using BufferType = uint32_t;
@@ -199,8 +409,61 @@ struct SystemCaps
     bool laptopDevice{};
 };
 
+//! CPU time spent in the SL framework itself, published by sl.common through 'param::common::kFrameworkStats'
+//! 
+//! Only collected while 'enabled' is set so regular runs pay a single relaxed load per call. Consumers
+//! (e.g. the sl.template benchmark) exchange the counters with zero once per report interval.
+struct FrameworkStats
+{
+    std::atomic<bool> enabled{};
+    //! 'slSetTag' and 'slSetTagForFrame', including recording of volatile tag copies
+    std::atomic<uint64_t> setTagCalls{};
+    std::atomic<uint64_t> setTagNs{};
+    //! 'slSetConstants'
+    std::atomic<uint64_t> setConstantsCalls{};
+    std::atomic<uint64_t> setConstantsNs{};
+    //! 'slEvaluateFeature' end to end, time spent in plugin callbacks and in restoring the pipeline is part of it
+    std::atomic<uint64_t> evaluateCalls{};
+    std::atomic<uint64_t> evaluateNs{};
+    std::atomic<uint64_t> pluginNs{};
+    std::atomic<uint64_t> restorePipelineNs{};
+};
+
+//! Adds the CPU time of its scope to 'counter' if stats are enabled
+struct ScopedFrameworkTimer
+{
+    ScopedFrameworkTimer(const FrameworkStats& stats, std::atomic<uint64_t>& counter, std::atomic<uint64_t>* calls = nullptr)
+    {
+        if (stats.enabled.load(std::memory_order_relaxed))
+        {
+            m_counter = &counter;
+            m_start = std::chrono::steady_clock::now();
+            if (calls)
+            {
+                calls->fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    ~ScopedFrameworkTimer()
+    {
+        if (m_counter)
+        {
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+            m_counter->fetch_add((uint64_t)ns, std::memory_order_relaxed);
+        }
+    }
+    std::atomic<uint64_t>* m_counter{};
+    std::chrono::steady_clock::time_point m_start{};
+};
+
 std::pair<sl::chi::ICompute*, sl::chi::ICompute*> createCompute(void* device, RenderAPI deviceType, bool dx11On12);
 bool destroyCompute();
+// Stops the background VRAM budget polling, must be called before adapters are released
+void stopVRAMBudgetMonitor();
+// Waits for deferred present work and stops its worker, must be called before the resource pool and compute are destroyed
+void stopPresentWorker();
+// Releases scratch resources of all plugins, must be called before compute is destroyed
+void destroyScratch();
 
 // Get info about the GPU, id can be null in which case we get info for GPU 0
 using PFunGetGPUInfo = bool(SystemCaps& info);
@@ -215,6 +478,28 @@ using PFunNGXReleaseFeature = bool(NVSDK_NGX_Handle* handle, const char* id);
 using PFunNGXBeforeReleaseFeature = void(NVSDK_NGX_Handle* handle);
 using PFunNGXUpdateFeature = void(NVSDK_NGX_Feature feature);
 using PFunNGXGetFeatureCaps = bool(NVSDK_NGX_Feature feature, PluginInfo& info);
+using PFunNGXAllocateParameters = NVSDK_NGX_Parameter*();
+using PFunNGXDestroyParameters = void(NVSDK_NGX_Parameter* params);
+using PFunNGXCreateFeatureWithParameters = bool(void* cmdList, NVSDK_NGX_Feature feature, NVSDK_NGX_Parameter* params, NVSDK_NGX_Handle** handle, const char* id);
+
+//! Evaluation parameters with the last value set for each key, implemented in sl.common
+struct NGXParameterCache;
+
+//! Matches the NVSDK_NGX_Parameter::Set overloads used for evaluation
+enum class NGXParameterType : uint32_t
+{
+    eUInt64,
+    eFloat,
+    eDouble,
+    eUInt,
+    eInt,
+    ePointer
+};
+
+using PFunNGXCreateParameterCache = NGXParameterCache*();
+using PFunNGXDestroyParameterCache = void(NGXParameterCache* cache);
+using PFunNGXSetCachedParameter = void(NGXParameterCache* cache, const char* name, NGXParameterType type, uint64_t value);
+using PFunNGXEvaluateFeatureWithCache = bool(void* cmdList, NVSDK_NGX_Handle* handle, NGXParameterCache* cache, const char* id);
 
 constexpr uint32_t kMaxNumBeforeReleaseCallbacks = 32;
 
@@ -225,8 +510,255 @@ struct NGXContext
     PFunNGXReleaseFeature* releaseFeature{};
     PFunNGXEvaluateFeature* evaluateFeature{};
     PFunNGXUpdateFeature* updateFeature{};
+    //! Private parameter blocks so features can be created off the render thread while 'params' is used for evaluation
+    //!
+    //! Creating with private parameters is D3D12 only, null on other platforms
+    PFunNGXAllocateParameters* allocateParameters{};
+    PFunNGXDestroyParameters* destroyParameters{};
+    PFunNGXCreateFeatureWithParameters* createFeatureWithParameters{};
+    //! Per viewport evaluation parameters, 'Set' is only called for keys which changed since the last evaluate
+    //!
+    //! Falls back to 'params' (without skipping anything) if the cache is null or a private block could not be allocated
+    PFunNGXCreateParameterCache* createParameterCache{};
+    PFunNGXDestroyParameterCache* destroyParameterCache{};
+    PFunNGXSetCachedParameter* setCachedParameter{};
+    PFunNGXEvaluateFeatureWithCache* evaluateFeatureWithCache{};
+};
+
+//! Plugin side helper for 'NGXContext::setCachedParameter', same overloads as NVSDK_NGX_Parameter::Set
+struct NGXCachedParameters
+{
+    NGXContext* ngx{};
+    NGXParameterCache* cache{};
+
+    inline void set(const char* name, unsigned long long value) { ngx->setCachedParameter(cache, name, NGXParameterType::eUInt64, value); }
+    inline void set(const char* name, float value) { uint32_t bits; memcpy(&bits, &value, sizeof(bits)); ngx->setCachedParameter(cache, name, NGXParameterType::eFloat, bits); }
+    inline void set(const char* name, double value) { uint64_t bits; memcpy(&bits, &value, sizeof(bits)); ngx->setCachedParameter(cache, name, NGXParameterType::eDouble, bits); }
+    inline void set(const char* name, unsigned int value) { ngx->setCachedParameter(cache, name, NGXParameterType::eUInt, value); }
+    inline void set(const char* name, int value) { ngx->setCachedParameter(cache, name, NGXParameterType::eInt, (uint64_t)(uint32_t)value); }
+    inline void set(const char* name, void* value) { ngx->setCachedParameter(cache, name, NGXParameterType::ePointer, (uint64_t)value); }
+};
+
+//! NGX features which are no longer in use by their viewport, kept so switching back to the same creation parameters is instant
+//!
+//! Opt-in, 'retire' releases right away unless 'enabled' is set. Entries are LRU evicted once over 'budgetBytes'
+//! or 'maxCount'. Key needs 'operator==' and the render/output sizes for logging. Render thread only.
+template<typename Key>
+struct NGXFeatureCache
+{
+    struct Entry
+    {
+        uint32_t viewport{};
+        Key key{};
+        NVSDK_NGX_Handle* handle{};
+        uint64_t bytes{};
+        uint64_t lastUsed{};
+    };
+
+    explicit NGXFeatureCache(const char* id_) : id(id_) {}
+
+    //! Plugin name used for NGX calls and logging
+    const char* id{};
+    bool enabled = false;
+    uint64_t budgetBytes = 512ull * 1024 * 1024;
+    uint32_t maxCount = 4;
+
+    //! Keeps a feature, releasing the least recently used ones when over budget
+    void add(NGXContext* ngx, uint32_t viewport, const Key& key, NVSDK_NGX_Handle* handle, uint64_t bytes)
+    {
+        entries.push_back({ viewport, key, handle, bytes, ++tick });
+        totalBytes += bytes;
+        while (!entries.empty() && (totalBytes > budgetBytes || entries.size() > maxCount))
+        {
+            auto lru = std::min_element(entries.begin(), entries.end(), [](const Entry& a, const Entry& b)->bool { return a.lastUsed < b.lastUsed; });
+            SL_LOG_INFO("Releasing cached %s feature (%u,%u) -> (%u,%u) for viewport %u - cache over budget", id, lru->key.renderWidth, lru->key.renderHeight, lru->key.outputWidth, lru->key.outputHeight, lru->viewport);
+            // Errors logged by sl.common
+            ngx->releaseFeature(lru->handle, id);
+            totalBytes -= lru->bytes;
+            entries.erase(lru);
+        }
+    }
+
+    //! Caches a feature the viewport stopped using, releases it if the cache is off
+    void retire(NGXContext* ngx, uint32_t viewport, const Key& key, NVSDK_NGX_Handle* handle, uint64_t bytes)
+    {
+        if (!handle) return;
+        if (enabled)
+        {
+            add(ngx, viewport, key, handle, bytes);
+        }
+        else
+        {
+            // Errors logged by sl.common
+            ngx->releaseFeature(handle, id);
+        }
+    }
+
+    //! Removes and returns a cached feature matching the key exactly, null if none
+    NVSDK_NGX_Handle* take(uint32_t viewport, const Key& key, uint64_t& bytes)
+    {
+        for (auto it = entries.begin(); it != entries.end(); it++)
+        {
+            if (it->viewport == viewport && it->key == key)
+            {
+                auto handle = it->handle;
+                bytes = it->bytes;
+                totalBytes -= it->bytes;
+                entries.erase(it);
+                return handle;
+            }
+        }
+        return nullptr;
+    }
+
+    //! True if cached, counts as a use for the LRU order
+    bool touch(uint32_t viewport, const Key& key)
+    {
+        for (auto& entry : entries)
+        {
+            if (entry.viewport == viewport && entry.key == key)
+            {
+                entry.lastUsed = ++tick;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    //! Releases cached features for the viewport, or all of them if viewport is UINT_MAX
+    void release(NGXContext* ngx, uint32_t viewport)
+    {
+        for (auto it = entries.begin(); it != entries.end();)
+        {
+            if (viewport == UINT_MAX || it->viewport == viewport)
+            {
+                ngx->releaseFeature(it->handle, id);
+                totalBytes -= it->bytes;
+                it = entries.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+    }
+
+    std::vector<Entry> entries{};
+    uint64_t totalBytes{};
+    uint64_t tick{};
 };
 
+//! First half of the GUID, unique enough to reject mismatches without comparing all 128 bits
+inline uint64_t getStructTypeFingerprint(const StructType& type)
+{
+    uint64_t fingerprint;
+    memcpy(&fingerprint, &type, sizeof(fingerprint));
+    return fingerprint;
+}
+
+//! Index of every struct chained in the evaluate inputs, built in one pass by 'slEvaluateFeature'
+//!
+//! Plugins get it as the first entry of 'inputs', plugins built before it existed skip it like any other
+//! unknown struct. Use 'findInput' and 'findInputs' to look up evaluate inputs, both walk the chains
+//! when there is no index (older sl.common) or when the inputs did not fit.
+// {fa08473a-eac5-40c2-9106-fc3543a33e7f}
+SL_STRUCT_BEGIN(InputIndex, StructType({ 0xfa08473a, 0xeac5, 0x40c2, { 0x91, 0x06, 0xfc, 0x35, 0x43, 0xa3, 0x3e, 0x7f } }), kStructVersion1)
+    static constexpr uint32_t kCapacity = 32;
+
+    void build(const sl::BaseStructure** inputs_, uint32_t numInputs_)
+    {
+        inputs = inputs_;
+        numInputs = numInputs_;
+        count = 0;
+        overflow = false;
+        for (uint32_t i = 0; inputs && i < numInputs; i++)
+        {
+            for (auto base = inputs[i]; base; base = base->next)
+            {
+                if (count == kCapacity)
+                {
+                    overflow = true;
+                    return;
+                }
+                fingerprints[count] = getStructTypeFingerprint(base->structType);
+                structs[count++] = base;
+            }
+        }
+    }
+
+    //! First struct of type T in chain order
+    template<typename T>
+    T* find() const
+    {
+        if (overflow)
+        {
+            return findStruct<T>((const void**)inputs, numInputs);
+        }
+        const uint64_t fingerprint = getStructTypeFingerprint(T::s_structType);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (fingerprints[i] == fingerprint && structs[i]->structType == T::s_structType)
+            {
+                return (T*)structs[i];
+            }
+        }
+        return nullptr;
+    }
+
+    //! All structs of type T in chain order
+    template<typename T, typename Allocator>
+    bool findAll(std::vector<T*, Allocator>& out) const
+    {
+        if (overflow)
+        {
+            return findStructs<T>((const void**)inputs, numInputs, out);
+        }
+        const uint64_t fingerprint = getStructTypeFingerprint(T::s_structType);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (fingerprints[i] == fingerprint && structs[i]->structType == T::s_structType)
+            {
+                out.push_back((T*)structs[i]);
+            }
+        }
+        return !out.empty();
+    }
+
+    uint64_t fingerprints[kCapacity]{};
+    const sl::BaseStructure* structs[kCapacity]{};
+    uint32_t count{};
+    //! More structs than 'kCapacity', lookups walk the original inputs
+    bool overflow{};
+    //! Inputs as provided by the host, without the index
+    const sl::BaseStructure** inputs{};
+    uint32_t numInputs{};
+SL_STRUCT_END()
+
+inline const InputIndex* getInputIndex(const sl::BaseStructure** inputs, uint32_t numInputs)
+{
+    return inputs && numInputs && inputs[0] && inputs[0]->structType == InputIndex::s_structType ? (const InputIndex*)inputs[0] : nullptr;
+}
+
+template<typename T>
+T* findInput(const sl::BaseStructure** inputs, uint32_t numInputs)
+{
+    if (auto index = getInputIndex(inputs, numInputs))
+    {
+        return index->find<T>();
+    }
+    return findStruct<T>((const void**)inputs, numInputs);
+}
+
+template<typename T, typename Allocator>
+bool findInputs(const sl::BaseStructure** inputs, uint32_t numInputs, std::vector<T*, Allocator>& out)
+{
+    if (auto index = getInputIndex(inputs, numInputs))
+    {
+        return index->findAll<T>(out);
+    }
+    return findStructs<T>((const void**)inputs, numInputs, out);
+}
+
 struct EventData
 {
     uint32_t id = 0;
@@ -299,21 +831,124 @@ inline GetDataResult getConsts(const EventData& data, sl::Constants** consts)
     return getConsts(data, consts);
 }
 
+//! Camera data derived from the common constants
+//!
+//! Computed by sl.common once per frame and viewport when constants are set so plugins
+//! don't redo the same inversions. Row major, same convention as 'sl::Constants'.
+//! Host provided 'clipToCameraView', 'clipToPrevClip' and 'prevClipToClip' are used as is,
+//! missing ones are derived from the camera vectors and the previous frame for the viewport.
+struct DerivedCameraData
+{
+    float4x4 cameraViewToWorld{};
+    float4x4 worldToCameraView{};
+    float4x4 clipToCameraView{};
+    float4x4 clipToWorld{};
+    float4x4 worldToClip{};
+    float4x4 clipToPrevClip{};
+    float4x4 prevClipToClip{};
+    //! False on the first frame for a viewport or after a reset, previous frame matrices are identity then
+    bool hasPreviousFrame{};
+};
+
+//! Common constants as stored by sl.common, derived data lives next to the host values
+struct CommonConstants : sl::Constants
+{
+    DerivedCameraData derived{};
+};
+
+using PFunGetConstantsAndDerived = GetDataResult(const EventData&, Constants** consts, const DerivedCameraData** derived);
+
+inline GetDataResult getConsts(const EventData& data, sl::Constants** consts, const DerivedCameraData** derived)
+{
+    auto parameters = api::getContext()->parameters;
+    common::PFunGetConstantsAndDerived* getConstsAndDerived = {};
+    param::getPointerParam(parameters, param::global::kPFunGetConstsAndDerived, &getConstsAndDerived);
+    if (!getConstsAndDerived)
+    {
+        SL_LOG_ERROR( "Cannot obtain common constants");
+        return GetDataResult();
+    }
+    return getConstsAndDerived(data, consts, derived);
+}
+
 using PFunBeginEndEvent = sl::Result(chi::CommandList cmdList, const common::EventData& data, const sl::BaseStructure** inputs, uint32_t numInputs);
 using PFunRegisterEvaluateCallbacks = void(Feature feature, PFunBeginEndEvent* beginEvent, PFunBeginEndEvent* endEvent);
+//! Evaluates of a feature are serialized unless its callbacks are marked reentrant
+//!
+//! Reentrant callbacks keep their per evaluate state in the viewport or in a 'thread::ThreadContext', never in globals,
+//! so hosts can evaluate different viewports on separate threads' command lists at the same time.
+using PFunSetEvaluateReentrant = void(Feature feature, bool reentrant);
+
+//! Swap-chain resize protocol, all plugins rebuild their back buffer sized resources together
+//!
+//! 'release' runs before ResizeBuffers. 'describe' runs after it, fills up to 'kMaxResizeResources' entries and returns
+//! how many it filled. sl.common then creates the resources of all plugins with a single 'ICompute::createResources'
+//! while the host is stalling anyway and hands them to 'commit' in the same order, 'commit' must not keep a pointer to 'entries'.
+constexpr uint32_t kMaxResizeResources = 8;
+
+struct ResizeInfo
+{
+    chi::SwapChain swapChain{};
+    uint32_t width{};
+    uint32_t height{};
+    uint32_t bufferCount{};
+    chi::Format format{};
+};
+
+using PFunResizeRelease = void(const ResizeInfo& info);
+using PFunResizeDescribe = uint32_t(const ResizeInfo& info, chi::ResourceBatchEntry* entries);
+using PFunResizeCommit = void(const ResizeInfo& info, const chi::ResourceBatchEntry* entries, uint32_t count);
+//! Null callbacks unregister the feature
+using PFunRegisterResizeCallbacks = void(Feature feature, PFunResizeRelease* release, PFunResizeDescribe* describe, PFunResizeCommit* commit);
+
+//! Transient scratch resources shared by all plugins, see 'param::common::kPFunAcquireScratch'
+//!
+//! A plugin numbers the passes of its evaluate from zero and declares which passes touch each resource. sl.common
+//! gives every plugin its own range of passes so memory is shared between plugins as well as between resources
+//! of one plugin whose passes do not overlap. 'acquire' is called on every evaluate with the same requests, it only
+//! creates resources when the requests of any plugin change and its results must not be kept past the evaluate.
+//! 'beginPass' is recorded before each pass, contents of a resource are undefined at the start of its first pass.
+//! Only meant for work recorded on the command list passed to evaluate, never for work running concurrently on other queues.
+struct ScratchRequest
+{
+    chi::ResourceType type = chi::ResourceType::eTex2d;
+    chi::ResourceDescription desc;
+    const char* name = "";
+    uint32_t firstPass = 0;
+    uint32_t lastPass = 0;
+};
+
+//! Returns false if 'resources' could not be created, they are all null then
+using PFunAcquireScratch = bool(Feature feature, const ScratchRequest* requests, uint32_t count, chi::Resource* resources);
+using PFunBeginScratchPass = void(Feature feature, chi::CommandList cmdList, uint32_t pass);
+//! Destroys the feature's scratch resources once the GPU is done with them
+using PFunReleaseScratch = void(Feature feature);
 
 CommandBuffer* getNativeCommandBuffer(CommandBuffer* cmdBuffer, bool* slProxy = false);
 void registerEvaluateCallbacks(Feature feature, PFunBeginEndEvent* beginEvent, PFunBeginEndEvent* endEvent);
+void setEvaluateReentrant(Feature feature, bool reentrant);
+void registerResizeCallbacks(Feature feature, PFunResizeRelease* release, PFunResizeDescribe* describe, PFunResizeCommit* commit);
+bool acquireScratch(Feature feature, const ScratchRequest* requests, uint32_t count, chi::Resource* resources);
+void beginScratchPass(Feature feature, chi::CommandList cmdList, uint32_t pass);
+void releaseScratch(Feature feature);
 bool onLoad(const void* managerConfig, const void* extraConfig, chi::IResourcePool* pool);
 
 struct EvaluateCallbacks
 {
     PFunBeginEndEvent* beginEvaluate;
     PFunBeginEndEvent* endEvaluate;
+    bool reentrant = false;
 };
 
-template<typename T, typename... Args>
-void packData(std::vector<uint8_t>& blob, const T* a)
+struct ResizeCallbacks
+{
+    PFunResizeRelease* release;
+    PFunResizeDescribe* describe;
+    PFunResizeCommit* commit;
+};
+
+template<typename Allocator, typename T, typename... Args>
+void packData(std::vector<uint8_t, Allocator>& blob, const T* a)
 {
     if (a)
     {
@@ -324,8 +959,8 @@ void packData(std::vector<uint8_t>& blob, const T* a)
     }
 }
 
-template<typename T, typename... Args>
-void packData(std::vector<uint8_t>& blob, const T* a, Args... args)
+template<typename Allocator, typename T, typename... Args>
+void packData(std::vector<uint8_t, Allocator>& blob, const T* a, Args... args)
 {
     packData(blob, a);
     packData(blob, args...);
@@ -369,7 +1004,6 @@ struct ViewportIdFrameData
     struct FrameData
     {
         FrameData() {};
-        FrameData(const std::vector<uint8_t>& d, uint32_t f) : data(d), frame(f) {};
         FrameData(const FrameData& rhs) { operator=(rhs); }
         inline FrameData& operator=(const FrameData& rhs)
         {
@@ -377,6 +1011,12 @@ struct ViewportIdFrameData
             frame = rhs.frame;
             return *this;
         }
+        //! Reuses the existing capacity, constants are usually the same size every frame
+        inline void assign(const uint8_t* d, size_t size, uint32_t f)
+        {
+            data.assign(d, d + size);
+            frame = f;
+        }
 
         std::vector<uint8_t> data{};
         uint32_t frame{};
@@ -404,18 +1044,18 @@ struct ViewportIdFrameData
     template<typename T, typename... Args>
     bool set(uint32_t frame, uint32_t id, const T* a)
     {
-        std::vector<uint8_t> blob;
+        extra::FrameVector<uint8_t> blob;
         packData(blob, a);
-        return set(blob, frame, id);
+        return set(blob.data(), blob.size(), frame, id);
     }
 
     template<typename T, typename... Args>
     bool set(uint32_t frame, uint32_t id, const T* a, Args... args)
     {
-        std::vector<uint8_t> blob;
+        extra::FrameVector<uint8_t> blob;
         packData(blob, a);
         packData(blob, args...);
-        return set(blob, frame, id);
+        return set(blob.data(), blob.size(), frame, id);
     }
 
     template<typename T, typename... Args>
@@ -449,7 +1089,7 @@ struct ViewportIdFrameData
 
 private:
 
-    bool set(const std::vector<uint8_t>& data, uint32_t frame, uint32_t id)
+    bool set(const uint8_t* data, size_t size, uint32_t frame, uint32_t id)
     {
         std::lock_guard<std::mutex> lock(m_mutex);
         auto& item = m_list[id];
@@ -463,10 +1103,10 @@ private:
             //! 
             //! This is fine ONLY if constants are identical so check
             auto& lastData = item.frames[item.lastIndex].data;
-            if (lastData.size() != data.size() || (memcmp(lastData.data(), data.data(), data.size()) != 0))
+            if (lastData.size() != size || (memcmp(lastData.data(), data, size) != 0))
             {
                 // Incoming and the existing data either have different size or different contents, this is not allowed within the same frame
-                item.frames[item.lastIndex] = { data, frame };
+                item.frames[item.lastIndex].assign(data, size, frame);
                 if (mustSetEachFrame)
                 {
                     SL_LOG_ERROR( "Setting different '%s' constants multiple times within the same frame is NOT allowed!", m_name.c_str());
@@ -480,7 +1120,7 @@ private:
                 return true;
             }
         }
-        item.frames[item.index] = { data, frame };
+        item.frames[item.index].assign(data, size, frame);
         item.lastIndex = item.index;
         item.index = (item.index + 1) % dataQueueSize;
         return true;
@@ -530,6 +1170,172 @@ private:
     std::map<uint32_t, IndexedFrameData> m_list = {};
 };
 
+//! Typed unique frame data
+//!
+//! Same semantics as 'ViewportIdFrameData' for a single structure type but without the per call
+//! blob packing. Each viewport owns a fixed ring of 'dataQueueSize' entries which is never
+//! reallocated, viewport ids below 'kFlatViewportCount' are looked up directly in a flat table.
+//!
+//! Only 'set' takes a lock, 'get' reads the published ring without one. Same as before, the
+//! returned pointer stays valid until the entry is recycled 'dataQueueSize' sets later.
+//!
+template<typename T, uint32_t dataQueueSize = 3, bool mustSetEachFrame = false>
+struct TypedViewportIdFrameData
+{
+    static constexpr uint32_t kFlatViewportCount = 16;
+    static constexpr uint32_t kInvalidIndex = UINT_MAX;
+
+    struct FrameData
+    {
+        T data{};
+        std::atomic<uint32_t> frame{};
+    };
+
+    struct IndexedFrameData
+    {
+        //! Next entry to write, only touched under the writer lock
+        uint32_t index = {};
+        std::atomic<uint32_t> lastIndex = kInvalidIndex;
+        FrameData frames[dataQueueSize]{};
+    };
+
+    TypedViewportIdFrameData(const char* name) : m_name(name) {};
+    TypedViewportIdFrameData(const TypedViewportIdFrameData&) = delete;
+    TypedViewportIdFrameData& operator=(const TypedViewportIdFrameData&) = delete;
+    ~TypedViewportIdFrameData()
+    {
+        for (auto& item : m_flat)
+        {
+            delete item.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool set(uint32_t frame, uint32_t id, const T* a)
+    {
+        if (!a) return false;
+
+        // Stored copies are never chained, same as what unpacking does for the blob based version
+        T data = *a;
+        data.next = {};
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto& item = getOrCreateItem(id);
+        auto lastIndex = item.lastIndex.load(std::memory_order_relaxed);
+        bool result = true;
+        if (lastIndex != kInvalidIndex && item.frames[lastIndex].frame.load(std::memory_order_relaxed) == frame)
+        {
+            //! Settings constants more than once per frame for the same unique id
+            //! 
+            //! This is fine ONLY if constants are identical so check
+            auto& last = item.frames[lastIndex];
+            if (memcmp(&last.data, &data, sizeof(T)) == 0)
+            {
+                return true;
+            }
+            // Incoming and the existing data have different contents, this is not allowed within the same frame
+            if (mustSetEachFrame)
+            {
+                SL_LOG_ERROR( "Setting different '%s' constants multiple times within the same frame is NOT allowed!", m_name.c_str());
+                result = false;
+            }
+            // Latest data still wins but readers may hold a pointer to the current entry lock-free so it is
+            // never rewritten in place, the new entry becomes the last one and 'get' finds it before the older copy
+        }
+        auto& entry = item.frames[item.index];
+        // Invalidate first so readers searching for the frame being replaced skip this entry
+        entry.frame.store(kInvalidIndex, std::memory_order_release);
+        entry.data = data;
+        entry.frame.store(frame, std::memory_order_release);
+        item.lastIndex.store(item.index, std::memory_order_release);
+        item.index = (item.index + 1) % dataQueueSize;
+        return result;
+    }
+
+    GetDataResult get(const common::EventData& ev, T** a)
+    {
+        *a = {};
+        auto* item = findItem(ev.id);
+        auto lastIndex = item ? item->lastIndex.load(std::memory_order_acquire) : kInvalidIndex;
+        if (lastIndex == kInvalidIndex)
+        {
+            // Not set for this id so let's default to 0
+            item = findItem(0);
+            lastIndex = item ? item->lastIndex.load(std::memory_order_acquire) : kInvalidIndex;
+            if (lastIndex == kInvalidIndex)
+            {
+                // Not set for 0, this is definitely not allowed
+                return GetDataResult::eNotFound;
+            }
+        }
+        for (uint32_t i = 0; i < dataQueueSize; i++)
+        {
+            uint32_t n = (lastIndex + i) % dataQueueSize;
+            if (item->frames[n].frame.load(std::memory_order_acquire) == ev.frame)
+            {
+                *a = &item->frames[n].data;
+                return GetDataResult::eFoundExact;
+            }
+        }
+        auto& last = item->frames[lastIndex];
+        *a = &last.data;
+        if (!ev.empty())
+        {
+            if (mustSetEachFrame)
+            {
+                // This can really spam the log due to changing frame index
+                SL_LOG_ERROR_ONCE( "Unable to find '%s' constants for frame %u - id %u - using last set for frame %u - this needs to be fixed if occurring every frame", m_name.c_str(), ev.frame, ev.id, last.frame.load());
+            }
+            else
+            {
+                SL_LOG_WARN_ONCE("Unable to find '%s' constants for frame %u - id %u - using last set for frame %u - this is OK since consts are flagged as not needed every frame", m_name.c_str(), ev.frame, ev.id, last.frame.load());
+            }
+        }
+        return GetDataResult::eFound;
+    }
+
+private:
+
+    IndexedFrameData* findItem(uint32_t id)
+    {
+        if (id < kFlatViewportCount)
+        {
+            return m_flat[id].load(std::memory_order_acquire);
+        }
+        // Rare, hosts normally use small viewport ids
+        std::shared_lock lock(m_overflowMutex);
+        auto it = m_overflow.find(id);
+        return it != m_overflow.end() ? it->second.get() : nullptr;
+    }
+
+    //! Called with the writer lock held
+    IndexedFrameData& getOrCreateItem(uint32_t id)
+    {
+        if (id < kFlatViewportCount)
+        {
+            auto item = m_flat[id].load(std::memory_order_relaxed);
+            if (!item)
+            {
+                item = new IndexedFrameData();
+                m_flat[id].store(item, std::memory_order_release);
+            }
+            return *item;
+        }
+        std::unique_lock lock(m_overflowMutex);
+        auto& item = m_overflow[id];
+        if (!item)
+        {
+            item = std::make_unique<IndexedFrameData>();
+        }
+        return *item;
+    }
+
+    std::string m_name = {};
+    std::mutex m_mutex = {};
+    std::atomic<IndexedFrameData*> m_flat[kFlatViewportCount]{};
+    std::shared_mutex m_overflowMutex = {};
+    std::map<uint32_t, std::unique_ptr<IndexedFrameData>> m_overflow = {};
+};
+
 struct ResourceTaggingBase
 {
     // Legacy resource-tagging API (slSetTag) implementation replaces existing tag only when a new tag of same type arrives which is incorrect
@@ -548,6 +1354,7 @@ struct ResourceTaggingBase
         CommandBuffer*,
         bool,
         const PrecisionInfo*,
+        const ResourceLifetimeInfo*,
         const sl::FrameToken&) = 0;
     virtual void getTag(BufferType,
         uint32_t,
@@ -556,9 +1363,103 @@ struct ResourceTaggingBase
         const sl::BaseStructure**,
         uint32_t,
         bool) = 0;
+    //! Bulk version of getTag, at most kMaxTagsPerRequest tags per call
+    virtual void getTags(const BufferType*,
+        uint32_t,
+        uint32_t,
+        uint32_t,
+        CommonResource*,
+        const sl::BaseStructure**,
+        uint32_t,
+        bool) = 0;
+
+    static constexpr uint32_t kMaxTagsPerRequest = 64;
+
+    //! Volatile tag copies collected by 'setTag' while a batch is open on the calling thread
+    //!
+    //! Tagging several resources at once can then transition all sources (and clones) with one barrier,
+    //! record the copies back to back and revert the transitions together, see 'setTagCommon'.
+    struct TagCopyBatch
+    {
+        struct Copy
+        {
+            sl::Resource source{};
+            chi::ResourceState sourceState{};
+            chi::HashedResource clone{};
+            chi::ResourceState cloneState = chi::ResourceState::eCopyDestination;
+            //! Only this part of the source is copied if valid, see 'ICompute::copyResourceRegion'
+            Extent region{};
+            //! Clone holds only the depth plane, see 'ICompute::copyDepthToColor'
+            bool depthOnly = false;
+        };
+        std::vector<Copy> copies;
+    };
+
+    static TagCopyBatch*& getTagCopyBatch()
+    {
+        static thread_local TagCopyBatch* s_batch{};
+        return s_batch;
+    }
 
 protected:
-    std::unordered_set<BufferTagInfo, BufferTagInfoHash> requiredTags{};
+    //! Allocates the clone of a volatile tag and copies the resource into it, the copy goes into the open
+    //! 'TagCopyBatch' if any. The clone and its native state are stored in 'res'.
+    //!
+    //! Honors the 'TagClonePolicy' declared for every lifecycle the tag is required with.
+    static sl::Result makeVolatileCopy(chi::ICompute* compute, chi::IResourcePool* pool, chi::CommandList cmdList, const sl::Resource* resource,
+        BufferType tag, uint32_t id, const Extent* ext, bool requiredOnPresent, bool requiredOnEvaluate, CommonResource& res);
+
+    //! Resolves local tags from the evaluate inputs in a single pass over the chains
+    //!
+    //! Returns a bit mask of the entries in 'res' which were found, first match in chain order wins
+    static uint64_t findLocalTags(const BufferType* tagTypes, uint32_t count, CommonResource* res, const sl::BaseStructure** inputs, uint32_t numInputs)
+    {
+        assert(count <= kMaxTagsPerRequest);
+        uint64_t found = 0;
+        auto match = [&](const sl::BaseStructure* base)
+        {
+            auto tag = (const ResourceTag*)base;
+            for (uint32_t k = 0; k < count; k++)
+            {
+                if (!(found & (1ull << k)) && tagTypes[k] == tag->type)
+                {
+                    res[k].extent = tag->extent;
+                    res[k].res = *tag->resource;
+
+                    // Optional extensions are chained after the tag they belong to
+                    PrecisionInfo* optPi = findStruct<PrecisionInfo>(tag->next);
+                    res[k].pi = optPi ? *optPi : PrecisionInfo{};
+                    found |= 1ull << k;
+                }
+            }
+        };
+        auto index = getInputIndex(inputs, numInputs);
+        if (index && !index->overflow)
+        {
+            const uint64_t fingerprint = getStructTypeFingerprint(ResourceTag::s_structType);
+            for (uint32_t i = 0; i < index->count; i++)
+            {
+                if (index->fingerprints[i] == fingerprint && index->structs[i]->structType == ResourceTag::s_structType)
+                {
+                    match(index->structs[i]);
+                }
+            }
+            return found;
+        }
+        for (uint32_t i = 0; inputs && i < numInputs; i++)
+        {
+            for (auto base = inputs[i]; base; base = base->next)
+            {
+                if (base->structType == ResourceTag::s_structType)
+                {
+                    match(base);
+                }
+            }
+        }
+        return found;
+    }
+
+    RequiredTagRegistry requiredTags{};
 };
 
 struct ResourceTaggingGeneral : public ResourceTaggingBase
@@ -571,6 +1472,7 @@ struct ResourceTaggingGeneral : public ResourceTaggingBase
         CommandBuffer* cmdBuffer,
         bool localTag,
         const PrecisionInfo* pi,
+        const ResourceLifetimeInfo* lifetime,
         const sl::FrameToken& frame) override final;
     virtual void getTag(BufferType tagType,
         uint32_t frameId,
@@ -579,6 +1481,14 @@ struct ResourceTaggingGeneral : public ResourceTaggingBase
         const sl::BaseStructure** inputs,
         uint32_t numInputs,
         bool optional) override final;
+    virtual void getTags(const BufferType* tagTypes,
+        uint32_t count,
+        uint32_t frameId,
+        uint32_t viewportId,
+        CommonResource* res,
+        const sl::BaseStructure** inputs,
+        uint32_t numInputs,
+        bool optional) override final;
 
     ~ResourceTaggingGeneral();
 
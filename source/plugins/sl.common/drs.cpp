@@ -24,6 +24,9 @@
 #include <mutex>
 #include <vector>
 #include <type_traits>
+#include <unordered_map>
+#include <chrono>
+#include <future>
 #include "source/core/sl.log/log.h"
 #include "source/core/sl.file/file.h"
 
@@ -40,6 +43,57 @@ namespace drs
 #endif
     std::mutex g_mutex;
 
+    //! Results are cached per process and the settings snapshot is reloaded in the background
+    //! every 'kRefreshInterval' so changes made in the control panel are picked up eventually.
+    constexpr std::chrono::seconds kRefreshInterval{ 10 };
+
+    struct CachedSetting
+    {
+        bool found = false;
+        NvU32 u32Value{};
+        std::wstring stringValue{};
+    };
+    std::unordered_map<uint64_t, CachedSetting> g_cache;
+#ifdef NV_WINDOWS
+    NvDRSProfileHandle g_hAppProfile = 0;
+#endif
+    bool g_appProfileResolved = false;
+    std::chrono::steady_clock::time_point g_loadTime{};
+    std::future<void> g_refresh;
+    bool g_refreshPending = false;
+
+    void refreshSettings()
+    {
+#ifdef NV_WINDOWS
+        // Loading settings is slow so it happens on a fresh session without holding the lock,
+        // readers keep getting cached values until the new snapshot is swapped in.
+        NvDRSSessionHandle hSession = NULL;
+        NvDRSProfileHandle hProfile = 0;
+        if (NVAPI_OK == NvAPI_DRS_CreateSession(&hSession))
+        {
+            if (NVAPI_OK != NvAPI_DRS_LoadSettings(hSession) || NVAPI_OK != NvAPI_DRS_GetBaseProfile(hSession, &hProfile))
+            {
+                NvAPI_DRS_DestroySession(hSession);
+                hSession = NULL;
+            }
+        }
+        std::unique_lock<std::mutex> lock(g_mutex);
+        if (hSession && g_hDRSSession)
+        {
+            std::swap(hSession, g_hDRSSession);
+            g_hDRSProfile = hProfile;
+            g_appProfileResolved = false;
+            g_cache.clear();
+        }
+        if (hSession)
+        {
+            NvAPI_DRS_DestroySession(hSession);
+        }
+        g_loadTime = std::chrono::steady_clock::now();
+        g_refreshPending = false;
+#endif
+    }
+
     bool drsInit()
     {
 #ifdef NV_WINDOWS
@@ -59,7 +113,10 @@ namespace drs
             }
         }
         if (g_hDRSProfile && g_hDRSSession)
+        {
+            g_loadTime = std::chrono::steady_clock::now();
             return true;
+        }
         if (!g_hDRSProfile && g_hDRSSession)
         {
             NvAPI_DRS_DestroySession(g_hDRSSession);
@@ -74,12 +131,20 @@ namespace drs
 #ifdef NV_WINDOWS
         if (!g_hDRSProfile)
             return;
+        // Background refresh takes the lock when done so wait for it first
+        if (g_refresh.valid())
+        {
+            g_refresh.wait();
+        }
         std::unique_lock<std::mutex> lock(g_mutex);
         if (!g_hDRSProfile)
             return;
         NvAPI_DRS_DestroySession(g_hDRSSession);
         g_hDRSSession = NULL;
         g_hDRSProfile = NULL;
+        g_hAppProfile = 0;
+        g_appProfileResolved = false;
+        g_cache.clear();
 #endif
     }
 
@@ -101,40 +166,68 @@ namespace drs
     bool drsReadKeyImpl(NvU32 keyId, T& value, bool useAppProfile)
     {
 #ifdef NV_WINDOWS
+        constexpr bool isString = !std::is_same_v<T, NvU32>;
         std::unique_lock<std::mutex> lock(g_mutex);
-        NvDRSProfileHandle hProfile;
-        if (useAppProfile)
+        if (!g_hDRSSession)
         {
-            std::wstring wAppName = sl::file::getFullPathOfExecutable();
-            auto status = getProfileHandleImpl(g_hDRSSession, wAppName, hProfile);
-            if (status != NVAPI_OK)
-            {
-                return false;
-            }
+            return false;
         }
-        else
+
+        if (!g_refreshPending && std::chrono::steady_clock::now() - g_loadTime > kRefreshInterval)
         {
-            hProfile = g_hDRSProfile;
+            g_refreshPending = true;
+            g_refresh = std::async(std::launch::async, refreshSettings);
         }
-        if (!hProfile)
+
+        auto key = (uint64_t)keyId | ((uint64_t)useAppProfile << 32) | ((uint64_t)isString << 33);
+        auto it = g_cache.find(key);
+        if (it == g_cache.end())
         {
-            return false;
+            CachedSetting cached{};
+            NvDRSProfileHandle hProfile = g_hDRSProfile;
+            if (useAppProfile)
+            {
+                // Executable lookup is the expensive part, resolve it once per snapshot
+                if (!g_appProfileResolved)
+                {
+                    std::wstring wAppName = sl::file::getFullPathOfExecutable();
+                    if (getProfileHandleImpl(g_hDRSSession, wAppName, g_hAppProfile) != NVAPI_OK)
+                    {
+                        g_hAppProfile = 0;
+                    }
+                    g_appProfileResolved = true;
+                }
+                hProfile = g_hAppProfile;
+            }
+            NVDRS_SETTING profileSetting;
+            profileSetting.version = NVDRS_SETTING_VER;
+            if (hProfile && NvAPI_DRS_GetSetting(g_hDRSSession, hProfile, keyId, &profileSetting) == NVAPI_OK)
+            {
+                cached.found = true;
+                if constexpr (isString)
+                {
+                    const char* s = (const char*)&profileSetting.binaryCurrentValue.valueData[0];
+                    cached.stringValue = std::wstring(s, s + strlen(s));
+                }
+                else
+                {
+                    cached.u32Value = profileSetting.u32CurrentValue;
+                }
+            }
+            it = g_cache.emplace(key, std::move(cached)).first;
         }
-        NVDRS_SETTING profileSetting;
-        profileSetting.version = NVDRS_SETTING_VER;
-        auto status = NvAPI_DRS_GetSetting(g_hDRSSession, hProfile, keyId, &profileSetting);
-        if (status != NVAPI_OK)
+
+        if (!it->second.found)
         {
             return false;
         }
-        if constexpr (std::is_same_v<T, NvU32>)
+        if constexpr (isString)
         {
-            value = profileSetting.u32CurrentValue;
+            value = it->second.stringValue;
         }
         else
         {
-            const char* s = (const char*)&profileSetting.binaryCurrentValue.valueData[0];
-            value = std::wstring(s, s + strlen(s));
+            value = it->second.u32Value;
         }
         return true;
 #else
@@ -0,0 +1,334 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <dxgi.h>
+
+#include "source/core/sl.log/log.h"
+#include "source/core/sl.extra/preciseWait.h"
+#include "source/core/sl.thread/thread.h"
+#include "source/platforms/sl.chi/compute.h"
+
+namespace sl
+{
+namespace common
+{
+
+struct PresentFrame;
+
+//! Runs on the present thread right before 'frame' is presented, for example to copy a generated frame into the back buffer
+using PFunPresentFrameCallback = void(const PresentFrame& frame, void* userData);
+
+//! Frame handed over to the present thread, see 'IPresentQueue::enqueue'
+struct PresentFrame
+{
+    //! Native swap-chain as passed to the present hooks, never the SL proxy
+    chi::SwapChain swapChain{};
+    //! Present thread waits on the CPU until 'fence' reaches 'fenceValue', null if the frame is ready when queued
+    chi::Fence fence{};
+    uint64_t fenceValue{};
+    uint32_t syncInterval{};
+    uint32_t flags{};
+    //! Produced by a plugin rather than the host, frames are spaced evenly only when there are generated ones
+    bool generated{};
+    PFunPresentFrameCallback* callback{};
+    void* userData{};
+};
+
+struct PresentQueueStats
+{
+    uint64_t presented{};
+    uint64_t generated{};
+    //! Frames refused by 'enqueue' because the queue was full
+    uint64_t rejected{};
+    uint64_t fenceTimeouts{};
+    //! Spacing applied between presents, zero while frames are presented as soon as they are ready
+    float intervalMs{};
+    float refreshRate{};
+};
+
+//! Presents frames on a dedicated thread so frame generation never blocks the host's render thread
+//!
+//! Shared with plugins via 'param::common::kPresentQueue'. A plugin presents through it from its present hook
+//! by setting 'Skip' and queueing the host frame along with the frames it generated, frames are presented
+//! in order once their fence is reached. Only DXGI swap-chains are supported.
+struct IPresentQueue
+{
+    //! Not thread safe, up to 'capacity' frames can be queued. With 'waitForVblank' frames presented without
+    //! v-sync are aligned to vertical blanks instead of being spaced by the measured host frame time.
+    virtual bool start(uint32_t capacity, bool waitForVblank) = 0;
+    //! Presents whatever is still queued and stops the thread
+    virtual void stop() = 0;
+    //! Never blocks, false if the queue is full or not running so the caller can present inline instead
+    virtual bool enqueue(const PresentFrame& frame) = 0;
+    //! Blocks until all queued frames are presented, sl.common calls it before a swap-chain is resized or destroyed
+    virtual void flush() = 0;
+    virtual void getStats(PresentQueueStats& stats) = 0;
+};
+
+class PresentQueue : public IPresentQueue
+{
+public:
+    static constexpr uint32_t kMaxCapacity = 8;
+    //! Querying the refresh rate goes through the display configuration, fine once every few seconds
+    static constexpr uint32_t kRefreshRateQueryPresents = 600;
+
+    ~PresentQueue() { stop(); }
+
+    void setCompute(chi::ICompute* compute) { m_compute = compute; }
+
+    virtual bool start(uint32_t capacity, bool waitForVblank) override final
+    {
+        if (m_thread.joinable())
+        {
+            return true;
+        }
+        RenderAPI platform{};
+        if (!m_compute || m_compute->getRenderAPI(platform) != chi::ComputeStatus::eOk || platform == RenderAPI::eVulkan)
+        {
+            SL_LOG_ERROR("Present queue requires a D3D11 or D3D12 device");
+            return false;
+        }
+        capacity = std::clamp(capacity, 1u, kMaxCapacity);
+        m_ring.assign(capacity, {});
+        m_head = m_count = 0;
+        m_waitForVblank = waitForVblank;
+        m_quit = false;
+        m_running = true;
+        m_thread = std::thread(&PresentQueue::presentThread, this);
+        SetThreadDescription(m_thread.native_handle(), L"sl.common.presentQueue");
+        // Presents are on the critical path of every frame
+        SetThreadPriority(m_thread.native_handle(), THREAD_PRIORITY_ABOVE_NORMAL);
+        thread::setThreadPlacement(m_thread.native_handle(), thread::ThreadPlacement::ePerformance);
+        SL_LOG_INFO("Present queue started with %u frame(s)%s", capacity, waitForVblank ? ", waiting for vblank" : "");
+        return true;
+    }
+
+    virtual void stop() override final
+    {
+        if (!m_thread.joinable())
+        {
+            return;
+        }
+        {
+            std::scoped_lock lock(m_mtx);
+            m_running = false;
+            m_quit = true;
+        }
+        m_cvWork.notify_all();
+        m_thread.join();
+        m_cvIdle.notify_all();
+        setOutput({});
+    }
+
+    virtual bool enqueue(const PresentFrame& frame) override final
+    {
+        std::scoped_lock lock(m_mtx);
+        if (!m_running || !frame.swapChain)
+        {
+            return false;
+        }
+        if (m_count == m_ring.size())
+        {
+            m_stats.rejected++;
+            return false;
+        }
+        if (!frame.generated)
+        {
+            // Host frame time and how many frames were presented for it so generated ones can be spaced evenly
+            auto now = std::chrono::steady_clock::now();
+            if (m_lastHostFrame != std::chrono::steady_clock::time_point{})
+            {
+                double us = std::chrono::duration<double, std::micro>(now - m_lastHostFrame).count();
+                m_hostIntervalUs = m_hostIntervalUs > 0.0 ? m_hostIntervalUs * 0.9 + us * 0.1 : us;
+            }
+            m_lastHostFrame = now;
+            m_framesPerHost = std::max(m_framesSinceHost, 1u);
+            m_framesSinceHost = 0;
+        }
+        m_framesSinceHost++;
+        m_ring[(m_head + m_count) % m_ring.size()] = frame;
+        m_count++;
+        m_cvWork.notify_one();
+        return true;
+    }
+
+    virtual void flush() override final
+    {
+        std::unique_lock<std::mutex> lock(m_mtx);
+        m_cvIdle.wait(lock, [this]() { return (!m_count && !m_busy) || !m_running; });
+    }
+
+    virtual void getStats(PresentQueueStats& stats) override final
+    {
+        std::scoped_lock lock(m_mtx);
+        stats = m_stats;
+    }
+
+private:
+    void presentThread()
+    {
+        for (;;)
+        {
+            PresentFrame frame;
+            double intervalUs{};
+            {
+                std::unique_lock<std::mutex> lock(m_mtx);
+                m_cvWork.wait(lock, [this]() { return m_quit || m_count; });
+                if (!m_count)
+                {
+                    break;
+                }
+                frame = m_ring[m_head];
+                m_head = (m_head + 1) % m_ring.size();
+                m_count--;
+                m_busy = true;
+                intervalUs = m_framesPerHost > 1 ? m_hostIntervalUs / m_framesPerHost : 0.0;
+            }
+
+            present(frame, intervalUs);
+
+            {
+                std::scoped_lock lock(m_mtx);
+                m_busy = false;
+            }
+            m_cvIdle.notify_all();
+        }
+    }
+
+    void present(const PresentFrame& frame, double intervalUs)
+    {
+        bool fenceTimeout = false;
+        if (frame.fence && m_compute->waitCPUFence(frame.fence, frame.fenceValue) != chi::WaitStatus::eNoTimeout)
+        {
+            // Presenting anyway keeps frames in order, the worst case is a partially rendered frame
+            fenceTimeout = true;
+        }
+
+        if (frame.swapChain != m_swapChain || m_presentsSinceRefreshQuery >= kRefreshRateQueryPresents)
+        {
+            if (frame.swapChain != m_swapChain)
+            {
+                IDXGIOutput* output{};
+                ((IDXGISwapChain*)frame.swapChain)->GetContainingOutput(&output);
+                setOutput(output);
+                m_swapChain = frame.swapChain;
+            }
+            float refreshRate{};
+            if (m_compute->getRefreshRate(frame.swapChain, refreshRate) == chi::ComputeStatus::eOk)
+            {
+                m_refreshRate = refreshRate;
+            }
+            m_presentsSinceRefreshQuery = 0;
+        }
+        m_presentsSinceRefreshQuery++;
+
+        // With v-sync the swap-chain paces presents itself
+        if (frame.syncInterval == 0)
+        {
+            if (m_waitForVblank && m_output)
+            {
+                m_output->WaitForVBlank();
+            }
+            else if (intervalUs > 0.0 && m_lastPresent != std::chrono::steady_clock::time_point{})
+            {
+                // No point going faster than the display can show
+                if (m_refreshRate > 0.0f)
+                {
+                    intervalUs = std::max(intervalUs, 1000000.0 / m_refreshRate);
+                }
+                auto elapsedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_lastPresent).count();
+                m_timer.waitForUs(intervalUs - elapsedUs);
+            }
+        }
+
+        if (frame.callback)
+        {
+            frame.callback(frame, frame.userData);
+        }
+        HRESULT hr = ((IDXGISwapChain*)frame.swapChain)->Present(frame.syncInterval, frame.flags);
+        if (FAILED(hr))
+        {
+            SL_LOG_WARN_EVERY(100, "Present from the present queue failed - %s", std::system_category().message(hr).c_str());
+        }
+        m_lastPresent = std::chrono::steady_clock::now();
+
+        std::scoped_lock lock(m_mtx);
+        m_stats.presented++;
+        m_stats.generated += frame.generated ? 1 : 0;
+        m_stats.fenceTimeouts += fenceTimeout ? 1 : 0;
+        m_stats.intervalMs = frame.syncInterval == 0 && !m_waitForVblank ? (float)(intervalUs / 1000.0) : 0.0f;
+        m_stats.refreshRate = m_refreshRate;
+    }
+
+    void setOutput(IDXGIOutput* output)
+    {
+        if (m_output)
+        {
+            m_output->Release();
+        }
+        m_output = output;
+        if (!output)
+        {
+            m_swapChain = {};
+        }
+    }
+
+    chi::ICompute* m_compute{};
+    std::thread m_thread;
+    std::mutex m_mtx;
+    std::condition_variable m_cvWork;
+    std::condition_variable m_cvIdle;
+    std::vector<PresentFrame> m_ring;
+    size_t m_head{};
+    size_t m_count{};
+    bool m_busy{};
+    bool m_quit{};
+    bool m_running{};
+    bool m_waitForVblank{};
+    PresentQueueStats m_stats{};
+
+    //! Guarded by 'm_mtx', written by 'enqueue'
+    std::chrono::steady_clock::time_point m_lastHostFrame{};
+    double m_hostIntervalUs{};
+    uint32_t m_framesSinceHost{};
+    uint32_t m_framesPerHost = 1;
+
+    //! Present thread only
+    chi::SwapChain m_swapChain{};
+    IDXGIOutput* m_output{};
+    extra::PreciseTimer m_timer;
+    float m_refreshRate{};
+    uint32_t m_presentsSinceRefreshQuery{};
+    std::chrono::steady_clock::time_point m_lastPresent{};
+};
+
+}
+}
@@ -43,7 +43,7 @@ public:
     const ProtectedResourceTagContainer& m_container;
 
 private:
-    std::shared_lock<std::shared_timed_mutex> m_lock;
+    std::shared_lock<std::shared_mutex> m_lock;
 };
 
 // RAII wrapper for write access to ProtectedResourceTagContainer
@@ -58,33 +58,9 @@ public:
     ProtectedResourceTagContainer& m_container;
 
 private:
-    std::unique_lock<std::shared_timed_mutex> m_lock;
+    std::unique_lock<std::shared_mutex> m_lock;
 };
 
-std::unique_ptr<ScopedResourceTagContainerReadAccess>
-ResourceTaggingForFrame::findFrameForReading(uint32_t frameIndex)
-{
-    const auto& frame = m_frames[frameIndex % m_frames.size()];
-    // this grabs the mutex for the frame
-    auto pFrame = std::make_unique<ScopedResourceTagContainerReadAccess>(frame);
-
-    // do those tags have the correct frame index?
-    if (frame.getFrameIndex() == frameIndex)
-        return pFrame;
-    return nullptr;
-}
-
-std::unique_ptr<ScopedResourceTagContainerWriteAccess>
-ResourceTaggingForFrame::findFrameForWriting(uint32_t frameIndex)
-{
-    auto& frame = m_frames[frameIndex % m_frames.size()];
-
-    // this grabs the mutex for the frame
-    auto pFrame = std::make_unique<ScopedResourceTagContainerWriteAccess>(frame);
-
-    return pFrame;
-}
-
 ResourceTaggingForFrame::ResourceTaggingForFrame(chi::ICompute* pCompute, chi::IResourcePool* pPool)
     : m_pCompute(pCompute), m_pPool(pPool)
 {
@@ -101,23 +77,24 @@ sl::Result common::ResourceTaggingForFrame::setTag(const sl::Resource* resource,
                                                    CommandBuffer* cmdBuffer,
                                                    bool localTag,
                                                    const PrecisionInfo* pi,
+                                                   const ResourceLifetimeInfo* lifetime,
                                                    const sl::FrameToken& frame)
 {
     // here we're recycling the old tags
     recycleTags();
 
-    uint64_t uid = ((uint64_t)tag << 32) | (uint64_t)id;
+    uint64_t uid = ProtectedResourceTagContainer::getTagUID(tag, id);
     uint32_t currFrameId = frame;
 
-    auto frameAccess = findFrameForWriting(currFrameId);
+    // this grabs the mutex for the frame
+    ScopedResourceTagContainerWriteAccess frameAccess(getFrameSlot(currFrameId));
     // if frame index doesn't match - this means it's an old frame containing old tags
-    if (frameAccess->m_container.getFrameIndex() != currFrameId)
+    if (frameAccess.m_container.getFrameIndex() != currFrameId)
     {
-        this->recycleTagsForFrame(*frameAccess);
-        frameAccess->m_container.setFrameIndex(currFrameId);
+        this->recycleTagsForFrame(frameAccess);
+        frameAccess.m_container.setFrameIndex(currFrameId);
     }
-    auto& frameTags = frameAccess->m_container.resourceTagContainer;
-    auto& frameTag = frameTags[uid];
+    auto& frameTag = frameAccess.m_container.getOrCreateTag(tag, id);
 
     // release the old tag
     m_pPool->recycle(frameTag.clone);
@@ -125,6 +102,8 @@ sl::Result common::ResourceTaggingForFrame::setTag(const sl::Resource* resource,
 
     // make the tag empty
     frameTag = CommonResource();
+    frameTag.uFrameWhenTagged = currFrameId;
+    frameTag.lifecycle = lifecycle;
 
     // bake the new tag
     if (resource && resource->native)
@@ -150,23 +129,28 @@ sl::Result common::ResourceTaggingForFrame::setTag(const sl::Resource* resource,
         bool writeTag = tag == kBufferTypeScalingOutputColor || tag == kBufferTypeAmbientOcclusionDenoised ||
                         tag == kBufferTypeShadowDenoised || tag == kBufferTypeSpecularHitDenoised ||
                         tag == kBufferTypeDiffuseHitDenoised || tag == kBufferTypeBackbuffer;
+        if (lifecycle == ResourceLifecycle::eValidForFrames)
+        {
+            // Host owns a ring of resources, frame based tags never outlive their frame so only tags required on present are copied below
+            frameTag.uFramesValid = lifetime ? lifetime->frameCount : ResourceLifetimeInfo::kDefaultFrameCount;
+            if (frameTag.uFramesValid == 0)
+            {
+                SL_LOG_ERROR("Tag '%s' requires at least one valid frame", sl::getBufferTypeAsStr(tag));
+                return Result::eErrorInvalidParameter;
+            }
+        }
         if (!writeTag && lifecycle != ResourceLifecycle::eValidUntilPresent)
         {
             //! Only make a copy if this tag is required by at least one loaded and supported plugin on the same
             //! viewport and with immutable life-cycle.
             //!
-            //! If tag is required on present we have to make a copy always, if tag is required on evaluate
-            //! we make a copy only if buffer is tagged as "valid only now" and this is not a local tag.
-            bool makeCopy = false;
-            {
-                std::lock_guard lock(requiredTagMutex);
-                auto requiredOnPresent =
-                    requiredTags.find({id, tag, ResourceLifecycle::eValidUntilPresent}) != requiredTags.end();
-                auto requiredOnEvaluate =
-                    requiredTags.find({id, tag, ResourceLifecycle::eValidUntilEvaluate}) != requiredTags.end();
-                makeCopy = requiredOnPresent ||
-                                (requiredOnEvaluate && lifecycle == ResourceLifecycle::eOnlyValidNow && !localTag);
-            }
+            //! If tag is required on present we have to make a copy always, including host rings since present can run
+            //! after the host moved on, if tag is required on evaluate we make a copy only if buffer is tagged as
+            //! "valid only now" and this is not a local tag.
+            auto requiredOnPresent = requiredTags.contains({id, tag, ResourceLifecycle::eValidUntilPresent});
+            auto requiredOnEvaluate = requiredTags.contains({id, tag, ResourceLifecycle::eValidUntilEvaluate});
+            bool makeCopy = requiredOnPresent ||
+                            (requiredOnEvaluate && lifecycle == ResourceLifecycle::eOnlyValidNow && !localTag);
 
             if (makeCopy)
             {
@@ -177,34 +161,15 @@ sl::Result common::ResourceTaggingForFrame::setTag(const sl::Resource* resource,
                 }
                 cmdBuffer = common::getNativeCommandBuffer(cmdBuffer);
 
-                // Actual resource to use
-                auto actualResource = (chi::Resource)resource;
-
-                // Defaults to eCopyDestination state
-                frameTag.clone =
-                    m_pPool->allocate(actualResource,
-                                       extra::format("sl.tag.{}.volatile.{}", sl::getBufferTypeAsStr(tag), id).c_str());
-
-                // Get tagged resource's state
-                chi::ResourceState state{};
-                m_pCompute->getResourceState(frameTag.res.state, state);
-                // Currently, we are not hitting this code for regular or multi view, for dlss or dlss frame gen, because we have marked our resources as eValidUntilPresent.
-                // But, this fix seems correct as the validation errors get fixed and things seem to work right.
 // ppp: patch: begin
-                // Now store clone's state for further use in SL
-                chi::ResourceState cloneState = frameTag.clone.getState();
-                m_pCompute->getNativeResourceState(cloneState, frameTag.res.state);
-                extra::ScopedTasks revTransitions;
-                chi::ResourceTransition transitions[] = {
-                    {actualResource, chi::ResourceState::eCopySource, state},
-                    {frameTag.clone, chi::ResourceState::eCopyDestination, cloneState },
-                };
+                // Clone transitions are recorded with the clone's own state, see makeVolatileCopy
+                auto copyResult = makeVolatileCopy(m_pCompute, m_pPool, cmdBuffer, resource, tag, id, ext,
+                                                   requiredOnPresent, requiredOnEvaluate, frameTag);
+                if (copyResult != Result::eOk)
+                {
+                    return copyResult;
+                }
 // ppp: patch: end
-                CHI_CHECK_RR(m_pCompute->transitionResources(cmdBuffer,
-                                                              transitions,
-                                                              (uint32_t)countof(transitions),
-                                                              &revTransitions));
-                CHI_CHECK_RR(m_pCompute->copyResource(cmdBuffer, frameTag.clone, actualResource));
 
                 // We've made a copy of the original resource and we're not doing AddRef() on the original. So set the
                 // original to nullptr - that way nobody can access it (it may become invalid at some point).
@@ -228,6 +193,15 @@ sl::Result common::ResourceTaggingForFrame::setTag(const sl::Resource* resource,
         m_pCompute->startTrackingResource(currFrameId, uid, &frameTag.res);
     }
 
+    // Tags live in per frame slots so compare with whatever was set last, usually in the previous frame
+    if (!localTag)
+    {
+        std::scoped_lock lock(m_tagHistoryMutex);
+        auto& last = m_tagHistory[uid];
+        frameTag.updateChanged(last);
+        last = frameTag;
+    }
+
 #if SL_TAG_LOG_ENABLE
     SL_LOG_VERBOSE("Resource tag set for resource %p, buffer type %s, viewport %d, frame %d",
                    sl::chi::Resource(cRes)->native,
@@ -248,90 +222,103 @@ void common::ResourceTaggingForFrame::getTag(BufferType tagType,
                                              const sl::BaseStructure** inputs,
                                              uint32_t numInputs,
                                              bool optional)
+{
+    getTags(&tagType, 1, frameId, viewportId, &res, inputs, numInputs, optional);
+}
+
+void common::ResourceTaggingForFrame::getTags(const BufferType* tagTypes,
+                                              uint32_t count,
+                                              uint32_t frameId,
+                                              uint32_t viewportId,
+                                              CommonResource* res,
+                                              const sl::BaseStructure** inputs,
+                                              uint32_t numInputs,
+                                              bool optional)
 {
     //! First look for local tags
-    if (inputs)
+    const uint64_t all = count == kMaxTagsPerRequest ? ~0ull : (1ull << count) - 1;
+    const uint64_t local = findLocalTags(tagTypes, count, res, inputs, numInputs);
+    if (local)
     {
-        std::vector<ResourceTag*> tags;
-        if (findStructs<ResourceTag>((const void**)inputs, numInputs, tags))
+        //! Keep track of what tags are requested for what viewport (unique insert)
+        //!
+        //! Note that the presence of a valid pointer to 'inputs'
+        //! indicates that we are called during the evaluate feature call.
+        for (uint32_t k = 0; k < count; k++)
         {
-            for (auto& tag : tags)
+            if (local & (1ull << k))
             {
-                if (tag->type == tagType)
-                {
-                    res.extent = tag->extent;
-                    res.res = *tag->resource;
-
-                    // Optional extensions are chained after the tag they belong to
-                    PrecisionInfo* optPi = findStruct<PrecisionInfo>(tag->next);
-                    res.pi = optPi ? *optPi : PrecisionInfo{};
-
-                    //! Keep track of what tags are requested for what viewport (unique insert)
-                    //!
-                    //! Note that the presence of a valid pointer to 'inputs'
-                    //! indicates that we are called during the evaluate feature call.
-                    std::lock_guard<std::mutex> lock(requiredTagMutex);
-                    requiredTags.insert({viewportId, tagType, ResourceLifecycle::eValidUntilEvaluate});
-
-                    return;
-                }
+                requiredTags.insert({viewportId, tagTypes[k], ResourceLifecycle::eValidUntilEvaluate});
             }
         }
     }
+    if (local == all)
+    {
+        return;
+    }
 
     //! Now let's check the global ones
-    uint64_t uid = ((uint64_t)tagType << 32) | (uint64_t)viewportId;
     {
-        auto frameAccess = this->findFrameForReading(frameId);
-        if (!frameAccess)
+        // this grabs the mutex for the frame
+        ScopedResourceTagContainerReadAccess frameAccess(getFrameSlot(frameId));
+        // do those tags have the correct frame index?
+        if (frameAccess.m_container.getFrameIndex() != frameId)
         {
             SL_LOG_INFO("SL resource tags for frame %d not set yet!", frameId);
             return;
         }
-        const auto& frameTags = frameAccess->m_container.resourceTagContainer;
-        if (auto searchTag = frameTags.find(uid); searchTag != frameTags.end())
+        for (uint32_t k = 0; k < count; k++)
         {
-            res = searchTag->second;
+            if (local & (1ull << k))
+            {
+                continue;
+            }
+            if (auto searchTag = frameAccess.m_container.findTag(tagTypes[k], viewportId))
+            {
+                res[k] = *searchTag;
 #if SL_TAG_LOG_ENABLE
-            SL_LOG_VERBOSE("Resource tag retrieved for resource %p, buffer type %s, viewport %d, frame %d",
-                            sl::chi::Resource(res)->native,
-                            sl::getBufferTypeAsStr(tagType),
-                            viewportId,
-                            frameId);
+                SL_LOG_VERBOSE("Resource tag retrieved for resource %p, buffer type %s, viewport %d, frame %d",
+                                sl::chi::Resource(res[k])->native,
+                                sl::getBufferTypeAsStr(tagTypes[k]),
+                                viewportId,
+                                frameId);
 #endif
-        }
-        else if (!optional)
-        {
-            // TODO: check if the tag is one of the required tags declared for any of the enabled features in
-            // respective common::PluginInfo
-            //  and flag an error if so.
-            SL_LOG_ERROR("Tag of buffer %s not set for frame %d, viewport %d",
-                            getBufferTypeAsStr(tagType),
-                            frameId,
-                            viewportId);
+            }
+            else if (!optional)
+            {
+                // TODO: check if the tag is one of the required tags declared for any of the enabled features in
+                // respective common::PluginInfo
+                //  and flag an error if so.
+                SL_LOG_ERROR("Tag of buffer %s not set for frame %d, viewport %d",
+                                getBufferTypeAsStr(tagTypes[k]),
+                                frameId,
+                                viewportId);
+            }
         }
     }
 
-    std::lock_guard<std::mutex> lock(requiredTagMutex);
     //! Keep track of what tags are requested for what viewport (unique insert)
     //!
     //! Note that the presence of a valid pointer to 'inputs' indicates that we are called
     //! during the evaluate feature call, otherwise tag was requested from a hook (present etc.)
-    requiredTags.insert(
-        {viewportId, tagType, inputs ? ResourceLifecycle::eValidUntilEvaluate : ResourceLifecycle::eValidUntilPresent});
+    for (uint32_t k = 0; k < count; k++)
+    {
+        if (!(local & (1ull << k)))
+        {
+            requiredTags.insert(
+                {viewportId, tagTypes[k], inputs ? ResourceLifecycle::eValidUntilEvaluate : ResourceLifecycle::eValidUntilPresent});
+        }
+    }
 }
 
 common::ResourceTaggingForFrame::~ResourceTaggingForFrame()
 {
-    {
-        std::lock_guard<std::mutex> lock(requiredTagMutex);
-        requiredTags.clear();
-    }
+    requiredTags.clear();
 
     for (uint32_t uFrame = 0; uFrame < m_frames.size(); ++uFrame)
     {
-        auto pFrame = this->findFrameForWriting(uFrame);
-        recycleTagsForFrame(*pFrame);
+        ScopedResourceTagContainerWriteAccess frameAccess(getFrameSlot(uFrame));
+        recycleTagsForFrame(frameAccess);
     }
 }
 
@@ -359,16 +346,16 @@ void common::ResourceTaggingForFrame::recycleTagsInternal(uint32_t currAppFrameI
     // start with the current app frame and go backward. if we wrap around 0 - it's fine
     for (uint32_t uOldFrame = currAppFrameId - 2; ; --uOldFrame)
     {
-        auto pFrame = this->findFrameForWriting(uOldFrame);
+        ScopedResourceTagContainerWriteAccess frameAccess(getFrameSlot(uOldFrame));
         // if that's frame index that we don't expect, this means we have either already
         // recycled this frame before, or we are now looking at a future frame
-        if (pFrame->m_container.getFrameIndex() != uOldFrame)
+        if (frameAccess.m_container.getFrameIndex() != uOldFrame)
         {
             break;
         }
-        recycleTagsForFrame(*pFrame);
+        recycleTagsForFrame(frameAccess);
         // set invalid past frame index to indicate we've recycled this
-        pFrame->m_container.setFrameIndex(uOldFrame - (uint32_t)m_frames.size());
+        frameAccess.m_container.setFrameIndex(uOldFrame - (uint32_t)m_frames.size());
     }
 }
 
@@ -383,7 +370,7 @@ void common::ResourceTaggingForFrame::recycleTagsForFrame(
         m_pCompute->stopTrackingResource(frameAccess.m_container.getFrameIndex(), it->first, &it->second.res);
 
     }
-    tags.clear();
+    frameAccess.m_container.clearTags();
 }
 
 } // namespace common
@@ -9,8 +9,47 @@ namespace common
 
 struct ProtectedResourceTagContainer
 {
+    //! Tags with buffer type and viewport id below these limits are also indexed in a flat table
+    //! so lookups on the evaluate path skip hashing, anything else is only found through the map.
+    static constexpr uint32_t kFlatBufferTypeCount = 128;
+    static constexpr uint32_t kFlatViewportCount = 4;
+
     std::unordered_map<uint64_t, CommonResource> resourceTagContainer;
-    mutable std::shared_timed_mutex resourceTagContainerMutex{};
+    mutable std::shared_mutex resourceTagContainerMutex{};
+
+    static uint64_t getTagUID(BufferType tag, uint32_t viewportId)
+    {
+        return ((uint64_t)tag << 32) | (uint64_t)viewportId;
+    }
+
+    //! Caller must hold the read or write lock
+    const CommonResource* findTag(BufferType tag, uint32_t viewportId) const
+    {
+        if (tag < kFlatBufferTypeCount && viewportId < kFlatViewportCount)
+        {
+            return m_flatTags[viewportId * kFlatBufferTypeCount + tag];
+        }
+        auto it = resourceTagContainer.find(getTagUID(tag, viewportId));
+        return it != resourceTagContainer.end() ? &it->second : nullptr;
+    }
+
+    //! Caller must hold the write lock, element references in the map are stable so the flat table can point into it
+    CommonResource& getOrCreateTag(BufferType tag, uint32_t viewportId)
+    {
+        auto& res = resourceTagContainer[getTagUID(tag, viewportId)];
+        if (tag < kFlatBufferTypeCount && viewportId < kFlatViewportCount)
+        {
+            m_flatTags[viewportId * kFlatBufferTypeCount + tag] = &res;
+        }
+        return res;
+    }
+
+    //! Caller must hold the write lock
+    void clearTags()
+    {
+        resourceTagContainer.clear();
+        m_flatTags.fill(nullptr);
+    }
 
     void setFrameIndex(uint32_t frameIndex)
     {
@@ -25,6 +64,7 @@ struct ProtectedResourceTagContainer
 
 private:
     uint32_t m_frameIndex = 0;
+    std::array<CommonResource*, kFlatBufferTypeCount * kFlatViewportCount> m_flatTags{};
 };
 
 // Forward declarations for RAII wrappers
@@ -42,6 +82,7 @@ struct ResourceTaggingForFrame : public ResourceTaggingBase
                               CommandBuffer* cmdBuffer,
                               bool localTag,
                               const PrecisionInfo* pi,
+                              const ResourceLifetimeInfo* lifetime,
                               const sl::FrameToken& frame) override final;
     virtual void getTag(BufferType tagType,
                         uint32_t frameId,
@@ -50,6 +91,14 @@ struct ResourceTaggingForFrame : public ResourceTaggingBase
                         const sl::BaseStructure** inputs,
                         uint32_t numInputs,
                         bool optional) override final;
+    virtual void getTags(const BufferType* tagTypes,
+                         uint32_t count,
+                         uint32_t frameId,
+                         uint32_t viewportId,
+                         CommonResource* res,
+                         const sl::BaseStructure** inputs,
+                         uint32_t numInputs,
+                         bool optional) override final;
 
     void recycleTags();
 
@@ -61,26 +110,27 @@ struct ResourceTaggingForFrame : public ResourceTaggingBase
     std::mutex m_recyclingMutex{};
     uint32_t m_prevSeenAppFrameIndex = 0;
 
-    std::mutex requiredTagMutex{};
-
     // frame-aware nested container of resources for each type of input resource tagged
-    std::array<ProtectedResourceTagContainer, 32> m_frames{};
+    static constexpr uint32_t kFrameSlotCount = 32;
+    static_assert((kFrameSlotCount & (kFrameSlotCount - 1)) == 0, "Frame slots are indexed with a mask");
+    std::array<ProtectedResourceTagContainer, kFrameSlotCount> m_frames{};
 
-    // Returns a RAII object with read-only access to the ProtectedResourceTagContainer for the specified frame
-    // Returns nullptr if the frame is not found
-    // TODO: change to std::optional<> when the support of VS2017 is deprecated
-    std::unique_ptr<ScopedResourceTagContainerReadAccess>
-        findFrameForReading(uint32_t frameIndex);
-
-    // Returns a RAII object with write access to the ProtectedResourceTagContainer for the specified frame
-    // Creates the container if it doesn't exist
-    // TODO: change to std::optional<> when the support of VS2017 is deprecated
-    std::unique_ptr<ScopedResourceTagContainerWriteAccess>
-        findFrameForWriting(uint32_t frameIndex);
+    // Returns the ring slot for the specified frame, wrap it in a scoped read or write access on the stack
+    // before touching it and check the frame index since the slot may hold tags for an older frame
+    ProtectedResourceTagContainer& getFrameSlot(uint32_t frameIndex)
+    {
+        return m_frames[frameIndex & (kFrameSlotCount - 1)];
+    }
 
     chi::ICompute* m_pCompute = nullptr;
     chi::IResourcePool* m_pPool = nullptr;
     sl::RenderAPI m_platform{};
+
+    //! Last tag set per uid in any frame, only used for 'CommonResource::isChanged'
+    //!
+    //! Leaf lock, taken while holding a frame slot but never the other way around.
+    std::mutex m_tagHistoryMutex{};
+    std::unordered_map<uint64_t, CommonResource> m_tagHistory{};
 };
 
 } // namespace common
@@ -0,0 +1,98 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+#include <stdint.h>
+
+namespace sl
+{
+namespace common
+{
+
+//! Latest copy of a plugin's per frame state for UI and telemetry readers
+//!
+//! Single writer publishes once per evaluate, any number of readers copy it out without locks.
+//! Two slots each with their own sequence number, the writer always fills the slot readers are not
+//! pointed at so a read only retries when the writer published twice while the copy was in flight.
+//! Keep 'T' to raw numeric fields, readers format whatever they display.
+template<typename T>
+class StatsSnapshot
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Snapshots are copied with memcpy");
+
+public:
+    //! Not thread safe with respect to other writers
+    void publish(const T& value)
+    {
+        auto next = m_published.load(std::memory_order_relaxed) + 1;
+        auto& slot = m_slots[next & 1];
+        // Odd sequence marks the slot as being written
+        auto sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        memcpy(&slot.value, &value, sizeof(T));
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+        m_published.store(next, std::memory_order_release);
+    }
+
+    //! Returns false if nothing was published yet
+    bool read(T& value) const
+    {
+        for (;;)
+        {
+            auto published = m_published.load(std::memory_order_acquire);
+            if (published == 0)
+            {
+                return false;
+            }
+            auto& slot = m_slots[published & 1];
+            auto sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence & 1)
+            {
+                continue;
+            }
+            memcpy(&value, &slot.value, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+            {
+                return true;
+            }
+        }
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence{};
+        T value{};
+    };
+
+    Slot m_slots[2]{};
+    std::atomic<uint64_t> m_published{};
+};
+
+}
+}
@@ -0,0 +1,121 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+#include <stdint.h>
+
+#include "include/sl.h"
+#include "include/sl_consts.h"
+#include "source/core/sl.log/log.h"
+#include "source/platforms/sl.chi/compute.h"
+
+namespace sl
+{
+namespace common
+{
+
+enum class TagValidationMode : uint32_t
+{
+    eOff,
+    //! Default, tags are checked when they change so validation can stay on while profiling
+    eOnChange,
+    //! Every tag on every call, including a 'getResourceDescription' round trip
+    eAlways
+};
+
+//! Checks tagged resources against their descriptions in non-production builds
+//!
+//! Results are cached per tag and viewport, a tag is checked again when its resource, extent or state changes.
+//! The host can recreate a resource at the same address so cached entries are also refreshed every 'kRevalidateFrames'.
+class TagValidator
+{
+public:
+    static constexpr uint32_t kRevalidateFrames = 300;
+
+    void setMode(TagValidationMode mode) { m_mode = mode; }
+    TagValidationMode getMode() const { return m_mode; }
+
+    void validate(chi::ICompute* compute, const sl::Resource* resource, BufferType tag, uint32_t id, const Extent& extent, uint32_t frame)
+    {
+        if (m_mode == TagValidationMode::eOff || !compute || !resource || !resource->native)
+        {
+            return;
+        }
+
+        if (m_mode == TagValidationMode::eOnChange)
+        {
+            std::scoped_lock lock(m_mutex);
+            auto& entry = m_entries[((uint64_t)tag << 32) | (uint64_t)id];
+            if (entry.native == resource->native && entry.state == resource->state && entry.extent == extent &&
+                frame - entry.frame < kRevalidateFrames)
+            {
+                return;
+            }
+            entry.native = resource->native;
+            entry.state = resource->state;
+            entry.extent = extent;
+            entry.frame = frame;
+        }
+
+        chi::ResourceDescription desc{};
+        if (compute->getResourceDescription((chi::Resource)resource, desc) != chi::ComputeStatus::eOk)
+        {
+            SL_LOG_WARN("Tag '%s' viewport %u - resource 0x%llx is not a valid texture or buffer", sl::getBufferTypeAsStr(tag), id, resource->native);
+            return;
+        }
+        if (extent && (extent.left + extent.width > desc.width || extent.top + extent.height > desc.height))
+        {
+            SL_LOG_WARN("Tag '%s' viewport %u - extent (%u,%u,%u,%u) is outside of the resource (%u,%u)", sl::getBufferTypeAsStr(tag), id,
+                extent.left, extent.top, extent.width, extent.height, desc.width, desc.height);
+        }
+        if (desc.mips == 0 || desc.width == 0 || desc.height == 0)
+        {
+            SL_LOG_WARN("Tag '%s' viewport %u - resource 0x%llx has an empty description", sl::getBufferTypeAsStr(tag), id, resource->native);
+        }
+    }
+
+    void clear()
+    {
+        std::scoped_lock lock(m_mutex);
+        m_entries.clear();
+    }
+
+private:
+    struct Entry
+    {
+        void* native{};
+        uint32_t state{};
+        Extent extent{};
+        uint32_t frame{};
+    };
+
+    TagValidationMode m_mode = TagValidationMode::eOnChange;
+    std::mutex m_mutex;
+    std::unordered_map<uint64_t, Entry> m_entries;
+};
+
+}
+}
@@ -20,6 +20,7 @@
 * SOFTWARE.
 */
 
+#include <algorithm>
 #include <sstream>
 #include <atomic>
 #include <future>
@@ -37,11 +38,16 @@
 #include "source/plugins/sl.deepdvc/versions.h"
 #include "source/plugins/sl.imgui/imgui.h"
 #include "source/plugins/sl.common/commonInterface.h"
+#include "source/plugins/sl.common/statsSnapshot.h"
 #include "external/json/include/nlohmann/json.hpp"
 #include "nvapi.h"
 
 #include "_artifacts/gitVersion.h"
 #include "_artifacts/json/deepdvc_json.h"
+#include "_artifacts/shaders/deepdvc_reuse_cs.h"
+#include "_artifacts/shaders/deepdvc_reuse_spv.h"
+#include "_artifacts/shaders/deepdvc_reproject_cs.h"
+#include "_artifacts/shaders/deepdvc_reproject_spv.h"
 
 #include "external/ngx-sdk/include/nvsdk_ngx.h"
 #include "external/ngx-sdk/include/nvsdk_ngx_helpers.h"
@@ -70,14 +76,63 @@ struct DeepDVCViewport
     uint32_t id = {};
     DeepDVCOptions consts = {};
     NVSDK_NGX_Handle* handle = {};
+
+    //! Enhancement from the last network evaluation stored as a delta from its input
+    //! 
+    //! Reprojection reads one and writes the other, 'deltaIndex' is the one holding the latest delta
+    chi::Resource delta[2] = {};
+    uint32_t deltaIndex = 0;
+    Extent deltaExtent = {};
+    bool deltaValid = false;
+    uint32_t lastEvaluatedFrame = {};
+    //! Adaptive quality, set while the cost of an evaluation is over budget
+    bool overBudget = false;
+    //! Frames between network evaluations
+    uint32_t updateInterval = 1;
+};
+
+//! Modes of 'deepdvc_reuse.hlsl'
+enum ReuseMode : uint32_t
+{
+    eReuseCapture,
+    eReuseStore,
+    eReuseApply
+};
+
+struct ReuseConsts
+{
+    uint32_t origin[2];
+    uint32_t size[2];
+    uint32_t mode;
+    uint32_t padding[3];
+};
+
+struct ReprojectConsts
+{
+    uint32_t origin[2];
+    uint32_t size[2];
+    uint32_t mvecOrigin[2];
+    uint32_t mvecSize[2];
+    float mvecScale[2];
+    uint32_t padding[2];
 };
 
+//! Upper limit for 'DeepDVCOptions::updateInterval', the enhancement lags behind too much past that
+constexpr uint32_t kMaxUpdateInterval = 4;
+//! Back to full rate once the cost per evaluation drops below this fraction of the budget
+constexpr float kAdaptiveRecoverFraction = 0.75f;
+//! Update interval used while over budget
+constexpr uint32_t kAdaptiveUpdateInterval = 2;
+
+//! Published once per evaluate, formatted by the UI only when drawn
 struct UIStats
 {
-    std::mutex mtx;
-    std::string mode{};
-    std::string viewport{};
-    std::string runtime{};
+    DeepDVCMode mode{};
+    uint32_t viewport{};
+    uint32_t width{};
+    uint32_t height{};
+    float runtimeMs{};
+    uint32_t updateInterval{};
 };
 
 struct DeepDVCContext
@@ -87,18 +142,25 @@ struct DeepDVCContext
     void onDestroyContext() {};
 
     common::PFunRegisterEvaluateCallbacks* registerEvaluateCallbacks{};
+#ifdef DEEPDVC_PRESENT_HOOK
+    common::PFunRegisterResizeCallbacks* registerResizeCallbacks{};
+#endif
 
-    common::ViewportIdFrameData<4, false> constsPerViewport = { "deepDVC" };
+    common::TypedViewportIdFrameData<DeepDVCOptions, 4, false> constsPerViewport = { "deepDVC" };
     std::map<uint32_t, DeepDVCViewport> viewports = {};
     DeepDVCViewport* currentViewport = {};
+    //! Features of viewports not evaluated for a while are released under VRAM pressure
+    common::IdleFeatureEviction idleFeatures{};
 
-    UIStats uiStats{};
+    common::StatsSnapshot<UIStats> uiStats{};
 
     // width and height for VRAM calculation
     uint32_t inputWidth{};
     uint32_t inputHeight{};
 
     chi::ICompute* compute = {};
+    chi::Kernel reuseKernel = {};
+    chi::Kernel reprojectKernel = {};
 #ifdef DEEPDVC_PRESENT_HOOK
     chi::ICommandListContext* cmdList{};
     chi::CommandQueue cmdQueue{};
@@ -161,6 +223,35 @@ static std::string JSON = std::string(deepdvc_hooks_json, &deepdvc_hooks_json[de
 static std::string JSON = std::string(deepdvc_json, &deepdvc_json[deepdvc_json_len]);
 #endif
 
+void updateEmbeddedJSON(json& config);
+
+SL_PLUGIN_DEFINE("sl.deepdvc", Version(VERSION_MAJOR, VERSION_MINOR, VERSION_PATCH), Version(0, 0, 1), JSON.c_str(), updateEmbeddedJSON, deepDVC, DeepDVCContext)
+
+#ifdef DEEPDVC_PRESENT_HOOK
+//! Present time intermediate matches the back buffer, rebuilt by sl.common together with other plugins on resize
+void deepDVCResizeRelease(const common::ResizeInfo& info)
+{
+    auto& ctx = (*deepDVC::getContext());
+    CHI_VALIDATE(ctx.compute->destroyResource(ctx.temp));
+    ctx.temp = {};
+}
+
+uint32_t deepDVCResizeDescribe(const common::ResizeInfo& info, chi::ResourceBatchEntry* entries)
+{
+    if (info.format == chi::eFormatINVALID) return 0;
+    entries[0].desc = chi::ResourceDescription(info.width, info.height, info.format, chi::HeapType::eHeapTypeDefault, chi::ResourceState::eStorageRW, chi::ResourceFlags::eShaderResourceStorage | chi::ResourceFlags::eColorAttachment);
+    entries[0].name = "sl.deepdvc.temp";
+    return 1;
+}
+
+void deepDVCResizeCommit(const common::ResizeInfo& info, const chi::ResourceBatchEntry* entries, uint32_t count)
+{
+    // Null if the batch failed, present creates it on demand then
+    auto& ctx = (*deepDVC::getContext());
+    ctx.temp = count ? entries[0].resource : nullptr;
+}
+#endif
+
 void updateEmbeddedJSON(json& config)
 {
     common::SystemCaps* caps = {};
@@ -178,10 +269,14 @@ void updateEmbeddedJSON(json& config)
         info.requiredTags = { {kBufferTypeScalingOutputColor, ResourceLifecycle::eValidUntilEvaluate} };
         updateCommonEmbeddedJSONConfig(&config, info);
     }
+    auto& ctx = (*deepDVC::getContext());
+    if (config.contains("idleFeatureReleaseFrames"))
+    {
+        ctx.idleFeatures.idleFrames = config["idleFeatureReleaseFrames"].operator uint32_t();
+    }
     // TODO: Check DeepDVC min driver version
 }
 
-SL_PLUGIN_DEFINE("sl.deepdvc", Version(VERSION_MAJOR, VERSION_MINOR, VERSION_PATCH), Version(0, 0, 1), JSON.c_str(), updateEmbeddedJSON, deepDVC, DeepDVCContext)
 
 Result slSetData(const BaseStructure* inputs, CommandBuffer* cmdBuffer)
 {
@@ -199,12 +294,96 @@ Result slSetData(const BaseStructure* inputs, CommandBuffer* cmdBuffer)
     return Result::eOk;
 }
 
+//! GPU budget and update interval only exist in version 2 options
+inline float getGPUBudgetMs(const DeepDVCOptions& options)
+{
+    return options.structVersion >= kStructVersion2 ? options.gpuBudgetMs : 0.0f;
+}
+
+inline uint32_t getUpdateInterval(const DeepDVCOptions& options)
+{
+    return options.structVersion >= kStructVersion2 ? std::clamp(options.updateInterval, 1u, deepDVC::kMaxUpdateInterval) : 1;
+}
+
+void destroyDelta(deepDVC::DeepDVCViewport& viewport)
+{
+    auto& ctx = (*deepDVC::getContext());
+    for (auto& delta : viewport.delta)
+    {
+        CHI_VALIDATE(ctx.compute->destroyResource(delta));
+        delta = {};
+    }
+    viewport.deltaValid = false;
+}
+
+void createDelta(deepDVC::DeepDVCViewport& viewport, uint32_t index, const Extent& extent)
+{
+    auto& ctx = (*deepDVC::getContext());
+    if (viewport.delta[index]) return;
+    chi::ResourceDescription desc(extent.width, extent.height, chi::eFormatRGBA16F, chi::HeapType::eHeapTypeDefault, chi::ResourceState::eStorageRW, chi::ResourceFlags::eShaderResourceStorage);
+    ctx.compute->beginVRAMSegment("sl.deepdvc");
+    CHI_VALIDATE(ctx.compute->createTexture2D(desc, viewport.delta[index], "sl.deepdvc.delta"));
+    ctx.compute->endVRAMSegment();
+}
+
+void dispatchReuse(chi::CommandList cmdList, deepDVC::DeepDVCViewport& viewport, chi::Resource color, const Extent& extent, deepDVC::ReuseMode mode)
+{
+    auto& ctx = (*deepDVC::getContext());
+    deepDVC::ReuseConsts cb{ { extent.left, extent.top }, { extent.width, extent.height }, mode };
+    CHI_VALIDATE(ctx.compute->bindSharedState(cmdList));
+    CHI_VALIDATE(ctx.compute->bindKernel(ctx.reuseKernel));
+    CHI_VALIDATE(ctx.compute->bindRWTexture(0, 0, color));
+    CHI_VALIDATE(ctx.compute->bindRWTexture(1, 1, viewport.delta[viewport.deltaIndex]));
+    // Up to two dispatches per viewport and frame
+    CHI_VALIDATE(ctx.compute->bindConsts(2, 0, &cb, sizeof(cb), common::kDefaultMaxNumViewports * 3 * 2));
+    CHI_VALIDATE(ctx.compute->dispatch((extent.width + 16 - 1) / 16, (extent.height + 16 - 1) / 16, 1));
+}
+
+//! Moves the latest delta to the current frame using motion vectors and applies it
+void dispatchReproject(chi::CommandList cmdList, deepDVC::DeepDVCViewport& viewport, chi::Resource color, const Extent& extent,
+    chi::Resource mvec, const Extent& mvecExtent, const float2& mvecScale)
+{
+    auto& ctx = (*deepDVC::getContext());
+    auto prev = viewport.deltaIndex;
+    auto next = 1 - prev;
+    deepDVC::ReprojectConsts cb{ { extent.left, extent.top }, { extent.width, extent.height },
+        { mvecExtent.left, mvecExtent.top }, { mvecExtent.width, mvecExtent.height }, { mvecScale.x, mvecScale.y } };
+    CHI_VALIDATE(ctx.compute->bindSharedState(cmdList));
+    CHI_VALIDATE(ctx.compute->bindKernel(ctx.reprojectKernel));
+    CHI_VALIDATE(ctx.compute->bindRWTexture(0, 0, color));
+    CHI_VALIDATE(ctx.compute->bindRWTexture(1, 1, viewport.delta[next]));
+    CHI_VALIDATE(ctx.compute->bindRWTexture(2, 2, viewport.delta[prev]));
+    CHI_VALIDATE(ctx.compute->bindTexture(3, 0, mvec));
+    CHI_VALIDATE(ctx.compute->bindConsts(4, 0, &cb, sizeof(cb), common::kDefaultMaxNumViewports * 3));
+    CHI_VALIDATE(ctx.compute->dispatch((extent.width + 16 - 1) / 16, (extent.height + 16 - 1) / 16, 1));
+    viewport.deltaIndex = next;
+}
+
+//! Releases the feature of the least recently evaluated viewport while over the VRAM budget, created again on its next evaluate
+void releaseIdleFeature(uint32_t frame)
+{
+    auto& ctx = (*deepDVC::getContext());
+    uint32_t id{};
+    if (!ctx.idleFeatures.pick(ctx.compute, frame, id)) return;
+
+    auto it = ctx.viewports.find(id);
+    if (it != ctx.viewports.end() && (*it).second.handle)
+    {
+        SL_LOG_INFO("Releasing deepdvc feature for viewport %u - not evaluated for %u frames while over VRAM budget", id, ctx.idleFeatures.idleFrames);
+        ctx.ngxContext->releaseFeature((*it).second.handle, "sl.deepdvc");
+        (*it).second.handle = {};
+    }
+}
+
 Result deepDVCBeginEvaluation(chi::CommandList cmdList, const common::EventData& data, const sl::BaseStructure** inputs, uint32_t numInputs)
 {
     auto& ctx = (*deepDVC::getContext());
     auto& viewport = ctx.viewports[data.id];
     viewport.id = data.id;
 
+    ctx.idleFeatures.touch(data.id, data.frame);
+    releaseIdleFeature(data.frame);
+
     // Options are set per viewport, frame index is always 0
     DeepDVCOptions* consts{};
     if (!ctx.constsPerViewport.get({ data.id, 0 }, &consts))
@@ -236,8 +415,9 @@ Result deepDVCEndEvaluation(chi::CommandList cmdList, const common::EventData& d
         return Result::eErrorInvalidParameter;
     }
 
-    const uint32_t id = ctx.currentViewport->id;
-    const DeepDVCOptions& options = ctx.currentViewport->consts;
+    auto& viewport = *ctx.currentViewport;
+    const uint32_t id = viewport.id;
+    const DeepDVCOptions& options = viewport.consts;
 
     CommonResource outColor{};
     
@@ -262,7 +442,37 @@ Result deepDVCEndEvaluation(chi::CommandList cmdList, const common::EventData& d
     ctx.inputWidth = outExtent.width;
     ctx.inputHeight = outExtent.height;
 
-    CHI_VALIDATE(ctx.compute->beginPerfSection(cmdList, "sl.deepdvc"));
+    const float budgetMs = getGPUBudgetMs(options);
+    if (budgetMs <= 0.0f)
+    {
+        viewport.overBudget = false;
+    }
+    viewport.updateInterval = std::max(getUpdateInterval(options), viewport.overBudget ? deepDVC::kAdaptiveUpdateInterval : 1u);
+    if ((viewport.updateInterval == 1 && budgetMs <= 0.0f) || !viewport.deltaExtent.isSameRes(outExtent))
+    {
+        destroyDelta(viewport);
+    }
+    if (viewport.updateInterval > 1)
+    {
+        createDelta(viewport, viewport.deltaIndex, outExtent);
+    }
+
+    // Frames in between network evaluations only apply the last enhancement
+    bool reuse = viewport.updateInterval > 1 && viewport.deltaValid && viewport.deltaExtent == outExtent &&
+        data.frame - viewport.lastEvaluatedFrame < viewport.updateInterval;
+    CommonResource mvec{};
+    sl::Constants* consts{};
+    if (reuse)
+    {
+        // Optional, without motion vectors the delta is applied in place
+        SL_CHECK(getTaggedResource(kBufferTypeMotionVectors, mvec, data.frame, id, true));
+        if (mvec && !common::getConsts(data, &consts))
+        {
+            consts = {};
+        }
+        // Camera cuts invalidate the last enhancement
+        reuse = !consts || consts->reset != Boolean::eTrue;
+    }
 
     extra::ScopedTasks revTransitions;
     chi::ResourceTransition transitions[] =
@@ -270,37 +480,94 @@ Result deepDVCEndEvaluation(chi::CommandList cmdList, const common::EventData& d
         {outColor, chi::ResourceState::eStorageRW, ctx.cachedStates[outColor]}
     };
     ctx.compute->transitionResources(cmdList, transitions, (uint32_t)countof(transitions), &revTransitions);
-    if (ctx.ngxContext)
+
+    float ms = 0;
+    if (reuse)
     {
-        if (ctx.platform == RenderAPI::eVulkan)
+        chi::Resource barriers[] = { viewport.delta[0], viewport.delta[1] };
+        CHI_VALIDATE(ctx.compute->insertGPUBarrierList(cmdList, barriers, viewport.delta[1] ? 2 : 1));
+        if (mvec && consts)
         {
-            ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Color, ctx.cachedVkResource(outColor));
+            createDelta(viewport, 1 - viewport.deltaIndex, outExtent);
+            ctx.cacheState(mvec, mvec.getState());
+            chi::ResourceTransition mvecTransitions[] =
+            {
+                {mvec, chi::ResourceState::eTextureRead, ctx.cachedStates[mvec]}
+            };
+            ctx.compute->transitionResources(cmdList, mvecTransitions, (uint32_t)countof(mvecTransitions), &revTransitions);
+
+            auto mvecExtent = mvec.getExtent();
+            if (!mvecExtent)
+            {
+                chi::ResourceDescription mvecDesc{};
+                CHI_VALIDATE(ctx.compute->getResourceDescription(mvec, mvecDesc));
+                mvecExtent = { 0, 0, mvecDesc.width, mvecDesc.height };
+            }
+            dispatchReproject(cmdList, viewport, outColor, outExtent, mvec, mvecExtent, consts->mvecScale);
         }
         else
         {
-            ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Color, (void*)outColor);
+            dispatchReuse(cmdList, viewport, outColor, outExtent, deepDVC::eReuseApply);
         }
-        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_X, outExtent.left);
-        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_Y, outExtent.top);
-        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Width, outExtent.width);
-        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Height, outExtent.height);
-        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DeepDVC_Strength, options.intensity);
-        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DeepDVC_SaturationBoost, options.saturationBoost);
-        ctx.ngxContext->evaluateFeature(cmdList, ctx.currentViewport->handle, "sl.deepdvc");
     }
+    else
+    {
+        CHI_VALIDATE(ctx.compute->beginPerfSection(cmdList, "sl.deepdvc"));
 
-    float ms = 0;
-    CHI_VALIDATE(ctx.compute->endPerfSection(cmdList, "sl.deepdvc", ms));
+        const bool keepDelta = viewport.updateInterval > 1 && viewport.delta[viewport.deltaIndex] != nullptr;
+        if (keepDelta)
+        {
+            dispatchReuse(cmdList, viewport, outColor, outExtent, deepDVC::eReuseCapture);
+            CHI_VALIDATE(ctx.compute->insertGPUBarrier(cmdList, outColor));
+        }
+        if (ctx.ngxContext)
+        {
+            if (ctx.platform == RenderAPI::eVulkan)
+            {
+                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Color, ctx.cachedVkResource(outColor));
+            }
+            else
+            {
+                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Color, (void*)outColor);
+            }
+            ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_X, outExtent.left);
+            ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_Y, outExtent.top);
+            ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Width, outExtent.width);
+            ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Height, outExtent.height);
+            ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DeepDVC_Strength, options.intensity);
+            ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DeepDVC_SaturationBoost, options.saturationBoost);
+            ctx.ngxContext->evaluateFeature(cmdList, viewport.handle, "sl.deepdvc");
+        }
+        if (keepDelta)
+        {
+            chi::Resource barriers[] = { outColor, viewport.delta[viewport.deltaIndex] };
+            CHI_VALIDATE(ctx.compute->insertGPUBarrierList(cmdList, barriers, (uint32_t)countof(barriers)));
+            dispatchReuse(cmdList, viewport, outColor, outExtent, deepDVC::eReuseStore);
+        }
+        viewport.deltaValid = keepDelta;
+        viewport.deltaExtent = outExtent;
+        viewport.lastEvaluatedFrame = data.frame;
+
+        CHI_VALIDATE(ctx.compute->endPerfSection(cmdList, "sl.deepdvc", ms));
+
+        // Mean cost of one evaluation, the per frame cost is divided by the update interval
+        if (budgetMs > 0.0f && ms > 0.0f)
+        {
+            if (ms > budgetMs)
+            {
+                viewport.overBudget = true;
+            }
+            else if (ms < budgetMs * deepDVC::kAdaptiveRecoverFraction)
+            {
+                viewport.overBudget = false;
+            }
+        }
+    }
 
     auto parameters = api::getContext()->parameters;
 
 #ifndef SL_PRODUCTION
-    {
-        std::scoped_lock lock(ctx.uiStats.mtx);
-        ctx.uiStats.mode = getDeepDVCModeAsStr(options.mode);
-        ctx.uiStats.viewport = extra::format("Viewport {}x{}", outExtent.width, outExtent.height);
-        ctx.uiStats.runtime = extra::format("Execution time {}ms", ms);
-    }
+    ctx.uiStats.publish({ options.mode, viewport.id, outExtent.width, outExtent.height, ms, viewport.updateInterval });
 #endif
 
     // Tell others that we are actually active this frame
@@ -365,10 +632,29 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
         return false;
     }
     ctx.registerEvaluateCallbacks(kFeatureDeepDVC, deepDVCBeginEvaluation, deepDVCEndEvaluation);
+#ifdef DEEPDVC_PRESENT_HOOK
+    if (param::getPointerParam(parameters, param::common::kPFunRegisterResizeCallbacks, &ctx.registerResizeCallbacks))
+    {
+        ctx.registerResizeCallbacks(kFeatureDeepDVC, deepDVCResizeRelease, deepDVCResizeDescribe, deepDVCResizeCommit);
+    }
+#endif
 
     param::getPointerParam(parameters, sl::param::common::kComputeAPI, &ctx.compute);
     ctx.compute->getRenderAPI(ctx.platform);
 
+    if (ctx.platform == RenderAPI::eVulkan)
+    {
+        CHI_CHECK_RF(ctx.compute->createKernel((void*)deepdvc_reuse_spv, deepdvc_reuse_spv_len, "deepdvc_reuse.cs", "main", ctx.reuseKernel));
+        CHI_CHECK_RF(ctx.compute->createKernel((void*)deepdvc_reproject_spv, deepdvc_reproject_spv_len, "deepdvc_reproject.cs", "main", ctx.reprojectKernel));
+    }
+    else
+    {
+        CHI_CHECK_RF(ctx.compute->createKernel((void*)deepdvc_reuse_cs, deepdvc_reuse_cs_len, "deepdvc_reuse.cs", "main", ctx.reuseKernel));
+        CHI_CHECK_RF(ctx.compute->createKernel((void*)deepdvc_reproject_cs, deepdvc_reproject_cs_len, "deepdvc_reproject.cs", "main", ctx.reprojectKernel));
+    }
+    chi::Kernel kernels[] = { ctx.reuseKernel, ctx.reprojectKernel };
+    ctx.compute->prewarmKernels(kernels, (uint32_t)countof(kernels));
+
 #ifndef SL_PRODUCTION
     // Check for UI and register our callback
     imgui::ImGUI* ui{};
@@ -379,21 +665,25 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
         auto renderUI = [&ctx](imgui::ImGUI* ui, bool finalFrame)->void
         {
             auto v = api::getContext()->pluginVersion;
-            std::scoped_lock lock(ctx.uiStats.mtx);
+            UIStats stats{};
+            bool active = ctx.uiStats.read(stats);
             uint32_t lastFrame, frame;
             if (api::getContext()->parameters->get(sl::param::deepDVC::kCurrentFrame, &lastFrame))
             {
                 ctx.compute->getFinishedFrameIndex(frame);
-                if (lastFrame < frame)
-                {
-                    ctx.uiStats.mode = "Mode: Off";
-                    ctx.uiStats.viewport = ctx.uiStats.runtime = {};
-                }
+                active &= lastFrame >= frame;
                 if (ui->collapsingHeader(extra::format("sl.deepdvc v{}", (v.toStr() + "." + GIT_LAST_COMMIT_SHORT)).c_str(), imgui::kTreeNodeFlagDefaultOpen))
                 {
-                    ui->text(ctx.uiStats.mode.c_str());
-                    ui->text(ctx.uiStats.viewport.c_str());
-                    ui->text(ctx.uiStats.runtime.c_str());
+                    if (active)
+                    {
+                        ui->text(getDeepDVCModeAsStr(stats.mode));
+                        ui->text("Viewport %ux%u", stats.width, stats.height);
+                        ui->text("Execution time %.2fms, update interval %u", stats.runtimeMs, stats.updateInterval);
+                    }
+                    else
+                    {
+                        ui->text("Mode: Off");
+                    }
                 }
             }
         };
@@ -410,6 +700,21 @@ void slOnPluginShutdown()
 {
     auto& ctx = (*deepDVC::getContext());
     ctx.registerEvaluateCallbacks(kFeatureDeepDVC, nullptr, nullptr);
+#ifdef DEEPDVC_PRESENT_HOOK
+    if (ctx.registerResizeCallbacks)
+    {
+        ctx.registerResizeCallbacks(kFeatureDeepDVC, nullptr, nullptr, nullptr);
+    }
+    CHI_VALIDATE(ctx.compute->destroyResource(ctx.temp));
+    ctx.temp = {};
+#endif
+
+    for (auto& [id, viewport] : ctx.viewports)
+    {
+        destroyDelta(viewport);
+    }
+    CHI_VALIDATE(ctx.compute->destroyKernel(ctx.reuseKernel));
+    CHI_VALIDATE(ctx.compute->destroyKernel(ctx.reprojectKernel));
 
     // it will shutdown it down automatically
     plugin::onShutdown(api::getContext());
@@ -445,6 +750,11 @@ sl::Result slDeepDVCGetState(const sl::ViewportHandle& viewport, sl::DeepDVCStat
         }
         ctx.ngxContext->params->Get(NVSDK_NGX_Parameter_SizeInBytes, &state.estimatedVRAMUsageInBytes);
     }
+    if (state.structVersion >= kStructVersion2)
+    {
+        auto it = ctx.viewports.find(viewport);
+        state.updateInterval = it != ctx.viewports.end() ? (*it).second.updateInterval : 1;
+    }
     return Result::eOk;
 }
 
@@ -490,13 +800,35 @@ HRESULT slHookPresent1(IDXGISwapChain* swapChain, UINT SyncInterval, UINT Flags,
 {
     auto& ctx = (*deepDVC::getContext());
 
+    // Host evaluates DeepDVC on an intermediate via 'slEvaluateFeature', nothing left to do at present time
+    uint32_t lastFrame = 0, frame = 0;
+    if (api::getContext()->parameters->get(sl::param::deepDVC::kCurrentFrame, &lastFrame))
+    {
+        CHI_VALIDATE(ctx.compute->getFinishedFrameIndex(frame));
+        if (lastFrame > frame)
+        {
+            return S_OK;
+        }
+    }
+
+    auto it = ctx.viewports.find(0);
+    if (it == ctx.viewports.end() || !(*it).second.handle)
+    {
+        return S_OK;
+    }
+    auto& viewport = (*it).second;
+
     //if (ctx->swapChain == swapChain)
     {
         int currentIdx = ((IDXGISwapChain3*)swapChain)->GetCurrentBackBufferIndex();
-        const DeepDVCOptions& options = ctx.currentViewport->consts;
+        const DeepDVCOptions& options = viewport.consts;
 
-        chi::Resource backBuffer;
-        ctx.compute->getSwapChainBuffer(swapChain, currentIdx, backBuffer);
+        // Owned by the swap-chain buffer cache in sl.common, must not be destroyed here
+        chi::Resource backBuffer{};
+        if (ctx.compute->getCachedSwapChainBuffer(swapChain, currentIdx, backBuffer) != chi::ComputeStatus::eOk)
+        {
+            return S_OK;
+        }
 
         chi::ResourceDescription outDesc{};
         CHI_VALIDATE(ctx.compute->getResourceDescription(backBuffer, outDesc));
@@ -507,25 +839,41 @@ HRESULT slHookPresent1(IDXGISwapChain* swapChain, UINT SyncInterval, UINT Flags,
             chi::ResourceDescription desc(outDesc.width, outDesc.height, outDesc.format, chi::HeapType::eHeapTypeDefault, chi::ResourceState::eStorageRW, chi::ResourceFlags::eShaderResourceStorage | chi::ResourceFlags::eColorAttachment);
             CHI_VALIDATE(ctx.compute->createTexture2D(desc, ctx.temp, "sl.deepdvc.temp"));
         }
-        extra::ScopedTasks revTransitions;
-        chi::ResourceTransition transitions[] =
+        // Present time work is eligible for the SL async compute queue, otherwise recorded on our own command list
+        chi::CommandList cmdList{};
+        const bool async = ctx.compute->beginAsyncCompute(ctx.cmdQueue, cmdList) == chi::ComputeStatus::eOk;
+        if (!async)
         {
-            {backBuffer, chi::ResourceState::eStorageRW, outDesc.state}
-        };
-        ctx.cmdList->beginCommandList();
-        ctx.compute->transitionResources(ctx.cmdList->getCmdList(), transitions, (uint32_t)countof(transitions), &revTransitions);
-        ctx.compute->copyResource(ctx.cmdList->getCmdList(), ctx.temp, backBuffer);
-        if (ctx.ngxContext)
+            ctx.cmdList->beginCommandList();
+            cmdList = ctx.cmdList->getCmdList();
+        }
         {
-            ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Color, (void*)ctx.temp->native);
-            ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DeepDVC_Strength, options.intensity);
-            ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DeepDVC_SaturationBoost, options.saturationBoost);
-            ctx.ngxContext->evaluateFeature(ctx.cmdList->getCmdList(), ctx.currentViewport->handle, "sl.deepdvc");
+            // Reverse transitions must be recorded before the command list is closed
+            extra::ScopedTasks revTransitions;
+            chi::ResourceTransition transitions[] =
+            {
+                {backBuffer, chi::ResourceState::eStorageRW, outDesc.state}
+            };
+            ctx.compute->transitionResources(cmdList, transitions, (uint32_t)countof(transitions), &revTransitions);
+            ctx.compute->copyResource(cmdList, ctx.temp, backBuffer);
+            if (ctx.ngxContext)
+            {
+                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Color, (void*)ctx.temp->native);
+                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DeepDVC_Strength, options.intensity);
+                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DeepDVC_SaturationBoost, options.saturationBoost);
+                ctx.ngxContext->evaluateFeature(cmdList, viewport.handle, "sl.deepdvc");
+            }
+            ctx.compute->copyResource(cmdList, backBuffer, ctx.temp);
+        }
+        // Present is queued behind our work on the same queue (or a GPU wait for async), no CPU wait needed
+        if (async)
+        {
+            CHI_VALIDATE(ctx.compute->endAsyncCompute(ctx.cmdQueue));
+        }
+        else
+        {
+            ctx.cmdList->executeCommandList();
         }
-        ctx.compute->copyResource(ctx.cmdList->getCmdList(), backBuffer, ctx.temp);
-        ctx.cmdList->executeCommandList();
-        ctx.cmdList->waitForCommandList(sl::chi::FlushType::eCurrent);
-        ctx.compute->destroyResource(backBuffer);
     }
     return S_OK;
 }
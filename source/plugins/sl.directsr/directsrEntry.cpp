@@ -27,6 +27,9 @@
 #include <chrono>
 #include <cstring>
 #include <future>
+#include <map>
+#include <mutex>
+#include <tuple>
 #include <sstream>
 #include <unordered_set>
 
@@ -43,6 +46,7 @@
 #include "source/core/sl.file/file.h"
 #include "source/core/sl.extra/extra.h"
 #include "source/core/sl.param/parameters.h"
+#include "source/platforms/sl.chi/compute.h"
 #include "external/json/include/nlohmann/json.hpp"
 
 #include "source/plugins/sl.common/commonInterface.h"
@@ -64,6 +68,269 @@ sl::Result slDirectSRGetOptimalSettings(const sl::DirectSROptions& options, sl::
 namespace directsr
 {
 
+//! Parameters an engine is created with, engines are shared by all viewports using the same ones
+struct DirectSREngineKey
+{
+    uint32_t variantIndex{};
+    DSR_SUPERRES_CREATE_ENGINE_FLAGS flags{};
+    DXGI_FORMAT targetFormat{};
+    DXGI_FORMAT sourceColorFormat{};
+    DXGI_FORMAT sourceDepthFormat{};
+    DXGI_FORMAT exposureScaleFormat{};
+    uint32_t targetWidth{};
+    uint32_t targetHeight{};
+    uint32_t maxSourceWidth{};
+    uint32_t maxSourceHeight{};
+
+    auto tie() const
+    {
+        return std::tie(variantIndex, flags, targetFormat, sourceColorFormat, sourceDepthFormat, exposureScaleFormat,
+            targetWidth, targetHeight, maxSourceWidth, maxSourceHeight);
+    }
+    bool operator<(const DirectSREngineKey& rhs) const { return tie() < rhs.tie(); }
+    bool operator==(const DirectSREngineKey& rhs) const { return tie() == rhs.tie(); }
+};
+
+//! Engines created ahead of time by 'slDirectSRPrewarm' or on first use
+//! 
+//! Creation runs on a worker thread so prewarming never blocks the caller, engines not referenced by
+//! an upscaler are dropped least recently used first once there are more than 'kMaxEngines'
+class DirectSREngineCache
+{
+    using Engine = Microsoft::WRL::ComPtr<IDSRSuperResEngine>;
+    struct Entry
+    {
+        std::shared_future<Engine> engine;
+        uint64_t lastUsed{};
+    };
+    static constexpr size_t kMaxEngines = 8;
+
+    std::mutex m_mutex;
+    std::map<DirectSREngineKey, Entry> m_entries;
+    uint64_t m_tick{};
+
+    static Engine createEngine(Microsoft::WRL::ComPtr<IDSRDevice> device, DirectSREngineKey key)
+    {
+        DSR_SUPERRES_VARIANT_DESC desc;
+        HRESULT res = device->GetSuperResVariantDesc(key.variantIndex, &desc);
+        if (res != S_OK)
+        {
+            SL_LOG_ERROR("Failed to get variant desc: %x", res);
+            return {};
+        }
+
+        DSR_SUPERRES_CREATE_ENGINE_PARAMETERS createParams{};
+        createParams.VariantId = desc.VariantId;
+        createParams.Flags = key.flags;
+        createParams.TargetFormat = key.targetFormat;
+        createParams.SourceColorFormat = key.sourceColorFormat;
+        createParams.SourceDepthFormat = key.sourceDepthFormat;
+        createParams.ExposureScaleFormat = key.exposureScaleFormat;
+        createParams.TargetSize.Width = key.targetWidth;
+        createParams.TargetSize.Height = key.targetHeight;
+        createParams.MaxSourceSize.Width = key.maxSourceWidth;
+        createParams.MaxSourceSize.Height = key.maxSourceHeight;
+
+        Engine engine;
+        res = device->CreateSuperResEngine(&createParams, __uuidof(IDSRSuperResEngine), &engine);
+        if (res != S_OK)
+        {
+            SL_LOG_ERROR("CreateSuperResEngine failed %x", res);
+            return {};
+        }
+        SL_LOG_INFO("Created DirectSR engine variant %u (%ux%u) formats %u/%u/%u", key.variantIndex, key.targetWidth, key.targetHeight,
+            key.targetFormat, key.sourceColorFormat, key.sourceDepthFormat);
+        return engine;
+    }
+
+    void trim()
+    {
+        while (m_entries.size() > kMaxEngines)
+        {
+            auto oldest = m_entries.end();
+            for (auto it = m_entries.begin(); it != m_entries.end(); it++)
+            {
+                // Pending creations are never dropped, destroying their future would block
+                bool ready = (*it).second.engine.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                if (ready && (oldest == m_entries.end() || (*it).second.lastUsed < (*oldest).second.lastUsed))
+                {
+                    oldest = it;
+                }
+            }
+            if (oldest == m_entries.end())
+            {
+                break;
+            }
+            m_entries.erase(oldest);
+        }
+    }
+
+public:
+    //! Starts creating the engine unless it exists or is being created already, failed creations are retried
+    std::shared_future<Engine> request(Microsoft::WRL::ComPtr<IDSRDevice> device, const DirectSREngineKey& key)
+    {
+        std::scoped_lock lock(m_mutex);
+        auto& entry = m_entries[key];
+        entry.lastUsed = ++m_tick;
+        auto engine = entry.engine;
+        if (engine.valid() && engine.wait_for(std::chrono::seconds(0)) == std::future_status::ready && !engine.get())
+        {
+            engine = {};
+        }
+        if (!engine.valid())
+        {
+            engine = std::async(std::launch::async, createEngine, device, key).share();
+            entry.engine = engine;
+            trim();
+        }
+        return engine;
+    }
+
+    void clear()
+    {
+        std::scoped_lock lock(m_mutex);
+        for (auto& [key, entry] : m_entries)
+        {
+            entry.engine.wait();
+        }
+        m_entries.clear();
+    }
+};
+
+//! Engine flags and maximal source size for the given options, formats and jitter mode
+DirectSREngineKey makeEngineKey(const DirectSROptions& options, bool mvecJittered, DXGI_FORMAT targetFormat,
+    DXGI_FORMAT sourceColorFormat, DXGI_FORMAT sourceDepthFormat, DXGI_FORMAT exposureScaleFormat)
+{
+    DirectSREngineKey key{};
+    key.variantIndex = options.variantIndex;
+
+    key.flags = DSR_SUPERRES_CREATE_ENGINE_FLAG_NONE;
+
+    // XXX[ljm] force auto exposure for now
+    if (true)
+    {
+        key.flags |= DSR_SUPERRES_CREATE_ENGINE_FLAG_AUTO_EXPOSURE;
+    }
+
+    key.flags |= DSR_SUPERRES_CREATE_ENGINE_FLAG_ALLOW_DRS;
+
+    if (mvecJittered)
+    {
+        key.flags |= DSR_SUPERRES_CREATE_ENGINE_FLAG_MOTION_VECTORS_USE_JITTER_OFFSETS;
+    }
+
+    key.flags |= DSR_SUPERRES_CREATE_ENGINE_FLAG_ALLOW_SUBRECT_OUTPUT;
+
+    if (options.colorBuffersHDR == Boolean::eFalse)
+    {
+        key.flags |= DSR_SUPERRES_CREATE_ENGINE_FLAG_FORCE_LDR_COLORS;
+    }
+
+    key.targetFormat = targetFormat;
+    key.sourceColorFormat = sourceColorFormat;
+    key.sourceDepthFormat = sourceDepthFormat;
+    key.exposureScaleFormat = exposureScaleFormat;
+
+    // XXX[ljm] do more depth-type coaslescing here
+    if (key.sourceDepthFormat == DXGI_FORMAT_R24G8_TYPELESS)
+    {
+        key.sourceDepthFormat = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+    }
+
+    key.targetWidth = options.outputWidth;
+    key.targetHeight = options.outputHeight;
+
+    sl::DirectSROptimalSettings settings;
+    sl::slDirectSRGetOptimalSettings(options, settings);
+    key.maxSourceWidth = settings.renderWidthMax;
+    key.maxSourceHeight = settings.renderHeightMax;
+    return key;
+}
+
+//! SL owned compute queue shared by all viewports using 'DirectSROptions::useAsyncCompute'
+//! 
+//! DirectSR submits to the queue its upscaler was created with so synchronization with the host
+//! queue is done with a pair of fences around each execute.
+struct DirectSRAsyncQueue
+{
+    chi::ICompute* compute{};
+    chi::ChiCommandQueue* queue{};
+    chi::Fence hostFence{};
+    chi::Fence computeFence{};
+    uint64_t hostValue{};
+    uint64_t computeValue{};
+    std::mutex mutex;
+
+    //! Creates the queue on first use, returns null if that failed
+    ID3D12CommandQueue* get()
+    {
+        std::scoped_lock lock(mutex);
+        if (!queue && compute)
+        {
+            if (compute->createCommandQueue(chi::CommandQueueType::eCompute, queue, "sl.directsr.asyncComputeQueue") != chi::ComputeStatus::eOk ||
+                compute->createFence(chi::eFenceFlagsNone, 0, hostFence, "sl.directsr.asyncComputeHostFence") != chi::ComputeStatus::eOk ||
+                compute->createFence(chi::eFenceFlagsNone, 0, computeFence, "sl.directsr.asyncComputeFence") != chi::ComputeStatus::eOk)
+            {
+                destroyNoLock();
+                compute = nullptr;
+                SL_LOG_WARN("Failed to create DirectSR async compute queue, using the host queue");
+            }
+        }
+        return (ID3D12CommandQueue*)queue;
+    }
+
+    //! Makes our queue wait for everything submitted to the host queue so far
+    bool begin(ID3D12CommandQueue* hostQueue)
+    {
+        std::scoped_lock lock(mutex);
+        hostValue++;
+        if (FAILED(hostQueue->Signal((ID3D12Fence*)hostFence, hostValue)) ||
+            FAILED(((ID3D12CommandQueue*)queue)->Wait((ID3D12Fence*)hostFence, hostValue)))
+        {
+            SL_LOG_ERROR("Failed to synchronize DirectSR async compute queue with the host queue");
+            return false;
+        }
+        return true;
+    }
+
+    //! Host work submitted from now on consumes the upscaled output so it has to wait
+    bool end(ID3D12CommandQueue* hostQueue)
+    {
+        std::scoped_lock lock(mutex);
+        computeValue++;
+        if (FAILED(((ID3D12CommandQueue*)queue)->Signal((ID3D12Fence*)computeFence, computeValue)) ||
+            FAILED(hostQueue->Wait((ID3D12Fence*)computeFence, computeValue)))
+        {
+            SL_LOG_ERROR("Failed to synchronize the host queue with DirectSR async compute queue");
+            return false;
+        }
+        return true;
+    }
+
+    void destroy()
+    {
+        std::scoped_lock lock(mutex);
+        destroyNoLock();
+    }
+
+private:
+    void destroyNoLock()
+    {
+        if (!compute) return;
+        if (computeFence)
+        {
+            // Upscaler work must finish before the queue goes away
+            compute->waitCPUFence(computeFence, computeValue);
+        }
+        compute->destroyFence(hostFence);
+        compute->destroyFence(computeFence);
+        compute->destroyCommandQueue(queue);
+        hostFence = {};
+        computeFence = {};
+        queue = {};
+    }
+};
+
 class DirectSRInstance
 {
     private:
@@ -71,20 +338,47 @@ class DirectSRInstance
 
     Microsoft::WRL::ComPtr<IDSRSuperResEngine> m_pDsrEngine;
     Microsoft::WRL::ComPtr<IDSRSuperResUpscaler> m_pDsrUpscaler;
-    bool m_needsRecreate;
+    //! Queue the upscaler submits to, either the host queue or the SL owned compute queue
+    ID3D12CommandQueue* m_pUpscalerQueue{};
+    //! Set when the variant failed to create an upscaler on a compute queue
+    bool m_asyncUnsupported{};
+    bool m_needsRecreate = true;
     std::chrono::time_point<std::chrono::high_resolution_clock> m_lastExecuteTime;
 
+    //! Engine the upscaler was created from
+    DirectSREngineKey m_engineKey{};
+    //! Tagged resources and jitter mode seen last frame, formats are only queried when a tag changes
+    ID3D12Resource* m_pLastTarget{};
+    ID3D12Resource* m_pLastSourceColor{};
+    ID3D12Resource* m_pLastSourceDepth{};
+    DXGI_FORMAT m_targetFormat{};
+    DXGI_FORMAT m_sourceColorFormat{};
+    DXGI_FORMAT m_sourceDepthFormat{};
+    bool m_mvecJittered{};
+
     public:
     uint32_t id;
     DirectSROptions m_options;
 
     DirectSRInstance(uint32_t id) : id(id) {}
 
+    bool wantsAsyncCompute() const
+    {
+        return m_options.structVersion >= kStructVersion2 && m_options.useAsyncCompute == Boolean::eTrue && !m_asyncUnsupported;
+    }
+
     sl::Result setOptions(Microsoft::WRL::ComPtr<IDSRDevice> pDsrDevice,
                           const DirectSROptions *options)
     {
+        bool useAsyncCompute = options->structVersion >= kStructVersion2 && options->useAsyncCompute == Boolean::eTrue;
+        bool usedAsyncCompute = m_options.structVersion >= kStructVersion2 && m_options.useAsyncCompute == Boolean::eTrue;
+        if (options->variantIndex != m_options.variantIndex)
+        {
+            m_asyncUnsupported = false;
+        }
         // If options that require a re-creation are changed
-        if (options->pCommandQueue != m_options.pCommandQueue ||
+        if (useAsyncCompute != usedAsyncCompute ||
+            options->pCommandQueue != m_options.pCommandQueue ||
             options->outputWidth != m_options.outputWidth ||
             options->outputHeight != m_options.outputHeight ||
             options->colorBuffersHDR != m_options.colorBuffersHDR ||
@@ -98,97 +392,86 @@ class DirectSRInstance
         return sl::Result::eOk;
     }
 
-    sl::Result prepareUpscalerEngine(const bool mvecJittered,
-                                     const DXGI_FORMAT targetFormat,
-                                     const DXGI_FORMAT sourceColorFormat,
-                                     const DXGI_FORMAT sourceDepthFormat,
+    sl::Result prepareUpscalerEngine(DirectSREngineCache& engines,
+                                     DirectSRAsyncQueue& asyncQueue,
+                                     const bool mvecJittered,
+                                     ID3D12Resource* pTargetTexture,
+                                     ID3D12Resource* pSourceColorTexture,
+                                     ID3D12Resource* pSourceDepthTexture,
                                      const DXGI_FORMAT exposureScaleFormat)
     {
-        HRESULT res = S_OK;
-
-        if (!m_needsRecreate)
+        if (!m_needsRecreate && mvecJittered == m_mvecJittered && pTargetTexture == m_pLastTarget &&
+            pSourceColorTexture == m_pLastSourceColor && pSourceDepthTexture == m_pLastSourceDepth)
         {
             return sl::Result::eOk;
         }
         m_needsRecreate = false;
-
-        DSR_SUPERRES_CREATE_ENGINE_PARAMETERS createParams;
-
-        // Find the variant to use
+        m_mvecJittered = mvecJittered;
+        if (pTargetTexture != m_pLastTarget)
         {
-            DSR_SUPERRES_VARIANT_DESC desc;
-            res = m_pDsrDevice->GetSuperResVariantDesc(m_options.variantIndex, &desc);
-            if (res != S_OK)
-            {
-                SL_LOG_ERROR("Failed to get variant desc: %x", res);
-                return sl::Result::eErrorD3DAPI;
-            }
-            createParams.VariantId = desc.VariantId;
+            m_pLastTarget = pTargetTexture;
+            m_targetFormat = pTargetTexture->GetDesc().Format;
         }
-
-        createParams.Flags = DSR_SUPERRES_CREATE_ENGINE_FLAG_NONE;
-
-        // XXX[ljm] force auto exposure for now
-        if (true)
+        if (pSourceColorTexture != m_pLastSourceColor)
         {
-            createParams.Flags |= DSR_SUPERRES_CREATE_ENGINE_FLAG_AUTO_EXPOSURE;
+            m_pLastSourceColor = pSourceColorTexture;
+            m_sourceColorFormat = pSourceColorTexture->GetDesc().Format;
         }
-
-        createParams.Flags |= DSR_SUPERRES_CREATE_ENGINE_FLAG_ALLOW_DRS;
-
-        if (mvecJittered)
+        if (pSourceDepthTexture != m_pLastSourceDepth)
         {
-            createParams.Flags |= DSR_SUPERRES_CREATE_ENGINE_FLAG_MOTION_VECTORS_USE_JITTER_OFFSETS;
+            m_pLastSourceDepth = pSourceDepthTexture;
+            m_sourceDepthFormat = pSourceDepthTexture->GetDesc().Format;
         }
 
-        createParams.Flags |= DSR_SUPERRES_CREATE_ENGINE_FLAG_ALLOW_SUBRECT_OUTPUT;
-
-        if (m_options.colorBuffersHDR == Boolean::eFalse)
+        auto key = makeEngineKey(m_options, mvecJittered, m_targetFormat, m_sourceColorFormat, m_sourceDepthFormat, exposureScaleFormat);
+        ID3D12CommandQueue* queue = wantsAsyncCompute() ? asyncQueue.get() : nullptr;
+        if (!queue)
         {
-            createParams.Flags |= DSR_SUPERRES_CREATE_ENGINE_FLAG_FORCE_LDR_COLORS;
+            queue = m_options.pCommandQueue;
         }
-
-        createParams.TargetFormat = targetFormat;
-        createParams.SourceColorFormat = sourceColorFormat;
-        createParams.SourceDepthFormat = sourceDepthFormat;
-        createParams.ExposureScaleFormat = exposureScaleFormat;
-
-        // XXX[ljm] do more depth-type coaslescing here
-        if (createParams.SourceDepthFormat == DXGI_FORMAT_R24G8_TYPELESS)
+        if (m_pDsrUpscaler && key == m_engineKey && queue == m_pUpscalerQueue)
         {
-            createParams.SourceDepthFormat = DXGI_FORMAT_R24_UNORM_X8_TYPELESS;
+            // New resources with the same formats, upscaler is still valid
+            return sl::Result::eOk;
         }
 
-        createParams.TargetSize.Width = m_options.outputWidth;
-        createParams.TargetSize.Height = m_options.outputHeight;
-
-        sl::DirectSROptimalSettings settings;
-        sl::slDirectSRGetOptimalSettings(m_options, settings);
-        createParams.MaxSourceSize.Width = settings.renderWidthMax;
-        createParams.MaxSourceSize.Height = settings.renderHeightMax;
-        res = m_pDsrDevice->CreateSuperResEngine(&createParams,
-                                               __uuidof(IDSRSuperResEngine),
-                                               &m_pDsrEngine);
-        if (res != S_OK)
+        // Only blocks if the engine was not prewarmed or its creation is still in flight
+        auto engine = engines.request(m_pDsrDevice, key).get();
+        if (!engine)
         {
-            SL_LOG_ERROR("CreateSuperResEngine failed %x", res);
+            // Retried next frame
+            m_needsRecreate = true;
             return sl::Result::eErrorD3DAPI;
         }
+        m_pDsrEngine = engine;
+        m_pDsrUpscaler.Reset();
 
-        res = m_pDsrEngine->CreateUpscaler(m_options.pCommandQueue,
-                                           __uuidof(IDSRSuperResUpscaler),
-                                           &m_pDsrUpscaler);
+        HRESULT res = m_pDsrEngine->CreateUpscaler(queue,
+                                                   __uuidof(IDSRSuperResUpscaler),
+                                                   &m_pDsrUpscaler);
+        if (res != S_OK && queue != m_options.pCommandQueue)
+        {
+            // Not every variant can run on a compute queue, don't try again until the variant changes
+            SL_LOG_WARN("CreateUpscaler on async compute queue failed %x, using the host queue", res);
+            m_asyncUnsupported = true;
+            queue = m_options.pCommandQueue;
+            res = m_pDsrEngine->CreateUpscaler(queue, __uuidof(IDSRSuperResUpscaler), &m_pDsrUpscaler);
+        }
         if (res != S_OK)
         {
             SL_LOG_ERROR("CreateUpscaler failed %x", res);
+            m_needsRecreate = true;
             return sl::Result::eErrorD3DAPI;
         }
+        m_engineKey = key;
+        m_pUpscalerQueue = queue;
 
-        SL_LOG_INFO("Upscaler engine prepared: %p", m_pDsrUpscaler);
+        SL_LOG_INFO("Upscaler engine prepared: %p (%s queue)", m_pDsrUpscaler, queue == m_options.pCommandQueue ? "host" : "async compute");
         return sl::Result::eOk;
     }
 
-    sl::Result evaluate(bool resetHistory,
+    sl::Result evaluate(DirectSRAsyncQueue& asyncQueue,
+                        bool resetHistory,
                         DSR_FLOAT2 mvecScale,
                         DSR_FLOAT2 jitterOffset,
                         float cameraNear,
@@ -203,6 +486,12 @@ class DirectSRInstance
                         ID3D12Resource *pMotionVectorsTexture,
                         D3D12_RECT      motionVectorsRegion)
     {
+        if (!m_pDsrUpscaler)
+        {
+            // Engine creation failed in the begin event, error already logged
+            return sl::Result::eErrorInvalidState;
+        }
+
         DSR_SUPERRES_UPSCALER_EXECUTE_FLAGS flags = DSR_SUPERRES_UPSCALER_EXECUTE_FLAG_NONE;
         if (resetHistory)
         {
@@ -230,6 +519,12 @@ class DirectSRInstance
         dsrExec.CameraFar = cameraFar;
         dsrExec.CameraFovAngleVert = cameraFOV;
 
+        bool async = m_pUpscalerQueue != m_options.pCommandQueue;
+        if (async && !asyncQueue.begin(m_options.pCommandQueue))
+        {
+            return sl::Result::eErrorD3DAPI;
+        }
+
         HRESULT res = S_OK;
         std::chrono::time_point<std::chrono::high_resolution_clock> executeTime =
             std::chrono::high_resolution_clock::now();
@@ -240,6 +535,11 @@ class DirectSRInstance
         {
             SL_LOG_ERROR("upscaler->Execute failed %x", res);
         }
+        // Always signal so the host queue never waits on a value that was skipped
+        if (async && !asyncQueue.end(m_options.pCommandQueue))
+        {
+            return sl::Result::eErrorD3DAPI;
+        }
         return sl::Result::eOk;
     }
 };
@@ -264,6 +564,8 @@ struct DirectSRContext
     std::map<uint32_t, DirectSRInstance*> viewports = {};
     Microsoft::WRL::ComPtr<ID3D12DSRDeviceFactory> dsrFactory;
     Microsoft::WRL::ComPtr<IDSRDevice> dsrDevice;
+    DirectSREngineCache engines;
+    DirectSRAsyncQueue asyncQueue;
     HMODULE hD3D12{};
 };
 }
@@ -323,10 +625,12 @@ sl::Result directsrBegin(chi::CommandList pCmdList, const common::EventData &dat
     SL_CHECK(getTaggedResource(kBufferTypeScalingInputColor, colorIn, data.frame, data.id, false, inputs, numInputs));
     SL_CHECK(getTaggedResource(kBufferTypeDepth, depth, data.frame, data.id, false, inputs, numInputs));
 
-    return viewport->prepareUpscalerEngine(commonConsts->motionVectorsJittered == Boolean::eTrue,
-                                           ((ID3D12Resource*)(void*)colorOut)->GetDesc().Format,
-                                           ((ID3D12Resource*)(void*)colorIn)->GetDesc().Format,
-                                           ((ID3D12Resource*)(void*)depth)->GetDesc().Format,
+    return viewport->prepareUpscalerEngine(ctx.engines,
+                                           ctx.asyncQueue,
+                                           commonConsts->motionVectorsJittered == Boolean::eTrue,
+                                           (ID3D12Resource*)(void*)colorOut,
+                                           (ID3D12Resource*)(void*)colorIn,
+                                           (ID3D12Resource*)(void*)depth,
                                            DXGI_FORMAT_UNKNOWN
                                            );
 }
@@ -371,7 +675,8 @@ sl::Result directsrEnd(chi::CommandList pCmdList, const common::EventData &data,
     jitterOffset.X = commonConsts->jitterOffset.x;
     jitterOffset.Y = commonConsts->jitterOffset.y;
 
-    return viewport->evaluate(commonConsts->reset == sl::Boolean::eTrue,
+    return viewport->evaluate(ctx.asyncQueue,
+                              commonConsts->reset == sl::Boolean::eTrue,
                               mvecScale,
                               jitterOffset,
                               commonConsts->cameraNear,
@@ -468,10 +773,40 @@ sl::Result slDirectSRSetOptions(const sl::ViewportHandle& viewport, const sl::Di
     return Result::eOk;
 }
 
+sl::Result slDirectSRPrewarm(const sl::DirectSRPrewarmInfo* infos, uint32_t count)
+{
+    auto& ctx = (*directsr::getContext());
+    if (!infos && count)
+    {
+        return Result::eErrorMissingInputParameter;
+    }
+    if (!ctx.dsrDevice)
+    {
+        return Result::eErrorNotInitialized;
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto& info = infos[i];
+        if (info.targetFormat == DXGI_FORMAT_UNKNOWN || info.sourceColorFormat == DXGI_FORMAT_UNKNOWN || info.sourceDepthFormat == DXGI_FORMAT_UNKNOWN)
+        {
+            SL_LOG_ERROR("DirectSR prewarm info %u is missing formats", i);
+            return Result::eErrorInvalidParameter;
+        }
+        // Same exposure format as evaluate, auto exposure is always used
+        auto key = directsr::makeEngineKey(info.options, info.motionVectorsJittered == Boolean::eTrue,
+            info.targetFormat, info.sourceColorFormat, info.sourceDepthFormat, DXGI_FORMAT_UNKNOWN);
+        ctx.engines.request(ctx.dsrDevice, key);
+    }
+    return Result::eOk;
+}
+
 static void freePluginGlobalState()
 {
     auto& ctx = (*directsr::getContext());
 
+    // Waits for engines still being created
+    ctx.engines.clear();
+    ctx.asyncQueue.destroy();
     if (ctx.dsrDevice != nullptr)
     {
         ctx.dsrDevice.Reset();
@@ -572,6 +907,9 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
 
     ctx.registerEvaluateCallbacks(kFeatureDirectSR, directsrBegin, directsrEnd);
 
+    // Only needed for the optional async compute queue
+    param::getPointerParam(parameters, sl::param::common::kComputeAPI, &ctx.asyncQueue.compute);
+
     return true;
 
 fail:
@@ -611,6 +949,7 @@ SL_EXPORT void *slGetPluginFunction(const char *functionName)
     SL_EXPORT_FUNCTION(slDirectSRGetOptimalSettings);
     SL_EXPORT_FUNCTION(slDirectSRGetVariantInfo);
     SL_EXPORT_FUNCTION(slDirectSRSetOptions);
+    SL_EXPORT_FUNCTION(slDirectSRPrewarm);
 
     return nullptr;
 }
@@ -41,6 +41,7 @@
 
 #include "source/platforms/sl.chi/vulkan.h"
 #include "source/plugins/sl.common/commonInterface.h"
+#include "source/plugins/sl.common/statsSnapshot.h"
 #include "source/plugins/sl.dlss/versions.h"
 #include "source/plugins/sl.imgui/imgui.h"
 #include "source/plugins/sl.dlss/dlss_shared.h"
@@ -49,6 +50,10 @@
 
 #include "_artifacts/shaders/mvec_cs.h"
 #include "_artifacts/shaders/mvec_spv.h"
+#include "_artifacts/shaders/mvec_dilate_cs.h"
+#include "_artifacts/shaders/mvec_dilate_spv.h"
+#include "_artifacts/shaders/mvec_sm66_cs.h"
+#include "_artifacts/shaders/mvec_dilate_sm66_cs.h"
 #include "_artifacts/json/dlss_json.h"
 #include "_artifacts/gitVersion.h"
 
@@ -68,6 +73,27 @@ using funNGXCreate = NVSDK_NGX_Result(*)(ID3D12GraphicsCommandList *InCmdList, N
 using funNGXRelease = NVSDK_NGX_Result(*)(NVSDK_NGX_Handle *InHandle);
 using funNGXEval = NVSDK_NGX_Result(*)(ID3D12GraphicsCommandList *InCmdList, const NVSDK_NGX_Handle *InHandle, const NVSDK_NGX_Parameter *InParameters, PFN_NVSDK_NGX_ProgressCallback InCallback);
 
+//! Everything a DLSS feature is created with, features are interchangeable only if all of it matches
+struct DLSSFeatureKey
+{
+    uint32_t renderWidth{};
+    uint32_t renderHeight{};
+    uint32_t outputWidth{};
+    uint32_t outputHeight{};
+    int createFlags{};
+    NVSDK_NGX_PerfQuality_Value perfQuality{};
+    //! DLAA, quality, balanced, performance and ultra performance presets
+    DLSSPreset presets[5]{};
+
+    bool operator==(const DLSSFeatureKey& rhs) const = default;
+};
+
+//! Feature created in the background, its VRAM cost is measured on the render thread when it is swapped in
+struct DLSSCreatedFeature
+{
+    NVSDK_NGX_Handle* handle{};
+};
+
 struct DLSSViewport
 {
     uint32_t id = {};
@@ -78,18 +104,53 @@ struct DLSSViewport
     sl::chi::Resource output;
     float2 inputTexelSize;
 
+    //! Options the current (or pending) feature was requested with
+    DLSSOptions createdConsts{};
+    //! Creation parameters and VRAM cost of the current feature
+    DLSSFeatureKey key{};
+    uint64_t bytes{};
+    //! Replacement feature created in the background, current handle keeps evaluating until it is ready
+    std::future<DLSSCreatedFeature> pendingHandle;
+    DLSSFeatureKey pendingKey{};
+    uint64_t pendingBaseBytes{};
+    //! Evaluation parameters, only changed values are set on each evaluate
+    common::NGXParameterCache* evalParams{};
+    //! Jitter of the last evaluate, jitter is removed from motion vectors when we compute camera motion
+    float2 prevJitterOffset{};
+    //! GPU timing section for this viewport, reported via 'slGetData' with the state struct
+    std::string perfSection{};
+
     // Note: since SR can have multiple viewports, we can never know which one is the "main" one
     // so sharing data across plugins is tricky without the app telling us
     // Maybe we should ask for it?
 };
 
+//! Picks the render size per viewport to hit the host's target frame time, see 'updateDynamicResolution'
+struct DLSSDynamicResolution
+{
+    DLSSDynamicResolutionOptions options{};
+    //! Host provided a new frame time since the last update
+    bool newSample = false;
+    //! Smoothed frame time and integral term of the controller
+    float frameTimeMS{};
+    float integral{};
+    //! Fraction of the maximal render area currently recommended
+    float areaScale = 1.0f;
+    uint32_t renderWidth{};
+    uint32_t renderHeight{};
+};
+
+//! Published once per evaluate, formatted by the UI only when drawn
 struct UIStats
 {
-    std::mutex mtx{};
-    std::string mode{};
-    std::string viewport{};
-    std::string runtime{};
-    std::string vram{};
+    DLSSMode mode{};
+    uint32_t viewport{};
+    uint32_t renderWidth{};
+    uint32_t renderHeight{};
+    uint32_t outputWidth{};
+    uint32_t outputHeight{};
+    float runtimeMs{};
+    uint64_t vramBytes{};
 };
 
 namespace dlss
@@ -104,27 +165,56 @@ struct DLSSContext
 
     Constants* commonConsts{};
 
-    UIStats uiStats{};
+    common::StatsSnapshot<UIStats> uiStats{};
 
     uint32_t adapterMask{};
 
     common::NGXContext* ngxContext = {};
     sl::chi::ICompute* compute;
+
+    //! Background feature (re)creation, see 'createFeatureInBackground'
+    sl::chi::ChiCommandQueue* createQueue{};
+    sl::chi::ICommandListContext* createCmdList{};
+    std::mutex createMutex{};
+    bool backgroundCreateFailed = false;
+    //! NGX is not thread safe, background creation runs while the render thread evaluates and queries stats
+    std::mutex ngxMutex{};
+    //! Background creations which no longer match their viewport, released once done, see 'discardPendingFeature'
+    std::vector<std::future<DLSSCreatedFeature>> discardedFeatures;
+
+    //! Features not in use, see 'slDLSSPrewarm'
+    //!
+    //! Opt-in, retired features are released right away unless the host called 'slDLSSPrewarm'
+    //! or the plugin JSON sets "featureCacheBudgetMB" or "featureCacheMaxCount".
+    common::NGXFeatureCache<DLSSFeatureKey> featureCache{ "sl.dlss" };
+    //! Features of viewports not evaluated for a while are released under VRAM pressure
+    common::IdleFeatureEviction idleFeatures{};
 #ifdef SL_CAPTURE
     sl::chi::ICapture* capture;
 #endif
     sl::chi::Kernel mvecKernel;
+    sl::chi::Kernel mvecDilateKernel;
 
 #ifndef SL_PRODUCTION
     std::string ngxVersion{};
 #endif
 
     common::PFunRegisterEvaluateCallbacks* registerEvaluateCallbacks{};
-    common::ViewportIdFrameData<4, false> constsPerViewport = { "dlss" };
+    //! One bit per pixel written by 'mvec_dilate.hlsl' is transient, all viewports share a scratch buffer sized for the largest one
+    common::PFunAcquireScratch* acquireScratch{};
+    common::PFunBeginScratchPass* beginScratchPass{};
+    common::PFunReleaseScratch* releaseScratch{};
+    uint32_t mvecInvalidMaskBytes{};
+    common::TypedViewportIdFrameData<DLSSOptions, 4, false> constsPerViewport = { "dlss" };
     std::map<void*, chi::ResourceState> cachedStates = {};
     std::map<void*, NVSDK_NGX_Resource_VK> cachedVkResources = {};
     std::map<uint32_t, DLSSViewport> viewports = {};
+    //! From 'PreferencesViewports', sizes per frame constant storage
+    uint32_t maxNumViewports = common::kDefaultMaxNumViewports;
     DLSSViewport* viewport = {};
+    //! Set by the host thread, updated on evaluate
+    std::mutex dynamicResolutionMutex{};
+    std::map<uint32_t, DLSSDynamicResolution> dynamicResolution = {};
 
     RenderAPI platform;
 
@@ -175,8 +265,6 @@ struct DLSSContext
 };
 }
 
-constexpr uint32_t kMaxNumViewports = 4;
-
 static std::string JSON = std::string(dlss_json, &dlss_json[dlss_json_len]);
 
 void updateEmbeddedJSON(json& config);
@@ -217,6 +305,20 @@ void updateEmbeddedJSON(json& config)
 
     auto& ctx = (*dlss::getContext());
     ctx.adapterMask = config.contains("supportedAdapters") ? config["supportedAdapters"].operator uint32_t() : 0;
+    if (config.contains("featureCacheBudgetMB"))
+    {
+        ctx.featureCache.budgetBytes = config["featureCacheBudgetMB"].operator uint64_t() * 1024 * 1024;
+        ctx.featureCache.enabled = true;
+    }
+    if (config.contains("featureCacheMaxCount"))
+    {
+        ctx.featureCache.maxCount = config["featureCacheMaxCount"].operator uint32_t();
+        ctx.featureCache.enabled = true;
+    }
+    if (config.contains("idleFeatureReleaseFrames"))
+    {
+        ctx.idleFeatures.idleFrames = config["idleFeatureReleaseFrames"].operator uint32_t();
+    }
 
     if (caps && ctx.adapterMask)
     {
@@ -253,7 +355,7 @@ void updateEmbeddedJSON(json& config)
 
             config["external"]["vk"]["device"]["1.2_features"] = { "timelineSemaphore", "descriptorIndexing", "bufferDeviceAddress" };
 
-            config["external"]["feature"]["viewport"]["maxCount"] = kMaxNumViewports;
+            config["external"]["feature"]["viewport"]["maxCount"] = common::getMaxNumViewports();
 
             // Version
             config["external"]["version"]["sl"] = extra::format("{}.{}.{}", SL_VERSION_MAJOR, SL_VERSION_MINOR, SL_VERSION_PATCH);
@@ -290,11 +392,29 @@ Result slSetData(const BaseStructure* inputs, CommandBuffer* cmdBuffer)
 
     ctx.constsPerViewport.set(0, *viewport, consts);
 
-    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_DLAA, (uint32_t)consts->dlaaPreset);
-    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_Quality, (uint32_t)consts->qualityPreset);
-    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_Balanced, (uint32_t)consts->balancedPreset);
-    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_Performance, (uint32_t)consts->performancePreset);
-    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_UltraPerformance, (uint32_t)consts->ultraPerformancePreset);
+    if (auto dynamicResolution = findStruct<DLSSDynamicResolutionOptions>(inputs))
+    {
+        std::scoped_lock lock(ctx.dynamicResolutionMutex);
+        if (dynamicResolution->targetFrameTimeMS > 0.0f)
+        {
+            auto& controller = ctx.dynamicResolution[*viewport];
+            controller.options = *dynamicResolution;
+            controller.newSample = dynamicResolution->frameTimeMS > 0.0f;
+        }
+        else
+        {
+            ctx.dynamicResolution.erase(*viewport);
+        }
+    }
+
+    {
+        std::scoped_lock lock(ctx.ngxMutex);
+        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_DLAA, (uint32_t)consts->dlaaPreset);
+        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_Quality, (uint32_t)consts->qualityPreset);
+        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_Balanced, (uint32_t)consts->balancedPreset);
+        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_Performance, (uint32_t)consts->performancePreset);
+        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_UltraPerformance, (uint32_t)consts->ultraPerformancePreset);
+    }
 
     // NOTE: Nothing to do here when mode is set to off.
     // 
@@ -304,6 +424,283 @@ Result slSetData(const BaseStructure* inputs, CommandBuffer* cmdBuffer)
     return Result::eOk;
 }
 
+int getCreateFlags(const DLSSOptions& consts, const Constants* commonConsts, bool autoExposure, bool mvecLowRes)
+{
+    int dlssCreateFlags = mvecLowRes ? NVSDK_NGX_DLSS_Feature_Flags_MVLowRes : 0;
+    if (consts.colorBuffersHDR == Boolean::eTrue)
+    {
+        dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_IsHDR;
+    }
+    if (consts.sharpness > 0.0f)
+    {
+        dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_DoSharpening;
+    }
+    if (commonConsts && commonConsts->depthInverted == Boolean::eTrue)
+    {
+        dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_DepthInverted;
+    }
+    // Motion vectors are unjittered by our 'mvec' pass when we compute camera motion
+    if (commonConsts && commonConsts->motionVectorsJittered == Boolean::eTrue && commonConsts->cameraMotionIncluded != Boolean::eFalse)
+    {
+        dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_MVJittered;
+    }
+    if (consts.structVersion >= kStructVersion3 && consts.alphaUpscalingEnabled == Boolean::eTrue)
+    {
+        dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_AlphaUpscaling;
+    }
+    if ((consts.structVersion >= sl::kStructVersion2 && consts.useAutoExposure) || autoExposure)
+    {
+        dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_AutoExposure;
+    }
+    return dlssCreateFlags;
+}
+
+DLSSFeatureKey getFeatureKey(const DLSSOptions& consts, const DLSSOptimalSettings& settings, int createFlags)
+{
+    return { settings.optimalRenderWidth, settings.optimalRenderHeight, consts.outputWidth, consts.outputHeight, createFlags,
+        (NVSDK_NGX_PerfQuality_Value)((uint32_t)consts.mode - 1),
+        { consts.dlaaPreset, consts.qualityPreset, consts.balancedPreset, consts.performancePreset, consts.ultraPerformancePreset } };
+}
+
+void setCreateParameters(NVSDK_NGX_Parameter* params, const DLSSFeatureKey& key)
+{
+    params->Set(NVSDK_NGX_Parameter_CreationNodeMask, 1);
+    params->Set(NVSDK_NGX_Parameter_VisibilityNodeMask, 1);
+    params->Set(NVSDK_NGX_Parameter_Width, key.renderWidth);
+    params->Set(NVSDK_NGX_Parameter_Height, key.renderHeight);
+    params->Set(NVSDK_NGX_Parameter_OutWidth, key.outputWidth);
+    params->Set(NVSDK_NGX_Parameter_OutHeight, key.outputHeight);
+    params->Set(NVSDK_NGX_Parameter_PerfQualityValue, key.perfQuality);
+    params->Set(NVSDK_NGX_Parameter_DLSS_Feature_Create_Flags, key.createFlags);
+    params->Set(NVSDK_NGX_Parameter_FreeMemOnReleaseFeature, 1);
+    params->Set(NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_DLAA, (uint32_t)key.presets[0]);
+    params->Set(NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_Quality, (uint32_t)key.presets[1]);
+    params->Set(NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_Balanced, (uint32_t)key.presets[2]);
+    params->Set(NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_Performance, (uint32_t)key.presets[3]);
+    params->Set(NVSDK_NGX_Parameter_DLSS_Hint_Render_Preset_UltraPerformance, (uint32_t)key.presets[4]);
+}
+
+//! VRAM allocated by DLSS for all features, NGX allocates it on its own so SL's VRAM segments never see it
+//!
+//! Zero if the installed snippet does not report it, the cache then relies on its count limit only.
+//! Uses the shared parameters so render thread only.
+uint64_t getNGXAllocatedBytes()
+{
+    auto& ctx = (*dlss::getContext());
+    std::scoped_lock lock(ctx.ngxMutex);
+    unsigned long long bytes{};
+    if (NVSDK_NGX_FAILED(NGX_DLSS_GET_STATS(ctx.ngxContext->params, &bytes)))
+    {
+        return 0;
+    }
+    return bytes;
+}
+
+//! Creates a feature on the host command list with the shared parameters, returns its VRAM cost
+bool createFeature(chi::CommandList cmdList, const DLSSFeatureKey& key, NVSDK_NGX_Handle*& handle, uint64_t& bytes)
+{
+    auto& ctx = (*dlss::getContext());
+    auto before = getNGXAllocatedBytes();
+    {
+        std::scoped_lock lock(ctx.ngxMutex);
+        setCreateParameters(ctx.ngxContext->params, key);
+        if (!ctx.ngxContext->createFeature(cmdList, NVSDK_NGX_Feature_SuperSampling, &handle, "sl.dlss"))
+        {
+            return false;
+        }
+    }
+    auto after = getNGXAllocatedBytes();
+    bytes = after > before ? after - before : 0;
+    return true;
+}
+
+//! Moves the current feature of the viewport to the cache so switching back is instant, releases it if the cache is off
+void retireFeature(DLSSViewport& viewport)
+{
+    auto& ctx = (*dlss::getContext());
+    ctx.featureCache.retire(ctx.ngxContext, viewport.id, viewport.key, viewport.handle, viewport.bytes);
+    viewport.handle = {};
+    viewport.bytes = {};
+    ctx.compute->destroyResource(viewport.mvec);
+    viewport.mvec = nullptr;
+}
+
+//! Background creation can not be cancelled, its result is released once it is done instead of waiting for it
+void discardPendingFeature(DLSSViewport& viewport)
+{
+    auto& ctx = (*dlss::getContext());
+    if (viewport.pendingHandle.valid())
+    {
+        ctx.discardedFeatures.push_back(std::move(viewport.pendingHandle));
+    }
+}
+
+//! Only blocks when 'wait' is set, which is for shutdown
+void releaseDiscardedFeatures(bool wait)
+{
+    auto& ctx = (*dlss::getContext());
+    auto it = ctx.discardedFeatures.begin();
+    while (it != ctx.discardedFeatures.end())
+    {
+        if (!wait && (*it).wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            it++;
+            continue;
+        }
+        if (auto handle = (*it).get().handle)
+        {
+            ctx.ngxContext->releaseFeature(handle, "sl.dlss");
+        }
+        it = ctx.discardedFeatures.erase(it);
+    }
+}
+
+//! Releases the feature of the least recently evaluated viewport while over the VRAM budget
+//! 
+//! Viewport keeps its options, the feature is created again on its next evaluate
+void releaseIdleFeature(uint32_t frame)
+{
+    auto& ctx = (*dlss::getContext());
+    uint32_t id{};
+    if (!ctx.idleFeatures.pick(ctx.compute, frame, id)) return;
+
+    auto it = ctx.viewports.find(id);
+    if (it == ctx.viewports.end()) return;
+    auto& viewport = (*it).second;
+    discardPendingFeature(viewport);
+    ctx.featureCache.release(ctx.ngxContext, id);
+    if (viewport.handle)
+    {
+        SL_LOG_INFO("Releasing DLSSContext feature for viewport %u (%.2fMB) - not evaluated for %u frames while over VRAM budget", id, viewport.bytes / (1024.0 * 1024.0), ctx.idleFeatures.idleFrames);
+        ctx.ngxContext->releaseFeature(viewport.handle, "sl.dlss");
+        viewport.handle = {};
+        viewport.bytes = {};
+    }
+    ctx.compute->destroyResource(viewport.mvec);
+    viewport.mvec = nullptr;
+}
+
+//! Creates a feature on our own command list and waits for it to finish initializing on the GPU
+//!
+//! Runs on a worker thread, uses a private parameter block since the shared one is used for evaluation
+DLSSCreatedFeature createFeatureInBackground(DLSSFeatureKey key, uint32_t id)
+{
+    auto& ctx = (*dlss::getContext());
+
+    // Creations share the command list so only one at a time
+    std::scoped_lock lock(ctx.createMutex);
+
+    DLSSCreatedFeature feature{};
+    bool created{};
+    {
+        // Not held while waiting for the GPU below so the render thread keeps evaluating
+        std::scoped_lock ngxLock(ctx.ngxMutex);
+        auto params = ctx.ngxContext->allocateParameters();
+        if (!params)
+        {
+            return {};
+        }
+        setCreateParameters(params, key);
+        ctx.createCmdList->beginCommandList();
+        created = ctx.ngxContext->createFeatureWithParameters(ctx.createCmdList->getCmdList(), NVSDK_NGX_Feature_SuperSampling, params, &feature.handle, "sl.dlss");
+        ctx.ngxContext->destroyParameters(params);
+    }
+    ctx.createCmdList->executeCommandList();
+    // Handle is used on the host queues right after the swap, initialization must be done by then
+    ctx.createCmdList->waitForCommandList(sl::chi::FlushType::eCurrent);
+
+    if (!created)
+    {
+        SL_LOG_WARN("Failed to create DLSSContext feature in the background for viewport %u", id);
+        return {};
+    }
+    return feature;
+}
+
+//! Background creation is possible if the current feature can keep evaluating with the new options
+bool canCreateInBackground(const DLSSViewport& viewport, const DLSSOptions& consts)
+{
+    auto& ctx = (*dlss::getContext());
+    if (!viewport.handle || !ctx.ngxContext->createFeatureWithParameters || ctx.backgroundCreateFailed)
+    {
+        return false;
+    }
+    // Output size is fixed at creation, input can shrink (same as dynamic resolution) but not grow
+    return viewport.key.outputWidth == consts.outputWidth && viewport.key.outputHeight == consts.outputHeight &&
+        viewport.settings.optimalRenderWidth <= viewport.key.renderWidth && viewport.settings.optimalRenderHeight <= viewport.key.renderHeight;
+}
+
+//! Adjusts the recommended render size towards the target frame time
+//! 
+//! Cost of everything but DLSS is assumed to scale with the number of rendered pixels, DLSS itself depends mostly on
+//! the output size so its measured GPU time is taken out of the budget. Size stays within the dynamic range of the
+//! current feature, going above the size it was created with would require a new feature.
+void updateDynamicResolution(DLSSDynamicResolution& controller, const DLSSViewport& viewport, float dlssTimeMS)
+{
+    constexpr float kSmoothing = 0.25f;
+    constexpr float kProportionalGain = 0.5f;
+    constexpr float kIntegralGain = 0.05f;
+    constexpr float kDeadband = 0.02f;
+    constexpr float kMaxStep = 0.1f;
+
+    auto maxWidth = viewport.settings.renderWidthMax ? std::min(viewport.settings.renderWidthMax, viewport.key.renderWidth) : viewport.key.renderWidth;
+    auto maxHeight = viewport.settings.renderHeightMax ? std::min(viewport.settings.renderHeightMax, viewport.key.renderHeight) : viewport.key.renderHeight;
+    auto minWidth = std::clamp(viewport.settings.renderWidthMin, 1u, std::max(maxWidth, 1u));
+    auto minHeight = std::clamp(viewport.settings.renderHeightMin, 1u, std::max(maxHeight, 1u));
+    if (!maxWidth || !maxHeight)
+    {
+        return;
+    }
+
+    auto minScale = float(minWidth * minHeight) / float(maxWidth * maxHeight);
+    if (controller.newSample)
+    {
+        controller.newSample = false;
+        auto frameTimeMS = controller.options.frameTimeMS;
+        controller.frameTimeMS = controller.frameTimeMS > 0.0f ? controller.frameTimeMS + (frameTimeMS - controller.frameTimeMS) * kSmoothing : frameTimeMS;
+
+        auto renderTimeMS = std::max(controller.frameTimeMS - dlssTimeMS, 0.1f);
+        auto budgetMS = std::max(controller.options.targetFrameTimeMS - dlssTimeMS, 0.1f);
+        auto error = budgetMS / renderTimeMS - 1.0f;
+        // Deadband avoids hunting around the target, no integral wind-up while pinned at either end of the range
+        if (std::abs(error) > kDeadband)
+        {
+            bool saturated = (controller.areaScale >= 1.0f && error > 0.0f) || (controller.areaScale <= minScale && error < 0.0f);
+            controller.integral = saturated ? 0.0f : std::clamp(controller.integral + error * kIntegralGain, -kMaxStep, kMaxStep);
+            controller.areaScale *= 1.0f + std::clamp(error * kProportionalGain + controller.integral, -kMaxStep, kMaxStep);
+        }
+    }
+    controller.areaScale = std::clamp(controller.areaScale, minScale, 1.0f);
+
+    auto axisScale = std::sqrt(controller.areaScale);
+    controller.renderWidth = std::clamp((uint32_t)(maxWidth * axisScale + 0.5f), minWidth, maxWidth);
+    controller.renderHeight = std::clamp((uint32_t)(maxHeight * axisScale + 0.5f), minHeight, maxHeight);
+}
+
+//! Replaces the current feature with the one created in the background
+void swapPendingHandle(DLSSViewport& viewport)
+{
+    auto& ctx = (*dlss::getContext());
+    auto feature = viewport.pendingHandle.get();
+    if (!feature.handle)
+    {
+        // Recreate the usual way from now on, forcing a mismatch so it happens next frame
+        ctx.backgroundCreateFailed = true;
+        viewport.createdConsts = {};
+        return;
+    }
+    // Approximate, anything else DLSS allocated since the request is counted too
+    auto bytes = getNGXAllocatedBytes();
+    retireFeature(viewport);
+    viewport.handle = feature.handle;
+    viewport.bytes = bytes > viewport.pendingBaseBytes ? bytes - viewport.pendingBaseBytes : 0;
+    viewport.key = viewport.pendingKey;
+    ctx.commonConsts->reset = Boolean::eTrue;
+    ctx.cachedStates.clear();
+    SL_LOG_INFO("Switched to DLSSContext feature created in the background (%u,%u)(optimal) -> (%u,%u) for viewport %u", viewport.key.renderWidth, viewport.key.renderHeight,
+        viewport.key.outputWidth, viewport.key.outputHeight, viewport.id);
+}
+
 Result dlssBeginEvent(chi::CommandList pCmdList, const common::EventData& data, const sl::BaseStructure** inputs, uint32_t numInputs)
 {
     auto parameters = api::getContext()->parameters;
@@ -322,16 +719,22 @@ Result dlssBeginEvent(chi::CommandList pCmdList, const common::EventData& data,
     if (it == ctx.viewports.end())
     {
         ctx.viewports[data.id] = {};
+        // DLSS only samples the depth plane, volatile depth copies can skip the stencil
+        setTagClonePolicy({ data.id, kBufferTypeDepth, ResourceLifecycle::eValidUntilEvaluate }, TagClonePolicy::eDepthOnly);
     }
     
-    if (ctx.viewports.size() > (size_t)kMaxNumViewports)
+    if (ctx.viewports.size() > (size_t)ctx.maxNumViewports)
     {
-        SL_LOG_WARN("Exceeded max number (%u) of allowed viewports for DLSS", kMaxNumViewports);
+        SL_LOG_WARN_ONCE("Exceeded max number (%u) of allowed viewports for DLSS, please raise 'PreferencesViewports::maxNumViewports'", ctx.maxNumViewports);
     }
 
     auto& viewport = ctx.viewports[data.id];
     viewport.id = data.id;
 
+    ctx.idleFeatures.touch(data.id, data.frame);
+    releaseIdleFeature(data.frame);
+    releaseDiscardedFeatures(false);
+
     // Our options are per viewport, frame index is just 0 always
     DLSSOptions* consts{};
     if (!ctx.constsPerViewport.get({ data.id, 0 }, &consts))
@@ -347,77 +750,56 @@ Result dlssBeginEvent(chi::CommandList pCmdList, const common::EventData& data,
         return Result::eErrorInvalidIntegration;
     }
 
-    // Must check here, before we overwrite viewport.consts
-    bool modeOrSizeOrPresetChanged = consts->mode != viewport.consts.mode || consts->outputWidth != viewport.consts.outputWidth || consts->outputHeight != viewport.consts.outputHeight
-        || consts->dlaaPreset != viewport.consts.dlaaPreset
-        || consts->qualityPreset  != viewport.consts.qualityPreset 
-        || consts->balancedPreset  != viewport.consts.balancedPreset 
-        || consts->performancePreset  != viewport.consts.performancePreset 
-        || consts->ultraPerformancePreset  != viewport.consts.ultraPerformancePreset;
+    // Pick up the replacement feature if it finished creating in the background
+    if (viewport.pendingHandle.valid() && viewport.pendingHandle.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        swapPendingHandle(viewport);
+    }
+
+    // Compared with what the feature was created with, options can change again while a replacement is being created
+    bool modeOrSizeOrPresetChanged = consts->mode != viewport.createdConsts.mode || consts->outputWidth != viewport.createdConsts.outputWidth || consts->outputHeight != viewport.createdConsts.outputHeight
+        || consts->dlaaPreset != viewport.createdConsts.dlaaPreset
+        || consts->qualityPreset  != viewport.createdConsts.qualityPreset 
+        || consts->balancedPreset  != viewport.createdConsts.balancedPreset 
+        || consts->performancePreset  != viewport.createdConsts.performancePreset 
+        || consts->ultraPerformancePreset  != viewport.createdConsts.ultraPerformancePreset;
 
     ctx.viewport = &viewport;
     viewport.consts = *consts;  // mandatory
 
-    if(!viewport.handle || modeOrSizeOrPresetChanged)
+    // Replacement being created was requested with the options which just changed, it would be swapped in at the wrong size or mode
+    if (modeOrSizeOrPresetChanged && viewport.pendingHandle.valid())
+    {
+        SL_LOG_INFO("Discarding DLSSContext feature (%u,%u)(optimal) -> (%u,%u) created in the background for viewport %u, options changed again", viewport.pendingKey.renderWidth,
+            viewport.pendingKey.renderHeight, viewport.pendingKey.outputWidth, viewport.pendingKey.outputHeight, data.id);
+        discardPendingFeature(viewport);
+    }
+
+    if((!viewport.handle || modeOrSizeOrPresetChanged) && !viewport.pendingHandle.valid())
     {
-        ctx.commonConsts->reset = Boolean::eTrue;
-        ctx.cachedStates.clear();
         slGetData(consts, &viewport.settings, pCmdList);
+        bool createAsync = ctx.ngxContext && canCreateInBackground(viewport, *consts);
+        if (!createAsync)
+        {
+            ctx.commonConsts->reset = Boolean::eTrue;
+            ctx.cachedStates.clear();
+        }
 
         if(ctx.ngxContext)
         {
-            if (viewport.handle)
-            {
-                SL_LOG_INFO("Detected resize, recreating DLSSContext feature");
-                // Errors logged by sl.common
-                ctx.ngxContext->releaseFeature(viewport.handle, "sl.dlss");
-                viewport.handle = {};
-                ctx.compute->destroyResource(viewport.mvec);
-                viewport.mvec = nullptr;
-            }
-
             {
-                int dlssCreateFlags = NVSDK_NGX_DLSS_Feature_Flags_MVLowRes;
-                if (consts->colorBuffersHDR == Boolean::eTrue)
-                {
-                    dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_IsHDR;
-                }
-                if (consts->sharpness > 0.0f)
-                {
-                    dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_DoSharpening;
-                }
-                if (ctx.commonConsts->depthInverted == Boolean::eTrue)
-                {
-                    dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_DepthInverted;
-                }
-                if (ctx.commonConsts->motionVectorsJittered == Boolean::eTrue)
-                {
-                    dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_MVJittered;
-                }
-                if (consts->structVersion >= kStructVersion3 && consts->alphaUpscalingEnabled == Boolean::eTrue)
-                {
-                    dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_AlphaUpscaling;
-                }
-
                 // Optional
                 CommonResource exposure = {};
                 getTaggedResource(kBufferTypeExposure, exposure, data.frame, ctx.viewport->id, true, inputs, numInputs);
 
-                if ((ctx.viewport->consts.structVersion >= sl::kStructVersion2 && ctx.viewport->consts.useAutoExposure) || !exposure)
-                {
-                    dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_AutoExposure;
-                }
-
                 // Mandatory
-                CommonResource colorIn{};
-                CommonResource colorOut{};
-                CommonResource depth{};
-                CommonResource mvec{};
-
-                SL_CHECK(getTaggedResource(kBufferTypeScalingInputColor, colorIn, data.frame, ctx.viewport->id, false, inputs, numInputs));
-                SL_CHECK(getTaggedResource(kBufferTypeScalingOutputColor, colorOut, data.frame, ctx.viewport->id, false, inputs, numInputs));
-                SL_CHECK(getTaggedResource(kBufferTypeDepth, depth, data.frame, ctx.viewport->id, false, inputs, numInputs));
-                SL_CHECK(getTaggedResource(kBufferTypeMotionVectors, mvec, data.frame, ctx.viewport->id, false, inputs, numInputs));
+                const BufferType mandatoryTags[] = { kBufferTypeScalingInputColor, kBufferTypeScalingOutputColor, kBufferTypeDepth, kBufferTypeMotionVectors };
+                CommonResource mandatory[countof(mandatoryTags)]{};
+                SL_CHECK(getTaggedResources(mandatoryTags, (uint32_t)countof(mandatoryTags), mandatory, data.frame, ctx.viewport->id, false, inputs, numInputs));
+                auto& colorIn = mandatory[0];
+                auto& colorOut = mandatory[1];
+                auto& depth = mandatory[2];
+                auto& mvec = mandatory[3];
 
                 auto colorInExt = colorIn.getExtent();
                 auto colorOutExt = colorOut.getExtent();
@@ -451,24 +833,53 @@ Result dlssBeginEvent(chi::CommandList pCmdList, const common::EventData& data,
                     depthExt = { 0,0,desc.width,desc.height };
                 }
 
+                bool mvecLowRes = true;
                 if (mvecExt.width > colorInExt.width || mvecExt.height > colorInExt.height)
                 {
                     SL_LOG_INFO("Detected high resolution mvec for DLSSContext");
-                    dlssCreateFlags &= ~NVSDK_NGX_DLSS_Feature_Flags_MVLowRes;
+                    mvecLowRes = false;
+                }
+
+                auto key = getFeatureKey(viewport.consts, viewport.settings, getCreateFlags(viewport.consts, ctx.commonConsts, !exposure, mvecLowRes));
+                viewport.createdConsts = viewport.consts;
+
+                // Prewarmed or used before with exactly the same parameters
+                uint64_t cachedBytes{};
+                if (auto cached = ctx.featureCache.take(data.id, key, cachedBytes))
+                {
+                    SL_LOG_INFO("Using cached DLSSContext feature (%u,%u)(optimal) -> (%u,%u) for viewport %u", key.renderWidth, key.renderHeight, key.outputWidth, key.outputHeight, data.id);
+                    retireFeature(viewport);
+                    viewport.handle = cached;
+                    viewport.bytes = cachedBytes;
+                    viewport.key = key;
+                    ctx.commonConsts->reset = Boolean::eTrue;
+                    ctx.cachedStates.clear();
+                    return Result::eOk;
                 }
 
-                NVSDK_NGX_PerfQuality_Value perfQualityValue = (NVSDK_NGX_PerfQuality_Value)((uint32_t)viewport.consts.mode - 1);
-
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_CreationNodeMask, 1);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_VisibilityNodeMask, 1);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Width, viewport.settings.optimalRenderWidth);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Height, viewport.settings.optimalRenderHeight);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_OutWidth, viewport.consts.outputWidth);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_OutHeight, viewport.consts.outputHeight);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_PerfQualityValue, perfQualityValue);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Feature_Create_Flags, dlssCreateFlags);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_FreeMemOnReleaseFeature, 1);
-                if (ctx.ngxContext->createFeature(pCmdList, NVSDK_NGX_Feature_SuperSampling, &viewport.handle, "sl.dlss"))
+                if (createAsync)
+                {
+                    if (!ctx.createCmdList)
+                    {
+                        CHI_VALIDATE(ctx.compute->createCommandQueue(chi::CommandQueueType::eGraphics, ctx.createQueue, "sl.dlss.create"));
+                        CHI_VALIDATE(ctx.compute->createCommandListContext(ctx.createQueue, 1, ctx.createCmdList, "sl.dlss.create"));
+                    }
+                    // Keep evaluating with the current feature meanwhile, it supports the new input size
+                    SL_LOG_INFO("Recreating DLSSContext feature in the background for viewport %u", data.id);
+                    viewport.pendingKey = key;
+                    viewport.pendingBaseBytes = getNGXAllocatedBytes();
+                    viewport.pendingHandle = std::async(std::launch::async, createFeatureInBackground, key, data.id);
+                    return Result::eOk;
+                }
+
+                if (viewport.handle)
+                {
+                    SL_LOG_INFO("Detected resize, recreating DLSSContext feature");
+                    retireFeature(viewport);
+                }
+
+                viewport.key = key;
+                if (createFeature(pCmdList, key, viewport.handle, viewport.bytes))
                 {
                     SL_LOG_INFO("Created DLSSContext feature (%u,%u)(optimal) -> (%u,%u) for viewport %u", viewport.settings.optimalRenderWidth, viewport.settings.optimalRenderHeight, viewport.consts.outputWidth, viewport.consts.outputHeight, data.id);
                     // Log the extent information for easier debugging
@@ -493,32 +904,27 @@ Result dlssEndEvent(chi::CommandList pCmdList, const common::EventData& data, co
         Constants* consts = ctx.commonConsts;
         
         {
-            CommonResource colorIn{};
-            CommonResource colorOut{};
-            CommonResource depth{};
-            CommonResource mvec{};
-            CommonResource transparency{};
-            CommonResource exposure{};
-            CommonResource animTexture{};
-            CommonResource mvecReflections{};
-            CommonResource rayTraceDist{};
-            CommonResource currentColorBias{};
-            CommonResource particleMask{};
-
             // Mandatory
-            SL_CHECK(getTaggedResource(kBufferTypeScalingInputColor, colorIn, data.frame, ctx.viewport->id, false, inputs, numInputs));
-            SL_CHECK(getTaggedResource(kBufferTypeScalingOutputColor, colorOut, data.frame, ctx.viewport->id, false, inputs, numInputs));
-            SL_CHECK(getTaggedResource(kBufferTypeDepth, depth, data.frame, ctx.viewport->id, false, inputs, numInputs));
-            SL_CHECK(getTaggedResource(kBufferTypeMotionVectors, mvec, data.frame, ctx.viewport->id, false, inputs, numInputs));
+            const BufferType mandatoryTags[] = { kBufferTypeScalingInputColor, kBufferTypeScalingOutputColor, kBufferTypeDepth, kBufferTypeMotionVectors };
+            CommonResource mandatory[countof(mandatoryTags)]{};
+            SL_CHECK(getTaggedResources(mandatoryTags, (uint32_t)countof(mandatoryTags), mandatory, data.frame, ctx.viewport->id, false, inputs, numInputs));
+            auto& colorIn = mandatory[0];
+            auto& colorOut = mandatory[1];
+            auto& depth = mandatory[2];
+            auto& mvec = mandatory[3];
 
             // Optional
-            getTaggedResource(kBufferTypeTransparencyHint, transparency, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeExposure, exposure, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeAnimatedTextureHint, animTexture, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeReflectionMotionVectors, mvecReflections, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeRaytracingDistance, rayTraceDist, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeBiasCurrentColorHint, currentColorBias, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeParticleHint, particleMask, data.frame, ctx.viewport->id, true, inputs, numInputs);
+            const BufferType optionalTags[] = { kBufferTypeTransparencyHint, kBufferTypeExposure, kBufferTypeAnimatedTextureHint, kBufferTypeReflectionMotionVectors,
+                                                kBufferTypeRaytracingDistance, kBufferTypeBiasCurrentColorHint, kBufferTypeParticleHint };
+            CommonResource optionalRes[countof(optionalTags)]{};
+            getTaggedResources(optionalTags, (uint32_t)countof(optionalTags), optionalRes, data.frame, ctx.viewport->id, true, inputs, numInputs);
+            auto& transparency = optionalRes[0];
+            auto& exposure = optionalRes[1];
+            auto& animTexture = optionalRes[2];
+            auto& mvecReflections = optionalRes[3];
+            auto& rayTraceDist = optionalRes[4];
+            auto& currentColorBias = optionalRes[5];
+            auto& particleMask = optionalRes[6];
 
             if (!depth || !mvec || !colorIn || !colorOut)
             {
@@ -568,9 +974,16 @@ Result dlssEndEvent(chi::CommandList pCmdList, const common::EventData& data, co
             // Depending if camera motion is provided or not we can use input directly or not
             auto mvecIn = mvec;
 
-#if SL_ENABLE_TIMING
-            CHI_VALIDATE(ctx.compute->beginPerfSection(pCmdList, "sl.dlss"));
-#endif
+            // Timed in all builds so hosts can read GPU cost per viewport, d3d11 waits on its queries so only there in dev builds
+            bool timed = SL_ENABLE_TIMING || ctx.platform != RenderAPI::eD3D11;
+            if (timed)
+            {
+                if (ctx.viewport->perfSection.empty())
+                {
+                    ctx.viewport->perfSection = extra::format("sl.dlss.{}", ctx.viewport->id);
+                }
+                CHI_VALIDATE(ctx.compute->beginPerfSection(pCmdList, ctx.viewport->perfSection.c_str()));
+            }
 
             {
                 ctx.cacheState(colorIn, colorIn.getState());
@@ -597,10 +1010,12 @@ Result dlssEndEvent(chi::CommandList pCmdList, const common::EventData& data, co
                 }
 
                 bool mvecPixelSpace = false;
+                // Dilation runs in the same pass which computes camera motion
+                bool dilateMvec = ctx.viewport->consts.structVersion >= kStructVersion4 && ctx.viewport->consts.dilateMotionVectors == Boolean::eTrue;
 
-                if (consts->cameraMotionIncluded == Boolean::eFalse)
+                if (consts->cameraMotionIncluded == Boolean::eFalse || dilateMvec)
                 {
-                    // Need to compute camera motion ourselves
+                    // Need to compute camera motion and/or dilate ourselves
 
                     // TODO - this is not optimal in the case of dynamic resizing, but cameraMotionIncluded should be true for most existing DLSSContext titles.
                     // To optimize this, we would want to realloc only when the size is larger than we've seen before, and use subrects
@@ -622,6 +1037,25 @@ Result dlssEndEvent(chi::CommandList pCmdList, const common::EventData& data, co
                         ctx.cacheState(ctx.viewport->mvec);
                         ctx.compute->endVRAMSegment();
                     }
+                    chi::Resource mvecInvalidMask{};
+                    if (dilateMvec && ctx.acquireScratch)
+                    {
+                        // 256 bits per 16x16 tile, see 'mvec_dilate.hlsl'
+                        uint32_t tiles = ((renderWidth + 15) / 16) * ((renderHeight + 15) / 16);
+                        ctx.mvecInvalidMaskBytes = std::max(ctx.mvecInvalidMaskBytes, tiles * 32);
+                        common::ScratchRequest request{};
+                        request.type = chi::ResourceType::eBuffer;
+                        request.desc = chi::ResourceDescription(ctx.mvecInvalidMaskBytes, 1, chi::eFormatINVALID, chi::eHeapTypeDefault, chi::ResourceState::eStorageRW, chi::ResourceFlags::eRawOrStructuredBuffer | chi::ResourceFlags::eShaderResourceStorage);
+                        request.name = "sl.dlss.mvecInvalidMask";
+                        ctx.compute->beginVRAMSegment("sl.dlss");
+                        ctx.acquireScratch(kFeatureDLSS, &request, 1, &mvecInvalidMask);
+                        ctx.compute->endVRAMSegment();
+                    }
+                    if (dilateMvec && !mvecInvalidMask)
+                    {
+                        SL_LOG_WARN_ONCE("Motion vector dilation needs the sl.common scratch service, computing motion vectors without it");
+                        dilateMvec = false;
+                    }
 
                     mvecIn = ctx.viewport->mvec;
 
@@ -629,6 +1063,7 @@ Result dlssEndEvent(chi::CommandList pCmdList, const common::EventData& data, co
                     mvecPixelSpace = true;
 
                     // No camera motion, need to compute ourselves and store in ctx.mvec
+                    chi::ScopedProfilingSection section(ctx.compute, pCmdList, "sl.dlss.mvec");
                     extra::ScopedTasks revTransitions;
                     chi::ResourceTransition transitions[] =
                     {
@@ -643,6 +1078,11 @@ Result dlssEndEvent(chi::CommandList pCmdList, const common::EventData& data, co
                         sl::float4 texSize;
                         sl::float2 mvecScale;
                         uint32_t debug;
+                        uint32_t padding;
+                        sl::float2 jitterDelta;
+                        // Only read by 'mvec_dilate.hlsl'
+                        uint32_t depthInverted;
+                        uint32_t reconstructZero;
                     };
                     MVecParamStruct cb;
                     cb.texSize.x = (float)renderWidth;
@@ -651,15 +1091,31 @@ Result dlssEndEvent(chi::CommandList pCmdList, const common::EventData& data, co
                     cb.texSize.w = 1.0f / renderHeight;
                     cb.mvecScale = { consts->mvecScale.x, consts->mvecScale.y }; // scaling everything to -1,1 range then to -width,width
                     cb.debug = 0;
+                    cb.padding = 0;
+                    // Removing jitter in the same pass, NGX gets unjittered vectors whenever we compute camera motion
+                    cb.jitterDelta = {};
+                    if (consts->motionVectorsJittered == Boolean::eTrue && consts->reset != Boolean::eTrue)
+                    {
+                        cb.jitterDelta = { consts->jitterOffset.x - ctx.viewport->prevJitterOffset.x, consts->jitterOffset.y - ctx.viewport->prevJitterOffset.y };
+                    }
+                    cb.depthInverted = consts->depthInverted == Boolean::eTrue ? 1 : 0;
+                    cb.reconstructZero = consts->cameraMotionIncluded == Boolean::eFalse ? 1 : 0;
                     memcpy(&cb.clipToPrevClip, &consts->clipToPrevClip, sizeof(float) * 16);
-                    CHI_VALIDATE(ctx.compute->bindKernel(ctx.mvecKernel));
+                    CHI_VALIDATE(ctx.compute->bindKernel(dilateMvec ? ctx.mvecDilateKernel : ctx.mvecKernel));
                     CHI_VALIDATE(ctx.compute->bindTexture(0, 0, mvec));
                     CHI_VALIDATE(ctx.compute->bindTexture(1, 1, depth));
                     CHI_VALIDATE(ctx.compute->bindRWTexture(2, 0, ctx.viewport->mvec));
-                    CHI_VALIDATE(ctx.compute->bindConsts(3, 0, &cb, sizeof(MVecParamStruct), kMaxNumViewports * 3));
+                    CHI_VALIDATE(ctx.compute->bindConsts(3, 0, &cb, sizeof(MVecParamStruct), ctx.maxNumViewports * 3));
+                    if (dilateMvec)
+                    {
+                        // Whole mask is written by the single dilate pass
+                        ctx.beginScratchPass(kFeatureDLSS, pCmdList, 0);
+                        CHI_VALIDATE(ctx.compute->bindRawBuffer(4, 1, mvecInvalidMask));
+                    }
                     uint32_t grid[] = { (renderWidth + 16 - 1) / 16, (renderHeight + 16 - 1) / 16, 1 };
                     CHI_VALIDATE(ctx.compute->dispatch(grid[0], grid[1], grid[2]));
                 }
+                ctx.viewport->prevJitterOffset = consts->jitterOffset;
 #if 0
                 if (ctx.viewport->output)
                 {
@@ -701,62 +1157,73 @@ Result dlssEndEvent(chi::CommandList pCmdList, const common::EventData& data, co
                     };
                     ctx.compute->transitionResources(pCmdList, transitions, (uint32_t)countof(transitions), &revTransitions);
 
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Reset, consts->reset == Boolean::eTrue);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_MV_Scale_X, (mvecPixelSpace ? 1.0f : (float)(consts->mvecScale.x * renderWidth)));
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_MV_Scale_Y, (mvecPixelSpace ? 1.0f : (float)(consts->mvecScale.y * renderHeight)));
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Jitter_Offset_X, consts->jitterOffset.x);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Jitter_Offset_Y, consts->jitterOffset.y);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Pre_Exposure, ctx.viewport->consts.preExposure);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Exposure_Scale, ctx.viewport->consts.exposureScale);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Sharpness, ctx.viewport->consts.sharpness);
+                    // Only values which changed since the last evaluate of this viewport reach NGX
+                    if (!ctx.viewport->evalParams)
+                    {
+                        ctx.viewport->evalParams = ctx.ngxContext->createParameterCache();
+                    }
+                    common::NGXCachedParameters params{ ctx.ngxContext, ctx.viewport->evalParams };
+
+                    params.set(NVSDK_NGX_Parameter_Reset, consts->reset == Boolean::eTrue);
+                    params.set(NVSDK_NGX_Parameter_MV_Scale_X, (mvecPixelSpace ? 1.0f : (float)(consts->mvecScale.x * renderWidth)));
+                    params.set(NVSDK_NGX_Parameter_MV_Scale_Y, (mvecPixelSpace ? 1.0f : (float)(consts->mvecScale.y * renderHeight)));
+                    params.set(NVSDK_NGX_Parameter_Jitter_Offset_X, consts->jitterOffset.x);
+                    params.set(NVSDK_NGX_Parameter_Jitter_Offset_Y, consts->jitterOffset.y);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Pre_Exposure, ctx.viewport->consts.preExposure);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Exposure_Scale, ctx.viewport->consts.exposureScale);
+                    params.set(NVSDK_NGX_Parameter_Sharpness, ctx.viewport->consts.sharpness);
 
                     if (ctx.platform == RenderAPI::eVulkan)
                     {
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Color, ctx.cachedVkResource(colorIn));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_MotionVectors, ctx.cachedVkResource(mvecIn));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Output, ctx.cachedVkResource(colorOut));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_TransparencyMask, ctx.cachedVkResource(transparency));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_ExposureTexture, ctx.cachedVkResource(exposure));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Depth, ctx.cachedVkResource(depth));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_Mask, ctx.cachedVkResource(currentColorBias));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_AnimatedTextureMask, ctx.cachedVkResource(animTexture));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_RayTracingHitDistance, ctx.cachedVkResource(rayTraceDist));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_MotionVectorsReflection, ctx.cachedVkResource(mvecReflections));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_IsParticleMask, ctx.cachedVkResource(particleMask));
+                        params.set(NVSDK_NGX_Parameter_Color, ctx.cachedVkResource(colorIn));
+                        params.set(NVSDK_NGX_Parameter_MotionVectors, ctx.cachedVkResource(mvecIn));
+                        params.set(NVSDK_NGX_Parameter_Output, ctx.cachedVkResource(colorOut));
+                        params.set(NVSDK_NGX_Parameter_TransparencyMask, ctx.cachedVkResource(transparency));
+                        params.set(NVSDK_NGX_Parameter_ExposureTexture, ctx.cachedVkResource(exposure));
+                        params.set(NVSDK_NGX_Parameter_Depth, ctx.cachedVkResource(depth));
+                        params.set(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_Mask, ctx.cachedVkResource(currentColorBias));
+                        params.set(NVSDK_NGX_Parameter_AnimatedTextureMask, ctx.cachedVkResource(animTexture));
+                        params.set(NVSDK_NGX_Parameter_RayTracingHitDistance, ctx.cachedVkResource(rayTraceDist));
+                        params.set(NVSDK_NGX_Parameter_MotionVectorsReflection, ctx.cachedVkResource(mvecReflections));
+                        params.set(NVSDK_NGX_Parameter_IsParticleMask, ctx.cachedVkResource(particleMask));
                     }
                     else
                     {
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Color, (void*)colorIn);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_MotionVectors, (void*)mvecIn);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Output, (void*)colorOut);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_TransparencyMask, (void*)transparency);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_ExposureTexture, (void*)exposure);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Depth, (void*)depth);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_Mask, (void*)currentColorBias);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_AnimatedTextureMask, (void*)animTexture);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_RayTracingHitDistance, (void*)rayTraceDist);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_MotionVectorsReflection, (void*)mvecReflections);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_IsParticleMask, (void*)particleMask);
+                        params.set(NVSDK_NGX_Parameter_Color, (void*)colorIn);
+                        params.set(NVSDK_NGX_Parameter_MotionVectors, (void*)mvecIn);
+                        params.set(NVSDK_NGX_Parameter_Output, (void*)colorOut);
+                        params.set(NVSDK_NGX_Parameter_TransparencyMask, (void*)transparency);
+                        params.set(NVSDK_NGX_Parameter_ExposureTexture, (void*)exposure);
+                        params.set(NVSDK_NGX_Parameter_Depth, (void*)depth);
+                        params.set(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_Mask, (void*)currentColorBias);
+                        params.set(NVSDK_NGX_Parameter_AnimatedTextureMask, (void*)animTexture);
+                        params.set(NVSDK_NGX_Parameter_RayTracingHitDistance, (void*)rayTraceDist);
+                        params.set(NVSDK_NGX_Parameter_MotionVectorsReflection, (void*)mvecReflections);
+                        params.set(NVSDK_NGX_Parameter_IsParticleMask, (void*)particleMask);
                     }
 
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_X, colorInExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_Y, colorInExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_X, depthExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_Y, depthExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_X, mvecExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_Y, mvecExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Translucency_SubrectBase_X, transparencyExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Translucency_SubrectBase_Y, transparencyExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_X, currentColorBiasExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_Y, currentColorBiasExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_X, colorOutExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_Y, colorOutExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Width, renderWidth);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Height, renderHeight);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Indicator_Invert_X_Axis, ctx.viewport->consts.indicatorInvertAxisX);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Indicator_Invert_Y_Axis, ctx.viewport->consts.indicatorInvertAxisY);
-
-                    ctx.ngxContext->evaluateFeature(pCmdList, ctx.viewport->handle, "sl.dlss");
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_X, colorInExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_Y, colorInExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_X, depthExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_Y, depthExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_X, mvecExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_Y, mvecExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Translucency_SubrectBase_X, transparencyExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Translucency_SubrectBase_Y, transparencyExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_X, currentColorBiasExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_Y, currentColorBiasExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_X, colorOutExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_Y, colorOutExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Width, renderWidth);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Height, renderHeight);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Indicator_Invert_X_Axis, ctx.viewport->consts.indicatorInvertAxisX);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Indicator_Invert_Y_Axis, ctx.viewport->consts.indicatorInvertAxisY);
+
+                    {
+                        chi::ScopedProfilingSection section(ctx.compute, pCmdList, "sl.dlss.ngx");
+                        std::scoped_lock lock(ctx.ngxMutex);
+                        ctx.ngxContext->evaluateFeatureWithCache(pCmdList, ctx.viewport->handle, ctx.viewport->evalParams, "sl.dlss");
+                    }
 
 #if 0
                     {
@@ -774,9 +1241,24 @@ Result dlssEndEvent(chi::CommandList pCmdList, const common::EventData& data, co
                 }
 
                 float ms = 0;
-#if SL_ENABLE_TIMING
-                CHI_VALIDATE(ctx.compute->endPerfSection(pCmdList, "sl.dlss", ms));
-#endif
+                if (timed)
+                {
+                    CHI_VALIDATE(ctx.compute->endPerfSection(pCmdList, ctx.viewport->perfSection.c_str(), ms));
+                }
+
+                {
+                    std::scoped_lock lock(ctx.dynamicResolutionMutex);
+                    auto controller = ctx.dynamicResolution.find(ctx.viewport->id);
+                    if (controller != ctx.dynamicResolution.end())
+                    {
+                        chi::PerfSectionStats stats{};
+                        if (timed)
+                        {
+                            ctx.compute->getPerfSectionStats(ctx.viewport->perfSection.c_str(), stats);
+                        }
+                        updateDynamicResolution((*controller).second, *ctx.viewport, stats.meanMS);
+                    }
+                }
 
 #ifndef SL_PRODUCTION
                 /*static std::string s_stats;
@@ -789,11 +1271,8 @@ Result dlssEndEvent(chi::CommandList pCmdList, const common::EventData& data, co
                 {
                     uint64_t bytes;
                     ctx.compute->getAllocatedBytes(bytes, "sl.dlss");
-                    std::scoped_lock lock(ctx.uiStats.mtx);
-                    ctx.uiStats.mode = getDLSSModeAsStr(ctx.viewport->consts.mode);
-                    ctx.uiStats.viewport = extra::format("Viewport {}x{} -> {}x{}", renderWidth, renderHeight, ctx.viewport->consts.outputWidth, ctx.viewport->consts.outputHeight);
-                    ctx.uiStats.runtime = extra::format("{}ms", ms);
-                    ctx.uiStats.vram = extra::format("{}GB", bytes / (1024.0 * 1024.0 * 1024.0));
+                    ctx.uiStats.publish({ ctx.viewport->consts.mode, ctx.viewport->id, renderWidth, renderHeight,
+                        ctx.viewport->consts.outputWidth, ctx.viewport->consts.outputHeight, ms, bytes });
                 }
 #endif
 
@@ -833,6 +1312,7 @@ Result slGetData(const BaseStructure *inputs, BaseStructure *output, CommandBuff
     // Settings
     if (consts && settings)
     {
+        std::scoped_lock lock(ctx.ngxMutex);
         void* callback = NULL;
         ctx.ngxContext->params->Get(NVSDK_NGX_Parameter_DLSSOptimalSettingsCallback, &callback);
         if (!callback)
@@ -868,6 +1348,7 @@ Result slGetData(const BaseStructure *inputs, BaseStructure *output, CommandBuff
     // Stats
     if(state)
     {
+        std::unique_lock ngxLock(ctx.ngxMutex);
         void* callback = NULL;
         ctx.ngxContext->params->Get(NVSDK_NGX_Parameter_DLSSGetStatsCallback, &callback);
         if (!callback)
@@ -884,6 +1365,29 @@ Result slGetData(const BaseStructure *inputs, BaseStructure *output, CommandBuff
         }
         // TODO: This has to return the correct estimate regardless if callback is present or not.
         ctx.ngxContext->params->Get(NVSDK_NGX_Parameter_SizeInBytes, &state->estimatedVRAMUsageInBytes);
+        ngxLock.unlock();
+
+        auto viewport = findStruct<ViewportHandle>(inputs);
+        if (state->structVersion >= kStructVersion2)
+        {
+            // Timings are resolved a few frames late so they stay zero until the viewport was evaluated a couple of times
+            auto it = viewport ? ctx.viewports.find(*viewport) : ctx.viewports.end();
+            chi::PerfSectionStats stats{};
+            if (it != ctx.viewports.end() && !(*it).second.perfSection.empty())
+            {
+                ctx.compute->getPerfSectionStats((*it).second.perfSection.c_str(), stats);
+            }
+            state->gpuTimeLastMS = stats.lastMS;
+            state->gpuTimeAverageMS = stats.meanMS;
+            state->gpuTimeP99MS = stats.p99MS;
+        }
+        if (state->structVersion >= kStructVersion3)
+        {
+            std::scoped_lock lock(ctx.dynamicResolutionMutex);
+            auto it = viewport ? ctx.dynamicResolution.find(*viewport) : ctx.dynamicResolution.end();
+            state->recommendedRenderWidth = it != ctx.dynamicResolution.end() ? (*it).second.renderWidth : 0;
+            state->recommendedRenderHeight = it != ctx.dynamicResolution.end() ? (*it).second.renderHeight : 0;
+        }
     }
     return Result::eOk;
 }
@@ -904,6 +1408,10 @@ Result slFreeResources(Feature feature, const sl::ViewportHandle& viewport)
     if (it != ctx.viewports.end())
     {
         auto& instance = (*it).second;
+        discardPendingFeature(instance);
+        ctx.featureCache.release(ctx.ngxContext, viewport);
+        ctx.idleFeatures.remove(viewport);
+        ctx.ngxContext->destroyParameterCache(instance.evalParams);
         if (instance.handle)
         {
             SL_LOG_INFO("Releasing DLSSContext instance id %u", viewport);
@@ -913,6 +1421,10 @@ Result slFreeResources(Feature feature, const sl::ViewportHandle& viewport)
             CHI_VALIDATE(ctx.compute->destroyResource(instance.output));
         }
         ctx.viewports.erase(it);
+        {
+            std::scoped_lock lock(ctx.dynamicResolutionMutex);
+            ctx.dynamicResolution.erase(viewport);
+        }
         return Result::eOk;
     }
     return Result::eErrorInvalidParameter;
@@ -932,6 +1444,8 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
 
     auto parameters = api::getContext()->parameters;
 
+    ctx.maxNumViewports = common::getMaxNumViewports();
+
     getPointerParam(parameters, param::global::kNGXContext, &ctx.ngxContext);
 
     if (!ctx.ngxContext)
@@ -967,6 +1481,13 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
         return false;
     }
     ctx.registerEvaluateCallbacks(kFeatureDLSS, dlssBeginEvent, dlssEndEvent);
+    // Optional, motion vector dilation is skipped without it
+    if (!param::getPointerParam(parameters, param::common::kPFunAcquireScratch, &ctx.acquireScratch) ||
+        !param::getPointerParam(parameters, param::common::kPFunBeginScratchPass, &ctx.beginScratchPass) ||
+        !param::getPointerParam(parameters, param::common::kPFunReleaseScratch, &ctx.releaseScratch))
+    {
+        ctx.acquireScratch = {};
+    }
 
     param::getPointerParam(parameters, sl::param::common::kComputeAPI, &ctx.compute);
 
@@ -985,11 +1506,26 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
     if (ctx.platform == RenderAPI::eVulkan)
     {
         CHI_CHECK_RF(ctx.compute->createKernel((void*)mvec_spv, mvec_spv_len, "mvec.cs", "main", ctx.mvecKernel));
+        CHI_CHECK_RF(ctx.compute->createKernel((void*)mvec_dilate_spv, mvec_dilate_spv_len, "mvec_dilate.cs", "main", ctx.mvecDilateKernel));
     }
     else
     {
-        CHI_CHECK_RF(ctx.compute->createKernel((void*)mvec_cs, mvec_cs_len, "mvec.cs", "main", ctx.mvecKernel));
+        // SM 6.6 builds index the descriptor heap directly and share one root signature, see 'shaders/bindless.hlsli'
+        chi::ShaderCaps caps{};
+        ctx.compute->getShaderCaps(caps);
+        if (caps.bindlessResources)
+        {
+            CHI_CHECK_RF(ctx.compute->createKernel((void*)mvec_sm66_cs, mvec_sm66_cs_len, "mvec_sm66.cs", "main", ctx.mvecKernel));
+            CHI_CHECK_RF(ctx.compute->createKernel((void*)mvec_dilate_sm66_cs, mvec_dilate_sm66_cs_len, "mvec_dilate_sm66.cs", "main", ctx.mvecDilateKernel));
+        }
+        else
+        {
+            CHI_CHECK_RF(ctx.compute->createKernel((void*)mvec_cs, mvec_cs_len, "mvec.cs", "main", ctx.mvecKernel));
+            CHI_CHECK_RF(ctx.compute->createKernel((void*)mvec_dilate_cs, mvec_dilate_cs_len, "mvec_dilate.cs", "main", ctx.mvecDilateKernel));
+        }
     }
+    // Pipelines recorded by previous runs are created now rather than on the first evaluate
+    ctx.compute->prewarmKernels(&ctx.mvecKernel, 1);
 
     // Update our feature if update is available and host opted in
     ctx.ngxContext->updateFeature(NVSDK_NGX_Feature_SuperSampling);
@@ -1016,25 +1552,26 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
             imgui::Float4 highlightColor{ 153.0f / 255.0f, 217.0f / 255.0f, 234.0f / 255.0f,1 };
 
             auto v = api::getContext()->pluginVersion;
-            std::scoped_lock lock(ctx.uiStats.mtx);
+            UIStats stats{};
+            bool active = ctx.uiStats.read(stats);
             uint32_t lastFrame, frame;
             if (api::getContext()->parameters->get(sl::param::dlss::kCurrentFrame, &lastFrame))
             {
                 ctx.compute->getFinishedFrameIndex(frame);
-                if (lastFrame < frame)
-                {
-                    ctx.uiStats.mode = "Mode: Off";
-                    ctx.uiStats.viewport = ctx.uiStats.runtime = {};
-                }
+                active &= lastFrame >= frame;
                 if (ui->collapsingHeader(extra::format("sl.dlss v{}", (v.toStr() + "." + GIT_LAST_COMMIT_SHORT)).c_str(), imgui::kTreeNodeFlagDefaultOpen))
                 {
                     ui->text("NGX v%s ", ctx.ngxVersion.c_str());
-                    ui->text(ctx.uiStats.mode.c_str());
-                    if (!ctx.uiStats.viewport.empty())
+                    if (active)
+                    {
+                        ui->text(getDLSSModeAsStr(stats.mode));
+                        ui->text("Viewport %ux%u -> %ux%u", stats.renderWidth, stats.renderHeight, stats.outputWidth, stats.outputHeight);
+                        ui->labelColored(greenColor, "Execution time: ", "%.2fms", stats.runtimeMs);
+                        ui->labelColored(highlightColor, "VRAM: ", "%.2fGB", stats.vramBytes / (1024.0 * 1024.0 * 1024.0));
+                    }
+                    else
                     {
-                        ui->text(ctx.uiStats.viewport.c_str());
-                        ui->labelColored(greenColor, "Execution time: ", "%s", ctx.uiStats.runtime.c_str());
-                        ui->labelColored(highlightColor, "VRAM: ", "%s", ctx.uiStats.vram.c_str());
+                        ui->text("Mode: Off");
                     }
                 }
             }
@@ -1058,12 +1595,29 @@ void slOnPluginShutdown()
     // Common shutdown
     plugin::onShutdown(api::getContext());
 
-    for(auto v : ctx.viewports)
+    for(auto& v : ctx.viewports)
     {
+        discardPendingFeature(v.second);
         ctx.ngxContext->releaseFeature(v.second.handle, "sl.dlss");
+        ctx.ngxContext->destroyParameterCache(v.second.evalParams);
         CHI_VALIDATE(ctx.compute->destroyResource(v.second.mvec));
     }
+    if (ctx.releaseScratch)
+    {
+        ctx.releaseScratch(kFeatureDLSS);
+    }
+    // Only place which waits for background creation, the command list below must be idle
+    releaseDiscardedFeatures(true);
+    ctx.featureCache.release(ctx.ngxContext, UINT_MAX);
+    if (ctx.createCmdList)
+    {
+        CHI_VALIDATE(ctx.compute->destroyCommandListContext(ctx.createCmdList));
+        CHI_VALIDATE(ctx.compute->destroyCommandQueue(ctx.createQueue));
+        ctx.createCmdList = {};
+        ctx.createQueue = {};
+    }
     CHI_VALIDATE(ctx.compute->destroyKernel(ctx.mvecKernel));
+    CHI_VALIDATE(ctx.compute->destroyKernel(ctx.mvecDilateKernel));
 }
 
 sl::Result slDLSSGetOptimalSettings(const sl::DLSSOptions& options, sl::DLSSOptimalSettings& settings)
@@ -1083,6 +1637,64 @@ sl::Result slDLSSSetOptions(const sl::ViewportHandle& viewport, const sl::DLSSOp
     return slSetData(&v, nullptr);
 }
 
+sl::Result slDLSSPrewarm(sl::CommandBuffer* cmdBuffer, const sl::ViewportHandle& viewport, const sl::DLSSOptions* options, uint32_t count)
+{
+    auto& ctx = (*dlss::getContext());
+    if (!cmdBuffer || (!options && count))
+    {
+        return Result::eErrorMissingInputParameter;
+    }
+    if (!ctx.ngxContext)
+    {
+        return Result::eErrorNGXFailed;
+    }
+
+    auto cmdList = common::getNativeCommandBuffer(cmdBuffer);
+
+    // Prewarming is how the host opts in to keeping features which are not in use
+    ctx.featureCache.enabled = true;
+    if (count > ctx.featureCache.maxCount)
+    {
+        SL_LOG_WARN("Prewarming %u DLSSContext features but the cache keeps at most %u, see 'featureCacheMaxCount'", count, ctx.featureCache.maxCount);
+    }
+
+    // Flags which depend on tags cannot be known up front. Tags are not looked up here since that would make them
+    // required for this viewport, missing exposure only means auto exposure if the options ask for it.
+    Constants* commonConsts{};
+    common::getConsts({ viewport, 0 }, &commonConsts);
+
+    auto it = ctx.viewports.find(viewport);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        auto& consts = options[i];
+        if (consts.mode == DLSSMode::eOff)
+        {
+            continue;
+        }
+        DLSSOptimalSettings settings{};
+        if (slGetData(&consts, &settings, cmdBuffer) != Result::eOk)
+        {
+            continue;
+        }
+        auto key = getFeatureKey(consts, settings, getCreateFlags(consts, commonConsts, false, true));
+        if ((it != ctx.viewports.end() && (*it).second.handle && (*it).second.key == key) || ctx.featureCache.touch(viewport, key))
+        {
+            continue;
+        }
+        NVSDK_NGX_Handle* handle{};
+        uint64_t bytes{};
+        if (!createFeature(cmdList, key, handle, bytes))
+        {
+            SL_LOG_WARN("Failed to prewarm DLSSContext feature (%u,%u) -> (%u,%u) for viewport %u", key.renderWidth, key.renderHeight, key.outputWidth, key.outputHeight, (uint32_t)viewport);
+            return Result::eErrorNGXFailed;
+        }
+        SL_LOG_INFO("Prewarmed DLSSContext feature (%u,%u)(optimal) -> (%u,%u) for viewport %u - %.2fMB", key.renderWidth, key.renderHeight, key.outputWidth, key.outputHeight,
+            (uint32_t)viewport, bytes / (1024.0 * 1024.0));
+        ctx.featureCache.add(ctx.ngxContext, viewport, key, handle, bytes);
+    }
+    return Result::eOk;
+}
+
 sl::Result slIsSupported(const sl::AdapterInfo& adapterInfo)
 {
     auto& ctx = (*dlss::getContext());
@@ -1134,6 +1746,7 @@ SL_EXPORT void *slGetPluginFunction(const char *functionName)
     SL_EXPORT_FUNCTION(slDLSSSetOptions);
     SL_EXPORT_FUNCTION(slDLSSGetOptimalSettings);
     SL_EXPORT_FUNCTION(slDLSSGetState);    
+    SL_EXPORT_FUNCTION(slDLSSPrewarm);
 
     return nullptr;
 }
@@ -40,6 +40,7 @@
 
 #include "source/platforms/sl.chi/vulkan.h"
 #include "source/plugins/sl.common/commonInterface.h"
+#include "source/plugins/sl.common/statsSnapshot.h"
 #include "source/plugins/sl.dlss_d/versions.h"
 #include "source/plugins/sl.imgui/imgui.h"
 
@@ -47,6 +48,7 @@
 
 #include "_artifacts/shaders/mvec_cs.h"
 #include "_artifacts/shaders/mvec_spv.h"
+#include "_artifacts/shaders/mvec_sm66_cs.h"
 #include "_artifacts/json/dlss_d_json.h"
 #include "_artifacts/gitVersion.h"
 
@@ -55,6 +57,7 @@
 #include "external/ngx-sdk/include/nvsdk_ngx_helpers.h"
 #include "external/ngx-sdk/include/nvsdk_ngx_helpers_vk.h"
 #include "external/ngx-sdk/include/nvsdk_ngx_defs_dlssd.h"
+#include "external/ngx-sdk/include/nvsdk_ngx_helpers_dlssd.h"
 
 using json = nlohmann::json;
 
@@ -67,6 +70,29 @@ using funNGXCreate = NVSDK_NGX_Result(*)(ID3D12GraphicsCommandList *InCmdList, N
 using funNGXRelease = NVSDK_NGX_Result(*)(NVSDK_NGX_Handle *InHandle);
 using funNGXEval = NVSDK_NGX_Result(*)(ID3D12GraphicsCommandList *InCmdList, const NVSDK_NGX_Handle *InHandle, const NVSDK_NGX_Parameter *InParameters, PFN_NVSDK_NGX_ProgressCallback InCallback);
 
+//! Everything a DLSSD feature is created with, features are interchangeable only if all of it matches
+struct DLSSDFeatureKey
+{
+    uint32_t renderWidth{};
+    uint32_t renderHeight{};
+    uint32_t outputWidth{};
+    uint32_t outputHeight{};
+    int createFlags{};
+    NVSDK_NGX_PerfQuality_Value perfQuality{};
+    DLSSDNormalRoughnessMode normalRoughnessMode{};
+    bool linearDepth{};
+    //! DLAA, quality, balanced, performance, ultra performance and ultra quality presets
+    DLSSDPreset presets[6]{};
+
+    bool operator==(const DLSSDFeatureKey& rhs) const = default;
+};
+
+//! Feature created in the background, its VRAM cost is measured on the render thread when it is swapped in
+struct DLSSDCreatedFeature
+{
+    NVSDK_NGX_Handle* handle{};
+};
+
 struct DLSSDViewport
 {
     uint32_t id = {};
@@ -75,15 +101,35 @@ struct DLSSDViewport
     NVSDK_NGX_Handle* handle = {};
     sl::chi::Resource mvec;
     float2 inputTexelSize;
+
+    //! Options the current (or pending) feature was requested with
+    DLSSDOptions createdConsts{};
+    //! Creation parameters and VRAM cost of the current feature
+    DLSSDFeatureKey key{};
+    uint64_t bytes{};
+    //! Replacement feature created in the background, current handle keeps evaluating until it is ready
+    std::future<DLSSDCreatedFeature> pendingHandle;
+    DLSSDFeatureKey pendingKey{};
+    uint64_t pendingBaseBytes{};
+    //! Evaluation parameters, only changed values are set on each evaluate
+    common::NGXParameterCache* evalParams{};
+    //! Jitter of the last evaluate, jitter is removed from motion vectors when we compute camera motion
+    float2 prevJitterOffset{};
+    //! GPU timing section for this viewport, reported via 'slGetData' with the state struct
+    std::string perfSection{};
 };
 
+//! Published once per evaluate, formatted by the UI only when drawn
 struct UIStats
 {
-    std::mutex mtx{};
-    std::string mode{};
-    std::string viewport{};
-    std::string runtime{};
-    std::string vram{};
+    DLSSMode mode{};
+    uint32_t viewport{};
+    uint32_t renderWidth{};
+    uint32_t renderHeight{};
+    uint32_t outputWidth{};
+    uint32_t outputHeight{};
+    float runtimeMs{};
+    uint64_t vramBytes{};
 };
 
 namespace dlss_d
@@ -98,12 +144,25 @@ struct DLSSDContext
 
     Constants* commonConsts{};
 
-    UIStats uiStats{};
+    common::StatsSnapshot<UIStats> uiStats{};
 
     uint32_t adapterMask{};
 
     common::NGXContext* ngxContext = {};
     sl::chi::ICompute* compute;
+
+    //! Background feature (re)creation, see 'createFeatureInBackground'
+    sl::chi::ChiCommandQueue* createQueue{};
+    sl::chi::ICommandListContext* createCmdList{};
+    std::mutex createMutex{};
+    bool backgroundCreateFailed = false;
+
+    //! Features not in use
+    //!
+    //! Opt-in, retired features are released right away unless the plugin JSON sets "featureCacheBudgetMB" or "featureCacheMaxCount".
+    common::NGXFeatureCache<DLSSDFeatureKey> featureCache{ "sl.dlss_d" };
+    //! Features of viewports not evaluated for a while are released under VRAM pressure
+    common::IdleFeatureEviction idleFeatures{};
 #ifdef SL_CAPTURE
     sl::chi::ICapture* capture;
 #endif
@@ -114,10 +173,12 @@ struct DLSSDContext
 #endif
 
     common::PFunRegisterEvaluateCallbacks* registerEvaluateCallbacks{};
-    common::ViewportIdFrameData<4, false> constsPerViewport = { "dlss_d" };
+    common::TypedViewportIdFrameData<DLSSDOptions, 4, false> constsPerViewport = { "dlss_d" };
     std::map<void*, chi::ResourceState> cachedStates = {};
     std::map<void*, NVSDK_NGX_Resource_VK> cachedVkResources = {};
     std::map<uint32_t, DLSSDViewport> viewports = {};
+    //! From 'PreferencesViewports', sizes per frame constant storage
+    uint32_t maxNumViewports = common::kDefaultMaxNumViewports;
     DLSSDViewport* viewport = {};
 
     RenderAPI platform;
@@ -161,8 +222,6 @@ struct DLSSDContext
 };
 }
 
-constexpr uint32_t kMaxNumViewports = 4;
-
 static std::string JSON = std::string(dlss_d_json, &dlss_d_json[dlss_d_json_len]);
 
 void updateEmbeddedJSON(json& config);
@@ -225,6 +284,20 @@ void updateEmbeddedJSON(json& config)
 
         auto& ctx = (*dlss_d::getContext());
         ctx.adapterMask = config.contains("supportedAdapters") ? config["supportedAdapters"].operator uint32_t() : 0;
+        if (config.contains("featureCacheBudgetMB"))
+        {
+            ctx.featureCache.budgetBytes = config["featureCacheBudgetMB"].operator uint64_t() * 1024 * 1024;
+            ctx.featureCache.enabled = true;
+        }
+        if (config.contains("featureCacheMaxCount"))
+        {
+            ctx.featureCache.maxCount = config["featureCacheMaxCount"].operator uint32_t();
+            ctx.featureCache.enabled = true;
+        }
+        if (config.contains("idleFeatureReleaseFrames"))
+        {
+            ctx.idleFeatures.idleFrames = config["idleFeatureReleaseFrames"].operator uint32_t();
+        }
 
         if (ctx.adapterMask && supported)
         {
@@ -254,7 +327,7 @@ void updateEmbeddedJSON(json& config)
 
             config["external"]["vk"]["device"]["1.2_features"] = { "timelineSemaphore", "descriptorIndexing", "bufferDeviceAddress" };
 
-            config["external"]["feature"]["viewport"]["maxCount"] = kMaxNumViewports;
+            config["external"]["feature"]["viewport"]["maxCount"] = common::getMaxNumViewports();
 
             // Version
             config["external"]["version"]["sl"] = extra::format("{}.{}.{}", SL_VERSION_MAJOR, SL_VERSION_MINOR, SL_VERSION_PATCH);
@@ -305,6 +378,213 @@ Result slSetData(const BaseStructure* inputs, CommandBuffer* cmdBuffer)
     return Result::eOk;
 }
 
+int getCreateFlags(const DLSSDOptions& consts, const Constants* commonConsts, bool mvecLowRes)
+{
+    int dlssCreateFlags = mvecLowRes ? NVSDK_NGX_DLSS_Feature_Flags_MVLowRes : 0;
+    if (consts.colorBuffersHDR == Boolean::eTrue)
+    {
+        dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_IsHDR;
+    }
+    if (consts.sharpness > 0.0f)
+    {
+        dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_DoSharpening;
+    }
+    if (commonConsts && commonConsts->depthInverted == Boolean::eTrue)
+    {
+        dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_DepthInverted;
+    }
+    // Motion vectors are unjittered by our 'mvec' pass when we compute camera motion
+    if (commonConsts && commonConsts->motionVectorsJittered == Boolean::eTrue && commonConsts->cameraMotionIncluded != Boolean::eFalse)
+    {
+        dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_MVJittered;
+    }
+    if (consts.structVersion >= kStructVersion2 && consts.alphaUpscalingEnabled == Boolean::eTrue)
+    {
+        dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_AlphaUpscaling;
+    }
+    return dlssCreateFlags;
+}
+
+DLSSDFeatureKey getFeatureKey(const DLSSDOptions& consts, const DLSSDOptimalSettings& settings, int createFlags, bool linearDepth)
+{
+    DLSSDFeatureKey key{ settings.optimalRenderWidth, settings.optimalRenderHeight, consts.outputWidth, consts.outputHeight, createFlags,
+        (NVSDK_NGX_PerfQuality_Value)((uint32_t)consts.mode - 1), consts.normalRoughnessMode, linearDepth };
+    if (consts.structVersion >= kStructVersion3)
+    {
+        key.presets[0] = consts.dlaaPreset;
+        key.presets[1] = consts.qualityPreset;
+        key.presets[2] = consts.balancedPreset;
+        key.presets[3] = consts.performancePreset;
+        key.presets[4] = consts.ultraPerformancePreset;
+        key.presets[5] = consts.ultraQualityPreset;
+    }
+    return key;
+}
+
+void setCreateParameters(NVSDK_NGX_Parameter* params, const DLSSDFeatureKey& key)
+{
+    params->Set(NVSDK_NGX_Parameter_CreationNodeMask, 1);
+    params->Set(NVSDK_NGX_Parameter_VisibilityNodeMask, 1);
+    params->Set(NVSDK_NGX_Parameter_Width, key.renderWidth);
+    params->Set(NVSDK_NGX_Parameter_Height, key.renderHeight);
+    params->Set(NVSDK_NGX_Parameter_OutWidth, key.outputWidth);
+    params->Set(NVSDK_NGX_Parameter_OutHeight, key.outputHeight);
+    params->Set(NVSDK_NGX_Parameter_PerfQualityValue, key.perfQuality);
+    params->Set(NVSDK_NGX_Parameter_DLSS_Feature_Create_Flags, key.createFlags);
+    params->Set(NVSDK_NGX_Parameter_FreeMemOnReleaseFeature, 1);
+    params->Set(NVSDK_NGX_Parameter_DLSS_Denoise_Mode, NVSDK_NGX_DLSS_Denoise_Mode_DLUnified);
+    params->Set(NVSDK_NGX_Parameter_DLSS_Roughness_Mode, 
+        key.normalRoughnessMode == DLSSDNormalRoughnessMode::eUnpacked ? NVSDK_NGX_DLSS_Roughness_Mode_Unpacked : NVSDK_NGX_DLSS_Roughness_Mode_Packed);
+    params->Set(NVSDK_NGX_Parameter_Use_HW_Depth, key.linearDepth ? NVSDK_NGX_DLSS_Depth_Type_Linear : NVSDK_NGX_DLSS_Depth_Type_HW);
+    params->Set(NVSDK_NGX_Parameter_RayReconstruction_Hint_Render_Preset_DLAA, (uint32_t)key.presets[0]);
+    params->Set(NVSDK_NGX_Parameter_RayReconstruction_Hint_Render_Preset_Quality, (uint32_t)key.presets[1]);
+    params->Set(NVSDK_NGX_Parameter_RayReconstruction_Hint_Render_Preset_Balanced, (uint32_t)key.presets[2]);
+    params->Set(NVSDK_NGX_Parameter_RayReconstruction_Hint_Render_Preset_Performance, (uint32_t)key.presets[3]);
+    params->Set(NVSDK_NGX_Parameter_RayReconstruction_Hint_Render_Preset_UltraPerformance, (uint32_t)key.presets[4]);
+    params->Set(NVSDK_NGX_Parameter_RayReconstruction_Hint_Render_Preset_UltraQuality, (uint32_t)key.presets[5]);
+}
+
+//! VRAM allocated by all DLSSD features as reported by NGX, zero if the driver does not report it
+uint64_t getNGXAllocatedBytes()
+{
+    auto& ctx = (*dlss_d::getContext());
+    unsigned long long bytes{};
+    if (NVSDK_NGX_FAILED(NGX_DLSSD_GET_STATS(ctx.ngxContext->params, &bytes)))
+    {
+        return 0;
+    }
+    return bytes;
+}
+
+//! Creates a feature on the host command list with the shared parameters, returns its VRAM cost
+bool createFeature(chi::CommandList cmdList, const DLSSDFeatureKey& key, NVSDK_NGX_Handle*& handle, uint64_t& bytes)
+{
+    auto& ctx = (*dlss_d::getContext());
+    auto before = getNGXAllocatedBytes();
+    setCreateParameters(ctx.ngxContext->params, key);
+    if (!ctx.ngxContext->createFeature(cmdList, NVSDK_NGX_Feature_RayReconstruction, &handle, "sl.dlss_d"))
+    {
+        return false;
+    }
+    auto after = getNGXAllocatedBytes();
+    bytes = after > before ? after - before : 0;
+    return true;
+}
+
+//! Moves the current feature of the viewport to the cache so switching back is instant, releases it if the cache is off
+void retireFeature(DLSSDViewport& viewport)
+{
+    auto& ctx = (*dlss_d::getContext());
+    ctx.featureCache.retire(ctx.ngxContext, viewport.id, viewport.key, viewport.handle, viewport.bytes);
+    viewport.handle = {};
+    viewport.bytes = {};
+    ctx.compute->destroyResource(viewport.mvec);
+    viewport.mvec = nullptr;
+}
+
+//! Releases the feature of the least recently evaluated viewport while over the VRAM budget
+//! 
+//! Viewport keeps its options, the feature is created again on its next evaluate
+void releaseIdleFeature(uint32_t frame)
+{
+    auto& ctx = (*dlss_d::getContext());
+    uint32_t id{};
+    if (!ctx.idleFeatures.pick(ctx.compute, frame, id)) return;
+
+    auto it = ctx.viewports.find(id);
+    if (it == ctx.viewports.end()) return;
+    auto& viewport = (*it).second;
+    if (viewport.pendingHandle.valid())
+    {
+        if (auto handle = viewport.pendingHandle.get().handle)
+        {
+            ctx.ngxContext->releaseFeature(handle, "sl.dlss_d");
+        }
+    }
+    ctx.featureCache.release(ctx.ngxContext, id);
+    if (viewport.handle)
+    {
+        SL_LOG_INFO("Releasing DLSSDContext feature for viewport %u (%.2fMB) - not evaluated for %u frames while over VRAM budget", id, viewport.bytes / (1024.0 * 1024.0), ctx.idleFeatures.idleFrames);
+        ctx.ngxContext->releaseFeature(viewport.handle, "sl.dlss_d");
+        viewport.handle = {};
+        viewport.bytes = {};
+    }
+    ctx.compute->destroyResource(viewport.mvec);
+    viewport.mvec = nullptr;
+}
+
+//! Creates a feature on our own command list and waits for it to finish initializing on the GPU
+//!
+//! Runs on a worker thread, uses a private parameter block since the shared one is used for evaluation
+DLSSDCreatedFeature createFeatureInBackground(DLSSDFeatureKey key, uint32_t id)
+{
+    auto& ctx = (*dlss_d::getContext());
+
+    // Creations share the command list so only one at a time
+    std::scoped_lock lock(ctx.createMutex);
+
+    auto params = ctx.ngxContext->allocateParameters();
+    if (!params)
+    {
+        return {};
+    }
+    setCreateParameters(params, key);
+
+    DLSSDCreatedFeature feature{};
+    ctx.createCmdList->beginCommandList();
+    bool created = ctx.ngxContext->createFeatureWithParameters(ctx.createCmdList->getCmdList(), NVSDK_NGX_Feature_RayReconstruction, params, &feature.handle, "sl.dlss_d");
+    ctx.createCmdList->executeCommandList();
+    // Handle is used on the host queues right after the swap, initialization must be done by then
+    ctx.createCmdList->waitForCommandList(sl::chi::FlushType::eCurrent);
+    ctx.ngxContext->destroyParameters(params);
+
+    if (!created)
+    {
+        SL_LOG_WARN("Failed to create DLSSDContext feature in the background for viewport %u", id);
+        return {};
+    }
+    return feature;
+}
+
+//! Background creation is possible if the current feature can keep evaluating the new inputs
+bool canCreateInBackground(const DLSSDViewport& viewport, const DLSSDFeatureKey& key)
+{
+    auto& ctx = (*dlss_d::getContext());
+    if (!viewport.handle || !ctx.ngxContext->createFeatureWithParameters || ctx.backgroundCreateFailed)
+    {
+        return false;
+    }
+    // Output size and input layout are fixed at creation, input can shrink (same as dynamic resolution) but not grow
+    return viewport.key.outputWidth == key.outputWidth && viewport.key.outputHeight == key.outputHeight &&
+        viewport.key.normalRoughnessMode == key.normalRoughnessMode && viewport.key.linearDepth == key.linearDepth &&
+        viewport.key.createFlags == key.createFlags &&
+        key.renderWidth <= viewport.key.renderWidth && key.renderHeight <= viewport.key.renderHeight;
+}
+
+//! Replaces the current feature with the one created in the background
+void swapPendingHandle(DLSSDViewport& viewport)
+{
+    auto& ctx = (*dlss_d::getContext());
+    auto feature = viewport.pendingHandle.get();
+    if (!feature.handle)
+    {
+        // Recreate the usual way from now on, forcing a mismatch so it happens next frame
+        ctx.backgroundCreateFailed = true;
+        viewport.createdConsts = {};
+        return;
+    }
+    // Approximate, anything else DLSSD allocated since the request is counted too
+    auto bytes = getNGXAllocatedBytes();
+    retireFeature(viewport);
+    viewport.handle = feature.handle;
+    viewport.bytes = bytes > viewport.pendingBaseBytes ? bytes - viewport.pendingBaseBytes : 0;
+    viewport.key = viewport.pendingKey;
+    ctx.commonConsts->reset = Boolean::eTrue;
+    ctx.cachedStates.clear();
+    SL_LOG_INFO("Switched to DLSSDContext feature created in the background (%u,%u)(optimal) -> (%u,%u) for viewport %u", viewport.key.renderWidth, viewport.key.renderHeight,
+        viewport.key.outputWidth, viewport.key.outputHeight, viewport.id);
+}
+
 Result dlssdBeginEvent(chi::CommandList pCmdList, const common::EventData& data, const sl::BaseStructure** inputs, uint32_t numInputs)
 {
     auto parameters = api::getContext()->parameters;
@@ -325,14 +605,17 @@ Result dlssdBeginEvent(chi::CommandList pCmdList, const common::EventData& data,
         ctx.viewports[data.id] = {};
     }
     
-    if (ctx.viewports.size() > (size_t)kMaxNumViewports)
+    if (ctx.viewports.size() > (size_t)ctx.maxNumViewports)
     {
-        SL_LOG_WARN("Exceeded max number (%u) of allowed viewports for DLSS_D", kMaxNumViewports);
+        SL_LOG_WARN_ONCE("Exceeded max number (%u) of allowed viewports for DLSS_D, please raise 'PreferencesViewports::maxNumViewports'", ctx.maxNumViewports);
     }
 
     auto& viewport = ctx.viewports[data.id];
     viewport.id = data.id;
 
+    ctx.idleFeatures.touch(data.id, data.frame);
+    releaseIdleFeature(data.frame);
+
     // Our options are per viewport, frame index is just 0 always
     DLSSDOptions* consts{};
     if (!ctx.constsPerViewport.get({ data.id, 0 }, &consts))
@@ -348,74 +631,50 @@ Result dlssdBeginEvent(chi::CommandList pCmdList, const common::EventData& data,
         return Result::eErrorInvalidIntegration;
     }
 
-    // Must check here, before we overwrite viewport.consts
-    bool modeOrSizeChanged = consts->mode != viewport.consts.mode || consts->outputWidth != viewport.consts.outputWidth || consts->outputHeight != viewport.consts.outputHeight || consts->normalRoughnessMode != viewport.consts.normalRoughnessMode;
+    // Pick up the replacement feature if it finished creating in the background
+    if (viewport.pendingHandle.valid() && viewport.pendingHandle.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+        swapPendingHandle(viewport);
+    }
+
+    // Compared with what the feature was created with, options can change again while a replacement is being created
+    bool modeOrSizeChanged = consts->mode != viewport.createdConsts.mode || consts->outputWidth != viewport.createdConsts.outputWidth || consts->outputHeight != viewport.createdConsts.outputHeight || consts->normalRoughnessMode != viewport.createdConsts.normalRoughnessMode;
     if (consts->structVersion >= kStructVersion3)
     {
         modeOrSizeChanged = modeOrSizeChanged  ||
-                            consts->dlaaPreset != viewport.consts.dlaaPreset ||
-                            consts->qualityPreset != viewport.consts.qualityPreset ||
-                            consts->balancedPreset != viewport.consts.balancedPreset ||
-                            consts->performancePreset != viewport.consts.performancePreset ||
-                            consts->ultraPerformancePreset != viewport.consts.ultraPerformancePreset ||
-                            consts->ultraQualityPreset != viewport.consts.ultraQualityPreset;
+                            consts->dlaaPreset != viewport.createdConsts.dlaaPreset ||
+                            consts->qualityPreset != viewport.createdConsts.qualityPreset ||
+                            consts->balancedPreset != viewport.createdConsts.balancedPreset ||
+                            consts->performancePreset != viewport.createdConsts.performancePreset ||
+                            consts->ultraPerformancePreset != viewport.createdConsts.ultraPerformancePreset ||
+                            consts->ultraQualityPreset != viewport.createdConsts.ultraQualityPreset;
     }
 
     ctx.viewport = &viewport;
     viewport.consts = *consts;  // mandatory
 
-    if(!viewport.handle || modeOrSizeChanged)
+    // One replacement at a time, any further change is picked up once it is swapped in
+    if((!viewport.handle || modeOrSizeChanged) && !viewport.pendingHandle.valid())
     {
-        ctx.commonConsts->reset = Boolean::eTrue;
-        ctx.cachedStates.clear();
         slGetData(consts, &viewport.settings, pCmdList);
 
         if(ctx.ngxContext)
         {
-            if (viewport.handle)
-            {
-                SL_LOG_INFO("Detected resize, recreating DLSSDContext feature");
-                // Errors logged by sl.common
-                ctx.ngxContext->releaseFeature(viewport.handle, "sl.dlss_d");
-                viewport.handle = {};
-                ctx.compute->destroyResource(viewport.mvec);
-            }
-
             {
-                int dlssCreateFlags = NVSDK_NGX_DLSS_Feature_Flags_MVLowRes;
-                if (consts->colorBuffersHDR == Boolean::eTrue)
-                {
-                    dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_IsHDR;
-                }
-                if (consts->sharpness > 0.0f)
-                {
-                    dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_DoSharpening;
-                }
-                if (ctx.commonConsts->depthInverted == Boolean::eTrue)
-                {
-                    dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_DepthInverted;
-                }
-                if (ctx.commonConsts->motionVectorsJittered == Boolean::eTrue)
-                {
-                    dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_MVJittered;
-                }
-                if (consts->structVersion >= kStructVersion2 && consts->alphaUpscalingEnabled == Boolean::eTrue)
-                {
-                    dlssCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_AlphaUpscaling;
-                }
-
                 // Mandatory
-                CommonResource colorIn{};
-                CommonResource colorOut{};
-                CommonResource linearDepth{};
-                CommonResource hwDepth{};
-                CommonResource mvec{};
-
-                SL_CHECK(getTaggedResource(kBufferTypeScalingInputColor, colorIn, data.frame, ctx.viewport->id, false, inputs, numInputs));
-                SL_CHECK(getTaggedResource(kBufferTypeScalingOutputColor, colorOut, data.frame, ctx.viewport->id, false, inputs, numInputs));
-                SL_CHECK(getTaggedResource(kBufferTypeLinearDepth, linearDepth, data.frame, ctx.viewport->id, true, inputs, numInputs));
-                SL_CHECK(getTaggedResource(kBufferTypeDepth, hwDepth, data.frame, ctx.viewport->id, true, inputs, numInputs));
-                SL_CHECK(getTaggedResource(kBufferTypeMotionVectors, mvec, data.frame, ctx.viewport->id, false, inputs, numInputs));
+                const BufferType mandatoryTags[] = { kBufferTypeScalingInputColor, kBufferTypeScalingOutputColor, kBufferTypeMotionVectors };
+                CommonResource mandatory[countof(mandatoryTags)]{};
+                SL_CHECK(getTaggedResources(mandatoryTags, (uint32_t)countof(mandatoryTags), mandatory, data.frame, ctx.viewport->id, false, inputs, numInputs));
+                auto& colorIn = mandatory[0];
+                auto& colorOut = mandatory[1];
+                auto& mvec = mandatory[2];
+
+                // Either one of the depths
+                const BufferType depthTags[] = { kBufferTypeLinearDepth, kBufferTypeDepth };
+                CommonResource depths[countof(depthTags)]{};
+                getTaggedResources(depthTags, (uint32_t)countof(depthTags), depths, data.frame, ctx.viewport->id, true, inputs, numInputs);
+                auto& linearDepth = depths[0];
+                auto& hwDepth = depths[1];
 
                 CommonResource& depth = linearDepth ? linearDepth : hwDepth;
 
@@ -457,29 +716,56 @@ Result dlssdBeginEvent(chi::CommandList pCmdList, const common::EventData& data,
                     depthExt = { 0,0,desc.width,desc.height };
                 }
 
+                bool mvecLowRes = true;
                 if (mvecExt.width > colorInExt.width || mvecExt.height > colorInExt.height)
                 {
                     SL_LOG_INFO("Detected high resolution mvec for DLSSDContext");
-                    dlssCreateFlags &= ~NVSDK_NGX_DLSS_Feature_Flags_MVLowRes;
+                    mvecLowRes = false;
+                }
+
+                auto key = getFeatureKey(viewport.consts, viewport.settings, getCreateFlags(viewport.consts, ctx.commonConsts, mvecLowRes), (bool)linearDepth);
+                viewport.createdConsts = viewport.consts;
+
+                // Used before with exactly the same parameters
+                uint64_t cachedBytes{};
+                if (auto cached = ctx.featureCache.take(data.id, key, cachedBytes))
+                {
+                    SL_LOG_INFO("Using cached DLSSDContext feature (%u,%u)(optimal) -> (%u,%u) for viewport %u", key.renderWidth, key.renderHeight, key.outputWidth, key.outputHeight, data.id);
+                    retireFeature(viewport);
+                    viewport.handle = cached;
+                    viewport.bytes = cachedBytes;
+                    viewport.key = key;
+                    ctx.commonConsts->reset = Boolean::eTrue;
+                    ctx.cachedStates.clear();
+                    return Result::eOk;
                 }
 
-                NVSDK_NGX_PerfQuality_Value perfQualityValue = (NVSDK_NGX_PerfQuality_Value)((uint32_t)viewport.consts.mode - 1);
-
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_CreationNodeMask, 1);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_VisibilityNodeMask, 1);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Width, viewport.settings.optimalRenderWidth);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Height, viewport.settings.optimalRenderHeight);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_OutWidth, viewport.consts.outputWidth);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_OutHeight, viewport.consts.outputHeight);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_PerfQualityValue, perfQualityValue);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Feature_Create_Flags, dlssCreateFlags);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_FreeMemOnReleaseFeature, 1);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Denoise_Mode, NVSDK_NGX_DLSS_Denoise_Mode_DLUnified);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Roughness_Mode, 
-                    viewport.consts.normalRoughnessMode == DLSSDNormalRoughnessMode::eUnpacked ? NVSDK_NGX_DLSS_Roughness_Mode_Unpacked : NVSDK_NGX_DLSS_Roughness_Mode_Packed);
-                ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Use_HW_Depth, linearDepth ? NVSDK_NGX_DLSS_Depth_Type_Linear : NVSDK_NGX_DLSS_Depth_Type_HW);
-
-                if (ctx.ngxContext->createFeature(pCmdList, NVSDK_NGX_Feature_RayReconstruction, &viewport.handle, "sl.dlss_d"))
+                if (canCreateInBackground(viewport, key))
+                {
+                    if (!ctx.createCmdList)
+                    {
+                        CHI_VALIDATE(ctx.compute->createCommandQueue(chi::CommandQueueType::eGraphics, ctx.createQueue, "sl.dlss_d.create"));
+                        CHI_VALIDATE(ctx.compute->createCommandListContext(ctx.createQueue, 1, ctx.createCmdList, "sl.dlss_d.create"));
+                    }
+                    // Keep evaluating with the current feature meanwhile, it supports the new input size
+                    SL_LOG_INFO("Recreating DLSSDContext feature in the background for viewport %u", data.id);
+                    viewport.pendingKey = key;
+                    viewport.pendingBaseBytes = getNGXAllocatedBytes();
+                    viewport.pendingHandle = std::async(std::launch::async, createFeatureInBackground, key, data.id);
+                    return Result::eOk;
+                }
+
+                ctx.commonConsts->reset = Boolean::eTrue;
+                ctx.cachedStates.clear();
+
+                if (viewport.handle)
+                {
+                    SL_LOG_INFO("Detected resize, recreating DLSSDContext feature");
+                    retireFeature(viewport);
+                }
+
+                viewport.key = key;
+                if (createFeature(pCmdList, key, viewport.handle, viewport.bytes))
                 {
                     SL_LOG_INFO("Created DLSSDContext feature (%u,%u)(optimal) -> (%u,%u) for viewport %u", viewport.settings.optimalRenderWidth, viewport.settings.optimalRenderHeight, viewport.consts.outputWidth, viewport.consts.outputHeight, data.id);
                     // Log the extent information for easier debugging
@@ -504,107 +790,79 @@ Result dlssdEndEvent(chi::CommandList pCmdList, const common::EventData& data, c
         Constants* consts = ctx.commonConsts;
         
         {
-            CommonResource colorIn{};
-            CommonResource colorOut{};
-            CommonResource linearDepth{};
-            CommonResource hwDepth{};
-            CommonResource mvec{};
-            CommonResource albedo{};
-            CommonResource specularAlbedo{};
-            CommonResource normals{};
-            CommonResource roughness{};
-            CommonResource reflectedAlbedo{};
-            CommonResource colorBeforeParticles{};
-            CommonResource colorBeforeTransparency{};
-            CommonResource colorBeforeFog{};
-            CommonResource diffuseHitDistance{};
-            CommonResource specularHitDistance{};
-            CommonResource diffuseRayDirection{};
-            CommonResource specularRayDirection{};
-            CommonResource diffuseRayDirectionHitDistance{};
-            CommonResource specularRayDirectionHitDistance{};
-            CommonResource hiResDepth{};
-            CommonResource specularMotionVector{};
-            CommonResource transparency{};
-            CommonResource exposure{};
-            CommonResource biasCurrentColor{};
-            CommonResource particle{};
-            CommonResource animTexture{};
-            CommonResource positionViewSpace{ };
-            CommonResource rayTraceDist{};
-            CommonResource mvecReflections{};
-            CommonResource transparencyLayer{};
-            CommonResource transparencyLayerOpacity{};
-            CommonResource colorAfterParticles{};
-            CommonResource colorAfterTransparency{};
-            CommonResource colorAfterFog{};
-            CommonResource screenSpaceSubsurfaceScatteringGuide{};
-            CommonResource colorBeforeScreenSpaceSubsurfaceScattering{};
-            CommonResource colorAfterScreenSpaceSubsurfaceScattering{};
-            CommonResource screenSpaceRefractionGuide{};
-            CommonResource colorBeforeScreenSpaceRefraction{};
-            CommonResource colorAfterScreenSpaceRefraction{};
-            CommonResource depthOfFieldGuide{};
-            CommonResource colorBeforeDepthOfField{};
-            CommonResource colorAfterDepthOfField{};
-            CommonResource disocclusionMask{};
-            CommonResource scalingOutputAlpha{};
-            CommonResource alpha{};
-
-            SL_CHECK(getTaggedResource(kBufferTypeScalingInputColor, colorIn, data.frame, ctx.viewport->id, false, inputs, numInputs));
-            SL_CHECK(getTaggedResource(kBufferTypeScalingOutputColor, colorOut, data.frame, ctx.viewport->id, false, inputs, numInputs));
-            SL_CHECK(getTaggedResource(kBufferTypeDepth, hwDepth, data.frame, ctx.viewport->id, true, inputs, numInputs));
-            SL_CHECK(getTaggedResource(kBufferTypeLinearDepth, linearDepth, data.frame, ctx.viewport->id, true, inputs, numInputs));
-            SL_CHECK(getTaggedResource(kBufferTypeMotionVectors, mvec, data.frame, ctx.viewport->id, false, inputs, numInputs));
-            SL_CHECK(getTaggedResource(kBufferTypeAlbedo, albedo, data.frame, ctx.viewport->id, false, inputs, numInputs));
-            SL_CHECK(getTaggedResource(kBufferTypeSpecularAlbedo, specularAlbedo, data.frame, ctx.viewport->id, false, inputs, numInputs));
-            if (ctx.viewport->consts.normalRoughnessMode == DLSSDNormalRoughnessMode::ePacked)
-            {
-                SL_CHECK(getTaggedResource(kBufferTypeNormalRoughness, normals, data.frame, ctx.viewport->id, false, inputs, numInputs));
-            }
-            else
+            // Resolved in batches, one lock of the tag container and one walk of the inputs per batch rather than per guide
+            const bool packedNormalRoughness = ctx.viewport->consts.normalRoughnessMode == DLSSDNormalRoughnessMode::ePacked;
+            const BufferType mandatoryTags[] = { kBufferTypeScalingInputColor, kBufferTypeScalingOutputColor, kBufferTypeMotionVectors, kBufferTypeAlbedo, kBufferTypeSpecularAlbedo,
+                                                 packedNormalRoughness ? kBufferTypeNormalRoughness : kBufferTypeNormals, kBufferTypeRoughness };
+            CommonResource mandatory[countof(mandatoryTags)]{};
+            // Roughness is in the w channel of the normals when packed so the last tag is skipped
+            SL_CHECK(getTaggedResources(mandatoryTags, (uint32_t)countof(mandatoryTags) - (packedNormalRoughness ? 1 : 0), mandatory, data.frame, ctx.viewport->id, false, inputs, numInputs));
+            auto& colorIn = mandatory[0];
+            auto& colorOut = mandatory[1];
+            auto& mvec = mandatory[2];
+            auto& albedo = mandatory[3];
+            auto& specularAlbedo = mandatory[4];
+            auto& normals = mandatory[5];
+            auto& roughness = mandatory[6];
+
+            // Optional
+            const BufferType optionalTags[] =
             {
-                SL_CHECK(getTaggedResource(kBufferTypeNormals, normals, data.frame, ctx.viewport->id, false, inputs, numInputs));
-                SL_CHECK(getTaggedResource(kBufferTypeRoughness, roughness, data.frame, ctx.viewport->id, false, inputs, numInputs));
-            }
-
-            getTaggedResource(kBufferTypeReflectedAlbedo, reflectedAlbedo, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeColorBeforeParticles, colorBeforeParticles, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeColorBeforeTransparency, colorBeforeTransparency, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeColorBeforeFog, colorBeforeFog, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeDiffuseHitDistance, diffuseHitDistance, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeSpecularHitDistance, specularHitDistance, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeDiffuseRayDirection, diffuseRayDirection, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeSpecularRayDirection, specularRayDirection, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeDiffuseRayDirectionHitDistance, diffuseRayDirectionHitDistance, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeSpecularRayDirectionHitDistance, specularRayDirectionHitDistance, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeHiResDepth, hiResDepth, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeSpecularMotionVectors, specularMotionVector, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeTransparencyHint, transparency, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeExposure, exposure, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeBiasCurrentColorHint, biasCurrentColor, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeParticleHint, particle, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeAnimatedTextureHint, animTexture, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypePosition, positionViewSpace, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeRaytracingDistance, rayTraceDist, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeReflectionMotionVectors, mvecReflections, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeTransparencyLayer, transparencyLayer, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeTransparencyLayerOpacity, transparencyLayerOpacity, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeColorAfterParticles, colorAfterParticles, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeColorAfterTransparency, colorAfterTransparency, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeColorAfterFog, colorAfterFog, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeScreenSpaceSubsurfaceScatteringGuide, screenSpaceSubsurfaceScatteringGuide, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeColorBeforeScreenSpaceSubsurfaceScattering, colorBeforeScreenSpaceSubsurfaceScattering, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeColorAfterScreenSpaceSubsurfaceScattering, colorAfterScreenSpaceSubsurfaceScattering, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeScreenSpaceRefractionGuide, screenSpaceRefractionGuide, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeColorBeforeScreenSpaceRefraction, colorBeforeScreenSpaceRefraction, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeColorAfterScreenSpaceRefraction, colorAfterScreenSpaceRefraction, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeDepthOfFieldGuide, depthOfFieldGuide, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeColorBeforeDepthOfField, colorBeforeDepthOfField, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeColorAfterDepthOfField, colorAfterDepthOfField, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeDisocclusionMask, disocclusionMask, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeScalingOutputAlpha, scalingOutputAlpha, data.frame, ctx.viewport->id, true, inputs, numInputs);
-            getTaggedResource(kBufferTypeAlpha, alpha, data.frame, ctx.viewport->id, true, inputs, numInputs);
+                kBufferTypeLinearDepth, kBufferTypeDepth, kBufferTypeReflectedAlbedo,
+                kBufferTypeColorBeforeParticles, kBufferTypeColorBeforeTransparency, kBufferTypeColorBeforeFog,
+                kBufferTypeDiffuseHitDistance, kBufferTypeSpecularHitDistance, kBufferTypeDiffuseRayDirection,
+                kBufferTypeSpecularRayDirection, kBufferTypeDiffuseRayDirectionHitDistance, kBufferTypeSpecularRayDirectionHitDistance,
+                kBufferTypeHiResDepth, kBufferTypeSpecularMotionVectors, kBufferTypeTransparencyHint,
+                kBufferTypeExposure, kBufferTypeBiasCurrentColorHint, kBufferTypeParticleHint,
+                kBufferTypeAnimatedTextureHint, kBufferTypePosition, kBufferTypeRaytracingDistance,
+                kBufferTypeReflectionMotionVectors, kBufferTypeTransparencyLayer, kBufferTypeTransparencyLayerOpacity,
+                kBufferTypeColorAfterParticles, kBufferTypeColorAfterTransparency, kBufferTypeColorAfterFog,
+                kBufferTypeScreenSpaceSubsurfaceScatteringGuide, kBufferTypeColorBeforeScreenSpaceSubsurfaceScattering, kBufferTypeColorAfterScreenSpaceSubsurfaceScattering,
+                kBufferTypeScreenSpaceRefractionGuide, kBufferTypeColorBeforeScreenSpaceRefraction, kBufferTypeColorAfterScreenSpaceRefraction,
+                kBufferTypeDepthOfFieldGuide, kBufferTypeColorBeforeDepthOfField, kBufferTypeColorAfterDepthOfField,
+                kBufferTypeDisocclusionMask, kBufferTypeScalingOutputAlpha, kBufferTypeAlpha
+            };
+            CommonResource optionalRes[countof(optionalTags)]{};
+            getTaggedResources(optionalTags, (uint32_t)countof(optionalTags), optionalRes, data.frame, ctx.viewport->id, true, inputs, numInputs);
+            auto& linearDepth = optionalRes[0];
+            auto& hwDepth = optionalRes[1];
+            auto& reflectedAlbedo = optionalRes[2];
+            auto& colorBeforeParticles = optionalRes[3];
+            auto& colorBeforeTransparency = optionalRes[4];
+            auto& colorBeforeFog = optionalRes[5];
+            auto& diffuseHitDistance = optionalRes[6];
+            auto& specularHitDistance = optionalRes[7];
+            auto& diffuseRayDirection = optionalRes[8];
+            auto& specularRayDirection = optionalRes[9];
+            auto& diffuseRayDirectionHitDistance = optionalRes[10];
+            auto& specularRayDirectionHitDistance = optionalRes[11];
+            auto& hiResDepth = optionalRes[12];
+            auto& specularMotionVector = optionalRes[13];
+            auto& transparency = optionalRes[14];
+            auto& exposure = optionalRes[15];
+            auto& biasCurrentColor = optionalRes[16];
+            auto& particle = optionalRes[17];
+            auto& animTexture = optionalRes[18];
+            auto& positionViewSpace = optionalRes[19];
+            auto& rayTraceDist = optionalRes[20];
+            auto& mvecReflections = optionalRes[21];
+            auto& transparencyLayer = optionalRes[22];
+            auto& transparencyLayerOpacity = optionalRes[23];
+            auto& colorAfterParticles = optionalRes[24];
+            auto& colorAfterTransparency = optionalRes[25];
+            auto& colorAfterFog = optionalRes[26];
+            auto& screenSpaceSubsurfaceScatteringGuide = optionalRes[27];
+            auto& colorBeforeScreenSpaceSubsurfaceScattering = optionalRes[28];
+            auto& colorAfterScreenSpaceSubsurfaceScattering = optionalRes[29];
+            auto& screenSpaceRefractionGuide = optionalRes[30];
+            auto& colorBeforeScreenSpaceRefraction = optionalRes[31];
+            auto& colorAfterScreenSpaceRefraction = optionalRes[32];
+            auto& depthOfFieldGuide = optionalRes[33];
+            auto& colorBeforeDepthOfField = optionalRes[34];
+            auto& colorAfterDepthOfField = optionalRes[35];
+            auto& disocclusionMask = optionalRes[36];
+            auto& scalingOutputAlpha = optionalRes[37];
+            auto& alpha = optionalRes[38];
 
             CommonResource& depth = linearDepth ? linearDepth : hwDepth;
 
@@ -701,9 +959,16 @@ Result dlssdEndEvent(chi::CommandList pCmdList, const common::EventData& data, c
             // Depending if camera motion is provided or not we can use input directly or not
             auto mvecIn = mvec;
 
-#if SL_ENABLE_TIMING
-            CHI_VALIDATE(ctx.compute->beginPerfSection(pCmdList, "sl.dlss_d"));
-#endif
+            // Timed in all builds so hosts can read GPU cost per viewport, d3d11 waits on its queries so only there in dev builds
+            bool timed = SL_ENABLE_TIMING || ctx.platform != RenderAPI::eD3D11;
+            if (timed)
+            {
+                if (ctx.viewport->perfSection.empty())
+                {
+                    ctx.viewport->perfSection = extra::format("sl.dlss_d.{}", ctx.viewport->id);
+                }
+                CHI_VALIDATE(ctx.compute->beginPerfSection(pCmdList, ctx.viewport->perfSection.c_str()));
+            }
             {
                 ctx.cacheState(colorIn, colorIn.getState());
                 ctx.cacheState(colorOut, colorOut.getState());
@@ -795,6 +1060,7 @@ Result dlssdEndEvent(chi::CommandList pCmdList, const common::EventData& data, c
                     mvecPixelSpace = true;
 
                     // No camera motion, need to compute ourselves and store in ctx.mvec
+                    chi::ScopedProfilingSection section(ctx.compute, pCmdList, "sl.dlss_d.mvec");
                     extra::ScopedTasks revTransitions;
                     chi::ResourceTransition transitions[] =
                     {
@@ -809,6 +1075,8 @@ Result dlssdEndEvent(chi::CommandList pCmdList, const common::EventData& data, c
                         sl::float4 texSize;
                         sl::float2 mvecScale;
                         uint32_t debug;
+                        uint32_t padding;
+                        sl::float2 jitterDelta;
                     };
                     MVecParamStruct cb;
                     cb.texSize.x = (float)renderWidth;
@@ -817,15 +1085,23 @@ Result dlssdEndEvent(chi::CommandList pCmdList, const common::EventData& data, c
                     cb.texSize.w = 1.0f / renderHeight;
                     cb.mvecScale = { consts->mvecScale.x, consts->mvecScale.y }; // scaling everything to -1,1 range then to -width,width
                     cb.debug = 0;
+                    cb.padding = 0;
+                    // Removing jitter in the same pass, NGX gets unjittered vectors whenever we compute camera motion
+                    cb.jitterDelta = {};
+                    if (consts->motionVectorsJittered == Boolean::eTrue && consts->reset != Boolean::eTrue)
+                    {
+                        cb.jitterDelta = { consts->jitterOffset.x - ctx.viewport->prevJitterOffset.x, consts->jitterOffset.y - ctx.viewport->prevJitterOffset.y };
+                    }
                     memcpy(&cb.clipToPrevClip, &consts->clipToPrevClip, sizeof(float) * 16);
                     CHI_VALIDATE(ctx.compute->bindKernel(ctx.mvecKernel));
                     CHI_VALIDATE(ctx.compute->bindTexture(0, 0, mvec));
                     CHI_VALIDATE(ctx.compute->bindTexture(1, 1, depth));
                     CHI_VALIDATE(ctx.compute->bindRWTexture(2, 0, ctx.viewport->mvec));
-                    CHI_VALIDATE(ctx.compute->bindConsts(3, 0, &cb, sizeof(MVecParamStruct), kMaxNumViewports * 3));
+                    CHI_VALIDATE(ctx.compute->bindConsts(3, 0, &cb, sizeof(MVecParamStruct), ctx.maxNumViewports * 3));
                     uint32_t grid[] = { (renderWidth + 16 - 1) / 16, (renderHeight + 16 - 1) / 16, 1 };
                     CHI_VALIDATE(ctx.compute->dispatch(grid[0], grid[1], grid[2]));
                 }
+                ctx.viewport->prevJitterOffset = consts->jitterOffset;
 
                 if (ctx.ngxContext)
                 {
@@ -881,200 +1157,211 @@ Result dlssdEndEvent(chi::CommandList pCmdList, const common::EventData& data, c
                     };
                     ctx.compute->transitionResources(pCmdList, transitions, (uint32_t)countof(transitions), &revTransitions);
 
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Reset, consts->reset == Boolean::eTrue);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_MV_Scale_X, (mvecPixelSpace ? 1.0f : (float)(consts->mvecScale.x * renderWidth)));
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_MV_Scale_Y, (mvecPixelSpace ? 1.0f : (float)(consts->mvecScale.y * renderHeight)));
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Jitter_Offset_X, consts->jitterOffset.x);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Jitter_Offset_Y, consts->jitterOffset.y);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Sharpness, ctx.viewport->consts.sharpness);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Pre_Exposure, ctx.viewport->consts.preExposure);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Exposure_Scale, ctx.viewport->consts.exposureScale);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Width, renderWidth);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Height, renderHeight);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Indicator_Invert_X_Axis, ctx.viewport->consts.indicatorInvertAxisX);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Indicator_Invert_Y_Axis, ctx.viewport->consts.indicatorInvertAxisY);
+                    // Only values which changed since the last evaluate of this viewport reach NGX
+                    if (!ctx.viewport->evalParams)
+                    {
+                        ctx.viewport->evalParams = ctx.ngxContext->createParameterCache();
+                    }
+                    common::NGXCachedParameters params{ ctx.ngxContext, ctx.viewport->evalParams };
+
+                    params.set(NVSDK_NGX_Parameter_Reset, consts->reset == Boolean::eTrue);
+                    params.set(NVSDK_NGX_Parameter_MV_Scale_X, (mvecPixelSpace ? 1.0f : (float)(consts->mvecScale.x * renderWidth)));
+                    params.set(NVSDK_NGX_Parameter_MV_Scale_Y, (mvecPixelSpace ? 1.0f : (float)(consts->mvecScale.y * renderHeight)));
+                    params.set(NVSDK_NGX_Parameter_Jitter_Offset_X, consts->jitterOffset.x);
+                    params.set(NVSDK_NGX_Parameter_Jitter_Offset_Y, consts->jitterOffset.y);
+                    params.set(NVSDK_NGX_Parameter_Sharpness, ctx.viewport->consts.sharpness);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Pre_Exposure, ctx.viewport->consts.preExposure);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Exposure_Scale, ctx.viewport->consts.exposureScale);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Width, renderWidth);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Render_Subrect_Dimensions_Height, renderHeight);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Indicator_Invert_X_Axis, ctx.viewport->consts.indicatorInvertAxisX);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Indicator_Invert_Y_Axis, ctx.viewport->consts.indicatorInvertAxisY);
 
                     if (ctx.platform == RenderAPI::eVulkan)
                     {
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Color, ctx.cachedVkResource(colorIn));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Output, ctx.cachedVkResource(colorOut));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Depth, ctx.cachedVkResource(depth));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_MotionVectors, ctx.cachedVkResource(mvecIn));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DiffuseAlbedo, ctx.cachedVkResource(albedo));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_SpecularAlbedo, ctx.cachedVkResource(specularAlbedo));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_GBuffer_Normals, ctx.cachedVkResource(normals));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_GBuffer_Roughness, ctx.cachedVkResource(roughness));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ReflectedAlbedo, ctx.cachedVkResource(reflectedAlbedo));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeParticles, ctx.cachedVkResource(colorBeforeParticles));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeTransparency, ctx.cachedVkResource(colorBeforeTransparency));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeFog, ctx.cachedVkResource(colorBeforeFog));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_DiffuseHitDistance, ctx.cachedVkResource(diffuseHitDistance));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_SpecularHitDistance, ctx.cachedVkResource(specularHitDistance));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_DiffuseRayDirection, ctx.cachedVkResource(diffuseRayDirection));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_SpecularRayDirection, ctx.cachedVkResource(specularRayDirection));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_DiffuseRayDirectionHitDistance, ctx.cachedVkResource(diffuseRayDirectionHitDistance));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_SpecularRayDirectionHitDistance, ctx.cachedVkResource(specularRayDirectionHitDistance));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DepthHighRes, ctx.cachedVkResource(hiResDepth));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_GBuffer_SpecularMvec, ctx.cachedVkResource(specularMotionVector));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_TransparencyMask, ctx.cachedVkResource(transparency));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_ExposureTexture, ctx.cachedVkResource(exposure));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_Mask, ctx.cachedVkResource(biasCurrentColor));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_IsParticleMask, ctx.cachedVkResource(particle));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_AnimatedTextureMask, ctx.cachedVkResource(animTexture));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Position_ViewSpace, ctx.cachedVkResource(positionViewSpace));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_RayTracingHitDistance, ctx.cachedVkResource(rayTraceDist));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_MotionVectorsReflection, ctx.cachedVkResource(mvecReflections));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_TransparencyLayer, ctx.cachedVkResource(transparencyLayer));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_TransparencyLayerOpacity, ctx.cachedVkResource(transparencyLayerOpacity));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterParticles, ctx.cachedVkResource(colorAfterParticles));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterTransparency, ctx.cachedVkResource(colorAfterTransparency));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterFog, ctx.cachedVkResource(colorAfterFog));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ScreenSpaceSubsurfaceScatteringGuide, ctx.cachedVkResource(screenSpaceSubsurfaceScatteringGuide));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeScreenSpaceSubsurfaceScattering, ctx.cachedVkResource(colorBeforeScreenSpaceSubsurfaceScattering));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterScreenSpaceSubsurfaceScattering, ctx.cachedVkResource(colorAfterScreenSpaceSubsurfaceScattering));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ScreenSpaceRefractionGuide, ctx.cachedVkResource(screenSpaceRefractionGuide));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeScreenSpaceRefraction, ctx.cachedVkResource(colorBeforeScreenSpaceRefraction));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterScreenSpaceRefraction, ctx.cachedVkResource(colorAfterScreenSpaceRefraction));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_DepthOfFieldGuide, ctx.cachedVkResource(depthOfFieldGuide));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeDepthOfField, ctx.cachedVkResource(colorBeforeDepthOfField));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterDepthOfField, ctx.cachedVkResource(colorAfterDepthOfField));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_DisocclusionMask, ctx.cachedVkResource(disocclusionMask));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_Alpha, ctx.cachedVkResource(alpha));
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_OutputAlpha, ctx.cachedVkResource(scalingOutputAlpha));
+                        params.set(NVSDK_NGX_Parameter_Color, ctx.cachedVkResource(colorIn));
+                        params.set(NVSDK_NGX_Parameter_Output, ctx.cachedVkResource(colorOut));
+                        params.set(NVSDK_NGX_Parameter_Depth, ctx.cachedVkResource(depth));
+                        params.set(NVSDK_NGX_Parameter_MotionVectors, ctx.cachedVkResource(mvecIn));
+                        params.set(NVSDK_NGX_Parameter_DiffuseAlbedo, ctx.cachedVkResource(albedo));
+                        params.set(NVSDK_NGX_Parameter_SpecularAlbedo, ctx.cachedVkResource(specularAlbedo));
+                        params.set(NVSDK_NGX_Parameter_GBuffer_Normals, ctx.cachedVkResource(normals));
+                        params.set(NVSDK_NGX_Parameter_GBuffer_Roughness, ctx.cachedVkResource(roughness));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ReflectedAlbedo, ctx.cachedVkResource(reflectedAlbedo));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeParticles, ctx.cachedVkResource(colorBeforeParticles));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeTransparency, ctx.cachedVkResource(colorBeforeTransparency));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeFog, ctx.cachedVkResource(colorBeforeFog));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_DiffuseHitDistance, ctx.cachedVkResource(diffuseHitDistance));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_SpecularHitDistance, ctx.cachedVkResource(specularHitDistance));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_DiffuseRayDirection, ctx.cachedVkResource(diffuseRayDirection));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_SpecularRayDirection, ctx.cachedVkResource(specularRayDirection));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_DiffuseRayDirectionHitDistance, ctx.cachedVkResource(diffuseRayDirectionHitDistance));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_SpecularRayDirectionHitDistance, ctx.cachedVkResource(specularRayDirectionHitDistance));
+                        params.set(NVSDK_NGX_Parameter_DepthHighRes, ctx.cachedVkResource(hiResDepth));
+                        params.set(NVSDK_NGX_Parameter_GBuffer_SpecularMvec, ctx.cachedVkResource(specularMotionVector));
+                        params.set(NVSDK_NGX_Parameter_TransparencyMask, ctx.cachedVkResource(transparency));
+                        params.set(NVSDK_NGX_Parameter_ExposureTexture, ctx.cachedVkResource(exposure));
+                        params.set(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_Mask, ctx.cachedVkResource(biasCurrentColor));
+                        params.set(NVSDK_NGX_Parameter_IsParticleMask, ctx.cachedVkResource(particle));
+                        params.set(NVSDK_NGX_Parameter_AnimatedTextureMask, ctx.cachedVkResource(animTexture));
+                        params.set(NVSDK_NGX_Parameter_Position_ViewSpace, ctx.cachedVkResource(positionViewSpace));
+                        params.set(NVSDK_NGX_Parameter_RayTracingHitDistance, ctx.cachedVkResource(rayTraceDist));
+                        params.set(NVSDK_NGX_Parameter_MotionVectorsReflection, ctx.cachedVkResource(mvecReflections));
+                        params.set(NVSDK_NGX_Parameter_DLSS_TransparencyLayer, ctx.cachedVkResource(transparencyLayer));
+                        params.set(NVSDK_NGX_Parameter_DLSS_TransparencyLayerOpacity, ctx.cachedVkResource(transparencyLayerOpacity));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterParticles, ctx.cachedVkResource(colorAfterParticles));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterTransparency, ctx.cachedVkResource(colorAfterTransparency));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterFog, ctx.cachedVkResource(colorAfterFog));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ScreenSpaceSubsurfaceScatteringGuide, ctx.cachedVkResource(screenSpaceSubsurfaceScatteringGuide));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeScreenSpaceSubsurfaceScattering, ctx.cachedVkResource(colorBeforeScreenSpaceSubsurfaceScattering));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterScreenSpaceSubsurfaceScattering, ctx.cachedVkResource(colorAfterScreenSpaceSubsurfaceScattering));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ScreenSpaceRefractionGuide, ctx.cachedVkResource(screenSpaceRefractionGuide));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeScreenSpaceRefraction, ctx.cachedVkResource(colorBeforeScreenSpaceRefraction));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterScreenSpaceRefraction, ctx.cachedVkResource(colorAfterScreenSpaceRefraction));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_DepthOfFieldGuide, ctx.cachedVkResource(depthOfFieldGuide));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeDepthOfField, ctx.cachedVkResource(colorBeforeDepthOfField));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterDepthOfField, ctx.cachedVkResource(colorAfterDepthOfField));
+                        params.set(NVSDK_NGX_Parameter_DLSS_DisocclusionMask, ctx.cachedVkResource(disocclusionMask));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_Alpha, ctx.cachedVkResource(alpha));
+                        params.set(NVSDK_NGX_Parameter_DLSSD_OutputAlpha, ctx.cachedVkResource(scalingOutputAlpha));
 
                     }
                     else
                     {
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Color, (void*)colorIn);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Output, (void*)colorOut);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Depth, (void*)depth);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_MotionVectors, (void*)mvecIn);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DiffuseAlbedo, (void*)albedo);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_SpecularAlbedo, (void*)specularAlbedo);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_GBuffer_Normals, (void*)normals);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_GBuffer_Roughness, (void*)roughness);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ReflectedAlbedo, (void*)reflectedAlbedo);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeParticles, (void*)colorBeforeParticles);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeTransparency, (void*)colorBeforeTransparency);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeFog, (void*)colorBeforeFog);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_DiffuseHitDistance, (void*)diffuseHitDistance);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_SpecularHitDistance, (void*)specularHitDistance);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_DiffuseRayDirection, (void*)diffuseRayDirection);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_SpecularRayDirection, (void*)specularRayDirection);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_DiffuseRayDirectionHitDistance, (void*)diffuseRayDirectionHitDistance);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_SpecularRayDirectionHitDistance, (void*)specularRayDirectionHitDistance);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DepthHighRes, (void*)hiResDepth);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_GBuffer_SpecularMvec, (void*)specularMotionVector);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_TransparencyMask, (void*)transparency);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_ExposureTexture, (void*)exposure);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_Mask, (void*)biasCurrentColor);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_IsParticleMask, (void*)particle);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_AnimatedTextureMask, (void*)animTexture);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_Position_ViewSpace, (void*)positionViewSpace);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_RayTracingHitDistance, (void*)rayTraceDist);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_MotionVectorsReflection, (void*)mvecReflections);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_TransparencyLayer, (void*)transparencyLayer);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_TransparencyLayerOpacity, (void*)transparencyLayerOpacity);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterParticles, (void*)colorAfterParticles);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterTransparency, (void*)colorAfterTransparency);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterFog, (void*)colorAfterFog);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ScreenSpaceSubsurfaceScatteringGuide, (void*)screenSpaceSubsurfaceScatteringGuide);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeScreenSpaceSubsurfaceScattering, (void*)colorBeforeScreenSpaceSubsurfaceScattering);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterScreenSpaceSubsurfaceScattering, (void*)colorAfterScreenSpaceSubsurfaceScattering);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ScreenSpaceRefractionGuide, (void*)screenSpaceRefractionGuide);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeScreenSpaceRefraction, (void*)colorBeforeScreenSpaceRefraction);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterScreenSpaceRefraction, (void*)colorAfterScreenSpaceRefraction);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_DepthOfFieldGuide, (void*)depthOfFieldGuide);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeDepthOfField, (void*)colorBeforeDepthOfField);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterDepthOfField, (void*)colorAfterDepthOfField);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_DisocclusionMask, (void*)disocclusionMask);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_OutputAlpha, (void*)scalingOutputAlpha);
-                        ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_Alpha, (void*)alpha);
+                        params.set(NVSDK_NGX_Parameter_Color, (void*)colorIn);
+                        params.set(NVSDK_NGX_Parameter_Output, (void*)colorOut);
+                        params.set(NVSDK_NGX_Parameter_Depth, (void*)depth);
+                        params.set(NVSDK_NGX_Parameter_MotionVectors, (void*)mvecIn);
+                        params.set(NVSDK_NGX_Parameter_DiffuseAlbedo, (void*)albedo);
+                        params.set(NVSDK_NGX_Parameter_SpecularAlbedo, (void*)specularAlbedo);
+                        params.set(NVSDK_NGX_Parameter_GBuffer_Normals, (void*)normals);
+                        params.set(NVSDK_NGX_Parameter_GBuffer_Roughness, (void*)roughness);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ReflectedAlbedo, (void*)reflectedAlbedo);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeParticles, (void*)colorBeforeParticles);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeTransparency, (void*)colorBeforeTransparency);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeFog, (void*)colorBeforeFog);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_DiffuseHitDistance, (void*)diffuseHitDistance);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_SpecularHitDistance, (void*)specularHitDistance);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_DiffuseRayDirection, (void*)diffuseRayDirection);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_SpecularRayDirection, (void*)specularRayDirection);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_DiffuseRayDirectionHitDistance, (void*)diffuseRayDirectionHitDistance);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_SpecularRayDirectionHitDistance, (void*)specularRayDirectionHitDistance);
+                        params.set(NVSDK_NGX_Parameter_DepthHighRes, (void*)hiResDepth);
+                        params.set(NVSDK_NGX_Parameter_GBuffer_SpecularMvec, (void*)specularMotionVector);
+                        params.set(NVSDK_NGX_Parameter_TransparencyMask, (void*)transparency);
+                        params.set(NVSDK_NGX_Parameter_ExposureTexture, (void*)exposure);
+                        params.set(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_Mask, (void*)biasCurrentColor);
+                        params.set(NVSDK_NGX_Parameter_IsParticleMask, (void*)particle);
+                        params.set(NVSDK_NGX_Parameter_AnimatedTextureMask, (void*)animTexture);
+                        params.set(NVSDK_NGX_Parameter_Position_ViewSpace, (void*)positionViewSpace);
+                        params.set(NVSDK_NGX_Parameter_RayTracingHitDistance, (void*)rayTraceDist);
+                        params.set(NVSDK_NGX_Parameter_MotionVectorsReflection, (void*)mvecReflections);
+                        params.set(NVSDK_NGX_Parameter_DLSS_TransparencyLayer, (void*)transparencyLayer);
+                        params.set(NVSDK_NGX_Parameter_DLSS_TransparencyLayerOpacity, (void*)transparencyLayerOpacity);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterParticles, (void*)colorAfterParticles);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterTransparency, (void*)colorAfterTransparency);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterFog, (void*)colorAfterFog);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ScreenSpaceSubsurfaceScatteringGuide, (void*)screenSpaceSubsurfaceScatteringGuide);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeScreenSpaceSubsurfaceScattering, (void*)colorBeforeScreenSpaceSubsurfaceScattering);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterScreenSpaceSubsurfaceScattering, (void*)colorAfterScreenSpaceSubsurfaceScattering);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ScreenSpaceRefractionGuide, (void*)screenSpaceRefractionGuide);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeScreenSpaceRefraction, (void*)colorBeforeScreenSpaceRefraction);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterScreenSpaceRefraction, (void*)colorAfterScreenSpaceRefraction);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_DepthOfFieldGuide, (void*)depthOfFieldGuide);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeDepthOfField, (void*)colorBeforeDepthOfField);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterDepthOfField, (void*)colorAfterDepthOfField);
+                        params.set(NVSDK_NGX_Parameter_DLSS_DisocclusionMask, (void*)disocclusionMask);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_OutputAlpha, (void*)scalingOutputAlpha);
+                        params.set(NVSDK_NGX_Parameter_DLSSD_Alpha, (void*)alpha);
                     }
 
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_X, colorInExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_Y, colorInExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_X, colorOutExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_Y, colorOutExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_X, depthExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_Y, depthExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_X, mvecExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_Y, mvecExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_DiffuseAlbedo_Subrect_Base_X, albedoExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_DiffuseAlbedo_Subrect_Base_Y, albedoExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_SpecularAlbedo_Subrect_Base_X, specAlbedoExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_SpecularAlbedo_Subrect_Base_Y, specAlbedoExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Normals_Subrect_Base_X, normalsExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Normals_Subrect_Base_Y, normalsExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Roughness_Subrect_Base_X, roughnessExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Roughness_Subrect_Base_Y, roughnessExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ReflectedAlbedo_Subrect_Base_X, reflectedAlbedoExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ReflectedAlbedo_Subrect_Base_Y, reflectedAlbedoExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeParticles_Subrect_Base_X, colorBeforeParticlesExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeParticles_Subrect_Base_Y, colorBeforeParticlesExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeTransparency_Subrect_Base_X, colorBeforeTransparencyExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeTransparency_Subrect_Base_Y, colorBeforeTransparencyExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeFog_Subrect_Base_X, colorBeforeFogExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeFog_Subrect_Base_Y, colorBeforeFogExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_DiffuseHitDistance_Subrect_Base_X, diffuseRayDirectionExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_DiffuseHitDistance_Subrect_Base_Y, diffuseRayDirectionExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_SpecularHitDistance_Subrect_Base_X, specularHitDistanceExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_SpecularHitDistance_Subrect_Base_Y, specularHitDistanceExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_DiffuseRayDirection_Subrect_Base_X, diffuseRayDirectionExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_DiffuseRayDirection_Subrect_Base_Y, diffuseRayDirectionExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_SpecularRayDirection_Subrect_Base_X, specularRayDirectionExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_SpecularRayDirection_Subrect_Base_Y, specularRayDirectionExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_DiffuseRayDirectionHitDistance_Subrect_Base_X, diffuseRayDirectionHitDistanceExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_DiffuseRayDirectionHitDistance_Subrect_Base_Y, diffuseRayDirectionHitDistanceExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_SpecularRayDirectionHitDistance_Subrect_Base_X, specularRayDirectionHitDistanceExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_SpecularRayDirectionHitDistance_Subrect_Base_Y, specularRayDirectionHitDistanceExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Translucency_SubrectBase_X, transparencyExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Translucency_SubrectBase_Y, transparencyExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_X, biasCurrentColorExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_Y, biasCurrentColorExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_TransparencyLayer_Subrect_Base_X, transparencyLayerExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_TransparencyLayer_Subrect_Base_Y, transparencyLayerExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_TransparencyLayerOpacity_Subrect_Base_X, transparencyLayerOpacityExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_TransparencyLayerOpacity_Subrect_Base_Y, transparencyLayerOpacityExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterParticles_Subrect_Base_X, colorAfterParticlesExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterParticles_Subrect_Base_Y, colorAfterParticlesExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterTransparency_Subrect_Base_X, colorAfterTransparencyExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterTransparency_Subrect_Base_Y, colorAfterTransparencyExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ScreenSpaceSubsurfaceScatteringGuide_Subrect_Base_X, screenSpaceSubsurfaceScatteringGuideExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ScreenSpaceSubsurfaceScatteringGuide_Subrect_Base_Y, screenSpaceSubsurfaceScatteringGuideExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeScreenSpaceSubsurfaceScattering_Subrect_Base_X, colorBeforeScreenSpaceSubsurfaceScatteringExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeScreenSpaceSubsurfaceScattering_Subrect_Base_Y, colorBeforeScreenSpaceSubsurfaceScatteringExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterScreenSpaceSubsurfaceScattering_Subrect_Base_X, colorAfterScreenSpaceSubsurfaceScatteringExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterScreenSpaceSubsurfaceScattering_Subrect_Base_Y, colorAfterScreenSpaceSubsurfaceScatteringExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ScreenSpaceRefractionGuide_Subrect_Base_X, screenSpaceRefractionGuideExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ScreenSpaceRefractionGuide_Subrect_Base_Y, screenSpaceRefractionGuideExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeScreenSpaceRefraction_Subrect_Base_X, colorBeforeScreenSpaceRefractionExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeScreenSpaceRefraction_Subrect_Base_Y, colorBeforeScreenSpaceRefractionExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterScreenSpaceRefraction_Subrect_Base_X, colorAfterScreenSpaceRefractionExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterScreenSpaceRefraction_Subrect_Base_Y, colorAfterScreenSpaceRefractionExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_DepthOfFieldGuide_Subrect_Base_X, depthOfFieldGuideExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_DepthOfFieldGuide_Subrect_Base_Y, depthOfFieldGuideExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeDepthOfField_Subrect_Base_X, colorBeforeDepthOfFieldExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeDepthOfField_Subrect_Base_Y, colorBeforeDepthOfFieldExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterDepthOfField_Subrect_Base_X, colorAfterDepthOfFieldExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_ColorAfterDepthOfField_Subrect_Base_Y, colorAfterDepthOfFieldExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_DisocclusionMask_Subrect_Base_X, disocclusionMaskExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_DisocclusionMask_Subrect_Base_Y, disocclusionMaskExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_OutputAlpha_Subrect_Base_X, scalingOutputAlphaExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_OutputAlpha_Subrect_Base_Y, scalingOutputAlphaExt.top);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_Alpha_Subrect_Base_X, alphaExt.left);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSSD_Alpha_Subrect_Base_Y, alphaExt.top);
-
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_WORLD_TO_VIEW_MATRIX, &ctx.viewport->consts.worldToCameraView);
-                    ctx.ngxContext->params->Set(NVSDK_NGX_Parameter_DLSS_VIEW_TO_CLIP_MATRIX, &ctx.commonConsts->cameraViewToClip);
-
-                    ctx.ngxContext->evaluateFeature(pCmdList, ctx.viewport->handle, "sl.dlss_d");
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_X, colorInExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Color_Subrect_Base_Y, colorInExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_X, colorOutExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Output_Subrect_Base_Y, colorOutExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_X, depthExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Depth_Subrect_Base_Y, depthExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_X, mvecExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_MV_SubrectBase_Y, mvecExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_DiffuseAlbedo_Subrect_Base_X, albedoExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_DiffuseAlbedo_Subrect_Base_Y, albedoExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_SpecularAlbedo_Subrect_Base_X, specAlbedoExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_SpecularAlbedo_Subrect_Base_Y, specAlbedoExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Normals_Subrect_Base_X, normalsExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Normals_Subrect_Base_Y, normalsExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Roughness_Subrect_Base_X, roughnessExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Roughness_Subrect_Base_Y, roughnessExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ReflectedAlbedo_Subrect_Base_X, reflectedAlbedoExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ReflectedAlbedo_Subrect_Base_Y, reflectedAlbedoExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeParticles_Subrect_Base_X, colorBeforeParticlesExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeParticles_Subrect_Base_Y, colorBeforeParticlesExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeTransparency_Subrect_Base_X, colorBeforeTransparencyExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeTransparency_Subrect_Base_Y, colorBeforeTransparencyExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeFog_Subrect_Base_X, colorBeforeFogExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeFog_Subrect_Base_Y, colorBeforeFogExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_DiffuseHitDistance_Subrect_Base_X, diffuseRayDirectionExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_DiffuseHitDistance_Subrect_Base_Y, diffuseRayDirectionExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_SpecularHitDistance_Subrect_Base_X, specularHitDistanceExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_SpecularHitDistance_Subrect_Base_Y, specularHitDistanceExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_DiffuseRayDirection_Subrect_Base_X, diffuseRayDirectionExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_DiffuseRayDirection_Subrect_Base_Y, diffuseRayDirectionExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_SpecularRayDirection_Subrect_Base_X, specularRayDirectionExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_SpecularRayDirection_Subrect_Base_Y, specularRayDirectionExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_DiffuseRayDirectionHitDistance_Subrect_Base_X, diffuseRayDirectionHitDistanceExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_DiffuseRayDirectionHitDistance_Subrect_Base_Y, diffuseRayDirectionHitDistanceExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_SpecularRayDirectionHitDistance_Subrect_Base_X, specularRayDirectionHitDistanceExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_SpecularRayDirectionHitDistance_Subrect_Base_Y, specularRayDirectionHitDistanceExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Translucency_SubrectBase_X, transparencyExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Translucency_SubrectBase_Y, transparencyExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_X, biasCurrentColorExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_Input_Bias_Current_Color_SubrectBase_Y, biasCurrentColorExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSS_TransparencyLayer_Subrect_Base_X, transparencyLayerExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_TransparencyLayer_Subrect_Base_Y, transparencyLayerExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSS_TransparencyLayerOpacity_Subrect_Base_X, transparencyLayerOpacityExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_TransparencyLayerOpacity_Subrect_Base_Y, transparencyLayerOpacityExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterParticles_Subrect_Base_X, colorAfterParticlesExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterParticles_Subrect_Base_Y, colorAfterParticlesExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterTransparency_Subrect_Base_X, colorAfterTransparencyExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterTransparency_Subrect_Base_Y, colorAfterTransparencyExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ScreenSpaceSubsurfaceScatteringGuide_Subrect_Base_X, screenSpaceSubsurfaceScatteringGuideExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ScreenSpaceSubsurfaceScatteringGuide_Subrect_Base_Y, screenSpaceSubsurfaceScatteringGuideExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeScreenSpaceSubsurfaceScattering_Subrect_Base_X, colorBeforeScreenSpaceSubsurfaceScatteringExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeScreenSpaceSubsurfaceScattering_Subrect_Base_Y, colorBeforeScreenSpaceSubsurfaceScatteringExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterScreenSpaceSubsurfaceScattering_Subrect_Base_X, colorAfterScreenSpaceSubsurfaceScatteringExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterScreenSpaceSubsurfaceScattering_Subrect_Base_Y, colorAfterScreenSpaceSubsurfaceScatteringExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ScreenSpaceRefractionGuide_Subrect_Base_X, screenSpaceRefractionGuideExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ScreenSpaceRefractionGuide_Subrect_Base_Y, screenSpaceRefractionGuideExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeScreenSpaceRefraction_Subrect_Base_X, colorBeforeScreenSpaceRefractionExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeScreenSpaceRefraction_Subrect_Base_Y, colorBeforeScreenSpaceRefractionExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterScreenSpaceRefraction_Subrect_Base_X, colorAfterScreenSpaceRefractionExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterScreenSpaceRefraction_Subrect_Base_Y, colorAfterScreenSpaceRefractionExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_DepthOfFieldGuide_Subrect_Base_X, depthOfFieldGuideExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_DepthOfFieldGuide_Subrect_Base_Y, depthOfFieldGuideExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeDepthOfField_Subrect_Base_X, colorBeforeDepthOfFieldExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorBeforeDepthOfField_Subrect_Base_Y, colorBeforeDepthOfFieldExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterDepthOfField_Subrect_Base_X, colorAfterDepthOfFieldExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_ColorAfterDepthOfField_Subrect_Base_Y, colorAfterDepthOfFieldExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSS_DisocclusionMask_Subrect_Base_X, disocclusionMaskExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSS_DisocclusionMask_Subrect_Base_Y, disocclusionMaskExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_OutputAlpha_Subrect_Base_X, scalingOutputAlphaExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_OutputAlpha_Subrect_Base_Y, scalingOutputAlphaExt.top);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_Alpha_Subrect_Base_X, alphaExt.left);
+                    params.set(NVSDK_NGX_Parameter_DLSSD_Alpha_Subrect_Base_Y, alphaExt.top);
+
+                    params.set(NVSDK_NGX_Parameter_DLSS_WORLD_TO_VIEW_MATRIX, &ctx.viewport->consts.worldToCameraView);
+                    params.set(NVSDK_NGX_Parameter_DLSS_VIEW_TO_CLIP_MATRIX, &ctx.commonConsts->cameraViewToClip);
+
+                    {
+                        chi::ScopedProfilingSection section(ctx.compute, pCmdList, "sl.dlss_d.ngx");
+                        ctx.ngxContext->evaluateFeatureWithCache(pCmdList, ctx.viewport->handle, ctx.viewport->evalParams, "sl.dlss_d");
+                    }
                 }
 
                 float ms = 0;
-#if SL_ENABLE_TIMING
-                CHI_VALIDATE(ctx.compute->endPerfSection(pCmdList, "sl.dlss_d", ms));
-#endif
+                if (timed)
+                {
+                    CHI_VALIDATE(ctx.compute->endPerfSection(pCmdList, ctx.viewport->perfSection.c_str(), ms));
+                }
 
 #ifndef SL_PRODUCTION
                 /*static std::string s_stats;
@@ -1087,11 +1374,8 @@ Result dlssdEndEvent(chi::CommandList pCmdList, const common::EventData& data, c
                 {
                     uint64_t bytes;
                     ctx.compute->getAllocatedBytes(bytes, "sl.dlss_d");
-                    std::scoped_lock lock(ctx.uiStats.mtx);
-                    ctx.uiStats.mode = getDLSSModeAsStr(ctx.viewport->consts.mode);
-                    ctx.uiStats.viewport = extra::format("Viewport {}x{} -> {}x{}", renderWidth, renderHeight, ctx.viewport->consts.outputWidth, ctx.viewport->consts.outputHeight);
-                    ctx.uiStats.runtime = extra::format("{}ms", ms);
-                    ctx.uiStats.vram = extra::format("{}GB", bytes / (1024.0 * 1024.0 * 1024.0));
+                    ctx.uiStats.publish({ ctx.viewport->consts.mode, ctx.viewport->id, renderWidth, renderHeight,
+                        ctx.viewport->consts.outputWidth, ctx.viewport->consts.outputHeight, ms, bytes });
                 }
 #endif
 
@@ -1182,6 +1466,27 @@ Result slGetData(const BaseStructure *inputs, BaseStructure *output, CommandBuff
         }
         // TODO: This has to return the correct estimate regardless if callback is present or not.
         ctx.ngxContext->params->Get(NVSDK_NGX_Parameter_SizeInBytes, &state->estimatedVRAMUsageInBytes);
+
+        if (state->structVersion >= kStructVersion2)
+        {
+            // Replacement still being created in the background, evaluating with the feature created for older options
+            auto viewport = findStruct<ViewportHandle>(inputs);
+            auto it = viewport ? ctx.viewports.find(*viewport) : ctx.viewports.end();
+            state->usingStaleFeature = it != ctx.viewports.end() && (*it).second.pendingHandle.valid() ? Boolean::eTrue : Boolean::eFalse;
+
+            if (state->structVersion >= kStructVersion3)
+            {
+                // Timings are resolved a few frames late so they stay zero until the viewport was evaluated a couple of times
+                chi::PerfSectionStats stats{};
+                if (it != ctx.viewports.end() && !(*it).second.perfSection.empty())
+                {
+                    ctx.compute->getPerfSectionStats((*it).second.perfSection.c_str(), stats);
+                }
+                state->gpuTimeLastMS = stats.lastMS;
+                state->gpuTimeAverageMS = stats.meanMS;
+                state->gpuTimeP99MS = stats.p99MS;
+            }
+        }
     }
     return Result::eOk;
 }
@@ -1202,6 +1507,16 @@ Result slFreeResources(Feature feature, const sl::ViewportHandle& viewport)
     if (it != ctx.viewports.end())
     {
         auto& instance = (*it).second;
+        if (instance.pendingHandle.valid())
+        {
+            if (auto handle = instance.pendingHandle.get().handle)
+            {
+                ctx.ngxContext->releaseFeature(handle, "sl.dlss_d");
+            }
+        }
+        ctx.featureCache.release(ctx.ngxContext, viewport);
+        ctx.idleFeatures.remove(viewport);
+        ctx.ngxContext->destroyParameterCache(instance.evalParams);
         if (instance.handle)
         {
             SL_LOG_INFO("Releasing DLSSDContext instance id %u", viewport);
@@ -1234,6 +1549,8 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
 
     auto parameters = api::getContext()->parameters;
 
+    ctx.maxNumViewports = common::getMaxNumViewports();
+
     getPointerParam(parameters, param::global::kNGXContext, &ctx.ngxContext);
 
     if (!ctx.ngxContext)
@@ -1290,8 +1607,20 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
     }
     else
     {
-        CHI_CHECK_RF(ctx.compute->createKernel((void*)mvec_cs, mvec_cs_len, "mvec.cs", "main", ctx.mvecKernel));
+        // SM 6.6 build indexes the descriptor heap directly and shares one root signature, see 'shaders/bindless.hlsli'
+        chi::ShaderCaps caps{};
+        ctx.compute->getShaderCaps(caps);
+        if (caps.bindlessResources)
+        {
+            CHI_CHECK_RF(ctx.compute->createKernel((void*)mvec_sm66_cs, mvec_sm66_cs_len, "mvec_sm66.cs", "main", ctx.mvecKernel));
+        }
+        else
+        {
+            CHI_CHECK_RF(ctx.compute->createKernel((void*)mvec_cs, mvec_cs_len, "mvec.cs", "main", ctx.mvecKernel));
+        }
     }
+    // Pipelines recorded by previous runs are created now rather than on the first evaluate
+    ctx.compute->prewarmKernels(&ctx.mvecKernel, 1);
 
     // Update our DLSS feature if update is available and host opted in
     ctx.ngxContext->updateFeature(NVSDK_NGX_Feature_RayReconstruction);
@@ -1317,25 +1646,26 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
             imgui::Float4 highlightColor{ 153.0f / 255.0f, 217.0f / 255.0f, 234.0f / 255.0f,1 };
 
             auto v = api::getContext()->pluginVersion;
-            std::scoped_lock lock(ctx.uiStats.mtx);
+            UIStats stats{};
+            bool active = ctx.uiStats.read(stats);
             uint32_t lastFrame, frame;
             if (api::getContext()->parameters->get(sl::param::dlss::kCurrentFrame, &lastFrame))
             {
                 ctx.compute->getFinishedFrameIndex(frame);
-                if (lastFrame < frame)
-                {
-                    ctx.uiStats.mode = "Mode: Off";
-                    ctx.uiStats.viewport = ctx.uiStats.runtime = {};
-                }
+                active &= lastFrame >= frame;
                 if (ui->collapsingHeader(extra::format("sl.dlss_d v{}", (v.toStr() + "." + GIT_LAST_COMMIT_SHORT)).c_str(), imgui::kTreeNodeFlagDefaultOpen))
                 {
                     ui->text("NGX v%s ", ctx.ngxVersion.c_str());
-                    ui->text(ctx.uiStats.mode.c_str());
-                    if (!ctx.uiStats.viewport.empty())
+                    if (active)
                     {
-                        ui->text(ctx.uiStats.viewport.c_str());
-                        ui->labelColored(greenColor, "Execution time: ", "%s", ctx.uiStats.runtime.c_str());
-                        ui->labelColored(highlightColor, "VRAM: ", "%s", ctx.uiStats.vram.c_str());
+                        ui->text(getDLSSModeAsStr(stats.mode));
+                        ui->text("Viewport %ux%u -> %ux%u", stats.renderWidth, stats.renderHeight, stats.outputWidth, stats.outputHeight);
+                        ui->labelColored(greenColor, "Execution time: ", "%.2fms", stats.runtimeMs);
+                        ui->labelColored(highlightColor, "VRAM: ", "%.2fGB", stats.vramBytes / (1024.0 * 1024.0 * 1024.0));
+                    }
+                    else
+                    {
+                        ui->text("Mode: Off");
                     }
                 }
             }
@@ -1359,11 +1689,27 @@ void slOnPluginShutdown()
     // Common shutdown
     plugin::onShutdown(api::getContext());
 
-    for(auto v : ctx.viewports)
+    for(auto& v : ctx.viewports)
     {
+        if (v.second.pendingHandle.valid())
+        {
+            if (auto handle = v.second.pendingHandle.get().handle)
+            {
+                ctx.ngxContext->releaseFeature(handle, "sl.dlss_d");
+            }
+        }
         ctx.ngxContext->releaseFeature(v.second.handle, "sl.dlss_d");
+        ctx.ngxContext->destroyParameterCache(v.second.evalParams);
         CHI_VALIDATE(ctx.compute->destroyResource(v.second.mvec));
     }
+    ctx.featureCache.release(ctx.ngxContext, UINT_MAX);
+    if (ctx.createCmdList)
+    {
+        CHI_VALIDATE(ctx.compute->destroyCommandListContext(ctx.createCmdList));
+        CHI_VALIDATE(ctx.compute->destroyCommandQueue(ctx.createQueue));
+        ctx.createCmdList = {};
+        ctx.createQueue = {};
+    }
     CHI_VALIDATE(ctx.compute->destroyKernel(ctx.mvecKernel));
 }
 
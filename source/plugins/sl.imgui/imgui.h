@@ -2635,6 +2635,14 @@ struct ImGUI
         imgui::Font* uiMediumFont{};
     };
     Fonts(*getFonts)();
+
+    //! Built-in performance panel (dev builds only)
+    //!
+    //! Each series gets a rolling histogram with P50/P95/P99 markers, GPU times of all chi perf sections
+    //! are shown as stacked bars. Registering the same name twice returns the same series.
+    //! Adding samples is lock-free and can be done from any thread.
+    PerfSeries(*registerPerfSeries)(const char* name);
+    void(*addPerfSample)(PerfSeries series, float ms);
 };
 
 }
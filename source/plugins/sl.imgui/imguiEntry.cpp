@@ -45,6 +45,7 @@
 #include "source/plugins/sl.imgui/imguiTypes.h"
 #include "source/plugins/sl.imgui/input.h"
 #include "source/plugins/sl.imgui/imgui.h"
+#include "source/plugins/sl.imgui/perfPanel.h"
 #include "source/plugins/sl.imgui/imgui_impl_dx12.h"
 #include "source/plugins/sl.imgui/imgui_impl_vulkan.h"
 #include "source/plugins/sl.imgui/imgui_impl_win32.h"
@@ -103,7 +104,17 @@ struct IMGUIContext
     float uiSmallFontSize = DEFAULT_SMALL_FONT_SIZE;
     float uiMediumFontSize = DEFAULT_MEDIUM_FONT_SIZE;
 
+    //! Rate in Hz at which the overlay is rebuilt, zero means every frame
+    //!
+    //! In between rebuilds the draw data from the last one is submitted again so plugin callbacks,
+    //! layout and uploads are all skipped. Meant for perf runs where the overlay must not skew frame times.
+    float overlayRefreshRate = 0.0f;
+    double overlayElapsedMs = 0.0;
+    bool overlayDrawDataValid = false;
+
     std::array<void*, NUM_BACK_BUFFERS> backBuffers = {};
+    //! Views were created for every swapchain buffer up front, present index alone selects the view
+    bool backBufferViewsFromSwapchain = false;
     BOOL  dxgiFullscreenState{};
 
     ID3D12Device* device{};
@@ -132,6 +143,10 @@ struct IMGUIContext
     uint32_t                  bufferCount            = 0;
     
     extra::AverageValueMeter  frameMeter             = {};
+
+    PerfSeriesStore           perfSeries             = {};
+    PerfSeries                presentSeries          = kInvalidPerfSeries;
+    std::vector<std::string>  perfSectionNames       = {};
     VkSwapchainKHR vkSwapchain{};
     std::unordered_map<VkSwapchainKHR, VKSwapchainInfo> vkSwapchainInfoMap{};
 };
@@ -400,6 +415,7 @@ void destroyContext(Context* ctx)
 {
     (void)(ctx);
     auto& pluginCtx = (*sl::imgui::getContext());
+    pluginCtx.overlayDrawDataValid = false;
 
     if (pluginCtx.platform == RenderAPI::eVulkan)
     {
@@ -435,9 +451,8 @@ void destroyContext(Context* ctx)
     delete g_ctx;
     g_ctx = {};
 
-    pluginCtx.backBuffers[0] = {};
-    pluginCtx.backBuffers[1] = {};
-    pluginCtx.backBuffers[2] = {};
+    pluginCtx.backBuffers = {};
+    pluginCtx.backBufferViewsFromSwapchain = false;
 
     pluginCtx.currentFrame = 0;
 }
@@ -478,7 +493,101 @@ void newFrame(float elapsedTime)
     ctx.currentFrame++;
 }
 
-void render(void* commandList, void* backBuffer, uint32_t index)
+static void createBackBufferViewD3D12(uint32_t index, ID3D12Resource* resource)
+{
+    auto& ctx = (*imgui::getContext());
+    ctx.backBuffers[index] = resource;
+    ctx.device->CreateRenderTargetView(resource, nullptr, ctx.mainRenderTargetDescriptor[index]);
+}
+
+static void createBackBufferViewVk(uint32_t index, VkImage image, uint32_t width, uint32_t height)
+{
+    auto& ctx = (*imgui::getContext());
+
+    // Image rotated under us (external swapchain), views must not leak
+    if (ctx.vkFrameBuffers[index])
+    {
+        vkDestroyFramebuffer(ctx.vkInfo.Device, ctx.vkFrameBuffers[index], nullptr);
+        ctx.vkFrameBuffers[index] = VK_NULL_HANDLE;
+    }
+    if (ctx.vkImageViews[index])
+    {
+        vkDestroyImageView(ctx.vkInfo.Device, ctx.vkImageViews[index], nullptr);
+        ctx.vkImageViews[index] = VK_NULL_HANDLE;
+    }
+    ctx.backBuffers[index] = image;
+
+    // Create The Image Views
+    {
+        VkImageViewCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        info.format = ctx.vkInfo.Format;
+        info.components.r = VK_COMPONENT_SWIZZLE_R;
+        info.components.g = VK_COMPONENT_SWIZZLE_G;
+        info.components.b = VK_COMPONENT_SWIZZLE_B;
+        info.components.a = VK_COMPONENT_SWIZZLE_A;
+        VkImageSubresourceRange image_range = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+        info.subresourceRange = image_range;
+        info.image = image;
+        vkCreateImageView(ctx.vkInfo.Device, &info, nullptr, &ctx.vkImageViews[index]);
+    }
+
+    // Create Framebuffer
+    {
+        VkImageView attachment[1];
+        VkFramebufferCreateInfo info = {};
+        info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        info.renderPass = (VkRenderPass)g_ctx->apiData;
+        info.attachmentCount = 1;
+        info.pAttachments = attachment;
+        info.width = width;
+        info.height = height;
+        info.layers = 1;
+        attachment[0] = ctx.vkImageViews[index];
+        vkCreateFramebuffer(ctx.vkInfo.Device, &info, nullptr, &ctx.vkFrameBuffers[index]);
+    }
+}
+
+//! Creates views for all swapchain buffers, called once per context (contexts are recreated on resize)
+static void createSwapchainViewsD3D12(IDXGISwapChain* swapChain, uint32_t bufferCount)
+{
+    auto& ctx = (*imgui::getContext());
+    if (bufferCount > NUM_BACK_BUFFERS)
+    {
+        SL_LOG_WARN("Swapchain has %u buffers, overlay supports up to %u", bufferCount, NUM_BACK_BUFFERS);
+        return;
+    }
+    for (uint32_t i = 0; i < bufferCount; i++)
+    {
+        ID3D12Resource* resource{};
+        if (FAILED(swapChain->GetBuffer(i, __uuidof(ID3D12Resource), (void**)&resource)))
+        {
+            return;
+        }
+        createBackBufferViewD3D12(i, resource);
+        resource->Release();
+    }
+    ctx.backBufferViewsFromSwapchain = true;
+}
+
+static void createSwapchainViewsVk(const std::vector<VkImage>& images, uint32_t width, uint32_t height)
+{
+    auto& ctx = (*imgui::getContext());
+    if (images.empty() || images.size() > NUM_BACK_BUFFERS)
+    {
+        SL_LOG_WARN("Swapchain has %u images, overlay supports 1 to %u", (uint32_t)images.size(), NUM_BACK_BUFFERS);
+        return;
+    }
+    for (uint32_t i = 0; i < (uint32_t)images.size(); i++)
+    {
+        createBackBufferViewVk(i, images[i], width, height);
+    }
+    ctx.backBufferViewsFromSwapchain = true;
+}
+
+//! Records the overlay, 'finalizeFrame' is false when re-submitting draw data from a previous ImGui::Render
+static void renderFrame(void* commandList, void* backBuffer, uint32_t index, bool finalizeFrame)
 {
     auto& ctx = (*imgui::getContext());
 
@@ -497,10 +606,10 @@ void render(void* commandList, void* backBuffer, uint32_t index)
 
         //ImVec4 clearColor = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
 
-        if (ctx.backBuffers[index] != backBuffer)
+        // Only external callers rendering into their own buffers need the lazy path
+        if (!ctx.backBufferViewsFromSwapchain && ctx.backBuffers[index] != backBuffer)
         {
-            ctx.backBuffers[index] = backBuffer;
-            ctx.device->CreateRenderTargetView(resource, nullptr, ctx.mainRenderTargetDescriptor[index]);
+            createBackBufferViewD3D12(index, resource);
         }
 
         cmdList->ResourceBarrier(1, &barrier);
@@ -508,7 +617,10 @@ void render(void* commandList, void* backBuffer, uint32_t index)
         cmdList->OMSetRenderTargets(1, &ctx.mainRenderTargetDescriptor[index], FALSE, NULL);
         cmdList->SetDescriptorHeaps(1, &ctx.pd3dSrvDescHeap);
 
-        ImGui::Render();
+        if (finalizeFrame)
+        {
+            ImGui::Render();
+        }
         ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), cmdList);
 
         barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
@@ -521,47 +633,18 @@ void render(void* commandList, void* backBuffer, uint32_t index)
         
         ImGuiIO& io = ImGui::GetIO();
 
-        if (ctx.backBuffers[index] != backBuffer)
+        // Only external callers rendering into their own buffers need the lazy path
+        if (!ctx.backBufferViewsFromSwapchain && ctx.backBuffers[index] != backBuffer)
         {
-            ctx.backBuffers[index] = backBuffer;
-
-            // Create The Image Views
-            {
-                VkImageViewCreateInfo info = {};
-                info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-                info.viewType = VK_IMAGE_VIEW_TYPE_2D;
-                info.format = ctx.vkInfo.Format;
-                info.components.r = VK_COMPONENT_SWIZZLE_R;
-                info.components.g = VK_COMPONENT_SWIZZLE_G;
-                info.components.b = VK_COMPONENT_SWIZZLE_B;
-                info.components.a = VK_COMPONENT_SWIZZLE_A;
-                VkImageSubresourceRange image_range = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
-                info.subresourceRange = image_range;
-                info.image = (VkImage)backBuffer;
-                assert(ctx.vkImageViews[index] == nullptr);
-                vkCreateImageView(ctx.vkInfo.Device, &info, nullptr, &ctx.vkImageViews[index]);
-            }
-
-            // Create Framebuffer
-            {
-                VkImageView attachment[1];
-                VkFramebufferCreateInfo info = {};
-                info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-                info.renderPass = (VkRenderPass)g_ctx->apiData;
-                info.attachmentCount = 1;
-                info.pAttachments = attachment;
-                info.width = (uint32_t)io.DisplaySize.x;
-                info.height = (uint32_t)io.DisplaySize.y;
-                info.layers = 1;
-                attachment[0] = ctx.vkImageViews[index];
-                assert(ctx.vkFrameBuffers[index] == nullptr);
-                vkCreateFramebuffer(ctx.vkInfo.Device, &info, nullptr, &ctx.vkFrameBuffers[index]);
-            }
+            createBackBufferViewVk(index, (VkImage)backBuffer, (uint32_t)io.DisplaySize.x, (uint32_t)io.DisplaySize.y);
         }
 
         ImGui_ImplVulkan_CreateFontsTexture(cmdBuffer);
 
-        ImGui::Render();
+        if (finalizeFrame)
+        {
+            ImGui::Render();
+        }
 
         VkRenderPassBeginInfo info = {};
         info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
@@ -577,6 +660,12 @@ void render(void* commandList, void* backBuffer, uint32_t index)
 
         vkCmdEndRenderPass(cmdBuffer);
     }
+    ctx.overlayDrawDataValid = true;
+}
+
+void render(void* commandList, void* backBuffer, uint32_t index)
+{
+    renderFrame(commandList, backBuffer, index, true);
 }
 
 void plotGraph(const Graph& graph, const std::vector<GraphValues>& values)
@@ -612,6 +701,8 @@ void toggleRenderInternal(bool val)
     auto& ctx = (*imgui::getContext());
     ctx.renderInternal = val;
     ctx.currentFrame = 0;
+    // External renderer brings its own buffers, back to tracking them by pointer
+    ctx.backBufferViewsFromSwapchain = ctx.backBufferViewsFromSwapchain && val;
     if (ctx.renderInternal)
     {
         ctx.frameMeter.reset();
@@ -634,6 +725,106 @@ ImGUI::Fonts getFonts()
     return imgui::getContext()->fonts;
 }
 
+PerfSeries registerPerfSeries(const char* name)
+{
+    auto& ctx = (*imgui::getContext());
+    auto series = ctx.perfSeries.registerSeries(name);
+    if (series == kInvalidPerfSeries)
+    {
+        SL_LOG_WARN("Too many performance series, '%s' will not be shown", name);
+    }
+    return series;
+}
+
+void addPerfSample(PerfSeries series, float ms)
+{
+    auto& ctx = (*imgui::getContext());
+    ctx.perfSeries.add(series, ms);
+}
+
+#ifndef SL_PRODUCTION
+//! Frame time histograms with percentile markers plus stacked GPU times of all perf sections
+static void renderPerfPanel()
+{
+    auto& ctx = (*imgui::getContext());
+    if (!ImGui::CollapsingHeader("Performance"))
+    {
+        return;
+    }
+
+    constexpr uint32_t kBins = 48;
+    static float s_samples[PerfSeriesStore::kHistory];
+    for (PerfSeries series = 0; series < ctx.perfSeries.getCount(); series++)
+    {
+        auto count = ctx.perfSeries.copy(series, s_samples, PerfSeriesStore::kHistory);
+        if (count < 2)
+        {
+            continue;
+        }
+        std::sort(s_samples, s_samples + count);
+        auto percentile = [count](float p)->double { return s_samples[std::min(count - 1, (uint32_t)(p * count))]; };
+        double markers[3] = { percentile(0.5f), percentile(0.95f), percentile(0.99f) };
+
+        // Range covers the tail but not single outliers
+        double binWidth = std::max(markers[2] * 1.25, 0.01) / kBins;
+        double bins[kBins]{}, centers[kBins];
+        for (uint32_t i = 0; i < kBins; i++)
+        {
+            centers[i] = (i + 0.5) * binWidth;
+        }
+        for (uint32_t i = 0; i < count; i++)
+        {
+            bins[std::min(kBins - 1, (uint32_t)(s_samples[i] / binWidth))] += 1.0;
+        }
+
+        auto name = ctx.perfSeries.getName(series);
+        ImGui::Text("%s P50 %.2fms P95 %.2fms P99 %.2fms", name, markers[0], markers[1], markers[2]);
+        ImGui::PushID((int)series);
+        if (ImPlot::BeginPlot("##histogram", ImVec2(-1, 120), ImPlotFlags_NoLegend | ImPlotFlags_NoMenus))
+        {
+            ImPlot::SetupAxes("ms", nullptr, 0, ImPlotAxisFlags_AutoFit | ImPlotAxisFlags_NoTickLabels);
+            ImPlot::SetupAxisLimits(ImAxis_X1, 0.0, binWidth * kBins, ImPlotCond_Always);
+            ImPlot::PlotBars("samples", centers, bins, kBins, binWidth);
+            ImPlot::PlotInfLines("percentiles", markers, 3);
+            ImPlot::EndPlot();
+        }
+        ImGui::PopID();
+    }
+
+    // GPU time per plugin pass, from the shared compute perf sections
+    ctx.compute->getPerfSectionNames(ctx.perfSectionNames);
+    if (ctx.perfSectionNames.empty())
+    {
+        return;
+    }
+    static std::vector<const char*> s_labels;
+    static std::vector<double> s_values;
+    s_labels.clear();
+    s_values.clear();
+    double total = 0.0;
+    for (auto& section : ctx.perfSectionNames)
+    {
+        chi::PerfSectionStats stats{};
+        if (ctx.compute->getPerfSectionStats(section.c_str(), stats) == chi::ComputeStatus::eOk && stats.numSamples)
+        {
+            s_labels.push_back(section.c_str());
+            s_values.push_back(stats.meanMS);
+            total += stats.meanMS;
+            ImGui::Text("%s mean %.3fms P99 %.3fms", section.c_str(), stats.meanMS, stats.p99MS);
+        }
+    }
+    if (!s_values.empty() && ImPlot::BeginPlot("##gpu", ImVec2(-1, 80 + 16 * (float)s_values.size()), ImPlotFlags_NoMenus))
+    {
+        ImPlot::SetupLegend(ImPlotLocation_South, ImPlotLegendFlags_Horizontal | ImPlotLegendFlags_Outside);
+        ImPlot::SetupAxes("GPU ms", nullptr, 0, ImPlotAxisFlags_NoDecorations);
+        ImPlot::SetupAxisLimits(ImAxis_X1, 0.0, std::max(total * 1.1, 0.01), ImPlotCond_Always);
+        // One group stacked horizontally, values are item major
+        ImPlot::PlotBarGroups(s_labels.data(), s_values.data(), (int)s_values.size(), 1, 0.67, 0, ImPlotBarGroupsFlags_Stacked | ImPlotBarGroupsFlags_Horizontal);
+        ImPlot::EndPlot();
+    }
+}
+#endif
+
 void triggerRenderWindowCallbacks(bool finalFrame)
 {
     auto& ctx = (*imgui::getContext());
@@ -3890,7 +4081,10 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
         ImPlot_PlotShadedG_NSightPerf,
         destroyContextOnResize,
         getFonts,
+        registerPerfSeries,
+        addPerfSample,
     };
+    ctx.presentSeries = ctx.perfSeries.registerSeries("Present to present");
 
     parameters->set(param::imgui::kInterface, &ctx.ui);
 
@@ -3940,31 +4134,55 @@ void updateEmbeddedJSON(json& config)
 
     extraConfig.contains("smallFontSize") ? extraConfig.at("smallFontSize").get_to(ctx.uiSmallFontSize) : imgui::DEFAULT_SMALL_FONT_SIZE;
     extraConfig.contains("mediumFontSize") ? extraConfig.at("mediumFontSize").get_to(ctx.uiMediumFontSize) : imgui::DEFAULT_MEDIUM_FONT_SIZE;
+    if (extraConfig.contains("overlayRefreshRate"))
+    {
+        extraConfig.at("overlayRefreshRate").get_to(ctx.overlayRefreshRate);
+        SL_LOG_INFO("Overlay refresh rate set to %.1fHz", ctx.overlayRefreshRate);
+    }
 }
 
 void renderInternal()
 {
     auto& ctx = (*sl::imgui::getContext());   
-    sl::imgui::setDisplaySize(Float2{ (float)ctx.backBufferWidth, (float)ctx.backBufferHeight });
-    sl::imgui::newFrame((float)ctx.frameMeter.getMean());
+
+    // Throttled overlay keeps showing the last draw data until the next rebuild is due
+    ctx.overlayElapsedMs += ctx.frameMeter.getMean();
+    bool rebuild = ctx.overlayRefreshRate <= 0.0f || !ctx.overlayDrawDataValid || ctx.overlayElapsedMs >= 1000.0 / ctx.overlayRefreshRate;
+    if (rebuild)
+    {
+        // Input and animations advance by the time since the last rebuild, not the last frame
+        float elapsed = (float)(ctx.overlayRefreshRate > 0.0f ? ctx.overlayElapsedMs : ctx.frameMeter.getMean());
+        ctx.overlayElapsedMs = 0.0;
+
+        sl::imgui::setDisplaySize(Float2{ (float)ctx.backBufferWidth, (float)ctx.backBufferHeight });
+        sl::imgui::newFrame(elapsed);
     
-    sl::imgui::pushFont(ctx.fonts.uiSmallFont);
+        sl::imgui::pushFont(ctx.fonts.uiSmallFont);
 
-    // Auto adjust the side bar based on latest size
-    static Float2 s_lastSize{};
+        // Auto adjust the side bar based on latest size
+        static Float2 s_lastSize{};
 
-    sl::imgui::setNextWindowPos(imgui::Float2{ ctx.backBufferWidth - s_lastSize.x - 10, ctx.backBufferHeight * 0.5f - s_lastSize.y * 0.5f }, imgui::Condition::eAlways, imgui::Float2{ 0.0f, 0.0f });
-    sl::imgui::setNextWindowBgAlpha(0.5f);
+        sl::imgui::setNextWindowPos(imgui::Float2{ ctx.backBufferWidth - s_lastSize.x - 10, ctx.backBufferHeight * 0.5f - s_lastSize.y * 0.5f }, imgui::Condition::eAlways, imgui::Float2{ 0.0f, 0.0f });
+        sl::imgui::setNextWindowBgAlpha(0.5f);
 
-    sl::imgui::begin("Streamline", 0, imgui::kWindowFlagAlwaysAutoResize | imgui::kWindowFlagNoCollapse);
+        sl::imgui::begin("Streamline", 0, imgui::kWindowFlagAlwaysAutoResize | imgui::kWindowFlagNoCollapse);
     
-    // render all the other plugins UI via callbacks
-    sl::imgui::triggerRenderWindowCallbacks(false);
-    sl::imgui::triggerRenderAnywhereCallbacks(false);
-
-    s_lastSize = sl::imgui::getWindowSize();
-    sl::imgui::end(); // Side bar    
-    sl::imgui::popFont();
+        // render all the other plugins UI via callbacks
+        sl::imgui::triggerRenderWindowCallbacks(false);
+        sl::imgui::triggerRenderAnywhereCallbacks(false);
+#ifndef SL_PRODUCTION
+        sl::imgui::renderPerfPanel();
+#endif
+
+        s_lastSize = sl::imgui::getWindowSize();
+        sl::imgui::end(); // Side bar    
+        sl::imgui::popFont();
+    }
+    else
+    {
+        // Frame counter normally advances in 'newFrame', the stabilization delay below is in presented frames
+        ctx.currentFrame++;
+    }
 
     //! Let rendering stabilize before trying to trigger UI rendering
     //!
@@ -3978,11 +4196,11 @@ void renderInternal()
         ctx.cmdList->beginCommandList();
         if (ctx.platform == RenderAPI::eD3D12 || ctx.platform == RenderAPI::eD3D11)
         {           
-            sl::imgui::render(ctx.cmdList->getCmdList(), (void*)ctx.currentBackBuffer, ctx.currentBackBufferIndex);
+            sl::imgui::renderFrame(ctx.cmdList->getCmdList(), (void*)ctx.currentBackBuffer, ctx.currentBackBufferIndex, rebuild);
         }
         else if (ctx.platform == RenderAPI::eVulkan)
         {            
-            sl::imgui::render(ctx.cmdList->getCmdList(), (void*)ctx.currentBackBufferVk, ctx.currentBackBufferIndex);
+            sl::imgui::renderFrame(ctx.cmdList->getCmdList(), (void*)ctx.currentBackBufferVk, ctx.currentBackBufferIndex, rebuild);
         }
         else
         {
@@ -3992,7 +4210,7 @@ void renderInternal()
         
         ctx.cmdList->executeCommandList();
     }
-    else
+    else if (rebuild)
     {
         ImGui::EndFrame();
     }
@@ -4039,6 +4257,7 @@ HRESULT slHookPresent(IDXGISwapChain* swapChain, UINT SyncInterval, UINT Flags,
         if (ctx.cmdQueue && ctx.cmdList)
         {
             ctx.frameMeter.timestamp();
+            ctx.perfSeries.add(ctx.presentSeries, (float)ctx.frameMeter.getValue());
             ctx.currentBackBufferIndex = ((IDXGISwapChain4*)swapChain)->GetCurrentBackBufferIndex();
             swapChain->GetBuffer(ctx.currentBackBufferIndex, __uuidof(ID3D12Resource), (void**)&ctx.currentBackBuffer);
             DXGI_SWAP_CHAIN_DESC swapChainDesc;
@@ -4078,6 +4297,7 @@ HRESULT slHookPresent(IDXGISwapChain* swapChain, UINT SyncInterval, UINT Flags,
                 ctx.ui.setCurrentContext(imguiCtx);
                 auto style = ctx.ui.getStyle();
                 ctx.ui.setStyleColors(style, imgui::StyleColorsPreset::eNvidiaDark);
+                sl::imgui::createSwapchainViewsD3D12(swapChain, swapChainDesc.BufferCount);
             }
 
             renderInternal();
@@ -4283,9 +4503,11 @@ VkResult slHookVkPresent(VkQueue Queue, const VkPresentInfoKHR* PresentInfo, boo
             ctx.vkSwapchain = currentSwapChain;
             auto style = ctx.ui.getStyle();
             ctx.ui.setStyleColors(style, imgui::StyleColorsPreset::eNvidiaDark);           
+            sl::imgui::createSwapchainViewsVk(ctx.vkSwapchainImages, ctx.backBufferWidth, ctx.backBufferHeight);
         }
 
         ctx.frameMeter.timestamp();
+        ctx.perfSeries.add(ctx.presentSeries, (float)ctx.frameMeter.getValue());
        
         ctx.currentBackBufferIndex = PresentInfo->pImageIndices[0];
         ctx.currentBackBufferVk = ctx.vkSwapchainImages[ctx.currentBackBufferIndex];
@@ -37,6 +37,10 @@ struct GraphValues
 
 SL_ENUM_OPERATORS_32(GraphFlags);
 
+//! Handle to a sample series shown in the built-in performance panel, see 'ImGUI::registerPerfSeries'
+using PerfSeries = uint32_t;
+constexpr PerfSeries kInvalidPerfSeries = UINT32_MAX;
+
 struct Graph
 {
     const char* title{};
@@ -26,6 +26,7 @@
 
 #include "external/imgui/imgui.h"
 #include "imgui_impl_dx12.h"
+#include "source/platforms/sl.chi/hash.h"
 
 // DirectX
 #include <d3d12.h>
@@ -44,12 +45,25 @@ static ID3D12Resource*              g_pFontTextureResource = NULL;
 static D3D12_CPU_DESCRIPTOR_HANDLE  g_hFontSrvCpuDescHandle = {};
 static D3D12_GPU_DESCRIPTOR_HANDLE  g_hFontSrvGpuDescHandle = {};
 
+// What was last written for each draw list into a frame's buffers, used to skip re-uploading static windows
+struct DrawListUpload
+{
+    uint64_t            Hash;
+    int                 VtxOffset;
+    int                 VtxCount;
+    int                 IdxOffset;
+    int                 IdxCount;
+};
+
 struct FrameResources
 {
     ID3D12Resource*     IndexBuffer;
     ID3D12Resource*     VertexBuffer;
     int                 IndexBufferSize;
     int                 VertexBufferSize;
+    ImDrawIdx*          IndexMapped;
+    ImDrawVert*         VertexMapped;
+    ImVector<DrawListUpload> Uploads;
 };
 static FrameResources*  g_pFrameResources = NULL;
 static UINT             g_numFramesInFlight = 0;
@@ -63,6 +77,47 @@ static void SafeRelease(T*& res)
     res = NULL;
 }
 
+// Upload heap buffers are persistently mapped, writes are visible to the GPU once the command list executes
+static bool ImGui_ImplDX12_CreateUploadBuffer(ID3D12Resource*& buffer, void*& mapped, size_t size)
+{
+    SafeRelease(buffer);
+    mapped = NULL;
+    D3D12_HEAP_PROPERTIES props;
+    memset(&props, 0, sizeof(D3D12_HEAP_PROPERTIES));
+    props.Type = D3D12_HEAP_TYPE_UPLOAD;
+    props.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+    props.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+    D3D12_RESOURCE_DESC desc;
+    memset(&desc, 0, sizeof(D3D12_RESOURCE_DESC));
+    desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+    desc.Width = size;
+    desc.Height = 1;
+    desc.DepthOrArraySize = 1;
+    desc.MipLevels = 1;
+    desc.Format = DXGI_FORMAT_UNKNOWN;
+    desc.SampleDesc.Count = 1;
+    desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+    desc.Flags = D3D12_RESOURCE_FLAG_NONE;
+    if (g_pd3dDevice->CreateCommittedResource(&props, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_GENERIC_READ, NULL, IID_PPV_ARGS(&buffer)) < 0)
+        return false;
+    // CPU never reads these back
+    D3D12_RANGE range = { 0, 0 };
+    if (buffer->Map(0, &range, &mapped) != S_OK)
+    {
+        SafeRelease(buffer);
+        mapped = NULL;
+        return false;
+    }
+    return true;
+}
+
+// Vertices and indices are all that ends up in the buffers so that is all that needs hashing
+static uint64_t ImGui_ImplDX12_HashDrawList(const ImDrawList* cmd_list)
+{
+    uint64_t hash = sl::chi::hash::hash64(cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+    return sl::chi::hash::hash64(cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx), hash);
+}
+
 struct VERTEX_CONSTANT_BUFFER
 {
     float   mvp[4][4];
@@ -136,74 +191,46 @@ void ImGui_ImplDX12_RenderDrawData(ImDrawData* draw_data, ID3D12GraphicsCommandL
     g_frameIndex = g_frameIndex + 1;
     FrameResources* fr = &g_pFrameResources[g_frameIndex % g_numFramesInFlight];
 
-    // Create and grow vertex/index buffers if needed
+    // Create and grow vertex/index buffers if needed, extra headroom keeps them stable while windows open and close
     if (fr->VertexBuffer == NULL || fr->VertexBufferSize < draw_data->TotalVtxCount)
     {
-        SafeRelease(fr->VertexBuffer);
         fr->VertexBufferSize = draw_data->TotalVtxCount + 5000;
-        D3D12_HEAP_PROPERTIES props;
-        memset(&props, 0, sizeof(D3D12_HEAP_PROPERTIES));
-        props.Type = D3D12_HEAP_TYPE_UPLOAD;
-        props.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-        props.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-        D3D12_RESOURCE_DESC desc;
-        memset(&desc, 0, sizeof(D3D12_RESOURCE_DESC));
-        desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-        desc.Width = fr->VertexBufferSize * sizeof(ImDrawVert);
-        desc.Height = 1;
-        desc.DepthOrArraySize = 1;
-        desc.MipLevels = 1;
-        desc.Format = DXGI_FORMAT_UNKNOWN;
-        desc.SampleDesc.Count = 1;
-        desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-        desc.Flags = D3D12_RESOURCE_FLAG_NONE;
-        if (g_pd3dDevice->CreateCommittedResource(&props, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_GENERIC_READ, NULL, IID_PPV_ARGS(&fr->VertexBuffer)) < 0)
+        if (!ImGui_ImplDX12_CreateUploadBuffer(fr->VertexBuffer, (void*&)fr->VertexMapped, fr->VertexBufferSize * sizeof(ImDrawVert)))
             return;
+        fr->Uploads.clear();
     }
     if (fr->IndexBuffer == NULL || fr->IndexBufferSize < draw_data->TotalIdxCount)
     {
-        SafeRelease(fr->IndexBuffer);
         fr->IndexBufferSize = draw_data->TotalIdxCount + 10000;
-        D3D12_HEAP_PROPERTIES props;
-        memset(&props, 0, sizeof(D3D12_HEAP_PROPERTIES));
-        props.Type = D3D12_HEAP_TYPE_UPLOAD;
-        props.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-        props.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-        D3D12_RESOURCE_DESC desc;
-        memset(&desc, 0, sizeof(D3D12_RESOURCE_DESC));
-        desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-        desc.Width = fr->IndexBufferSize * sizeof(ImDrawIdx);
-        desc.Height = 1;
-        desc.DepthOrArraySize = 1;
-        desc.MipLevels = 1;
-        desc.Format = DXGI_FORMAT_UNKNOWN;
-        desc.SampleDesc.Count = 1;
-        desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-        desc.Flags = D3D12_RESOURCE_FLAG_NONE;
-        if (g_pd3dDevice->CreateCommittedResource(&props, D3D12_HEAP_FLAG_NONE, &desc, D3D12_RESOURCE_STATE_GENERIC_READ, NULL, IID_PPV_ARGS(&fr->IndexBuffer)) < 0)
+        if (!ImGui_ImplDX12_CreateUploadBuffer(fr->IndexBuffer, (void*&)fr->IndexMapped, fr->IndexBufferSize * sizeof(ImDrawIdx)))
             return;
+        fr->Uploads.clear();
     }
 
     // Upload vertex/index data into a single contiguous GPU buffer
-    void* vtx_resource, *idx_resource;
-    D3D12_RANGE range;
-    memset(&range, 0, sizeof(D3D12_RANGE));
-    if (fr->VertexBuffer->Map(0, &range, &vtx_resource) != S_OK)
-        return;
-    if (fr->IndexBuffer->Map(0, &range, &idx_resource) != S_OK)
-        return;
-    ImDrawVert* vtx_dst = (ImDrawVert*)vtx_resource;
-    ImDrawIdx* idx_dst = (ImDrawIdx*)idx_resource;
+    // (Buffers stay mapped, draw lists which are already in this frame's buffers at the same offsets are skipped)
+    if (fr->Uploads.Size != draw_data->CmdListsCount)
+    {
+        DrawListUpload invalid = { 0, -1, -1, -1, -1 };
+        fr->Uploads.resize(draw_data->CmdListsCount, invalid);
+    }
+    int vtx_offset = 0;
+    int idx_offset = 0;
     for (int n = 0; n < draw_data->CmdListsCount; n++)
     {
         const ImDrawList* cmd_list = draw_data->CmdLists[n];
-        memcpy(vtx_dst, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
-        memcpy(idx_dst, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
-        vtx_dst += cmd_list->VtxBuffer.Size;
-        idx_dst += cmd_list->IdxBuffer.Size;
+        DrawListUpload& upload = fr->Uploads[n];
+        uint64_t hash = ImGui_ImplDX12_HashDrawList(cmd_list);
+        if (upload.Hash != hash || upload.VtxOffset != vtx_offset || upload.VtxCount != cmd_list->VtxBuffer.Size ||
+            upload.IdxOffset != idx_offset || upload.IdxCount != cmd_list->IdxBuffer.Size)
+        {
+            memcpy(fr->VertexMapped + vtx_offset, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+            memcpy(fr->IndexMapped + idx_offset, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
+            upload = { hash, vtx_offset, cmd_list->VtxBuffer.Size, idx_offset, cmd_list->IdxBuffer.Size };
+        }
+        vtx_offset += cmd_list->VtxBuffer.Size;
+        idx_offset += cmd_list->IdxBuffer.Size;
     }
-    fr->VertexBuffer->Unmap(0, &range);
-    fr->IndexBuffer->Unmap(0, &range);
 
     // Setup desired DX state
     ImGui_ImplDX12_SetupRenderState(draw_data, ctx, fr);
@@ -613,6 +640,9 @@ void    ImGui_ImplDX12_InvalidateDeviceObjects()
         FrameResources* fr = &g_pFrameResources[i];
         SafeRelease(fr->IndexBuffer);
         SafeRelease(fr->VertexBuffer);
+        fr->IndexMapped = NULL;
+        fr->VertexMapped = NULL;
+        fr->Uploads.clear();
     }
 }
 
@@ -639,6 +669,8 @@ bool ImGui_ImplDX12_Init(ID3D12Device* device, int num_frames_in_flight, DXGI_FO
         FrameResources* fr = &g_pFrameResources[i];
         fr->IndexBuffer = NULL;
         fr->VertexBuffer = NULL;
+        fr->IndexMapped = NULL;
+        fr->VertexMapped = NULL;
         fr->IndexBufferSize = 10000;
         fr->VertexBufferSize = 5000;
     }
@@ -48,10 +48,22 @@
 
 #include "external/imgui/imgui.h"
 #include "imgui_impl_vulkan.h"
+#include "source/platforms/sl.chi/hash.h"
 
 #include <stdio.h>
 
+// What was last written for each draw list into a frame's buffers, used to skip re-uploading static windows
+struct ImGui_ImplVulkanH_DrawListUpload
+{
+    uint64_t            Hash;
+    int                 VtxOffset;
+    int                 VtxCount;
+    int                 IdxOffset;
+    int                 IdxCount;
+};
+
 // Reusable buffers used for rendering 1 current in-flight frame, for ImGui_ImplVulkan_RenderDrawData()
+// Memory stays mapped for the lifetime of the buffers.
 // [Please zero-clear before use!]
 struct ImGui_ImplVulkanH_FrameRenderBuffers
 {
@@ -61,6 +73,9 @@ struct ImGui_ImplVulkanH_FrameRenderBuffers
     VkDeviceSize        IndexBufferSize;
     VkBuffer            VertexBuffer;
     VkBuffer            IndexBuffer;
+    ImDrawVert*         VertexMapped;
+    ImDrawIdx*          IndexMapped;
+    ImVector<ImGui_ImplVulkanH_DrawListUpload> Uploads;
 };
 
 // Each viewport will hold 1 ImGui_ImplVulkanH_WindowRenderBuffers
@@ -235,14 +250,18 @@ static void check_vk_result(VkResult err)
         v->CheckVkResultFn(err);
 }
 
-static void CreateOrResizeBuffer(VkBuffer& buffer, VkDeviceMemory& buffer_memory, VkDeviceSize& p_buffer_size, size_t new_size, VkBufferUsageFlagBits usage)
+static void CreateOrResizeBuffer(VkBuffer& buffer, VkDeviceMemory& buffer_memory, VkDeviceSize& p_buffer_size, void*& p_mapped, size_t new_size, VkBufferUsageFlagBits usage)
 {
     ImGui_ImplVulkan_InitInfo* v = &g_VulkanInitInfo;
     VkResult err;
     if (buffer != VK_NULL_HANDLE)
         vkDestroyBuffer(v->Device, buffer, v->Allocator);
     if (buffer_memory != VK_NULL_HANDLE)
+    {
+        vkUnmapMemory(v->Device, buffer_memory);
         vkFreeMemory(v->Device, buffer_memory, v->Allocator);
+    }
+    p_mapped = NULL;
 
     VkDeviceSize vertex_buffer_size_aligned = ((new_size - 1) / g_BufferMemoryAlignment + 1) * g_BufferMemoryAlignment;
     VkBufferCreateInfo buffer_info = {};
@@ -265,9 +284,18 @@ static void CreateOrResizeBuffer(VkBuffer& buffer, VkDeviceMemory& buffer_memory
 
     err = vkBindBufferMemory(v->Device, buffer, buffer_memory, 0);
     check_vk_result(err);
+    err = vkMapMemory(v->Device, buffer_memory, 0, VK_WHOLE_SIZE, 0, &p_mapped);
+    check_vk_result(err);
     p_buffer_size = new_size;
 }
 
+// Vertices and indices are all that ends up in the buffers so that is all that needs hashing
+static uint64_t ImGui_ImplVulkan_HashDrawList(const ImDrawList* cmd_list)
+{
+    uint64_t hash = sl::chi::hash::hash64(cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+    return sl::chi::hash::hash64(cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx), hash);
+}
+
 static void ImGui_ImplVulkan_SetupRenderState(ImDrawData* draw_data, VkCommandBuffer command_buffer, ImGui_ImplVulkanH_FrameRenderBuffers* rb, int fb_width, int fb_height)
 {
     // Bind pipeline and descriptor sets:
@@ -339,40 +367,59 @@ void ImGui_ImplVulkan_RenderDrawData(ImDrawData* draw_data, VkCommandBuffer comm
 
     if (draw_data->TotalVtxCount > 0)
     {
-        // Create or resize the vertex/index buffers
+        // Create or resize the vertex/index buffers, extra headroom keeps them stable while windows open and close
         size_t vertex_size = draw_data->TotalVtxCount * sizeof(ImDrawVert);
         size_t index_size = draw_data->TotalIdxCount * sizeof(ImDrawIdx);
         if (rb->VertexBuffer == VK_NULL_HANDLE || rb->VertexBufferSize < vertex_size)
-            CreateOrResizeBuffer(rb->VertexBuffer, rb->VertexBufferMemory, rb->VertexBufferSize, vertex_size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+        {
+            CreateOrResizeBuffer(rb->VertexBuffer, rb->VertexBufferMemory, rb->VertexBufferSize, (void*&)rb->VertexMapped, vertex_size + 5000 * sizeof(ImDrawVert), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+            rb->Uploads.clear();
+        }
         if (rb->IndexBuffer == VK_NULL_HANDLE || rb->IndexBufferSize < index_size)
-            CreateOrResizeBuffer(rb->IndexBuffer, rb->IndexBufferMemory, rb->IndexBufferSize, index_size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+        {
+            CreateOrResizeBuffer(rb->IndexBuffer, rb->IndexBufferMemory, rb->IndexBufferSize, (void*&)rb->IndexMapped, index_size + 10000 * sizeof(ImDrawIdx), VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+            rb->Uploads.clear();
+        }
 
         // Upload vertex/index data into a single contiguous GPU buffer
-        ImDrawVert* vtx_dst = NULL;
-        ImDrawIdx* idx_dst = NULL;
-        VkResult err = vkMapMemory(v->Device, rb->VertexBufferMemory, 0, VK_WHOLE_SIZE, 0, (void**)(&vtx_dst));
-        check_vk_result(err);
-        err = vkMapMemory(v->Device, rb->IndexBufferMemory, 0, VK_WHOLE_SIZE, 0, (void**)(&idx_dst));
-        check_vk_result(err);
+        // (Draw lists which are already in this frame's buffers at the same offsets are skipped)
+        if (rb->Uploads.Size != draw_data->CmdListsCount)
+        {
+            ImGui_ImplVulkanH_DrawListUpload invalid = { 0, -1, -1, -1, -1 };
+            rb->Uploads.resize(draw_data->CmdListsCount, invalid);
+        }
+        bool dirty = false;
+        int vtx_offset = 0;
+        int idx_offset = 0;
         for (int n = 0; n < draw_data->CmdListsCount; n++)
         {
             const ImDrawList* cmd_list = draw_data->CmdLists[n];
-            memcpy(vtx_dst, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
-            memcpy(idx_dst, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
-            vtx_dst += cmd_list->VtxBuffer.Size;
-            idx_dst += cmd_list->IdxBuffer.Size;
+            ImGui_ImplVulkanH_DrawListUpload& upload = rb->Uploads[n];
+            uint64_t hash = ImGui_ImplVulkan_HashDrawList(cmd_list);
+            if (upload.Hash != hash || upload.VtxOffset != vtx_offset || upload.VtxCount != cmd_list->VtxBuffer.Size ||
+                upload.IdxOffset != idx_offset || upload.IdxCount != cmd_list->IdxBuffer.Size)
+            {
+                memcpy(rb->VertexMapped + vtx_offset, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
+                memcpy(rb->IndexMapped + idx_offset, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
+                upload = { hash, vtx_offset, cmd_list->VtxBuffer.Size, idx_offset, cmd_list->IdxBuffer.Size };
+                dirty = true;
+            }
+            vtx_offset += cmd_list->VtxBuffer.Size;
+            idx_offset += cmd_list->IdxBuffer.Size;
+        }
+        // Memory is not necessarily coherent, nothing to flush when the overlay is static
+        if (dirty)
+        {
+            VkMappedMemoryRange range[2] = {};
+            range[0].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+            range[0].memory = rb->VertexBufferMemory;
+            range[0].size = VK_WHOLE_SIZE;
+            range[1].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+            range[1].memory = rb->IndexBufferMemory;
+            range[1].size = VK_WHOLE_SIZE;
+            VkResult err = vkFlushMappedMemoryRanges(v->Device, 2, range);
+            check_vk_result(err);
         }
-        VkMappedMemoryRange range[2] = {};
-        range[0].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-        range[0].memory = rb->VertexBufferMemory;
-        range[0].size = VK_WHOLE_SIZE;
-        range[1].sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-        range[1].memory = rb->IndexBufferMemory;
-        range[1].size = VK_WHOLE_SIZE;
-        err = vkFlushMappedMemoryRanges(v->Device, 2, range);
-        check_vk_result(err);
-        vkUnmapMemory(v->Device, rb->VertexBufferMemory);
-        vkUnmapMemory(v->Device, rb->IndexBufferMemory);
     }
 
     // Setup desired Vulkan state
@@ -1282,11 +1329,14 @@ void ImGui_ImplVulkanH_DestroyFrameSemaphores(VkDevice device, ImGui_ImplVulkanH
 void ImGui_ImplVulkanH_DestroyFrameRenderBuffers(VkDevice device, ImGui_ImplVulkanH_FrameRenderBuffers* buffers, const VkAllocationCallbacks* allocator)
 {
     if (buffers->VertexBuffer) { vkDestroyBuffer(device, buffers->VertexBuffer, allocator); buffers->VertexBuffer = VK_NULL_HANDLE; }
-    if (buffers->VertexBufferMemory) { vkFreeMemory(device, buffers->VertexBufferMemory, allocator); buffers->VertexBufferMemory = VK_NULL_HANDLE; }
+    if (buffers->VertexBufferMemory) { vkUnmapMemory(device, buffers->VertexBufferMemory); vkFreeMemory(device, buffers->VertexBufferMemory, allocator); buffers->VertexBufferMemory = VK_NULL_HANDLE; }
     if (buffers->IndexBuffer) { vkDestroyBuffer(device, buffers->IndexBuffer, allocator); buffers->IndexBuffer = VK_NULL_HANDLE; }
-    if (buffers->IndexBufferMemory) { vkFreeMemory(device, buffers->IndexBufferMemory, allocator); buffers->IndexBufferMemory = VK_NULL_HANDLE; }
+    if (buffers->IndexBufferMemory) { vkUnmapMemory(device, buffers->IndexBufferMemory); vkFreeMemory(device, buffers->IndexBufferMemory, allocator); buffers->IndexBufferMemory = VK_NULL_HANDLE; }
     buffers->VertexBufferSize = 0;
     buffers->IndexBufferSize = 0;
+    buffers->VertexMapped = NULL;
+    buffers->IndexMapped = NULL;
+    buffers->Uploads.clear();
 }
 
 void ImGui_ImplVulkanH_DestroyWindowRenderBuffers(VkDevice device, ImGui_ImplVulkanH_WindowRenderBuffers* buffers, const VkAllocationCallbacks* allocator)
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <algorithm>
+
+#include "source/plugins/sl.imgui/imguiTypes.h"
+
+namespace sl
+{
+namespace imgui
+{
+
+//! Rolling samples behind the built-in performance panel
+//!
+//! Adding a sample is an atomic increment plus a relaxed store so producers never block. The reader can see a slot
+//! a producer is still writing to and get the value from 'kHistory' samples ago, harmless for a debug view.
+//! Series are never removed, registration takes a lock but only happens once per series.
+class PerfSeriesStore
+{
+public:
+    static constexpr uint32_t kMaxSeries = 16;
+    static constexpr uint32_t kHistory = 1024;
+
+    struct Series
+    {
+        std::string name;
+        std::atomic<uint64_t> written{};
+        std::array<std::atomic<float>, kHistory> samples{};
+    };
+
+    PerfSeries registerSeries(const char* name)
+    {
+        std::lock_guard<std::mutex> lock(m_mtx);
+        auto count = m_count.load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (m_series[i]->name == name) return i;
+        }
+        if (count == kMaxSeries) return kInvalidPerfSeries;
+        m_series[count] = std::make_unique<Series>();
+        m_series[count]->name = name;
+        // Publish only once fully constructed, readers do not take the lock
+        m_count.store(count + 1, std::memory_order_release);
+        return count;
+    }
+
+    void add(PerfSeries series, float ms)
+    {
+        if (series >= m_count.load(std::memory_order_acquire)) return;
+        auto& s = *m_series[series];
+        auto index = s.written.fetch_add(1, std::memory_order_relaxed);
+        s.samples[index % kHistory].store(ms, std::memory_order_relaxed);
+    }
+
+    uint32_t getCount() const { return m_count.load(std::memory_order_acquire); }
+    const char* getName(PerfSeries series) const { return m_series[series]->name.c_str(); }
+
+    //! Copies up to 'maxCount' most recent samples into 'out', oldest first, returns the number copied
+    uint32_t copy(PerfSeries series, float* out, uint32_t maxCount) const
+    {
+        auto& s = *m_series[series];
+        auto written = s.written.load(std::memory_order_relaxed);
+        auto count = (uint32_t)std::min<uint64_t>({ written, maxCount, kHistory });
+        for (uint32_t i = 0; i < count; i++)
+        {
+            out[i] = s.samples[(written - count + i) % kHistory].load(std::memory_order_relaxed);
+        }
+        return count;
+    }
+
+private:
+    std::mutex m_mtx;
+    std::atomic<uint32_t> m_count{};
+    std::unique_ptr<Series> m_series[kMaxSeries];
+};
+
+}
+}
@@ -29,6 +29,15 @@
 #define NIS_DXC 0
 #endif
 
+// NIS_OUTPUT_ENCODE: (0) store as is, (1) dither, (2) linear scRGB to Rec.2020 PQ and dither, (3) PQ to linear scRGB
+#define NIS_OUTPUT_ENCODE_NONE 0
+#define NIS_OUTPUT_ENCODE_DITHER 1
+#define NIS_OUTPUT_ENCODE_PQ 2
+#define NIS_OUTPUT_ENCODE_SCRGB 3
+#ifndef NIS_OUTPUT_ENCODE
+#define NIS_OUTPUT_ENCODE NIS_OUTPUT_ENCODE_NONE
+#endif
+
 #if NIS_DXC
 #define NIS_PUSH_CONSTANT    [[vk::push_constant]]
 #define NIS_BINDING(bindingIndex) [[vk::binding(bindingIndex, 0)]]
@@ -73,8 +82,9 @@ NIS_BINDING(0) cbuffer cb : register(b0)
     uint kOutputViewportWidth;
     uint kOutputViewportHeight;
 
-    float reserved0;
-    float reserved1;
+    // 'reserved0/1' in NISConfig, only used by NIS_OUTPUT_ENCODE permutations
+    float kDitherScale;
+    float kOutputNitsScale;
 };
 
 NIS_BINDING(1) SamplerState samplerLinearClamp : register(s0);
@@ -85,7 +95,61 @@ NIS_BINDING(4) Texture2D coef_scaler           : register(t1);
 NIS_BINDING(5) Texture2D coef_usm              : register(t2);
 #endif
 
+#if NIS_OUTPUT_ENCODE != NIS_OUTPUT_ENCODE_NONE
+static const float kPQ_m1 = 0.1593017578125f;
+static const float kPQ_m2 = 78.84375f;
+static const float kPQ_c1 = 0.8359375f;
+static const float kPQ_c2 = 18.8515625f;
+static const float kPQ_c3 = 18.6875f;
+
+// Triangular noise in [-1, 1], one LSB of the output format once scaled by kDitherScale
+float NISDitherNoise(uint2 pos)
+{
+    const float2 p = float2(pos);
+    const float n0 = frac(sin(dot(p, float2(12.9898f, 78.233f))) * 43758.5453f);
+    const float n1 = frac(sin(dot(p, float2(39.3468f, 11.1353f))) * 24634.6345f);
+    return n0 + n1 - 1.0f;
+}
 
+// kOutputNitsScale maps 1.0 in scRGB (80 nits) to the 10000 nits PQ range
+float3 NISLinearToPQ(float3 scRGB)
+{
+    const float3x3 rec709ToRec2020 = {
+        0.6274040f, 0.3292820f, 0.0433136f,
+        0.0690970f, 0.9195400f, 0.0113612f,
+        0.0163916f, 0.0880132f, 0.8955950f };
+    const float3 y = saturate(mul(rec709ToRec2020, scRGB) * kOutputNitsScale);
+    const float3 ym = pow(y, kPQ_m1);
+    return pow((kPQ_c1 + kPQ_c2 * ym) / (1.0f + kPQ_c3 * ym), kPQ_m2);
+}
+
+float3 NISPQToLinear(float3 pq)
+{
+    const float3x3 rec2020ToRec709 = {
+         1.6604910f, -0.5876411f, -0.0728499f,
+        -0.1245505f,  1.1328999f, -0.0083494f,
+        -0.0181508f, -0.1005789f,  1.1187297f };
+    const float3 e = pow(saturate(pq), 1.0f / kPQ_m2);
+    const float3 y = pow(max(e - kPQ_c1, 0.0f) / (kPQ_c2 - kPQ_c3 * e), 1.0f / kPQ_m1);
+    return mul(rec2020ToRec709, y) / kOutputNitsScale;
+}
+
+float4 NISEncodeOutput(float4 v, uint2 pos)
+{
+#if NIS_OUTPUT_ENCODE == NIS_OUTPUT_ENCODE_PQ
+    v.rgb = NISLinearToPQ(v.rgb);
+#elif NIS_OUTPUT_ENCODE == NIS_OUTPUT_ENCODE_SCRGB
+    v.rgb = NISPQToLinear(v.rgb);
+#endif
+#if NIS_OUTPUT_ENCODE != NIS_OUTPUT_ENCODE_SCRGB
+    v.rgb += NISDitherNoise(pos) * kDitherScale;
+#endif
+    return v;
+}
+
+// Replaces the plain store in NIS_Scaler.h
+#define NVTEX_STORE(x, pos, v) x[pos] = NISEncodeOutput(v, pos)
+#endif
 
 #include "NIS_Scaler.h"
 
@@ -182,7 +182,9 @@
 #define NVTEX_SAMPLE_RED(x, sampler, pos) x.GatherRed(sampler, pos)
 #define NVTEX_SAMPLE_GREEN(x, sampler, pos) x.GatherGreen(sampler, pos)
 #define NVTEX_SAMPLE_BLUE(x, sampler, pos) x.GatherBlue(sampler, pos)
+#ifndef NVTEX_STORE
 #define NVTEX_STORE(x, pos, v) x[pos] = v
+#endif
 #ifndef NIS_UNROLL
 #define NIS_UNROLL [unroll]
 #endif
@@ -32,11 +32,13 @@
 #include "source/core/sl.log/log.h"
 #include "source/core/sl.plugin/plugin.h"
 #include "source/core/sl.param/parameters.h"
+#include "source/core/sl.thread/thread.h"
 #include "source/platforms/sl.chi/compute.h"
 #include "source/platforms/sl.chi/vulkan.h"
 #include "source/plugins/sl.nis/versions.h"
 #include "source/plugins/sl.imgui/imgui.h"
 #include "source/plugins/sl.common/commonInterface.h"
+#include "source/plugins/sl.common/statsSnapshot.h"
 #include "external/json/include/nlohmann/json.hpp"
 #include "_artifacts/gitVersion.h"
 #include "_artifacts/json/nis_json.h"
@@ -45,24 +47,86 @@
 // Compute shader permutations
 #include "./NIS_shaders.h"
 
+// Headers generated before these were emitted only contain full precision DXBC for 'cs6', no full precision SPIR-V
+// and no output encode permutations
+#ifndef NIS_CS6_HALF_PRECISION
+#define NIS_CS6_HALF_PRECISION 0
+#endif
+#ifndef NIS_SPV_FULL_PRECISION
+#define NIS_SPV_FULL_PRECISION 0
+#endif
+#ifndef NIS_OUTPUT_ENCODE_PERMUTATIONS
+#define NIS_OUTPUT_ENCODE_PERMUTATIONS 0
+#endif
+
 using json = nlohmann::json;
 namespace sl
 {
 
 namespace nis
 {
+//! Everything 'NVScalerUpdateConfig/NVSharpenUpdateConfig' depend on
+struct NISConfigKey
+{
+    NISMode mode{};
+    NISHDR hdrMode{};
+    float sharpness{};
+    Extent inExtent{};
+    Extent outExtent{};
+    uint32_t inWidth{};
+    uint32_t inHeight{};
+    uint32_t outWidth{};
+    uint32_t outHeight{};
+    uint32_t outputEncode{};
+    uint32_t ditherBits{};
+
+    inline bool operator==(const NISConfigKey& rhs) const
+    {
+        return mode == rhs.mode && hdrMode == rhs.hdrMode && sharpness == rhs.sharpness &&
+            inExtent == rhs.inExtent && outExtent == rhs.outExtent &&
+            inWidth == rhs.inWidth && inHeight == rhs.inHeight && outWidth == rhs.outWidth && outHeight == rhs.outHeight &&
+            outputEncode == rhs.outputEncode && ditherBits == rhs.ditherBits;
+    }
+};
+
+//! Everything recorded into a viewport's bundle, constants included since they are root constants
+struct NISBundleKey
+{
+    chi::Kernel kernel{};
+    void* colorIn{};
+    void* colorOut{};
+    NISConfigKey config{};
+
+    inline bool operator==(const NISBundleKey& rhs) const
+    {
+        return kernel == rhs.kernel && colorIn == rhs.colorIn && colorOut == rhs.colorOut && config == rhs.config;
+    }
+};
+
 struct NISViewport
 {
     uint32_t id = {};
     NISOptions consts = {};
+    //! Recomputed only when the key changes
+    NISConfigKey configKey = {};
+    NISConfig config = {};
+    bool configValid = false;
+    //! Used with 'NISOptions::reuseCommandList', retried only once the key changes if recording failed
+    chi::CommandList bundle = {};
+    NISBundleKey bundleKey = {};
+    bool bundleFailed = false;
 };
 
+//! Published once per evaluate, formatted by the UI only when drawn
 struct UIStats
 {
-    std::mutex mtx;
-    std::string mode{};
-    std::string viewport{};
-    std::string runtime{};
+    NISMode mode{};
+    uint32_t viewport{};
+    uint32_t inputWidth{};
+    uint32_t inputHeight{};
+    uint32_t outputWidth{};
+    uint32_t outputHeight{};
+    float runtimeMs{};
 };
 
 struct NISContext
@@ -73,55 +137,84 @@ struct NISContext
 
     common::PFunRegisterEvaluateCallbacks* registerEvaluateCallbacks{};
 
-    common::ViewportIdFrameData<4, false> constsPerViewport = { "nis" };
+    common::TypedViewportIdFrameData<NISOptions, 4, false> constsPerViewport = { "nis" };
+    //! Map nodes are stable, only the lookup is locked since a viewport is evaluated by one thread at a time
+    std::mutex viewportMutex;
     std::map<uint32_t, NISViewport> viewports = {};
-    NISViewport* currentViewport = {};
+    //! From 'PreferencesViewports', sizes per frame constant storage
+    uint32_t maxNumViewports = common::kDefaultMaxNumViewports;
+
+    //! Viewport being evaluated by the calling thread, set in 'nisBeginEvaluation'
+    struct EvaluateContext
+    {
+        NISViewport* viewport{};
+    };
+    thread::ThreadContext<EvaluateContext> evaluateContext;
 
+    std::mutex coefMutex;
     chi::Resource scalerCoef = {};
     chi::Resource usmCoef = {};
-    chi::Resource uploadScalerCoef = {};
-    chi::Resource uploadUsmCoef = {};
-
-    UIStats uiStats{};
 
-    NISConfig config;
+    //! Snapshot takes a single writer, evaluates can run on several threads
+    std::mutex uiStatsMutex;
+    common::StatsSnapshot<UIStats> uiStats{};
 
     chi::ICompute* compute = {};
 
-    std::unordered_map<uint32_t, chi::Kernel> shaders;
-
-    // Specifies compute shader block width
-    constexpr static uint32_t blockWidth = 32;
-    // Specifies compute shader block height
-    constexpr static uint32_t blockHeight = 24;
-    // Specifies compute shader thread group size
-    constexpr static uint32_t threadGroupSize = 128;
+    //! Byte code is registered at startup but kernels are only created on first use
+    struct ShaderPermutation
+    {
+        uint8_t* byteCode{};
+        uint32_t len{};
+        const char* filename{};
+        const char* entryPoint{};
+        bool halfPrecision{};
+        //! Must match the NIS_BLOCK_WIDTH/HEIGHT the byte code was compiled with, see 'nis_compile.py'
+        uint32_t blockWidth{};
+        uint32_t blockHeight{};
+        chi::Kernel kernel{};
+    };
+    std::mutex shaderMutex;
+    std::unordered_map<uint32_t, ShaderPermutation> shaders;
 
-    uint32_t hash_combine(uint32_t a, uint32_t b, uint32_t c)
+    uint32_t hash_combine(uint32_t a, uint32_t b, uint32_t c, uint32_t d)
     {
-        return  a + b * 10 + c * 100;
+        return  a + b * 10 + c * 100 + d * 1000;
     }
 
-    bool addShaderPermutation(NISMode scalerMode, uint32_t viewPorts, NISHDR HDRMode,
-        uint8_t* byteCode, uint32_t len, const char* filename, const char* entryPoint = "main") {
-        chi::Kernel kernel = {};
-        CHI_CHECK_RF(compute->createKernel((void*)byteCode, len, filename, entryPoint, kernel));
-        if (kernel)
-            shaders[hash_combine((uint32_t)scalerMode, viewPorts, (uint32_t)HDRMode)] = kernel;
-        return true;
+    //! 'outputEncode' matches NIS_OUTPUT_ENCODE in NIS_Main.hlsl, see 'getOutputEncode'
+    void addShaderPermutation(NISMode scalerMode, uint32_t viewPorts, NISHDR HDRMode, bool halfPrecision,
+        uint8_t* byteCode, uint32_t len, const char* filename, uint32_t outputEncode = 0, const char* entryPoint = "main") {
+        // Same block sizes 'GetOptimalArguments' in 'nis_compile.py' uses for the NVIDIA_Generic(_fp16) targets
+        uint32_t blockHeight = halfPrecision || scalerMode == NISMode::eSharpen ? 32 : 24;
+        std::scoped_lock lock(shaderMutex);
+        shaders[hash_combine((uint32_t)scalerMode, viewPorts, (uint32_t)HDRMode, outputEncode)] = { byteCode, len, filename, entryPoint, halfPrecision, 32, blockHeight };
     }
 
-    chi::Kernel getKernel(NISMode scalerMode, uint32_t viewPorts, NISHDR HDRMode) {
-        uint32_t key = hash_combine((uint32_t)scalerMode, viewPorts, (uint32_t)HDRMode);
-        if (shaders.find(key) == shaders.end())
+    //! Creates the kernel on first request and prewarms any pipelines the persistent cache recorded for it
+    //! 
+    //! Returned pointer stays valid until shutdown, permutations are only registered in 'slOnPluginStartup'
+    const ShaderPermutation* getPermutation(NISMode scalerMode, uint32_t viewPorts, NISHDR HDRMode, uint32_t outputEncode) {
+        uint32_t key = hash_combine((uint32_t)scalerMode, viewPorts, (uint32_t)HDRMode, outputEncode);
+        std::scoped_lock lock(shaderMutex);
+        auto it = shaders.find(key);
+        if (it == shaders.end())
             return {};
-        return shaders[key];
+        auto& permutation = (*it).second;
+        if (!permutation.kernel)
+        {
+            if (compute->createKernel((void*)permutation.byteCode, permutation.len, permutation.filename, permutation.entryPoint, permutation.kernel) != chi::ComputeStatus::eOk)
+            {
+                SL_LOG_ERROR("Failed to create NIS kernel '%s'", permutation.filename);
+                return {};
+            }
+            CHI_VALIDATE(compute->prewarmKernels(&permutation.kernel, 1));
+        }
+        return &permutation;
     }
 };
 }
 
-constexpr uint32_t kMaxNumViewports = 4;
-
 static std::string JSON = std::string(nis_json, &nis_json[nis_json_len]);
 
 void updateEmbeddedJSON(json& config)
@@ -146,6 +239,21 @@ void updateEmbeddedJSON(json& config)
 
 SL_PLUGIN_DEFINE("sl.nis", Version(VERSION_MAJOR, VERSION_MINOR, VERSION_PATCH), Version(0, 0, 1), JSON.c_str(), updateEmbeddedJSON, nis, NISContext)
 
+//! Maps the requested output encoding and dithering to NIS_OUTPUT_ENCODE in NIS_Main.hlsl
+uint32_t getOutputEncode(const NISOptions& options)
+{
+    if (options.structVersion < kStructVersion2)
+    {
+        return 0;
+    }
+    switch (options.outputEncoding)
+    {
+        case NISOutputEncoding::ePQ: return 2;
+        case NISOutputEncoding::eScRGB: return 3;
+        default: return options.ditherBits ? 1 : 0;
+    }
+}
+
 Result slSetData(const BaseStructure* inputs, CommandBuffer* cmdBuffer)
 {
     auto& ctx = (*nis::getContext());
@@ -156,69 +264,178 @@ Result slSetData(const BaseStructure* inputs, CommandBuffer* cmdBuffer)
         return Result::eErrorMissingInputParameter;
     }
     ctx.constsPerViewport.set(0, *viewport, static_cast<NISOptions*>(options));
+
+    // Build the permutations these options can select now so a mode or HDR change does not stall evaluate
+    if (options->mode != NISMode::eOff)
+    {
+        auto outputEncode = getOutputEncode(*options);
+        ctx.getPermutation(options->mode, 0, options->hdrMode, outputEncode);
+        ctx.getPermutation(options->mode, 1, options->hdrMode, outputEncode);
+    }
     
     return Result::eOk;
 }
 
-bool initializeNIS(chi::CommandList cmdList, const common::EventData& data)
+//! Coefficient textures are shared by all viewports, on failure they are released so the next call can retry
+//! 
+//! Caller holds 'coefMutex'
+bool initializeNIS(chi::CommandList cmdList)
 {
     auto& ctx = (*nis::getContext());
     if (!ctx.scalerCoef && !ctx.usmCoef)
     {
         auto texDesc = sl::chi::ResourceDescription(kFilterSize / 4, kPhaseCount, sl::chi::eFormatRGBA32F);
-        CHI_CHECK_RF(ctx.compute->createTexture2D(texDesc, ctx.scalerCoef, "nisScalerCoef"));
-        CHI_CHECK_RF(ctx.compute->createTexture2D(texDesc, ctx.usmCoef, "nisUSMCoef"));
-
-        int rowPitchAlignment = 1; // D3D11
-        RenderAPI platform;
-        ctx.compute->getRenderAPI(platform);
-        if (platform == RenderAPI::eD3D12)
+        // Staging and device pitch alignment are handled by the shared upload ring
+        const uint64_t rowPitch = kFilterSize * sizeof(float);
+        const uint64_t totalBytes = rowPitch * kPhaseCount;
+        if (ctx.compute->createTexture2D(texDesc, ctx.scalerCoef, "nisScalerCoef") != chi::ComputeStatus::eOk ||
+            ctx.compute->createTexture2D(texDesc, ctx.usmCoef, "nisUSMCoef") != chi::ComputeStatus::eOk ||
+            ctx.compute->uploadToTexture(cmdList, coef_scale, totalBytes, rowPitch, ctx.scalerCoef) != chi::ComputeStatus::eOk ||
+            ctx.compute->uploadToTexture(cmdList, coef_usm, totalBytes, rowPitch, ctx.usmCoef) != chi::ComputeStatus::eOk)
         {
-            rowPitchAlignment = 256; // D3D12_TEXTURE_DATA_PITCH_ALIGNMENT
+            SL_LOG_ERROR("Failed to create NIS coefficient textures");
+            ctx.compute->destroyResource(ctx.scalerCoef);
+            ctx.compute->destroyResource(ctx.usmCoef);
+            ctx.scalerCoef = {};
+            ctx.usmCoef = {};
+            return false;
         }
+    }
+    return true;
+}
 
-        const int rowPitch = kFilterSize * sizeof(float);
-        const int deviceRowPitch = extra::align(kFilterSize * sizeof(float), rowPitchAlignment);
-        const int totalBytes = deviceRowPitch * kPhaseCount;
+//! Uploads the coefficients once on an SL owned queue so no evaluate records the copy
+//! 
+//! Evaluates can run in parallel, a copy on one host command list could execute after another thread's list samples the coefficients.
+//! Blocks until the copy is done so it completes before any host list using them is even submitted,
+//! the queue goes away right after and the staging space is recycled by the upload ring.
+bool initializeNISOnOwnQueue()
+{
+    auto& ctx = (*nis::getContext());
+    std::scoped_lock lock(ctx.coefMutex);
+    if (ctx.scalerCoef && ctx.usmCoef)
+    {
+        return true;
+    }
+    bool initialized = false;
+    chi::ChiCommandQueue* queue{};
+    chi::ICommandListContext* cmdList{};
+    // Graphics queue since the textures are created in states a d3d12 copy queue cannot transition
+    // and on vulkan no queue family ownership transfer is needed when the host renders on the same family
+    if (ctx.compute->createCommandQueue(chi::CommandQueueType::eGraphics, queue, "sl.nis.upload") != chi::ComputeStatus::eOk ||
+        ctx.compute->createCommandListContext(queue, 1, cmdList, "sl.nis.upload") != chi::ComputeStatus::eOk)
+    {
+        SL_LOG_WARN("Unable to create NIS upload queue, retrying on the first evaluate");
+    }
+    else
+    {
+        cmdList->beginCommandList();
+        initialized = initializeNIS(cmdList->getCmdList());
+        cmdList->executeCommandList();
+        cmdList->waitForCommandList(chi::FlushType::eCurrent);
+    }
+    if (cmdList)
+    {
+        CHI_VALIDATE(ctx.compute->destroyCommandListContext(cmdList));
+    }
+    if (queue)
+    {
+        CHI_VALIDATE(ctx.compute->destroyCommandQueue(queue));
+    }
+    return initialized;
+}
 
-        if (!ctx.uploadScalerCoef)
-        {
-            chi::ResourceDescription bufferDesc(deviceRowPitch * kPhaseCount, 1, chi::eFormatINVALID, chi::HeapType::eHeapTypeUpload, chi::ResourceState::eUnknown);
-            CHI_CHECK_RF(ctx.compute->createBuffer(bufferDesc, ctx.uploadScalerCoef, "sl.ctx.uploadScalerCoef"));
-            CHI_CHECK_RF(ctx.compute->createBuffer(bufferDesc, ctx.uploadUsmCoef, "sl.ctx.uploadUsmCoef"));
-        }
+//! Binds and dispatches the NIS kernel, 'cmdList' is either the host list or a bundle being recorded
+chi::ComputeStatus recordNISDispatch(chi::CommandList cmdList, const nis::NISContext::ShaderPermutation* permutation, const nis::NISViewport& viewport,
+    chi::Resource colorIn, chi::Resource colorOut, const chi::ResourceDescription& outDesc)
+{
+    auto& ctx = (*nis::getContext());
+    CHI_CHECK(ctx.compute->bindSharedState(cmdList));
+    CHI_CHECK(ctx.compute->bindKernel(permutation->kernel));
+    CHI_CHECK(ctx.compute->bindConsts(0, 0, (void*)&viewport.config, sizeof(viewport.config), ctx.maxNumViewports * 3));
+    CHI_CHECK(ctx.compute->bindSampler(1, 0, chi::eSamplerLinearClamp));
+    CHI_CHECK(ctx.compute->bindTexture(2, 0, colorIn));
+    CHI_CHECK(ctx.compute->bindRWTexture(3, 0, colorOut));
+    if (viewport.consts.mode == NISMode::eScaler)
+    {
+        CHI_CHECK(ctx.compute->bindTexture(4, 1, ctx.scalerCoef));
+        CHI_CHECK(ctx.compute->bindTexture(5, 2, ctx.usmCoef));
+    }
+    return ctx.compute->dispatch(UINT(std::ceil(outDesc.width / float(permutation->blockWidth))), UINT(std::ceil(outDesc.height / float(permutation->blockHeight))), 1);
+}
 
-        std::vector<float> blobScale(totalBytes / sizeof(float));
-        std::vector<float> blobUsm(totalBytes / sizeof(float));
+//! Records the dispatch into a new bundle for 'viewport', false if the platform or kernel cannot use one
+bool recordNISBundle(const nis::NISContext::ShaderPermutation* permutation, nis::NISViewport& viewport,
+    chi::Resource colorIn, chi::Resource colorOut, const chi::ResourceDescription& outDesc)
+{
+    auto& ctx = (*nis::getContext());
+    chi::CommandList bundle{};
+    if (ctx.compute->beginBundle(0, bundle) != chi::ComputeStatus::eOk)
+    {
+        return false;
+    }
+    auto status = recordNISDispatch(bundle, permutation, viewport, colorIn, colorOut, outDesc);
+    if (ctx.compute->endBundle(bundle) != chi::ComputeStatus::eOk || status != chi::ComputeStatus::eOk)
+    {
+        CHI_VALIDATE(ctx.compute->destroyBundle(bundle));
+        return false;
+    }
+    viewport.bundle = bundle;
+    return true;
+}
 
-        auto fillBlob = [rowPitch, deviceRowPitch](std::vector<float>& blob, const void* data)->void
+//! Replays the viewport's bundle on 'cmdList', recording a new one when the key changed or descriptors moved
+bool executeNISBundle(chi::CommandList cmdList, const nis::NISContext::ShaderPermutation* permutation, nis::NISViewport& viewport,
+    chi::Resource colorIn, chi::Resource colorOut, const chi::ResourceDescription& outDesc)
+{
+    auto& ctx = (*nis::getContext());
+    nis::NISBundleKey key{ permutation->kernel, colorIn->native, colorOut->native, viewport.configKey };
+    if (!(viewport.bundleKey == key))
+    {
+        if (viewport.bundle)
         {
-            void* cpuVA = blob.data();
-            for (uint32_t row = 0; row < kPhaseCount; row++)
-            {
-                void* destAddress = (char*)cpuVA + deviceRowPitch * row;
-                void* srcAddress = (char*)data + rowPitch * row;
-                memcpy(destAddress, srcAddress, rowPitch);
-            }
-        };
-
-        fillBlob(blobScale, coef_scale);
-        fillBlob(blobUsm, coef_usm);
+            CHI_VALIDATE(ctx.compute->destroyBundle(viewport.bundle));
+            viewport.bundle = {};
+        }
+        viewport.bundleKey = key;
+        viewport.bundleFailed = false;
+    }
+    if (!viewport.bundle && !viewport.bundleFailed)
+    {
+        viewport.bundleFailed = !recordNISBundle(permutation, viewport, colorIn, colorOut, outDesc);
+    }
+    if (!viewport.bundle)
+    {
+        return false;
+    }
 
-        CHI_CHECK_RF(ctx.compute->copyHostToDeviceTexture(cmdList, totalBytes, rowPitch, blobScale.data(), ctx.scalerCoef, ctx.uploadScalerCoef));
-        CHI_CHECK_RF(ctx.compute->copyHostToDeviceTexture(cmdList, totalBytes, rowPitch, blobUsm.data(), ctx.usmCoef, ctx.uploadUsmCoef));
+    auto status = ctx.compute->executeBundle(cmdList, viewport.bundle);
+    if (status == chi::ComputeStatus::eInvalidCall)
+    {
+        // Views were recreated since recording, for example after 'slFreeResources'
+        CHI_VALIDATE(ctx.compute->destroyBundle(viewport.bundle));
+        viewport.bundle = {};
+        viewport.bundleFailed = !recordNISBundle(permutation, viewport, colorIn, colorOut, outDesc);
+        status = viewport.bundle ? ctx.compute->executeBundle(cmdList, viewport.bundle) : chi::ComputeStatus::eError;
     }
-    return true;
+    return status == chi::ComputeStatus::eOk;
 }
 
 Result nisBeginEvaluation(chi::CommandList cmdList, const common::EventData& data, const sl::BaseStructure** inputs, uint32_t numInputs)
 {
     auto& ctx = (*nis::getContext());
-    if (ctx.viewports.size() > (size_t)kMaxNumViewports)
+    auto& evaluate = ctx.evaluateContext.getContext();
+    evaluate.viewport = {};
+    nis::NISViewport* v{};
     {
-        SL_LOG_WARN("Exceeded max number (%u) of allowed viewports for NIS", kMaxNumViewports);
+        std::scoped_lock lock(ctx.viewportMutex);
+        if (ctx.viewports.size() > (size_t)ctx.maxNumViewports)
+        {
+            SL_LOG_WARN_ONCE("Exceeded max number (%u) of allowed viewports for NIS, please raise 'PreferencesViewports::maxNumViewports'", ctx.maxNumViewports);
+        }
+        v = &ctx.viewports[data.id];
     }
-    auto& viewport = ctx.viewports[data.id];
+    auto& viewport = *v;
     viewport.id = data.id;
 
     // Options are set per viewport, frame index is always 0
@@ -229,22 +446,41 @@ Result nisBeginEvaluation(chi::CommandList cmdList, const common::EventData& dat
     }
 
     viewport.consts = *consts;
-    ctx.currentViewport = &viewport;
+    evaluate.viewport = &viewport;
 
-    initializeNIS(cmdList, data);
+    // Normally done at startup, d3d11 evaluates are serialized on the immediate context so the host list is safe to record on
+    RenderAPI platform;
+    ctx.compute->getRenderAPI(platform);
+    bool initialized{};
+    if (platform == RenderAPI::eD3D11)
+    {
+        std::scoped_lock lock(ctx.coefMutex);
+        initialized = initializeNIS(cmdList);
+    }
+    else
+    {
+        initialized = initializeNISOnOwnQueue();
+    }
+    if (!initialized)
+    {
+        return Result::eErrorComputeFailed;
+    }
     return Result::eOk;
 }
 
 Result nisEndEvaluation(chi::CommandList cmdList, const common::EventData& data, const sl::BaseStructure** inputs, uint32_t numInputs)
 {
     auto& ctx = (*nis::getContext());
-    if (!ctx.currentViewport)
+    auto& evaluate = ctx.evaluateContext.getContext();
+    if (!evaluate.viewport)
     {
         return Result::eErrorInvalidParameter;
     }
 
-    const uint32_t id = ctx.currentViewport->id;
-    const NISOptions& consts = ctx.currentViewport->consts;
+    auto& viewport = *evaluate.viewport;
+    evaluate.viewport = {};
+    const uint32_t id = viewport.id;
+    const NISOptions& consts = viewport.consts;
 
     if (consts.mode != NISMode::eScaler && consts.mode != NISMode::eSharpen) {
         SL_LOG_ERROR( "Invalid NISContext mode %d", consts.mode);
@@ -254,6 +490,22 @@ Result nisEndEvaluation(chi::CommandList cmdList, const common::EventData& data,
         SL_LOG_ERROR( "Invalid NISContext HDR mode %d", consts.hdrMode);
         return Result::eErrorInvalidParameter;
     }
+    const uint32_t outputEncode = getOutputEncode(consts);
+    const uint32_t ditherBits = consts.structVersion >= kStructVersion2 ? std::min(consts.ditherBits, 16u) : 0;
+    if (consts.structVersion >= kStructVersion2 && (consts.outputEncoding >= NISOutputEncoding::eCount ||
+        (consts.outputEncoding == NISOutputEncoding::ePQ && consts.hdrMode != NISHDR::eLinear) ||
+        (consts.outputEncoding == NISOutputEncoding::eScRGB && consts.hdrMode != NISHDR::ePQ)))
+    {
+        SL_LOG_ERROR( "Invalid NISContext output encoding %d for HDR mode %d", consts.outputEncoding, consts.hdrMode);
+        return Result::eErrorInvalidParameter;
+    }
+#if !NIS_OUTPUT_ENCODE_PERMUTATIONS
+    if (outputEncode)
+    {
+        SL_LOG_ERROR_ONCE("NIS output encoding and dithering need NIS_shaders.h generated by 'nis_compile.py' with output encode permutations");
+        return Result::eErrorInvalidParameter;
+    }
+#endif
 
     CommonResource colorIn{};
     CommonResource colorOut{};
@@ -298,42 +550,52 @@ Result nisEndEvaluation(chi::CommandList cmdList, const common::EventData& data,
     NISHDRMode nisHdrMode = hdrMode == NISHDR::eLinear ? NISHDRMode::Linear :
         hdrMode == NISHDR::ePQ ? NISHDRMode::PQ : NISHDRMode::None;
 
-    chi::Kernel kernel = ctx.getKernel(consts.mode, viewPortsSupport, hdrMode);
-    if (!kernel)
+    auto permutation = ctx.getPermutation(consts.mode, viewPortsSupport, hdrMode, outputEncode);
+    if (!permutation)
     {
-        SL_LOG_ERROR( "Failed to find NISContext shader permutation mode: %d viewportSupport: %d, hdrMode: %d", consts.mode, viewPortsSupport, consts.hdrMode);
+        SL_LOG_ERROR( "Failed to find NISContext shader permutation mode: %d viewportSupport: %d, hdrMode: %d, outputEncode: %u", consts.mode, viewPortsSupport, consts.hdrMode, outputEncode);
         return Result::eErrorInvalidParameter;
     }
 
-    // Resource state already obtained and stored in resource description
-    
-    if (consts.mode == NISMode::eScaler)
+    NISConfigKey configKey{ consts.mode, hdrMode, sharpness, inExtent, outExtent, inDesc.width, inDesc.height, outDesc.width, outDesc.height, outputEncode, ditherBits };
+    if (!viewport.configValid || !(viewport.configKey == configKey))
     {
-        if (!NVScalerUpdateConfig(ctx.config, sharpness,
-            inExtent.left, inExtent.top, inExtent.width, inExtent.height, inDesc.width, inDesc.height,
-            outExtent.left, outExtent.top, outExtent.width, outExtent.height, outDesc.width, outDesc.height,
-            nisHdrMode))
+        // Stays invalid if the update below fails part way
+        viewport.configValid = false;
+        if (consts.mode == NISMode::eScaler)
         {
-            SL_LOG_ERROR( "NVScaler configuration error, scale out of bounds or textures width/height with zero value");
-            return Result::eErrorInvalidParameter;
+            if (!NVScalerUpdateConfig(viewport.config, sharpness,
+                inExtent.left, inExtent.top, inExtent.width, inExtent.height, inDesc.width, inDesc.height,
+                outExtent.left, outExtent.top, outExtent.width, outExtent.height, outDesc.width, outDesc.height,
+                nisHdrMode))
+            {
+                SL_LOG_ERROR( "NVScaler configuration error, scale out of bounds or textures width/height with zero value");
+                return Result::eErrorInvalidParameter;
+            }
         }
-    }
-    else
-    {
-        // Sharpening only (no upscaling)
-        if (!NVSharpenUpdateConfig(ctx.config, sharpness,
-            inExtent.left, inExtent.top, inExtent.width, inExtent.height, inDesc.width, inDesc.height,
-            outExtent.left, outExtent.top, nisHdrMode))
+        else
         {
-            SL_LOG_ERROR( "NVSharpen configuration error, textures width/height width zero value");
-            return Result::eErrorInvalidParameter;
+            // Sharpening only (no upscaling)
+            if (!NVSharpenUpdateConfig(viewport.config, sharpness,
+                inExtent.left, inExtent.top, inExtent.width, inExtent.height, inDesc.width, inDesc.height,
+                outExtent.left, outExtent.top, nisHdrMode))
+            {
+                SL_LOG_ERROR( "NVSharpen configuration error, textures width/height width zero value");
+                return Result::eErrorInvalidParameter;
+            }
         }
+        // Read by the NIS_OUTPUT_ENCODE permutations as 'kDitherScale' and 'kOutputNitsScale'
+        viewport.config.reserved0 = ditherBits ? 1.0f / float((1u << ditherBits) - 1) : 0.0f;
+        viewport.config.reserved1 = 80.0f / 10000.0f;
+        viewport.configKey = configKey;
+        viewport.configValid = true;
     }
 
 #if SL_ENABLE_TIMING
     CHI_VALIDATE(ctx.compute->beginPerfSection(cmdList, "sl.nis"));
 #endif
 
+    chi::ScopedProfilingSection section(ctx.compute, cmdList, consts.mode == NISMode::eScaler ? "sl.nis.scaler" : "sl.nis.sharpen");
     // Resource state already obtained and stored in resource description
     extra::ScopedTasks revTransitions;
     std::vector<chi::ResourceTransition> transitions {
@@ -342,18 +604,17 @@ Result nisEndEvaluation(chi::CommandList cmdList, const common::EventData& data,
     };
     ctx.compute->transitionResources(cmdList, transitions.data(), (uint32_t)(transitions.size()), &revTransitions);
 
-    CHI_VALIDATE(ctx.compute->bindSharedState(cmdList));
-    CHI_VALIDATE(ctx.compute->bindKernel(kernel));
-    CHI_VALIDATE(ctx.compute->bindConsts(0, 0, &ctx.config, sizeof(ctx.config), kMaxNumViewports * 3));
-    CHI_VALIDATE(ctx.compute->bindSampler(1, 0, chi::eSamplerLinearClamp));
-    CHI_VALIDATE(ctx.compute->bindTexture(2, 0, colorIn));
-    CHI_VALIDATE(ctx.compute->bindRWTexture(3, 0, colorOut));
-    if (consts.mode == NISMode::eScaler)
+    bool reuseCommandList = consts.structVersion >= kStructVersion3 && consts.reuseCommandList == Boolean::eTrue;
+    if (!reuseCommandList || !executeNISBundle(cmdList, permutation, viewport, colorIn, colorOut, outDesc))
     {
-        CHI_VALIDATE(ctx.compute->bindTexture(4, 1, ctx.scalerCoef));
-        CHI_VALIDATE(ctx.compute->bindTexture(5, 2, ctx.usmCoef));
+        if (!reuseCommandList && viewport.bundle)
+        {
+            CHI_VALIDATE(ctx.compute->destroyBundle(viewport.bundle));
+            viewport.bundle = {};
+            viewport.bundleKey = {};
+        }
+        CHI_VALIDATE(recordNISDispatch(cmdList, permutation, viewport, colorIn, colorOut, outDesc));
     }
-    CHI_VALIDATE(ctx.compute->dispatch(UINT(std::ceil(outDesc.width / float(ctx.blockWidth))), UINT(std::ceil(outDesc.height / float(ctx.blockHeight))), 1));
 
     float ms = 0;
 #if SL_ENABLE_TIMING
@@ -369,10 +630,10 @@ Result nisEndEvaluation(chi::CommandList cmdList, const common::EventData& data,
     s_stats = extra::format("sl.nis {} - ({}x{})->({}x{}) - {}ms", v.toStr() + "." + GIT_LAST_COMMIT_SHORT, inExtent.width, inExtent.height,outDesc.width, outDesc.height, ms);
     parameters->set(sl::param::nis::kStats, (void*)s_stats.c_str());*/
 
-    std::scoped_lock lock(ctx.uiStats.mtx);
-    ctx.uiStats.mode = getNISModeAsStr(consts.mode);
-    ctx.uiStats.viewport = extra::format("Viewport {}x{} -> {}x{}", inExtent.width, inExtent.height, outExtent.width, outExtent.height);
-    ctx.uiStats.runtime = extra::format("Execution time {}ms", ms);
+    {
+        std::scoped_lock lock(ctx.uiStatsMutex);
+        ctx.uiStats.publish({ consts.mode, id, inExtent.width, inExtent.height, outExtent.width, outExtent.height, ms });
+    }
 #endif
 
     // Tell others that we are actually active this frame
@@ -380,7 +641,6 @@ Result nisEndEvaluation(chi::CommandList cmdList, const common::EventData& data,
     CHI_VALIDATE(ctx.compute->getFinishedFrameIndex(frame));
     parameters->set(sl::param::nis::kCurrentFrame, frame + 1);
 
-    ctx.currentViewport = {};
     return Result::eOk;
 }
 
@@ -390,6 +650,12 @@ Result nisEndEvaluation(chi::CommandList cmdList, const common::EventData& data,
 
 //! Plugin startup
 //!
+#if NIS_OUTPUT_ENCODE_PERMUTATIONS
+//! Expands the X(scaler, viewport, hdr, encode, byteCode, filename) lists 'nis_compile.py' writes to NIS_shaders.h
+#define NIS_ADD_ENCODE_PERMUTATION(scaler, viewport, hdr, encode, byteCode, filename) \
+    ctx.addShaderPermutation(scaler ? NISMode::eScaler : NISMode::eSharpen, viewport, (NISHDR)hdr, halfPrecision, byteCode, byteCode##_len, filename, encode);
+#endif
+
 //! Called only if plugin reports `supported : true` in the JSON config.
 //! Note that supported flag can flip back to false if this method fails.
 //!
@@ -402,6 +668,8 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
 
     auto parameters = api::getContext()->parameters;
 
+    ctx.maxNumViewports = common::getMaxNumViewports();
+
     if (!getPointerParam(parameters, param::common::kComputeAPI, &ctx.compute))
     {
         SL_LOG_ERROR( "Can't find %s", param::common::kComputeAPI);
@@ -417,57 +685,120 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
 
     RenderAPI platform;
     ctx.compute->getRenderAPI(platform);
-    switch (platform)
+
+    // Evaluate state lives in the viewport and the calling thread, d3d11 records on the immediate context so stays serialized
+    common::PFunSetEvaluateReentrant* setEvaluateReentrant{};
+    if (platform != RenderAPI::eD3D11 && param::getPointerParam(parameters, param::common::kPFunSetEvaluateReentrant, &setEvaluateReentrant))
+    {
+        setEvaluateReentrant(kFeatureNIS, true);
+    }
+    chi::ShaderCaps shaderCaps{};
+    CHI_VALIDATE(ctx.compute->getShaderCaps(shaderCaps));
+    SL_LOG_INFO("NIS shader caps: native fp16 %s, wave lanes %u-%u", shaderCaps.nativeFP16 ? "yes" : "no", shaderCaps.waveLaneCountMin, shaderCaps.waveLaneCountMax);
+
+    if (platform != RenderAPI::eD3D11)
     {
-    case RenderAPI::eVulkan:
+        // Immediate context is not ours to use from this thread on d3d11
+        initializeNISOnOwnQueue();
+    }
+
+    // Half precision permutations are only used when the device runs 16-bit math natively, otherwise the full precision ones are
+    if (platform == RenderAPI::eVulkan)
+    {
+#if NIS_SPV_FULL_PRECISION
+        if (!shaderCaps.nativeFP16)
         {
-            ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::eNone, NIS_Sharpen_V0_H0_spv, NIS_Sharpen_V0_H0_spv_len, "NIS_Sharpen_V0_H0.spv");
-            ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::eLinear, NIS_Sharpen_V0_H1_spv, NIS_Sharpen_V0_H1_spv_len, "NIS_Sharpen_V0_H1.spv");
-            ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::ePQ, NIS_Sharpen_V0_H2_spv, NIS_Sharpen_V0_H2_spv_len, "NIS_Sharpen_V0_H2.spv");
-            ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::eNone, NIS_Sharpen_V1_H0_spv, NIS_Sharpen_V1_H0_spv_len, "NIS_Sharpen_V1_H0.spv");
-            ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::eLinear, NIS_Sharpen_V1_H1_spv, NIS_Sharpen_V1_H1_spv_len, "NIS_Sharpen_V1_H1.spv");
-            ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::ePQ, NIS_Sharpen_V1_H2_spv, NIS_Sharpen_V1_H2_spv_len, "NIS_Sharpen_V1_H2.spv");
-            ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::eNone, NIS_Scaler_V0_H0_spv, NIS_Scaler_V0_H0_spv_len, "NIS_Scaler_V0_H0.spv");
-            ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::eLinear, NIS_Scaler_V0_H1_spv, NIS_Scaler_V0_H1_spv_len, "NIS_Scaler_V0_H1.spv");
-            ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::ePQ, NIS_Scaler_V0_H2_spv, NIS_Scaler_V0_H2_spv_len, "NIS_Scaler_V0_H2.spv");
-            ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::eNone, NIS_Scaler_V1_H0_spv, NIS_Scaler_V1_H0_spv_len, "NIS_Scaler_V1_H0.spv");
-            ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::eLinear, NIS_Scaler_V1_H1_spv, NIS_Scaler_V1_H1_spv_len, "NIS_Scaler_V1_H1.spv");
-            ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::ePQ, NIS_Scaler_V1_H2_spv, NIS_Scaler_V1_H2_spv_len, "NIS_Scaler_V1_H2.spv");
-            break;
+            ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::eNone, false, NIS_Sharpen_V0_H0_spv_fp32, NIS_Sharpen_V0_H0_spv_fp32_len, "NIS_Sharpen_V0_H0.spv_fp32");
+            ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::eLinear, false, NIS_Sharpen_V0_H1_spv_fp32, NIS_Sharpen_V0_H1_spv_fp32_len, "NIS_Sharpen_V0_H1.spv_fp32");
+            ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::ePQ, false, NIS_Sharpen_V0_H2_spv_fp32, NIS_Sharpen_V0_H2_spv_fp32_len, "NIS_Sharpen_V0_H2.spv_fp32");
+            ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::eNone, false, NIS_Sharpen_V1_H0_spv_fp32, NIS_Sharpen_V1_H0_spv_fp32_len, "NIS_Sharpen_V1_H0.spv_fp32");
+            ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::eLinear, false, NIS_Sharpen_V1_H1_spv_fp32, NIS_Sharpen_V1_H1_spv_fp32_len, "NIS_Sharpen_V1_H1.spv_fp32");
+            ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::ePQ, false, NIS_Sharpen_V1_H2_spv_fp32, NIS_Sharpen_V1_H2_spv_fp32_len, "NIS_Sharpen_V1_H2.spv_fp32");
+            ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::eNone, false, NIS_Scaler_V0_H0_spv_fp32, NIS_Scaler_V0_H0_spv_fp32_len, "NIS_Scaler_V0_H0.spv_fp32");
+            ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::eLinear, false, NIS_Scaler_V0_H1_spv_fp32, NIS_Scaler_V0_H1_spv_fp32_len, "NIS_Scaler_V0_H1.spv_fp32");
+            ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::ePQ, false, NIS_Scaler_V0_H2_spv_fp32, NIS_Scaler_V0_H2_spv_fp32_len, "NIS_Scaler_V0_H2.spv_fp32");
+            ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::eNone, false, NIS_Scaler_V1_H0_spv_fp32, NIS_Scaler_V1_H0_spv_fp32_len, "NIS_Scaler_V1_H0.spv_fp32");
+            ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::eLinear, false, NIS_Scaler_V1_H1_spv_fp32, NIS_Scaler_V1_H1_spv_fp32_len, "NIS_Scaler_V1_H1.spv_fp32");
+            ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::ePQ, false, NIS_Scaler_V1_H2_spv_fp32, NIS_Scaler_V1_H2_spv_fp32_len, "NIS_Scaler_V1_H2.spv_fp32");
+#if NIS_OUTPUT_ENCODE_PERMUTATIONS
+            {
+                const bool halfPrecision = false;
+                NIS_ENCODE_PERMUTATIONS_spv_fp32(NIS_ADD_ENCODE_PERMUTATION)
+            }
+#endif
         }
-    case RenderAPI::eD3D12:
+        else
+#else
+        if (!shaderCaps.nativeFP16)
         {
-            ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::eNone, NIS_Sharpen_V0_H0_cs6, NIS_Sharpen_V0_H0_cs6_len, "NIS_Sharpen_V0_H0.cs6");
-            ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::eLinear, NIS_Sharpen_V0_H1_cs6, NIS_Sharpen_V0_H1_cs6_len, "NIS_Sharpen_V0_H1.cs6");
-            ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::ePQ, NIS_Sharpen_V0_H2_cs6, NIS_Sharpen_V0_H2_cs6_len, "NIS_Sharpen_V0_H2.cs6");
-            ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::eNone, NIS_Sharpen_V1_H0_cs6, NIS_Sharpen_V1_H0_cs6_len, "NIS_Sharpen_V1_H0.cs6");
-            ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::eLinear, NIS_Sharpen_V1_H1_cs6, NIS_Sharpen_V1_H1_cs6_len, "NIS_Sharpen_V1_H1.cs6");
-            ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::ePQ, NIS_Sharpen_V1_H2_cs6, NIS_Sharpen_V1_H2_cs6_len, "NIS_Sharpen_V1_H2.cs6");
-            ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::eNone, NIS_Scaler_V0_H0_cs6, NIS_Scaler_V0_H0_cs6_len, "NIS_Scaler_V0_H0.cs6");
-            ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::eLinear, NIS_Scaler_V0_H1_cs6, NIS_Scaler_V0_H1_cs6_len, "NIS_Scaler_V0_H1.cs6");
-            ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::ePQ, NIS_Scaler_V0_H2_cs6, NIS_Scaler_V0_H2_cs6_len, "NIS_Scaler_V0_H2.cs6");
-            ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::eNone, NIS_Scaler_V1_H0_cs6, NIS_Scaler_V1_H0_cs6_len, "NIS_Scaler_V1_H0.cs6");
-            ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::eLinear, NIS_Scaler_V1_H1_cs6, NIS_Scaler_V1_H1_cs6_len, "NIS_Scaler_V1_H1.cs6");
-            ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::ePQ, NIS_Scaler_V1_H2_cs6, NIS_Scaler_V1_H2_cs6_len, "NIS_Scaler_V1_H2.cs6");
-            break;
+            SL_LOG_WARN("Device does not report 'shaderFloat16' and no full precision SPIR-V was compiled, NIS may fail to run");
         }
-    default:
+#endif
         {
-            ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::eNone, NIS_Sharpen_V0_H0_cs, NIS_Sharpen_V0_H0_cs_len, "NIS_Sharpen_V0_H0.cs");
-            ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::eLinear, NIS_Sharpen_V0_H1_cs, NIS_Sharpen_V0_H1_cs_len, "NIS_Sharpen_V0_H1.cs");
-            ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::ePQ, NIS_Sharpen_V0_H2_cs, NIS_Sharpen_V0_H2_cs_len, "NIS_Sharpen_V0_H2.cs");
-            ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::eNone, NIS_Sharpen_V1_H0_cs, NIS_Sharpen_V1_H0_cs_len, "NIS_Sharpen_V1_H0.cs");
-            ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::eLinear, NIS_Sharpen_V1_H1_cs, NIS_Sharpen_V1_H1_cs_len, "NIS_Sharpen_V1_H1.cs");
-            ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::ePQ, NIS_Sharpen_V1_H2_cs, NIS_Sharpen_V1_H2_cs_len, "NIS_Sharpen_V1_H2.cs");
-            ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::eNone, NIS_Scaler_V0_H0_cs, NIS_Scaler_V0_H0_cs_len, "NIS_Scaler_V0_H0.cs");
-            ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::eLinear, NIS_Scaler_V0_H1_cs, NIS_Scaler_V0_H1_cs_len, "NIS_Scaler_V0_H1.cs");
-            ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::ePQ, NIS_Scaler_V0_H2_cs, NIS_Scaler_V0_H2_cs_len, "NIS_Scaler_V0_H2.cs");
-            ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::eNone, NIS_Scaler_V1_H0_cs, NIS_Scaler_V1_H0_cs_len, "NIS_Scaler_V1_H0.cs");
-            ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::eLinear, NIS_Scaler_V1_H1_cs, NIS_Scaler_V1_H1_cs_len, "NIS_Scaler_V1_H1.cs");
-            ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::ePQ, NIS_Scaler_V1_H2_cs, NIS_Scaler_V1_H2_cs_len, "NIS_Scaler_V1_H2.cs");
-            break;
+            ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::eNone, true, NIS_Sharpen_V0_H0_spv, NIS_Sharpen_V0_H0_spv_len, "NIS_Sharpen_V0_H0.spv");
+            ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::eLinear, true, NIS_Sharpen_V0_H1_spv, NIS_Sharpen_V0_H1_spv_len, "NIS_Sharpen_V0_H1.spv");
+            ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::ePQ, true, NIS_Sharpen_V0_H2_spv, NIS_Sharpen_V0_H2_spv_len, "NIS_Sharpen_V0_H2.spv");
+            ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::eNone, true, NIS_Sharpen_V1_H0_spv, NIS_Sharpen_V1_H0_spv_len, "NIS_Sharpen_V1_H0.spv");
+            ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::eLinear, true, NIS_Sharpen_V1_H1_spv, NIS_Sharpen_V1_H1_spv_len, "NIS_Sharpen_V1_H1.spv");
+            ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::ePQ, true, NIS_Sharpen_V1_H2_spv, NIS_Sharpen_V1_H2_spv_len, "NIS_Sharpen_V1_H2.spv");
+            ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::eNone, true, NIS_Scaler_V0_H0_spv, NIS_Scaler_V0_H0_spv_len, "NIS_Scaler_V0_H0.spv");
+            ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::eLinear, true, NIS_Scaler_V0_H1_spv, NIS_Scaler_V0_H1_spv_len, "NIS_Scaler_V0_H1.spv");
+            ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::ePQ, true, NIS_Scaler_V0_H2_spv, NIS_Scaler_V0_H2_spv_len, "NIS_Scaler_V0_H2.spv");
+            ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::eNone, true, NIS_Scaler_V1_H0_spv, NIS_Scaler_V1_H0_spv_len, "NIS_Scaler_V1_H0.spv");
+            ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::eLinear, true, NIS_Scaler_V1_H1_spv, NIS_Scaler_V1_H1_spv_len, "NIS_Scaler_V1_H1.spv");
+            ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::ePQ, true, NIS_Scaler_V1_H2_spv, NIS_Scaler_V1_H2_spv_len, "NIS_Scaler_V1_H2.spv");
+#if NIS_OUTPUT_ENCODE_PERMUTATIONS
+            {
+                const bool halfPrecision = true;
+                NIS_ENCODE_PERMUTATIONS_spv(NIS_ADD_ENCODE_PERMUTATION)
+            }
+#endif
+        }
+    }
+    else if (platform == RenderAPI::eD3D12 && (!NIS_CS6_HALF_PRECISION || shaderCaps.nativeFP16))
+    {
+        ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::eNone, NIS_CS6_HALF_PRECISION != 0, NIS_Sharpen_V0_H0_cs6, NIS_Sharpen_V0_H0_cs6_len, "NIS_Sharpen_V0_H0.cs6");
+        ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::eLinear, NIS_CS6_HALF_PRECISION != 0, NIS_Sharpen_V0_H1_cs6, NIS_Sharpen_V0_H1_cs6_len, "NIS_Sharpen_V0_H1.cs6");
+        ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::ePQ, NIS_CS6_HALF_PRECISION != 0, NIS_Sharpen_V0_H2_cs6, NIS_Sharpen_V0_H2_cs6_len, "NIS_Sharpen_V0_H2.cs6");
+        ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::eNone, NIS_CS6_HALF_PRECISION != 0, NIS_Sharpen_V1_H0_cs6, NIS_Sharpen_V1_H0_cs6_len, "NIS_Sharpen_V1_H0.cs6");
+        ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::eLinear, NIS_CS6_HALF_PRECISION != 0, NIS_Sharpen_V1_H1_cs6, NIS_Sharpen_V1_H1_cs6_len, "NIS_Sharpen_V1_H1.cs6");
+        ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::ePQ, NIS_CS6_HALF_PRECISION != 0, NIS_Sharpen_V1_H2_cs6, NIS_Sharpen_V1_H2_cs6_len, "NIS_Sharpen_V1_H2.cs6");
+        ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::eNone, NIS_CS6_HALF_PRECISION != 0, NIS_Scaler_V0_H0_cs6, NIS_Scaler_V0_H0_cs6_len, "NIS_Scaler_V0_H0.cs6");
+        ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::eLinear, NIS_CS6_HALF_PRECISION != 0, NIS_Scaler_V0_H1_cs6, NIS_Scaler_V0_H1_cs6_len, "NIS_Scaler_V0_H1.cs6");
+        ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::ePQ, NIS_CS6_HALF_PRECISION != 0, NIS_Scaler_V0_H2_cs6, NIS_Scaler_V0_H2_cs6_len, "NIS_Scaler_V0_H2.cs6");
+        ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::eNone, NIS_CS6_HALF_PRECISION != 0, NIS_Scaler_V1_H0_cs6, NIS_Scaler_V1_H0_cs6_len, "NIS_Scaler_V1_H0.cs6");
+        ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::eLinear, NIS_CS6_HALF_PRECISION != 0, NIS_Scaler_V1_H1_cs6, NIS_Scaler_V1_H1_cs6_len, "NIS_Scaler_V1_H1.cs6");
+        ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::ePQ, NIS_CS6_HALF_PRECISION != 0, NIS_Scaler_V1_H2_cs6, NIS_Scaler_V1_H2_cs6_len, "NIS_Scaler_V1_H2.cs6");
+#if NIS_OUTPUT_ENCODE_PERMUTATIONS
+        {
+            const bool halfPrecision = NIS_CS6_HALF_PRECISION != 0;
+            NIS_ENCODE_PERMUTATIONS_cs6(NIS_ADD_ENCODE_PERMUTATION)
         }
+#endif
     }
+    else
+    {
+        // SM 5.0 byte code runs on d3d11 and is the full precision fallback on d3d12
+        ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::eNone, false, NIS_Sharpen_V0_H0_cs, NIS_Sharpen_V0_H0_cs_len, "NIS_Sharpen_V0_H0.cs");
+        ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::eLinear, false, NIS_Sharpen_V0_H1_cs, NIS_Sharpen_V0_H1_cs_len, "NIS_Sharpen_V0_H1.cs");
+        ctx.addShaderPermutation(NISMode::eSharpen, 0, NISHDR::ePQ, false, NIS_Sharpen_V0_H2_cs, NIS_Sharpen_V0_H2_cs_len, "NIS_Sharpen_V0_H2.cs");
+        ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::eNone, false, NIS_Sharpen_V1_H0_cs, NIS_Sharpen_V1_H0_cs_len, "NIS_Sharpen_V1_H0.cs");
+        ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::eLinear, false, NIS_Sharpen_V1_H1_cs, NIS_Sharpen_V1_H1_cs_len, "NIS_Sharpen_V1_H1.cs");
+        ctx.addShaderPermutation(NISMode::eSharpen, 1, NISHDR::ePQ, false, NIS_Sharpen_V1_H2_cs, NIS_Sharpen_V1_H2_cs_len, "NIS_Sharpen_V1_H2.cs");
+        ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::eNone, false, NIS_Scaler_V0_H0_cs, NIS_Scaler_V0_H0_cs_len, "NIS_Scaler_V0_H0.cs");
+        ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::eLinear, false, NIS_Scaler_V0_H1_cs, NIS_Scaler_V0_H1_cs_len, "NIS_Scaler_V0_H1.cs");
+        ctx.addShaderPermutation(NISMode::eScaler, 0, NISHDR::ePQ, false, NIS_Scaler_V0_H2_cs, NIS_Scaler_V0_H2_cs_len, "NIS_Scaler_V0_H2.cs");
+        ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::eNone, false, NIS_Scaler_V1_H0_cs, NIS_Scaler_V1_H0_cs_len, "NIS_Scaler_V1_H0.cs");
+        ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::eLinear, false, NIS_Scaler_V1_H1_cs, NIS_Scaler_V1_H1_cs_len, "NIS_Scaler_V1_H1.cs");
+        ctx.addShaderPermutation(NISMode::eScaler, 1, NISHDR::ePQ, false, NIS_Scaler_V1_H2_cs, NIS_Scaler_V1_H2_cs_len, "NIS_Scaler_V1_H2.cs");
+#if NIS_OUTPUT_ENCODE_PERMUTATIONS
+        {
+            const bool halfPrecision = false;
+            NIS_ENCODE_PERMUTATIONS_cs(NIS_ADD_ENCODE_PERMUTATION)
+        }
+#endif
+    }
+
   
 #ifndef SL_PRODUCTION
     // Check for UI and register our callback
@@ -479,21 +810,25 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
         auto renderUI = [&ctx](imgui::ImGUI* ui, bool finalFrame)->void
         {
             auto v = api::getContext()->pluginVersion;
-            std::scoped_lock lock(ctx.uiStats.mtx);
+            UIStats stats{};
+            bool active = ctx.uiStats.read(stats);
             uint32_t lastFrame, frame;
             if (api::getContext()->parameters->get(sl::param::nis::kCurrentFrame, &lastFrame))
             {
                 ctx.compute->getFinishedFrameIndex(frame);
-                if (lastFrame < frame)
-                {
-                    ctx.uiStats.mode = "Mode: Off";
-                    ctx.uiStats.viewport = ctx.uiStats.runtime = {};
-                }
+                active &= lastFrame >= frame;
                 if (ui->collapsingHeader(extra::format("sl.nis v{}", (v.toStr() + "." + GIT_LAST_COMMIT_SHORT)).c_str(), imgui::kTreeNodeFlagDefaultOpen))
                 {
-                    ui->text(ctx.uiStats.mode.c_str());
-                    ui->text(ctx.uiStats.viewport.c_str());
-                    ui->text(ctx.uiStats.runtime.c_str());
+                    if (active)
+                    {
+                        ui->text(getNISModeAsStr(stats.mode));
+                        ui->text("Viewport %ux%u -> %ux%u", stats.inputWidth, stats.inputHeight, stats.outputWidth, stats.outputHeight);
+                        ui->text("Execution time %.2fms", stats.runtimeMs);
+                    }
+                    else
+                    {
+                        ui->text("Mode: Off");
+                    }
                 }
             }
         };
@@ -510,24 +845,29 @@ void slOnPluginShutdown()
 {
     auto& ctx = (*nis::getContext());
     ctx.registerEvaluateCallbacks(kFeatureNIS, nullptr, nullptr);
+    ctx.evaluateContext.clear();
 
     // it will shutdown it down automatically
     plugin::onShutdown(api::getContext());
 
-    if (ctx.uploadScalerCoef)
-    {
-        ctx.compute->destroyResource(ctx.uploadScalerCoef);
-    }
-    if (ctx.uploadUsmCoef)
-    {
-        ctx.compute->destroyResource(ctx.uploadUsmCoef);
-    }
     ctx.compute->destroyResource(ctx.scalerCoef);
     ctx.compute->destroyResource(ctx.usmCoef);
 
+    for (auto& [id, viewport] : ctx.viewports)
+    {
+        if (viewport.bundle)
+        {
+            CHI_VALIDATE(ctx.compute->destroyBundle(viewport.bundle));
+        }
+    }
+    ctx.viewports.clear();
+
     for (auto& e : ctx.shaders)
     {
-        CHI_VALIDATE(ctx.compute->destroyKernel(e.second));
+        if (e.second.kernel)
+        {
+            CHI_VALIDATE(ctx.compute->destroyKernel(e.second.kernel));
+        }
     }
     ctx.compute = {};
 }
@@ -547,10 +887,6 @@ sl::Result slNISGetState(const sl::ViewportHandle& viewport, sl::NISState& state
     state.estimatedVRAMUsageInBytes = 0;
 
     chi::ResourceFootprint footprint{};
-    ctx.compute->getResourceFootprint(ctx.uploadScalerCoef, footprint);
-    state.estimatedVRAMUsageInBytes += footprint.totalBytes;
-    ctx.compute->getResourceFootprint(ctx.uploadUsmCoef, footprint);
-    state.estimatedVRAMUsageInBytes += footprint.totalBytes;
     ctx.compute->getResourceFootprint(ctx.scalerCoef, footprint);
     state.estimatedVRAMUsageInBytes += footprint.totalBytes;
     ctx.compute->getResourceFootprint(ctx.usmCoef, footprint);
@@ -28,9 +28,19 @@ import os.path
 def hasCompiler(compiler):
     return shutil.which(compiler) is not None
 
-def outputFilename(scalerMode, viewportSupport, hdrMode):
+def outputFilename(scalerMode, viewportSupport, hdrMode, outputEncode = 0):
     mode = "Scaler" if scalerMode else "Sharpen"
-    return f"NIS_{mode}_V{viewportSupport}_H{hdrMode}"
+    encode = f"_E{outputEncode}" if outputEncode else ""
+    return f"NIS_{mode}_V{viewportSupport}_H{hdrMode}{encode}"
+
+# Output encodes only apply to matching inputs, PQ encode needs linear HDR and scRGB needs PQ
+def outputEncodes(hdrMode):
+    encodes = [0, 1]
+    if hdrMode == 1:
+        encodes.append(2)
+    if hdrMode == 2:
+        encodes.append(3)
+    return encodes
 
 def appendToHeader(shadersFolder, outputHeader, shaderName, extension):
     print(f"{shaderName}.{extension}")
@@ -87,12 +97,14 @@ def generatePermutations(slangcPath, dxcPath, inputFolder, outputFolder):
     if os.path.exists(outputHeader):
         os.remove(outputHeader)
 
-    shaderTypes = ['cs', 'cs6', 'spv']
+    # 'spv_fp32' is the full precision fallback for devices without shaderFloat16
+    shaderTypes = ['cs', 'cs6', 'spv', 'spv_fp32']
+    encodePermutations = {st: [] for st in shaderTypes}
     for upscale in range(2):
         for viewport in range(2):
             for hdr in range(3):
-                for st in shaderTypes:
-                    shaderName = outputFilename(upscale, viewport, hdr)
+                for encode, st in [(e, st) for e in outputEncodes(hdr) for st in shaderTypes]:
+                    shaderName = outputFilename(upscale, viewport, hdr, encode)
                     fullName = os.path.join(outputFolder, shaderName) + "." + st
                     options = ""
                     if st == 'cs':
@@ -114,6 +126,15 @@ def generatePermutations(slangcPath, dxcPath, inputFolder, outputFolder):
                         use_vk_bindings = 1
                         use_half_precision = 1
                         options += f" -target {target}"
+                    if st == 'spv_fp32':
+                        arch = 'NVIDIA_Generic'
+                        blockWidth, blockHeight, threadGroupSize = GetOptimalArguments(arch, upscale)
+                        target = "spirv"
+                        hlsl_6_2 = 1
+                        profile = 'sm_6_2'
+                        use_vk_bindings = 1
+                        use_half_precision = 0
+                        options += f" -target {target}"
                     if st == 'cs6':
                         if dxcPath != None:
                             arch = 'NVIDIA_Generic_fp16'
@@ -145,6 +166,7 @@ def generatePermutations(slangcPath, dxcPath, inputFolder, outputFolder):
                     options += f" -D NIS_HLSL_6_2={hlsl_6_2}"
                     options += f" -D NIS_DXC={use_vk_bindings}"
                     options += f" -D NIS_USE_HALF_PRECISION={use_half_precision}"
+                    options += f" -D NIS_OUTPUT_ENCODE={encode}"
                     options += f" -entry main -stage compute -profile {profile} -O3 -o {fullName} {inputShader}"
                     try:
                         return_code = subprocess.run(compiler+" "+options)
@@ -154,6 +176,17 @@ def generatePermutations(slangcPath, dxcPath, inputFolder, outputFolder):
                     if os.path.exists(fullName):
                         appendToHeader(outputFolder, outputHeader, shaderName, st)
                         os.remove(fullName)
+                        if encode:
+                            encodePermutations[st].append(f"    X({upscale}, {viewport}, {hdr}, {encode}, {shaderName}_{st}, \"{shaderName}.{st}\")")
+    # sl.nis only uses half precision byte code on devices with native fp16 and dispatches with matching block sizes
+    with open(outputHeader, "a") as f:
+        f.write(f"#define NIS_CS6_HALF_PRECISION {0 if dxcPath == None else 1}\n")
+        f.write(f"#define NIS_SPV_FULL_PRECISION 1\n")
+        # X(scaler, viewport, hdr, encode, byteCode, filename) lists, the plain permutations are registered explicitly
+        for st in shaderTypes:
+            entries = " \\\n".join(encodePermutations[st])
+            f.write(f"#define NIS_ENCODE_PERMUTATIONS_{st}(X) \\\n{entries}\n")
+        f.write(f"#define NIS_OUTPUT_ENCODE_PERMUTATIONS 1\n")
     print("\nOutput header file : " + outputHeader)
     return
 
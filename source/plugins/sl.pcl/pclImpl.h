@@ -4,29 +4,42 @@
 #include "source/core/sl.plugin-manager/pluginManager.h"
 #include "source/plugins/sl.pcl/pclstats.h"
 #include "source/plugins/sl.reflex/reflex_shared.h"
+#include "source/plugins/sl.pcl/pclMarkerRing.h"
 
 namespace sl
 {
 namespace pcl
 {
 
+//! In process marker capture, see PCLMarkerCaptureOptions
+static MarkerRing s_markerRing;
+
 Result implSetData(const BaseStructure* inputs, sl::PCLOptions& constants)
 {	
     auto marker = findStruct<PCLHelper>(inputs);
     auto consts = findStruct<PCLOptions>(inputs);
     auto frame = findStruct<FrameToken>(inputs);
+    auto capture = findStruct<PCLMarkerCaptureOptions>(inputs);
     
     if (marker && frame)
     {
         auto evd_id = (PCLSTATS_LATENCY_MARKER_TYPE)to_underlying(marker->get());
         PCLSTATS_MARKER(evd_id, *frame);
+        s_markerRing.record(marker->get(), *frame);
     }
-    else if (consts)
+    else if (consts || capture)
     {
-        PCLSTATS_SET_ID_THREAD(consts->idThread);
-        PCLSTATS_SET_VIRTUAL_KEY(to_underlying(consts->virtualKey));
+        if (consts)
+        {
+            PCLSTATS_SET_ID_THREAD(consts->idThread);
+            PCLSTATS_SET_VIRTUAL_KEY(to_underlying(consts->virtualKey));
 
-        constants = *consts;
+            constants = *consts;
+        }
+        if (capture && !s_markerRing.enable(capture->enable == Boolean::eTrue))
+        {
+            return Result::eErrorInvalidState;
+        }
     }
     else
     {
@@ -39,12 +52,20 @@ Result implSetData(const BaseStructure* inputs, sl::PCLOptions& constants)
 Result implGetData(BaseStructure* outputs)
 {
     auto settings = findStruct<PCLState>(outputs);
-    if (!settings)
+    auto timestamps = findStruct<PCLMarkerTimestamps>(outputs);
+    if (!settings && !timestamps)
     {
         return Result::eErrorMissingInputParameter;
     }
-    // Allow host to check Windows messages for the special low latency message
-    settings->statsWindowMessage = g_PCLStatsWindowMessage;
+    if (settings)
+    {
+        // Allow host to check Windows messages for the special low latency message
+        settings->statsWindowMessage = g_PCLStatsWindowMessage;
+    }
+    if (timestamps)
+    {
+        s_markerRing.read(*timestamps);
+    }
     return Result::eOk;
 }
 
@@ -53,6 +74,7 @@ Result implGetData(BaseStructure* outputs)
 void setPCLStatsMarker(PCLMarker marker, uint32_t frameId)
 {
     PCLSTATS_MARKER(to_underlying(marker), frameId);
+    s_markerRing.record(marker, frameId);
 }
 
 void implOnPluginStartup(sl::param::IParameters* parameters, plugin_manager::PFun_slGetDataInternal* getter, plugin_manager::PFun_slSetDataInternal* setter)
@@ -74,6 +96,7 @@ void implOnPluginShutdown(sl::param::IParameters* parameters)
 {
 	//! GPU agnostic latency stats shutdown
     PCLSTATS_SHUTDOWN();
+    s_markerRing.close();
 
     parameters->set(param::pcl::kPFunSetPCLStatsMarker, nullptr);
     // DEPRECATED (reflex-pcl):
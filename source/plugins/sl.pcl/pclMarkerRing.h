@@ -0,0 +1,255 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+#include <windows.h>
+#include <atomic>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "include/sl_pcl.h"
+#include "source/core/sl.log/log.h"
+
+namespace sl
+{
+namespace pcl
+{
+
+//! Shared memory layout of captured PCL markers
+//! 
+//! [MarkerRingHeader][MarkerRingThread x threadCount]
+//! 
+//! Each thread setting markers owns one ring so writers never contend, an entry is
+//! valid once 'writeIndex' moves past it and until the writer laps it. Readers (slGetData
+//! or an external process mapping 'sharedMemoryName' read-only) copy entries in
+//! [writeIndex - capacity + 1, writeIndex) and re-read 'writeIndex' to drop lapped ones.
+
+constexpr uint32_t kMarkerRingMagic = 0x4d50534c; // 'SLPM'
+constexpr uint32_t kMarkerRingVersion = 1;
+constexpr uint32_t kMarkerRingThreadCount = 16;
+constexpr uint32_t kMarkerRingCapacity = 1024; // Power of two
+
+struct MarkerRingHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t threadCount;
+    uint32_t capacity;
+    int64_t qpcFrequency;
+    //! Rings claimed so far, threads beyond 'threadCount' are not captured
+    std::atomic<uint32_t> threadsUsed;
+    uint32_t reserved;
+};
+
+struct MarkerRingThread
+{
+    std::atomic<uint32_t> threadId;
+    uint32_t reserved;
+    std::atomic<uint64_t> writeIndex;
+    PCLMarkerTimestamp entries[kMarkerRingCapacity];
+};
+
+class MarkerRing
+{
+public:
+    ~MarkerRing() { close(); }
+
+    //! Creates 'Local\SL_PCL_Markers_<pid>' on first use, later calls only toggle capture
+    bool enable(bool value)
+    {
+        if (value && !m_header && !open())
+        {
+            return false;
+        }
+        m_enabled.store(value && m_header, std::memory_order_release);
+        return true;
+    }
+
+    void close()
+    {
+        m_enabled.store(false);
+        if (m_header)
+        {
+            UnmapViewOfFile(m_header);
+            m_header = {};
+            m_threads = {};
+        }
+        if (m_mapping)
+        {
+            CloseHandle(m_mapping);
+            m_mapping = {};
+        }
+        m_name.clear();
+    }
+
+    //! Safe to call from any thread, never blocks or allocates
+    void record(PCLMarker marker, uint64_t frameId)
+    {
+        if (!m_enabled.load(std::memory_order_acquire))
+        {
+            return;
+        }
+        LARGE_INTEGER qpc{};
+        QueryPerformanceCounter(&qpc);
+
+        auto ring = getThreadRing();
+        if (!ring)
+        {
+            return;
+        }
+        // Single writer per ring, publishing the index is what makes the entry visible
+        auto index = ring->writeIndex.load(std::memory_order_relaxed);
+        ring->entries[index & (kMarkerRingCapacity - 1)] = { marker, ring->threadId.load(std::memory_order_relaxed), frameId, qpc.QuadPart };
+        ring->writeIndex.store(index + 1, std::memory_order_release);
+    }
+
+    //! Merges all thread rings into 'out', see PCLMarkerTimestamps
+    void read(PCLMarkerTimestamps& out)
+    {
+        out.count = 0;
+        out.qpcFrequency = m_header ? m_header->qpcFrequency : 0;
+        out.sharedMemoryName = m_header ? m_name.c_str() : nullptr;
+        if (!m_header)
+        {
+            return;
+        }
+
+        m_scratch.clear();
+        auto threadsUsed = std::min(m_header->threadsUsed.load(std::memory_order_acquire), kMarkerRingThreadCount);
+        for (uint32_t t = 0; t < threadsUsed; t++)
+        {
+            auto& ring = m_threads[t];
+            auto end = ring.writeIndex.load(std::memory_order_acquire);
+            auto begin = end > kMarkerRingCapacity - 1 ? end - (kMarkerRingCapacity - 1) : 0;
+            auto first = m_scratch.size();
+            for (auto i = begin; i < end; i++)
+            {
+                m_scratch.push_back(ring.entries[i & (kMarkerRingCapacity - 1)]);
+            }
+            // Anything the writer lapped while we were copying is garbage
+            auto endAfter = ring.writeIndex.load(std::memory_order_acquire);
+            auto validBegin = endAfter > kMarkerRingCapacity - 1 ? endAfter - (kMarkerRingCapacity - 1) : 0;
+            auto torn = (size_t)(std::min(std::max(validBegin, begin), end) - begin);
+            m_scratch.erase(m_scratch.begin() + first, m_scratch.begin() + first + torn);
+        }
+
+        auto seen = std::remove_if(m_scratch.begin(), m_scratch.end(), [&out](const PCLMarkerTimestamp& t) { return t.qpc <= out.sinceQpc; });
+        m_scratch.erase(seen, m_scratch.end());
+        std::stable_sort(m_scratch.begin(), m_scratch.end(), [](const PCLMarkerTimestamp& a, const PCLMarkerTimestamp& b) { return a.qpc < b.qpc; });
+        if (!out.timestamps)
+        {
+            return;
+        }
+        // Oldest first so whatever does not fit is returned on the next call
+        out.count = (uint32_t)std::min<size_t>(m_scratch.size(), out.capacity);
+        // Never split markers sharing a QPC value, 'sinceQpc' would skip the rest
+        while (out.count && out.count < m_scratch.size() && m_scratch[out.count].qpc == m_scratch[out.count - 1].qpc)
+        {
+            out.count--;
+        }
+        std::copy(m_scratch.begin(), m_scratch.begin() + out.count, out.timestamps);
+        if (out.count)
+        {
+            out.sinceQpc = out.timestamps[out.count - 1].qpc;
+        }
+    }
+
+private:
+    bool open()
+    {
+        constexpr size_t kSize = sizeof(MarkerRingHeader) + sizeof(MarkerRingThread) * kMarkerRingThreadCount;
+        auto name = "Local\\SL_PCL_Markers_" + std::to_string(GetCurrentProcessId());
+        auto mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, 0, (DWORD)kSize, name.c_str());
+        if (!mapping)
+        {
+            SL_LOG_ERROR("Failed to create PCL marker section '%s' - error %u", name.c_str(), GetLastError());
+            return false;
+        }
+        if (GetLastError() == ERROR_ALREADY_EXISTS)
+        {
+            SL_LOG_ERROR("PCL marker section '%s' is already in use", name.c_str());
+            CloseHandle(mapping);
+            return false;
+        }
+        auto view = (uint8_t*)MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, kSize);
+        if (!view)
+        {
+            CloseHandle(mapping);
+            return false;
+        }
+
+        // Pagefile backed sections are zero filled so all rings start empty
+        auto header = (MarkerRingHeader*)view;
+        LARGE_INTEGER frequency{};
+        QueryPerformanceFrequency(&frequency);
+        header->magic = kMarkerRingMagic;
+        header->version = kMarkerRingVersion;
+        header->threadCount = kMarkerRingThreadCount;
+        header->capacity = kMarkerRingCapacity;
+        header->qpcFrequency = frequency.QuadPart;
+
+        m_mapping = mapping;
+        m_threads = (MarkerRingThread*)(view + sizeof(MarkerRingHeader));
+        m_header = header;
+        m_name = name;
+        m_generation++;
+        SL_LOG_INFO("PCL marker capture published as '%s'", name.c_str());
+        return true;
+    }
+
+    MarkerRingThread* getThreadRing()
+    {
+        // Rings outlive the threads, a new section (or plugin reload) invalidates cached ones
+        thread_local uint32_t t_generation = 0;
+        thread_local MarkerRingThread* t_ring = nullptr;
+        auto generation = m_generation.load(std::memory_order_acquire);
+        if (t_generation != generation)
+        {
+            t_generation = generation;
+            auto index = m_header->threadsUsed.fetch_add(1, std::memory_order_acq_rel);
+            t_ring = index < kMarkerRingThreadCount ? &m_threads[index] : nullptr;
+            if (t_ring)
+            {
+                t_ring->threadId.store(GetCurrentThreadId(), std::memory_order_relaxed);
+            }
+            else
+            {
+                SL_LOG_WARN_ONCE("More than %u threads are setting PCL markers, extra threads are not captured", kMarkerRingThreadCount);
+            }
+        }
+        return t_ring;
+    }
+
+    HANDLE m_mapping{};
+    MarkerRingHeader* m_header{};
+    MarkerRingThread* m_threads{};
+    std::string m_name;
+    std::atomic<bool> m_enabled{};
+    std::atomic<uint32_t> m_generation{};
+    //! Only touched by readers, slGetData is not thread safe
+    std::vector<PCLMarkerTimestamp> m_scratch;
+};
+
+} // namespace pcl
+} // namespace sl
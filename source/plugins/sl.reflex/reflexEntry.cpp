@@ -20,13 +20,25 @@
 * SOFTWARE.
 */
 
+#include <algorithm>
+#include <chrono>
 #include <unordered_set>
+#include <thread>
+#include <condition_variable>
+#include <unordered_map>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <dxgi1_6.h>
 
 #include "include/sl.h"
 #include "include/sl_consts.h"
 #include "source/core/sl.log/log.h"
 #include "source/core/sl.api/internalDataSharing.h"
 #include "source/core/sl.plugin/plugin.h"
+#include "source/core/sl.extra/preciseWait.h"
+#include "source/core/sl.thread/thread.h"
 #include "source/core/sl.param/parameters.h"
 #include "source/platforms/sl.chi/compute.h"
 #include "source/plugins/sl.reflex/versions.h"
@@ -53,85 +65,737 @@ namespace sl
 namespace reflex
 {
 
+//! Raw numbers written on the marker path, formatted by the UI callback only when the overlay is rendered
 struct UIStats
 {
-    std::mutex mtx;
-    std::string mode;
-    std::string markers;
-    std::string fpsCap;
-    std::string presentFrame;
-    std::string sleeping;
+    std::atomic<uint32_t> mode{};
+    std::atomic<bool> useMarkersToOptimize{};
+    std::atomic<uint32_t> frameLimitUs{};
+    std::atomic<bool> adaptiveFrameLimit{};
+    std::atomic<uint32_t> presentFrame{};
 };
 
+//! Per frame camera data ring
+//! 
+//! Each slot is protected by a seqlock: the writer makes the sequence odd, updates the slot and makes it even again,
+//! readers copy the slot and retry if the sequence changed in the meantime. Readers (render and late warp threads)
+//! never take a lock or wait for the simulation thread, writers are serialized between themselves only.
 template <typename T>
 class ReflexCameraDataManager
 {
-    std::vector<std::pair<uint32_t, T>> cameraData;
-    std::mutex framesMutex;
-    uint32_t lastFrame = 0;
-    std::condition_variable getFrameCV;
+    static_assert(std::is_trivially_copyable_v<T>, "camera data must be trivially copyable to be read under a seqlock");
 
-public:
-    ReflexCameraDataManager()
+    //! Reader gives up after this many torn reads, writer only holds a slot for a copy of T so this is never hit in practice
+    static constexpr uint32_t kMaxReadRetries = 16;
+
+    struct Slot
     {
-        cameraData.resize(MAX_FRAMES_IN_FLIGHT);
-    }
+        std::atomic<uint32_t> sequence{};
+        std::atomic<uint32_t> frame{ UINT_MAX };
+        T data{};
+    };
+    Slot slots[MAX_FRAMES_IN_FLIGHT];
+    std::mutex writerMutex;
+    std::atomic<uint32_t> lastFrame{};
 
+public:
     void insertCameraData(const uint32_t frameID, const T& inCameraData)
     {
-        std::lock_guard<std::mutex> _(framesMutex);
         if (frameID <= 0)
         {
             return; // first frame data not used
         }
-        auto& availableCameraData = cameraData.at(frameID % MAX_FRAMES_IN_FLIGHT);
-        if (frameID == availableCameraData.first)
+        std::lock_guard<std::mutex> _(writerMutex);
+        auto& slot = slots[frameID % MAX_FRAMES_IN_FLIGHT];
+        if (frameID == slot.frame.load(std::memory_order_relaxed))
         {
             SL_LOG_WARN("Camera data for frame %d already set!", frameID);
             return;
         }
-        if (lastFrame + 1 != frameID)
+        auto last = lastFrame.load(std::memory_order_relaxed);
+        if (last + 1 != frameID)
         {
-            SL_LOG_WARN("Out of order camera data detected! last: %d, pushing: %d", lastFrame, frameID);
+            SL_LOG_WARN("Out of order camera data detected! last: %d, pushing: %d", last, frameID);
         }
-        availableCameraData = std::make_pair(frameID, inCameraData);
-        lastFrame = frameID;
-        getFrameCV.notify_one();
+
+        auto sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.frame.store(frameID, std::memory_order_relaxed);
+        memcpy(&slot.data, &inCameraData, sizeof(T));
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+
+        lastFrame.store(frameID, std::memory_order_release);
     }
 
-    std::optional<T> getCameraData(uint32_t frameID)
+    //! Non-blocking read, returns false if data for the frame was not published (yet)
+    bool tryGet(uint32_t frameID, T& outCameraData) const
     {
-        while (true)
+        auto& slot = slots[frameID % MAX_FRAMES_IN_FLIGHT];
+        for (uint32_t i = 0; i < kMaxReadRetries; i++)
         {
-            // Look for frame ID.
+            auto sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence & 1)
+            {
+                continue;
+            }
+            auto frame = slot.frame.load(std::memory_order_relaxed);
+            memcpy(&outCameraData, &slot.data, sizeof(T));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == sequence)
             {
-                std::lock_guard<std::mutex> _(framesMutex);
+                return frame == frameID;
+            }
+        }
+        return false;
+    }
 
-                auto& availableCameraData = cameraData.at(frameID % MAX_FRAMES_IN_FLIGHT);
-                if (frameID == availableCameraData.first)
-                {
-                    return availableCameraData.second;
-                }
+    //! Most recently published frame, 0 if none
+    uint32_t getLastFrame() const { return lastFrame.load(std::memory_order_acquire); }
+};
+
+//! Unit quaternion for the rotation part of a row major (row vector) matrix
+struct Quat
+{
+    float x, y, z, w;
+};
+
+inline Quat quatMul(const Quat& a, const Quat& b)
+{
+    return {
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+    };
+}
+
+inline Quat quatConjugate(const Quat& q)
+{
+    return { -q.x, -q.y, -q.z, q.w };
+}
+
+//! Rows 0-2 of 'm' are the rotated basis vectors, quaternion follows the column vector convention (R = transpose(m))
+inline Quat quatFromRotation(const float4x4& m)
+{
+    Quat q{};
+    float trace = m[0].x + m[1].y + m[2].z;
+    if (trace > 0.0f)
+    {
+        float s = sqrtf(trace + 1.0f) * 2.0f;
+        q = { (m[1].z - m[2].y) / s, (m[2].x - m[0].z) / s, (m[0].y - m[1].x) / s, 0.25f * s };
+    }
+    else if (m[0].x > m[1].y && m[0].x > m[2].z)
+    {
+        float s = sqrtf(1.0f + m[0].x - m[1].y - m[2].z) * 2.0f;
+        q = { 0.25f * s, (m[1].x + m[0].y) / s, (m[2].x + m[0].z) / s, (m[1].z - m[2].y) / s };
+    }
+    else if (m[1].y > m[2].z)
+    {
+        float s = sqrtf(1.0f + m[1].y - m[0].x - m[2].z) * 2.0f;
+        q = { (m[1].x + m[0].y) / s, 0.25f * s, (m[2].y + m[1].z) / s, (m[2].x - m[0].z) / s };
+    }
+    else
+    {
+        float s = sqrtf(1.0f + m[2].z - m[0].x - m[1].y) * 2.0f;
+        q = { (m[2].x + m[0].z) / s, (m[2].y + m[1].z) / s, 0.25f * s, (m[0].y - m[1].x) / s };
+    }
+    float len = sqrtf(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    return { q.x / len, q.y / len, q.z / len, q.w / len };
+}
+
+inline void quatToRotation(float4x4& m, const Quat& q)
+{
+    m[0] = float4(1.0f - 2.0f * (q.y * q.y + q.z * q.z), 2.0f * (q.x * q.y + q.z * q.w), 2.0f * (q.x * q.z - q.y * q.w), 0.0f);
+    m[1] = float4(2.0f * (q.x * q.y - q.z * q.w), 1.0f - 2.0f * (q.x * q.x + q.z * q.z), 2.0f * (q.y * q.z + q.x * q.w), 0.0f);
+    m[2] = float4(2.0f * (q.x * q.z + q.y * q.w), 2.0f * (q.y * q.z - q.x * q.w), 1.0f - 2.0f * (q.x * q.x + q.y * q.y), 0.0f);
+}
+
+//! Axis scaled by angle
+inline float3 quatToRotationVector(const Quat& q)
+{
+    // Shortest arc
+    float sign = q.w < 0.0f ? -1.0f : 1.0f;
+    float len = sqrtf(q.x * q.x + q.y * q.y + q.z * q.z);
+    float scale = len > 1e-6f ? 2.0f * atan2f(len, sign * q.w) / len : 2.0f;
+    return float3(sign * q.x * scale, sign * q.y * scale, sign * q.z * scale);
+}
+
+inline Quat quatFromRotationVector(const float3& v)
+{
+    float angle = sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
+    float scale = angle > 1e-6f ? sinf(0.5f * angle) / angle : 0.5f;
+    return { v.x * scale, v.y * scale, v.z * scale, cosf(0.5f * angle) };
+}
+
+//! Limits second order term to the magnitude of the first order one, noisy input should not make us overshoot
+inline float3 extrapolate(const float3& value, const float3& velocity, const float3& acceleration, float horizon)
+{
+    float3 first(velocity.x * horizon, velocity.y * horizon, velocity.z * horizon);
+    float3 second(0.5f * acceleration.x * horizon * horizon, 0.5f * acceleration.y * horizon * horizon, 0.5f * acceleration.z * horizon * horizon);
+    float firstLen = sqrtf(first.x * first.x + first.y * first.y + first.z * first.z);
+    float secondLen = sqrtf(second.x * second.x + second.y * second.y + second.z * second.z);
+    if (secondLen > firstLen)
+    {
+        float scale = firstLen / secondLen;
+        second = float3(second.x * scale, second.y * scale, second.z * scale);
+    }
+    return float3(value.x + first.x + second.x, value.y + first.y + second.y, value.z + first.z + second.z);
+}
+
+inline double getTimeMs()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//! Per viewport camera history and extrapolation
+//! 
+//! Translation and orientation are extrapolated to second order, velocity and acceleration are estimated
+//! from the last three samples using their actual frame times. Projection scale (FOV) is extrapolated to first order.
+class CameraPredictor
+{
+    struct Sample
+    {
+        uint32_t frame{};
+        double timeMs{};
+        float3 position{};
+        Quat orientation{};
+        float2 projectionScale{};
+    };
+
+    static constexpr uint32_t kHistorySize = 3;
+    //! Anything longer than this is a hitch or a pause, history is no longer representative
+    static constexpr double kMaxFrameTimeMs = 250.0;
+    //! Maximum relative change of the projection scale we extrapolate per frame
+    static constexpr float kMaxProjectionScaleChange = 0.1f;
+
+    Sample history[kHistorySize]{};
+    uint32_t count{};
+
+    const Sample& get(uint32_t age) const { return history[(count - 1 - age) % kHistorySize]; }
+
+public:
+    void predict(const ReflexCameraData& cameraData, uint32_t frame, double timeMs, ReflexPredictedCameraData& predictedCameraData)
+    {
+        float4x4 viewToWorld;
+        matrixOrthoNormalInvert(viewToWorld, cameraData.worldToViewMatrix);
+
+        // Mirrored (left handed) basis cannot be represented by a quaternion, flip forward axis and restore it later
+        float3 axisX(viewToWorld[0].x, viewToWorld[0].y, viewToWorld[0].z);
+        float3 axisY(viewToWorld[1].x, viewToWorld[1].y, viewToWorld[1].z);
+        float3 cross;
+        vectorCrossProduct(cross, axisX, axisY);
+        bool mirrored = cross.x * viewToWorld[2].x + cross.y * viewToWorld[2].y + cross.z * viewToWorld[2].z < 0.0f;
+        float4x4 rotation = viewToWorld;
+        if (mirrored)
+        {
+            rotation[2] = float4(-rotation[2].x, -rotation[2].y, -rotation[2].z, 0.0f);
+        }
+
+        Sample sample{};
+        sample.frame = frame;
+        sample.timeMs = timeMs;
+        sample.position = float3(viewToWorld[3].x, viewToWorld[3].y, viewToWorld[3].z);
+        sample.orientation = quatFromRotation(rotation);
+        sample.projectionScale = float2(cameraData.viewToClipMatrix[0].x, cameraData.viewToClipMatrix[1].y);
+
+        if (count)
+        {
+            auto& last = get(0);
+            auto frameTimeMs = timeMs - last.timeMs;
+            if (frame != last.frame + 1 || frameTimeMs <= 0.0 || frameTimeMs > kMaxFrameTimeMs)
+            {
+                count = 0;
             }
+            else if (last.orientation.x * sample.orientation.x + last.orientation.y * sample.orientation.y +
+                last.orientation.z * sample.orientation.z + last.orientation.w * sample.orientation.w < 0.0f)
+            {
+                // Keep consecutive samples in the same hemisphere
+                sample.orientation = { -sample.orientation.x, -sample.orientation.y, -sample.orientation.z, -sample.orientation.w };
+            }
+        }
+        history[count % kHistorySize] = sample;
+        count++;
 
-            // Wait for next frame.
-            SL_LOG_WARN("Camera data for frame %d was not readily available, this should not happen often!", frameID);
+        predictedCameraData.predictedWorldToViewMatrix = cameraData.worldToViewMatrix;
+        predictedCameraData.predictedViewToClipMatrix = cameraData.viewToClipMatrix;
+        if (count < 2)
+        {
+            return;
+        }
+
+        auto& s0 = get(0);
+        auto& s1 = get(1);
+        float dt0 = float(s0.timeMs - s1.timeMs);
+        float3 velocity((s0.position.x - s1.position.x) / dt0, (s0.position.y - s1.position.y) / dt0, (s0.position.z - s1.position.z) / dt0);
+        float3 angularVelocity = quatToRotationVector(quatMul(s0.orientation, quatConjugate(s1.orientation)));
+        angularVelocity = float3(angularVelocity.x / dt0, angularVelocity.y / dt0, angularVelocity.z / dt0);
+        float3 acceleration(0.0f, 0.0f, 0.0f);
+        float3 angularAcceleration(0.0f, 0.0f, 0.0f);
+        // Next frame is expected to take as long as the recent ones
+        float horizon = dt0;
+        if (count >= 3)
+        {
+            auto& s2 = get(2);
+            float dt1 = float(s1.timeMs - s2.timeMs);
+            float dt = 0.5f * (dt0 + dt1);
+            float3 prevVelocity((s1.position.x - s2.position.x) / dt1, (s1.position.y - s2.position.y) / dt1, (s1.position.z - s2.position.z) / dt1);
+            float3 prevAngularVelocity = quatToRotationVector(quatMul(s1.orientation, quatConjugate(s2.orientation)));
+            prevAngularVelocity = float3(prevAngularVelocity.x / dt1, prevAngularVelocity.y / dt1, prevAngularVelocity.z / dt1);
+            acceleration = float3((velocity.x - prevVelocity.x) / dt, (velocity.y - prevVelocity.y) / dt, (velocity.z - prevVelocity.z) / dt);
+            angularAcceleration = float3((angularVelocity.x - prevAngularVelocity.x) / dt, (angularVelocity.y - prevAngularVelocity.y) / dt, (angularVelocity.z - prevAngularVelocity.z) / dt);
+            // Finite differences give velocities in the middle of each interval, move them to the latest sample
+            velocity = float3(velocity.x + acceleration.x * 0.5f * dt0, velocity.y + acceleration.y * 0.5f * dt0, velocity.z + acceleration.z * 0.5f * dt0);
+            angularVelocity = float3(angularVelocity.x + angularAcceleration.x * 0.5f * dt0, angularVelocity.y + angularAcceleration.y * 0.5f * dt0, angularVelocity.z + angularAcceleration.z * 0.5f * dt0);
+            horizon = dt;
+        }
+
+        float3 position = extrapolate(s0.position, velocity, acceleration, horizon);
+        float3 deltaRotation = extrapolate(float3(0.0f, 0.0f, 0.0f), angularVelocity, angularAcceleration, horizon);
+        Quat orientation = quatMul(quatFromRotationVector(deltaRotation), s0.orientation);
+
+        float4x4 predictedViewToWorld;
+        quatToRotation(predictedViewToWorld, orientation);
+        if (mirrored)
+        {
+            predictedViewToWorld[2] = float4(-predictedViewToWorld[2].x, -predictedViewToWorld[2].y, -predictedViewToWorld[2].z, 0.0f);
+        }
+        predictedViewToWorld[3] = float4(position.x, position.y, position.z, 1.0f);
+        matrixOrthoNormalInvert(predictedCameraData.predictedWorldToViewMatrix, predictedViewToWorld);
+
+        // Zoom, extrapolate FOV only, depth range and jitter offsets are kept as is
+        auto extrapolateScale = [horizon, dt0](float current, float prev)->float
+        {
+            if (current == 0.0f || prev == 0.0f)
             {
-                std::unique_lock<std::mutex> lock(framesMutex);
+                return current;
+            }
+            float change = std::clamp((current - prev) / current * horizon / dt0, -kMaxProjectionScaleChange, kMaxProjectionScaleChange);
+            return current * (1.0f + change);
+        };
+        predictedCameraData.predictedViewToClipMatrix[0].x = extrapolateScale(s0.projectionScale.x, s1.projectionScale.x);
+        predictedCameraData.predictedViewToClipMatrix[1].y = extrapolateScale(s0.projectionScale.y, s1.projectionScale.y);
+    }
+};
 
-                // UE often doesn't send first few frames, make sure we don't block
-                // Depend on the engine, this also loosely define minimum support framerate, as 1/timeout
-                auto timeout = frameID < 5 ? 0ms : 100ms;
-                if (!getFrameCV.wait_for(lock, timeout, [&] { return frameID == cameraData.at(frameID % MAX_FRAMES_IN_FLIGHT).first; }))
+//! Latency reports collected by a background poller, deduplicated by frame id
+//! 
+//! The poller is the only writer, consumers get pointers straight into the ring. Report N lives at
+//! 'reports[N % kCapacity]' and stays valid until it is overwritten kCapacity reports later.
+class LatencyReportStream
+{
+    static constexpr uint32_t kCapacity = 4096;
+    static constexpr uint32_t kReportsPerPoll = sizeof(ReflexState::frameReport) / sizeof(ReflexReport);
+    //! Never hand out entries the next poll could overwrite
+    static constexpr uint32_t kGuard = kReportsPerPoll;
+
+    std::vector<ReflexReport> reports;
+    std::atomic<uint64_t> written{};
+    uint64_t lastFrameID{};
+
+    //! Guards 'thread', held across the join so start/stop/isRunning can be called from any thread
+    mutable std::mutex threadMtx;
+    std::thread thread;
+    std::mutex mtx;
+    std::condition_variable quitCV;
+    bool quit{};
+
+    void poll(chi::ICompute* compute, ReflexState& state)
+    {
+        if (compute->getLatencyReport(state) != chi::ComputeStatus::eOk)
+        {
+            return;
+        }
+        uint32_t order[kReportsPerPoll];
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < kReportsPerPoll; i++)
+        {
+            // New and complete reports only, in-flight frames are picked up by a later poll
+            if (state.frameReport[i].frameID > lastFrameID && state.frameReport[i].gpuRenderEndTime)
+            {
+                order[count++] = i;
+            }
+        }
+        std::sort(order, order + count, [&state](uint32_t a, uint32_t b)->bool { return state.frameReport[a].frameID < state.frameReport[b].frameID; });
+
+        auto index = written.load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            reports[index++ % kCapacity] = state.frameReport[order[i]];
+        }
+        if (count)
+        {
+            lastFrameID = state.frameReport[order[count - 1]].frameID;
+            written.store(index, std::memory_order_release);
+        }
+    }
+
+public:
+    uint32_t pollIntervalMs = 100;
+
+    bool isRunning() const
+    {
+        std::lock_guard<std::mutex> lock(threadMtx);
+        return thread.joinable();
+    }
+
+    void start(chi::ICompute* compute)
+    {
+        std::lock_guard<std::mutex> threadLock(threadMtx);
+        if (thread.joinable())
+        {
+            return;
+        }
+        reports.resize(kCapacity);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            quit = false;
+        }
+        thread = std::thread([this, compute]()->void
+        {
+            // Large, keep it off the stack
+            auto state = std::make_unique<ReflexState>();
+            std::unique_lock<std::mutex> lock(mtx);
+            while (!quitCV.wait_for(lock, std::chrono::milliseconds(pollIntervalMs), [this] { return quit; }))
+            {
+                lock.unlock();
+                poll(compute, *state);
+                lock.lock();
+            }
+        });
+#ifdef SL_WINDOWS
+        SetThreadDescription(thread.native_handle(), L"sl.reflex.latency");
+        sl::thread::setThreadPlacement(thread.native_handle(), sl::thread::ThreadPlacement::eEfficiency);
+#endif
+    }
+
+    void stop()
+    {
+        std::lock_guard<std::mutex> threadLock(threadMtx);
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            quit = true;
+        }
+        quitCV.notify_all();
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+
+    //! Returns the number of consecutive reports at 'outReports' starting from 'cursor' and advances the cursor
+    //! 
+    //! Call again until it returns 0 to drain reports split by the ring wrap around. Cursor jumps forward
+    //! if the consumer fell behind far enough for the reports to be overwritten.
+    uint32_t read(uint64_t& cursor, const ReflexReport*& outReports) const
+    {
+        auto end = written.load(std::memory_order_acquire);
+        if (end - std::min(cursor, end) > kCapacity - kGuard)
+        {
+            cursor = end - (kCapacity - kGuard);
+        }
+        cursor = std::min(cursor, end);
+        auto offset = uint32_t(cursor % kCapacity);
+        auto count = uint32_t(std::min<uint64_t>(end - cursor, kCapacity - offset));
+        outReports = count ? &reports[offset] : nullptr;
+        cursor += count;
+        return count;
+    }
+};
+
+//! Picks a frame limit which keeps the GPU just under saturation so the render queue does not build up
+//! 
+//! Driven by the latency report stream. If the GPU is the bottleneck the limit is set slightly above the measured
+//! GPU active time, if the CPU is the bottleneck the queue cannot build up and no limit is needed. New limits are
+//! only applied once they persist over a few evaluations and differ enough from the current one.
+class AdaptiveFrameLimiter
+{
+    static constexpr uint32_t kWindow = 64;
+    static constexpr float kTargetGPUUtilization = 0.95f;
+    static constexpr float kHysteresis = 0.05f;
+    static constexpr uint32_t kStableEvaluations = 3;
+    //! Never limit below 10 FPS
+    static constexpr uint32_t kMaxLimitUs = 100000;
+
+    uint64_t cursor{};
+    uint32_t gpuUs[kWindow]{};
+    uint32_t cpuUs[kWindow]{};
+    uint32_t count{};
+    uint32_t next{};
+    uint32_t candidateUs{};
+    uint32_t candidateEvaluations{};
+    uint32_t limitUs{};
+
+    static uint32_t percentile90(const uint32_t* values, uint32_t count)
+    {
+        uint32_t sorted[kWindow];
+        std::copy(values, values + count, sorted);
+        auto nth = sorted + count * 9 / 10;
+        std::nth_element(sorted, nth, sorted + count);
+        return *nth;
+    }
+
+    static bool isClose(uint32_t a, uint32_t b)
+    {
+        return (float)std::abs((int64_t)a - (int64_t)b) <= kHysteresis * (float)std::max(a, b);
+    }
+
+public:
+    uint32_t getLimitUs() const { return limitUs; }
+
+    void reset(uint32_t initialLimitUs)
+    {
+        count = next = 0;
+        candidateUs = candidateEvaluations = 0;
+        limitUs = initialLimitUs;
+    }
+
+    //! Consumes new reports, returns true if the limit changed
+    //! 
+    //! 'minLimitUs' is the host provided 'frameLimitUs', adaptive limit never allows a higher frame rate
+    bool update(const LatencyReportStream& stream, uint32_t minLimitUs)
+    {
+        const ReflexReport* reports{};
+        while (auto n = stream.read(cursor, reports))
+        {
+            for (uint32_t i = 0; i < n; i++)
+            {
+                auto& report = reports[i];
+                if (!report.gpuActiveRenderTimeUs)
                 {
-                    if (timeout > 0us)
-                    {
-                        SL_LOG_WARN("Time out trying to get data for frame %d (wait %dms)", frameID, std::chrono::duration_cast<std::chrono::milliseconds>(timeout).count());
-                    }
-                    return std::nullopt;
+                    continue;
                 }
+                auto stageUs = [](uint64_t start, uint64_t end)->uint64_t { return end > start ? end - start : 0; };
+                // Slowest CPU stage bounds the rate at which frames can be produced
+                auto cpu = std::max({ stageUs(report.simStartTime, report.simEndTime),
+                    stageUs(report.renderSubmitStartTime, report.renderSubmitEndTime),
+                    stageUs(report.presentStartTime, report.presentEndTime) });
+                gpuUs[next] = report.gpuActiveRenderTimeUs;
+                cpuUs[next] = (uint32_t)std::min<uint64_t>(cpu, UINT_MAX);
+                next = (next + 1) % kWindow;
+                count = std::min(count + 1, kWindow);
             }
         }
+        if (count < kWindow / 2)
+        {
+            return false;
+        }
+
+        auto gpu = percentile90(gpuUs, count);
+        auto cpu = percentile90(cpuUs, count);
+        auto gpuBoundUs = (uint32_t)((float)gpu / kTargetGPUUtilization);
+        uint32_t desiredUs = gpuBoundUs > cpu ? std::min(gpuBoundUs, kMaxLimitUs) : 0;
+        desiredUs = std::max(desiredUs, minLimitUs);
+
+        if (isClose(desiredUs, limitUs))
+        {
+            candidateEvaluations = 0;
+            return false;
+        }
+        if (candidateEvaluations && isClose(desiredUs, candidateUs))
+        {
+            candidateEvaluations++;
+        }
+        else
+        {
+            candidateUs = desiredUs;
+            candidateEvaluations = 1;
+        }
+        if (candidateEvaluations < kStableEvaluations)
+        {
+            return false;
+        }
+        limitUs = desiredUs;
+        candidateEvaluations = 0;
+        return true;
+    }
+};
+
+//! Schedules simulation start so frames are presented on an even cadence, see ReflexOptions::framePacing
+//! 
+//! Cadence comes from PCL present markers, the median present-to-present interval with the pacing delay
+//! we added taken out so the pacer never locks onto its own cadence. Under fixed refresh, when DXGI frame
+//! statistics are available, the cadence is rounded to whole refresh intervals and simulation start is
+//! phased so the present lands just ahead of the targeted vblank. Under VRR (or without statistics)
+//! frames are simply spaced by the median interval which removes short-long alternation on screen.
+//! 
+//! Present markers, present hook and 'pace' may run on different threads, all shared state is atomic.
+class FramePacer
+{
+    static constexpr uint32_t kHistory = 32;
+    static constexpr uint32_t kMinSamples = 8;
+    static constexpr uint32_t kFrameSlots = 8;
+    //! Present should be issued at least this long before the vblank it targets
+    static constexpr double kVblankMarginUs = 1000.0;
+    //! Nothing to pace below 10 FPS, also protects against stale statistics
+    static constexpr double kMaxIntervalUs = 100000.0;
+
+    struct FrameSlot
+    {
+        std::atomic<uint32_t> frame{ UINT_MAX };
+        std::atomic<int64_t> simStart{};
+        std::atomic<uint32_t> waitFrame{ UINT_MAX };
+        std::atomic<double> waitUs{};
+    };
+
+    std::atomic<double> presentIntervalUs[kHistory]{};
+    std::atomic<double> simToPresentUs[kHistory]{};
+    std::atomic<uint32_t> intervalCount{};
+    std::atomic<uint32_t> simToPresentCount{};
+    std::atomic<int64_t> lastPresent{};
+    FrameSlot slots[kFrameSlots]{};
+
+    //! From DXGI frame statistics, zero when not available (windowed, Vulkan, VRR without sync interval)
+    std::atomic<double> refreshUs{};
+    std::atomic<int64_t> vblank{};
+    std::atomic<uint32_t> syncInterval{};
+    //! Only touched by 'onPresent', 'reset' asks for it to be cleared
+    DXGI_FRAME_STATISTICS lastStats{};
+    std::atomic<bool> statsReset{};
+
+    //! Written by 'pace', cleared by 'reset' from the options thread
+    std::atomic<int64_t> lastStart{};
+    extra::PreciseTimer timer;
+    const double ticksPerUs = extra::PreciseTimer::ticksPerUs();
+    std::atomic<bool> enabled{};
+
+    static int64_t now()
+    {
+        LARGE_INTEGER qpc{};
+        QueryPerformanceCounter(&qpc);
+        return qpc.QuadPart;
+    }
+
+    static double percentile(const std::atomic<double>* values, uint32_t count, uint32_t percent)
+    {
+        double sorted[kHistory];
+        count = std::min(count, kHistory);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            sorted[i] = values[i].load(std::memory_order_relaxed);
+        }
+        auto nth = sorted + std::min(count * percent / 100, count - 1);
+        std::nth_element(sorted, nth, sorted + count);
+        return *nth;
+    }
+
+public:
+    //! Hooks and markers return right away unless enabled, cadence measured while disabled is stale so it is dropped
+    void setEnabled(bool value)
+    {
+        if (value && !enabled.load(std::memory_order_relaxed))
+        {
+            intervalCount.store(0);
+            simToPresentCount.store(0);
+            lastPresent.store(0);
+            refreshUs.store(0);
+            lastStart.store(0);
+            statsReset.store(true);
+        }
+        enabled.store(value, std::memory_order_release);
+    }
+
+    bool isEnabled() const { return enabled.load(std::memory_order_acquire); }
+
+    void onSimulationStart(uint32_t frame)
+    {
+        auto& slot = slots[frame % kFrameSlots];
+        slot.frame.store(UINT_MAX, std::memory_order_relaxed);
+        slot.simStart.store(now(), std::memory_order_relaxed);
+        slot.frame.store(frame, std::memory_order_release);
+    }
+
+    void onPresentStart(uint32_t frame)
+    {
+        auto time = now();
+        auto previous = lastPresent.exchange(time, std::memory_order_relaxed);
+        auto& slot = slots[frame % kFrameSlots];
+        if (previous)
+        {
+            // Remove the delay we inserted so the measured cadence reflects the frame cost only
+            auto waitUs = slot.waitFrame.load(std::memory_order_acquire) == frame ? slot.waitUs.load(std::memory_order_relaxed) : 0.0;
+            auto intervalUs = (double)(time - previous) / ticksPerUs - waitUs;
+            auto i = intervalCount.fetch_add(1, std::memory_order_relaxed);
+            presentIntervalUs[i % kHistory].store(std::max(intervalUs, 0.0), std::memory_order_relaxed);
+        }
+        if (slot.frame.load(std::memory_order_acquire) == frame)
+        {
+            auto i = simToPresentCount.fetch_add(1, std::memory_order_relaxed);
+            simToPresentUs[i % kHistory].store((double)(time - slot.simStart.load(std::memory_order_relaxed)) / ticksPerUs, std::memory_order_relaxed);
+        }
+    }
+
+    //! Called from the DXGI present hook, refresh interval and vblank phase come from the frame statistics
+    void onPresent(IDXGISwapChain* swapChain, UINT interval)
+    {
+        syncInterval.store(interval, std::memory_order_relaxed);
+        if (statsReset.exchange(false, std::memory_order_relaxed))
+        {
+            lastStats = {};
+        }
+        DXGI_FRAME_STATISTICS stats{};
+        if (FAILED(swapChain->GetFrameStatistics(&stats)) || !stats.SyncQPCTime.QuadPart)
+        {
+            // Disjoint or not available (windowed composition), pace on cadence only
+            refreshUs.store(0, std::memory_order_relaxed);
+            lastStats = {};
+            return;
+        }
+        if (lastStats.SyncRefreshCount && stats.SyncRefreshCount > lastStats.SyncRefreshCount)
+        {
+            auto us = (double)(stats.SyncQPCTime.QuadPart - lastStats.SyncQPCTime.QuadPart) / ticksPerUs / (double)(stats.SyncRefreshCount - lastStats.SyncRefreshCount);
+            refreshUs.store(us < kMaxIntervalUs ? us : 0, std::memory_order_relaxed);
+        }
+        vblank.store(stats.SyncQPCTime.QuadPart, std::memory_order_relaxed);
+        lastStats = stats;
+    }
+
+    //! Delays simulation start of the upcoming frame, called from slReflexSleep
+    void pace(uint32_t frame)
+    {
+        auto samples = intervalCount.load(std::memory_order_relaxed);
+        if (samples < kMinSamples)
+        {
+            return;
+        }
+        auto intervalUs = percentile(presentIntervalUs, samples, 50);
+        if (intervalUs <= 0 || intervalUs > kMaxIntervalUs)
+        {
+            return;
+        }
+
+        auto start = now();
+        auto previousStart = lastStart.load(std::memory_order_relaxed);
+        auto earliest = previousStart ? previousStart + (int64_t)(intervalUs * ticksPerUs) : start;
+        auto refresh = refreshUs.load(std::memory_order_relaxed);
+        auto sync = syncInterval.load(std::memory_order_relaxed);
+        if (refresh > 0 && sync > 0 && simToPresentCount.load(std::memory_order_relaxed) >= kMinSamples)
+        {
+            // Whole number of refreshes, tolerating measurement noise around an exact multiple
+            auto refreshes = std::max((double)sync, std::ceil(intervalUs / refresh - 0.1));
+            earliest = previousStart ? previousStart + (int64_t)(refreshes * refresh * ticksPerUs) : start;
+            // Start so the present lands right before the first vblank we can still make, slow frames included
+            auto leadTicks = (int64_t)((percentile(simToPresentUs, simToPresentCount.load(std::memory_order_relaxed), 90) + kVblankMarginUs) * ticksPerUs);
+            auto refreshTicks = (int64_t)(refresh * ticksPerUs);
+            auto phase = vblank.load(std::memory_order_relaxed);
+            // Half a refresh of slack so small changes in the lead do not push us to the next vblank
+            auto present = std::max(earliest - refreshTicks / 2, start) + leadTicks;
+            auto target = phase + (present > phase ? (present - phase + refreshTicks - 1) / refreshTicks : 0) * refreshTicks;
+            earliest = target - leadTicks;
+        }
+
+        // Running late, start right away and pick up the cadence from here
+        if (earliest <= start || earliest - start > (int64_t)(2 * kMaxIntervalUs * ticksPerUs))
+        {
+            lastStart.store(start, std::memory_order_relaxed);
+            return;
+        }
+        timer.waitUntil(earliest);
+        lastStart.store(earliest, std::memory_order_relaxed);
+        auto& slot = slots[frame % kFrameSlots];
+        slot.waitFrame.store(UINT_MAX, std::memory_order_relaxed);
+        slot.waitUs.store((double)(earliest - start) / ticksPerUs, std::memory_order_relaxed);
+        slot.waitFrame.store(frame, std::memory_order_release);
     }
 };
 
@@ -157,6 +821,10 @@ struct LatencyContext
 
     UIStats uiStats{};
 
+    //! Looked up on each present marker, registered once to avoid hashing and probing by key
+    param::ParameterHandle markerPresentFrameHandle{};
+    param::ParameterHandle currentFrameHandle{};
+
     // Engine type (Unity, UE etc)
     EngineType engine{};
 
@@ -168,10 +836,20 @@ struct LatencyContext
     //! Predicted camera data
     ReflexCameraDataManager<ReflexPredictedCameraData> predCameraData;
 
-    //! Matrices from the last frame
-    float4x4 prevWorldToViewMatrix{};
-    float4x4 prevViewToClipMatrix{};
+    //! Camera history per viewport, only accessed from the thread(s) setting camera data
+    std::mutex predictorMutex;
+    std::unordered_map<uint32_t, CameraPredictor> cameraPredictors;
+    //! Simulation start times from PCL markers, used to timestamp camera samples
+    struct MarkerTime
+    {
+        std::atomic<uint32_t> frame{ UINT_MAX };
+        std::atomic<double> timeMs{};
+    };
+    MarkerTime simulationStart[MAX_FRAMES_IN_FLIGHT]{};
     bool predictCamera = false;
+    //! Serve extrapolated data when the simulation thread has not published the requested frame yet,
+    //! can be overridden via sl.reflex.json config
+    bool cameraDataFallbackToPredicted = true;
 
 
     //! Can be overridden via sl.reflex.json config
@@ -187,6 +865,21 @@ struct LatencyContext
     bool flashIndicatorDriverControlled = false;
 
     extra::AverageValueMeter sleepMeter{};
+    //! Read from the UI thread, averages hide the occasional long sleep
+    extra::QuantileMeter sleepQuantiles{};
+
+    //! Started on first 'slReflexGetLatencyReports' call or when adaptive frame limit is enabled
+    LatencyReportStream latencyReports{};
+    AdaptiveFrameLimiter frameLimiter{};
+    //! Reports forwarded to the imgui performance panel (dev builds only)
+    uint64_t uiLatencyCursor{};
+    imgui::PerfSeries uiLatencySeries = imgui::kInvalidPerfSeries;
+    //! Evaluated on every Nth present marker
+    static constexpr uint32_t kFrameLimiterIntervalFrames = 30;
+    FramePacer framePacer{};
+    //! Frame limit enforced by slReflexSleep when the driver cannot sleep for us
+    extra::PreciseTimer fallbackLimiter;
+    int64_t fallbackLimiterStart{};
 
     //! Stats initialized or not
     std::atomic<bool> initialized = false;
@@ -265,18 +958,26 @@ void updateEmbeddedJSON(json& config)
 }
 
 //! Update stats shown on screen
+inline bool isAdaptiveFrameLimit(const ReflexOptions& options)
+{
+    return options.structVersion >= kStructVersion2 && options.adaptiveFrameLimit;
+}
+
+inline bool isFramePacing(const ReflexOptions& options)
+{
+    return options.structVersion >= kStructVersion3 && options.framePacing;
+}
+
 void updateStats(uint32_t presentFrameIndex)
 {
 #ifndef SL_PRODUCTION
     auto& ctx = (*reflex::getContext());
-    const std::string mode[ReflexMode_eCount] = { "Off", "On", "On + boost" };
-
-    std::scoped_lock lock(ctx.uiStats.mtx);
-    ctx.uiStats.mode = "Mode: " + mode[ctx.constants.mode];
-    ctx.uiStats.markers = extra::format("Optimize with markers: {}", (ctx.constants.useMarkersToOptimize ? "Yes" : "No"));
-    ctx.uiStats.fpsCap = extra::format("FPS cap: {}us", ctx.constants.frameLimitUs);
-    if(presentFrameIndex) ctx.uiStats.presentFrame = extra::format("Present marker frame: {}", presentFrameIndex);
-    ctx.uiStats.sleeping = extra::format("Sleeping: {}ms", ctx.sleepMeter.getMean());
+    ctx.uiStats.mode.store((uint32_t)ctx.constants.mode, std::memory_order_relaxed);
+    ctx.uiStats.useMarkersToOptimize.store(ctx.constants.useMarkersToOptimize, std::memory_order_relaxed);
+    bool adaptive = isAdaptiveFrameLimit(ctx.constants);
+    ctx.uiStats.frameLimitUs.store(adaptive ? ctx.frameLimiter.getLimitUs() : ctx.constants.frameLimitUs, std::memory_order_relaxed);
+    ctx.uiStats.adaptiveFrameLimit.store(adaptive, std::memory_order_relaxed);
+    if (presentFrameIndex) ctx.uiStats.presentFrame.store(presentFrameIndex, std::memory_order_relaxed);
 #endif
 }
 
@@ -313,14 +1014,47 @@ Result slSetData(const BaseStructure* inputs, CommandBuffer* cmdBuffer)
                     SL_LOG_WARN("Reflex sleep failed");
                 }
                 ctx.sleepMeter.end();
+                ctx.sleepQuantiles.add(ctx.sleepMeter.getValue());
 #endif
             }
+            else if (ctx.constants.frameLimitUs)
+            {
+                // Space simulation starts by the frame limit, a late frame restarts the cadence
+                auto limitTicks = (int64_t)(ctx.constants.frameLimitUs * extra::PreciseTimer::ticksPerUs());
+                auto now = extra::PreciseTimer::now();
+                auto target = ctx.fallbackLimiterStart + limitTicks;
+                if (ctx.fallbackLimiterStart && target > now && target - now <= limitTicks)
+                {
+                    ctx.fallbackLimiter.waitUntil(target);
+                }
+                else
+                {
+                    target = now;
+                }
+                ctx.fallbackLimiterStart = target;
+            }
+            // Driver sleep (if any) decides how late we can start, pacing then evens out the cadence
+            if (ctx.framePacer.isEnabled())
+            {
+                ctx.framePacer.pace(*frame);
+            }
         }
         else
         {
             // Made sure it's not special kReflexMarkerSleep value, so should be "safe" to cast to valid PCLMarker enum
             assert(evd_id < to_underlying(PCLMarker::eMaximum));
             const PCLMarker pcl_marker = (PCLMarker)evd_id;
+            if (pcl_marker == PCLMarker::eSimulationStart)
+            {
+                auto& simStart = ctx.simulationStart[*frame % MAX_FRAMES_IN_FLIGHT];
+                simStart.frame.store(UINT_MAX, std::memory_order_relaxed);
+                simStart.timeMs.store(reflex::getTimeMs(), std::memory_order_relaxed);
+                simStart.frame.store(*frame, std::memory_order_release);
+                if (ctx.framePacer.isEnabled())
+                {
+                    ctx.framePacer.onSimulationStart(*frame);
+                }
+            }
             if (ctx.lowLatencyAvailable && pcl_marker != PCLMarker::ePCLatencyPing
                 && (pcl_marker != PCLMarker::eTriggerFlash || ctx.flashIndicatorDriverControlled))
             {
@@ -334,7 +1068,23 @@ Result slSetData(const BaseStructure* inputs, CommandBuffer* cmdBuffer)
             {
                 // This frame-id assists present-time SL features like DLSS FG and LW to detect id of the frame 
                 // being currently processed on the present thread.
-                api::getContext()->parameters->set(sl::param::latency::kMarkerPresentFrame, *frame);
+                api::getContext()->parameters->setByHandle(ctx.markerPresentFrameHandle, (uint32_t)*frame);
+
+                if (ctx.framePacer.isEnabled())
+                {
+                    ctx.framePacer.onPresentStart(*frame);
+                }
+
+                if (ctx.lowLatencyAvailable && isAdaptiveFrameLimit(ctx.constants) && (*frame % reflex::LatencyContext::kFrameLimiterIntervalFrames) == 0)
+                {
+                    if (ctx.frameLimiter.update(ctx.latencyReports, ctx.constants.frameLimitUs))
+                    {
+                        auto options = ctx.constants;
+                        options.frameLimitUs = ctx.frameLimiter.getLimitUs();
+                        SL_LOG_VERBOSE("Adaptive frame limit %uus", options.frameLimitUs);
+                        CHI_VALIDATE(ctx.compute->setSleepMode(options));
+                    }
+                }
                 updateStats(*frame);
 
                 // Mark the last frame we were active
@@ -346,7 +1096,7 @@ Result slSetData(const BaseStructure* inputs, CommandBuffer* cmdBuffer)
                 {
                     uint32_t frame = 0;
                     CHI_VALIDATE(ctx.compute->getFinishedFrameIndex(frame));
-                    api::getContext()->parameters->set(sl::param::latency::kCurrentFrame, frame + 1);
+                    api::getContext()->parameters->setByHandle(ctx.currentFrameHandle, frame + 1);
                 }
             }
 
@@ -402,6 +1152,7 @@ Result slSetData(const BaseStructure* inputs, CommandBuffer* cmdBuffer)
         }
 
         {
+            ctx.framePacer.setEnabled(isFramePacing(*consts));
             ctx.constants = *consts;
             ctx.enabled.store(consts->mode != ReflexMode::eOff);
 #ifndef SL_PRODUCTION
@@ -417,7 +1168,14 @@ Result slSetData(const BaseStructure* inputs, CommandBuffer* cmdBuffer)
 #endif
             if (ctx.lowLatencyAvailable)
             {
-                CHI_VALIDATE(ctx.compute->setSleepMode(ctx.constants));
+                auto options = ctx.constants;
+                if (isAdaptiveFrameLimit(ctx.constants))
+                {
+                    // Host limit is the floor, start from it until the limiter has enough reports
+                    ctx.latencyReports.start(ctx.compute);
+                    ctx.frameLimiter.reset(ctx.constants.frameLimitUs);
+                }
+                CHI_VALIDATE(ctx.compute->setSleepMode(options));
             }
             updateStats(0);
         }
@@ -491,47 +1249,6 @@ internal::shared::Status getSharedData(BaseStructure* requestedData, const BaseS
     return internal::shared::Status::eOk;
 }
 
-sl::Result predictCameraData(const ReflexCameraData& cameraData, float4x4& prevWorldToView, float4x4& prevViewToClip, ReflexPredictedCameraData& predictedCameraData)
-{
-    float4x4 ViewToWorld, PrevViewToWorld;
-    matrixOrthoNormalInvert(ViewToWorld, cameraData.worldToViewMatrix);
-    matrixOrthoNormalInvert(PrevViewToWorld, prevWorldToView);
-
-    // 1st order prediction (simple constant velocity for now): 
-    const float4& currentTranslation = ViewToWorld.getRow(3);
-    float4 prevTranslation = PrevViewToWorld.getRow(3);
-    float4 predictedTranslation = float4(currentTranslation.x, currentTranslation.y, currentTranslation.z, 1);
-    predictedTranslation.x += currentTranslation.x - prevTranslation.x;
-    predictedTranslation.y += currentTranslation.y - prevTranslation.y;
-    predictedTranslation.z += currentTranslation.z - prevTranslation.z;
-
-    float4x4 currentRotation;
-    currentRotation[0].x = ViewToWorld[0].x; currentRotation[0].y = ViewToWorld[0].y; currentRotation[0].z = ViewToWorld[0].z; currentRotation[0].w = 0.f;
-    currentRotation[1].x = ViewToWorld[1].x; currentRotation[1].y = ViewToWorld[1].y; currentRotation[1].z = ViewToWorld[1].z; currentRotation[1].w = 0.f;
-    currentRotation[2].x = ViewToWorld[2].x; currentRotation[2].y = ViewToWorld[2].y; currentRotation[2].z = ViewToWorld[2].z; currentRotation[2].w = 0.f;
-    currentRotation[3].x = 0.f;              currentRotation[3].y = 0.f;              currentRotation[3].x = 0.f;              currentRotation[3].x = 1.f;
-
-    float4x4 inversePrevRotation;
-    inversePrevRotation[0].x = PrevViewToWorld[0].x; inversePrevRotation[0].y = PrevViewToWorld[1].x; inversePrevRotation[0].z = PrevViewToWorld[2].x; inversePrevRotation[0].w = 0.f;
-    inversePrevRotation[1].x = PrevViewToWorld[0].y; inversePrevRotation[1].y = PrevViewToWorld[1].y; inversePrevRotation[1].z = PrevViewToWorld[2].y; inversePrevRotation[1].w = 0.f;
-    inversePrevRotation[2].x = PrevViewToWorld[0].z; inversePrevRotation[2].y = PrevViewToWorld[1].z; inversePrevRotation[2].z = PrevViewToWorld[2].z; inversePrevRotation[2].w = 0.f;
-    inversePrevRotation[3].x = 0.f;                  inversePrevRotation[3].y = 0.f;                  inversePrevRotation[3].x = 0.f;                  inversePrevRotation[3].x = 1.f;
-
-    float4x4 deltaRotation;
-    matrixMul(deltaRotation, currentRotation, inversePrevRotation);
-
-    matrixMul(predictedCameraData.predictedWorldToViewMatrix, deltaRotation, currentRotation);
-    predictedCameraData.predictedWorldToViewMatrix[3].x = predictedTranslation.x;
-    predictedCameraData.predictedWorldToViewMatrix[3].y = predictedTranslation.y;
-    predictedCameraData.predictedWorldToViewMatrix[3].z = predictedTranslation.z;
-    predictedCameraData.predictedWorldToViewMatrix[3].w = 1.f;
-
-    // TODO: Predict viewtoclip
-    predictedCameraData.predictedViewToClipMatrix = cameraData.viewToClipMatrix;
-
-    return sl::Result::eOk;
-}
-
 sl::Result slReflexSetCameraData(const sl::ViewportHandle& viewport, const sl::FrameToken& frame, const sl::ReflexCameraData& inCameraData)
 {
     auto& ctx = (*reflex::getContext());
@@ -539,18 +1256,26 @@ sl::Result slReflexSetCameraData(const sl::ViewportHandle& viewport, const sl::F
     ctx.compute->setReflexMarker(PCLMarker::eCameraConstructed, frame);
     ctx.setStatsMarkerFunc(PCLMarker::eCameraConstructed, frame);
 
-    if (ctx.predictCamera && frame > 0)
+    if ((ctx.predictCamera || ctx.cameraDataFallbackToPredicted) && frame > 0)
     {
+        // Prefer simulation start from PCL markers, it is what the frame's camera was sampled for
+        double timeMs = reflex::getTimeMs();
+        auto& simStart = ctx.simulationStart[frame % MAX_FRAMES_IN_FLIGHT];
+        if (simStart.frame.load(std::memory_order_acquire) == frame)
+        {
+            timeMs = simStart.timeMs.load(std::memory_order_relaxed);
+        }
+
         ReflexPredictedCameraData predictedCameraData{};
-        predictCameraData(inCameraData, ctx.prevWorldToViewMatrix, ctx.prevViewToClipMatrix, predictedCameraData);
+        {
+            std::lock_guard<std::mutex> lock(ctx.predictorMutex);
+            ctx.cameraPredictors[viewport].predict(inCameraData, frame, timeMs, predictedCameraData);
+        }
         ctx.predCameraData.insertCameraData(frame, predictedCameraData);
     }
 
     ctx.simCameraData.insertCameraData(frame, inCameraData);
 
-    ctx.prevWorldToViewMatrix = inCameraData.worldToViewMatrix;
-    ctx.prevViewToClipMatrix = inCameraData.viewToClipMatrix;
-
     return sl::Result::eOk;
 }
 
@@ -558,15 +1283,32 @@ sl::Result slReflexGetCameraDataInternal(const sl::ViewportHandle& viewport, con
 {
     auto& ctx = (*reflex::getContext());
 
-    std::optional<ReflexCameraData> cameraData = ctx.simCameraData.getCameraData(frame);
-    if (!cameraData.has_value())
+    if (ctx.simCameraData.tryGet(frame, outCameraData))
     {
-        SL_LOG_WARN("Could not get camera data for frame %d", frame);
-        return Result::eErrorInvalidState;
+        return sl::Result::eOk;
     }
 
-    outCameraData = cameraData.value();
-    return sl::Result::eOk;
+    // Never wait for the simulation thread, extrapolate from the most recently published frame instead
+    auto lastFrame = ctx.simCameraData.getLastFrame();
+    ReflexCameraData lastCameraData{};
+    ReflexPredictedCameraData predictedCameraData{};
+    if (ctx.cameraDataFallbackToPredicted && lastFrame && lastFrame < frame &&
+        ctx.simCameraData.tryGet(lastFrame, lastCameraData) && ctx.predCameraData.tryGet(lastFrame, predictedCameraData))
+    {
+        SL_LOG_VERBOSE("Camera data for frame %d not available, using prediction from frame %d", frame, lastFrame);
+        outCameraData.worldToViewMatrix = predictedCameraData.predictedWorldToViewMatrix;
+        outCameraData.viewToClipMatrix = predictedCameraData.predictedViewToClipMatrix;
+        outCameraData.prevRenderedWorldToViewMatrix = lastCameraData.worldToViewMatrix;
+        outCameraData.prevRenderedViewToClipMatrix = lastCameraData.viewToClipMatrix;
+        return sl::Result::eOk;
+    }
+
+    // UE often doesn't send first few frames
+    if (frame >= 5)
+    {
+        SL_LOG_WARN("Could not get camera data for frame %d", frame);
+    }
+    return Result::eErrorInvalidState;
 }
 
 sl::Result slReflexSetCameraDataFenceInternal(const sl::ViewportHandle& viewport, sl::chi::Fence fence, const uint32_t syncValue, chi::ICommandListContext* cmdList)
@@ -583,14 +1325,11 @@ sl::Result slReflexGetPredictedCameraData(const sl::ViewportHandle& viewport, co
     auto& ctx = (*reflex::getContext());
     ctx.predictCamera = true;
 
-    std::optional<ReflexPredictedCameraData> cameraData = ctx.predCameraData.getCameraData(frame);
-    if (!cameraData.has_value())
+    if (!ctx.predCameraData.tryGet(frame, outCameraData))
     {
         SL_LOG_WARN("Could not get predicted camera data for frame %d", frame);
         return Result::eErrorInvalidState;
     }
-
-    outCameraData = cameraData.value();
     return sl::Result::eOk;
 }
 
@@ -664,6 +1403,20 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
         ctx.useMarkersToOptimizeOverride = true;
         SL_LOG_HINT("Read 'useMarkersToOptimize' %u from JSON config", ctx.useMarkersToOptimizeOverrideValue);
     }
+    if (extraConfig.contains("latencyReportPollMs"))
+    {
+        extraConfig.at("latencyReportPollMs").get_to(ctx.latencyReports.pollIntervalMs);
+        ctx.latencyReports.pollIntervalMs = std::max(1u, ctx.latencyReports.pollIntervalMs);
+        SL_LOG_HINT("Read 'latencyReportPollMs' %u from JSON config", ctx.latencyReports.pollIntervalMs);
+    }
+    if (extraConfig.contains("cameraDataFallbackToPredicted"))
+    {
+        extraConfig.at("cameraDataFallbackToPredicted").get_to(ctx.cameraDataFallbackToPredicted);
+        SL_LOG_HINT("Read 'cameraDataFallbackToPredicted' %u from JSON config", ctx.cameraDataFallbackToPredicted);
+    }
+
+    ctx.markerPresentFrameHandle = param::registerKey(parameters, param::latency::kMarkerPresentFrame);
+    ctx.currentFrameHandle = param::registerKey(parameters, param::latency::kCurrentFrame);
 
     updateStats(0);
     parameters->set(internal::shared::getParameterNameForFeature(kFeatureReflex).c_str(), (void*)getSharedData);
@@ -674,18 +1427,40 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
     param::getPointerParam(parameters, param::imgui::kInterface, &ui);
     if (ui)
     {
+        ctx.uiLatencySeries = ui->registerPerfSeries("Reflex PC latency");
+
         // Runs async from the present thread where UI is rendered just before frame is presented
         auto renderUI = [&ctx](imgui::ImGUI* ui, bool finalFrame)->void
         {
+            // Feed the performance panel, the stream is started here since hosts rarely ask for reports themselves
+            if (ctx.lowLatencyAvailable)
+            {
+                ctx.latencyReports.start(ctx.compute);
+                const ReflexReport* reports{};
+                while (auto n = ctx.latencyReports.read(ctx.uiLatencyCursor, reports))
+                {
+                    for (uint32_t i = 0; i < n; i++)
+                    {
+                        if (reports[i].gpuRenderEndTime > reports[i].simStartTime)
+                        {
+                            ui->addPerfSample(ctx.uiLatencySeries, (reports[i].gpuRenderEndTime - reports[i].simStartTime) / 1000.0f);
+                        }
+                    }
+                }
+            }
+
             auto v = api::getContext()->pluginVersion;
             if (ui->collapsingHeader(extra::format("sl.reflex v{}", (v.toStr() + "." + GIT_LAST_COMMIT_SHORT)).c_str(), imgui::kTreeNodeFlagDefaultOpen))
             {
-                std::scoped_lock lock(ctx.uiStats.mtx);
-                ui->text(ctx.uiStats.mode.c_str());
-                ui->text(ctx.uiStats.markers.c_str());
-                ui->text(ctx.uiStats.fpsCap.c_str());
-                ui->text(ctx.uiStats.presentFrame.c_str());
-                ui->text(ctx.uiStats.sleeping.c_str());
+                const char* mode[ReflexMode_eCount] = { "Off", "On", "On + boost" };
+                auto modeIndex = ctx.uiStats.mode.load(std::memory_order_relaxed);
+                ui->text("Mode: %s", modeIndex < ReflexMode_eCount ? mode[modeIndex] : "Unknown");
+                ui->text("Optimize with markers: %s", ctx.uiStats.useMarkersToOptimize.load(std::memory_order_relaxed) ? "Yes" : "No");
+                ui->text("FPS cap: %uus%s", ctx.uiStats.frameLimitUs.load(std::memory_order_relaxed), ctx.uiStats.adaptiveFrameLimit.load(std::memory_order_relaxed) ? " (adaptive)" : "");
+                ui->text("Present marker frame: %u", ctx.uiStats.presentFrame.load(std::memory_order_relaxed));
+                ui->text("Sleeping: %.2fms", ctx.sleepMeter.getMean());
+                auto sleep = ctx.sleepQuantiles.getQuantiles();
+                ui->text("Sleeping P50/P95/P99/max: %.2f/%.2f/%.2f/%.2fms", sleep.p50, sleep.p95, sleep.p99, sleep.max);
             }
         };
         ui->registerRenderCallbacks(renderUI, nullptr);
@@ -706,6 +1481,8 @@ void slOnPluginShutdown()
 {
     auto& ctx = (*reflex::getContext());
 
+    ctx.latencyReports.stop();
+
     // If we used 'evaluate' mechanism reset the callbacks here
     ctx.registerEvaluateCallbacks(kFeatureReflex, nullptr, nullptr);
 
@@ -735,6 +1512,40 @@ sl::Result slReflexSetMarker(sl::PCLMarker marker, const sl::FrameToken& frame)
     return slSetData(&inputs, nullptr);
 }
 
+sl::Result slReflexGetLatencyReports(uint64_t& cursor, const sl::ReflexReport*& reports, uint32_t& count)
+{
+    auto& ctx = (*reflex::getContext());
+    if (!ctx.compute || !ctx.lowLatencyAvailable)
+    {
+        reports = nullptr;
+        count = 0;
+        return Result::eErrorFeatureNotSupported;
+    }
+    if (!ctx.latencyReports.isRunning())
+    {
+        ctx.latencyReports.start(ctx.compute);
+    }
+    count = ctx.latencyReports.read(cursor, reports);
+    return Result::eOk;
+}
+
+//! Frame pacing needs the refresh interval and vblank phase of the swapchain being presented
+HRESULT slHookPresent(IDXGISwapChain* swapChain, UINT SyncInterval, UINT Flags, bool& Skip)
+{
+    auto& ctx = (*reflex::getContext());
+    if (!ctx.framePacer.isEnabled() || (Flags & DXGI_PRESENT_TEST))
+    {
+        return S_OK;
+    }
+    ctx.framePacer.onPresent(swapChain, SyncInterval);
+    return S_OK;
+}
+
+HRESULT slHookPresent1(IDXGISwapChain* swapChain, UINT SyncInterval, UINT Flags, const DXGI_PRESENT_PARAMETERS* pPresentParameters, bool& Skip)
+{
+    return slHookPresent(swapChain, SyncInterval, Flags, Skip);
+}
+
 sl::Result slReflexSleep(const sl::FrameToken& frame)
 {
     sl::ReflexHelper inputs(kReflexMarkerSleep);
@@ -760,10 +1571,15 @@ SL_EXPORT void* slGetPluginFunction(const char* functionName)
     SL_EXPORT_FUNCTION(slReflexGetState);
     SL_EXPORT_FUNCTION(slReflexSetMarker);
     SL_EXPORT_FUNCTION(slReflexSleep);
+
+    //! Hooks
+    SL_EXPORT_FUNCTION(slHookPresent);
+    SL_EXPORT_FUNCTION(slHookPresent1);
     SL_EXPORT_FUNCTION(slReflexSetOptions);
 
     SL_EXPORT_FUNCTION(slReflexSetCameraData);
     SL_EXPORT_FUNCTION(slReflexGetPredictedCameraData);
+    SL_EXPORT_FUNCTION(slReflexGetLatencyReports);
 
     return nullptr;
 }
@@ -21,7 +21,9 @@
 */
 
 #include <dxgi1_6.h>
+#include <algorithm>
 #include <future>
+#include <climits>
 
 #include "include/sl.h"
 #include "include/sl_consts.h"
@@ -36,6 +38,8 @@
 #include "external/json/include/nlohmann/json.hpp"
 #include "_artifacts/json/template_json.h"
 #include "_artifacts/gitVersion.h"
+#include "_artifacts/shaders/template_load_cs.h"
+#include "_artifacts/shaders/template_load_spv.h"
 
 using json = nlohmann::json;
 
@@ -48,6 +52,25 @@ namespace sl
 
 namespace tmpl
 {
+//! Benchmark mode, configured via the 'benchmark' object in `sl.template.json`
+//! 
+//! Turns the template into a controlled workload so SL framework overhead can be measured
+//! in isolation from any real feature (DLSS/NGX etc.)
+struct BenchmarkConfig
+{
+    bool enabled = false;
+    //! ALU iterations per pixel of the synthetic compute load, 0 disables the dispatch
+    uint32_t computeIterations = 64;
+    uint32_t dispatchWidth = 1920;
+    uint32_t dispatchHeight = 1080;
+    //! Tag and constant lookups performed on each evaluate to simulate plugin traffic
+    uint32_t tagLookupsPerEvaluate = 4;
+    uint32_t constantLookupsPerEvaluate = 1;
+    //! Report from the present hook rather than from evaluate
+    bool usePresentHook = false;
+    uint32_t reportIntervalFrames = 120;
+};
+
 //! Our common context
 //! 
 //! Here we can keep whatever global state we need
@@ -72,6 +95,8 @@ struct TemplateContext
     // 
     // See 'templateBeginEvaluation' below for more details
     sl::Constants* commonConsts;
+    // Camera matrices sl.common derived from the common constants, no need to invert anything here
+    const common::DerivedCameraData* derivedCamera{};
 
     // Feature constants (if any)
     //
@@ -91,6 +116,15 @@ struct TemplateContext
     // Compute API
     RenderAPI platform = RenderAPI::eD3D12;
     chi::ICompute* compute{};
+
+    // Benchmark mode state
+    BenchmarkConfig benchmark{};
+    common::FrameworkStats* frameworkStats{};
+    chi::Kernel loadKernel{};
+    chi::Resource loadOutput{};
+    float loadMs{};
+    uint32_t lastFrame = UINT_MAX;
+    uint32_t framesSinceReport{};
 };
 }
 
@@ -103,6 +137,99 @@ static std::string JSON = std::string(template_json, &template_json[template_jso
 //! Define our plugin, make sure to update version numbers in versions.h
 SL_PLUGIN_DEFINE("sl.template", Version(VERSION_MAJOR, VERSION_MINOR, VERSION_PATCH), Version(0, 0, 1), JSON.c_str(), updateEmbeddedJSON, tmpl, TemplateContext)
 
+namespace tmpl
+{
+//! Logs per frame SL framework overhead accumulated by sl.common since the last report
+void benchmarkReport(uint32_t frames)
+{
+    auto& ctx = (*tmpl::getContext());
+    auto& stats = *ctx.frameworkStats;
+
+    auto perFrame = [frames](std::atomic<uint64_t>& value)->double
+    {
+        return (double)value.exchange(0, std::memory_order_relaxed) / (double)frames;
+    };
+    auto setTagUs = perFrame(stats.setTagNs) / 1000.0;
+    auto setTagCalls = perFrame(stats.setTagCalls);
+    auto setConstantsUs = perFrame(stats.setConstantsNs) / 1000.0;
+    auto setConstantsCalls = perFrame(stats.setConstantsCalls);
+    auto evaluateUs = perFrame(stats.evaluateNs) / 1000.0;
+    auto evaluateCalls = perFrame(stats.evaluateCalls);
+    auto pluginUs = perFrame(stats.pluginNs) / 1000.0;
+    auto restoreUs = perFrame(stats.restorePipelineNs) / 1000.0;
+
+    // Everything SL does on the host's behalf excluding the work done by the feature itself
+    auto overheadUs = setTagUs + setConstantsUs + evaluateUs - pluginUs;
+    SL_LOG_INFO("benchmark (per frame over %u frames) - setTag %.2fus (%.1f calls), setConstants %.2fus (%.1f calls), evaluate %.2fus (%.1f calls), plugin %.2fus, restorePipeline %.2fus, framework overhead %.2fus, synthetic load %.3fms",
+        frames, setTagUs, setTagCalls, setConstantsUs, setConstantsCalls, evaluateUs, evaluateCalls, pluginUs, restoreUs, overheadUs, ctx.loadMs);
+}
+
+//! Counts unique frames and reports every 'reportIntervalFrames'
+void benchmarkFrame(uint32_t frame)
+{
+    auto& ctx = (*tmpl::getContext());
+    if (!ctx.frameworkStats || frame == ctx.lastFrame)
+    {
+        return;
+    }
+    ctx.lastFrame = frame;
+    if (++ctx.framesSinceReport >= ctx.benchmark.reportIntervalFrames)
+    {
+        benchmarkReport(ctx.framesSinceReport);
+        ctx.framesSinceReport = 0;
+    }
+}
+
+//! Simulates tag and constant traffic of a typical plugin, none of the tags are mandatory
+void benchmarkLookups(const common::EventData& evd, const sl::BaseStructure** inputs, uint32_t numInputs)
+{
+    auto& ctx = (*tmpl::getContext());
+    const BufferType tags[] = { kBufferTypeDepth, kBufferTypeMotionVectors, kBufferTypeShadowNoisy, kBufferTypeShadowDenoised };
+    for (uint32_t i = 0; i < ctx.benchmark.tagLookupsPerEvaluate; i++)
+    {
+        CommonResource res{};
+        getTaggedResource(tags[i % countof(tags)], res, evd.frame, evd.id, true, inputs, numInputs);
+    }
+    for (uint32_t i = 0; i < ctx.benchmark.constantLookupsPerEvaluate; i++)
+    {
+        common::getConsts(evd, &ctx.commonConsts);
+        ctx.constants.get(evd, &ctx.templateConsts);
+    }
+}
+
+//! Records the synthetic compute load into a plugin owned texture
+void benchmarkDispatch(chi::CommandList cmdList, uint32_t frame)
+{
+    auto& ctx = (*tmpl::getContext());
+    if (!ctx.benchmark.computeIterations)
+    {
+        return;
+    }
+
+    if (!ctx.loadOutput)
+    {
+        chi::ResourceDescription desc(ctx.benchmark.dispatchWidth, ctx.benchmark.dispatchHeight, chi::eFormatRGBA16F, chi::HeapType::eHeapTypeDefault, chi::ResourceState::eStorageRW, chi::ResourceFlags::eShaderResourceStorage);
+        CHI_VALIDATE(ctx.compute->createTexture2D(desc, ctx.loadOutput, "sl.template.load"));
+    }
+
+    struct LoadConsts
+    {
+        uint32_t size[2];
+        uint32_t iterations;
+        uint32_t frame;
+    };
+    LoadConsts cb{ { ctx.benchmark.dispatchWidth, ctx.benchmark.dispatchHeight }, ctx.benchmark.computeIterations, frame };
+
+    CHI_VALIDATE(ctx.compute->beginPerfSection(cmdList, "sl.template.load"));
+    CHI_VALIDATE(ctx.compute->bindSharedState(cmdList));
+    CHI_VALIDATE(ctx.compute->bindKernel(ctx.loadKernel));
+    CHI_VALIDATE(ctx.compute->bindRWTexture(0, 0, ctx.loadOutput));
+    CHI_VALIDATE(ctx.compute->bindConsts(1, 0, &cb, sizeof(cb), 3));
+    CHI_VALIDATE(ctx.compute->dispatch((ctx.benchmark.dispatchWidth + 16 - 1) / 16, (ctx.benchmark.dispatchHeight + 16 - 1) / 16, 1));
+    CHI_VALIDATE(ctx.compute->endPerfSection(cmdList, "sl.template.load", ctx.loadMs));
+}
+}
+
 //! Set constants for our plugin (if any, this is optional and should be thread safe)
 Result slSetConstants(const void* data, uint32_t frameIndex, uint32_t id)
 {
@@ -137,13 +264,21 @@ sl::Result templateBeginEvaluation(chi::CommandList pCmdList, const common::Even
 {
     auto& ctx = (*tmpl::getContext());
 
+    //! In benchmark mode we only simulate the lookups, nothing is mandatory
+    //! 
+    if (ctx.benchmark.enabled)
+    {
+        tmpl::benchmarkLookups(evd, inputs, numInputs);
+        return Result::eOk;
+    }
+
     //! Here we can go and fetch our constants based on the 'event data' - frame index, unique id etc.
     //! 
 
     // Get common constants if we need them
     //
     // Note that we are passing frame index, unique id provided with the 'evaluate' call
-    if (!common::getConsts(evd, &ctx.commonConsts))
+    if (!common::getConsts(evd, &ctx.commonConsts, &ctx.derivedCamera))
     {
         // Log error
         return sl::Result::eErrorMissingConstants;
@@ -197,6 +332,16 @@ sl::Result templateEndEvaluation(chi::CommandList cmdList, const common::EventDa
 
     auto& ctx = (*tmpl::getContext());
 
+    if (ctx.benchmark.enabled)
+    {
+        tmpl::benchmarkDispatch(cmdList, evd.frame);
+        if (!ctx.benchmark.usePresentHook)
+        {
+            tmpl::benchmarkFrame(evd.frame);
+        }
+        return Result::eOk;
+    }
+
     chi::ResourceState mvecState{}, depthState{}, outputState{}, inputState{};
 
     // Convert native to SL state
@@ -330,6 +475,22 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
     {
         //! Extract your configuration data and do something with it
     }
+    if (extraConfig.contains("benchmark"))
+    {
+        //! For example, benchmark mode turns this template into a synthetic workload
+        //! 
+        //! "benchmark": { "enabled": true, "computeIterations": 64, "dispatchWidth": 1920, "dispatchHeight": 1080,
+        //!                "tagLookupsPerEvaluate": 4, "constantLookupsPerEvaluate": 1, "usePresentHook": false, "reportIntervalFrames": 120 }
+        auto& benchmark = extraConfig["benchmark"];
+        ctx.benchmark.enabled = benchmark.value("enabled", ctx.benchmark.enabled);
+        ctx.benchmark.computeIterations = benchmark.value("computeIterations", ctx.benchmark.computeIterations);
+        ctx.benchmark.dispatchWidth = std::max(1u, benchmark.value("dispatchWidth", ctx.benchmark.dispatchWidth));
+        ctx.benchmark.dispatchHeight = std::max(1u, benchmark.value("dispatchHeight", ctx.benchmark.dispatchHeight));
+        ctx.benchmark.tagLookupsPerEvaluate = benchmark.value("tagLookupsPerEvaluate", ctx.benchmark.tagLookupsPerEvaluate);
+        ctx.benchmark.constantLookupsPerEvaluate = benchmark.value("constantLookupsPerEvaluate", ctx.benchmark.constantLookupsPerEvaluate);
+        ctx.benchmark.usePresentHook = benchmark.value("usePresentHook", ctx.benchmark.usePresentHook);
+        ctx.benchmark.reportIntervalFrames = std::max(1u, benchmark.value("reportIntervalFrames", ctx.benchmark.reportIntervalFrames));
+    }
 
     //! Now let's obtain compute interface if we need to dispatch some compute work
     //! 
@@ -357,6 +518,26 @@ bool slOnPluginStartup(const char* jsonConfig, void* device)
         // 
         //CHI_CHECK_RF(ctx.compute->createKernel((void*)myDenoisingKernel_cs, myDenoisingKernel_cs_len, "myDenoisingKernel.cs", "main", ctx.myDenoisingKernel));
     }
+
+    if (ctx.benchmark.enabled)
+    {
+        if (ctx.platform == RenderAPI::eVulkan)
+        {
+            CHI_CHECK_RF(ctx.compute->createKernel((void*)template_load_spv, template_load_spv_len, "template_load.cs", "main", ctx.loadKernel));
+        }
+        else
+        {
+            CHI_CHECK_RF(ctx.compute->createKernel((void*)template_load_cs, template_load_cs_len, "template_load.cs", "main", ctx.loadKernel));
+        }
+        ctx.compute->prewarmKernels(&ctx.loadKernel, 1);
+
+        //! sl.common only collects framework stats while somebody asks for them
+        if (param::getPointerParam(parameters, param::common::kFrameworkStats, &ctx.frameworkStats))
+        {
+            ctx.frameworkStats->enabled.store(true, std::memory_order_relaxed);
+        }
+        SL_LOG_INFO("benchmark mode enabled - %u iterations at %ux%u, reporting every %u frames", ctx.benchmark.computeIterations, ctx.benchmark.dispatchWidth, ctx.benchmark.dispatchHeight, ctx.benchmark.reportIntervalFrames);
+    }
     return true;
 }
 
@@ -371,6 +552,13 @@ void slOnPluginShutdown()
 
     // Here we need to release/destroy any resource we created
     CHI_VALIDATE(ctx.compute->destroyKernel(ctx.myDenoisingKernel));
+    CHI_VALIDATE(ctx.compute->destroyKernel(ctx.loadKernel));
+    CHI_VALIDATE(ctx.compute->destroyResource(ctx.loadOutput));
+    if (ctx.frameworkStats)
+    {
+        ctx.frameworkStats->enabled.store(false, std::memory_order_relaxed);
+        ctx.frameworkStats = {};
+    }
 
     // If we used 'evaluate' mechanism reset the callbacks here
     //
@@ -390,6 +578,12 @@ HRESULT slHookPresent(IDXGISwapChain* swapChain, UINT SyncInterval, UINT Flags,
     // This is just an example, if your plugin just needs to do something in `evaluate`
     // then no hooks are necessary.
     //
+    auto& ctx = (*tmpl::getContext());
+    if (ctx.benchmark.enabled && ctx.benchmark.usePresentHook)
+    {
+        // Present cadence is the frame boundary, no need to rely on frame indices provided via evaluate
+        tmpl::benchmarkFrame(ctx.lastFrame + 1);
+    }
     Skip = false;
     return S_OK;
 }
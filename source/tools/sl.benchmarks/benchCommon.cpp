@@ -0,0 +1,270 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+//! sl.common hot paths, per frame constants, resource tagging and the resource pool
+//!
+//! Compute is a regular 'chi' D3D12 instance on top of a WARP device so these run headless
+//! on any machine, none of the measured paths touch the GPU timeline.
+
+#include <d3d12.h>
+#include <dxgi1_6.h>
+#include <wrl/client.h>
+
+#include "include/sl.h"
+#include "include/sl_consts.h"
+#include "source/core/sl.api/internal.h"
+#include "source/core/sl.param/parameters.h"
+#include "source/platforms/sl.chi/compute.h"
+#include "source/plugins/sl.common/commonInterface.h"
+#include "source/plugins/sl.common/resourceTaggingForFrame.h"
+#include "source/tools/sl.benchmarks/benchmark.h"
+
+using Microsoft::WRL::ComPtr;
+
+namespace sl
+{
+
+// Plugin side glue normally provided by 'SL_PLUGIN_DEFINE' and sl.common, resource tagging only needs the parameters
+namespace api
+{
+static Context* s_ctx{};
+Context* getContext() { return s_ctx; }
+}
+
+bool slOnPluginLoad(sl::param::IParameters* params, const char* loaderJSON, const char** pluginJSON)
+{
+    if (!api::s_ctx)
+    {
+        api::s_ctx = new api::Context("sl.benchmarks", {}, {}, nullptr, params, nullptr, nullptr, nullptr);
+    }
+    return true;
+}
+
+namespace common
+{
+CommandBuffer* getNativeCommandBuffer(CommandBuffer* cmdBuffer, bool* slProxy)
+{
+    if (slProxy) *slProxy = false;
+    return cmdBuffer;
+}
+
+// Benchmarks only tag with 'eValidForFrames' which never clones
+sl::Result ResourceTaggingBase::makeVolatileCopy(chi::ICompute* compute, chi::IResourcePool* pool, chi::CommandList cmdList, const sl::Resource* resource,
+    BufferType tag, uint32_t id, const Extent* ext, bool requiredOnPresent, bool requiredOnEvaluate, CommonResource& res)
+{
+    return Result::eErrorInvalidState;
+}
+}
+
+namespace bench
+{
+
+struct ComputeFixture
+{
+    ComPtr<ID3D12Device> device;
+    chi::ICompute* compute{};
+    chi::IResourcePool* pool{};
+    chi::Resource texture{};
+
+    ComputeFixture()
+    {
+        ComPtr<IDXGIFactory4> factory;
+        ComPtr<IDXGIAdapter> adapter;
+        if (FAILED(CreateDXGIFactory2(0, IID_PPV_ARGS(&factory))) ||
+            FAILED(factory->EnumWarpAdapter(IID_PPV_ARGS(&adapter))) ||
+            FAILED(D3D12CreateDevice(adapter.Get(), D3D_FEATURE_LEVEL_12_0, IID_PPV_ARGS(&device))))
+        {
+            fprintf(stderr, "Error: failed to create WARP D3D12 device\n");
+            exit(1);
+        }
+        auto params = param::getInterface();
+        const char* pluginJSON{};
+        slOnPluginLoad(params, nullptr, &pluginJSON);
+        compute = chi::getD3D12();
+        if (compute->init(device.Get(), params) != chi::ComputeStatus::eOk ||
+            compute->createResourcePool(&pool, "sl.benchmarks") != chi::ComputeStatus::eOk)
+        {
+            fprintf(stderr, "Error: failed to initialize compute\n");
+            exit(1);
+        }
+        chi::ResourceDescription desc(1920, 1080, chi::eFormatRGBA16F);
+        compute->createTexture2D(desc, texture, "sl.bench.texture");
+    }
+};
+
+static ComputeFixture& getComputeFixture()
+{
+    // Intentionally leaked, process exit tears down the device
+    static ComputeFixture* s_fixture = new ComputeFixture();
+    return *s_fixture;
+}
+
+struct BenchConstants
+{
+    float4x4 cameraViewToClip;
+    float4x4 clipToCameraView;
+    float2 jitterOffset;
+    float2 mvecScale;
+    uint32_t reset;
+};
+
+SL_BENCHMARK(frameDataSetGet, "ViewportIdFrameData::set/get")
+{
+    static common::ViewportIdFrameData<> s_data("bench");
+    BenchConstants consts{};
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        auto frame = (uint32_t)i;
+        consts.reset = frame;
+        s_data.set(frame, 0, &consts);
+        BenchConstants* out{};
+        s_data.get({ 0, frame }, &out);
+        doNotOptimize(out);
+    }
+}
+
+SL_BENCHMARK(frameDataGet, "ViewportIdFrameData::get")
+{
+    static common::ViewportIdFrameData<> s_data("bench");
+    static BenchConstants s_consts{};
+    s_data.set(1, 0, &s_consts);
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        BenchConstants* out{};
+        s_data.get({ 0, 1 }, &out);
+        doNotOptimize(out);
+    }
+}
+
+SL_BENCHMARK(resourcePoolAllocateRecycle, "ResourcePool::allocate/recycle")
+{
+    auto& fixture = getComputeFixture();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        // Only the very first allocation creates a resource, afterwards this is the free list hit path
+        auto res = fixture.pool->allocate(fixture.texture, "sl.bench.clone");
+        fixture.pool->recycle(res);
+    }
+}
+
+SL_BENCHMARK(resourceTagSetGet, "ResourceTaggingForFrame::setTag/getTag")
+{
+    auto& fixture = getComputeFixture();
+    static common::ResourceTaggingForFrame s_tagging(fixture.compute, fixture.pool);
+    static FrameHandleImplementation s_frame;
+    static uint64_t s_frameIndex = 0;
+    auto params = param::getInterface();
+
+    sl::Resource resource(ResourceType::eTex2d, fixture.texture->native, 0);
+    Extent extent{ 0, 0, 1920, 1080 };
+    ResourceLifetimeInfo lifetime(1);
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        // New frame every few tags, matches a typical title tagging a handful of buffers per frame
+        if ((i & 3) == 0)
+        {
+            s_frame.counter = (uint32_t)++s_frameIndex;
+            params->set(param::latency::kMarkerPresentFrame, (uint32_t)s_frameIndex);
+        }
+        auto tag = kBufferTypeDepth + (BufferType)(i & 3);
+        s_tagging.setTag(&resource, tag, 0, &extent, ResourceLifecycle::eValidForFrames, nullptr, false, nullptr, &lifetime, s_frame);
+        CommonResource res{};
+        s_tagging.getTag(tag, s_frame, 0, res, nullptr, 0, true);
+        doNotOptimize(res);
+    }
+}
+
+//! Typical evaluate inputs, viewport handle and six local tags spread over two chains
+struct EvaluateInputs
+{
+    sl::Resource resource{ ResourceType::eTex2d, nullptr, 0 };
+    ViewportHandle viewport{ 0 };
+    ResourceTag tags[6] =
+    {
+        { &resource, kBufferTypeDepth, ResourceLifecycle::eValidUntilEvaluate },
+        { &resource, kBufferTypeMotionVectors, ResourceLifecycle::eValidUntilEvaluate },
+        { &resource, kBufferTypeScalingInputColor, ResourceLifecycle::eValidUntilEvaluate },
+        { &resource, kBufferTypeScalingOutputColor, ResourceLifecycle::eValidUntilEvaluate },
+        { &resource, kBufferTypeExposure, ResourceLifecycle::eValidUntilEvaluate },
+        { &resource, kBufferTypeBiasCurrentColorHint, ResourceLifecycle::eValidUntilEvaluate },
+    };
+    const BaseStructure* inputs[2]{};
+
+    EvaluateInputs()
+    {
+        viewport.next = &tags[0];
+        tags[0].next = &tags[1];
+        tags[1].next = &tags[2];
+        tags[3].next = &tags[4];
+        tags[4].next = &tags[5];
+        inputs[0] = &viewport;
+        inputs[1] = &tags[3];
+    }
+};
+
+//! Lookups done by sl.common and a plugin for one evaluate, viewport, batch, all tags and one tag per batch
+SL_BENCHMARK(findStructInputs, "findStruct (evaluate inputs)")
+{
+    static EvaluateInputs s_inputs;
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        doNotOptimize(findStruct<ViewportHandle>((const void**)s_inputs.inputs, 2));
+        doNotOptimize(findStruct<ViewportBatch>((const void**)s_inputs.inputs, 2));
+        ResourceTag* tags[8]{};
+        uint32_t count = 0;
+        for (uint32_t k = 0; k < 2; k++)
+        {
+            for (auto base = s_inputs.inputs[k]; base; base = base->next)
+            {
+                if (base->structType == ResourceTag::s_structType) tags[count++] = (ResourceTag*)base;
+            }
+        }
+        doNotOptimize(tags);
+        doNotOptimize(findStruct<ResourceTag>((const void**)s_inputs.inputs, 2));
+        doNotOptimize(findStruct<ViewportHandle>((const void**)s_inputs.inputs, 2));
+    }
+}
+
+SL_BENCHMARK(inputIndexInputs, "InputIndex::build/find (evaluate inputs)")
+{
+    static EvaluateInputs s_inputs;
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        common::InputIndex index{};
+        index.build(s_inputs.inputs, 2);
+        doNotOptimize(index.find<ViewportHandle>());
+        doNotOptimize(index.find<ViewportBatch>());
+        ResourceTag* tags[8]{};
+        uint32_t count = 0;
+        const uint64_t fingerprint = common::getStructTypeFingerprint(ResourceTag::s_structType);
+        for (uint32_t k = 0; k < index.count; k++)
+        {
+            if (index.fingerprints[k] == fingerprint && index.structs[k]->structType == ResourceTag::s_structType) tags[count++] = (ResourceTag*)index.structs[k];
+        }
+        doNotOptimize(tags);
+        doNotOptimize(index.find<ResourceTag>());
+        doNotOptimize(index.find<ViewportHandle>());
+    }
+}
+
+}
+}
@@ -0,0 +1,145 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+//! Core hot paths, parameters, thread contexts, worker threads and logging
+
+#include "include/sl.h"
+#include "source/core/sl.log/log.h"
+#include "source/core/sl.param/parameters.h"
+#include "source/core/sl.thread/thread.h"
+#include "source/tools/sl.benchmarks/benchmark.h"
+
+namespace sl
+{
+namespace bench
+{
+
+SL_BENCHMARK(paramsSetByKey, "Parameters::set (key)")
+{
+    auto params = param::getInterface();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        params->set(param::latency::kMarkerPresentFrame, (uint32_t)i);
+    }
+}
+
+SL_BENCHMARK(paramsGetByKey, "Parameters::get (key)")
+{
+    auto params = param::getInterface();
+    params->set(param::global::kSwapchainBufferCount, 3u);
+    uint32_t value{};
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        params->get(param::global::kSwapchainBufferCount, &value);
+        doNotOptimize(value);
+    }
+}
+
+SL_BENCHMARK(paramsGetMissing, "Parameters::get (missing key)")
+{
+    auto params = param::getInterface();
+    void* value{};
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        params->get("sl.param.bench.missing", &value);
+        doNotOptimize(value);
+    }
+}
+
+SL_BENCHMARK(paramsSetByHandle, "Parameters::set (handle)")
+{
+    auto params = param::getInterface();
+    static auto handle = param::registerKey(params, param::latency::kMarkerPresentFrame);
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        params->set(handle, (uint32_t)i);
+    }
+}
+
+SL_BENCHMARK(paramsGetByHandle, "Parameters::get (handle)")
+{
+    auto params = param::getInterface();
+    static auto handle = param::registerKey(params, param::global::kSwapchainBufferCount);
+    uint32_t value{};
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        params->get(handle, &value);
+        doNotOptimize(value);
+    }
+}
+
+struct BenchThreadData
+{
+    uint64_t counter{};
+};
+
+SL_BENCHMARK(threadContextGet, "ThreadContext::getContext")
+{
+    static thread::ThreadContext<BenchThreadData> s_context;
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        s_context.getContext().counter++;
+    }
+}
+
+SL_BENCHMARK(threadContextGetAlternating, "ThreadContext::getContext (two instances)")
+{
+    // Worst case for the per-thread cache, every call misses and takes the lock
+    static thread::ThreadContext<BenchThreadData> s_contexts[2];
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        s_contexts[i & 1].getContext().counter++;
+    }
+}
+
+SL_BENCHMARK(workerScheduleWork, "WorkerThread::scheduleWork")
+{
+    static thread::WorkerThread s_worker(L"sl.bench.worker", THREAD_PRIORITY_NORMAL);
+    static std::atomic<uint64_t> s_counter{};
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        s_worker.scheduleWork([]()->void { s_counter.fetch_add(1, std::memory_order_relaxed); });
+    }
+    // Include the drain so producer throughput cannot outrun the worker between runs
+    s_worker.flush(UINT_MAX);
+}
+
+SL_BENCHMARK(logFiltered, "Log::logva (filtered out)")
+{
+    auto log = log::getInterface();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        log->logva(2, log::WHITE, __FILE__, __LINE__, __func__, 0, false, "frame %llu", i);
+    }
+}
+
+SL_BENCHMARK(logEnabled, "Log::logva")
+{
+    auto log = log::getInterface();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        log->logva(1, log::WHITE, __FILE__, __LINE__, __func__, 0, false, "frame %llu", i);
+    }
+}
+
+}
+}
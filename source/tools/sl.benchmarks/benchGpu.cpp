@@ -0,0 +1,634 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+//! GPU cost of the chi kernels and copy paths SL passes are built from
+//!
+//! Every pass is recorded on its own command list, bracketed with 'beginPerfSection/endPerfSection'
+//! and submitted one frame at a time so passes never overlap. Samples are read back through
+//! 'getPerfSectionStats' as they resolve, exactly the timings the SL overlay shows in a title.
+
+#include <d3d12.h>
+#include <dxgi1_6.h>
+#include <wrl/client.h>
+
+#include <cstdio>
+#include <cmath>
+#include <functional>
+
+#include "include/sl.h"
+#include "include/sl_consts.h"
+#include "source/core/sl.param/parameters.h"
+#include "source/platforms/sl.chi/compute.h"
+#include "source/platforms/sl.chi/vulkan.h"
+#include "source/tools/sl.benchmarks/benchGpu.h"
+
+#include "_artifacts/shaders/mvec_cs.h"
+#include "_artifacts/shaders/mvec_spv.h"
+#include "_artifacts/shaders/copy_cs.h"
+#include "_artifacts/shaders/copy_spv.h"
+#include "_artifacts/shaders/copy_to_buffer_cs.h"
+#include "_artifacts/shaders/copy_to_buffer_spv.h"
+#include "_artifacts/shaders/copy_to_buffer_tiled_cs.h"
+#include "_artifacts/shaders/copy_to_buffer_tiled_spv.h"
+
+#include "source/plugins/sl.nis/NIS/NIS_Config.h"
+#include "source/plugins/sl.nis/NIS_shaders.h"
+
+using Microsoft::WRL::ComPtr;
+
+namespace sl
+{
+namespace bench
+{
+
+//! Same layout as the constants DLSS binds for 'mvec.hlsl'
+struct MVecConsts
+{
+    float4x4 clipToPrevClip;
+    float4 texSize;
+    float2 mvecScale;
+    uint32_t debug;
+    uint32_t padding;
+    float2 jitterDelta;
+};
+
+struct Kernels
+{
+    chi::Kernel mvec{};
+    chi::Kernel copy{};
+    chi::Kernel copyToBuffer{};
+    chi::Kernel copyToBufferTiled{};
+};
+
+struct NISPermutation
+{
+    const char* name;
+    NISHDRMode hdrMode;
+    bool scaler;
+    uint8_t* cs;
+    uint32_t csLen;
+    uint8_t* spv;
+    uint32_t spvLen;
+    chi::Kernel kernel;
+};
+
+//! Single viewport permutations, multi viewport ones only differ in constant indexing
+static NISPermutation s_nisPermutations[] =
+{
+    { "nis.sharpen.sdr", NISHDRMode::None, false, NIS_Sharpen_V0_H0_cs, NIS_Sharpen_V0_H0_cs_len, NIS_Sharpen_V0_H0_spv, NIS_Sharpen_V0_H0_spv_len },
+    { "nis.sharpen.linear", NISHDRMode::Linear, false, NIS_Sharpen_V0_H1_cs, NIS_Sharpen_V0_H1_cs_len, NIS_Sharpen_V0_H1_spv, NIS_Sharpen_V0_H1_spv_len },
+    { "nis.sharpen.pq", NISHDRMode::PQ, false, NIS_Sharpen_V0_H2_cs, NIS_Sharpen_V0_H2_cs_len, NIS_Sharpen_V0_H2_spv, NIS_Sharpen_V0_H2_spv_len },
+    { "nis.scaler.sdr", NISHDRMode::None, true, NIS_Scaler_V0_H0_cs, NIS_Scaler_V0_H0_cs_len, NIS_Scaler_V0_H0_spv, NIS_Scaler_V0_H0_spv_len },
+    { "nis.scaler.linear", NISHDRMode::Linear, true, NIS_Scaler_V0_H1_cs, NIS_Scaler_V0_H1_cs_len, NIS_Scaler_V0_H1_spv, NIS_Scaler_V0_H1_spv_len },
+    { "nis.scaler.pq", NISHDRMode::PQ, true, NIS_Scaler_V0_H2_cs, NIS_Scaler_V0_H2_cs_len, NIS_Scaler_V0_H2_spv, NIS_Scaler_V0_H2_spv_len },
+};
+
+//! Render targets for one resolution, inputs are kept in 'eTextureRead' and outputs in 'eStorageRW'
+struct Targets
+{
+    static constexpr uint32_t kTransitionCount = 8;
+    uint32_t width{};
+    uint32_t height{};
+    chi::Resource color{};
+    chi::Resource colorOut{};
+    chi::Resource colorLowRes{};
+    chi::Resource mvec{};
+    chi::Resource depth{};
+    chi::Resource mvecOut{};
+    chi::Resource buffer{};
+    chi::Resource copySrc{};
+    chi::Resource copyDst{};
+    chi::Resource transitions[kTransitionCount]{};
+};
+
+class GpuRunner
+{
+public:
+    GpuRunner(chi::ICompute* compute, const GpuSettings& settings, std::vector<Result>& results) : m_compute(compute), m_settings(settings), m_results(results) {}
+
+    bool init()
+    {
+        m_compute->getRenderAPI(m_api);
+        m_apiName = m_api == RenderAPI::eVulkan ? "vulkan" : "d3d12";
+        CHI_CHECK_RF(m_compute->createCommandQueue(chi::CommandQueueType::eGraphics, m_queue, "sl.bench.queue"));
+        CHI_CHECK_RF(m_compute->createCommandListContext(m_queue, 1, m_cmdList, "sl.bench.cmdlist"));
+
+        bool vk = m_api == RenderAPI::eVulkan;
+        CHI_CHECK_RF(m_compute->createKernel(vk ? (void*)mvec_spv : (void*)mvec_cs, vk ? mvec_spv_len : mvec_cs_len, "mvec.cs", "main", m_kernels.mvec));
+        CHI_CHECK_RF(m_compute->createKernel(vk ? (void*)copy_spv : (void*)copy_cs, vk ? copy_spv_len : copy_cs_len, "copy.cs", "main", m_kernels.copy));
+        CHI_CHECK_RF(m_compute->createKernel(vk ? (void*)copy_to_buffer_spv : (void*)copy_to_buffer_cs, vk ? copy_to_buffer_spv_len : copy_to_buffer_cs_len, "copy_to_buffer.cs", "main", m_kernels.copyToBuffer));
+        CHI_CHECK_RF(m_compute->createKernel(vk ? (void*)copy_to_buffer_tiled_spv : (void*)copy_to_buffer_tiled_cs, vk ? copy_to_buffer_tiled_spv_len : copy_to_buffer_tiled_cs_len, "copy_to_buffer_tiled.cs", "main", m_kernels.copyToBufferTiled));
+
+        // SPIR-V permutations are half precision, d3d12 uses the SM 5.0 full precision ones which run everywhere
+        chi::ShaderCaps caps{};
+        m_compute->getShaderCaps(caps);
+        m_nisSupported = !vk || caps.nativeFP16;
+        if (!m_nisSupported)
+        {
+            printf("Warning: device does not support native fp16, skipping NIS passes\n");
+        }
+        for (auto& permutation : s_nisPermutations)
+        {
+            if (!m_nisSupported) break;
+            CHI_CHECK_RF(m_compute->createKernel(vk ? (void*)permutation.spv : (void*)permutation.cs, vk ? permutation.spvLen : permutation.csLen, permutation.name, "main", permutation.kernel));
+        }
+
+        auto coefDesc = chi::ResourceDescription(kFilterSize / 4, kPhaseCount, chi::eFormatRGBA32F);
+        CHI_CHECK_RF(m_compute->createTexture2D(coefDesc, m_scalerCoef, "sl.bench.nisScalerCoef"));
+        CHI_CHECK_RF(m_compute->createTexture2D(coefDesc, m_usmCoef, "sl.bench.nisUSMCoef"));
+        const uint64_t rowPitch = kFilterSize * sizeof(float);
+        m_cmdList->beginCommandList();
+        CHI_CHECK_RF(m_compute->uploadToTexture(m_cmdList->getCmdList(), coef_scale, rowPitch * kPhaseCount, rowPitch, m_scalerCoef));
+        CHI_CHECK_RF(m_compute->uploadToTexture(m_cmdList->getCmdList(), coef_usm, rowPitch * kPhaseCount, rowPitch, m_usmCoef));
+        m_cmdList->executeCommandList();
+        m_cmdList->waitForCommandList(chi::FlushType::eCurrent);
+        return true;
+    }
+
+    void shutdown()
+    {
+        if (m_cmdList)
+        {
+            m_cmdList->flushAll();
+        }
+        m_compute->destroyKernel(m_kernels.mvec);
+        m_compute->destroyKernel(m_kernels.copy);
+        m_compute->destroyKernel(m_kernels.copyToBuffer);
+        m_compute->destroyKernel(m_kernels.copyToBufferTiled);
+        for (auto& permutation : s_nisPermutations)
+        {
+            if (permutation.kernel) m_compute->destroyKernel(permutation.kernel);
+        }
+        m_compute->destroyResource(m_scalerCoef, 0);
+        m_compute->destroyResource(m_usmCoef, 0);
+        if (m_cmdList) m_compute->destroyCommandListContext(m_cmdList);
+        if (m_queue) m_compute->destroyCommandQueue(m_queue);
+        m_cmdList = {};
+        m_queue = {};
+    }
+
+    bool run()
+    {
+        for (auto [width, height] : m_settings.resolutions)
+        {
+            Targets targets{};
+            if (!createTargets(width, height, targets))
+            {
+                destroyTargets(targets);
+                return false;
+            }
+            runPasses(targets);
+            destroyTargets(targets);
+        }
+        return true;
+    }
+
+private:
+
+    using RecordFunc = std::function<void(chi::CommandList)>;
+
+    chi::ICompute* m_compute{};
+    const GpuSettings& m_settings;
+    std::vector<Result>& m_results;
+    RenderAPI m_api{};
+    const char* m_apiName{};
+    chi::ChiCommandQueue* m_queue{};
+    chi::ICommandListContext* m_cmdList{};
+    Kernels m_kernels{};
+    bool m_nisSupported{};
+    chi::Resource m_scalerCoef{};
+    chi::Resource m_usmCoef{};
+
+    std::string getName(const char* pass, const Targets& targets) const
+    {
+        return std::string(m_apiName) + "/" + pass + "/" + std::to_string(targets.width) + "x" + std::to_string(targets.height);
+    }
+
+    bool isEnabled(const std::string& name) const
+    {
+        return m_settings.filter.empty() || name.find(m_settings.filter) != std::string::npos;
+    }
+
+    //! Records 'record' inside a perf section once per frame until 'frames' samples have resolved
+    void measure(const std::string& name, const RecordFunc& record)
+    {
+        if (!isEnabled(name)) return;
+
+        std::vector<double> samples;
+        samples.reserve(m_settings.frames);
+        uint64_t lastCount = 0;
+        // Timestamps resolve a few frames late, bail out if they never show up
+        const uint32_t maxFrames = m_settings.warmup + m_settings.frames * 2 + 16;
+        for (uint32_t frame = 0; frame < maxFrames && samples.size() < m_settings.frames; frame++)
+        {
+            m_cmdList->beginCommandList();
+            auto cmdList = m_cmdList->getCmdList();
+            CHI_VALIDATE(m_compute->bindSharedState(cmdList));
+            // Everything recorded during warmup is discarded, including samples still in flight
+            CHI_VALIDATE(m_compute->beginPerfSection(cmdList, name.c_str(), 0, frame == m_settings.warmup));
+            record(cmdList);
+            float avgMS{};
+            CHI_VALIDATE(m_compute->endPerfSection(cmdList, name.c_str(), avgMS));
+            m_cmdList->executeCommandList();
+            m_cmdList->waitForCommandList(chi::FlushType::eCurrent);
+
+            chi::PerfSectionStats stats{};
+            if (frame >= m_settings.warmup && m_compute->getPerfSectionStats(name.c_str(), stats) == chi::ComputeStatus::eOk && stats.numSamples > lastCount)
+            {
+                lastCount = stats.numSamples;
+                samples.push_back(stats.lastMS * 1e6);
+            }
+        }
+        addResult(name, samples);
+    }
+
+    void addResult(const std::string& name, std::vector<double>& samples)
+    {
+        if (samples.empty())
+        {
+            printf("Warning: no GPU samples resolved for '%s'\n", name.c_str());
+            return;
+        }
+        std::sort(samples.begin(), samples.end());
+        Result result{};
+        result.name = name;
+        result.iterations = samples.size();
+        result.minNs = samples.front();
+        result.medianNs = samples[samples.size() / 2];
+        result.maxNs = samples.back();
+        m_results.push_back(std::move(result));
+    }
+
+    bool createTargets(uint32_t width, uint32_t height, Targets& targets)
+    {
+        using namespace chi;
+        targets.width = width;
+        targets.height = height;
+        auto read = ResourceState::eTextureRead;
+        auto rw = ResourceState::eStorageRW;
+        // Roughly the NIS/DLSS quality mode ratio
+        uint32_t lowResWidth = width * 2 / 3;
+        uint32_t lowResHeight = height * 2 / 3;
+        CHI_CHECK_RF(m_compute->createTexture2D(ResourceDescription(width, height, eFormatRGBA16F, eHeapTypeDefault, read), targets.color, "sl.bench.color"));
+        CHI_CHECK_RF(m_compute->createTexture2D(ResourceDescription(width, height, eFormatRGBA16F, eHeapTypeDefault, rw), targets.colorOut, "sl.bench.colorOut"));
+        CHI_CHECK_RF(m_compute->createTexture2D(ResourceDescription(lowResWidth, lowResHeight, eFormatRGBA16F, eHeapTypeDefault, read), targets.colorLowRes, "sl.bench.colorLowRes"));
+        CHI_CHECK_RF(m_compute->createTexture2D(ResourceDescription(width, height, eFormatRG16F, eHeapTypeDefault, read), targets.mvec, "sl.bench.mvec"));
+        CHI_CHECK_RF(m_compute->createTexture2D(ResourceDescription(width, height, eFormatR32F, eHeapTypeDefault, read), targets.depth, "sl.bench.depth"));
+        CHI_CHECK_RF(m_compute->createTexture2D(ResourceDescription(width, height, eFormatRG16F, eHeapTypeDefault, rw), targets.mvecOut, "sl.bench.mvecOut"));
+        CHI_CHECK_RF(m_compute->createTexture2D(ResourceDescription(width, height, eFormatRGBA16F, eHeapTypeDefault, ResourceState::eCopySource), targets.copySrc, "sl.bench.copySrc"));
+        CHI_CHECK_RF(m_compute->createTexture2D(ResourceDescription(width, height, eFormatRGBA16F, eHeapTypeDefault, ResourceState::eCopyDestination), targets.copyDst, "sl.bench.copyDst"));
+        for (auto& texture : targets.transitions)
+        {
+            CHI_CHECK_RF(m_compute->createTexture2D(ResourceDescription(width, height, eFormatRGBA8UN, eHeapTypeDefault, read), texture, "sl.bench.transition"));
+        }
+        // RGB32F, see 'copy_to_buffer.hlsl'
+        ResourceDescription bufferDesc(width * height * 12, 1, eFormatINVALID, eHeapTypeDefault, rw, ResourceFlags::eRawOrStructuredBuffer | ResourceFlags::eShaderResourceStorage);
+        CHI_CHECK_RF(m_compute->createBuffer(bufferDesc, targets.buffer, "sl.bench.buffer"));
+        return true;
+    }
+
+    void destroyTargets(Targets& targets)
+    {
+        m_cmdList->flushAll();
+        chi::Resource* resources[] = { &targets.color, &targets.colorOut, &targets.colorLowRes, &targets.mvec, &targets.depth,
+            &targets.mvecOut, &targets.buffer, &targets.copySrc, &targets.copyDst };
+        for (auto res : resources)
+        {
+            if (*res) m_compute->destroyResource(*res, 0);
+            *res = {};
+        }
+        for (auto& texture : targets.transitions)
+        {
+            if (texture) m_compute->destroyResource(texture, 0);
+            texture = {};
+        }
+    }
+
+    void runPasses(Targets& targets)
+    {
+        const uint32_t w = targets.width;
+        const uint32_t h = targets.height;
+        const uint32_t groupsX = (w + 15) / 16;
+        const uint32_t groupsY = (h + 15) / 16;
+        // Constants live in a ring, one instance per frame in flight is plenty since frames are serialized
+        const uint32_t kConstInstances = 4;
+
+        measure(getName("mvec.hlsl", targets), [&](chi::CommandList)
+        {
+            MVecConsts cb{};
+            cb.clipToPrevClip.setRow(0, { 1, 0, 0, 0 });
+            cb.clipToPrevClip.setRow(1, { 0, 1, 0, 0 });
+            cb.clipToPrevClip.setRow(2, { 0, 0, 1, 0 });
+            cb.clipToPrevClip.setRow(3, { 0, 0, 0, 1 });
+            cb.texSize = { (float)w, (float)h, 1.0f / w, 1.0f / h };
+            cb.mvecScale = { 1.0f / w, 1.0f / h };
+            CHI_VALIDATE(m_compute->bindKernel(m_kernels.mvec));
+            CHI_VALIDATE(m_compute->bindTexture(0, 0, targets.mvec));
+            CHI_VALIDATE(m_compute->bindTexture(1, 1, targets.depth));
+            CHI_VALIDATE(m_compute->bindRWTexture(2, 0, targets.mvecOut));
+            CHI_VALIDATE(m_compute->bindConsts(3, 0, &cb, sizeof(cb), kConstInstances));
+            CHI_VALIDATE(m_compute->dispatch(groupsX, groupsY, 1));
+        });
+
+        float4 sizeAndInvSize = { (float)w, (float)h, 1.0f / w, 1.0f / h };
+        measure(getName("copy.hlsl", targets), [&](chi::CommandList)
+        {
+            CHI_VALIDATE(m_compute->bindKernel(m_kernels.copy));
+            CHI_VALIDATE(m_compute->bindConsts(0, 0, &sizeAndInvSize, sizeof(sizeAndInvSize), kConstInstances));
+            CHI_VALIDATE(m_compute->bindTexture(1, 0, targets.color));
+            CHI_VALIDATE(m_compute->bindRWTexture(2, 0, targets.colorOut));
+            CHI_VALIDATE(m_compute->dispatch(groupsX, groupsY, 1));
+        });
+
+        measure(getName("copy_to_buffer.hlsl", targets), [&](chi::CommandList)
+        {
+            CHI_VALIDATE(m_compute->bindKernel(m_kernels.copyToBuffer));
+            CHI_VALIDATE(m_compute->bindConsts(0, 0, &sizeAndInvSize, sizeof(sizeAndInvSize), kConstInstances));
+            CHI_VALIDATE(m_compute->bindTexture(1, 0, targets.color));
+            CHI_VALIDATE(m_compute->bindRawBuffer(2, 0, targets.buffer));
+            CHI_VALIDATE(m_compute->dispatch(groupsX, groupsY, 1));
+        });
+
+        // Same output as above, tile goes through groupshared memory so rows are written with coalesced 16 byte stores
+        measure(getName("copy_to_buffer_tiled.hlsl", targets), [&](chi::CommandList)
+        {
+            CHI_VALIDATE(m_compute->bindKernel(m_kernels.copyToBufferTiled));
+            CHI_VALIDATE(m_compute->bindConsts(0, 0, &sizeAndInvSize, sizeof(sizeAndInvSize), kConstInstances));
+            CHI_VALIDATE(m_compute->bindTexture(1, 0, targets.color));
+            CHI_VALIDATE(m_compute->bindRawBuffer(2, 0, targets.buffer));
+            CHI_VALIDATE(m_compute->dispatch(groupsX, groupsY, 1));
+        });
+
+        // Vulkan has no native UAV clear, this goes through the 'vulkan_clear_image_view' kernel
+        measure(getName("clearView", targets), [&](chi::CommandList cmdList)
+        {
+            chi::CLEAR_TYPE clearType{};
+            CHI_VALIDATE(m_compute->clearView(cmdList, targets.colorOut, { 0, 0, 0, 0 }, nullptr, 0, clearType));
+        });
+
+        if (m_nisSupported)
+        {
+            for (auto& permutation : s_nisPermutations)
+            {
+                auto input = permutation.scaler ? targets.colorLowRes : targets.color;
+                chi::ResourceDescription inDesc{};
+                m_compute->getResourceDescription(input, inDesc);
+                NISConfig config{};
+                bool valid = permutation.scaler ?
+                    NVScalerUpdateConfig(config, 0.5f, 0, 0, inDesc.width, inDesc.height, inDesc.width, inDesc.height, 0, 0, w, h, w, h, permutation.hdrMode) :
+                    NVSharpenUpdateConfig(config, 0.5f, 0, 0, w, h, w, h, 0, 0, permutation.hdrMode);
+                if (!valid) continue;
+                // Same block sizes the NIS plugin dispatches these permutations with
+                const uint32_t blockWidth = 32;
+                const uint32_t blockHeight = permutation.scaler && m_api != RenderAPI::eVulkan ? 24 : 32;
+                measure(getName(permutation.name, targets), [&](chi::CommandList)
+                {
+                    CHI_VALIDATE(m_compute->bindKernel(permutation.kernel));
+                    CHI_VALIDATE(m_compute->bindConsts(0, 0, &config, sizeof(config), kConstInstances));
+                    CHI_VALIDATE(m_compute->bindSampler(1, 0, chi::eSamplerLinearClamp));
+                    CHI_VALIDATE(m_compute->bindTexture(2, 0, input));
+                    CHI_VALIDATE(m_compute->bindRWTexture(3, 0, targets.colorOut));
+                    if (permutation.scaler)
+                    {
+                        CHI_VALIDATE(m_compute->bindTexture(4, 1, m_scalerCoef));
+                        CHI_VALIDATE(m_compute->bindTexture(5, 2, m_usmCoef));
+                    }
+                    CHI_VALIDATE(m_compute->dispatch((w + blockWidth - 1) / blockWidth, (h + blockHeight - 1) / blockHeight, 1));
+                });
+            }
+        }
+
+        measure(getName("copyResource", targets), [&](chi::CommandList cmdList)
+        {
+            CHI_VALIDATE(m_compute->copyResource(cmdList, targets.copyDst, targets.copySrc));
+        });
+
+        // Round trip so every frame starts from the same states
+        measure(getName("transitionResources", targets), [&](chi::CommandList cmdList)
+        {
+            chi::ResourceTransition toRW[Targets::kTransitionCount];
+            chi::ResourceTransition toRead[Targets::kTransitionCount];
+            for (uint32_t i = 0; i < Targets::kTransitionCount; i++)
+            {
+                toRW[i] = { targets.transitions[i], chi::ResourceState::eStorageRW, chi::ResourceState::eTextureRead };
+                toRead[i] = { targets.transitions[i], chi::ResourceState::eTextureRead, chi::ResourceState::eStorageRW };
+            }
+            CHI_VALIDATE(m_compute->transitionResources(cmdList, toRW, Targets::kTransitionCount));
+            CHI_VALIDATE(m_compute->transitionResources(cmdList, toRead, Targets::kTransitionCount));
+        });
+
+        // Resource creation never shows up on the GPU timeline, report the CPU cost instead
+        auto cloneName = getName("cloneResource (cpu)", targets);
+        if (isEnabled(cloneName))
+        {
+            std::vector<double> samples;
+            for (uint32_t i = 0; i < m_settings.frames; i++)
+            {
+                chi::Resource clone{};
+                auto start = std::chrono::steady_clock::now();
+                CHI_VALIDATE(m_compute->cloneResource(targets.color, clone, "sl.bench.clone"));
+                auto end = std::chrono::steady_clock::now();
+                samples.push_back((double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+                m_compute->destroyResource(clone, 0);
+            }
+            addResult(cloneName, samples);
+        }
+    }
+};
+
+//! Instance and device with a single graphics+compute family, 'VkTable' plays the role of the interposer
+struct VulkanDevice
+{
+    VkInstance instance{};
+    VkPhysicalDevice physicalDevice{};
+    VkDevice device{};
+    interposer::VkTable table{};
+
+    bool create()
+    {
+        VkApplicationInfo appInfo{ VK_STRUCTURE_TYPE_APPLICATION_INFO };
+        appInfo.pApplicationName = "sl.benchmarks";
+        appInfo.apiVersion = VK_API_VERSION_1_3;
+        VkInstanceCreateInfo instanceInfo{ VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO };
+        instanceInfo.pApplicationInfo = &appInfo;
+        if (vkCreateInstance(&instanceInfo, nullptr, &instance) != VK_SUCCESS)
+        {
+            fprintf(stderr, "Error: failed to create Vulkan instance\n");
+            return false;
+        }
+
+        uint32_t count = 0;
+        vkEnumeratePhysicalDevices(instance, &count, nullptr);
+        std::vector<VkPhysicalDevice> devices(count);
+        vkEnumeratePhysicalDevices(instance, &count, devices.data());
+        for (auto candidate : devices)
+        {
+            VkPhysicalDeviceProperties props{};
+            vkGetPhysicalDeviceProperties(candidate, &props);
+            if (!physicalDevice || props.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
+            {
+                physicalDevice = candidate;
+                if (props.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU) break;
+            }
+        }
+        if (!physicalDevice)
+        {
+            fprintf(stderr, "Error: no Vulkan physical device found\n");
+            return false;
+        }
+        VkPhysicalDeviceProperties props{};
+        vkGetPhysicalDeviceProperties(physicalDevice, &props);
+        printf("Adapter: %s\n", props.deviceName);
+
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, families.data());
+        uint32_t family = UINT_MAX;
+        for (uint32_t i = 0; i < familyCount && family == UINT_MAX; i++)
+        {
+            auto flags = families[i].queueFlags;
+            if ((flags & VK_QUEUE_GRAPHICS_BIT) && (flags & VK_QUEUE_COMPUTE_BIT)) family = i;
+        }
+        if (family == UINT_MAX)
+        {
+            fprintf(stderr, "Error: no graphics queue family found\n");
+            return false;
+        }
+
+        // Only enable what chi and the NIS fp16 permutations can use, whatever the device supports
+        VkPhysicalDeviceVulkan11Features features11{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES };
+        VkPhysicalDeviceVulkan12Features features12{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES };
+        features11.pNext = &features12;
+        VkPhysicalDeviceFeatures2 supported{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
+        supported.pNext = &features11;
+        vkGetPhysicalDeviceFeatures2(physicalDevice, &supported);
+
+        VkPhysicalDeviceVulkan11Features enable11{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES };
+        VkPhysicalDeviceVulkan12Features enable12{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES };
+        enable11.pNext = &enable12;
+        enable11.storageBuffer16BitAccess = features11.storageBuffer16BitAccess;
+        enable12.timelineSemaphore = features12.timelineSemaphore;
+        enable12.shaderFloat16 = features12.shaderFloat16;
+        VkPhysicalDeviceFeatures2 enabled{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2 };
+        enabled.pNext = &enable11;
+
+        // Separate compute queue when the family has one to spare, same as a typical title
+        uint32_t queueCount = std::min(2u, families[family].queueCount);
+        float priorities[2] = { 1.0f, 1.0f };
+        VkDeviceQueueCreateInfo queueInfo{ VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
+        queueInfo.queueFamilyIndex = family;
+        queueInfo.queueCount = queueCount;
+        queueInfo.pQueuePriorities = priorities;
+        VkDeviceCreateInfo deviceInfo{ VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
+        deviceInfo.pNext = &enabled;
+        deviceInfo.queueCreateInfoCount = 1;
+        deviceInfo.pQueueCreateInfos = &queueInfo;
+        if (vkCreateDevice(physicalDevice, &deviceInfo, nullptr, &device) != VK_SUCCESS)
+        {
+            fprintf(stderr, "Error: failed to create Vulkan device\n");
+            return false;
+        }
+
+        table.instance = instance;
+        table.device = device;
+        table.getInstanceProcAddr = vkGetInstanceProcAddr;
+        table.getDeviceProcAddr = vkGetDeviceProcAddr;
+        table.graphicsQueueFamily = family;
+        table.graphicsQueueIndex = 0;
+        table.computeQueueFamily = family;
+        table.computeQueueIndex = queueCount - 1;
+        table.synchronization2 = false;
+        table.descriptorBuffer = false;
+        return true;
+    }
+
+    void destroy()
+    {
+        if (device) vkDestroyDevice(device, nullptr);
+        if (instance) vkDestroyInstance(instance, nullptr);
+        device = {};
+        instance = {};
+    }
+};
+
+bool runGpuBenchmarks(const GpuSettings& settings, std::vector<Result>& results)
+{
+    auto params = param::getInterface();
+    chi::ICompute* compute{};
+    ComPtr<ID3D12Device> d3d12Device;
+    VulkanDevice vulkanDevice{};
+
+    if (settings.api == RenderAPI::eVulkan)
+    {
+        if (!vulkanDevice.create())
+        {
+            vulkanDevice.destroy();
+            return false;
+        }
+        params->set(param::global::kVulkanTable, (void*)&vulkanDevice.table);
+        void* device[] = { vulkanDevice.instance, vulkanDevice.device, vulkanDevice.physicalDevice };
+        compute = chi::getVulkan();
+        if (compute->init((chi::Device)device, params) != chi::ComputeStatus::eOk)
+        {
+            fprintf(stderr, "Error: failed to initialize Vulkan compute\n");
+            vulkanDevice.destroy();
+            return false;
+        }
+    }
+    else
+    {
+        ComPtr<IDXGIFactory6> factory;
+        ComPtr<IDXGIAdapter1> adapter;
+        if (FAILED(CreateDXGIFactory2(0, IID_PPV_ARGS(&factory))))
+        {
+            fprintf(stderr, "Error: failed to create DXGI factory\n");
+            return false;
+        }
+        HRESULT hr = settings.warp ? factory->EnumWarpAdapter(IID_PPV_ARGS(&adapter)) :
+            factory->EnumAdapterByGpuPreference(0, DXGI_GPU_PREFERENCE_HIGH_PERFORMANCE, IID_PPV_ARGS(&adapter));
+        if (FAILED(hr) || FAILED(D3D12CreateDevice(adapter.Get(), D3D_FEATURE_LEVEL_12_0, IID_PPV_ARGS(&d3d12Device))))
+        {
+            fprintf(stderr, "Error: failed to create D3D12 device\n");
+            return false;
+        }
+        DXGI_ADAPTER_DESC1 adapterDesc{};
+        adapter->GetDesc1(&adapterDesc);
+        printf("Adapter: %ls\n", adapterDesc.Description);
+        compute = chi::getD3D12();
+        if (compute->init(d3d12Device.Get(), params) != chi::ComputeStatus::eOk)
+        {
+            fprintf(stderr, "Error: failed to initialize D3D12 compute\n");
+            return false;
+        }
+    }
+
+    GpuRunner runner(compute, settings, results);
+    bool ok = runner.init() && runner.run();
+    runner.shutdown();
+    compute->shutdown();
+    vulkanDevice.destroy();
+    return ok;
+}
+
+}
+}
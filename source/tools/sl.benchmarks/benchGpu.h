@@ -0,0 +1,52 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+#include "include/sl.h"
+#include "source/tools/sl.benchmarks/benchmark.h"
+
+namespace sl
+{
+namespace bench
+{
+
+struct GpuSettings
+{
+    RenderAPI api = RenderAPI::eD3D12;
+    //! Software adapter, D3D12 only, handy to validate the harness on machines without a GPU
+    bool warp = false;
+    std::vector<std::pair<uint32_t, uint32_t>> resolutions = { {1280, 720}, {1920, 1080}, {2560, 1440}, {3840, 2160} };
+    //! Resolved GPU samples collected per pass, run after 'warmup' frames
+    uint32_t frames = 100;
+    uint32_t warmup = 8;
+    //! Only passes containing this string are executed
+    std::string filter;
+};
+
+//! Times chi kernels and copy paths on a headless device created for 'settings.api'
+//!
+//! Results are in GPU ns per pass (CPU ns for resource creation), named "<api>/<pass>/<width>x<height>"
+bool runGpuBenchmarks(const GpuSettings& settings, std::vector<Result>& results);
+
+}
+}
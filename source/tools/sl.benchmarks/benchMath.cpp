@@ -0,0 +1,200 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+//! Matrix helpers used on every evaluate, SIMD paths are checked against the scalar reference first
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "include/sl.h"
+#include "include/sl_consts.h"
+#include "include/sl_matrix_helpers.h"
+#include "source/tools/sl.benchmarks/benchmark.h"
+
+namespace sl
+{
+namespace bench
+{
+
+constexpr uint32_t kMatrixCount = 256;
+
+//! Fixed seed so every run and every machine compares the same inputs
+struct Random
+{
+    uint32_t state = 0x12345678;
+    float next(float range)
+    {
+        state = state * 1664525u + 1013904223u;
+        return ((float)(state >> 8) / (float)(1u << 24) * 2.0f - 1.0f) * range;
+    }
+};
+
+//! Camera like matrices, rotation with a translation up to 'distance' from the origin, last column is (0,0,0,1)
+void makeOrthoNormal(float4x4& m, Random& random, float distance)
+{
+    float yaw = random.next(3.14159265f), pitch = random.next(1.5f), roll = random.next(3.14159265f);
+    float cy = cosf(yaw), sy = sinf(yaw), cp = cosf(pitch), sp = sinf(pitch), cr = cosf(roll), sr = sinf(roll);
+    m[0] = float4(cy * cr + sy * sp * sr, cp * sr, -sy * cr + cy * sp * sr, 0.0f);
+    m[1] = float4(-cy * sr + sy * sp * cr, cp * cr, sr * sy + cy * sp * cr, 0.0f);
+    m[2] = float4(sy * cp, -sp, cy * cp, 0.0f);
+    m[3] = float4(random.next(distance), random.next(distance), random.next(distance), 1.0f);
+}
+
+//! General inputs, includes singular matrices and signed zeros which the SIMD paths have to preserve
+void makeGeneral(float4x4& m, Random& random, uint32_t i)
+{
+    for (uint32_t r = 0; r < 4; r++)
+    {
+        m[r] = float4(random.next(100.0f), random.next(100.0f), random.next(100.0f), random.next(100.0f));
+    }
+    if (i % 8 == 1)
+    {
+        m[2] = m[1];
+    }
+    else if (i % 8 == 2)
+    {
+        m[0].x = -0.0f;
+        m[3] = float4(0.0f, -0.0f, 0.0f, -0.0f);
+    }
+}
+
+struct MatrixInputs
+{
+    float4x4 general[kMatrixCount];
+    float4x4 orthoNormal[kMatrixCount];
+    MatrixInputs()
+    {
+        Random random;
+        for (uint32_t i = 0; i < kMatrixCount; i++)
+        {
+            makeGeneral(general[i], random, i);
+            // Large distances are where 'calcCameraToPrevCamera' matters
+            makeOrthoNormal(orthoNormal[i], random, i % 2 ? 100000.0f : 10.0f);
+        }
+    }
+};
+
+const MatrixInputs& getMatrixInputs()
+{
+    static MatrixInputs s_inputs;
+    return s_inputs;
+}
+
+bool matchesBits(const float4x4& a, const float4x4& b, const char* what, uint32_t index, std::string& error)
+{
+    if (memcmp(&a, &b, sizeof(float4x4)) == 0)
+    {
+        return true;
+    }
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        auto x = (&a[0].x)[i], y = (&b[0].x)[i];
+        if (memcmp(&x, &y, sizeof(float)))
+        {
+            char buffer[160];
+            snprintf(buffer, sizeof(buffer), "%s input %u element %u is %.9g instead of %.9g", what, index, i, x, y);
+            error = buffer;
+            break;
+        }
+    }
+    return false;
+}
+
+SL_BENCHMARK_CHECK(matrixHelpersBitExact, "sl_matrix_helpers SIMD vs scalar")
+{
+    auto& inputs = getMatrixInputs();
+    for (uint32_t i = 0; i < kMatrixCount; i++)
+    {
+        auto& a = inputs.general[i];
+        auto& b = inputs.general[(i + 1) % kMatrixCount];
+        float4x4 fast, scalar;
+        matrixMul(fast, a, b);
+        matrixMulScalar(scalar, a, b);
+        if (!matchesBits(fast, scalar, "matrixMul", i, error)) return false;
+        matrixFullInvert(fast, a);
+        matrixFullInvertScalar(scalar, a);
+        if (!matchesBits(fast, scalar, "matrixFullInvert", i, error)) return false;
+        matrixOrthoNormalInvert(fast, inputs.orthoNormal[i]);
+        matrixOrthoNormalInvertScalar(scalar, inputs.orthoNormal[i]);
+        if (!matchesBits(fast, scalar, "matrixOrthoNormalInvert", i, error)) return false;
+    }
+    return true;
+}
+
+SL_BENCHMARK(matrixMulScalarBench, "matrixMulScalar")
+{
+    auto& inputs = getMatrixInputs();
+    float4x4 result;
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        matrixMulScalar(result, inputs.general[i % kMatrixCount], inputs.general[(i + 1) % kMatrixCount]);
+        doNotOptimize(result);
+    }
+}
+
+SL_BENCHMARK(matrixMulBench, "matrixMul")
+{
+    auto& inputs = getMatrixInputs();
+    float4x4 result;
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        matrixMul(result, inputs.general[i % kMatrixCount], inputs.general[(i + 1) % kMatrixCount]);
+        doNotOptimize(result);
+    }
+}
+
+SL_BENCHMARK(matrixFullInvertScalarBench, "matrixFullInvertScalar")
+{
+    auto& inputs = getMatrixInputs();
+    float4x4 result;
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        matrixFullInvertScalar(result, inputs.general[i % kMatrixCount]);
+        doNotOptimize(result);
+    }
+}
+
+SL_BENCHMARK(matrixFullInvertBench, "matrixFullInvert")
+{
+    auto& inputs = getMatrixInputs();
+    float4x4 result;
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        matrixFullInvert(result, inputs.general[i % kMatrixCount]);
+        doNotOptimize(result);
+    }
+}
+
+SL_BENCHMARK(calcCameraToPrevCameraBench, "calcCameraToPrevCamera")
+{
+    auto& inputs = getMatrixInputs();
+    float4x4 result;
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        calcCameraToPrevCamera(result, inputs.orthoNormal[i % kMatrixCount], inputs.orthoNormal[(i + 1) % kMatrixCount]);
+        doNotOptimize(result);
+    }
+}
+
+}
+}
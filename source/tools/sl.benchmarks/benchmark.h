@@ -0,0 +1,169 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <stdint.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace sl
+{
+namespace bench
+{
+
+//! Benchmark body, must execute the measured operation exactly 'iterations' times
+using BenchmarkFunc = void(*)(uint64_t iterations);
+
+struct Benchmark
+{
+    const char* name{};
+    BenchmarkFunc func{};
+};
+
+struct Result
+{
+    std::string name;
+    uint64_t iterations{};
+    double minNs{};
+    double medianNs{};
+    double maxNs{};
+};
+
+struct Settings
+{
+    //! Each repetition runs for at least this long
+    double minTimeMs = 50.0;
+    uint32_t repetitions = 5;
+    //! Only benchmarks containing this string are executed
+    std::string filter;
+};
+
+inline std::vector<Benchmark>& getRegistry()
+{
+    static std::vector<Benchmark> s_registry;
+    return s_registry;
+}
+
+struct Registrar
+{
+    Registrar(const char* name, BenchmarkFunc func) { getRegistry().push_back({ name, func }); }
+};
+
+//! Correctness check executed once before the benchmarks, returns false and describes the mismatch in 'error'
+//!
+//! Used where a fast path must match a reference implementation, timing a wrong result is meaningless.
+using CheckFunc = bool(*)(std::string& error);
+
+struct Check
+{
+    const char* name{};
+    CheckFunc func{};
+};
+
+inline std::vector<Check>& getCheckRegistry()
+{
+    static std::vector<Check> s_registry;
+    return s_registry;
+}
+
+struct CheckRegistrar
+{
+    CheckRegistrar(const char* name, CheckFunc func) { getCheckRegistry().push_back({ name, func }); }
+};
+
+//! Keeps the optimizer from discarding values computed in the timed loop
+inline const volatile void* s_sink{};
+template<typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(_MSC_VER)
+    s_sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "g"(&value) : "memory");
+#endif
+}
+
+inline double measureNs(BenchmarkFunc func, uint64_t iterations)
+{
+    auto start = std::chrono::steady_clock::now();
+    func(iterations);
+    auto end = std::chrono::steady_clock::now();
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+//! Calibrates the iteration count so a repetition lasts 'minTimeMs' then reports the spread across repetitions
+//!
+//! Median is the value to compare between releases, min and max show how noisy the machine is.
+inline Result run(const Benchmark& benchmark, const Settings& settings)
+{
+    const double targetNs = settings.minTimeMs * 1e6;
+    uint64_t iterations = 1;
+    double ns = measureNs(benchmark.func, iterations);
+    constexpr uint64_t kMaxIterations = 1ull << 32;
+    while (ns < targetNs && iterations < kMaxIterations)
+    {
+        // Grow towards the target but never by more than 100x per step, first runs are often cold
+        double scale = ns > 0.0 ? std::clamp(targetNs * 1.2 / ns, 2.0, 100.0) : 100.0;
+        iterations = std::min(kMaxIterations, (uint64_t)(iterations * scale));
+        ns = measureNs(benchmark.func, iterations);
+    }
+
+    std::vector<double> perOp;
+    perOp.reserve(settings.repetitions);
+    for (uint32_t i = 0; i < settings.repetitions; i++)
+    {
+        perOp.push_back(measureNs(benchmark.func, iterations) / iterations);
+    }
+    std::sort(perOp.begin(), perOp.end());
+
+    Result result{};
+    result.name = benchmark.name;
+    result.iterations = iterations;
+    result.minNs = perOp.front();
+    result.medianNs = perOp[perOp.size() / 2];
+    result.maxNs = perOp.back();
+    return result;
+}
+
+}
+}
+
+//! Registers a benchmark, body receives the number of iterations to execute
+//!
+//! One-time setup belongs in function statics so it stays out of the measurement after calibration.
+#define SL_BENCHMARK(ID, NAME)                                              \
+static void ID(uint64_t iterations);                                        \
+static sl::bench::Registrar s_registrar_##ID(NAME, ID);                     \
+static void ID(uint64_t iterations)
+
+//! Registers a correctness check, body receives the error string to fill on failure
+#define SL_BENCHMARK_CHECK(ID, NAME)                                        \
+static bool ID(std::string& error);                                         \
+static sl::bench::CheckRegistrar s_checkRegistrar_##ID(NAME, ID);           \
+static bool ID(std::string& error)
@@ -0,0 +1,281 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+//! CPU microbenchmarks for SL core and sl.common hot paths, GPU timings for chi kernels and copy paths
+//!
+//! Runs headless, results can be written as JSON and compared against a previous run to catch regressions
+//! between releases. Exit code is 2 if any benchmark got slower than the threshold allows and 3 if a correctness
+//! check failed, in which case no CPU benchmarks are executed.
+//!
+//! Usage: sl.benchmarks.exe [--filter <text>] [--min-time <ms>] [--repetitions N] [--json <out.json>]
+//!                          [--baseline <in.json>] [--threshold <percent>]
+//!                          [--gpu d3d12|vulkan] [--warp] [--resolutions WxH,...] [--frames N]
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <fstream>
+#include <map>
+
+#include "include/sl.h"
+#include "source/core/sl.log/log.h"
+#include "source/core/sl.param/parameters.h"
+#include "source/core/sl.extra/trace.h"
+#include "source/tools/sl.benchmarks/benchmark.h"
+#include "source/tools/sl.benchmarks/benchGpu.h"
+#include "external/json/include/nlohmann/json.hpp"
+
+using json = nlohmann::json;
+
+SL_TRACE_DEFINE_PROVIDER()
+
+namespace sl
+{
+namespace bench
+{
+
+struct Options
+{
+    Settings settings{};
+    //! GPU passes are timed instead of the CPU benchmarks when set
+    bool gpu = false;
+    GpuSettings gpuSettings{};
+    std::string jsonPath;
+    std::string baselinePath;
+    double thresholdPercent = 10.0;
+};
+
+bool parseResolutions(const std::string& text, std::vector<std::pair<uint32_t, uint32_t>>& resolutions)
+{
+    resolutions.clear();
+    size_t start = 0;
+    while (start < text.size())
+    {
+        auto end = text.find(',', start);
+        if (end == std::string::npos) end = text.size();
+        uint32_t width{}, height{};
+        if (sscanf_s(text.substr(start, end - start).c_str(), "%ux%u", &width, &height) != 2 || !width || !height)
+        {
+            return false;
+        }
+        resolutions.push_back({ width, height });
+        start = end + 1;
+    }
+    return !resolutions.empty();
+}
+
+bool parseArguments(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue) options.settings.filter = argv[++i];
+        else if (arg == "--min-time" && hasValue) options.settings.minTimeMs = std::max(1.0, atof(argv[++i]));
+        else if (arg == "--repetitions" && hasValue) options.settings.repetitions = std::max(1, atoi(argv[++i]));
+        else if (arg == "--json" && hasValue) options.jsonPath = argv[++i];
+        else if (arg == "--baseline" && hasValue) options.baselinePath = argv[++i];
+        else if (arg == "--threshold" && hasValue) options.thresholdPercent = std::max(0.0, atof(argv[++i]));
+        else if (arg == "--gpu" && hasValue)
+        {
+            std::string api = argv[++i];
+            if (api == "d3d12") options.gpuSettings.api = RenderAPI::eD3D12;
+            else if (api == "vulkan") options.gpuSettings.api = RenderAPI::eVulkan;
+            else
+            {
+                fprintf(stderr, "Error: unsupported API '%s'\n", api.c_str());
+                return false;
+            }
+            options.gpu = true;
+        }
+        else if (arg == "--warp") options.gpuSettings.warp = true;
+        else if (arg == "--resolutions" && hasValue)
+        {
+            if (!parseResolutions(argv[++i], options.gpuSettings.resolutions))
+            {
+                fprintf(stderr, "Error: invalid resolutions '%s'\n", argv[i]);
+                return false;
+            }
+        }
+        else if (arg == "--frames" && hasValue) options.gpuSettings.frames = std::max(1, atoi(argv[++i]));
+        else
+        {
+            fprintf(stderr, "Error: unexpected argument '%s'\n", arg.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool loadBaseline(const std::string& path, std::map<std::string, double>& baseline)
+{
+    std::ifstream stream(path);
+    if (!stream.is_open())
+    {
+        fprintf(stderr, "Error: failed to open baseline '%s'\n", path.c_str());
+        return false;
+    }
+    try
+    {
+        auto root = json::parse(stream);
+        for (auto& entry : root["benchmarks"])
+        {
+            baseline[entry["name"].get<std::string>()] = entry["medianNs"].get<double>();
+        }
+    }
+    catch (std::exception& e)
+    {
+        fprintf(stderr, "Error: failed to parse baseline '%s' - %s\n", path.c_str(), e.what());
+        return false;
+    }
+    return true;
+}
+
+bool saveResults(const std::string& path, const std::vector<Result>& results)
+{
+    json root;
+    root["benchmarks"] = json::array();
+    for (auto& result : results)
+    {
+        root["benchmarks"].push_back({
+            {"name", result.name},
+            {"iterations", result.iterations},
+            {"minNs", result.minNs},
+            {"medianNs", result.medianNs},
+            {"maxNs", result.maxNs}
+        });
+    }
+    std::ofstream stream(path);
+    if (!stream.is_open())
+    {
+        fprintf(stderr, "Error: failed to write '%s'\n", path.c_str());
+        return false;
+    }
+    stream << root.dump(2);
+    return true;
+}
+
+}
+}
+
+int main(int argc, char** argv)
+{
+    using namespace sl;
+    using namespace sl::bench;
+
+    Options options{};
+    if (!parseArguments(argc, argv, options))
+    {
+        printf("Usage: sl.benchmarks.exe [--filter <text>] [--min-time <ms>] [--repetitions N] [--json <out.json>] [--baseline <in.json>] [--threshold <percent>]\n");
+        printf("                         [--gpu d3d12|vulkan] [--warp] [--resolutions WxH,...] [--frames N]\n");
+        return 1;
+    }
+
+    std::map<std::string, double> baseline;
+    if (!options.baselinePath.empty() && !loadBaseline(options.baselinePath, baseline))
+    {
+        return 1;
+    }
+
+    // Same defaults as a title running without the console, verbose messages are filtered out
+    auto log = log::getInterface();
+    log->enableConsole(false);
+    log->setLogLevel(LogLevel::eDefault);
+    param::getInterface()->set(param::global::kLogInterface, (void*)log);
+
+    std::vector<Result> results;
+    if (options.gpu)
+    {
+        options.gpuSettings.filter = options.settings.filter;
+        if (!runGpuBenchmarks(options.gpuSettings, results))
+        {
+            log::destroyInterface();
+            return 1;
+        }
+    }
+    else
+    {
+        uint32_t failures = 0;
+        for (auto& check : getCheckRegistry())
+        {
+            if (!options.settings.filter.empty() && std::string(check.name).find(options.settings.filter) == std::string::npos)
+            {
+                continue;
+            }
+            std::string error;
+            if (!check.func(error))
+            {
+                fprintf(stderr, "Check '%s' failed - %s\n", check.name, error.c_str());
+                failures++;
+            }
+        }
+        if (failures)
+        {
+            printf("%u check(s) failed\n", failures);
+            log::destroyInterface();
+            return 3;
+        }
+        for (auto& benchmark : getRegistry())
+        {
+            if (!options.settings.filter.empty() && std::string(benchmark.name).find(options.settings.filter) == std::string::npos)
+            {
+                continue;
+            }
+            results.push_back(run(benchmark, options.settings));
+        }
+    }
+
+    uint32_t regressions = 0;
+    printf("%-48s %12s %12s %12s %10s\n", "benchmark", "median (ns)", "min (ns)", "max (ns)", "delta");
+    for (auto& result : results)
+    {
+        std::string delta = "-";
+        auto it = baseline.find(result.name);
+        if (it != baseline.end() && it->second > 0.0)
+        {
+            double percent = (result.medianNs - it->second) / it->second * 100.0;
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "%+.1f%%", percent);
+            delta = buffer;
+            if (percent > options.thresholdPercent)
+            {
+                delta += " !";
+                regressions++;
+            }
+        }
+        printf("%-48s %12.2f %12.2f %12.2f %10s\n", result.name.c_str(), result.medianNs, result.minNs, result.maxNs, delta.c_str());
+    }
+
+    if (!options.jsonPath.empty() && !saveResults(options.jsonPath, results))
+    {
+        return 1;
+    }
+
+    log::destroyInterface();
+
+    if (regressions)
+    {
+        printf("%u benchmark(s) regressed by more than %.1f%%\n", regressions, options.thresholdPercent);
+        return 2;
+    }
+    return 0;
+}
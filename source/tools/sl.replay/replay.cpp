@@ -0,0 +1,916 @@
+/*
+* Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+*
+* Permission is hereby granted, free of charge, to any person obtaining a copy
+* of this software and associated documentation files (the "Software"), to deal
+* in the Software without restriction, including without limitation the rights
+* to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+* copies of the Software, and to permit persons to whom the Software is
+* furnished to do so, subject to the following conditions:
+*
+* The above copyright notice and this permission notice shall be included in all
+* copies or substantial portions of the Software.
+*
+* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+* IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+* FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+* AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+* LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+* OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+* SOFTWARE.
+*/
+
+//! Offline replay of captures recorded with 'ICapture::startRecording'
+//!
+//! Loads a capture, creates a headless D3D12 device and drives the public SL API frame by frame
+//! (tags, constants, feature options and evaluate) reporting CPU and GPU time per frame.
+//! There is no swap-chain or engine involved so results only depend on the SL and plugin versions, frames
+//! are closed with 'slPresentHeadless' so SL runs its regular per frame work between them.
+//!
+//! Usage: sl.replay.exe <capture.sldump> [--feature dlss|dlss_rr|nis|directsr] [--loops N] [--warmup N]
+//!                      [--variant N] [--plugins <dir>] [--log]
+
+#include <d3d12.h>
+#include <dxgi1_6.h>
+#include <wrl/client.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <iterator>
+
+#include "include/sl.h"
+#include "include/sl_consts.h"
+#include "include/sl_dlss.h"
+#include "include/sl_dlss_d.h"
+#include "include/sl_nis.h"
+#include "include/sl_directsr.h"
+#include "include/sl_helpers.h"
+#include "include/sl_headless.h"
+
+// The capture format is only compiled in for non-production builds, the replay tool always needs it
+#ifndef SL_CAPTURE
+#define SL_CAPTURE
+#endif
+#include "source/platforms/sl.chi/capture.h"
+#include "source/platforms/sl.chi/captureCodec.h"
+#include "source/platforms/sl.chi/compute.h"
+
+using Microsoft::WRL::ComPtr;
+
+namespace sl
+{
+namespace replay
+{
+
+struct Settings
+{
+    std::string capturePath;
+    Feature feature = kFeatureDLSS;
+    bool featureOverride = false;
+    uint32_t loops = 1;
+    uint32_t warmup = 0;
+    uint32_t variant = 0;
+    std::wstring pluginPath;
+    bool log = false;
+};
+
+struct Chunk
+{
+    CaptureChunkHeader header{};
+    uint64_t offset{}; // File offset of the payload
+};
+
+//! Reads the chunked capture container described in capture.h
+class CaptureReader
+{
+public:
+    bool open(const std::string& path)
+    {
+        file.open(path, std::ios::binary);
+        if (!file)
+        {
+            fprintf(stderr, "Error: failed to open '%s'\n", path.c_str());
+            return false;
+        }
+
+        const CaptureFileHeader expected{};
+        CaptureFileHeader header{};
+        if (!file.read((char*)&header, sizeof(header)) || memcmp(header.magic, expected.magic, sizeof(header.magic)) != 0)
+        {
+            fprintf(stderr, "Error: '%s' is not a capture file\n", path.c_str());
+            return false;
+        }
+        if (header.version != SL_DUMP_FILE_VERSION)
+        {
+            fprintf(stderr, "Error: capture version %u is not supported, expected %u\n", header.version, SL_DUMP_FILE_VERSION);
+            return false;
+        }
+
+        file.seekg(0, std::ios::end);
+        fileSize = (uint64_t)file.tellg();
+
+        CaptureFileFooter footer{};
+        bool indexed = false;
+        if (fileSize >= sizeof(CaptureFileHeader) + sizeof(CaptureFileFooter))
+        {
+            file.seekg(fileSize - sizeof(CaptureFileFooter));
+            indexed = file.read((char*)&footer, sizeof(footer)) && footer.magic == SL_DUMP_FOOTER_MAGIC &&
+                footer.indexOffset + footer.indexCount * sizeof(CaptureIndexEntry) <= fileSize - sizeof(CaptureFileFooter);
+        }
+
+        if (indexed)
+        {
+            std::vector<CaptureIndexEntry> index(footer.indexCount);
+            file.clear();
+            file.seekg(footer.indexOffset);
+            if (!file.read((char*)index.data(), index.size() * sizeof(CaptureIndexEntry)))
+            {
+                fprintf(stderr, "Error: failed to read the frame index\n");
+                return false;
+            }
+            for (auto& entry : index)
+            {
+                if (!readChunkAt(entry.offset))
+                {
+                    fprintf(stderr, "Error: frame index points to an invalid chunk at offset %llu\n", entry.offset);
+                    return false;
+                }
+            }
+        }
+        else
+        {
+            // Capture was not finished cleanly, walk the chunks until the data runs out
+            printf("Warning: capture has no frame index, walking chunks\n");
+            uint64_t offset = sizeof(CaptureFileHeader);
+            while (offset + sizeof(CaptureChunkHeader) <= fileSize && readChunkAt(offset))
+            {
+                offset = chunks.back().offset + chunks.back().header.storedSize;
+            }
+        }
+        return true;
+    }
+
+    //! Decodes the payload of a chunk back to the layout it was recorded in
+    bool decode(size_t chunkIndex, std::vector<uint8_t>& raw)
+    {
+        const CaptureChunkHeader& header = chunks[chunkIndex].header;
+
+        std::vector<uint8_t> stored(header.storedSize);
+        file.clear();
+        file.seekg(chunks[chunkIndex].offset);
+        if (!file.read((char*)stored.data(), stored.size())) return false;
+
+        if (header.codec & eCaptureCodecLZ4)
+        {
+            raw.resize(header.rawSize);
+            if (chi::codec::lz4Decompress(stored.data(), stored.size(), raw.data(), raw.size()) != header.rawSize) return false;
+        }
+        else
+        {
+            raw = std::move(stored);
+        }
+        if (raw.size() != header.rawSize) return false;
+
+        if (header.codec & eCaptureCodecDeltaXor)
+        {
+            auto reference = references.find({ header.bufferType, header.referenceFrame });
+            if (reference == references.end())
+            {
+                // Frames can be appended out of order, decode the reference first which caches it
+                auto source = resourceChunks.find({ header.bufferType, header.referenceFrame });
+                std::vector<uint8_t> unused;
+                if (source == resourceChunks.end() || source->second == chunkIndex || !decode(source->second, unused)) return false;
+                reference = references.find({ header.bufferType, header.referenceFrame });
+            }
+            if (reference->second.size() != raw.size()) return false;
+            for (size_t i = 0; i < raw.size(); i++)
+            {
+                raw[i] ^= reference->second[i];
+            }
+        }
+
+        if (header.kind == eCaptureChunkResource && (header.bufferType == kBufferTypeDepth || header.bufferType == kBufferTypeMotionVectors))
+        {
+            references[{ header.bufferType, header.frame }] = raw;
+            // Delta chains never cross a key frame so anything older than the interval cannot be referenced again
+            for (auto it = references.begin(); it != references.end();)
+            {
+                if (it->first.first == header.bufferType && it->first.second < header.frame - SL_DUMP_KEY_FRAME_INTERVAL)
+                {
+                    it = references.erase(it);
+                }
+                else
+                {
+                    it++;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::vector<Chunk> chunks;
+    //! Chunk indices per frame, ordered by frame
+    std::map<int, std::vector<size_t>> frames;
+
+private:
+    bool readChunkAt(uint64_t offset)
+    {
+        Chunk chunk{};
+        file.clear();
+        file.seekg(offset);
+        if (!file.read((char*)&chunk.header, sizeof(chunk.header)) || chunk.header.magic != SL_DUMP_CHUNK_MAGIC) return false;
+        chunk.offset = offset + sizeof(CaptureChunkHeader);
+        if (chunk.offset + chunk.header.storedSize > fileSize) return false;
+
+        if (chunk.header.kind != eCaptureChunkRaw && chunk.header.frame >= 0)
+        {
+            frames[chunk.header.frame].push_back(chunks.size());
+            if (chunk.header.kind == eCaptureChunkResource)
+            {
+                resourceChunks[{ chunk.header.bufferType, chunk.header.frame }] = chunks.size();
+            }
+        }
+        chunks.push_back(chunk);
+        return true;
+    }
+
+    std::ifstream file;
+    uint64_t fileSize{};
+    std::map<std::pair<BufferType, int>, size_t> resourceChunks;
+    //! Decoded depth and motion vector payloads delta coded chunks refer to
+    std::map<std::pair<BufferType, int>, std::vector<uint8_t>> references;
+};
+
+struct ResourceInputs
+{
+    BufferType type{};
+    Extent extent{};
+    uint32_t width{};
+    uint32_t height{};
+    DXGI_FORMAT format{};
+    std::vector<uint8_t> payload;
+    size_t pixelOffset{};
+};
+
+//! Everything recorded for a single frame
+struct FrameInputs
+{
+    bool hasConstants = false;
+    Constants constants{};
+    bool isDLSSD = false;
+    DLSSOptions dlssOptions{};
+    DLSSDOptions dlssdOptions{};
+    std::vector<ResourceInputs> resources;
+};
+
+//! Copies a recorded SL structure while keeping our own header, 'next' pointers are meaningless on disk
+template<typename T>
+void copyStructure(T& dst, const uint8_t* src, size_t size)
+{
+    size = std::min(size, sizeof(T));
+    if (size > sizeof(BaseStructure))
+    {
+        memcpy((uint8_t*)&dst + sizeof(BaseStructure), src + sizeof(BaseStructure), size - sizeof(BaseStructure));
+    }
+}
+
+bool parseFrame(CaptureReader& reader, const std::vector<size_t>& chunkIndices, FrameInputs& frame)
+{
+    constexpr size_t kResourceHeaderSize = SL_DUMP_SIZE_OF_LABELS + sizeof(int) + sizeof(BufferType) + sizeof(Extent) + sizeof(chi::ResourceDescription);
+    constexpr size_t kGlobalHeaderSize = SL_DUMP_SIZE_OF_LABELS + sizeof(int) + sizeof(double);
+    constexpr size_t kFeatureHeaderSize = SL_DUMP_SIZE_OF_LABELS + sizeof(int) + sizeof(int);
+
+    for (auto i : chunkIndices)
+    {
+        std::vector<uint8_t> raw;
+        if (!reader.decode(i, raw))
+        {
+            fprintf(stderr, "Error: failed to decode chunk %llu of frame %d\n", (uint64_t)i, reader.chunks[i].header.frame);
+            return false;
+        }
+
+        switch (reader.chunks[i].header.kind)
+        {
+            case eCaptureChunkResource:
+            {
+                if (raw.size() < kResourceHeaderSize) return false;
+                ResourceInputs resource{};
+                const uint8_t* p = raw.data() + SL_DUMP_SIZE_OF_LABELS + sizeof(int);
+                memcpy(&resource.type, p, sizeof(BufferType));
+                p += sizeof(BufferType);
+                memcpy(&resource.extent, p, sizeof(Extent));
+                p += sizeof(Extent);
+                // Only the leading width, height and native format are used, the rest of the description
+                // (including a std::string) is meaningless outside of the process which recorded it
+                uint32_t leading[3]{};
+                memcpy(leading, p, sizeof(leading));
+                resource.width = leading[0];
+                resource.height = leading[1];
+                resource.format = (DXGI_FORMAT)leading[2];
+                resource.pixelOffset = kResourceHeaderSize;
+                resource.payload = std::move(raw);
+                frame.resources.push_back(std::move(resource));
+                break;
+            }
+            case eCaptureChunkGlobalConstants:
+            {
+                if (raw.size() < kGlobalHeaderSize) return false;
+                copyStructure(frame.constants, raw.data() + kGlobalHeaderSize, raw.size() - kGlobalHeaderSize);
+                frame.hasConstants = true;
+                break;
+            }
+            case eCaptureChunkFeatureConstants:
+            {
+                if (raw.size() < kFeatureHeaderSize) return false;
+                int counter{};
+                memcpy(&counter, raw.data() + SL_DUMP_SIZE_OF_LABELS + sizeof(int), sizeof(int));
+                size_t size = raw.size() - kFeatureHeaderSize;
+                // Counter 0 holds the options, DLSS and DLSS-RR options are told apart by their size
+                if (counter == 0)
+                {
+                    frame.isDLSSD = size == sizeof(DLSSDOptions);
+                    if (frame.isDLSSD)
+                    {
+                        copyStructure(frame.dlssdOptions, raw.data() + kFeatureHeaderSize, size);
+                    }
+                    else
+                    {
+                        copyStructure(frame.dlssOptions, raw.data() + kFeatureHeaderSize, size);
+                    }
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+//! Depth formats cannot be written with copies from buffers, use the typeless equivalent
+DXGI_FORMAT getReplayFormat(DXGI_FORMAT format)
+{
+    switch (format)
+    {
+        case DXGI_FORMAT_D32_FLOAT: return DXGI_FORMAT_R32_TYPELESS;
+        case DXGI_FORMAT_D24_UNORM_S8_UINT: return DXGI_FORMAT_R24G8_TYPELESS;
+        case DXGI_FORMAT_D16_UNORM: return DXGI_FORMAT_R16_TYPELESS;
+        case DXGI_FORMAT_D32_FLOAT_S8X24_UINT: return DXGI_FORMAT_R32G8X24_TYPELESS;
+        default: return format;
+    }
+}
+
+struct ReplayTexture
+{
+    ComPtr<ID3D12Resource> texture;
+    ComPtr<ID3D12Resource> upload;
+    uint8_t* uploadData{};
+    D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint{};
+    UINT numRows{};
+    UINT64 rowSizeInBytes{};
+    uint32_t width{};
+    uint32_t height{};
+    DXGI_FORMAT format{};
+    D3D12_RESOURCE_STATES state = D3D12_RESOURCE_STATE_COPY_DEST;
+};
+
+struct FrameTiming
+{
+    int frame{};
+    double cpuMs{};
+    double gpuMs{};
+};
+
+class Replay
+{
+public:
+    bool init(const Settings& settings_in)
+    {
+        settings = settings_in;
+
+        // SL has to be initialized before the device is created, manual hooking keeps the device native
+        std::wstring pluginPath = settings.pluginPath.empty() ? std::filesystem::current_path().wstring() : settings.pluginPath;
+        const wchar_t* pluginPaths[] = { pluginPath.c_str() };
+        Preferences pref{};
+        pref.showConsole = settings.log;
+        pref.logLevel = settings.log ? LogLevel::eVerbose : LogLevel::eDefault;
+        pref.pathsToPlugins = pluginPaths;
+        pref.numPathsToPlugins = 1;
+        pref.flags = PreferenceFlags::eDisableCLStateTracking | PreferenceFlags::eUseManualHooking | PreferenceFlags::eUseFrameBasedResourceTagging |
+            PreferenceFlags::eHeadless;
+        pref.featuresToLoad = &settings.feature;
+        pref.numFeaturesToLoad = 1;
+        pref.renderAPI = RenderAPI::eD3D12;
+        Result res = slInit(pref);
+        if (res != Result::eOk)
+        {
+            fprintf(stderr, "Error: slInit failed with %s\n", getResultAsStr(res));
+            return false;
+        }
+        slInitialized = true;
+
+        ComPtr<IDXGIFactory6> factory;
+        if (FAILED(CreateDXGIFactory2(0, IID_PPV_ARGS(&factory))))
+        {
+            fprintf(stderr, "Error: failed to create DXGI factory\n");
+            return false;
+        }
+        if (FAILED(factory->EnumAdapterByGpuPreference(0, DXGI_GPU_PREFERENCE_HIGH_PERFORMANCE, IID_PPV_ARGS(&adapter))) ||
+            FAILED(D3D12CreateDevice(adapter.Get(), D3D_FEATURE_LEVEL_12_0, IID_PPV_ARGS(&device))))
+        {
+            fprintf(stderr, "Error: failed to create D3D12 device\n");
+            return false;
+        }
+
+        DXGI_ADAPTER_DESC1 adapterDesc{};
+        adapter->GetDesc1(&adapterDesc);
+        printf("Adapter: %ls\n", adapterDesc.Description);
+
+        AdapterInfo adapterInfo{};
+        adapterInfo.deviceLUID = (uint8_t*)&adapterDesc.AdapterLuid;
+        adapterInfo.deviceLUIDSizeInBytes = sizeof(LUID);
+        res = slIsFeatureSupported(settings.feature, adapterInfo);
+        if (res != Result::eOk)
+        {
+            fprintf(stderr, "Error: %s is not supported on this adapter - %s\n", getFeatureAsStr(settings.feature), getResultAsStr(res));
+            return false;
+        }
+
+        res = slSetD3DDevice(device.Get());
+        if (res != Result::eOk)
+        {
+            fprintf(stderr, "Error: slSetD3DDevice failed with %s\n", getResultAsStr(res));
+            return false;
+        }
+
+        D3D12_COMMAND_QUEUE_DESC queueDesc{};
+        queueDesc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;
+        if (FAILED(device->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&queue))) ||
+            FAILED(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&allocator))) ||
+            FAILED(device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, allocator.Get(), nullptr, IID_PPV_ARGS(&cmdList))) ||
+            FAILED(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence))))
+        {
+            fprintf(stderr, "Error: failed to create D3D12 command objects\n");
+            return false;
+        }
+        cmdList->Close();
+        fenceEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+
+        D3D12_QUERY_HEAP_DESC queryDesc{};
+        queryDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+        queryDesc.Count = 2;
+        device->CreateQueryHeap(&queryDesc, IID_PPV_ARGS(&queryHeap));
+        queryReadback = createBuffer(D3D12_HEAP_TYPE_READBACK, 2 * sizeof(uint64_t));
+        queue->GetTimestampFrequency(&timestampFrequency);
+        QueryPerformanceFrequency(&cpuFrequency);
+
+        return queryHeap && queryReadback && fenceEvent;
+    }
+
+    void shutdown()
+    {
+        if (queue) waitForGPU();
+        textures.clear();
+        output = {};
+        if (slInitialized)
+        {
+            // Releases everything the plugin allocated for the viewport before the device goes away
+            slFreeResources(settings.feature, viewport);
+            slShutdown();
+        }
+        if (fenceEvent) CloseHandle(fenceEvent);
+    }
+
+    bool replayFrame(int frameIndex, FrameInputs& inputs, bool reset, FrameTiming& timing)
+    {
+        allocator->Reset();
+        cmdList->Reset(allocator.Get(), nullptr);
+
+        // Uploads are recorded first and kept out of the timed region
+        std::vector<ResourceTag> tags;
+        std::vector<Resource> resources;
+        std::vector<Extent> extents;
+        resources.reserve(inputs.resources.size() + 1);
+        extents.reserve(inputs.resources.size() + 1);
+        uint32_t renderWidth{}, renderHeight{};
+        DXGI_FORMAT colorFormat = DXGI_FORMAT_R16G16B16A16_FLOAT;
+        for (auto& input : inputs.resources)
+        {
+            ReplayTexture* texture = uploadTexture(input);
+            if (!texture) return false;
+            resources.push_back(Resource(ResourceType::eTex2d, texture->texture.Get(), texture->state));
+            extents.push_back(input.extent);
+            tags.push_back(ResourceTag(&resources.back(), input.type, ResourceLifecycle::eValidUntilPresent, input.extent ? &extents.back() : nullptr));
+            if (input.type == kBufferTypeScalingInputColor)
+            {
+                renderWidth = input.extent ? input.extent.width : input.width;
+                renderHeight = input.extent ? input.extent.height : input.height;
+                colorFormat = input.format;
+            }
+        }
+
+        uint32_t outputWidth = inputs.isDLSSD ? inputs.dlssdOptions.outputWidth : inputs.dlssOptions.outputWidth;
+        uint32_t outputHeight = inputs.isDLSSD ? inputs.dlssdOptions.outputHeight : inputs.dlssOptions.outputHeight;
+        if (outputWidth == INVALID_UINT || outputHeight == INVALID_UINT)
+        {
+            outputWidth = renderWidth;
+            outputHeight = renderHeight;
+        }
+        if (!getOutput(outputWidth, outputHeight, colorFormat)) return false;
+        resources.push_back(Resource(ResourceType::eTex2d, output.texture.Get(), D3D12_RESOURCE_STATE_UNORDERED_ACCESS));
+        extents.push_back(Extent{ 0, 0, outputWidth, outputHeight });
+        tags.push_back(ResourceTag(&resources.back(), kBufferTypeScalingOutputColor, ResourceLifecycle::eValidUntilPresent, &extents.back()));
+
+        Constants consts = inputs.constants;
+        if (reset) consts.reset = Boolean::eTrue;
+
+        LARGE_INTEGER cpuStart{}, cpuEnd{};
+        QueryPerformanceCounter(&cpuStart);
+
+        FrameToken* frameToken{};
+        uint32_t frameCounter = (uint32_t)frameIndex;
+        Result res = slGetNewFrameToken(frameToken, &frameCounter);
+        if (res == Result::eOk) res = slSetConstants(consts, *frameToken, viewport);
+        if (res == Result::eOk) res = setOptions(inputs);
+        if (res == Result::eOk) res = slSetTagForFrame(*frameToken, viewport, tags.data(), (uint32_t)tags.size(), cmdList.Get());
+        if (res == Result::eOk)
+        {
+            const BaseStructure* evaluateInputs[] = { &viewport };
+            cmdList->EndQuery(queryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, 0);
+            res = slEvaluateFeature(settings.feature, *frameToken, evaluateInputs, (uint32_t)std::size(evaluateInputs), cmdList.Get());
+            cmdList->EndQuery(queryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, 1);
+        }
+
+        QueryPerformanceCounter(&cpuEnd);
+
+        cmdList->ResolveQueryData(queryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, 0, 2, queryReadback.Get(), 0);
+        cmdList->Close();
+        ID3D12CommandList* lists[] = { cmdList.Get() };
+        queue->ExecuteCommandLists(1, lists);
+        // Every frame is waited on so GPU times are isolated and the next upload never races the previous evaluate
+        waitForGPU();
+
+        // Lets SL recycle tags and resources and close its per frame counters like a real present would
+        if (res == Result::eOk)
+        {
+            HeadlessPresentOptions present{};
+            present.commandQueue = queue.Get();
+            present.bufferCount = 1;
+            res = slPresentHeadless(present);
+        }
+
+        if (res != Result::eOk)
+        {
+            fprintf(stderr, "Error: frame %d failed with %s\n", frameIndex, getResultAsStr(res));
+            return false;
+        }
+
+        uint64_t* timestamps{};
+        D3D12_RANGE range{ 0, 2 * sizeof(uint64_t) };
+        queryReadback->Map(0, &range, (void**)&timestamps);
+        timing.gpuMs = timestamps ? double(timestamps[1] - timestamps[0]) * 1000.0 / double(timestampFrequency) : 0.0;
+        D3D12_RANGE written{};
+        queryReadback->Unmap(0, &written);
+        timing.cpuMs = double(cpuEnd.QuadPart - cpuStart.QuadPart) * 1000.0 / double(cpuFrequency.QuadPart);
+        timing.frame = frameIndex;
+        return true;
+    }
+
+private:
+    Result setOptions(const FrameInputs& inputs)
+    {
+        // Recorded DLSS or DLSS-RR options drive whichever feature is replayed
+        const DLSSMode mode = inputs.isDLSSD ? inputs.dlssdOptions.mode : inputs.dlssOptions.mode;
+        const uint32_t outputWidth = inputs.isDLSSD ? inputs.dlssdOptions.outputWidth : inputs.dlssOptions.outputWidth;
+        const uint32_t outputHeight = inputs.isDLSSD ? inputs.dlssdOptions.outputHeight : inputs.dlssOptions.outputHeight;
+        // DLSS sharpness is deprecated and always recorded as zero
+        const float sharpness = inputs.isDLSSD ? inputs.dlssdOptions.sharpness : 0.0f;
+        const float preExposure = inputs.isDLSSD ? inputs.dlssdOptions.preExposure : inputs.dlssOptions.preExposure;
+        const float exposureScale = inputs.isDLSSD ? inputs.dlssdOptions.exposureScale : inputs.dlssOptions.exposureScale;
+        const Boolean colorBuffersHDR = inputs.isDLSSD ? inputs.dlssdOptions.colorBuffersHDR : inputs.dlssOptions.colorBuffersHDR;
+
+        switch (settings.feature)
+        {
+            case kFeatureDLSS:
+            {
+                DLSSOptions options = inputs.dlssOptions;
+                if (inputs.isDLSSD)
+                {
+                    options = {};
+                    options.mode = mode;
+                    options.outputWidth = outputWidth;
+                    options.outputHeight = outputHeight;
+                    options.preExposure = preExposure;
+                    options.exposureScale = exposureScale;
+                    options.colorBuffersHDR = colorBuffersHDR;
+                }
+                return slDLSSSetOptions(viewport, options);
+            }
+            case kFeatureDLSS_RR:
+            {
+                if (!inputs.isDLSSD)
+                {
+                    fprintf(stderr, "Error: DLSS-RR needs a capture recorded with DLSS-RR\n");
+                    return Result::eErrorMissingInputParameter;
+                }
+                return slDLSSDSetOptions(viewport, inputs.dlssdOptions);
+            }
+            case kFeatureNIS:
+            {
+                NISOptions options{};
+                options.mode = NISMode::eScaler;
+                options.hdrMode = colorBuffersHDR == Boolean::eTrue ? NISHDR::eLinear : NISHDR::eNone;
+                options.sharpness = sharpness;
+                return slNISSetOptions(viewport, options);
+            }
+            case kFeatureDirectSR:
+            {
+                DirectSROptions options{};
+                options.variantIndex = settings.variant;
+                options.pCommandQueue = queue.Get();
+                switch (mode)
+                {
+                    case DLSSMode::eMaxPerformance: options.optType = DirectSROptimizationType::eHighPerformance; break;
+                    case DLSSMode::eUltraPerformance: options.optType = DirectSROptimizationType::eMaxPerformance; break;
+                    case DLSSMode::eMaxQuality: options.optType = DirectSROptimizationType::eHighQuality; break;
+                    case DLSSMode::eUltraQuality:
+                    case DLSSMode::eDLAA: options.optType = DirectSROptimizationType::eMaxQuality; break;
+                    default: options.optType = DirectSROptimizationType::eBalanced; break;
+                }
+                options.outputWidth = outputWidth;
+                options.outputHeight = outputHeight;
+                options.sharpness = sharpness;
+                options.preExposure = preExposure;
+                options.exposureScale = exposureScale;
+                options.colorBuffersHDR = colorBuffersHDR;
+                return slDirectSRSetOptions(viewport, options);
+            }
+            default:
+                return Result::eErrorFeatureMissing;
+        }
+    }
+
+    ComPtr<ID3D12Resource> createBuffer(D3D12_HEAP_TYPE heapType, UINT64 size)
+    {
+        D3D12_HEAP_PROPERTIES heap{ heapType };
+        D3D12_RESOURCE_DESC desc{};
+        desc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        desc.Width = size;
+        desc.Height = 1;
+        desc.DepthOrArraySize = 1;
+        desc.MipLevels = 1;
+        desc.SampleDesc.Count = 1;
+        desc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        D3D12_RESOURCE_STATES state = heapType == D3D12_HEAP_TYPE_UPLOAD ? D3D12_RESOURCE_STATE_GENERIC_READ : D3D12_RESOURCE_STATE_COPY_DEST;
+        ComPtr<ID3D12Resource> buffer;
+        device->CreateCommittedResource(&heap, D3D12_HEAP_FLAG_NONE, &desc, state, nullptr, IID_PPV_ARGS(&buffer));
+        return buffer;
+    }
+
+    bool createTexture(ReplayTexture& texture, uint32_t width, uint32_t height, DXGI_FORMAT format, D3D12_RESOURCE_FLAGS flags, D3D12_RESOURCE_STATES state)
+    {
+        D3D12_HEAP_PROPERTIES heap{ D3D12_HEAP_TYPE_DEFAULT };
+        D3D12_RESOURCE_DESC desc{};
+        desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        desc.Width = width;
+        desc.Height = height;
+        desc.DepthOrArraySize = 1;
+        desc.MipLevels = 1;
+        desc.Format = getReplayFormat(format);
+        desc.SampleDesc.Count = 1;
+        desc.Flags = flags;
+        texture = {};
+        if (FAILED(device->CreateCommittedResource(&heap, D3D12_HEAP_FLAG_NONE, &desc, state, nullptr, IID_PPV_ARGS(&texture.texture))))
+        {
+            fprintf(stderr, "Error: failed to create %ux%u texture with format %u\n", width, height, format);
+            return false;
+        }
+        texture.width = width;
+        texture.height = height;
+        texture.format = format;
+        texture.state = state;
+        UINT64 totalBytes{};
+        device->GetCopyableFootprints(&desc, 0, 1, 0, &texture.footprint, &texture.numRows, &texture.rowSizeInBytes, &totalBytes);
+        if (!(flags & D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS))
+        {
+            texture.upload = createBuffer(D3D12_HEAP_TYPE_UPLOAD, totalBytes);
+            if (!texture.upload || FAILED(texture.upload->Map(0, nullptr, (void**)&texture.uploadData))) return false;
+        }
+        return true;
+    }
+
+    ReplayTexture* uploadTexture(const ResourceInputs& input)
+    {
+        auto& texture = textures[input.type];
+        if (!texture.texture || texture.width != input.width || texture.height != input.height || texture.format != input.format)
+        {
+            // Previous frame has completed, safe to release
+            if (!createTexture(texture, input.width, input.height, input.format, D3D12_RESOURCE_FLAG_NONE, D3D12_RESOURCE_STATE_COPY_DEST)) return nullptr;
+        }
+        if (texture.state != D3D12_RESOURCE_STATE_COPY_DEST)
+        {
+            transition(texture, D3D12_RESOURCE_STATE_COPY_DEST);
+        }
+
+        // Pixels are recorded with tightly packed rows, rows can be narrower than the footprint for planar formats
+        const uint8_t* pixels = input.payload.data() + input.pixelOffset;
+        uint64_t bytes = input.payload.size() - input.pixelOffset;
+        uint64_t recordedRowSize = input.height ? bytes / input.height : 0;
+        uint64_t rowSize = std::min(recordedRowSize, texture.rowSizeInBytes);
+        for (UINT y = 0; y < std::min<UINT>(texture.numRows, input.height); y++)
+        {
+            memcpy(texture.uploadData + texture.footprint.Offset + y * texture.footprint.Footprint.RowPitch, pixels + y * recordedRowSize, rowSize);
+        }
+
+        D3D12_TEXTURE_COPY_LOCATION dst{ texture.texture.Get(), D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX };
+        dst.SubresourceIndex = 0;
+        D3D12_TEXTURE_COPY_LOCATION src{ texture.upload.Get(), D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT };
+        src.PlacedFootprint = texture.footprint;
+        cmdList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+        transition(texture, D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+        return &texture;
+    }
+
+    bool getOutput(uint32_t width, uint32_t height, DXGI_FORMAT format)
+    {
+        if (output.texture && output.width == width && output.height == height && output.format == format) return true;
+        return createTexture(output, width, height, format, D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS, D3D12_RESOURCE_STATE_UNORDERED_ACCESS);
+    }
+
+    void transition(ReplayTexture& texture, D3D12_RESOURCE_STATES state)
+    {
+        D3D12_RESOURCE_BARRIER barrier{};
+        barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        barrier.Transition.pResource = texture.texture.Get();
+        barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        barrier.Transition.StateBefore = texture.state;
+        barrier.Transition.StateAfter = state;
+        cmdList->ResourceBarrier(1, &barrier);
+        texture.state = state;
+    }
+
+    void waitForGPU()
+    {
+        queue->Signal(fence.Get(), ++fenceValue);
+        if (fence->GetCompletedValue() < fenceValue)
+        {
+            fence->SetEventOnCompletion(fenceValue, fenceEvent);
+            WaitForSingleObject(fenceEvent, INFINITE);
+        }
+    }
+
+    Settings settings{};
+    bool slInitialized = false;
+    ViewportHandle viewport{ 0 };
+    ComPtr<IDXGIAdapter1> adapter;
+    ComPtr<ID3D12Device> device;
+    ComPtr<ID3D12CommandQueue> queue;
+    ComPtr<ID3D12CommandAllocator> allocator;
+    ComPtr<ID3D12GraphicsCommandList> cmdList;
+    ComPtr<ID3D12Fence> fence;
+    uint64_t fenceValue{};
+    HANDLE fenceEvent{};
+    ComPtr<ID3D12QueryHeap> queryHeap;
+    ComPtr<ID3D12Resource> queryReadback;
+    uint64_t timestampFrequency{};
+    LARGE_INTEGER cpuFrequency{};
+    std::map<BufferType, ReplayTexture> textures;
+    ReplayTexture output{};
+};
+
+void printSummary(const char* name, std::vector<double> values)
+{
+    if (values.empty()) return;
+    std::sort(values.begin(), values.end());
+    double total{};
+    for (auto v : values) total += v;
+    printf("%s avg %.3f ms, min %.3f ms, median %.3f ms, max %.3f ms\n", name, total / values.size(), values.front(), values[values.size() / 2], values.back());
+}
+
+bool parseArguments(int argc, char** argv, Settings& settings)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--feature" && hasValue)
+        {
+            std::string name = argv[++i];
+            if (name == "dlss") settings.feature = kFeatureDLSS;
+            else if (name == "dlss_rr") settings.feature = kFeatureDLSS_RR;
+            else if (name == "nis") settings.feature = kFeatureNIS;
+            else if (name == "directsr") settings.feature = kFeatureDirectSR;
+            else
+            {
+                fprintf(stderr, "Error: unknown feature '%s'\n", name.c_str());
+                return false;
+            }
+            settings.featureOverride = true;
+        }
+        else if (arg == "--loops" && hasValue) settings.loops = std::max(1, atoi(argv[++i]));
+        else if (arg == "--warmup" && hasValue) settings.warmup = std::max(0, atoi(argv[++i]));
+        else if (arg == "--variant" && hasValue) settings.variant = std::max(0, atoi(argv[++i]));
+        else if (arg == "--plugins" && hasValue) settings.pluginPath = std::filesystem::path(argv[++i]).wstring();
+        else if (arg == "--log") settings.log = true;
+        else if (settings.capturePath.empty() && arg[0] != '-') settings.capturePath = arg;
+        else
+        {
+            fprintf(stderr, "Error: unexpected argument '%s'\n", arg.c_str());
+            return false;
+        }
+    }
+    return !settings.capturePath.empty();
+}
+
+}
+}
+
+int main(int argc, char** argv)
+{
+    using namespace sl;
+    using namespace sl::replay;
+
+    Settings settings{};
+    if (!parseArguments(argc, argv, settings))
+    {
+        printf("Usage: sl.replay.exe <capture.sldump> [--feature dlss|dlss_rr|nis|directsr] [--loops N] [--warmup N] [--variant N] [--plugins <dir>] [--log]\n");
+        return 1;
+    }
+
+    CaptureReader reader{};
+    if (!reader.open(settings.capturePath)) return 1;
+    if (reader.frames.empty())
+    {
+        fprintf(stderr, "Error: capture has no frames\n");
+        return 1;
+    }
+
+    // Frames are decoded up front so file access and decoding never show up in the timings
+    std::vector<FrameInputs> frames;
+    frames.reserve(reader.frames.size());
+    for (auto& [index, chunkIndices] : reader.frames)
+    {
+        FrameInputs frame{};
+        if (!parseFrame(reader, chunkIndices, frame)) return 1;
+        if (!frame.hasConstants || frame.resources.empty())
+        {
+            printf("Warning: skipping incomplete frame %d\n", index);
+            continue;
+        }
+        frames.push_back(std::move(frame));
+    }
+    if (frames.empty())
+    {
+        fprintf(stderr, "Error: capture has no complete frames\n");
+        return 1;
+    }
+    if (!settings.featureOverride)
+    {
+        settings.feature = frames.front().isDLSSD ? kFeatureDLSS_RR : kFeatureDLSS;
+    }
+    printf("Replaying %llu frames x %u with %s\n", (uint64_t)frames.size(), settings.loops, getFeatureAsStr(settings.feature));
+
+    Replay replay{};
+    if (!replay.init(settings))
+    {
+        replay.shutdown();
+        return 1;
+    }
+
+    std::vector<double> cpuTimes, gpuTimes;
+    int frameIndex = 0;
+    bool ok = true;
+    printf("%8s %10s %10s\n", "frame", "cpu (ms)", "gpu (ms)");
+    for (uint32_t loop = 0; loop < settings.loops && ok; loop++)
+    {
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            FrameTiming timing{};
+            // History from the previous loop does not match the first frame again
+            if (!replay.replayFrame(frameIndex, frames[i], loop > 0 && i == 0, timing))
+            {
+                ok = false;
+                break;
+            }
+            printf("%8d %10.3f %10.3f\n", timing.frame, timing.cpuMs, timing.gpuMs);
+            if ((uint32_t)frameIndex >= settings.warmup)
+            {
+                cpuTimes.push_back(timing.cpuMs);
+                gpuTimes.push_back(timing.gpuMs);
+            }
+            frameIndex++;
+        }
+    }
+
+    printSummary("CPU", cpuTimes);
+    printSummary("GPU", gpuTimes);
+
+    replay.shutdown();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,76 @@
+#!/usr/bin/python
+
+# Copyright (c) 2024 NVIDIA CORPORATION. All rights reserved
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+
+# Decodes binary log ring written by sl.log (see source/core/sl.log/binaryLog.h)
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x4c42534c
+HEADER = struct.Struct("<IIIIQQQQQQ")
+RECORD = struct.Struct("<QQIHHIIIIII")
+TYPES = ["info", "warn", "error"]
+
+def readString(data, offset, stringId):
+    if stringId == 0:
+        return ""
+    start = offset + stringId - 1
+    (length,) = struct.unpack_from("<I", data, start)
+    return data[start + 4:start + 4 + length].decode("utf-8", "replace")
+
+def decode(path, out):
+    with open(path, "rb") as f:
+        data = f.read()
+    magic, version, recordSize, recordCount, frequency, stringsOffset, stringsSize, recordsOffset, writeIndex, stringsUsed = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        sys.exit("'%s' is not a Streamline binary log" % path)
+    if version != 1:
+        sys.exit("Unsupported binary log version %d" % version)
+
+    first = max(0, writeIndex - recordCount)
+    start = None
+    for index in range(first, writeIndex):
+        base = recordsOffset + (index % recordCount) * recordSize
+        sequence, timestamp, tid, level, logType, line, fileId, funcId, fmtId, length, _ = RECORD.unpack_from(data, base)
+        if sequence != index + 1:
+            # Torn or overwritten record
+            continue
+        if start is None:
+            start = timestamp
+        message = data[base + RECORD.size:base + RECORD.size + length].decode("utf-8", "replace").rstrip("\n")
+        fileName = readString(data, stringsOffset, fileId).split("\\")[-1]
+        func = readString(data, stringsOffset, funcId)
+        seconds = (timestamp - start) / frequency
+        prefix = TYPES[logType] if logType < len(TYPES) else str(logType)
+        out.write("[%12.6f][streamline][%s][tid:%u]%s:%u[%s] %s\n" % (seconds, prefix, tid, fileName, line, func, message))
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description="Decode Streamline binary log")
+    parser.add_argument("input", help="binary log file (*.bin)")
+    parser.add_argument("-o", "--output", help="output text file, stdout if not specified")
+    args = parser.parse_args()
+    if args.output:
+        with open(args.output, "w") as out:
+            decode(args.input, out)
+    else:
+        decode(args.input, sys.stdout)